@@ -43,6 +43,81 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_STACK_CHECK_INCREMENTAL
+
+/****************************************************************************
+ * Name: arm_stack_check_incremental
+ *
+ * Description:
+ *   Like arm_stack_check(), but remember the high water mark in the TCB.
+ *   The mark only moves deeper, so the scan covers just the colored words
+ *   below it and ends at the old mark.  With CONFIG_STACK_CHECK_BUDGET the
+ *   scan is split over several calls, the last known mark is returned
+ *   until the scan completes.
+ *
+ ****************************************************************************/
+
+static size_t arm_stack_check_incremental(struct tcb_s *tcb)
+{
+  uint32_t *start;
+  uint32_t *mark;
+  uint32_t *ptr;
+  uintptr_t end;
+#if CONFIG_STACK_CHECK_BUDGET > 0
+  size_t budget = CONFIG_STACK_CHECK_BUDGET >> 2;
+#endif
+
+  if (tcb->adj_stack_size == 0)
+    {
+      return 0;
+    }
+
+  start = (uint32_t *)STACK_ALIGN_UP((uintptr_t)tcb->stack_base_ptr);
+  end   = STACK_ALIGN_DOWN((uintptr_t)tcb->stack_base_ptr +
+                           tcb->adj_stack_size);
+
+  mark = tcb->stack_mark;
+  if (mark == NULL || mark < start || (uintptr_t)mark > end)
+    {
+      mark = (uint32_t *)end;
+    }
+
+  ptr = tcb->stack_scan;
+  if (ptr == NULL || ptr < start || ptr >= mark)
+    {
+      ptr = start;
+    }
+
+  while (ptr < mark && *ptr == STACK_COLOR)
+    {
+#if CONFIG_STACK_CHECK_BUDGET > 0
+      if (budget-- == 0)
+        {
+          break;
+        }
+#endif
+
+      ptr++;
+    }
+
+  if (ptr < mark && *ptr != STACK_COLOR)
+    {
+      /* Found a deeper use, the next scan starts over from the bottom */
+
+      mark = ptr;
+      ptr  = start;
+    }
+  else if (ptr >= mark)
+    {
+      ptr = start;
+    }
+
+  tcb->stack_mark = mark;
+  tcb->stack_scan = ptr;
+  return end - (uintptr_t)mark;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -211,7 +286,11 @@ size_t up_check_tcbstack(struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_STACK_CHECK_INCREMENTAL
+  size = arm_stack_check_incremental(tcb);
+#else
   size = arm_stack_check(tcb->stack_base_ptr, tcb->adj_stack_size);
+#endif
 
 #ifdef CONFIG_ARCH_ADDRENV
   if (tcb->addrenv_own != NULL)
@@ -189,6 +189,10 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
        */
 
       arm_stack_color(tcb->stack_base_ptr, tcb->adj_stack_size);
+#ifdef CONFIG_STACK_CHECK_INCREMENTAL
+      tcb->stack_mark = NULL;
+      tcb->stack_scan = NULL;
+#endif
 #endif /* CONFIG_STACK_COLORATION */
       tcb->flags |= TCB_FLAG_FREE_STACK;
 
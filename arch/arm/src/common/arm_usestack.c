@@ -112,6 +112,10 @@ int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
    */
 
   arm_stack_color(tcb->stack_base_ptr, tcb->adj_stack_size);
+#ifdef CONFIG_STACK_CHECK_INCREMENTAL
+  tcb->stack_mark = NULL;
+  tcb->stack_scan = NULL;
+#endif
 #endif /* CONFIG_STACK_COLORATION */
 
   return OK;
@@ -92,6 +92,14 @@ static int      nand_rawread(struct nand_raw_s *raw, off_t block,
                   unsigned int page, void *data, void *spare);
 static int      nand_rawwrite(struct nand_raw_s *raw, off_t block,
                   unsigned int page, const void *data, const void *spare);
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+static int      nand_readcache(struct nand_raw_s *raw, off_t block,
+                  unsigned int page, unsigned int npages, void *data,
+                  nand_pagecb_t callback, void *arg);
+static int      nand_writecache(struct nand_raw_s *raw, off_t block,
+                  unsigned int page, unsigned int npages,
+                  const void *data, nand_pagecb_t callback, void *arg);
+#endif
 
 /* Initialization */
 
@@ -469,6 +477,231 @@ static int nand_rawwrite(struct nand_raw_s *raw, off_t block,
   return ret;
 }
 
+/****************************************************************************
+ * Name: nand_readcache
+ *
+ * Description:
+ *   Reads the data areas of several consecutive pages of one block using
+ *   the ONFI read cache sequential command.  The callback is invoked on
+ *   each page, together with its spare area, while the device is already
+ *   loading the next page from the array into its data register.
+ *
+ * Input Parameters:
+ *   raw      - Lower-half, raw NAND FLASH interface
+ *   block    - Number of the block where the pages reside.
+ *   page     - Number of the first page to read inside the given block.
+ *   npages   - Number of pages to read.
+ *   data     - Buffer where the data areas will be stored.
+ *   callback - Per-page callback, may be NULL.
+ *   arg      - Argument passed to the callback.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+static int nand_readcache(struct nand_raw_s *raw, off_t block,
+                          unsigned int page, unsigned int npages,
+                          void *data, nand_pagecb_t callback, void *arg)
+{
+  struct sam_nandcs_s *priv = (struct sam_nandcs_s *)raw;
+  volatile uint8_t *src8 = (volatile uint8_t *)priv->raw.dataaddr;
+  uint8_t *dest8 = (uint8_t *)data;
+  uint16_t pagesize;
+  uint16_t sparesize;
+  uint32_t rowaddr;
+  unsigned int i;
+  int remaining;
+  int ret = OK;
+
+  DEBUGASSERT(priv && data && npages > 0);
+  finfo("block=%" PRIdOFF " page=%d npages=%d\n", block, page, npages);
+
+  pagesize  = nandmodel_getpagesize(&priv->raw.model);
+  sparesize = nandmodel_getsparesize(&priv->raw.model);
+  rowaddr   = block * nandmodel_pagesperblock(&priv->raw.model) + page;
+
+  /* Load the first page into the data register */
+
+  WRITE_COMMAND8(&priv->raw, COMMAND_READ_1);
+  WRITE_ADDRESS8(&priv->raw, 0);                 /* 1st cycle column addr */
+  WRITE_ADDRESS8(&priv->raw, 0);                 /* 2nt cycle column addr */
+  WRITE_ADDRESS8(&priv->raw, rowaddr);           /* 3rd cycle row addr */
+  WRITE_ADDRESS8(&priv->raw, rowaddr >> 8);      /* 4th cycle row addr */
+  WRITE_ADDRESS8(&priv->raw, rowaddr >> 16);     /* 5st cycle row addr */
+  WRITE_COMMAND8(&priv->raw, COMMAND_READ_2);
+  up_udelay(10);
+  while (!sam_gpioread(priv->rb));
+
+  for (i = 0; i < npages; i++)
+    {
+      /* Move the page to the cache register.  Unless this is the last
+       * page, the device then starts fetching the next page from the
+       * array while this one is transferred and processed.
+       */
+
+      WRITE_COMMAND8(&priv->raw, i + 1 < npages ? COMMAND_READ_CACHE_SEQ :
+                                                  COMMAND_READ_CACHE_END);
+      up_udelay(1);
+      while (!sam_gpioread(priv->rb));
+
+      for (remaining = pagesize; remaining > 0; remaining--)
+        {
+          *dest8++ = *src8;
+        }
+
+#ifdef CONFIG_MTD_NAND_SWECC
+      if (callback != NULL)
+        {
+          uint8_t *spare8 = priv->raw.spare;
+
+          /* The spare area follows the data in the cache register */
+
+          for (remaining = sparesize; remaining > 0; remaining--)
+            {
+              *spare8++ = *src8;
+            }
+
+          ret = callback(arg, page + i, dest8 - pagesize, priv->raw.spare);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+#else
+      UNUSED(sparesize);
+#endif
+    }
+
+  /* Terminate the cache sequence if it was aborted */
+
+  if (i + 1 < npages)
+    {
+      WRITE_COMMAND8(&priv->raw, COMMAND_READ_CACHE_END);
+      up_udelay(1);
+      while (!sam_gpioread(priv->rb));
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: nand_writecache
+ *
+ * Description:
+ *   Programs several consecutive pages of one block using the ONFI page
+ *   cache program command.  The callback prepares the spare area of each
+ *   page while the device is still programming the previous page.
+ *
+ * Input Parameters:
+ *   raw      - Lower-half, raw NAND FLASH interface
+ *   block    - Number of the block where the pages reside.
+ *   page     - Number of the first page to write inside the given block.
+ *   npages   - Number of pages to write.
+ *   data     - Buffer containing the data areas.
+ *   callback - Per-page callback, may be NULL.
+ *   arg      - Argument passed to the callback.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+static int nand_writecache(struct nand_raw_s *raw, off_t block,
+                           unsigned int page, unsigned int npages,
+                           const void *data, nand_pagecb_t callback,
+                           void *arg)
+{
+  struct sam_nandcs_s *priv = (struct sam_nandcs_s *)raw;
+  volatile uint8_t *dest8 = (volatile uint8_t *)priv->raw.dataaddr;
+  const uint8_t *src8 = (const uint8_t *)data;
+  uint16_t pagesize;
+  uint16_t sparesize;
+  uint32_t rowaddr;
+  unsigned int i;
+  int remaining;
+  int ret = OK;
+
+  DEBUGASSERT(priv && data && npages > 0);
+  finfo("block=%" PRIdOFF " page=%d npages=%d\n", block, page, npages);
+
+  pagesize  = nandmodel_getpagesize(&priv->raw.model);
+  sparesize = nandmodel_getsparesize(&priv->raw.model);
+  rowaddr   = block * nandmodel_pagesperblock(&priv->raw.model) + page;
+
+  for (i = 0; i < npages; i++, rowaddr++)
+    {
+#ifdef CONFIG_MTD_NAND_SWECC
+      /* Prepare the spare area while the previous page is programmed */
+
+      if (callback != NULL)
+        {
+          ret = callback(arg, page + i, (void *)src8, priv->raw.spare);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+#endif
+
+      WRITE_COMMAND8(&priv->raw, COMMAND_WRITE_1);
+      WRITE_ADDRESS8(&priv->raw, 0);             /* 1st cycle column addr */
+      WRITE_ADDRESS8(&priv->raw, 0);             /* 2nt cycle column addr */
+      WRITE_ADDRESS8(&priv->raw, rowaddr);       /* 3rd cycle row addr */
+      WRITE_ADDRESS8(&priv->raw, rowaddr >> 8);  /* 4th cycle row addr */
+      WRITE_ADDRESS8(&priv->raw, rowaddr >> 16); /* 5st cycle row addr */
+
+      for (remaining = pagesize; remaining > 0; remaining--)
+        {
+          *dest8 = *src8++;
+        }
+
+#ifdef CONFIG_MTD_NAND_SWECC
+      if (callback != NULL)
+        {
+          const uint8_t *spare8 = priv->raw.spare;
+
+          for (remaining = sparesize; remaining > 0; remaining--)
+            {
+              *dest8 = *spare8++;
+            }
+        }
+#else
+      UNUSED(sparesize);
+#endif
+
+      /* Cache program returns as soon as the cache register is free again
+       * and the array program continues in the background; the last page
+       * is a normal program that waits for all programming to complete.
+       */
+
+      WRITE_COMMAND8(&priv->raw, i + 1 < npages ? COMMAND_WRITE_CACHE :
+                                                  COMMAND_WRITE_2);
+      ret = nand_wait_ready(priv);
+      if (ret < 0)
+        {
+          ferr("ERROR: Cache program failed, page %d: %d\n", page + i,
+               ret);
+          break;
+        }
+    }
+
+  /* If the sequence was aborted, wait for the device to finish the pages
+   * that are still being programmed.
+   */
+
+  if (ret < 0 && i > 0)
+    {
+      nand_wait_ready(priv);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -538,6 +771,10 @@ struct mtd_dev_s *sam_nand_initialize(int cs)
   priv->raw.eraseblock = nand_eraseblock;
   priv->raw.rawread    = nand_rawread;
   priv->raw.rawwrite   = nand_rawwrite;
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+  priv->raw.readcache  = nand_readcache;
+  priv->raw.writecache = nand_writecache;
+#endif
 
   priv->cs             = cs;
   priv->rb             = GPIO_SMC_RB;
@@ -740,6 +740,49 @@ int up_addrenv_select(const arch_addrenv_t *addrenv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: up_addrenv_asid_select
+ *
+ * Description:
+ *   Instantiate an address environment with its user mappings tagged by
+ *   'asid', flushing the local TLB only when asked to.
+ *
+ * Input Parameters:
+ *   addrenv - The representation of the task address environment previously
+ *     returned by up_addrenv_create.
+ *   asid    - The address space identifier.
+ *   flush   - Invalidate the local TLB before using 'asid'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+int up_addrenv_asid_select(const arch_addrenv_t *addrenv, uint16_t asid,
+                           bool flush)
+{
+  DEBUGASSERT(addrenv && addrenv->ttbr0);
+  mmu_switch_ttbr0(addrenv->ttbr0 |
+                   ((uintptr_t)asid << TTBR_ASID_SHIFT), flush);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_addrenv_asid_bits
+ *
+ * Description:
+ *   Return the number of ASID bits in use.  TCR_EL1.AS is left clear, so
+ *   ttbr0 carries an 8-bit ASID on every ARMv8-A implementation.
+ *
+ ****************************************************************************/
+
+int up_addrenv_asid_bits(void)
+{
+  return 8;
+}
+#endif
+
 /****************************************************************************
  * Name: up_addrenv_coherent
  *
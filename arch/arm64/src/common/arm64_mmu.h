@@ -405,7 +405,7 @@ static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
   __asm__ __volatile__
     (
       "dsb ishst\n"
-      "tlbi vale1is, %0\n"
+      "tlbi vaale1is, %0\n"
       "dsb ish\n"
       "isb"
       :
@@ -453,6 +453,33 @@ static inline void mmu_write_ttbr0(uintptr_t reg)
   mmu_invalidate_tlbs();
 }
 
+/****************************************************************************
+ * Name: mmu_switch_ttbr0
+ *
+ * Description:
+ *   Write ttbr0 when switching between ASID tagged address environments.
+ *   The local TLB is only invalidated if requested.
+ *
+ * Input Parameters:
+ *   reg   - ttbr0 value, including the ASID
+ *   flush - Invalidate the local TLB as well
+ *
+ ****************************************************************************/
+
+static inline void mmu_switch_ttbr0(uintptr_t reg, bool flush)
+{
+  write_sysreg(reg, ttbr0_el1);
+
+  if (flush)
+    {
+      mmu_invalidate_tlbs();
+    }
+  else
+    {
+      UP_ISB();
+    }
+}
+
 /****************************************************************************
  * Name: mmu_read_ttbr0
  *
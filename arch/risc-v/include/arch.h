@@ -106,6 +106,26 @@ typedef struct arch_addrenv_s arch_addrenv_t;
 #endif /* __ASSEMBLY__ */
 #endif /* CONFIG_ARCH_ADDRENV */
 
+/****************************************************************************
+ * Inline functions
+ ****************************************************************************/
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__ASSEMBLY__)
+
+/* Read the time CSR behind up_perf_gettime() from user mode, for
+ * clock_gettime() in libc.  The kernel allows this with counteren.TM.
+ */
+
+static inline unsigned long up_vdso_gettime(void)
+{
+  unsigned long time;
+
+  __asm__ __volatile__("rdtime %0" : "=r"(time));
+  return time;
+}
+
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -45,6 +45,7 @@
 #  define CSR_TVAL          CSR_STVAL        /* Trap value register */
 #  define CSR_TVEC          CSR_STVEC        /* Trap vector base addr register */
 #  define CSR_ENVCFG        CSR_SENVCFG      /* Env configuration register */
+#  define CSR_COUNTEREN     CSR_SCOUNTEREN   /* Counter enable register */
 #  define CSR_IEH           CSR_SIEH
 #  define CSR_ISELECT       CSR_SISELECT     /* Indirect select register */
 #  define CSR_IREG          CSR_SIREG        /* Indirect alias register */
@@ -94,6 +95,7 @@
 #  define CSR_TVAL          CSR_MTVAL        /* Trap value register */
 #  define CSR_TVEC          CSR_MTVEC        /* Trap vector base addr register */
 #  define CSR_ENVCFG        CSR_MENVCFG      /* Env configuration register */
+#  define CSR_COUNTEREN     CSR_MCOUNTEREN   /* Counter enable register */
 #  define CSR_IEH           CSR_MIEH
 #  define CSR_ISELECT       CSR_MISELECT     /* Indirect select register */
 #  define CSR_IREG          CSR_MIREG        /* Indirect alias register */
@@ -723,6 +723,68 @@ int up_addrenv_select(const arch_addrenv_t *addrenv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: up_addrenv_asid_select
+ *
+ * Description:
+ *   Instantiate an address environment with its user mappings tagged by
+ *   'asid', flushing the local TLB only when asked to.
+ *
+ * Input Parameters:
+ *   addrenv - The representation of the task address environment previously
+ *     returned by up_addrenv_create.
+ *   asid    - The address space identifier.
+ *   flush   - Invalidate the local TLB before using 'asid'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+int up_addrenv_asid_select(const arch_addrenv_t *addrenv, uint16_t asid,
+                           bool flush)
+{
+  DEBUGASSERT(addrenv && addrenv->satp);
+  mmu_switch_satp(addrenv->satp |
+                  (((uintptr_t)asid << SATP_ASID_SHIFT) & SATP_ASID_MASK),
+                  flush);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_addrenv_asid_bits
+ *
+ * Description:
+ *   Return the number of ASID bits implemented by the hart.  The ASID field
+ *   of satp is WARL, so write all ones and count the bits that stick.
+ *
+ ****************************************************************************/
+
+int up_addrenv_asid_bits(void)
+{
+  uintptr_t satp = mmu_read_satp();
+  uintptr_t asid;
+
+  __asm__ __volatile__
+    (
+      "csrw satp, %1\n"
+      "csrr %0, satp\n"
+      "csrw satp, %2\n"
+      : "=&r" (asid)
+      : "r" (satp | SATP_ASID_MASK), "r" (satp)
+      : "memory"
+    );
+
+  /* Drop whatever was walked in under the probe ASID */
+
+  mmu_invalidate_tlbs();
+
+  asid = (asid & SATP_ASID_MASK) >> SATP_ASID_SHIFT;
+  return asid ? 32 - __builtin_clz((uint32_t)asid) : 0;
+}
+#endif
+
 /****************************************************************************
  * Name: up_addrenv_coherent
  *
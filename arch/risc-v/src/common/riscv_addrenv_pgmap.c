@@ -167,6 +167,102 @@ void up_addrenv_page_wipe(uintptr_t page)
   riscv_pgwipe(page);
 }
 
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Name: up_addrenv_map_pages
+ *
+ * Description:
+ *   Map physical pages into a continuous user virtual memory block of an
+ *   address environment.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to map the pages into.
+ *   pages - A pointer to the first element in a array of physical address,
+ *     each corresponding to one page of memory.
+ *   npages - The number of pages in the list of physical pages to be mapped.
+ *   vaddr - The virtual address corresponding to the beginning of the
+ *     (continuous) virtual address region.
+ *   prot - Access right flags.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
+                         unsigned int npages, uintptr_t vaddr, int prot)
+{
+  int mask = 0;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(addrenv != NULL && pages != NULL && npages > 0);
+  DEBUGASSERT(riscv_uservaddr(vaddr));
+  DEBUGASSERT(MM_ISALIGNED(vaddr));
+
+  /* Convert access right flags to MMU flags */
+
+  if (prot & PROT_READ)
+    {
+      mask |= PTE_R;
+    }
+
+  if (prot & PROT_WRITE)
+    {
+      mask |= PTE_W;
+    }
+
+  if (prot & PROT_EXEC)
+    {
+      mask |= PTE_X;
+    }
+
+  /* This is a user mapping */
+
+  mask |= PTE_U | EXT_UDATA_FLAGS;
+
+  /* Let riscv_map_pages do the work */
+
+  return riscv_map_pages(addrenv, pages, npages, vaddr, mask);
+}
+
+/****************************************************************************
+ * Name: up_addrenv_unmap_pages
+ *
+ * Description:
+ *   Unmap a user virtual memory region previously mapped with
+ *   up_addrenv_map_pages().
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to unmap the pages from.
+ *   vaddr - The virtual address corresponding to the beginning of the
+ *     (continuous) virtual address region.
+ *   npages - The number of pages to be unmapped
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
+                           unsigned int npages)
+{
+  /* Sanity checks */
+
+  DEBUGASSERT(addrenv != NULL && npages > 0);
+  DEBUGASSERT(riscv_uservaddr(vaddr));
+  DEBUGASSERT(MM_ISALIGNED(vaddr));
+
+  /* Let riscv_unmap_pages do the work */
+
+  return riscv_unmap_pages(addrenv, vaddr, npages);
+}
+
+#endif /* CONFIG_CLOCK_VDSO */
+
 #ifdef CONFIG_MM_KMAP
 
 /****************************************************************************
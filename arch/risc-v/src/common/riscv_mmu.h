@@ -236,6 +236,50 @@ static inline void mmu_write_satp(uintptr_t reg)
     }
 }
 
+/****************************************************************************
+ * Name: mmu_switch_satp
+ *
+ * Description:
+ *   Write satp when switching between ASID tagged address environments.
+ *   The local TLB is only invalidated if requested.
+ *
+ * Input Parameters:
+ *   reg   - satp value, including the ASID
+ *   flush - Invalidate the local TLB as well
+ *
+ ****************************************************************************/
+
+static inline void mmu_switch_satp(uintptr_t reg, bool flush)
+{
+  __asm__ __volatile__
+    (
+      "csrw satp, %0\n"
+      "fence rw, rw\n"
+      "fence.i\n"
+      :
+      : "rK" (reg)
+      : "memory"
+    );
+
+  if (flush)
+    {
+      __asm__ __volatile__
+        (
+          "sfence.vma x0, x0\n"
+          :
+          :
+          : "memory"
+        );
+    }
+
+  /* Flush the MMU Cache if needed (T-Head C906) */
+
+  if (mmu_flush_cache != NULL)
+    {
+      mmu_flush_cache(reg);
+    }
+}
+
 /****************************************************************************
  * Name: mmu_read_satp
  *
@@ -277,7 +321,7 @@ static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
 {
   __asm__ __volatile__
     (
-      "sfence.vma x0, %0\n"
+      "sfence.vma %0, x0\n"
       :
       : "rK" (vaddr)
       : "memory"
@@ -168,6 +168,12 @@ void qemu_rv_start(int mhartid, const char *dtb)
 
   riscv_fpuconfig();
 
+#ifdef CONFIG_CLOCK_VDSO
+  /* Let user space read the time CSR, see up_vdso_gettime() */
+
+  SET_CSR(CSR_COUNTEREN, COUNTEREN_TM);
+#endif
+
   if (mhartid > 0)
     {
       goto cpux;
@@ -71,4 +71,8 @@ void up_timer_initialize(void)
   DEBUGASSERT(lower);
 
   up_alarm_set_lowerhalf(lower);
+
+#ifdef CONFIG_ARCH_PERF_EVENTS
+  up_perf_init((FAR void *)MTIMER_FREQ);
+#endif
 }
@@ -117,6 +117,54 @@ static void host_stat_convert(struct stat *hostbuf, struct nuttx_stat_s *buf)
   buf->st_blocks       = hostbuf->st_blocks;
 }
 
+/****************************************************************************
+ * Name: host_dirent_convert
+ ****************************************************************************/
+
+static void host_dirent_convert(struct dirent *ent,
+                                struct nuttx_dirent_s *entry)
+{
+  /* Copy the entry name */
+
+  strncpy(entry->d_name, ent->d_name, sizeof(entry->d_name) - 1);
+  entry->d_name[sizeof(entry->d_name) - 1] = 0;
+
+  /* Map the type */
+
+  if (ent->d_type == DT_REG)
+    {
+      entry->d_type = NUTTX_DTYPE_FILE;
+    }
+  else if (ent->d_type == DT_FIFO)
+    {
+      entry->d_type = NUTTX_DTYPE_FIFO;
+    }
+  else if (ent->d_type == DT_CHR)
+    {
+      entry->d_type = NUTTX_DTYPE_CHR;
+    }
+  else if (ent->d_type == DT_BLK)
+    {
+      entry->d_type = NUTTX_DTYPE_BLK;
+    }
+  else if (ent->d_type == DT_DIR)
+    {
+      entry->d_type = NUTTX_DTYPE_DIRECTORY;
+    }
+  else if (ent->d_type == DT_LNK)
+    {
+      entry->d_type = NUTTX_DTYPE_LINK;
+    }
+  else if (ent->d_type == DT_SOCK)
+    {
+      entry->d_type = NUTTX_DTYPE_SOCK;
+    }
+  else
+    {
+      entry->d_type = NUTTX_DTYPE_UNKNOWN;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -423,50 +471,52 @@ int host_readdir(void *dirp, struct nuttx_dirent_s *entry)
   ent = readdir(dirp);
   if (ent != NULL)
     {
-      /* Copy the entry name */
+      host_dirent_convert(ent, entry);
+      return 0;
+    }
+
+  return -ENOENT;
+}
 
-      strncpy(entry->d_name, ent->d_name, sizeof(entry->d_name) - 1);
-      entry->d_name[sizeof(entry->d_name) - 1] = 0;
+/****************************************************************************
+ * Name: host_readdir_batch
+ *
+ * Description:
+ *   Read up to count directory entries and their attributes in one call.
+ *   Returns the number of entries read, zero at the end of the directory.
+ *   The st_mode of an entry whose attributes could not be read is zero.
+ *
+ ****************************************************************************/
 
-      /* Map the type */
+int host_readdir_batch(void *dirp, struct nuttx_dirent_s *entries,
+                       struct nuttx_stat_s *bufs, int count)
+{
+  struct dirent *ent;
+  struct stat hostbuf;
+  int n;
 
-      if (ent->d_type == DT_REG)
-        {
-          entry->d_type = NUTTX_DTYPE_FILE;
-        }
-      else if (ent->d_type == DT_FIFO)
-        {
-          entry->d_type = NUTTX_DTYPE_FIFO;
-        }
-      else if (ent->d_type == DT_CHR)
-        {
-          entry->d_type = NUTTX_DTYPE_CHR;
-        }
-      else if (ent->d_type == DT_BLK)
-        {
-          entry->d_type = NUTTX_DTYPE_BLK;
-        }
-      else if (ent->d_type == DT_DIR)
-        {
-          entry->d_type = NUTTX_DTYPE_DIRECTORY;
-        }
-      else if (ent->d_type == DT_LNK)
-        {
-          entry->d_type = NUTTX_DTYPE_LINK;
-        }
-      else if (ent->d_type == DT_SOCK)
+  for (n = 0; n < count; n++)
+    {
+      ent = readdir(dirp);
+      if (ent == NULL)
         {
-          entry->d_type = NUTTX_DTYPE_SOCK;
+          break;
         }
-      else
+
+      host_dirent_convert(ent, &entries[n]);
+
+      /* Follow symbolic links the same way as host_stat() */
+
+      if (fstatat(dirfd(dirp), ent->d_name, &hostbuf, 0) < 0)
         {
-          entry->d_type = NUTTX_DTYPE_UNKNOWN;
+          memset(&bufs[n], 0, sizeof(bufs[n]));
+          continue;
         }
 
-      return 0;
+      host_stat_convert(&hostbuf, &bufs[n]);
     }
 
-  return -ENOENT;
+  return n;
 }
 
 /****************************************************************************
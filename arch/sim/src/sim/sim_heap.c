@@ -610,6 +610,19 @@ void mm_memdump(struct mm_heap_s *heap, const struct mm_memdump_s *dump)
 {
 }
 
+/****************************************************************************
+ * Name: mm_foreach_free
+ *
+ * Description:
+ *   The host allocator doesn't expose its free blocks, report nothing.
+ *
+ ****************************************************************************/
+
+void mm_foreach_free(struct mm_heap_s *heap, mm_free_handler_t handler,
+                     void *arg)
+{
+}
+
 #ifdef CONFIG_DEBUG_MM
 
 /****************************************************************************
@@ -332,6 +332,35 @@ int host_readdir(void *dirp, struct nuttx_dirent_s *entry)
   return 0;
 }
 
+/****************************************************************************
+ * Name: host_readdir_batch
+ *
+ * Description:
+ *   Read up to count directory entries in one call.  The attributes are
+ *   not available from the directory search, so every st_mode is zero.
+ *
+ ****************************************************************************/
+
+int host_readdir_batch(void *dirp, struct nuttx_dirent_s *entries,
+                       struct nuttx_stat_s *bufs, int count)
+{
+  int ret;
+  int n;
+
+  for (n = 0; n < count; n++)
+    {
+      ret = host_readdir(dirp, &entries[n]);
+      if (ret < 0)
+        {
+          return n > 0 || ret == -ENOENT ? n : ret;
+        }
+
+      memset(&bufs[n], 0, sizeof(bufs[n]));
+    }
+
+  return n;
+}
+
 /****************************************************************************
  * Name: host_rewinddir
  ****************************************************************************/
@@ -224,7 +224,7 @@ int exec_module(FAR struct binary_s *binp,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = nxsched_alloc_tcb(sizeof(struct task_tcb_s));
   if (!tcb)
     {
       return -ENOMEM;
@@ -301,6 +301,10 @@ int exec_module(FAR struct binary_s *binp,
   /* tcb->cmn.flags |= TCB_FLAG_TTYPE_TASK; */
 
   tcb->cmn.flags |= TCB_FLAG_FREE_TCB;
+  if (attr != NULL && (attr->flags & POSIX_SPAWN_CLOEXEC_DEFAULT) != 0)
+    {
+      tcb->cmn.flags |= TCB_FLAG_CLOEXEC_DEFAULT;
+    }
 
   /* Initialize the task */
 
@@ -439,7 +443,7 @@ errout_with_envp:
 errout_with_args:
   binfmt_freeargv(argv);
 errout_with_tcb:
-  kmm_free(tcb);
+  nxsched_free_tcb(tcb);
   return ret;
 }
 
@@ -55,6 +55,18 @@
 
 int sim_bringup(void);
 
+/****************************************************************************
+ * Name: sim_fsbench_setup
+ *
+ * Description:
+ *   Create the RAM disk and RAM MTD devices used by file system benchmarks
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_FSBENCH
+int sim_fsbench_setup(void);
+#endif
+
 /****************************************************************************
  * Name: sim_zoneinfo
  *
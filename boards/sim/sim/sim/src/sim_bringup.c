@@ -254,6 +254,12 @@ int sim_bringup(void)
     }
 #endif
 
+#ifdef CONFIG_SIM_FSBENCH
+  /* Create the file system benchmark devices */
+
+  sim_fsbench_setup();
+#endif
+
 #ifdef CONFIG_ONESHOT
   /* Get an instance of the simulated oneshot timer */
 
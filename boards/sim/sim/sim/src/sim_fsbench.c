@@ -0,0 +1,190 @@
+/****************************************************************************
+ * boards/sim/sim/sim/src/sim_fsbench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mount.h>
+#include <stdint.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/drivers/ramdisk.h>
+
+#include "sim.h"
+
+#ifdef CONFIG_SIM_FSBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_DISABLE_MOUNTPOINT
+#  error "Mountpoint support is disabled"
+#endif
+
+#define FSBENCH_SECTSIZE     512
+#define FSBENCH_RAMDISK_SIZE (CONFIG_SIM_FSBENCH_RAMDISK_SIZE * 1024)
+#define FSBENCH_MTD_SIZE     (CONFIG_SIM_FSBENCH_MTD_SIZE * 1024)
+
+#ifdef CONFIG_RAMDISK_SPARSE
+#  define FSBENCH_RDFLAGS    (RDFLAG_WRENABLED | RDFLAG_SPARSE)
+#else
+#  define FSBENCH_RDFLAGS    (RDFLAG_WRENABLED | RDFLAG_FUNLINK)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_fsbench_ramdisk
+ *
+ * Description:
+ *   Register the RAM disk used for the block device file systems.  It is
+ *   sparse when possible so that its size costs no memory until it is
+ *   written.
+ *
+ ****************************************************************************/
+
+static int sim_fsbench_ramdisk(void)
+{
+  FAR uint8_t *buffer = NULL;
+  int ret;
+
+#ifndef CONFIG_RAMDISK_SPARSE
+  buffer = kmm_malloc(FSBENCH_RAMDISK_SIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+#endif
+
+  ret = ramdisk_register(CONFIG_SIM_FSBENCH_RAMDISK_MINOR, buffer,
+                         FSBENCH_RAMDISK_SIZE / FSBENCH_SECTSIZE,
+                         FSBENCH_SECTSIZE, FSBENCH_RDFLAGS);
+  if (ret < 0)
+    {
+      kmm_free(buffer);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sim_fsbench_mtd
+ *
+ * Description:
+ *   Register the RAM MTD device used for the flash file systems, and mount
+ *   littlefs on it if that is enabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMMTD
+static int sim_fsbench_mtd(void)
+{
+  FAR struct mtd_dev_s *mtd;
+  FAR uint8_t *buffer;
+  int ret;
+
+  buffer = kmm_malloc(FSBENCH_MTD_SIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mtd = rammtd_initialize(buffer, FSBENCH_MTD_SIZE);
+  if (mtd == NULL)
+    {
+      kmm_free(buffer);
+      return -ENODEV;
+    }
+
+  MTD_IOCTL(mtd, MTDIOC_BULKERASE, 0);
+
+  ret = register_mtddriver("/dev/benchmtd", mtd, 0755, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_FS_LITTLEFS
+  ret = nx_mount("/dev/benchmtd", "/mnt/bench/lfs", "littlefs", 0,
+                 "forceformat");
+#endif
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_fsbench_setup
+ *
+ * Description:
+ *   Create the devices that file system benchmarks run against, so that
+ *   every run starts from the same, freshly created media:
+ *
+ *   - /dev/ram<CONFIG_SIM_FSBENCH_RAMDISK_MINOR>, an empty RAM disk to be
+ *     formatted with FAT by the benchmark.
+ *   - /dev/benchmtd, an erased RAM MTD device with littlefs mounted at
+ *     /mnt/bench/lfs.
+ *
+ *   tmpfs (CONFIG_LIBC_TMPDIR) and the ROMFS /etc image are mounted by
+ *   sim_bringup() as usual.
+ *
+ ****************************************************************************/
+
+int sim_fsbench_setup(void)
+{
+  int ret;
+
+  ret = sim_fsbench_ramdisk();
+  if (ret < 0)
+    {
+      syslog(LOG_ERR, "ERROR: Failed to create the benchmark RAM disk: %d\n",
+             ret);
+      return ret;
+    }
+
+#ifdef CONFIG_RAMMTD
+  ret = sim_fsbench_mtd();
+  if (ret < 0)
+    {
+      syslog(LOG_ERR, "ERROR: Failed to set up /dev/benchmtd: %d\n", ret);
+    }
+#endif
+
+  return ret;
+}
+
+#endif /* CONFIG_SIM_FSBENCH */
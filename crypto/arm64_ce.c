@@ -0,0 +1,164 @@
+/****************************************************************************
+ * crypto/arm64_ce.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <arch/irq.h>
+
+#ifdef __GNUC__
+#  pragma GCC target("+crypto")
+#endif
+
+#include <arm_neon.h>
+
+#include "arm64_ce.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ID_AA64ISAR0_EL1 fields */
+
+#define ID_AES_SHIFT      4
+#define ID_SHA2_SHIFT     12
+#define ID_FIELD(v, s)    (((v) >> (s)) & 0xf)
+
+/* rijndael.c keeps the round keys as big endian words, the AES
+ * instructions want them in byte order.
+ */
+
+#define LOAD_RK(rk)       vrev32q_u8(vld1q_u8((FAR const uint8_t *)(rk)))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_arm64_ce_isar0 = -1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t arm64_ce_isar0(void)
+{
+  if (g_arm64_ce_isar0 < 0)
+    {
+      g_arm64_ce_isar0 = read_sysreg(id_aa64isar0_el1) & 0xffff;
+    }
+
+  return g_arm64_ce_isar0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+bool arm64_ce_has_aes(void)
+{
+  return ID_FIELD(arm64_ce_isar0(), ID_AES_SHIFT) != 0;
+}
+
+bool arm64_ce_has_sha256(void)
+{
+  return ID_FIELD(arm64_ce_isar0(), ID_SHA2_SHIFT) != 0;
+}
+
+void arm64_ce_aes_encrypt(FAR const uint32_t *rk, int nr,
+                          FAR const uint8_t *in, FAR uint8_t *out)
+{
+  uint8x16_t state = vld1q_u8(in);
+  int i;
+
+  for (i = 0; i < nr - 1; i++, rk += 4)
+    {
+      state = vaesmcq_u8(vaeseq_u8(state, LOAD_RK(rk)));
+    }
+
+  state = vaeseq_u8(state, LOAD_RK(rk));
+  state = veorq_u8(state, LOAD_RK(rk + 4));
+  vst1q_u8(out, state);
+}
+
+void arm64_ce_aes_decrypt(FAR const uint32_t *rk, int nr,
+                          FAR const uint8_t *in, FAR uint8_t *out)
+{
+  uint8x16_t state = vld1q_u8(in);
+  int i;
+
+  /* The decryption schedule is already in the "equivalent inverse
+   * cipher" form that AESD/AESIMC expect.
+   */
+
+  for (i = 0; i < nr - 1; i++, rk += 4)
+    {
+      state = vaesimcq_u8(vaesdq_u8(state, LOAD_RK(rk)));
+    }
+
+  state = vaesdq_u8(state, LOAD_RK(rk));
+  state = veorq_u8(state, LOAD_RK(rk + 4));
+  vst1q_u8(out, state);
+}
+
+void arm64_ce_sha256_transform(FAR uint32_t *state,
+                               FAR const uint8_t *data,
+                               FAR const uint32_t *k)
+{
+  uint32x4_t abcd = vld1q_u32(&state[0]);
+  uint32x4_t efgh = vld1q_u32(&state[4]);
+  uint32x4_t abcd0 = abcd;
+  uint32x4_t efgh0 = efgh;
+  uint32x4_t msg[4];
+  uint32x4_t wk;
+  uint32x4_t tmp;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+    }
+
+  /* 16 groups of four rounds, the message schedule for group i + 4 is
+   * computed while group i runs.
+   */
+
+  for (i = 0; i < 16; i++)
+    {
+      wk = vaddq_u32(msg[i & 3], vld1q_u32(&k[i * 4]));
+      if (i < 12)
+        {
+          msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3],
+                                                       msg[(i + 1) & 3]),
+                                       msg[(i + 2) & 3], msg[(i + 3) & 3]);
+        }
+
+      tmp  = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, wk);
+      efgh = vsha256h2q_u32(efgh, tmp, wk);
+    }
+
+  vst1q_u32(&state[0], vaddq_u32(abcd, abcd0));
+  vst1q_u32(&state[4], vaddq_u32(efgh, efgh0));
+}
@@ -0,0 +1,64 @@
+/****************************************************************************
+ * crypto/arm64_ce.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_ARM64_CE_H
+#define __CRYPTO_ARM64_CE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_CRYPTO_ARM64_CE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* The probes read ID_AA64ISAR0_EL1 once, a kernel image built for a
+ * whole SoC family may run on cores with and without the extensions.
+ */
+
+bool arm64_ce_has_aes(void);
+bool arm64_ce_has_sha256(void);
+
+/* Single block AES with the key schedules of rijndael_key_setup_enc()
+ * and rijndael_key_setup_dec().
+ */
+
+void arm64_ce_aes_encrypt(FAR const uint32_t *rk, int nr,
+                          FAR const uint8_t *in, FAR uint8_t *out);
+void arm64_ce_aes_decrypt(FAR const uint32_t *rk, int nr,
+                          FAR const uint8_t *in, FAR uint8_t *out);
+
+/* One 64 byte SHA-256 block, 'k' is the table of round constants */
+
+void arm64_ce_sha256_transform(FAR uint32_t *state,
+                               FAR const uint8_t *data,
+                               FAR const uint32_t *k);
+
+#endif /* CONFIG_CRYPTO_ARM64_CE */
+#endif /* __CRYPTO_ARM64_CE_H */
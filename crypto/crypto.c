@@ -36,8 +36,11 @@
 #include <errno.h>
 #include <crypto/cryptodev.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/irq.h>
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/crypto/crypto.h>
 
 /****************************************************************************
@@ -53,6 +56,68 @@ int crypto_drivers_num = 0;
 
 static mutex_t g_crypto_lock = NXMUTEX_INITIALIZER;
 
+#ifdef CONFIG_CRYPTO_ASYNC
+/* Requests handed over by crypto_dispatch() and requests a driver has
+ * finished, both drained by crypto_worker().
+ */
+
+static TAILQ_HEAD(, cryptop) g_crypto_pending =
+  TAILQ_HEAD_INITIALIZER(g_crypto_pending);
+static TAILQ_HEAD(, cryptop) g_crypto_done =
+  TAILQ_HEAD_INITIALIZER(g_crypto_done);
+static struct work_s g_crypto_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_ASYNC
+static void crypto_worker(FAR void *arg)
+{
+  FAR struct cryptop *crp;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      /* Completions first, they free up room in the drivers */
+
+      flags = enter_critical_section();
+      crp = TAILQ_FIRST(&g_crypto_done);
+      if (crp != NULL)
+        {
+          TAILQ_REMOVE(&g_crypto_done, crp, crp_next);
+          leave_critical_section(flags);
+          crp->crp_callback(crp);
+          continue;
+        }
+
+      crp = TAILQ_FIRST(&g_crypto_pending);
+      if (crp != NULL)
+        {
+          TAILQ_REMOVE(&g_crypto_pending, crp, crp_next);
+        }
+
+      leave_critical_section(flags);
+
+      if (crp == NULL)
+        {
+          break;
+        }
+
+      /* A driver that queues the request to its engine completes it
+       * later through crypto_done().
+       */
+
+      if (crypto_invoke(crp) != -EINPROGRESS)
+        {
+          crp->crp_flags |= CRYPTO_F_DONE;
+          crp->crp_callback(crp);
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -587,7 +652,23 @@ int crypto_invoke(FAR struct cryptop *crp)
   crypto_drivers[hid].cc_bytes += crp->crp_ilen;
 
   error = crypto_drivers[hid].cc_process(crp);
-  if (error)
+  if (error == -EINPROGRESS)
+    {
+      /* The driver has queued the request and reports the completion
+       * through crypto_done().  Don't hold the lock meanwhile, the other
+       * sessions would be serialized behind this one.
+       */
+
+      nxmutex_unlock(&g_crypto_lock);
+      if (crp->crp_flags & CRYPTO_F_ASYNC)
+        {
+          return -EINPROGRESS;
+        }
+
+      nxsem_wait_uninterruptible(&crp->crp_sem);
+      return 0;
+    }
+  else if (error)
     {
       if (error == -ERESTART)
         {
@@ -624,6 +705,66 @@ migrate:
   return 0;
 }
 
+/* Called by a driver that returned -EINPROGRESS from its process method
+ * once the request has been finished.  May be called from an interrupt
+ * handler.
+ */
+
+void crypto_done(FAR struct cryptop *crp)
+{
+#ifdef CONFIG_CRYPTO_ASYNC
+  irqstate_t flags;
+#endif
+
+  crp->crp_flags |= CRYPTO_F_DONE;
+
+#ifdef CONFIG_CRYPTO_ASYNC
+  if (crp->crp_flags & CRYPTO_F_ASYNC)
+    {
+      flags = enter_critical_section();
+      TAILQ_INSERT_TAIL(&g_crypto_done, crp, crp_next);
+      if (work_available(&g_crypto_work))
+        {
+          work_queue(LPWORK, &g_crypto_work, crypto_worker, NULL, 0);
+        }
+
+      leave_critical_section(flags);
+      return;
+    }
+#endif
+
+  nxsem_post(&crp->crp_sem);
+}
+
+#ifdef CONFIG_CRYPTO_ASYNC
+/* Queue a request and return at once.  crp_callback is called from the
+ * low priority work queue when the request has been performed, so that a
+ * caller can keep several requests in flight on a hardware engine.
+ */
+
+int crypto_dispatch(FAR struct cryptop *crp)
+{
+  irqstate_t flags;
+
+  if (crp == NULL || crp->crp_callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  crp->crp_flags = (crp->crp_flags & ~CRYPTO_F_DONE) | CRYPTO_F_ASYNC;
+
+  flags = enter_critical_section();
+  TAILQ_INSERT_TAIL(&g_crypto_pending, crp, crp_next);
+  if (work_available(&g_crypto_work))
+    {
+      work_queue(LPWORK, &g_crypto_work, crypto_worker, NULL, 0);
+    }
+
+  leave_critical_section(flags);
+  return 0;
+}
+#endif
+
 /* Release a set of crypto descriptors. */
 
 void crypto_freereq(FAR struct cryptop *crp)
@@ -643,6 +784,7 @@ void crypto_freereq(FAR struct cryptop *crp)
       kmm_free(crd);
     }
 
+  nxsem_destroy(&crp->crp_sem);
   kmm_free(crp);
   nxmutex_unlock(&g_crypto_lock);
 }
@@ -664,6 +806,7 @@ FAR struct cryptop *crypto_getreq(int num)
     }
 
   bzero(crp, sizeof(struct cryptop));
+  nxsem_init(&crp->crp_sem, 0, 0);
 
   while (num--)
     {
@@ -683,6 +826,101 @@ FAR struct cryptop *crypto_getreq(int num)
   return crp;
 }
 
+/* Open a cipher session for kernel use.  The first driver that supports
+ * the algorithm wins and hardware drivers are tried before software.
+ */
+
+int crypto_cipher_init(FAR struct crypto_cipher_s *cc, uint32_t alg,
+                       FAR const void *key, size_t keylen)
+{
+  struct cryptoini cri;
+  int ret;
+
+  cc->key = kmm_malloc(keylen);
+  if (cc->key == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(cc->key, key, keylen);
+  cc->alg  = alg;
+  cc->klen = keylen * 8;
+
+  bzero(&cri, sizeof(cri));
+  cri.cri_alg  = alg;
+  cri.cri_klen = cc->klen;
+  cri.cri_key  = (caddr_t)cc->key;
+
+  ret = crypto_newsession(&cc->sid, &cri, 0);
+  if (ret < 0)
+    {
+      explicit_bzero(cc->key, keylen);
+      kmm_free(cc->key);
+      cc->key = NULL;
+    }
+
+  return ret;
+}
+
+/* Encrypt or decrypt 'len' bytes from 'src' to 'dst' (which may be the
+ * same buffer).  'iv' is updated as the algorithm chains, NULL for ECB.
+ */
+
+int crypto_cipher_run(FAR struct crypto_cipher_s *cc, FAR const void *src,
+                      FAR void *dst, size_t len, FAR void *iv,
+                      bool encrypt)
+{
+  FAR struct cryptodesc *crd;
+  FAR struct cryptop *crp;
+  int ret;
+
+  crp = crypto_getreq(1);
+  if (crp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  crd = crp->crp_desc;
+  crd->crd_len   = len;
+  crd->crd_alg   = cc->alg;
+  crd->crd_key   = (caddr_t)cc->key;
+  crd->crd_klen  = cc->klen;
+  crd->crd_flags = encrypt ? CRD_F_ENCRYPT : 0;
+
+  crp->crp_sid   = cc->sid;
+  crp->crp_ilen  = len;
+  crp->crp_flags = CRYPTO_F_IOV;
+  crp->crp_buf   = (caddr_t)src;
+  crp->crp_dst   = dst;
+  crp->crp_iv    = iv;
+
+  ret = crypto_invoke(crp);
+  if (ret == 0)
+    {
+      ret = crp->crp_etype;
+      if (ret == -EAGAIN)
+        {
+          /* The driver went away and the session has been migrated */
+
+          cc->sid = crp->crp_sid;
+        }
+    }
+
+  crypto_freereq(crp);
+  return ret;
+}
+
+void crypto_cipher_free(FAR struct crypto_cipher_s *cc)
+{
+  if (cc->key != NULL)
+    {
+      crypto_freesession(cc->sid);
+      explicit_bzero(cc->key, cc->klen / 8);
+      kmm_free(cc->key);
+      cc->key = NULL;
+    }
+}
+
 int crypto_getfeat(FAR int *featp)
 {
   extern int cryptodevallowsoft;
@@ -42,6 +42,8 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
@@ -132,9 +134,18 @@ static FAR struct csession *csecreate(FAR struct fcrypt *, uint64_t,
                                       caddr_t, uint64_t, uint32_t,
                                       uint32_t, bool, bool);
 static int csefree(FAR struct csession *);
+static int cserelease(FAR struct csession *);
+#if CONFIG_CRYPTO_CRYPTODEV_SESSION_CACHE > 0
+static FAR struct csession *csecache_get(uint32_t, FAR const void *, int);
+#endif
 
+static int cryptodev_prep(FAR struct csession *, FAR struct crypt_op *,
+                          FAR struct cryptop **);
+static int cryptodev_finish(FAR struct csession *, FAR struct crypt_op *,
+                            FAR struct cryptop *);
 static int cryptodev_op(FAR struct csession *,
                         FAR struct crypt_op *);
+static int cryptodev_mop(FAR struct fcrypt *, FAR struct crypt_mop *);
 static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
@@ -177,6 +188,19 @@ static struct inode g_cryptoinode =
   .u.i_ops = &g_cryptofops
 };
 
+#if CONFIG_CRYPTO_CRYPTODEV_SESSION_CACHE > 0
+/* Cipher sessions closed by userspace, most recently used first.  TLS
+ * and disk tools tend to open and close sessions with the same key over
+ * and over; setting up a hardware session is far more expensive than
+ * the lookup.
+ */
+
+static struct csessionlist g_csecache =
+  TAILQ_HEAD_INITIALIZER(g_csecache);
+static int g_csecache_num;
+static mutex_t g_csecache_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -266,6 +290,19 @@ static int cryptof_ioctl(FAR struct file *filep,
               return -EINVAL;
           }
 
+#if CONFIG_CRYPTO_CRYPTODEV_SESSION_CACHE > 0
+        if (txform && !thash)
+          {
+            cse = csecache_get(sop->cipher, sop->key, sop->keylen);
+            if (cse != NULL)
+              {
+                cseadd(fcr, cse);
+                sop->ses = cse->ses;
+                break;
+              }
+          }
+#endif
+
         bzero(&crie, sizeof(crie));
         bzero(&cria, sizeof(cria));
 
@@ -354,7 +391,7 @@ bail:
           }
 
         csedelete(fcr, cse);
-        error = csefree(cse);
+        error = cserelease(cse);
         break;
       case CIOCCRYPT:
         cop = (FAR struct crypt_op *)arg;
@@ -366,9 +403,27 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCCRYPTM:
+        error = cryptodev_mop(fcr, (FAR struct crypt_mop *)arg);
+        break;
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
+      case CIOCKEYM:
+        {
+          FAR struct crypt_kmop *kmop = (FAR struct crypt_kmop *)arg;
+          uint32_t i;
+
+          /* The key operations are independent, run them all and
+           * leave the result of each in its crk_status.
+           */
+
+          for (i = 0; i < kmop->count; i++)
+            {
+              cryptodev_key(fcr, &kmop->reqs[i]);
+            }
+        }
+        break;
       case CIOCKEYRET:
         error = cryptodev_getkeystatus(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -382,22 +437,23 @@ bail:
   return error;
 }
 
-static int cryptodev_op(FAR struct csession *cse,
-                        FAR struct crypt_op *cop)
+/* Build the request for one crypt_op */
+
+static int cryptodev_prep(FAR struct csession *cse,
+                          FAR struct crypt_op *cop,
+                          FAR struct cryptop **crpp)
 {
   FAR struct cryptop *crp = NULL;
   FAR struct cryptodesc *crde = NULL;
   FAR struct cryptodesc *crda = NULL;
   int error = OK;
-  uint32_t hid;
 
   /* number of requests, not logical and */
 
   crp = crypto_getreq(cse->txform + cse->thash);
   if (crp == NULL)
     {
-      error = -ENOMEM;
-      goto bail;
+      return -ENOMEM;
     }
 
   if (cse->thash)
@@ -494,6 +550,48 @@ static int cryptodev_op(FAR struct csession *cse,
       crp->crp_mac = cop->mac;
     }
 
+  *crpp = crp;
+  return OK;
+
+bail:
+  crypto_freereq(crp);
+  return error;
+}
+
+/* Collect the result of a request built by cryptodev_prep() and free it */
+
+static int cryptodev_finish(FAR struct csession *cse,
+                            FAR struct crypt_op *cop,
+                            FAR struct cryptop *crp)
+{
+  int error = OK;
+
+  if (cse->error)
+    {
+      error = cse->error;
+    }
+  else if (crp->crp_etype != 0)
+    {
+      error = crp->crp_etype;
+    }
+
+  crypto_freereq(crp);
+  return error;
+}
+
+static int cryptodev_op(FAR struct csession *cse,
+                        FAR struct crypt_op *cop)
+{
+  FAR struct cryptop *crp;
+  uint32_t hid;
+  int error;
+
+  error = cryptodev_prep(cse, cop, &crp);
+  if (error < 0)
+    {
+      return error;
+    }
+
   /* try the fast path first */
 
   crp->crp_flags = CRYPTO_F_IOV | CRYPTO_F_NOQUEUE;
@@ -514,7 +612,14 @@ static int cryptodev_op(FAR struct csession *cse,
     }
 
   error = crypto_drivers[hid].cc_process(crp);
-  if (error)
+  if (error == -EINPROGRESS)
+    {
+      /* Queued to the engine, crypto_done() wakes us up */
+
+      nxsem_wait_uninterruptible(&crp->crp_sem);
+      goto processed;
+    }
+  else if (error)
     {
       /* clear error */
 
@@ -527,29 +632,119 @@ dispatch:
   crp->crp_flags = CRYPTO_F_IOV;
   crypto_invoke(crp);
 processed:
+  return cryptodev_finish(cse, cop, crp);
+}
+
+#ifdef CONFIG_CRYPTO_ASYNC
+static int cryptodev_mop_cb(FAR struct cryptop *crp)
+{
+  nxsem_post(crp->crp_opaque);
+  return OK;
+}
+#endif
+
+/* CIOCCRYPTM: with CONFIG_CRYPTO_ASYNC all requests are dispatched before
+ * the first one is waited for, so that an engine with a descriptor queue
+ * never runs dry in between.  Otherwise they run one after the other.
+ */
+
+static int cryptodev_mop(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+#ifdef CONFIG_CRYPTO_ASYNC
+  FAR struct cryptop **crps;
+  FAR struct csession *cse;
+  sem_t done;
+  uint32_t ndispatched = 0;
+#endif
+  int error = OK;
+  uint32_t i;
+  int ret;
 
-  if (crde && (cop->flags & COP_FLAG_UPDATE) == 0)
+  if (mop == NULL || mop->reqs == NULL || mop->count == 0)
     {
-      crde->crd_flags &= ~CRD_F_IV_EXPLICIT;
+      return -EINVAL;
     }
 
-  if (cse->error)
+#ifdef CONFIG_CRYPTO_ASYNC
+  crps = kmm_zalloc(mop->count * sizeof(FAR struct cryptop *));
+  if (crps == NULL)
     {
-      error = cse->error;
-      goto bail;
+      return -ENOMEM;
     }
 
-  if (crp->crp_etype != 0)
+  nxsem_init(&done, 0, 0);
+
+  for (i = 0; i < mop->count; i++)
     {
-      error = crp->crp_etype;
-      goto bail;
+      cse = csefind(fcr, mop->reqs[i].ses);
+      ret = cse != NULL ? cryptodev_prep(cse, &mop->reqs[i], &crps[i]) :
+                          -EINVAL;
+      if (ret == OK)
+        {
+          crps[i]->crp_flags = CRYPTO_F_IOV;
+          crps[i]->crp_callback = cryptodev_mop_cb;
+          crps[i]->crp_opaque = &done;
+          ret = crypto_dispatch(crps[i]);
+          if (ret == OK)
+            {
+              ndispatched++;
+              continue;
+            }
+
+          crypto_freereq(crps[i]);
+          crps[i] = NULL;
+        }
+
+      if (mop->status != NULL)
+        {
+          mop->status[i] = ret;
+        }
+
+      error = ret;
     }
 
-bail:
-  if (crp)
+  while (ndispatched-- > 0)
+    {
+      nxsem_wait_uninterruptible(&done);
+    }
+
+  for (i = 0; i < mop->count; i++)
     {
-      crypto_freereq(crp);
+      if (crps[i] != NULL)
+        {
+          ret = cryptodev_finish(csefind(fcr, mop->reqs[i].ses),
+                                 &mop->reqs[i], crps[i]);
+          if (mop->status != NULL)
+            {
+              mop->status[i] = ret;
+            }
+
+          if (ret < 0)
+            {
+              error = ret;
+            }
+        }
+    }
+
+  nxsem_destroy(&done);
+  kmm_free(crps);
+#else
+  for (i = 0; i < mop->count; i++)
+    {
+      FAR struct csession *cse = csefind(fcr, mop->reqs[i].ses);
+
+      ret = cse != NULL ? cryptodev_op(cse, &mop->reqs[i]) : -EINVAL;
+      if (mop->status != NULL)
+        {
+          mop->status[i] = ret;
+        }
+
+      if (ret < 0)
+        {
+          error = ret;
+        }
     }
+#endif
 
   return error;
 }
@@ -841,7 +1036,7 @@ static int cryptof_close(FAR struct file *filep)
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
       TAILQ_REMOVE(&fcr->csessions, cse, next);
-      (void)csefree(cse);
+      (void)cserelease(cse);
     }
 
   while ((krp = TAILQ_FIRST(&fcr->crpk_ret)))
@@ -1128,6 +1323,68 @@ static int csefree(FAR struct csession *cse)
   return error;
 }
 
+/* Give up a session of a closing fd or CIOCFSESSION.  Cipher-only
+ * sessions go to the cache instead of being torn down; hash sessions
+ * may carry the state of an unfinished COP_FLAG_UPDATE digest and are
+ * never reused.
+ */
+
+static int cserelease(FAR struct csession *cse)
+{
+#if CONFIG_CRYPTO_CRYPTODEV_SESSION_CACHE > 0
+  FAR struct csession *old = NULL;
+
+  if (!cse->txform || cse->thash || cse->error != 0)
+    {
+      return csefree(cse);
+    }
+
+  nxmutex_lock(&g_csecache_lock);
+  TAILQ_INSERT_HEAD(&g_csecache, cse, next);
+  if (++g_csecache_num > CONFIG_CRYPTO_CRYPTODEV_SESSION_CACHE)
+    {
+      old = TAILQ_LAST(&g_csecache, csessionlist);
+      TAILQ_REMOVE(&g_csecache, old, next);
+      g_csecache_num--;
+    }
+
+  nxmutex_unlock(&g_csecache_lock);
+
+  if (old != NULL)
+    {
+      explicit_bzero(old->key, old->keylen);
+      csefree(old);
+    }
+
+  return OK;
+#else
+  return csefree(cse);
+#endif
+}
+
+#if CONFIG_CRYPTO_CRYPTODEV_SESSION_CACHE > 0
+static FAR struct csession *csecache_get(uint32_t cipher,
+                                         FAR const void *key, int keylen)
+{
+  FAR struct csession *cse;
+
+  nxmutex_lock(&g_csecache_lock);
+  TAILQ_FOREACH(cse, &g_csecache, next)
+    {
+      if (cse->cipher == cipher && cse->keylen == keylen &&
+          memcmp(cse->key, key, keylen) == 0)
+        {
+          TAILQ_REMOVE(&g_csecache, cse, next);
+          g_csecache_num--;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_csecache_lock);
+  return cse;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
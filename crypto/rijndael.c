@@ -31,10 +31,14 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/param.h>
 
 #include <crypto/rijndael.h>
 
+#include "arm64_ce.h"
+
 #undef FULL_UNROLL
 
 /* TE0[x] = S [x].[02, 01, 01, 03];
@@ -1403,6 +1407,14 @@ void rijndael_decrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  if (arm64_ce_has_aes())
+    {
+      arm64_ce_aes_decrypt(ctx->dk, ctx->nr, src, dst);
+      return;
+    }
+#endif
+
   rijndaeldecrypt(ctx->dk, ctx->nr, src, dst);
 }
 
@@ -1410,5 +1422,13 @@ void rijndael_encrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  if (arm64_ce_has_aes())
+    {
+      arm64_ce_aes_encrypt(ctx->ek, ctx->nr, src, dst);
+      return;
+    }
+#endif
+
   rijndaelencrypt(ctx->ek, ctx->nr, src, dst);
 }
@@ -38,11 +38,15 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <endian.h>
 #include <string.h>
 #include <sys/time.h>
 #include <crypto/sha2.h>
 
+#include "arm64_ce.h"
+
 /* UNROLLED TRANSFORM LOOP NOTE:
  * You can define SHA2_UNROLL_TRANSFORM to use the unrolled transform
  * loop version for the hash transform rounds (defined using macros
@@ -364,6 +368,14 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
   uint32_t W256[16];
   int j;
 
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  if (arm64_ce_has_sha256())
+    {
+      arm64_ce_sha256_transform(state, data, K256);
+      return;
+    }
+#endif
+
   /* Initialize registers with the prev. intermediate value */
 
   a = state[0];
@@ -441,6 +453,14 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
   uint32_t W256[16];
   int j;
 
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  if (arm64_ce_has_sha256())
+    {
+      arm64_ce_sha256_transform(state, data, K256);
+      return;
+    }
+#endif
+
   /* Initialize registers with the prev. intermediate value */
 
   a = state[0];
@@ -30,13 +30,19 @@
 #include <poll.h>
 #include <errno.h>
 #include <debug.h>
+#include <inttypes.h>
+#include <syslog.h>
 
 #include <sys/param.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
+#include <crypto/rijndael.h>
+#include <crypto/sha2.h>
+
 #ifdef CONFIG_CRYPTO_ALGTEST
 
 #include "testmngr.h"
@@ -106,6 +112,117 @@ static int test_aes(void)
 }
 #endif
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+static void bench_report(FAR const char *name, size_t bytes,
+                         clock_t elapsed)
+{
+  struct timespec ts;
+  uint64_t us;
+
+  perf_convert(elapsed, &ts);
+  us = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+  syslog(LOG_INFO, "%s: %zu bytes in %" PRIu64 " us, %" PRIu64 " KiB/s\n",
+         name, bytes, us, us ? (uint64_t)bytes * 1000000 / 1024 / us : 0);
+}
+
+/* Known answer checks of the software primitives (whichever
+ * implementation is dispatched to) followed by a throughput run.
+ */
+
+static int bench_sw(void)
+{
+  static const uint8_t aes_key[16] =
+  {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+  };
+
+  static const uint8_t aes_pt[16] =
+  {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+  };
+
+  static const uint8_t aes_ct[16] =
+  {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+  };
+
+  static const uint8_t sha_abc[32] =
+  {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+    0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+    0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+  };
+
+  const size_t size = 4096;
+  rijndael_ctx ctx;
+  SHA2_CTX sha;
+  uint8_t digest[32];
+  uint8_t block[16];
+  FAR uint8_t *buf;
+  clock_t start;
+  size_t i;
+
+  rijndael_set_key(&ctx, aes_key, 128);
+  rijndael_encrypt(&ctx, aes_pt, block);
+  if (memcmp(block, aes_ct, 16) != 0)
+    {
+      crypterr("ERROR: rijndael encrypt known answer\n");
+      return -1;
+    }
+
+  rijndael_decrypt(&ctx, aes_ct, block);
+  if (memcmp(block, aes_pt, 16) != 0)
+    {
+      crypterr("ERROR: rijndael decrypt known answer\n");
+      return -1;
+    }
+
+  sha256init(&sha);
+  sha256update(&sha, "abc", 3);
+  sha256final(digest, &sha);
+  if (memcmp(digest, sha_abc, 32) != 0)
+    {
+      crypterr("ERROR: sha256 known answer\n");
+      return -1;
+    }
+
+  buf = kmm_zalloc(size);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  start = perf_gettime();
+  for (i = 0; i < size; i += 16)
+    {
+      rijndael_encrypt(&ctx, buf + i, buf + i);
+    }
+
+  bench_report("aes128 encrypt", size, perf_gettime() - start);
+
+  start = perf_gettime();
+  for (i = 0; i < size; i += 16)
+    {
+      rijndael_decrypt(&ctx, buf + i, buf + i);
+    }
+
+  bench_report("aes128 decrypt", size, perf_gettime() - start);
+
+  start = perf_gettime();
+  sha256init(&sha);
+  sha256update(&sha, buf, size);
+  sha256final(digest, &sha);
+  bench_report("sha256", size, perf_gettime() - start);
+
+  kmm_free(buf);
+  return OK;
+}
+#endif
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -115,6 +232,13 @@ int crypto_test(void)
     }
 #endif
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+  if (bench_sw())
+    {
+      return -1;
+    }
+#endif
+
   return OK;
 }
 
@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <sys/param.h>
 #include <nuttx/audio/audio_dma.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
@@ -46,9 +47,14 @@ struct audio_dma_s
   uint8_t fifo_width;
   bool playback;
   bool xrun;
+  bool ring;          /* Period ring mapped by the application */
   struct dq_queue_s pendq;
   apb_samp_t buffer_size;
   apb_samp_t buffer_num;
+  uint32_t hwptr;     /* Bytes transferred by the DMA in ring mode */
+  uint32_t applptr;   /* Bytes written/consumed by the application */
+  uint32_t wakeup;    /* Periods between AUDIO_MSG_PERIOD messages */
+  uint32_t nperiods;  /* Periods since the last AUDIO_MSG_PERIOD */
 };
 
 /****************************************************************************
@@ -320,6 +326,9 @@ static int audio_dma_stop(struct audio_lowerhalf_s *dev)
                        NULL, OK);
 #endif
   audio_dma->xrun = false;
+  audio_dma->hwptr = 0;
+  audio_dma->applptr = 0;
+  audio_dma->nperiods = 0;
   return OK;
 }
 #endif
@@ -344,7 +353,7 @@ static int audio_dma_resume(struct audio_lowerhalf_s *dev)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
 
-  if (dq_empty(&audio_dma->pendq))
+  if (!audio_dma->ring && dq_empty(&audio_dma->pendq))
     {
       return -EINVAL;
     }
@@ -353,36 +362,48 @@ static int audio_dma_resume(struct audio_lowerhalf_s *dev)
 }
 #endif
 
+static int audio_dma_allocring(struct audio_dma_s *audio_dma)
+{
+  if (!audio_dma->alloc_addr)
+    {
+      audio_dma->alloc_addr = kumm_memalign(32,
+                                            audio_dma->buffer_num *
+                                            audio_dma->buffer_size);
+      if (!audio_dma->alloc_addr)
+        {
+          return -ENOMEM;
+        }
+
+      if (audio_dma->playback)
+        audio_dma->src_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+      else
+        audio_dma->dst_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+    }
+
+  return OK;
+}
+
 static int audio_dma_allocbuffer(struct audio_lowerhalf_s *dev,
                                  struct audio_buf_desc_s *bufdesc)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
   struct ap_buffer_s *apb;
+  int ret;
 
   if (bufdesc->numbytes != audio_dma->buffer_size)
     {
       return -EINVAL;
     }
 
-  if (audio_dma->alloc_index == audio_dma->buffer_num)
+  if (audio_dma->ring || audio_dma->alloc_index == audio_dma->buffer_num)
     {
       return -ENOMEM;
     }
 
-  if (!audio_dma->alloc_addr)
+  ret = audio_dma_allocring(audio_dma);
+  if (ret < 0)
     {
-      audio_dma->alloc_addr = kumm_memalign(32,
-                                            audio_dma->buffer_num *
-                                            audio_dma->buffer_size);
-      if (!audio_dma->alloc_addr)
-        {
-          return -ENOMEM;
-        }
-
-      if (audio_dma->playback)
-        audio_dma->src_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
-      else
-        audio_dma->dst_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+      return ret;
     }
 
   apb = kumm_zalloc(sizeof(struct ap_buffer_s));
@@ -454,11 +475,126 @@ static int audio_dma_enqueuebuffer(struct audio_lowerhalf_s *dev,
   return OK;
 }
 
+static void audio_dma_ringcache(struct audio_dma_s *audio_dma,
+                                uint32_t from, uint32_t to)
+{
+  uint32_t size = audio_dma->buffer_num * audio_dma->buffer_size;
+  uintptr_t base = (uintptr_t)audio_dma->alloc_addr;
+  uint32_t len = MIN(to - from, size);
+  uint32_t off = from % size;
+  uint32_t n;
+
+  /* Clean (playback) or invalidate (capture) [from, to) of the ring */
+
+  while (len > 0)
+    {
+      n = MIN(len, size - off);
+      if (audio_dma->playback)
+        up_clean_dcache(base + off, base + off + n);
+      else
+        up_invalidate_dcache(base + off, base + off + n);
+
+      len -= n;
+      off  = 0;
+    }
+}
+
+static int audio_dma_syncpointer(struct audio_dma_s *audio_dma,
+                                 struct audio_pointer_s *ptr)
+{
+  uint32_t size = audio_dma->buffer_num * audio_dma->buffer_size;
+  irqstate_t flags;
+  int ret = OK;
+
+  /* Samples the application wrote since the last sync must reach memory
+   * before the DMA reads them.
+   */
+
+  if (audio_dma->playback)
+    {
+      audio_dma_ringcache(audio_dma, audio_dma->applptr, ptr->applptr);
+    }
+
+  flags = enter_critical_section();
+
+  audio_dma->applptr = ptr->applptr;
+  ptr->hwptr = audio_dma->hwptr;
+
+  if (audio_dma->playback)
+    {
+      /* Free space ahead of the DMA */
+
+      ptr->avail = size - (ptr->applptr - ptr->hwptr);
+      if (audio_dma->xrun &&
+          ptr->applptr - ptr->hwptr >= audio_dma->buffer_size)
+        {
+          audio_dma->xrun = false;
+          ret = DMA_RESUME(audio_dma->chan);
+        }
+    }
+  else
+    {
+      /* Captured bytes not yet consumed, more than the ring is an overrun */
+
+      ptr->avail = ptr->hwptr - ptr->applptr;
+      if (ptr->avail > size)
+        {
+          ret = -EPIPE;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+static void audio_dma_period_done(struct audio_dma_s *audio_dma)
+{
+  struct audio_msg_s msg;
+
+  if (!audio_dma->playback)
+    {
+      audio_dma_ringcache(audio_dma, audio_dma->hwptr,
+                          audio_dma->hwptr + audio_dma->buffer_size);
+    }
+
+  audio_dma->hwptr += audio_dma->buffer_size;
+
+  /* Underrun: the application has not filled the next period yet */
+
+  if (audio_dma->playback &&
+      audio_dma->applptr - audio_dma->hwptr < audio_dma->buffer_size)
+    {
+      DMA_PAUSE(audio_dma->chan);
+      audio_dma->xrun = true;
+    }
+
+  /* Wake the application only every 'wakeup' periods */
+
+  if (++audio_dma->nperiods < audio_dma->wakeup)
+    {
+      return;
+    }
+
+  audio_dma->nperiods = 0;
+  msg.msg_id = AUDIO_MSG_PERIOD;
+  msg.u.data = audio_dma->hwptr;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_MESSAGE,
+                       (struct ap_buffer_s *)&msg, OK, NULL);
+#else
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_MESSAGE,
+                       (struct ap_buffer_s *)&msg, OK);
+#endif
+}
+
 static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
                            unsigned long arg)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
   struct ap_buffer_info_s *bufinfo;
+  struct audio_ring_s *ring;
+  int ret;
 
   switch (cmd)
     {
@@ -480,6 +616,52 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
         kumm_free(audio_dma->alloc_addr);
         audio_dma->alloc_addr = NULL;
         audio_dma->alloc_index = 0;
+        audio_dma->ring = false;
+
+        return OK;
+
+      /* Switch to ring mode and report the period ring */
+
+      case AUDIOIOC_GETRING:
+        audinfo("AUDIOIOC_GETRING:\n");
+        if (audio_dma->alloc_index != 0)
+          {
+            return -EBUSY;
+          }
+
+        ret = audio_dma_allocring(audio_dma);
+        if (ret < 0)
+          {
+            return ret;
+          }
+
+        if (!audio_dma->ring)
+          {
+            audio_dma->ring     = true;
+            audio_dma->hwptr    = 0;
+            audio_dma->applptr  = 0;
+            audio_dma->nperiods = 0;
+          }
+
+        ring               = (struct audio_ring_s *)arg;
+        ring->base         = audio_dma->alloc_addr;
+        ring->period_bytes = audio_dma->buffer_size;
+        ring->nperiods     = audio_dma->buffer_num;
+
+        return OK;
+
+      case AUDIOIOC_SYNCPOINTER:
+        if (!audio_dma->ring)
+          {
+            return -EINVAL;
+          }
+
+        return audio_dma_syncpointer(audio_dma,
+                                     (struct audio_pointer_s *)arg);
+
+      case AUDIOIOC_SETPERIODWAKEUP:
+        audinfo("AUDIOIOC_SETPERIODWAKEUP: %lu\n", arg);
+        audio_dma->wakeup = MAX(arg, 1);
 
         return OK;
     }
@@ -512,6 +694,12 @@ static void audio_dma_callback(struct dma_chan_s *chan,
   struct ap_buffer_s *apb;
   bool final = false;
 
+  if (audio_dma->ring)
+    {
+      audio_dma_period_done(audio_dma);
+      return;
+    }
+
   apb = (struct ap_buffer_s *)dq_remfirst(&audio_dma->pendq);
   if (!apb)
     {
@@ -593,6 +781,7 @@ struct audio_lowerhalf_s *audio_dma_initialize(struct dma_dev_s *dma_dev,
 
   audio_dma->buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
   audio_dma->buffer_num  = CONFIG_AUDIO_NUM_BUFFERS;
+  audio_dma->wakeup      = 1;
   dq_init(&audio_dma->pendq);
 
   audio_dma->dev.ops = &g_audio_dma_ops;
@@ -34,7 +34,9 @@
 #include <stdbool.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -42,25 +44,53 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#if CONFIG_BCH_CACHE_SECTORS < 1 || CONFIG_BCH_CACHE_WAYS < 1 || \
+    CONFIG_BCH_CACHE_SECTORS % CONFIG_BCH_CACHE_WAYS != 0
+#  error CONFIG_BCH_CACHE_SECTORS must be a multiple of CONFIG_BCH_CACHE_WAYS
+#endif
+
+#define BCH_CACHE_SETS    (CONFIG_BCH_CACHE_SECTORS / CONFIG_BCH_CACHE_WAYS)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One entry of the sector cache */
+
+struct bchlib_cache_s
+{
+  size_t sector;           /* The sector in the buffer, (size_t)-1 if none */
+  uint32_t stamp;          /* Last use, for LRU replacement within the set */
+  bool dirty;              /* true: Data has been written to the buffer */
+  FAR uint8_t *buffer;     /* One sector buffer */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  uint32_t stamp;          /* Clock of the LRU replacement */
+  struct bchlib_cache_s cache[CONFIG_BCH_CACHE_SECTORS];
+
+#if CONFIG_BCH_WRITEBACK_DELAY > 0
+  struct work_s work;      /* Deferred write-back of dirty sectors */
+#endif
+
+#ifdef CONFIG_FS_BLKQUEUE
+  FAR struct blkqueue_s *queue; /* Request queue for asynchronous I/O */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-  uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
+  FAR uint8_t *tweak;      /* One sector of XEX tweaks, may be NULL */
+
+  /* Encryption key */
+
+  uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];
 #endif
 };
 
@@ -84,7 +114,19 @@ EXTERN const struct file_operations g_bch_fops;
  ****************************************************************************/
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors, bool discard);
+EXTERN void bchlib_discardrange(FAR struct bchlib_s *bch, size_t sector,
+                                size_t nsectors);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                              FAR struct bchlib_cache_s **cache);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch,
+                               FAR struct bchlib_cache_s *cache);
+EXTERN int  bchlib_readdirect(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                              size_t sector, size_t nsectors);
+EXTERN int  bchlib_writedirect(FAR struct bchlib_s *bch,
+                               FAR const uint8_t *buffer, size_t sector,
+                               size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
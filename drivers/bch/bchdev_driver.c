@@ -39,6 +39,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/drivers/drivers.h>
@@ -49,6 +50,23 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* An asynchronous transfer forwarded to the block driver */
+
+struct bch_aio_s
+{
+#ifdef CONFIG_FS_BLKQUEUE
+  struct blkqueue_req_s blkreq;  /* Sector based request to the queue */
+#else
+  struct fs_aio_s      blkaio;   /* Sector based request to the driver */
+#endif
+  FAR struct fs_aio_s *aio;      /* Byte based request of the caller */
+  uint32_t             sectsize; /* Sector size used for the conversion */
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -56,14 +74,15 @@
 static int     bch_open(FAR struct file *filep);
 static int     bch_close(FAR struct file *filep);
 static off_t   bch_seek(FAR struct file *filep, off_t offset, int whence);
-static ssize_t bch_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen);
-static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen);
+static ssize_t bch_readv(FAR struct file *filep,
+                         FAR const struct uio *uio);
+static ssize_t bch_writev(FAR struct file *filep,
+                          FAR const struct uio *uio);
 static int     bch_ioctl(FAR struct file *filep, int cmd,
                          unsigned long arg);
 static int     bch_poll(FAR struct file *filep, FAR struct pollfd *fds,
                         bool setup);
+static int     bch_aio(FAR struct file *filep, FAR struct fs_aio_s *aio);
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     bch_unlink(FAR struct inode *inode);
 #endif
@@ -76,18 +95,19 @@ const struct file_operations g_bch_fops =
 {
   bch_open,    /* open */
   bch_close,   /* close */
-  bch_read,    /* read */
-  bch_write,   /* write */
+  NULL,        /* read */
+  NULL,        /* write */
   bch_seek,    /* seek */
   bch_ioctl,   /* ioctl */
   NULL,        /* mmap */
   NULL,        /* truncate */
   bch_poll,    /* poll */
-  NULL,        /* readv */
-  NULL         /* writev */
+  bch_readv,   /* readv */
+  bch_writev   /* writev */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , bch_unlink /* unlink */
 #endif
+  , bch_aio    /* aio */
 };
 
 /****************************************************************************
@@ -289,14 +309,21 @@ static off_t bch_seek(FAR struct file *filep, off_t offset, int whence)
 }
 
 /****************************************************************************
- * Name: bch_read
+ * Name: bch_readv
+ *
+ * Description:
+ *   Read into each user buffer in turn with the device lock held, so a
+ *   vector is transferred through the sector cache in a single pass.
+ *
  ****************************************************************************/
 
-static ssize_t bch_read(FAR struct file *filep, FAR char *buffer, size_t len)
+static ssize_t bch_readv(FAR struct file *filep, FAR const struct uio *uio)
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct bchlib_s *bch;
+  ssize_t nread = 0;
   ssize_t ret;
+  int i;
 
   DEBUGASSERT(inode->i_private);
   bch = inode->i_private;
@@ -307,26 +334,40 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  ret = bchlib_read(bch, buffer, filep->f_pos, len);
-  if (ret > 0)
+  for (i = 0; i < uio->uio_iovcnt; i++)
     {
+      FAR const struct iovec *iov = &uio->uio_iov[i];
+
+      ret = bchlib_read(bch, iov->iov_base, filep->f_pos, iov->iov_len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
       filep->f_pos += ret;
+      nread        += ret;
+
+      if (ret < iov->iov_len)
+        {
+          break;
+        }
     }
 
   nxmutex_unlock(&bch->lock);
-  return ret;
+  return nread > 0 ? nread : ret;
 }
 
 /****************************************************************************
- * Name: bch_write
+ * Name: bch_writev
  ****************************************************************************/
 
-static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t len)
+static ssize_t bch_writev(FAR struct file *filep, FAR const struct uio *uio)
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct bchlib_s *bch;
+  ssize_t nwritten = 0;
   ssize_t ret = -EACCES;
+  int i;
 
   DEBUGASSERT(inode->i_private);
   bch = inode->i_private;
@@ -339,15 +380,159 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
           return ret;
         }
 
-      ret = bchlib_write(bch, buffer, filep->f_pos, len);
-      if (ret > 0)
+      for (i = 0; i < uio->uio_iovcnt; i++)
         {
+          FAR const struct iovec *iov = &uio->uio_iov[i];
+
+          ret = bchlib_write(bch, iov->iov_base, filep->f_pos,
+                             iov->iov_len);
+          if (ret <= 0)
+            {
+              break;
+            }
+
           filep->f_pos += ret;
+          nwritten     += ret;
+
+          if (ret < iov->iov_len)
+            {
+              break;
+            }
         }
 
       nxmutex_unlock(&bch->lock);
     }
 
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: bch_aio_complete
+ *
+ * Description:
+ *   Completion of a forwarded transfer, possibly at interrupt level.
+ *
+ ****************************************************************************/
+
+static void bch_aio_complete(FAR struct fs_aio_s *blkaio, ssize_t result)
+{
+  FAR struct bch_aio_s *req = blkaio->priv;
+  FAR struct fs_aio_s *aio = req->aio;
+
+  if (result > 0)
+    {
+      result *= req->sectsize;
+    }
+
+  kmm_free(req);
+  aio->complete(aio, result);
+}
+
+/****************************************************************************
+ * Name: bch_aio
+ *
+ * Description:
+ *   Hand a sector aligned transfer directly to the block driver if it
+ *   supports asynchronous transfers, or to its request queue.  Anything
+ *   else is left to the synchronous path through the sector cache.
+ *
+ ****************************************************************************/
+
+static int bch_aio(FAR struct file *filep, FAR struct fs_aio_s *aio)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bch_aio_s *req;
+  FAR struct fs_aio_s *blkaio;
+  FAR struct bchlib_s *bch;
+  size_t nsectors;
+  size_t sector;
+  int ret;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+#ifdef CONFIG_BCH_ENCRYPTION
+  /* Data must pass through the sector buffer to be encrypted */
+
+  return -ENOSYS;
+#endif
+
+#ifdef CONFIG_FS_BLKQUEUE
+  if (bch->queue == NULL || aio->nbytes == 0 ||
+#else
+  if (bch->inode->u.i_bops->aio == NULL || aio->nbytes == 0 ||
+#endif
+      aio->offset % bch->sectsize != 0 || aio->nbytes % bch->sectsize != 0)
+    {
+      return -ENOSYS;
+    }
+
+  if (aio->write && bch->readonly)
+    {
+      return -EACCES;
+    }
+
+  sector = aio->offset / bch->sectsize;
+  if (sector >= bch->nsectors)
+    {
+      return -ENOSYS;
+    }
+
+  nsectors = aio->nbytes / bch->sectsize;
+  if (nsectors > bch->nsectors - sector)
+    {
+      nsectors = bch->nsectors - sector;
+    }
+
+  req = kmm_malloc(sizeof(struct bch_aio_s));
+  if (req == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#ifdef CONFIG_FS_BLKQUEUE
+  blkaio = &req->blkreq.aio;
+#else
+  blkaio = &req->blkaio;
+#endif
+
+  req->aio         = aio;
+  req->sectsize    = bch->sectsize;
+  blkaio->buf      = aio->buf;
+  blkaio->nbytes   = nsectors;
+  blkaio->offset   = sector;
+  blkaio->write    = aio->write;
+  blkaio->complete = bch_aio_complete;
+  blkaio->priv     = req;
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      kmm_free(req);
+      return ret;
+    }
+
+  /* Write back a cached sector inside the range first.  A write also
+   * discards it so that later cached reads see the new data.
+   */
+
+  ret = bchlib_flushrange(bch, sector, nsectors, aio->write);
+  if (ret >= 0)
+    {
+#ifdef CONFIG_FS_BLKQUEUE
+      ret = blkqueue_submit(bch->queue, &req->blkreq);
+#else
+      ret = bch->inode->u.i_bops->aio(bch->inode, blkaio);
+#endif
+    }
+
+  nxmutex_unlock(&bch->lock);
+
+  if (ret < 0)
+    {
+      kmm_free(req);
+    }
+
   return ret;
 }
 
@@ -424,6 +609,39 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* Forget the cached copies of discarded sectors without writing
+       * them back, then let the block driver release the media.
+       */
+
+      case BIOC_DISCARD:
+        {
+          FAR const struct blk_discard_s *range =
+            (FAR const struct blk_discard_s *)((uintptr_t)arg);
+          FAR struct inode *bchinode = bch->inode;
+
+          if (range == NULL || range->start < 0 || range->nsectors < 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          bchlib_discardrange(bch, range->start, range->nsectors);
+          nxmutex_unlock(&bch->lock);
+
+          ret = -ENOTTY;
+          if (bchinode->u.i_bops->ioctl != NULL)
+            {
+              ret = bchinode->u.i_bops->ioctl(bchinode, cmd, arg);
+            }
+        }
+        break;
+
 #ifdef CONFIG_BCH_ENCRYPTION
       /* This is a request to set the encryption key? */
 
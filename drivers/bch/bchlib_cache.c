@@ -25,10 +25,13 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -62,29 +65,56 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
+  FAR uint32_t *X = (FAR uint32_t *)bch->tweak;
+  uint32_t onex[4];
+  int n = blocks;
   int i;
+  int j;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  /* Each aes_cypher() call sets up the key (and on most chips the AES
+   * peripheral), so do a whole sector per call: first all the tweaks,
+   * then all the data.  Without the scratch buffer go block by block.
+   */
+
+  if (X == NULL)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
+      X = onex;
+      n = 1;
+    }
+
+  for (i = 0; i < blocks; i += n, buffer += n * 4)
+    {
+      for (j = 0; j < n; j++)
+        {
+          X[j * 4 + 0] = sector;
+          X[j * 4 + 1] = 0;
+          X[j * 4 + 2] = 0;
+          X[j * 4 + 3] = i + j;
+        }
 
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
+      aes_cypher(X, X, n * 16, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB,
+                 CYPHER_ENCRYPT);
 
       /* Xor-Encrypt-Xor */
 
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (j = 0; j < n * 4; j += 4)
+        {
+          bch_xor(&buffer[j], &X[j], &buffer[j]);
+        }
+
+      aes_cypher(buffer, buffer, n * 16, NULL, bch->key,
+                 CONFIG_BCH_ENCRYPTION_KEY_SIZE, AES_MODE_ECB, encrypt);
+
+      for (j = 0; j < n * 4; j += 4)
+        {
+          bch_xor(&buffer[j], &X[j], &buffer[j]);
+        }
     }
 
   return OK;
@@ -92,122 +122,434 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bch_writeback
+ *
+ * Description:
+ *   Write back the dirty sectors from the work queue.
+ *
  ****************************************************************************/
 
+#if CONFIG_BCH_WRITEBACK_DELAY > 0
+static void bch_writeback(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = arg;
+
+  if (nxmutex_lock(&bch->lock) >= 0)
+    {
+      bchlib_flushsector(bch, false);
+      nxmutex_unlock(&bch->lock);
+    }
+}
+#endif
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_writesector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write one cache entry back to the media if it is dirty
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+static int bch_writesector(FAR struct bchlib_s *bch,
+                           FAR struct bchlib_cache_s *cache)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+
+  if (!cache->dirty)
+    {
+      return OK;
+    }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
+
+  bch_cypher(bch, cache->buffer, cache->sector, CYPHER_ENCRYPT);
+#endif
+
+  /* Write the sector to the media */
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
+  ret = inode->u.i_bops->write(inode, cache->buffer, cache->sector, 1);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Computation overhead to save memory for extra sector buffer
+   * TODO: Add configuration switch for extra sector buffer
    */
 
-  if (bch->dirty && bch->buffer != NULL)
+  bch_cypher(bch, cache->buffer, cache->sector, CYPHER_DECRYPT);
+#endif
+
+  if (ret < 0)
     {
-      inode = bch->inode;
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Encrypt data as necessary */
+  /* The sector is now in sync with the media */
+
+  cache->dirty = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bch_findsector
+ *
+ * Description:
+ *   Return the cache entry holding a sector, or NULL if it is not cached
+ *
+ ****************************************************************************/
+
+static FAR struct bchlib_cache_s *
+bch_findsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  FAR struct bchlib_cache_s *cache;
+  int i;
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+  cache = &bch->cache[(sector % BCH_CACHE_SETS) * CONFIG_BCH_CACHE_WAYS];
+  for (i = 0; i < CONFIG_BCH_CACHE_WAYS; i++, cache++)
+    {
+      if (cache->sector == sector)
+        {
+          return cache;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bch_getsector
+ *
+ * Description:
+ *   Return the cache entry for a sector, replacing the least recently used
+ *   entry of its set if the sector is not cached.  The contents are read
+ *   from the media only if 'read' is true.
+ *
+ ****************************************************************************/
+
+static int bch_getsector(FAR struct bchlib_s *bch, size_t sector,
+                         bool read, FAR struct bchlib_cache_s **cachep)
+{
+  FAR struct inode *inode = bch->inode;
+  FAR struct bchlib_cache_s *cache;
+  FAR struct bchlib_cache_s *victim;
+  ssize_t ret;
+  int i;
+
+  cache = bch_findsector(bch, sector);
+  if (cache != NULL)
+    {
+      goto out;
+    }
+
+  /* Pick an unused entry of the set or else the least recently used */
+
+  cache = &bch->cache[(sector % BCH_CACHE_SETS) * CONFIG_BCH_CACHE_WAYS];
+  victim = cache;
+  for (i = 0; i < CONFIG_BCH_CACHE_WAYS; i++, cache++)
+    {
+      if (cache->sector == (size_t)-1)
+        {
+          victim = cache;
+          break;
+        }
+      else if (cache->stamp < victim->stamp)
+        {
+          victim = cache;
+        }
+    }
+
+  cache = victim;
+  if (cache->buffer == NULL)
+    {
+#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
+      cache->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                                   bch->sectsize);
+#else
+      cache->buffer = kmm_malloc(bch->sectsize);
 #endif
+      if (cache->buffer == NULL)
+        {
+          ferr("Failed to allocate sector buffer\n");
+          return -ENOMEM;
+        }
+    }
 
-      /* Write the sector to the media */
+  ret = bch_writesector(bch, cache);
+  if (ret < 0)
+    {
+      ferr("Flush failed: %zd\n", ret);
+      return (int)ret;
+    }
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+  cache->sector = (size_t)-1;
+  if (read)
+    {
+      ret = inode->u.i_bops->read(inode, cache->buffer, sector, 1);
       if (ret < 0)
         {
-          ferr("Write failed: %zd\n", ret);
+          ferr("Read failed: %zd\n", ret);
           return (int)ret;
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
-
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, cache->buffer, sector, CYPHER_DECRYPT);
 #endif
+    }
+
+  cache->sector = sector;
+
+out:
+  cache->stamp = ++bch->stamp;
+  *cachep = cache;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Write back the dirty cached sectors in the range sector through
+ *   sector + nsectors - 1, and drop them from the cache if 'discard' is
+ *   true.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, bool discard)
+{
+  FAR struct bchlib_cache_s *cache;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++)
+    {
+      cache = &bch->cache[i];
+      if (cache->sector == (size_t)-1 || cache->sector < sector ||
+          cache->sector - sector >= nsectors)
+        {
+          continue;
+        }
 
-      /* The sector is now in sync with the media */
+      ret = bch_writesector(bch, cache);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
-      bch->dirty = false;
+      if (discard)
+        {
+          cache->sector = (size_t)-1;
+        }
     }
 
-  if (discard)
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_discardrange
+ *
+ * Description:
+ *   Drop the cached sectors in the range sector through
+ *   sector + nsectors - 1 without writing them back, since the media
+ *   content of a discarded range no longer matters.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_discardrange(FAR struct bchlib_s *bch, size_t sector,
+                         size_t nsectors)
+{
+  FAR struct bchlib_cache_s *cache;
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++)
     {
-      bch->sector = (size_t)-1;
+      cache = &bch->cache[i];
+      if (cache->sector != (size_t)-1 && cache->sector >= sector &&
+          cache->sector - sector < nsectors)
+        {
+          cache->sector = (size_t)-1;
+          cache->dirty  = false;
+        }
     }
+}
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush the current contents of the sector cache (if dirty)
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
 
-  return (int)ret;
+int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+{
+  return bchlib_flushrange(bch, 0, SIZE_MAX, discard);
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Make sure that a sector is in the cache, reading it from the media if
+ *   necessary, and return its cache entry
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                      FAR struct bchlib_cache_s **cache)
+{
+  return bch_getsector(bch, sector, true, cache);
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark a cache entry as modified and schedule its write-back
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+void bchlib_dirtysector(FAR struct bchlib_s *bch,
+                        FAR struct bchlib_cache_s *cache)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  cache->dirty = true;
 
-  if (bch->buffer == NULL)
+#if CONFIG_BCH_WRITEBACK_DELAY > 0
+  if (work_available(&bch->work))
     {
-#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
-#else
-      bch->buffer = kmm_malloc(bch->sectsize);
+      work_queue(LPWORK, &bch->work, bch_writeback, bch,
+                 MSEC2TICK(CONFIG_BCH_WRITEBACK_DELAY));
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_readdirect
+ *
+ * Description:
+ *   Read whole sectors from the media into the caller's buffer, bypassing
+ *   the cache.  Cached sectors that have been modified but not yet written
+ *   back are copied over the data read.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_readdirect(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                      size_t sector, size_t nsectors)
+{
+  FAR struct bchlib_cache_s *cache;
+  ssize_t ret;
+  size_t i;
+
+  ret = bch->inode->u.i_bops->read(bch->inode, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      ferr("ERROR: Read failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  for (i = 0; i < nsectors; i++)
+    {
+      bch_cypher(bch, buffer + i * bch->sectsize, sector + i,
+                 CYPHER_DECRYPT);
+    }
 #endif
-      if (bch->buffer == NULL)
+
+  for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++)
+    {
+      cache = &bch->cache[i];
+      if (cache->dirty && cache->sector >= sector &&
+          cache->sector - sector < nsectors)
         {
-          ferr("Failed to allocate sector buffer\n");
-          return -ENOMEM;
+          memcpy(buffer + (cache->sector - sector) * bch->sectsize,
+                 cache->buffer, bch->sectsize);
         }
     }
 
-  if (bch->sector != sector)
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_writedirect
+ *
+ * Description:
+ *   Write whole sectors from the caller's buffer to the media, bypassing
+ *   the cache.  Dirty cached sectors are written back first to keep the
+ *   sector sequence, and copies of the sectors written are dropped.
+ *   Encrypted data cannot be written from the caller's buffer and goes
+ *   through the cache instead.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_writedirect(FAR struct bchlib_s *bch, FAR const uint8_t *buffer,
+                       size_t sector, size_t nsectors)
+{
+#if defined(CONFIG_BCH_ENCRYPTION)
+  FAR struct bchlib_cache_s *cache;
+  size_t i;
+#endif
+  ssize_t ret;
+
+  ret = bchlib_flushsector(bch, false);
+  if (ret < 0)
     {
-      inode = bch->inode;
+      ferr("ERROR: Flush failed: %zd\n", ret);
+      return (int)ret;
+    }
 
-      ret = bchlib_flushsector(bch, true);
+#if defined(CONFIG_BCH_ENCRYPTION)
+  for (i = 0; i < nsectors; i++)
+    {
+      ret = bch_getsector(bch, sector + i, false, &cache);
       if (ret < 0)
         {
-          ferr("Flush failed: %zd\n", ret);
           return (int)ret;
         }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      memcpy(cache->buffer, buffer + i * bch->sectsize, bch->sectsize);
+      cache->dirty = true;
+      ret = bch_writesector(bch, cache);
       if (ret < 0)
         {
-          ferr("Read failed: %zd\n", ret);
           return (int)ret;
         }
+    }
+#else
+  bchlib_flushrange(bch, sector, nsectors, true);
 
-      bch->sector = sector;
-#if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+  ret = bch->inode->u.i_bops->write(bch->inode, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      ferr("ERROR: Write failed: %zd\n", ret);
+      return (int)ret;
     }
+#endif
 
-  return (int)ret;
+  return OK;
 }
@@ -70,6 +70,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
                     size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bchlib_cache_s *cache;
   size_t   nsectors;
   size_t   sector;
   uint16_t sectoffset;
@@ -101,9 +102,9 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
   bytesread = 0;
   if (sectoffset > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -120,7 +121,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, &cache->buffer[sectoffset], nbytes);
 
       /* Adjust pointers and counts */
 
@@ -148,11 +149,9 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
+      ret = bchlib_readdirect(bch, (FAR uint8_t *)buffer, sector, nsectors);
       if (ret < 0)
         {
-          ferr("ERROR: Read failed: %d\n", ret);
           return ret;
         }
 
@@ -175,9 +174,9 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -185,7 +184,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, cache->buffer, len);
 
       /* Adjust counts */
 
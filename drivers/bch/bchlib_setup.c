@@ -60,6 +60,7 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   FAR struct bchlib_s *bch;
   struct geometry geo;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -110,8 +111,28 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   nxmutex_init(&bch->lock);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+
+  for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++)
+    {
+      bch->cache[i].sector = (size_t)-1;
+    }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Optional, bch_cypher() works block by block without it */
+
+  bch->tweak = kmm_malloc(bch->sectsize);
+#endif
+
+#ifdef CONFIG_FS_BLKQUEUE
+  /* Without a queue asynchronous I/O falls back to the synchronous path */
+
+  if (blkqueue_open(bch->inode, &bch->queue) < 0)
+    {
+      bch->queue = NULL;
+    }
+#endif
+
   *handle = bch;
   return OK;
 
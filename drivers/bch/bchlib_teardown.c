@@ -52,6 +52,7 @@
 int bchlib_teardown(FAR void *handle)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  int i;
 
   DEBUGASSERT(handle);
 
@@ -62,20 +63,43 @@ int bchlib_teardown(FAR void *handle)
       return -EBUSY;
     }
 
+#if CONFIG_BCH_WRITEBACK_DELAY > 0
+  /* Stop the deferred write-back, the flush below replaces it */
+
+  work_cancel_sync(LPWORK, &bch->work);
+#endif
+
   /* Flush any pending data to the block driver */
 
   bchlib_flushsector(bch, false);
 
+#ifdef CONFIG_FS_BLKQUEUE
+  if (bch->queue != NULL)
+    {
+      blkqueue_close(bch->queue);
+    }
+#endif
+
   /* Close the block driver */
 
   close_blockdriver(bch->inode);
 
   /* Free the BCH state structure */
 
-  if (bch->buffer)
+  for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++)
+    {
+      if (bch->cache[i].buffer)
+        {
+          kmm_free(bch->cache[i].buffer);
+        }
+    }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  if (bch->tweak)
     {
-      kmm_free(bch->buffer);
+      kmm_free(bch->tweak);
     }
+#endif
 
   nxmutex_destroy(&bch->lock);
   kmm_free(bch);
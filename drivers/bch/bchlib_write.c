@@ -56,6 +56,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
         size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bchlib_cache_s *cache;
   size_t   nsectors;
   size_t   sector;
   uint16_t sectoffset;
@@ -85,9 +86,9 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
   byteswritten = 0;
   if (sectoffset > 0)
     {
-      /* Read the full sector into the sector buffer */
+      /* Read the full sector into the sector cache */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -104,8 +105,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(&cache->buffer[sectoffset], buffer, nbytes);
+      bchlib_dirtysector(bch, cache);
 
       /* Adjust pointers and counts */
 
@@ -133,23 +134,12 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
-
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
-      if (ret < 0)
-        {
-          ferr("ERROR: Flush failed: %d\n", ret);
-          return ret;
-        }
-
       /* Write the contiguous sectors */
 
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
+      ret = bchlib_writedirect(bch, (FAR const uint8_t *)buffer, sector,
+                               nsectors);
       if (ret < 0)
         {
-          ferr("ERROR: Write failed: %d\n", ret);
           return ret;
         }
 
@@ -172,9 +162,9 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -182,8 +172,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(cache->buffer, buffer, len);
+      bchlib_dirtysector(bch, cache);
 
       /* Adjust counts */
 
@@ -720,7 +720,45 @@ static int binder_close(FAR struct file *filep)
 static ssize_t binder_read(FAR struct file *filep, FAR char *buffer,
                            size_t len)
 {
-  return 0;
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct binder_device *binder_dev = inode->i_private;
+  FAR struct binder_proc *proc;
+  size_t total = 0;
+
+  /* Report the per-process transaction latency once per open */
+
+  if (filep->f_pos != 0 || len == 0)
+    {
+      return 0;
+    }
+
+  total = snprintf(buffer, len, "%-8s %10s %12s %12s\n",
+                   "PID", "NTRANS", "AVGLAT", "MAXLAT");
+
+  nxmutex_lock(&binder_dev->binder_procs_lock);
+  list_for_every_entry(&binder_dev->binder_procs_list, proc,
+                       struct binder_proc, proc_node)
+    {
+      if (total >= len)
+        {
+          break;
+        }
+
+      binder_inner_proc_lock(proc);
+      total += snprintf(buffer + total, len - total,
+                        "%-8d %10" PRIu32 " %12lu %12lu\n",
+                        proc->pid, proc->ntrans,
+                        proc->ntrans ?
+                        (unsigned long)(proc->totlat / proc->ntrans) : 0ul,
+                        (unsigned long)proc->maxlat);
+      binder_inner_proc_unlock(proc);
+    }
+
+  nxmutex_unlock(&binder_dev->binder_procs_lock);
+
+  total = MIN(total, len);
+  filep->f_pos += total;
+  return total;
 }
 
 static ssize_t binder_write(FAR struct file *filep, FAR const char *buffer,
@@ -523,6 +523,8 @@ static int binder_alloc_do_buffer_copy(
   FAR struct binder_buffer *buffer, binder_size_t buffer_offset,
   FAR void *ptr, size_t bytes)
 {
+  FAR uint8_t *tmpptr;
+
   /* All copies must be 32-bit aligned and 32-bit size */
 
   if (!check_buffer(alloc, buffer, buffer_offset, bytes))
@@ -530,34 +532,18 @@ static int binder_alloc_do_buffer_copy(
       return -EINVAL;
     }
 
-  while (bytes)
-    {
-      unsigned long size;
-      FAR void *page;
-      unsigned long pgoff;
-      FAR void *tmpptr;
-      FAR void *base_ptr;
-
-      page = binder_alloc_get_page(alloc, buffer,
-                                   buffer_offset, &pgoff);
-      size = MIN(bytes, (size_t)(PAGE_SIZE - pgoff));
-      base_ptr = page;
-      tmpptr = base_ptr + pgoff;
-      if (to_buffer)
-        {
-          BUG_ON(pgoff + size > PAGE_SIZE);
-          memcpy(tmpptr, ptr, size);
-        }
-      else
-        {
-          BUG_ON(pgoff + size > PAGE_SIZE);
-          memcpy(ptr, tmpptr, size);
-        }
+  /* The mmap area is a single contiguous allocation, so the whole range
+   * is copied in one go instead of page by page.
+   */
 
-      bytes -= size;
-      pgoff = 0;
-      ptr = ptr + size;
-      buffer_offset += size;
+  tmpptr = (FAR uint8_t *)buffer->user_data + buffer_offset;
+  if (to_buffer)
+    {
+      memcpy(tmpptr, ptr, bytes);
+    }
+  else
+    {
+      memcpy(ptr, tmpptr, bytes);
     }
 
   return 0;
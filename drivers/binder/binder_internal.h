@@ -398,6 +398,15 @@ struct binder_proc
   int requested_threads;
   int requested_threads_started;
   int tmp_ref;
+
+  /* Transaction statistics, in perf_gettime() units: time from the sender
+   * entering binder_transaction() until a thread of this proc picks the
+   * transaction up.  Protected by inner_lock.
+   */
+
+  uint32_t ntrans;
+  clock_t totlat;
+  clock_t maxlat;
 };
 
 /**
@@ -535,6 +544,7 @@ struct binder_transaction
   uid_t sender_euid;
   struct list_node fd_fixups;
   binder_uintptr_t security_ctx;
+  clock_t start;
 
   /**
    * lock: protects from, to_proc, and to_thread
@@ -627,6 +637,25 @@ static inline bool binder_worklist_empty_ilocked(FAR struct list_node *list)
   return list_is_empty(list);
 }
 
+/**
+ * binder_proc_account_latency_ilocked() - Record a delivered transaction
+ * proc: binder_proc receiving the transaction
+ * lat: time the transaction spent in flight
+ *
+ * Requires the proc->inner_lock to be held.
+ */
+
+static inline void binder_proc_account_latency_ilocked(
+  FAR struct binder_proc *proc, clock_t lat)
+{
+  proc->ntrans++;
+  proc->totlat += lat;
+  if (lat > proc->maxlat)
+    {
+      proc->maxlat = lat;
+    }
+}
+
 /**
  * binder_enqueue_work_ilocked() - Add an item to the work list
  * work: struct binder_work to add to list
@@ -39,6 +39,7 @@
 #include <debug.h>
 #include <sched.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/android/binder.h>
 #include <nuttx/mutex.h>
@@ -1535,6 +1536,10 @@ retry:
 
       binder_debug(BINDER_DEBUG_THREADS, "Send %s", BINDER_BR_STR(cmd));
 
+      binder_inner_proc_lock(proc);
+      binder_proc_account_latency_ilocked(proc, perf_gettime() - t->start);
+      binder_inner_proc_unlock(proc);
+
       data->code = t->code;
       data->flags = t->flags;
       data->sender_euid = geteuid();
@@ -37,6 +37,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <sched.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/android/binder.h>
 #include <nuttx/mutex.h>
@@ -1208,6 +1209,7 @@ void binder_transaction(FAR struct binder_proc *proc,
   list_initialize(&tran->fd_fixups);
   list_initialize(&tran->work.entry_node);
   nxmutex_init(&tran->lock);
+  tran->start = perf_gettime();
   complete_work = kmm_zalloc(sizeof(struct binder_work));
   if (complete_work == NULL)
     {
@@ -1288,7 +1290,12 @@ void binder_transaction(FAR struct binder_proc *proc,
   tran->buffer->target_node = target_node;
   tran->buffer->clear_on_free = !!(tran->flags & TF_CLEAR_BUF);
 
-  if (binder_alloc_copy_to_buffer(&target_proc->alloc, tran->buffer,
+  /* Plain data transactions carry no objects: skip the offsets array
+   * entirely and fall through to a single copy of the payload below.
+   */
+
+  if (trans->offsets_size != 0 &&
+      binder_alloc_copy_to_buffer(&target_proc->alloc, tran->buffer,
                       ALIGN(trans->data_size, sizeof(void *)),
                       (FAR void *)(uintptr_t)trans->data.ptr.offsets,
                       trans->offsets_size))
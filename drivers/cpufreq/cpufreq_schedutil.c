@@ -0,0 +1,305 @@
+/****************************************************************************
+ * drivers/cpufreq/cpufreq_schedutil.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <sys/param.h>
+
+#include "cpufreq_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CPUFREQ_UTIL_SCALE    1024
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Utilization tracking of one CPU, only updated by that CPU */
+
+struct cpufreq_schedutil_cpu_s
+{
+  clock_t last;           /* Time of the last context switch */
+  clock_t busy;           /* Busy time in the current window */
+  clock_t total;          /* Elapsed time in the current window */
+  unsigned int util;      /* Decayed utilization, 0..CPUFREQ_UTIL_SCALE */
+  bool idle;              /* The idle task is running */
+  bool rt;                /* A realtime task is running */
+};
+
+struct cpufreq_schedutil_s
+{
+  FAR struct cpufreq_policy *policy;
+  struct cpufreq_schedutil_cpu_s cpu[CONFIG_SMP_NCPUS];
+  spinlock_t lock;        /* Protects the request below */
+  struct wdog_s wdog;     /* Leaves the scheduler context */
+  struct work_s work;     /* Performs the frequency change */
+  clock_t window;         /* Utilization window in perf ticks */
+  clock_t rate_limit;     /* Minimum interval of changes in perf ticks */
+  clock_t last_update;    /* Time of the last request */
+  unsigned int next_freq; /* The requested frequency in kHz */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int cpufreq_gov_schedutil_init(FAR struct cpufreq_policy *policy);
+static int cpufreq_gov_schedutil_exit(FAR struct cpufreq_policy *policy);
+static int cpufreq_gov_schedutil_start(FAR struct cpufreq_policy *policy);
+static void cpufreq_gov_schedutil_stop(FAR struct cpufreq_policy *policy);
+static void cpufreq_gov_schedutil_limits(FAR struct cpufreq_policy *policy);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct cpufreq_governor g_cpufreq_gov_schedutil =
+{
+  .name   = "schedutil",
+  .init   = cpufreq_gov_schedutil_init,
+  .exit   = cpufreq_gov_schedutil_exit,
+  .start  = cpufreq_gov_schedutil_start,
+  .stop   = cpufreq_gov_schedutil_stop,
+  .limits = cpufreq_gov_schedutil_limits,
+};
+
+/* The running instance, NULL while the governor is stopped */
+
+static FAR struct cpufreq_schedutil_s *g_cpufreq_schedutil;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static clock_t cpufreq_schedutil_us2perf(unsigned long us)
+{
+  return (uint64_t)us * perf_getfreq() / USEC_PER_SEC;
+}
+
+static unsigned int
+cpufreq_schedutil_next_freq(FAR struct cpufreq_schedutil_s *data,
+                            clock_t now)
+{
+  FAR struct cpufreq_policy *policy = data->policy;
+  FAR struct cpufreq_schedutil_cpu_s *sc;
+  unsigned int util = 0;
+  unsigned int freq;
+  int cpu;
+
+  /* All CPUs share one frequency, so the busiest one decides */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      sc = &data->cpu[cpu];
+      if (sc->rt)
+        {
+          return policy->max;
+        }
+
+      /* A CPU that idles for a whole window no longer counts */
+
+      if (!sc->idle || now - sc->last < data->window)
+        {
+          util = MAX(util, sc->util);
+        }
+    }
+
+  /* Leave 25% headroom so that a growing load is caught early */
+
+  freq = (uint64_t)policy->max * (util + (util >> 2)) / CPUFREQ_UTIL_SCALE;
+  return MAX(MIN(freq, policy->max), policy->min);
+}
+
+static void cpufreq_schedutil_worker(FAR void *arg)
+{
+  FAR struct cpufreq_schedutil_s *data = arg;
+  FAR struct cpufreq_policy *policy = data->policy;
+
+  nxmutex_lock(&policy->lock);
+  cpufreq_driver_target(policy, data->next_freq, CPUFREQ_RELATION_L);
+  nxmutex_unlock(&policy->lock);
+}
+
+static void cpufreq_schedutil_kick(wdparm_t arg)
+{
+  FAR struct cpufreq_schedutil_s *data =
+    (FAR struct cpufreq_schedutil_s *)arg;
+
+  if (work_available(&data->work))
+    {
+      work_queue(HPWORK, &data->work, cpufreq_schedutil_worker, data, 0);
+    }
+}
+
+static int cpufreq_gov_schedutil_init(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_schedutil_s *data;
+
+  data = kmm_zalloc(sizeof(struct cpufreq_schedutil_s));
+  if (!data)
+    {
+      return -ENOMEM;
+    }
+
+  data->policy     = policy;
+  data->window =
+    cpufreq_schedutil_us2perf(CONFIG_CPUFREQ_SCHEDUTIL_WINDOW);
+  data->rate_limit =
+    cpufreq_schedutil_us2perf(CONFIG_CPUFREQ_SCHEDUTIL_RATE_LIMIT);
+  spin_lock_init(&data->lock);
+  policy->governor_data = data;
+  return 0;
+}
+
+static int cpufreq_gov_schedutil_exit(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_schedutil_s *data = policy->governor_data;
+
+  kmm_free(data);
+  return 0;
+}
+
+static int cpufreq_gov_schedutil_start(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_schedutil_s *data = policy->governor_data;
+  clock_t now = perf_gettime();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      data->cpu[cpu].last = now;
+    }
+
+  data->next_freq = policy->cur;
+  g_cpufreq_schedutil = data;
+  return 0;
+}
+
+static void cpufreq_gov_schedutil_stop(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_schedutil_s *data = policy->governor_data;
+
+  g_cpufreq_schedutil = NULL;
+  wd_cancel(&data->wdog);
+
+  if (sched_idletask())
+    {
+      work_cancel(HPWORK, &data->work);
+    }
+  else
+    {
+      work_cancel_sync(HPWORK, &data->work);
+    }
+}
+
+static void cpufreq_gov_schedutil_limits(FAR struct cpufreq_policy *policy)
+{
+  nxmutex_lock(&policy->lock);
+  if (policy->max < policy->cur)
+    {
+      cpufreq_driver_target(policy, policy->max, CPUFREQ_RELATION_H);
+    }
+  else if (policy->min > policy->cur)
+    {
+      cpufreq_driver_target(policy, policy->min, CPUFREQ_RELATION_L);
+    }
+
+  nxmutex_unlock(&policy->lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+FAR struct cpufreq_governor *cpufreq_default_governor(void)
+{
+  return &g_cpufreq_gov_schedutil;
+}
+
+void cpufreq_update_util(int cpu, unsigned int flags)
+{
+  FAR struct cpufreq_schedutil_s *data = g_cpufreq_schedutil;
+  FAR struct cpufreq_schedutil_cpu_s *sc;
+  unsigned int next_freq;
+  irqstate_t irqflags;
+  clock_t delta;
+  clock_t now;
+  bool boost;
+
+  if (data == NULL)
+    {
+      return;
+    }
+
+  /* Account the time since the last switch to the outgoing task */
+
+  sc    = &data->cpu[cpu];
+  now   = perf_gettime();
+  delta = now - sc->last;
+
+  sc->last   = now;
+  sc->total += delta;
+  if (!sc->idle)
+    {
+      sc->busy += delta;
+    }
+
+  /* Close the window, each one halves the weight of the older ones */
+
+  if (sc->total >= data->window)
+    {
+      sc->util  = (sc->util + (uint64_t)sc->busy * CPUFREQ_UTIL_SCALE /
+                              sc->total) / 2;
+      sc->busy  = 0;
+      sc->total = 0;
+    }
+
+  boost    = (flags & CPUFREQ_UTIL_RT) != 0 && !sc->rt;
+  sc->idle = (flags & CPUFREQ_UTIL_IDLE) != 0;
+  sc->rt   = (flags & CPUFREQ_UTIL_RT) != 0;
+
+  /* Request the new frequency, a realtime task doesn't wait for the rate
+   * limit.  The change itself may sleep, so leave the scheduler through a
+   * watchdog and the high priority work queue.
+   */
+
+  irqflags  = spin_lock_irqsave(&data->lock);
+  next_freq = cpufreq_schedutil_next_freq(data, now);
+  if (next_freq != data->next_freq &&
+      (boost || now - data->last_update >= data->rate_limit))
+    {
+      data->next_freq   = next_freq;
+      data->last_update = now;
+      wd_start(&data->wdog, 0, cpufreq_schedutil_kick, (wdparm_t)data);
+    }
+
+  spin_unlock_irqrestore(&data->lock, irqflags);
+}
@@ -0,0 +1,614 @@
+/****************************************************************************
+ * drivers/dma/dma_engine.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_DMA_MEMCPY_THRESHOLD
+#  define CONFIG_DMA_MEMCPY_THRESHOLD 0
+#endif
+
+/* Values of dma_desc_s::type */
+
+#define DMA_DESC_SG             0
+#define DMA_DESC_MEMCPY         1
+#define DMA_DESC_CYCLIC         2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A registered controller */
+
+struct dma_ctrl_s
+{
+  FAR struct dma_dev_s *dev;       /* NULL if the slot is free */
+  unsigned int caps;               /* DMA_CAP_* */
+  unsigned int memcpy_ident;       /* Channel used by dma_memcpy() */
+};
+
+struct dma_engine_s
+{
+  FAR struct dma_dev_s *dev;       /* Owner of the channel */
+  FAR struct dma_chan_s *chan;     /* Lower half channel */
+  struct dma_config_s cfg;         /* Set by dma_engine_config() */
+  sq_queue_t queue;                /* Submitted, not yet started */
+  FAR struct dma_desc_s *active;   /* In flight, NULL if idle */
+};
+
+/* State of one dma_memcpy() call */
+
+struct dma_memcpy_s
+{
+  sem_t done;
+  ssize_t result;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dma_ctrl_s g_dma_ctrl[CONFIG_DMA_ENGINE_NDEVICES];
+
+#if CONFIG_DMA_MEMCPY_THRESHOLD > 0
+static mutex_t g_dma_memcpy_lock = NXMUTEX_INITIALIZER;
+static FAR struct dma_engine_s *g_dma_memcpy_chan;
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void dma_engine_callback(FAR struct dma_chan_s *chan,
+                                FAR void *arg, ssize_t len);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_engine_segment
+ *
+ * Description:
+ *   Start the current segment of a scatter-gather descriptor on a
+ *   controller without hardware scatter-gather.
+ *
+ ****************************************************************************/
+
+static int dma_engine_segment(FAR struct dma_engine_s *engine,
+                              FAR struct dma_desc_s *desc)
+{
+  FAR const struct dma_sg_s *seg = &desc->sg[desc->index];
+
+  if (desc->direction == DMA_MEM_TO_DEV)
+    {
+      return DMA_START(engine->chan, dma_engine_callback, engine,
+                       desc->devaddr, seg->addr, seg->len);
+    }
+  else
+    {
+      return DMA_START(engine->chan, dma_engine_callback, engine,
+                       seg->addr, desc->devaddr, seg->len);
+    }
+}
+
+/****************************************************************************
+ * Name: dma_engine_start
+ *
+ * Description:
+ *   Program the channel for a descriptor.  Called with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+static int dma_engine_start(FAR struct dma_engine_s *engine,
+                            FAR struct dma_desc_s *desc)
+{
+  FAR struct dma_chan_s *chan = engine->chan;
+  uintptr_t dst;
+  uintptr_t src;
+  int ret;
+
+  engine->cfg.direction = desc->direction;
+  ret = DMA_CONFIG(chan, &engine->cfg);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  desc->index  = 0;
+  desc->result = 0;
+
+  switch (desc->type)
+    {
+      case DMA_DESC_MEMCPY:
+        return DMA_START(chan, dma_engine_callback, engine,
+                         desc->devaddr, desc->buf.addr, desc->buf.len);
+
+      case DMA_DESC_CYCLIC:
+        dst = desc->direction == DMA_MEM_TO_DEV ? desc->devaddr :
+                                                  desc->buf.addr;
+        src = desc->direction == DMA_MEM_TO_DEV ? desc->buf.addr :
+                                                  desc->devaddr;
+        return DMA_START_CYCLIC(chan, dma_engine_callback, engine,
+                                dst, src, desc->buf.len, desc->period);
+
+      default:
+        if (chan->ops->start_sg != NULL)
+          {
+            return DMA_START_SG(chan, dma_engine_callback, engine,
+                                desc->devaddr, desc->sg, desc->nsg);
+          }
+
+        return dma_engine_segment(engine, desc);
+    }
+}
+
+/****************************************************************************
+ * Name: dma_engine_next
+ *
+ * Description:
+ *   Start the oldest queued descriptor of an idle channel.  Descriptors
+ *   that cannot be started complete immediately with the error.  Called
+ *   with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void dma_engine_next(FAR struct dma_engine_s *engine)
+{
+  FAR struct dma_desc_s *desc;
+  int ret;
+
+  while (engine->active == NULL &&
+         (desc = (FAR struct dma_desc_s *)
+                 sq_remfirst(&engine->queue)) != NULL)
+    {
+      engine->active = desc;
+      ret = dma_engine_start(engine, desc);
+      if (ret < 0)
+        {
+          engine->active = NULL;
+          if (desc->callback != NULL)
+            {
+              desc->callback(engine->chan, desc->arg, ret);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: dma_engine_callback
+ *
+ * Description:
+ *   Completion interrupt of the lower half.  Advances the scatter-gather
+ *   list or retires the descriptor and chains the next one before the
+ *   client is notified, so the channel does not idle during the callback.
+ *
+ ****************************************************************************/
+
+static void dma_engine_callback(FAR struct dma_chan_s *chan,
+                                FAR void *arg, ssize_t len)
+{
+  FAR struct dma_engine_s *engine = arg;
+  FAR struct dma_desc_s *desc;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+
+  desc = engine->active;
+  if (desc == NULL)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  if (desc->type == DMA_DESC_CYCLIC)
+    {
+      leave_critical_section(flags);
+      if (desc->callback != NULL)
+        {
+          desc->callback(chan, desc->arg, len);
+        }
+
+      return;
+    }
+
+  if (len < 0)
+    {
+      desc->result = len;
+    }
+  else
+    {
+      desc->result += len;
+      if (desc->type == DMA_DESC_SG && chan->ops->start_sg == NULL &&
+          ++desc->index < desc->nsg)
+        {
+          ret = dma_engine_segment(engine, desc);
+          if (ret >= 0)
+            {
+              leave_critical_section(flags);
+              return;
+            }
+
+          desc->result = ret;
+        }
+    }
+
+  engine->active = NULL;
+  dma_engine_next(engine);
+  leave_critical_section(flags);
+
+  if (desc->callback != NULL)
+    {
+      desc->callback(chan, desc->arg, desc->result);
+    }
+}
+
+#if CONFIG_DMA_MEMCPY_THRESHOLD > 0
+
+/****************************************************************************
+ * Name: dma_memcpy_done
+ ****************************************************************************/
+
+static void dma_memcpy_done(FAR struct dma_chan_s *chan, FAR void *arg,
+                            ssize_t len)
+{
+  FAR struct dma_memcpy_s *xfer = arg;
+
+  xfer->result = len;
+  nxsem_post(&xfer->done);
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_offload
+ *
+ * Description:
+ *   Perform the copy on the memcpy channel.  The flat build is required,
+ *   so virtual and bus addresses are the same.
+ *
+ ****************************************************************************/
+
+static int dma_memcpy_offload(FAR void *dst, FAR const void *src,
+                              size_t len)
+{
+  struct dma_memcpy_s xfer;
+  struct dma_desc_s desc;
+  unsigned int i;
+  int ret;
+
+  ret = nxmutex_lock(&g_dma_memcpy_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (g_dma_memcpy_chan == NULL)
+    {
+      for (i = 0; i < CONFIG_DMA_ENGINE_NDEVICES; i++)
+        {
+          if (g_dma_ctrl[i].dev != NULL &&
+              (g_dma_ctrl[i].caps & DMA_CAP_MEMCPY) != 0)
+            {
+              g_dma_memcpy_chan =
+                dma_request_chan(DMA_CAP_MEMCPY, g_dma_ctrl[i].memcpy_ident);
+              break;
+            }
+        }
+
+      if (g_dma_memcpy_chan == NULL)
+        {
+          nxmutex_unlock(&g_dma_memcpy_lock);
+          return -ENODEV;
+        }
+
+      g_dma_memcpy_chan->cfg.src_width = sizeof(uintptr_t);
+      g_dma_memcpy_chan->cfg.dst_width = sizeof(uintptr_t);
+    }
+
+  /* Write back the source, and drop any dirty line of the destination so
+   * that it cannot be evicted on top of the DMA data.
+   */
+
+  up_clean_dcache((uintptr_t)src, (uintptr_t)src + len);
+  up_flush_dcache((uintptr_t)dst, (uintptr_t)dst + len);
+
+  nxsem_init(&xfer.done, 0, 0);
+  dma_prep_memcpy(&desc, (uintptr_t)dst, (uintptr_t)src, len,
+                  dma_memcpy_done, &xfer);
+  dma_submit(g_dma_memcpy_chan, &desc);
+  nxsem_wait_uninterruptible(&xfer.done);
+  nxsem_destroy(&xfer.done);
+
+  up_invalidate_dcache((uintptr_t)dst, (uintptr_t)dst + len);
+  nxmutex_unlock(&g_dma_memcpy_lock);
+
+  return xfer.result == (ssize_t)len ? OK : -EIO;
+}
+
+#endif /* CONFIG_DMA_MEMCPY_THRESHOLD > 0 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_register
+ ****************************************************************************/
+
+int dma_register(FAR struct dma_dev_s *dev, unsigned int caps,
+                 unsigned int memcpy_ident)
+{
+  irqstate_t flags;
+  int ret = -ENOSPC;
+  int i;
+
+  DEBUGASSERT(dev != NULL);
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_DMA_ENGINE_NDEVICES; i++)
+    {
+      if (g_dma_ctrl[i].dev == NULL)
+        {
+          g_dma_ctrl[i].dev          = dev;
+          g_dma_ctrl[i].caps         = caps;
+          g_dma_ctrl[i].memcpy_ident = memcpy_ident;
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dma_request_chan
+ ****************************************************************************/
+
+FAR struct dma_engine_s *dma_request_chan(unsigned int caps,
+                                          unsigned int ident)
+{
+  FAR struct dma_engine_s *engine;
+  FAR struct dma_dev_s *dev = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_DMA_ENGINE_NDEVICES; i++)
+    {
+      if (g_dma_ctrl[i].dev != NULL &&
+          (g_dma_ctrl[i].caps & caps) == caps)
+        {
+          dev = g_dma_ctrl[i].dev;
+          break;
+        }
+    }
+
+  if (dev == NULL)
+    {
+      return NULL;
+    }
+
+  engine = kmm_zalloc(sizeof(struct dma_engine_s));
+  if (engine == NULL)
+    {
+      return NULL;
+    }
+
+  engine->dev  = dev;
+  engine->chan = DMA_GET_CHAN(dev, ident);
+  if (engine->chan == NULL)
+    {
+      kmm_free(engine);
+      return NULL;
+    }
+
+  sq_init(&engine->queue);
+  return engine;
+}
+
+/****************************************************************************
+ * Name: dma_release_chan
+ ****************************************************************************/
+
+void dma_release_chan(FAR struct dma_engine_s *engine)
+{
+  dma_terminate(engine);
+  DMA_PUT_CHAN(engine->dev, engine->chan);
+  kmm_free(engine);
+}
+
+/****************************************************************************
+ * Name: dma_engine_config
+ ****************************************************************************/
+
+void dma_engine_config(FAR struct dma_engine_s *engine,
+                       FAR const struct dma_config_s *cfg)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  engine->cfg = *cfg;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: dma_prep_slave_sg
+ ****************************************************************************/
+
+int dma_prep_slave_sg(FAR struct dma_desc_s *desc, unsigned int direction,
+                      uintptr_t devaddr, FAR const struct dma_sg_s *sg,
+                      unsigned int nsg, dma_callback_t callback,
+                      FAR void *arg)
+{
+  if (sg == NULL || nsg == 0 ||
+      (direction != DMA_MEM_TO_DEV && direction != DMA_DEV_TO_MEM))
+    {
+      return -EINVAL;
+    }
+
+  memset(desc, 0, sizeof(*desc));
+  desc->type      = DMA_DESC_SG;
+  desc->direction = direction;
+  desc->devaddr   = devaddr;
+  desc->sg        = sg;
+  desc->nsg       = nsg;
+  desc->callback  = callback;
+  desc->arg       = arg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_prep_memcpy
+ ****************************************************************************/
+
+int dma_prep_memcpy(FAR struct dma_desc_s *desc, uintptr_t dst,
+                    uintptr_t src, size_t len, dma_callback_t callback,
+                    FAR void *arg)
+{
+  if (len == 0)
+    {
+      return -EINVAL;
+    }
+
+  memset(desc, 0, sizeof(*desc));
+  desc->type      = DMA_DESC_MEMCPY;
+  desc->direction = DMA_MEM_TO_MEM;
+  desc->devaddr   = dst;
+  desc->buf.addr  = src;
+  desc->buf.len   = len;
+  desc->callback  = callback;
+  desc->arg       = arg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_prep_cyclic
+ ****************************************************************************/
+
+int dma_prep_cyclic(FAR struct dma_desc_s *desc, unsigned int direction,
+                    uintptr_t devaddr, uintptr_t buf, size_t len,
+                    size_t period, dma_callback_t callback, FAR void *arg)
+{
+  if (period == 0 || len == 0 || len % period != 0 ||
+      (direction != DMA_MEM_TO_DEV && direction != DMA_DEV_TO_MEM))
+    {
+      return -EINVAL;
+    }
+
+  memset(desc, 0, sizeof(*desc));
+  desc->type      = DMA_DESC_CYCLIC;
+  desc->direction = direction;
+  desc->devaddr   = devaddr;
+  desc->buf.addr  = buf;
+  desc->buf.len   = len;
+  desc->period    = period;
+  desc->callback  = callback;
+  desc->arg       = arg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_submit
+ ****************************************************************************/
+
+void dma_submit(FAR struct dma_engine_s *engine,
+                FAR struct dma_desc_s *desc)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  sq_addlast(&desc->node, &engine->queue);
+  dma_engine_next(engine);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: dma_terminate
+ ****************************************************************************/
+
+void dma_terminate(FAR struct dma_engine_s *engine)
+{
+  FAR struct dma_desc_s *desc;
+  sq_queue_t queue;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  desc = engine->active;
+  if (desc != NULL)
+    {
+      engine->active = NULL;
+      DMA_STOP(engine->chan);
+    }
+
+  sq_move(&engine->queue, &queue);
+  leave_critical_section(flags);
+
+  if (desc != NULL && desc->callback != NULL)
+    {
+      desc->callback(engine->chan, desc->arg, -ECANCELED);
+    }
+
+  while ((desc = (FAR struct dma_desc_s *)sq_remfirst(&queue)) != NULL)
+    {
+      if (desc->callback != NULL)
+        {
+          desc->callback(engine->chan, desc->arg, -ECANCELED);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: dma_memcpy
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len)
+{
+#if CONFIG_DMA_MEMCPY_THRESHOLD > 0
+  if (len >= CONFIG_DMA_MEMCPY_THRESHOLD && !up_interrupt_context() &&
+      dma_memcpy_offload(dst, src, len) >= 0)
+    {
+      return dst;
+    }
+#endif
+
+  return memcpy(dst, src, len);
+}
@@ -0,0 +1,235 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/i2c/i2c_master.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of pending requests of one bus */
+
+struct i2c_async_s
+{
+  FAR struct i2c_master_s *dev;  /* The bus, NULL if the slot is free */
+  sq_queue_t queue;              /* Pending struct i2c_request_s */
+  struct work_s work;            /* Drains the queue */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct i2c_async_s g_i2c_async[CONFIG_I2C_ASYNC_NBUSES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_find
+ *
+ * Description:
+ *   Return the queue of a bus, claiming a free slot if 'alloc' is set.
+ *   Must be called in a critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct i2c_async_s *i2c_async_find(FAR struct i2c_master_s *dev,
+                                              bool alloc)
+{
+  FAR struct i2c_async_s *slot = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_I2C_ASYNC_NBUSES; i++)
+    {
+      if (g_i2c_async[i].dev == dev)
+        {
+          return &g_i2c_async[i];
+        }
+      else if (alloc && slot == NULL && g_i2c_async[i].dev == NULL)
+        {
+          slot = &g_i2c_async[i];
+        }
+    }
+
+  if (slot != NULL)
+    {
+      slot->dev = dev;
+    }
+
+  return slot;
+}
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Perform every queued request of one bus, highest priority first.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_s *async = arg;
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      req = (FAR struct i2c_request_s *)sq_remfirst(&async->queue);
+      leave_critical_section(flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      ret = I2C_TRANSFER(async->dev, req->msgv, req->msgc);
+      if (req->complete != NULL)
+        {
+          req->complete(req, ret);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue a transfer and return immediately.  'complete' is called from
+ *   the work queue once the transfer has been performed.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to queue
+ *
+ * Returned Value:
+ *   0: queued, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_request_s *req)
+{
+  FAR struct i2c_async_s *async;
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+
+  DEBUGASSERT(dev != NULL && req != NULL && req->msgv != NULL &&
+              req->msgc > 0);
+
+  flags = enter_critical_section();
+
+  async = i2c_async_find(dev, true);
+  if (async == NULL)
+    {
+      leave_critical_section(flags);
+      return -ENOSPC;
+    }
+
+  /* Keep the queue sorted by priority, FIFO among equal priorities */
+
+  sq_for_every(&async->queue, node)
+    {
+      if (((FAR struct i2c_request_s *)node)->priority < req->priority)
+        {
+          break;
+        }
+
+      prev = node;
+    }
+
+  if (prev == NULL)
+    {
+      sq_addfirst(&req->node, &async->queue);
+    }
+  else
+    {
+      sq_addafter(prev, &req->node, &async->queue);
+    }
+
+  if (work_available(&async->work))
+    {
+      work_queue(LPWORK, &async->work, i2c_async_worker, async, 0);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_transfer_cancel
+ *
+ * Description:
+ *   Remove a request that has not been started yet.
+ *
+ * Returned Value:
+ *   0: removed, -ENOENT: not queued
+ *
+ ****************************************************************************/
+
+int i2c_transfer_cancel(FAR struct i2c_master_s *dev,
+                        FAR struct i2c_request_s *req)
+{
+  FAR struct i2c_async_s *async;
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = enter_critical_section();
+
+  async = i2c_async_find(dev, false);
+  if (async != NULL)
+    {
+      sq_for_every(&async->queue, node)
+        {
+          if (node == &req->node)
+            {
+              sq_rem(node, &async->queue);
+              ret = OK;
+              break;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
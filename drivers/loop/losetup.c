@@ -45,6 +45,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/loop.h>
 #include <nuttx/mutex.h>
 
@@ -82,6 +83,8 @@ static ssize_t loop_write(FAR struct inode *inode,
                           blkcnt_t start_sector, unsigned int nsectors);
 static int     loop_geometry(FAR struct inode *inode,
                              FAR struct geometry *geometry);
+static int     loop_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -94,6 +97,7 @@ static const struct block_operations g_bops =
   loop_read,     /* read */
   loop_write,    /* write */
   loop_geometry, /* geometry */
+  loop_ioctl,    /* ioctl */
 };
 
 /****************************************************************************
@@ -303,6 +307,69 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_ioctl
+ *
+ * Description:
+ *   Pass BIOC_DISCARD on to a backing block device, converted to its
+ *   sectors.  Only the backing sectors completely inside the range are
+ *   discarded.  Regular files can not release their blocks, so discard is
+ *   not supported for them.
+ *
+ ****************************************************************************/
+
+static int loop_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct loop_struct_s *dev;
+  FAR const struct blk_discard_s *range;
+  struct blk_discard_s backing;
+  struct geometry geo;
+  off_t start;
+  off_t end;
+  int ret;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  if (cmd != BIOC_DISCARD)
+    {
+      return -ENOTTY;
+    }
+
+  range = (FAR const struct blk_discard_s *)((uintptr_t)arg);
+  if (range == NULL || range->start < 0 || range->nsectors < 0 ||
+      range->start > dev->nsectors ||
+      range->nsectors > dev->nsectors - range->start)
+    {
+      return -EINVAL;
+    }
+  else if (!dev->writeenabled)
+    {
+      return -EACCES;
+    }
+
+  ret = file_ioctl(&dev->devfile, BIOC_GEOMETRY,
+                   (unsigned long)((uintptr_t)&geo));
+  if (ret < 0 || geo.geo_sectorsize == 0)
+    {
+      return -ENOTTY;
+    }
+
+  start = range->start * dev->sectsize + dev->offset;
+  end   = start + range->nsectors * dev->sectsize;
+  start = (start + geo.geo_sectorsize - 1) / geo.geo_sectorsize;
+  end   = end / geo.geo_sectorsize;
+  if (start >= end)
+    {
+      return OK;
+    }
+
+  backing.start    = start;
+  backing.nsectors = end - start;
+  return file_ioctl(&dev->devfile, BIOC_DISCARD,
+                    (unsigned long)((uintptr_t)&backing));
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
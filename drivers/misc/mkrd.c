@@ -63,9 +63,16 @@
 
 int mkrd(int minor, uint32_t nsectors, uint16_t sectsize, uint8_t rdflags)
 {
-  FAR uint8_t *buffer;
+  FAR uint8_t *buffer = NULL;
   int ret;
 
+  /* A sparse RAM disk allocates its memory as it is written */
+
+  if ((rdflags & RDFLAG_SPARSE) != 0)
+    {
+      return ramdisk_register(minor, NULL, nsectors, sectsize, rdflags);
+    }
+
   /* Allocate the memory backing up the ramdisk from the kernel heap */
 
   buffer = kmm_malloc(sectsize * nsectors);
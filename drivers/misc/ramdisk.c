@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -39,7 +40,9 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/drivers/ramdisk.h>
 
 /****************************************************************************
@@ -50,10 +53,12 @@
 
 /* User input flags */
 
-#define RDFLAG_USER            (RDFLAG_WRENABLED | RDFLAG_FUNLINK)
+#define RDFLAG_USER            (RDFLAG_WRENABLED | RDFLAG_FUNLINK | \
+                                RDFLAG_SPARSE)
 
 #define RDFLAG_IS_WRENABLED(f) (((f) & RDFLAG_WRENABLED) != 0)
 #define RDFLAG_IS_FUNLINK(f)   (((f) & RDFLAG_FUNLINK) != 0)
+#define RDFLAG_IS_SPARSE(f)    (((f) & RDFLAG_SPARSE) != 0)
 
 /* Flag set when the RAM disk block driver is unlink */
 
@@ -73,6 +78,14 @@ struct rd_struct_s
 #endif
   uint8_t rd_flags;             /* See RDFLAG_* definitions */
   FAR uint8_t *rd_buffer;       /* RAM disk backup memory */
+#ifdef CONFIG_RAMDISK_SPARSE
+  mutex_t rd_lock;              /* Protects the sparse page table */
+  uint16_t rd_pagesects;        /* Sectors in one backing page */
+  uint32_t rd_npages;           /* Pages covering the whole disk */
+  uint32_t rd_nalloc;           /* Pages currently allocated */
+  uint32_t rd_nzero;            /* Zero page writes not backed by memory */
+  FAR uint8_t **rd_pages;       /* Backing pages, NULL reads as zero */
+#endif
 };
 
 /****************************************************************************
@@ -139,6 +152,23 @@ static void rd_destroy(FAR struct rd_struct_s *dev)
 {
   finfo("Destroying RAM disk\n");
 
+#ifdef CONFIG_RAMDISK_SPARSE
+  /* The pages of a sparse RAM disk always belong to the driver */
+
+  if (RDFLAG_IS_SPARSE(dev->rd_flags))
+    {
+      uint32_t i;
+
+      for (i = 0; i < dev->rd_npages; i++)
+        {
+          kmm_free(dev->rd_pages[i]);
+        }
+
+      kmm_free(dev->rd_pages);
+      nxmutex_destroy(&dev->rd_lock);
+    }
+#endif
+
   /* We we configured to free the RAM disk memory when unlinked? */
 
   if (RDFLAG_IS_UNLINKED(dev->rd_flags))
@@ -223,6 +253,207 @@ static int rd_close(FAR struct inode *inode)
 }
 #endif
 
+/****************************************************************************
+ * Name: rd_iszero
+ *
+ * Description:
+ *   Return true if the 'len' bytes at 'buf' are all zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMDISK_SPARSE
+static bool rd_iszero(FAR const uint8_t *buf, size_t len)
+{
+  return buf[0] == 0 && memcmp(buf, buf + 1, len - 1) == 0;
+}
+
+/****************************************************************************
+ * Name: rd_sparse_read
+ *
+ * Description:
+ *   Read sectors of a sparse RAM disk.  Pages that were never written, or
+ *   only with zeros, read as zero.
+ *
+ ****************************************************************************/
+
+static void rd_sparse_read(FAR struct rd_struct_s *dev,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors)
+{
+  size_t pagesize = (size_t)dev->rd_pagesects * dev->rd_sectsize;
+
+  nxmutex_lock(&dev->rd_lock);
+
+  while (nsectors > 0)
+    {
+      uint32_t page = start_sector / dev->rd_pagesects;
+      size_t offset = (start_sector % dev->rd_pagesects) * dev->rd_sectsize;
+      unsigned int count = MIN(nsectors, dev->rd_pagesects -
+                               start_sector % dev->rd_pagesects);
+      size_t nbytes = (size_t)count * dev->rd_sectsize;
+
+      DEBUGASSERT(offset + nbytes <= pagesize);
+      if (dev->rd_pages[page] == NULL)
+        {
+          memset(buffer, 0, nbytes);
+        }
+      else
+        {
+          memcpy(buffer, dev->rd_pages[page] + offset, nbytes);
+        }
+
+      buffer       += nbytes;
+      start_sector += count;
+      nsectors     -= count;
+    }
+
+  nxmutex_unlock(&dev->rd_lock);
+}
+
+/****************************************************************************
+ * Name: rd_sparse_write
+ *
+ * Description:
+ *   Write sectors of a sparse RAM disk.  A page is allocated on the first
+ *   write of non-zero data and freed again once it only holds zeros, so
+ *   zero pages are never backed by memory.
+ *
+ * Returned Value:
+ *   The number of sectors written, or -ENOMEM if nothing could be written.
+ *
+ ****************************************************************************/
+
+static ssize_t rd_sparse_write(FAR struct rd_struct_s *dev,
+                               FAR const unsigned char *buffer,
+                               blkcnt_t start_sector, unsigned int nsectors)
+{
+  size_t pagesize = (size_t)dev->rd_pagesects * dev->rd_sectsize;
+  ssize_t nwritten = 0;
+
+  nxmutex_lock(&dev->rd_lock);
+
+  while (nsectors > 0)
+    {
+      uint32_t page = start_sector / dev->rd_pagesects;
+      size_t offset = (start_sector % dev->rd_pagesects) * dev->rd_sectsize;
+      unsigned int count = MIN(nsectors, dev->rd_pagesects -
+                               start_sector % dev->rd_pagesects);
+      size_t nbytes = (size_t)count * dev->rd_sectsize;
+      bool zero = rd_iszero(buffer, nbytes);
+
+      if (dev->rd_pages[page] == NULL)
+        {
+          if (zero)
+            {
+              dev->rd_nzero++;
+              goto next;
+            }
+
+          dev->rd_pages[page] = kmm_zalloc(pagesize);
+          if (dev->rd_pages[page] == NULL)
+            {
+              ferr("ERROR: No memory for RAM disk page %" PRIu32 "\n",
+                   page);
+              break;
+            }
+
+          dev->rd_nalloc++;
+        }
+
+      memcpy(dev->rd_pages[page] + offset, buffer, nbytes);
+
+      /* Zeros written over the last data of a page free it */
+
+      if (zero && rd_iszero(dev->rd_pages[page], pagesize))
+        {
+          kmm_free(dev->rd_pages[page]);
+          dev->rd_pages[page] = NULL;
+          dev->rd_nalloc--;
+          dev->rd_nzero++;
+        }
+
+next:
+      buffer       += nbytes;
+      start_sector += count;
+      nsectors     -= count;
+      nwritten     += count;
+    }
+
+  nxmutex_unlock(&dev->rd_lock);
+  return nwritten > 0 ? nwritten : -ENOMEM;
+}
+#endif
+
+/****************************************************************************
+ * Name: rd_discard
+ *
+ * Description:
+ *   Handle BIOC_DISCARD.  Whole pages of a sparse RAM disk are released;
+ *   anything else in the range is cleared so that it reads back as zero.
+ *
+ ****************************************************************************/
+
+static int rd_discard(FAR struct rd_struct_s *dev,
+                      FAR const struct blk_discard_s *range)
+{
+  blkcnt_t start_sector;
+  blkcnt_t nsectors;
+
+  if (range == NULL || range->start < 0 || range->nsectors < 0 ||
+      range->start > dev->rd_nsectors ||
+      range->nsectors > dev->rd_nsectors - range->start)
+    {
+      return -EINVAL;
+    }
+  else if (!RDFLAG_IS_WRENABLED(dev->rd_flags))
+    {
+      return -EACCES;
+    }
+
+  start_sector = range->start;
+  nsectors     = range->nsectors;
+
+#ifdef CONFIG_RAMDISK_SPARSE
+  if (RDFLAG_IS_SPARSE(dev->rd_flags))
+    {
+      size_t pagesize = (size_t)dev->rd_pagesects * dev->rd_sectsize;
+
+      nxmutex_lock(&dev->rd_lock);
+
+      while (nsectors > 0)
+        {
+          uint32_t page = start_sector / dev->rd_pagesects;
+          size_t offset = (start_sector % dev->rd_pagesects) *
+                          dev->rd_sectsize;
+          blkcnt_t count = MIN(nsectors, dev->rd_pagesects -
+                               start_sector % dev->rd_pagesects);
+          FAR uint8_t *mem = dev->rd_pages[page];
+
+          if (mem != NULL)
+            {
+              memset(mem + offset, 0, count * dev->rd_sectsize);
+              if (count == dev->rd_pagesects || rd_iszero(mem, pagesize))
+                {
+                  kmm_free(mem);
+                  dev->rd_pages[page] = NULL;
+                  dev->rd_nalloc--;
+                }
+            }
+
+          start_sector += count;
+          nsectors     -= count;
+        }
+
+      nxmutex_unlock(&dev->rd_lock);
+      return OK;
+    }
+#endif
+
+  memset(&dev->rd_buffer[start_sector * dev->rd_sectsize], 0,
+         nsectors * dev->rd_sectsize);
+  return OK;
+}
+
 /****************************************************************************
  * Name: rd_read
  *
@@ -244,6 +475,14 @@ static ssize_t rd_read(FAR struct inode *inode, unsigned char *buffer,
   if (start_sector < dev->rd_nsectors &&
       start_sector + nsectors <= dev->rd_nsectors)
     {
+#ifdef CONFIG_RAMDISK_SPARSE
+      if (RDFLAG_IS_SPARSE(dev->rd_flags))
+        {
+          rd_sparse_read(dev, buffer, start_sector, nsectors);
+          return nsectors;
+        }
+#endif
+
        finfo("Transfer %d bytes from %p\n",
              nsectors * dev->rd_sectsize,
              &dev->rd_buffer[start_sector * dev->rd_sectsize]);
@@ -283,6 +522,13 @@ static ssize_t rd_write(FAR struct inode *inode,
   else if (start_sector < dev->rd_nsectors &&
            start_sector + nsectors <= dev->rd_nsectors)
     {
+#ifdef CONFIG_RAMDISK_SPARSE
+      if (RDFLAG_IS_SPARSE(dev->rd_flags))
+        {
+          return rd_sparse_write(dev, buffer, start_sector, nsectors);
+        }
+#endif
+
       finfo("Transfer %d bytes to %p\n",
              nsectors * dev->rd_sectsize,
              &dev->rd_buffer[start_sector * dev->rd_sectsize]);
@@ -337,27 +583,65 @@ static int rd_geometry(FAR struct inode *inode,
  * Name: rd_ioctl
  *
  * Description:
- *   Return device geometry
+ *   Handle the XIP mapping, discard and sparse statistics commands
  *
  ****************************************************************************/
 
 static int rd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 {
   FAR struct rd_struct_s *dev;
-  FAR void **ppv = (FAR void **)((uintptr_t)arg);
 
   finfo("Entry\n");
 
-  /* Only one ioctl command is supported */
-
   DEBUGASSERT(inode->i_private);
-  if (cmd == BIOC_XIPBASE && ppv)
+  dev = inode->i_private;
+
+  switch (cmd)
     {
-      dev  = inode->i_private;
-      *ppv = (FAR void *)dev->rd_buffer;
+      case BIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
 
-      finfo("ppv: %p\n", *ppv);
-      return OK;
+          /* A sparse RAM disk has no contiguous memory to map */
+
+          if (ppv == NULL || RDFLAG_IS_SPARSE(dev->rd_flags))
+            {
+              break;
+            }
+
+          *ppv = (FAR void *)dev->rd_buffer;
+
+          finfo("ppv: %p\n", *ppv);
+          return OK;
+        }
+
+      case BIOC_DISCARD:
+        return rd_discard(dev, (FAR const struct blk_discard_s *)
+                               ((uintptr_t)arg));
+
+#ifdef CONFIG_RAMDISK_SPARSE
+      case BIOC_SPARSEINFO:
+        {
+          FAR struct ramdisk_sparseinfo_s *info =
+            (FAR struct ramdisk_sparseinfo_s *)((uintptr_t)arg);
+
+          if (info == NULL || !RDFLAG_IS_SPARSE(dev->rd_flags))
+            {
+              break;
+            }
+
+          nxmutex_lock(&dev->rd_lock);
+          info->pagesize   = (uint32_t)dev->rd_pagesects * dev->rd_sectsize;
+          info->npages     = dev->rd_npages;
+          info->nallocated = dev->rd_nalloc;
+          info->nzero      = dev->rd_nzero;
+          nxmutex_unlock(&dev->rd_lock);
+          return OK;
+        }
+#endif
+
+      default:
+        break;
     }
 
   return -ENOTTY;
@@ -431,12 +715,20 @@ int ramdisk_register(int minor, FAR uint8_t *buffer, uint32_t nsectors,
   /* Sanity check */
 
 #ifdef CONFIG_DEBUG_FEATURES
-  if (minor < 0 || minor > 255 || !buffer || !nsectors || !sectsize)
+  if (minor < 0 || minor > 255 || !nsectors || !sectsize ||
+      (buffer == NULL) != ((rdflags & RDFLAG_SPARSE) != 0))
     {
       return -EINVAL;
     }
 #endif
 
+#ifndef CONFIG_RAMDISK_SPARSE
+  if ((rdflags & RDFLAG_SPARSE) != 0)
+    {
+      return -ENOSYS;
+    }
+#endif
+
   /* Allocate a ramdisk device structure */
 
   dev = kmm_zalloc(sizeof(struct rd_struct_s));
@@ -449,6 +741,27 @@ int ramdisk_register(int minor, FAR uint8_t *buffer, uint32_t nsectors,
       dev->rd_buffer       = buffer;       /* RAM disk backup memory */
       dev->rd_flags        = rdflags & RDFLAG_USER;
 
+#ifdef CONFIG_RAMDISK_SPARSE
+      /* A sparse RAM disk only starts with its page table */
+
+      if (RDFLAG_IS_SPARSE(rdflags))
+        {
+          dev->rd_pagesects = MAX(CONFIG_RAMDISK_SPARSE_PAGESIZE / sectsize,
+                                  1);
+          dev->rd_npages    = (nsectors + dev->rd_pagesects - 1) /
+                              dev->rd_pagesects;
+          dev->rd_pages     = kmm_zalloc(dev->rd_npages *
+                                         sizeof(FAR uint8_t *));
+          if (dev->rd_pages == NULL)
+            {
+              kmm_free(dev);
+              return -ENOMEM;
+            }
+
+          nxmutex_init(&dev->rd_lock);
+        }
+#endif
+
       /* Create a ramdisk device name */
 
       snprintf(devname, sizeof(devname), "/dev/ram%d", minor);
@@ -459,6 +772,14 @@ int ramdisk_register(int minor, FAR uint8_t *buffer, uint32_t nsectors,
       if (ret < 0)
         {
           ferr("register_blockdriver failed: %d\n", -ret);
+#ifdef CONFIG_RAMDISK_SPARSE
+          if (RDFLAG_IS_SPARSE(rdflags))
+            {
+              nxmutex_destroy(&dev->rd_lock);
+              kmm_free(dev->rd_pages);
+            }
+#endif
+
           kmm_free(dev);
         }
     }
@@ -87,6 +87,11 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
 static ssize_t rpmsgblk_write(FAR struct inode *inode,
                               FAR const unsigned char *buffer,
                               blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t rpmsgblk_shm_transfer(FAR struct rpmsgblk_s *priv,
+                                     uint32_t command,
+                                     FAR unsigned char *buffer,
+                                     blkcnt_t start_sector,
+                                     unsigned int nsectors);
 static int     rpmsgblk_geometry(FAR struct inode *inode,
                                  FAR struct geometry *geometry);
 static ssize_t rpmsgblk_ioctl_arglen(int cmd);
@@ -139,12 +144,14 @@ static void    rpmsgblk_ns_bound(struct rpmsg_endpoint *ept);
 
 static const rpmsg_ept_cb g_rpmsgblk_handler[] =
 {
-  [RPMSGBLK_OPEN]     = rpmsgblk_default_handler,
-  [RPMSGBLK_CLOSE]    = rpmsgblk_default_handler,
-  [RPMSGBLK_READ]     = rpmsgblk_read_handler,
-  [RPMSGBLK_WRITE]    = rpmsgblk_default_handler,
-  [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
-  [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+  [RPMSGBLK_OPEN]      = rpmsgblk_default_handler,
+  [RPMSGBLK_CLOSE]     = rpmsgblk_default_handler,
+  [RPMSGBLK_READ]      = rpmsgblk_read_handler,
+  [RPMSGBLK_WRITE]     = rpmsgblk_default_handler,
+  [RPMSGBLK_GEOMETRY]  = rpmsgblk_geometry_handler,
+  [RPMSGBLK_IOCTL]     = rpmsgblk_ioctl_handler,
+  [RPMSGBLK_READ_SHM]  = rpmsgblk_default_handler,
+  [RPMSGBLK_WRITE_SHM] = rpmsgblk_default_handler,
 };
 
 /****************************************************************************
@@ -288,6 +295,13 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
       return ret;
     }
 
+  ret = rpmsgblk_shm_transfer(priv, RPMSGBLK_READ_SHM, buffer,
+                              start_sector, nsectors);
+  if (ret != -ENOTSUP)
+    {
+      return ret;
+    }
+
   /* In block read, iov_len represent the received block number */
 
   iov.iov_base = buffer;
@@ -303,6 +317,80 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
   return ret < 0 ? ret : iov.iov_len;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_shm_transfer
+ *
+ * Description:
+ *   Move a whole read or write through the rpmsg shared pool: the sectors
+ *   are copied once into a pool buffer (or out of it for reads) and a
+ *   single descriptor message replaces the chain of buffer sized chunks.
+ *
+ * Parameters:
+ *   priv         - The rpmsg-blk handle
+ *   command      - RPMSGBLK_READ_SHM or RPMSGBLK_WRITE_SHM
+ *   buffer       - The user buffer
+ *   start_sector - The first sector
+ *   nsectors     - The number of sectors
+ *
+ * Returned Values:
+ *   The number of sectors transferred, a negated errno value on failure.
+ *   -ENOTSUP means the transfer fits one message or the transport has no
+ *   shared pool, the caller then uses the regular message path.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgblk_shm_transfer(FAR struct rpmsgblk_s *priv,
+                                     uint32_t command,
+                                     FAR unsigned char *buffer,
+                                     blkcnt_t start_sector,
+                                     unsigned int nsectors)
+{
+  struct rpmsgblk_shm_s msg;
+  size_t size = (size_t)nsectors * priv->geo.geo_sectorsize;
+  FAR void *shm;
+  int ret;
+
+  if (sizeof(struct rpmsgblk_read_s) - 1 + size <=
+      rpmsg_get_tx_buffer_size(&priv->ept))
+    {
+      return -ENOTSUP;
+    }
+
+  shm = rpmsg_shm_alloc(&priv->ept, size, &msg.offset);
+  if (shm == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  if (command == RPMSGBLK_WRITE_SHM)
+    {
+      memcpy(shm, buffer, size);
+      rpmsg_shm_flush(shm, size);
+    }
+  else
+    {
+      /* Drop stale lines so that no eviction lands on the remote data */
+
+      rpmsg_shm_invalidate(shm, size);
+    }
+
+  msg.startsector = start_sector;
+  msg.nsectors    = nsectors;
+  msg.sectorsize  = priv->geo.geo_sectorsize;
+
+  ret = rpmsgblk_send_recv(priv, command, true, &msg.header,
+                           sizeof(msg), NULL);
+  if (ret > 0 && command == RPMSGBLK_READ_SHM)
+    {
+      size = (size_t)ret * priv->geo.geo_sectorsize;
+      rpmsg_shm_invalidate(shm, size);
+      memcpy(buffer, shm, size);
+    }
+
+  rpmsg_shm_free(&priv->ept, shm);
+  return ret;
+}
+
 /****************************************************************************
  * Name: rpmsgblk_write
  *
@@ -351,6 +439,14 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
       return ret;
     }
 
+  ret = rpmsgblk_shm_transfer(priv, RPMSGBLK_WRITE_SHM,
+                              (FAR unsigned char *)buffer,
+                              start_sector, nsectors);
+  if (ret != -ENOTSUP)
+    {
+      return ret;
+    }
+
   /* Perform the rpmsg write */
 
   memset(&cookie, 0, sizeof(cookie));
@@ -72,6 +72,9 @@ static int rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgblk_geometry_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv);
+static int rpmsgblk_shm_handler(FAR struct rpmsg_endpoint *ept,
+                                FAR void *data, size_t len,
+                                uint32_t src, FAR void *priv);
 static int rpmsgblk_ioctl_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
@@ -94,12 +97,14 @@ static int  rpmsgblk_ept_cb(FAR struct rpmsg_endpoint *ept,
 
 static const rpmsg_ept_cb g_rpmsgblk_handler[] =
 {
-  [RPMSGBLK_OPEN]     = rpmsgblk_open_handler,
-  [RPMSGBLK_CLOSE]    = rpmsgblk_close_handler,
-  [RPMSGBLK_READ]     = rpmsgblk_read_handler,
-  [RPMSGBLK_WRITE]    = rpmsgblk_write_handler,
-  [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
-  [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+  [RPMSGBLK_OPEN]      = rpmsgblk_open_handler,
+  [RPMSGBLK_CLOSE]     = rpmsgblk_close_handler,
+  [RPMSGBLK_READ]      = rpmsgblk_read_handler,
+  [RPMSGBLK_WRITE]     = rpmsgblk_write_handler,
+  [RPMSGBLK_GEOMETRY]  = rpmsgblk_geometry_handler,
+  [RPMSGBLK_IOCTL]     = rpmsgblk_ioctl_handler,
+  [RPMSGBLK_READ_SHM]  = rpmsgblk_shm_handler,
+  [RPMSGBLK_WRITE_SHM] = rpmsgblk_shm_handler,
 };
 
 /****************************************************************************
@@ -283,6 +288,61 @@ static int rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_shm_handler
+ ****************************************************************************/
+
+static int rpmsgblk_shm_handler(FAR struct rpmsg_endpoint *ept,
+                                FAR void *data, size_t len,
+                                uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgblk_server_s *server = ept->priv;
+  FAR struct rpmsgblk_shm_s *msg = data;
+  FAR unsigned char *shm;
+  size_t size;
+  int ret;
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  if (server->blknode->i_peer == NULL)
+    {
+      msg->header.result = -ENODEV;
+      return rpmsg_send(ept, msg, sizeof(*msg));
+    }
+#endif
+
+  size = (size_t)msg->nsectors * msg->sectorsize;
+  shm  = rpmsg_shm_get(ept, msg->offset, size);
+  if (shm == NULL || msg->sectorsize <= 0)
+    {
+      msg->header.result = -EINVAL;
+      return rpmsg_send(ept, msg, sizeof(*msg));
+    }
+
+  if (msg->header.command == RPMSGBLK_READ_SHM)
+    {
+      ret = server->bops->read(server->blknode, shm,
+                               msg->startsector, msg->nsectors);
+      if (ret > 0)
+        {
+          rpmsg_shm_flush(shm, (size_t)ret * msg->sectorsize);
+        }
+    }
+  else
+    {
+      rpmsg_shm_invalidate(shm, size);
+      ret = server->bops->write(server->blknode, shm,
+                                msg->startsector, msg->nsectors);
+    }
+
+  if (ret <= 0)
+    {
+      ferr("block shm transfer failed, ret=%d\n", ret);
+    }
+
+  msg->header.result = ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+
 /****************************************************************************
  * Name: rpmsgblk_ioctl_handler
  ****************************************************************************/
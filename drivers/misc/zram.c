@@ -0,0 +1,757 @@
+/****************************************************************************
+ * drivers/misc/zram.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <lzf.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/drivers/zram.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* lzf records the page length in 16 bits */
+
+#if CONFIG_ZRAM_PAGESIZE > 32768
+#  error CONFIG_ZRAM_PAGESIZE is too large
+#endif
+
+/* Compressed pages are kept in ZRAM_NPOOLS size classes of 1/16 page.  A
+ * page that does not shrink to 3/4 of its size or less is stored as is.
+ */
+
+#define ZRAM_NPOOLS            12
+#define ZRAM_POOLSTEP(dev)     ((dev)->zr_pagesize / 16)
+#define ZRAM_MAXCOMP(dev)      (ZRAM_POOLSTEP(dev) * ZRAM_NPOOLS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct zram_slot_s
+{
+  FAR uint8_t *data;            /* Page contents, NULL reads as zero */
+  uint32_t len;                 /* Compressed length, pagesize if raw */
+};
+
+struct zram_dev_s
+{
+  mutex_t zr_lock;              /* Protects the slots and scratch buffers */
+  uint32_t zr_nsectors;         /* Number of sectors on device */
+  uint16_t zr_sectsize;         /* The size of one sector */
+  uint16_t zr_pagesects;        /* Sectors in one page */
+  uint32_t zr_pagesize;         /* Bytes in one page */
+  uint32_t zr_npages;           /* Pages covering the whole disk */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  uint8_t zr_crefs;             /* Open reference count */
+  bool zr_unlinked;             /* The driver has been unlinked */
+#endif
+  uint32_t zr_ncomp;            /* Pages stored compressed */
+  uint32_t zr_nraw;             /* Pages stored as is */
+  uint32_t zr_nzero;            /* Zero page writes not backed by memory */
+  size_t zr_compbytes;          /* Bytes of compressed data */
+
+  /* Compressed page pools and one slot per page */
+
+  FAR struct mempool_multiple_s *zr_mpool;
+  FAR struct zram_slot_s *zr_slots;
+  FAR uint8_t *zr_scratch;      /* Backs zr_page and zr_comp */
+  FAR uint8_t *zr_page;         /* Uncompressed page scratch */
+  FAR uint8_t *zr_comp;         /* Compression output scratch */
+  FAR lzf_hslot_t *zr_htab;     /* lzf hash table */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     zram_open(FAR struct inode *inode);
+static int     zram_close(FAR struct inode *inode);
+#endif
+
+static ssize_t zram_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                         blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t zram_write(FAR struct inode *inode,
+                          FAR const unsigned char *buffer,
+                          blkcnt_t start_sector, unsigned int nsectors);
+static int     zram_geometry(FAR struct inode *inode,
+                             FAR struct geometry *geometry);
+static int     zram_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     zram_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_zram_bops =
+{
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  zram_open,     /* open     */
+  zram_close,    /* close    */
+#else
+  NULL,          /* open     */
+  NULL,          /* close    */
+#endif
+  zram_read,     /* read     */
+  zram_write,    /* write    */
+  zram_geometry, /* geometry */
+  zram_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , zram_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: zram_mpool_alloc/zram_mpool_size/zram_mpool_free
+ *
+ * Description:
+ *   Back the compressed page pools with the kernel heap.
+ *
+ ****************************************************************************/
+
+static FAR void *zram_mpool_alloc(FAR void *arg, size_t alignment,
+                                  size_t size)
+{
+  return kmm_memalign(alignment, size);
+}
+
+static size_t zram_mpool_size(FAR void *arg, FAR void *addr)
+{
+  return kmm_malloc_size(addr);
+}
+
+static void zram_mpool_free(FAR void *arg, FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+/****************************************************************************
+ * Name: zram_iszero
+ *
+ * Description:
+ *   Return true if the 'len' bytes at 'buf' are all zero.
+ *
+ ****************************************************************************/
+
+static bool zram_iszero(FAR const uint8_t *buf, size_t len)
+{
+  return buf[0] == 0 && memcmp(buf, buf + 1, len - 1) == 0;
+}
+
+/****************************************************************************
+ * Name: zram_release
+ *
+ * Description:
+ *   Free the memory behind one page, which then reads as zero.
+ *
+ ****************************************************************************/
+
+static void zram_release(FAR struct zram_dev_s *dev, uint32_t page)
+{
+  FAR struct zram_slot_s *slot = &dev->zr_slots[page];
+
+  if (slot->data == NULL)
+    {
+      return;
+    }
+
+  if (slot->len == dev->zr_pagesize)
+    {
+      kmm_free(slot->data);
+      dev->zr_nraw--;
+    }
+  else
+    {
+      mempool_multiple_free(dev->zr_mpool, slot->data);
+      dev->zr_ncomp--;
+      dev->zr_compbytes -= slot->len;
+    }
+
+  slot->data = NULL;
+  slot->len  = 0;
+}
+
+/****************************************************************************
+ * Name: zram_load
+ *
+ * Description:
+ *   Uncompress one page into 'dest'.
+ *
+ ****************************************************************************/
+
+static int zram_load(FAR struct zram_dev_s *dev, uint32_t page,
+                     FAR uint8_t *dest)
+{
+  FAR struct zram_slot_s *slot = &dev->zr_slots[page];
+
+  if (slot->data == NULL)
+    {
+      memset(dest, 0, dev->zr_pagesize);
+    }
+  else if (slot->len == dev->zr_pagesize)
+    {
+      memcpy(dest, slot->data, dev->zr_pagesize);
+    }
+  else if (lzf_decompress(slot->data, slot->len, dest,
+                          dev->zr_pagesize) != dev->zr_pagesize)
+    {
+      ferr("ERROR: Corrupted zram page %" PRIu32 "\n", page);
+      return -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zram_store
+ *
+ * Description:
+ *   Replace one page with the contents of the page scratch buffer.  Zero
+ *   pages release their memory, other pages are compressed into a pool
+ *   block, or copied as is if they do not compress well.
+ *
+ ****************************************************************************/
+
+static int zram_store(FAR struct zram_dev_s *dev, uint32_t page)
+{
+  FAR struct zram_slot_s *slot = &dev->zr_slots[page];
+  FAR struct lzf_header_s *header;
+  FAR uint8_t *src = dev->zr_page;
+  FAR uint8_t *data;
+  size_t len;
+
+  if (zram_iszero(src, dev->zr_pagesize))
+    {
+      zram_release(dev, page);
+      dev->zr_nzero++;
+      return OK;
+    }
+
+  /* lzf writes its header in front of the output, or in front of the
+   * input if the data does not fit.  Both scratch buffers have room for it.
+   */
+
+  len = lzf_compress(src, dev->zr_pagesize, dev->zr_comp,
+                     ZRAM_MAXCOMP(dev), dev->zr_htab, &header);
+  if (header->lzf_type == LZF_TYPE1_HDR)
+    {
+      len -= LZF_TYPE1_HDR_SIZE;
+      data = mempool_multiple_alloc(dev->zr_mpool, len);
+      src  = dev->zr_comp;
+    }
+  else
+    {
+      len  = dev->zr_pagesize;
+      data = kmm_malloc(len);
+    }
+
+  if (data == NULL)
+    {
+      ferr("ERROR: No memory for zram page %" PRIu32 "\n", page);
+      return -ENOMEM;
+    }
+
+  memcpy(data, src, len);
+  zram_release(dev, page);
+
+  slot->data = data;
+  slot->len  = len;
+  if (len == dev->zr_pagesize)
+    {
+      dev->zr_nraw++;
+    }
+  else
+    {
+      dev->zr_ncomp++;
+      dev->zr_compbytes += len;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zram_destroy
+ *
+ * Description:
+ *   Free all resources used by the compressed RAM disk
+ *
+ ****************************************************************************/
+
+static void zram_destroy(FAR struct zram_dev_s *dev)
+{
+  uint32_t i;
+
+  if (dev->zr_slots != NULL)
+    {
+      for (i = 0; i < dev->zr_npages; i++)
+        {
+          zram_release(dev, i);
+        }
+    }
+
+  if (dev->zr_mpool != NULL)
+    {
+      mempool_multiple_deinit(dev->zr_mpool);
+    }
+
+  kmm_free(dev->zr_htab);
+  kmm_free(dev->zr_scratch);
+  kmm_free(dev->zr_slots);
+  nxmutex_destroy(&dev->zr_lock);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: zram_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int zram_open(FAR struct inode *inode)
+{
+  FAR struct zram_dev_s *dev = inode->i_private;
+
+  nxmutex_lock(&dev->zr_lock);
+  dev->zr_crefs++;
+  DEBUGASSERT(dev->zr_crefs > 0);
+  nxmutex_unlock(&dev->zr_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zram_close
+ *
+ * Description: Close the block device
+ *
+ ****************************************************************************/
+
+static int zram_close(FAR struct inode *inode)
+{
+  FAR struct zram_dev_s *dev = inode->i_private;
+  bool destroy;
+
+  nxmutex_lock(&dev->zr_lock);
+  DEBUGASSERT(dev->zr_crefs > 0);
+  dev->zr_crefs--;
+  destroy = dev->zr_crefs == 0 && dev->zr_unlinked;
+  nxmutex_unlock(&dev->zr_lock);
+
+  if (destroy)
+    {
+      zram_destroy(dev);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: zram_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t zram_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                         blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct zram_dev_s *dev = inode->i_private;
+  ssize_t nread = 0;
+  int ret = OK;
+
+  if (start_sector >= dev->zr_nsectors ||
+      start_sector + nsectors > dev->zr_nsectors)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&dev->zr_lock);
+
+  while (nsectors > 0)
+    {
+      uint32_t page = start_sector / dev->zr_pagesects;
+      size_t offset = (start_sector % dev->zr_pagesects) * dev->zr_sectsize;
+      unsigned int count = MIN(nsectors, dev->zr_pagesects -
+                               start_sector % dev->zr_pagesects);
+      size_t nbytes = (size_t)count * dev->zr_sectsize;
+
+      /* Whole pages are uncompressed straight into the caller's buffer */
+
+      if (nbytes == dev->zr_pagesize)
+        {
+          ret = zram_load(dev, page, buffer);
+        }
+      else
+        {
+          ret = zram_load(dev, page, dev->zr_page);
+          memcpy(buffer, dev->zr_page + offset, nbytes);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      buffer       += nbytes;
+      start_sector += count;
+      nsectors     -= count;
+      nread        += count;
+    }
+
+  nxmutex_unlock(&dev->zr_lock);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: zram_write
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t zram_write(FAR struct inode *inode,
+                          FAR const unsigned char *buffer,
+                          blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct zram_dev_s *dev = inode->i_private;
+  ssize_t nwritten = 0;
+  int ret = OK;
+
+  if (start_sector >= dev->zr_nsectors ||
+      start_sector + nsectors > dev->zr_nsectors)
+    {
+      return -EFBIG;
+    }
+
+  nxmutex_lock(&dev->zr_lock);
+
+  while (nsectors > 0)
+    {
+      uint32_t page = start_sector / dev->zr_pagesects;
+      size_t offset = (start_sector % dev->zr_pagesects) * dev->zr_sectsize;
+      unsigned int count = MIN(nsectors, dev->zr_pagesects -
+                               start_sector % dev->zr_pagesects);
+      size_t nbytes = (size_t)count * dev->zr_sectsize;
+
+      /* A partial page is merged into its current contents */
+
+      if (nbytes != dev->zr_pagesize)
+        {
+          ret = zram_load(dev, page, dev->zr_page);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      memcpy(dev->zr_page + offset, buffer, nbytes);
+      ret = zram_store(dev, page);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      buffer       += nbytes;
+      start_sector += count;
+      nsectors     -= count;
+      nwritten     += count;
+    }
+
+  nxmutex_unlock(&dev->zr_lock);
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: zram_discard
+ *
+ * Description:
+ *   Handle BIOC_DISCARD.  Whole pages are released; partially discarded
+ *   pages are cleared in the range so that it reads back as zero.
+ *
+ ****************************************************************************/
+
+static int zram_discard(FAR struct zram_dev_s *dev,
+                        FAR const struct blk_discard_s *range)
+{
+  blkcnt_t start_sector;
+  blkcnt_t nsectors;
+  int ret = OK;
+
+  if (range == NULL || range->start < 0 || range->nsectors < 0 ||
+      range->start > dev->zr_nsectors ||
+      range->nsectors > dev->zr_nsectors - range->start)
+    {
+      return -EINVAL;
+    }
+
+  start_sector = range->start;
+  nsectors     = range->nsectors;
+
+  nxmutex_lock(&dev->zr_lock);
+
+  while (nsectors > 0)
+    {
+      uint32_t page = start_sector / dev->zr_pagesects;
+      size_t offset = (start_sector % dev->zr_pagesects) * dev->zr_sectsize;
+      blkcnt_t count = MIN(nsectors, dev->zr_pagesects -
+                           start_sector % dev->zr_pagesects);
+
+      if (count == dev->zr_pagesects)
+        {
+          zram_release(dev, page);
+        }
+      else if (dev->zr_slots[page].data != NULL)
+        {
+          ret = zram_load(dev, page, dev->zr_page);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          memset(dev->zr_page + offset, 0, count * dev->zr_sectsize);
+          ret = zram_store(dev, page);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      start_sector += count;
+      nsectors     -= count;
+    }
+
+  nxmutex_unlock(&dev->zr_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: zram_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int zram_geometry(FAR struct inode *inode,
+                         FAR struct geometry *geometry)
+{
+  FAR struct zram_dev_s *dev = inode->i_private;
+
+  if (geometry == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(geometry, 0, sizeof(*geometry));
+
+  geometry->geo_available     = true;
+  geometry->geo_mediachanged  = false;
+  geometry->geo_writeenabled  = true;
+  geometry->geo_nsectors      = dev->zr_nsectors;
+  geometry->geo_sectorsize    = dev->zr_sectsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zram_ioctl
+ *
+ * Description:
+ *   Handle the discard and statistics commands
+ *
+ ****************************************************************************/
+
+static int zram_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct zram_dev_s *dev = inode->i_private;
+
+  switch (cmd)
+    {
+      case BIOC_DISCARD:
+        return zram_discard(dev, (FAR const struct blk_discard_s *)
+                                 ((uintptr_t)arg));
+
+      case BIOC_ZRAMINFO:
+        {
+          FAR struct zram_info_s *info =
+            (FAR struct zram_info_s *)((uintptr_t)arg);
+
+          if (info == NULL)
+            {
+              return -EINVAL;
+            }
+
+          nxmutex_lock(&dev->zr_lock);
+          info->pagesize    = dev->zr_pagesize;
+          info->npages      = dev->zr_npages;
+          info->ncompressed = dev->zr_ncomp;
+          info->nraw        = dev->zr_nraw;
+          info->nzero       = dev->zr_nzero;
+          info->compbytes   = dev->zr_compbytes;
+          nxmutex_unlock(&dev->zr_lock);
+          return OK;
+        }
+
+      default:
+        break;
+    }
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: zram_unlink
+ *
+ * Description:
+ *   The block driver has been unlinked.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int zram_unlink(FAR struct inode *inode)
+{
+  FAR struct zram_dev_s *dev = inode->i_private;
+  bool destroy;
+
+  nxmutex_lock(&dev->zr_lock);
+  dev->zr_unlinked = true;
+  destroy = dev->zr_crefs == 0;
+  nxmutex_unlock(&dev->zr_lock);
+
+  if (destroy)
+    {
+      zram_destroy(dev);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: zram_register
+ *
+ * Description:
+ *   Register a compressed RAM disk as /dev/zramN.
+ *
+ ****************************************************************************/
+
+int zram_register(int minor, uint32_t nsectors, uint16_t sectsize)
+{
+  FAR struct zram_dev_s *dev;
+  size_t poolsize[ZRAM_NPOOLS];
+  char devname[16];
+  int ret = -ENOMEM;
+  int i;
+
+  if (minor < 0 || minor > 255 || nsectors == 0 || sectsize == 0 ||
+      sectsize > CONFIG_ZRAM_PAGESIZE ||
+      CONFIG_ZRAM_PAGESIZE % sectsize != 0)
+    {
+      return -EINVAL;
+    }
+
+  dev = kmm_zalloc(sizeof(struct zram_dev_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&dev->zr_lock);
+  dev->zr_nsectors  = nsectors;
+  dev->zr_sectsize  = sectsize;
+  dev->zr_pagesize  = CONFIG_ZRAM_PAGESIZE;
+  dev->zr_pagesects = CONFIG_ZRAM_PAGESIZE / sectsize;
+  dev->zr_npages    = (nsectors + dev->zr_pagesects - 1) /
+                      dev->zr_pagesects;
+
+  for (i = 0; i < ZRAM_NPOOLS; i++)
+    {
+      poolsize[i] = (i + 1) * ZRAM_POOLSTEP(dev);
+    }
+
+  dev->zr_slots   = kmm_zalloc(dev->zr_npages *
+                               sizeof(struct zram_slot_s));
+  dev->zr_scratch = kmm_malloc(dev->zr_pagesize + ZRAM_MAXCOMP(dev) +
+                               2 * LZF_MAX_HDR_SIZE);
+  dev->zr_htab    = kmm_malloc(sizeof(lzf_state_t));
+  dev->zr_mpool   = mempool_multiple_init("zram", poolsize, ZRAM_NPOOLS,
+                                          zram_mpool_alloc, zram_mpool_size,
+                                          zram_mpool_free, NULL, 0,
+                                          4 * dev->zr_pagesize,
+                                          4 * dev->zr_pagesize);
+  if (dev->zr_slots == NULL || dev->zr_scratch == NULL ||
+      dev->zr_htab == NULL || dev->zr_mpool == NULL)
+    {
+      goto errout;
+    }
+
+  /* Both scratch buffers have room for the lzf header in front */
+
+  dev->zr_page = dev->zr_scratch + LZF_MAX_HDR_SIZE;
+  dev->zr_comp = dev->zr_page + dev->zr_pagesize + LZF_MAX_HDR_SIZE;
+
+  snprintf(devname, sizeof(devname), "/dev/zram%d", minor);
+  ret = register_blockdriver(devname, &g_zram_bops, 0, dev);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+
+  ferr("ERROR: register_blockdriver failed: %d\n", ret);
+
+errout:
+  zram_destroy(dev);
+  return ret;
+}
@@ -93,6 +93,9 @@ struct mmcsd_state_s
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
+#ifdef CONFIG_MMCSD_MMCCACHE
+  uint8_t cacheon:1;               /* true: eMMC volatile cache enabled */
+#endif
 
   uint8_t mode:4;                  /* (See MMCSDMODE_* definitions) */
   uint8_t type:4;                  /* Card type (See MMCSD_CARDTYPE_* definitions) */
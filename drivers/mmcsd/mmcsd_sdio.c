@@ -161,6 +161,11 @@ static int     mmcsd_get_r1(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_verifystate(FAR struct mmcsd_state_s *priv,
                                  uint32_t status);
 static int     mmcsd_switch(FAR struct mmcsd_state_s *priv, uint32_t arg);
+#ifdef CONFIG_MMCSD_MMCCACHE
+static void    mmcsd_cacheenable(FAR struct mmcsd_state_s *priv,
+                                 FAR const uint8_t *extcsd);
+static int     mmcsd_flushcache(FAR struct mmcsd_state_s *priv);
+#endif
 
 /* Transfer helpers *********************************************************/
 
@@ -1122,6 +1127,81 @@ static int mmcsd_switch(FAR struct mmcsd_state_s *priv, uint32_t arg)
   return mmcsd_recv_r1(priv, MMCSD_CMD6);
 }
 
+#ifdef CONFIG_MMCSD_MMCCACHE
+/****************************************************************************
+ * Name: mmcsd_cacheenable
+ *
+ * Description:
+ *   Switch on the volatile cache of an eMMC device if it has one.  A
+ *   failure is not fatal, the device is then used without the cache.
+ *
+ ****************************************************************************/
+
+static void mmcsd_cacheenable(FAR struct mmcsd_state_s *priv,
+                              FAR const uint8_t *extcsd)
+{
+  uint32_t cachesize;
+  int ret;
+
+  priv->cacheon = false;
+
+  /* CACHE_SIZE is in units of 1 Kibit, zero if there is no cache */
+
+  cachesize = ((uint32_t)extcsd[MMCSD_EXTCSD_CACHE_SIZE + 3] << 24) |
+              ((uint32_t)extcsd[MMCSD_EXTCSD_CACHE_SIZE + 2] << 16) |
+              ((uint32_t)extcsd[MMCSD_EXTCSD_CACHE_SIZE + 1] << 8) |
+              extcsd[MMCSD_EXTCSD_CACHE_SIZE];
+  if (cachesize == 0)
+    {
+      return;
+    }
+
+  ret = mmcsd_switch(priv, MMC_CMD6_MODE(MMC_CMD6_MODE_WRITE_BYTE) |
+                           MMC_CMD6_INDEX(MMCSD_EXTCSD_CACHE_CTRL) |
+                           MMC_CMD6_VALUE(MMCSD_CACHE_CTRL_EN));
+  if (ret != OK)
+    {
+      ferr("ERROR: Failed to enable the eMMC cache: %d\n", ret);
+      return;
+    }
+
+  finfo("eMMC cache of %" PRIu32 " Kibit enabled\n", cachesize);
+  priv->cacheon = true;
+}
+
+/****************************************************************************
+ * Name: mmcsd_flushcache
+ *
+ * Description:
+ *   Write the volatile cache of an eMMC device to the flash and wait until
+ *   the device has finished.
+ *
+ ****************************************************************************/
+
+static int mmcsd_flushcache(FAR struct mmcsd_state_s *priv)
+{
+  int ret;
+
+  if (!priv->cacheon || IS_EMPTY(priv))
+    {
+      return OK;
+    }
+
+  ret = mmcsd_switch(priv, MMC_CMD6_MODE(MMC_CMD6_MODE_WRITE_BYTE) |
+                           MMC_CMD6_INDEX(MMCSD_EXTCSD_FLUSH_CACHE) |
+                           MMC_CMD6_VALUE(MMCSD_FLUSH_CACHE_FLUSH));
+  if (ret != OK)
+    {
+      ferr("ERROR: Failed to flush the eMMC cache: %d\n", ret);
+      return ret;
+    }
+
+  /* The device stays in the programming state until the flush is done */
+
+  return mmcsd_transferready(priv);
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_get_r1
  *
@@ -2319,6 +2399,16 @@ static int mmcsd_close(FAR struct inode *inode)
     }
 
   priv->crefs--;
+
+#ifdef CONFIG_MMCSD_MMCCACHE
+  /* Write the device cache back when the last user goes away */
+
+  if (priv->crefs == 0)
+    {
+      mmcsd_flushcache(priv);
+    }
+#endif
+
   mmcsd_unlock(priv);
   return OK;
 }
@@ -2609,6 +2699,15 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       }
       break;
 
+#ifdef CONFIG_MMCSD_MMCCACHE
+    case BIOC_FLUSH: /* Write the eMMC volatile cache to the flash */
+      {
+        finfo("BIOC_FLUSH\n");
+        ret = mmcsd_flushcache(priv);
+      }
+      break;
+#endif
+
 #ifdef CONFIG_MMCSD_IOCSUPPORT
     case MMC_IOC_CMD: /* MMCSD device ioctl commands */
       {
@@ -3103,6 +3202,9 @@ static int mmcsd_mmcinitialize(FAR struct mmcsd_state_s *priv)
         }
 
       mmcsd_decode_extcsd(priv, extcsd);
+#ifdef CONFIG_MMCSD_MMCCACHE
+      mmcsd_cacheenable(priv, extcsd);
+#endif
     }
 
   mmcsd_decode_csd(priv, priv->csd);
@@ -4408,6 +4510,9 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->probed       = false;
   priv->mediachanged = false;
   priv->wrbusy       = false;
+#ifdef CONFIG_MMCSD_MMCCACHE
+  priv->cacheon      = false;
+#endif
   priv->type         = MMCSD_CARDTYPE_UNKNOWN;
   priv->rca          = 0;
   priv->selblocklen  = 0;
@@ -26,14 +26,25 @@
 
 #include <nuttx/config.h>
 
+#include <sys/stat.h>
+
+#include <inttypes.h>
 #include <errno.h>
 #include <debug.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <nuttx/nuttx.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/procfs.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 
 #include <dhara/map.h>
 #include <dhara/nand.h>
@@ -42,10 +53,52 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_DHARA)
+#  define HAVE_DHARA_PROCFS 1
+#endif
+
+/* Marks an unused entry of the write combining cache */
+
+#define DHARA_WCACHE_EMPTY  ((dhara_sector_t)-1)
+
+/* Length of the device name reported by procfs and of the longest line
+ * generated by the procfs read logic.
+ */
+
+#define DHARA_NAMELEN       32
+#define DHARA_LINELEN       64
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef HAVE_DHARA_PROCFS
+/* Write amplification and garbage collection counters */
+
+struct dhara_stats_s
+{
+  uint32_t writes;      /* Sectors written by the block layer */
+  uint32_t combined;    /* Writes absorbed by the write combining cache */
+  uint32_t mapwrites;   /* Sectors written to the map */
+  uint32_t progs;       /* Pages programmed, including metadata and GC */
+  uint32_t erases;      /* Blocks erased */
+  uint32_t gcsteps;     /* Background garbage collection steps */
+  uint64_t gctime;      /* Total background GC time in microseconds */
+  uint32_t gcmax;       /* Longest background GC pass in microseconds */
+  uint32_t writemax;    /* Longest map write in microseconds */
+};
+#endif
+
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+/* One sector held by the write combining cache */
+
+struct dhara_wcache_s
+{
+  dhara_sector_t sector;
+  FAR uint8_t   *buffer;
+};
+#endif
+
 struct dhara_pagecache_s
 {
   dq_entry_t   node;
@@ -77,6 +130,26 @@ struct dhara_dev_s
 
   struct dq_queue_s readcache;
   dhara_pagecache_t readpage[CONFIG_DHARA_READ_NCACHES];
+
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  /* Write combining cache: sector writes are collected in RAM so that
+   * repeated writes of the same sector only reach the map once.
+   */
+
+  FAR uint8_t *wcachebuf;
+  uint16_t     nwcache;
+  struct dhara_wcache_s wcache[CONFIG_DHARA_WRITE_NCACHES];
+#endif
+
+#ifdef CONFIG_DHARA_BGGC
+  struct work_s work;             /* Background flush and GC work */
+#endif
+
+#ifdef HAVE_DHARA_PROCFS
+  FAR struct dhara_dev_s *flink;  /* Supports a singly linked list */
+  char name[DHARA_NAMELEN];       /* Block device path */
+  struct dhara_stats_s stats;     /* Write and GC counters */
+#endif
 };
 
 typedef struct dhara_dev_s dhara_dev_t;
@@ -104,6 +177,19 @@ static int     dhara_ioctl(FAR struct inode *inode,
 static int     dhara_unlink(FAR struct inode *inode);
 #endif
 
+#ifdef HAVE_DHARA_PROCFS
+static int     dhara_procfs_open(FAR struct file *filep,
+                                 FAR const char *relpath,
+                                 int oflags, mode_t mode);
+static int     dhara_procfs_close(FAR struct file *filep);
+static ssize_t dhara_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen);
+static int     dhara_procfs_dup(FAR const struct file *oldp,
+                                FAR struct file *newp);
+static int     dhara_procfs_stat(FAR const char *relpath,
+                                 FAR struct stat *buf);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -121,6 +207,39 @@ static const struct block_operations g_dhara_bops =
 #endif
 };
 
+#ifdef HAVE_DHARA_PROCFS
+/* All dhara devices, for procfs */
+
+static FAR dhara_dev_t *g_dhara_devs;
+static mutex_t g_dhara_devlock = NXMUTEX_INITIALIZER;
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef HAVE_DHARA_PROCFS
+/* See fs_procfs.c -- this structure is explicitly externed there */
+
+const struct procfs_operations g_dhara_operations =
+{
+  dhara_procfs_open,  /* open */
+  dhara_procfs_close, /* close */
+  dhara_procfs_read,  /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  dhara_procfs_dup,   /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  dhara_procfs_stat   /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -288,6 +407,353 @@ static void dhara_update_readcache(FAR dhara_dev_t *dev,
     }
 }
 
+#ifdef HAVE_DHARA_PROCFS
+static uint32_t dhara_elapsed(clock_t start)
+{
+  struct timespec ts;
+
+  perf_convert(perf_gettime() - start, &ts);
+  return ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+#endif
+
+/****************************************************************************
+ * Name: dhara_write_sector
+ *
+ * Description:
+ *   Write one sector to the map.  Any garbage collection that the map
+ *   decides to run inline happens here.
+ *
+ ****************************************************************************/
+
+static int dhara_write_sector(FAR dhara_dev_t *dev, dhara_sector_t sector,
+                              FAR const uint8_t *data)
+{
+  dhara_error_t err;
+  int ret;
+#ifdef HAVE_DHARA_PROCFS
+  clock_t start = perf_gettime();
+  uint32_t elapsed;
+#endif
+
+  ret = dhara_map_write(&dev->map, sector, data, &err);
+  if (ret < 0)
+    {
+      ferr("Write sector %" PRIu32 " failed err %s\n",
+           (uint32_t)sector, dhara_strerror(err));
+      return dhara_convert_result(err);
+    }
+
+#ifdef HAVE_DHARA_PROCFS
+  elapsed = dhara_elapsed(start);
+  if (elapsed > dev->stats.writemax)
+    {
+      dev->stats.writemax = elapsed;
+    }
+
+  dev->stats.mapwrites++;
+#endif
+
+  return 0;
+}
+
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+static int dhara_init_writecache(FAR dhara_dev_t *dev)
+{
+  int i;
+
+  dev->wcachebuf = kmm_malloc(dev->geo.blocksize *
+                              CONFIG_DHARA_WRITE_NCACHES);
+  if (dev->wcachebuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_DHARA_WRITE_NCACHES; i++)
+    {
+      dev->wcache[i].sector = DHARA_WCACHE_EMPTY;
+      dev->wcache[i].buffer = dev->wcachebuf + i * dev->geo.blocksize;
+    }
+
+  return 0;
+}
+
+static FAR struct dhara_wcache_s *
+dhara_find_writecache(FAR dhara_dev_t *dev, dhara_sector_t sector)
+{
+  int i;
+
+  if (dev->nwcache > 0)
+    {
+      for (i = 0; i < CONFIG_DHARA_WRITE_NCACHES; i++)
+        {
+          if (dev->wcache[i].sector == sector)
+            {
+              return &dev->wcache[i];
+            }
+        }
+    }
+
+  return NULL;
+}
+
+static void dhara_drop_writecache(FAR dhara_dev_t *dev,
+                                  dhara_sector_t sector)
+{
+  FAR struct dhara_wcache_s *wcache;
+
+  wcache = dhara_find_writecache(dev, sector);
+  if (wcache != NULL)
+    {
+      wcache->sector = DHARA_WCACHE_EMPTY;
+      dev->nwcache--;
+    }
+}
+
+/****************************************************************************
+ * Name: dhara_flush_writecache
+ *
+ * Description:
+ *   Write every sector held by the write combining cache to the map.
+ *
+ ****************************************************************************/
+
+static int dhara_flush_writecache(FAR dhara_dev_t *dev)
+{
+  FAR struct dhara_wcache_s *wcache;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_DHARA_WRITE_NCACHES && dev->nwcache > 0; i++)
+    {
+      wcache = &dev->wcache[i];
+      if (wcache->sector != DHARA_WCACHE_EMPTY)
+        {
+          ret = dhara_write_sector(dev, wcache->sector, wcache->buffer);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          wcache->sector = DHARA_WCACHE_EMPTY;
+          dev->nwcache--;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: dhara_cache_write
+ *
+ * Description:
+ *   Place one sector in the write combining cache, overwriting an older
+ *   copy of the same sector or flushing the cache first if it is full.
+ *
+ ****************************************************************************/
+
+static int dhara_cache_write(FAR dhara_dev_t *dev, dhara_sector_t sector,
+                             FAR const uint8_t *data)
+{
+  FAR struct dhara_wcache_s *wcache;
+  int ret;
+
+  wcache = dhara_find_writecache(dev, sector);
+  if (wcache != NULL)
+    {
+#ifdef HAVE_DHARA_PROCFS
+      dev->stats.combined++;
+#endif
+      memcpy(wcache->buffer, data, dev->geo.blocksize);
+      return 0;
+    }
+
+  if (dev->nwcache >= CONFIG_DHARA_WRITE_NCACHES)
+    {
+      ret = dhara_flush_writecache(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  wcache = dhara_find_writecache(dev, DHARA_WCACHE_EMPTY);
+  if (wcache == NULL)
+    {
+      wcache = &dev->wcache[0];
+    }
+
+  memcpy(wcache->buffer, data, dev->geo.blocksize);
+  wcache->sector = sector;
+  dev->nwcache++;
+  return 0;
+}
+#endif /* CONFIG_DHARA_WRITE_NCACHES > 0 */
+
+/****************************************************************************
+ * Name: dhara_flush
+ *
+ * Description:
+ *   Write back the write combining cache and make the map persistent.
+ *   Called with the device lock held.
+ *
+ ****************************************************************************/
+
+static int dhara_flush(FAR dhara_dev_t *dev)
+{
+  dhara_error_t err;
+  int ret;
+
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  ret = dhara_flush_writecache(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
+  ret = dhara_map_sync(&dev->map, &err);
+  if (ret < 0)
+    {
+      ferr("Map sync failed err %s\n", dhara_strerror(err));
+      return dhara_convert_result(err);
+    }
+
+  return 0;
+}
+
+#ifdef CONFIG_DHARA_BGGC
+static bool dhara_gc_needed(FAR dhara_dev_t *dev)
+{
+  /* The map collects garbage inline once the journal has grown to the
+   * capacity; keep it at least the threshold below that point.
+   */
+
+  return dhara_journal_size(&dev->map.journal) +
+         CONFIG_DHARA_BGGC_THRESHOLD >= dhara_map_capacity(&dev->map) &&
+         dhara_map_size(&dev->map) > 0;
+}
+
+/****************************************************************************
+ * Name: dhara_bggc_worker
+ *
+ * Description:
+ *   Runs on the low priority work queue once the device has been idle for
+ *   CONFIG_DHARA_BGGC_DELAY milliseconds.  Writes back the write combining
+ *   cache and then performs garbage collection in passes of
+ *   CONFIG_DHARA_GC_RATIO steps (the amount of work an inline collection
+ *   does for one write) until the free space threshold is met again.
+ *
+ ****************************************************************************/
+
+static void dhara_bggc_worker(FAR void *arg)
+{
+  FAR dhara_dev_t *dev = arg;
+  dhara_error_t err;
+  dhara_page_t size;
+  bool again = false;
+  int steps = 0;
+#ifdef HAVE_DHARA_PROCFS
+  clock_t start;
+  uint32_t elapsed;
+#endif
+
+  nxmutex_lock(&dev->lock);
+
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  if (dhara_flush_writecache(dev) < 0)
+    {
+      nxmutex_unlock(&dev->lock);
+      return;
+    }
+#endif
+
+#ifdef HAVE_DHARA_PROCFS
+  start = perf_gettime();
+#endif
+
+  size = dhara_journal_size(&dev->map.journal);
+  while (steps < CONFIG_DHARA_GC_RATIO && dhara_gc_needed(dev))
+    {
+      if (dhara_map_gc(&dev->map, &err) < 0)
+        {
+          ferr("Background GC failed err %s\n", dhara_strerror(err));
+          break;
+        }
+
+      steps++;
+    }
+
+  if (steps > 0)
+    {
+#ifdef HAVE_DHARA_PROCFS
+      elapsed = dhara_elapsed(start);
+      dev->stats.gcsteps += steps;
+      dev->stats.gctime  += elapsed;
+      if (elapsed > dev->stats.gcmax)
+        {
+          dev->stats.gcmax = elapsed;
+        }
+#endif
+
+      /* Continue only while collection is making progress: a map full
+       * of live data cannot shrink the journal any further.
+       */
+
+      again = steps == CONFIG_DHARA_GC_RATIO && dhara_gc_needed(dev) &&
+              dhara_journal_size(&dev->map.journal) < size;
+    }
+
+  nxmutex_unlock(&dev->lock);
+
+  /* Yield to writers for a tick between passes */
+
+  if (again)
+    {
+      work_queue(LPWORK, &dev->work, dhara_bggc_worker, dev, 1);
+    }
+}
+#endif /* CONFIG_DHARA_BGGC */
+
+/****************************************************************************
+ * Name: dhara_free
+ *
+ * Description:
+ *   Release all resources of a device.
+ *
+ ****************************************************************************/
+
+static void dhara_free(FAR dhara_dev_t *dev)
+{
+#ifdef HAVE_DHARA_PROCFS
+  FAR dhara_dev_t **link;
+
+  nxmutex_lock(&g_dhara_devlock);
+  for (link = &g_dhara_devs; *link != NULL; link = &(*link)->flink)
+    {
+      if (*link == dev)
+        {
+          *link = dev->flink;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_dhara_devlock);
+#endif
+
+#ifdef CONFIG_DHARA_BGGC
+  work_cancel_sync(LPWORK, &dev->work);
+#endif
+
+  nxmutex_destroy(&dev->lock);
+  dhara_deinit_readcache(dev);
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  kmm_free(dev->wcachebuf);
+#endif
+  kmm_free(dev->pagebuf);
+  kmm_free(dev);
+}
+
 /****************************************************************************
  * Name: dhara_open
  *
@@ -323,14 +789,19 @@ static int dhara_close(FAR struct inode *inode)
   dev = inode->i_private;
   nxmutex_lock(&dev->lock);
   dev->refs--;
+
+  /* Make everything written so far persistent on the last close */
+
+  if (dev->refs == 0)
+    {
+      dhara_flush(dev);
+    }
+
   nxmutex_unlock(&dev->lock);
 
   if (dev->refs == 0 && dev->unlinked)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_free(dev);
     }
 
   return 0;
@@ -359,10 +830,25 @@ static ssize_t dhara_read(FAR struct inode *inode,
   while (nsectors-- > 0)
     {
       dhara_error_t err;
-      ret = dhara_map_read(&dev->map,
-                           start_sector,
-                           buffer,
-                           &err);
+
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+      FAR struct dhara_wcache_s *wcache;
+
+      wcache = dhara_find_writecache(dev, start_sector);
+      if (wcache != NULL)
+        {
+          memcpy(buffer, wcache->buffer, dev->geo.blocksize);
+          ret = 0;
+        }
+      else
+#endif
+        {
+          ret = dhara_map_read(&dev->map,
+                               start_sector,
+                               buffer,
+                               &err);
+        }
+
       if (ret < 0)
         {
           ret = dhara_convert_result(err);
@@ -399,27 +885,54 @@ static ssize_t dhara_write(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  /* Requests at least as large as the write combining cache are streamed
+   * straight to the map.
+   */
+
+  bool bypass = nsectors >= CONFIG_DHARA_WRITE_NCACHES;
+#endif
+
   nxmutex_lock(&dev->lock);
   while (nsectors-- > 0)
     {
-      dhara_error_t err;
-      ret = dhara_map_write(&dev->map,
-                            start_sector,
-                            buffer,
-                            &err);
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+      if (!bypass)
+        {
+          ret = dhara_cache_write(dev, start_sector, buffer);
+        }
+      else
+        {
+          dhara_drop_writecache(dev, start_sector);
+          ret = dhara_write_sector(dev, start_sector, buffer);
+        }
+#else
+      ret = dhara_write_sector(dev, start_sector, buffer);
+#endif
+
       if (ret < 0)
         {
-          ret = dhara_convert_result(err);
-          ferr("Write starting at block %lld failed nwrite %zu err %s\n",
-               (long long)start_sector, nwrite, dhara_strerror(err));
+          ferr("Write starting at block %lld failed nwrite %zu: %d\n",
+               (long long)start_sector, nwrite, ret);
           break;
         }
 
+#ifdef HAVE_DHARA_PROCFS
+      dev->stats.writes++;
+#endif
+
       nwrite++;
       start_sector++;
       buffer += dev->geo.blocksize;
     }
 
+#ifdef CONFIG_DHARA_BGGC
+  /* (Re)start the idle timer of the background flush and GC */
+
+  work_queue(LPWORK, &dev->work, dhara_bggc_worker, dev,
+             MSEC2TICK(CONFIG_DHARA_BGGC_DELAY));
+#endif
+
   nxmutex_unlock(&dev->lock);
   return nwrite ? nwrite : ret;
 }
@@ -472,6 +985,21 @@ static int dhara_ioctl(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+  /* BIOC_FLUSH writes back the write combining cache and syncs the map
+   * before it is passed on to the MTD driver.
+   */
+
+  if (cmd == BIOC_FLUSH)
+    {
+      nxmutex_lock(&dev->lock);
+      ret = dhara_flush(dev);
+      nxmutex_unlock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -482,6 +1010,10 @@ static int dhara_ioctl(FAR struct inode *inode,
     {
       ferr("MTD ioctl(%04x) failed: %d\n", cmd, ret);
     }
+  else if (cmd == BIOC_FLUSH && ret == -ENOTTY)
+    {
+      ret = 0;
+    }
 
   return ret;
 }
@@ -506,16 +1038,167 @@ static int dhara_unlink(FAR struct inode *inode)
 
   if (dev->refs == 0)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_free(dev);
     }
 
   return 0;
 }
 #endif
 
+#ifdef HAVE_DHARA_PROCFS
+/****************************************************************************
+ * Name: dhara_procfs_open
+ ****************************************************************************/
+
+static int dhara_procfs_open(FAR struct file *filep,
+                             FAR const char *relpath,
+                             int oflags, mode_t mode)
+{
+  FAR struct procfs_file_s *attr;
+
+  /* This procfs file is read-only */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  attr = kmm_zalloc(sizeof(struct procfs_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = attr;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: dhara_procfs_close
+ ****************************************************************************/
+
+static int dhara_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: dhara_procfs_read
+ *
+ * Description:
+ *   Report the write amplification and garbage collection counters of
+ *   every dhara device.  Write amplification is the number of programmed
+ *   pages per sector written by the block layer.
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen)
+{
+  FAR dhara_dev_t *dev;
+  struct dhara_stats_s stats;
+  char line[DHARA_LINELEN];
+  size_t linesize;
+  uint32_t amp;
+  off_t offset;
+  ssize_t ret = 0;
+
+  offset = filep->f_pos;
+
+  nxmutex_lock(&g_dhara_devlock);
+  for (dev = g_dhara_devs; dev != NULL; dev = dev->flink)
+    {
+      nxmutex_lock(&dev->lock);
+      stats = dev->stats;
+      nxmutex_unlock(&dev->lock);
+
+      /* Write amplification in hundredths */
+
+      amp = stats.writes > 0 ?
+            (uint32_t)((uint64_t)stats.progs * 100 / stats.writes) : 0;
+
+      linesize = procfs_snprintf(line, DHARA_LINELEN, "%s:\n", dev->name);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, DHARA_LINELEN,
+                                 "  writes:   %" PRIu32 " combined %"
+                                 PRIu32 " mapped %" PRIu32 "\n",
+                                 stats.writes, stats.combined,
+                                 stats.mapwrites);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, DHARA_LINELEN,
+                                 "  nand:     prog %" PRIu32 " erase %"
+                                 PRIu32 "\n", stats.progs, stats.erases);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, DHARA_LINELEN,
+                                 "  writeamp: %" PRIu32 ".%02" PRIu32 "\n",
+                                 amp / 100, amp % 100);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, DHARA_LINELEN,
+                                 "  gc:       steps %" PRIu32 " time %"
+                                 PRIu64 "us max %" PRIu32 "us\n",
+                                 stats.gcsteps, stats.gctime, stats.gcmax);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, DHARA_LINELEN,
+                                 "  maxwrite: %" PRIu32 "us\n",
+                                 stats.writemax);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+    }
+
+  nxmutex_unlock(&g_dhara_devlock);
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dhara_procfs_dup
+ ****************************************************************************/
+
+static int dhara_procfs_dup(FAR const struct file *oldp,
+                            FAR struct file *newp)
+{
+  FAR struct procfs_file_s *attr;
+
+  attr = kmm_malloc(sizeof(struct procfs_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(attr, oldp->f_priv, sizeof(struct procfs_file_s));
+  newp->f_priv = attr;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: dhara_procfs_stat
+ ****************************************************************************/
+
+static int dhara_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return 0;
+}
+#endif /* HAVE_DHARA_PROCFS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -552,6 +1235,10 @@ int dhara_nand_erase(FAR const struct dhara_nand *n,
       return ret;
     }
 
+#ifdef HAVE_DHARA_PROCFS
+  dev->stats.erases++;
+#endif
+
   for (i = 0; i < dev->blkper; i++)
     {
       dhara_discard_readcache(dev, pno + i);
@@ -575,6 +1262,10 @@ int dhara_nand_prog(FAR const struct dhara_nand *n,
       return ret;
     }
 
+#ifdef HAVE_DHARA_PROCFS
+  dev->stats.progs++;
+#endif
+
   dhara_update_readcache(dev, p, data);
   return 0;
 }
@@ -744,6 +1435,14 @@ int dhara_initialize_by_path(FAR const char *path,
       goto err;
     }
 
+#if CONFIG_DHARA_WRITE_NCACHES > 0
+  ret = dhara_init_writecache(dev);
+  if (ret != 0)
+    {
+      goto err;
+    }
+#endif
+
   dhara_map_init(&dev->map, &dev->nand,
                  dev->pagebuf + dev->geo.blocksize,
                  CONFIG_DHARA_GC_RATIO);
@@ -761,13 +1460,19 @@ int dhara_initialize_by_path(FAR const char *path,
       goto err;
     }
 
+#ifdef HAVE_DHARA_PROCFS
+  strlcpy(dev->name, path, sizeof(dev->name));
+
+  nxmutex_lock(&g_dhara_devlock);
+  dev->flink   = g_dhara_devs;
+  g_dhara_devs = dev;
+  nxmutex_unlock(&g_dhara_devlock);
+#endif
+
   return ret;
 
 err:
-  nxmutex_destroy(&dev->lock);
-  dhara_deinit_readcache(dev);
-  kmm_free(dev->pagebuf);
-  kmm_free(dev);
+  dhara_free(dev);
   return ret;
 }
 
@@ -699,6 +699,53 @@ static int ftl_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: ftl_discard
+ *
+ * Description:
+ *   Handle BIOC_DISCARD by erasing the erase blocks that lie completely
+ *   inside the range.  Partial erase blocks at either end are left alone
+ *   since erasing them would need a read-modify-write of the rest.
+ *
+ ****************************************************************************/
+
+static int ftl_discard(FAR struct ftl_struct_s *dev,
+                       FAR const struct blk_discard_s *range)
+{
+  off_t eblock;
+  off_t eend;
+  ssize_t ret;
+
+  if (range == NULL || range->start < 0 || range->nsectors < 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Write back or drop anything buffered for the range first */
+
+#ifdef CONFIG_FTL_WRITEBUFFER
+  rwb_flush(&dev->rwb);
+#endif
+#if defined(FTL_HAVE_RWBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
+  rwb_invalidate(&dev->rwb, range->start, range->nsectors);
+#endif
+
+  eblock = (range->start + dev->blkper - 1) / dev->blkper;
+  eend   = MIN((range->start + range->nsectors) / dev->blkper,
+               (off_t)dev->geo.neraseblocks);
+
+  for (; eblock < eend; eblock++)
+    {
+      ret = ftl_mtd_erase(dev, eblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: ftl_ioctl
  *
@@ -722,6 +769,11 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       rwb_flush(&dev->rwb);
 #endif
     }
+  else if (cmd == BIOC_DISCARD)
+    {
+      return ftl_discard(dev, (FAR const struct blk_discard_s *)
+                              ((uintptr_t)arg));
+    }
 
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
@@ -42,6 +42,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/sfdp.h>
 
 /***************************************************************************
  * Configuration
@@ -143,6 +144,7 @@ struct gd25_dev_s
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to GD25 device */
   bool                  addr_4byte;  /* True: Use Four-byte address */
+  bool                  lastwrite;   /* Write enabled since the last read */
   uint8_t               memory;      /* memory type read from device */
 };
 
@@ -247,6 +249,32 @@ static inline void gd25_unlock(FAR struct spi_dev_s *spi)
   SPI_LOCK(spi, false);
 }
 
+/***************************************************************************
+ * Name: gd25_sfdp
+ *
+ * Description:
+ *   Return the number of 4KiB sectors reported by the SFDP parameters of
+ *   the part, or zero if they cannot be used by this driver.  Called with
+ *   the bus locked and the part released from power-down.
+ *
+ ***************************************************************************/
+
+#ifdef CONFIG_MTD_SFDP
+static uint16_t gd25_sfdp(FAR struct gd25_dev_s *priv)
+{
+  struct sfdp_info_s info;
+
+  if (sfdp_spi_probe(priv->spi, priv->spi_devid, &info) < 0 ||
+      info.erase4k != GD25_SE || info.size < (1 << GD25_SECTOR_SHIFT) ||
+      info.size > ((uint64_t)UINT16_MAX << GD25_SECTOR_SHIFT))
+    {
+      return 0;
+    }
+
+  return info.size >> GD25_SECTOR_SHIFT;
+}
+#endif
+
 /***************************************************************************
  * Name: gd25_readid
  ***************************************************************************/
@@ -314,7 +342,15 @@ static inline int gd25_readid(FAR struct gd25_dev_s *priv)
         }
       else
         {
-          goto out;
+#ifdef CONFIG_MTD_SFDP
+          /* Not in the table: size the part from its SFDP parameters */
+
+          priv->nsectors = gd25_sfdp(priv);
+          if (priv->nsectors == 0)
+#endif
+            {
+              goto out;
+            }
         }
 
       priv->memory = memory;
@@ -463,6 +499,10 @@ static inline void gd25_wren(FAR struct gd25_dev_s *priv)
   SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
   SPI_SEND(priv->spi, GD25_WREN);
   SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+  /* Every program, erase and status write starts here */
+
+  priv->lastwrite = true;
 }
 
 /***************************************************************************
@@ -602,13 +642,22 @@ static void gd25_byteread(FAR struct gd25_dev_s *priv, FAR uint8_t *buffer,
 {
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+  /* Back to back reads skip the status poll and the write disable: no
+   * program or erase can be in progress and the write enable latch is
+   * already clear.
+   */
 
-  gd25_waitwritecomplete(priv);
+  if (priv->lastwrite)
+    {
+      /* Wait for any preceding write or erase operation to complete. */
+
+      gd25_waitwritecomplete(priv);
 
-  /* Make sure that writing is disabled */
+      /* Make sure that writing is disabled */
 
-  gd25_wrdi(priv);
+      gd25_wrdi(priv);
+      priv->lastwrite = false;
+    }
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
 
@@ -1052,6 +1101,12 @@ FAR struct mtd_dev_s *gd25_initialize(FAR struct spi_dev_s *spi,
       priv->spi        = spi;
       priv->spi_devid  = spi_devid;
 
+      /* The part may still be busy with an operation started before
+       * reset.
+       */
+
+      priv->lastwrite = true;
+
       /* Deselect the FLASH */
 
       SPI_SELECT(spi, SPIDEV_FLASH(priv->spi_devid), false);
@@ -65,6 +65,8 @@
 #define GD5F_PAGE_READ            0x13 /* Array read          3   0   0     */
 #define GD5F_READ_FROM_CACHE      0x03 /* Output cache data
                                         *  on SO              2   1   1-2112 */
+#define GD5F_READ_CACHE_SEQ       0x31 /* Cache read next     0   0   0     */
+#define GD5F_READ_CACHE_END       0x3f /* Cache read last     0   0   0     */
 #define GD5F_READ_ID              0x9f /* Read device ID      0   1   2     */
 #define GD5F_ECC_STATUS_READ      0x7c /* Internal ECC status
                                         *  output             0   1   1     */
@@ -182,6 +184,9 @@ static void gd5f_readbuffer(FAR struct gd5f_dev_s *priv,
                             size_t length);
 static bool gd5f_read_page(FAR struct gd5f_dev_s *priv,
                            uint32_t position);
+#ifdef CONFIG_GD5F_CACHEREAD
+static bool gd5f_read_cache(FAR struct gd5f_dev_s *priv, bool last);
+#endif
 
 static void gd5f_write_to_cache(FAR struct gd5f_dev_s *priv,
                                 uint32_t address,
@@ -531,6 +536,42 @@ static bool gd5f_read_page(FAR struct gd5f_dev_s *priv, uint32_t pageaddress)
   return true;
 }
 
+/****************************************************************************
+ * Name: gd5f_read_cache
+ *
+ * Description:
+ *   Move the next page of a cache read sequence into the cache register.
+ *   Unless this is the last page, the device then starts reading the
+ *   following page from the array while the current one is clocked out of
+ *   the cache, so the array read time is hidden behind the SPI transfer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_GD5F_CACHEREAD
+static bool gd5f_read_cache(FAR struct gd5f_dev_s *priv, bool last)
+{
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(priv->spi_devid), true);
+  SPI_SEND(priv->dev, last ? GD5F_READ_CACHE_END : GD5F_READ_CACHE_SEQ);
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(priv->spi_devid), false);
+
+  /* Wait until the cache register holds the page */
+
+  gd5f_waitstatus(priv, GD5F_SR_OIP, false);
+
+  /* Check the internal ECC result of the page now in the cache */
+
+  gd5f_eccstatusread(priv);
+  if ((priv->eccstatus & GD5F_FEATURE_ECC_MASK) == GD5F_FEATURE_ECC_ERROR)
+    {
+      /* ECC report uncorrectable, discard data */
+
+      return false;
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: gd5f_read
  ****************************************************************************/
@@ -543,6 +584,10 @@ static ssize_t gd5f_read(FAR struct mtd_dev_s *dev,
   FAR struct gd5f_dev_s *priv = (FAR struct gd5f_dev_s *)dev;
   size_t bytesleft = nbytes;
   uint32_t position = offset;
+#ifdef CONFIG_GD5F_CACHEREAD
+  uint32_t npages;
+  uint32_t index;
+#endif
 
   finfo("Read: offset: %08lx nbytes: %d\n", (long)offset, (int)nbytes);
 
@@ -554,6 +599,16 @@ static ssize_t gd5f_read(FAR struct mtd_dev_s *dev,
 
   gd5f_waitstatus(priv, GD5F_SR_OIP, false);
 
+#ifdef CONFIG_GD5F_CACHEREAD
+  /* Requests that span several pages are streamed through the cache read
+   * sequence: one array read followed by one cache command per page.
+   */
+
+  npages = nbytes > 0 ? ((position + nbytes - 1) >> priv->pageshift) -
+                        (position >> priv->pageshift) + 1 : 0;
+  index  = 0;
+#endif
+
   while (bytesleft)
     {
       const uint32_t pageaddress =
@@ -563,6 +618,21 @@ static ssize_t gd5f_read(FAR struct mtd_dev_s *dev,
       const size_t chunklength =
                    bytesleft < spaceleft ? bytesleft : spaceleft;
 
+#ifdef CONFIG_GD5F_CACHEREAD
+      if (npages > 1)
+        {
+          if (index == 0 && !gd5f_read_page(priv, pageaddress))
+            {
+              break;
+            }
+
+          if (!gd5f_read_cache(priv, ++index == npages))
+            {
+              break;
+            }
+        }
+      else
+#endif
       if (!gd5f_read_page(priv, pageaddress))
         {
           break;
@@ -575,6 +645,15 @@ static ssize_t gd5f_read(FAR struct mtd_dev_s *dev,
       bytesleft -= chunklength;
     }
 
+#ifdef CONFIG_GD5F_CACHEREAD
+  /* End a cache read sequence that was aborted by an ECC failure */
+
+  if (index > 0 && index < npages)
+    {
+      gd5f_read_cache(priv, true);
+    }
+#endif
+
   gd5f_unlock(priv->dev);
 
   finfo("return nbytes: %d\n", (int)(nbytes - bytesleft));
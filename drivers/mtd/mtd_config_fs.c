@@ -84,10 +84,40 @@
 #define NVS_ALIGN_SIZE                  CONFIG_MTD_WRITE_ALIGN_SIZE
 #define NVS_ALIGN_UP(x)                 (((x) + NVS_ALIGN_SIZE - 1) & ~(NVS_ALIGN_SIZE - 1))
 
+#ifndef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+#  define CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX 0
+#endif
+
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+/* Special index slot addresses.  Block numbers are 16 bit and at most
+ * nblocks - 1, so these never collide with an ate address.
+ */
+
+#  define NVS_INDEX_NONE                0xffffffff /* No ate left for the id */
+#  define NVS_INDEX_CONFLICT            0xfffffffe /* Keys share the id */
+
+/* The index is abandoned (lookups scan the ates) once it is 3/4 full */
+
+#  define NVS_INDEX_LIMIT \
+     (CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX - CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX / 4)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+/* One slot of the in-RAM hash index.  It maps the hash id of a key to the
+ * newest ate written for it, which may be expired if the key was deleted.
+ */
+
+struct nvs_index_s
+{
+  uint32_t id;                         /* Hash id, zero if the slot is free */
+  uint32_t addr;                       /* Ate address or NVS_INDEX_* */
+};
+#endif
+
 /* Non-volatile Storage File system structure */
 
 struct nvs_fs
@@ -102,6 +132,11 @@ struct nvs_fs
   uint32_t              data_wra;      /* Next data write address */
   uint32_t              step_addr;     /* For traverse */
   mutex_t               nvs_lock;
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  FAR struct nvs_index_s *index;       /* Hash index of the newest ates */
+  uint16_t              nindex;        /* Number of used index slots */
+  bool                  index_valid;   /* False: lookups scan the ates */
+#endif
 };
 
 /* Allocation Table Entry */
@@ -869,6 +904,379 @@ static void nvs_block_advance(FAR struct nvs_fs *fs, FAR uint32_t *addr)
     }
 }
 
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+/****************************************************************************
+ * Name: nvs_index_slot
+ *
+ * Description:
+ *   Find the index slot of a hash id using linear probing.  If insert is
+ *   true a free slot is claimed for an id not yet in the index; once the
+ *   index is too full it is invalidated instead.
+ *
+ ****************************************************************************/
+
+static FAR struct nvs_index_s *nvs_index_slot(FAR struct nvs_fs *fs,
+                                              uint32_t id, bool insert)
+{
+  FAR struct nvs_index_s *slot;
+  uint32_t i = id % CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX;
+
+  while (1)
+    {
+      slot = &fs->index[i];
+      if (slot->id == id)
+        {
+          return slot;
+        }
+
+      if (slot->id == 0)
+        {
+          break;
+        }
+
+      if (++i == CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX)
+        {
+          i = 0;
+        }
+    }
+
+  if (!insert)
+    {
+      return NULL;
+    }
+
+  if (fs->nindex >= NVS_INDEX_LIMIT)
+    {
+      fwarn("Index full, falling back to ate scans\n");
+      fs->index_valid = false;
+      return NULL;
+    }
+
+  fs->nindex++;
+  slot->id = id;
+  slot->addr = NVS_INDEX_NONE;
+  return slot;
+}
+
+/****************************************************************************
+ * Name: nvs_index_samekey
+ *
+ * Description:
+ *   Compare the key of the ate at addr1 with the key of ate2 at addr2.
+ *   Returns 0 if equal, 1 if not equal, errcode if error.
+ *
+ ****************************************************************************/
+
+static int nvs_index_samekey(FAR struct nvs_fs *fs, uint32_t addr1,
+                             uint32_t addr2, FAR const struct nvs_ate *ate2)
+{
+  struct nvs_ate ate1;
+  int rc;
+
+  rc = nvs_flash_ate_rd(fs, addr1, &ate1);
+  if (rc)
+    {
+      return rc;
+    }
+
+  if (ate1.key_len != ate2->key_len)
+    {
+      return 1;
+    }
+
+  return nvs_flash_direct_cmp(fs, (addr1 & ADDR_BLOCK_MASK) + ate1.offset,
+                              (addr2 & ADDR_BLOCK_MASK) + ate2->offset,
+                              ate1.key_len);
+}
+
+/****************************************************************************
+ * Name: nvs_index_build
+ *
+ * Description:
+ *   Build the index by walking all ates from newest to oldest.  The first
+ *   ate seen for an id is the newest one of its key; older ates of the
+ *   same id either belong to the same key (and are ignored) or to another
+ *   key, in which case the id is marked as conflicting and lookups of it
+ *   scan the ates.
+ *
+ ****************************************************************************/
+
+static void nvs_index_build(FAR struct nvs_fs *fs)
+{
+  FAR struct nvs_index_s *slot;
+  struct nvs_ate ate;
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  int rc;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  memset(fs->index, 0,
+         CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX * sizeof(struct nvs_index_s));
+  fs->nindex = 0;
+  fs->index_valid = true;
+
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, &ate);
+      if (rc)
+        {
+          break;
+        }
+
+      if (!nvs_ate_valid(fs, &ate) || ate.id == NVS_SPECIAL_ATE_ID)
+        {
+          continue;
+        }
+
+      slot = nvs_index_slot(fs, ate.id, true);
+      if (slot == NULL)
+        {
+          return;
+        }
+
+      if (slot->addr == NVS_INDEX_NONE)
+        {
+          slot->addr = rd_addr;
+        }
+      else if (slot->addr != NVS_INDEX_CONFLICT)
+        {
+          rc = nvs_index_samekey(fs, slot->addr, rd_addr, &ate);
+          if (rc < 0)
+            {
+              break;
+            }
+          else if (rc)
+            {
+              fwarn("hash conflict\n");
+              slot->addr = NVS_INDEX_CONFLICT;
+            }
+        }
+    }
+  while (wlk_addr != fs->ate_wra);
+
+  if (rc < 0)
+    {
+      ferr("Index build failed, rc=%d\n", rc);
+      fs->index_valid = false;
+      return;
+    }
+
+  finfo("Index built, %" PRIu16 " ids\n", fs->nindex);
+}
+
+/****************************************************************************
+ * Name: nvs_index_update
+ *
+ * Description:
+ *   Record that the newest ate of a key is now at addr.  oldaddr is the
+ *   previous ate of the same key, or NVS_INDEX_NONE if there was none; a
+ *   slot pointing anywhere else belongs to another key with the same id.
+ *
+ ****************************************************************************/
+
+static void nvs_index_update(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t oldaddr, uint32_t addr)
+{
+  FAR struct nvs_index_s *slot;
+
+  if (!fs->index_valid)
+    {
+      return;
+    }
+
+  slot = nvs_index_slot(fs, id, true);
+  if (slot == NULL)
+    {
+      return;
+    }
+
+  if (slot->addr == NVS_INDEX_NONE || slot->addr == oldaddr)
+    {
+      slot->addr = addr;
+    }
+  else
+    {
+      slot->addr = NVS_INDEX_CONFLICT;
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_move
+ *
+ * Description:
+ *   Garbage collection copied the ate at oldaddr to addr.
+ *
+ ****************************************************************************/
+
+static void nvs_index_move(FAR struct nvs_fs *fs, uint32_t id,
+                           uint32_t oldaddr, uint32_t addr)
+{
+  FAR struct nvs_index_s *slot;
+
+  if (fs->index_valid)
+    {
+      slot = nvs_index_slot(fs, id, false);
+      if (slot != NULL && slot->addr == oldaddr)
+        {
+          slot->addr = addr;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_erase
+ *
+ * Description:
+ *   Garbage collection erased a block.  Ates still indexed there were
+ *   expired ones that were not copied, so their keys have no ate left.
+ *
+ ****************************************************************************/
+
+static void nvs_index_erase(FAR struct nvs_fs *fs, uint32_t block_addr)
+{
+  FAR struct nvs_index_s *slot;
+  int i;
+
+  if (!fs->index_valid)
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX; i++)
+    {
+      slot = &fs->index[i];
+      if (slot->id != 0 && slot->addr < NVS_INDEX_CONFLICT &&
+          (slot->addr & ADDR_BLOCK_MASK) == (block_addr & ADDR_BLOCK_MASK))
+        {
+          slot->addr = NVS_INDEX_NONE;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_lookup
+ *
+ * Description:
+ *   Look a key up in the index.  Returns 0 with the newest ate of the key
+ *   and its address, -ENOENT if the key has no ate, 1 if the index cannot
+ *   tell and the ates must be scanned, or another errcode on error.
+ *
+ ****************************************************************************/
+
+static int nvs_index_lookup(FAR struct nvs_fs *fs, FAR const uint8_t *key,
+                            size_t key_size, uint32_t hash_id,
+                            FAR struct nvs_ate *ate,
+                            FAR uint32_t *ate_addr)
+{
+  FAR struct nvs_index_s *slot;
+  int rc;
+
+  if (!fs->index_valid)
+    {
+      return 1;
+    }
+
+  slot = nvs_index_slot(fs, hash_id, false);
+  if (slot == NULL || slot->addr == NVS_INDEX_NONE)
+    {
+      return -ENOENT;
+    }
+
+  if (slot->addr == NVS_INDEX_CONFLICT)
+    {
+      return 1;
+    }
+
+  rc = nvs_flash_ate_rd(fs, slot->addr, ate);
+  if (rc)
+    {
+      return rc;
+    }
+
+  if (ate->id != hash_id || !nvs_ate_valid(fs, ate))
+    {
+      fwarn("Stale index slot at 0x%" PRIx32 "\n", slot->addr);
+      return 1;
+    }
+
+  /* A different key with the same id makes the scan necessary */
+
+  if (ate->key_len != key_size ||
+      nvs_flash_block_cmp(fs, (slot->addr & ADDR_BLOCK_MASK) + ate->offset,
+                          key, key_size))
+    {
+      return 1;
+    }
+
+  *ate_addr = slot->addr;
+  return 0;
+}
+#endif /* CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0 */
+
+/****************************************************************************
+ * Name: nvs_find_ate
+ *
+ * Description:
+ *   Find the newest ate of a key, which is expired if the key has been
+ *   deleted.  Returns 0 on success, -ENOENT if the key has no ate, or
+ *   another errcode on error.
+ *
+ ****************************************************************************/
+
+static int nvs_find_ate(FAR struct nvs_fs *fs, FAR const uint8_t *key,
+                        size_t key_size, uint32_t hash_id,
+                        FAR struct nvs_ate *ate, FAR uint32_t *ate_addr)
+{
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  int rc;
+
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  rc = nvs_index_lookup(fs, key, key_size, hash_id, ate, ate_addr);
+  if (rc <= 0)
+    {
+      return rc;
+    }
+#endif
+
+  wlk_addr = fs->ate_wra;
+
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, ate);
+      if (rc)
+        {
+          ferr("Walk to previous ate failed, rc=%d\n", rc);
+          return rc;
+        }
+
+      if ((ate->id == hash_id) && (nvs_ate_valid(fs, ate)))
+        {
+          if ((ate->key_len == key_size)
+              && (!nvs_flash_block_cmp(fs,
+              (rd_addr & ADDR_BLOCK_MASK) + ate->offset, key, key_size)))
+            {
+              *ate_addr = rd_addr;
+              return 0;
+            }
+          else
+            {
+              fwarn("hash conflict\n");
+            }
+        }
+    }
+  while (wlk_addr != fs->ate_wra);
+
+  return -ENOENT;
+}
+
 /****************************************************************************
  * Name: nvs_block_close
  *
@@ -1044,6 +1452,10 @@ static int nvs_gc(FAR struct nvs_fs *fs)
               return rc;
             }
 
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+          nvs_index_move(fs, gc_ate.id, gc_prev_addr, fs->ate_wra);
+#endif
+
           rc = nvs_flash_ate_wrt(fs, &gc_ate);
           if (rc)
             {
@@ -1068,6 +1480,10 @@ gc_done:
       return rc;
     }
 
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  nvs_index_erase(fs, sec_addr);
+#endif
+
   return 0;
 }
 
@@ -1098,6 +1514,10 @@ static int nvs_startup(FAR struct nvs_fs *fs)
   fs->ate_wra = 0;
   fs->data_wra = 0;
 
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  fs->index_valid = false;
+#endif
+
   /* Get the device geometry. (Casting to uintptr_t first eliminates
    * complaints on some architectures where the sizeof long is different
    * from the size of a pointer).
@@ -1436,6 +1856,13 @@ end:
       rc = nvs_add_gc_done_ate(fs);
     }
 
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  if (!rc)
+    {
+      nvs_index_build(fs);
+    }
+#endif
+
   finfo("%" PRIu32 " Eraseblocks of %" PRIu32 " bytes\n",
         fs->nblocks, fs->blocksize);
   finfo("alloc wra: %" PRIu32 ", 0x%" PRIx32 "\n",
@@ -1474,53 +1901,27 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
                 FAR uint32_t *ate_addr)
 {
   int rc;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
   uint32_t hist_addr;
   struct nvs_ate wlk_ate;
   uint32_t hash_id;
 
   hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
-  wlk_addr = fs->ate_wra;
-  rd_addr = wlk_addr;
 
-  do
+  rc = nvs_find_ate(fs, key, key_size, hash_id, &wlk_ate, &rd_addr);
+  if (rc)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          ferr("Walk to previous ate failed, rc=%d\n", rc);
-          return rc;
-        }
+      return rc;
+    }
 
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
-        {
-          if ((wlk_ate.key_len == key_size)
-              && (!nvs_flash_block_cmp(fs,
-              (rd_addr & ADDR_BLOCK_MASK) + wlk_ate.offset, key, key_size)))
-            {
-              /* It is old or deleted, return -ENOENT */
+  /* It is old or deleted, return -ENOENT */
 
-              if (wlk_ate.expired[0] != fs->erasestate)
-                {
-                  return -ENOENT;
-                }
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
-        }
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          return -ENOENT;
-        }
+  if (wlk_ate.expired[0] != fs->erasestate)
+    {
+      return -ENOENT;
     }
-  while (true);
+
+  hist_addr = rd_addr;
 
   if (data && len)
     {
@@ -1567,9 +1968,11 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
   size_t data_size;
   size_t key_size;
   struct nvs_ate wlk_ate;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
   uint32_t hist_addr;
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  uint32_t ate_addr;
+#endif
   uint16_t required_space = 0;
   bool prev_found = false;
   uint32_t hash_id;
@@ -1611,40 +2014,17 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
   hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
 
-  /* Find latest entry with same id. */
-
-  wlk_addr = fs->ate_wra;
+  /* Find latest entry with same key. */
 
-  while (1)
+  rc = nvs_find_ate(fs, key, key_size, hash_id, &wlk_ate, &hist_addr);
+  if (rc == 0)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          return rc;
-        }
-
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
-        {
-          if ((wlk_ate.key_len == key_size)
-              && !nvs_flash_block_cmp(fs,
-                                      (rd_addr & ADDR_BLOCK_MASK) +
-                                      wlk_ate.offset, key, key_size))
-            {
-              prev_found = true;
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
-        }
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          break;
-        }
+      prev_found = true;
+      rd_addr = hist_addr;
+    }
+  else if (rc != -ENOENT)
+    {
+      return rc;
     }
 
   if (prev_found)
@@ -1757,6 +2137,9 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
           finfo("Write entry, ate_wra=0x%" PRIx32 ", "
                 "data_wra=0x%" PRIx32 "\n",
                 fs->ate_wra, fs->data_wra);
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+          ate_addr = fs->ate_wra;
+#endif
           rc = nvs_flash_wrt_entry(fs, hash_id, key, key_size,
                                    pdata->configdata, pdata->len);
           if (rc)
@@ -1765,6 +2148,12 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
               return rc;
             }
 
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+          nvs_index_update(fs, hash_id,
+                           prev_found ? hist_addr : NVS_INDEX_NONE,
+                           ate_addr);
+#endif
+
           finfo("Write entry success\n");
 
           /* Expiring the old ate if exists.
@@ -2019,6 +2408,69 @@ static ssize_t mtdconfig_read(FAR struct file *filep, FAR char *buffer,
   return -ENOTSUP;
 }
 
+/****************************************************************************
+ * Name: nvs_read_bulk
+ *
+ * Description:
+ *   Read several items under one lock.  Items that do not exist get a
+ *   length of zero.  Returns the number of items found.
+ *
+ ****************************************************************************/
+
+static int nvs_read_bulk(FAR struct nvs_fs *fs,
+                         FAR struct config_bulk_s *bulk)
+{
+  size_t found = 0;
+  size_t i;
+  int rc;
+
+  for (i = 0; i < bulk->count; i++)
+    {
+      rc = nvs_read(fs, &bulk->data[i]);
+      if (rc == -ENOENT)
+        {
+          bulk->data[i].len = 0;
+        }
+      else if (rc < 0)
+        {
+          return rc;
+        }
+      else
+        {
+          found++;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: nvs_write_bulk
+ *
+ * Description:
+ *   Write several items in order under one lock, stopping at the first
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int nvs_write_bulk(FAR struct nvs_fs *fs,
+                          FAR struct config_bulk_s *bulk)
+{
+  size_t i;
+  int rc;
+
+  for (i = 0; i < bulk->count; i++)
+    {
+      rc = nvs_write(fs, &bulk->data[i]);
+      if (rc < 0)
+        {
+          return rc;
+        }
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: mtdconfig_ioctl
  ****************************************************************************/
@@ -2074,6 +2526,20 @@ static int mtdconfig_ioctl(FAR struct file *filep, int cmd,
         ret = nvs_next(fs, pdata, false);
         break;
 
+      case CFGDIOC_GETCONFIGS:
+
+        /* Read several nvs items. */
+
+        ret = nvs_read_bulk(fs, (FAR struct config_bulk_s *)arg);
+        break;
+
+      case CFGDIOC_SETCONFIGS:
+
+        /* Write several nvs items. */
+
+        ret = nvs_write_bulk(fs, (FAR struct config_bulk_s *)arg);
+        break;
+
       case MTDIOC_BULKERASE:
 
         /* Call the MTD's ioctl for this. */
@@ -2133,6 +2599,18 @@ int mtdconfig_register_by_path(FAR struct mtd_dev_s *mtd,
   /* Initialize the mtdnvs device structure */
 
   fs->mtd = mtd;
+
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  fs->index = kmm_malloc(CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX *
+                         sizeof(struct nvs_index_s));
+  fs->index_valid = false;
+  if (fs->index == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+#endif
+
   ret = nxmutex_init(&fs->nvs_lock);
   if (ret < 0)
     {
@@ -2160,6 +2638,9 @@ mutex_err:
   nxmutex_destroy(&fs->nvs_lock);
 
 errout:
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  kmm_free(fs->index);
+#endif
   kmm_free(fs);
   return ret;
 }
@@ -2202,6 +2683,9 @@ int mtdconfig_unregister_by_path(FAR const char *path)
   inode = file.f_inode;
   fs = inode->i_private;
   nxmutex_destroy(&fs->nvs_lock);
+#if CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX > 0
+  kmm_free(fs->index);
+#endif
   kmm_free(fs);
   file_close(&file);
   unregister_driver(path);
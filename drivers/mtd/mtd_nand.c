@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 #include <nuttx/mtd/nand_config.h>
 
+#include <sys/param.h>
+
 #include <inttypes.h>
 #include <string.h>
 #include <assert.h>
@@ -71,6 +73,17 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+/* State shared with the per-page callbacks of the cache operations */
+
+struct nand_cachectx_s
+{
+  FAR struct nand_dev_s *nand; /* Upper-half, NAND FLASH interface */
+  off_t block;                 /* Block being read or written */
+  bool fixedecc;               /* A correctable ECC error was found */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -93,6 +106,14 @@ static int      nand_readpage(FAR struct nand_dev_s *nand, off_t block,
                               unsigned int page, FAR uint8_t *data);
 static int      nand_writepage(FAR struct nand_dev_s *nand, off_t block,
                                unsigned int page, FAR const void *data);
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+static int      nand_readcache(FAR struct nand_dev_s *nand, off_t block,
+                               unsigned int page, unsigned int npages,
+                               FAR uint8_t *data);
+static int      nand_writecache(FAR struct nand_dev_s *nand, off_t block,
+                                unsigned int page, unsigned int npages,
+                                FAR const uint8_t *data);
+#endif
 
 /* MTD driver methods */
 
@@ -522,6 +543,161 @@ static int nand_writepage(FAR struct nand_dev_s *nand, off_t block,
     }
 }
 
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+/****************************************************************************
+ * Name: nand_verify_cb and nand_encode_cb
+ *
+ * Description:
+ *   Per-page callbacks of NAND_READCACHE and NAND_WRITECACHE.  They run
+ *   the software ECC on one page while the device is busy with the array
+ *   access of the next (read) or previous (write) page.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_SWECC
+static int nand_verify_cb(FAR void *arg, unsigned int page,
+                          FAR void *data, FAR void *spare)
+{
+  FAR struct nand_cachectx_s *ctx = (FAR struct nand_cachectx_s *)arg;
+  int ret;
+
+  ret = nandecc_verifypage(ctx->nand, ctx->block, page, data, spare);
+  if (ret == -EUCLEAN)
+    {
+      ctx->fixedecc = true;
+      ret = OK;
+    }
+
+  return ret;
+}
+
+static int nand_encode_cb(FAR void *arg, unsigned int page,
+                          FAR void *data, FAR void *spare)
+{
+  FAR struct nand_cachectx_s *ctx = (FAR struct nand_cachectx_s *)arg;
+
+  memset(spare, 0xff, nandmodel_getsparesize(&ctx->nand->raw->model));
+  nandecc_encodepage(ctx->nand, data, spare);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: nand_readcache
+ *
+ * Description:
+ *   Read the data area of several consecutive pages of one block with a
+ *   single ONFI read cache sequence, verifying the software ECC of each
+ *   page while the next one is being fetched.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages reside.
+ *   page   - Number of the first page inside the given block.
+ *   npages - Number of pages to read.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK or -EUCLEAN is returned in success; a negated errno value is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+static int nand_readcache(FAR struct nand_dev_s *nand, off_t block,
+                          unsigned int page, unsigned int npages,
+                          FAR uint8_t *data)
+{
+  struct nand_cachectx_s ctx;
+  nand_pagecb_t callback = NULL;
+  int ret;
+
+  finfo("block=%d page=%d npages=%d data=%p\n",
+        (int)block, page, npages, data);
+
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+  /* Check that the block is not BAD if data is requested */
+
+  if (nand_checkblock(nand, block) != GOODBLOCK)
+    {
+      ferr("ERROR: Block is BAD\n");
+      return -EAGAIN;
+    }
+#endif
+
+  ctx.nand     = nand;
+  ctx.block    = block;
+  ctx.fixedecc = false;
+
+#ifdef CONFIG_MTD_NAND_SWECC
+  if (nand->raw->ecctype == NANDECC_SWECC)
+    {
+      callback = nand_verify_cb;
+    }
+#endif
+
+  ret = NAND_READCACHE(nand->raw, block, page, npages, data, callback,
+                       &ctx);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return ctx.fixedecc ? -EUCLEAN : OK;
+}
+
+/****************************************************************************
+ * Name: nand_writecache
+ *
+ * Description:
+ *   Program the data area of several consecutive pages of one block with a
+ *   single ONFI page cache program sequence, computing the software ECC of
+ *   each page while the previous one is being programmed.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages reside.
+ *   page   - Number of the first page inside the given block.
+ *   npages - Number of pages to write.
+ *   data   - Buffer containing the data areas.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int nand_writecache(FAR struct nand_dev_s *nand, off_t block,
+                           unsigned int page, unsigned int npages,
+                           FAR const uint8_t *data)
+{
+  struct nand_cachectx_s ctx;
+  nand_pagecb_t callback = NULL;
+
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+  /* Check that the block is good */
+
+  if (nand_checkblock(nand, block) != GOODBLOCK)
+    {
+      ferr("ERROR: Block is BAD\n");
+      return -EAGAIN;
+    }
+#endif
+
+  ctx.nand     = nand;
+  ctx.block    = block;
+  ctx.fixedecc = false;
+
+#ifdef CONFIG_MTD_NAND_SWECC
+  if (nand->raw->ecctype == NANDECC_SWECC)
+    {
+      callback = nand_encode_cb;
+    }
+#endif
+
+  return NAND_WRITECACHE(nand->raw, block, page, npages, data, callback,
+                         &ctx);
+}
+#endif /* CONFIG_MTD_NAND_CACHEOPS */
+
 /****************************************************************************
  * Name: nand_erase
  *
@@ -579,6 +755,7 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
   bool fixedecc = false;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -612,7 +789,7 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
 
   /* Then read every page from NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to read beyond the end of NAND */
 
@@ -625,9 +802,27 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Read the next page from NAND */
+      count = 1;
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+      /* Stream all of the remaining pages in this block through the read
+       * cache if the device supports it.
+       */
+
+      if (raw->readcache != NULL && raw->ecctype < NANDECC_HWECC &&
+          remaining > 1 && page + 1 < pagesperblock)
+        {
+          count = MIN(remaining, pagesperblock - page);
+          ret   = nand_readcache(nand, block, page, count, buffer);
+        }
+      else
+#endif
+        {
+          /* Read the next page from NAND */
+
+          ret = nand_readpage(nand, block, page, buffer);
+        }
 
-      ret = nand_readpage(nand, block, page, buffer);
       if (ret == -EUCLEAN)
         {
           fixedecc = true;
@@ -644,15 +839,16 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += count;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += (size_t)count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
@@ -679,6 +875,7 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -712,7 +909,7 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
 
   /* Then write every page into NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to write beyond the end of NAND */
 
@@ -725,9 +922,27 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Write the next page into NAND */
+      count = 1;
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+      /* Program all of the remaining pages in this block through the page
+       * cache if the device supports it.
+       */
+
+      if (raw->writecache != NULL && raw->ecctype < NANDECC_HWECC &&
+          remaining > 1 && page + 1 < pagesperblock)
+        {
+          count = MIN(remaining, pagesperblock - page);
+          ret   = nand_writecache(nand, block, page, count, buffer);
+        }
+      else
+#endif
+        {
+          /* Write the next page into NAND */
+
+          ret = nand_writepage(nand, block, page, buffer);
+        }
 
-      ret = nand_writepage(nand, block, page, buffer);
       if (ret < 0)
         {
           ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
@@ -740,15 +955,16 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += count;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += (size_t)count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
@@ -997,6 +1213,13 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
           ferr("ERROR: Could not determine NAND model\n");
           return NULL;
         }
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+      /* Without the ONFI parameter page the cache commands are unknown */
+
+      raw->readcache  = NULL;
+      raw->writecache = NULL;
+#endif
     }
   else
     {
@@ -1049,6 +1272,20 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
 
       onfi_embeddedecc(&onfi, raw->cmdaddr, raw->addraddr, raw->dataaddr,
                                                            true);
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+      /* Only keep the cache operations that the device reports */
+
+      if ((onfi.optcmds & ONFI_OPTCMD_CACHEREAD) == 0)
+        {
+          raw->readcache = NULL;
+        }
+
+      if ((onfi.optcmds & ONFI_OPTCMD_CACHEPROGRAM) == 0)
+        {
+          raw->writecache = NULL;
+        }
+#endif
     }
 
   return nand_raw_initialize(raw);
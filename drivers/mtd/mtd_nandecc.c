@@ -85,8 +85,6 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
 {
   FAR struct nand_raw_s *raw;
   FAR struct nand_model_s *model;
-  FAR const struct nand_scheme_s *scheme;
-  unsigned int pagesize;
   unsigned int sparesize;
   int ret;
 
@@ -101,7 +99,6 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
 
   /* Get size parameters */
 
-  pagesize  = nandmodel_getpagesize(model);
   sparesize = nandmodel_getsparesize(model);
 
   /* Store code in spare buffer, either the buffer provided by the caller or
@@ -132,6 +129,47 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
       return ret;
     }
 
+  /* Use the ECC information in the spare to verify the page */
+
+  return nandecc_verifypage(nand, block, page, data, spare);
+}
+
+/****************************************************************************
+ * Name: nandecc_verifypage
+ *
+ * Description:
+ *   Verify (and, if possible, correct) the data area of a page that has
+ *   already been transferred from the NAND FLASH using the ECC information
+ *   held in its spare area.  This is the second half of nandecc_readpage()
+ *   and lets a lower half that streams several pages (see NAND_READCACHE)
+ *   verify one page while the device is still fetching the next one.
+ *
+ * Input Parameters:
+ *   nand  - Upper-half, NAND FLASH interface
+ *   block - Number of the block where the page resides.
+ *   page  - Number of the page inside the given block.
+ *   data  - Buffer holding the data area of the page.
+ *   spare - Buffer holding the spare area of the page.
+ *
+ * Returned Value:
+ *   OK if the data is valid, -EUCLEAN if a single bit error was corrected
+ *   and -EBADMSG if the data could not be recovered.
+ *
+ ****************************************************************************/
+
+int nandecc_verifypage(FAR struct nand_dev_s *nand, off_t block,
+                       unsigned int page, FAR void *data,
+                       FAR const void *spare)
+{
+  FAR struct nand_raw_s *raw;
+  FAR struct nand_model_s *model;
+  FAR const struct nand_scheme_s *scheme;
+  int ret;
+
+  DEBUGASSERT(nand && nand->raw && data && spare);
+  raw   = nand->raw;
+  model = &raw->model;
+
   /* Retrieve ECC information from page */
 
   scheme = nandmodel_getscheme(model);
@@ -139,7 +177,7 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
 
   /* Use the ECC data to verify the page */
 
-  ret = hamming_verify256x(data, pagesize, raw->ecc);
+  ret = hamming_verify256x(data, nandmodel_getpagesize(model), raw->ecc);
   switch (ret)
     {
       case HAMMING_SUCCESS:
@@ -183,9 +221,6 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 {
   FAR struct nand_raw_s *raw;
   FAR struct nand_model_s *model;
-  FAR const struct nand_scheme_s *scheme;
-  unsigned int pagesize;
-  unsigned int sparesize;
   int ret;
 
   finfo("block=%" PRIdOFF " page=%d data=%p spare=%p\n",
@@ -197,24 +232,6 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
   raw   = nand->raw;
   model = &raw->model;
 
-  /* Get size parameters */
-
-  pagesize  = nandmodel_getpagesize(model);
-  sparesize = nandmodel_getsparesize(model);
-
-  /* Set hamming code set to 0xffff.. to keep existing bytes */
-
-  memset(raw->ecc, 0xff, CONFIG_MTD_NAND_MAXSPAREECCBYTES);
-
-  /* Compute ECC on the new data, if provided */
-
-  if (data)
-    {
-      /* Compute hamming code on data */
-
-      hamming_compute256x(data, pagesize, raw->ecc);
-    }
-
   /* Store code in spare buffer, either the buffer provided by the caller or
    * the scratch buffer in the raw NAND structure.
    */
@@ -222,13 +239,12 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
   if (!spare)
     {
       spare = raw->spare;
-      memset(spare, 0xff, sparesize);
+      memset(spare, 0xff, nandmodel_getsparesize(model));
     }
 
-  /* Write the ECC */
+  /* Compute the ECC and write it into the spare */
 
-  scheme = nandmodel_getscheme(model);
-  nandscheme_writeecc(scheme, spare, raw->ecc);
+  nandecc_encodepage(nand, data, spare);
 
   /* Perform page write operation */
 
@@ -240,3 +256,52 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: nandecc_encodepage
+ *
+ * Description:
+ *   Calculate the ECC for the data area of a page and store it in the
+ *   provided spare buffer.  This is the first half of nandecc_writepage()
+ *   and lets a lower half that programs several pages back-to-back (see
+ *   NAND_WRITECACHE) encode the next page while the device is still
+ *   programming the previous one.
+ *
+ * Input Parameters:
+ *   nand  - Upper-half, NAND FLASH interface
+ *   data  - Buffer containing the data to be written or NULL to leave the
+ *           existing ECC bytes erased.
+ *   spare - Buffer receiving the ECC bytes.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nandecc_encodepage(FAR struct nand_dev_s *nand, FAR const void *data,
+                        FAR void *spare)
+{
+  FAR struct nand_raw_s *raw;
+  FAR struct nand_model_s *model;
+
+  DEBUGASSERT(nand && nand->raw && spare);
+  raw   = nand->raw;
+  model = &raw->model;
+
+  /* Set hamming code set to 0xffff.. to keep existing bytes */
+
+  memset(raw->ecc, 0xff, CONFIG_MTD_NAND_MAXSPAREECCBYTES);
+
+  /* Compute ECC on the new data, if provided */
+
+  if (data)
+    {
+      /* Compute hamming code on data */
+
+      hamming_compute256x(data, nandmodel_getpagesize(model), raw->ecc);
+    }
+
+  /* Write the ECC */
+
+  nandscheme_writeecc(nandmodel_getscheme(model), spare, raw->ecc);
+}
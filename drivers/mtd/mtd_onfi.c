@@ -340,6 +340,15 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->model = *(FAR uint8_t *)(parmtab + 49);
 
+  /* Features and optional commands supported (bytes 6-9) */
+
+  onfi->features = (uint16_t)parmtab[6] | ((uint16_t)parmtab[7] << 8);
+  onfi->optcmds  = (uint16_t)parmtab[8] | ((uint16_t)parmtab[9] << 8);
+
+  /* Number of plane address bits (multi-plane addressing, byte 114) */
+
+  onfi->planebits = parmtab[114] & 0x0f;
+
   finfo("Returning:\n");
   finfo("  manufacturer:  0x%02x\n",      onfi->manufacturer);
   finfo("  buswidth:      %d\n",          onfi->buswidth);
@@ -350,6 +359,9 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
   finfo("  pagesperblock: %d\n",          onfi->pagesperblock);
   finfo("  blocksperlun:  %d\n",          onfi->blocksperlun);
   finfo("  pagesize:      %" PRId32 "\n", onfi->pagesize);
+  finfo("  features:      0x%04x\n",      onfi->features);
+  finfo("  optcmds:       0x%04x\n",      onfi->optcmds);
+  finfo("  planebits:     %d\n",          onfi->planebits);
   return OK;
 }
 
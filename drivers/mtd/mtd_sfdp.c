@@ -0,0 +1,464 @@
+/****************************************************************************
+ * drivers/mtd/mtd_sfdp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mtd/sfdp.h>
+#include <nuttx/spi/spi.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SFDP header */
+
+#define SFDP_SIGNATURE       0x50444653  /* "SFDP" */
+#define SFDP_HEADER_SIZE     8
+#define SFDP_PHEADER_SIZE    8
+
+/* Parameter ID of the Basic Flash Parameter Table */
+
+#define SFDP_BFPT_ID         0xff00
+
+/* Number of BFPT DWORDs decoded.  JESD216 defines 9, JESD216A 16 and
+ * JESD216C 20.
+ */
+
+#define SFDP_BFPT_MINDWORDS  9
+#define SFDP_BFPT_NDWORDS    20
+
+/* BFPT DWORD 1 */
+
+#define BFPT1_ERASE4K_MASK   (3 << 0)
+#define BFPT1_ERASE4K        (1 << 0)
+#define BFPT1_ERASE4K_SHIFT  8
+#define BFPT1_READ_1_1_2     (1 << 16)
+#define BFPT1_ADDR_SHIFT     17
+#define BFPT1_ADDR_MASK      (3 << BFPT1_ADDR_SHIFT)
+#define BFPT1_DTR            (1 << 19)
+#define BFPT1_READ_1_2_2     (1 << 20)
+#define BFPT1_READ_1_4_4     (1 << 21)
+#define BFPT1_READ_1_1_4     (1 << 22)
+
+/* BFPT DWORD 2 */
+
+#define BFPT2_DENSITY_POW2   (1u << 31)
+
+/* BFPT DWORD 5 */
+
+#define BFPT5_READ_2_2_2     (1 << 0)
+#define BFPT5_READ_4_4_4     (1 << 4)
+
+/* BFPT DWORD 11 and 15 */
+
+#define BFPT11_PAGE_SHIFT    4
+#define BFPT11_PAGE_MASK     (15 << BFPT11_PAGE_SHIFT)
+#define BFPT15_QER_SHIFT     20
+#define BFPT15_QER_MASK      (7 << BFPT15_QER_SHIFT)
+
+/* Fast read parameter fields, 16 bits each */
+
+#define READ_DUMMIES(f)      ((f) & 0x1f)
+#define READ_MODECLKS(f)     (((f) >> 5) & 0x7)
+#define READ_OPCODE(f)       (((f) >> 8) & 0xff)
+
+/* Legacy fast read (0Bh), implied by every SFDP device */
+
+#define SFDP_FAST_READ       0x0b
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI
+struct sfdp_spi_s
+{
+  FAR struct spi_dev_s *spi;
+  uint32_t devid;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Read modes in order of preference.  2-2-2 and 4-4-4 are left out since
+ * they require the device to be switched to DPI/QPI mode first.
+ */
+
+static const uint8_t g_sfdp_readorder[] =
+{
+  SFDP_READ_1_8_8,
+  SFDP_READ_1_1_8,
+  SFDP_READ_1_4_4,
+  SFDP_READ_1_1_4,
+  SFDP_READ_1_2_2,
+  SFDP_READ_1_1_2,
+  SFDP_READ_1_1_1
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t sfdp_getle32(FAR const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/****************************************************************************
+ * Name: sfdp_setread
+ *
+ * Description:
+ *   Record one fast read mode from a 16 bit BFPT field.  A zero opcode
+ *   means that the mode is not supported after all.
+ *
+ ****************************************************************************/
+
+static void sfdp_setread(FAR struct sfdp_info_s *info, int mode,
+                         uint16_t field)
+{
+  FAR struct sfdp_readop_s *op = &info->read[mode];
+
+  op->opcode   = READ_OPCODE(field);
+  op->modeclks = READ_MODECLKS(field);
+  op->dummies  = READ_DUMMIES(field);
+
+  if (op->opcode != 0)
+    {
+      info->readmodes |= SFDP_READ_MODE(mode);
+    }
+}
+
+static void sfdp_seterase(FAR struct sfdp_erase_s *erase, uint16_t field)
+{
+  uint8_t shift = field & 0xff;
+
+  if (shift != 0 && shift < 32)
+    {
+      erase->size   = 1u << shift;
+      erase->opcode = field >> 8;
+    }
+}
+
+/****************************************************************************
+ * Name: sfdp_parse_bfpt
+ ****************************************************************************/
+
+static int sfdp_parse_bfpt(FAR struct sfdp_info_s *info,
+                           FAR const uint32_t *dw, int ndwords)
+{
+  uint32_t density;
+
+  /* DWORD 1: 4KiB erase, address bytes and the 1-x-y read modes */
+
+  if ((dw[0] & BFPT1_ERASE4K_MASK) == BFPT1_ERASE4K)
+    {
+      info->erase4k = (dw[0] >> BFPT1_ERASE4K_SHIFT) & 0xff;
+    }
+
+  info->addrmode = (dw[0] & BFPT1_ADDR_MASK) >> BFPT1_ADDR_SHIFT;
+  info->dtr      = (dw[0] & BFPT1_DTR) != 0;
+
+  /* DWORD 2: density in bits */
+
+  density = dw[1];
+  if ((density & BFPT2_DENSITY_POW2) != 0)
+    {
+      density &= ~BFPT2_DENSITY_POW2;
+      if (density < 3 || density > 63)
+        {
+          ferr("ERROR: Bad SFDP density 2^%" PRIu32 "\n", density);
+          return -EINVAL;
+        }
+
+      info->size = (uint64_t)1 << (density - 3);
+    }
+  else
+    {
+      info->size = ((uint64_t)density + 1) >> 3;
+    }
+
+  /* DWORDs 3 to 7: fast read instructions */
+
+  info->read[SFDP_READ_1_1_1].opcode  = SFDP_FAST_READ;
+  info->read[SFDP_READ_1_1_1].dummies = SFDP_DUMMY_CLOCKS;
+  info->readmodes = SFDP_READ_MODE(SFDP_READ_1_1_1);
+
+  if ((dw[0] & BFPT1_READ_1_4_4) != 0)
+    {
+      sfdp_setread(info, SFDP_READ_1_4_4, dw[2] & 0xffff);
+    }
+
+  if ((dw[0] & BFPT1_READ_1_1_4) != 0)
+    {
+      sfdp_setread(info, SFDP_READ_1_1_4, dw[2] >> 16);
+    }
+
+  if ((dw[0] & BFPT1_READ_1_1_2) != 0)
+    {
+      sfdp_setread(info, SFDP_READ_1_1_2, dw[3] & 0xffff);
+    }
+
+  if ((dw[0] & BFPT1_READ_1_2_2) != 0)
+    {
+      sfdp_setread(info, SFDP_READ_1_2_2, dw[3] >> 16);
+    }
+
+  if ((dw[4] & BFPT5_READ_2_2_2) != 0)
+    {
+      sfdp_setread(info, SFDP_READ_2_2_2, dw[5] >> 16);
+    }
+
+  if ((dw[4] & BFPT5_READ_4_4_4) != 0)
+    {
+      sfdp_setread(info, SFDP_READ_4_4_4, dw[6] >> 16);
+    }
+
+  /* DWORDs 8 and 9: erase types */
+
+  sfdp_seterase(&info->erase[0], dw[7] & 0xffff);
+  sfdp_seterase(&info->erase[1], dw[7] >> 16);
+  sfdp_seterase(&info->erase[2], dw[8] & 0xffff);
+  sfdp_seterase(&info->erase[3], dw[8] >> 16);
+
+  /* JESD216A and later: page size and quad enable requirements */
+
+  info->pagesize = 256;
+  if (ndwords >= 11 && (dw[10] & BFPT11_PAGE_MASK) != 0)
+    {
+      info->pagesize = 1u << ((dw[10] & BFPT11_PAGE_MASK) >>
+                              BFPT11_PAGE_SHIFT);
+    }
+
+  if (ndwords >= 15)
+    {
+      info->qer = (dw[14] & BFPT15_QER_MASK) >> BFPT15_QER_SHIFT;
+    }
+
+  /* JESD216C and later: octal reads */
+
+  if (ndwords >= 17)
+    {
+      sfdp_setread(info, SFDP_READ_1_1_8, dw[16] & 0xffff);
+      sfdp_setread(info, SFDP_READ_1_8_8, dw[16] >> 16);
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_SPI
+static int sfdp_spi_read(FAR void *arg, uint32_t addr,
+                         FAR void *buffer, size_t nbytes)
+{
+  FAR struct sfdp_spi_s *priv = arg;
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->devid), true);
+
+  SPI_SEND(priv->spi, SFDP_CMD_READ);
+  SPI_SEND(priv->spi, (addr >> 16) & 0xff);
+  SPI_SEND(priv->spi, (addr >> 8) & 0xff);
+  SPI_SEND(priv->spi, addr & 0xff);
+  SPI_SEND(priv->spi, 0xff);
+
+  SPI_RECVBLOCK(priv->spi, buffer, nbytes);
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->devid), false);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sfdp_probe
+ *
+ * Description:
+ *   Read the SFDP header of a serial flash and decode its Basic Flash
+ *   Parameter Table.
+ *
+ ****************************************************************************/
+
+int sfdp_probe(sfdp_read_t read, FAR void *arg,
+               FAR struct sfdp_info_s *info)
+{
+  uint8_t header[SFDP_HEADER_SIZE];
+  uint8_t pheader[SFDP_PHEADER_SIZE];
+  uint8_t bfpt[SFDP_BFPT_NDWORDS * 4];
+  uint32_t dw[SFDP_BFPT_NDWORDS];
+  uint32_t ptp;
+  int ndwords;
+  int nph;
+  int ret;
+  int i;
+
+  memset(info, 0, sizeof(*info));
+
+  ret = read(arg, 0, header, sizeof(header));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (sfdp_getle32(header) != SFDP_SIGNATURE)
+    {
+      finfo("No SFDP signature\n");
+      return -ENODEV;
+    }
+
+  /* Look for the BFPT among the parameter headers.  JESD216 requires it
+   * to be the first one, but do not rely on that.
+   */
+
+  nph = header[6] + 1;
+  for (i = 0; i < nph; i++)
+    {
+      ret = read(arg, SFDP_HEADER_SIZE + i * SFDP_PHEADER_SIZE,
+                 pheader, sizeof(pheader));
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if ((pheader[0] | (pheader[7] << 8)) == SFDP_BFPT_ID)
+        {
+          break;
+        }
+    }
+
+  if (i >= nph)
+    {
+      ferr("ERROR: No SFDP basic flash parameter table\n");
+      return -ENODEV;
+    }
+
+  info->minor = pheader[1];
+  info->major = pheader[2];
+
+  ndwords = pheader[3];
+  if (ndwords < SFDP_BFPT_MINDWORDS)
+    {
+      ferr("ERROR: SFDP BFPT too short: %d\n", ndwords);
+      return -EINVAL;
+    }
+
+  if (ndwords > SFDP_BFPT_NDWORDS)
+    {
+      ndwords = SFDP_BFPT_NDWORDS;
+    }
+
+  ptp = (sfdp_getle32(&pheader[4]) & 0xffffff);
+  memset(bfpt, 0, sizeof(bfpt));
+  ret = read(arg, ptp, bfpt, ndwords * 4);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < SFDP_BFPT_NDWORDS; i++)
+    {
+      dw[i] = sfdp_getle32(&bfpt[i * 4]);
+    }
+
+  ret = sfdp_parse_bfpt(info, dw, ndwords);
+  if (ret >= 0)
+    {
+      finfo("SFDP %d.%d size %" PRIu64 " page %" PRIu32 " reads %04x\n",
+            info->major, info->minor, info->size, info->pagesize,
+            info->readmodes);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sfdp_select_read
+ *
+ * Description:
+ *   Pick the widest read mode that both the device and the controller
+ *   support.
+ *
+ ****************************************************************************/
+
+int sfdp_select_read(FAR const struct sfdp_info_s *info, uint16_t modes,
+                     FAR struct sfdp_readop_s *op)
+{
+  int mode = SFDP_READ_1_1_1;
+  int i;
+
+  modes &= info->readmodes;
+  for (i = 0; i < nitems(g_sfdp_readorder); i++)
+    {
+      if ((modes & SFDP_READ_MODE(g_sfdp_readorder[i])) != 0)
+        {
+          mode = g_sfdp_readorder[i];
+          break;
+        }
+    }
+
+  if (mode == SFDP_READ_1_1_1)
+    {
+      op->opcode   = SFDP_FAST_READ;
+      op->modeclks = 0;
+      op->dummies  = SFDP_DUMMY_CLOCKS;
+    }
+  else
+    {
+      *op = info->read[mode];
+    }
+
+  return mode;
+}
+
+/****************************************************************************
+ * Name: sfdp_spi_probe
+ *
+ * Description:
+ *   sfdp_probe() for flash attached to a single line SPI bus.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI
+int sfdp_spi_probe(FAR struct spi_dev_s *spi, uint32_t devid,
+                   FAR struct sfdp_info_s *info)
+{
+  struct sfdp_spi_s priv;
+
+  priv.spi   = spi;
+  priv.devid = devid;
+
+  return sfdp_probe(sfdp_spi_read, &priv, info);
+}
+#endif
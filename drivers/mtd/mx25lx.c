@@ -235,6 +235,7 @@ struct mx25l_dev_s
   uint8_t               pageshift;
   uint8_t               addressbytes; /* Number of address bytes required */
   uint16_t              nsectors;
+  bool                  lastwrite;   /* Write enabled since the last read */
 #if defined(CONFIG_MX25L_SECTOR512)
   uint8_t               flags;       /* Buffered sector flags */
   uint16_t              esectno;     /* Erase sector number in the cache */
@@ -489,6 +490,10 @@ static void mx25l_writeenable(FAR struct mx25l_dev_s *priv)
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
 
+  /* Every program, erase and status write starts here */
+
+  priv->lastwrite = true;
+
   mxlinfo("Enabled\n");
 }
 
@@ -614,13 +619,22 @@ static void mx25l_byteread(FAR struct mx25l_dev_s *priv, FAR uint8_t *buffer,
 {
   mxlinfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+  /* Back to back reads skip the status poll and the write disable: no
+   * program or erase can be in progress and the write enable latch is
+   * already clear.
+   */
 
-  mx25l_waitwritecomplete(priv);
+  if (priv->lastwrite)
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  /* Make sure that writing is disabled */
+      mx25l_waitwritecomplete(priv);
+
+      /* Make sure that writing is disabled */
 
-  mx25l_writedisable(priv);
+      mx25l_writedisable(priv);
+      priv->lastwrite = false;
+    }
 
   /* Select this FLASH part */
 
@@ -1178,6 +1192,12 @@ FAR struct mtd_dev_s *mx25l_initialize_spi(FAR struct spi_dev_s *dev)
       priv->mtd.name   = "mx25l";
       priv->dev        = dev;
 
+      /* The part may still be busy with an operation started before
+       * reset.
+       */
+
+      priv->lastwrite = true;
+
       /* Deselect the FLASH */
 
       SPI_SELECT(dev, SPIDEV_FLASH(0), false);
@@ -109,6 +109,8 @@
                                             * on SI and SO         2  1  1-2112 */
 #define MX35_READ_FROM_CACHE_X4     0x6B   /* Output cache data
                                             * on SI, SO, WP, HOLD  2  1  1-2112 */
+#define MX35_READ_CACHE_SEQ         0x31   /* Cache read next      0  0  0      */
+#define MX35_READ_CACHE_END         0x3F   /* Cache read last      0  0  0      */
 #define MX35_READ_ID                0x9F   /* Read device ID       0  1  2      */
 #define MX35_ECC_STATUS_READ        0x7C   /* Internal ECC status
                                             * output               0  1  1      */
@@ -221,6 +223,9 @@ static void mx35_readbuffer(FAR struct mx35_dev_s *priv,
                             uint8_t *buffer, size_t length);
 static bool mx35_read_page(FAR struct mx35_dev_s *priv,
                            uint32_t position);
+#ifdef CONFIG_MX35_CACHEREAD
+static bool mx35_read_cache(FAR struct mx35_dev_s *priv, bool last);
+#endif
 static ssize_t mx35_read(FAR struct mtd_dev_s *dev,
                          off_t offset,
                          size_t nbytes,
@@ -617,6 +622,41 @@ static bool mx35_read_page(FAR struct mx35_dev_s *priv, uint32_t pageaddress)
   return true;
 }
 
+/****************************************************************************
+ * Name: mx35_read_cache
+ *
+ * Description:
+ *   Move the next page of a cache read sequence into the cache register.
+ *   Unless this is the last page, the device then starts reading the
+ *   following page from the array while the current one is clocked out of
+ *   the cache, so the array read time is hidden behind the SPI transfer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MX35_CACHEREAD
+static bool mx35_read_cache(FAR struct mx35_dev_s *priv, bool last)
+{
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->dev, last ? MX35_READ_CACHE_END : MX35_READ_CACHE_SEQ);
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+
+  /* Wait until the cache register holds the page */
+
+  mx35_waitstatus(priv, MX35_SR_OIP, false);
+
+  /* Check the internal ECC result of the page now in the cache */
+
+  mx35_eccstatusread(priv);
+  if ((priv->eccstatus & MX35_FEATURE_ECC_MASK) ==
+       MX35_FEATURE_ECC_INCORRECTABLE)
+    {
+      return false;
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: mx35_read
  ****************************************************************************/
@@ -629,6 +669,10 @@ static ssize_t mx35_read(FAR struct mtd_dev_s *dev,
   FAR struct mx35_dev_s *priv = (FAR struct mx35_dev_s *)dev;
   size_t bytesleft = nbytes;
   uint32_t position = offset;
+#ifdef CONFIG_MX35_CACHEREAD
+  uint32_t npages;
+  uint32_t index;
+#endif
 
   mx35info("offset: %08lx nbytes: %d\n", (long)offset, (int)nbytes);
 
@@ -640,6 +684,16 @@ static ssize_t mx35_read(FAR struct mtd_dev_s *dev,
 
   mx35_waitstatus(priv, MX35_SR_OIP, false);
 
+#ifdef CONFIG_MX35_CACHEREAD
+  /* Requests that span several pages are streamed through the cache read
+   * sequence: one array read followed by one cache command per page.
+   */
+
+  npages = nbytes > 0 ? ((position + nbytes - 1) >> priv->pageshift) -
+                        (position >> priv->pageshift) + 1 : 0;
+  index  = 0;
+#endif
+
   while (bytesleft)
     {
       const uint32_t pageaddress = (position >> priv->pageshift) <<
@@ -649,6 +703,21 @@ static ssize_t mx35_read(FAR struct mtd_dev_s *dev,
       const size_t chunklength = bytesleft < spaceleft ?
                                  bytesleft : spaceleft;
 
+#ifdef CONFIG_MX35_CACHEREAD
+      if (npages > 1)
+        {
+          if (index == 0 && !mx35_read_page(priv, pageaddress))
+            {
+              break;
+            }
+
+          if (!mx35_read_cache(priv, ++index == npages))
+            {
+              break;
+            }
+        }
+      else
+#endif
       if (!mx35_read_page(priv, pageaddress))
         {
           break;
@@ -661,6 +730,15 @@ static ssize_t mx35_read(FAR struct mtd_dev_s *dev,
       bytesleft -= chunklength;
     }
 
+#ifdef CONFIG_MX35_CACHEREAD
+  /* End a cache read sequence that was aborted by an ECC failure */
+
+  if (index > 0 && index < npages)
+    {
+      mx35_read_cache(priv, true);
+    }
+#endif
+
   mx35_unlock(priv->dev);
 
   mx35info("return nbytes: %d\n", (int)(nbytes - bytesleft));
@@ -46,6 +46,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/sfdp.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -241,6 +242,7 @@ struct w25_dev_s
   FAR struct spi_dev_s *spi;         /* Saved SPI interface instance */
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to W25 device */
+  bool                  lastwrite;   /* Write enabled since the last read */
 
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
   uint8_t               flags;       /* Buffered sector flags */
@@ -258,6 +260,9 @@ struct w25_dev_s
 static void w25_lock(FAR struct spi_dev_s *spi);
 static inline void w25_unlock(FAR struct spi_dev_s *spi);
 static inline int w25_readid(FAR struct w25_dev_s *priv);
+#ifdef CONFIG_MTD_SFDP
+static uint16_t w25_sfdp(FAR struct w25_dev_s *priv);
+#endif
 #ifndef CONFIG_W25_READONLY
 static void w25_unprotect(FAR struct w25_dev_s *priv);
 #endif
@@ -479,6 +484,16 @@ static inline int w25_readid(struct w25_dev_s *priv)
         }
       else
         {
+#ifdef CONFIG_MTD_SFDP
+          /* Not in the table: size the part from its SFDP parameters */
+
+          priv->nsectors = w25_sfdp(priv);
+          if (priv->nsectors > 0)
+            {
+              return OK;
+            }
+#endif
+
           /* Nope.. we don't understand this capacity. */
 
           w25_ferr("ERROR: Unsupported capacity: %02x\n", capacity);
@@ -495,6 +510,38 @@ static inline int w25_readid(struct w25_dev_s *priv)
   return -ENODEV;
 }
 
+/****************************************************************************
+ * Name: w25_sfdp
+ *
+ * Description:
+ *   Return the number of 4KiB sectors reported by the SFDP parameters of
+ *   the part, or zero if they cannot be used by this driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SFDP
+static uint16_t w25_sfdp(FAR struct w25_dev_s *priv)
+{
+  struct sfdp_info_s info;
+  int ret;
+
+  w25_lock(priv->spi);
+  ret = sfdp_spi_probe(priv->spi, 0, &info);
+  w25_unlock(priv->spi);
+
+  /* Only 4KiB sector erase and 3 byte addresses are supported */
+
+  if (ret < 0 || info.erase4k != W25_SE ||
+      info.size < (1 << W25_SECTOR_SHIFT) ||
+      info.size > ((uint64_t)NSECTORS_128MBIT << W25_SECTOR_SHIFT))
+    {
+      return 0;
+    }
+
+  return info.size >> W25_SECTOR_SHIFT;
+}
+#endif
+
 /****************************************************************************
  * Name: w25_unprotect
  ****************************************************************************/
@@ -605,6 +652,10 @@ static inline void w25_wren(struct w25_dev_s *priv)
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* Every program, erase and status write starts here */
+
+  priv->lastwrite = true;
 }
 
 /****************************************************************************
@@ -767,14 +818,24 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
 
   w25_finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+  /* Back to back reads skip the status poll and the write disable: no
+   * program or erase can be in progress and the write enable latch is
+   * already clear.
+   */
 
-  status = w25_waitwritecomplete(priv);
-  DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+  if (priv->lastwrite)
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  /* Make sure that writing is disabled */
+      status = w25_waitwritecomplete(priv);
+      DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+      UNUSED(status);
 
-  w25_wrdi(priv);
+      /* Make sure that writing is disabled */
+
+      w25_wrdi(priv);
+      priv->lastwrite = false;
+    }
 
   /* Select this FLASH part */
 
@@ -1451,6 +1512,12 @@ FAR struct mtd_dev_s *w25_initialize(FAR struct spi_dev_s *spi)
       priv->mtd.name   = "w25";
       priv->spi        = spi;
 
+      /* The part may still be busy with an operation started before
+       * reset.
+       */
+
+      priv->lastwrite = true;
+
       /* Deselect the FLASH */
 
       SPI_SELECT(spi, SPIDEV_FLASH(0), false);
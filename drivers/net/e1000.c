@@ -29,6 +29,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <string.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
@@ -36,6 +37,8 @@
 #include <nuttx/addrenv.h>
 #include <nuttx/spinlock.h>
 
+#include <nuttx/ethtool.h>
+#include <nuttx/net/ioctl.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/pci/pci.h>
 #include <nuttx/net/e1000.h>
@@ -58,6 +61,10 @@
 #define E1000_TX_DESC           256
 #define E1000_RX_DESC           256
 
+/* The driver sets up the TX and RX queue 0 of the device only */
+
+#define E1000_NQUEUES           1
+
 /* After RX packet is done, we provide free netpkt to the RX descriptor ring.
  * The upper-half network logic is responsible for freeing the RX packets
  * so we need some additional spare netpkt buffers to assure that it's
@@ -195,6 +202,15 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
 
 static FAR netpkt_t *e1000_receive(FAR struct netdev_lowerhalf_s *dev);
 static void e1000_txdone(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int e1000_transmitq(FAR struct netdev_lowerhalf_s *dev, int queue,
+                           FAR netpkt_t *pkt);
+static FAR netpkt_t *e1000_receiveq(FAR struct netdev_lowerhalf_s *dev,
+                                    int queue);
+#  if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD > 0
+static void e1000_reclaimq(FAR struct netdev_lowerhalf_s *dev, int queue);
+#  endif
+#endif
 
 static void e1000_msi_interrupt(FAR struct e1000_driver_s *priv);
 #ifdef CONFIG_PCI_MSIX
@@ -215,6 +231,10 @@ static int e1000_addmac(FAR struct netdev_lowerhalf_s *dev,
 static int e1000_rmmac(FAR struct netdev_lowerhalf_s *dev,
                        FAR const uint8_t *mac);
 #endif
+#ifdef CONFIG_NETDEV_ETHTOOL_IOCTL
+static int e1000_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
+                       unsigned long arg);
+#endif
 
 /* Initialization */
 
@@ -291,9 +311,19 @@ static const struct netdev_ops_s g_e1000_ops =
   .addmac   = e1000_addmac,
   .rmmac    = e1000_rmmac,
 #endif
+#ifdef CONFIG_NETDEV_ETHTOOL_IOCTL
+  .ioctl    = e1000_ioctl,
+#endif
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD > 0
   .reclaim  = e1000_txdone,
 #endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  .transmitq = e1000_transmitq,
+  .receiveq  = e1000_receiveq,
+#  if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD > 0
+  .reclaimq  = e1000_reclaimq,
+#  endif
+#endif
 };
 
 /*****************************************************************************
@@ -524,8 +554,23 @@ static int e1000_transmit(FAR struct netdev_lowerhalf_s *dev,
   priv->tx[desc].cmd    = (E1000_TDESC_CMD_EOP | E1000_TDESC_CMD_IFCS |
                            E1000_TDESC_CMD_RS | E1000_TDESC_CMD_RPS);
   priv->tx[desc].cso    = 0;
+  priv->tx[desc].css    = 0;
   priv->tx[desc].status = 0;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Insert the TCP/UDP checksum left to us, the field already holds the
+   * pseudo-header sum.
+   */
+
+  if ((dev->netdev.d_chksum_flags & NETDEV_CHKSUM_PARTIAL) != 0)
+    {
+      priv->tx[desc].css  = ETH_HDRLEN + dev->netdev.d_chksum_start;
+      priv->tx[desc].cso  = priv->tx[desc].css +
+                            dev->netdev.d_chksum_offset;
+      priv->tx[desc].cmd |= E1000_TDESC_CMD_IC;
+    }
+#endif
+
   UP_DSB();
 
   /* Update TX tail */
@@ -590,6 +635,20 @@ static FAR netpkt_t *e1000_receive(FAR struct netdev_lowerhalf_s *dev)
 
   netpkt_setdatalen(dev, pkt, rx->len);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Both checksums were checked, a failure is reported as an error and
+   * the packet is dropped below.  IPv6 has no IP checksum and is left to
+   * the network stack.
+   */
+
+  if ((rx->status & (E1000_RDESC_STATUS_IXSM | E1000_RDESC_STATUS_TCPCS |
+                     E1000_RDESC_STATUS_IPCS)) ==
+      (E1000_RDESC_STATUS_TCPCS | E1000_RDESC_STATUS_IPCS))
+    {
+      dev->netdev.d_chksum_flags |= NETDEV_CHKSUM_VERIFIED;
+    }
+#endif
+
   /* Store new packet in RX descriptor ring */
 
   rx->addr   = up_addrenv_va_to_pa(
@@ -660,6 +719,44 @@ static void e1000_txdone(FAR struct netdev_lowerhalf_s *dev)
   netdev_lower_txdone(dev);
 }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/*****************************************************************************
+ * Name: e1000_transmitq/e1000_receiveq/e1000_reclaimq
+ *
+ * Description:
+ *   The operations on one queue pair.  The packets of the only queue pair
+ *   set up are counted against its quota by netpkt_alloc and netpkt_free,
+ *   and the completions are notified by netdev_lower_rxready and
+ *   netdev_lower_txdone, which all work on queue 0.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ *****************************************************************************/
+
+static int e1000_transmitq(FAR struct netdev_lowerhalf_s *dev, int queue,
+                           FAR netpkt_t *pkt)
+{
+  DEBUGASSERT(queue < E1000_NQUEUES);
+  return e1000_transmit(dev, pkt);
+}
+
+static FAR netpkt_t *e1000_receiveq(FAR struct netdev_lowerhalf_s *dev,
+                                    int queue)
+{
+  DEBUGASSERT(queue < E1000_NQUEUES);
+  return e1000_receive(dev);
+}
+
+#  if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD > 0
+static void e1000_reclaimq(FAR struct netdev_lowerhalf_s *dev, int queue)
+{
+  DEBUGASSERT(queue < E1000_NQUEUES);
+  e1000_txdone(dev);
+}
+#  endif
+#endif
+
 /*****************************************************************************
  * Name: e1000_msi_interupt
  *
@@ -1052,6 +1149,91 @@ static int e1000_rmmac(FAR struct netdev_lowerhalf_s *dev,
 }
 #endif  /* CONFIG_NET_MCASTGROUP */
 
+/*****************************************************************************
+ * Name: e1000_ioctl
+ *
+ * Description:
+ *   NuttX Callback: Handle the ETHTOOL_GCOALESCE and ETHTOOL_SCOALESCE
+ *   commands of SIOCETHTOOL.  The interrupt moderation of the device is
+ *   the minimum interval of the interrupt that RX and TX share, it is
+ *   programmed in 256 ns increments.
+ *
+ * Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *   cmd  - The ioctl command
+ *   arg  - The struct ethtool_coalesce of the command
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ *****************************************************************************/
+
+#ifdef CONFIG_NETDEV_ETHTOOL_IOCTL
+static int e1000_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+  FAR struct e1000_driver_s   *priv = (FAR struct e1000_driver_s *)dev;
+  FAR struct ethtool_coalesce *ec   =
+    (FAR struct ethtool_coalesce *)((uintptr_t)arg);
+  uint32_t                     usecs;
+  uint32_t                     regval;
+
+  if (cmd != SIOCETHTOOL)
+    {
+      return -ENOTTY;
+    }
+
+  switch (ec->cmd)
+    {
+      case ETHTOOL_GCOALESCE:
+        regval = e1000_getreg_mem(priv, E1000_ITR) & E1000_ITR_INTERVAL_MASK;
+        usecs  = (regval * 256 + 500) / 1000;
+
+        memset(ec, 0, sizeof(*ec));
+        ec->cmd               = ETHTOOL_GCOALESCE;
+        ec->rx_coalesce_usecs = usecs;
+        ec->tx_coalesce_usecs = usecs;
+        return OK;
+
+      case ETHTOOL_SCOALESCE:
+        /* RX and TX share the interrupt, only the interval of it is
+         * implemented.
+         */
+
+        if (ec->rx_max_coalesced_frames > 1 ||
+            ec->tx_max_coalesced_frames > 1 ||
+            ec->use_adaptive_rx_coalesce || ec->use_adaptive_tx_coalesce)
+          {
+            return -EOPNOTSUPP;
+          }
+
+        if ((ec->tx_coalesce_usecs != 0 &&
+             ec->tx_coalesce_usecs != ec->rx_coalesce_usecs) ||
+            ec->rx_coalesce_usecs > E1000_ITR_INTERVAL_MASK * 256 / 1000)
+          {
+            return -EINVAL;
+          }
+
+        regval = ec->rx_coalesce_usecs * 1000 / 256;
+        e1000_putreg_mem(priv, E1000_ITR, regval);
+
+#ifdef CONFIG_PCI_MSIX
+        /* With MSI-X the vector is throttled on its own */
+
+        if (priv->type->flags & E1000_HAS_MSIX)
+          {
+            e1000_putreg_mem(priv, E1000_EITR0, regval);
+          }
+#endif
+
+        return OK;
+
+      default:
+        return -EOPNOTSUPP;
+    }
+}
+#endif
+
 /*****************************************************************************
  * Name: e1000_disable
  *
@@ -1219,6 +1401,14 @@ static void e1000_enable(FAR struct e1000_driver_s *priv)
 #endif
   e1000_putreg_mem(priv, E1000_RCTL, regval);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Check the IPv4 and TCP/UDP checksums of received packets */
+
+  regval = e1000_getreg_mem(priv, E1000_RXCSUM);
+  regval |= E1000_RXCSUM_IPOFL | E1000_RXCSUM_TUOFL;
+  e1000_putreg_mem(priv, E1000_RXCSUM, regval);
+#endif
+
   /* REVISIT: Set granuality to Descriptors */
 
   regval = e1000_getreg_mem(priv, E1000_RXDCTL);
@@ -1422,10 +1612,20 @@ static int e1000_probe(FAR struct pci_device_s *dev)
 
   /* Register the network device */
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->nqueues = E1000_NQUEUES;
+  netdev->queues[0].quota[NETPKT_TX] = E1000_TX_QUOTA;
+  netdev->queues[0].quota[NETPKT_RX] = E1000_RX_QUOTA;
+#else
   netdev->quota[NETPKT_TX] = E1000_TX_QUOTA;
   netdev->quota[NETPKT_RX] = E1000_RX_QUOTA;
+#endif
   netdev->ops = &g_e1000_ops;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  netdev->netdev.d_features = NETDEV_FEATURE_TXCSUM | NETDEV_FEATURE_RXCSUM;
+#endif
+
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
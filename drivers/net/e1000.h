@@ -53,12 +53,14 @@
 /* Interrupt registers */
 
 #define E1000_ICR                   (0x00c0)   /* Interrupt Cause Read */
+#define E1000_ITR                   (0x00c4)   /* Interrupt Throttling Rate */
 #define E1000_ICS                   (0x00c8)   /* Interrupt Cause Set */
 #define E1000_IMS                   (0x00d0)   /* Interrupt Mask Set */
 #define E1000_IMC                   (0x00d8)   /* Interrupt Mask Clear */
 #define E1000_EIAC                  (0x00dc)   /* Interrupt Auto Clear */
 #define E1000_IAM                   (0x00e0)   /* Interrupt Acknowledge Auto–Mask  */
 #define E1000_IVAR                  (0x00e4)   /* Interrupt Vector Allocation Registers  */
+#define E1000_EITR0                 (0x00e8)   /* Extended Interrupt Throttling Rate of MSI-X vector 0 */
 
 /* Transmit registers */
 
@@ -308,11 +310,21 @@
 #define E1000_RXDCTL_GRAN           (1 << 24)  /* Bit 24: Granularity */
                                                /* Bits 25-32: Reserved */
 
+/* Receive Checksum Control */
+
+#define E1000_RXCSUM_IPOFL          (1 << 8)   /* Bit 8: IP Checksum Off-load Enable */
+#define E1000_RXCSUM_TUOFL          (1 << 9)   /* Bit 9: TCP/UDP Checksum Off-load Enable */
+
 /* Receive Delay Timer Register  */
 
 #define E1000_RDTR_DELAY_MASK       (0xffff)   /* Bits 0-15: Receive delay timer */
 #define E1000_RDTR_FPD              (1 << 31)  /* Bit 31: Flush partial descriptor block */
 
+/* Interrupt Throttling Rate */
+
+#define E1000_ITR_INTERVAL_MASK     (0xffff)   /* Bits 0-15: Minimum inter-interrupt interval in 256 ns increments */
+                                               /* Bits 16-31: Reserved */
+
 /* Interrupt Cause */
 
 #define E1000_IC_TXDW               (1 << 0)   /* Bit 0: Transmit Descriptor Written Back */
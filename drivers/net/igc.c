@@ -29,6 +29,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <string.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
@@ -36,6 +37,8 @@
 #include <nuttx/addrenv.h>
 #include <nuttx/spinlock.h>
 
+#include <nuttx/ethtool.h>
+#include <nuttx/net/ioctl.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/pci/pci.h>
 #include <nuttx/net/igc.h>
@@ -58,6 +61,10 @@
 #define IGC_TX_DESC            256
 #define IGC_RX_DESC            256
 
+/* The driver sets up the TX and RX queue 0 of the device only */
+
+#define IGC_NQUEUES            1
+
 /* After RX packet is done, we provide free netpkt to the RX descriptor ring.
  * The upper-half network logic is responsible for freeing the RX packets
  * so we need some additional spare netpkt buffers to assure that it's
@@ -178,6 +185,12 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
 
 static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev);
 static void igc_txdone(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int igc_transmitq(FAR struct netdev_lowerhalf_s *dev, int queue,
+                         FAR netpkt_t *pkt);
+static FAR netpkt_t *igc_receiveq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue);
+#endif
 
 static void igc_msix_interrupt(FAR struct igc_driver_s *priv);
 static int igc_interrupt(int irq, FAR void *context, FAR void *arg);
@@ -195,6 +208,10 @@ static int igc_addmac(FAR struct netdev_lowerhalf_s *dev,
 static int igc_rmmac(FAR struct netdev_lowerhalf_s *dev,
                      FAR const uint8_t *mac);
 #endif
+#ifdef CONFIG_NETDEV_ETHTOOL_IOCTL
+static int igc_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
+                     unsigned long arg);
+#endif
 
 /* Initialization */
 
@@ -250,6 +267,13 @@ static const struct netdev_ops_s g_igc_ops =
   .addmac   = igc_addmac,
   .rmmac    = igc_rmmac,
 #endif
+#ifdef CONFIG_NETDEV_ETHTOOL_IOCTL
+  .ioctl    = igc_ioctl,
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  .transmitq = igc_transmitq,
+  .receiveq  = igc_receiveq,
+#endif
 };
 
 /*****************************************************************************
@@ -478,8 +502,23 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
   priv->tx[desc].cmd    = (IGC_TDESC_CMD_EOP | IGC_TDESC_CMD_IFCS |
                            IGC_TDESC_CMD_RS);
   priv->tx[desc].cso    = 0;
+  priv->tx[desc].css    = 0;
   priv->tx[desc].status = 0;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Insert the TCP/UDP checksum left to us, the field already holds the
+   * pseudo-header sum.
+   */
+
+  if ((dev->netdev.d_chksum_flags & NETDEV_CHKSUM_PARTIAL) != 0)
+    {
+      priv->tx[desc].css  = ETH_HDRLEN + dev->netdev.d_chksum_start;
+      priv->tx[desc].cso  = priv->tx[desc].css +
+                            dev->netdev.d_chksum_offset;
+      priv->tx[desc].cmd |= IGC_TDESC_CMD_IC;
+    }
+#endif
+
   UP_DSB();
 
   /* Update TX tail */
@@ -546,6 +585,19 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
 
   netpkt_setdatalen(dev, pkt, rx->len);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Both checksums were checked, a failure is reported as an error and
+   * the packet is dropped below.  IPv6 has no IP checksum and is left to
+   * the network stack.
+   */
+
+  if ((rx->status & (IGC_RDESC_STATUS_L4CS | IGC_RDESC_STATUS_IPCS)) ==
+      (IGC_RDESC_STATUS_L4CS | IGC_RDESC_STATUS_IPCS))
+    {
+      dev->netdev.d_chksum_flags |= NETDEV_CHKSUM_VERIFIED;
+    }
+#endif
+
   /* Store new packet in RX descriptor ring */
 
   rx->addr   = up_addrenv_va_to_pa(
@@ -616,6 +668,36 @@ static void igc_txdone(FAR struct netdev_lowerhalf_s *dev)
   netdev_lower_txdone(dev);
 }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/*****************************************************************************
+ * Name: igc_transmitq/igc_receiveq
+ *
+ * Description:
+ *   The operations on one queue pair.  The packets of the only queue pair
+ *   set up are counted against its quota by netpkt_alloc and netpkt_free,
+ *   and the completions are notified by netdev_lower_rxready and
+ *   netdev_lower_txdone, which all work on queue 0.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ *****************************************************************************/
+
+static int igc_transmitq(FAR struct netdev_lowerhalf_s *dev, int queue,
+                         FAR netpkt_t *pkt)
+{
+  DEBUGASSERT(queue < IGC_NQUEUES);
+  return igc_transmit(dev, pkt);
+}
+
+static FAR netpkt_t *igc_receiveq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue)
+{
+  DEBUGASSERT(queue < IGC_NQUEUES);
+  return igc_receive(dev);
+}
+#endif
+
 /*****************************************************************************
  * Name: igc_misx_interrupt
  *
@@ -931,6 +1013,79 @@ static int igc_rmmac(FAR struct netdev_lowerhalf_s *dev,
 }
 #endif  /* CONFIG_NET_MCASTGROUP */
 
+/*****************************************************************************
+ * Name: igc_ioctl
+ *
+ * Description:
+ *   NuttX Callback: Handle the ETHTOOL_GCOALESCE and ETHTOOL_SCOALESCE
+ *   commands of SIOCETHTOOL.  The interrupt moderation of the device is
+ *   the minimum interval of the MSI-X vector that RX and TX share.
+ *
+ * Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *   cmd  - The ioctl command
+ *   arg  - The struct ethtool_coalesce of the command
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ *****************************************************************************/
+
+#ifdef CONFIG_NETDEV_ETHTOOL_IOCTL
+static int igc_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
+                     unsigned long arg)
+{
+  FAR struct igc_driver_s     *priv = (FAR struct igc_driver_s *)dev;
+  FAR struct ethtool_coalesce *ec   =
+    (FAR struct ethtool_coalesce *)((uintptr_t)arg);
+  uint32_t                     usecs;
+
+  if (cmd != SIOCETHTOOL)
+    {
+      return -ENOTTY;
+    }
+
+  switch (ec->cmd)
+    {
+      case ETHTOOL_GCOALESCE:
+        usecs = (igc_getreg_mem(priv, IGC_EITR0) & IGC_EITR_INTERVAL_MASK) >>
+                IGC_EITR_INTERVAL_SHIFT;
+
+        memset(ec, 0, sizeof(*ec));
+        ec->cmd               = ETHTOOL_GCOALESCE;
+        ec->rx_coalesce_usecs = usecs;
+        ec->tx_coalesce_usecs = usecs;
+        return OK;
+
+      case ETHTOOL_SCOALESCE:
+        /* RX and TX share the interrupt, only the interval of it is
+         * implemented.
+         */
+
+        if (ec->rx_max_coalesced_frames > 1 ||
+            ec->tx_max_coalesced_frames > 1 ||
+            ec->use_adaptive_rx_coalesce || ec->use_adaptive_tx_coalesce)
+          {
+            return -EOPNOTSUPP;
+          }
+
+        if ((ec->tx_coalesce_usecs != 0 &&
+             ec->tx_coalesce_usecs != ec->rx_coalesce_usecs) ||
+            ec->rx_coalesce_usecs > IGC_EITR_INTERVAL_MAX)
+          {
+            return -EINVAL;
+          }
+
+        igc_putreg_mem(priv, IGC_EITR0,
+                       ec->rx_coalesce_usecs << IGC_EITR_INTERVAL_SHIFT);
+        return OK;
+
+      default:
+        return -EOPNOTSUPP;
+    }
+}
+#endif
+
 /*****************************************************************************
  * Name: igc_disable
  *
@@ -1101,6 +1256,14 @@ static void igc_enable(FAR struct igc_driver_s *priv)
 #endif
   igc_putreg_mem(priv, IGC_RCTL, regval);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Check the IPv4 and TCP/UDP checksums of received packets */
+
+  regval = igc_getreg_mem(priv, IGC_RXCSUM);
+  regval |= IGC_RXCSUM_IPOFLD | IGC_RXCSUM_TUOFLD;
+  igc_putreg_mem(priv, IGC_RXCSUM, regval);
+#endif
+
   /* Enable TX queeu */
 
   regval = igc_getreg_mem(priv, IGC_TXDCTL0);
@@ -1184,7 +1347,8 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
 
   /* Configure Interrupt Throttle */
 
-  igc_putreg_mem(priv, IGC_EITR0, (IGC_INTERRUPT_INTERVAL << 2));
+  igc_putreg_mem(priv, IGC_EITR0,
+                 IGC_INTERRUPT_INTERVAL << IGC_EITR_INTERVAL_SHIFT);
 
   /* Get MAC if valid */
 
@@ -1318,10 +1482,20 @@ static int igc_probe(FAR struct pci_device_s *dev)
 
   /* Register the network device */
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->nqueues = IGC_NQUEUES;
+  netdev->queues[0].quota[NETPKT_TX] = IGC_TX_QUOTA;
+  netdev->queues[0].quota[NETPKT_RX] = IGC_RX_QUOTA;
+#else
   netdev->quota[NETPKT_TX] = IGC_TX_QUOTA;
   netdev->quota[NETPKT_RX] = IGC_RX_QUOTA;
+#endif
   netdev->ops = &g_igc_ops;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  netdev->netdev.d_features = NETDEV_FEATURE_TXCSUM | NETDEV_FEATURE_RXCSUM;
+#endif
+
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
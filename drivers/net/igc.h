@@ -371,6 +371,11 @@
 #define IGC_RXDCTL_SWFLUSH        (1 << 26) /* Bit 26: Receive Software Flush */
                                             /* Bits 27-31: Reserved */
 
+/* Receive Checksum Control */
+
+#define IGC_RXCSUM_IPOFLD         (1 << 8)  /* Bit 8: IP Checksum Off-load Enable */
+#define IGC_RXCSUM_TUOFLD         (1 << 9)  /* Bit 9: TCP/UDP Checksum Off-load Enable */
+
 /* Interrupt Cause */
 
 #define IGC_IC_TXDW               (1 << 0)   /* Bit 0: Transmit Descriptor Written Back */
@@ -446,6 +451,13 @@
 #define IGC_GPIE_EIAME            (1 << 30)  /* Bit 30: Extended Interrupt Auto Mask Enable */
 #define IGC_GPIE_PBASUPPORT       (1 << 31)  /* Bit 31: PBA Support */
 
+/* Extended Interrupt Throttling Rate */
+
+                                             /* Bits 0-1: Reserved */
+#define IGC_EITR_INTERVAL_SHIFT   (2)        /* Bits 2-14: Minimum Inter-interrupt Interval in 1 us increments */
+#define IGC_EITR_INTERVAL_MASK    (0x1fff << IGC_EITR_INTERVAL_SHIFT)
+#define IGC_EITR_INTERVAL_MAX     (0x1fff)
+
 /* Transmit Descriptor Command Field */
 
 #define IGC_TDESC_CMD_EOP         (1 << 0)   /* Bit 0: End Of Packet */
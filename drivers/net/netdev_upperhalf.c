@@ -39,6 +39,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -56,12 +57,62 @@
 #  define NETDEV_WORK LPWORK
 #endif
 
-#ifdef CONFIG_NETDEV_RSS
+/* One thread per CPU for RSS, one per queue pair for multi-queue devices */
+
+#if defined(CONFIG_NETDEV_MULTIQUEUE) && (!defined(CONFIG_NETDEV_RSS) || \
+    CONFIG_NETDEV_MAX_QUEUES > CONFIG_SMP_NCPUS)
+#  define NETDEV_THREAD_COUNT CONFIG_NETDEV_MAX_QUEUES
+#elif defined(CONFIG_NETDEV_RSS)
 #  define NETDEV_THREAD_COUNT CONFIG_SMP_NCPUS
 #else
 #  define NETDEV_THREAD_COUNT 1
 #endif
 
+/* The queue pair being serviced, the number of queue pairs of a device and
+ * the per-queue statistics.  A device without queue pairs has queue 0.
+ */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define NETDEV_QUEUE(upper)     ((upper)->queue)
+#  define NETDEV_NQUEUES(lower)   ((lower)->nqueues > 0 ? (lower)->nqueues : 1)
+#  define NETDEV_QUEUE_STATS(upper,stat,type) \
+     do \
+       { \
+         if ((upper)->lower->nqueues > 0) \
+           { \
+             (upper)->lower->queues[(upper)->queue].stat[type]++; \
+           } \
+       } \
+     while (0)
+#else
+#  define NETDEV_QUEUE(upper)     0
+#  define NETDEV_NQUEUES(lower)   1
+#  define NETDEV_QUEUE_STATS(upper,stat,type)
+#endif
+
+/* The driver reports the checksum state of a received packet in
+ * d_chksum_flags, it is carried with the packet until the packet is
+ * handed to the network stack.
+ */
+
+/* The segment size of the packet being sent, non-zero if the driver
+ * segments it in hardware.
+ */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define NETDEV_GSO_SIZE(lower)  ((lower)->gso_size)
+#else
+#  define NETDEV_GSO_SIZE(lower)  0
+#endif
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+#  define NETDEV_RXCHKSUM_GET(dev)       ((dev)->d_chksum_flags)
+#  define NETDEV_RXCHKSUM_SET(dev,flags) ((dev)->d_chksum_flags = (flags))
+#else
+#  define NETDEV_RXCHKSUM_GET(dev)       0
+#  define NETDEV_RXCHKSUM_SET(dev,flags) ((void)(flags))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,12 +138,106 @@ struct netdev_upperhalf_s
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The queue pair being serviced and the TX queue of each CPU (XPS) */
+
+  int     queue;
+  uint8_t xps[CONFIG_SMP_NCPUS];
+#endif
+
+#if CONFIG_NETDEV_TX_BATCH > 0
+  /* Packets collected for transmit_batch() during one poll */
+
+  FAR netpkt_t *txbatch[CONFIG_NETDEV_TX_BATCH];
+  int           ntxbatch;
+#endif
+
+#ifdef CONFIG_NETDEV_WMM
+  /* Packets waiting to be sent, one queue per access category */
+
+  struct iob_queue_s acq[NETDEV_AC_NUM];
+#endif
 };
 
+/* The packet held by receive offload during one RX poll */
+
+#ifdef CONFIG_NETDEV_GRO
+struct netdev_gro_s
+{
+  FAR netpkt_t *pkt;            /* Held packet, NULL if none */
+  uint32_t      seqno;          /* Sequence number that continues it */
+  uint16_t      iphdrlen;       /* Length of its IP header */
+  uint16_t      hdrlen;         /* Length of its IP and TCP headers */
+  uint16_t      nseg;           /* Number of segments merged into it */
+  uint8_t       chksum;         /* NETDEV_CHKSUM_* common to all of them */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev,
+                                           int queue);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netdev_upper_quota
+ *
+ * Description:
+ *   Get the quota of one queue pair, the quota of the device itself if it
+ *   has no queue pairs.
+ *
+ ****************************************************************************/
+
+static FAR atomic_int *
+netdev_upper_quota(FAR struct netdev_lowerhalf_s *lower, int queue,
+                   enum netpkt_type_e type)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 0)
+    {
+      DEBUGASSERT(queue >= 0 && queue < lower->nqueues);
+      return &lower->queues[queue].quota[type];
+    }
+#endif
+
+  DEBUGASSERT(queue == 0);
+  return &lower->quota[type];
+}
+
+/****************************************************************************
+ * Name: ops_is_valid
+ *
+ * Description:
+ *   Check if the lower half provides the operations the upper half needs.
+ *
+ ****************************************************************************/
+
+static bool ops_is_valid(FAR struct netdev_lowerhalf_s *lower)
+{
+  FAR const struct netdev_ops_s *ops = lower->ops;
+
+  if (ops == NULL)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 0)
+    {
+      return lower->nqueues <= CONFIG_NETDEV_MAX_QUEUES &&
+             ops->transmitq != NULL && ops->receiveq != NULL;
+    }
+#endif
+
+  return ops->transmit != NULL && ops->receive != NULL;
+}
+
 /****************************************************************************
  * Name: quota_is_valid
  *
@@ -155,7 +300,8 @@ static FAR netpkt_t *netpkt_get(FAR struct net_driver_s *dev,
    * cases will be limited by netdev_upper_can_tx and seldom reaches here.
    */
 
-  if (atomic_fetch_sub(&upper->lower->quota[type], 1) <= 0)
+  if (atomic_fetch_sub(netdev_upper_quota(upper->lower, NETDEV_QUEUE(upper),
+                                           type), 1) <= 0)
     {
       nwarn("WARNING: Allowing temperarily exceeding quota of %s.\n",
             dev->d_ifname);
@@ -175,71 +321,665 @@ static FAR netpkt_t *netpkt_get(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-static void netpkt_put(FAR struct net_driver_s *dev, FAR netpkt_t *pkt,
-                       enum netpkt_type_e type)
+static void netpkt_put(FAR struct net_driver_s *dev, FAR netpkt_t *pkt,
+                       enum netpkt_type_e type)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+  DEBUGASSERT(dev && pkt);
+
+  atomic_fetch_add(netdev_upper_quota(upper->lower, NETDEV_QUEUE(upper),
+                                      type), 1);
+  netdev_iob_replace_l2(dev, pkt);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_alloc
+ *
+ * Description:
+ *   Get the upper half of lower half structure, create one if not present.
+ *
+ ****************************************************************************/
+
+static FAR struct netdev_upperhalf_s *
+netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
+{
+  /* Allocate the upper-half data structure */
+
+  FAR struct netdev_upperhalf_s *upper;
+
+  DEBUGASSERT(dev != NULL && dev->netdev.d_private == NULL);
+
+  upper = kmm_zalloc(sizeof(struct netdev_upperhalf_s));
+  if (upper == NULL)
+    {
+      nerr("ERROR: Allocation failed\n");
+      return NULL;
+    }
+
+  upper->lower = dev;
+  dev->netdev.d_private = upper;
+
+  return upper;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_transmit/receive/reclaim
+ *
+ * Description:
+ *   Relay to the operation of the lower half for the queue pair being
+ *   serviced.  netdev_upper_reclaim returns false if the lower half cannot
+ *   reclaim.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_transmit(FAR struct netdev_upperhalf_s *upper,
+                                 FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 0)
+    {
+      return lower->ops->transmitq(lower, upper->queue, pkt);
+    }
+#endif
+
+  return lower->ops->transmit(lower, pkt);
+}
+
+static FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 0)
+    {
+      return lower->ops->receiveq(lower, upper->queue);
+    }
+#endif
+
+  return lower->ops->receive(lower);
+}
+
+static bool netdev_upper_reclaim(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 0)
+    {
+      if (lower->ops->reclaimq == NULL)
+        {
+          return false;
+        }
+
+      lower->ops->reclaimq(lower, upper->queue);
+      return true;
+    }
+#endif
+
+  if (lower->ops->reclaim == NULL)
+    {
+      return false;
+    }
+
+  lower->ops->reclaim(lower);
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_can_tx
+ *
+ * Description:
+ *   Check if we allow tx on the queue of this device being serviced.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int queue = NETDEV_QUEUE(upper);
+  int quota = netdev_lower_quota_load_queue(lower, queue, NETPKT_TX);
+
+  if (quota <= 0 && netdev_upper_reclaim(upper))
+    {
+      quota = netdev_lower_quota_load_queue(lower, queue, NETPKT_TX);
+    }
+
+  return quota > 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_flush
+ *
+ * Description:
+ *   Hand the packets collected during this poll to transmit_batch() of the
+ *   lower half.  The packets the lower half does not take are dropped.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NETDEV_TX_BATCH > 0
+static void netdev_upper_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int npkts = upper->ntxbatch;
+  int ret;
+  int i;
+
+  if (npkts == 0)
+    {
+      return;
+    }
+
+  upper->ntxbatch = 0;
+  ret = lower->ops->transmit_batch(lower, NETDEV_QUEUE(upper),
+                                   upper->txbatch, npkts);
+  for (i = 0; i < npkts; i++)
+    {
+      if (i < ret)
+        {
+          NETDEV_QUEUE_STATS(upper, packets, NETPKT_TX);
+          continue;
+        }
+
+      NETDEV_TXERRORS(&lower->netdev);
+      NETDEV_QUEUE_STATS(upper, errors, NETPKT_TX);
+      netpkt_qfree(lower, NETDEV_QUEUE(upper), upper->txbatch[i],
+                   NETPKT_TX);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_batch
+ *
+ * Description:
+ *   Add a packet to the batch, sending the batch once it is full.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_batch(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  upper->txbatch[upper->ntxbatch++] = pkt;
+  if (upper->ntxbatch == CONFIG_NETDEV_TX_BATCH)
+    {
+      netdev_upper_flush(upper);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_wmm_queue
+ *
+ * Description:
+ *   Get the queue of the access category of a packet from the DSCP of its
+ *   IP header: the precedence bits are the 802.1D user priority, mapped as
+ *   in IEEE 802.11 Table 10-1.  Other packets are best effort.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_WMM
+static FAR struct iob_queue_s *
+netdev_upper_wmm_queue(FAR struct netdev_upperhalf_s *upper,
+                       FAR netpkt_t *pkt)
+{
+  static const uint8_t up2ac[8] =
+  {
+    NETDEV_AC_BE, NETDEV_AC_BK, NETDEV_AC_BK, NETDEV_AC_BE,
+    NETDEV_AC_VI, NETDEV_AC_VI, NETDEV_AC_VO, NETDEV_AC_VO
+  };
+
+  FAR struct eth_hdr_s *eth_hdr =
+    (FAR struct eth_hdr_s *)netpkt_getdata(upper->lower, pkt);
+  FAR const uint8_t *iphdr = IOB_DATA(pkt);
+  uint8_t tos;
+
+  if (pkt->io_len < 2)
+    {
+      return &upper->acq[NETDEV_AC_BE];
+    }
+
+  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+    {
+      tos = iphdr[1];
+    }
+  else if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+    {
+      tos = (iphdr[0] << 4) | (iphdr[1] >> 4);
+    }
+  else
+    {
+      return &upper->acq[NETDEV_AC_BE];
+    }
+
+  return &upper->acq[up2ac[tos >> 5]];
+}
+
+/****************************************************************************
+ * Name: netdev_upper_wmm_send
+ *
+ * Description:
+ *   Send the packets waiting in the access category queues, voice first.
+ *   A packet the lower half refuses stays queued and sending stops until
+ *   the next poll, so a busy driver does not lose packets.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_wmm_send(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t *pkt;
+  int ac;
+
+  for (ac = 0; ac < NETDEV_AC_NUM; ac++)
+    {
+      lower->tx_ac = ac;
+      while ((pkt = iob_peek_queue(&upper->acq[ac])) != NULL)
+        {
+#if CONFIG_NETDEV_TX_BATCH > 0
+          if (lower->ops->transmit_batch != NULL)
+            {
+              netdev_upper_batch(upper, iob_remove_queue(&upper->acq[ac]));
+              continue;
+            }
+#endif
+
+          if (netdev_upper_transmit(upper, pkt) != OK)
+            {
+              return;
+            }
+
+          iob_remove_queue(&upper->acq[ac]);
+          NETDEV_QUEUE_STATS(upper, packets, NETPKT_TX);
+        }
+
+#if CONFIG_NETDEV_TX_BATCH > 0
+      /* A batch holds packets of one category only */
+
+      netdev_upper_flush(upper);
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_wmm_free
+ *
+ * Description:
+ *   Drop the packets waiting in the access category queues.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_wmm_free(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR netpkt_t *pkt;
+  int ac;
+
+  for (ac = 0; ac < NETDEV_AC_NUM; ac++)
+    {
+      while ((pkt = iob_remove_queue(&upper->acq[ac])) != NULL)
+        {
+          netpkt_free(upper->lower, pkt, NETPKT_TX);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_rxfill
+ *
+ * Description:
+ *   Hand empty RX packets to a lower half with the rxfill operation, until
+ *   its RX quota is used up or it has no more room.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxfill(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int queue = NETDEV_QUEUE(upper);
+  FAR netpkt_t *pkt;
+
+  if (lower->ops->rxfill == NULL || !IFF_IS_UP(lower->netdev.d_flags))
+    {
+      return;
+    }
+
+  while ((pkt = netpkt_qalloc(lower, queue, NETPKT_RX)) != NULL)
+    {
+      if (lower->ops->rxfill(lower, queue, pkt) < 0)
+        {
+          netpkt_qfree(lower, queue, pkt, NETPKT_RX);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_tcphdr
+ *
+ * Description:
+ *   Check whether the IP packet in 'iob' is a TCP segment that offload can
+ *   handle: IPv4 without fragmentation or IPv6 without extension headers,
+ *   with the IP and TCP headers in the first buffer of the chain.
+ *
+ * Returned Value:
+ *   The length of the IP header, or zero if the packet is not such a TCP
+ *   segment.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_GSO) || defined(CONFIG_NETDEV_GRO)
+static unsigned int netdev_upper_tcphdr(FAR struct iob_s *iob)
+{
+  FAR uint8_t *ip = IOB_DATA(iob);
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int iphdrlen;
+
+  if (iob->io_len == 0)
+    {
+      return 0;
+    }
+
+  switch (ip[0] >> 4)
+    {
+#ifdef CONFIG_NET_IPv4
+      case 4:
+        {
+          FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+          uint16_t ipoffset;
+
+          if (iob->io_len < IPv4_HDRLEN)
+            {
+              return 0;
+            }
+
+          ipoffset = ((uint16_t)ipv4->ipoffset[0] << 8) + ipv4->ipoffset[1];
+          if (ipv4->proto != IP_PROTO_TCP ||
+              (ipoffset & ~IP_FLAG_DONTFRAG) != 0)
+            {
+              return 0;
+            }
+
+          iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      case 6:
+        if (iob->io_len < IPv6_HDRLEN ||
+            ((FAR struct ipv6_hdr_s *)ip)->proto != IP_PROTO_TCP)
+          {
+            return 0;
+          }
+
+        iphdrlen = IPv6_HDRLEN;
+        break;
+#endif
+
+      default:
+        return 0;
+    }
+
+  if (iob->io_len < iphdrlen + TCP_HDRLEN)
+    {
+      return 0;
+    }
+
+  tcp = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+  if (iob->io_len < iphdrlen + ((tcp->tcpoffset >> 4) << 2))
+    {
+      return 0;
+    }
+
+  return iphdrlen;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_tcpsum
+ *
+ * Description:
+ *   Sum the pseudo-header and the TCP segment of the IP packet in 'iob'.
+ *   The result is 0xffff if the checksum in the TCP header is valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+static uint16_t netdev_upper_tcpsum(FAR struct iob_s *iob,
+                                    unsigned int iphdrlen)
+{
+  FAR uint8_t *ip = IOB_DATA(iob);
+  uint16_t sum;
+
+  /* Protocol and upper layer length, this addition cannot carry */
+
+  sum = iob->io_pktlen - iphdrlen + IP_PROTO_TCP;
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] >> 4) == 4)
+    {
+      sum = chksum(sum,
+                   (FAR uint8_t *)((FAR struct ipv4_hdr_s *)ip)->srcipaddr,
+                   2 * sizeof(in_addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      sum = chksum(sum,
+                   (FAR uint8_t *)((FAR struct ipv6_hdr_s *)ip)->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+#endif
+
+  return chksum_iob(sum, iob, iphdrlen);
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_tcpfix
+ *
+ * Description:
+ *   Make the IP and TCP headers of a segment built by offload consistent
+ *   with its new length: set the IP length, advance the IPv4 ID by 'ipid'
+ *   and recompute the checksums.  The TCP checksum is left alone if
+ *   'tcpsum' is false, for a packet the driver has already verified.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_tcpfix(FAR struct iob_s *iob, unsigned int iphdrlen,
+                                uint16_t ipid, bool tcpsum)
+{
+  FAR uint8_t *ip = IOB_DATA(iob);
+  FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  uint16_t sum;
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] >> 4) == 4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      ipid += ((uint16_t)ipv4->ipid[0] << 8) + ipv4->ipid[1];
+
+      ipv4->len[0]   = iob->io_pktlen >> 8;
+      ipv4->len[1]   = iob->io_pktlen & 0xff;
+      ipv4->ipid[0]  = ipid >> 8;
+      ipv4->ipid[1]  = ipid & 0xff;
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      ipv6->len[0] = (iob->io_pktlen - IPv6_HDRLEN) >> 8;
+      ipv6->len[1] = (iob->io_pktlen - IPv6_HDRLEN) & 0xff;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  if (tcpsum)
+    {
+      tcp->tcpchksum = 0;
+      sum            = netdev_upper_tcpsum(iob, iphdrlen);
+      tcp->tcpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+    }
+#else
+  UNUSED(tcp);
+  UNUSED(tcpsum);
+#endif
+}
+#endif /* CONFIG_NETDEV_GSO || CONFIG_NETDEV_GRO */
+
+/****************************************************************************
+ * Name: netdev_upper_gso
+ *
+ * Description:
+ *   Segment the TCP packet in d_iob in software for a driver that can not
+ *   do it itself.  Each segment gets a copy of the L2, IP and TCP headers
+ *   followed by up to 'mss' bytes of the payload, and is appended to the
+ *   TX queue; the original packet is released.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   mss - The segment size the TCP stack asked for
+ *
+ * Returned Value:
+ *   Zero if at least one segment was queued.  A negated errno value if
+ *   not, d_iob is left untouched then.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static int netdev_upper_gso(FAR struct net_driver_s *dev, uint16_t mss)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct iob_s *iob = dev->d_iob;
+  int llhdrlen = NET_LL_HDRLEN(dev);
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *seg;
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+  unsigned int payload;
+  unsigned int offset;
+  unsigned int len;
+  uint32_t seqno;
+  uint16_t nseg = 0;
+  uint8_t flags;
+
+  iphdrlen = netdev_upper_tcphdr(iob);
+  if (iphdrlen == 0 || mss == 0)
+    {
+      return -EMSGSIZE;
+    }
 
-  DEBUGASSERT(dev && pkt);
+  tcp     = (FAR struct tcp_hdr_s *)(IOB_DATA(iob) + iphdrlen);
+  hdrlen  = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  payload = iob->io_pktlen - hdrlen;
+  seqno   = ((uint32_t)tcp->seqno[0] << 24) |
+            ((uint32_t)tcp->seqno[1] << 16) |
+            ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+  flags   = tcp->flags;
 
-  atomic_fetch_add(&upper->lower->quota[type], 1);
-  netdev_iob_replace_l2(dev, pkt);
-}
+  /* The headers are patched in place, so they must fit in the first
+   * buffer of every segment.
+   */
 
-/****************************************************************************
- * Name: netdev_upper_alloc
- *
- * Description:
- *   Get the upper half of lower half structure, create one if not present.
- *
- ****************************************************************************/
+  if (hdrlen > CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE)
+    {
+      return -EMSGSIZE;
+    }
 
-static FAR struct netdev_upperhalf_s *
-netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
-{
-  /* Allocate the upper-half data structure */
+  for (offset = 0; offset < payload; offset += len, nseg++)
+    {
+      len = MIN(payload - offset, mss);
 
-  FAR struct netdev_upperhalf_s *upper;
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          break;
+        }
 
-  DEBUGASSERT(dev != NULL && dev->netdev.d_private == NULL);
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
 
-  upper = kmm_zalloc(sizeof(struct netdev_upperhalf_s));
-  if (upper == NULL)
-    {
-      nerr("ERROR: Allocation failed\n");
-      return NULL;
-    }
+      if (iob_trycopyin(seg, IOB_DATA(iob) - llhdrlen, llhdrlen + hdrlen,
+                        -llhdrlen, false) != llhdrlen + hdrlen ||
+          iob_clone_partial(iob, len, hdrlen + offset, seg, hdrlen,
+                            false, false) != OK)
+        {
+          iob_free_chain(seg);
+          break;
+        }
 
-  upper->lower = dev;
-  dev->netdev.d_private = upper;
+      tcp = (FAR struct tcp_hdr_s *)(IOB_DATA(seg) + iphdrlen);
+      tcp->seqno[0] = (seqno + offset) >> 24;
+      tcp->seqno[1] = (seqno + offset) >> 16;
+      tcp->seqno[2] = (seqno + offset) >> 8;
+      tcp->seqno[3] = seqno + offset;
 
-  return upper;
-}
+      /* Only the last segment keeps PSH and FIN */
 
-/****************************************************************************
- * Name: netdev_upper_can_tx
- *
- * Description:
- *   Check if we allow tx on this device.
- *
- * Assumptions:
- *   Called with the network locked.
- *
- ****************************************************************************/
+      if (offset + len < payload)
+        {
+          tcp->flags = flags & ~(TCP_PSH | TCP_FIN);
+        }
 
-static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
-{
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  int quota = netdev_lower_quota_load(lower, NETPKT_TX);
+      netdev_upper_tcpfix(seg, iphdrlen, nseg, true);
+
+      if (iob_tryadd_queue(seg, &upper->txq) < 0)
+        {
+          iob_free_chain(seg);
+          break;
+        }
+    }
 
-  if (quota <= 0 && lower->ops->reclaim)
+  if (nseg == 0)
     {
-      lower->ops->reclaim(lower);
-      quota = netdev_lower_quota_load(lower, NETPKT_TX);
+      return -ENOMEM;
     }
 
-  return quota > 0;
+  if (offset < payload)
+    {
+      /* TCP will retransmit what could not be queued */
+
+      nwarn("WARNING: GSO dropped %u of %u bytes\n",
+            payload - offset, payload);
+    }
+
+  netdev_iob_release(dev);
+  dev->d_len = 0;
+  return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_txpoll
@@ -272,9 +1012,33 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
   int                            ret;
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t                       gso_size = dev->d_gso_size;
+#endif
 
   DEBUGASSERT(dev->d_len > 0);
 
+#ifdef CONFIG_NETDEV_GSO
+  /* d_gso_size may be left over if the TCP packet was replaced, e.g. by
+   * an ARP request, so only trust it for a packet that needs it.
+   */
+
+  dev->d_gso_size = 0;
+  if (gso_size > 0 && dev->d_len > NETDEV_PKTSIZE(dev))
+    {
+      if (dev->d_len <= lower->tso_max)
+        {
+          lower->gso_size = gso_size;
+        }
+      else if (netdev_upper_gso(dev, gso_size) == OK)
+        {
+          /* Continue with the first segment */
+
+          netdev_iob_replace_l2(dev, iob_remove_queue(&upper->txq));
+        }
+    }
+#endif
+
   NETDEV_TXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
@@ -285,16 +1049,50 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev)
+#ifdef CONFIG_NETDEV_GSO
+      && lower->gso_size == 0
+#endif
+     )
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
+#ifdef CONFIG_NETDEV_WMM
+  else if (dev->d_lltype == NET_LL_IEEE80211 &&
+           NETDEV_GSO_SIZE(lower) == 0 &&
+           iob_tryadd_queue(pkt, netdev_upper_wmm_queue(upper, pkt)) >= 0)
+    {
+      /* Sent by netdev_upper_wmm_send() at the end of the poll */
+
+      return NETDEV_TX_CONTINUE;
+    }
+#endif
+#if CONFIG_NETDEV_TX_BATCH > 0
+  else if (lower->ops->transmit_batch != NULL &&
+           NETDEV_GSO_SIZE(lower) == 0)
+    {
+      netdev_upper_batch(upper, pkt);
+      return NETDEV_TX_CONTINUE;
+    }
+#endif
   else
     {
-      ret = lower->ops->transmit(lower, pkt);
+#ifdef CONFIG_NETDEV_WMM
+      lower->tx_ac = NETDEV_AC_BE;
+#endif
+#if CONFIG_NETDEV_TX_BATCH > 0
+      /* Keep the order with the packets collected so far */
+
+      netdev_upper_flush(upper);
+#endif
+      ret = netdev_upper_transmit(upper, pkt);
     }
 
+#ifdef CONFIG_NETDEV_GSO
+  lower->gso_size = 0;
+#endif
+
   if (ret != OK)
     {
       /* Stop polling on any error
@@ -302,10 +1100,12 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
        */
 
       NETDEV_TXERRORS(dev);
+      NETDEV_QUEUE_STATS(upper, errors, NETPKT_TX);
       netpkt_put(dev, pkt, NETPKT_TX);
       return ret;
     }
 
+  NETDEV_QUEUE_STATS(upper, packets, NETPKT_TX);
   return NETDEV_TX_CONTINUE;
 }
 
@@ -373,6 +1173,13 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
       while (netdev_upper_can_tx(upper) &&
              netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
     }
+
+#ifdef CONFIG_NETDEV_WMM
+  netdev_upper_wmm_send(upper);
+#endif
+#if CONFIG_NETDEV_TX_BATCH > 0
+  netdev_upper_flush(upper);
+#endif
 }
 
 /****************************************************************************
@@ -397,6 +1204,23 @@ static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   int ret;
 
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t gso_size = dev->d_gso_size;
+
+  /* Replies are always segmented here, the queue keeps no segment size */
+
+  dev->d_gso_size = 0;
+  if (gso_size > 0 && dev->d_len > NETDEV_PKTSIZE(dev) &&
+      netdev_upper_gso(dev, gso_size) == OK)
+    {
+      return;
+    }
+#endif
+
+  /* The queue keeps no checksum state either */
+
+  netdev_chksum_complete(dev);
+
   if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
     {
       netdev_iob_clear(dev);
@@ -565,14 +1389,332 @@ static void ip_input(FAR struct net_driver_s *dev)
    * the field d_len will set to a value > 0.
    */
 
-  if (dev->d_len > 0)
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass one received packet to the network stack.
+ *
+ * Input Parameters:
+ *   dev    - Reference to the NuttX driver state structure
+ *   pkt    - The received packet
+ *   chksum - The NETDEV_CHKSUM_* flags the driver reported for it
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct net_driver_s *dev,
+                               FAR netpkt_t *pkt, uint8_t chksum)
+{
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXCHKSUM_SET(dev, chksum);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_match
+ *
+ * Description:
+ *   Check that two TCP segments belong to the same flow and can be merged:
+ *   all header fields but the lengths, IPv4 ID, checksums, sequence number,
+ *   flags and window must be equal.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static bool netdev_upper_gro_match(FAR const uint8_t *a,
+                                   FAR const uint8_t *b,
+                                   unsigned int iphdrlen,
+                                   unsigned int hdrlen)
+{
+  FAR const struct tcp_hdr_s *ta =
+    (FAR const struct tcp_hdr_s *)(a + iphdrlen);
+  FAR const struct tcp_hdr_s *tb =
+    (FAR const struct tcp_hdr_s *)(b + iphdrlen);
+
+  if (memcmp(a - ETH_HDRLEN, b - ETH_HDRLEN, ETH_HDRLEN) != 0 ||
+      a[0] != b[0])
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((a[0] >> 4) == 4)
+    {
+      FAR const struct ipv4_hdr_s *ia = (FAR const struct ipv4_hdr_s *)a;
+      FAR const struct ipv4_hdr_s *ib = (FAR const struct ipv4_hdr_s *)b;
+
+      if (ia->tos != ib->tos || ia->ttl != ib->ttl ||
+          memcmp(ia->ipoffset, ib->ipoffset, 2) != 0 ||
+          memcmp(ia->srcipaddr, ib->srcipaddr, 2 * sizeof(in_addr_t)) != 0)
+        {
+          return false;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((a[0] >> 4) == 6)
+    {
+      FAR const struct ipv6_hdr_s *ia = (FAR const struct ipv6_hdr_s *)a;
+      FAR const struct ipv6_hdr_s *ib = (FAR const struct ipv6_hdr_s *)b;
+
+      if (ia->vtc != ib->vtc || ia->tcf != ib->tcf ||
+          ia->flow != ib->flow || ia->ttl != ib->ttl ||
+          memcmp(ia->srcipaddr, ib->srcipaddr,
+                 2 * sizeof(net_ipv6addr_t)) != 0)
+        {
+          return false;
+        }
+    }
+#endif
+
+  return ta->srcport == tb->srcport && ta->destport == tb->destport &&
+         ta->tcpoffset == tb->tcpoffset &&
+         memcmp(ta->ackno, tb->ackno, 4) == 0 &&
+         memcmp(ta->urgp, tb->urgp,
+                hdrlen - iphdrlen - offsetof(struct tcp_hdr_s, urgp)) == 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_verify
+ *
+ * Description:
+ *   Verify the checksums of a segment before it is merged, the network
+ *   stack only sees the checksums recomputed over the merged packet.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_verify(FAR netpkt_t *pkt, unsigned int iphdrlen)
+{
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+  if ((IOB_DATA(pkt)[0] >> 4) == 4 &&
+      ipv4_chksum((FAR struct ipv4_hdr_s *)IOB_DATA(pkt)) != 0xffff)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  if (netdev_upper_tcpsum(pkt, iphdrlen) != 0xffff)
+    {
+      return false;
+    }
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Hand the packet held for receive offload to the network stack, with
+ *   its headers rewritten if segments were merged into it.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *   gro - The receive offload state of the current poll
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_flush(FAR struct net_driver_s *dev,
+                                   FAR struct netdev_gro_s *gro)
+{
+  FAR netpkt_t *pkt = gro->pkt;
+
+  if (pkt == NULL)
+    {
+      return;
+    }
+
+  if (gro->nseg > 1)
+    {
+      netdev_upper_tcpfix(pkt, gro->iphdrlen, 0,
+                          (gro->chksum & NETDEV_CHKSUM_VERIFIED) == 0);
+    }
+
+  gro->pkt  = NULL;
+  gro->nseg = 0;
+  netdev_upper_input(dev, pkt, gro->chksum);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro
+ *
+ * Description:
+ *   Try to merge a received frame into the packet held for receive
+ *   offload.  Only Ethernet frames carrying a plain ACK segment with data
+ *   are candidates; a candidate that does not continue the held packet
+ *   replaces it, anything else flushes it.
+ *
+ * Input Parameters:
+ *   dev    - Reference to the NuttX driver state structure
+ *   gro    - The receive offload state of the current poll
+ *   pkt    - The received frame
+ *   chksum - The NETDEV_CHKSUM_* flags the driver reported for it
+ *
+ * Returned Value:
+ *   true if the frame was merged or is now held, false if the caller
+ *   still has to pass it to the network stack.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro(FAR struct net_driver_s *dev,
+                             FAR struct netdev_gro_s *gro,
+                             FAR netpkt_t *pkt, uint8_t chksum)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *htcp;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+  unsigned int iplen = 0;
+  uint32_t seqno;
+
+  if (dev->d_lltype != NET_LL_ETHERNET ||
+      (iphdrlen = netdev_upper_tcphdr(pkt)) == 0)
+    {
+      netdev_upper_gro_flush(dev, gro);
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] >> 4) == 4)
+    {
+      iplen = ((unsigned int)ip[2] << 8) + ip[3];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      iplen = ((unsigned int)ip[4] << 8) + ip[5] + IPv6_HDRLEN;
+    }
+#endif
+
+  tcp    = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+  hdrlen = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  seqno  = ((uint32_t)tcp->seqno[0] << 24) |
+           ((uint32_t)tcp->seqno[1] << 16) |
+           ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+
+  /* The IP packet must fill the frame exactly (no Ethernet padding) and
+   * the segment must carry data and no other flag than ACK and PSH.
+   */
+
+  if (iplen != pkt->io_pktlen || iplen <= hdrlen ||
+      (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      netdev_upper_gro_flush(dev, gro);
+      return false;
+    }
+
+  if (gro->pkt != NULL && gro->seqno == seqno && gro->hdrlen == hdrlen &&
+      gro->iphdrlen == iphdrlen &&
+      gro->pkt->io_pktlen + iplen - hdrlen <= CONFIG_NETDEV_GRO_MAXSIZE &&
+      netdev_upper_gro_match(IOB_DATA(gro->pkt), ip, iphdrlen, hdrlen))
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
+      htcp = (FAR struct tcp_hdr_s *)(IOB_DATA(gro->pkt) + iphdrlen);
+
+      /* A PSH ends the merge, and a bad segment goes to the stack as is to
+       * be dropped and counted there.  Segments the driver verified need
+       * no check, the merged packet stays verified if all of them were.
        */
 
-      netdev_upper_queue_tx(dev);
+      if ((htcp->flags & TCP_PSH) == 0 &&
+          ((chksum & NETDEV_CHKSUM_VERIFIED) != 0 ||
+           netdev_upper_gro_verify(pkt, iphdrlen)) &&
+          (gro->nseg > 1 || (gro->chksum & NETDEV_CHKSUM_VERIFIED) != 0 ||
+           netdev_upper_gro_verify(gro->pkt, iphdrlen)))
+        {
+          htcp->flags |= tcp->flags & TCP_PSH;
+          memcpy(htcp->wnd, tcp->wnd, sizeof(tcp->wnd));
+
+          /* Append the payload, the frame no longer counts against the
+           * driver's RX quota.
+           */
+
+          iob_concat(gro->pkt, iob_trimhead(pkt, hdrlen));
+          atomic_fetch_add(netdev_upper_quota(upper->lower,
+                                              NETDEV_QUEUE(upper),
+                                              NETPKT_RX), 1);
+
+          gro->seqno  += iplen - hdrlen;
+          gro->chksum &= chksum;
+          gro->nseg++;
+          return true;
+        }
     }
+
+  /* Hold the segment in the hope that the next one continues it */
+
+  netdev_upper_gro_flush(dev, gro);
+
+  gro->pkt      = pkt;
+  gro->nseg     = 1;
+  gro->chksum   = chksum;
+  gro->iphdrlen = iphdrlen;
+  gro->hdrlen   = hdrlen;
+  gro->seqno    = seqno + iplen - hdrlen;
+  return true;
 }
 #endif
 
@@ -586,70 +1728,122 @@ static void ip_input(FAR struct net_driver_s *dev)
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
  *
+ * Returned Value:
+ *   True if CONFIG_NETDEV_RX_BUDGET packets were received, the device may
+ *   have more; false if the device has no more packets.
+ *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
   FAR netpkt_t                  *pkt;
+  uint8_t                        chksum;
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  int                            budget = CONFIG_NETDEV_RX_BUDGET;
+#endif
+#ifdef CONFIG_NETDEV_GRO
+  struct netdev_gro_s            gro;
+
+  memset(&gro, 0, sizeof(gro));
+#endif
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  for (; ; )
     {
+#if CONFIG_NETDEV_RX_BUDGET > 0
+      if (budget-- <= 0)
+        {
+          break;
+        }
+#endif
+
+      NETDEV_RXCHKSUM_SET(dev, 0);
+
+      pkt = netdev_upper_receive(upper);
+      if (pkt == NULL)
+        {
+          break;
+        }
+
+      chksum = NETDEV_RXCHKSUM_GET(dev);
+
       if (!IFF_IS_UP(dev->d_flags))
         {
           /* Interface down, drop frame */
 
           NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
+          NETDEV_QUEUE_STATS(upper, errors, NETPKT_RX);
+          netpkt_qfree(lower, NETDEV_QUEUE(upper), pkt, NETPKT_RX);
           continue;
         }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
       NETDEV_RXPACKETS(dev);
+      NETDEV_QUEUE_STATS(upper, packets, NETPKT_RX);
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
-
-      pkt_input(dev);
-#endif
-
-      switch (dev->d_lltype)
+#ifdef CONFIG_NETDEV_GRO
+      if (netdev_upper_gro(dev, &gro, pkt, chksum))
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
+          continue;
+        }
 #endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
+
+      netdev_upper_input(dev, pkt, chksum);
+    }
+
+#ifdef CONFIG_NETDEV_GRO
+  /* Deliver what is still held before the RX poll ends */
+
+  netdev_upper_gro_flush(dev, &gro);
 #endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  return budget < 0;
+#else
+  return false;
 #endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_poll
+ *
+ * Description:
+ *   Perform an out-of-cycle poll of one queue pair.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   queue - The queue pair, 0 for a device without queue pairs
+ *
+ ****************************************************************************/
+
+static void netdev_upper_poll(FAR struct netdev_upperhalf_s *upper,
+                              int queue)
+{
+  bool more;
+
+  /* RX may release quota and driver buffer, so do RX first. */
+
+  net_lock();
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  upper->queue = queue;
 #endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
-        }
+  more = netdev_upper_rxpoll_work(upper);
+  netdev_upper_rxfill(upper);
+  netdev_upper_txavail_work(upper);
+  net_unlock();
+
+  /* The RX budget ran out.  The driver keeps its RX interrupt masked until
+   * receive() returns NULL, so poll again rather than wait for it.
+   */
+
+  if (more)
+    {
+      netdev_upper_queue_work(&upper->lower->netdev, queue);
     }
 }
 
@@ -657,24 +1851,46 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
  * Name: netdev_upper_work
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Perform an out-of-cycle poll on the worker thread.
  *
  * Input Parameters:
  *   arg - Reference to the upper half driver structure (cast to void *)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NETDEV_WORK_THREAD
 static void netdev_upper_work(FAR void *arg)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
+  netdev_upper_poll(arg, 0);
+}
+#endif
 
-  /* RX may release quota and driver buffer, so do RX first. */
+/****************************************************************************
+ * Name: netdev_upper_busypoll
+ *
+ * Description:
+ *   Run the poll of the work thread in the context of a receiving socket,
+ *   for SO_BUSY_POLL.  The network lock serializes it with the thread.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ ****************************************************************************/
 
-  net_lock();
-  netdev_upper_rxpoll_work(upper);
-  netdev_upper_txavail_work(upper);
-  net_unlock();
+#ifdef CONFIG_NET_BUSY_POLL
+static int netdev_upper_busypoll(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int queue;
+
+  for (queue = 0; queue < NETDEV_NQUEUES(upper->lower); queue++)
+    {
+      netdev_upper_poll(upper, queue);
+    }
+
+  return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_wait
@@ -697,11 +1913,63 @@ static int netdev_upper_wait(FAR sem_t *sem)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_upper_nthreads
+ *
+ * Description:
+ *   Get the number of dedicated threads of the device: one for each queue
+ *   pair, or one for each CPU with RSS.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_nthreads(FAR struct netdev_upperhalf_s *upper)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->lower->nqueues > 0)
+    {
+      return upper->lower->nqueues;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_RSS
+  return CONFIG_SMP_NCPUS;
+#else
+  return 1;
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_upper_thread
+ *
+ * Description:
+ *   Get the dedicated thread that services the queue pair 'queue'.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_thread(FAR struct netdev_upperhalf_s *upper,
+                               int queue)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->lower->nqueues > 0)
+    {
+      DEBUGASSERT(queue >= 0 && queue < upper->lower->nqueues);
+      return queue;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_RSS
+  return this_cpu();
+#else
+  return 0;
+#endif
+}
+
 /****************************************************************************
  * Name: netdev_upper_loop
  *
  * Description:
- *   The loop for dedicated thread.
+ *   The loop for dedicated thread.  Thread n runs on CPU n and services
+ *   queue pair n if the device has queue pairs.
  *
  ****************************************************************************/
 
@@ -710,19 +1978,25 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
   FAR struct netdev_upperhalf_s *upper =
     (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
   int cpu = atoi(argv[2]);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int queue = upper->lower->nqueues > 0 ? cpu : 0;
+#else
+  const int queue = 0;
+#endif
 
-#ifdef CONFIG_NETDEV_RSS
+#if defined(CONFIG_NETDEV_RSS) || \
+    (defined(CONFIG_NETDEV_MULTIQUEUE) && defined(CONFIG_SMP))
   cpu_set_t cpuset;
 
   CPU_ZERO(&cpuset);
-  CPU_SET(cpu, &cpuset);
+  CPU_SET(cpu % CONFIG_SMP_NCPUS, &cpuset);
   sched_setaffinity(upper->tid[cpu], sizeof(cpu_set_t), &cpuset);
 #endif
 
   while (netdev_upper_wait(&upper->sem[cpu]) == OK &&
          upper->tid[cpu] != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      netdev_upper_poll(upper, queue);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -738,20 +2012,18 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
  *   Called when there is any work to do.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   dev   - Reference to the NuttX driver state structure
+ *   queue - The queue pair with work to do
  *
  ****************************************************************************/
 
-static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev,
+                                           int queue)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-#  ifdef CONFIG_NETDEV_RSS
-  int cpu = this_cpu();
-#  else
-  const int cpu = 0;
-#  endif
+  int cpu = netdev_upper_thread(upper, queue);
   int semcount;
 
   if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
@@ -782,7 +2054,15 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
 
 static int netdev_upper_txavail(FAR struct net_driver_s *dev)
 {
-  netdev_upper_queue_work(dev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+  /* Send on the TX queue of the calling CPU */
+
+  netdev_upper_queue_work(dev, upper->xps[this_cpu()]);
+#else
+  netdev_upper_queue_work(dev, 0);
+#endif
   return OK;
 }
 
@@ -1046,7 +2326,7 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   /* Try to bring up a dedicated thread for work. */
 
-  for (i = 0; i < NETDEV_THREAD_COUNT; i++)
+  for (i = 0; i < netdev_upper_nthreads(upper); i++)
     {
       if (upper->tid[i] <= 0)
         {
@@ -1079,7 +2359,23 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifup)
     {
-      return upper->lower->ops->ifup(upper->lower);
+      int ret = upper->lower->ops->ifup(upper->lower);
+
+      /* The RX packets are loaned to the driver on the first poll, which
+       * runs once IFF_UP is set.
+       */
+
+      if (ret >= 0 && upper->lower->ops->rxfill != NULL)
+        {
+          int queue;
+
+          for (queue = 0; queue < NETDEV_NQUEUES(upper->lower); queue++)
+            {
+              netdev_upper_queue_work(dev, queue);
+            }
+        }
+
+      return ret;
     }
 
   return -ENOSYS;
@@ -1093,6 +2389,10 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
   work_cancel(NETDEV_WORK, &upper->work);
 #endif
 
+#ifdef CONFIG_NETDEV_WMM
+  netdev_upper_wmm_free(upper);
+#endif
+
   if (upper->lower->ops->ifdown)
     {
       return upper->lower->ops->ifdown(upper->lower);
@@ -1188,8 +2488,8 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   int i;
 #endif
 
-  if (dev == NULL || quota_is_valid(dev) == false || dev->ops == NULL ||
-      dev->ops->transmit == NULL || dev->ops->receive == NULL)
+  if (dev == NULL || ops_is_valid(dev) == false ||
+      quota_is_valid(dev) == false)
     {
       return -EINVAL;
     }
@@ -1208,8 +2508,20 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 #endif
 #ifdef CONFIG_NETDEV_IOCTL
   dev->netdev.d_ioctl   = netdev_upper_ioctl;
+#endif
+#ifdef CONFIG_NET_BUSY_POLL
+  dev->netdev.d_busypoll = netdev_upper_busypoll;
 #endif
   dev->netdev.d_private = upper;
+#ifdef CONFIG_NETDEV_GSO
+  dev->netdev.d_gso_max = CONFIG_NETDEV_GSO_MAXSIZE;
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      upper->xps[i] = i % NETDEV_NQUEUES(dev);
+    }
+#endif
 
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
@@ -1338,9 +2650,7 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
-#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
-  netdev_upper_queue_work(&dev->netdev);
-#endif
+  netdev_lower_rxready_queue(dev, 0);
 }
 
 /****************************************************************************
@@ -1355,18 +2665,95 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
  ****************************************************************************/
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
+{
+  netdev_lower_txdone_queue(dev, 0);
+}
+
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   the queue pair 'queue'.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_queue_work(&dev->netdev, queue);
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on the queue
+ *   pair 'queue'.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue)
 {
   NETDEV_TXDONE(&dev->netdev);
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
-  netdev_upper_queue_work(&dev->netdev);
+  netdev_upper_queue_work(&dev->netdev, queue);
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_set_xps
+ *
+ * Description:
+ *   Select the TX queue used for the packets the network stack sends from
+ *   'cpu'.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure, already registered
+ *   cpu   - The CPU
+ *   queue - The TX queue
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+int netdev_lower_set_xps(FAR struct netdev_lowerhalf_s *dev, int cpu,
+                         int queue)
+{
+  FAR struct netdev_upperhalf_s *upper;
+
+  if (dev == NULL || dev->netdev.d_private == NULL ||
+      cpu < 0 || cpu >= CONFIG_SMP_NCPUS ||
+      queue < 0 || queue >= NETDEV_NQUEUES(dev))
+    {
+      return -EINVAL;
+    }
+
+  upper = (FAR struct netdev_upperhalf_s *)dev->netdev.d_private;
+  upper->xps[cpu] = queue;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
  * Description:
- *   Fetch the quota, works like atomic_load.
+ *   Fetch the quota, works like atomic_load.  The quota of a device with
+ *   queue pairs is the sum of the quota of its queues.
  *
  * Input Parameters:
  *   dev  - The lower half device driver structure
@@ -1377,9 +2764,43 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 int netdev_lower_quota_load(FAR struct netdev_lowerhalf_s *dev,
                             enum netpkt_type_e type)
 {
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int quota = 0;
+  int i;
+
+  if (dev->nqueues > 0)
+    {
+      for (i = 0; i < dev->nqueues; i++)
+        {
+          quota += atomic_load(&dev->queues[i].quota[type]);
+        }
+
+      return quota;
+    }
+#endif
+
   return atomic_load(&dev->quota[type]);
 }
 
+/****************************************************************************
+ * Name: netdev_lower_quota_load_queue
+ *
+ * Description:
+ *   Fetch the quota of one queue pair.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *   type  - Whether get quota for TX or RX
+ *
+ ****************************************************************************/
+
+int netdev_lower_quota_load_queue(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue, enum netpkt_type_e type)
+{
+  return atomic_load(netdev_upper_quota(dev, queue, type));
+}
+
 /****************************************************************************
  * Name: netpkt_alloc
  *
@@ -1398,18 +2819,41 @@ int netdev_lower_quota_load(FAR struct netdev_lowerhalf_s *dev,
 FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
                            enum netpkt_type_e type)
 {
+  return netpkt_qalloc(dev, 0, type);
+}
+
+/****************************************************************************
+ * Name: netpkt_qalloc
+ *
+ * Description:
+ *   Allocate a netpkt structure for the queue pair 'queue'.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *   type  - Whether used for TX or RX
+ *
+ * Returned Value:
+ *   Pointer to the packet, NULL on failure
+ *
+ ****************************************************************************/
+
+FAR netpkt_t *netpkt_qalloc(FAR struct netdev_lowerhalf_s *dev, int queue,
+                            enum netpkt_type_e type)
+{
+  FAR atomic_int *quota = netdev_upper_quota(dev, queue, type);
   FAR netpkt_t *pkt;
 
-  if (atomic_fetch_sub(&dev->quota[type], 1) <= 0)
+  if (atomic_fetch_sub(quota, 1) <= 0)
     {
-      atomic_fetch_add(&dev->quota[type], 1);
+      atomic_fetch_add(quota, 1);
       return NULL;
     }
 
   pkt = iob_tryalloc(false);
   if (pkt == NULL)
     {
-      atomic_fetch_add(&dev->quota[type], 1);
+      atomic_fetch_add(quota, 1);
       return NULL;
     }
 
@@ -1433,7 +2877,27 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
 void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                  enum netpkt_type_e type)
 {
-  atomic_fetch_add(&dev->quota[type], 1);
+  netpkt_qfree(dev, 0, pkt, type);
+}
+
+/****************************************************************************
+ * Name: netpkt_qfree
+ *
+ * Description:
+ *   Release a netpkt structure of the queue pair 'queue'.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *   pkt   - The packet to release
+ *   type  - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+void netpkt_qfree(FAR struct netdev_lowerhalf_s *dev, int queue,
+                  FAR netpkt_t *pkt, enum netpkt_type_e type)
+{
+  atomic_fetch_add(netdev_upper_quota(dev, queue, type), 1);
   iob_free_chain(pkt);
 }
 
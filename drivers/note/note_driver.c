@@ -32,6 +32,7 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <fnmatch.h>
 #include <time.h>
 
 #include <nuttx/irq.h>
@@ -175,6 +176,19 @@ static struct note_taskname_s g_note_taskname;
 static spinlock_t g_note_lock;
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT
+
+/* Tracepoints register themselves when they are first reached, the rules
+ * decide the state of the ones reached later on.
+ */
+
+static FAR struct note_tracepoint_s *g_note_tracepoints;
+static struct note_filter_tracepoint_s
+  g_note_tracepoint_rules[CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT_NRULES];
+static unsigned int g_note_tracepoint_nrules;
+static spinlock_t g_note_tracepoint_lock;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -1809,6 +1823,193 @@ void sched_note_printf_ip(uint32_t tag, uintptr_t ip, FAR const char *fmt,
 
 #endif /* CONFIG_SCHED_INSTRUMENTATION_DUMP */
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT
+
+/****************************************************************************
+ * Name: note_tracepoint_match
+ *
+ * Description:
+ *   Return true if the tracepoint matches the module and name patterns of
+ *   a rule.  An empty pattern matches everything.
+ *
+ ****************************************************************************/
+
+static bool
+note_tracepoint_match(FAR const struct note_tracepoint_s *tp,
+                      FAR const struct note_filter_tracepoint_s *rule)
+{
+  return (rule->module[0] == '\0' ||
+          fnmatch(rule->module, tp->module, 0) == 0) &&
+         (rule->name[0] == '\0' ||
+          fnmatch(rule->name, tp->name, 0) == 0);
+}
+
+/****************************************************************************
+ * Name: note_tracepoint_state
+ *
+ * Description:
+ *   Return the state the rules assign to a tracepoint, the last matching
+ *   rule wins.  Must be called with g_note_tracepoint_lock held.
+ *
+ ****************************************************************************/
+
+static uint8_t note_tracepoint_state(FAR const struct note_tracepoint_s *tp)
+{
+  uint8_t state = NOTE_TRACEPOINT_OFF;
+  unsigned int i;
+
+  for (i = 0; i < g_note_tracepoint_nrules; i++)
+    {
+      if (note_tracepoint_match(tp, &g_note_tracepoint_rules[i]))
+        {
+          state = g_note_tracepoint_rules[i].enable ?
+                  NOTE_TRACEPOINT_ON : NOTE_TRACEPOINT_OFF;
+        }
+    }
+
+  return state;
+}
+
+/****************************************************************************
+ * Name: sched_note_tracepoint_ip
+ *
+ * Description:
+ *   Slow path of sched_note_tracepoint_begin/end(), only reached while the
+ *   tracepoint is enabled or before it has been registered.
+ *
+ ****************************************************************************/
+
+void sched_note_tracepoint_ip(FAR struct note_tracepoint_s *tp,
+                              uintptr_t ip, uint8_t event)
+{
+  irqstate_t flags;
+
+  if (tp->state == NOTE_TRACEPOINT_NEW)
+    {
+      flags = spin_lock_irqsave_wo_note(&g_note_tracepoint_lock);
+      if (tp->state == NOTE_TRACEPOINT_NEW)
+        {
+          tp->next = g_note_tracepoints;
+          g_note_tracepoints = tp;
+          tp->state = note_tracepoint_state(tp);
+        }
+
+      spin_unlock_irqrestore_wo_note(&g_note_tracepoint_lock, flags);
+    }
+
+  if (tp->state == NOTE_TRACEPOINT_ON)
+    {
+      sched_note_event_ip(NOTE_TAG_ALWAYS, ip, event,
+                          tp->name, strlen(tp->name));
+    }
+}
+
+/****************************************************************************
+ * Name: sched_note_filter_tracepoint
+ *
+ * Description:
+ *   Get a registered tracepoint or add an enable rule.
+ *   (Same as NOTECTL_GETTRACEPOINT / NOTECTL_SETTRACEPOINT ioctls)
+ *
+ * Input Parameters:
+ *   oldf - If not NULL, oldf->index selects the registered tracepoint
+ *          whose module, name and state are returned.
+ *   newf - If not NULL, a rule that enables or disables every tracepoint
+ *          whose module and name match the glob patterns, including the
+ *          ones not reached yet.  A rule with the same patterns as an
+ *          existing one replaces it, a rule matching everything replaces
+ *          all of them.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if oldf->index is out of range, -ENOSPC if
+ *   the rule table is full.
+ *
+ ****************************************************************************/
+
+int sched_note_filter_tracepoint(FAR struct note_filter_tracepoint_s *oldf,
+                                 FAR const struct note_filter_tracepoint_s
+                                 *newf)
+{
+  FAR struct note_tracepoint_s *tp;
+  irqstate_t flags;
+  unsigned int i;
+  int ret = OK;
+
+  flags = spin_lock_irqsave_wo_note(&g_note_tracepoint_lock);
+
+  if (oldf != NULL)
+    {
+      tp = g_note_tracepoints;
+      for (i = 0; tp != NULL && i < oldf->index; i++)
+        {
+          tp = tp->next;
+        }
+
+      if (tp == NULL)
+        {
+          ret = -ENOENT;
+          goto out;
+        }
+
+      strlcpy(oldf->module, tp->module, sizeof(oldf->module));
+      strlcpy(oldf->name, tp->name, sizeof(oldf->name));
+      oldf->enable = tp->state == NOTE_TRACEPOINT_ON;
+    }
+
+  if (newf != NULL)
+    {
+      if ((newf->module[0] == '\0' || strcmp(newf->module, "*") == 0) &&
+          (newf->name[0] == '\0' || strcmp(newf->name, "*") == 0))
+        {
+          g_note_tracepoint_nrules = 0;
+        }
+
+      for (i = 0; i < g_note_tracepoint_nrules; i++)
+        {
+          if (strcmp(g_note_tracepoint_rules[i].module,
+                     newf->module) == 0 &&
+              strcmp(g_note_tracepoint_rules[i].name, newf->name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (i < g_note_tracepoint_nrules)
+        {
+          /* Move the rule to the end so that it takes precedence */
+
+          memmove(&g_note_tracepoint_rules[i],
+                  &g_note_tracepoint_rules[i + 1],
+                  (g_note_tracepoint_nrules - i - 1) *
+                  sizeof(struct note_filter_tracepoint_s));
+          g_note_tracepoint_nrules--;
+        }
+      else if (g_note_tracepoint_nrules ==
+               CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT_NRULES)
+        {
+          ret = -ENOSPC;
+          goto out;
+        }
+
+      g_note_tracepoint_rules[g_note_tracepoint_nrules++] = *newf;
+
+      for (tp = g_note_tracepoints; tp != NULL; tp = tp->next)
+        {
+          if (note_tracepoint_match(tp, newf))
+            {
+              tp->state = newf->enable ?
+                          NOTE_TRACEPOINT_ON : NOTE_TRACEPOINT_OFF;
+            }
+        }
+    }
+
+out:
+  spin_unlock_irqrestore_wo_note(&g_note_tracepoint_lock, flags);
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT */
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
 
 /****************************************************************************
@@ -209,6 +209,52 @@ static int notectl_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT
+      /* NOTECTL_GETTRACEPOINT
+       *      - Get the registered tracepoint selected by 'index'
+       *        Argument: A writable pointer to struct
+       *                  note_filter_tracepoint_s
+       */
+
+      case NOTECTL_GETTRACEPOINT:
+        {
+          FAR struct note_filter_tracepoint_s *filter;
+          filter = (FAR struct note_filter_tracepoint_s *)arg;
+
+          if (filter == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = sched_note_filter_tracepoint(filter, NULL);
+            }
+        }
+        break;
+
+      /* NOTECTL_SETTRACEPOINT
+       *      - Enable or disable the matching tracepoints
+       *        Argument: A read-only pointer to struct
+       *                  note_filter_tracepoint_s
+       */
+
+      case NOTECTL_SETTRACEPOINT:
+        {
+          FAR struct note_filter_tracepoint_s *filter;
+          filter = (FAR struct note_filter_tracepoint_s *)arg;
+
+          if (filter == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = sched_note_filter_tracepoint(NULL, filter);
+            }
+        }
+        break;
+#endif
+
       default:
           break;
     }
@@ -34,8 +34,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <poll.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
@@ -72,20 +74,48 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+/* The number of circular buffers the note memory is split into */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_NRINGS NCPUS
+#else
+#  define NOTERAM_NRINGS 1
+#endif
+
+/* The ring positions wrap at the largest multiple of the ring size that
+ * leaves half of the unsigned range to tell "ahead" from "behind".
+ */
+
+#define NOTERAM_LIMIT(size) ((size) * ((UINT_MAX / 2) / (size)))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One circular buffer.  Each one has a single writer: with
+ * CONFIG_DRIVERS_NOTERAM_PERCPU every CPU adds to its own ring with only
+ * the local interrupts disabled, otherwise the writers are serialized by
+ * the driver lock.  The reader never blocks the writer.
+ */
+
+struct noteram_ring_s
+{
+  volatile unsigned int head;   /* Next position written, writer owned */
+  volatile unsigned int tail;   /* Oldest note kept, writer owned */
+  volatile unsigned int read;   /* Next note to read, reader owned */
+  volatile unsigned int base;   /* Cleared up to here, reader owned */
+  volatile bool overflow;       /* Full in the no overwrite mode */
+};
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
-  FAR uint8_t *ni_buffer;
-  size_t ni_bufsize;
+  FAR uint8_t *ni_buffer;       /* NOTERAM_NRINGS consecutive rings */
+  size_t ni_bufsize;            /* Size of one ring */
+  unsigned int ni_limit;        /* Positions wrap at this ring multiple */
   unsigned int ni_overwrite;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
-  spinlock_t lock;
+  struct noteram_ring_s ni_ring[NOTERAM_NRINGS];
+  spinlock_t lock;              /* Serializes the readers (and writers) */
   FAR struct pollfd *pfd;
 };
 
@@ -175,7 +205,8 @@ struct noteram_driver_s g_noteram_driver =
     &g_noteram_ops
   },
   g_ramnote_buffer,
-  CONFIG_DRIVERS_NOTERAM_BUFSIZE,
+  CONFIG_DRIVERS_NOTERAM_BUFSIZE / NOTERAM_NRINGS,
+  NOTERAM_LIMIT(CONFIG_DRIVERS_NOTERAM_BUFSIZE / NOTERAM_NRINGS),
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
   NOTERAM_MODE_OVERWRITE_DISABLE
 #else
@@ -188,163 +219,235 @@ struct noteram_driver_s g_noteram_driver =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: noteram_buffer_clear
+ * Name: noteram_adv
  *
  * Description:
- *   Clear all contents of the circular buffer.
+ *   Advance a position of a ring.  Positions run from 0 to ni_limit, a
+ *   multiple of the ring size, so that a reader lapped by a writer can
+ *   still tell how far behind it is.
  *
- * Input Parameters:
- *   None.
+ ****************************************************************************/
+
+static inline unsigned int noteram_adv(FAR struct noteram_driver_s *drv,
+                                       unsigned int pos, unsigned int offset)
+{
+  pos += offset;
+  if (pos >= drv->ni_limit)
+    {
+      pos -= drv->ni_limit;
+    }
+
+  return pos;
+}
+
+/****************************************************************************
+ * Name: noteram_diff
  *
- * Returned Value:
- *   None.
+ * Description:
+ *   Return how far the position 'to' is ahead of the position 'from'.
  *
  ****************************************************************************/
 
-static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
+static inline unsigned int noteram_diff(FAR struct noteram_driver_s *drv,
+                                        unsigned int to, unsigned int from)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  return to >= from ? to - from : to + drv->ni_limit - from;
+}
 
-  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
-    {
-      drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
-    }
+/****************************************************************************
+ * Name: noteram_after
+ *
+ * Description:
+ *   Return true if the position 'a' is strictly ahead of the position 'b'.
+ *
+ ****************************************************************************/
+
+static inline bool noteram_after(FAR struct noteram_driver_s *drv,
+                                 unsigned int a, unsigned int b)
+{
+  unsigned int diff = noteram_diff(drv, a, b);
+
+  return diff != 0 && diff < drv->ni_limit / 2;
 }
 
 /****************************************************************************
- * Name: noteram_next
+ * Name: noteram_copyout
  *
  * Description:
- *   Return the circular buffer index at offset from the specified index
- *   value, handling wraparound
+ *   Copy 'len' bytes from the ring 'ndx' at position 'pos'.
  *
- * Input Parameters:
- *   ndx - Old circular buffer index
+ ****************************************************************************/
+
+static void noteram_copyout(FAR struct noteram_driver_s *drv, int ndx,
+                            unsigned int pos, FAR void *dest, size_t len)
+{
+  FAR uint8_t *ring = drv->ni_buffer + ndx * drv->ni_bufsize;
+  unsigned int off = pos % drv->ni_bufsize;
+  size_t space = drv->ni_bufsize - off;
+
+  space = space < len ? space : len;
+  memcpy(dest, ring + off, space);
+  memcpy((FAR uint8_t *)dest + space, ring, len - space);
+}
+
+/****************************************************************************
+ * Name: noteram_start
  *
- * Returned Value:
- *   New circular buffer index
+ * Description:
+ *   Return the position of the oldest note the reader may still get from
+ *   a ring: notes before it were either overwritten or cleared.
  *
  ****************************************************************************/
 
-static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
-                                        unsigned int ndx,
-                                        unsigned int offset)
+static unsigned int noteram_start(FAR struct noteram_driver_s *drv,
+                                  FAR struct noteram_ring_s *ring)
 {
-  ndx += offset;
-  if (ndx >= drv->ni_bufsize)
-    {
-      ndx -= drv->ni_bufsize;
-    }
+  unsigned int tail = ring->tail;
 
-  return ndx;
+  return noteram_after(drv, ring->base, tail) ? ring->base : tail;
 }
 
 /****************************************************************************
- * Name: noteram_length
+ * Name: noteram_buffer_clear
  *
  * Description:
- *   Length of data currently in circular buffer.
+ *   Clear all contents of the circular buffer.
  *
  * Input Parameters:
- *   None
+ *   None.
  *
  * Returned Value:
- *   Length of data currently in circular buffer.
+ *   None.
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
+static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
+  int i;
+
+  /* The writers own the tail.  Only move the reader owned base, which the
+   * writers treat as the tail from now on.
+   */
 
-  if (tail > head)
+  for (i = 0; i < NOTERAM_NRINGS; i++)
     {
-      head += drv->ni_bufsize;
+      drv->ni_ring[i].base     = drv->ni_ring[i].head;
+      drv->ni_ring[i].read     = drv->ni_ring[i].head;
+      drv->ni_ring[i].overflow = false;
     }
 
-  return head - tail;
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
+    }
 }
 
 /****************************************************************************
  * Name: noteram_unread_length
  *
  * Description:
- *   Length of unread data currently in circular buffer.
+ *   Length of unread data currently in the circular buffers.
  *
  * Input Parameters:
  *   None
  *
  * Returned Value:
- *   Length of unread data currently in circular buffer.
+ *   Length of unread data currently in the circular buffers.
  *
  ****************************************************************************/
 
 static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
+  FAR struct noteram_ring_s *ring;
+  unsigned int length = 0;
+  unsigned int read;
+  unsigned int start;
+  int i;
 
-  if (read > head)
+  for (i = 0; i < NOTERAM_NRINGS; i++)
     {
-      head += drv->ni_bufsize;
+      ring  = &drv->ni_ring[i];
+      read  = ring->read;
+      start = noteram_start(drv, ring);
+      if (noteram_after(drv, start, read))
+        {
+          read = start;
+        }
+
+      length += noteram_diff(drv, ring->head, read);
     }
 
-  return head - read;
+  return length;
 }
 
 /****************************************************************************
- * Name: noteram_remove
+ * Name: noteram_ring_get
  *
  * Description:
- *   Remove the variable length note from the tail of the circular buffer
+ *   Copy the next unread note of a ring without consuming it.  The writer
+ *   never waits for the reader, so the copy is validated afterwards: the
+ *   writer moves the tail past a note before it overwrites it.
  *
  * Input Parameters:
- *   None
+ *   ndx    - The ring
+ *   buffer - Location to return the note
+ *   buflen - The length of the buffer, the note is truncated to it
+ *   pos    - Location to return the position of the note
  *
  * Returned Value:
- *   None
- *
- * Assumptions:
- *   We are within a critical section.
+ *   The length of the note; zero if the ring is empty.
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static size_t noteram_ring_get(FAR struct noteram_driver_s *drv, int ndx,
+                               FAR uint8_t *buffer, size_t buflen,
+                               FAR unsigned int *pos)
 {
-  unsigned int tail;
-  unsigned int length;
-
-  /* Get the tail index of the circular buffer */
+  FAR struct noteram_ring_s *ring = &drv->ni_ring[ndx];
+  unsigned int start;
+  unsigned int read;
+  unsigned int head;
+  uint8_t notelen;
 
-  tail = drv->ni_tail;
-  DEBUGASSERT(tail < drv->ni_bufsize);
+  for (; ; )
+    {
+      read  = ring->read;
+      head  = ring->head;
+      UP_DMB();
 
-  /* Get the length of the note at the tail index */
+      start = noteram_start(drv, ring);
+      if (noteram_after(drv, start, read))
+        {
+          /* The writer lapped us, the notes in between are lost */
 
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
+          read = start;
+        }
 
-  /* Increment the tail index to remove the entire note from the circular
-   * buffer.
-   */
+      if (read == head)
+        {
+          return 0;
+        }
 
-  if (drv->ni_read == drv->ni_tail)
-    {
-      /* The read index also needs increment. */
+      noteram_copyout(drv, ndx, read, &notelen, 1);
+      noteram_copyout(drv, ndx, read, buffer,
+                      notelen < buflen ? notelen : buflen);
 
-      drv->ni_read = noteram_next(drv, tail, length);
+      UP_DMB();
+      if (!noteram_after(drv, ring->tail, read))
+        {
+          *pos = read;
+          return notelen;
+        }
     }
-
-  drv->ni_tail = noteram_next(drv, tail, length);
 }
 
 /****************************************************************************
  * Name: noteram_get
  *
  * Description:
- *   Get the next note from the read index of the circular buffer.
+ *   Get the next note from the read index of the circular buffer.  With
+ *   one ring per CPU, the oldest of the notes at the head of the rings is
+ *   returned so that the merged stream stays ordered by time.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -355,68 +458,67 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  *   provided.  Zero is returned only if the circular buffer is empty.  A
  *   negated errno value is returned in the event of any failure.
  *
+ * Assumptions:
+ *   The caller holds drv->lock, readers are serialized.
+ *
  ****************************************************************************/
 
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
                            FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
-  unsigned int remaining;
-  unsigned int read;
-  ssize_t notelen;
-  size_t circlen;
-
-  DEBUGASSERT(buffer != NULL);
-
-  /* Verify that the circular buffer is not empty */
+  unsigned int pos = 0;
+  size_t notelen = 0;
+  int ndx = 0;
+#if NOTERAM_NRINGS > 1
+  struct note_common_s note;
+  clock_t oldest = 0;
+  unsigned int npos;
+  size_t nlen;
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      nlen = noteram_ring_get(drv, i, (FAR uint8_t *)&note, sizeof(note),
+                              &npos);
+      if (nlen > 0 &&
+          (notelen == 0 || (sclock_t)(note.nc_systime - oldest) < 0))
+        {
+          oldest  = note.nc_systime;
+          notelen = nlen;
+          pos     = npos;
+          ndx     = i;
+        }
+    }
 
-  circlen = noteram_unread_length(drv);
-  if (circlen <= 0)
+  if (notelen == 0)
     {
       return 0;
     }
 
-  /* Get the read index of the circular buffer */
+  /* Copy the whole note; if it was overwritten meanwhile this returns the
+   * next one of the same ring.
+   */
+#endif
 
-  read = drv->ni_read;
-  DEBUGASSERT(read < drv->ni_bufsize);
+  DEBUGASSERT(buffer != NULL);
 
-  /* Get the length of the note at the read index */
+  notelen = noteram_ring_get(drv, ndx, buffer, buflen, &pos);
+  if (notelen == 0)
+    {
+      return 0;
+    }
 
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  drv->ni_ring[ndx].read = noteram_adv(drv, pos, NOTE_ALIGN(notelen));
 
-  /* Is the user buffer large enough to hold the note? */
+  /* Is the user buffer large enough to hold the note?  The large note was
+   * skipped so that we do not get constipated.
+   */
 
   if (buflen < notelen)
     {
-      /* Skip the large note so that we do not get constipated. */
-
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
-
-      /* and return an error */
-
       return -EFBIG;
     }
 
-  /* Loop until the note has been transferred to the user buffer */
-
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
-    {
-      /* Copy the next byte at the read index */
-
-      *buffer++ = drv->ni_buffer[read];
-
-      /* Adjust indices and counts */
-
-      read = noteram_next(drv, read, 1);
-      remaining--;
-    }
-
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
-
   return notelen;
 }
 
@@ -429,10 +531,19 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+  irqstate_t flags;
+  int i;
+
+  /* Reset the read index of the circular buffers */
 
-  /* Reset the read index of the circular buffer */
+  flags = spin_lock_irqsave_wo_note(&drv->lock);
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      drv->ni_ring[i].read = noteram_start(drv, &drv->ni_ring[i]);
+    }
+
+  spin_unlock_irqrestore_wo_note(&drv->lock, flags);
 
-  drv->ni_read = drv->ni_tail;
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -536,7 +647,18 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
+            int i;
+
             *(FAR unsigned int *)arg = drv->ni_overwrite;
+            for (i = 0; i < NOTERAM_NRINGS; i++)
+              {
+                if (drv->ni_ring[i].overflow)
+                  {
+                    *(FAR unsigned int *)arg =
+                      NOTERAM_MODE_OVERWRITE_OVERFLOW;
+                  }
+              }
+
             ret = OK;
           }
         break;
@@ -553,7 +675,14 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
+            int i;
+
             drv->ni_overwrite = *(FAR unsigned int *)arg;
+            for (i = 0; i < NOTERAM_NRINGS; i++)
+              {
+                drv->ni_ring[i].overflow = false;
+              }
+
             ret = OK;
           }
         break;
@@ -691,54 +820,91 @@ errout:
 static void noteram_add(FAR struct note_driver_s *driver,
                         FAR const void *note, size_t notelen)
 {
-  FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *buffer;
   unsigned int head;
-  unsigned int remain;
+  unsigned int tail;
+  unsigned int off;
   unsigned int space;
+  uint8_t length;
   irqstate_t flags;
+  bool added = false;
+  int ndx;
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  /* Nobody else writes to the ring of this CPU */
+
+  flags = up_irq_save();
+  ndx   = this_cpu();
+#else
   flags = spin_lock_irqsave_wo_note(&drv->lock);
+  ndx   = 0;
+#endif
 
-  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+  ring = &drv->ni_ring[ndx];
+  if (ring->overflow ||
+      drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
-      return;
+      goto out;
     }
 
   DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
 
-  if (remain <= NOTE_ALIGN(notelen))
+  head = ring->head;
+  tail = noteram_start(drv, ring);
+
+  if (noteram_diff(drv, head, tail) + NOTE_ALIGN(notelen) >=
+      drv->ni_bufsize)
     {
       if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
         {
           /* Stop recording if not in overwrite mode */
 
-          drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_wo_note(&drv->lock, flags);
-          return;
+          ring->overflow = true;
+          goto out;
         }
 
-      /* Remove the note at the tail index , make sure there is enough space
-       */
+      /* Remove the notes at the tail, make sure there is enough space */
 
       do
         {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
+          noteram_copyout(drv, ndx, tail, &length, 1);
+          tail = noteram_adv(drv, tail, NOTE_ALIGN(length));
         }
-      while (remain <= NOTE_ALIGN(notelen));
+      while (noteram_diff(drv, head, tail) + NOTE_ALIGN(notelen) >=
+             drv->ni_bufsize);
+
+      /* Publish the new tail before the old notes are overwritten */
+
+      ring->tail = tail;
+      UP_DMB();
     }
 
-  head = drv->ni_head;
-  space = drv->ni_bufsize - head;
-  space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
+  buffer = drv->ni_buffer + ndx * drv->ni_bufsize;
+  off    = head % drv->ni_bufsize;
+  space  = drv->ni_bufsize - off;
+  space  = space < notelen ? space : notelen;
+  memcpy(buffer + off, note, space);
+  memcpy(buffer, (FAR const uint8_t *)note + space, notelen - space);
+
+  /* Publish the note only after it is complete */
+
+  UP_DMB();
+  ring->head = noteram_adv(drv, head, NOTE_ALIGN(notelen));
+  added = true;
+
+out:
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  up_irq_restore(flags);
+#else
   spin_unlock_irqrestore_wo_note(&drv->lock, flags);
-  poll_notify(&drv->pfd, 1, POLLIN);
+#endif
+
+  if (added)
+    {
+      poll_notify(&drv->pfd, 1, POLLIN);
+    }
 }
 
 /****************************************************************************
@@ -1347,7 +1513,7 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
 #endif
   int ret;
 
-  drv = kmm_malloc(sizeof(*drv) + len + bufsize);
+  drv = kmm_zalloc(sizeof(*drv) + len + bufsize);
   if (drv == NULL)
     {
       return NULL;
@@ -1367,13 +1533,10 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
 #endif
 
   drv->driver.ops = &g_noteram_ops;
-  drv->ni_bufsize = bufsize;
+  drv->ni_bufsize = bufsize / NOTERAM_NRINGS;
+  drv->ni_limit = NOTERAM_LIMIT(drv->ni_bufsize);
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
-  drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
   if (ret < 0)
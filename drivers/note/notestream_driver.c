@@ -25,11 +25,95 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
+#include <assert.h>
+#include <sys/param.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched_note.h>
 #include <nuttx/note/notestream_driver.h>
 
+#if defined(CONFIG_DRIVERS_NOTESTREAM_PERFETTO) && \
+    defined(CONFIG_SCHED_INSTRUMENTATION_SYSCALL)
+#  ifdef CONFIG_LIB_SYSCALL
+#    include <syscall.h>
+#  else
+#    define CONFIG_LIB_SYSCALL
+#    include <syscall.h>
+#    undef CONFIG_LIB_SYSCALL
+#  endif
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+
+/* Protobuf wire types */
+
+#define PB_WIRE_VARINT                 0
+#define PB_WIRE_BYTES                  2
+
+/* Field numbers of the Perfetto trace protos that are used here:
+ * Trace, TracePacket, TrackDescriptor, ThreadDescriptor, TrackEvent,
+ * InternedData and EventName.
+ */
+
+#define TRACE_PACKET                   1
+
+#define PACKET_TIMESTAMP               8
+#define PACKET_SEQUENCE_ID             10
+#define PACKET_TRACK_EVENT             11
+#define PACKET_INTERNED_DATA           12
+#define PACKET_SEQUENCE_FLAGS          13
+#define PACKET_TRACK_DESCRIPTOR        60
+
+#define TRACK_UUID                     1
+#define TRACK_NAME                     2
+#define TRACK_THREAD                   4
+
+#define THREAD_PID                     1
+#define THREAD_TID                     2
+#define THREAD_NAME                    5
+
+#define EVENT_TYPE                     9
+#define EVENT_NAME_IID                 10
+#define EVENT_TRACK_UUID               11
+#define EVENT_NAME                     23
+
+#define INTERNED_EVENT_NAMES           2
+
+#define EVENT_NAME_NAME                2
+
+/* TrackEvent.Type and TracePacket.SequenceFlags */
+
+#define PERFETTO_SLICE_BEGIN           1
+#define PERFETTO_SLICE_END             2
+#define PERFETTO_INSTANT               3
+
+#define PERFETTO_SEQ_INCREMENTAL_STATE_CLEARED 1
+#define PERFETTO_SEQ_NEEDS_INCREMENTAL_STATE   2
+
+/* Track UUIDs and interning keys */
+
+#define PERFETTO_CPU_UUID(cpu)         (1 + (cpu))
+#define PERFETTO_THREAD_UUID(pid)      (0x10000 + (uint32_t)(pid))
+
+#define PERFETTO_KEY_TASK(pid)         (0x1000000 | (uint16_t)(pid))
+#define PERFETTO_KEY_THREAD(pid)       (0x2000000 | (uint16_t)(pid))
+#define PERFETTO_KEY_IRQ(irq)          (0x3000000 | (irq))
+#define PERFETTO_KEY_SYSCALL(nr)       (0x4000000 | (nr))
+
+/* Longer names are truncated */
+
+#define PERFETTO_NAME_MAX              127
+
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -88,12 +172,490 @@ struct notestream_driver_s g_notestream_lowerout =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+
+/****************************************************************************
+ * Name: pb_varint / pb_uint / pb_bytes
+ *
+ * Description:
+ *   Append a protobuf varint, a varint field or a length delimited field.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *pb_varint(FAR uint8_t *p, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      *p++ = (uint8_t)value | 0x80;
+      value >>= 7;
+    }
+
+  *p++ = (uint8_t)value;
+  return p;
+}
+
+static FAR uint8_t *pb_uint(FAR uint8_t *p, int field, uint64_t value)
+{
+  p = pb_varint(p, (field << 3) | PB_WIRE_VARINT);
+  return pb_varint(p, value);
+}
+
+static FAR uint8_t *pb_bytes(FAR uint8_t *p, int field,
+                             FAR const void *data, size_t len)
+{
+  p = pb_varint(p, (field << 3) | PB_WIRE_BYTES);
+  p = pb_varint(p, len);
+  memcpy(p, data, len);
+  return p + len;
+}
+
+/****************************************************************************
+ * Name: pb_begin / pb_end
+ *
+ * Description:
+ *   Open and close a nested message.  The length is stored as a two byte
+ *   varint, which protobuf allows to be redundant, so that it can be filled
+ *   in once the message is complete.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *pb_begin(FAR uint8_t *p, int field,
+                             FAR uint8_t **slot)
+{
+  p = pb_varint(p, (field << 3) | PB_WIRE_BYTES);
+  *slot = p;
+  return p + 2;
+}
+
+static FAR uint8_t *pb_end(FAR uint8_t *p, FAR uint8_t *slot)
+{
+  size_t len = p - slot - 2;
+
+  DEBUGASSERT(len < 0x4000);
+  slot[0] = (len & 0x7f) | 0x80;
+  slot[1] = len >> 7;
+  return p;
+}
+
+/****************************************************************************
+ * Name: perfetto_time
+ *
+ * Description:
+ *   Convert the time stamp of a note to nanoseconds.  Only the distance to
+ *   the previous note is converted so that a wrapping perf counter still
+ *   gives a monotonic time.
+ *
+ ****************************************************************************/
+
+static uint64_t perfetto_time(FAR struct notestream_perfetto_s *pf,
+                              clock_t systime)
+{
+  struct timespec ts;
+  sclock_t delta = (sclock_t)(systime - pf->last);
+
+  pf->last = systime;
+  perf_convert(delta < 0 ? -delta : delta, &ts);
+
+  if (delta < 0)
+    {
+      pf->time -= (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+    }
+  else
+    {
+      pf->time += (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+    }
+
+  return pf->time;
+}
+
+/****************************************************************************
+ * Name: perfetto_flush
+ ****************************************************************************/
+
+static void perfetto_flush(FAR struct notestream_driver_s *drv,
+                           FAR uint8_t *end)
+{
+  FAR uint8_t *buf = drv->perfetto.buffer;
+
+  DEBUGASSERT(end - buf <= NOTESTREAM_PERFETTO_BUFSIZE);
+  lib_stream_puts(drv->stream, buf, end - buf);
+}
+
+/****************************************************************************
+ * Name: perfetto_track
+ *
+ * Description:
+ *   Describe the track of a CPU (pid < 0) or of a thread.
+ *
+ ****************************************************************************/
+
+static void perfetto_track(FAR struct notestream_driver_s *drv, int cpu,
+                           pid_t pid, FAR const char *name, size_t len)
+{
+  FAR uint8_t *p = drv->perfetto.buffer;
+  FAR uint8_t *packet;
+  FAR uint8_t *track;
+  FAR uint8_t *thread;
+
+  p = pb_begin(p, TRACE_PACKET, &packet);
+  p = pb_begin(p, PACKET_TRACK_DESCRIPTOR, &track);
+
+  if (pid < 0)
+    {
+      p = pb_uint(p, TRACK_UUID, PERFETTO_CPU_UUID(cpu));
+      p = pb_bytes(p, TRACK_NAME, name, len);
+    }
+  else
+    {
+      p = pb_uint(p, TRACK_UUID, PERFETTO_THREAD_UUID(pid));
+      p = pb_begin(p, TRACK_THREAD, &thread);
+      p = pb_uint(p, THREAD_PID, pid);
+      p = pb_uint(p, THREAD_TID, pid);
+      p = pb_bytes(p, THREAD_NAME, name, len);
+      p = pb_end(p, thread);
+    }
+
+  p = pb_end(p, track);
+  p = pb_end(p, packet);
+  perfetto_flush(drv, p);
+}
+
+/****************************************************************************
+ * Name: perfetto_intern
+ *
+ * Description:
+ *   Look up the interning ID of a key.  If the key is not interned yet it
+ *   gets a new ID and false is returned: the caller has to send the name.
+ *
+ ****************************************************************************/
+
+static bool perfetto_intern(FAR struct notestream_perfetto_s *pf,
+                            uint32_t key, FAR uint32_t *iid)
+{
+  int i;
+
+  for (i = 0; i < pf->nkeys; i++)
+    {
+      if (pf->keys[i] == key)
+        {
+          *iid = pf->iids[i];
+          return true;
+        }
+    }
+
+  if (pf->nkeys == CONFIG_DRIVERS_NOTESTREAM_PERFETTO_NINTERN)
+    {
+      /* Forget all names, the reader drops its table too */
+
+      pf->nkeys   = 0;
+      pf->cleared = true;
+    }
+
+  i = pf->nkeys++;
+  pf->keys[i] = key;
+  pf->iids[i] = ++pf->nextiid;
+  *iid = pf->iids[i];
+  return false;
+}
+
+/****************************************************************************
+ * Name: perfetto_forget
+ ****************************************************************************/
+
+static void perfetto_forget(FAR struct notestream_perfetto_s *pf,
+                            uint32_t key)
+{
+  int i;
+
+  for (i = 0; i < pf->nkeys; i++)
+    {
+      if (pf->keys[i] == key)
+        {
+          pf->nkeys--;
+          pf->keys[i] = pf->keys[pf->nkeys];
+          pf->iids[i] = pf->iids[pf->nkeys];
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: perfetto_taskname
+ ****************************************************************************/
+
+static size_t perfetto_taskname(pid_t pid, FAR char *buf, size_t buflen)
+{
+  FAR const char *name = NULL;
+
+#if defined(CONFIG_DRIVERS_NOTE_TASKNAME_BUFSIZE) && \
+    CONFIG_DRIVERS_NOTE_TASKNAME_BUFSIZE > 0
+  name = note_get_taskname(pid);
+#endif
+
+  if (name == NULL)
+    {
+      return snprintf(buf, buflen, "pid %d", pid);
+    }
+
+  return MIN(strlcpy(buf, name, buflen), buflen - 1);
+}
+
+/****************************************************************************
+ * Name: perfetto_thread
+ *
+ * Description:
+ *   Describe the track of a thread the first time it is used.
+ *
+ ****************************************************************************/
+
+static void perfetto_thread(FAR struct notestream_driver_s *drv,
+                            pid_t pid, FAR const char *name)
+{
+  char buf[PERFETTO_NAME_MAX + 1];
+  uint32_t iid;
+  size_t len;
+
+  if (!perfetto_intern(&drv->perfetto, PERFETTO_KEY_THREAD(pid), &iid))
+    {
+      if (name != NULL)
+        {
+          len = MIN(strlcpy(buf, name, sizeof(buf)), sizeof(buf) - 1);
+        }
+      else
+        {
+          len = perfetto_taskname(pid, buf, sizeof(buf));
+        }
+
+      perfetto_track(drv, 0, pid, buf, len);
+    }
+}
+
+/****************************************************************************
+ * Name: perfetto_event
+ *
+ * Description:
+ *   Emit one track event.  The event is named either by an interned name
+ *   ('key' is not zero) or inline.
+ *
+ ****************************************************************************/
+
+static void perfetto_event(FAR struct notestream_driver_s *drv,
+                           FAR const struct note_common_s *note,
+                           uint64_t uuid, int type, uint32_t key,
+                           FAR const char *name, size_t len)
+{
+  FAR struct notestream_perfetto_s *pf = &drv->perfetto;
+  FAR uint8_t *p = pf->buffer;
+  FAR uint8_t *packet;
+  FAR uint8_t *interned;
+  FAR uint8_t *event;
+  uint32_t iid = 0;
+  bool known = true;
+  int flags;
+
+  len = MIN(len, PERFETTO_NAME_MAX);
+  if (key != 0)
+    {
+      known = perfetto_intern(pf, key, &iid);
+    }
+
+  flags = PERFETTO_SEQ_NEEDS_INCREMENTAL_STATE;
+  if (pf->cleared)
+    {
+      flags |= PERFETTO_SEQ_INCREMENTAL_STATE_CLEARED;
+      pf->cleared = false;
+    }
+
+  p = pb_begin(p, TRACE_PACKET, &packet);
+  p = pb_uint(p, PACKET_TIMESTAMP, perfetto_time(pf, note->nc_systime));
+  p = pb_uint(p, PACKET_SEQUENCE_ID, 1);
+  p = pb_uint(p, PACKET_SEQUENCE_FLAGS, flags);
+
+  if (!known)
+    {
+      FAR uint8_t *entry;
+
+      p = pb_begin(p, PACKET_INTERNED_DATA, &interned);
+      p = pb_begin(p, INTERNED_EVENT_NAMES, &entry);
+      p = pb_uint(p, EVENT_NAME_IID, iid);
+      p = pb_bytes(p, EVENT_NAME_NAME, name, len);
+      p = pb_end(p, entry);
+      p = pb_end(p, interned);
+    }
+
+  p = pb_begin(p, PACKET_TRACK_EVENT, &event);
+  p = pb_uint(p, EVENT_TYPE, type);
+  p = pb_uint(p, EVENT_TRACK_UUID, uuid);
+  if (iid != 0)
+    {
+      p = pb_uint(p, EVENT_NAME_IID, iid);
+    }
+  else if (name != NULL)
+    {
+      p = pb_bytes(p, EVENT_NAME, name, len);
+    }
+
+  p = pb_end(p, event);
+  p = pb_end(p, packet);
+  perfetto_flush(drv, p);
+}
+
+/****************************************************************************
+ * Name: perfetto_add
+ *
+ * Description:
+ *   Translate one note into Perfetto packets.  Notes without a counterpart
+ *   in the trace format (heap, spinlocks, watchdogs, ...) are dropped.
+ *
+ ****************************************************************************/
+
+static void perfetto_add(FAR struct notestream_driver_s *drv,
+                         FAR const struct note_common_s *note)
+{
+  FAR struct notestream_perfetto_s *pf = &drv->perfetto;
+  FAR const char *name = NULL;
+  char buf[PERFETTO_NAME_MAX + 1];
+  size_t len;
+  int cpu;
+
+#ifdef CONFIG_SMP
+  cpu = note->nc_cpu;
+#else
+  cpu = 0;
+#endif
+
+  if (!pf->started)
+    {
+      int i;
+
+      pf->started = true;
+      pf->last    = note->nc_systime;
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          len = snprintf(buf, sizeof(buf), "CPU %d", i);
+          perfetto_track(drv, i, -1, buf, len);
+        }
+    }
+
+  switch (note->nc_type)
+    {
+      case NOTE_START:
+
+        /* The PID may be reused, forget what was sent for the old task */
+
+        perfetto_forget(pf, PERFETTO_KEY_TASK(note->nc_pid));
+        perfetto_forget(pf, PERFETTO_KEY_THREAD(note->nc_pid));
+#if CONFIG_TASK_NAME_SIZE > 0
+        name = ((FAR const struct note_start_s *)note)->nst_name;
+#endif
+        perfetto_thread(drv, note->nc_pid, name);
+        break;
+
+      case NOTE_RESUME:
+        perfetto_thread(drv, note->nc_pid, NULL);
+        len = perfetto_taskname(note->nc_pid, buf, sizeof(buf));
+        if (pf->running[cpu])
+          {
+            perfetto_event(drv, note, PERFETTO_CPU_UUID(cpu),
+                           PERFETTO_SLICE_END, 0, NULL, 0);
+          }
+
+        perfetto_event(drv, note, PERFETTO_CPU_UUID(cpu),
+                       PERFETTO_SLICE_BEGIN,
+                       PERFETTO_KEY_TASK(note->nc_pid), buf, len);
+        pf->running[cpu] = true;
+        break;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+      case NOTE_IRQ_ENTER:
+        {
+          FAR const struct note_irqhandler_s *nih =
+            (FAR const struct note_irqhandler_s *)note;
+
+          len = snprintf(buf, sizeof(buf), "irq %u", nih->nih_irq);
+          perfetto_event(drv, note, PERFETTO_CPU_UUID(cpu),
+                         PERFETTO_SLICE_BEGIN,
+                         PERFETTO_KEY_IRQ(nih->nih_irq), buf, len);
+        }
+        break;
+
+      case NOTE_IRQ_LEAVE:
+        perfetto_event(drv, note, PERFETTO_CPU_UUID(cpu),
+                       PERFETTO_SLICE_END, 0, NULL, 0);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+      case NOTE_SYSCALL_ENTER:
+        {
+          FAR const struct note_syscall_enter_s *nsc =
+            (FAR const struct note_syscall_enter_s *)note;
+
+          if (nsc->nsc_nr < CONFIG_SYS_RESERVED ||
+              nsc->nsc_nr >= SYS_maxsyscall)
+            {
+              break;
+            }
+
+          name = g_funcnames[nsc->nsc_nr - CONFIG_SYS_RESERVED];
+          perfetto_thread(drv, note->nc_pid, NULL);
+          perfetto_event(drv, note, PERFETTO_THREAD_UUID(note->nc_pid),
+                         PERFETTO_SLICE_BEGIN,
+                         PERFETTO_KEY_SYSCALL(nsc->nsc_nr),
+                         name, strlen(name));
+        }
+        break;
+
+      case NOTE_SYSCALL_LEAVE:
+        perfetto_event(drv, note, PERFETTO_THREAD_UUID(note->nc_pid),
+                       PERFETTO_SLICE_END, 0, NULL, 0);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+      case NOTE_DUMP_BEGIN:
+      case NOTE_DUMP_END:
+      case NOTE_DUMP_MARK:
+        {
+          FAR const struct note_event_s *nev =
+            (FAR const struct note_event_s *)note;
+          int type;
+
+          name = (FAR const char *)nev->nev_data;
+          len  = strnlen(name, note->nc_length - SIZEOF_NOTE_EVENT(0));
+          type = note->nc_type == NOTE_DUMP_BEGIN ? PERFETTO_SLICE_BEGIN :
+                 note->nc_type == NOTE_DUMP_END ? PERFETTO_SLICE_END :
+                 PERFETTO_INSTANT;
+
+          perfetto_thread(drv, note->nc_pid, NULL);
+          perfetto_event(drv, note, PERFETTO_THREAD_UUID(note->nc_pid),
+                         type, 0, len > 0 ? name : NULL, len);
+        }
+        break;
+#endif
+
+      default:
+        break;
+    }
+}
+#endif /* CONFIG_DRIVERS_NOTESTREAM_PERFETTO */
+
 static void notestream_add(FAR struct note_driver_s *drv,
                            FAR const void *note, size_t len)
 {
   FAR struct notestream_driver_s *drivers =
       (FAR struct notestream_driver_s *)drv;
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+  irqstate_t flags;
+
+  /* The interned names must reach the stream before their first use */
+
+  flags = spin_lock_irqsave_wo_note(&drivers->perfetto.lock);
+  perfetto_add(drivers, note);
+  spin_unlock_irqrestore_wo_note(&drivers->perfetto.lock, flags);
+#else
   lib_stream_puts(drivers->stream, note, len);
+#endif
 }
 
 /****************************************************************************
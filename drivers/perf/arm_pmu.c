@@ -181,6 +181,11 @@ static int armpmu_start(FAR struct perf_event_s *event, int flags)
   FAR struct hw_perf_event_s *hwc = &event->hw;
 
   hwc->state = 0;
+  if (is_sampling_event(event))
+    {
+      armpmu_event_set_period(event);
+    }
+
   armpmu->enable(event);
 
   return 0;
@@ -247,6 +252,15 @@ static int armpmu_event_init(FAR struct perf_event_s *event)
       return -ENOENT;
     }
 
+  /* Only a fixed sample period is supported, the counter cannot be
+   * retuned on the fly to reach a sampling frequency.
+   */
+
+  if (event->attr.freq)
+    {
+      return -EOPNOTSUPP;
+    }
+
   hwc->flags = 0;
   mapping = armpmu->map_event(event);
 
@@ -393,13 +407,40 @@ uint64_t armpmu_event_update(FAR struct perf_event_s *event)
 
   new_raw_count = armpmu->read_counter(event);
 
-  delta = (new_raw_count) & max_period;
+  /* A counting event restarts from zero, a sampling event from the value
+   * programmed by armpmu_event_set_period().
+   */
+
+  delta = (new_raw_count - event->hw.prev_count) & max_period;
+  if (is_sampling_event(event))
+    {
+      event->hw.prev_count = new_raw_count;
+    }
 
   atomic_fetch_add(&event->count, delta);
 
   return new_raw_count;
 }
 
+void armpmu_event_set_period(FAR struct perf_event_s *event)
+{
+  FAR struct arm_pmu_s *armpmu = to_arm_pmu(event->pmu);
+  uint64_t max_period = armpmu_event_max_period(event);
+  uint64_t left = event->attr.sample_period;
+
+  /* Keep half of the range as headroom so that the delta computed at the
+   * overflow interrupt is still unambiguous when the interrupt is late.
+   */
+
+  if (left > (max_period >> 1))
+    {
+      left = max_period >> 1;
+    }
+
+  event->hw.prev_count = (0 - left) & max_period;
+  armpmu->write_counter(event, event->hw.prev_count);
+}
+
 int armpmu_driver_init(FAR void *fn)
 {
   FAR armpmu_init_fn init_fn = (armpmu_init_fn)fn;
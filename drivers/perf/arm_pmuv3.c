@@ -263,18 +263,29 @@ static void pmuv3_enable_user_access(FAR struct arm_pmu_s *cpu_pmu)
 
   for (i = 0; i < cpu_pmu->num_events; i++)
     {
+      uint64_t value = 0;
+
       if (!test_bit(i, &cpuc->used_mask))
         {
           continue;
         }
 
+      /* A sampling counter keeps the value that makes it overflow after
+       * the next sample period.
+       */
+
+      if (cpuc->events[i] && is_sampling_event(cpuc->events[i]))
+        {
+          value = cpuc->events[i]->hw.prev_count;
+        }
+
       if (i == PMU_IDX_CYCLE_COUNTER)
         {
-          write_pmccntr(0);
+          write_pmccntr(value);
         }
       else
         {
-          write_pmevcntrn(PMU_IDX_TO_COUNTER(i), 0);
+          write_pmevcntrn(PMU_IDX_TO_COUNTER(i), value);
         }
     }
 
@@ -369,9 +380,13 @@ static int pmuv3_handle_irq(FAR struct arm_pmu_s *cpu_pmu)
           continue;
         }
 
-      /* Update data */
+      /* Update data and re-arm the counter for the next sample */
 
       armpmu_event_update(event);
+      if (is_sampling_event(event))
+        {
+          armpmu_event_set_period(event);
+        }
 
       if (perf_event_overflow(event))
         {
@@ -398,6 +413,9 @@ static int pmuv3_get_event_idx(FAR struct pmu_hw_events_s *cpuc,
     {
       if (!test_and_set_bit(PMU_IDX_CYCLE_COUNTER, &cpuc->used_mask))
         {
+          /* PMCR.LC is set, the cycle counter overflows at 64 bits */
+
+          hwc->flags |= ARMPMU_EVT_64BIT;
           return PMU_IDX_CYCLE_COUNTER;
         }
     }
@@ -52,8 +52,8 @@ static const struct file_operations g_fifo_fops =
   NULL,                /* mmap */
   NULL,                /* truncate */
   pipecommon_poll,     /* poll */
-  NULL,                /* readv */
-  NULL                 /* writev */
+  pipecommon_readv,    /* readv */
+  pipecommon_writev    /* writev */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , pipecommon_unlink  /* unlink */
 #endif
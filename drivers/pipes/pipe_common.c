@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <string.h>
 #include <sched.h>
 #include <fcntl.h>
@@ -82,6 +83,152 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_rdwait
+ *
+ * Description:
+ *   Wait until the pipe holds at least one byte.  Must be called with
+ *   d_bflock held.  A positive return value means that data is available
+ *   and the lock is still held; otherwise the lock has been released and
+ *   zero means end of file.
+ *
+ ****************************************************************************/
+
+static int pipecommon_rdwait(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  while (circbuf_is_empty(&dev->d_buffer))
+    {
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrwait
+ *
+ * Description:
+ *   Wait until the pipe has room for at least one byte.  Must be called
+ *   with d_bflock held.  On success the lock is still held; on failure it
+ *   has been released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_wrwait(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!circbuf_is_full(&dev->d_buffer))
+        {
+          return OK;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_consumed
+ *
+ * Description:
+ *   Notify poll waiters and blocked writers that bytes were removed from
+ *   the pipe.  Must be called with d_bflock held.
+ *
+ ****************************************************************************/
+
+static void pipecommon_consumed(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_produced
+ *
+ * Description:
+ *   Notify poll waiters and blocked readers that bytes were added to the
+ *   pipe.  Must be called with d_bflock held.
+ *
+ ****************************************************************************/
+
+static void pipecommon_produced(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  pipecommon_wakeup(&dev->d_rdsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_peekptr
+ *
+ * Description:
+ *   Return the contiguous run of unread bytes that starts 'pos' bytes past
+ *   the read position, without consuming anything.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *pipecommon_peekptr(FAR struct circbuf_s *circ,
+                                       size_t pos, FAR size_t *size)
+{
+  size_t used = circbuf_used(circ);
+  size_t off;
+
+  if (pos >= used)
+    {
+      *size = 0;
+      return NULL;
+    }
+
+  off   = (circ->tail + pos) % circ->size;
+  *size = MIN(used - pos, circ->size - off);
+  return (FAR uint8_t *)circ->base + off;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -406,21 +553,24 @@ int pipecommon_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: pipecommon_read
+ * Name: pipecommon_readv
  ****************************************************************************/
 
-ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+ssize_t pipecommon_readv(FAR struct file *filep, FAR const struct uio *uio)
 {
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
   ssize_t                nread = 0;
+  ssize_t                len;
   int                    ret;
+  int                    i;
 
   DEBUGASSERT(dev);
 
-  if (len == 0)
+  len = uio_total_len(uio);
+  if (len <= 0)
     {
-      return 0;
+      return len;
     }
 
   /* Make sure that we have exclusive access to the device structure */
@@ -449,7 +599,8 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
       /* If O_NONBLOCK was set, then return EGAIN */
 
-      if (filep->f_oflags & O_NONBLOCK)
+      if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+          (uio->uio_flags & UIO_NONBLOCK) != 0)
         {
           nxrmutex_unlock(&dev->d_bflock);
           return -EAGAIN;
@@ -471,10 +622,23 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
     }
 
   /* Then return whatever is available in the pipe (which is at least one
-   * byte).
+   * byte), filling each buffer in turn.
    */
 
-  nread = circbuf_read(&dev->d_buffer, buffer, len);
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      FAR const struct iovec *iov = &uio->uio_iov[i];
+      ssize_t n;
+
+      n = circbuf_read(&dev->d_buffer, iov->iov_base, iov->iov_len);
+      pipe_dumpbuffer("From PIPE:", iov->iov_base, n);
+      nread += n;
+
+      if (n < iov->iov_len)
+        {
+          break;
+        }
+    }
 
   /* Notify all poll/select waiters that they can write to the
    * FIFO when buffer can accept more than d_polloutthrd bytes.
@@ -492,31 +656,50 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   pipecommon_wakeup(&dev->d_wrsem);
 
   nxrmutex_unlock(&dev->d_bflock);
-  pipe_dumpbuffer("From PIPE:", buffer, nread);
   return nread;
 }
 
 /****************************************************************************
- * Name: pipecommon_write
+ * Name: pipecommon_read
  ****************************************************************************/
 
-ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t len)
+ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = buffer;
+  iov.iov_len = len;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return pipecommon_readv(filep, &uio);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writev
+ ****************************************************************************/
+
+ssize_t pipecommon_writev(FAR struct file *filep, FAR const struct uio *uio)
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
+  ssize_t                len;
+  size_t                 need;
+  size_t                 iovoff   = 0;
+  int                    iovidx   = 0;
   int                    ret;
 
   DEBUGASSERT(dev);
-  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
 
   /* Handle zero-length writes */
 
-  if (len == 0)
+  len = uio_total_len(uio);
+  if (len <= 0)
     {
-      return 0;
+      return len;
     }
 
   /* At present, this method cannot be called from interrupt handlers.  That
@@ -546,6 +729,13 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
       return ret;
     }
 
+  /* POSIX requires that writes of no more than PIPE_BUF bytes are never
+   * interleaved with data from other writers.  Such a write waits until
+   * the whole request fits rather than being split.
+   */
+
+  need = (len <= PIPE_BUF && len <= dev->d_bufsize) ? len : 1;
+
   /* Loop until all of the bytes have been written */
 
   last = 0;
@@ -563,16 +753,36 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Is there room for the next part of the write? */
 
-      if (!circbuf_is_full(&dev->d_buffer))
+      if (circbuf_space(&dev->d_buffer) >= need)
         {
-          /* Loop until all of the bytes have been written */
+          /* Copy from each remaining buffer until the circular buffer
+           * fills up or the whole vector has been written.
+           */
 
-          nwritten += circbuf_write(&dev->d_buffer,
-                                    buffer + nwritten, len - nwritten);
+          while (iovidx < uio->uio_iovcnt)
+            {
+              FAR const struct iovec *iov = &uio->uio_iov[iovidx];
+              FAR const uint8_t *src = iov->iov_base;
+              ssize_t n;
 
-          if ((size_t)nwritten == len)
+              n = circbuf_write(&dev->d_buffer, src + iovoff,
+                                iov->iov_len - iovoff);
+              pipe_dumpbuffer("To PIPE:", src + iovoff, n);
+              nwritten += n;
+              iovoff   += n;
+
+              if (iovoff < iov->iov_len)
+                {
+                  break;
+                }
+
+              iovoff = 0;
+              iovidx++;
+            }
+
+          if (nwritten == len)
             {
               /* Notify all poll/select waiters that they can read from the
                * FIFO when buffer used exceeds poll threshold.
@@ -598,8 +808,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
         }
       else
         {
-          /* There is not enough room for the next byte.  Was anything
-           * written in this pass?
+          /* There is not enough room for the next part of the write.  Was
+           * anything written in this pass?
            */
 
           if (last < nwritten)
@@ -623,7 +833,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
            * EGAIN.
            */
 
-          if (filep->f_oflags & O_NONBLOCK)
+          if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+              (uio->uio_flags & UIO_NONBLOCK) != 0)
             {
               if (nwritten == 0)
                 {
@@ -652,6 +863,388 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_write
+ ****************************************************************************/
+
+ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t len)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len = len;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return pipecommon_writev(filep, &uio);
+}
+
+/****************************************************************************
+ * Name: pipecommon_ispipe
+ *
+ * Description:
+ *   Return true if the open file refers to a pipe or a FIFO.
+ *
+ ****************************************************************************/
+
+bool pipecommon_ispipe(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  return inode != NULL && INODE_IS_DRIVER(inode) &&
+         inode->u.i_ops->readv == pipecommon_readv;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_read
+ *
+ * Description:
+ *   Drain up to 'len' bytes from the pipe straight into another file.  The
+ *   bytes are handed to the output file from the pipe buffer itself so they
+ *   are never staged in an intermediate buffer.  Only as much as the output
+ *   accepts is consumed from the pipe.
+ *
+ * Input Parameters:
+ *   filep    - The read end of the pipe
+ *   out      - The destination file
+ *   offset   - If not NULL, write at this offset of 'out' and advance it;
+ *              otherwise use and advance the file position of 'out'
+ *   len      - The maximum number of bytes to move
+ *   nonblock - Do not wait for the pipe to become non-empty
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice_read(FAR struct file *filep, FAR struct file *out,
+                               FAR off_t *offset, size_t len, bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  ssize_t total = 0;
+  ssize_t ret;
+
+  DEBUGASSERT(dev);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_rdwait(dev, nonblock ||
+                               (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  while (total < len)
+    {
+      FAR uint8_t *src;
+      size_t n;
+
+      src = circbuf_get_readptr(&dev->d_buffer, &n);
+      n   = MIN(n, len - total);
+      if (n == 0)
+        {
+          break;
+        }
+
+      if (offset != NULL)
+        {
+          ret = file_pwrite(out, src, n, *offset);
+        }
+      else
+        {
+          ret = file_write(out, src, n);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("From PIPE:", src, ret);
+      circbuf_readcommit(&dev->d_buffer, ret);
+      total += ret;
+      if (offset != NULL)
+        {
+          *offset += ret;
+        }
+
+      if (ret < n)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      pipecommon_consumed(dev);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_write
+ *
+ * Description:
+ *   Fill the pipe with up to 'len' bytes read from another file.  The input
+ *   file reads directly into the free space of the pipe buffer.
+ *
+ * Input Parameters:
+ *   filep    - The write end of the pipe
+ *   in       - The source file
+ *   offset   - If not NULL, read at this offset of 'in' and advance it;
+ *              otherwise use and advance the file position of 'in'
+ *   len      - The maximum number of bytes to move
+ *   nonblock - Do not wait for the pipe to have free space
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of the input, or a negated
+ *   errno.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice_write(FAR struct file *filep, FAR struct file *in,
+                                FAR off_t *offset, size_t len, bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  ssize_t total = 0;
+  ssize_t ret;
+
+  DEBUGASSERT(dev);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_wrwait(dev, nonblock ||
+                               (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (total < len)
+    {
+      FAR uint8_t *dst;
+      size_t n;
+
+      dst = circbuf_get_writeptr(&dev->d_buffer, &n);
+      n   = MIN(n, len - total);
+      if (n == 0)
+        {
+          break;
+        }
+
+      if (offset != NULL)
+        {
+          ret = file_pread(in, dst, n, *offset);
+        }
+      else
+        {
+          ret = file_read(in, dst, n);
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("To PIPE:", dst, ret);
+      circbuf_writecommit(&dev->d_buffer, ret);
+      total += ret;
+      if (offset != NULL)
+        {
+          *offset += ret;
+        }
+
+      if (ret < n)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      pipecommon_produced(dev);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_pipe
+ *
+ * Description:
+ *   Move (or, for tee(), duplicate) up to 'len' bytes from one pipe into
+ *   another, copying once from ring buffer to ring buffer.  Both pipes are
+ *   locked in address order so that concurrent transfers in opposite
+ *   directions cannot deadlock.
+ *
+ * Input Parameters:
+ *   in       - The read end of the source pipe
+ *   out      - The write end of the destination pipe
+ *   len      - The maximum number of bytes to move
+ *   nonblock - Do not wait for data or for free space
+ *   peek     - Leave the bytes in the source pipe
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice_pipe(FAR struct file *in, FAR struct file *out,
+                               size_t len, bool nonblock, bool peek)
+{
+  FAR struct pipe_dev_s *idev = in->f_inode->i_private;
+  FAR struct pipe_dev_s *odev = out->f_inode->i_private;
+  FAR struct pipe_dev_s *first;
+  FAR struct pipe_dev_s *second;
+  FAR struct file *waitfile;
+  FAR sem_t *waitsem;
+  size_t total = 0;
+  int ret;
+
+  DEBUGASSERT(idev && odev);
+
+  if (idev == odev)
+    {
+      return -EINVAL;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  first  = idev < odev ? idev : odev;
+  second = idev < odev ? odev : idev;
+
+  for (; ; )
+    {
+      ret = nxrmutex_lock(&first->d_bflock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = nxrmutex_lock(&second->d_bflock);
+      if (ret < 0)
+        {
+          nxrmutex_unlock(&first->d_bflock);
+          return ret;
+        }
+
+      if (circbuf_is_empty(&idev->d_buffer))
+        {
+          if (idev->d_nwriters <= 0 && PIPE_IS_POLICY_0(idev->d_flags))
+            {
+              ret = 0;
+            }
+          else
+            {
+              ret = -EAGAIN;
+            }
+
+          waitfile = in;
+          waitsem  = &idev->d_rdsem;
+        }
+      else if (odev->d_nreaders <= 0 && PIPE_IS_POLICY_0(odev->d_flags))
+        {
+          ret = -EPIPE;
+        }
+      else if (circbuf_is_full(&odev->d_buffer))
+        {
+          ret      = -EAGAIN;
+          waitfile = out;
+          waitsem  = &odev->d_wrsem;
+        }
+      else
+        {
+          break;
+        }
+
+      nxrmutex_unlock(&second->d_bflock);
+      nxrmutex_unlock(&first->d_bflock);
+
+      if (ret != -EAGAIN || nonblock ||
+          (waitfile->f_oflags & O_NONBLOCK) != 0)
+        {
+          return ret;
+        }
+
+      ret = nxsem_wait(waitsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  while (total < len)
+    {
+      FAR uint8_t *src;
+      FAR uint8_t *dst;
+      size_t space;
+      size_t n;
+
+      if (peek)
+        {
+          src = pipecommon_peekptr(&idev->d_buffer, total, &n);
+        }
+      else
+        {
+          src = circbuf_get_readptr(&idev->d_buffer, &n);
+        }
+
+      dst = circbuf_get_writeptr(&odev->d_buffer, &space);
+      n   = MIN(MIN(n, space), len - total);
+      if (n == 0)
+        {
+          break;
+        }
+
+      memcpy(dst, src, n);
+      circbuf_writecommit(&odev->d_buffer, n);
+      if (!peek)
+        {
+          circbuf_readcommit(&idev->d_buffer, n);
+        }
+
+      total += n;
+    }
+
+  if (!peek)
+    {
+      pipecommon_consumed(idev);
+    }
+
+  pipecommon_produced(odev);
+
+  nxrmutex_unlock(&second->d_bflock);
+  nxrmutex_unlock(&first->d_bflock);
+  return total;
+}
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
@@ -862,7 +1455,15 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+          /* Never discard unread data to satisfy a smaller size */
+
           size = MIN(size, CONFIG_DEV_PIPE_MAXSIZE);
+          if (size < circbuf_used(&dev->d_buffer))
+            {
+              ret = -EBUSY;
+              break;
+            }
+
           ret = circbuf_resize(&dev->d_buffer, size);
           if (ret != 0)
             {
@@ -870,6 +1471,19 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
 
           dev->d_bufsize = size;
+          if (dev->d_pollinthrd >= size)
+            {
+              dev->d_pollinthrd = size - 1;
+            }
+
+          if (dev->d_polloutthrd >= size)
+            {
+              dev->d_polloutthrd = size - 1;
+            }
+
+          /* A larger buffer may let blocked writers proceed */
+
+          pipecommon_consumed(dev);
         }
         break;
 
@@ -153,6 +153,7 @@ extern "C"
 
 struct file;  /* Forward reference */
 struct inode; /* Forward reference */
+struct uio;   /* Forward reference */
 
 FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize);
 void    pipecommon_freedev(FAR struct pipe_dev_s *dev);
@@ -160,6 +161,17 @@ int     pipecommon_open(FAR struct file *filep);
 int     pipecommon_close(FAR struct file *filep);
 ssize_t pipecommon_read(FAR struct file *, FAR char *, size_t);
 ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
+ssize_t pipecommon_readv(FAR struct file *filep, FAR const struct uio *uio);
+ssize_t pipecommon_writev(FAR struct file *filep,
+                          FAR const struct uio *uio);
+bool    pipecommon_ispipe(FAR struct file *filep);
+ssize_t pipecommon_splice_read(FAR struct file *filep, FAR struct file *out,
+                               FAR off_t *offset, size_t len, bool nonblock);
+ssize_t pipecommon_splice_write(FAR struct file *filep, FAR struct file *in,
+                                FAR off_t *offset, size_t len,
+                                bool nonblock);
+ssize_t pipecommon_splice_pipe(FAR struct file *in, FAR struct file *out,
+                               size_t len, bool nonblock, bool peek);
 int     pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
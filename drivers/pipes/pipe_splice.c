@@ -0,0 +1,336 @@
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <sys/uio.h>
+
+#include <stdbool.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "pipe_common.h"
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SPLICE_F_ALL (SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE | \
+                      SPLICE_F_GIFT)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Move data between two open files, at least one of which is a pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t file_splice(FAR struct file *in, FAR off_t *off_in,
+                           FAR struct file *out, FAR off_t *off_out,
+                           size_t len, unsigned int flags)
+{
+  bool inpipe  = pipecommon_ispipe(in);
+  bool outpipe = pipecommon_ispipe(out);
+  bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+
+  if ((in->f_oflags & O_RDOK) == 0 || (out->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if ((out->f_oflags & O_APPEND) != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Pipes have no file position */
+
+  if ((inpipe && off_in != NULL) || (outpipe && off_out != NULL))
+    {
+      return -ESPIPE;
+    }
+
+  if ((off_in != NULL && *off_in < 0) || (off_out != NULL && *off_out < 0))
+    {
+      return -EINVAL;
+    }
+
+  if (len > SSIZE_MAX)
+    {
+      len = SSIZE_MAX;
+    }
+
+  if (inpipe && outpipe)
+    {
+      return pipecommon_splice_pipe(in, out, len, nonblock, false);
+    }
+  else if (inpipe)
+    {
+      return pipecommon_splice_read(in, out, off_out, len, nonblock);
+    }
+  else if (outpipe)
+    {
+      return pipecommon_splice_write(out, in, off_in, len, nonblock);
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves up to 'len' bytes between two file descriptors, one of
+ *   which must refer to a pipe, without copying them through user space.
+ *   The bytes are transferred directly from (or into) the pipe's ring
+ *   buffer by the other file's read or write method.
+ *
+ * Input Parameters:
+ *   fd_in   - The source file descriptor
+ *   off_in  - NULL to use the file position of fd_in; otherwise the offset
+ *             to read from, advanced by the number of bytes moved.  Must be
+ *             NULL if fd_in is a pipe.
+ *   fd_out  - The destination file descriptor
+ *   off_out - As off_in, for fd_out
+ *   len     - The maximum number of bytes to move
+ *   flags   - A bit mask of SPLICE_F_* values.  Only SPLICE_F_NONBLOCK
+ *             changes the behaviour; the other flags are accepted as hints.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of input, or -1 with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  FAR struct file *in;
+  FAR struct file *out;
+  ssize_t ret;
+
+  if ((flags & ~SPLICE_F_ALL) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_in, &in);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &out);
+  if (ret < 0)
+    {
+      fs_putfilep(in);
+      goto errout;
+    }
+
+  ret = file_splice(in, off_in, out, off_out, len, flags);
+
+  fs_putfilep(out);
+  fs_putfilep(in);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() duplicates up to 'len' bytes from one pipe into another without
+ *   consuming them, so that the data can still be read or spliced from
+ *   fd_in afterwards.
+ *
+ * Input Parameters:
+ *   fd_in  - The read end of the source pipe
+ *   fd_out - The write end of the destination pipe
+ *   len    - The maximum number of bytes to duplicate
+ *   flags  - A bit mask of SPLICE_F_* values
+ *
+ * Returned Value:
+ *   The number of bytes duplicated, zero if the source pipe is empty and
+ *   has no writers, or -1 with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *in;
+  FAR struct file *out;
+  ssize_t ret;
+
+  if ((flags & ~SPLICE_F_ALL) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_in, &in);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &out);
+  if (ret < 0)
+    {
+      fs_putfilep(in);
+      goto errout;
+    }
+
+  if (!pipecommon_ispipe(in) || !pipecommon_ispipe(out))
+    {
+      ret = -EINVAL;
+    }
+  else if ((in->f_oflags & O_RDOK) == 0 || (out->f_oflags & O_WROK) == 0)
+    {
+      ret = -EBADF;
+    }
+  else
+    {
+      ret = pipecommon_splice_pipe(in, out, MIN(len, SSIZE_MAX),
+                                   (flags & SPLICE_F_NONBLOCK) != 0, true);
+    }
+
+  fs_putfilep(out);
+  fs_putfilep(in);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: vmsplice
+ *
+ * Description:
+ *   vmsplice() writes the user buffers described by 'iov' into a pipe, or,
+ *   if 'fd' is the read end of a pipe, reads the pipe into them.  There
+ *   are no page references to hand over in a flat address space, so this
+ *   is a single copy to or from the pipe buffer, like writev() or readv(),
+ *   with SPLICE_F_NONBLOCK applied.
+ *
+ * Input Parameters:
+ *   fd      - A file descriptor referring to a pipe
+ *   iov     - The user buffers
+ *   nr_segs - The number of entries in iov
+ *   flags   - A bit mask of SPLICE_F_* values
+ *
+ * Returned Value:
+ *   The number of bytes transferred, or -1 with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags)
+{
+  FAR struct file *filep;
+  struct uio uio;
+  ssize_t ret;
+
+  if ((flags & ~SPLICE_F_ALL) != 0 || nr_segs > IOV_MAX)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!pipecommon_ispipe(filep))
+    {
+      fs_putfilep(filep);
+      ret = -EBADF;
+      goto errout;
+    }
+
+  /* SPLICE_F_NONBLOCK applies to this call only, so it travels with the
+   * request rather than in the f_oflags shared with other users of the
+   * open file.
+   */
+
+  uio.uio_iov    = iov;
+  uio.uio_iovcnt = nr_segs;
+  uio.uio_flags  = (flags & SPLICE_F_NONBLOCK) != 0 ? UIO_NONBLOCK : 0;
+
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      ret = file_writev(filep, &uio);
+    }
+  else
+    {
+      ret = file_readv(filep, &uio);
+    }
+
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_PIPES */
@@ -71,6 +71,15 @@ struct pm_domain_s
   struct timespec wake[PM_COUNT];
   struct timespec sleep[PM_COUNT];
 
+  /* Completed sleeps of each state, and the wrong guesses reported by the
+   * governor: woken up before the target residency of the state (above),
+   * or slept long enough for a deeper state (below).
+   */
+
+  uint32_t usage[PM_COUNT];
+  uint32_t above[PM_COUNT];
+  uint32_t below[PM_COUNT];
+
   /* When procfs read update wake or sleep up-to-now */
 
   bool in_sleep;
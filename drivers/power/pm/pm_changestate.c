@@ -75,6 +75,7 @@ static void pm_stats(FAR struct pm_domain_s *dom, int curstate, int newstate)
       /* Wakeup from WFI */
 
       clock_timespec_add(&ts, &dom->sleep[curstate], &dom->sleep[curstate]);
+      dom->usage[curstate]++;
       dom->in_sleep = false;
     }
   else
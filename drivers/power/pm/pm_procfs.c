@@ -49,6 +49,8 @@
 #define STHDR "DOMAIN%-2d                  WAKE           SLEEP          TOTAL\n"
 #define PFHDR "CALLBACKS                 IDLE           STANDBY        SLEEP\n"
 #define WAHDR "DOMAIN%-2d                  STATE          COUNT          TIME\n"
+#define IDHDR "DOMAIN%-2d                  USAGE          ABOVE          BELOW\n"
+#define IDFMT "%-25s %-14" PRIu32 " %-14" PRIu32 " %" PRIu32 "\n"
 
 #ifdef CONFIG_SYSTEM_TIME64
 #  define STFMT "%-18s %8" PRIu64 "s %3" PRIu64 "%% %8" PRIu64 "s %3" \
@@ -109,6 +111,8 @@ static ssize_t pm_read_wakelock(FAR struct file *filep, FAR char *buffer,
                                 size_t buflen);
 static ssize_t pm_read_preparefail(FAR struct file *filep, FAR char *buffer,
                                    size_t buflen);
+static ssize_t pm_read_idle(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
 static ssize_t pm_read(FAR struct file *filep, FAR char *buffer,
                        size_t buflen);
 static int     pm_dup(FAR const struct file *oldp,
@@ -161,6 +165,7 @@ static const struct pm_file_ops_s g_pm_files[] =
   {"state",        pm_read_state},
   {"wakelock",     pm_read_wakelock},
   {"preparefail",  pm_read_preparefail},
+  {"idle",         pm_read_idle},
 };
 
 static FAR const char *g_pm_state[PM_COUNT] =
@@ -533,6 +538,82 @@ static ssize_t pm_read_preparefail(FAR struct file *filep, FAR char *buffer,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: pm_read_idle
+ *
+ * Description:
+ *   The number of completed sleeps of each state, and how often the
+ *   governor picked a state that was too deep or too shallow.
+ *
+ ****************************************************************************/
+
+static ssize_t pm_read_idle(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct pm_domain_s *dom;
+  FAR struct pm_file_s *pmfile;
+  uint32_t usage[PM_COUNT];
+  uint32_t above[PM_COUNT];
+  uint32_t below[PM_COUNT];
+  irqstate_t flags;
+  size_t totalsize = 0;
+  size_t linesize;
+  size_t copysize;
+  off_t offset;
+  uint32_t state;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  pmfile = (FAR struct pm_file_s *)filep->f_priv;
+  dom    = &g_pmdomains[pmfile->domain];
+  DEBUGASSERT(pmfile);
+  DEBUGASSERT(dom);
+
+  /* Save the file offset and the user buffer information */
+
+  offset = filep->f_pos;
+
+  /* Then list the idle statistics */
+
+  linesize = snprintf(pmfile->line, PM_LINELEN, IDHDR, pmfile->domain);
+  copysize = procfs_memcpy(pmfile->line, linesize, buffer,
+                           buflen, &offset);
+
+  totalsize += copysize;
+
+  flags = pm_domain_lock(pmfile->domain);
+
+  for (state = 0; state < PM_COUNT; state++)
+    {
+      usage[state] = dom->usage[state];
+      above[state] = dom->above[state];
+      below[state] = dom->below[state];
+    }
+
+  pm_domain_unlock(pmfile->domain, flags);
+
+  for (state = 0; state < PM_COUNT && totalsize < buflen; state++)
+    {
+      linesize = snprintf(pmfile->line, PM_LINELEN, IDFMT,
+                          g_pm_state[state],
+                          usage[state],
+                          above[state],
+                          below[state]);
+      buffer += copysize;
+      buflen -= copysize;
+
+      copysize = procfs_memcpy(pmfile->line, linesize, buffer,
+                               buflen, &offset);
+
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
 /****************************************************************************
  * Name: pm_read
  ****************************************************************************/
@@ -0,0 +1,335 @@
+/****************************************************************************
+ * drivers/power/pm/predict_governor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/power/pm.h>
+#include <nuttx/wdog.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PREDICT_HISTORY CONFIG_PM_GOVERNOR_PREDICT_HISTORY
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+struct pm_predict_governor_domain_s
+{
+  /* The last observed idle durations in ticks, a ring of nsamples */
+
+  clock_t history[PREDICT_HISTORY];
+  uint8_t index;
+  uint8_t nsamples;
+
+  /* The state entered and when, to measure the idle period on restore */
+
+  enum pm_state_e state;
+  clock_t enter;
+};
+
+struct pm_predict_governor_s
+{
+  struct pm_predict_governor_domain_s domain[CONFIG_PM_NDOMAINS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void predict_governor_statechanged(int domain,
+                                          enum pm_state_e newstate);
+static enum pm_state_e predict_governor_checkstate(int domain);
+static void predict_governor_activity(int domain, int count);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_predict_governor_ops =
+{
+  NULL,                          /* initialize */
+  NULL,                          /* deinitialize */
+  predict_governor_statechanged, /* statechanged */
+  predict_governor_checkstate,   /* checkstate */
+  predict_governor_activity,     /* activity */
+  NULL                           /* priv */
+};
+
+/* The minimum time a state must last to save energy */
+
+static const clock_t g_predict_governor_residency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_PREDICT_IDLE_RESIDENCY,
+  CONFIG_PM_GOVERNOR_PREDICT_STANDBY_RESIDENCY,
+  CONFIG_PM_GOVERNOR_PREDICT_SLEEP_RESIDENCY,
+};
+
+/* The time it takes to get back to normal from a state */
+
+static const clock_t g_predict_governor_latency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_PREDICT_IDLE_LATENCY,
+  CONFIG_PM_GOVERNOR_PREDICT_STANDBY_LATENCY,
+  CONFIG_PM_GOVERNOR_PREDICT_SLEEP_LATENCY,
+};
+
+static struct pm_predict_governor_s g_predict_governor;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: predict_governor_fits
+ *
+ * Description:
+ *   Check whether an idle period of 'ticks' pays off the given state.
+ *
+ ****************************************************************************/
+
+static bool predict_governor_fits(enum pm_state_e state, clock_t ticks)
+{
+  return ticks >= g_predict_governor_residency[state] +
+                  g_predict_governor_latency[state];
+}
+
+/****************************************************************************
+ * Name: predict_governor_typical
+ *
+ * Description:
+ *   Look for a repeating pattern in the idle history: use the average if
+ *   the samples are close to it, otherwise drop the longest sample as an
+ *   outlier and retry, as long as three quarters of the samples remain.
+ *
+ * Returned Value:
+ *   The expected idle duration in ticks, CLOCK_MAX if there is no pattern.
+ *
+ ****************************************************************************/
+
+static clock_t
+predict_governor_typical(FAR struct pm_predict_governor_domain_s *gdom)
+{
+  clock_t thresh = CLOCK_MAX;
+  uint64_t variance;
+  uint64_t avg;
+  int64_t diff;
+  clock_t max;
+  int divisor;
+  int i;
+
+  if (gdom->nsamples < PREDICT_HISTORY)
+    {
+      return CLOCK_MAX;
+    }
+
+  for (; ; )
+    {
+      avg     = 0;
+      max     = 0;
+      divisor = 0;
+
+      for (i = 0; i < PREDICT_HISTORY; i++)
+        {
+          if (gdom->history[i] <= thresh)
+            {
+              avg += gdom->history[i];
+              max  = MAX(max, gdom->history[i]);
+              divisor++;
+            }
+        }
+
+      avg /= divisor;
+
+      variance = 0;
+      for (i = 0; i < PREDICT_HISTORY; i++)
+        {
+          if (gdom->history[i] <= thresh)
+            {
+              diff      = gdom->history[i] - avg;
+              variance += diff * diff;
+            }
+        }
+
+      variance /= divisor;
+
+      /* Accept the average if the standard deviation is within 1/6 of
+       * it.
+       */
+
+      if (variance * 36 <= avg * avg)
+        {
+          return avg;
+        }
+
+      if (divisor * 4 <= PREDICT_HISTORY * 3)
+        {
+          return CLOCK_MAX;
+        }
+
+      thresh = max - 1;
+    }
+}
+
+/****************************************************************************
+ * Name: predict_governor_statechanged
+ ****************************************************************************/
+
+static void predict_governor_statechanged(int domain,
+                                          enum pm_state_e newstate)
+{
+  FAR struct pm_predict_governor_domain_s *gdom;
+#ifdef CONFIG_PM_PROCFS
+  FAR struct pm_domain_s *pdom;
+#endif
+  clock_t measured;
+
+  gdom = &g_predict_governor.domain[domain];
+
+  if (newstate != PM_RESTORE)
+    {
+      gdom->state = newstate;
+      gdom->enter = clock_systime_ticks();
+      return;
+    }
+
+  /* Wakeup, record how long the idle period really was.  Called with the
+   * domain locked.
+   */
+
+  measured = clock_systime_ticks() - gdom->enter;
+
+  gdom->history[gdom->index] = measured;
+  gdom->index = (gdom->index + 1) % PREDICT_HISTORY;
+  if (gdom->nsamples < PREDICT_HISTORY)
+    {
+      gdom->nsamples++;
+    }
+
+#ifdef CONFIG_PM_PROCFS
+  pdom = &g_pmdomains[domain];
+
+  if (measured < g_predict_governor_residency[gdom->state])
+    {
+      pdom->above[gdom->state]++;
+    }
+  else if (gdom->state < PM_COUNT - 1 &&
+           predict_governor_fits(gdom->state + 1, measured))
+    {
+      pdom->below[gdom->state]++;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: predict_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e predict_governor_checkstate(int domain)
+{
+  FAR struct pm_predict_governor_domain_s *gdom;
+  FAR struct pm_domain_s *pdom;
+  enum pm_state_e state;
+  irqstate_t flags;
+  clock_t predicted;
+
+  gdom = &g_predict_governor.domain[domain];
+  pdom = &g_pmdomains[domain];
+  state = PM_NORMAL;
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = spin_lock_irqsave(&pdom->lock);
+
+  /* Find the lowest power-level which is not locked. */
+
+  while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+    {
+      state++;
+    }
+
+  spin_unlock_irqrestore(&pdom->lock, flags);
+
+  /* The idle period ends at the next timer expiry at the latest, and
+   * earlier if the recent history shows a shorter repeating pattern.
+   */
+
+  predicted = MIN(wd_getnext(), predict_governor_typical(gdom));
+
+  /* Pick the deepest allowed state that pays off within that period */
+
+  while (state > PM_NORMAL && !predict_governor_fits(state, predicted))
+    {
+      state--;
+    }
+
+  return state;
+}
+
+/****************************************************************************
+ * Name: predict_governor_activity
+ ****************************************************************************/
+
+static void predict_governor_activity(int domain, int count)
+{
+  pm_staytimeout(domain, PM_NORMAL, (count ? count : 1) * 1000);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_predict_governor_initialize
+ *
+ * Description:
+ *   Return the predictive governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_predict_governor_initialize(void)
+{
+  return &g_predict_governor_ops;
+}
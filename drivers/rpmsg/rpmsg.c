@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <metal/cache.h>
 #include <metal/sys.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
@@ -33,6 +34,7 @@
 #include <nuttx/rpmsg/rpmsg.h>
 
 #include "rpmsg_ping.h"
+#include "rpmsg_router.h"
 
 /****************************************************************************
  * Private Types
@@ -209,6 +211,113 @@ FAR const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev)
   return rpmsg ? rpmsg->ops->get_cpuname(rpmsg) : NULL;
 }
 
+/****************************************************************************
+ * Name: rpmsg_shm_alloc
+ *
+ * Description:
+ *   Allocate a buffer from the memory shared with the remote behind the
+ *   endpoint.  The returned offset travels in a message and is resolved
+ *   by the remote with rpmsg_shm_get(), so large payloads move without
+ *   being chunked into rpmsg buffers.
+ *
+ * Input Parameters:
+ *   ept    - The endpoint the buffer will be exchanged on
+ *   size   - The buffer size in bytes
+ *   offset - Location to return the buffer offset
+ *
+ * Returned Value:
+ *   The local address of the buffer, NULL if the transport has no shared
+ *   pool or the pool is exhausted.  Callers fall back to copying.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_shm_alloc(FAR struct rpmsg_endpoint *ept, size_t size,
+                          FAR uint32_t *offset)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept || !offset)
+    {
+      return NULL;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (!rpmsg || !rpmsg->ops->shm_alloc)
+    {
+      return NULL;
+    }
+
+  return rpmsg->ops->shm_alloc(rpmsg, size, offset);
+}
+
+void rpmsg_shm_free(FAR struct rpmsg_endpoint *ept, FAR void *ptr)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept || !ptr)
+    {
+      return;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (rpmsg && rpmsg->ops->shm_free)
+    {
+      rpmsg->ops->shm_free(rpmsg, ptr);
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_shm_get
+ *
+ * Description:
+ *   Translate an offset received from the remote to a local address,
+ *   checking that the whole range lies inside the shared pool.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_shm_get(FAR struct rpmsg_endpoint *ept, uint32_t offset,
+                        size_t size)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept)
+    {
+      return NULL;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (!rpmsg || !rpmsg->ops->shm_get)
+    {
+      return NULL;
+    }
+
+  return rpmsg->ops->shm_get(rpmsg, offset, size);
+}
+
+/****************************************************************************
+ * Name: rpmsg_shm_flush/rpmsg_shm_invalidate
+ *
+ * Description:
+ *   Cache maintenance for shared buffers: flush after the local side
+ *   wrote a buffer and before it is handed over, invalidate before reading
+ *   a buffer the remote filled.
+ *
+ ****************************************************************************/
+
+void rpmsg_shm_flush(FAR void *ptr, size_t size)
+{
+#ifdef CONFIG_OPENAMP_CACHE
+  metal_cache_flush(ptr, size);
+#endif
+}
+
+void rpmsg_shm_invalidate(FAR void *ptr, size_t size)
+{
+#ifdef CONFIG_OPENAMP_CACHE
+  metal_cache_invalidate(ptr, size);
+#endif
+}
+
 int rpmsg_register_callback(FAR void *priv,
                             rpmsg_dev_cb_t device_created,
                             rpmsg_dev_cb_t device_destroy,
@@ -537,4 +646,7 @@ int rpmsg_panic(FAR const char *cpuname)
 void rpmsg_dump_all(void)
 {
   rpmsg_ioctl(NULL, RPMSGIOC_DUMP, 0);
+#ifdef CONFIG_RPMSG_ROUTER
+  rpmsg_router_hub_dump();
+#endif
 }
@@ -27,8 +27,10 @@
 #include <debug.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <lzf.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <nuttx/crc16.h>
 #include <nuttx/kmalloc.h>
@@ -51,6 +53,9 @@
 
 #define RPMSG_PORT_UART_BUFLEN             256
 
+#define RPMSG_PORT_UART_CMD_DATA           0
+#define RPMSG_PORT_UART_CMD_LZF            1
+
 #define RPMSG_PORT_UART_RX_WAIT_START      1
 #define RPMSG_PORT_UART_RX_RECV_NORMAL     2
 #define RPMSG_PORT_UART_RX_RECV_ESCAPE     3
@@ -81,6 +86,11 @@ struct rpmsg_port_uart_s
   char                   localcpu[RPMSG_NAME_SIZE];
   rpmsg_port_rx_cb_t     rx_cb;
   bool                   connected;
+#ifdef CONFIG_RPMSG_PORT_UART_LZF
+  lzf_state_t            htab;     /* Compressor hash table */
+  FAR uint8_t            *ztx;     /* Compressed tx frame */
+  FAR uint8_t            *zrx;     /* Decompressed rx payload */
+#endif
 };
 
 /****************************************************************************
@@ -185,6 +195,91 @@ static void rpmsg_port_uart_send_frame(FAR struct rpmsg_port_uart_s *rpuart,
   rpmsg_port_uart_send_packet(rpuart, buf, next);
 }
 
+#ifdef CONFIG_RPMSG_PORT_UART_LZF
+
+/****************************************************************************
+ * Name: rpmsg_port_uart_compress
+ *
+ * Description:
+ *   Compress the payload of a data frame into the compressed tx frame.
+ *   Return the frame to send, the original one if it does not shrink.
+ *
+ ****************************************************************************/
+
+static FAR struct rpmsg_port_header_s *
+rpmsg_port_uart_compress(FAR struct rpmsg_port_uart_s *rpuart,
+                         FAR struct rpmsg_port_header_s *hdr)
+{
+  FAR struct rpmsg_port_header_s *zhdr =
+    (FAR struct rpmsg_port_header_s *)rpuart->ztx;
+  struct rpmsg_port_header_s saved = *hdr;
+  FAR struct lzf_header_s *lzfhdr = NULL;
+  size_t payload = hdr->len - sizeof(*hdr);
+  size_t zlen;
+
+  if (payload < CONFIG_RPMSG_PORT_UART_LZF_THRESHOLD)
+    {
+      return hdr;
+    }
+
+  /* Ask for a strictly smaller result.  An incompressible payload gets a
+   * type 0 lzf header stored right in front of it, that is over our own
+   * frame header, which is restored below.
+   */
+
+  zlen = lzf_compress(hdr->buf, payload, zhdr->buf + LZF_TYPE1_HDR_SIZE,
+                      payload - LZF_TYPE1_HDR_SIZE - 1, rpuart->htab,
+                      &lzfhdr);
+  if (zlen == 0 || lzfhdr == NULL || lzfhdr->lzf_type != LZF_TYPE1_HDR)
+    {
+      *hdr = saved;
+      return hdr;
+    }
+
+  zhdr->cmd = RPMSG_PORT_UART_CMD_LZF;
+  zhdr->len = sizeof(*zhdr) + zlen;
+  return zhdr;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_uart_decompress
+ *
+ * Description:
+ *   Expand a compressed frame in place.  Return false if it is corrupted.
+ *
+ ****************************************************************************/
+
+static bool
+rpmsg_port_uart_decompress(FAR struct rpmsg_port_uart_s *rpuart,
+                           FAR struct rpmsg_port_header_s *hdr)
+{
+  FAR struct lzf_type1_header_s *lzfhdr =
+    (FAR struct lzf_type1_header_s *)hdr->buf;
+  unsigned int clen;
+  unsigned int ulen;
+
+  clen = (lzfhdr->lzf_clen[0] << 8) | lzfhdr->lzf_clen[1];
+  if (lzfhdr->lzf_type != LZF_TYPE1_HDR ||
+      sizeof(*hdr) + LZF_TYPE1_HDR_SIZE + clen > hdr->len)
+    {
+      return false;
+    }
+
+  ulen = lzf_decompress(lzfhdr + 1, clen, rpuart->zrx,
+                        rpuart->port.rxq.len - sizeof(*hdr));
+  if (ulen == 0)
+    {
+      return false;
+    }
+
+  memcpy(hdr->buf, rpuart->zrx, ulen);
+  hdr->cmd = RPMSG_PORT_UART_CMD_DATA;
+  hdr->len = sizeof(*hdr) + ulen;
+  return true;
+}
+
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_uart_send_data
  *
@@ -198,7 +293,11 @@ static void rpmsg_port_uart_send_data(FAR struct rpmsg_port_uart_s *rpuart,
 {
   rpmsgdbg("Send data len: %" PRIu16 "\n", hdr->len);
 
-  hdr->cmd = 0;
+  hdr->cmd = RPMSG_PORT_UART_CMD_DATA;
+#ifdef CONFIG_RPMSG_PORT_UART_LZF
+  hdr = rpmsg_port_uart_compress(rpuart, hdr);
+#endif
+
   hdr->avail = 0;
   hdr->crc = rpmsg_port_uart_crc16(hdr);
 
@@ -361,6 +460,15 @@ static int rpmsg_port_uart_rx_thread(int argc, FAR char *argv[])
                     DEBUGASSERT(hdr->crc == 0 ||
                                 hdr->crc == rpmsg_port_uart_crc16(hdr));
 
+#ifdef CONFIG_RPMSG_PORT_UART_LZF
+                    if (hdr->cmd == RPMSG_PORT_UART_CMD_LZF &&
+                        !rpmsg_port_uart_decompress(rpuart, hdr))
+                      {
+                        rpmsgerr("Drop corrupted compressed frame\n");
+                        rpmsg_port_queue_return_buffer(rxq, hdr);
+                      }
+                    else
+#endif
                     if (rpuart->rx_cb != NULL)
                       {
                         rpuart->rx_cb(&rpuart->port, hdr);
@@ -479,6 +587,17 @@ int rpmsg_port_uart_initialize(FAR const struct rpmsg_port_config_s *cfg,
       goto err_rpmsg_port;
     }
 
+#ifdef CONFIG_RPMSG_PORT_UART_LZF
+  rpuart->ztx = kmm_malloc(cfg->txlen);
+  rpuart->zrx = kmm_malloc(cfg->rxlen);
+  if (rpuart->ztx == NULL || rpuart->zrx == NULL)
+    {
+      rpmsgerr("Malloc lzf buffers failed\n");
+      ret = -ENOMEM;
+      goto err_rx_thread;
+    }
+#endif
+
   snprintf(arg1, sizeof(arg1), "%p", rpuart);
 
   argv[0] = (FAR char *)cfg->remotecpu;
@@ -513,6 +632,10 @@ int rpmsg_port_uart_initialize(FAR const struct rpmsg_port_config_s *cfg,
 err_tx_thread:
   kthread_delete(rx);
 err_rx_thread:
+#ifdef CONFIG_RPMSG_PORT_UART_LZF
+  kmm_free(rpuart->ztx);
+  kmm_free(rpuart->zrx);
+#endif
   rpmsg_port_uninitialize(&rpuart->port);
 err_rpmsg_port:
   file_close(&rpuart->file);
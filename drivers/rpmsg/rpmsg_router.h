@@ -56,5 +56,11 @@ begin_packed_struct struct rpmsg_router_s
   char     cpuname[RPMSG_ROUTER_CPUNAME_LEN];
 } end_packed_struct;
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+void rpmsg_router_hub_dump(void);
+
 #endif /* CONFIG_RPMSG_ROUTER */
 #endif /* __DRIVERS_RPMSG_RPMSG_ROUTER_H */
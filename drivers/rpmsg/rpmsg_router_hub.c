@@ -27,14 +27,19 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
 #include <sys/param.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 #include <rpmsg/rpmsg_internal.h>
 
 #include "rpmsg_router.h"
@@ -52,6 +57,12 @@
  *
  ****************************************************************************/
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RPMSG_ROUTER_HUB_RETRY  1 /* Ticks before retrying a full link */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,10 +74,147 @@ struct rpmsg_router_hub_s
   mutex_t               lock;
 };
 
+/* One forwarding direction.  The endpoint sends to the destination edge,
+ * its priv is the endpoint that receives from the source edge.
+ */
+
+struct rpmsg_router_route_s
+{
+  struct rpmsg_endpoint ept;
+  struct list_node      node;     /* Entry of g_rpmsg_router_routes */
+  struct list_node      pending;  /* Held rx buffers waiting for tx room */
+  spinlock_t            lock;
+  struct work_s         work;
+
+  /* Statistics */
+
+  uint32_t              nmsgs;    /* Messages forwarded */
+  uint32_t              ndefer;   /* Messages that waited for a tx buffer */
+  uint32_t              ndrops;   /* Messages lost on a send error */
+  uint64_t              nbytes;   /* Bytes forwarded */
+  clock_t               maxlat;   /* Worst hub residency */
+  clock_t               totlat;   /* Sum of hub residency */
+};
+
+struct rpmsg_router_pending_s
+{
+  struct list_node      node;
+  FAR void              *data;
+  size_t                len;
+  clock_t               stamp;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct list_node g_rpmsg_router_routes =
+  LIST_INITIAL_VALUE(g_rpmsg_router_routes);
+static spinlock_t g_rpmsg_router_lock = SP_UNLOCKED;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rpmsg_router_hub_account
+ ****************************************************************************/
+
+static void rpmsg_router_hub_account(FAR struct rpmsg_router_route_s *route,
+                                     int ret, size_t len, clock_t stamp)
+{
+  clock_t lat;
+
+  if (ret < 0)
+    {
+      route->ndrops++;
+      return;
+    }
+
+  lat = perf_gettime() - stamp;
+  route->nmsgs++;
+  route->nbytes += len;
+  route->totlat += lat;
+  if (lat > route->maxlat)
+    {
+      route->maxlat = lat;
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_hub_work
+ *
+ * Description:
+ *   Drain the messages that found the destination link full, in arrival
+ *   order and as many as the link takes, then release their rx buffers.
+ *
+ ****************************************************************************/
+
+static void rpmsg_router_hub_work(FAR void *arg)
+{
+  FAR struct rpmsg_router_route_s *route = arg;
+  FAR struct rpmsg_router_pending_s *pending;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&route->lock);
+      pending = list_peek_head_type(&route->pending,
+                                    struct rpmsg_router_pending_s, node);
+      spin_unlock_irqrestore(&route->lock, flags);
+      if (pending == NULL)
+        {
+          break;
+        }
+
+      ret = rpmsg_trysend(&route->ept, pending->data, pending->len);
+      if (ret == RPMSG_ERR_NO_BUFF)
+        {
+          work_queue(LPWORK, &route->work, rpmsg_router_hub_work, route,
+                     RPMSG_ROUTER_HUB_RETRY);
+          break;
+        }
+
+      rpmsg_router_hub_account(route, ret, pending->len, pending->stamp);
+
+      /* Only dequeue after the send, so that the rx callback keeps queueing
+       * behind it and the order is preserved.
+       */
+
+      flags = spin_lock_irqsave(&route->lock);
+      list_delete(&pending->node);
+      spin_unlock_irqrestore(&route->lock, flags);
+
+      rpmsg_release_rx_buffer(route->ept.priv, pending->data);
+      kmm_free(pending);
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_hub_flush
+ *
+ * Description:
+ *   Drop the messages still waiting on a route that is going away.
+ *
+ ****************************************************************************/
+
+static void rpmsg_router_hub_flush(FAR struct rpmsg_router_route_s *route)
+{
+  FAR struct rpmsg_router_pending_s *pending;
+  FAR struct rpmsg_router_pending_s *tmp;
+
+  work_cancel_sync(LPWORK, &route->work);
+  list_for_every_entry_safe(&route->pending, pending, tmp,
+                            struct rpmsg_router_pending_s, node)
+    {
+      list_delete(&pending->node);
+      rpmsg_release_rx_buffer(route->ept.priv, pending->data);
+      kmm_free(pending);
+      route->ndrops++;
+    }
+}
+
 /****************************************************************************
  * Name: rpmsg_router_hub_cb
  *
@@ -75,6 +223,11 @@ struct rpmsg_router_hub_s
  *   It will receive data from source edge core by ept(r:cpu:name), and find
  *   dest edge core communicating with it, send data to dest edge core.
  *
+ *   The message is forwarded with a non-blocking send.  If the destination
+ *   link has no free tx buffer the rx buffer is held instead of being
+ *   copied, and the route work drains it later, so a slow edge never
+ *   stalls the rx thread of the other link.
+ *
  * Parameters:
  *   ept - rpmsg_endpoint for communicating with edge core (r:dst_cpu:name)
  *   data - received data
@@ -92,6 +245,12 @@ static int rpmsg_router_hub_cb(FAR struct rpmsg_endpoint *ept,
                                uint32_t src, FAR void *priv)
 {
   FAR struct rpmsg_endpoint *dst_ept = priv;
+  FAR struct rpmsg_router_route_s *route;
+  FAR struct rpmsg_router_pending_s *pending;
+  clock_t stamp = perf_gettime();
+  irqstate_t flags;
+  bool empty;
+  int ret;
 
   /* Retransmit data to dest edge core */
 
@@ -100,7 +259,92 @@ static int rpmsg_router_hub_cb(FAR struct rpmsg_endpoint *ept,
       return -EINVAL;
     }
 
-  return rpmsg_send(dst_ept, data, len);
+  route = container_of(dst_ept, struct rpmsg_router_route_s, ept);
+
+  flags = spin_lock_irqsave(&route->lock);
+  empty = list_is_empty(&route->pending);
+  spin_unlock_irqrestore(&route->lock, flags);
+
+  /* Messages already waiting go first, otherwise try the fast path */
+
+  if (empty)
+    {
+      ret = rpmsg_trysend(dst_ept, data, len);
+      if (ret != RPMSG_ERR_NO_BUFF)
+        {
+          rpmsg_router_hub_account(route, ret, len, stamp);
+          return ret;
+        }
+    }
+
+  pending = kmm_malloc(sizeof(*pending));
+  if (pending == NULL)
+    {
+      /* Fall back to waiting for the link like before */
+
+      ret = rpmsg_send(dst_ept, data, len);
+      rpmsg_router_hub_account(route, ret, len, stamp);
+      return ret;
+    }
+
+  pending->data  = data;
+  pending->len   = len;
+  pending->stamp = stamp;
+  rpmsg_hold_rx_buffer(ept, data);
+
+  flags = spin_lock_irqsave(&route->lock);
+  list_add_tail(&route->pending, &pending->node);
+  route->ndefer++;
+  spin_unlock_irqrestore(&route->lock, flags);
+
+  if (work_available(&route->work))
+    {
+      work_queue(LPWORK, &route->work, rpmsg_router_hub_work, route, 0);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_hub_route_alloc
+ ****************************************************************************/
+
+static FAR struct rpmsg_endpoint *rpmsg_router_hub_route_alloc(void)
+{
+  FAR struct rpmsg_router_route_s *route;
+  irqstate_t flags;
+
+  route = kmm_zalloc(sizeof(*route));
+  if (route == NULL)
+    {
+      return NULL;
+    }
+
+  list_initialize(&route->pending);
+  spin_lock_init(&route->lock);
+
+  flags = spin_lock_irqsave(&g_rpmsg_router_lock);
+  list_add_tail(&g_rpmsg_router_routes, &route->node);
+  spin_unlock_irqrestore(&g_rpmsg_router_lock, flags);
+
+  return &route->ept;
+}
+
+/****************************************************************************
+ * Name: rpmsg_router_hub_route_free
+ ****************************************************************************/
+
+static void rpmsg_router_hub_route_free(FAR struct rpmsg_endpoint *ept)
+{
+  FAR struct rpmsg_router_route_s *route =
+    container_of(ept, struct rpmsg_router_route_s, ept);
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_rpmsg_router_lock);
+  list_delete(&route->node);
+  spin_unlock_irqrestore(&g_rpmsg_router_lock, flags);
+
+  kmm_free(route);
 }
 
 /****************************************************************************
@@ -118,18 +362,31 @@ static void rpmsg_router_hub_unbind(FAR struct rpmsg_endpoint *ept)
 {
   FAR struct rpmsg_endpoint *dst_ept = ept->priv;
 
+  /* Release the rx buffers held by both directions before the endpoints
+   * they belong to are destroyed.
+   */
+
+  rpmsg_router_hub_flush(container_of(ept, struct rpmsg_router_route_s,
+                                      ept));
+  if (dst_ept)
+    {
+      rpmsg_router_hub_flush(container_of(dst_ept,
+                                          struct rpmsg_router_route_s,
+                                          ept));
+    }
+
   /* Destroy dest edge ept firstly */
 
   if (dst_ept)
     {
       rpmsg_destroy_ept(dst_ept);
-      kmm_free(dst_ept);
+      rpmsg_router_hub_route_free(dst_ept);
     }
 
   /* Destroy source edge ept */
 
   rpmsg_destroy_ept(ept);
-  kmm_free(ept);
+  rpmsg_router_hub_route_free(ept);
 }
 
 /****************************************************************************
@@ -267,8 +524,8 @@ static void rpmsg_router_hub_bind(FAR struct rpmsg_device *rdev,
            name + RPMSG_ROUTER_NAME_PREFIX_LEN +
            strlen(hub->cpuname[1 - i]));
 
-  src_ept = kmm_zalloc(sizeof(*src_ept));
-  dst_ept = kmm_zalloc(sizeof(*dst_ept));
+  src_ept = rpmsg_router_hub_route_alloc();
+  dst_ept = rpmsg_router_hub_route_alloc();
 
   DEBUGASSERT(src_ept && dst_ept);
 
@@ -289,8 +546,8 @@ static void rpmsg_router_hub_bind(FAR struct rpmsg_device *rdev,
                          rpmsg_router_hub_unbind);
   if (ret < 0)
     {
-      kmm_free(dst_ept);
-      kmm_free(src_ept);
+      rpmsg_router_hub_route_free(dst_ept);
+      rpmsg_router_hub_route_free(src_ept);
     }
 
   nxmutex_unlock(&hub->lock);
@@ -424,6 +681,40 @@ static void rpmsg_router_destroy(FAR struct rpmsg_device *rdev,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rpmsg_router_hub_dump
+ *
+ * Description:
+ *   Print the forwarding statistics of every route through this hub.
+ *
+ ****************************************************************************/
+
+void rpmsg_router_hub_dump(void)
+{
+  FAR struct rpmsg_router_route_s *route;
+  struct timespec maxlat;
+  struct timespec avglat;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_rpmsg_router_lock);
+  list_for_every_entry(&g_rpmsg_router_routes, route,
+                       struct rpmsg_router_route_s, node)
+    {
+      perf_convert(route->maxlat, &maxlat);
+      perf_convert(route->nmsgs ? route->totlat / route->nmsgs : 0,
+                   &avglat);
+      metal_log(METAL_LOG_EMERGENCY,
+                "route %s -> %s: msgs %" PRIu32 " bytes %" PRIu64
+                " defer %" PRIu32 " drop %" PRIu32 " avg %ldus max %ldus\n",
+                route->ept.name, rpmsg_get_cpuname(route->ept.rdev),
+                route->nmsgs, route->nbytes, route->ndefer, route->ndrops,
+                (long)(avglat.tv_sec * 1000000 + avglat.tv_nsec / 1000),
+                (long)(maxlat.tv_sec * 1000000 + maxlat.tv_nsec / 1000));
+    }
+
+  spin_unlock_irqrestore(&g_rpmsg_router_lock, flags);
+}
+
 /****************************************************************************
  * Name: rpmsg_router_hub_init
  *
@@ -27,12 +27,14 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <sys/param.h>
 
 #include <metal/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/power/pm.h>
 #include <nuttx/semaphore.h>
@@ -49,6 +51,13 @@
 #define RPMSG_VIRTIO_VRING0_NOTIFYID 1
 #define RPMSG_VIRTIO_VRING1_NOTIFYID 2
 
+/* Shared pool carve-outs are cache line aligned and sized, so cache
+ * maintenance on one never touches a neighbour owned by the other side.
+ */
+
+#define RPMSG_VIRTIO_SHM_ALIGN       64
+#define RPMSG_VIRTIO_SHM_MINSIZE     4096
+
 #ifdef CONFIG_OPENAMP_CACHE
 #  define RPMSG_VIRTIO_INVALIDATE(x) metal_cache_invalidate(&x, sizeof(x))
 #else
@@ -72,6 +81,11 @@ struct rpmsg_virtio_priv_s
   sem_t                         semrx;
   pid_t                         tid;
   uint16_t                      headrx;
+  uint32_t                      nnotify;   /* Kicks sent to the remote */
+  uint32_t                      ncallback; /* Kicks received */
+  FAR char                      *shmbase;  /* Shared pool, both halves */
+  size_t                        shmsize;
+  FAR struct mm_heap_s          *shmheap;  /* Half owned by this side */
 #ifdef CONFIG_RPMSG_VIRTIO_PM
   struct pm_wakelock_s          wakelock;
   struct wdog_s                 wdog;
@@ -89,6 +103,11 @@ static void rpmsg_virtio_dump(FAR struct rpmsg_s *rpmsg);
 static FAR const char *
 rpmsg_virtio_get_local_cpuname(FAR struct rpmsg_s *rpmsg);
 static FAR const char *rpmsg_virtio_get_cpuname(FAR struct rpmsg_s *rpmsg);
+static FAR void *rpmsg_virtio_shm_alloc(FAR struct rpmsg_s *rpmsg,
+                                        size_t size, FAR uint32_t *offset);
+static void rpmsg_virtio_shm_free(FAR struct rpmsg_s *rpmsg, FAR void *ptr);
+static FAR void *rpmsg_virtio_shm_get(FAR struct rpmsg_s *rpmsg,
+                                      uint32_t offset, size_t size);
 
 static int rpmsg_virtio_create_virtqueues_(FAR struct virtio_device *vdev,
                                            unsigned int flags,
@@ -116,6 +135,9 @@ static const struct rpmsg_ops_s g_rpmsg_virtio_ops =
   .dump               = rpmsg_virtio_dump,
   .get_local_cpuname  = rpmsg_virtio_get_local_cpuname,
   .get_cpuname        = rpmsg_virtio_get_cpuname,
+  .shm_alloc          = rpmsg_virtio_shm_alloc,
+  .shm_free           = rpmsg_virtio_shm_free,
+  .shm_get            = rpmsg_virtio_shm_get,
 };
 
 static const struct virtio_dispatch g_rpmsg_virtio_dispatch =
@@ -358,6 +380,7 @@ static void rpmsg_virtio_notify(FAR struct virtqueue *vq)
       rpmsg_virtio_pm_action(priv, true);
     }
 
+  priv->nnotify++;
   RPMSG_VIRTIO_NOTIFY(priv->dev,
                       vdev->vrings_info[vq->vq_queue_index].notifyid);
 }
@@ -487,8 +510,10 @@ static void rpmsg_virtio_dump(FAR struct rpmsg_s *rpmsg)
   FAR struct metal_list *node;
   bool needlock = true;
 
-  metal_log(METAL_LOG_EMERGENCY, "Remote: %s headrx %d\n",
-            RPMSG_VIRTIO_GET_CPUNAME(priv->dev), priv->headrx);
+  metal_log(METAL_LOG_EMERGENCY,
+            "Remote: %s headrx %d notify %" PRIu32 " callback %" PRIu32
+            "\n", RPMSG_VIRTIO_GET_CPUNAME(priv->dev), priv->headrx,
+            priv->nnotify, priv->ncallback);
 
   if (!rvdev->vdev)
     {
@@ -558,6 +583,94 @@ static FAR const char *rpmsg_virtio_get_cpuname(FAR struct rpmsg_s *rpmsg)
   return RPMSG_VIRTIO_GET_CPUNAME(priv->dev);
 }
 
+static FAR void *rpmsg_virtio_shm_alloc(FAR struct rpmsg_s *rpmsg,
+                                        size_t size, FAR uint32_t *offset)
+{
+  FAR struct rpmsg_virtio_priv_s *priv =
+      (FAR struct rpmsg_virtio_priv_s *)rpmsg;
+  FAR char *ptr;
+
+  if (priv->shmheap == NULL)
+    {
+      return NULL;
+    }
+
+  ptr = mm_memalign(priv->shmheap, RPMSG_VIRTIO_SHM_ALIGN,
+                    ALIGN_UP(size, RPMSG_VIRTIO_SHM_ALIGN));
+  if (ptr != NULL)
+    {
+      *offset = ptr - priv->shmbase;
+    }
+
+  return ptr;
+}
+
+static void rpmsg_virtio_shm_free(FAR struct rpmsg_s *rpmsg, FAR void *ptr)
+{
+  FAR struct rpmsg_virtio_priv_s *priv =
+      (FAR struct rpmsg_virtio_priv_s *)rpmsg;
+
+  mm_free(priv->shmheap, ptr);
+}
+
+static FAR void *rpmsg_virtio_shm_get(FAR struct rpmsg_s *rpmsg,
+                                      uint32_t offset, size_t size)
+{
+  FAR struct rpmsg_virtio_priv_s *priv =
+      (FAR struct rpmsg_virtio_priv_s *)rpmsg;
+
+  if (priv->shmbase == NULL || offset > priv->shmsize ||
+      size > priv->shmsize - offset)
+    {
+      return NULL;
+    }
+
+  return priv->shmbase + offset;
+}
+
+/****************************************************************************
+ * Name: rpmsg_virtio_shm_init
+ *
+ * Description:
+ *   Turn the shared memory left after the rpmsg buffers into a pool for
+ *   large payloads.  The pool is split in two halves, the master allocates
+ *   from the first and the remote from the second, so each side runs a
+ *   private heap and no cross-cpu lock is needed.  Offsets are relative to
+ *   the start of the pool and valid on both sides.
+ *
+ ****************************************************************************/
+
+static void rpmsg_virtio_shm_init(FAR struct rpmsg_virtio_priv_s *priv,
+                                  FAR char *end)
+{
+  FAR char *rsc = (FAR char *)priv->rsc;
+  size_t total = RPMSG_VIRTIO_GET_RESOURCE_SIZE(priv->dev);
+  FAR char *base;
+  size_t half;
+
+  base = (FAR char *)ALIGN_UP((uintptr_t)end, RPMSG_VIRTIO_SHM_ALIGN);
+  if (total == 0 || base >= rsc + total)
+    {
+      return;
+    }
+
+  half = ALIGN_DOWN((size_t)(rsc + total - base) / 2,
+                    RPMSG_VIRTIO_SHM_ALIGN);
+  if (half < RPMSG_VIRTIO_SHM_MINSIZE)
+    {
+      return;
+    }
+
+  priv->shmheap = mm_initialize("rpmsg_shm",
+                                RPMSG_VIRTIO_IS_MASTER(priv->dev) ?
+                                base : base + half, half);
+  if (priv->shmheap != NULL)
+    {
+      priv->shmbase = base;
+      priv->shmsize = 2 * half;
+    }
+}
+
 static void rpmsg_virtio_wakeup_rx(FAR struct rpmsg_virtio_priv_s *priv)
 {
   int semcount;
@@ -605,6 +718,7 @@ static int rpmsg_virtio_callback(FAR void *arg, uint32_t vqid)
   FAR struct virtqueue *rvq = rvdev->rvq;
   FAR struct virtqueue *svq = rvdev->svq;
 
+  priv->ncallback++;
   rpmsg_virtio_command(priv);
 
   if (vqid == RPMSG_VIRTIO_NOTIFY_ALL ||
@@ -668,6 +782,17 @@ static int rpmsg_virtio_start(FAR struct rpmsg_virtio_priv_s *priv)
 
   priv->rsc = rsc;
 
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+  /* The master owns the resource table, the remote negotiates whatever
+   * it finds there, so both sides agree on kick suppression.
+   */
+
+  if (RPMSG_VIRTIO_IS_MASTER(priv->dev))
+    {
+      rsc->rpmsg_vdev.dfeatures |= VIRTIO_RING_F_EVENT_IDX;
+    }
+#endif
+
   vdev->notifyid = RPMSG_VIRTIO_VDEV_NOTIFYID;
   vdev->vrings_num = rsc->rpmsg_vdev.num_of_vrings;
   vdev->role = RPMSG_VIRTIO_IS_MASTER(priv->dev) ? RPMSG_HOST : RPMSG_REMOTE;
@@ -726,6 +851,8 @@ static int rpmsg_virtio_start(FAR struct rpmsg_virtio_priv_s *priv)
       goto err_vq1;
     }
 
+  rpmsg_virtio_shm_init(priv, (FAR char *)shbuf1 + shbufsz1);
+
   priv->rvdev.rdev.ns_unbind_cb = rpmsg_ns_unbind;
   priv->rvdev.notify_wait_cb = rpmsg_virtio_notify_wait;
 
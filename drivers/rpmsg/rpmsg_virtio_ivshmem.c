@@ -28,6 +28,7 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <stddef.h>
 #include <stdio.h>
 
 #include <nuttx/drivers/addrenv.h>
@@ -87,6 +88,8 @@ static const FAR char *
 rpmsg_virtio_ivshmem_get_cpuname(FAR struct rpmsg_virtio_s *dev);
 static FAR struct rpmsg_virtio_rsc_s *
 rpmsg_virtio_ivshmem_get_resource(FAR struct rpmsg_virtio_s *dev);
+static size_t
+rpmsg_virtio_ivshmem_get_resource_size(FAR struct rpmsg_virtio_s *dev);
 static int
 rpmsg_virtio_ivshmem_is_master(FAR struct rpmsg_virtio_s *dev);
 static int rpmsg_virtio_ivshmem_notify(FAR struct rpmsg_virtio_s *dev,
@@ -106,6 +109,7 @@ static const struct rpmsg_virtio_ops_s g_rpmsg_virtio_ivshmem_ops =
 {
   .get_cpuname       = rpmsg_virtio_ivshmem_get_cpuname,
   .get_resource      = rpmsg_virtio_ivshmem_get_resource,
+  .get_resource_size = rpmsg_virtio_ivshmem_get_resource_size,
   .is_master         = rpmsg_virtio_ivshmem_is_master,
   .notify            = rpmsg_virtio_ivshmem_notify,
   .register_callback = rpmsg_virtio_ivshmem_register_callback,
@@ -177,6 +181,16 @@ rpmsg_virtio_ivshmem_get_resource(FAR struct rpmsg_virtio_s *dev)
   return rsc;
 }
 
+static size_t
+rpmsg_virtio_ivshmem_get_resource_size(FAR struct rpmsg_virtio_s *dev)
+{
+  FAR struct rpmsg_virtio_ivshmem_dev_s *priv =
+    (FAR struct rpmsg_virtio_ivshmem_dev_s *)dev;
+
+  return priv->shmem_size -
+         offsetof(struct rpmsg_virtio_ivshmem_mem_s, rsc);
+}
+
 static int rpmsg_virtio_ivshmem_is_master(FAR struct rpmsg_virtio_s *dev)
 {
   FAR struct rpmsg_virtio_ivshmem_dev_s *priv =
@@ -27,6 +27,8 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/param.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -42,6 +44,8 @@
 #include <nuttx/mutex.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/sched.h>
+#include <nuttx/seqlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -53,6 +57,7 @@
 #define DEVNAME_FMT         "/dev/uorb/sensor_%s%s%d"
 #define DEVNAME_UNCAL       "_uncal"
 #define TIMING_BUF_ESIZE    (sizeof(uint32_t))
+#define TIMING_BATCH_SIZE   16
 
 /****************************************************************************
  * Private Types
@@ -120,6 +125,9 @@ struct sensor_upperhalf_s
   struct sensor_state_s          state;  /* The state of sensor device */
   struct circbuf_s   timing;             /* The circular buffer of generation */
   struct circbuf_s   buffer;             /* The circular buffer of data */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *shm;         /* The mmap header, buffer follows */
+#endif
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
 };
@@ -140,6 +148,10 @@ static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes);
 
@@ -225,7 +237,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -387,16 +403,124 @@ update:
   return ret;
 }
 
+static int sensor_buffer_init(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t size = lower->nbuffer * upper->state.esize;
+  FAR void *base = NULL;
+  int ret;
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* Allocate the buffer ourselves, behind the header shared with mmap */
+
+  upper->shm = kmm_zalloc(sizeof(struct sensor_mmap_s) + size);
+  if (upper->shm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->shm->esize = upper->state.esize;
+  upper->shm->nbuffer = lower->nbuffer;
+  base = upper->shm + 1;
+#endif
+
+  ret = circbuf_init(&upper->buffer, base, size);
+  if (ret < 0)
+    {
+      goto err_shm;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto err_shm;
+    }
+
+  return 0;
+
+err_shm:
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->shm);
+  upper->shm = NULL;
+#endif
+  return ret;
+}
+
+static void sensor_buffer_uninit(FAR struct sensor_upperhalf_s *upper)
+{
+  if (circbuf_is_init(&upper->buffer))
+    {
+      circbuf_uninit(&upper->buffer);
+      circbuf_uninit(&upper->timing);
+#ifdef CONFIG_SENSORS_MMAP
+      kmm_free(upper->shm);
+      upper->shm = NULL;
+#endif
+    }
+}
+
+static void sensor_buffer_write(FAR struct sensor_upperhalf_s *upper,
+                                FAR const void *data, size_t bytes)
+{
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *shm = upper->shm;
+
+  /* Writers are serialized by upper->lock.  Keep the odd sequence window
+   * short and free of preemption so that mapped readers never spin on it
+   * for long.
+   */
+
+  sched_lock();
+  shm->sequence++;
+  SEQ_WMB();
+#endif
+
+  circbuf_overwrite(&upper->buffer, data, bytes);
+
+#ifdef CONFIG_SENSORS_MMAP
+  shm->head = upper->buffer.head;
+  SEQ_WMB();
+  shm->sequence++;
+  sched_unlock();
+#endif
+}
+
 static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
                                    unsigned long nums)
 {
   uint32_t interval = upper->state.min_interval != UINT32_MAX ?
                       upper->state.min_interval : 1;
-  while (nums-- > 0)
+  uint32_t timing[TIMING_BATCH_SIZE];
+  unsigned long skip;
+  unsigned long n;
+  unsigned long i;
+
+  /* Only the newest nbuffer entries survive in the timing buffer, so a
+   * large FIFO drain just advances the generation over the older ones.
+   */
+
+  skip = nums > upper->lower->nbuffer ? nums - upper->lower->nbuffer : 0;
+  upper->state.generation += skip * interval;
+  nums -= skip;
+
+  while (nums > 0)
     {
-      upper->state.generation += interval;
-      circbuf_overwrite(&upper->timing, &upper->state.generation,
-                        TIMING_BUF_ESIZE);
+      n = MIN(nums, TIMING_BATCH_SIZE);
+      for (i = 0; i < n; i++)
+        {
+          upper->state.generation += interval;
+          timing[i] = upper->state.generation;
+        }
+
+      circbuf_overwrite(&upper->timing, timing, n * TIMING_BUF_ESIZE);
+      nums -= n;
     }
 }
 
@@ -428,6 +552,37 @@ static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static bool sensor_is_batch_ready(FAR struct sensor_upperhalf_s *upper,
+                                  FAR struct sensor_user_s *user)
+{
+  uint32_t delta;
+
+  if (!sensor_is_updated(upper, user))
+    {
+      return false;
+    }
+
+  /* Users without a batch latency, or with a latency that the hardware
+   * FIFO already honours, are woken on every push.
+   */
+
+  if (user->state.latency <= upper->state.min_latency ||
+      user->state.interval == UINT32_MAX)
+    {
+      return true;
+    }
+
+  /* Otherwise wake only once the user's batch latency worth of events is
+   * pending, or when half of the buffer is filled and older events would
+   * be overwritten before the user gets to them.
+   */
+
+  delta = upper->state.generation - user->state.generation;
+  return delta >= user->state.latency ||
+         delta / MAX(upper->state.min_interval, 1) >=
+         upper->lower->nbuffer / 2;
+}
+
 static void sensor_catch_up(FAR struct sensor_upperhalf_s *upper,
                             FAR struct sensor_user_s *user)
 {
@@ -1083,11 +1238,55 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  size_t size;
+  int ret;
+
+  /* The mapping is shared by every subscriber and is read-only */
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (upper->lower->ops->fetch)
+    {
+      ret = -ENOTSUP;
+      goto out;
+    }
+
+  ret = sensor_buffer_init(upper);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  size = sizeof(struct sensor_mmap_s) + upper->buffer.size;
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > size)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  map->vaddr = (FAR char *)upper->shm + map->offset;
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -1118,33 +1317,24 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
       return -EINVAL;
     }
 
-  if (!circbuf_is_init(&upper->buffer))
-    {
-      /* Initialize sensor buffer when data is first generated */
-
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  ret = sensor_buffer_init(upper);
+  if (ret < 0)
+    {
+      nxrmutex_unlock(&upper->lock);
+      return ret;
     }
 
-  circbuf_overwrite(&upper->buffer, data, bytes);
+  /* A FIFO drain of any number of events is stored with one buffer
+   * update and results in at most one wakeup per user.
+   */
+
+  sensor_buffer_write(upper, data, bytes);
   sensor_generate_timing(upper, envcount);
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
-      if (sensor_is_updated(upper, user))
+      if (sensor_is_batch_ready(upper, user))
         {
           nxsem_get_value(&user->buffersem, &semcount);
           if (semcount < 1)
@@ -1440,11 +1630,7 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
 #endif
 
   nxrmutex_destroy(&upper->lock);
-  if (circbuf_is_init(&upper->buffer))
-    {
-      circbuf_uninit(&upper->buffer);
-      circbuf_uninit(&upper->timing);
-    }
+  sensor_buffer_uninit(upper);
 
   kmm_free(upper);
 }
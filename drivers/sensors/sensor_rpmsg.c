@@ -26,12 +26,14 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <fcntl.h>
 #include <debug.h>
 
 #include <nuttx/nuttx.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/lib/math32.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/rpmsg/rpmsg.h>
@@ -837,6 +839,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
   FAR struct sensor_rpmsg_ept_s *sre;
   FAR struct sensor_rpmsg_data_s *msg;
   struct sensor_ustate_s state;
+  uint64_t window;
   uint64_t now;
   bool updated;
   int ret;
@@ -854,15 +857,20 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       state.interval = 0;
     }
 
+  /* Samples may be held back for half of the subscription interval, or for
+   * the whole batch latency if the remote subscriber asked for batching.
+   * The oversampled samples were already dropped by stub->file, which
+   * honours the remote interval in SNIOC_UPDATED and read().
+   */
+
+  window = MAX(state.interval / 2, state.latency);
+
   sre = container_of(stub->ept, struct sensor_rpmsg_ept_s, ept);
   nxrmutex_lock(&sre->lock);
 
-  /* Cancel work to fill new data to buffer */
-
-  if (sre->buffer)
-    {
-      work_cancel(HPWORK, &sre->work);
-    }
+  /* The pending flush work, if any, serializes with us on sre->lock and
+   * checks sre->buffer, so it is left queued while new data is appended.
+   */
 
   for (; ; )
     {
@@ -940,16 +948,26 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
 
       sre->buffer = NULL;
     }
-  else
+  else if (sre->buffer)
     {
-      if (sre->expire == UINT64_MAX ||
-          sre->expire - now > state.interval / 2)
+      /* Only requeue the flush when the deadline moves earlier or no flush
+       * is pending.  Round up to whole ticks so that short windows still
+       * coalesce several pushes instead of flushing immediately.
+       */
+
+      bool requeue = work_available(&sre->work);
+
+      if (sre->expire == UINT64_MAX || sre->expire - now > window)
         {
-          sre->expire = now + state.interval / 2;
+          sre->expire = now + window;
+          requeue = true;
         }
 
-      work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
-                 (sre->expire - now) / USEC_PER_TICK);
+      if (requeue)
+        {
+          work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
+                     div_round_up(sre->expire - now, USEC_PER_TICK));
+        }
     }
 
   nxrmutex_unlock(&sre->lock);
@@ -859,6 +859,7 @@ static ssize_t uart_read(FAR struct file *filep,
   irqstate_t flags;
   ssize_t recvd = 0;
   bool echoed = false;
+  bool raw;
   int16_t tail;
   char ch;
   int ret;
@@ -876,6 +877,14 @@ static ssize_t uart_read(FAR struct file *filep,
       return ret;
     }
 
+  /* With no input translation, line editing or echo enabled, the bytes are
+   * passed through unmodified and can be copied out of the RX buffer in
+   * contiguous blocks.
+   */
+
+  raw = !(dev->tc_iflag & (INLCR | IGNCR | ICRNL)) &&
+        !(dev->tc_lflag & (ICANON | ECHO));
+
   /* Loop while we still have data to copy to the receive buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
@@ -911,7 +920,31 @@ static ssize_t uart_read(FAR struct file *filep,
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      if (raw && rxbuf->head != tail)
+        {
+          int16_t head = rxbuf->head;
+          size_t nbytes;
+
+          /* Copy up to the head or the end of the buffer, whichever comes
+           * first.  A wrapped buffer is drained on the next iteration.
+           */
+
+          nbytes = (head > tail ? head : rxbuf->size) - tail;
+          nbytes = MIN(nbytes, buflen - recvd);
+
+          memcpy(buffer, &rxbuf->buffer[tail], nbytes);
+          buffer += nbytes;
+          recvd  += nbytes;
+
+          tail += nbytes;
+          if (tail >= rxbuf->size)
+            {
+              tail = 0;
+            }
+
+          rxbuf->tail = tail;
+        }
+      else if (rxbuf->head != tail)
         {
           /* Take the next character from the tail of the buffer */
 
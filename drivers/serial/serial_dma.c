@@ -293,18 +293,17 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
 #endif
 
 /****************************************************************************
- * Name: uart_recvchars_done
+ * Name: uart_recvchars_complete
  *
  * Description:
- *   Perform operations necessary at the complete of DMA including adjusting
- *   the RX circular buffer indices and waking up of any threads that may
- *   have been waiting for new data to become available in the RX circular
- *   buffer.
+ *   Commit the bytes of the current RX DMA transfer to the circular buffer
+ *   and wake up readers.  If 'idle' is true the line went idle, the burst
+ *   is over and readers are woken even if fewer than VMIN bytes arrived.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_SERIAL_RXDMA
-void uart_recvchars_done(FAR uart_dev_t *dev)
+static void uart_recvchars_complete(FAR uart_dev_t *dev, bool idle)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
   FAR struct uart_buffer_s *rxbuf = &dev->recv;
@@ -340,7 +339,7 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
     }
 
 #ifdef CONFIG_SERIAL_TERMIOS
-  if (nbytes >= dev->minrecv)
+  if (nbytes >= dev->minrecv || (idle && nbytes))
 #else
   if (nbytes)
 #endif
@@ -360,4 +359,41 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_done
+ *
+ * Description:
+ *   Perform operations necessary at the complete of DMA including adjusting
+ *   the RX circular buffer indices and waking up of any threads that may
+ *   have been waiting for new data to become available in the RX circular
+ *   buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_done(FAR uart_dev_t *dev)
+{
+  uart_recvchars_complete(dev, false);
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *   Called by the lower half when an idle line is detected while an RX DMA
+ *   transfer is still in progress.  The lower half stops the transfer and
+ *   sets dmarx.nbytes to the number of bytes received so far before the
+ *   call.  Those bytes are delivered to readers immediately, even if a
+ *   VMIN threshold has not been reached yet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_idle(FAR uart_dev_t *dev)
+{
+  uart_recvchars_complete(dev, true);
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
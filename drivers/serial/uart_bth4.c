@@ -31,6 +31,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/circbuf.h>
 
+#include <sys/param.h>
 #include <fcntl.h>
 #include <string.h>
 #include <poll.h>
@@ -269,8 +270,13 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
   FAR struct uart_bth4_s *dev = inode->i_private;
   FAR union bt_hdr_u *hdr;
   enum bt_buf_type_e type;
+  FAR uint8_t *stream;
+  size_t nwritten = 0;
   size_t reserved;
-  uint8_t *data;
+  size_t bufsize;
+  size_t offset;
+  size_t avail;
+  size_t chunk;
   size_t pktlen;
   size_t hdrlen;
   int ret;
@@ -290,76 +296,106 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
       reserved = dev->drv->head_reserve;
     }
 
-  data = dev->sendbuf + reserved;
+  /* The H4 packets are collected from 'stream' on, the bytes in front of
+   * it are the headroom the driver needs in front of the first packet.
+   * The packets behind it use the tail of the packets already sent.
+   */
 
-  if (dev->sendlen + buflen > CONFIG_UART_BTH4_TXBUFSIZE - reserved)
+  stream  = dev->sendbuf + reserved - H4_HEADER_SIZE;
+  bufsize = CONFIG_UART_BTH4_TXBUFSIZE - reserved;
+
+  for (; ; )
     {
-      ret = -E2BIG;
-      goto err;
-    }
+      /* Append as much of the caller's data as fits, a write may carry
+       * many packets and be larger than the send buffer.
+       */
 
-  memcpy(data - H4_HEADER_SIZE + dev->sendlen,
-         buffer, buflen);
-  dev->sendlen += buflen;
+      chunk = MIN(buflen - nwritten, bufsize - dev->sendlen);
+      memcpy(stream + dev->sendlen, buffer + nwritten, chunk);
+      dev->sendlen += chunk;
+      nwritten     += chunk;
 
-  hdr = (FAR union bt_hdr_u *)data;
+      /* Send all complete packets */
 
-  for (; ; )
-    {
-      switch (*(data - H4_HEADER_SIZE))
+      for (offset = 0; offset < dev->sendlen; offset += pktlen)
         {
-          case H4_CMD:
-            hdrlen = sizeof(struct bt_hci_cmd_hdr_s);
-            pktlen = hdr->cmd.param_len;
-            type = BT_CMD;
-            break;
-          case H4_ACL:
-            hdrlen = sizeof(struct bt_hci_acl_hdr_s);
-            pktlen = hdr->acl.len;
-            type = BT_ACL_OUT;
-            break;
-          case H4_ISO:
-            hdrlen = sizeof(struct bt_hci_iso_hdr_s);
-            pktlen = hdr->iso.len;
-            type = BT_ISO_OUT;
-            break;
-          default:
-            ret = -EINVAL;
-            goto err;
-        }
+          avail = dev->sendlen - offset;
+          hdr   = (FAR union bt_hdr_u *)(stream + offset + H4_HEADER_SIZE);
 
-      /* Reassembly is incomplete ? */
+          switch (stream[offset])
+            {
+              case H4_CMD:
+                hdrlen = sizeof(struct bt_hci_cmd_hdr_s);
+                type = BT_CMD;
+                break;
+              case H4_ACL:
+                hdrlen = sizeof(struct bt_hci_acl_hdr_s);
+                type = BT_ACL_OUT;
+                break;
+              case H4_ISO:
+                hdrlen = sizeof(struct bt_hci_iso_hdr_s);
+                type = BT_ISO_OUT;
+                break;
+              default:
+                ret = -EINVAL;
+                goto err;
+            }
 
-      hdrlen += H4_HEADER_SIZE;
+          /* Reassembly is incomplete ? */
 
-      if (dev->sendlen < hdrlen)
-        {
-          goto out;
-        }
+          hdrlen += H4_HEADER_SIZE;
+          if (avail < hdrlen)
+            {
+              break;
+            }
 
-      pktlen += hdrlen;
-      if (dev->sendlen < pktlen)
-        {
-          goto out;
-        }
+          if (type == BT_CMD)
+            {
+              pktlen = hdr->cmd.param_len;
+            }
+          else if (type == BT_ACL_OUT)
+            {
+              pktlen = hdr->acl.len;
+            }
+          else
+            {
+              pktlen = hdr->iso.len;
+            }
 
-      /* Got the full packet, send out */
+          pktlen += hdrlen;
+          if (avail < pktlen)
+            {
+              break;
+            }
 
-      ret = dev->drv->send(dev->drv, type,
-                           data, pktlen - H4_HEADER_SIZE);
-      if (ret < 0)
+          /* Got the full packet, send out */
+
+          ret = dev->drv->send(dev->drv, type,
+                               stream + offset + H4_HEADER_SIZE,
+                               pktlen - H4_HEADER_SIZE);
+          if (ret < 0)
+            {
+              goto err;
+            }
+        }
+
+      if (offset == 0 && nwritten < buflen)
         {
+          /* The send buffer is full with one incomplete packet */
+
+          ret = -E2BIG;
           goto err;
         }
 
-      dev->sendlen -= pktlen;
-      if (dev->sendlen == 0)
+      /* Keep the incomplete packet at the front */
+
+      dev->sendlen -= offset;
+      memmove(stream, stream + offset, dev->sendlen);
+
+      if (nwritten == buflen)
         {
           goto out;
         }
-
-      memmove(data - H4_HEADER_SIZE,
-              dev->sendbuf + pktlen, dev->sendlen);
     }
 
 err:
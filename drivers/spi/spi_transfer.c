@@ -31,43 +31,54 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/signal.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/spi/spi_transfer.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
- * Public Functions
+ * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_SPI_ASYNC
+/* The queue of pending messages of one bus */
+
+struct spi_async_s
+{
+  FAR struct spi_dev_s *spi;     /* The bus, NULL if the slot is free */
+  sq_queue_t queue;              /* Pending struct spi_message_s */
+  struct work_s work;            /* Drains the queue */
+};
+#endif
+
 /****************************************************************************
- * Name: spi_transfer
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+static struct spi_async_s g_spi_async[CONFIG_SPI_ASYNC_NBUSES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer_locked
  *
  * Description:
- *   This is a helper function that can be used to encapsulate and manage
- *   a sequence of SPI transfers.  The SPI bus will be locked and the
- *   SPI device selected for the duration of the transfers.
- *
- * Input Parameters:
- *   spi - An instance of the SPI device to use for the transfer
- *   seq - Describes the sequence of transfers.
- *
- * Returned Value:
- *   Zero (OK) on success; a negated errno value on failure.
+ *   Perform a sequence of transfers on a bus that is already locked.
  *
  ****************************************************************************/
 
-int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+static int spi_transfer_locked(FAR struct spi_dev_s *spi,
+                               FAR struct spi_sequence_s *seq)
 {
   FAR struct spi_trans_s *trans;
   int ret = OK;
   int i;
 
-  DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
-
-  /* Get exclusive access to the SPI bus */
-
-  SPI_LOCK(spi, true);
-
   /* Establish the fixed SPI attributes for all transfers in the sequence */
 
   SPI_SETFREQUENCY(spi, seq->frequency);
@@ -77,7 +88,6 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
   if (ret < 0)
     {
       spierr("ERROR: SPI_SETDELAY failed: %d\n", ret);
-      SPI_LOCK(spi, false);
       return ret;
     }
 #endif
@@ -85,6 +95,20 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
   SPI_SETMODE(spi, (enum spi_mode_e)seq->mode);
   SPI_SETBITS(spi, seq->nbits);
 
+#ifdef CONFIG_SPI_ASYNC
+  /* Let the lower half run the whole sequence as one chained DMA, if it
+   * can.
+   */
+
+  ret = SPI_CHAIN(spi, seq);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+
+  ret = OK;
+#endif
+
   /* Select the SPI device in preparation for the transfer.
    * REVISIT: This is redundant.
    */
@@ -139,7 +163,154 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
     }
 
   SPI_SELECT(spi, seq->dev, false);
+  return ret;
+}
+
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_worker
+ *
+ * Description:
+ *   Perform the queued messages of one bus from the work queue.
+ *
+ ****************************************************************************/
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct spi_async_s *async = arg;
+  FAR struct spi_message_s *msg;
+  irqstate_t flags;
+  int count;
+  int ret;
+
+  SPI_LOCK(async->spi, true);
+
+  for (count = 0; count < CONFIG_SPI_ASYNC_BATCH; count++)
+    {
+      flags = enter_critical_section();
+      msg = (FAR struct spi_message_s *)sq_remfirst(&async->queue);
+      leave_critical_section(flags);
+
+      if (msg == NULL)
+        {
+          break;
+        }
+
+      ret = spi_transfer_locked(async->spi, msg->seq);
+      if (msg->complete != NULL)
+        {
+          msg->complete(msg, ret);
+        }
+    }
+
+  SPI_LOCK(async->spi, false);
+
+  /* Leave the bus to synchronous users for a moment if there is more */
+
+  flags = enter_critical_section();
+  if (!sq_empty(&async->queue))
+    {
+      work_queue(LPWORK, &async->work, spi_async_worker, async, 0);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer
+ *
+ * Description:
+ *   This is a helper function that can be used to encapsulate and manage
+ *   a sequence of SPI transfers.  The SPI bus will be locked and the
+ *   SPI device selected for the duration of the transfers.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   seq - Describes the sequence of transfers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+{
+  int ret;
+
+  DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
+
+  /* Get exclusive access to the SPI bus */
+
+  SPI_LOCK(spi, true);
+  ret = spi_transfer_locked(spi, seq);
   SPI_LOCK(spi, false);
   return ret;
 }
 
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return immediately.  'complete'
+ *   is called from the work queue once the sequence has been performed.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   msg - The message to queue
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_message_s *msg)
+{
+  FAR struct spi_async_s *async = NULL;
+  irqstate_t flags;
+  int i;
+
+  DEBUGASSERT(spi != NULL && msg != NULL && msg->seq != NULL &&
+              msg->seq->trans != NULL);
+
+  flags = enter_critical_section();
+
+  /* Find the queue of this bus, or claim a free one */
+
+  for (i = 0; i < CONFIG_SPI_ASYNC_NBUSES; i++)
+    {
+      if (g_spi_async[i].spi == spi)
+        {
+          async = &g_spi_async[i];
+          break;
+        }
+      else if (g_spi_async[i].spi == NULL && async == NULL)
+        {
+          async = &g_spi_async[i];
+        }
+    }
+
+  if (async == NULL)
+    {
+      leave_critical_section(flags);
+      return -ENOSPC;
+    }
+
+  async->spi = spi;
+  sq_addlast(&msg->node, &async->queue);
+
+  if (work_available(&async->work))
+    {
+      work_queue(LPWORK, &async->work, spi_async_worker, async, 0);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
@@ -29,7 +29,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Public Data
@@ -250,6 +253,164 @@ void syslog_flush_intbuffer(bool force);
 
 ssize_t syslog_write_foreach(FAR const char *buffer,
                              size_t buflen, bool force);
+
+/****************************************************************************
+ * Name: syslog_ring_write
+ *
+ * Description:
+ *   Add a message to the lock-free ring of the current CPU.  The ring is
+ *   forwarded to the SYSLOG channels later from a work queue.
+ *
+ * Input Parameters:
+ *   buffer - The buffer containing the data to be output
+ *   buflen - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   The number of bytes accepted, or -EAGAIN if the ring can not be used
+ *   and the message must be written to the channels directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_RING
+ssize_t syslog_ring_write(FAR const char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: syslog_ring_drain
+ *
+ * Description:
+ *   Forward all committed ring records to the SYSLOG channels.
+ *
+ * Input Parameters:
+ *   force - Use the force() method of the channel vs. the putc() method.
+ *
+ * Returned Value:
+ *   True if the rings were drained, false if another drain was already in
+ *   progress.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_RING
+bool syslog_ring_drain(bool force);
+#endif
+
+/****************************************************************************
+ * Name: syslog_ring_write_binary
+ *
+ * Description:
+ *   Queue one record built by syslog_binary_vprintf() in the ring of the
+ *   current CPU.
+ *
+ * Input Parameters:
+ *   record - The record to queue
+ *   len    - Size of the record in bytes
+ *
+ * Returned Value:
+ *   Zero on success, or -EAGAIN if the ring can not be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+int syslog_ring_write_binary(FAR const void *record, size_t len);
+#endif
+
+/****************************************************************************
+ * Name: syslog_gettime
+ *
+ * Description:
+ *   Sample the clock used for SYSLOG timestamps.
+ *
+ * Input Parameters:
+ *   ts - Receives the current time, or zero early in start-up
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+void syslog_gettime(FAR struct timespec *ts);
+#endif
+
+/****************************************************************************
+ * Name: syslog_task_name
+ *
+ * Description:
+ *   Return the name of the calling thread for the message prefix.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+FAR const char *syslog_task_name(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_format_prefix
+ *
+ * Description:
+ *   Output the configured message prefix to a stream.
+ *
+ * Input Parameters:
+ *   stream   - The stream to write to
+ *   priority - The message priority
+ *   ts       - Time at which the message was logged
+ *   cpu      - CPU that logged the message
+ *   pid      - Thread that logged the message
+ *   name     - Name of that thread, used with CONFIG_SYSLOG_PROCESS_NAME
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
+
+struct lib_outstream_s;
+int syslog_format_prefix(FAR struct lib_outstream_s *stream, int priority,
+                         FAR const struct timespec *ts, int cpu, pid_t pid,
+                         FAR const char *name);
+
+/****************************************************************************
+ * Name: syslog_binary_vprintf
+ *
+ * Description:
+ *   Queue a message as a copy of its format string and its raw arguments,
+ *   leaving the formatting to the ring drain.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   fmt      - The format string
+ *   ap       - The arguments
+ *
+ * Returned Value:
+ *   Zero if the message was queued.  A negated errno value if the message
+ *   must be formatted by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+int syslog_binary_vprintf(int priority, FAR const IPTR char *fmt,
+                          FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_binary_output
+ *
+ * Description:
+ *   Format one record queued by syslog_binary_vprintf() and write it to
+ *   the SYSLOG channels.
+ *
+ * Input Parameters:
+ *   record - The record
+ *   len    - Size of the record in bytes
+ *   force  - Use the force() method of the channel vs. the putc() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+void syslog_binary_output(FAR const void *record, size_t len, bool force);
+#endif
 #endif /* CONFIG_SYSLOG */
 
 #undef EXTERN
@@ -0,0 +1,511 @@
+/****************************************************************************
+ * drivers/syslog/syslog_binary.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/sched.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_BINARY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SIZEOF_SYSLOG_BINARY(n) (offsetof(struct syslog_binary_s, data) + (n))
+#define SYSLOG_BINARY_DATASIZE  (CONFIG_SYSLOG_BINARY_BUFSIZE - \
+                                 SIZEOF_SYSLOG_BINARY(0))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One deferred message.  Nothing in it may refer to the caller's memory:
+ * the format string may live in user space or in a module that is gone by
+ * the time the record is formatted, and so may the calling thread.  The
+ * data therefore holds copies of the thread name (with
+ * CONFIG_SYSLOG_PROCESS_NAME) and of the format string, each terminated,
+ * followed by the arguments, unaligned, in the layout expected by
+ * lib_bsprintf().  String arguments are copied as well.
+ */
+
+struct syslog_binary_s
+{
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;           /* Time of the syslog() call */
+#endif
+  pid_t pid;                    /* Calling thread */
+  uint8_t priority;             /* Message priority */
+  uint8_t cpu;                  /* Calling CPU */
+  char data[1];                 /* Packed arguments */
+};
+
+begin_packed_struct union syslog_binary_arg_u
+{
+  char c;
+  short int si;
+  int i;
+  long l;
+#ifdef CONFIG_HAVE_LONG_LONG
+  long long ll;
+#endif
+  intmax_t im;
+  size_t sz;
+  ptrdiff_t pd;
+  uintptr_t p;
+#ifdef CONFIG_HAVE_DOUBLE
+  float f;
+  double d;
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+  long double ld;
+#  endif
+#endif
+} end_packed_struct;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_binary_string
+ *
+ * Description:
+ *   Copy a string, including its terminator, into 'data'.
+ *
+ * Returned Value:
+ *   The number of bytes used in 'data', zero if the string does not fit.
+ *
+ ****************************************************************************/
+
+static size_t syslog_binary_string(FAR char *data, size_t size,
+                                   FAR const IPTR char *str)
+{
+  size_t len = strnlen(str, size);
+
+  if (len >= size)
+    {
+      return 0;
+    }
+
+  memcpy(data, str, len + 1);
+  return len + 1;
+}
+
+/****************************************************************************
+ * Name: syslog_binary_pack
+ *
+ * Description:
+ *   Store the arguments described by 'fmt' into 'data'.  Only conversions
+ *   that lib_bsprintf() reproduces exactly are accepted; anything else
+ *   (%%, %n, precision on numbers, ...) makes the caller fall back to
+ *   formatting the message immediately.
+ *
+ * Returned Value:
+ *   The number of bytes used in 'data', -ENOTSUP if the format can not be
+ *   deferred or -E2BIG if the arguments do not fit.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_binary_pack(FAR char *data, size_t size,
+                                  FAR const IPTR char *fmt, va_list ap)
+{
+  FAR union syslog_binary_arg_u *var;
+  size_t next = 0;
+  char c;
+
+#define SYSLOG_BINARY_PUT(field, value) \
+  do \
+    { \
+      if (next + sizeof(var->field) > size) \
+        { \
+          return -E2BIG; \
+        } \
+      var = (FAR union syslog_binary_arg_u *)&data[next]; \
+      var->field = (value); \
+      next += sizeof(var->field); \
+    } \
+  while (0)
+
+  while ((c = *fmt++) != '\0')
+    {
+      FAR const IPTR char *mod;
+      FAR char *end;
+      unsigned long prec = 0;
+      bool hasprec = false;
+      size_t modlen;
+
+      if (c != '%')
+        {
+          continue;
+        }
+
+      /* Flags and field width */
+
+      while (*fmt != '\0' && strchr("-+ #0123456789*", *fmt) != NULL)
+        {
+          if (*fmt == '*')
+            {
+              SYSLOG_BINARY_PUT(i, va_arg(ap, int));
+            }
+
+          fmt++;
+        }
+
+      /* Precision, only a literal one is understood by lib_bsprintf() */
+
+      if (*fmt == '.')
+        {
+          prec = strtoul(fmt + 1, &end, 10);
+          if (end == fmt + 1)
+            {
+              return -ENOTSUP;
+            }
+
+          hasprec = true;
+          fmt = end;
+        }
+
+      /* Length modifier */
+
+      mod = fmt;
+      while (*fmt != '\0' && strchr("hljztL", *fmt) != NULL)
+        {
+          fmt++;
+        }
+
+      modlen = fmt - mod;
+      if (modlen > 2)
+        {
+          return -ENOTSUP;
+        }
+
+      c = *fmt++;
+      if (hasprec && c != 's')
+        {
+          return -ENOTSUP;
+        }
+
+      switch (c)
+        {
+          case 'c':
+          case 'd':
+          case 'i':
+          case 'o':
+          case 'u':
+          case 'x':
+          case 'X':
+            if (modlen == 0)
+              {
+                SYSLOG_BINARY_PUT(i, va_arg(ap, int));
+              }
+            else if (modlen == 1 && *mod == 'h')
+              {
+                SYSLOG_BINARY_PUT(si, (short)va_arg(ap, int));
+              }
+            else if (modlen == 2 && mod[0] == 'h' && mod[1] == 'h')
+              {
+                SYSLOG_BINARY_PUT(c, (char)va_arg(ap, int));
+              }
+            else if (modlen == 1 && *mod == 'l')
+              {
+                SYSLOG_BINARY_PUT(l, va_arg(ap, long));
+              }
+#ifdef CONFIG_HAVE_LONG_LONG
+            else if (modlen == 2 && mod[0] == 'l' && mod[1] == 'l')
+              {
+                SYSLOG_BINARY_PUT(ll, va_arg(ap, long long));
+              }
+#endif
+            else if (modlen == 1 && *mod == 'j')
+              {
+                SYSLOG_BINARY_PUT(im, va_arg(ap, intmax_t));
+              }
+            else if (modlen == 1 && *mod == 'z')
+              {
+                SYSLOG_BINARY_PUT(sz, va_arg(ap, size_t));
+              }
+            else if (modlen == 1 && *mod == 't')
+              {
+                SYSLOG_BINARY_PUT(pd, va_arg(ap, ptrdiff_t));
+              }
+            else
+              {
+                return -ENOTSUP;
+              }
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case 'a':
+          case 'A':
+          case 'e':
+          case 'E':
+          case 'f':
+          case 'F':
+          case 'g':
+          case 'G':
+            if (modlen == 0 || (modlen == 1 && *mod == 'l'))
+              {
+                SYSLOG_BINARY_PUT(d, va_arg(ap, double));
+              }
+            else if (modlen == 1 && *mod == 'h')
+              {
+                SYSLOG_BINARY_PUT(f, (float)va_arg(ap, double));
+              }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+            else if (modlen == 1 && *mod == 'L')
+              {
+                SYSLOG_BINARY_PUT(ld, va_arg(ap, long double));
+              }
+#  endif
+            else
+              {
+                return -ENOTSUP;
+              }
+            break;
+#endif
+
+          case 's':
+            {
+              FAR const char *str = va_arg(ap, FAR const char *);
+              size_t len;
+
+              if (modlen != 0)
+                {
+                  return -ENOTSUP;
+                }
+
+              if (str == NULL)
+                {
+                  str = "(null)";
+                }
+
+              /* With a precision lib_bsprintf() consumes exactly that many
+               * bytes, otherwise up to and including the terminator.
+               */
+
+              if (hasprec)
+                {
+                  if (next + prec > size)
+                    {
+                      return -E2BIG;
+                    }
+
+                  len = strnlen(str, prec);
+                  memcpy(&data[next], str, len);
+                  memset(&data[next + len], 0, prec - len);
+                  next += prec;
+                }
+              else
+                {
+                  len = strlen(str) + 1;
+                  if (next + len > size)
+                    {
+                      return -E2BIG;
+                    }
+
+                  memcpy(&data[next], str, len);
+                  next += len;
+                }
+            }
+            break;
+
+          case 'p':
+            if (modlen != 0)
+              {
+                return -ENOTSUP;
+              }
+
+            SYSLOG_BINARY_PUT(p, (uintptr_t)va_arg(ap, FAR void *));
+            break;
+
+          default:
+            return -ENOTSUP;
+        }
+    }
+
+#undef SYSLOG_BINARY_PUT
+
+  return next;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_binary_vprintf
+ *
+ * Description:
+ *   Queue a SYSLOG message without formatting it.  A copy of the format
+ *   string, the raw arguments and the prefix information (time, CPU,
+ *   thread, priority) are stored in the lock-free ring; the text is only
+ *   produced when the ring is drained.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   fmt      - The format string
+ *   ap       - The arguments, left untouched
+ *
+ * Returned Value:
+ *   Zero if the message was queued.  A negated errno value if it can not
+ *   be deferred and must be formatted by the caller instead.
+ *
+ ****************************************************************************/
+
+int syslog_binary_vprintf(int priority, FAR const IPTR char *fmt,
+                          FAR va_list *ap)
+{
+  union
+    {
+      struct syslog_binary_s rec;
+      char raw[CONFIG_SYSLOG_BINARY_BUFSIZE];
+    } u;
+
+  size_t next = 0;
+  va_list copy;
+  ssize_t len;
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  next = syslog_binary_string(u.rec.data, SYSLOG_BINARY_DATASIZE,
+                              syslog_task_name());
+  if (next == 0)
+    {
+      return -E2BIG;
+    }
+#endif
+
+  len = syslog_binary_string(u.rec.data + next,
+                             SYSLOG_BINARY_DATASIZE - next, fmt);
+  if (len == 0)
+    {
+      return -E2BIG;
+    }
+
+  next += len;
+
+  va_copy(copy, *ap);
+  len = syslog_binary_pack(u.rec.data + next, SYSLOG_BINARY_DATASIZE - next,
+                           fmt, copy);
+  va_end(copy);
+
+  if (len < 0)
+    {
+      return len;
+    }
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  syslog_gettime(&u.rec.ts);
+#endif
+  u.rec.pid      = nxsched_gettid();
+  u.rec.priority = priority;
+  u.rec.cpu      = this_cpu();
+
+  return syslog_ring_write_binary(&u.rec, SIZEOF_SYSLOG_BINARY(next + len));
+}
+
+/****************************************************************************
+ * Name: syslog_binary_output
+ *
+ * Description:
+ *   Format one record queued by syslog_binary_vprintf() and write it to
+ *   the SYSLOG channels.
+ *
+ * Input Parameters:
+ *   record - The record, suitably aligned
+ *   len    - Size of the record in bytes
+ *   force  - Use the force() method of the channel vs. the putc() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void syslog_binary_output(FAR const void *record, size_t len, bool force)
+{
+  FAR const struct syslog_binary_s *rec = record;
+  FAR const struct timespec *ts = NULL;
+  FAR const char *name = NULL;
+  FAR const char *fmt = rec->data;
+  struct lib_memoutstream_s stream;
+  char line[CONFIG_SYSLOG_BINARY_LINELEN];
+  size_t nput;
+
+  DEBUGASSERT(len >= SIZEOF_SYSLOG_BINARY(0));
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  ts = &rec->ts;
+#endif
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  name = fmt;
+  fmt += strlen(name) + 1;
+#endif
+
+  lib_memoutstream(&stream, line, sizeof(line));
+  syslog_format_prefix(&stream.common, rec->priority, ts, rec->cpu,
+                       rec->pid, name);
+  lib_bsprintf(&stream.common, fmt, fmt + strlen(fmt) + 1);
+
+  /* Terminate the line as nx_vsyslog() does, overwriting the last
+   * character if the line was truncated.
+   */
+
+  nput = stream.common.nput;
+  if (nput == 0 || line[nput - 1] != '\n')
+    {
+      if (nput >= stream.buflen)
+        {
+          nput = stream.buflen - 1;
+        }
+
+      line[nput++] = '\n';
+    }
+
+  syslog_write_foreach(line, nput, force);
+
+#if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
+  /* Reset the terminal style back to normal. */
+
+  syslog_write_foreach("\e[0m", sizeof("\e[0m") - 1, force);
+#endif
+}
+
+#endif /* CONFIG_SYSLOG_BINARY */
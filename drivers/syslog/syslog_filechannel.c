@@ -37,8 +37,12 @@
 #include <sys/types.h>
 
 #include <nuttx/syslog/syslog.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/wqueue.h>
 
 #include "syslog.h"
 
@@ -51,6 +55,52 @@
 #define OPEN_FLAGS (O_WRONLY | O_CREAT | O_APPEND)
 #define OPEN_MODE  (S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR)
 
+/* Rotated files are compressed with LZF when so configured */
+
+#ifdef CONFIG_SYSLOG_FILE_COMPRESS
+#  define ROTATE_SUFFIX ".lzf"
+#else
+#  define ROTATE_SUFFIX ""
+#endif
+
+#ifdef CONFIG_SYSLOG_FILE_ASYNC
+#  define ASYNC_BUFSIZE CONFIG_SYSLOG_FILE_ASYNC_BUFSIZE
+#  define ASYNC_DELAY   MSEC2TICK(CONFIG_SYSLOG_FILE_ASYNC_DELAY)
+#  define ASYNC_SYNC    SEC2TICK(CONFIG_SYSLOG_FILE_ASYNC_SYNC)
+#  if CONFIG_SYSLOG_FILE_ROTATIONS > 0
+#    define ASYNC_AGE   SEC2TICK(CONFIG_SYSLOG_FILE_ROTATE_AGE)
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_FILE_ASYNC
+/* An asynchronous file channel.  Producers append to one of two buffers
+ * under a spinlock; the low priority work queue writes full (or aged)
+ * buffers to the file, so no caller ever blocks on the file system.
+ */
+
+struct syslog_file_async_s
+{
+  struct syslog_channel_s channel;  /* Must be first */
+  spinlock_t lock;                  /* Protects the buffer state */
+  struct work_s work;               /* Writes buffers to the file */
+  struct file file;                 /* The log file */
+  bool opened;                      /* The log file is open */
+  uint8_t cur;                      /* Buffer being filled */
+  size_t fill;                      /* Bytes in buffer[cur] */
+  size_t pending;                   /* Bytes in buffer[cur ^ 1] to write */
+  size_t dropped;                   /* Bytes lost while both were full */
+  off_t size;                       /* Current size of the log file */
+  clock_t created;                  /* When the log file was opened */
+  clock_t synced;                   /* Last fsync() of the log file */
+  FAR char *buffer[2];              /* Double buffer, ASYNC_BUFSIZE each */
+  char path[1];                     /* Path of the log file */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -71,35 +121,74 @@ static void log_separate(FAR const char *log_file)
 }
 #endif
 
-#if CONFIG_SYSLOG_FILE_ROTATIONS > 0
-static void log_rotate(FAR const char *log_file)
+#ifdef CONFIG_SYSLOG_FILE_COMPRESS
+static int log_compress(FAR const char *from, FAR const char *to)
 {
-  int i;
-  off_t size;
-  struct stat f_stat;
-  size_t name_size;
-  FAR char *rotate_to;
-  FAR char *rotate_from;
+  FAR struct lib_lzfoutstream_s *lzf;
+  struct lib_fileoutstream_s out;
+  struct file src;
+  struct file dst;
+  FAR char *buffer;
+  ssize_t nread;
+  int ret;
+
+  lzf = kmm_malloc(sizeof(*lzf) + LZF_STREAM_BLOCKSIZE);
+  if (lzf == NULL)
+    {
+      return -ENOMEM;
+    }
 
-  /* Get the size of the current log file. */
+  buffer = (FAR char *)(lzf + 1);
 
-  if (stat(log_file, &f_stat) < 0)
+  ret = file_open(&src, from, O_RDONLY | O_CLOEXEC);
+  if (ret < 0)
     {
-      return;
+      goto errout_with_lzf;
     }
 
-  size = f_stat.st_size;
+  ret = file_open(&dst, to, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  OPEN_MODE);
+  if (ret < 0)
+    {
+      goto errout_with_src;
+    }
 
-  /* If it does not exceed the limit we are OK. */
+  lib_fileoutstream(&out, &dst);
+  lib_lzfoutstream(lzf, &out.common);
 
-  if (size < CONFIG_SYSLOG_FILE_SIZE_LIMIT)
+  while ((nread = file_read(&src, buffer, LZF_STREAM_BLOCKSIZE)) > 0)
     {
-      return;
+      lib_stream_puts(&lzf->common, buffer, nread);
     }
 
+  lib_stream_flush(&lzf->common);
+  ret = nread < 0 ? (int)nread : file_fsync(&dst);
+  file_close(&dst);
+
+  if (ret < 0)
+    {
+      unlink(to);
+    }
+
+errout_with_src:
+  file_close(&src);
+errout_with_lzf:
+  kmm_free(lzf);
+  return ret;
+}
+#endif
+
+#if CONFIG_SYSLOG_FILE_ROTATIONS > 0
+static void log_shift(FAR const char *log_file)
+{
+  int i;
+  size_t name_size;
+  FAR char *rotate_to;
+  FAR char *rotate_from;
+
   /* Rotated file names. */
 
-  name_size = strlen(log_file) + 8;
+  name_size = strlen(log_file) + 8 + sizeof(ROTATE_SUFFIX);
   rotate_to = kmm_malloc(name_size);
   rotate_from = kmm_malloc(name_size);
   if ((rotate_to == NULL) || (rotate_from == NULL))
@@ -111,20 +200,319 @@ static void log_rotate(FAR const char *log_file)
 
   for (i = (CONFIG_SYSLOG_FILE_ROTATIONS - 1); i > 0; i--)
     {
-      snprintf(rotate_to, name_size, "%s.%d", log_file, i);
-      snprintf(rotate_from, name_size, "%s.%d", log_file, i - 1);
+      snprintf(rotate_to, name_size, "%s.%d" ROTATE_SUFFIX, log_file, i);
+      snprintf(rotate_from, name_size, "%s.%d" ROTATE_SUFFIX,
+               log_file, i - 1);
 
       rename(rotate_from, rotate_to);
     }
 
-  snprintf(rotate_to, name_size, "%s.0", log_file);
+  snprintf(rotate_to, name_size, "%s.0" ROTATE_SUFFIX, log_file);
+
+#ifdef CONFIG_SYSLOG_FILE_COMPRESS
+  /* If compression fails the log is kept and appended to */
 
+  if (log_compress(log_file, rotate_to) >= 0)
+    {
+      unlink(log_file);
+    }
+#else
   rename(log_file, rotate_to);
+#endif
 
 end:
   kmm_free(rotate_to);
   kmm_free(rotate_from);
 }
+
+static void log_rotate(FAR const char *log_file)
+{
+  struct stat f_stat;
+
+  /* Get the size of the current log file. */
+
+  if (stat(log_file, &f_stat) < 0)
+    {
+      return;
+    }
+
+  /* If it does not exceed the limit we are OK. */
+
+  if (f_stat.st_size < CONFIG_SYSLOG_FILE_SIZE_LIMIT)
+    {
+      return;
+    }
+
+  log_shift(log_file);
+}
+#endif
+
+#ifdef CONFIG_SYSLOG_FILE_ASYNC
+static int syslog_file_async_open(FAR struct syslog_file_async_s *priv)
+{
+  off_t size;
+  int ret;
+
+  ret = file_open(&priv->file, priv->path, OPEN_FLAGS | O_CLOEXEC,
+                  OPEN_MODE);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  size = file_seek(&priv->file, 0, SEEK_END);
+  priv->size    = size < 0 ? 0 : size;
+  priv->created = clock_systime_ticks();
+  priv->synced  = priv->created;
+  priv->opened  = true;
+  return OK;
+}
+
+static void syslog_file_async_close(FAR struct syslog_file_async_s *priv)
+{
+  if (priv->opened)
+    {
+      file_fsync(&priv->file);
+      file_close(&priv->file);
+      priv->opened = false;
+    }
+}
+
+static void syslog_file_async_out(FAR struct syslog_file_async_s *priv,
+                                  FAR const char *buffer, size_t buflen)
+{
+  ssize_t nwritten;
+
+  if (!priv->opened && syslog_file_async_open(priv) < 0)
+    {
+      return;
+    }
+
+  while (buflen > 0)
+    {
+      nwritten = file_write(&priv->file, buffer, buflen);
+      if (nwritten <= 0)
+        {
+          /* Retry with a fresh descriptor next time, e.g. after the
+           * file system was remounted.
+           */
+
+          file_close(&priv->file);
+          priv->opened = false;
+          return;
+        }
+
+      priv->size += nwritten;
+      buffer     += nwritten;
+      buflen     -= nwritten;
+    }
+}
+
+static void syslog_file_async_worker(FAR void *arg)
+{
+  FAR struct syslog_file_async_s *priv = arg;
+  FAR const char *buffer;
+  irqstate_t flags;
+  size_t dropped;
+  size_t len;
+  clock_t now;
+
+  /* Take the buffer handed over by a producer, or the partially filled
+   * one once it has aged.
+   */
+
+  flags = spin_lock_irqsave(&priv->lock);
+  if (priv->pending == 0 && priv->fill > 0)
+    {
+      priv->pending = priv->fill;
+      priv->cur    ^= 1;
+      priv->fill    = 0;
+    }
+
+  len           = priv->pending;
+  buffer        = priv->buffer[priv->cur ^ 1];
+  dropped       = priv->dropped;
+  priv->dropped = 0;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (len > 0)
+    {
+      syslog_file_async_out(priv, buffer, len);
+
+      flags = spin_lock_irqsave(&priv->lock);
+      priv->pending = 0;
+      spin_unlock_irqrestore(&priv->lock, flags);
+    }
+
+  if (dropped > 0)
+    {
+      char msg[48];
+      int n;
+
+      n = snprintf(msg, sizeof(msg), "\n[syslog: %zu bytes dropped]\n",
+                   dropped);
+      syslog_file_async_out(priv, msg, n);
+    }
+
+  if (!priv->opened)
+    {
+      return;
+    }
+
+  now = clock_systime_ticks();
+
+#if CONFIG_SYSLOG_FILE_ROTATIONS > 0
+  /* Rotate by size, and by age if configured */
+
+  if (priv->size >= CONFIG_SYSLOG_FILE_SIZE_LIMIT ||
+      (ASYNC_AGE > 0 && priv->size > 0 && now - priv->created >= ASYNC_AGE))
+    {
+      syslog_file_async_close(priv);
+      log_shift(priv->path);
+      syslog_file_async_open(priv);
+      return;
+    }
+#endif
+
+  if (now - priv->synced >= ASYNC_SYNC)
+    {
+      file_fsync(&priv->file);
+      priv->synced = now;
+    }
+}
+
+static ssize_t syslog_file_async_write(FAR syslog_channel_t *channel,
+                                       FAR const char *buffer,
+                                       size_t buflen)
+{
+  FAR struct syslog_file_async_s *priv =
+    (FAR struct syslog_file_async_s *)channel;
+  irqstate_t flags;
+  size_t remain = buflen;
+  bool full = false;
+
+  flags = spin_lock_irqsave(&priv->lock);
+  while (remain > 0)
+    {
+      size_t n = ASYNC_BUFSIZE - priv->fill;
+
+      if (n > remain)
+        {
+          n = remain;
+        }
+
+      memcpy(priv->buffer[priv->cur] + priv->fill, buffer, n);
+      priv->fill += n;
+      buffer     += n;
+      remain     -= n;
+
+      if (priv->fill == ASYNC_BUFSIZE)
+        {
+          if (priv->pending > 0)
+            {
+              /* The worker has not caught up with the previous buffer */
+
+              priv->dropped += remain;
+              break;
+            }
+
+          priv->pending = priv->fill;
+          priv->cur    ^= 1;
+          priv->fill    = 0;
+          full          = true;
+        }
+    }
+
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  /* Write full buffers right away, partial ones after a short delay so
+   * that lines are batched.
+   */
+
+  if (full)
+    {
+      work_queue(LPWORK, &priv->work, syslog_file_async_worker, priv, 0);
+    }
+  else if (work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, syslog_file_async_worker, priv,
+                 ASYNC_DELAY);
+    }
+
+  return buflen;
+}
+
+static int syslog_file_async_putc(FAR syslog_channel_t *channel, int ch)
+{
+  char tmp = ch;
+
+  syslog_file_async_write(channel, &tmp, 1);
+  return ch;
+}
+
+static void syslog_file_async_uninitialize(FAR syslog_channel_t *channel)
+{
+  FAR struct syslog_file_async_s *priv =
+    (FAR struct syslog_file_async_s *)channel;
+
+  /* Write out both buffers before closing the file */
+
+  work_cancel_sync(LPWORK, &priv->work);
+  syslog_file_async_worker(priv);
+  syslog_file_async_worker(priv);
+  syslog_file_async_close(priv);
+
+  kmm_free(priv->buffer[0]);
+  kmm_free(priv);
+}
+
+static const struct syslog_channel_ops_s g_syslog_file_async_ops =
+{
+  syslog_file_async_putc,
+  syslog_file_async_putc,
+  NULL,                       /* Can not write files on a crash */
+  syslog_file_async_write,
+  syslog_file_async_write,
+  syslog_file_async_uninitialize
+};
+
+static FAR syslog_channel_t *
+syslog_file_async_initialize(FAR const char *devpath)
+{
+  FAR struct syslog_file_async_s *priv;
+  size_t len = strlen(devpath);
+
+  priv = kmm_zalloc(sizeof(struct syslog_file_async_s) + len);
+  if (priv == NULL)
+    {
+      return NULL;
+    }
+
+  /* Both buffers come from one allocation aligned for DMA capable block
+   * drivers, and are always written whole when full.
+   */
+
+  priv->buffer[0] = kmm_memalign(sizeof(uint64_t) * 4, 2 * ASYNC_BUFSIZE);
+  if (priv->buffer[0] == NULL)
+    {
+      kmm_free(priv);
+      return NULL;
+    }
+
+  priv->buffer[1] = priv->buffer[0] + ASYNC_BUFSIZE;
+  memcpy(priv->path, devpath, len + 1);
+  spin_lock_init(&priv->lock);
+
+  if (syslog_file_async_open(priv) < 0)
+    {
+      kmm_free(priv->buffer[0]);
+      kmm_free(priv);
+      return NULL;
+    }
+
+  priv->channel.sc_ops = &g_syslog_file_async_ops;
+  return &priv->channel;
+}
 #endif
 
 /****************************************************************************
@@ -196,7 +584,11 @@ FAR syslog_channel_t *syslog_file_channel(FAR const char *devpath)
 
   /* Then initialize the file interface */
 
+#ifdef CONFIG_SYSLOG_FILE_ASYNC
+  file_channel = syslog_file_async_initialize(devpath);
+#else
   file_channel = syslog_dev_initialize(devpath, OPEN_FLAGS, OPEN_MODE);
+#endif
   if (file_channel == NULL)
     {
       goto errout_with_lock;
@@ -208,7 +600,7 @@ FAR syslog_channel_t *syslog_file_channel(FAR const char *devpath)
 
   if (syslog_channel_register(file_channel) != OK)
     {
-      syslog_dev_uninitialize(file_channel);
+      file_channel->sc_ops->sc_close(file_channel);
       file_channel = NULL;
     }
 
@@ -68,6 +68,12 @@ int syslog_flush(void)
 {
   int i;
 
+#ifdef CONFIG_SYSLOG_RING
+  /* Forward whatever is still queued in the lock-free rings */
+
+  syslog_ring_drain(true);
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   /* Flush any characters that may have been added to the interrupt
    * buffer.
@@ -57,6 +57,15 @@
 
 int syslog_putc(int ch)
 {
+#ifdef CONFIG_SYSLOG_RING
+  char rch = ch;
+
+  if (syslog_ring_write(&rch, 1) >= 0)
+    {
+      return ch;
+    }
+#endif
+
   /* Is this an attempt to do SYSLOG output from an interrupt handler? */
 
   if (up_interrupt_context() || sched_idletask())
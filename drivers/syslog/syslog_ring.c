@@ -0,0 +1,496 @@
+/****************************************************************************
+ * drivers/syslog/syslog_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/init.h>
+#include <nuttx/sched.h>
+#include <nuttx/syslog/syslog.h>
+#include <nuttx/wqueue.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SYSLOG_RING_SIZE & (CONFIG_SYSLOG_RING_SIZE - 1)) != 0
+#  error CONFIG_SYSLOG_RING_SIZE must be a power of two
+#endif
+
+#if CONFIG_SYSLOG_RING_SIZE < 64
+#  error CONFIG_SYSLOG_RING_SIZE is too small
+#endif
+
+#ifdef CONFIG_SYSLOG_RING_LPWORK
+#  define SYSLOG_RING_WORK   LPWORK
+#else
+#  define SYSLOG_RING_WORK   HPWORK
+#endif
+
+#define SYSLOG_RING_MASK     (CONFIG_SYSLOG_RING_SIZE - 1)
+
+/* Each record starts with a 32-bit header holding the payload length and a
+ * commit flag.  Records are padded to the header size so that a header
+ * never straddles the end of the ring, the payload may.
+ */
+
+#define SYSLOG_RING_HDRSIZE  4
+#define SYSLOG_RING_COMMIT   0x80000000u
+#define SYSLOG_RING_BINARY   0x40000000u
+#define SYSLOG_RING_LENMASK  0x0000ffffu
+#define SYSLOG_RING_ALIGN(n) \
+  (((n) + SYSLOG_RING_HDRSIZE - 1) & ~(SYSLOG_RING_HDRSIZE - 1))
+
+/* Longest payload carried by a single record.  Longer writes are split. */
+
+#define SYSLOG_RING_MAXREC   (CONFIG_SYSLOG_RING_SIZE / 4 - \
+                              SYSLOG_RING_HDRSIZE)
+
+#if defined(CONFIG_SYSLOG_BINARY) && \
+    CONFIG_SYSLOG_BINARY_BUFSIZE > SYSLOG_RING_MAXREC
+#  error CONFIG_SYSLOG_BINARY_BUFSIZE does not fit in CONFIG_SYSLOG_RING_SIZE
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One ring per CPU.  Producers on any CPU reserve space by advancing head
+ * with a compare-and-swap, so a task that migrates between the reservation
+ * and the commit is harmless.  Consumers, the drain work and
+ * syslog_flush(), are serialized by g_syslog_ring_draining.
+ */
+
+struct syslog_ring_s
+{
+  atomic_uint head;                /* Next byte to reserve */
+  atomic_uint tail;                /* Next byte to drain */
+  atomic_uint dropped;             /* Records lost because the ring was full */
+  uint32_t buffer[CONFIG_SYSLOG_RING_SIZE / sizeof(uint32_t)];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void syslog_ring_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_ring[CONFIG_SMP_NCPUS];
+static struct work_s g_syslog_ring_work;
+static atomic_uint g_syslog_ring_pending;
+static atomic_uint g_syslog_ring_draining;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_ring_header
+ ****************************************************************************/
+
+static inline_function FAR atomic_uint *
+syslog_ring_header(FAR struct syslog_ring_s *ring, uint32_t pos)
+{
+  return (FAR atomic_uint *)&ring->buffer[(pos & SYSLOG_RING_MASK) /
+                                          SYSLOG_RING_HDRSIZE];
+}
+
+/****************************************************************************
+ * Name: syslog_ring_copyin
+ ****************************************************************************/
+
+static void syslog_ring_copyin(FAR struct syslog_ring_s *ring, uint32_t pos,
+                               FAR const char *buffer, size_t buflen)
+{
+  FAR char *base = (FAR char *)ring->buffer;
+  size_t off = pos & SYSLOG_RING_MASK;
+  size_t first = CONFIG_SYSLOG_RING_SIZE - off;
+
+  if (first > buflen)
+    {
+      first = buflen;
+    }
+
+  memcpy(base + off, buffer, first);
+  memcpy(base, buffer + first, buflen - first);
+}
+
+/****************************************************************************
+ * Name: syslog_ring_reserve
+ *
+ * Description:
+ *   Reserve 'size' bytes in the ring and return the start position, or
+ *   false if the ring does not have room.
+ *
+ ****************************************************************************/
+
+static bool syslog_ring_reserve(FAR struct syslog_ring_s *ring,
+                                uint32_t size, FAR uint32_t *pos)
+{
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+  do
+    {
+      uint32_t tail = atomic_load_explicit(&ring->tail,
+                                           memory_order_acquire);
+
+      if (head - tail + size > CONFIG_SYSLOG_RING_SIZE)
+        {
+          return false;
+        }
+    }
+  while (!atomic_compare_exchange_weak(&ring->head, &head, head + size));
+
+  *pos = head;
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_ring_put
+ *
+ * Description:
+ *   Reserve, fill in and commit one record.  Returns false if the ring is
+ *   full.
+ *
+ ****************************************************************************/
+
+static bool syslog_ring_put(FAR struct syslog_ring_s *ring,
+                            FAR const void *buffer, size_t len,
+                            uint32_t flags)
+{
+  uint32_t size = SYSLOG_RING_ALIGN(SYSLOG_RING_HDRSIZE + len);
+  uint32_t pos;
+
+  if (!syslog_ring_reserve(ring, size, &pos))
+    {
+      atomic_fetch_add(&ring->dropped, 1);
+      return false;
+    }
+
+  syslog_ring_copyin(ring, pos + SYSLOG_RING_HDRSIZE, buffer, len);
+  atomic_store_explicit(syslog_ring_header(ring, pos),
+                        SYSLOG_RING_COMMIT | flags | len,
+                        memory_order_release);
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_ring_kick
+ ****************************************************************************/
+
+static void syslog_ring_kick(void)
+{
+  if (atomic_exchange(&g_syslog_ring_pending, 1) == 0)
+    {
+      work_queue(SYSLOG_RING_WORK, &g_syslog_ring_work,
+                 syslog_ring_worker, NULL, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_ring_output
+ ****************************************************************************/
+
+static void syslog_ring_output(FAR struct syslog_ring_s *ring,
+                               uint32_t pos, uint32_t value, bool force)
+{
+  FAR const char *base = (FAR const char *)ring->buffer;
+  size_t len = value & SYSLOG_RING_LENMASK;
+  size_t off = (pos + SYSLOG_RING_HDRSIZE) & SYSLOG_RING_MASK;
+  size_t first = CONFIG_SYSLOG_RING_SIZE - off;
+
+  if (first > len)
+    {
+      first = len;
+    }
+
+#ifdef CONFIG_SYSLOG_BINARY
+  if ((value & SYSLOG_RING_BINARY) != 0)
+    {
+      /* Binary records are decoded from a contiguous, aligned copy */
+
+      uint64_t record[SYSLOG_RING_ALIGN(CONFIG_SYSLOG_BINARY_BUFSIZE) /
+                      sizeof(uint64_t) + 1];
+
+      DEBUGASSERT(len <= CONFIG_SYSLOG_BINARY_BUFSIZE);
+      memcpy(record, base + off, first);
+      memcpy((FAR char *)record + first, base, len - first);
+      syslog_binary_output(record, len, force);
+      return;
+    }
+#endif
+
+  syslog_write_foreach(base + off, first, force);
+  if (len > first)
+    {
+      syslog_write_foreach(base, len - first, force);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_ring_drain_one
+ *
+ * Description:
+ *   Forward every committed record of one ring to the SYSLOG channels.
+ *   Draining stops at the first record still being filled in; its producer
+ *   schedules the drain work again once it commits.
+ *
+ ****************************************************************************/
+
+static void syslog_ring_drain_one(FAR struct syslog_ring_s *ring,
+                                  bool force)
+{
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  uint32_t dropped;
+
+  for (; ; )
+    {
+      FAR atomic_uint *hdr;
+      uint32_t value;
+      uint32_t size;
+      size_t off;
+
+      if (tail == atomic_load_explicit(&ring->head, memory_order_acquire))
+        {
+          break;
+        }
+
+      hdr   = syslog_ring_header(ring, tail);
+      value = atomic_load_explicit(hdr, memory_order_acquire);
+      if ((value & SYSLOG_RING_COMMIT) == 0)
+        {
+          break;
+        }
+
+      syslog_ring_output(ring, tail, value, force);
+      value &= SYSLOG_RING_LENMASK;
+
+      /* Clear the consumed bytes so that the commit flag reads as zero
+       * when a later record lands on the same header slot.
+       */
+
+      size = SYSLOG_RING_ALIGN(SYSLOG_RING_HDRSIZE + value);
+      off  = tail & SYSLOG_RING_MASK;
+      if (off + size > CONFIG_SYSLOG_RING_SIZE)
+        {
+          memset((FAR char *)ring->buffer + off, 0,
+                 CONFIG_SYSLOG_RING_SIZE - off);
+          memset(ring->buffer, 0, off + size - CONFIG_SYSLOG_RING_SIZE);
+        }
+      else
+        {
+          memset((FAR char *)ring->buffer + off, 0, size);
+        }
+
+      tail += size;
+      atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+  dropped = atomic_exchange(&ring->dropped, 0);
+  if (dropped > 0)
+    {
+      char msg[32];
+      int len;
+
+      len = snprintf(msg, sizeof(msg), "[dropped %u]\n",
+                     (unsigned int)dropped);
+      syslog_write_foreach(msg, len, force);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_ring_worker
+ ****************************************************************************/
+
+static void syslog_ring_worker(FAR void *arg)
+{
+  /* Clear the pending flag before looking at the rings, so a producer
+   * committing after this point schedules another pass.
+   */
+
+  atomic_store_explicit(&g_syslog_ring_pending, 0, memory_order_seq_cst);
+
+  /* If syslog_flush() is draining, records it has already passed by may
+   * have been committed before the flag was cleared, so come back later.
+   */
+
+  if (!syslog_ring_drain(false) &&
+      atomic_exchange(&g_syslog_ring_pending, 1) == 0)
+    {
+      work_queue(SYSLOG_RING_WORK, &g_syslog_ring_work,
+                 syslog_ring_worker, NULL, 1);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_ring_write
+ *
+ * Description:
+ *   Copy one SYSLOG message into the ring of the current CPU and schedule
+ *   the drain work.  No locks are taken, so this may be called from any
+ *   context, including interrupt handlers.  The message text, and with it
+ *   any timestamp prepended by vsyslog(), is produced by the caller before
+ *   it enters the ring.
+ *
+ * Input Parameters:
+ *   buffer - The buffer containing the data to be output
+ *   buflen - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   The number of bytes accepted, including bytes dropped because the ring
+ *   was full.  -EAGAIN is returned if the ring can not be used yet (or any
+ *   more), in which case the caller should write to the channels directly.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_ring_write(FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_ring_s *ring;
+  size_t remain = buflen;
+
+  /* Before the work queues run and after a crash nobody would drain the
+   * ring.
+   */
+
+  if (!OSINIT_OS_READY() || g_nx_initstate == OSINIT_PANIC)
+    {
+      return -EAGAIN;
+    }
+
+  ring = &g_syslog_ring[this_cpu()];
+
+  while (remain > 0)
+    {
+      size_t len = remain > SYSLOG_RING_MAXREC ? SYSLOG_RING_MAXREC : remain;
+
+      if (!syslog_ring_put(ring, buffer, len, 0))
+        {
+          break;
+        }
+
+      buffer += len;
+      remain -= len;
+    }
+
+  syslog_ring_kick();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: syslog_ring_write_binary
+ *
+ * Description:
+ *   Queue one binary record built by syslog_binary_vprintf().  The record
+ *   is handed back to syslog_binary_output() by the drain.
+ *
+ * Input Parameters:
+ *   record - The record to queue
+ *   len    - Size of the record in bytes
+ *
+ * Returned Value:
+ *   Zero if the record was queued or dropped because the ring was full;
+ *   -EAGAIN if the ring can not be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+int syslog_ring_write_binary(FAR const void *record, size_t len)
+{
+  DEBUGASSERT(len <= CONFIG_SYSLOG_BINARY_BUFSIZE);
+
+  if (!OSINIT_OS_READY() || g_nx_initstate == OSINIT_PANIC)
+    {
+      return -EAGAIN;
+    }
+
+  syslog_ring_put(&g_syslog_ring[this_cpu()], record, len,
+                  SYSLOG_RING_BINARY);
+  syslog_ring_kick();
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_ring_drain
+ *
+ * Description:
+ *   Forward the committed content of all rings to the SYSLOG channels.
+ *   Records are forwarded per CPU, so messages logged on different CPUs at
+ *   about the same time may appear out of order.
+ *
+ *   Only one drain runs at a time; a caller finding another one in
+ *   progress returns at once.  After a crash the drain that was running
+ *   will never complete, so the rings are then drained regardless.
+ *
+ * Input Parameters:
+ *   force - Use the force() method of the channel vs. the putc() method.
+ *
+ * Returned Value:
+ *   True if the rings were drained, false if another drain was already in
+ *   progress.
+ *
+ ****************************************************************************/
+
+bool syslog_ring_drain(bool force)
+{
+  int cpu;
+
+  if (atomic_exchange(&g_syslog_ring_draining, 1) != 0 &&
+      g_nx_initstate != OSINIT_PANIC)
+    {
+      return false;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      syslog_ring_drain_one(&g_syslog_ring[cpu], force);
+    }
+
+  atomic_store_explicit(&g_syslog_ring_draining, 0, memory_order_release);
+  return true;
+}
+
+#endif /* CONFIG_SYSLOG_RING */
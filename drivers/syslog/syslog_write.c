@@ -228,7 +228,18 @@ ssize_t syslog_write_foreach(FAR const char *buffer,
 
 ssize_t syslog_write(FAR const char *buffer, size_t buflen)
 {
-  bool force = !syslog_safe_to_block();
+  bool force;
+
+#ifdef CONFIG_SYSLOG_RING
+  ssize_t ret = syslog_ring_write(buffer, buflen);
+
+  if (ret >= 0)
+    {
+      return ret;
+    }
+#endif
+
+  force = !syslog_safe_to_block();
 
 #ifdef CONFIG_SYSLOG_INTBUFFER
   if (force)
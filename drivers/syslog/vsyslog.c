@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 #include <errno.h>
 
@@ -69,90 +70,112 @@ static FAR const char * const g_priority_str[] =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_gettime
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Sample the clock used for SYSLOG timestamps.  Since debug output may be
+ *   generated very early in the start-up sequence, hardware timer support
+ *   may not yet be available; zero is returned in that case.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
-{
-  struct lib_syslograwstream_s stream;
-  int ret = 0;
-#ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_get_tcb(nxsched_gettid());
-#endif
 #ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
-
-  lib_syslograwstream_open(&stream);
-
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
-
-  /* Get the current time.  Since debug output may be generated very early
-   * in the start-up sequence, hardware timer support may not yet be
-   * available.
-   */
+void syslog_gettime(FAR struct timespec *ts)
+{
+  ts->tv_sec = 0;
+  ts->tv_nsec = 0;
 
   if (OSINIT_HW_READY())
     {
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, ts);
 #  endif
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_task_name
+ *
+ * Description:
+ *   Return the name of the calling thread for the message prefix.  The
+ *   name must be sampled by the caller: once the message is queued the
+ *   thread may exit before the prefix is formatted.
+ *
+ ****************************************************************************/
 
-      /* Prepend the message with the current time, if available */
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+FAR const char *syslog_task_name(void)
+{
+  FAR struct tcb_s *tcb = nxsched_get_tcb(nxsched_gettid());
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+  return tcb != NULL ? get_task_name(tcb) : "<noname>";
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_format_prefix
+ *
+ * Description:
+ *   Output the configured message prefix (timestamp, CPU, thread ID,
+ *   priority, prefix string and process name) to a stream.
+ *
+ * Input Parameters:
+ *   stream   - The stream to write to
+ *   priority - The message priority
+ *   ts       - Time at which the message was logged, see syslog_gettime()
+ *   cpu      - CPU that logged the message
+ *   pid      - Thread that logged the message
+ *   name     - Name of that thread, see syslog_task_name()
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
+
+int syslog_format_prefix(FAR struct lib_outstream_s *stream, int priority,
+                         FAR const struct timespec *ts, int cpu, pid_t pid,
+                         FAR const char *name)
+{
+  int ret = 0;
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
+
+  memset(&tm, 0, sizeof(tm));
+  if (ts->tv_sec != 0 || ts->tv_nsec != 0)
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&ts->tv_sec, &tm);
+#  else
+      gmtime_r(&ts->tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
+  UNUSED(ts);
+  UNUSED(cpu);
+  UNUSED(pid);
+  UNUSED(name);
+
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
     defined(CONFIG_SMP) || defined(CONFIG_SYSLOG_PROCESSID) || \
     defined(CONFIG_SYSLOG_PRIORITY) || defined(CONFIG_SYSLOG_PREFIX) || \
     defined(CONFIG_SYSLOG_PROCESS_NAME)
 
-  ret = lib_sprintf_internal(&stream.common,
+  ret = lib_sprintf_internal(stream,
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style. */
 
@@ -206,24 +229,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ts->tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ts->tv_sec
+                             , ts->tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -247,12 +270,71 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , name
 #endif
                     );
 
+#else
+  UNUSED(stream);
+  UNUSED(priority);
 #endif /* CONFIG_SYSLOG_COLOR_OUTPUT || CONFIG_SYSLOG_TIMESTAMP || ... */
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct lib_syslograwstream_s stream;
+  FAR const struct timespec *pts = NULL;
+  int ret;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;
+#endif
+
+#ifdef CONFIG_SYSLOG_BINARY
+  /* Queue the format string and the raw arguments, formatting is left to
+   * the ring drain.
+   */
+
+  ret = syslog_binary_vprintf(priority, fmt, ap);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+#endif
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  syslog_gettime(&ts);
+  pts = &ts;
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  ret = syslog_format_prefix(&stream.common, priority, pts, this_cpu(),
+                             nxsched_gettid(), syslog_task_name());
+#else
+  ret = syslog_format_prefix(&stream.common, priority, pts, this_cpu(),
+                             nxsched_gettid(), NULL);
+#endif
+
   /* Generate the output */
 
   ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
@@ -336,6 +336,38 @@ int weak_function up_alarm_tick_start(clock_t ticks)
 }
 #endif
 
+#ifdef CONFIG_HRTIMER
+int weak_function up_alarm_start(FAR const struct timespec *ts)
+{
+  int ret = -EAGAIN;
+
+  if (g_oneshot_lower != NULL)
+    {
+      struct timespec now;
+      struct timespec delta;
+
+      /* The high resolution timers need the alarm with the full precision
+       * of the oneshot timer, so don't convert to ticks here.
+       */
+
+      ONESHOT_CURRENT(g_oneshot_lower, &now);
+      if (clock_timespec_compare(ts, &now) > 0)
+        {
+          clock_timespec_subtract(ts, &now, &delta);
+        }
+      else
+        {
+          delta.tv_sec  = 0;
+          delta.tv_nsec = 0;
+        }
+
+      ret = ONESHOT_START(g_oneshot_lower, oneshot_callback, NULL, &delta);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: up_perf_*
  *
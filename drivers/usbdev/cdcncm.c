@@ -75,7 +75,6 @@
 /* TX timeout = 1 minute */
 
 #define CDCNCM_TXTIMEOUT             (60*CLK_TCK)
-#define CDCNCM_DGRAM_COMBINE_PERIOD   1
 
 #define NTB_DEFAULT_IN_SIZE           16384
 #define NTB_OUT_SIZE                  16384
@@ -159,6 +158,14 @@ enum ncm_notify_state_e
   NCM_NOTIFY_RESPONSE_AVAILABLE, /* Issue RESPONSE_AVAILABLE next */
 };
 
+/* Container of a bulk request, linked in the idle or pending lists */
+
+struct cdcncm_req_s
+{
+  FAR struct cdcncm_req_s    *flink;       /* Implements a singly linked list */
+  FAR struct usbdev_req_s    *req;         /* The contained request */
+};
+
 struct ndp_parser_opts_s
 {
   uint32_t nthsign;          /* NCM Transfer Header signature */
@@ -307,11 +314,13 @@ struct cdcncm_driver_s
   FAR struct usbdev_ep_s     *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                     config;      /* Selected configuration number */
 
-  FAR struct usbdev_req_s    *rdreq;       /* Single read request */
-  bool                        rxpending;   /* Packet available in rdreq */
+  struct cdcncm_req_s         rdreqs[CONFIG_CDCNCM_NRDREQS];
+  struct sq_queue_s           rxpending;   /* Read requests holding an NTB */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  struct cdcncm_req_s         wrreqs[CONFIG_CDCNCM_NWRREQS];
+  struct sq_queue_s           txfree;      /* Idle write requests */
+  FAR struct cdcncm_req_s    *wrreq;       /* Write request being filled */
+  netpkt_queue_t              tx_queue;    /* Packets waiting for an NTB */
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -371,7 +380,8 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 /* Interrupt handling */
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -846,6 +856,7 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
   const int rem = g_ntbparameters.ndpinpayloadremainder;
   const int dgramidxlen = 2 * opts->dgramitemlen;
   const int ndpalign = g_ntbparameters.ndpinalignment;
+  FAR struct usbdev_req_s *req = self->wrreq->req;
   FAR uint8_t *tmp;
   int ncblen;
   int ndpindex;
@@ -857,29 +868,29 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
     {
       /* Fill NCB */
 
-      tmp = self->wrreq->buf;
+      tmp = req->buf;
       memset(tmp, 0, ncblen);
       cdcncm_put(&tmp, 4, opts->nthsign);
       cdcncm_put(&tmp, 2, opts->nthsize);
       tmp += 2;              /* Skip seq */
       tmp += opts->blocklen; /* Skip block len */
       cdcncm_put(&tmp, opts->ndpindex, ndpindex);
-      self->dgramaddr = self->wrreq->buf + ndpindex +
+      self->dgramaddr = req->buf + ndpindex +
                         opts->ndpsize + (TX_MAX_NUM_DPE + 1) * dgramidxlen;
       self->dgramaddr = (FAR uint8_t *)NCM_ALIGN((uintptr_t)self->dgramaddr,
                                                  div) + rem;
 
       /* Fill NDP */
 
-      tmp = self->wrreq->buf + ndpindex;
+      tmp = req->buf + ndpindex;
       cdcncm_put(&tmp, 4, self->ndpsign);
       tmp += 2 + opts->reserved1;
       cdcncm_put(&tmp, opts->nextndpindex, 0);
     }
 
-  tmp = self->wrreq->buf + ndpindex + opts->ndpsize +
+  tmp = req->buf + ndpindex + opts->ndpsize +
         self->dgramcount * dgramidxlen;
-  cdcncm_put(&tmp, opts->dgramitemlen, self->dgramaddr - self->wrreq->buf);
+  cdcncm_put(&tmp, opts->dgramitemlen, self->dgramaddr - req->buf);
   cdcncm_put(&tmp, opts->dgramitemlen, dglen);
 
   /* Fill IP packet */
@@ -894,23 +905,27 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 }
 
 /****************************************************************************
- * Name: cdcncm_transmit_work
+ * Name: cdcncm_transmit_flush
  *
  * Description:
- *   Send NTB to the USB device for ethernet frame transmission
+ *   Finish the NTB being filled and send it to the USB device for ethernet
+ *   frame transmission
  *
  * Input Parameters:
- *   arg - Reference to the driver state structure
+ *   self - Reference to the driver state structure
  *
  * Returned Value:
  *   None
  *
+ * Assumptions:
+ *   The network is locked.
+ *
  ****************************************************************************/
 
-static void cdcncm_transmit_work(FAR void *arg)
+static void cdcncm_transmit_flush(FAR struct cdcncm_driver_s *self)
 {
-  FAR struct cdcncm_driver_s *self = arg;
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
+  FAR struct usbdev_req_s *req;
   FAR uint8_t *tmp;
   const int dgramidxlen = 2 * opts->dgramitemlen;
   const int ndpalign = g_ntbparameters.ndpinalignment;
@@ -918,26 +933,24 @@ static void cdcncm_transmit_work(FAR void *arg)
   int ndpindex;
   int totallen;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
-
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (self->wrreq == NULL || self->dgramcount == 0)
     {
+      return;
     }
 
+  req      = self->wrreq->req;
   ncblen   = opts->nthsize;
   ndpindex = NCM_ALIGN(ncblen, ndpalign);
 
   /* Fill NCB */
 
-  tmp      = self->wrreq->buf + 8; /* Offset to block length */
-  totallen = self->dgramaddr - self->wrreq->buf;
+  tmp      = req->buf + 8; /* Offset to block length */
+  totallen = self->dgramaddr - req->buf;
   cdcncm_put(&tmp, opts->blocklen, totallen);
 
   /* Fill NDP */
 
-  tmp = self->wrreq->buf + ndpindex + 4; /* Offset to ndp length */
+  tmp = req->buf + ndpindex + 4; /* Offset to ndp length */
   cdcncm_put(&tmp, 2, opts->ndpsize + (self->dgramcount + 1) * dgramidxlen);
 
   tmp += opts->reserved1 + opts->nextndpindex + opts->reserved2 +
@@ -947,9 +960,90 @@ static void cdcncm_transmit_work(FAR void *arg)
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
 
-  self->wrreq->len = totallen;
+  req->len    = totallen;
+  self->wrreq = NULL;
+
+  EP_SUBMIT(self->epbulkin, req);
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit_work
+ *
+ * Description:
+ *   Send the partially filled NTB once the flush period expired
+ *
+ * Input Parameters:
+ *   arg - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-  EP_SUBMIT(self->epbulkin, self->wrreq);
+static void cdcncm_transmit_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = arg;
+
+  net_lock();
+  cdcncm_transmit_flush(self);
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit
+ *
+ * Description:
+ *   Add a packet to the NTB being filled, starting a new NTB in an idle
+ *   write request if needed.  A full NTB is sent at once, otherwise the
+ *   NTB is sent CONFIG_CDCNCM_TXFLUSH_MS after its first datagram.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *   pkt  - Reference to the packet to be transmitted
+ *
+ * Returned Value:
+ *   true if the packet was consumed; false if all write requests are busy.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_transmit(FAR struct cdcncm_driver_s *self,
+                            FAR netpkt_t *pkt)
+{
+  irqstate_t flags;
+
+  if (self->wrreq == NULL)
+    {
+      flags = enter_critical_section();
+      self->wrreq = (FAR struct cdcncm_req_s *)sq_remfirst(&self->txfree);
+      leave_critical_section(flags);
+
+      if (self->wrreq == NULL)
+        {
+          return false;
+        }
+    }
+
+  cdcncm_transmit_format(self, pkt);
+  netpkt_free(&self->dev, pkt, NETPKT_TX);
+
+  /* Send the NTB if the next packet may not fit into it anymore */
+
+  if ((self->wrreq->req->buf + NTB_OUT_SIZE - self->dgramaddr <
+       self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE)
+    {
+      work_cancel(ETHWORK, &self->delaywork);
+      cdcncm_transmit_flush(self);
+    }
+  else if (work_available(&self->delaywork))
+    {
+      work_queue(ETHWORK, &self->delaywork, cdcncm_transmit_work, self,
+                 MSEC2TICK(CONFIG_CDCNCM_TXFLUSH_MS));
+    }
+
+  return true;
 }
 
 /****************************************************************************
@@ -1001,16 +1095,18 @@ static int cdcncm_packet_handler(FAR struct cdcncm_driver_s *self,
  *
  * Input Parameters:
  *   self - Reference to the driver state structure
+ *   req  - The read request holding the NTB
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
-  FAR uint8_t *tmp = self->rdreq->buf;
+  FAR uint8_t *tmp = req->buf;
   uint32_t ntbmax = g_ntbparameters.ntboutmaxsize;
   uint32_t blocklen;
   uint32_t ndplen;
@@ -1021,7 +1117,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
   if (GETUINT32(tmp) != opts->nthsign)
     {
-      uerr("Wrong NTH SIGN, skblen %zu\n", self->rdreq->xfrd);
+      uerr("Wrong NTH SIGN, skblen %zu\n", req->xfrd);
       return;
     }
 
@@ -1061,7 +1157,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
           return;
         }
 
-      tmp = self->rdreq->buf + ndpindex;
+      tmp = req->buf + ndpindex;
 
       if (GETUINT32(tmp) != self->ndpsign)
         {
@@ -1105,7 +1201,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
           /* Copy the data from the hardware to self->rx_queue. */
 
-          cdcncm_packet_handler(self, self->rdreq->buf + index, dglen);
+          cdcncm_packet_handler(self, req->buf + index, dglen);
 
           ndplen -= 2 * (opts->dgramitemlen);
         }
@@ -1130,6 +1226,25 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 {
+  FAR netpkt_t *pkt;
+
+  /* Move the packets held back while all write requests were busy into
+   * the NTBs that became idle.
+   */
+
+  net_lock();
+
+  while ((pkt = netpkt_remove_queue(&priv->tx_queue)) != NULL)
+    {
+      if (!cdcncm_transmit(priv, pkt))
+        {
+          netpkt_tryadd_queue(pkt, &priv->tx_queue);
+          break;
+        }
+    }
+
+  net_unlock();
+
   /* In any event, poll the network for new TX data */
 
   netdev_lower_txdone(&priv->dev);
@@ -1155,18 +1270,30 @@ static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 static void cdcncm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct cdcncm_req_s *rdcontainer;
   irqstate_t flags;
 
-  /* Check if we received an incoming packet, if so, call cdcncm_receive() */
+  /* Parse every received NTB in order and give its request back to the
+   * bulk OUT endpoint.
+   */
 
-  if (self->rxpending)
+  for (; ; )
     {
-      cdcncm_receive(self);
+      flags = enter_critical_section();
+      rdcontainer = (FAR struct cdcncm_req_s *)
+                    sq_remfirst(&self->rxpending);
+      leave_critical_section(flags);
+
+      if (rdcontainer == NULL)
+        {
+          break;
+        }
+
+      cdcncm_receive(self, rdcontainer->req);
       netdev_lower_rxready(&self->dev);
 
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      EP_SUBMIT(self->epbulkout, rdcontainer->req);
       leave_critical_section(flags);
     }
 
@@ -1291,19 +1418,14 @@ static int cdcncm_send(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
   FAR struct cdcncm_driver_s *self;
 
   self = container_of(dev, struct cdcncm_driver_s, dev);
-  cdcncm_transmit_format(self, pkt);
-  netpkt_free(dev, pkt, NETPKT_TX);
 
-  if ((self->wrreq->buf + NTB_OUT_SIZE - self->dgramaddr <
-       self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE)
-    {
-      work_cancel(ETHWORK, &self->delaywork);
-      cdcncm_transmit_work(self);
-    }
-  else
+  /* Hold the packet, and with it its TX quota, while all write requests
+   * are in flight.  This throttles the network instead of blocking it.
+   */
+
+  if (!IOB_QEMPTY(&self->tx_queue) || !cdcncm_transmit(self, pkt))
     {
-      work_queue(ETHWORK, &self->delaywork, cdcncm_transmit_work, self,
-                 MSEC2TICK(CDCNCM_DGRAM_COMBINE_PERIOD));
+      return netpkt_tryadd_queue(pkt, &self->tx_queue);
     }
 
   return OK;
@@ -1482,8 +1604,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          sq_addlast((FAR sq_entry_t *)req->priv, &self->rxpending);
           work_queue(ETHWORK, &self->irqwork,
                      cdcncm_interrupt_work, self, 0);
         }
@@ -1495,7 +1616,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1514,21 +1635,16 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
-  int rc;
+  irqstate_t flags;
 
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
-   */
-
-  rc = nxsem_post(&self->wrreq_idle);
+  /* The write request is available for upcoming NTBs again */
 
-  if (rc != OK)
-    {
-      nerr("nxsem_post failed! rc: %d\n", rc);
-    }
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req->priv, &self->txfree);
+  leave_critical_section(flags);
 
   /* Inform the network layer that an Ethernet frame was transmitted. */
 
@@ -1585,6 +1701,7 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 {
   struct usb_ss_epdesc_s epdesc;
   int ret;
+  int i;
 
   if (config == self->config)
     {
@@ -1637,14 +1754,16 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  DEBUGASSERT(sq_empty(&self->rxpending));
 
-  self->rdreq->callback = cdcncm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreqs[i].req);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -2479,7 +2598,9 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
                        FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  FAR struct usbdev_req_s *req;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -2537,38 +2658,42 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests. The buffer size is NTB_DEFAULT_IN_SIZE. */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
-  if (self->rdreq == NULL)
+  sq_init(&self->rxpending);
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
-
-  self->rdreq->callback = cdcncm_rdcomplete;
-
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+      req = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
+      if (req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
-    {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
+      req->callback         = cdcncm_rdcomplete;
+      req->priv             = &self->rdreqs[i];
+      self->rdreqs[i].req   = req;
     }
 
-  self->wrreq->callback = cdcncm_wrcomplete;
-
-  /* The single write request just allocated is available now. */
-
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  /* Pre-allocate write requests, all idle. Buffer size is NTB_OUT_SIZE */
 
-  if (ret != OK)
+  sq_init(&self->txfree);
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      uerr("nxsem_init failed. ret: %d\n", ret);
-      goto error;
+      req = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
+      if (req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      req->callback         = cdcncm_wrcomplete;
+      req->priv             = &self->wrreqs[i];
+      self->wrreqs[i].req   = req;
+      sq_addlast((FAR sq_entry_t *)&self->wrreqs[i], &self->txfree);
     }
 
+  self->wrreq     = NULL;
   self->txdone    = false;
 
 #ifndef CONFIG_CDCNCM_COMPOSITE
@@ -2594,6 +2719,7 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -2633,12 +2759,17 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      usbdev_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkout, self->rdreqs[i].req);
+          self->rdreqs[i].req = NULL;
+        }
     }
 
+  sq_init(&self->rxpending);
+
   /* Free the bulk OUT endpoint */
 
   if (self->epbulkout)
@@ -2651,12 +2782,19 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
     }
 
+  sq_init(&self->txfree);
+  self->wrreq      = NULL;
+  self->dgramcount = 0;
+
   /* Free the bulk IN endpoint */
 
   if (self->epbulkin)
@@ -2665,9 +2803,10 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
       self->epbulkin = NULL;
     }
 
-  /* Clear out all data in the rx_queue */
+  /* Clear out all data in the rx_queue and tx_queue */
 
   netpkt_free_queue(&self->rx_queue);
+  netpkt_free_queue(&self->tx_queue);
 }
 
 static int cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
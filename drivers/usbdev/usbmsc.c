@@ -292,23 +292,22 @@ static int usbmsc_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate write request containers and put in a free list */
 
-  for (i = 0; i < CONFIG_USBMSC_NWRREQS; i++)
-    {
-      reqcontainer = &priv->wrreqs[i];
 #ifdef CONFIG_USBDEV_SUPERSPEED
-      if (dev->speed == USB_SPEED_SUPER ||
-          dev->speed == USB_SPEED_SUPER_PLUS)
-        {
-          reqcontainer->req = usbdev_allocreq(priv->epbulkin,
-                                              USBMSC_SSBULKMAXPACKET *
-                                              (USBMSC_SSBULKMAXBURST + 1));
-        }
-      else
+  if (dev->speed == USB_SPEED_SUPER ||
+      dev->speed == USB_SPEED_SUPER_PLUS)
+    {
+      priv->wrreqlen = USBMSC_SSBULKMAXPACKET * (USBMSC_SSBULKMAXBURST + 1);
+    }
+  else
 #endif
-        {
-          reqcontainer->req = usbdev_allocreq(priv->epbulkin,
-                                              CONFIG_USBMSC_BULKINREQLEN);
-        }
+    {
+      priv->wrreqlen = CONFIG_USBMSC_BULKINREQLEN;
+    }
+
+  for (i = 0; i < CONFIG_USBMSC_NWRREQS; i++)
+    {
+      reqcontainer      = &priv->wrreqs[i];
+      reqcontainer->req = usbdev_allocreq(priv->epbulkin, priv->wrreqlen);
 
       if (reqcontainer->req == NULL)
         {
@@ -1476,12 +1475,7 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
 
   if (!priv->iobuffer)
     {
-#ifdef CONFIG_USBMSC_WRMULTIPLE
-      priv->iobuffer = kmm_malloc(geo.geo_sectorsize *
-                                  CONFIG_USBMSC_NWRREQS);
-#else
-      priv->iobuffer = kmm_malloc(geo.geo_sectorsize);
-#endif
+      priv->iobuffer = kmm_malloc(geo.geo_sectorsize * USBMSC_IOSECTORS);
       if (!priv->iobuffer)
         {
           usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_ALLOCIOBUFFER),
@@ -1489,17 +1483,14 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
           return -ENOMEM;
         }
 
-#ifdef CONFIG_USBMSC_WRMULTIPLE
-      priv->iosize = geo.geo_sectorsize * CONFIG_USBMSC_NWRREQS;
-#else
-      priv->iosize = geo.geo_sectorsize;
-#endif
+      priv->iosize = geo.geo_sectorsize * USBMSC_IOSECTORS;
     }
-  else if (priv->iosize < geo.geo_sectorsize)
+  else if (priv->iosize < geo.geo_sectorsize * USBMSC_IOSECTORS)
     {
       FAR void *tmp;
 
-      tmp = kmm_realloc(priv->iobuffer, geo.geo_sectorsize);
+      tmp = kmm_realloc(priv->iobuffer,
+                        geo.geo_sectorsize * USBMSC_IOSECTORS);
       if (!tmp)
         {
           usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_REALLOCIOBUFFER),
@@ -1508,7 +1499,7 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
         }
 
       priv->iobuffer = (FAR uint8_t *)tmp;
-      priv->iosize   = geo.geo_sectorsize;
+      priv->iosize   = geo.geo_sectorsize * USBMSC_IOSECTORS;
     }
 
   lun->inode       = inode;
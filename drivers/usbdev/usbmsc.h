@@ -87,6 +87,14 @@
 #  define CONFIG_USBMSC_NRDREQS 4
 #endif
 
+/* Number of sectors buffered in iobuffer[] */
+
+#if defined(CONFIG_USBMSC_WRMULTIPLE) || defined(CONFIG_USBMSC_RDMULTIPLE)
+#  define USBMSC_IOSECTORS CONFIG_USBMSC_NWRREQS
+#else
+#  define USBMSC_IOSECTORS 1
+#endif
+
 /* Logical endpoint numbers / max packet sizes */
 
 #ifndef CONFIG_USBMSC_COMPOSITE
@@ -408,9 +416,11 @@ struct usbmsc_dev_s
   uint8_t           cbwdir:2;         /* Direction from CBW. See USBMSC_FLAGS_DIR* definitions */
   uint8_t           cdblen;           /* Length of cdb[] from CBW */
   uint8_t           cbwlun;           /* LUN from the CBW */
-  uint16_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint32_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint32_t          niobytes;         /* Bytes read into iobuffer[] */
   uint16_t          nreqbytes;        /* Bytes buffered in head write requests */
-  uint16_t          iosize;           /* Size of iobuffer[] */
+  uint16_t          wrreqlen;         /* Size of each write request buffer */
+  uint32_t          iosize;           /* Size of iobuffer[] */
   uint32_t          cbwlen;           /* Length of data from CBW */
   uint32_t          cbwtag;           /* Tag from the CBW */
   union
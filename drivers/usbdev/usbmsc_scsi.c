@@ -1929,6 +1929,7 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
   /* No data is buffered */
 
   priv->nsectbytes   = 0;
+  priv->niobytes     = 0;
   priv->nreqbytes    = 0;
 
   /* Get exclusive access to the block driver */
@@ -2230,10 +2231,16 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes not yet copied from iobuffer[]
+ *   niobytes   - holds the number of bytes read into iobuffer[]
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
+ * Data is copied into the write requests up to their full size, and the
+ * requests are submitted as soon as the sectors in iobuffer[] have been
+ * consumed, so that reading the next sectors from the block driver
+ * overlaps with the bulk IN transfers already queued.
+ *
  ****************************************************************************/
 
 static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
@@ -2245,9 +2252,22 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   ssize_t nread;
   FAR uint8_t *src;
   FAR uint8_t *dest;
+  uint16_t maxpacket = priv->epbulkin->maxpacket;
+  uint16_t reqlen;
+  uint32_t nsectors;
   int nbytes;
   int ret;
 
+  /* Only full packets may be sent before the end of the data, so use the
+   * request buffer in multiples of the endpoint max packet size.
+   */
+
+  reqlen = priv->wrreqlen - priv->wrreqlen % maxpacket;
+  if (reqlen == 0)
+    {
+      reqlen = maxpacket;
+    }
+
   /* Loop transferring data until either (1) all of the data has been
    * transferred, or (2) we have used up all of the write requests that we
    * have available.
@@ -2261,9 +2281,15 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read the next sectors */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+          nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+#else
+          nsectors = 1;
+#endif
+          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                   nsectors);
           if (nread < 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
@@ -2273,9 +2299,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->niobytes   = lun->sectorsize * nsectors;
+          priv->nsectbytes = priv->niobytes;
+          priv->u.xfrlen  -= nsectors;
+          priv->sector    += nsectors;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2303,11 +2330,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * OR (2) all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
-      nbytes = MIN(priv->epbulkin->maxpacket - priv->nreqbytes,
-                   priv->nsectbytes);
+      nbytes = MIN(reqlen - priv->nreqbytes, priv->nsectbytes);
 
       /* Copy the data from the sector buffer to the USB request and update
        * counts
@@ -2318,12 +2344,14 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
       priv->nsectbytes -= nbytes;
 
       /* If (1) the request buffer is full OR (2) this is the final request
-       * full of data,
-       * then submit the request
+       * full of data OR (3) the sector buffer is drained and the request
+       * ends on a packet boundary, then submit the request rather than
+       * holding it while the next sectors are read.
        */
 
-      if (priv->nreqbytes >= priv->epbulkin->maxpacket ||
-          (priv->u.xfrlen <= 0 && priv->nsectbytes <= 0))
+      if (priv->nreqbytes >= reqlen ||
+          (priv->u.xfrlen <= 0 && priv->nsectbytes <= 0) ||
+          (priv->nsectbytes <= 0 && priv->nreqbytes % maxpacket == 0))
         {
           /* Remove the request that we just filled from wrreqlist (we've
            * already checked that is it not NULL
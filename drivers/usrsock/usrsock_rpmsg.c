@@ -145,6 +145,7 @@ static int usrsock_rpmsg_ept_cb(FAR struct rpmsg_endpoint *ept,
                                 uint32_t src, FAR void *priv)
 {
   FAR struct usrsock_message_common_s *common = data;
+  ssize_t ret;
 
   if (common->msgid == USRSOCK_RPMSG_DNS_EVENT)
     {
@@ -157,7 +158,24 @@ static int usrsock_rpmsg_ept_cb(FAR struct rpmsg_endpoint *ept,
       len -= sizeof(struct usrsock_message_frag_ack_s);
     }
 
-  return usrsock_response(data, len, NULL);
+  /* The server may pack several messages into one buffer, e.g. the
+   * coalesced socket events, handle them one after the other.
+   */
+
+  do
+    {
+      ret = usrsock_response(data, len, NULL);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      data = (FAR char *)data + ret;
+      len -= ret;
+    }
+  while (len > 0);
+
+  return ret < 0 ? ret : 0;
 }
 
 static void usrsock_rpmsg_device_created(FAR struct rpmsg_device *rdev,
@@ -41,6 +41,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/usrsock/usrsock_rpmsg.h>
+#include <nuttx/wqueue.h>
 #ifdef CONFIG_NETDEV_WIRELESS_IOCTL
 #include <nuttx/wireless/wireless.h>
 #endif
@@ -55,6 +56,13 @@ struct usrsock_rpmsg_s
   struct socket             socks[CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS];
   FAR struct rpmsg_endpoint *epts[CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS];
   struct pollfd             pfds[CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS];
+
+#ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER_EVENT_COALESCE
+  /* Poll events not sent yet, merged until the work sends them */
+
+  uint16_t                  events[CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS];
+  struct work_s             work;
+#endif
 };
 
 /* Saving rpmsg requests to keep message order. */
@@ -102,6 +110,13 @@ static int usrsock_rpmsg_send_data_ack(FAR struct rpmsg_endpoint *ept,
                               int32_t datalen);
 static int usrsock_rpmsg_send_event(FAR struct rpmsg_endpoint *ept,
                                     int16_t usockid, uint16_t events);
+#ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER_EVENT_COALESCE
+static void usrsock_rpmsg_queue_event(FAR struct usrsock_rpmsg_s *priv,
+                                      int16_t usockid, uint16_t events);
+static void usrsock_rpmsg_drop_event(FAR struct usrsock_rpmsg_s *priv,
+                                     int16_t usockid, uint16_t events);
+static void usrsock_rpmsg_event_work(FAR void *arg);
+#endif
 
 static int usrsock_rpmsg_socket_handler(FAR struct rpmsg_endpoint *ept,
                                         FAR void *data, size_t len,
@@ -291,6 +306,100 @@ static int usrsock_rpmsg_send_event(FAR struct rpmsg_endpoint *ept,
   return rpmsg_send(ept, &event, sizeof(event));
 }
 
+#ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER_EVENT_COALESCE
+/* Merge the events of a socket with the ones not sent yet, the work sends
+ * the events of all sockets of an endpoint in as few messages as possible.
+ * Called with priv->mutex held.
+ */
+
+static void usrsock_rpmsg_queue_event(FAR struct usrsock_rpmsg_s *priv,
+                                      int16_t usockid, uint16_t events)
+{
+  priv->events[usockid] |= events;
+  if (work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, usrsock_rpmsg_event_work, priv, 0);
+    }
+}
+
+/* Forget the events that a response is about to report more accurately */
+
+static void usrsock_rpmsg_drop_event(FAR struct usrsock_rpmsg_s *priv,
+                                     int16_t usockid, uint16_t events)
+{
+  nxrmutex_lock(&priv->mutex);
+  priv->events[usockid] &= ~events;
+  nxrmutex_unlock(&priv->mutex);
+}
+
+static void usrsock_rpmsg_event_work(FAR void *arg)
+{
+  FAR struct usrsock_rpmsg_s *priv = arg;
+  FAR struct usrsock_message_socket_event_s *event;
+  FAR struct rpmsg_endpoint *ept;
+  FAR uint8_t *buf;
+  uint32_t size;
+  uint32_t len;
+  int ret;
+  int i;
+  int j;
+
+  nxrmutex_lock(&priv->mutex);
+
+  for (i = 0; i < CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS; i++)
+    {
+      ept = priv->epts[i];
+      if (ept == NULL)
+        {
+          priv->events[i] = 0;
+          continue;
+        }
+
+      if (priv->events[i] == 0)
+        {
+          continue;
+        }
+
+      buf = rpmsg_get_tx_payload_buffer(ept, &size, true);
+      if (buf == NULL)
+        {
+          continue;
+        }
+
+      /* Pack the events of this socket and of the next sockets of the same
+       * endpoint back to back, the client handles them one by one.
+       */
+
+      len = 0;
+      for (j = i; j < CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS &&
+                  len + sizeof(*event) <= size; j++)
+        {
+          if (priv->epts[j] != ept || priv->events[j] == 0)
+            {
+              continue;
+            }
+
+          event = (FAR struct usrsock_message_socket_event_s *)(buf + len);
+          event->head.msgid  = USRSOCK_MESSAGE_SOCKET_EVENT;
+          event->head.flags  = USRSOCK_MESSAGE_FLAG_EVENT;
+          event->head.events = priv->events[j];
+          event->usockid     = j;
+
+          priv->events[j] = 0;
+          len += sizeof(*event);
+        }
+
+      ret = rpmsg_send_nocopy(ept, buf, len);
+      if (ret < 0)
+        {
+          rpmsg_release_tx_buffer(ept, buf);
+        }
+    }
+
+  nxrmutex_unlock(&priv->mutex);
+}
+#endif
+
 static int usrsock_rpmsg_socket_handler(FAR struct rpmsg_endpoint *ept,
                                         FAR void *data, size_t len,
                                         uint32_t src, FAR void *priv_)
@@ -308,6 +417,9 @@ static int usrsock_rpmsg_socket_handler(FAR struct rpmsg_endpoint *ept,
       if (priv->epts[i] == NULL)
         {
           priv->epts[i] = ept;
+#ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER_EVENT_COALESCE
+          priv->events[i] = 0;
+#endif
           nxrmutex_unlock(&priv->mutex);
           ret = psock_socket(req->domain, req->type | SOCK_NONBLOCK,
                              req->protocol, &priv->socks[i]);
@@ -525,6 +637,17 @@ static int usrsock_rpmsg_sendto_handler(FAR struct rpmsg_endpoint *ept,
     }
 
 out:
+#ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER_EVENT_COALESCE
+  if (req->usockid >= 0 &&
+      req->usockid < CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS)
+    {
+      /* The ack tells whether the socket can still send */
+
+      usrsock_rpmsg_drop_event(priv, req->usockid,
+                               USRSOCK_EVENT_SENDTO_READY);
+    }
+#endif
+
   if (ret > 0 &&
       usrsock_rpmsg_available(&priv->socks[req->usockid], FIONSPACE))
     {
@@ -666,6 +789,18 @@ static int usrsock_rpmsg_recvfrom_handler(FAR struct rpmsg_endpoint *ept,
         }
     }
 
+#ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER_EVENT_COALESCE
+  if (req->usockid >= 0 &&
+      req->usockid < CONFIG_NET_USRSOCK_RPMSG_SERVER_NSOCKS &&
+      (events & USRSOCK_EVENT_RECVFROM_AVAIL) == 0)
+    {
+      /* The ack tells that no more data is available */
+
+      usrsock_rpmsg_drop_event(priv, req->usockid,
+                               USRSOCK_EVENT_RECVFROM_AVAIL);
+    }
+#endif
+
   retr = usrsock_rpmsg_send_data_ack(ept,
                                      ack, events, req->head.xid,
                                      totlen, inaddrlen, outaddrlen,
@@ -1273,7 +1408,11 @@ static void usrsock_rpmsg_poll_cb(FAR struct pollfd *pfds)
 
   if (events != 0)
     {
+#ifdef CONFIG_NET_USRSOCK_RPMSG_SERVER_EVENT_COALESCE
+      usrsock_rpmsg_queue_event(priv, pfds->fd, events);
+#else
       usrsock_rpmsg_send_event(priv->epts[pfds->fd], pfds->fd, events);
+#endif
     }
 
   nxrmutex_unlock(&priv->mutex);
@@ -0,0 +1,324 @@
+/****************************************************************************
+ * drivers/video/dmabuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <debug.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/cache.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/sched.h>
+#include <nuttx/video/dmabuf.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dmabuf_s
+{
+  FAR void        *addr;     /* Start of the shared buffer */
+  size_t           size;     /* Size of the shared buffer */
+  atomic_int       refs;     /* Open files + imports + mappings */
+  dmabuf_release_t release;  /* Exporter's release callback */
+  FAR void        *arg;      /* Argument of the release callback */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int dmabuf_open(FAR struct file *filep);
+static int dmabuf_close(FAR struct file *filep);
+static int dmabuf_ioctl(FAR struct file *filep, int cmd,
+                        unsigned long arg);
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_dmabuf_fops =
+{
+  dmabuf_open,      /* open */
+  dmabuf_close,     /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  dmabuf_ioctl,     /* ioctl */
+  dmabuf_mmap,      /* mmap */
+};
+
+static struct inode g_dmabuf_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_dmabuf_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void dmabuf_free(FAR void *arg, FAR void *addr)
+{
+  kumm_free(addr);
+}
+
+static int dmabuf_open(FAR struct file *filep)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+
+  atomic_fetch_add(&buf->refs, 1);
+  return OK;
+}
+
+static int dmabuf_close(FAR struct file *filep)
+{
+  dmabuf_put(filep->f_priv);
+  return OK;
+}
+
+static void dmabuf_sync(FAR struct dmabuf_s *buf, uint64_t flags)
+{
+  /* Drop stale lines before the CPU reads what a device wrote, and push
+   * the CPU's writes out before a device reads them.
+   */
+
+  if ((flags & DMABUF_SYNC_END) == 0)
+    {
+      if (flags & DMABUF_SYNC_READ)
+        {
+          up_invalidate_dcache((uintptr_t)buf->addr,
+                               (uintptr_t)buf->addr + buf->size);
+        }
+    }
+  else if (flags & DMABUF_SYNC_WRITE)
+    {
+      up_clean_dcache((uintptr_t)buf->addr,
+                      (uintptr_t)buf->addr + buf->size);
+    }
+}
+
+static int dmabuf_ioctl(FAR struct file *filep, int cmd,
+                        unsigned long arg)
+{
+  FAR struct dmabuf_sync_s *sync;
+
+  switch (cmd)
+    {
+      case DMABUFIOC_SYNC:
+        sync = (FAR struct dmabuf_sync_s *)(uintptr_t)arg;
+        if (sync == NULL || (sync->flags & ~(DMABUF_SYNC_RW |
+                                             DMABUF_SYNC_END)) != 0 ||
+            (sync->flags & DMABUF_SYNC_RW) == 0)
+          {
+            return -EINVAL;
+          }
+
+        dmabuf_sync(filep->f_priv, sync->flags);
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+static int dmabuf_munmap(FAR struct task_group_s *group,
+                         FAR struct mm_map_entry_s *entry,
+                         FAR void *start, size_t length)
+{
+  FAR struct dmabuf_s *buf = entry->priv.p;
+  int ret;
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  dmabuf_put(buf);
+  return ret;
+}
+
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+  int ret;
+
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > buf->size)
+    {
+      return -EINVAL;
+    }
+
+  /* The mapping holds its own reference so that the memory stays valid
+   * after the descriptor is closed.
+   */
+
+  map->vaddr  = (FAR char *)buf->addr + map->offset;
+  map->priv.p = buf;
+  map->munmap = dmabuf_munmap;
+
+  atomic_fetch_add(&buf->refs, 1);
+  ret = mm_map_add(get_current_mm(), map);
+  if (ret < 0)
+    {
+      dmabuf_put(buf);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_export
+ ****************************************************************************/
+
+int dmabuf_export(FAR void *addr, size_t size, dmabuf_release_t release,
+                  FAR void *arg, int oflags)
+{
+  FAR struct dmabuf_s *buf;
+  int fd;
+
+  if (addr == NULL || size == 0 ||
+      (oflags & ~(O_CLOEXEC | O_NONBLOCK)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  buf = kmm_zalloc(sizeof(struct dmabuf_s));
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  buf->addr    = addr;
+  buf->size    = size;
+  buf->release = release;
+  buf->arg     = arg;
+  atomic_init(&buf->refs, 1);
+
+  fd = file_allocate(&g_dmabuf_inode, O_RDWR | oflags, 0, buf, 0, true);
+  if (fd < 0)
+    {
+      kmm_free(buf);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: dmabuf_alloc
+ ****************************************************************************/
+
+int dmabuf_alloc(size_t size, int oflags)
+{
+  FAR void *addr;
+  int fd;
+
+  addr = kumm_memalign(32, size);
+  if (addr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fd = dmabuf_export(addr, size, dmabuf_free, NULL, oflags);
+  if (fd < 0)
+    {
+      kumm_free(addr);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: dmabuf_get
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_get(int fd)
+{
+  FAR struct dmabuf_s *buf = NULL;
+  FAR struct file *filep;
+
+  if (fs_getfilep(fd, &filep) < 0)
+    {
+      return NULL;
+    }
+
+  if (filep->f_inode == &g_dmabuf_inode)
+    {
+      buf = filep->f_priv;
+      atomic_fetch_add(&buf->refs, 1);
+    }
+
+  fs_putfilep(filep);
+  return buf;
+}
+
+/****************************************************************************
+ * Name: dmabuf_put
+ ****************************************************************************/
+
+void dmabuf_put(FAR struct dmabuf_s *buf)
+{
+  if (atomic_fetch_sub(&buf->refs, 1) == 1)
+    {
+      if (buf->release != NULL)
+        {
+          buf->release(buf->arg, buf->addr);
+        }
+
+      kmm_free(buf);
+    }
+}
+
+/****************************************************************************
+ * Name: dmabuf_vaddr
+ ****************************************************************************/
+
+FAR void *dmabuf_vaddr(FAR struct dmabuf_s *buf)
+{
+  return buf->addr;
+}
+
+/****************************************************************************
+ * Name: dmabuf_size
+ ****************************************************************************/
+
+size_t dmabuf_size(FAR struct dmabuf_s *buf)
+{
+  return buf->size;
+}
@@ -29,6 +29,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -42,8 +43,10 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/video/dmabuf.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/circbuf.h>
 
 /****************************************************************************
@@ -94,6 +97,14 @@ struct fb_chardev_s
   FAR struct fb_priv_s *head;
   FAR struct fb_paninfo_s *paninfo; /* Pan info array */
   size_t paninfo_count;             /* Pan info count */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s *dmabuf;      /* Imported scanout buffer */
+#endif
+#ifdef CONFIG_FB_DAMAGE
+  struct fb_area_s damage[CONFIG_FB_DAMAGE_NRECTS];
+  uint8_t ndamage;                  /* Number of pending areas in damage */
+  struct work_s damage_work;        /* Deferred flush */
+#endif
 };
 
 struct fb_panelinfo_s
@@ -133,6 +144,12 @@ static int     fb_get_panelinfo(FAR struct fb_chardev_s *fb,
 static int     fb_get_planeinfo(FAR struct fb_chardev_s *fb,
                                 FAR struct fb_planeinfo_s *pinfo,
                                 uint8_t display);
+#ifdef CONFIG_FB_DAMAGE
+static void    fb_damage_add(FAR struct fb_chardev_s *fb,
+                             FAR const struct fb_area_s *area);
+static int     fb_damage_flush(FAR struct fb_chardev_s *fb);
+static void    fb_damage_worker(FAR void *arg);
+#endif
 #ifdef CONFIG_FB_SYNC
 static int     fb_sem_wait(FAR struct fb_chardev_s *fb,
                            FAR struct fb_priv_s *priv,
@@ -708,7 +725,12 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+#ifdef CONFIG_FB_DAMAGE
+          fb_damage_add(fb, area);
+          ret = OK;
+#else
           ret = fb->vtable->updatearea(fb->vtable, area);
+#endif
         }
         break;
 #endif
@@ -719,6 +741,9 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           FAR struct fb_priv_s *priv = (FAR struct fb_priv_s *)filep->f_priv;
 
           DEBUGASSERT(fb->vtable != NULL);
+#ifdef CONFIG_FB_DAMAGE
+          fb_damage_flush(fb);
+#endif
           if (fb->vtable->waitforvsync != NULL)
             {
               ret = fb->vtable->waitforvsync(fb->vtable);
@@ -985,6 +1010,11 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           memcpy(&paninfo, pinfo, sizeof(*pinfo));
 
+#ifdef CONFIG_FB_DAMAGE
+          /* The damage belongs to the buffer that is about to be shown */
+
+          fb_damage_flush(fb);
+#endif
           if (fb->vtable->pandisplay != NULL)
             {
               fb->vtable->pandisplay(fb->vtable, pinfo);
@@ -1006,6 +1036,59 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_VIDEO_DMABUF
+      case FBIOSET_DMABUF:
+        {
+          FAR struct dmabuf_s *dmabuf = NULL;
+
+          DEBUGASSERT(fb->vtable != NULL);
+          if (fb->vtable->setbuffer == NULL)
+            {
+              ret = -ENOTTY;
+              break;
+            }
+
+          if ((int)arg >= 0)
+            {
+              dmabuf = dmabuf_get((int)arg);
+              if (dmabuf == NULL)
+                {
+                  ret = -EBADF;
+                  break;
+                }
+
+              ret = fb->vtable->setbuffer(fb->vtable, dmabuf_vaddr(dmabuf),
+                                          dmabuf_size(dmabuf));
+            }
+          else
+            {
+              ret = fb->vtable->setbuffer(fb->vtable, NULL, 0);
+            }
+
+          /* The plane keeps its reference until the next buffer has taken
+           * over the scanout.
+           */
+
+          if (ret < 0)
+            {
+              if (dmabuf != NULL)
+                {
+                  dmabuf_put(dmabuf);
+                }
+
+              break;
+            }
+
+          if (fb->dmabuf != NULL)
+            {
+              dmabuf_put(fb->dmabuf);
+            }
+
+          fb->dmabuf = dmabuf;
+        }
+        break;
+#endif
+
       case FBIOGET_VSCREENINFO:
         {
           struct fb_videoinfo_s vinfo;
@@ -1404,6 +1487,160 @@ static void fb_do_pollnotify(wdparm_t arg)
   leave_critical_section(flags);
 }
 
+#ifdef CONFIG_FB_DAMAGE
+/****************************************************************************
+ * Name: fb_area_size
+ ****************************************************************************/
+
+static uint32_t fb_area_size(FAR const struct fb_area_s *area)
+{
+  return (uint32_t)area->w * area->h;
+}
+
+/****************************************************************************
+ * Name: fb_area_union
+ ****************************************************************************/
+
+static void fb_area_union(FAR struct fb_area_s *out,
+                          FAR const struct fb_area_s *a,
+                          FAR const struct fb_area_s *b)
+{
+  fb_coord_t x1 = MIN(a->x, b->x);
+  fb_coord_t y1 = MIN(a->y, b->y);
+  fb_coord_t x2 = MAX(a->x + a->w, b->x + b->w);
+  fb_coord_t y2 = MAX(a->y + a->h, b->y + b->h);
+
+  out->x = x1;
+  out->y = y1;
+  out->w = x2 - x1;
+  out->h = y2 - y1;
+}
+
+/****************************************************************************
+ * Name: fb_damage_add
+ *
+ * Description:
+ *   Add an area to the pending damage of the frame and schedule a flush.
+ *   An area is folded into an existing rectangle when their bounding box
+ *   is no larger than the two rectangles together, i.e. when merging does
+ *   not send more pixels than flushing them separately would.  If nothing
+ *   qualifies and the list is full, the rectangle whose bounding box grows
+ *   the least absorbs the area.
+ *
+ ****************************************************************************/
+
+static void fb_damage_add(FAR struct fb_chardev_s *fb,
+                          FAR const struct fb_area_s *area)
+{
+  struct fb_area_s cur = *area;
+  struct fb_area_s merged;
+  irqstate_t flags;
+  uint32_t best_growth;
+  uint32_t growth;
+  int best;
+  int i;
+
+  if (area->w == 0 || area->h == 0)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  /* Keep merging: a grown rectangle may now cover another one */
+
+  for (i = 0; i < fb->ndamage; )
+    {
+      fb_area_union(&merged, &cur, &fb->damage[i]);
+      if (fb_area_size(&merged) <=
+          fb_area_size(&cur) + fb_area_size(&fb->damage[i]))
+        {
+          cur = merged;
+          fb->damage[i] = fb->damage[--fb->ndamage];
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (fb->ndamage < CONFIG_FB_DAMAGE_NRECTS)
+    {
+      fb->damage[fb->ndamage++] = cur;
+    }
+  else
+    {
+      best = 0;
+      best_growth = UINT32_MAX;
+      for (i = 0; i < fb->ndamage; i++)
+        {
+          fb_area_union(&merged, &cur, &fb->damage[i]);
+          growth = fb_area_size(&merged) - fb_area_size(&fb->damage[i]);
+          if (growth < best_growth)
+            {
+              best_growth = growth;
+              best = i;
+            }
+        }
+
+      fb_area_union(&fb->damage[best], &cur, &fb->damage[best]);
+    }
+
+  leave_critical_section(flags);
+
+  if (work_available(&fb->damage_work))
+    {
+      work_queue(LPWORK, &fb->damage_work, fb_damage_worker, fb,
+                 MSEC2TICK(CONFIG_FB_DAMAGE_INTERVAL));
+    }
+}
+
+/****************************************************************************
+ * Name: fb_damage_flush
+ *
+ * Description:
+ *   Send all pending damage of the frame to the panel.
+ *
+ ****************************************************************************/
+
+static int fb_damage_flush(FAR struct fb_chardev_s *fb)
+{
+  struct fb_area_s damage[CONFIG_FB_DAMAGE_NRECTS];
+  irqstate_t flags;
+  int ndamage;
+  int ret = OK;
+  int err;
+  int i;
+
+  flags = enter_critical_section();
+  ndamage = fb->ndamage;
+  memcpy(damage, fb->damage, ndamage * sizeof(struct fb_area_s));
+  fb->ndamage = 0;
+  leave_critical_section(flags);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      err = fb->vtable->updatearea(fb->vtable, &damage[i]);
+      if (err < 0)
+        {
+          ret = err;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fb_damage_worker
+ ****************************************************************************/
+
+static void fb_damage_worker(FAR void *arg)
+{
+  fb_damage_flush(arg);
+}
+#endif
+
 #ifdef CONFIG_FB_SYNC
 /****************************************************************************
  * Name: fb_sem_wait
@@ -1535,6 +1772,15 @@ void fb_notify_vsync(FAR struct fb_vtable_s *vtable)
           poll_notify(priv->fds, CONFIG_VIDEO_FB_NPOLLWAITERS, POLLPRI);
         }
 
+#ifdef CONFIG_FB_DAMAGE
+      /* Pull the pending flush forward to the start of the new frame */
+
+      if (fb->ndamage > 0)
+        {
+          work_queue(LPWORK, &fb->damage_work, fb_damage_worker, fb, 0);
+        }
+#endif
+
       leave_critical_section(flags);
     }
 }
@@ -31,6 +31,7 @@
 #include <errno.h>
 #include <poll.h>
 
+#include <nuttx/mm/cma.h>
 #include <nuttx/mutex.h>
 #include <nuttx/video/v4l2_cap.h>
 #include <nuttx/video/video.h>
@@ -109,6 +110,9 @@ struct capture_type_inf_s
   struct v4l2_fract      frame_interval;
   video_framebuff_t      bufinf;
   FAR uint8_t            *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+  struct cma_buffer_s    bufcma;     /* bufheap if taken from the CMA */
+#endif
   FAR struct pollfd      *fds;
   uint32_t               seqnum;
 };
@@ -181,6 +185,9 @@ struct capture_mng_s
   enum v4l2_scene_mode   capture_scene_mode;
   uint8_t                capture_scence_num;
   FAR capture_scene_params_t *capture_scene_param[V4L2_SCENE_MODE_MAX];
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+  FAR struct cma_consumer_s *cma;
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   bool                   unlinked;
 #endif
@@ -292,6 +299,10 @@ static int capture_enum_frmsize(FAR struct file *filep,
 
 static int capture_open(FAR struct file *filep);
 static int capture_close(FAR struct file *filep);
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *exp);
+#endif
 static int capture_mmap(FAR struct file *filep,
                         FAR struct mm_map_entry_s *map);
 static int capture_poll(FAR struct file *filep,
@@ -339,7 +350,17 @@ static const struct v4l2_ops_s g_capture_vops =
   capture_s_ext_ctrls_scene,          /* s_ext_ctrls_scene */
   capture_enum_fmt,                   /* enum_fmt */
   capture_enum_frminterval,           /* enum_frminterval */
-  capture_enum_frmsize                /* enum_frmsize */
+  capture_enum_frmsize,               /* enum_frmsize */
+  NULL,                               /* cropcap */
+  NULL,                               /* dqevent */
+  NULL,                               /* subscribe_event */
+  NULL,                               /* decoder_cmd */
+  NULL,                               /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  capture_expbuf                      /* expbuf */
+#else
+  NULL                                /* expbuf */
+#endif
 };
 
 static const struct file_operations g_capture_fops =
@@ -1179,25 +1200,62 @@ static void initialize_resources(FAR capture_mng_t *cmng)
   initialize_scenes_parameter(cmng);
 }
 
+static int alloc_bufheap(FAR capture_type_inf_t *type_inf,
+                         FAR capture_mng_t *cmng, size_t size)
+{
+  FAR struct imgdata_s *imgdata = cmng->imgdata;
+
+  if (imgdata->ops->alloc)
+    {
+      type_inf->bufheap = imgdata->ops->alloc(imgdata, 32, size);
+    }
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+  else if (cma_alloc(cmng->cma, size, &type_inf->bufcma) == OK)
+    {
+      type_inf->bufheap = type_inf->bufcma.addr;
+    }
+#endif
+  else
+    {
+      type_inf->bufheap = kumm_memalign(32, size);
+    }
+
+  return type_inf->bufheap != NULL ? OK : -ENOMEM;
+}
+
+static void free_bufheap(FAR capture_type_inf_t *type_inf,
+                         FAR capture_mng_t *cmng)
+{
+  if (type_inf->bufheap == NULL)
+    {
+      return;
+    }
+
+  if (cmng->imgdata->ops->free)
+    {
+      cmng->imgdata->ops->free(cmng->imgdata, type_inf->bufheap);
+    }
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+  else if (type_inf->bufcma.addr != NULL)
+    {
+      cma_free(&type_inf->bufcma);
+    }
+#endif
+  else
+    {
+      kumm_free(type_inf->bufheap);
+    }
+
+  type_inf->bufheap = NULL;
+}
+
 static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
                                     FAR capture_mng_t *cmng)
 {
   video_framebuff_uninit(&type_inf->bufinf);
   nxsem_destroy(&type_inf->wait_capture.dqbuf_wait_flg);
   nxmutex_destroy(&type_inf->lock_state);
-  if (type_inf->bufheap != NULL)
-    {
-      if (cmng->imgdata->ops->free)
-        {
-          cmng->imgdata->ops->free(cmng->imgdata, type_inf->bufheap);
-        }
-      else
-        {
-          kumm_free(type_inf->bufheap);
-        }
-
-      type_inf->bufheap = NULL;
-    }
+  free_bufheap(type_inf, cmng);
 }
 
 static void cleanup_scene_parameter(FAR capture_scene_params_t **vsp)
@@ -1978,6 +2036,18 @@ static int complete_capture(uint8_t err_code,
     }
 
   type_inf->bufinf.vbuf_next->buf.bytesused = datasize;
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+  if (type_inf->bufcma.addr != NULL &&
+      type_inf->bufinf.vbuf_next->buf.memory == V4L2_MEMORY_MMAP)
+    {
+      /* The frame was written by DMA, drop any stale cache lines */
+
+      cma_sync_for_cpu(&type_inf->bufcma,
+                       type_inf->bufinf.vbuf_next->buf.m.userptr -
+                       (uintptr_t)type_inf->bufheap, datasize);
+    }
+#endif
+
   if (ts != NULL)
     {
       type_inf->bufinf.vbuf_next->buf.timestamp = *ts;
@@ -2138,7 +2208,6 @@ static int capture_reqbufs(FAR struct file *filep,
   FAR struct inode *inode = filep->f_inode;
   FAR capture_mng_t *cmng = inode->i_private;
   FAR capture_type_inf_t *type_inf;
-  struct imgdata_s *imgdata;
   irqstate_t flags;
   int ret = OK;
 
@@ -2147,7 +2216,6 @@ static int capture_reqbufs(FAR struct file *filep,
       return -EINVAL;
     }
 
-  imgdata  = cmng->imgdata;
   type_inf = get_capture_type_inf(cmng, reqbufs->type);
   if (type_inf == NULL)
     {
@@ -2174,34 +2242,9 @@ static int capture_reqbufs(FAR struct file *filep,
                                               reqbufs->count);
       if (ret == OK && reqbufs->memory == V4L2_MEMORY_MMAP)
         {
-          if (type_inf->bufheap != NULL)
-            {
-              if (imgdata->ops->free)
-                {
-                    imgdata->ops->free(imgdata, type_inf->bufheap);
-                }
-              else
-                {
-                  kumm_free(type_inf->bufheap);
-                }
-            }
-
-          if (imgdata->ops->alloc)
-            {
-              type_inf->bufheap = imgdata->ops->alloc(imgdata, 32,
-                reqbufs->count *
-                get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]));
-            }
-          else
-            {
-              type_inf->bufheap = kumm_memalign(32, reqbufs->count *
-                get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]));
-            }
-
-          if (type_inf->bufheap == NULL)
-            {
-              ret = -ENOMEM;
-            }
+          free_bufheap(type_inf, cmng);
+          ret = alloc_bufheap(type_inf, cmng, reqbufs->count *
+                  get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]));
         }
     }
 
@@ -2259,7 +2302,10 @@ static int capture_qbuf(FAR struct file *filep,
       return -EINVAL;
     }
 
-  if (!is_bufsize_sufficient(cmng, buf->length))
+  /* The size of a DMABUF is only known once it has been imported */
+
+  if (buf->memory != V4L2_MEMORY_DMABUF &&
+      !is_bufsize_sufficient(cmng, buf->length))
     {
       return -EINVAL;
     }
@@ -2279,6 +2325,13 @@ static int capture_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+  else if (video_framebuff_import(container) < 0 ||
+           !is_bufsize_sufficient(cmng, container->buf.length))
+    {
+      video_framebuff_release(container);
+      video_framebuff_free_container(&type_inf->bufinf, container);
+      return -EINVAL;
+    }
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -2393,6 +2446,7 @@ static int capture_dqbuf(FAR struct file *filep,
       type_inf->wait_capture.done_container = NULL;
     }
 
+  video_framebuff_release(container);
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
   video_framebuff_free_container(&type_inf->bufinf, container);
 
@@ -3605,6 +3659,9 @@ static int capture_close(FAR struct file *filep)
         {
           nxmutex_unlock(&cmng->lock_open_num);
           nxmutex_destroy(&cmng->lock_open_num);
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+          cma_unreserve(cmng->cma);
+#endif
           kmm_free(cmng);
           inode->i_private = NULL;
           return OK;
@@ -3617,6 +3674,45 @@ static int capture_close(FAR struct file *filep)
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *exp)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR capture_mng_t *cmng = inode->i_private;
+  FAR capture_type_inf_t *type_inf;
+  size_t bufsize;
+  int fd;
+
+  if (cmng == NULL || exp == NULL || exp->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_capture_type_inf(cmng, exp->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      exp->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  /* The exported buffer stays part of the MMAP heap, so importers must be
+   * done with it before the next VIDIOC_REQBUFS.
+   */
+
+  bufsize = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
+  fd = dmabuf_export(type_inf->bufheap + bufsize * exp->index, bufsize,
+                     NULL, NULL, exp->flags);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  exp->fd = fd;
+  return OK;
+}
+#endif
+
 static int capture_mmap(FAR struct file *filep,
                         FAR struct mm_map_entry_s *map)
 {
@@ -3637,6 +3733,13 @@ static int capture_mmap(FAR struct file *filep,
   if (map->offset >= 0 && map->offset < heapsize &&
       map->length && map->offset + map->length <= heapsize)
     {
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+      if (type_inf->bufcma.addr != NULL)
+        {
+          return cma_mmap(&type_inf->bufcma, map);
+        }
+#endif
+
       map->vaddr = type_inf->bufheap + map->offset;
       ret = OK;
     }
@@ -3712,6 +3815,9 @@ static int capture_unlink(FAR struct inode *inode)
     {
       nxmutex_unlock(&cmng->lock_open_num);
       nxmutex_destroy(&cmng->lock_open_num);
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+      cma_unreserve(cmng->cma);
+#endif
       kmm_free(cmng);
       inode->i_private = NULL;
     }
@@ -3781,6 +3887,14 @@ int capture_register(FAR const char *devpath,
 
   nxmutex_init(&cmng->lock_open_num);
 
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+  /* Reserve contiguous memory for the MMAP buffers.  If that fails, the
+   * buffers are allocated from the user heap instead.
+   */
+
+  cmng->cma = cma_reserve(devpath, CONFIG_VIDEO_CAPTURE_CMA_SIZE);
+#endif
+
   /* Register the character driver */
 
   ret = video_register(devpath, (FAR struct v4l2_s *)cmng);
@@ -3788,6 +3902,9 @@ int capture_register(FAR const char *devpath,
     {
       verr("Failed to register driver: %d\n", ret);
       nxmutex_destroy(&cmng->lock_open_num);
+#ifdef CONFIG_VIDEO_CAPTURE_CMA
+      cma_unreserve(cmng->cma);
+#endif
       kmm_free(cmng);
       return ret;
     }
@@ -153,6 +153,10 @@ static int codec_decoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_decoder_cmd *cmd);
 static int codec_encoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_encoder_cmd *cmd);
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *exp);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -198,7 +202,12 @@ static const struct v4l2_ops_s g_codec_vops =
   codec_dqevent,         /* dqevent */
   codec_subscribe_event, /* subscribe_event */
   codec_decoder_cmd,     /* decoder_cmd */
-  codec_encoder_cmd      /* encoder_cmd */
+  codec_encoder_cmd,     /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  codec_expbuf           /* expbuf */
+#else
+  NULL                   /* expbuf */
+#endif
 };
 
 static const struct file_operations g_codec_fops =
@@ -413,6 +422,11 @@ static int codec_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+  else if (video_framebuff_import(container) < 0)
+    {
+      video_framebuff_free_container(&type_inf->bufinf, container);
+      return -EINVAL;
+    }
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -460,6 +474,7 @@ static int codec_dqbuf(FAR struct file *filep,
       return -EAGAIN;
     }
 
+  video_framebuff_release(container);
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
   video_framebuff_free_container(&type_inf->bufinf, container);
 
@@ -470,6 +485,55 @@ static int codec_dqbuf(FAR struct file *filep,
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *exp)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR codec_mng_t *cmng = inode->i_private;
+  FAR codec_file_t *cfile = filep->f_priv;
+  FAR codec_type_inf_t *type_inf;
+  size_t buf_size;
+  int fd;
+
+  if (exp == NULL || exp->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = codec_get_type_inf(cfile, exp->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      exp->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  if (V4L2_TYPE_IS_OUTPUT(exp->type))
+    {
+      buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+  else
+    {
+      buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+
+  if (buf_size == 0)
+    {
+      return -EINVAL;
+    }
+
+  fd = dmabuf_export(type_inf->bufheap + buf_size * exp->index, buf_size,
+                     NULL, NULL, exp->flags);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  exp->fd = fd;
+  return OK;
+}
+#endif
+
 static int codec_s_selection(FAR struct file *filep,
                              FAR struct v4l2_selection *clip)
 {
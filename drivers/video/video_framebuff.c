@@ -54,6 +54,18 @@ static void init_buf_chain(video_framebuff_t *fbuf)
     }
 }
 
+static void release_buf_chain(video_framebuff_t *fbuf)
+{
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+
+  for (i = 0; i < fbuf->container_size; i++)
+    {
+      video_framebuff_release(&fbuf->vbuf_alloced[i]);
+    }
+#endif
+}
+
 static inline bool is_last_one(video_framebuff_t *fbuf)
 {
   return fbuf->vbuf_top == fbuf->vbuf_tail;
@@ -111,6 +123,8 @@ int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
       return OK;
     }
 
+  release_buf_chain(fbuf);
+
   if (sz > 0)
     {
       vbuf = kmm_realloc(fbuf->vbuf_alloced, sizeof(vbuf_container_t) * sz);
@@ -289,3 +303,42 @@ vbuf_container_t *video_framebuff_pop_curr_container(video_framebuff_t *fbuf)
   spin_unlock_irqrestore(&fbuf->lock_queue, flags);
   return ret;
 }
+
+int video_framebuff_import(vbuf_container_t *cnt)
+{
+  if (cnt->buf.memory != V4L2_MEMORY_DMABUF)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Take a reference on the application's buffer for as long as it is
+   * queued, and let the lower half see it as a plain user pointer.
+   */
+
+  cnt->dmabuf = dmabuf_get(cnt->buf.m.fd);
+  if (cnt->dmabuf == NULL)
+    {
+      return -EBADF;
+    }
+
+  cnt->fd            = cnt->buf.m.fd;
+  cnt->buf.m.userptr = (unsigned long)dmabuf_vaddr(cnt->dmabuf);
+  cnt->buf.length    = dmabuf_size(cnt->dmabuf);
+  return OK;
+#else
+  return -EINVAL;
+#endif
+}
+
+void video_framebuff_release(vbuf_container_t *cnt)
+{
+#ifdef CONFIG_VIDEO_DMABUF
+  if (cnt->dmabuf != NULL)
+    {
+      dmabuf_put(cnt->dmabuf);
+      cnt->dmabuf   = NULL;
+      cnt->buf.m.fd = cnt->fd;
+    }
+#endif
+}
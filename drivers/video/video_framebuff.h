@@ -31,6 +31,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/video/dmabuf.h>
 
 /****************************************************************************
  * Public Types
@@ -40,6 +41,10 @@ struct vbuf_container_s
 {
   struct v4l2_buffer       buf;   /* Buffer information */
   struct vbuf_container_s *next;  /* Pointer to next buffer */
+#ifdef CONFIG_VIDEO_DMABUF
+  struct dmabuf_s         *dmabuf; /* Imported DMABUF, if any */
+  int                      fd;     /* Application's DMABUF descriptor */
+#endif
 };
 
 typedef struct vbuf_container_s vbuf_container_t;
@@ -90,4 +95,15 @@ void              video_framebuff_capture_done
 void              video_framebuff_change_mode
                        (video_framebuff_t *fbuf, enum v4l2_buf_mode mode);
 
+/* V4L2_MEMORY_DMABUF support.  video_framebuff_import() resolves the
+ * descriptor of a queued buffer into an address and holds a reference on
+ * it; video_framebuff_release() drops the reference again and restores the
+ * descriptor before the buffer is handed back to the application.
+ */
+
+int               video_framebuff_import
+                       (vbuf_container_t *cnt);
+void              video_framebuff_release
+                       (vbuf_container_t *cnt);
+
 #endif  /* __DRIVERS_VIDEO_VIDEO_FRAMEBUFF_H */
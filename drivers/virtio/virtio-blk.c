@@ -28,6 +28,7 @@
 #include <errno.h>
 #include <stdio.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/semaphore.h>
@@ -114,6 +115,20 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* One request on the virtqueue.  The address of this structure is the
+ * virtqueue cookie.  Synchronous requests live on the caller's stack and
+ * post 'sem'; asynchronous requests are allocated and complete 'aio'.
+ */
+
+struct virtio_blk_cmd_s
+{
+  struct virtio_blk_req_s  req;      /* Block out header */
+  struct virtio_blk_resp_s resp;     /* Block in header */
+  FAR struct fs_aio_s     *aio;      /* Asynchronous request, or NULL */
+  unsigned int             nsectors; /* Number of sectors transferred */
+  sem_t                    sem;      /* Completion of synchronous requests */
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio deivce */
@@ -129,6 +144,10 @@ struct virtio_blk_priv_s
 
 /* BLK block_operations functions and they helper function */
 
+static int     virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                                 FAR struct virtio_blk_cmd_s *cmd,
+                                 FAR void *buffer, blkcnt_t startsector,
+                                 unsigned int nsectors, bool write);
 static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
                                FAR void *buffer, blkcnt_t startsector,
                                unsigned int nsectors, bool write);
@@ -144,6 +163,8 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
                                    FAR struct geometry *geometry);
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
+static int     virtio_blk_aio(FAR struct inode *inode,
+                              FAR struct fs_aio_s *aio);
 static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
 
 /* Other functions */
@@ -174,7 +195,11 @@ static const struct block_operations g_virtio_blk_bops =
   virtio_blk_read,     /* read     */
   virtio_blk_write,    /* write    */
   virtio_blk_geometry, /* geometry */
-  virtio_blk_ioctl     /* ioctl    */
+  virtio_blk_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,                /* unlink   */
+#endif
+  virtio_blk_aio       /* aio      */
 };
 
 static int g_virtio_blk_idx = 0;
@@ -183,6 +208,30 @@ static int g_virtio_blk_idx = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_blk_finish
+ *
+ * Description:
+ *   Finish a request returned by the virtqueue
+ *
+ ****************************************************************************/
+
+static void virtio_blk_finish(FAR struct virtio_blk_cmd_s *cmd)
+{
+  FAR struct fs_aio_s *aio = cmd->aio;
+  ssize_t result;
+
+  if (aio == NULL)
+    {
+      nxsem_post(&cmd->sem);
+      return;
+    }
+
+  result = cmd->resp.status == VIRTIO_BLK_S_OK ? cmd->nsectors : -EIO;
+  kmm_free(cmd);
+  aio->complete(aio, result);
+}
+
 /****************************************************************************
  * Name: virtio_blk_wait_complete
  *
@@ -192,62 +241,60 @@ static int g_virtio_blk_idx = 0;
  ****************************************************************************/
 
 static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
-                                     FAR sem_t *respsem)
+                                     FAR struct virtio_blk_cmd_s *cmd)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *sem;
+  FAR struct virtio_blk_cmd_s *done;
 
   if (up_interrupt_context())
     {
       for (; ; )
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-          if (sem == respsem)
+          done = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+          if (done == cmd)
             {
               break;
             }
-          else if (sem != NULL)
+          else if (done != NULL)
             {
-              nxsem_post(sem);
+              virtio_blk_finish(done);
             }
         }
     }
   else
     {
-      nxsem_wait_uninterruptible(respsem);
+      nxsem_wait_uninterruptible(&cmd->sem);
     }
 }
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_submit
  *
  * Description:
- *   Common function for read and write
+ *   Put a read or write request on the virtqueue and kick the device
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static int virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                             FAR struct virtio_blk_cmd_s *cmd,
+                             FAR void *buffer, blkcnt_t startsector,
+                             unsigned int nsectors, bool write)
 {
   FAR struct virtio_device *vdev = priv->vdev;
   FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
   irqstate_t flags;
-  sem_t respsem;
-  ssize_t ret;
   int readnum;
-
-  nxsem_init(&respsem, 0, 0);
+  int ret;
 
   /* Build the block request */
 
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  cmd->req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+  cmd->req.reserved = 0;
+  cmd->req.sector   = startsector * priv->block_size >>
+                      VIRTIO_BLK_SECTOR_BITS;
+  cmd->resp.status  = VIRTIO_BLK_S_IOERR;
+  cmd->nsectors     = nsectors;
 
   /* Fill the virtqueue buffer:
    * Buffer 0: the block out header;
@@ -255,36 +302,63 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
    * Buffer 2: the block in header, return the status.
    */
 
-  vb[0].buf = &req;
+  vb[0].buf = &cmd->req;
   vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
   vb[1].buf = buffer;
   vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
+  vb[2].buf = &cmd->resp;
   vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
   readnum = write ? 2 : 1;
 
+  flags = spin_lock_irqsave(&priv->lock);
+  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, cmd);
+  if (ret < 0)
+    {
+      spin_unlock_irqrestore(&priv->lock, flags);
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+  spin_unlock_irqrestore(&priv->lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[0].vq;
+  struct virtio_blk_cmd_s cmd;
+  ssize_t ret;
+
+  cmd.aio = NULL;
+  nxsem_init(&cmd.sem, 0, 0);
+
   if (up_interrupt_context())
     {
       virtqueue_disable_cb_lock(vq, &priv->lock);
     }
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
+  ret = virtio_blk_submit(priv, &cmd, buffer, startsector, nsectors, write);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
       goto err;
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
-
   /* Wait for the request completion */
 
-  virtio_blk_wait_complete(vq, &respsem);
+  virtio_blk_wait_complete(vq, &cmd);
 
-  if (resp.status != VIRTIO_BLK_S_OK)
+  if (cmd.resp.status != VIRTIO_BLK_S_OK)
     {
       vrterr("%s Error\n", write ? "Write" : "Read");
       ret = -EIO;
@@ -296,6 +370,7 @@ err:
       virtqueue_enable_cb_lock(vq, &priv->lock);
     }
 
+  nxsem_destroy(&cmd.sem);
   return ret >= 0 ? nsectors : ret;
 }
 
@@ -409,32 +484,31 @@ static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
   FAR struct virtio_device *vdev = priv->vdev;
   FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[2];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  struct virtio_blk_cmd_s cmd;
   irqstate_t flags;
-  sem_t respsem;
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
+  cmd.aio = NULL;
+  nxsem_init(&cmd.sem, 0, 0);
 
   /* Build the block request */
 
-  req.type     = VIRTIO_BLK_T_FLUSH;
-  req.reserved = 0;
-  req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  cmd.req.type     = VIRTIO_BLK_T_FLUSH;
+  cmd.req.reserved = 0;
+  cmd.req.sector   = 0;
+  cmd.resp.status  = VIRTIO_BLK_S_IOERR;
 
-  vb[0].buf = &req;
+  vb[0].buf = &cmd.req;
   vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = &resp;
+  vb[1].buf = &cmd.resp;
   vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
 
   flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
+  ret = virtqueue_add_buffer(vq, vb, 1, 1, &cmd);
   if (ret < 0)
     {
       spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
+      goto out;
     }
 
   virtqueue_kick(vq);
@@ -442,13 +516,15 @@ static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 
   /* Wait for the request completion */
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+  nxsem_wait_uninterruptible(&cmd.sem);
+  if (cmd.resp.status != VIRTIO_BLK_S_OK)
     {
       vrterr("Flush Error\n");
       ret = -EIO;
     }
 
+out:
+  nxsem_destroy(&cmd.sem);
   return ret;
 }
 
@@ -478,6 +554,51 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
   return ret;
 }
 
+/****************************************************************************
+ * Name: virtio_blk_aio
+ *
+ * Description:
+ *   Start an asynchronous transfer.  It completes from virtio_blk_done()
+ *   when the device returns the buffers.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_aio(FAR struct inode *inode, FAR struct fs_aio_s *aio)
+{
+  FAR struct virtio_blk_priv_s *priv;
+  FAR struct virtio_blk_cmd_s *cmd;
+  int ret;
+
+  DEBUGASSERT(inode->i_private);
+  priv = inode->i_private;
+
+  if (aio->write && virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
+    {
+      return -EPERM;
+    }
+
+  if (aio->offset + aio->nbytes > priv->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  cmd = kmm_malloc(sizeof(struct virtio_blk_cmd_s));
+  if (cmd == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  cmd->aio = aio;
+  ret = virtio_blk_submit(priv, cmd, aio->buf, aio->offset, aio->nbytes,
+                          aio->write);
+  if (ret < 0)
+    {
+      kmm_free(cmd);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: virtio_blk_done
  ****************************************************************************/
@@ -485,18 +606,22 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *respsem;
+  FAR struct virtio_blk_cmd_s *cmd;
 
-  for (; ; )
+  do
     {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-      if (respsem == NULL)
+      while ((cmd = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                              &priv->lock)) != NULL)
         {
-          break;
+          virtio_blk_finish(cmd);
         }
 
-      nxsem_post(respsem);
+      /* With VIRTIO_RING_F_EVENT_IDX the device interrupts again only
+       * after the used index passes the one published here.  Check for
+       * requests that completed before it was published.
+       */
     }
+  while (virtqueue_enable_cb_lock(vq, &priv->lock) != 0);
 }
 
 /****************************************************************************
@@ -519,7 +644,8 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+                                  VIRTIO_RING_F_EVENT_IDX, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
   vqname[0]   = "virtio_blk_vq";
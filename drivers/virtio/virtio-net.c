@@ -31,6 +31,7 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/virtio/virtio.h>
@@ -44,20 +45,87 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_MRG_RXBUF  15
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net header flags */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
+
+/* The received checksums are only trusted by a host, a packet that is
+ * forwarded must carry a complete checksum.
+ */
+
+#if defined(CONFIG_NETDEV_CHKSUM_OFFLOAD) && !defined(CONFIG_NET_IPFORWARD)
+#  define VIRTIO_NET_FEATURES   ((1UL << VIRTIO_NET_F_CSUM) | \
+                                 (1UL << VIRTIO_NET_F_GUEST_CSUM))
+#elif defined(CONFIG_NETDEV_CHKSUM_OFFLOAD)
+#  define VIRTIO_NET_FEATURES   (1UL << VIRTIO_NET_F_CSUM)
+#else
+#  define VIRTIO_NET_FEATURES   0
+#endif
+
+/* The queue pairs beyond the first one are enabled through the control
+ * virtqueue.
+ */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MQ_FEATURES ((1UL << VIRTIO_NET_F_CTRL_VQ) | \
+                                  (1UL << VIRTIO_NET_F_MQ))
+#  define VIRTIO_NET_MAX_PAIRS   CONFIG_NETDEV_MAX_QUEUES
+#else
+#  define VIRTIO_NET_MQ_FEATURES 0
+#  define VIRTIO_NET_MAX_PAIRS   1
+#endif
+
+/* Mergeable RX buffers let a received packet span several one-IOB
+ * buffers, so the RX virtqueues hold more packets for the same memory.
+ */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+#  define VIRTIO_NET_MRG_FEATURES (1UL << VIRTIO_NET_F_MRG_RXBUF)
+#else
+#  define VIRTIO_NET_MRG_FEATURES 0
+#endif
+
+/* Virtio net header size and packet buffer size.  The header is shorter
+ * by num_buffers unless VIRTIO_NET_F_MRG_RXBUF was negotiated.
+ */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* The room for the frame in a single IOB, i.e. one mergeable RX buffer */
+
+#define VIRTIO_NET_MRG_BUFSIZE \
+    MIN(NETPKT_BUFLEN - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN, \
+        VIRTIO_NET_BUFSIZE)
+
+/* Virtio net virtqueue index and number, queue pair n uses the virtqueues
+ * 2n (RX) and 2n + 1 (TX).  The control virtqueue follows the last pair.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#define VIRTIO_NET_RXQ(q)     (VIRTIO_NET_NUM * (q) + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     (VIRTIO_NET_NUM * (q) + VIRTIO_NET_TX)
+#define VIRTIO_NET_PAIR(id)   ((id) / VIRTIO_NET_NUM)
+#define VIRTIO_NET_ISTX(id)   ((id) % VIRTIO_NET_NUM == VIRTIO_NET_TX)
+
+/* Control virtqueue command to set the number of queue pairs */
+
+#define VIRTIO_NET_CTRL_MQ              4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_OK                   0
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
@@ -79,6 +147,9 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  uint16_t num_buffers;
+#endif
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -99,6 +170,20 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Control virtqueue command, the class and command are read by the device
+ * and the ack written back.
+ */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+begin_packed_struct struct virtio_net_ctrl_mq_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+#endif
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -112,12 +197,19 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_NUM * VIRTIO_NET_MAX_PAIRS];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       rxbufnum;  /* RX Buffer number */
+  uint8_t                   hdrsize;   /* Negotiated virtio header size */
+  uint16_t                  rxbufsize; /* Length of a RX buffer */
+  int                       npairs;    /* Number of queue pairs in use */
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  sem_t                     ctrlsem;   /* Control command completion */
+#endif
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -133,6 +225,10 @@ struct virtio_net_priv_s
  *                          = sizeof(uintptr) + 10 + 14
  *                          = 32 (64-Bit)
  *                          = 28 (32-Bit)
+ *
+ * CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF needs two more bytes for num_buffers.
+ * If the device does not offer the feature the header stays 10 bytes and
+ * is placed right before the ETH Header, see virtio_net_llhdr().
  */
 
 begin_packed_struct struct virtio_net_llhdr_s
@@ -145,6 +241,11 @@ static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
               " + VIRTIO_NET_LLHDRSIZE");
 
+#define virtio_net_llhdr(priv, data) \
+  ((FAR struct virtio_net_llhdr_s *) \
+   ((FAR uint8_t *)(data) - (priv)->hdrsize - \
+    offsetof(struct virtio_net_llhdr_s, vhdr)))
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -165,6 +266,14 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev, int queue,
+                            FAR netpkt_t *pkt);
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue);
+static void virtio_net_txfreeq(FAR struct netdev_lowerhalf_s *dev,
+                               int queue);
+#endif
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -194,7 +303,12 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_sendq,
+  virtio_net_recvq,
+  virtio_net_txfreeq
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -226,12 +340,23 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 
   /* Alloc cookie and net header from transport layer */
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
+  hdr = virtio_net_llhdr(priv, iov[0].iov_base);
   DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
+  memset(&hdr->vhdr, 0, priv->hdrsize);
   hdr->pkt = pkt;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Let the device finish the checksum the stack left to it */
+
+  if (VIRTIO_NET_ISTX(vq_id) &&
+      (dev->netdev.d_chksum_flags & NETDEV_CHKSUM_PARTIAL) != 0)
+    {
+      hdr->vhdr.flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+      hdr->vhdr.csum_start  = ETH_HDRLEN + dev->netdev.d_chksum_start;
+      hdr->vhdr.csum_offset = dev->netdev.d_chksum_offset;
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -239,7 +364,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Append the virtio net header to the first buffer */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].len = iov[0].iov_len + priv->hdrsize;
 
 #if VIRTIO_NET_MAX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
@@ -254,7 +379,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Buffer 0 is only for virtio net header */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
@@ -266,7 +391,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (!VIRTIO_NET_ISTX(vq_id))
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -282,18 +407,19 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(queue)].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (i = 0; i < priv->rxbufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
-      pkt = netpkt_alloc(dev, NETPKT_RX);
+      pkt = netpkt_qalloc(dev, queue, NETPKT_RX);
       if (pkt == NULL)
         {
           vrtinfo("Has ran out of the RX buffer, i=%d\n", i);
@@ -302,33 +428,34 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Preserve data length */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, priv->rxbufsize) < priv->rxbufsize)
         {
           vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
-          netpkt_free(dev, pkt, NETPKT_RX);
+          netpkt_qfree(dev, queue, pkt, NETPKT_RX);
           break;
         }
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RXQ(queue));
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RXQ(queue)]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txfreeq
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfreeq(FAR struct netdev_lowerhalf_s *dev,
+                               int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(queue)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
@@ -336,17 +463,26 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
       /* Get buffer from tx virtqueue */
 
       hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+                                      &priv->lock[VIRTIO_NET_TXQ(queue)]);
       if (hdr == NULL)
         {
           break;
         }
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
+      netpkt_qfree(dev, queue, hdr->pkt, NETPKT_TX);
       vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  virtio_net_txfreeq(dev, 0);
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -354,6 +490,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -370,9 +507,12 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+                               &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -395,7 +535,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < VIRTIO_NET_NUM * priv->npairs; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -415,14 +555,15 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_sendq
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev, int queue,
+                            FAR netpkt_t *pkt)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(queue)].vq;
 
   /* Check the send length */
 
@@ -434,65 +575,152 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TXQ(queue));
+  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TXQ(queue)]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfreeq(dev, queue);
 
   /* If we have no buffer left, enable TX done callback. */
 
-  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
+  if (netdev_lower_quota_load_queue(dev, queue, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TXQ(queue)]);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_sendq(dev, 0, pkt);
+}
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+/****************************************************************************
+ * Name: virtio_net_merge
+ *
+ * Description:
+ *   Append the other 'num' - 1 buffers of a packet the device spread over
+ *   several mergeable RX buffers.  Only the first buffer has the virtio
+ *   header, the data of the others starts where the header would be.
+ *
+ ****************************************************************************/
+
+static int virtio_net_merge(FAR struct netdev_lowerhalf_s *dev, int queue,
+                            FAR netpkt_t *pkt, uint16_t num)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(queue)].vq;
+  FAR struct virtio_net_llhdr_s *hdr;
+  FAR netpkt_t *next;
+  uint32_t len;
+
+  while (--num > 0)
+    {
+      hdr = virtqueue_get_buffer_lock(vq, &len, NULL,
+                                      &priv->lock[VIRTIO_NET_RXQ(queue)]);
+      if (hdr == NULL)
+        {
+          vrterr("Missing %u RX buffers of a packet\n", num);
+          return -EIO;
+        }
+
+      next = hdr->pkt;
+      next->io_offset -= IOB_DATA(next) - (FAR uint8_t *)&hdr->vhdr;
+      next->io_len     = len;
+      next->io_pktlen  = len;
+      iob_concat(pkt, next);
+
+      /* The buffer belongs to 'pkt' now, only give its quota back */
+
+      netpkt_qfree(dev, queue, NULL, NETPKT_RX);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: virtio_net_recvq
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(queue)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, queue);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
+  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RXQ(queue)]);
   hdr = virtqueue_get_buffer(vq, &len, NULL);
   if (hdr == NULL)
     {
       /* If we have no buffer left, enable RX callback. */
 
       virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RXQ(queue)], flags);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RXQ(queue)], flags);
     }
 
   /* Set the received pkt length */
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
+  netpkt_setdatalen(dev, hdr->pkt, len - priv->hdrsize);
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  if (priv->hdrsize == VIRTIO_NET_HDRSIZE && hdr->vhdr.num_buffers > 1 &&
+      virtio_net_merge(dev, queue, hdr->pkt, hdr->vhdr.num_buffers) < 0)
+    {
+      netpkt_qfree(dev, queue, hdr->pkt, NETPKT_RX);
+      return virtio_net_recvq(dev, queue);
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* A packet from the host itself may not even carry the checksum */
+
+  if ((hdr->vhdr.flags & (VIRTIO_NET_HDR_F_DATA_VALID |
+                          VIRTIO_NET_HDR_F_NEEDS_CSUM)) != 0)
+    {
+      dev->netdev.d_chksum_flags |= NETDEV_CHKSUM_VERIFIED;
+    }
+#endif
+
   vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recvq(dev, 0);
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -535,8 +763,9 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
-  netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+  netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                             VIRTIO_NET_PAIR(vq->vq_queue_index));
 }
 
 /****************************************************************************
@@ -547,10 +776,109 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
-  netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+  netdev_lower_txdone_queue((FAR struct netdev_lowerhalf_s *)priv,
+                            VIRTIO_NET_PAIR(vq->vq_queue_index));
+}
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/****************************************************************************
+ * Name: virtio_net_ctrldone
+ ****************************************************************************/
+
+static void virtio_net_ctrldone(FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
+
+  if (virtqueue_get_buffer(vq, NULL, NULL) != NULL)
+    {
+      nxsem_post(&priv->ctrlsem);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_max_pairs
+ *
+ * Description:
+ *   Get the number of queue pairs to use: all the pairs of the device if
+ *   it offers several and the control virtqueue that enables them, and no
+ *   more than CONFIG_NETDEV_MAX_QUEUES.  The control virtqueue follows the
+ *   last pair the device has, so a device with more pairs uses only one.
+ *
+ ****************************************************************************/
+
+static int virtio_net_max_pairs(FAR struct virtio_device *vdev)
+{
+  uint16_t pairs;
+
+  if (!virtio_has_feature(vdev, VIRTIO_NET_F_MQ) ||
+      !virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ))
+    {
+      return 1;
+    }
+
+  virtio_read_config_member(vdev, struct virtio_net_config_s,
+                            max_virtqueue_pairs, &pairs);
+  if (pairs > VIRTIO_NET_MAX_PAIRS)
+    {
+      vrtwarn("Device has %u queue pairs, using one\n", pairs);
+      return 1;
+    }
+
+  return pairs > 0 ? pairs : 1;
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_pairs
+ *
+ * Description:
+ *   Ask the device to spread the traffic over priv->npairs queue pairs.
+ *
+ ****************************************************************************/
+
+static int virtio_net_set_pairs(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_NUM * priv->npairs].vq;
+  FAR struct virtio_net_ctrl_mq_s *ctrl;
+  struct virtqueue_buf vb[3];
+  int ret;
+
+  ctrl = virtio_zalloc_buf(priv->vdev, sizeof(*ctrl), 16);
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = priv->npairs;
+  ctrl->ack   = 0xff;
+
+  /* Buffer 0: the command header, buffer 1: the number of pairs,
+   * buffer 2: the ack written by the device.
+   */
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = offsetof(struct virtio_net_ctrl_mq_s, pairs);
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret >= 0)
+    {
+      virtqueue_kick(vq);
+      nxsem_wait_uninterruptible(&priv->ctrlsem);
+      ret = ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+    }
+
+  virtio_free_buf(priv->vdev, ctrl);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -558,28 +886,74 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char *vqnames[VIRTIO_NET_NUM * VIRTIO_NET_MAX_PAIRS + 1];
+  vq_callback callbacks[VIRTIO_NET_NUM * VIRTIO_NET_MAX_PAIRS + 1];
+  int rxdescs;
+  int descs;
+  int nvqs;
   int ret;
+  int i;
+
+  for (i = 0; i < VIRTIO_NET_NUM * VIRTIO_NET_MAX_PAIRS; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
   vdev->priv = priv;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  nxsem_init(&priv->ctrlsem, 0, 0);
+#endif
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+                                  (1UL << VIRTIO_F_ANY_LAYOUT) |
+                                  VIRTIO_RING_F_EVENT_IDX |
+                                  VIRTIO_NET_FEATURES |
+                                  VIRTIO_NET_MQ_FEATURES |
+                                  VIRTIO_NET_MRG_FEATURES, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  priv->hdrsize   = VIRTIO_NET_HDRSIZE;
+  priv->rxbufsize = VIRTIO_NET_BUFSIZE;
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->rxbufsize = VIRTIO_NET_MRG_BUFSIZE;
+    }
+  else
+    {
+      priv->hdrsize -= sizeof(uint16_t);
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  priv->npairs = virtio_net_max_pairs(vdev);
+#else
+  priv->npairs = 1;
+#endif
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      vqnames[VIRTIO_NET_RXQ(i)]   = "virtio_net_rx";
+      vqnames[VIRTIO_NET_TXQ(i)]   = "virtio_net_tx";
+      callbacks[VIRTIO_NET_RXQ(i)] = virtio_net_rxready;
+      callbacks[VIRTIO_NET_TXQ(i)] = virtio_net_txdone;
+    }
+
+  nvqs = VIRTIO_NET_NUM * priv->npairs;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      vqnames[nvqs]   = "virtio_net_ctrl";
+      callbacks[nvqs] = virtio_net_ctrldone;
+      nvqs++;
+    }
+#endif
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -588,19 +962,54 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Only the first pair carries traffic until the others are enabled */
+
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_set_pairs(priv);
+      if (ret < 0)
+        {
+          vrtwarn("Enable %d queue pairs failed, ret=%d\n",
+                  priv->npairs, ret);
+          priv->npairs = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts, shared by the pairs.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4 /
+                 priv->npairs;
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+  /* Mergeable RX buffers take one IOB and two descriptors at most, so
+   * the same share of the IOBs makes more of them.
+   */
+
+  rxdescs = priv->rxbufsize < VIRTIO_NET_BUFSIZE ? 2 :
+                                                   VIRTIO_NET_MAX_NIOB + 1;
+#if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
+  priv->rxbufnum = priv->bufnum;
+#else
+  priv->rxbufnum = rxdescs == 2 ? CONFIG_IOB_NBUFFERS / 4 / priv->npairs :
+                                  priv->bufnum;
+#endif
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      descs = vdev->vrings_info[VIRTIO_NET_TXQ(i)].info.num_descs;
+      priv->bufnum = MIN(descs / (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+      descs = vdev->vrings_info[VIRTIO_NET_RXQ(i)].info.num_descs;
+      priv->rxbufnum = MIN(descs / rxdescs, priv->rxbufnum);
+    }
+
   return OK;
 }
 
@@ -650,6 +1059,9 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   FAR struct netdev_lowerhalf_s *netdev;
   FAR struct virtio_net_priv_s *priv;
   int ret;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int i;
+#endif
 
   priv = kmm_zalloc(sizeof(*priv));
   if (priv == NULL)
@@ -668,10 +1080,31 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->nqueues = priv->npairs;
+  for (i = 0; i < priv->npairs; i++)
+    {
+      netdev->queues[i].quota[NETPKT_RX] = priv->rxbufnum;
+      netdev->queues[i].quota[NETPKT_TX] = priv->bufnum;
+    }
+#else
+  netdev->quota[NETPKT_RX] = priv->rxbufnum;
   netdev->quota[NETPKT_TX] = priv->bufnum;
+#endif
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_FEATURE_TXCSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_FEATURE_RXCSUM;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
@@ -716,6 +1149,9 @@ err_with_virtqueues:
   virtio_reset_device(vdev);
   virtio_delete_virtqueues(vdev);
 err_with_priv:
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  nxsem_destroy(&priv->ctrlsem);
+#endif
   kmm_free(priv);
   return ret;
 }
@@ -734,6 +1170,9 @@ static void virtio_net_remove(FAR struct virtio_device *vdev)
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   g_netdev_num--;
   wifi_sim_remove(&priv->lower);
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  nxsem_destroy(&priv->ctrlsem);
 #endif
   kmm_free(priv);
 }
@@ -33,6 +33,7 @@
 
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 
 #ifdef CONFIG_FS_AIO
 
@@ -64,6 +65,9 @@ struct aio_container_s
   FAR struct aiocb *aioc_aiocbp;   /* The contained AIO control block */
   FAR struct file *aioc_filep;     /* File structure to use with the I/O */
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+  struct fs_aio_s aioc_aio;        /* Native asynchronous transfer */
+  ssize_t aioc_result;             /* Result of the native transfer */
+  bool aioc_native;                /* true: Transfer started by the driver */
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
@@ -220,6 +224,26 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_native
+ *
+ * Description:
+ *   Try to start the transfer with the aio method of the driver or file
+ *   system so that no worker thread is held for its duration.  Only the
+ *   completion bookkeeping runs on the low priority work queue.
+ *
+ * Input Parameters:
+ *   aioc  - The AIO container of the transfer
+ *   write - true: aio_write(); false: aio_read()
+ *
+ * Returned Value:
+ *   Zero (OK) if the transfer was started.  A negated errno value if the
+ *   file does not support it; the caller must then use aio_queue().
+ *
+ ****************************************************************************/
+
+int aio_native(FAR struct aio_container_s *aioc, bool write);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -42,6 +42,57 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_native_worker
+ *
+ * Description:
+ *   Report the result of a native transfer to the client.
+ *
+ ****************************************************************************/
+
+static void aio_native_worker(FAR void *arg)
+{
+  FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
+  FAR struct aiocb *aiocbp;
+  ssize_t result;
+  pid_t pid;
+
+  pid    = aioc->aioc_pid;
+  result = aioc->aioc_result;
+  aiocbp = aioc_decant(aioc);
+
+#ifdef CONFIG_DEBUG_FS_ERROR
+  if (result < 0)
+    {
+      ferr("ERROR: transfer failed: %d\n", (int)result);
+    }
+#endif
+
+  aiocbp->aio_result = result;
+  aio_signal(pid, aiocbp);
+}
+
+/****************************************************************************
+ * Name: aio_native_complete
+ *
+ * Description:
+ *   Completion callback of a native transfer.  This may run at interrupt
+ *   level, so the rest of the work is deferred.
+ *
+ ****************************************************************************/
+
+static void aio_native_complete(FAR struct fs_aio_s *aio, ssize_t result)
+{
+  FAR struct aio_container_s *aioc = aio->priv;
+
+  aioc->aioc_result = result;
+  work_queue(LPWORK, &aioc->aioc_work, aio_native_worker, aioc, 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
@@ -98,4 +149,50 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
+/****************************************************************************
+ * Name: aio_native
+ *
+ * Description:
+ *   Try to start the transfer with the aio method of the driver or file
+ *   system so that no worker thread is held for its duration.  Only the
+ *   completion bookkeeping runs on the low priority work queue.
+ *
+ * Input Parameters:
+ *   aioc  - The AIO container of the transfer
+ *   write - true: aio_write(); false: aio_read()
+ *
+ * Returned Value:
+ *   Zero (OK) if the transfer was started.  A negated errno value if the
+ *   file does not support it; the caller must then use aio_queue().
+ *
+ ****************************************************************************/
+
+int aio_native(FAR struct aio_container_s *aioc, bool write)
+{
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  FAR struct fs_aio_s *aio = &aioc->aioc_aio;
+  int ret;
+
+  aio->buf      = (FAR void *)aiocbp->aio_buf;
+  aio->nbytes   = aiocbp->aio_nbytes;
+  aio->offset   = aiocbp->aio_offset;
+  aio->write    = write;
+  aio->complete = aio_native_complete;
+  aio->priv     = aioc;
+
+  /* Mark the container first, the transfer may complete before
+   * file_aio() returns.  aio_cancel() cannot stop a transfer owned by the
+   * driver.
+   */
+
+  aioc->aioc_native = true;
+  ret = file_aio(aioc->aioc_filep, aio);
+  if (ret < 0)
+    {
+      aioc->aioc_native = false;
+    }
+
+  return ret;
+}
+
 #endif /* CONFIG_FS_AIO */
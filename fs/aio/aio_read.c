@@ -268,7 +268,14 @@ int aio_read(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
-  /* Defer the work to the worker thread */
+  /* Let the driver start the transfer if it can.  Otherwise defer the
+   * work to the worker thread.
+   */
+
+  if (aio_native(aioc, false) >= 0)
+    {
+      return OK;
+    }
 
   ret = aio_queue(aioc, aio_read_worker);
   if (ret < 0)
@@ -305,7 +305,14 @@ int aio_write(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
-  /* Defer the work to the worker thread */
+  /* Let the driver start the transfer if it can.  Appending writes need
+   * the file position, so they always go to the worker thread.
+   */
+
+  if ((flags & O_APPEND) == 0 && aio_native(aioc, true) >= 0)
+    {
+      return OK;
+    }
 
   ret = aio_queue(aioc, aio_write_worker);
   if (ret < 0)
@@ -0,0 +1,830 @@
+/****************************************************************************
+ * fs/driver/fs_blkqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/blkqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_BLKQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLKQUEUE_DEPTH   CONFIG_FS_BLKQUEUE_DEPTH
+
+/* Finished aio() transfers are reaped on the high priority work queue.
+ * This is short, it copies merged reads out and starts the next transfers.
+ * The synchronous transfers of drivers without aio() block, so they
+ * belong on the low priority work queue.
+ */
+
+#define BLKQUEUE_DONEWORK HPWORK
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define BLKQUEUE_IOWORK LPWORK
+#else
+#  define BLKQUEUE_IOWORK HPWORK
+#endif
+
+#define BLKQUEUE_REQ(n)  list_container_of(n, struct blkqueue_req_s, node)
+#define BLKQUEUE_END(r)  ((blkcnt_t)(r)->aio.offset + (r)->aio.nbytes)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One transfer to the driver, made of one or more adjacent requests */
+
+struct blkqueue_slot_s
+{
+  struct fs_aio_s        aio;    /* The transfer handed to the driver */
+  FAR struct blkqueue_s *queue;  /* The queue owning this slot */
+  struct list_node       reqs;   /* The requests, in sector order */
+  struct list_node       done;   /* In the list of finished transfers */
+  FAR unsigned char     *bounce; /* Merge buffer, allocated on first use */
+  ssize_t                result; /* Result reported by the driver */
+  bool                   copy;   /* The transfer uses the merge buffer */
+  bool                   busy;   /* The transfer is in progress */
+};
+
+struct blkqueue_s
+{
+  struct list_node       node;        /* In g_blkqueues */
+  FAR struct inode      *inode;       /* The block driver */
+  rmutex_t               lock;        /* Protects everything but done */
+  spinlock_t             spinlock;    /* Protects done */
+  int                    crefs;       /* Users of the queue */
+  int                    plugged;     /* Plug nesting count */
+  uint32_t               sectsize;    /* Sector size of the driver */
+  unsigned int           maxsectors;  /* Largest merged transfer */
+  unsigned int           starved;     /* Read batches while writes wait */
+  blkcnt_t               head;        /* Sector after the last dispatch */
+  struct list_node       sorted[2];   /* Pending reads/writes by sector */
+  struct list_node       fifo[2];     /* Pending reads/writes by arrival */
+  struct list_node       done;        /* Finished aio() transfers */
+  struct work_s          donework;    /* Reaps finished aio() transfers */
+  struct work_s          iowork;      /* Runs synchronous transfers */
+  struct blkqueue_slot_s slot[BLKQUEUE_DEPTH];
+};
+
+/* State of blkqueue_read() and blkqueue_write() */
+
+struct blkqueue_sync_s
+{
+  struct blkqueue_req_s req;
+  sem_t                 sem;
+  ssize_t               result;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void blkqueue_doneworker(FAR void *arg);
+static void blkqueue_ioworker(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct list_node g_blkqueues = LIST_INITIAL_VALUE(g_blkqueues);
+static mutex_t g_blkqueue_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkqueue_insert
+ *
+ * Description:
+ *   Add a request to the sector ordered list and to the arrival ordered
+ *   list of its direction.
+ *
+ ****************************************************************************/
+
+static void blkqueue_insert(FAR struct blkqueue_s *queue,
+                            FAR struct blkqueue_req_s *req)
+{
+  FAR struct list_node *list = &queue->sorted[req->aio.write];
+  FAR struct blkqueue_req_s *pos;
+
+  /* Most requests arrive in ascending order, search from the tail */
+
+  list_for_every_entry_reverse(list, pos, struct blkqueue_req_s, node)
+    {
+      if (pos->aio.offset <= req->aio.offset)
+        {
+          break;
+        }
+    }
+
+  list_add_after(&pos->node, &req->node);
+  list_add_tail(&queue->fifo[req->aio.write], &req->fifo);
+
+  req->deadline = clock_systime_ticks() +
+                  MSEC2TICK(req->aio.write ?
+                            CONFIG_FS_BLKQUEUE_WRITE_EXPIRE :
+                            CONFIG_FS_BLKQUEUE_READ_EXPIRE);
+}
+
+/****************************************************************************
+ * Name: blkqueue_expired
+ ****************************************************************************/
+
+static bool blkqueue_expired(FAR struct blkqueue_s *queue, bool write)
+{
+  FAR struct blkqueue_req_s *req;
+
+  req = list_peek_head_type(&queue->fifo[write], struct blkqueue_req_s,
+                            fifo);
+  return req != NULL && clock_compare(req->deadline, clock_systime_ticks());
+}
+
+/****************************************************************************
+ * Name: blkqueue_pick
+ *
+ * Description:
+ *   Select the first request of the next transfer.  Reads are served
+ *   before writes, but only CONFIG_FS_BLKQUEUE_WRITES_STARVED times in a
+ *   row while writes are waiting, and never while the oldest write has
+ *   expired but the oldest read has not.  In the chosen direction the
+ *   oldest request is taken if it has expired, otherwise the elevator
+ *   continues upwards from the last transfer.
+ *
+ ****************************************************************************/
+
+static FAR struct blkqueue_req_s *
+blkqueue_pick(FAR struct blkqueue_s *queue)
+{
+  FAR struct blkqueue_req_s *req;
+  bool reads = !list_is_empty(&queue->sorted[false]);
+  bool writes = !list_is_empty(&queue->sorted[true]);
+  bool write;
+
+  if (!reads && !writes)
+    {
+      return NULL;
+    }
+
+  if (reads && (!writes ||
+      (queue->starved < CONFIG_FS_BLKQUEUE_WRITES_STARVED &&
+       (!blkqueue_expired(queue, true) || blkqueue_expired(queue, false)))))
+    {
+      write = false;
+      if (writes)
+        {
+          queue->starved++;
+        }
+    }
+  else
+    {
+      write = true;
+      queue->starved = 0;
+    }
+
+  if (blkqueue_expired(queue, write))
+    {
+      return list_first_entry(&queue->fifo[write], struct blkqueue_req_s,
+                              fifo);
+    }
+
+  list_for_every_entry(&queue->sorted[write], req, struct blkqueue_req_s,
+                       node)
+    {
+      if (req->aio.offset >= queue->head)
+        {
+          return req;
+        }
+    }
+
+  return list_first_entry(&queue->sorted[write], struct blkqueue_req_s,
+                          node);
+}
+
+/****************************************************************************
+ * Name: blkqueue_batch
+ *
+ * Description:
+ *   Move a request, and the following requests adjacent to it, from the
+ *   pending lists into a transfer slot.  The requests are transferred in
+ *   place if their buffers are contiguous too, otherwise through the merge
+ *   buffer of the slot.
+ *
+ ****************************************************************************/
+
+static void blkqueue_batch(FAR struct blkqueue_s *queue,
+                           FAR struct blkqueue_slot_s *slot,
+                           FAR struct blkqueue_req_s *first)
+{
+  FAR struct list_node *list = &queue->sorted[first->aio.write];
+  FAR struct blkqueue_req_s *req = first;
+  FAR struct blkqueue_req_s *next;
+  FAR unsigned char *end;
+  size_t nsectors = first->aio.nbytes;
+
+  list_initialize(&slot->reqs);
+  slot->copy = false;
+
+  for (; ; )
+    {
+      end  = (FAR unsigned char *)req->aio.buf +
+             req->aio.nbytes * queue->sectsize;
+      next = list_next_type(list, &req->node, struct blkqueue_req_s, node);
+
+      list_delete(&req->node);
+      list_delete(&req->fifo);
+      list_add_tail(&slot->reqs, &req->node);
+
+      if (next == NULL || next->aio.offset != BLKQUEUE_END(req) ||
+          nsectors + next->aio.nbytes > queue->maxsectors)
+        {
+          break;
+        }
+
+      if (!slot->copy && next->aio.buf != end)
+        {
+          if (slot->bounce == NULL)
+            {
+              slot->bounce = fs_heap_malloc(queue->maxsectors *
+                                            queue->sectsize);
+              if (slot->bounce == NULL)
+                {
+                  break;
+                }
+            }
+
+          slot->copy = true;
+        }
+
+      nsectors += next->aio.nbytes;
+      req = next;
+    }
+
+  slot->aio.buf      = slot->copy ? slot->bounce : first->aio.buf;
+  slot->aio.nbytes   = nsectors;
+  slot->aio.offset   = first->aio.offset;
+  slot->aio.write    = first->aio.write;
+  slot->busy         = true;
+  queue->head        = first->aio.offset + nsectors;
+
+  if (slot->copy && slot->aio.write)
+    {
+      list_for_every_entry(&slot->reqs, req, struct blkqueue_req_s, node)
+        {
+          memcpy(slot->bounce + (req->aio.offset - first->aio.offset) *
+                 queue->sectsize, req->aio.buf,
+                 req->aio.nbytes * queue->sectsize);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: blkqueue_finish
+ *
+ * Description:
+ *   Complete the requests of a finished transfer and free its slot.
+ *
+ ****************************************************************************/
+
+static void blkqueue_finish(FAR struct blkqueue_s *queue,
+                            FAR struct blkqueue_slot_s *slot,
+                            ssize_t result)
+{
+  FAR struct blkqueue_req_s *req;
+  FAR struct blkqueue_req_s *tmp;
+  struct list_node reqs;
+  blkcnt_t start = slot->aio.offset;
+  ssize_t nsectors;
+
+  /* Copy merged reads out, then release the slot before any completion:
+   * a completion may submit a new request, which reuses the slot.
+   */
+
+  list_initialize(&reqs);
+  list_for_every_entry_safe(&slot->reqs, req, tmp, struct blkqueue_req_s,
+                            node)
+    {
+      if (result > 0 && slot->copy && !slot->aio.write)
+        {
+          nsectors = result - (req->aio.offset - start);
+          nsectors = MIN(MAX(nsectors, 0), (ssize_t)req->aio.nbytes);
+          memcpy(req->aio.buf, slot->bounce +
+                 (req->aio.offset - start) * queue->sectsize,
+                 nsectors * queue->sectsize);
+        }
+
+      list_delete(&req->node);
+      list_add_tail(&reqs, &req->node);
+    }
+
+  slot->busy = false;
+
+  /* Each request gets its share of the sectors transferred, or the
+   * error.
+   */
+
+  list_for_every_entry_safe(&reqs, req, tmp, struct blkqueue_req_s, node)
+    {
+      list_delete(&req->node);
+
+      if (result < 0)
+        {
+          nsectors = result;
+        }
+      else
+        {
+          nsectors = result - (req->aio.offset - start);
+          nsectors = MIN(MAX(nsectors, 0), (ssize_t)req->aio.nbytes);
+        }
+
+      req->aio.complete(&req->aio, nsectors);
+    }
+}
+
+/****************************************************************************
+ * Name: blkqueue_done
+ *
+ * Description:
+ *   Completion of an aio() transfer, possibly at interrupt level
+ *
+ ****************************************************************************/
+
+static void blkqueue_done(FAR struct fs_aio_s *aio, ssize_t result)
+{
+  FAR struct blkqueue_slot_s *slot = aio->priv;
+  FAR struct blkqueue_s *queue = slot->queue;
+  irqstate_t flags;
+
+  slot->result = result;
+
+  flags = spin_lock_irqsave(&queue->spinlock);
+  list_add_tail(&queue->done, &slot->done);
+  spin_unlock_irqrestore(&queue->spinlock, flags);
+
+  work_queue(BLKQUEUE_DONEWORK, &queue->donework, blkqueue_doneworker,
+             queue, 0);
+}
+
+/****************************************************************************
+ * Name: blkqueue_dispatch
+ *
+ * Description:
+ *   Start aio() transfers until the driver queue is full or no requests
+ *   are left.
+ *
+ ****************************************************************************/
+
+static void blkqueue_dispatch(FAR struct blkqueue_s *queue)
+{
+  FAR struct inode *inode = queue->inode;
+  FAR struct blkqueue_slot_s *slot;
+  FAR struct blkqueue_req_s *req;
+  int ret;
+  int i;
+
+  for (i = 0; i < BLKQUEUE_DEPTH && queue->plugged == 0; i++)
+    {
+      slot = &queue->slot[i];
+      if (slot->busy)
+        {
+          continue;
+        }
+
+      req = blkqueue_pick(queue);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      blkqueue_batch(queue, slot, req);
+
+      ret = inode->u.i_bops->aio(inode, &slot->aio);
+      if (ret < 0)
+        {
+          ferr("ERROR: Transfer of sector %" PRIdOFF " failed: %d\n",
+               slot->aio.offset, ret);
+          blkqueue_finish(queue, slot, ret);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: blkqueue_run
+ *
+ * Description:
+ *   Perform the transfers of a driver without aio() in the calling thread,
+ *   one after the other, until no requests are left.  The queue is
+ *   unlocked during each transfer so that new requests can be merged in
+ *   the meantime.  Returns at once if another thread is already running
+ *   the queue.
+ *
+ ****************************************************************************/
+
+static void blkqueue_run(FAR struct blkqueue_s *queue)
+{
+  FAR struct inode *inode = queue->inode;
+  FAR struct blkqueue_slot_s *slot = &queue->slot[0];
+  FAR struct blkqueue_req_s *req;
+  ssize_t ret;
+
+  while (queue->plugged == 0 && !slot->busy &&
+         (req = blkqueue_pick(queue)) != NULL)
+    {
+      blkqueue_batch(queue, slot, req);
+      nxrmutex_unlock(&queue->lock);
+
+      if (slot->aio.write)
+        {
+          ret = inode->u.i_bops->write(inode, slot->aio.buf,
+                                       slot->aio.offset, slot->aio.nbytes);
+        }
+      else
+        {
+          ret = inode->u.i_bops->read(inode, slot->aio.buf,
+                                      slot->aio.offset, slot->aio.nbytes);
+        }
+
+      nxrmutex_lock(&queue->lock);
+      blkqueue_finish(queue, slot, ret);
+    }
+}
+
+/****************************************************************************
+ * Name: blkqueue_kick
+ ****************************************************************************/
+
+static void blkqueue_kick(FAR struct blkqueue_s *queue)
+{
+  if (queue->plugged > 0)
+    {
+      return;
+    }
+
+  if (queue->inode->u.i_bops->aio != NULL)
+    {
+      blkqueue_dispatch(queue);
+    }
+  else if (!queue->slot[0].busy && work_available(&queue->iowork))
+    {
+      work_queue(BLKQUEUE_IOWORK, &queue->iowork, blkqueue_ioworker,
+                 queue, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: blkqueue_doneworker
+ ****************************************************************************/
+
+static void blkqueue_doneworker(FAR void *arg)
+{
+  FAR struct blkqueue_s *queue = arg;
+  FAR struct blkqueue_slot_s *slot;
+  FAR struct list_node *node;
+  irqstate_t flags;
+
+  nxrmutex_lock(&queue->lock);
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&queue->spinlock);
+      node = list_remove_head(&queue->done);
+      spin_unlock_irqrestore(&queue->spinlock, flags);
+
+      if (node == NULL)
+        {
+          break;
+        }
+
+      slot = list_container_of(node, struct blkqueue_slot_s, done);
+      blkqueue_finish(queue, slot, slot->result);
+    }
+
+  blkqueue_kick(queue);
+  nxrmutex_unlock(&queue->lock);
+}
+
+/****************************************************************************
+ * Name: blkqueue_ioworker
+ ****************************************************************************/
+
+static void blkqueue_ioworker(FAR void *arg)
+{
+  FAR struct blkqueue_s *queue = arg;
+
+  nxrmutex_lock(&queue->lock);
+  blkqueue_run(queue);
+  nxrmutex_unlock(&queue->lock);
+}
+
+/****************************************************************************
+ * Name: blkqueue_wakeup
+ ****************************************************************************/
+
+static void blkqueue_wakeup(FAR struct fs_aio_s *aio, ssize_t result)
+{
+  FAR struct blkqueue_sync_s *sync = aio->priv;
+
+  sync->result = result;
+  nxsem_post(&sync->sem);
+}
+
+/****************************************************************************
+ * Name: blkqueue_transfer
+ ****************************************************************************/
+
+static ssize_t blkqueue_transfer(FAR struct blkqueue_s *queue,
+                                 FAR unsigned char *buffer, blkcnt_t start,
+                                 unsigned int nsectors, bool write)
+{
+  struct blkqueue_sync_s sync;
+  int ret;
+
+  nxsem_init(&sync.sem, 0, 0);
+
+  sync.req.aio.buf      = buffer;
+  sync.req.aio.nbytes   = nsectors;
+  sync.req.aio.offset   = start;
+  sync.req.aio.write    = write;
+  sync.req.aio.complete = blkqueue_wakeup;
+  sync.req.aio.priv     = &sync;
+
+  /* Unplugging runs the queue in this thread if the driver has no aio() */
+
+  blkqueue_plug(queue);
+  ret = blkqueue_submit(queue, &sync.req);
+  blkqueue_unplug(queue);
+
+  if (ret >= 0)
+    {
+      nxsem_wait_uninterruptible(&sync.sem);
+      ret = sync.result;
+    }
+
+  nxsem_destroy(&sync.sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkqueue_open
+ ****************************************************************************/
+
+int blkqueue_open(FAR struct inode *inode, FAR struct blkqueue_s **queue)
+{
+  FAR struct blkqueue_s *q;
+  struct geometry geo;
+  int ret;
+  int i;
+
+  DEBUGASSERT(inode != NULL && queue != NULL);
+
+  if (!INODE_IS_BLOCK(inode) || inode->u.i_bops->geometry == NULL ||
+      inode->u.i_bops->read == NULL || inode->u.i_bops->write == NULL)
+    {
+      return -ENOTBLK;
+    }
+
+  ret = nxmutex_lock(&g_blkqueue_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  list_for_every_entry(&g_blkqueues, q, struct blkqueue_s, node)
+    {
+      if (q->inode == inode)
+        {
+          q->crefs++;
+          goto out;
+        }
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!geo.geo_available || geo.geo_sectorsize == 0)
+    {
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  q = fs_heap_zalloc(sizeof(struct blkqueue_s));
+  if (q == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  q->inode      = inode;
+  q->crefs      = 1;
+  q->sectsize   = geo.geo_sectorsize;
+  q->maxsectors = MAX(CONFIG_FS_BLKQUEUE_MERGE_SIZE / geo.geo_sectorsize,
+                      1);
+
+  nxrmutex_init(&q->lock);
+  spin_lock_init(&q->spinlock);
+
+  for (i = 0; i < 2; i++)
+    {
+      list_initialize(&q->sorted[i]);
+      list_initialize(&q->fifo[i]);
+    }
+
+  list_initialize(&q->done);
+
+  for (i = 0; i < BLKQUEUE_DEPTH; i++)
+    {
+      q->slot[i].queue        = q;
+      q->slot[i].aio.complete = blkqueue_done;
+      q->slot[i].aio.priv     = &q->slot[i];
+    }
+
+  list_add_tail(&g_blkqueues, &q->node);
+
+out:
+  *queue = q;
+  ret = OK;
+
+errout:
+  nxmutex_unlock(&g_blkqueue_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkqueue_close
+ ****************************************************************************/
+
+void blkqueue_close(FAR struct blkqueue_s *queue)
+{
+  int i;
+
+  nxmutex_lock(&g_blkqueue_lock);
+  if (--queue->crefs > 0)
+    {
+      nxmutex_unlock(&g_blkqueue_lock);
+      return;
+    }
+
+  list_delete(&queue->node);
+  nxmutex_unlock(&g_blkqueue_lock);
+
+  /* Wait for a thread still running the queue to let go of it */
+
+  nxrmutex_lock(&queue->lock);
+  DEBUGASSERT(list_is_empty(&queue->sorted[false]) &&
+              list_is_empty(&queue->sorted[true]));
+  nxrmutex_unlock(&queue->lock);
+
+  work_cancel_sync(BLKQUEUE_DONEWORK, &queue->donework);
+  work_cancel_sync(BLKQUEUE_IOWORK, &queue->iowork);
+
+  for (i = 0; i < BLKQUEUE_DEPTH; i++)
+    {
+      DEBUGASSERT(!queue->slot[i].busy);
+      if (queue->slot[i].bounce != NULL)
+        {
+          fs_heap_free(queue->slot[i].bounce);
+        }
+    }
+
+  nxrmutex_destroy(&queue->lock);
+  fs_heap_free(queue);
+}
+
+/****************************************************************************
+ * Name: blkqueue_submit
+ ****************************************************************************/
+
+int blkqueue_submit(FAR struct blkqueue_s *queue,
+                    FAR struct blkqueue_req_s *req)
+{
+  int ret;
+
+  DEBUGASSERT(queue != NULL && req != NULL && req->aio.complete != NULL);
+
+  if (req->aio.nbytes == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxrmutex_lock(&queue->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  blkqueue_insert(queue, req);
+  blkqueue_kick(queue);
+  nxrmutex_unlock(&queue->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkqueue_plug
+ ****************************************************************************/
+
+void blkqueue_plug(FAR struct blkqueue_s *queue)
+{
+  nxrmutex_lock(&queue->lock);
+  queue->plugged++;
+  nxrmutex_unlock(&queue->lock);
+}
+
+/****************************************************************************
+ * Name: blkqueue_unplug
+ ****************************************************************************/
+
+void blkqueue_unplug(FAR struct blkqueue_s *queue)
+{
+  nxrmutex_lock(&queue->lock);
+  DEBUGASSERT(queue->plugged > 0);
+
+  if (--queue->plugged == 0)
+    {
+      if (queue->inode->u.i_bops->aio != NULL)
+        {
+          blkqueue_dispatch(queue);
+        }
+      else
+        {
+          blkqueue_run(queue);
+        }
+    }
+
+  nxrmutex_unlock(&queue->lock);
+}
+
+/****************************************************************************
+ * Name: blkqueue_read
+ ****************************************************************************/
+
+ssize_t blkqueue_read(FAR struct blkqueue_s *queue,
+                      FAR unsigned char *buffer, blkcnt_t start,
+                      unsigned int nsectors)
+{
+  return blkqueue_transfer(queue, buffer, start, nsectors, false);
+}
+
+/****************************************************************************
+ * Name: blkqueue_write
+ ****************************************************************************/
+
+ssize_t blkqueue_write(FAR struct blkqueue_s *queue,
+                       FAR const unsigned char *buffer, blkcnt_t start,
+                       unsigned int nsectors)
+{
+  return blkqueue_transfer(queue, (FAR unsigned char *)buffer, start,
+                           nsectors, true);
+}
+
+#endif /* CONFIG_FS_BLKQUEUE */
@@ -0,0 +1,905 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/blkqueue.h>
+#include <nuttx/fs/blockcache.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLOCKCACHE_PAGESIZE    CONFIG_FS_BLOCKCACHE_PAGESIZE
+#define BLOCKCACHE_NPAGES      CONFIG_FS_BLOCKCACHE_NPAGES
+#define BLOCKCACHE_NBUCKETS    32
+
+/* At most a quarter of the pages, those touched only once, live in the
+ * probation queue.  A page that is hit again moves to the protected queue.
+ */
+
+#define BLOCKCACHE_NPROBATION  ((BLOCKCACHE_NPAGES + 3) / 4)
+#define BLOCKCACHE_NPROTECTED  (BLOCKCACHE_NPAGES - BLOCKCACHE_NPROBATION)
+
+#define BLOCKCACHE_PROBATION   0
+#define BLOCKCACHE_PROTECTED   1
+
+#define BLOCKCACHE_FIRST(p)    ((blkcnt_t)(p)->index * (p)->spp)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct blockcache_page_s
+{
+  dq_entry_t                    node;   /* Link in a queue, newest first */
+  FAR struct blockcache_page_s *hnext;  /* Link in a hash bucket */
+  FAR struct inode             *inode;  /* Block driver of the page */
+  blkcnt_t                      index;  /* First sector / spp */
+  uint16_t                      spp;    /* Sectors in a full page */
+  uint16_t                      nvalid; /* Sectors read from the driver */
+  uint8_t                       queue;  /* BLOCKCACHE_PROBATION/PROTECTED */
+  bool                          dirty;  /* Newer than the driver */
+#ifdef CONFIG_FS_BLKQUEUE
+  struct blkqueue_req_s         req;    /* Queued write back */
+  FAR struct blkqueue_s        *blkq;   /* Queue of a queued write back */
+  ssize_t                       result; /* Result of a queued write back */
+#endif
+  uint8_t                       data[1];
+};
+
+struct blockcache_s
+{
+  mutex_t                       lock;
+  size_t                        npages;
+  size_t                        count[2];
+  dq_queue_t                    queue[2];
+  FAR struct blockcache_page_s *hash[BLOCKCACHE_NBUCKETS];
+  struct blockcache_stats_s     stats;
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  struct work_s                 work;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct blockcache_s g_blockcache =
+{
+  NXMUTEX_INITIALIZER
+};
+
+#ifdef CONFIG_FS_BLKQUEUE
+/* Posted once for every queued write back that completes */
+
+static sem_t g_blockcache_wbsem = SEM_INITIALIZER(0);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_hash
+ ****************************************************************************/
+
+static inline unsigned int blockcache_hash(FAR struct inode *inode,
+                                           blkcnt_t index)
+{
+  uintptr_t key = ((uintptr_t)inode >> 4) ^ (uintptr_t)index;
+
+  key ^= key >> 5;
+  return key & (BLOCKCACHE_NBUCKETS - 1);
+}
+
+/****************************************************************************
+ * Name: blockcache_find
+ ****************************************************************************/
+
+static FAR struct blockcache_page_s *
+blockcache_find(FAR struct inode *inode, blkcnt_t index, uint16_t spp)
+{
+  FAR struct blockcache_page_s *page;
+
+  page = g_blockcache.hash[blockcache_hash(inode, index)];
+  while (page != NULL)
+    {
+      if (page->inode == inode && page->index == index && page->spp == spp)
+        {
+          return page;
+        }
+
+      page = page->hnext;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: blockcache_insert
+ ****************************************************************************/
+
+static void blockcache_insert(FAR struct blockcache_page_s *page,
+                              FAR struct inode *inode, blkcnt_t index,
+                              uint16_t spp, uint16_t nvalid)
+{
+  unsigned int bucket = blockcache_hash(inode, index);
+
+  page->inode  = inode;
+  page->index  = index;
+  page->spp    = spp;
+  page->nvalid = nvalid;
+  page->dirty  = false;
+  page->queue  = BLOCKCACHE_PROBATION;
+
+  page->hnext  = g_blockcache.hash[bucket];
+  g_blockcache.hash[bucket] = page;
+
+  dq_addfirst(&page->node, &g_blockcache.queue[BLOCKCACHE_PROBATION]);
+  g_blockcache.count[BLOCKCACHE_PROBATION]++;
+}
+
+/****************************************************************************
+ * Name: blockcache_remove
+ *
+ * Description:
+ *   Remove a page from its queue and from the hash table.
+ *
+ ****************************************************************************/
+
+static void blockcache_remove(FAR struct blockcache_page_s *page)
+{
+  FAR struct blockcache_page_s **pprev;
+
+  pprev = &g_blockcache.hash[blockcache_hash(page->inode, page->index)];
+  while (*pprev != page)
+    {
+      pprev = &(*pprev)->hnext;
+    }
+
+  *pprev = page->hnext;
+
+  dq_rem(&page->node, &g_blockcache.queue[page->queue]);
+  g_blockcache.count[page->queue]--;
+}
+
+/****************************************************************************
+ * Name: blockcache_touch
+ *
+ * Description:
+ *   Record a hit on a page.
+ *
+ ****************************************************************************/
+
+static void blockcache_touch(FAR struct blockcache_page_s *page)
+{
+  FAR struct blockcache_page_s *demote;
+
+  dq_rem(&page->node, &g_blockcache.queue[page->queue]);
+  g_blockcache.count[page->queue]--;
+
+  page->queue = BLOCKCACHE_PROTECTED;
+  dq_addfirst(&page->node, &g_blockcache.queue[BLOCKCACHE_PROTECTED]);
+  g_blockcache.count[BLOCKCACHE_PROTECTED]++;
+
+  /* Keep the protected queue within its share of the cache by giving its
+   * oldest page one more chance in the probation queue.
+   */
+
+  if (g_blockcache.count[BLOCKCACHE_PROTECTED] > BLOCKCACHE_NPROTECTED)
+    {
+      demote = (FAR struct blockcache_page_s *)
+        dq_tail(&g_blockcache.queue[BLOCKCACHE_PROTECTED]);
+
+      dq_rem(&demote->node, &g_blockcache.queue[BLOCKCACHE_PROTECTED]);
+      g_blockcache.count[BLOCKCACHE_PROTECTED]--;
+
+      demote->queue = BLOCKCACHE_PROBATION;
+      dq_addfirst(&demote->node, &g_blockcache.queue[BLOCKCACHE_PROBATION]);
+      g_blockcache.count[BLOCKCACHE_PROBATION]++;
+    }
+}
+
+/****************************************************************************
+ * Name: blockcache_writepage
+ ****************************************************************************/
+
+static int blockcache_writepage(FAR struct blockcache_page_s *page)
+{
+  FAR struct inode *inode = page->inode;
+  ssize_t ret;
+
+  ret = inode->u.i_bops->write(inode, page->data, BLOCKCACHE_FIRST(page),
+                               page->nvalid);
+  if (ret < 0)
+    {
+      ferr("ERROR: Write back of sector %" PRIdOFF " failed: %zd\n",
+           (off_t)BLOCKCACHE_FIRST(page), ret);
+      return ret;
+    }
+  else if (ret != page->nvalid)
+    {
+      return -EIO;
+    }
+
+  page->dirty = false;
+  g_blockcache.stats.writebacks++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_alloc
+ *
+ * Description:
+ *   Get a free page, either a new one or the least valuable cached page.
+ *   The page is not in any queue on return.
+ *
+ ****************************************************************************/
+
+static FAR struct blockcache_page_s *blockcache_alloc(void)
+{
+  FAR struct blockcache_page_s *page = NULL;
+  int queue;
+
+  if (g_blockcache.npages < BLOCKCACHE_NPAGES)
+    {
+      page = fs_heap_malloc(sizeof(struct blockcache_page_s) +
+                            BLOCKCACHE_PAGESIZE - 1);
+      if (page != NULL)
+        {
+#ifdef CONFIG_FS_BLKQUEUE
+          page->blkq = NULL;
+#endif
+          g_blockcache.npages++;
+          return page;
+        }
+    }
+
+  /* The cache is full or the heap is short of memory:  reuse the oldest
+   * page of the probation queue, unless it is empty.
+   */
+
+  queue = g_blockcache.count[BLOCKCACHE_PROBATION] > 0 ?
+          BLOCKCACHE_PROBATION : BLOCKCACHE_PROTECTED;
+
+  page = (FAR struct blockcache_page_s *)
+    dq_tail(&g_blockcache.queue[queue]);
+  if (page == NULL)
+    {
+      return NULL;
+    }
+
+  if (page->dirty && blockcache_writepage(page) < 0)
+    {
+      return NULL;
+    }
+
+  blockcache_remove(page);
+  return page;
+}
+
+/****************************************************************************
+ * Name: blockcache_release
+ ****************************************************************************/
+
+static void blockcache_release(FAR struct blockcache_page_s *page)
+{
+  fs_heap_free(page);
+  g_blockcache.npages--;
+}
+
+/****************************************************************************
+ * Name: blockcache_fill
+ *
+ * Description:
+ *   Read a page from the block driver into the cache.
+ *
+ ****************************************************************************/
+
+static FAR struct blockcache_page_s *
+blockcache_fill(FAR struct inode *inode, blkcnt_t index, uint16_t spp)
+{
+  FAR struct blockcache_page_s *page;
+  ssize_t ret;
+
+  page = blockcache_alloc();
+  if (page == NULL)
+    {
+      return NULL;
+    }
+
+  ret = inode->u.i_bops->read(inode, page->data, index * spp, spp);
+  if (ret <= 0)
+    {
+      /* Probably a partial page at the end of the media: let the caller
+       * read just the sectors it wants.
+       */
+
+      blockcache_release(page);
+      return NULL;
+    }
+
+  g_blockcache.stats.drvsectors += ret;
+  blockcache_insert(page, inode, index, spp, ret);
+  return page;
+}
+
+/****************************************************************************
+ * Name: blockcache_update
+ *
+ * Description:
+ *   Copy data just transferred to or from the driver into or out of the
+ *   cached pages that overlap it.  On a write the pages are brought up to
+ *   date; on a read the newer contents of the dirty pages are copied over
+ *   the data from the driver.
+ *
+ ****************************************************************************/
+
+static void blockcache_update(FAR struct inode *inode,
+                              FAR unsigned char *buffer, blkcnt_t start,
+                              size_t nsectors, size_t sectorsize,
+                              uint16_t spp, bool write)
+{
+  FAR struct blockcache_page_s *page;
+  blkcnt_t sector;
+  blkcnt_t first;
+  blkcnt_t last;
+  blkcnt_t index;
+
+  for (index = start / spp; index <= (start + nsectors - 1) / spp; index++)
+    {
+      page = blockcache_find(inode, index, spp);
+      if (page == NULL || (!write && !page->dirty))
+        {
+          continue;
+        }
+
+      first = MAX(start, BLOCKCACHE_FIRST(page));
+      last  = MIN(start + nsectors, BLOCKCACHE_FIRST(page) + page->nvalid);
+
+      for (sector = first; sector < last; sector++)
+        {
+          FAR uint8_t *cached = page->data +
+            (sector - BLOCKCACHE_FIRST(page)) * sectorsize;
+          FAR uint8_t *user = buffer + (sector - start) * sectorsize;
+
+          if (write)
+            {
+              memcpy(cached, user, sectorsize);
+            }
+          else
+            {
+              memcpy(user, cached, sectorsize);
+            }
+        }
+    }
+}
+
+#ifdef CONFIG_FS_BLKQUEUE
+
+/****************************************************************************
+ * Name: blockcache_wbdone
+ ****************************************************************************/
+
+static void blockcache_wbdone(FAR struct fs_aio_s *aio, ssize_t result)
+{
+  FAR struct blockcache_page_s *page = aio->priv;
+
+  page->result = result;
+  nxsem_post(&g_blockcache_wbsem);
+}
+
+/****************************************************************************
+ * Name: blockcache_queuepage
+ *
+ * Description:
+ *   Submit the write back of a page to the request queue of its driver,
+ *   with the queue plugged so that the whole flush is merged and sorted
+ *   before the first transfer starts.
+ *
+ ****************************************************************************/
+
+static int blockcache_queuepage(FAR struct blockcache_page_s *page)
+{
+  int ret;
+
+  ret = blkqueue_open(page->inode, &page->blkq);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  page->req.aio.buf      = page->data;
+  page->req.aio.nbytes   = page->nvalid;
+  page->req.aio.offset   = BLOCKCACHE_FIRST(page);
+  page->req.aio.write    = true;
+  page->req.aio.complete = blockcache_wbdone;
+  page->req.aio.priv     = page;
+
+  blkqueue_plug(page->blkq);
+  ret = blkqueue_submit(page->blkq, &page->req);
+  if (ret < 0)
+    {
+      blkqueue_unplug(page->blkq);
+      blkqueue_close(page->blkq);
+      page->blkq = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_flush_locked
+ *
+ * Description:
+ *   Write the dirty pages back through the block request queues, which
+ *   merge adjacent pages into larger transfers.  Pages that cannot be
+ *   queued are written directly.
+ *
+ ****************************************************************************/
+
+static int blockcache_flush_locked(FAR struct inode *inode)
+{
+  FAR struct blockcache_page_s *page;
+  FAR dq_entry_t *node;
+  int result = OK;
+  int count = 0;
+  int queue;
+  int ret;
+
+  for (queue = 0; queue < 2; queue++)
+    {
+      dq_for_every(&g_blockcache.queue[queue], node)
+        {
+          page = (FAR struct blockcache_page_s *)node;
+          if (page->dirty && (inode == NULL || page->inode == inode))
+            {
+              if (blockcache_queuepage(page) >= 0)
+                {
+                  count++;
+                  continue;
+                }
+
+              ret = blockcache_writepage(page);
+              if (ret < 0)
+                {
+                  result = ret;
+                }
+            }
+        }
+    }
+
+  if (count == 0)
+    {
+      return result;
+    }
+
+  /* Remove the plugs, this starts the transfers */
+
+  for (queue = 0; queue < 2; queue++)
+    {
+      dq_for_every(&g_blockcache.queue[queue], node)
+        {
+          page = (FAR struct blockcache_page_s *)node;
+          if (page->blkq != NULL)
+            {
+              blkqueue_unplug(page->blkq);
+            }
+        }
+    }
+
+  while (count-- > 0)
+    {
+      nxsem_wait_uninterruptible(&g_blockcache_wbsem);
+    }
+
+  for (queue = 0; queue < 2; queue++)
+    {
+      dq_for_every(&g_blockcache.queue[queue], node)
+        {
+          page = (FAR struct blockcache_page_s *)node;
+          if (page->blkq == NULL)
+            {
+              continue;
+            }
+
+          blkqueue_close(page->blkq);
+          page->blkq = NULL;
+
+          if (page->result == page->nvalid)
+            {
+              page->dirty = false;
+              g_blockcache.stats.writebacks++;
+            }
+          else
+            {
+              ferr("ERROR: Write back of sector %" PRIdOFF " failed: %zd\n",
+                   (off_t)BLOCKCACHE_FIRST(page), page->result);
+              result = page->result < 0 ? page->result : -EIO;
+            }
+        }
+    }
+
+  return result;
+}
+
+#else
+
+/****************************************************************************
+ * Name: blockcache_flush_locked
+ ****************************************************************************/
+
+static int blockcache_flush_locked(FAR struct inode *inode)
+{
+  FAR struct blockcache_page_s *page;
+  FAR dq_entry_t *node;
+  int result = OK;
+  int queue;
+  int ret;
+
+  for (queue = 0; queue < 2; queue++)
+    {
+      dq_for_every(&g_blockcache.queue[queue], node)
+        {
+          page = (FAR struct blockcache_page_s *)node;
+          if (page->dirty && (inode == NULL || page->inode == inode))
+            {
+              ret = blockcache_writepage(page);
+              if (ret < 0)
+                {
+                  result = ret;
+                }
+            }
+        }
+    }
+
+  return result;
+}
+#endif /* CONFIG_FS_BLKQUEUE */
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+
+/****************************************************************************
+ * Name: blockcache_worker
+ ****************************************************************************/
+
+static void blockcache_worker(FAR void *arg)
+{
+  nxmutex_lock(&g_blockcache.lock);
+  blockcache_flush_locked(NULL);
+  nxmutex_unlock(&g_blockcache.lock);
+}
+
+/****************************************************************************
+ * Name: blockcache_dirty
+ ****************************************************************************/
+
+static void blockcache_dirty(FAR struct blockcache_page_s *page)
+{
+  page->dirty = true;
+
+  if (work_available(&g_blockcache.work))
+    {
+      work_queue(LPWORK, &g_blockcache.work, blockcache_worker, NULL,
+                 MSEC2TICK(CONFIG_FS_BLOCKCACHE_WRITEBACK_DELAY));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_read
+ ****************************************************************************/
+
+ssize_t blockcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                        blkcnt_t start, unsigned int nsectors,
+                        size_t sectorsize)
+{
+  FAR struct blockcache_page_s *page;
+  unsigned int remaining = nsectors;
+  size_t spp = BLOCKCACHE_PAGESIZE / sectorsize;
+  ssize_t ret;
+
+  if (spp == 0 || spp > UINT16_MAX || nsectors == 0)
+    {
+      return inode->u.i_bops->read(inode, buffer, start, nsectors);
+    }
+
+  ret = nxmutex_lock(&g_blockcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Requests of more than a page go straight to the driver, both to save
+   * the extra copy and to keep large sequential reads from flushing the
+   * cache.
+   */
+
+  g_blockcache.stats.reqsectors += nsectors;
+
+  if (nsectors > spp)
+    {
+      g_blockcache.stats.bypasses++;
+      ret = inode->u.i_bops->read(inode, buffer, start, nsectors);
+      if (ret > 0)
+        {
+          g_blockcache.stats.drvsectors += ret;
+          blockcache_update(inode, buffer, start, ret, sectorsize, spp,
+                            false);
+        }
+
+      goto out;
+    }
+
+  while (remaining > 0)
+    {
+      blkcnt_t index = start / spp;
+      unsigned int offset = start % spp;
+      unsigned int count = MIN(spp - offset, remaining);
+      bool hit;
+
+      page = blockcache_find(inode, index, spp);
+      hit  = page != NULL;
+      if (hit)
+        {
+          blockcache_touch(page);
+        }
+      else
+        {
+          page = blockcache_fill(inode, index, spp);
+        }
+
+      if (page != NULL && offset + count <= page->nvalid)
+        {
+          if (hit)
+            {
+              g_blockcache.stats.hits++;
+            }
+          else
+            {
+              g_blockcache.stats.misses++;
+            }
+
+          memcpy(buffer, page->data + offset * sectorsize,
+                 count * sectorsize);
+        }
+      else
+        {
+          g_blockcache.stats.misses++;
+          ret = inode->u.i_bops->read(inode, buffer, start, count);
+          if (ret < 0)
+            {
+              goto out;
+            }
+
+          g_blockcache.stats.drvsectors += ret;
+          if (ret != count)
+            {
+              ret = nsectors - remaining + ret;
+              goto out;
+            }
+        }
+
+      buffer    += count * sectorsize;
+      start     += count;
+      remaining -= count;
+    }
+
+  ret = nsectors;
+
+out:
+  nxmutex_unlock(&g_blockcache.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_write
+ ****************************************************************************/
+
+ssize_t blockcache_write(FAR struct inode *inode,
+                         FAR const unsigned char *buffer, blkcnt_t start,
+                         unsigned int nsectors, size_t sectorsize)
+{
+  size_t spp = BLOCKCACHE_PAGESIZE / sectorsize;
+  ssize_t ret;
+
+  if (spp == 0 || spp > UINT16_MAX || nsectors == 0)
+    {
+      return inode->u.i_bops->write(inode, buffer, start, nsectors);
+    }
+
+  ret = nxmutex_lock(&g_blockcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  if (nsectors <= spp)
+    {
+      FAR struct blockcache_page_s *page;
+      unsigned int remaining = nsectors;
+
+      while (remaining > 0)
+        {
+          blkcnt_t index = start / spp;
+          unsigned int offset = start % spp;
+          unsigned int count = MIN(spp - offset, remaining);
+
+          page = blockcache_find(inode, index, spp);
+          if (page != NULL)
+            {
+              blockcache_touch(page);
+            }
+          else if (count == spp && (page = blockcache_alloc()) != NULL)
+            {
+              /* The whole page is overwritten, no need to read it */
+
+              blockcache_insert(page, inode, index, spp, spp);
+            }
+
+          if (page != NULL && offset + count <= page->nvalid)
+            {
+              memcpy(page->data + offset * sectorsize, buffer,
+                     count * sectorsize);
+              blockcache_dirty(page);
+            }
+          else
+            {
+              ret = inode->u.i_bops->write(inode, buffer, start, count);
+              if (ret < 0)
+                {
+                  goto out;
+                }
+              else if (ret != count)
+                {
+                  ret = nsectors - remaining + ret;
+                  goto out;
+                }
+            }
+
+          buffer    += count * sectorsize;
+          start     += count;
+          remaining -= count;
+        }
+
+      ret = nsectors;
+      goto out;
+    }
+#endif
+
+  /* Write through to the driver and refresh any cached copy */
+
+  ret = inode->u.i_bops->write(inode, buffer, start, nsectors);
+  if (ret > 0)
+    {
+      blockcache_update(inode, (FAR unsigned char *)buffer, start, ret,
+                        sectorsize, spp, true);
+    }
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+out:
+#endif
+  nxmutex_unlock(&g_blockcache.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_flush
+ ****************************************************************************/
+
+int blockcache_flush(FAR struct inode *inode)
+{
+  int ret;
+
+  ret = nxmutex_lock(&g_blockcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = blockcache_flush_locked(inode);
+  nxmutex_unlock(&g_blockcache.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_invalidate
+ ****************************************************************************/
+
+void blockcache_invalidate(FAR struct inode *inode)
+{
+  FAR struct blockcache_page_s *page;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *tmp;
+  int queue;
+
+  nxmutex_lock(&g_blockcache.lock);
+
+  for (queue = 0; queue < 2; queue++)
+    {
+      dq_for_every_safe(&g_blockcache.queue[queue], node, tmp)
+        {
+          page = (FAR struct blockcache_page_s *)node;
+          if (page->inode == inode)
+            {
+              blockcache_remove(page);
+              blockcache_release(page);
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_blockcache.lock);
+}
+
+/****************************************************************************
+ * Name: blockcache_getstats
+ ****************************************************************************/
+
+void blockcache_getstats(FAR struct blockcache_stats_s *stats)
+{
+  nxmutex_lock(&g_blockcache.lock);
+  memcpy(stats, &g_blockcache.stats, sizeof(*stats));
+  stats->npages = g_blockcache.npages;
+  nxmutex_unlock(&g_blockcache.lock);
+}
+
+/****************************************************************************
+ * Name: blockcache_resetstats
+ ****************************************************************************/
+
+void blockcache_resetstats(void)
+{
+  nxmutex_lock(&g_blockcache.lock);
+  memset(&g_blockcache.stats, 0, sizeof(g_blockcache.stats));
+  nxmutex_unlock(&g_blockcache.lock);
+}
+
+#endif /* CONFIG_FS_BLOCKCACHE */
@@ -29,8 +29,10 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/param.h>
 #include <sys/mount.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
@@ -40,6 +42,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/blockcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
@@ -71,6 +74,9 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
+static ssize_t fat_readv(FAR struct file *filep, FAR const struct uio *uio);
+static ssize_t fat_writev(FAR struct file *filep,
+                 FAR const struct uio *uio);
 static off_t   fat_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fat_ioctl(FAR struct file *filep, int cmd,
                  unsigned long arg);
@@ -80,6 +86,10 @@ static int     fat_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     fat_fstat(FAR const struct file *filep,
                  FAR struct stat *buf);
 static int     fat_truncate(FAR struct file *filep, off_t length);
+static void    fat_invalidate_extents(FAR struct fat_mountpt_s *fs,
+                 off_t dirsector, uint16_t dirindex);
+static int     fat_releaseprealloc(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff);
 
 static int     fat_opendir(FAR struct inode *mountpt,
                  FAR const char *relpath, FAR struct fs_dirent_s **dir);
@@ -134,8 +144,8 @@ const struct mountpt_operations g_fat_operations =
   NULL,              /* mmap */
   fat_truncate,      /* truncate */
   NULL,              /* poll */
-  NULL,              /* readv */
-  NULL,              /* writev */
+  fat_readv,         /* readv */
+  fat_writev,        /* writev */
 
   fat_sync,          /* sync */
   fat_dup,           /* dup */
@@ -274,6 +284,9 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
             {
               goto errout_with_lock;
             }
+
+          fat_invalidate_extents(fs, fs->fs_currentsector,
+                                 dirinfo.dir.fd_index);
         }
 
       /* fall through to finish the file open operations */
@@ -323,7 +336,7 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
    * file.
    */
 
-  ff = fs_heap_zalloc(sizeof(struct fat_file_s));
+  ff = fs_heap_arena_zalloc(fs->fs_arena, sizeof(struct fat_file_s));
   if (!ff)
     {
       ret = -ENOMEM;
@@ -332,7 +345,7 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Create a file buffer to support partial sector accesses */
 
-  ff->ff_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+  ff->ff_buffer = (FAR uint8_t *)fat_io_alloc(fs, fs->fs_hwsectorsize);
   if (!ff->ff_buffer)
     {
       ret = -ENOMEM;
@@ -415,6 +428,7 @@ static int fat_close(FAR struct file *filep)
   FAR struct fat_file_s *prevff;
   FAR struct fat_mountpt_s *fs;
   int ret = OK;
+  int ret2;
 
   /* Sanity checks */
 
@@ -436,9 +450,22 @@ static int fat_close(FAR struct file *filep)
        * the file even when there is healthy mount.
        */
 
+      /* Give back the clusters reserved by fallocate() but not written */
+
+      if ((ff->ff_bflags & FFBUFF_PREALLOC) != 0 &&
+          nxmutex_lock(&fs->fs_lock) >= 0)
+        {
+          ret = fat_releaseprealloc(fs, ff);
+          nxmutex_unlock(&fs->fs_lock);
+        }
+
       /* Synchronize the file buffers and disk content; update times */
 
-      ret = fat_sync(filep);
+      ret2 = fat_sync(filep);
+      if (ret >= 0)
+        {
+          ret = ret2;
+        }
 
       /* Remove the file structure from the list of open files in the
        * mountpoint structure.
@@ -509,7 +536,7 @@ static int fat_zero_cluster(FAR struct fat_mountpt_s *fs, int cluster,
   off_t end_sec = sector + DIV_ROUND_UP(end, fs->fs_hwsectorsize);
   int ret;
 
-  buf = fs_heap_malloc(fs->fs_hwsectorsize);
+  buf = fs_heap_arena_malloc(fs->fs_arena, fs->fs_hwsectorsize);
   if (!buf)
     {
       return -ENOMEM;
@@ -553,6 +580,298 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that the cluster at 'index' in the file is immediately followed
+ *   on the media by cluster + 1.  Each open file remembers the most recent
+ *   such run of clusters so that walking over it again, after a backward
+ *   seek for example, needs no FAT accesses.
+ *
+ ****************************************************************************/
+
+static void fat_extentadd(FAR struct fat_file_s *ff, uint32_t cluster,
+                          uint32_t index)
+{
+  if (ff->ff_extcount > 0 && index + 1 == ff->ff_extindex + ff->ff_extcount)
+    {
+      ff->ff_extcount++;
+    }
+  else if (ff->ff_extcount == 0 || index < ff->ff_extindex ||
+           index >= ff->ff_extindex + ff->ff_extcount)
+    {
+      ff->ff_extcluster = cluster;
+      ff->ff_extindex   = index;
+      ff->ff_extcount   = 2;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_nextcluster
+ *
+ * Description:
+ *   Return the cluster that follows 'cluster', the cluster at 'index' in
+ *   the file, using the cached extent when it covers it.
+ *
+ ****************************************************************************/
+
+static off_t fat_nextcluster(FAR struct fat_mountpt_s *fs,
+                             FAR struct fat_file_s *ff, uint32_t cluster,
+                             uint32_t index)
+{
+  off_t next;
+
+  if (ff->ff_extcount > 0 && index >= ff->ff_extindex &&
+      index + 1 < ff->ff_extindex + ff->ff_extcount)
+    {
+      return cluster + 1;
+    }
+
+  next = fat_getcluster(fs, cluster);
+  if (next == cluster + 1)
+    {
+      fat_extentadd(ff, cluster, index);
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: fat_invalidate_extents
+ *
+ * Description:
+ *   Forget the cached extents of every open instance of the file whose
+ *   directory entry is at (dirsector, dirindex), after its cluster chain
+ *   has been cut.
+ *
+ ****************************************************************************/
+
+static void fat_invalidate_extents(FAR struct fat_mountpt_s *fs,
+                                   off_t dirsector, uint16_t dirindex)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      if (ff->ff_dirsector == dirsector && ff->ff_dirindex == dirindex)
+        {
+          ff->ff_extcount = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_releaseprealloc
+ *
+ * Description:
+ *   Called when 'ff' is closed after clusters were reserved past its end.
+ *   The last handle of the file to be closed releases the clusters that
+ *   still hold no data.
+ *
+ ****************************************************************************/
+
+static int fat_releaseprealloc(FAR struct fat_mountpt_s *fs,
+                               FAR struct fat_file_s *ff)
+{
+  FAR struct fat_file_s *other;
+  FAR uint8_t *direntry;
+  off_t length;
+  int ret;
+
+  for (other = fs->fs_head; other != NULL; other = other->ff_next)
+    {
+      if (other != ff && other->ff_dirsector == ff->ff_dirsector &&
+          other->ff_dirindex == ff->ff_dirindex)
+        {
+          /* Leave the reservation to the last one to close */
+
+          other->ff_bflags |= FFBUFF_PREALLOC;
+          ff->ff_bflags &= ~FFBUFF_PREALLOC;
+          return OK;
+        }
+    }
+
+  /* Other handles may have grown the file and already closed; keep what
+   * the directory entry records as well.
+   */
+
+  ret = fat_fscacheread(fs, ff->ff_dirsector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  direntry = &fs->fs_buffer[(ff->ff_dirindex & DIRSEC_NDXMASK(fs)) *
+                            DIR_SIZE];
+  length   = MAX(ff->ff_size, (off_t)DIR_GETFILESIZE(direntry));
+
+  ret = fat_trimchain(fs, ff, length);
+  fat_invalidate_extents(fs, ff->ff_dirsector, ff->ff_dirindex);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_fallocate
+ *
+ * Description:
+ *   Handle FIOC_FALLOCATE: allocate the clusters backing the byte range
+ *   of the request, contiguously where the free space allows, and extend
+ *   the file over them unless FALLOC_FL_KEEP_SIZE is given.
+ *
+ ****************************************************************************/
+
+static int fat_fallocate(FAR struct fat_mountpt_s *fs,
+                         FAR struct fat_file_s *ff,
+                         FAR const struct fallocate_s *req)
+{
+  off_t clu_size = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  off_t end;
+  int ret;
+
+  if (req == NULL || req->offset < 0 || req->len <= 0)
+    {
+      return -EINVAL;
+    }
+  else if ((req->mode & ~FALLOC_FL_KEEP_SIZE) != 0)
+    {
+      return -EOPNOTSUPP;
+    }
+  else if ((ff->ff_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  /* The size of a FAT file is a 32-bit quantity */
+
+  end = req->offset + req->len;
+  if (end < 0 || (uint64_t)end > UINT32_MAX)
+    {
+      return -EFBIG;
+    }
+
+  ret = fat_reservechain(fs, ff, DIV_ROUND_UP(end, clu_size));
+  if (ret >= 0 && (req->mode & FALLOC_FL_KEEP_SIZE) == 0 &&
+      end > ff->ff_size)
+    {
+      ret = fat_dirextend(fs, ff, end);
+      if (ret >= 0)
+        {
+          ff->ff_size = end;
+          ret = OK;
+        }
+    }
+
+  return ret;
+}
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Return how many of the next 'nsectors' sectors of the file, starting
+ *   at ff_currentsector, are consecutive on the media, so that they can be
+ *   transferred with a single block driver request.  The run may cross
+ *   cluster boundaries wherever the cluster chain is contiguous.  If
+ *   'extend' is true, the chain is grown into the free clusters that
+ *   immediately follow its end so that appends can be written in one
+ *   request as well.
+ *
+ * Returned Value:
+ *   The number of sectors (at least one) or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int fat_contiguous(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_file_s *ff, unsigned int nsectors,
+                          bool extend)
+{
+  uint32_t clu_size = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  uint32_t cluster  = ff->ff_currentcluster;
+  uint32_t index    = ff->ff_pos / clu_size;
+  unsigned int run  = ff->ff_sectorsincluster;
+  off_t next;
+
+  while (run < nsectors)
+    {
+      next = fat_nextcluster(fs, ff, cluster, index);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next >= 2 && next < fs->fs_nclusters + 2)
+        {
+          /* The chain goes on, is it contiguous here? */
+
+          if (next != cluster + 1)
+            {
+              break;
+            }
+        }
+      else if (extend && cluster + 1 < fs->fs_nclusters + 2 &&
+               fat_getcluster(fs, cluster + 1) == 0)
+        {
+          /* End of chain and the following cluster is free: the search of
+           * fat_extendchain() starts there, so it will allocate it.
+           */
+
+          next = fat_extendchain(fs, cluster);
+          if (next < 0)
+            {
+              return next;
+            }
+          else if (next != cluster + 1)
+            {
+              break;
+            }
+
+          fat_extentadd(ff, cluster, index);
+        }
+      else
+        {
+          break;
+        }
+
+      cluster++;
+      index++;
+      run += fs->fs_fatsecperclus;
+    }
+
+  return MIN(run, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_advance
+ *
+ * Description:
+ *   Move the current sector forward past a direct transfer of 'nsectors'
+ *   returned by fat_contiguous(), possibly into a later cluster.
+ *
+ ****************************************************************************/
+
+static void fat_advance(FAR struct fat_mountpt_s *fs,
+                        FAR struct fat_file_s *ff, unsigned int nsectors)
+{
+  if (nsectors > ff->ff_sectorsincluster)
+    {
+      unsigned int extra = nsectors - ff->ff_sectorsincluster;
+      unsigned int nclusters = DIV_ROUND_UP(extra, fs->fs_fatsecperclus);
+
+      ff->ff_currentcluster   += nclusters;
+      ff->ff_pos              += (off_t)nclusters * fs->fs_fatsecperclus *
+                                 fs->fs_hwsectorsize;
+      ff->ff_sectorsincluster  = nclusters * fs->fs_fatsecperclus - extra;
+    }
+  else
+    {
+      ff->ff_sectorsincluster -= nsectors;
+    }
+
+  ff->ff_currentsector += nsectors;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_get_sectors
  *
@@ -620,11 +939,21 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
       num_traversed = 1;
     }
 
+  /* Jump straight to the target cluster if the cached extent holds it */
+
+  i = MIN(num_clu, new_num_clu) - 1;
+  if (cluster != 0 && i >= num_traversed && ff->ff_extcount > 0 &&
+      i >= ff->ff_extindex && i < ff->ff_extindex + ff->ff_extcount)
+    {
+      cluster = ff->ff_extcluster + (i - ff->ff_extindex);
+      num_traversed = i + 1;
+    }
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
     {
-      cluster = fat_getcluster(fs, cluster);
+      cluster = fat_nextcluster(fs, ff, cluster, i - 1);
 
       /* The chain is broken */
 
@@ -745,15 +1074,19 @@ out:
 }
 
 /****************************************************************************
- * Name: fat_read
+ * Name: fat_readbuf
+ *
+ * Description:
+ *   Read from the current file position into one user buffer.  The caller
+ *   holds fs_lock and has already verified the mount and the access mode.
+ *
  ****************************************************************************/
 
-static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen)
+static ssize_t fat_readbuf(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
 {
-  FAR struct inode *inode;
-  FAR struct fat_mountpt_s *fs;
-  FAR struct fat_file_s *ff;
+  FAR struct fat_mountpt_s *fs = filep->f_inode->i_private;
+  FAR struct fat_file_s *ff = filep->f_priv;
   unsigned int bytesread;
   unsigned int readsize;
   size_t bytesleft;
@@ -766,56 +1099,13 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   bool force_indirect = false;
 #endif
 
-  /* Sanity checks */
-
-  DEBUGASSERT(filep->f_priv != NULL);
-
-  /* Recover our private data from the struct file instance */
-
-  ff = filep->f_priv;
-
-  /* Check for the forced mount condition */
-
-  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
-    {
-      return -EPIPE;
-    }
-
-  inode = filep->f_inode;
-  fs    = inode->i_private;
-
-  DEBUGASSERT(fs != NULL);
-
-  /* Make sure that the mount is still healthy */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  ret = fat_checkmount(fs);
-  if (ret != OK)
-    {
-      goto errout_with_lock;
-    }
-
-  /* Check if the file was opened with read access */
-
-  if ((ff->ff_oflags & O_RDOK) == 0)
-    {
-      ret = -EACCES;
-      goto errout_with_lock;
-    }
-
   /* Check that the file position is not past the end of the file */
 
   if (filep->f_pos > ff->ff_size)
     {
       /* Return EOF */
 
-      ret = 0;
-      goto errout_with_lock;
+      return 0;
     }
   else
     {
@@ -848,7 +1138,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
       ret = fat_get_sectors(filep, true);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
 
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
@@ -868,15 +1158,19 @@ fat_read_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we read on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the sectors that are consecutive on the
+           * media, in this cluster and in any clusters that follow it
+           * contiguously.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contiguous(fs, ff, nsectors, false);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              return ret;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
            */
@@ -906,12 +1200,11 @@ fat_read_restart:
                 }
 #endif /* CONFIG_FAT_DIRECT_RETRY */
 
-              goto errout_with_lock;
+              return ret;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_advance(fs, ff, nsectors);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -925,7 +1218,7 @@ fat_read_restart:
           ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
           if (ret < 0)
             {
-              goto errout_with_lock;
+              return ret;
             }
 
           /* Copy the requested part of the sector into the user buffer */
@@ -957,34 +1250,23 @@ fat_read_restart:
       sectorindex   = filep->f_pos & SEC_NDXMASK(fs);
     }
 
-  nxmutex_unlock(&fs->fs_lock);
   return readsize;
-
-errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
-  return ret;
 }
 
 /****************************************************************************
- * Name: fat_write
+ * Name: fat_readv
  ****************************************************************************/
 
-static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
+static ssize_t fat_readv(FAR struct file *filep, FAR const struct uio *uio)
 {
   FAR struct inode *inode;
   FAR struct fat_mountpt_s *fs;
   FAR struct fat_file_s *ff;
-  unsigned int byteswritten;
-  unsigned int writesize;
-  FAR uint8_t *userbuffer = (FAR uint8_t *)buffer;
-  int sectorindex;
-  int ret;
+  ssize_t nread = 0;
+  ssize_t ret;
+  int i;
 
-#ifndef CONFIG_FAT_FORCE_INDIRECT
-  unsigned int nsectors;
-  bool force_indirect = false;
-#endif
+  /* Sanity checks */
 
   DEBUGASSERT(filep->f_priv != NULL);
 
@@ -1018,20 +1300,97 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_lock;
     }
 
-  /* Check if the file was opened for write access */
+  /* Check if the file was opened with read access */
 
-  if ((ff->ff_oflags & O_WROK) == 0)
+  if ((ff->ff_oflags & O_RDOK) == 0)
     {
       ret = -EACCES;
       goto errout_with_lock;
     }
 
+  /* Fill each buffer in turn while holding the lock, stopping at the end
+   * of the file or at the first short transfer.
+   */
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      FAR const struct iovec *iov = &uio->uio_iov[i];
+
+      ret = fat_readbuf(filep, iov->iov_base, iov->iov_len);
+      if (ret < 0)
+        {
+          if (nread == 0)
+            {
+              goto errout_with_lock;
+            }
+
+          break;
+        }
+
+      nread += ret;
+      if (ret < iov->iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return nread;
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_read
+ ****************************************************************************/
+
+static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = buffer;
+  iov.iov_len = buflen;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return fat_readv(filep, &uio);
+}
+
+/****************************************************************************
+ * Name: fat_writebuf
+ *
+ * Description:
+ *   Write one user buffer at the current file position.  The caller holds
+ *   fs_lock and has already verified the mount and the access mode.
+ *
+ ****************************************************************************/
+
+static ssize_t fat_writebuf(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  FAR struct fat_mountpt_s *fs = filep->f_inode->i_private;
+  FAR struct fat_file_s *ff = filep->f_priv;
+  unsigned int byteswritten;
+  unsigned int writesize;
+  FAR uint8_t *userbuffer = (FAR uint8_t *)buffer;
+  int sectorindex;
+  int ret;
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+  unsigned int nsectors;
+  bool force_indirect = false;
+#endif
+
   /* Check if the file size would exceed the range of off_t */
 
   if (buflen > OFF_MAX || ff->ff_size > OFF_MAX - (off_t)buflen)
     {
       ret = -EFBIG;
-      goto errout_with_lock;
+      return ret;
     }
 
   /* Loop until either (1) all data has been transferred, or (2) an
@@ -1047,7 +1406,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
       ret = fat_get_sectors(filep, false);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
 
 #ifdef CONFIG_FAT_DIRECT_RETRY /* Warning avoidance */
@@ -1066,15 +1425,19 @@ fat_write_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we write on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the sectors that are consecutive on the
+           * media, allocating the free clusters that follow the end of
+           * the file if we are appending.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contiguous(fs, ff, nsectors, true);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              return ret;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
            * and invalidate the current cache content.
@@ -1105,11 +1468,10 @@ fat_write_restart:
                 }
 #endif /* CONFIG_FAT_DIRECT_RETRY */
 
-              goto errout_with_lock;
+              return ret;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
+          fat_advance(fs, ff, nsectors);
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
         }
@@ -1139,7 +1501,7 @@ fat_write_restart:
               ret = fat_ffcacheflush(fs, ff);
               if (ret < 0)
                 {
-                  goto errout_with_lock;
+                  return ret;
                 }
 
               /* Now mark the clean cache buffer as the current sector. */
@@ -1155,7 +1517,7 @@ fat_write_restart:
               ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
               if (ret < 0)
                 {
-                  goto errout_with_lock;
+                  return ret;
                 }
             }
 
@@ -1205,14 +1567,110 @@ fat_write_restart:
         }
     }
 
-  nxmutex_unlock(&fs->fs_lock);
   return byteswritten;
+}
+
+/****************************************************************************
+ * Name: fat_writev
+ ****************************************************************************/
+
+static ssize_t fat_writev(FAR struct file *filep, FAR const struct uio *uio)
+{
+  FAR struct inode *inode;
+  FAR struct fat_mountpt_s *fs;
+  FAR struct fat_file_s *ff;
+  ssize_t nwritten = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  ff = filep->f_priv;
+
+  /* Check for the forced mount condition */
+
+  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
+    {
+      return -EPIPE;
+    }
+
+  inode = filep->f_inode;
+  fs    = inode->i_private;
+
+  DEBUGASSERT(fs != NULL);
+
+  /* Make sure that the mount is still healthy */
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  /* Check if the file was opened for write access */
+
+  if ((ff->ff_oflags & O_WROK) == 0)
+    {
+      ret = -EACCES;
+      goto errout_with_lock;
+    }
+
+  /* Write each buffer in turn while holding the lock so that the whole
+   * vector lands contiguously in the file.
+   */
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      FAR const struct iovec *iov = &uio->uio_iov[i];
+
+      ret = fat_writebuf(filep, iov->iov_base, iov->iov_len);
+      if (ret < 0)
+        {
+          if (nwritten == 0)
+            {
+              goto errout_with_lock;
+            }
+
+          break;
+        }
+
+      nwritten += ret;
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return nwritten;
 
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_write
+ ****************************************************************************/
+
+static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len = buflen;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return fat_writev(filep, &uio);
+}
+
 /****************************************************************************
  * Name: fat_seek
  ****************************************************************************/
@@ -1368,6 +1826,14 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  if (cmd == FIOC_FALLOCATE)
+    {
+      ret = fat_fallocate(fs, ff,
+                          (FAR const struct fallocate_s *)(uintptr_t)arg);
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+
   /* ioctl calls are just passed through to the contained block driver */
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1492,6 +1958,13 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+  /* Write back anything still held by the block cache */
+
+  if (ret >= 0)
+    {
+      ret = blockcache_flush(fs->fs_blkdriver);
+    }
+
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1554,7 +2027,7 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
    * dup'ed file.
    */
 
-  newff = fs_heap_malloc(sizeof(struct fat_file_s));
+  newff = fs_heap_arena_malloc(fs->fs_arena, sizeof(struct fat_file_s));
   if (!newff)
     {
       ret = -ENOMEM;
@@ -1563,7 +2036,7 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   /* Create a file buffer to support partial sector accesses */
 
-  newff->ff_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+  newff->ff_buffer = (FAR uint8_t *)fat_io_alloc(fs, fs->fs_hwsectorsize);
   if (!newff->ff_buffer)
     {
       ret = -ENOMEM;
@@ -1599,6 +2072,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+  newff->ff_pos              = oldff->ff_pos;              /* Position of the current cluster */
+  newff->ff_extcluster       = oldff->ff_extcluster;       /* Cached extent */
+  newff->ff_extindex         = oldff->ff_extindex;
+  newff->ff_extcount         = oldff->ff_extcount;
 
   /* Attach the private date to the struct file instance */
 
@@ -1652,7 +2129,7 @@ static int fat_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   fs = mountpt->i_private;
 
-  fdir = fs_heap_zalloc(sizeof(struct fat_dirent_s));
+  fdir = fs_heap_arena_zalloc(fs->fs_arena, sizeof(struct fat_dirent_s));
   if (fdir == NULL)
     {
       return -ENOMEM;
@@ -1938,6 +2415,7 @@ static int fat_truncate(FAR struct file *filep, off_t length)
            */
 
           ff->ff_size = length;
+          fat_invalidate_extents(fs, ff->ff_dirsector, ff->ff_dirindex);
           ret = OK;
         }
     }
@@ -2203,6 +2681,67 @@ errout_with_lock:
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: fat_parse_options
+ *
+ * Description:
+ *   Parse the comma separated mount options.  Only the heap arena options
+ *   of fs_heap_arena_option() are understood, anything else is ignored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HEAP_ARENA
+static int fat_parse_options(FAR struct fat_mountpt_s *fs,
+                             FAR const char *data)
+{
+  FAR char *options;
+  FAR char *saveptr;
+  FAR char *ptr;
+  size_t heapsize = 0;
+  bool heappool = false;
+  int ret = OK;
+
+  if (data == NULL)
+    {
+      return OK;
+    }
+
+  options = fs_heap_strdup(data);
+  if (options == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ptr = strtok_r(options, ",", &saveptr);
+  while (ptr != NULL && ret == OK)
+    {
+      if (fs_heap_arena_option(ptr, &heapsize, &heappool) < 0)
+        {
+          ferr("ERROR: Invalid mount option '%s'\n", ptr);
+          ret = -EINVAL;
+        }
+
+      ptr = strtok_r(NULL, ",", &saveptr);
+    }
+
+  fs_heap_free(options);
+
+  if (ret == OK && heapsize > 0)
+    {
+      char name[32];
+
+      snprintf(name, sizeof(name), "fat:%s", fs->fs_blkdriver->i_name);
+      fs->fs_arena = fs_heap_arena_create(name, heapsize, heappool);
+      if (fs->fs_arena == NULL)
+        {
+          ret = -ENOMEM;
+        }
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_bind
  *
@@ -2249,6 +2788,16 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
   fs->fs_blkdriver = blkdriver;   /* Save the block driver reference */
   nxmutex_init(&fs->fs_lock);     /* Initialize the mutex that controls access */
 
+#ifdef CONFIG_FS_HEAP_ARENA
+  ret = fat_parse_options(fs, data);
+  if (ret < 0)
+    {
+      nxmutex_destroy(&fs->fs_lock);
+      fs_heap_free(fs);
+      return ret;
+    }
+#endif
+
   /* Then get information about the FAT32 filesystem on the devices managed
    * by this block driver.
    */
@@ -2256,6 +2805,9 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
   ret = fat_mount(fs, true);
   if (ret != 0)
     {
+#ifdef CONFIG_FS_HEAP_ARENA
+      fs_heap_arena_destroy(fs->fs_arena);
+#endif
       nxmutex_destroy(&fs->fs_lock);
       fs_heap_free(fs);
       return ret;
@@ -2333,6 +2885,9 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       FAR struct inode *inode = fs->fs_blkdriver;
       if (inode)
         {
+          blockcache_flush(inode);
+          blockcache_invalidate(inode);
+
           if (inode->u.i_bops && inode->u.i_bops->close)
             {
               inode->u.i_bops->close(inode);
@@ -2358,6 +2913,16 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap)
+    {
+      fs_heap_free(fs->fs_freemap);
+    }
+#endif
+
+#ifdef CONFIG_FS_HEAP_ARENA
+  fs_heap_arena_destroy(fs->fs_arena);
+#endif
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
@@ -335,6 +335,7 @@
 #define FFBUFF_VALID         1
 #define FFBUFF_DIRTY         2
 #define FFBUFF_MODIFIED      4
+#define FFBUFF_PREALLOC      16  /* Clusters are allocated past the EOF */
 
 /* Mount status flags (ff_bflags) */
 
@@ -841,16 +842,17 @@
  *   fat_dma_alloc() and fat_dma_free() as prototyped below:  fat_dmalloc()
  *   will allocate DMA-capable memory of the specified size; fat_dmafree()
  *   is the corresponding function that will be called to free the DMA-
- *   capable memory.
+ *   capable memory.  Otherwise the buffers come from the heap arena of the
+ *   mount, if it has one.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FAT_DMAMEMORY
-#  define fat_io_alloc(s)  fat_dma_alloc(s)
-#  define fat_io_free(m,s) fat_dma_free(m,s)
+#  define fat_io_alloc(f,s) fat_dma_alloc(s)
+#  define fat_io_free(m,s)  fat_dma_free(m,s)
 #else
-#  define fat_io_alloc(s)  fs_heap_malloc(s)
-#  define fat_io_free(m,s) fs_heap_free(m)
+#  define fat_io_alloc(f,s) fs_heap_arena_malloc((f)->fs_arena, s)
+#  define fat_io_free(m,s)  fs_heap_free(m)
 #endif
 
 /****************************************************************************
@@ -891,6 +893,16 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint8_t *fs_freemap;         /* Bit set: the cluster is free */
+  bool     fs_freemapfail;         /* true: The bitmap could not be allocated */
+#endif
+#ifdef CONFIG_FAT_DISCARD
+  bool     fs_nodiscard;           /* true: The driver does not discard */
+#endif
+#ifdef CONFIG_FS_HEAP_ARENA
+  FAR struct fs_heap_arena_s *fs_arena; /* Heap of this mount, if any */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -912,6 +924,9 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
+  uint32_t ff_extcluster;          /* First cluster of the cached extent */
+  uint32_t ff_extindex;            /* Index of ff_extcluster in the file */
+  uint32_t ff_extcount;            /* Clusters in the cached extent (0: none) */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
 };
 
@@ -1052,6 +1067,11 @@ EXTERN int    fat_removechain(FAR struct fat_mountpt_s *fs,
                               uint32_t cluster);
 EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
                                uint32_t cluster);
+EXTERN int    fat_reservechain(FAR struct fat_mountpt_s *fs,
+                               FAR struct fat_file_s *ff,
+                               uint32_t nclusters);
+EXTERN int    fat_trimchain(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_file_s *ff, off_t length);
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -38,16 +39,261 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/blockcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
+#include "fs_heap.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+#  define FREEMAP_ISFREE(fs, c) \
+     (((fs)->fs_freemap[(c) >> 3] & (1 << ((c) & 7))) != 0)
+#  define FREEMAP_SET(fs, c)    ((fs)->fs_freemap[(c) >> 3] |= 1 << ((c) & 7))
+#  define FREEMAP_CLR(fs, c)    ((fs)->fs_freemap[(c) >> 3] &= ~(1 << ((c) & 7)))
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_buildfreemap
+ *
+ * Description:
+ *   Build the bitmap of free clusters, if that has not been done yet, by
+ *   reading the whole FAT once.  The count of free clusters is refreshed
+ *   as a side effect.
+ *
+ * Returned Value:
+ *   OK if the bitmap is available; a negated errno value if it is not and
+ *   the FAT must be searched instead.
+ *
+ ****************************************************************************/
+
+static int fat_buildfreemap(FAR struct fat_mountpt_s *fs)
+{
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  if (fs->fs_freemap != NULL)
+    {
+      return OK;
+    }
+  else if (fs->fs_freemapfail)
+    {
+      return -ENOMEM;
+    }
+
+  fs->fs_freemap = fs_heap_arena_zalloc(fs->fs_arena,
+                                        (fs->fs_nclusters + 2 + 7) / 8);
+  if (fs->fs_freemap == NULL)
+    {
+      fwarn("WARNING: No memory for the free cluster bitmap\n");
+      fs->fs_freemapfail = true;
+      return -ENOMEM;
+    }
+
+  for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          fs_heap_free(fs->fs_freemap);
+          fs->fs_freemap = NULL;
+          return next;
+        }
+      else if (next == 0)
+        {
+          FREEMAP_SET(fs, cluster);
+          nfreeclusters++;
+        }
+    }
+
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_scanfreemap
+ *
+ * Description:
+ *   Return the first cluster in [from, to) that starts a run of at least
+ *   'minrun' free clusters (the run itself may extend past 'to'), or zero
+ *   if there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_scanfreemap(FAR struct fat_mountpt_s *fs,
+                                uint32_t from, uint32_t to,
+                                uint32_t minrun)
+{
+  uint32_t end = fs->fs_nclusters + 2;
+  uint32_t cluster = from;
+  uint32_t run = 0;
+
+  while (cluster < end && cluster - run < to)
+    {
+      /* Skip over whole bytes of allocated clusters at once */
+
+      if (run == 0 && (cluster & 7) == 0 &&
+          fs->fs_freemap[cluster >> 3] == 0)
+        {
+          cluster += 8;
+          continue;
+        }
+
+      if (FREEMAP_ISFREE(fs, cluster))
+        {
+          if (++run >= minrun)
+            {
+              return cluster + 1 - run;
+            }
+        }
+      else
+        {
+          run = 0;
+        }
+
+      cluster++;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: fat_findfree
+ *
+ * Description:
+ *   Find a free cluster after 'start' (wrapping around to the beginning of
+ *   the volume), preferring one that begins a run of at least 'minrun' free
+ *   clusters.
+ *
+ * Returned Value:
+ *   The free cluster number or zero if the volume is full.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_findfree(FAR struct fat_mountpt_s *fs, uint32_t start,
+                             uint32_t minrun)
+{
+  uint32_t end = fs->fs_nclusters + 2;
+  uint32_t cluster;
+
+  if (++start < 2 || start >= end)
+    {
+      start = 2;
+    }
+
+  if (minrun < 1)
+    {
+      minrun = 1;
+    }
+
+  cluster = fat_scanfreemap(fs, start, end, minrun);
+  if (cluster == 0)
+    {
+      cluster = fat_scanfreemap(fs, 2, start, minrun);
+    }
+
+  if (cluster == 0 && minrun > 1)
+    {
+      cluster = fat_findfree(fs, start - 1, 1);
+    }
+
+  return cluster;
+}
+#endif /* CONFIG_FAT_FREEMAP */
+
+/****************************************************************************
+ * Name: fat_searchfat
+ *
+ * Description:
+ *   Search the FAT itself for a free cluster following 'startcluster'.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: the free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_searchfat(FAR struct fat_mountpt_s *fs,
+                             uint32_t startcluster)
+{
+  uint32_t newcluster;
+  off_t    startsector;
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: fat_checkfsinfo
  *
@@ -508,7 +754,7 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
 
   /* Allocate a buffer to hold one hardware sector */
 
-  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs, fs->fs_hwsectorsize);
   if (!fs->fs_buffer)
     {
       ret = -ENOMEM;
@@ -698,8 +944,11 @@ int fat_checkmount(struct fat_mountpt_s *fs)
             }
         }
 
-      /* If we get here, the mount is NOT healthy */
+      /* If we get here, the mount is NOT healthy.  Whatever is cached for
+       * the old media is of no further use.
+       */
 
+      blockcache_invalidate(fs->fs_blkdriver);
       fs->fs_mounted = false;
     }
 
@@ -723,8 +972,9 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread = blockcache_read(inode, buffer, sector,
+                                                 nsectors,
+                                                 fs->fs_hwsectorsize);
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -757,7 +1007,8 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
           ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+              blockcache_write(inode, buffer, sector, nsectors,
+                               fs->fs_hwsectorsize);
 
           if (nsectorswritten == nsectors)
             {
@@ -1098,12 +1349,71 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEMAP
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          if (nextcluster == 0)
+            {
+              FREEMAP_SET(fs, clusterno);
+            }
+          else
+            {
+              FREEMAP_CLR(fs, clusterno);
+            }
+        }
+#endif
+
       return OK;
     }
 
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: fat_discard
+ *
+ * Description:
+ *   Pass a run of freed clusters to the block driver as BIOC_DISCARD.
+ *   Discard is only a hint, so failures are not reported.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_DISCARD
+static void fat_discard(struct fat_mountpt_s *fs, uint32_t cluster,
+                        uint32_t nclusters)
+{
+  struct inode *inode = fs->fs_blkdriver;
+  struct blk_discard_s range;
+  int ret;
+
+  if (nclusters == 0 || fs->fs_nodiscard || inode == NULL ||
+      inode->u.i_bops == NULL || inode->u.i_bops->ioctl == NULL)
+    {
+      return;
+    }
+
+  /* Dirty cached sectors of the run must not be written back later */
+
+  blockcache_flush(inode);
+
+  range.start    = fat_cluster2sector(fs, cluster);
+  range.nsectors = (blkcnt_t)nclusters * fs->fs_fatsecperclus;
+
+  ret = inode->u.i_bops->ioctl(inode, BIOC_DISCARD,
+                               (unsigned long)((uintptr_t)&range));
+  if (ret == -ENOTTY)
+    {
+      fs->fs_nodiscard = true;
+    }
+  else if (ret < 0)
+    {
+      fwarn("WARNING: Discard of %" PRIu32 " clusters failed: %d\n",
+            nclusters, ret);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_removechain
  *
@@ -1116,6 +1426,10 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 {
   int32_t nextcluster;
   int    ret;
+#ifdef CONFIG_FAT_DISCARD
+  uint32_t runstart = 0;
+  uint32_t runlen = 0;
+#endif
 
   /* Loop while there are clusters in the chain */
 
@@ -1139,6 +1453,21 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
           return ret;
         }
 
+#ifdef CONFIG_FAT_DISCARD
+      /* Collect contiguous clusters into one discard request */
+
+      if (runlen > 0 && cluster == runstart + runlen)
+        {
+          runlen++;
+        }
+      else
+        {
+          fat_discard(fs, runstart, runlen);
+          runstart = cluster;
+          runlen   = 1;
+        }
+#endif
+
       /* Update FSINFINFO data */
 
       if (fs->fs_fsifreecount != 0xffffffff)
@@ -1152,6 +1481,10 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
       cluster = nextcluster;
     }
 
+#ifdef CONFIG_FAT_DISCARD
+  fat_discard(fs, runstart, runlen);
+#endif
+
   return OK;
 }
 
@@ -1221,67 +1554,35 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
+  /* Find a free cluster following the start cluster, through the free
+   * cluster bitmap if there is one.  New chains prefer the start of a
+   * free run so that files growing concurrently do not interleave.
    */
 
-  newcluster = startcluster;
-  for (; ; )
+#ifdef CONFIG_FAT_FREEMAP
+  if (fat_buildfreemap(fs) >= 0)
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
+      uint32_t minrun = cluster == 0 ? CONFIG_FAT_FREEMAP_MINRUN : 1;
 
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
+      newcluster = fat_findfree(fs, startcluster, minrun);
+      if (newcluster == 0)
         {
-          /* Found have found a free cluster break out */
-
-          break;
+          return 0;
         }
-      else if (startsector < 0)
+    }
+  else
+#endif
+    {
+      int32_t found = fat_searchfat(fs, startcluster);
+      if (found <= 0)
         {
-          /* Some error occurred, return the error number */
-
-          return startsector;
+          return found;
         }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      newcluster = found;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
-   */
+  /* Now mark that cluster as in-use. */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
   if (ret < 0)
@@ -1318,6 +1619,189 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_reservechain
+ *
+ * Description:
+ *   Make sure that the cluster chain of the open file holds at least
+ *   'nclusters' clusters, allocating the missing ones.  A new chain is
+ *   started at a free run long enough to hold all of them if the free
+ *   cluster bitmap knows of one; an existing chain is extended from the
+ *   clusters that follow its end.  Clusters beyond the end of the file are
+ *   released again by fat_trimchain() when the file is closed.
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value; -ENOSPC if the volume
+ *   does not have enough free clusters.
+ *
+ ****************************************************************************/
+
+int fat_reservechain(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+                     uint32_t nclusters)
+{
+  fsblkcnt_t nfreeclusters;
+  uint32_t nchain = 0;
+  uint32_t last = 0;
+  off_t cluster = ff->ff_startcluster;
+  int32_t next;
+  int ret;
+
+  /* Count the clusters already in the chain */
+
+  while (cluster >= 2 && cluster < fs->fs_nclusters + 2 &&
+         nchain < nclusters)
+    {
+      last = cluster;
+      nchain++;
+      cluster = fat_getcluster(fs, cluster);
+    }
+
+  if (cluster < 0)
+    {
+      return cluster;
+    }
+  else if (nchain >= nclusters)
+    {
+      return OK;
+    }
+
+  ret = fat_nfreeclusters(fs, &nfreeclusters);
+  if (ret < 0)
+    {
+      return ret;
+    }
+  else if (nfreeclusters < nclusters - nchain)
+    {
+      return -ENOSPC;
+    }
+
+  ff->ff_bflags |= FFBUFF_PREALLOC;
+
+  if (last == 0)
+    {
+#ifdef CONFIG_FAT_FREEMAP
+      /* Point the allocator at a run that can hold the whole chain */
+
+      if (fat_buildfreemap(fs) >= 0)
+        {
+          uint32_t first = fat_findfree(fs, fs->fs_fsinextfree,
+                                        MAX(nclusters,
+                                            CONFIG_FAT_FREEMAP_MINRUN));
+          if (first >= 2)
+            {
+              fs->fs_fsinextfree = first - 1;
+            }
+        }
+#endif
+
+      next = fat_createchain(fs);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next == 0)
+        {
+          return -ENOSPC;
+        }
+
+      ff->ff_startcluster     = next;
+      ff->ff_currentcluster   = next;
+      ff->ff_currentsector    = 0;
+      ff->ff_sectorsincluster = fs->fs_fatsecperclus;
+      ff->ff_bflags          |= FFBUFF_MODIFIED;
+
+      last = next;
+      nchain++;
+    }
+
+  while (nchain < nclusters)
+    {
+      next = fat_extendchain(fs, last);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next == 0)
+        {
+          return -ENOSPC;
+        }
+
+      last = next;
+      nchain++;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_trimchain
+ *
+ * Description:
+ *   Release the clusters of the open file's chain that lie beyond the
+ *   first 'length' bytes, i.e. those reserved by fat_reservechain() but
+ *   never written.
+ *
+ ****************************************************************************/
+
+int fat_trimchain(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+                  off_t length)
+{
+  off_t clu_size = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  off_t nclusters = (length + clu_size - 1) / clu_size;
+  off_t cluster = ff->ff_startcluster;
+  off_t next;
+  int ret;
+
+  ff->ff_bflags &= ~FFBUFF_PREALLOC;
+  if (cluster < 2)
+    {
+      return OK;
+    }
+
+  if (nclusters == 0)
+    {
+      /* Nothing was written: give back the whole chain */
+
+      ff->ff_startcluster   = 0;
+      ff->ff_currentcluster = 0;
+      ff->ff_currentsector  = 0;
+      ff->ff_bflags        |= FFBUFF_MODIFIED;
+      return fat_removechain(fs, cluster);
+    }
+
+  /* Find the last cluster that holds data */
+
+  while (--nclusters > 0)
+    {
+      cluster = fat_getcluster(fs, cluster);
+      if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
+        {
+          return cluster < 0 ? (int)cluster : OK;
+        }
+    }
+
+  next = fat_getcluster(fs, cluster);
+  if (next < 0)
+    {
+      return next;
+    }
+  else if (next < 2 || next >= fs->fs_nclusters + 2)
+    {
+      return OK;
+    }
+
+  /* Terminate the chain there and free the remainder */
+
+  ret = fat_putcluster(fs, cluster, 0x0fffffff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ff->ff_bflags |= FFBUFF_MODIFIED;
+  return fat_removechain(fs, next);
+}
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -2033,6 +2517,38 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   /* We have to count the number of free clusters */
 
   uint32_t nfreeclusters = 0;
+
+#ifdef CONFIG_FAT_FREEMAP
+  /* Count the bits of the free cluster bitmap if we have it.  Building it
+   * counts the free clusters too.
+   */
+
+  if (fs->fs_freemap != NULL)
+    {
+      uint32_t cluster;
+
+      for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
+        {
+          if (FREEMAP_ISFREE(fs, cluster))
+            {
+              nfreeclusters++;
+            }
+        }
+
+      fs->fs_fsifreecount = nfreeclusters;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+
+      return OK;
+    }
+  else if (fat_buildfreemap(fs) >= 0)
+    {
+      return OK;
+    }
+#endif
+
   if (fs->fs_type == FSTYPE_FAT12)
     {
       off_t sector;
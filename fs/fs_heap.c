@@ -25,21 +25,107 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include <nuttx/spinlock.h>
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
 #if defined(CONFIG_FS_HEAPSIZE) && CONFIG_FS_HEAPSIZE > 0
+#  define FS_HEAP_MALLOC_SIZE(m) mm_malloc_size(g_fs_heap, m)
+#  define FS_HEAP_REALLOC(m, s)  mm_realloc(g_fs_heap, m, s)
+#  define FS_HEAP_FREE(m)        mm_free(g_fs_heap, m)
+#else
+#  define FS_HEAP_MALLOC_SIZE(m) kmm_malloc_size(m)
+#  define FS_HEAP_REALLOC(m, s)  kmm_realloc(m, s)
+#  define FS_HEAP_FREE(m)        kmm_free(m)
+#endif
+
+#define FS_HEAP_ARENA_NAMELEN 32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HEAP_ARENA
+struct fs_heap_arena_s
+{
+  FAR struct fs_heap_arena_s *flink;  /* Next arena */
+  FAR struct mm_heap_s *heap;         /* Heap placed in buf */
+  FAR void *buf;                      /* Memory taken from the kernel heap */
+  char name[FS_HEAP_ARENA_NAMELEN];   /* Name shown in /proc/meminfo */
+};
+#endif
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#if defined(CONFIG_FS_HEAPSIZE) && CONFIG_FS_HEAPSIZE > 0
 static FAR struct mm_heap_s *g_fs_heap;
+#endif
+
+#ifdef CONFIG_FS_HEAP_ARENA
+/* Arenas are only added and removed at mount and unmount time.  Lookups
+ * on free hold the lock just for the walk of the (short) list, never
+ * across the heap operation.
+ */
+
+static FAR struct fs_heap_arena_s *g_fs_arenas;
+static spinlock_t g_fs_arenas_lock = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fs_heap_owner
+ *
+ * Description:
+ *   Return the heap of the arena that 'mem' belongs to, or NULL if it was
+ *   allocated from the shared heap.  The arena can not go away while the
+ *   caller holds a block of it, so no lock is kept on return.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HEAP_ARENA
+static FAR struct mm_heap_s *fs_heap_owner(FAR void *mem)
+{
+  FAR struct fs_heap_arena_s *arena;
+  FAR struct mm_heap_s *heap = NULL;
+  irqstate_t flags;
+
+  if (mem == NULL || g_fs_arenas == NULL)
+    {
+      return NULL;
+    }
+
+  flags = spin_lock_irqsave(&g_fs_arenas_lock);
+  for (arena = g_fs_arenas; arena != NULL; arena = arena->flink)
+    {
+      if (mm_heapmember(arena->heap, mem))
+        {
+          heap = arena->heap;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_fs_arenas_lock, flags);
+  return heap;
+}
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#if defined(CONFIG_FS_HEAPSIZE) && CONFIG_FS_HEAPSIZE > 0
 void fs_heap_initialize(void)
 {
 #ifdef FS_HEAPBUF_SECTION
@@ -62,26 +148,11 @@ FAR void *fs_heap_malloc(size_t size)
   return mm_malloc(g_fs_heap, size);
 }
 
-size_t fs_heap_malloc_size(FAR void *mem)
-{
-  return mm_malloc_size(g_fs_heap, mem);
-}
-
-FAR void *fs_heap_realloc(FAR void *oldmem, size_t size)
-{
-  return mm_realloc(g_fs_heap, oldmem, size);
-}
-
 FAR void *fs_heap_memalign(size_t alignment, size_t size)
 {
   return mm_memalign(g_fs_heap, alignment, size);
 }
 
-void fs_heap_free(FAR void *mem)
-{
-  mm_free(g_fs_heap, mem);
-}
-
 FAR char *fs_heap_strdup(FAR const char *s)
 {
   size_t len = strlen(s) + 1;
@@ -143,3 +214,170 @@ struct mallinfo_task fs_heap_mallinfo_task(FAR const struct malltask *task)
 }
 
 #endif
+
+#if (defined(CONFIG_FS_HEAPSIZE) && CONFIG_FS_HEAPSIZE > 0) || \
+    defined(CONFIG_FS_HEAP_ARENA)
+size_t fs_heap_malloc_size(FAR void *mem)
+{
+#ifdef CONFIG_FS_HEAP_ARENA
+  FAR struct mm_heap_s *heap = fs_heap_owner(mem);
+
+  if (heap != NULL)
+    {
+      return mm_malloc_size(heap, mem);
+    }
+#endif
+
+  return FS_HEAP_MALLOC_SIZE(mem);
+}
+
+FAR void *fs_heap_realloc(FAR void *oldmem, size_t size)
+{
+#ifdef CONFIG_FS_HEAP_ARENA
+  FAR struct mm_heap_s *heap = fs_heap_owner(oldmem);
+
+  if (heap != NULL)
+    {
+      return mm_realloc(heap, oldmem, size);
+    }
+#endif
+
+  return FS_HEAP_REALLOC(oldmem, size);
+}
+
+void fs_heap_free(FAR void *mem)
+{
+#ifdef CONFIG_FS_HEAP_ARENA
+  FAR struct mm_heap_s *heap = fs_heap_owner(mem);
+
+  if (heap != NULL)
+    {
+      mm_free(heap, mem);
+      return;
+    }
+#endif
+
+  FS_HEAP_FREE(mem);
+}
+#endif
+
+#ifdef CONFIG_FS_HEAP_ARENA
+FAR struct fs_heap_arena_s *fs_heap_arena_create(FAR const char *name,
+                                                 size_t size, bool pool)
+{
+  FAR struct fs_heap_arena_s *arena;
+  irqstate_t flags;
+
+  arena = kmm_zalloc(sizeof(struct fs_heap_arena_s));
+  if (arena == NULL)
+    {
+      return NULL;
+    }
+
+  arena->buf = kmm_malloc(size);
+  if (arena->buf == NULL)
+    {
+      kmm_free(arena);
+      return NULL;
+    }
+
+  strlcpy(arena->name, name, sizeof(arena->name));
+
+  /* The default pool layout of mm_initialize_pool() is used when asked
+   * for, it already favours the small metadata objects of file systems.
+   */
+
+  if (pool)
+    {
+      arena->heap = mm_initialize_pool(arena->name, arena->buf, size, NULL);
+    }
+  else
+    {
+      arena->heap = mm_initialize(arena->name, arena->buf, size);
+    }
+
+  if (arena->heap == NULL)
+    {
+      kmm_free(arena->buf);
+      kmm_free(arena);
+      return NULL;
+    }
+
+  flags = spin_lock_irqsave(&g_fs_arenas_lock);
+  arena->flink = g_fs_arenas;
+  g_fs_arenas  = arena;
+  spin_unlock_irqrestore(&g_fs_arenas_lock, flags);
+
+  return arena;
+}
+
+void fs_heap_arena_destroy(FAR struct fs_heap_arena_s *arena)
+{
+  FAR struct fs_heap_arena_s **prev;
+  irqstate_t flags;
+
+  if (arena == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_fs_arenas_lock);
+  for (prev = &g_fs_arenas; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == arena)
+        {
+          *prev = arena->flink;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_fs_arenas_lock, flags);
+
+  mm_uninitialize(arena->heap);
+  kmm_free(arena->buf);
+  kmm_free(arena);
+}
+
+int fs_heap_arena_option(FAR const char *option, FAR size_t *size,
+                         FAR bool *pool)
+{
+  FAR char *end;
+
+  if (strncmp(option, "fsheap=", 7) == 0)
+    {
+      *size = strtoul(&option[7], &end, 0);
+      if (end == &option[7] || *end != '\0' || *size == 0)
+        {
+          return -EINVAL;
+        }
+
+      return 1;
+    }
+  else if (strcmp(option, "fsheap_pool") == 0)
+    {
+      *pool = true;
+      return 1;
+    }
+
+  return 0;
+}
+
+FAR void *fs_heap_arena_malloc(FAR struct fs_heap_arena_s *arena,
+                               size_t size)
+{
+  return arena ? mm_malloc(arena->heap, size) : fs_heap_malloc(size);
+}
+
+FAR void *fs_heap_arena_zalloc(FAR struct fs_heap_arena_s *arena,
+                               size_t size)
+{
+  return arena ? mm_zalloc(arena->heap, size) : fs_heap_zalloc(size);
+}
+
+FAR void *fs_heap_arena_memalign(FAR struct fs_heap_arena_s *arena,
+                                 size_t alignment, size_t size)
+{
+  return arena ? mm_memalign(arena->heap, alignment, size) :
+                 fs_heap_memalign(alignment, size);
+}
+#endif
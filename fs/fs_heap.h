@@ -35,6 +35,16 @@
 #include <stdio.h>
 #include <string.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HEAP_ARENA
+/* A private heap created for one mount, see fs_heap_arena_create() */
+
+struct fs_heap_arena_s;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -56,14 +66,91 @@ struct mallinfo_task fs_heap_mallinfo_task(FAR const struct malltask *task);
 #  define fs_heap_initialize()
 #  define fs_heap_zalloc        kmm_zalloc
 #  define fs_heap_malloc        kmm_malloc
-#  define fs_heap_malloc_size   kmm_malloc_size
-#  define fs_heap_realloc       kmm_realloc
 #  define fs_heap_memalign      kmm_memalign
-#  define fs_heap_free          kmm_free
 #  define fs_heap_mallinfo_task kmm_mallinfo_task
 #  define fs_heap_strdup        strdup
 #  define fs_heap_strndup       strndup
 #  define fs_heap_asprintf      asprintf
+
+/* Memory handed out by an arena must go back to it, so these look up the
+ * owner when arenas are enabled.
+ */
+
+#  ifdef CONFIG_FS_HEAP_ARENA
+size_t    fs_heap_malloc_size(FAR void *mem);
+FAR void *fs_heap_realloc(FAR void *oldmem, size_t size) realloc_like(2);
+void      fs_heap_free(FAR void *mem);
+#  else
+#    define fs_heap_malloc_size kmm_malloc_size
+#    define fs_heap_realloc     kmm_realloc
+#    define fs_heap_free        kmm_free
+#  endif
+#endif
+
+#ifdef CONFIG_FS_HEAP_ARENA
+
+/****************************************************************************
+ * Name: fs_heap_arena_create
+ *
+ * Description:
+ *   Create a private heap of 'size' bytes, taken from the kernel heap, for
+ *   the allocations of one mount.  It has its own lock and shows up in
+ *   /proc/meminfo under 'name'.  With 'pool' and CONFIG_MM_HEAP_MEMPOOL the
+ *   small allocations are served from per-size memory pools.
+ *
+ * Returned Value:
+ *   The new arena, or NULL if there is not enough memory.
+ *
+ ****************************************************************************/
+
+FAR struct fs_heap_arena_s *fs_heap_arena_create(FAR const char *name,
+                                                 size_t size, bool pool);
+
+/****************************************************************************
+ * Name: fs_heap_arena_destroy
+ *
+ * Description:
+ *   Release an arena.  Everything allocated from it must have been freed.
+ *   A NULL arena is ignored.
+ *
+ ****************************************************************************/
+
+void fs_heap_arena_destroy(FAR struct fs_heap_arena_s *arena);
+
+/****************************************************************************
+ * Name: fs_heap_arena_option
+ *
+ * Description:
+ *   Recognize the arena mount options of a file system:
+ *
+ *     fsheap=<n>  Serve the allocations of the mount from an arena of n
+ *                 bytes
+ *     fsheap_pool Add memory pools for small objects to the arena
+ *
+ * Returned Value:
+ *   One if 'option' was an arena option, zero if not, -EINVAL if its value
+ *   is invalid.
+ *
+ ****************************************************************************/
+
+int fs_heap_arena_option(FAR const char *option, FAR size_t *size,
+                         FAR bool *pool);
+
+/* Allocate from 'arena', or from the shared file system heap if it is
+ * NULL.  Release with fs_heap_free() as usual.
+ */
+
+FAR void *fs_heap_arena_malloc(FAR struct fs_heap_arena_s *arena,
+                               size_t size) malloc_like1(2);
+FAR void *fs_heap_arena_zalloc(FAR struct fs_heap_arena_s *arena,
+                               size_t size) malloc_like1(2);
+FAR void *fs_heap_arena_memalign(FAR struct fs_heap_arena_s *arena,
+                                 size_t alignment, size_t size)
+                                 malloc_like1(3);
+#else
+#  define fs_heap_arena_malloc(a, s)      fs_heap_malloc(s)
+#  define fs_heap_arena_zalloc(a, s)      fs_heap_zalloc(s)
+#  define fs_heap_arena_memalign(a, l, s) fs_heap_memalign(l, s)
 #endif
 
 #endif
@@ -38,6 +38,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -63,6 +64,15 @@ struct hostfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+#if CONFIG_FS_HOSTFS_READDIR_BATCH > 0
+  int count;                     /* Number of entries in entries[] */
+  int index;                     /* Next entry of entries[] to return */
+  struct dirent entries[CONFIG_FS_HOSTFS_READDIR_BATCH];
+  struct stat bufs[CONFIG_FS_HOSTFS_READDIR_BATCH];
+#  if CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+  char path[HOSTFS_MAX_PATH];    /* Host path of the directory */
+#  endif
+#endif
 };
 
 /****************************************************************************
@@ -240,6 +250,106 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+/****************************************************************************
+ * Name: hostfs_statcache_entry
+ *
+ * Description: Return the stat cache entry that a host path maps to.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+static FAR struct hostfs_statcache_s *
+hostfs_statcache_entry(FAR struct hostfs_mountpt_s *fs,
+                       FAR const char *path)
+{
+  uint32_t hash = 0;
+
+  while (*path != '\0')
+    {
+      hash = hash * 31 + (uint8_t)*path++;
+    }
+
+  return &fs->fs_stats[hash % CONFIG_FS_HOSTFS_STATCACHE_ENTRIES];
+}
+
+/****************************************************************************
+ * Name: hostfs_statcache_lookup
+ *
+ * Description:
+ *   Look up the attributes of a host path in the stat cache.  Returns
+ *   true if an unexpired entry was found.  Called with g_lock held.
+ *
+ ****************************************************************************/
+
+static bool hostfs_statcache_lookup(FAR struct hostfs_mountpt_s *fs,
+                                    FAR const char *path,
+                                    FAR struct stat *buf)
+{
+  FAR struct hostfs_statcache_s *entry = hostfs_statcache_entry(fs, path);
+
+  if (entry->path != NULL && strcmp(entry->path, path) == 0 &&
+      (sclock_t)(entry->expire - clock_systime_ticks()) > 0)
+    {
+      memcpy(buf, &entry->buf, sizeof(struct stat));
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: hostfs_statcache_store
+ *
+ * Description:
+ *   Save the attributes of a host path in the stat cache, replacing the
+ *   path that used the entry before.  Called with g_lock held.
+ *
+ ****************************************************************************/
+
+static void hostfs_statcache_store(FAR struct hostfs_mountpt_s *fs,
+                                   FAR const char *path,
+                                   FAR const struct stat *buf)
+{
+  FAR struct hostfs_statcache_s *entry = hostfs_statcache_entry(fs, path);
+
+  if (entry->path == NULL || strcmp(entry->path, path) != 0)
+    {
+      fs_heap_free(entry->path);
+      entry->path = fs_heap_strdup(path);
+      if (entry->path == NULL)
+        {
+          return;
+        }
+    }
+
+  memcpy(&entry->buf, buf, sizeof(struct stat));
+  entry->expire = clock_systime_ticks() +
+                  MSEC2TICK(CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT);
+}
+
+/****************************************************************************
+ * Name: hostfs_statcache_flush
+ *
+ * Description:
+ *   Drop the whole stat cache.  Called with g_lock held on every change
+ *   made through the mount point.
+ *
+ ****************************************************************************/
+
+static void hostfs_statcache_flush(FAR struct hostfs_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_STATCACHE_ENTRIES; i++)
+    {
+      fs_heap_free(fs->fs_stats[i].path);
+      fs->fs_stats[i].path = NULL;
+    }
+}
+#else
+#  define hostfs_statcache_flush(fs)
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -289,6 +399,11 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
 
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_statcache_flush(fs);
+    }
+
   /* Try to open the file in the host file system */
 
   hf->fd = host_open(path, oflags, mode);
@@ -528,6 +643,7 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
   if (ret > 0)
     {
       filep->f_pos += ret;
+      hostfs_statcache_flush(fs);
     }
 
 errout_with_lock:
@@ -794,6 +910,7 @@ static int hostfs_fchstat(FAR const struct file *filep,
   /* Call the host to perform the change */
 
   ret = host_fchstat(hf->fd, buf, flags);
+  hostfs_statcache_flush(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -835,6 +952,7 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
   /* Call the host to perform the truncate */
 
   ret = host_ftruncate(hf->fd, length);
+  hostfs_statcache_flush(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -889,6 +1007,17 @@ static int hostfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_lock;
     }
 
+#if CONFIG_FS_HOSTFS_READDIR_BATCH > 0 && \
+    CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+  /* Keep the directory path to cache the attributes of its entries */
+
+  strlcpy(hdir->path, path, sizeof(hdir->path));
+  if (hdir->path[strlen(hdir->path) - 1] != '/')
+    {
+      strlcat(hdir->path, "/", sizeof(hdir->path));
+    }
+#endif
+
   *dir = (FAR struct fs_dirent_s *)hdir;
   nxmutex_unlock(&g_lock);
   return OK;
@@ -969,9 +1098,47 @@ static int hostfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_READDIR_BATCH > 0
+  /* Refill the entry buffer with a single host call */
+
+  if (hdir->index >= hdir->count)
+    {
+      ret = host_readdir_batch(hdir->dir, hdir->entries, hdir->bufs,
+                               CONFIG_FS_HOSTFS_READDIR_BATCH);
+      if (ret <= 0)
+        {
+          nxmutex_unlock(&g_lock);
+          return ret < 0 ? ret : -ENOENT;
+        }
+
+      hdir->count = ret;
+      hdir->index = 0;
+
+#  if CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+      /* A traversal usually stats the entries it has just listed */
+
+      for (ret = 0; ret < hdir->count; ret++)
+        {
+          char path[HOSTFS_MAX_PATH];
+
+          if (hdir->bufs[ret].st_mode != 0)
+            {
+              strlcpy(path, hdir->path, sizeof(path));
+              strlcat(path, hdir->entries[ret].d_name, sizeof(path));
+              hostfs_statcache_store(mountpt->i_private, path,
+                                     &hdir->bufs[ret]);
+            }
+        }
+#  endif
+    }
+
+  memcpy(entry, &hdir->entries[hdir->index++], sizeof(struct dirent));
+  ret = OK;
+#else
   /* Call the host OS's readdir function */
 
   ret = host_readdir(hdir->dir, entry);
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1009,6 +1176,10 @@ static int hostfs_rewinddir(FAR struct inode *mountpt,
   /* Call the host and let it do all the work */
 
   host_rewinddir(hdir->dir);
+#if CONFIG_FS_HOSTFS_READDIR_BATCH > 0
+  hdir->count = 0;
+  hdir->index = 0;
+#endif
 
   nxmutex_unlock(&g_lock);
   return OK;
@@ -1154,6 +1325,7 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return (flags != 0) ? -ENOSYS : -EBUSY;
     }
 
+  hostfs_statcache_flush(fs);
   nxmutex_unlock(&g_lock);
   fs_heap_free(fs);
   return ret;
@@ -1228,6 +1400,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_statcache_flush(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1268,6 +1441,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_statcache_flush(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1309,6 +1483,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_statcache_flush(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1353,6 +1528,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_statcache_flush(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1392,7 +1568,21 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
+#if CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+  if (hostfs_statcache_lookup(fs, path, buf))
+    {
+      nxmutex_unlock(&g_lock);
+      return OK;
+    }
+#endif
+
   ret = host_stat(path, buf);
+#if CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+  if (ret >= 0)
+    {
+      hostfs_statcache_store(fs, path, buf);
+    }
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1433,6 +1623,7 @@ static int hostfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the chstat operation */
 
   ret = host_chstat(path, buf, flags);
+  hostfs_statcache_flush(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
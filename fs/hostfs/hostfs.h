@@ -30,8 +30,10 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -56,6 +58,17 @@ struct hostfs_ofile_s
   char                      relpath[1];
 };
 
+/* One cached result of host_stat(), keyed by the host path */
+
+#if CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+struct hostfs_statcache_s
+{
+  FAR char                 *path;    /* Host path, NULL if unused */
+  clock_t                   expire;  /* Tick count when the entry expires */
+  struct stat               buf;     /* The cached attributes */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a hostfs filesystem.
@@ -65,6 +78,9 @@ struct hostfs_mountpt_s
 {
   FAR struct hostfs_ofile_s *fs_head;      /* A singly-linked list of open files */
   char                       fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT > 0
+  struct hostfs_statcache_s  fs_stats[CONFIG_FS_HOSTFS_STATCACHE_ENTRIES];
+#endif
 };
 
 /****************************************************************************
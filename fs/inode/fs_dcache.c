@@ -0,0 +1,211 @@
+/****************************************************************************
+ * fs/inode/fs_dcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/spinlock.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_DCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_FS_DCACHE_NENTRIES & (CONFIG_FS_DCACHE_NENTRIES - 1)) != 0
+#  error CONFIG_FS_DCACHE_NENTRIES must be a power of two
+#endif
+
+#if CONFIG_FS_DCACHE_NAMELEN > UINT8_MAX
+#  error CONFIG_FS_DCACHE_NAMELEN must not exceed 255
+#endif
+
+#define DCACHE_MASK (CONFIG_FS_DCACHE_NENTRIES - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dcache_entry_s
+{
+  FAR const void *parent;     /* Directory that was searched */
+  FAR void       *node;       /* Object found, NULL for a negative entry */
+  FAR void       *aux;        /* Caller defined companion value */
+  uint32_t        hash;       /* Hash of the parent and the name */
+  uint8_t         len;        /* Length of the name, zero if unused */
+  char            name[CONFIG_FS_DCACHE_NAMELEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dcache_entry_s g_dcache[CONFIG_FS_DCACHE_NENTRIES];
+static spinlock_t g_dcache_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_hash
+ *
+ * Description:
+ *   FNV-1a hash of the name, seeded with the address of the parent.
+ *
+ ****************************************************************************/
+
+static uint32_t dcache_hash(FAR const void *parent, FAR const char *name,
+                            size_t len)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)(uintptr_t)parent;
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      hash ^= (uint8_t)name[i];
+      hash *= 16777619u;
+    }
+
+  return hash ^ (hash >> 16);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_lookup
+ *
+ * Description:
+ *   Look up the path component 'name' of length 'len' below 'parent'.
+ *
+ ****************************************************************************/
+
+bool dcache_lookup(FAR const void *parent, FAR const char *name, size_t len,
+                   FAR void **node, FAR void **aux)
+{
+  FAR struct dcache_entry_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  bool found = false;
+
+  if (len == 0 || len > CONFIG_FS_DCACHE_NAMELEN)
+    {
+      return false;
+    }
+
+  hash  = dcache_hash(parent, name, len);
+  entry = &g_dcache[hash & DCACHE_MASK];
+
+  flags = spin_lock_irqsave(&g_dcache_lock);
+  if (entry->len == len && entry->hash == hash && entry->parent == parent &&
+      memcmp(entry->name, name, len) == 0)
+    {
+      *node = entry->node;
+      if (aux != NULL)
+        {
+          *aux = entry->aux;
+        }
+
+      found = true;
+    }
+
+  spin_unlock_irqrestore(&g_dcache_lock, flags);
+  return found;
+}
+
+/****************************************************************************
+ * Name: dcache_insert
+ *
+ * Description:
+ *   Remember the result of looking up 'name' below 'parent', replacing
+ *   whatever occupied the slot before.
+ *
+ ****************************************************************************/
+
+void dcache_insert(FAR const void *parent, FAR const char *name, size_t len,
+                   FAR void *node, FAR void *aux)
+{
+  FAR struct dcache_entry_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+
+  if (len == 0 || len > CONFIG_FS_DCACHE_NAMELEN)
+    {
+      return;
+    }
+
+  hash  = dcache_hash(parent, name, len);
+  entry = &g_dcache[hash & DCACHE_MASK];
+
+  flags = spin_lock_irqsave(&g_dcache_lock);
+  entry->parent = parent;
+  entry->node   = node;
+  entry->aux    = aux;
+  entry->hash   = hash;
+  entry->len    = len;
+  memcpy(entry->name, name, len);
+  spin_unlock_irqrestore(&g_dcache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: dcache_purge
+ *
+ * Description:
+ *   Drop every entry below the directory object 'key' and every entry that
+ *   refers to 'key'.
+ *
+ ****************************************************************************/
+
+void dcache_purge(FAR const void *key)
+{
+  FAR struct dcache_entry_s *entry;
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_dcache_lock);
+  for (i = 0; i < CONFIG_FS_DCACHE_NENTRIES; i++)
+    {
+      entry = &g_dcache[i];
+      if (entry->len != 0 &&
+          (entry->parent == key ||
+           (key != NULL && (entry->node == key || entry->aux == key))))
+        {
+          entry->len = 0;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_dcache_lock, flags);
+}
+
+#endif /* CONFIG_FS_DCACHE */
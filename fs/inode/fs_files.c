@@ -41,6 +41,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/rcu.h>
 #include <nuttx/sched.h>
 #include <nuttx/spawn.h>
 #include <nuttx/spinlock.h>
@@ -62,6 +63,33 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: files_tryref
+ *
+ * Description:
+ *   Take a reference on the file unless the count already dropped to zero,
+ *   i.e. unless the file is being closed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_REFCOUNT
+static bool files_tryref(FAR struct file *filep)
+{
+  int refs = atomic_load(&filep->f_refs);
+
+  do
+    {
+      if (refs == 0)
+        {
+          return false;
+        }
+    }
+  while (!atomic_compare_exchange_weak(&filep->f_refs, &refs, refs + 1));
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: files_fget_by_index
  ****************************************************************************/
@@ -72,38 +100,53 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
   FAR struct file *filep;
   irqstate_t flags;
 
-  flags = spin_lock_irqsave(NULL);
+  /* files_extend() may replace the array of rows at any time, but frees
+   * the old array only after a grace period, so a read-side section is
+   * all that is needed to index it.  The rows themselves never move.  The
+   * barrier orders the caller's load of fl_rows before that of fl_files,
+   * which files_extend() publishes in the opposite order.
+   */
+
+  flags = rcu_read_lock();
+  RCU_RMB();
+  filep = &rcu_dereference(list->fl_files)[l1][l2];
+  rcu_read_unlock(flags);
 
-  filep = &list->fl_files[l1][l2];
 #ifdef CONFIG_FS_REFCOUNT
-  if (filep->f_inode != NULL)
+  if (new == NULL)
     {
       /* When the reference count is zero but the inode has not yet been
        * released, At this point we should return a null pointer
        */
 
-      if (filep->f_refs == 0)
+      if (filep->f_inode == NULL || !files_tryref(filep))
         {
           filep = NULL;
         }
-      else
-        {
-          filep->f_refs++;
-        }
-    }
-  else if (new == NULL)
-    {
-      filep = NULL;
+
+      return filep;
     }
-  else if (filep->f_refs)
+
+  /* Reserving a descriptor for dup2() is rare: stay serialized against
+   * file_allocate_from_tcb() claiming the same entry.
+   */
+
+  flags = spin_lock_irqsave(NULL);
+
+  if (filep->f_inode != NULL)
     {
-      filep->f_refs++;
+      if (!files_tryref(filep))
+        {
+          filep = NULL;
+        }
     }
-  else
+  else if (!files_tryref(filep))
     {
-      filep->f_refs = 2;
+      atomic_store(&filep->f_refs, 2);
       *new = true;
     }
+
+  spin_unlock_irqrestore(NULL, flags);
 #else
   if (filep->f_inode == NULL && new == NULL)
     {
@@ -111,7 +154,6 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
     }
 #endif
 
-  spin_unlock_irqrestore(NULL, flags);
   return filep;
 }
 
@@ -192,14 +234,21 @@ static int files_extend(FAR struct filelist *list, size_t row)
              list->fl_rows * sizeof(FAR struct file *));
     }
 
+  /* Publish the new array before the new row count: a lockless reader
+   * that sees the larger count then also sees the larger array.
+   */
+
   tmp = list->fl_files;
-  list->fl_files = files;
-  list->fl_rows = row;
+  rcu_assign_pointer(list->fl_files, files);
+  rcu_assign_pointer(list->fl_rows, row);
 
   spin_unlock_irqrestore(NULL, flags);
 
   if (tmp != NULL)
     {
+      /* Wait for the readers that may still be indexing the old array */
+
+      synchronize_rcu();
       fs_heap_free(tmp);
     }
 
@@ -603,8 +652,11 @@ int file_allocate_from_tcb(FAR struct tcb_s *tcb, FAR struct inode *inode,
               filep->f_pos         = pos;
               filep->f_inode       = inode;
               filep->f_priv        = priv;
+#ifdef CONFIG_FS_READAHEAD
+              filep->f_ra          = NULL;
+#endif
 #ifdef CONFIG_FS_REFCOUNT
-              filep->f_refs        = 1;
+              atomic_store(&filep->f_refs, 1);
 #endif
 #ifdef CONFIG_FDSAN
               filep->f_tag_fdsan   = 0;
@@ -612,6 +664,9 @@ int file_allocate_from_tcb(FAR struct tcb_s *tcb, FAR struct inode *inode,
 #ifdef CONFIG_FDCHECK
               filep->f_tag_fdcheck = 0;
 #endif
+#ifdef CONFIG_FS_NOTIFY
+              filep->f_notify_gen  = 0;
+#endif
 
               goto found;
             }
@@ -753,6 +808,99 @@ int files_duplist(FAR struct filelist *plist, FAR struct filelist *clist,
   return OK;
 }
 
+/****************************************************************************
+ * Name: files_dupactions
+ *
+ * Description:
+ *   Duplicate the parent's descriptors that file actions dup2() from.
+ *
+ ****************************************************************************/
+
+int files_dupactions(FAR struct filelist *plist, FAR struct filelist *clist,
+                     FAR const posix_spawn_file_actions_t *actions)
+{
+  FAR struct spawn_general_file_action_s *entry;
+  FAR struct file *filep2;
+  FAR struct file *filep;
+  bool new;
+  int ret;
+  int fd;
+  int i;
+  int j;
+
+  for (entry = (FAR struct spawn_general_file_action_s *)actions;
+       entry != NULL;
+       entry = entry->flink)
+    {
+      if (entry->action != SPAWN_FILE_ACTION_DUP2)
+        {
+          continue;
+        }
+
+      fd = ((FAR struct spawn_dup2_file_action_s *)entry)->fd1;
+#ifdef CONFIG_FDCHECK
+      fd = fdcheck_restore(fd);
+#endif
+
+      /* A bad descriptor is left to fail in the dup2 action itself */
+
+      if (fd < 0)
+        {
+          continue;
+        }
+
+      i = fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+      j = fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+      if (i >= plist->fl_rows)
+        {
+          continue;
+        }
+
+      filep = files_fget_by_index(plist, i, j, NULL);
+      if (filep == NULL)
+        {
+          continue;
+        }
+
+      ret = files_extend(clist, i + 1);
+      if (ret < 0)
+        {
+          fs_putfilep(filep);
+          return ret;
+        }
+
+      /* Several actions may dup2() from the same descriptor */
+
+      new = false;
+      filep2 = files_fget_by_index(clist, i, j, &new);
+      if (filep2 == NULL || filep2->f_inode != NULL)
+        {
+          if (filep2 != NULL)
+            {
+              fs_putfilep(filep2);
+            }
+
+          fs_putfilep(filep);
+          continue;
+        }
+
+      ret = file_dup2(filep, filep2);
+      fs_putfilep(filep2);
+      fs_putfilep(filep);
+      if (ret < 0)
+        {
+          if (new)
+            {
+              fs_putfilep(filep2);
+            }
+
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: fs_getfilep
  *
@@ -834,12 +982,8 @@ void fs_reffilep(FAR struct file *filep)
 {
   /* This interface is used to increase the reference count of filep */
 
-  irqstate_t flags;
-
   DEBUGASSERT(filep);
-  flags = spin_lock_irqsave(NULL);
-  filep->f_refs++;
-  spin_unlock_irqrestore(NULL, flags);
+  atomic_fetch_add(&filep->f_refs, 1);
 }
 
 /****************************************************************************
@@ -856,16 +1000,12 @@ void fs_reffilep(FAR struct file *filep)
 
 int fs_putfilep(FAR struct file *filep)
 {
-  irqstate_t flags;
   int ret = 0;
   int refs;
 
   DEBUGASSERT(filep);
-  flags = spin_lock_irqsave(NULL);
-
-  refs = --filep->f_refs;
 
-  spin_unlock_irqrestore(NULL, flags);
+  refs = atomic_fetch_sub(&filep->f_refs, 1) - 1;
 
   /* If refs is zero, the close() had called, closing it now. */
 
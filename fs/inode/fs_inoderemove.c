@@ -98,6 +98,11 @@ static FAR struct inode *inode_unlink(FAR const char *path)
 
       inode->i_peer   = NULL;
       inode->i_parent = NULL;
+
+      /* Forget the cached lookups below the parent and the inode */
+
+      dcache_purge(desc.parent);
+      dcache_purge(inode);
       atomic_fetch_sub(&inode->i_crefs, 1);
     }
 
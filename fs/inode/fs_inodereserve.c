@@ -109,6 +109,10 @@ static void inode_insert(FAR struct inode *inode,
                          FAR struct inode *peer,
                          FAR struct inode *parent)
 {
+  /* The cached lookups below the parent are no longer valid */
+
+  dcache_purge(parent);
+
   /* If peer is non-null, then new node simply goes to the right
    * of that peer node.
    */
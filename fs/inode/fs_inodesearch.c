@@ -43,6 +43,12 @@
  ****************************************************************************/
 
 static int _inode_compare(FAR const char *fname, FAR struct inode *inode);
+#ifdef CONFIG_FS_DCACHE
+static FAR struct inode *_inode_lookup(FAR const char *name,
+                                       FAR struct inode *parent,
+                                       FAR struct inode *inode,
+                                       FAR struct inode **peer);
+#endif
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
 static int _inode_linktarget(FAR struct inode *inode,
                              FAR struct inode_search_s *desc);
@@ -131,6 +137,63 @@ static int _inode_compare(FAR const char *fname, FAR struct inode *inode)
     }
 }
 
+/****************************************************************************
+ * Name: _inode_lookup
+ *
+ * Description:
+ *   Find the node matching the first segment of 'name' among 'inode' and
+ *   its peers below 'parent', consulting the path component cache first.
+ *   The node to the "left" of the match, or of the position where the name
+ *   would be inserted, is returned in 'peer'.  Both are cached, so that
+ *   negative lookups are just as cheap as positive ones.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+static FAR struct inode *_inode_lookup(FAR const char *name,
+                                       FAR struct inode *parent,
+                                       FAR struct inode *inode,
+                                       FAR struct inode **peer)
+{
+  FAR struct inode *left = NULL;
+  FAR void *node;
+  FAR void *aux;
+  size_t len;
+
+  len = strcspn(name, "/");
+  if (dcache_lookup(parent, name, len, &node, &aux))
+    {
+      *peer = aux;
+      return node;
+    }
+
+  while (inode != NULL)
+    {
+      int result = _inode_compare(name, inode);
+
+      if (result < 0)
+        {
+          inode = NULL;
+        }
+      else if (result > 0)
+        {
+          left  = inode;
+          inode = inode->i_peer;
+          continue;
+        }
+
+      break;
+    }
+
+  dcache_insert(parent, name, len, inode, left);
+  *peer = left;
+  return inode;
+}
+#endif
+
 /****************************************************************************
  * Name: _inode_linktarget
  *
@@ -242,7 +305,24 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (inode != NULL)
     {
-      int result = _inode_compare(name, inode);
+      int result;
+
+#ifdef CONFIG_FS_DCACHE
+      /* At the first peer of each level, let the path component cache find
+       * the matching node (and the node to its left), if any.
+       */
+
+      if (left == NULL)
+        {
+          inode = _inode_lookup(name, above, inode, &left);
+          if (inode == NULL)
+            {
+              break;
+            }
+        }
+#endif
+
+      result = _inode_compare(name, inode);
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
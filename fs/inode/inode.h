@@ -89,6 +89,12 @@
 #  define FS_ADD_BACKTRACE(filep)
 #endif
 
+#ifndef CONFIG_FS_DCACHE
+#  define dcache_lookup(p,n,l,o,a) ((void)(o), (void)(a), false)
+#  define dcache_insert(p,n,l,o,a)
+#  define dcache_purge(k)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -463,6 +469,60 @@ int pseudofile_create(FAR struct inode **node, FAR const char *path,
 bool inode_is_pseudofile(FAR struct inode *inode);
 #endif
 
+/****************************************************************************
+ * Name: dcache_lookup
+ *
+ * Description:
+ *   Look up the path component 'name' of length 'len' below 'parent' in
+ *   the path component cache.  The cache is shared by the pseudo file
+ *   system tree and by any file system that wants to use it; the keys are
+ *   simply the addresses of the caller's directory objects.
+ *
+ * Input Parameters:
+ *   parent - The directory object that is searched (may be NULL)
+ *   name   - The path component, not necessarily NUL terminated
+ *   len    - The length of the path component
+ *   node   - The location to return the cached object.  NULL is returned
+ *            for a negative entry, i.e. a name known not to exist.
+ *   aux    - The location to return the caller defined companion value
+ *            saved with the entry.  May be NULL.
+ *
+ * Returned Value:
+ *   true if the cache holds an entry (positive or negative) for the name.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+bool dcache_lookup(FAR const void *parent, FAR const char *name, size_t len,
+                   FAR void **node, FAR void **aux);
+
+/****************************************************************************
+ * Name: dcache_insert
+ *
+ * Description:
+ *   Remember the result of looking up 'name' below 'parent'.  A NULL
+ *   'node' records a negative entry.  Names longer than
+ *   CONFIG_FS_DCACHE_NAMELEN are not cached.
+ *
+ ****************************************************************************/
+
+void dcache_insert(FAR const void *parent, FAR const char *name, size_t len,
+                   FAR void *node, FAR void *aux);
+
+/****************************************************************************
+ * Name: dcache_purge
+ *
+ * Description:
+ *   Drop every entry below the directory object 'key' and every entry that
+ *   refers to 'key'.  Must be called whenever a name is added to or removed
+ *   from a directory (with the directory as key) and before an object that
+ *   may be cached is freed (with the object as key).
+ *
+ ****************************************************************************/
+
+void dcache_purge(FAR const void *key);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
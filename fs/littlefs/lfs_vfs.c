@@ -28,8 +28,11 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <nuttx/fs/blockcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
@@ -66,6 +69,9 @@ struct littlefs_file_s
 {
   struct lfs_file       file;
   int                   refs;
+#ifdef CONFIG_FS_HEAP_ARENA
+  struct lfs_file_config cfg;
+#endif
 };
 
 /* This structure represents the overall mountpoint state. An instance of
@@ -80,6 +86,9 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+#ifdef CONFIG_FS_HEAP_ARENA
+  FAR struct fs_heap_arena_s *arena;
+#endif
 };
 
 struct littlefs_attr_s
@@ -318,6 +327,7 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct littlefs_mountpt_s *fs;
   FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
+  size_t size = sizeof(*priv);
   int ret;
 
   /* Get the mountpoint inode reference from the file structure and the
@@ -327,15 +337,33 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
   inode = filep->f_inode;
   fs    = inode->i_private;
 
+#ifdef CONFIG_FS_HEAP_ARENA
+  /* With an arena the file cache follows the file, so that littlefs does
+   * not take it from the shared heap.
+   */
+
+  if (fs->arena != NULL)
+    {
+      size += fs->cfg.cache_size;
+    }
+#endif
+
   /* Allocate memory for the open file */
 
-  priv = fs_heap_malloc(sizeof(*priv));
+  priv = fs_heap_arena_malloc(fs->arena, size);
   if (priv == NULL)
     {
       return -ENOMEM;
     }
 
   priv->refs = 1;
+#ifdef CONFIG_FS_HEAP_ARENA
+  memset(&priv->cfg, 0, sizeof(priv->cfg));
+  if (fs->arena != NULL)
+    {
+      priv->cfg.buffer = priv + 1;
+    }
+#endif
 
   /* Lock */
 
@@ -348,8 +376,14 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
   /* Try to open the file */
 
   oflags = littlefs_convert_oflags(oflags);
+#ifdef CONFIG_FS_HEAP_ARENA
+  ret = littlefs_convert_result(lfs_file_opencfg(&fs->lfs, &priv->file,
+                                                 relpath, oflags,
+                                                 &priv->cfg));
+#else
   ret = littlefs_convert_result(lfs_file_open(&fs->lfs, &priv->file,
                                               relpath, oflags));
+#endif
   if (ret < 0)
     {
       /* Error opening file */
@@ -938,7 +972,7 @@ static int littlefs_opendir(FAR struct inode *mountpt,
 
   /* Allocate memory for the open directory */
 
-  ldir = fs_heap_malloc(sizeof(*ldir));
+  ldir = fs_heap_arena_malloc(fs->arena, sizeof(*ldir));
   if (ldir == NULL)
     {
       return -ENOMEM;
@@ -1119,7 +1153,7 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
     }
   else
     {
-      ret = drv->u.i_bops->read(drv, buffer, block, size);
+      ret = blockcache_read(drv, buffer, block, size, geo->blocksize);
     }
 
   return ret >= 0 ? OK : ret;
@@ -1147,7 +1181,7 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
     }
   else
     {
-      ret = drv->u.i_bops->write(drv, buffer, block, size);
+      ret = blockcache_write(drv, buffer, block, size, geo->blocksize);
     }
 
   return ret >= 0 ? OK : ret;
@@ -1192,6 +1226,12 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
     }
   else
     {
+      ret = blockcache_flush(drv);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       if (drv->u.i_bops->ioctl != NULL)
         {
           ret = drv->u.i_bops->ioctl(drv, BIOC_FLUSH, 0);
@@ -1205,6 +1245,136 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parse_options
+ *
+ * Description:
+ *   Parse the comma separated mount options:
+ *
+ *     forceformat         Format the device before mounting it
+ *     autoformat          Format the device if it cannot be mounted
+ *     cache_size=<n>      Bytes in the read, program and each file cache
+ *     lookahead_size=<n>  Bytes in the block allocator bitmap
+ *     block_cycles=<n>    Erases before metadata is relocated, -1 disables
+ *     fsheap=<n>          Allocate for this mount from an own n byte arena
+ *     fsheap_pool         Serve small objects of the arena from mempools
+ *
+ *   The options that are not given keep the Kconfig defaults, so that a
+ *   large data partition and a small configuration partition can be tuned
+ *   independently.  Unknown options are ignored.
+ *
+ ****************************************************************************/
+
+static int littlefs_parse_options(FAR struct littlefs_mountpt_s *fs,
+                                  FAR const char *data,
+                                  FAR bool *forceformat,
+                                  FAR bool *autoformat)
+{
+  FAR struct lfs_config *cfg = &fs->cfg;
+  FAR char *options;
+  FAR char *saveptr;
+  FAR char *ptr;
+#ifdef CONFIG_FS_HEAP_ARENA
+  size_t heapsize = 0;
+  bool heappool = false;
+#endif
+  int ret = OK;
+
+  *forceformat = false;
+  *autoformat  = false;
+
+  if (data == NULL)
+    {
+      return OK;
+    }
+
+  options = fs_heap_strdup(data);
+  if (options == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ptr = strtok_r(options, ",", &saveptr);
+  while (ptr != NULL && ret == OK)
+    {
+      if (strcmp(ptr, "forceformat") == 0)
+        {
+          *forceformat = true;
+        }
+      else if (strcmp(ptr, "autoformat") == 0)
+        {
+          *autoformat = true;
+        }
+      else if (strncmp(ptr, "cache_size=", 11) == 0)
+        {
+          /* littlefs requires a multiple of the read and program sizes
+           * that divides the block size.
+           */
+
+          cfg->cache_size = strtoul(&ptr[11], NULL, 0);
+          if (cfg->cache_size == 0 ||
+              cfg->cache_size % cfg->read_size != 0 ||
+              cfg->cache_size % cfg->prog_size != 0 ||
+              cfg->block_size % cfg->cache_size != 0)
+            {
+              ret = -EINVAL;
+            }
+        }
+      else if (strncmp(ptr, "lookahead_size=", 15) == 0)
+        {
+          cfg->lookahead_size = strtoul(&ptr[15], NULL, 0);
+          if (cfg->lookahead_size == 0 || cfg->lookahead_size % 8 != 0)
+            {
+              ret = -EINVAL;
+            }
+        }
+      else if (strncmp(ptr, "block_cycles=", 13) == 0)
+        {
+          cfg->block_cycles = strtol(&ptr[13], NULL, 0);
+          if (cfg->block_cycles == 0)
+            {
+              ret = -EINVAL;
+            }
+        }
+#ifdef CONFIG_FS_HEAP_ARENA
+      else if (strncmp(ptr, "fsheap", 6) == 0)
+        {
+          ret = fs_heap_arena_option(ptr, &heapsize, &heappool) > 0 ?
+                OK : -EINVAL;
+        }
+#endif
+      else
+        {
+          fwarn("WARNING: Ignoring mount option '%s'\n", ptr);
+        }
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Invalid mount option '%s'\n", ptr);
+        }
+
+      ptr = strtok_r(NULL, ",", &saveptr);
+    }
+
+  fs_heap_free(options);
+
+#ifdef CONFIG_FS_HEAP_ARENA
+  if (ret >= 0 && heapsize > 0)
+    {
+      char name[32];
+
+      snprintf(name, sizeof(name), "lfs:%s", fs->drv->i_name);
+      fs->arena = fs_heap_arena_create(name, heapsize, heappool);
+      if (fs->arena == NULL)
+        {
+          ret = -ENOMEM;
+        }
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -1213,6 +1383,8 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  bool forceformat;
+  bool autoformat;
   int ret;
 
   /* Open the block driver */
@@ -1313,13 +1485,45 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+  /* Let the mount options override the defaults */
+
+  ret = littlefs_parse_options(fs, data, &forceformat, &autoformat);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
+#ifdef CONFIG_FS_HEAP_ARENA
+  /* Take the lookahead bitmap and the read and program caches from the
+   * arena as well.  littlefs leaves buffers it was given to the caller.
+   */
+
+  if (fs->arena != NULL)
+    {
+      FAR uint8_t *buf;
+
+      buf = fs_heap_arena_malloc(fs->arena, fs->cfg.lookahead_size +
+                                 2 * fs->cfg.cache_size);
+      if (buf == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_fs;
+        }
+
+      fs->cfg.lookahead_buffer = buf;
+      fs->cfg.read_buffer      = buf + fs->cfg.lookahead_size;
+      fs->cfg.prog_buffer      = buf + fs->cfg.lookahead_size +
+                                 fs->cfg.cache_size;
+    }
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if (forceformat)
     {
       ret = littlefs_convert_result(lfs_format(&fs->lfs, &fs->cfg));
       if (ret < 0)
@@ -1333,7 +1537,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != -EFAULT || !data || strcmp(data, "autoformat"))
+      if (ret != -EFAULT || !autoformat)
         {
           goto errout_with_fs;
         }
@@ -1357,6 +1561,10 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#ifdef CONFIG_FS_HEAP_ARENA
+  fs_heap_free(fs->cfg.lookahead_buffer);
+  fs_heap_arena_destroy(fs->arena);
+#endif
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1396,7 +1604,15 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
   if (ret >= 0)
     {
-      /* Close the block driver */
+      /* Write back and drop any cached sectors, then close the block
+       * driver.
+       */
+
+      if (INODE_IS_BLOCK(drv))
+        {
+          blockcache_flush(drv);
+          blockcache_invalidate(drv);
+        }
 
       if (INODE_IS_BLOCK(drv) && drv->u.i_bops->close)
         {
@@ -1416,6 +1632,10 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#ifdef CONFIG_FS_HEAP_ARENA
+      fs_heap_free(fs->cfg.lookahead_buffer);
+      fs_heap_arena_destroy(fs->arena);
+#endif
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
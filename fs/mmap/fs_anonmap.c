@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
+#include <sys/mman.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -38,6 +39,32 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: anonmap_alloc
+ *
+ * Description:
+ *   Allocate the memory of an anonymous mapping.  The memory is left
+ *   uninitialized:  file_mmap_() clears it unless MAP_UNINITIALIZED was
+ *   requested, so it is written only once.
+ *
+ ****************************************************************************/
+
+static FAR void *anonmap_alloc(FAR struct mm_map_entry_s *entry,
+                               bool kernel)
+{
+#if CONFIG_FS_ANONMAP_HUGEPAGE_SIZE > 0
+  if ((entry->flags & MAP_HUGETLB) != 0)
+    {
+      return kernel ?
+        fs_heap_memalign(CONFIG_FS_ANONMAP_HUGEPAGE_SIZE, entry->length) :
+        kumm_memalign(CONFIG_FS_ANONMAP_HUGEPAGE_SIZE, entry->length);
+    }
+#endif
+
+  return kernel ?
+    fs_heap_malloc(entry->length) : kumm_malloc(entry->length);
+}
+
 /****************************************************************************
  * Name: unmap_anonymous
  ****************************************************************************/
@@ -127,10 +154,12 @@ int map_anonymous(FAR struct mm_map_entry_s *entry, bool kernel)
    * only purpose of MAP_ANONYMOUS:  To get non-heap memory.  In KERNEL
    * build, this could be accomplished using pgalloc(), provided that
    * you had logic in place to assign a virtual address to the mapping.
+   *
+   * Heap memory is always resident, so MAP_POPULATE needs no extra work:
+   * the mapping is fully populated when it is returned.
    */
 
-  entry->vaddr = kernel ?
-    fs_heap_zalloc(entry->length) : kumm_zalloc(entry->length);
+  entry->vaddr = anonmap_alloc(entry, kernel);
   if (entry->vaddr == NULL)
     {
       ferr("ERROR: kumm_alloc() failed, enable DEBUG_MM for info!\n");
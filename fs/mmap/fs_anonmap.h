@@ -44,7 +44,7 @@
  *
  * Input Parameters:
  *   map     Input struct containing user request
- *   kernel  fs_heap_zalloc or kumm_zalloc
+ *   kernel  fs_heap_malloc or kumm_malloc.  The memory is not cleared.
  *
  * Returned Value:
  *   On success returns 0. Otherwise negated errno is returned appropriately.
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 
 #include <assert.h>
 #include <debug.h>
@@ -37,6 +38,8 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
 #include <nuttx/sched.h>
 
 #include "fs_rammap.h"
@@ -44,13 +47,147 @@
 #include "fs_heap.h"
 
 /****************************************************************************
- * Public Data
+ * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_RAMMAP_SHARED
+/* One in-memory image of a file region shared by all of the MAP_SHARED
+ * mappings of that region.
+ */
+
+struct rammap_image_s
+{
+  sq_entry_t          node;    /* Supports a singly linked list */
+  FAR struct inode   *inode;   /* Inode of the mapped file */
+  off_t               offset;  /* File offset of the image */
+  size_t              length;  /* Length of the image */
+  enum mm_map_type_e  type;    /* Heap that holds the image */
+  FAR void           *vaddr;   /* Address of the image */
+  unsigned int        crefs;   /* Number of mappings of the image */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+static sq_queue_t g_rammap_images;
+static mutex_t g_rammap_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rammap_free
+ ****************************************************************************/
+
+static void rammap_free(FAR void *vaddr, enum mm_map_type_e type)
+{
+  if (type == MAP_KERNEL)
+    {
+      fs_heap_free(vaddr);
+    }
+  else if (type == MAP_USER)
+    {
+      kumm_free(vaddr);
+    }
+}
+
+/****************************************************************************
+ * Name: rammap_image_find
+ *
+ * Description:
+ *   Find the image at the address vaddr, or, if vaddr is NULL, the image
+ *   of the file region described by the remaining arguments.  The caller
+ *   must hold g_rammap_lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+static FAR struct rammap_image_s *
+rammap_image_find(FAR void *vaddr, FAR struct inode *inode, off_t offset,
+                  size_t length, enum mm_map_type_e type)
+{
+  FAR sq_entry_t *node;
+
+  sq_for_every(&g_rammap_images, node)
+    {
+      FAR struct rammap_image_s *image = (FAR struct rammap_image_s *)node;
+
+      if (vaddr != NULL)
+        {
+          if (image->vaddr == vaddr)
+            {
+              return image;
+            }
+        }
+      else if (image->inode == inode && image->offset == offset &&
+               image->length == length && image->type == type)
+        {
+          return image;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: rammap_release
+ *
+ * Description:
+ *   Drop one mapping of the memory at vaddr.  Private images are freed
+ *   immediately; shared images when their last mapping goes away.
+ *
+ ****************************************************************************/
+
+static void rammap_release(FAR void *vaddr, enum mm_map_type_e type)
+{
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  FAR struct rammap_image_s *image;
+
+  nxmutex_lock(&g_rammap_lock);
+  image = rammap_image_find(vaddr, NULL, 0, 0, type);
+  if (image != NULL)
+    {
+      if (--image->crefs > 0)
+        {
+          nxmutex_unlock(&g_rammap_lock);
+          return;
+        }
+
+      sq_rem(&image->node, &g_rammap_images);
+      fs_heap_free(image);
+    }
+
+  nxmutex_unlock(&g_rammap_lock);
+#endif
+
+  rammap_free(vaddr, type);
+}
+
+/****************************************************************************
+ * Name: rammap_isshared
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+static bool rammap_isshared(FAR void *vaddr)
+{
+  bool shared;
+
+  nxmutex_lock(&g_rammap_lock);
+  shared = rammap_image_find(vaddr, NULL, 0, 0, MAP_USER) != NULL;
+  nxmutex_unlock(&g_rammap_lock);
+
+  return shared;
+}
+#else
+#  define rammap_isshared(vaddr) false
+#endif
+
 /****************************************************************************
  * Name: msync_rammap
  ****************************************************************************/
@@ -166,15 +303,7 @@ static int unmap_rammap(FAR struct task_group_s *group,
     {
       /* Free the region */
 
-      if (type == MAP_KERNEL)
-        {
-          fs_heap_free(entry->vaddr);
-        }
-      else if (type == MAP_USER)
-        {
-          kumm_free(entry->vaddr);
-        }
-
+      rammap_release(entry->vaddr, type);
       fs_putfilep(filep);
 
       /* Then remove the mapping from the list */
@@ -183,9 +312,14 @@ static int unmap_rammap(FAR struct task_group_s *group,
     }
 
   /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+   * (offset > 0).  A shared image is still in use by the other mappings,
+   * so its tail is only released together with the whole image.
    */
 
+  else if (rammap_isshared(entry->vaddr))
+    {
+      entry->length = offset;
+    }
   else
     {
       if (type == MAP_KERNEL)
@@ -206,62 +340,22 @@ static int unmap_rammap(FAR struct task_group_s *group,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: rammmap
+ * Name: rammap_read
  *
  * Description:
- *   Support simulation of memory mapped files by copying files into RAM.
- *
- * Input Parameters:
- *   filep   file descriptor of the backing file -- required.
- *   entry   mmap entry information.
- *           field offset and length must be initialized correctly.
- *   type    fs_heap_zalloc or kumm_zalloc or xip_base
- *
- * Returned Value:
- *  On success, rammap returns 0 and entry->vaddr points to memory mapped.
- *     Otherwise errno is returned appropriately.
- *
- *     EBADF
- *      'fd' is not a valid file descriptor.
- *     EINVAL
- *       'length' or 'offset' are invalid
- *     ENOMEM
- *       Insufficient memory is available to map the file.
+ *   Allocate a region of memory and read the file region described by
+ *   entry into it.
  *
  ****************************************************************************/
 
-int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
-           enum mm_map_type_e type)
+static int rammap_read(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *entry,
+                       enum mm_map_type_e type)
 {
   FAR uint8_t *rdbuffer;
+  size_t length = entry->length;
   ssize_t nread;
   off_t fpos;
-  int ret;
-  size_t length = entry->length;
-
-  ret = file_ioctl(filep, BIOC_XIPBASE, (unsigned long)&entry->vaddr);
-  if (ret == OK)
-    {
-      type = MAP_XIP;
-      goto out;
-    }
-
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
-   */
 
   /* Allocate a region of memory of the specified size */
 
@@ -285,8 +379,8 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
        */
 
       ferr("ERROR: Seek to position %zu failed\n", (size_t)entry->offset);
-      ret = fpos;
-      goto errout_with_region;
+      rammap_free(entry->vaddr, type);
+      return fpos;
     }
 
   /* Read the file data into the memory region */
@@ -307,8 +401,8 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
               ferr("ERROR: Read failed: offset=%zu ret=%zd\n",
                    (size_t)entry->offset, nread);
 
-              ret = nread;
-              goto errout_with_region;
+              rammap_free(entry->vaddr, type);
+              return nread;
             }
         }
 
@@ -329,6 +423,130 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
 
   memset(rdbuffer, 0, length);
 
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rammap_share
+ *
+ * Description:
+ *   Map the file region described by entry to the image shared by all of
+ *   the MAP_SHARED mappings of that region, loading the image from the
+ *   file on first use.  The design goal of the file mapping emulation is
+ *   a single region of memory that represents a file and is shared by all
+ *   of the threads that map it:  file descriptors opened separately on the
+ *   same path refer to the same inode, which identifies the image.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+static int rammap_share(FAR struct file *filep,
+                        FAR struct mm_map_entry_s *entry,
+                        enum mm_map_type_e type)
+{
+  FAR struct rammap_image_s *image;
+  int ret;
+
+  ret = nxmutex_lock(&g_rammap_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  image = rammap_image_find(NULL, filep->f_inode, entry->offset,
+                            entry->length, type);
+  if (image != NULL)
+    {
+      image->crefs++;
+      entry->vaddr = image->vaddr;
+      goto out;
+    }
+
+  image = fs_heap_malloc(sizeof(struct rammap_image_s));
+  if (image == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  ret = rammap_read(filep, entry, type);
+  if (ret < 0)
+    {
+      fs_heap_free(image);
+      goto out;
+    }
+
+  image->inode  = filep->f_inode;
+  image->offset = entry->offset;
+  image->length = entry->length;
+  image->type   = type;
+  image->vaddr  = entry->vaddr;
+  image->crefs  = 1;
+  sq_addlast(&image->node, &g_rammap_images);
+
+out:
+  nxmutex_unlock(&g_rammap_lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammmap
+ *
+ * Description:
+ *   Support simulation of memory mapped files by copying files into RAM.
+ *
+ * Input Parameters:
+ *   filep   file descriptor of the backing file -- required.
+ *   entry   mmap entry information.
+ *           field offset and length must be initialized correctly.
+ *   type    fs_heap_zalloc or kumm_zalloc or xip_base
+ *
+ * Returned Value:
+ *  On success, rammap returns 0 and entry->vaddr points to memory mapped.
+ *     Otherwise errno is returned appropriately.
+ *
+ *     EBADF
+ *      'fd' is not a valid file descriptor.
+ *     EINVAL
+ *       'length' or 'offset' are invalid
+ *     ENOMEM
+ *       Insufficient memory is available to map the file.
+ *
+ ****************************************************************************/
+
+int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
+           enum mm_map_type_e type)
+{
+  int ret;
+
+  ret = file_ioctl(filep, BIOC_XIPBASE, (unsigned long)&entry->vaddr);
+  if (ret == OK)
+    {
+      type = MAP_XIP;
+      goto out;
+    }
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  if ((entry->flags & MAP_SHARED) != 0)
+    {
+      ret = rammap_share(filep, entry, type);
+    }
+  else
+#endif
+    {
+      ret = rammap_read(filep, entry, type);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Add the buffer to the list of regions */
 
 out:
@@ -346,14 +564,6 @@ out:
   return OK;
 
 errout_with_region:
-  if (type == MAP_KERNEL)
-    {
-      fs_heap_free(entry->vaddr);
-    }
-  else if (type == MAP_USER)
-    {
-      kumm_free(entry->vaddr);
-    }
-
+  rammap_release(entry->vaddr, type);
   return ret;
 }
@@ -475,11 +475,14 @@ static int mnemofs_close(FAR struct file *filep)
 
   if (f->com->refcount == 0)
     {
-      ret = mnemofs_flush(sb);
-      if (predict_false(ret < 0))
+      if (MFS_LRU_FLUSH_ON_CLOSE)
         {
-          finfo("Error while flushing. Ret: %d.", ret);
-          goto errout_with_lock;
+          ret = mnemofs_flush(sb);
+          if (predict_false(ret < 0))
+            {
+              finfo("Error while flushing. Ret: %d.", ret);
+              goto errout_with_lock;
+            }
         }
 
       fs_heap_free(f->com->path);
@@ -487,10 +490,13 @@ static int mnemofs_close(FAR struct file *filep)
 
       finfo("Open file structure freed.");
 
-      ret = mnemofs_flush(sb);
-      if (predict_false(ret < 0))
+      if (MFS_LRU_FLUSH_ON_CLOSE)
         {
-          goto errout_with_fcom;
+          ret = mnemofs_flush(sb);
+          if (predict_false(ret < 0))
+            {
+              goto errout_with_fcom;
+            }
         }
     }
 
@@ -1610,6 +1616,20 @@ static int mnemofs_bind(FAR struct inode *driver, FAR const void *data,
       MFS_EXTRA_LOG("BIND", "RW Buffer allocated.");
     }
 
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+  MFS_CTZCACHE(sb)  = fs_heap_zalloc(sizeof(struct mfs_ctzcache_s));
+  if (predict_false(MFS_CTZCACHE(sb) == NULL))
+    {
+      MFS_LOG("BIND", "CTZ cache in-memory allocation error.");
+      ret = -ENOMEM;
+      goto errout_with_rwbuf;
+    }
+  else
+    {
+      MFS_EXTRA_LOG("BIND", "CTZ cache allocated.");
+    }
+#endif
+
   /* TODO: Format the superblock in Block 0. */
 
   srand(time(NULL));
@@ -1738,10 +1758,17 @@ static int mnemofs_bind(FAR struct inode *driver, FAR const void *data,
   nxmutex_unlock(&MFS_LOCK(sb));
   MFS_LOG("BIND", "Mutex released.");
 
+#ifdef MFS_HAVE_PROCFS
+  mfs_procfs_register(sb);
+#endif
+
   MFS_LOG("BIND", "Exit | Return: %d.", ret);
   return ret;
 
 errout_with_rwbuf:
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+  fs_heap_free(MFS_CTZCACHE(sb));
+#endif
   fs_heap_free(sb->rw_buf);
   MFS_LOG("BIND", "RW Buffer freed.");
 
@@ -1783,6 +1810,7 @@ errout:
 static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
                           unsigned int flags)
 {
+  int                  ret;
   FAR struct mfs_sb_s *sb;
 
   MFS_LOG("UNBIND", "Entry.");
@@ -1794,12 +1822,27 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   *driver = sb->drv;
   MFS_LOG("UNBIND", "Driver %p.", driver);
 
+#ifdef MFS_HAVE_PROCFS
+  mfs_procfs_unregister(sb);
+#endif
+
+  /* Writes may still be pending if the LRU is not flushed on close. */
+
+  ret = mnemofs_flush(sb);
+  if (predict_false(ret < 0))
+    {
+      MFS_LOG("UNBIND", "Error while flushing. Ret: %d.", ret);
+    }
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
   nxmutex_destroy(&MFS_LOCK(sb));
   MFS_EXTRA_LOG("UNBIND", "Mutex destroyed.");
 
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+  fs_heap_free(MFS_CTZCACHE(sb));
+#endif
   fs_heap_free(sb->rw_buf);
   MFS_LOG("UNBIND", "RW Buffer freed.");
 
@@ -2414,6 +2457,7 @@ int mnemofs_flush(FAR struct mfs_sb_s *sb)
           finfo("LRU needs to be flushed.");
 
           change = true;
+          MFS_STATS_INC(sb, lru_flushes);
           ret    = mfs_lru_flush(sb);
           if (predict_false(ret < 0))
             {
@@ -58,6 +58,7 @@
  ****************************************************************************/
 
 #include <debug.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/list.h>
 #include <nuttx/mtd/mtd.h>
@@ -91,6 +92,22 @@
 #define MFS_OFILES(sb)             ((sb)->of)
 #define MFS_FLUSH(sb)              ((sb)->flush)
 #define MFS_NPGS(sb)               (MFS_NBLKS(sb) * MFS_PGINBLK(sb))
+#define MFS_CTZCACHE(sb)           ((sb)->ctz_cache)
+
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_CLOSE
+#  define MFS_LRU_FLUSH_ON_CLOSE   1
+#else
+#  define MFS_LRU_FLUSH_ON_CLOSE   0
+#endif
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MNEMOFS)
+#  define MFS_HAVE_PROCFS
+#  define MFS_STATS_ADD(sb, f, n)  ((sb)->stats.f += (n))
+#else
+#  define MFS_STATS_ADD(sb, f, n)
+#endif
+
+#define MFS_STATS_INC(sb, f)       MFS_STATS_ADD(sb, f, 1)
 
 #define MFS_HASHSZ                 16
 #define MFS_CTZ_SZ(l)              ((l)->sz)
@@ -187,6 +204,49 @@ struct mfs_jrnl_state_s
   uint16_t n_blks;        /* TODO: Does not include the master node. */
 };
 
+/* Journal and LRU counters, reported by procfs. */
+
+#ifdef MFS_HAVE_PROCFS
+struct mfs_stats_s
+{
+  uint32_t lru_deltas;   /* Deltas added to the LRU. */
+  uint32_t lru_bytes;    /* Bytes buffered by update deltas. */
+  uint32_t lru_evicts;   /* Nodes written out as the LRU was full. */
+  uint32_t lru_nodefull; /* Flushes as a node had too many deltas. */
+  uint32_t lru_aged;     /* Flushes as pending deltas got too old. */
+  uint32_t lru_flushes;  /* Flushes of the entire LRU. */
+  uint32_t jrnl_logs;    /* Logs written to the journal. */
+  uint32_t jrnl_flushes; /* Journal flushes into the master node. */
+};
+#endif
+
+/* Known pages of a CTZ list, so that reads do not always have to travel
+ * from the last block of the list. A CTZ list is never modified in place,
+ * so its last block identifies its content.
+ */
+
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+struct mfs_ctzidx_s
+{
+  struct mfs_ctz_s ctz;    /* Last block of the list. */
+  uint32_t         stamp;  /* Last use. */
+  uint8_t          next;   /* Next entry to replace. */
+
+  /* Known blocks of the list, by index and page. */
+
+  mfs_t            idx[CONFIG_MNEMOFS_CTZ_NINDEX];
+  mfs_t            pg[CONFIG_MNEMOFS_CTZ_NINDEX];
+};
+
+struct mfs_ctzcache_s
+{
+  struct mfs_ctzidx_s list[CONFIG_MNEMOFS_CTZ_NCACHES];
+  uint32_t            clock;
+  uint32_t            hits;   /* Travels started from a known block. */
+  uint32_t            misses; /* Travels started from the last block. */
+};
+#endif
+
 struct mfs_sb_s
 {
   FAR uint8_t             *rw_buf;
@@ -207,6 +267,16 @@ struct mfs_sb_s
   struct list_node        lru;
   struct list_node        of;            /* open files. */
   bool                    flush;
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_AGE
+  clock_t                 lru_dirty;     /* Oldest delta in the LRU. */
+#endif
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+  FAR struct mfs_ctzcache_s *ctz_cache;  /* Writable through const sb. */
+#endif
+#ifdef MFS_HAVE_PROCFS
+  struct mfs_stats_s      stats;
+  FAR struct mfs_sb_s     *flink;        /* Next mount, for procfs. */
+#endif
 };
 
 /* This is for *dir VFS methods. */
@@ -1318,6 +1388,24 @@ int mfs_ctz_wrtnode(FAR struct mfs_sb_s * const sb,
 mfs_t mfs_ctz_travel(FAR const struct mfs_sb_s * const sb,
                      mfs_t idx_src, mfs_t pg_src, mfs_t idx_dest);
 
+/****************************************************************************
+ * Name: mfs_ctz_cacheinval
+ *
+ * Description:
+ *   Forget all known pages of CTZ lists. Needs to be called whenever a block
+ *   is erased, as its pages may be reused by other CTZ lists.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+void mfs_ctz_cacheinval(FAR const struct mfs_sb_s * const sb);
+#else
+#  define mfs_ctz_cacheinval(sb)
+#endif
+
 /* mnemofs_lru.c */
 
 /****************************************************************************
@@ -1954,6 +2042,37 @@ int mfs_pitr_rm(FAR struct mfs_sb_s * const sb,
 int mfs_pitr_traversefs(FAR struct mfs_sb_s * sb, const struct mfs_ctz_s ctz,
                         int type);
 
+/* mnemofs_procfs.c */
+
+#ifdef MFS_HAVE_PROCFS
+
+/****************************************************************************
+ * Name: mfs_procfs_register
+ *
+ * Description:
+ *   Add a mounted file system to the report of /proc/fs/mnemofs.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+void mfs_procfs_register(FAR struct mfs_sb_s * const sb);
+
+/****************************************************************************
+ * Name: mfs_procfs_unregister
+ *
+ * Description:
+ *   Remove a file system that is being unmounted from /proc/fs/mnemofs.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+void mfs_procfs_unregister(FAR struct mfs_sb_s * const sb);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -128,6 +128,8 @@ static mfs_t  ctz_blkdatasz(FAR const struct mfs_sb_s * const sb,
 static void   ctz_copyidxptrs(FAR const struct mfs_sb_s * const sb,
                               struct mfs_ctz_s ctz, const mfs_t idx,
                               FAR char *buf);
+static mfs_t  ctz_travel(FAR const struct mfs_sb_s * const sb,
+                         const struct mfs_ctz_s ctz, const mfs_t idx);
 
 /****************************************************************************
  * Private Data
@@ -318,6 +320,101 @@ static void ctz_copyidxptrs(FAR const struct mfs_sb_s * const sb,
     }
 }
 
+/****************************************************************************
+ * Name: ctz_travel
+ *
+ * Description:
+ *   Give the page number of the CTZ block at index `idx` of a CTZ list.
+ *   The travel starts from the closest block after `idx` whose page is
+ *   known by the CTZ cache, and the destination is added to the cache.
+ *
+ * Input Parameters:
+ *   sb  - Superblock instance of the device.
+ *   ctz - CTZ list.
+ *   idx - Index of the destination ctz block.
+ *
+ * Returned Value:
+ *   The page number corresponding to `idx`, 0 on error.
+ *
+ ****************************************************************************/
+
+static mfs_t ctz_travel(FAR const struct mfs_sb_s * const sb,
+                        const struct mfs_ctz_s ctz, const mfs_t idx)
+{
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+  FAR struct mfs_ctzcache_s *cache  = MFS_CTZCACHE(sb);
+  FAR struct mfs_ctzidx_s   *ent    = NULL;
+  FAR struct mfs_ctzidx_s   *victim = &cache->list[0];
+  mfs_t                      idx_src = ctz.idx_e;
+  mfs_t                      pg_src  = ctz.pg_e;
+  mfs_t                      pg;
+  int                        i;
+
+  for (i = 0; i < CONFIG_MNEMOFS_CTZ_NCACHES; i++)
+    {
+      if (mfs_ctz_eq(&cache->list[i].ctz, &ctz))
+        {
+          ent = &cache->list[i];
+          break;
+        }
+
+      if (cache->list[i].stamp < victim->stamp)
+        {
+          victim = &cache->list[i];
+        }
+    }
+
+  if (ent == NULL)
+    {
+      /* Replace the least recently used list. */
+
+      ent = victim;
+      memset(ent, 0, sizeof(*ent));
+      ent->ctz = ctz;
+    }
+  else
+    {
+      for (i = 0; i < CONFIG_MNEMOFS_CTZ_NINDEX; i++)
+        {
+          if (ent->pg[i] != 0 && ent->idx[i] >= idx &&
+              ent->idx[i] < idx_src)
+            {
+              idx_src = ent->idx[i];
+              pg_src  = ent->pg[i];
+            }
+        }
+    }
+
+  ent->stamp = ++cache->clock;
+
+  if (idx_src != ctz.idx_e)
+    {
+      cache->hits++;
+    }
+  else
+    {
+      cache->misses++;
+    }
+
+  if (idx_src == idx)
+    {
+      return pg_src;
+    }
+
+  pg = mfs_ctz_travel(sb, idx_src, pg_src, idx);
+  if (pg != 0)
+    {
+      ent->idx[ent->next] = idx;
+      ent->pg[ent->next]  = pg;
+      ent->next           = (ent->next + 1) % CONFIG_MNEMOFS_CTZ_NINDEX;
+    }
+
+  return pg;
+#else
+  return mfs_ctz_travel(sb, ctz.idx_e, ctz.pg_e, idx);
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -328,7 +425,9 @@ int mfs_ctz_rdfromoff(FAR const struct mfs_sb_s * const sb,
 {
   int   ret       = OK;
   mfs_t i;
+  mfs_t off;
   mfs_t cur_pg;
+  FAR char *pgbuf = NULL;
   mfs_t cur_idx;
   mfs_t cur_pgoff;
   mfs_t end_idx;
@@ -352,58 +451,75 @@ int mfs_ctz_rdfromoff(FAR const struct mfs_sb_s * const sb,
       goto errout;
     }
 
-  cur_pg   = mfs_ctz_travel(sb, ctz.idx_e, ctz.pg_e, cur_idx);
+  cur_pg   = ctz_travel(sb, ctz, cur_idx);
 
   if (predict_false(cur_pg == 0))
     {
       goto errout;
     }
 
-  /* O(n) read by reading in reverse. */
+  /* O(n) read by reading in reverse. Every page read also gives the first
+   * pointer of its CTZ block, which is the page of the previous block, so
+   * walking back costs no extra page reads.
+   */
 
   finfo("Started reading. Current Idx: %u, End Idx: %u.", cur_idx, end_idx);
 
   if (cur_idx != end_idx)
     {
-      for (i = cur_idx; i >= end_idx; i--)
+      pgbuf = fs_heap_malloc(MFS_PGSZ(sb));
+      if (predict_false(pgbuf == NULL))
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      buf += len;
+
+      for (i = cur_idx; ; i--)
         {
           finfo("Current index %u, Current Page %u.", i, cur_pg);
 
           if (predict_false(i == cur_idx))
             {
-              pg_rd_sz  = cur_pgoff;
-              ret       = mfs_read_page(sb, buf - pg_rd_sz, pg_rd_sz, cur_pg,
-                                        0);
-              cur_pgoff = 0;
+              off      = 0;
+              pg_rd_sz = cur_pgoff;
             }
           else if (predict_false(i == end_idx))
             {
+              off      = end_pgoff;
               pg_rd_sz = ctz_blkdatasz(sb, i) - end_pgoff;
-              ret      = mfs_read_page(sb, buf - pg_rd_sz, pg_rd_sz, cur_pg,
-                                       end_pgoff);
             }
           else
             {
+              off      = 0;
               pg_rd_sz = ctz_blkdatasz(sb, i);
-              ret      = mfs_read_page(sb, buf - pg_rd_sz, pg_rd_sz, cur_pg,
-                                      0);
             }
 
-          if (predict_false(ret == 0))
+          ret = mfs_read_page(sb, pgbuf, MFS_PGSZ(sb), cur_pg, 0);
+          if (predict_false(ret <= 0))
             {
-              ret = -EINVAL;
-              goto errout;
+              ret = (ret == 0) ? -EINVAL : ret;
+              goto errout_with_pgbuf;
             }
 
           buf -= pg_rd_sz;
-        }
+          memcpy(buf, pgbuf + off, pg_rd_sz);
 
-      cur_pg = mfs_ctz_travel(sb, cur_idx, cur_pg, cur_idx - 1);
-      if (predict_false(cur_pg == 0))
-        {
-          ret = -EINVAL;
-          goto errout;
+          if (i == end_idx)
+            {
+              break;
+            }
+
+          mfs_deser_mfs(pgbuf + MFS_PGSZ(sb) - MFS_CTZ_PTRSZ, &cur_pg);
+          if (predict_false(cur_pg == 0))
+            {
+              ret = -EINVAL;
+              goto errout_with_pgbuf;
+            }
         }
+
+      ret = OK;
     }
   else
     {
@@ -418,6 +534,9 @@ int mfs_ctz_rdfromoff(FAR const struct mfs_sb_s * const sb,
 
   finfo("Reading finished.");
 
+errout_with_pgbuf:
+  fs_heap_free(pgbuf);
+
 errout:
   return ret;
 }
@@ -623,7 +742,9 @@ mfs_t mfs_ctz_travel(FAR const struct mfs_sb_s * const sb,
 
   for (pow = mfs_ctz(idx); pow < max_pow - 1; pow = mfs_ctz(idx))
     {
-      mfs_read_page(sb, buf, 4, pg, MFS_PGSZ(sb) - (4 * pow));
+      /* The `k`th pointer is the `k + 1`th word from the end. */
+
+      mfs_read_page(sb, buf, 4, pg, MFS_PGSZ(sb) - (4 * (pow + 1)));
       mfs_deser_mfs(buf, &pg);
       idx -= (1 << pow);
 
@@ -644,7 +765,7 @@ mfs_t mfs_ctz_travel(FAR const struct mfs_sb_s * const sb,
 
   for (pow = mfs_set_msb(diff); diff != 0; pow = mfs_set_msb(diff))
     {
-      mfs_read_page(sb, buf, 4, pg, MFS_PGSZ(sb) - (4 * pow));
+      mfs_read_page(sb, buf, 4, pg, MFS_PGSZ(sb) - (4 * (pow + 1)));
       mfs_deser_mfs(buf, &pg);
       idx  -= (1 << pow);
       diff -= (1 << pow);
@@ -660,3 +781,15 @@ mfs_t mfs_ctz_travel(FAR const struct mfs_sb_s * const sb,
 
   return pg;
 }
+
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+void mfs_ctz_cacheinval(FAR const struct mfs_sb_s * const sb)
+{
+  FAR struct mfs_ctzcache_s *cache = MFS_CTZCACHE(sb);
+
+  if (cache != NULL)
+    {
+      memset(cache->list, 0, sizeof(cache->list));
+    }
+}
+#endif
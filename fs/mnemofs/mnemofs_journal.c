@@ -677,6 +677,7 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
 
   MFS_JRNL(sb).log_cpg = jrnl_pg;
   MFS_JRNL(sb).n_logs++;
+  MFS_STATS_INC(sb, jrnl_logs);
 
 errout_with_buf:
   fs_heap_free(buf);
@@ -877,6 +878,8 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
       goto errout;
     }
 
+  MFS_STATS_INC(sb, jrnl_flushes);
+
 errout:
   return ret;
 }
@@ -99,6 +99,9 @@ static void lru_nodesearch(FAR const struct mfs_sb_s * const sb,
                            FAR const struct mfs_path_s * const path,
                            const mfs_t depth, FAR struct mfs_node_s **node);
 static bool lru_islrufull(FAR struct mfs_sb_s * const sb);
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_AGE
+static bool lru_isaged(FAR struct mfs_sb_s * const sb);
+#endif
 static bool lru_isnodefull(FAR struct mfs_sb_s * const sb,
                            FAR struct mfs_node_s *node);
 static int  lru_nodeflush(FAR struct mfs_sb_s * const sb,
@@ -226,9 +229,34 @@ static void lru_nodesearch(FAR const struct mfs_sb_s * const sb,
 
 static bool lru_islrufull(FAR struct mfs_sb_s * const sb)
 {
-  return !MFS_FLUSH(sb) && list_length(&MFS_LRU(sb)) == CONFIG_MNEMOFS_NLRU;
+  return !MFS_FLUSH(sb) && list_length(&MFS_LRU(sb)) >= CONFIG_MNEMOFS_NLRU;
 }
 
+/****************************************************************************
+ * Name: lru_isaged
+ *
+ * Description:
+ *   Check whether the oldest delta in the LRU has been pending for longer
+ *   than CONFIG_MNEMOFS_LRU_FLUSH_AGE_MS.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *  true   - LRU needs to be flushed.
+ *  false  - LRU is empty or recent.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_AGE
+static bool lru_isaged(FAR struct mfs_sb_s * const sb)
+{
+  return !MFS_FLUSH(sb) && !mfs_lru_isempty(sb) &&
+         clock_systime_ticks() - sb->lru_dirty >=
+         MSEC2TICK(CONFIG_MNEMOFS_LRU_FLUSH_AGE_MS);
+}
+#endif
+
 /****************************************************************************
  * Name: lru_isnodefull
  *
@@ -386,11 +414,52 @@ static int lru_wrtooff(FAR struct mfs_sb_s * const sb, const mfs_t data_off,
   FAR struct mfs_node_s  *node      = NULL;
   FAR struct mfs_node_s  *last_node = NULL;
   FAR struct mfs_delta_s *delta     = NULL;
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_AGE
+  bool                    wasempty;
+#endif
 
   DEBUGASSERT(depth > 0);
 
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_AGE
+  if (lru_isaged(sb))
+    {
+      finfo("LRU deltas are too old, flushing.");
+      MFS_STATS_INC(sb, lru_aged);
+
+      ret = mnemofs_flush(sb);
+      if (predict_false(ret < 0))
+        {
+          goto errout;
+        }
+    }
+#endif
+
   lru_nodesearch(sb, path, depth, &node);
 
+  if (node != NULL && lru_isnodefull(sb, node))
+    {
+      /* This can be optimized further if needed, but for now, for saftey of
+       * the data, I think it's better to flush the entire thing. It won't
+       * flush ALL of it, just, whatever's required.
+       *
+       * The flush frees the node, so a new one is allocated below.
+       */
+
+      MFS_STATS_INC(sb, lru_nodefull);
+
+      ret = mnemofs_flush(sb);
+      if (predict_false(ret < 0))
+        {
+          goto errout;
+        }
+
+      lru_nodesearch(sb, path, depth, &node);
+    }
+
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_AGE
+  wasempty = mfs_lru_isempty(sb);
+#endif
+
   if (node == NULL)
     {
       node = fs_heap_zalloc(sizeof(*node));
@@ -425,10 +494,24 @@ static int lru_wrtooff(FAR struct mfs_sb_s * const sb, const mfs_t data_off,
     {
       if (lru_islrufull(sb))
         {
+          /* Write out the oldest node, new nodes are added at the tail.
+           * Its parent is updated through the LRU, which may add the
+           * parent as a node.
+           */
+
           finfo("LRU is full, need to flush a node.");
-          last_node = list_container_of(list_peek_tail(&MFS_LRU(sb)),
+          last_node = list_container_of(list_peek_head(&MFS_LRU(sb)),
                                         struct mfs_node_s, list);
-          list_delete_init(&last_node->list);
+          MFS_STATS_INC(sb, lru_evicts);
+
+          ret = lru_nodeflush(sb, last_node->path, last_node->depth,
+                              last_node, true);
+          if (predict_false(ret < 0))
+            {
+              lru_node_free(node);
+              goto errout;
+            }
+
           list_add_tail(&MFS_LRU(sb), &node->list);
           finfo("LRU flushing node complete, now only %zu nodes",
                 list_length(&MFS_LRU(sb)));
@@ -440,19 +523,6 @@ static int lru_wrtooff(FAR struct mfs_sb_s * const sb, const mfs_t data_off,
                 list_length(&MFS_LRU(sb)));
         }
     }
-  else if (found && lru_isnodefull(sb, node))
-    {
-      /* This can be optimized further if needed, but for now, for saftey of
-       * the data, I think it's better to flush the entire thing. It won't
-       * flush ALL of it, just, whatever's required.
-       */
-
-      ret = mnemofs_flush(sb);
-      if (predict_false(ret < 0))
-        {
-          goto errout_with_node;
-        }
-    }
 
   /* Add delta to node. */
 
@@ -487,6 +557,15 @@ static int lru_wrtooff(FAR struct mfs_sb_s * const sb, const mfs_t data_off,
       memcpy(delta->upd, buf, bytes);
     }
 
+#ifdef CONFIG_MNEMOFS_LRU_FLUSH_AGE
+  if (wasempty)
+    {
+      sb->lru_dirty = clock_systime_ticks();
+    }
+#endif
+
+  MFS_STATS_INC(sb, lru_deltas);
+  MFS_STATS_ADD(sb, lru_bytes, op == MFS_LRU_UPD ? bytes : 0);
   node->n_list++;
   node->range_min                = MIN(node->range_min, data_off);
   node->range_max                = MAX(node->range_max, data_off + bytes);
@@ -891,13 +970,17 @@ int mfs_lru_rdfromoff(FAR const struct mfs_sb_s * const sb,
   lru_nodesearch(sb, path, depth, &node);
   if (node == NULL)
     {
-      mfs_ctz_rdfromoff(sb, ctz, 0, buflen, tmp);
+      ret = mfs_ctz_rdfromoff(sb, ctz, data_off, buflen, tmp);
       goto errout;
     }
 
   while (rem_sz > 0)
     {
-      mfs_ctz_rdfromoff(sb, ctz, lower, rem_sz, tmp);
+      ret = mfs_ctz_rdfromoff(sb, ctz, lower, rem_sz, tmp);
+      if (predict_false(ret < 0))
+        {
+          goto errout;
+        }
 
       list_for_every_entry(&node->delta, delta, struct mfs_delta_s, list)
         {
@@ -0,0 +1,274 @@
+/****************************************************************************
+ * fs/mnemofs/mnemofs_procfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * /proc/fs/mnemofs reports the LRU and journal counters of every mounted
+ * mnemofs, to help sizing CONFIG_MNEMOFS_NLRU, CONFIG_MNEMOFS_NLRUDELTA,
+ * the journal and the CTZ cache for a given NAND and workload.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mutex.h>
+
+#include "mnemofs.h"
+#include "fs_heap.h"
+
+#ifdef MFS_HAVE_PROCFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MFS_PROCFS_LINELEN 80
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     mfs_procfs_open(FAR struct file *filep,
+                               FAR const char *relpath, int oflags,
+                               mode_t mode);
+static int     mfs_procfs_close(FAR struct file *filep);
+static ssize_t mfs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static int     mfs_procfs_dup(FAR const struct file *oldp,
+                              FAR struct file *newp);
+static int     mfs_procfs_stat(FAR const char *relpath,
+                               FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All mounted mnemofs instances. */
+
+static FAR struct mfs_sb_s *g_mfs_mounts;
+static mutex_t g_mfs_mountlock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there. */
+
+const struct procfs_operations g_mnemofs_procfs_operations =
+{
+  mfs_procfs_open,  /* open */
+  mfs_procfs_close, /* close */
+  mfs_procfs_read,  /* read */
+  NULL,             /* write */
+  NULL,             /* poll */
+
+  mfs_procfs_dup,   /* dup */
+
+  NULL,             /* opendir */
+  NULL,             /* closedir */
+  NULL,             /* readdir */
+  NULL,             /* rewinddir */
+
+  mfs_procfs_stat   /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int mfs_procfs_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct procfs_file_s *attr;
+
+  /* This procfs file is read-only. */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  attr = fs_heap_zalloc(sizeof(struct procfs_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = attr;
+  return OK;
+}
+
+static int mfs_procfs_close(FAR struct file *filep)
+{
+  fs_heap_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+static ssize_t mfs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct mfs_sb_s     *sb;
+  struct mfs_stats_s       stats;
+  struct mfs_jrnl_state_s  jrnl;
+  char                     line[MFS_PROCFS_LINELEN];
+  size_t                   linesize;
+  size_t                   nodes;
+  size_t                   deltas;
+  FAR struct mfs_node_s   *node;
+  off_t                    offset;
+  ssize_t                  ret    = 0;
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+  uint32_t                 hits;
+  uint32_t                 misses;
+#endif
+
+  offset = filep->f_pos;
+
+  nxmutex_lock(&g_mfs_mountlock);
+  for (sb = g_mfs_mounts; sb != NULL; sb = sb->flink)
+    {
+      nxmutex_lock(&MFS_LOCK(sb));
+      stats  = sb->stats;
+      jrnl   = MFS_JRNL(sb);
+      nodes  = 0;
+      deltas = 0;
+      list_for_every_entry(&MFS_LRU(sb), node, struct mfs_node_s, list)
+        {
+          nodes++;
+          deltas += node->n_list;
+        }
+
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+      hits   = MFS_CTZCACHE(sb)->hits;
+      misses = MFS_CTZCACHE(sb)->misses;
+#endif
+      nxmutex_unlock(&MFS_LOCK(sb));
+
+      linesize = procfs_snprintf(line, MFS_PROCFS_LINELEN, "%s:\n",
+                                 sb->drv->i_name);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, MFS_PROCFS_LINELEN,
+                                 "  lru:     nodes %zu/%d deltas %zu"
+                                 " added %" PRIu32 " bytes %" PRIu32 "\n",
+                                 nodes, CONFIG_MNEMOFS_NLRU, deltas,
+                                 stats.lru_deltas, stats.lru_bytes);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, MFS_PROCFS_LINELEN,
+                                 "  flush:   all %" PRIu32 " evict %" PRIu32
+                                 " nodefull %" PRIu32 " aged %" PRIu32
+                                 "\n", stats.lru_flushes, stats.lru_evicts,
+                                 stats.lru_nodefull, stats.lru_aged);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+      linesize = procfs_snprintf(line, MFS_PROCFS_LINELEN,
+                                 "  journal: logs %" PRIu32 " (%" PRIu32
+                                 " pending) blocks %" PRIu32 "/%u"
+                                 " flushes %" PRIu32 "\n",
+                                 stats.jrnl_logs, jrnl.n_logs,
+                                 jrnl.log_cblkidx, jrnl.n_blks,
+                                 stats.jrnl_flushes);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+
+#if CONFIG_MNEMOFS_CTZ_NCACHES > 0
+      linesize = procfs_snprintf(line, MFS_PROCFS_LINELEN,
+                                 "  ctz:     hits %" PRIu32 " misses %"
+                                 PRIu32 "\n", hits, misses);
+      ret += procfs_memcpy(line, linesize, buffer + ret, buflen - ret,
+                           &offset);
+#endif
+    }
+
+  nxmutex_unlock(&g_mfs_mountlock);
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+static int mfs_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct procfs_file_s *attr;
+
+  attr = fs_heap_malloc(sizeof(struct procfs_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(attr, oldp->f_priv, sizeof(struct procfs_file_s));
+  newp->f_priv = attr;
+  return OK;
+}
+
+static int mfs_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void mfs_procfs_register(FAR struct mfs_sb_s * const sb)
+{
+  nxmutex_lock(&g_mfs_mountlock);
+  sb->flink    = g_mfs_mounts;
+  g_mfs_mounts = sb;
+  nxmutex_unlock(&g_mfs_mountlock);
+}
+
+void mfs_procfs_unregister(FAR struct mfs_sb_s * const sb)
+{
+  FAR struct mfs_sb_s **prev;
+
+  nxmutex_lock(&g_mfs_mountlock);
+  for (prev = &g_mfs_mounts; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == sb)
+        {
+          *prev = sb->flink;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_mfs_mountlock);
+}
+
+#endif /* MFS_HAVE_PROCFS */
@@ -167,6 +167,7 @@ int mfs_erase_blk(FAR const struct mfs_sb_s * const sb, const off_t blk)
       return -EINVAL;
     }
 
+  mfs_ctz_cacheinval(sb);
   return MTD_ERASE(MFS_MTD(sb), blk, 1);
 }
 
@@ -178,5 +179,6 @@ int mfs_erase_nblks(FAR const struct mfs_sb_s * const sb, const off_t blk,
       return -EINVAL;
     }
 
+  mfs_ctz_cacheinval(sb);
   return MTD_ERASE(MFS_MTD(sb), blk, n);
 }
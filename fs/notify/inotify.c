@@ -64,12 +64,16 @@ struct inotify_device_s
   int                count;       /* Reference count */
   uint32_t           event_size;  /* Size of the queue (bytes) */
   uint32_t           event_count; /* Number of pending events */
+  uint32_t           max_events;  /* Queue limit, see FIOC_NOTIFYLIMIT */
+  uint32_t           head_seq;    /* Sequence of the oldest queued event */
+  uint32_t           tail_seq;    /* Sequence of the next queued event */
   FAR struct pollfd *fds[CONFIG_FS_NOTIFY_FD_POLLWAITERS];
 };
 
 struct inotify_event_s
 {
   struct list_node     node;     /* Entry in inotify_device's list */
+  uint32_t             seq;      /* Position in the device queue */
   struct inotify_event event;    /* The user-space event */
 };
 
@@ -87,6 +91,8 @@ struct inotify_watch_s
   uint32_t                         mask;    /* Event mask for this watch */
   FAR struct inotify_device_s     *dev;     /* Associated device */
   FAR struct inotify_watch_list_s *list;    /* Associated watch list */
+  FAR struct inotify_event_s      *last;    /* Last event of this watch */
+  uint32_t                         seq;     /* Sequence of 'last' */
 };
 
 struct inotify_global_s
@@ -96,6 +102,7 @@ struct inotify_global_s
   int      watch_cookie;       /* Watch cookie */
   uint32_t read_count;         /* Number of read events */
   uint32_t write_count;        /* Number of write events */
+  volatile unsigned int gen;   /* Bumped when a file may gain a watch */
   struct   hsearch_data hash;  /* Hash table for watch lists */
 };
 
@@ -144,6 +151,7 @@ static struct inode g_inotify_inode =
 static struct inotify_global_s g_inotify =
 {
   .lock = NXMUTEX_INITIALIZER,
+  .gen  = 1,
 };
 
 /****************************************************************************
@@ -193,6 +201,41 @@ static int notify_check_mask(uint32_t mask)
           -EBADF : OK;
 }
 
+/****************************************************************************
+ * Name: inotify_bump_gen
+ *
+ * Description:
+ *   Invalidate the "not watched" mark cached in every open file.  Called
+ *   with the global lock held whenever a path may have gained a watch.
+ *
+ ****************************************************************************/
+
+static void inotify_bump_gen(void)
+{
+  if (++g_inotify.gen == 0)
+    {
+      g_inotify.gen = 1;
+    }
+}
+
+/****************************************************************************
+ * Name: inotify_same_event
+ *
+ * Description:
+ *   Check if a queued event is identical to a new one.
+ *
+ ****************************************************************************/
+
+static bool inotify_same_event(FAR struct inotify_event_s *event, int wd,
+                               uint32_t mask, uint32_t cookie,
+                               FAR const char *name)
+{
+  return event->event.mask == mask && event->event.wd == wd &&
+         event->event.cookie == cookie &&
+         ((name == NULL && event->event.len == 0) ||
+          (name && event->event.len && !strcmp(name, event->event.name)));
+}
+
 /****************************************************************************
  * Name: inotify_alloc_event
  *
@@ -240,12 +283,14 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
  *
  ****************************************************************************/
 
-static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
+static void inotify_queue_event(FAR struct inotify_device_s *dev,
+                                FAR struct inotify_watch_s *watch,
                                 uint32_t mask, uint32_t cookie,
                                 FAR const char *name)
 {
   FAR struct inotify_event_s *event;
   FAR struct inotify_event_s *last;
+  bool overflow;
   int semcnt;
 
   if (!list_is_empty(&dev->events))
@@ -254,28 +299,38 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
 
       last = list_last_entry(&dev->events,
                              struct inotify_event_s, node);
-      if (last->event.mask == mask && last->event.wd == wd &&
-          last->event.cookie == cookie &&
-          ((name == NULL && last->event.len == 0) ||
-           (name && last->event.len && !strcmp(name, last->event.name))))
+      if (inotify_same_event(last, watch->wd, mask, cookie, name))
+        {
+          return;
+        }
+
+      /* Or of the last event of the same watch that is still unread, so
+       * that a file written in small chunks produces a single IN_MODIFY
+       * even when other watches report in between.
+       */
+
+      if (watch->last != NULL &&
+          (int32_t)(watch->seq - dev->head_seq) >= 0 &&
+          inotify_same_event(watch->last, watch->wd, mask, cookie, name))
         {
           return;
         }
     }
 
-  if (dev->event_count > CONFIG_FS_NOTIFY_MAX_EVENTS)
+  if (dev->event_count > dev->max_events)
     {
       finfo("Too many events queued\n");
       return;
     }
 
-  if (dev->event_count == CONFIG_FS_NOTIFY_MAX_EVENTS)
+  overflow = dev->event_count == dev->max_events;
+  if (overflow)
     {
       event = inotify_alloc_event(-1, IN_Q_OVERFLOW, cookie, NULL);
     }
   else
     {
-      event = inotify_alloc_event(wd, mask, cookie, name);
+      event = inotify_alloc_event(watch->wd, mask, cookie, name);
     }
 
   if (event == NULL)
@@ -283,6 +338,13 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
       return;
     }
 
+  event->seq = dev->tail_seq++;
+  if (!overflow)
+    {
+      watch->last = event;
+      watch->seq = event->seq;
+    }
+
   dev->event_count++;
   dev->event_size += sizeof(struct inotify_event) + event->event.len;
   list_add_tail(&dev->events, &event->node);
@@ -332,7 +394,7 @@ inotify_remove_watch_no_event(FAR struct inotify_watch_s *watch)
 static void inotify_remove_watch(FAR struct inotify_device_s *dev,
                                  FAR struct inotify_watch_s *watch)
 {
-  inotify_queue_event(dev, watch->wd, IN_IGNORED, 0, NULL);
+  inotify_queue_event(dev, watch, IN_IGNORED, 0, NULL);
   inotify_remove_watch_no_event(watch);
 }
 
@@ -350,6 +412,7 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
   list_delete(&event->node);
   dev->event_size -= sizeof(struct inotify_event) + event->event.len;
   dev->event_count--;
+  dev->head_seq++;
   fs_heap_free(event);
 }
 
@@ -372,6 +435,7 @@ static FAR struct inotify_device_s *inotify_alloc_device(void)
     }
 
   dev->count = 1;
+  dev->max_events = CONFIG_FS_NOTIFY_MAX_EVENTS;
   nxmutex_init(&dev->lock);
   nxsem_init(&dev->sem, 0, 0);
   list_initialize(&dev->events);
@@ -473,6 +537,21 @@ static int inotify_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
         }
         break;
+
+      case FIOC_NOTIFYLIMIT:
+        {
+          if (arg == 0 || arg > UINT32_MAX)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          nxmutex_lock(&dev->lock);
+          dev->max_events = arg;
+          nxmutex_unlock(&dev->lock);
+          ret = OK;
+        }
+        break;
     }
 
   return ret;
@@ -817,7 +896,7 @@ inotify_queue_watch_list_event(FAR struct inotify_watch_list_s *list,
           bool last_iteration = list_is_singular(&list->watches);
 
           nxmutex_lock(&dev->lock);
-          inotify_queue_event(dev, watch->wd, mask, cookie, name);
+          inotify_queue_event(dev, watch, mask, cookie, name);
           if (watch_mask & IN_ONESHOT)
             {
               inotify_remove_watch(dev, watch);
@@ -846,7 +925,7 @@ inotify_queue_watch_list_event(FAR struct inotify_watch_list_s *list,
  *
  ****************************************************************************/
 
-static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
+static bool inotify_queue_parent_event(FAR char *path, uint32_t mask,
                                        uint32_t cookie)
 {
   FAR struct inotify_watch_list_s *list;
@@ -855,15 +934,18 @@ static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
   name = basename(path);
   if (name == NULL || name == path)
     {
-      return;
+      return false;
     }
 
   *(name - 1) = '\0';
   list = inotify_get_watch_list(path);
-  if (list != NULL)
+  if (list == NULL)
     {
-      inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+      return false;
     }
+
+  inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+  return true;
 }
 
 /****************************************************************************
@@ -872,26 +954,30 @@ static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
  * Description:
  *   Send the notification by the path.
  *
+ * Returned Value:
+ *   True if the path or its parent directory is watched.
+ *
  ****************************************************************************/
 
-static void notify_queue_path_event(FAR const char *path, uint32_t mask)
+static bool notify_queue_path_event(FAR const char *path, uint32_t mask)
 {
   FAR struct inotify_watch_list_s *list;
   FAR char *abspath;
   FAR char *pathbuffer;
   uint32_t cookie = 0;
+  bool watched;
 
   pathbuffer = lib_get_pathbuffer();
   if (pathbuffer == NULL)
     {
-      return;
+      return true;
     }
 
   abspath = lib_realpath(path, pathbuffer, true);
   if (abspath == NULL)
     {
       lib_put_pathbuffer(pathbuffer);
-      return;
+      return true;
     }
 
   if (mask & IN_MOVE)
@@ -905,11 +991,11 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     }
 
   list = inotify_get_watch_list(abspath);
-  inotify_queue_parent_event(abspath, mask, cookie);
+  watched = inotify_queue_parent_event(abspath, mask, cookie);
   lib_put_pathbuffer(pathbuffer);
   if (list == NULL)
     {
-      return;
+      return watched;
     }
 
   if (mask & IN_MOVED_FROM)
@@ -933,6 +1019,8 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     {
       inotify_queue_watch_list_event(list, mask, cookie, NULL);
     }
+
+  return true;
 }
 
 /****************************************************************************
@@ -972,17 +1060,29 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
                                             uint32_t mask)
 {
   FAR char *pathbuffer;
+  unsigned int gen;
   int ret;
 
+  /* Fast path: the file was found unwatched and no watch was added since.
+   * Sample the generation before the lookup below, so that a watch added
+   * concurrently invalidates the mark stored at the end.
+   */
+
+  gen = g_inotify.gen;
+  if (filep->f_notify_gen == gen)
+    {
+      return;
+    }
+
   ret = notify_check_inode(filep);
   if (ret < 0)
     {
       return;
     }
 
-  nxmutex_lock(&g_inotify.lock);
+  /* The counters are only a hint, reading them unlocked is fine */
+
   ret = notify_check_mask(mask);
-  nxmutex_unlock(&g_inotify.lock);
   if (ret < 0)
     {
       return;
@@ -1007,7 +1107,11 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
     }
 
   nxmutex_lock(&g_inotify.lock);
-  notify_queue_path_event(pathbuffer, mask);
+  if (!notify_queue_path_event(pathbuffer, mask))
+    {
+      filep->f_notify_gen = gen;
+    }
+
   lib_put_pathbuffer(pathbuffer);
   nxmutex_unlock(&g_inotify.lock);
 }
@@ -1146,6 +1250,8 @@ int inotify_add_watch(int fd, FAR const char *pathname, uint32_t mask)
       inotify_add_count(mask);
     }
 
+  inotify_bump_gen();
+
 out:
   nxmutex_unlock(&dev->lock);
   nxmutex_unlock(&g_inotify.lock);
@@ -1510,5 +1616,9 @@ void notify_rename(FAR const char *oldpath, bool oldisdir,
   nxmutex_lock(&g_inotify.lock);
   notify_queue_path_event(oldpath, oldmask);
   notify_queue_path_event(newpath, newmask);
+
+  /* Open files below the old path now live under a new parent */
+
+  inotify_bump_gen();
   nxmutex_unlock(&g_inotify.lock);
 }
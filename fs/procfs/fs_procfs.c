@@ -56,24 +56,32 @@
  * External Definitions
  ****************************************************************************/
 
+extern const struct procfs_operations g_blockcache_operations;
+extern const struct procfs_operations g_bootprof_operations;
 extern const struct procfs_operations g_clk_operations;
 extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_cpufreq_operations;
 extern const struct procfs_operations g_critmon_operations;
 extern const struct procfs_operations g_fdt_operations;
+extern const struct procfs_operations g_heapprof_operations;
 extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
+extern const struct procfs_operations g_loadbalance_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
 extern const struct procfs_operations g_mempool_operations;
 extern const struct procfs_operations g_module_operations;
+extern const struct procfs_operations g_mqueue_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
+extern const struct procfs_operations g_schedlat_operations;
+extern const struct procfs_operations g_tasksnap_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_pressure_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -82,6 +90,8 @@ extern const struct procfs_operations g_pressure_operations;
  * configuration.
  */
 
+extern const struct procfs_operations g_dhara_operations;
+extern const struct procfs_operations g_mnemofs_procfs_operations;
 extern const struct procfs_operations g_mount_operations;
 extern const struct procfs_operations g_net_operations;
 extern const struct procfs_operations g_netroute_operations;
@@ -105,6 +115,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",       &g_proc_operations,     PROCFS_DIR_TYPE    },
 #endif
 
+#if defined(CONFIG_SCHED_BOOTPROF) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOTPROF)
+  { "bootprof",     &g_bootprof_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_CLK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CLK)
   { "clk",          &g_clk_operations,      PROCFS_FILE_TYPE   },
 #endif
@@ -126,14 +141,27 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "critmon",      &g_critmon_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MTD_DHARA) && !defined(CONFIG_FS_PROCFS_EXCLUDE_DHARA)
+  { "dhara",        &g_dhara_operations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_DEVICE_TREE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_FDT)
   { "fdt",          &g_fdt_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_BLOCKCACHE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE)
+  { "fs/blockcache", &g_blockcache_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_MNEMOFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MNEMOFS)
+  { "fs/mnemofs",   &g_mnemofs_procfs_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MOUNT
   { "fs/mount",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -146,6 +174,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/usage",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_HEAPPROF) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAPPROF)
+  { "heapprof",     &g_heapprof_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",      &g_iobinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -154,6 +186,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "irqs",         &g_irq_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SCHED_LOADBALANCE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_LOADBALANCE)
+  { "loadbalance",  &g_loadbalance_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
 #  ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP
   { "memdump",      &g_memdump_operations,  PROCFS_FILE_TYPE   },
@@ -169,6 +206,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "modules",      &g_module_operations,   PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0 && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_MQUEUE)
+  { "mqueue",       &g_mqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_NET) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
   { "net",          &g_net_operations,      PROCFS_DIR_TYPE    },
 #  if defined(CONFIG_NET_ROUTE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_ROUTE)
@@ -192,11 +234,20 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "pressure/**",  &g_pressure_operations, PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SCHED_LATENCY) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SCHEDLAT)
+  { "schedlat",     &g_schedlat_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_PROCESS
   { "self",         &g_proc_operations,     PROCFS_DIR_TYPE    },
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_TASKSNAP
+  { "tasksnap",     &g_tasksnap_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_TCBINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_TCBINFO)
   { "tcbinfo",      &g_tcbinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -213,6 +264,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_VERSION
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#if defined(CONFIG_SCHED_WORKQUEUE_PERWORKER) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
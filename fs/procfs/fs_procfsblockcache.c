@@ -0,0 +1,326 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsblockcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/blockcache.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_FS_BLOCKCACHE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BLOCKCACHE_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct bcstats_file_s
+{
+  struct procfs_file_s  base;    /* Base open file structure */
+  char line[BLOCKCACHE_LINELEN]; /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     bcstats_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     bcstats_close(FAR struct file *filep);
+static ssize_t bcstats_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t bcstats_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+
+static int     bcstats_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     bcstats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_blockcache_operations =
+{
+  bcstats_open,       /* open */
+  bcstats_close,      /* close */
+  bcstats_read,       /* read */
+  bcstats_write,      /* write */
+  NULL,               /* poll */
+
+  bcstats_dup,        /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  bcstats_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcstats_open
+ ****************************************************************************/
+
+static int bcstats_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct bcstats_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct bcstats_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcstats_close
+ ****************************************************************************/
+
+static int bcstats_close(FAR struct file *filep)
+{
+  FAR struct bcstats_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bcstats_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcstats_read
+ ****************************************************************************/
+
+static ssize_t bcstats_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct bcstats_file_s *attr;
+  struct blockcache_stats_s stats;
+  uint64_t amp;
+  size_t linesize;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bcstats_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  blockcache_getstats(&stats);
+
+  /* Read amplification in hundredths */
+
+  amp = stats.reqsectors > 0 ?
+        stats.drvsectors * 100 / stats.reqsectors : 0;
+
+  offset = filep->f_pos;
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "pages:      %zu/%d\n", stats.npages,
+                             CONFIG_FS_BLOCKCACHE_NPAGES);
+  ret = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "hits:       %" PRIu32 "\n", stats.hits);
+  ret += procfs_memcpy(attr->line, linesize, buffer + ret, buflen - ret,
+                       &offset);
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "misses:     %" PRIu32 "\n", stats.misses);
+  ret += procfs_memcpy(attr->line, linesize, buffer + ret, buflen - ret,
+                       &offset);
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "bypasses:   %" PRIu32 "\n", stats.bypasses);
+  ret += procfs_memcpy(attr->line, linesize, buffer + ret, buflen - ret,
+                       &offset);
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "writebacks: %" PRIu32 "\n", stats.writebacks);
+  ret += procfs_memcpy(attr->line, linesize, buffer + ret, buflen - ret,
+                       &offset);
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "reqsectors: %" PRIu64 "\n", stats.reqsectors);
+  ret += procfs_memcpy(attr->line, linesize, buffer + ret, buflen - ret,
+                       &offset);
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "drvsectors: %" PRIu64 "\n", stats.drvsectors);
+  ret += procfs_memcpy(attr->line, linesize, buffer + ret, buflen - ret,
+                       &offset);
+
+  linesize = procfs_snprintf(attr->line, BLOCKCACHE_LINELEN,
+                             "readamp:    %" PRIu64 ".%02u\n", amp / 100,
+                             (unsigned int)(amp % 100));
+  ret += procfs_memcpy(attr->line, linesize, buffer + ret, buflen - ret,
+                       &offset);
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcstats_write
+ *
+ * Description:
+ *   Any write clears the statistics.
+ *
+ ****************************************************************************/
+
+static ssize_t bcstats_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  blockcache_resetstats();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: bcstats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bcstats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct bcstats_file_s *oldattr;
+  FAR struct bcstats_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct bcstats_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct bcstats_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct bcstats_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcstats_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bcstats_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/blockcache" is the name for a file that is cleared when written */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_FS_BLOCKCACHE && !CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE
+        */
@@ -0,0 +1,311 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsbootprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_BOOTPROF) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOTPROF)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BOOTPROF_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct bootprof_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[BOOTPROF_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     bootprof_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     bootprof_close(FAR struct file *filep);
+static ssize_t bootprof_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     bootprof_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     bootprof_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_bootprof_operations =
+{
+  bootprof_open,       /* open */
+  bootprof_close,      /* close */
+  bootprof_read,       /* read */
+  NULL,                /* write */
+  NULL,                /* poll */
+
+  bootprof_dup,        /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  bootprof_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bootprof_open
+ ****************************************************************************/
+
+static int bootprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct bootprof_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct bootprof_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bootprof_close
+ ****************************************************************************/
+
+static int bootprof_close(FAR struct file *filep)
+{
+  FAR struct bootprof_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bootprof_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bootprof_read_step
+ *
+ * Description:
+ *   Generate the line of one boot step: the time since the first mark, the
+ *   time spent in the step and its name, in microseconds.
+ *
+ ****************************************************************************/
+
+static size_t bootprof_read_step(FAR struct bootprof_file_s *attr,
+                                 FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset,
+                                 FAR const struct nx_bootprof_s *steps,
+                                 size_t index)
+{
+  struct timespec ts;
+  clock_t prev;
+  size_t linesize;
+  uint64_t total;
+  uint64_t delta;
+
+  prev = index > 0 ? steps[index - 1].time : steps[0].time;
+
+  perf_convert(steps[index].time - steps[0].time, &ts);
+  total = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  perf_convert(steps[index].time - prev, &ts);
+  delta = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  linesize = procfs_snprintf(attr->line, BOOTPROF_LINELEN,
+                             "%10" PRIu64 " %10" PRIu64 " %s\n",
+                             total, delta, steps[index].name);
+
+  return procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+}
+
+/****************************************************************************
+ * Name: bootprof_read
+ ****************************************************************************/
+
+static ssize_t bootprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR const struct nx_bootprof_s *steps;
+  FAR struct bootprof_file_s *attr;
+  size_t nsteps;
+  size_t linesize;
+  size_t i;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bootprof_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+  nsteps = nx_bootprof_get(&steps);
+
+  linesize = procfs_snprintf(attr->line, BOOTPROF_LINELEN,
+                             "%10s %10s %s\n", "TOTAL(us)", "STEP(us)",
+                             "NAME");
+  ret = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (i = 0; i < nsteps && ret < buflen; i++)
+    {
+      ret += bootprof_read_step(attr, buffer + ret, buflen - ret, &offset,
+                                steps, i);
+    }
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bootprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bootprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct bootprof_file_s *oldattr;
+  FAR struct bootprof_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct bootprof_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct bootprof_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct bootprof_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bootprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bootprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "bootprof" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_BOOTPROF && !CONFIG_FS_PROCFS_EXCLUDE_BOOTPROF
+        */
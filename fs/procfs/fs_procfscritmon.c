@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -277,6 +278,26 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
     {
       return totalsize;
     }
+
+#  ifdef CONFIG_SMP
+  /* Generate output for the number of contended critical section entries
+   * and reset the count.
+   */
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, ",%" PRIu32,
+                             g_crit_contention[cpu]);
+  g_crit_contention[cpu] = 0;
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  if (buflen <= 0)
+    {
+      return totalsize;
+    }
+#  endif
 #endif
 
   linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "\n");
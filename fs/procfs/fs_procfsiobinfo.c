@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -201,8 +202,9 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
   /* The first line is the headers */
 
   linesize  = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                              "%10s%10s%10s%10s\n",
-                              "ntotal", "nfree", "nwait", "nthrottle");
+                              "%10s%10s%10s%10s%10s%10s%10s\n",
+                              "ntotal", "nfree", "nwait", "nthrottle",
+                              "nminfree", "nwaited", "nfailed");
 
   copysize  = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                             &offset);
@@ -215,9 +217,12 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 
   iob_getstats(&stats);
   linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                               "%10d%10d%10d%10d\n",
+                               "%10d%10d%10d%10d%10d%10" PRIu32
+                               "%10" PRIu32 "\n",
                                stats.ntotal, stats.nfree,
-                               stats.nwait, stats.nthrottle);
+                               stats.nwait, stats.nthrottle,
+                               stats.nminfree, stats.nwaited,
+                               stats.nfailed);
 
   copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                              &offset);
@@ -45,6 +45,7 @@
 #include <nuttx/progmem.h>
 #include <nuttx/sched.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/mm/mempool.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 
@@ -345,6 +346,200 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+  /* Followed by the hit rates of the per-CPU caches of each heap */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%11s%11s%11s%11s%s\n",
+                                   "hits", "misses", "flushes", "cached",
+                                   " cache");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      int cpu;
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS && buflen > 0; cpu++)
+        {
+          struct mm_cacheinfo_s info;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mm_cacheinfo(entry->heap, cpu, &info);
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%11lu%11lu%11lu%11lu %s/cpu%d\n",
+                                       info.hits, info.misses,
+                                       info.flushes,
+                                       (unsigned long)info.cached,
+                                       entry->name, cpu);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+  /* Followed by the fragmentation index of each heap and the number of its
+   * free chunks by log2 of their size.
+   */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%7s%s\n", "frag",
+                                   " log2size:nfree ... name");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL && buflen > 0;
+       entry = entry->next)
+    {
+      struct mm_fraginfo_s info;
+      int i;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      mm_fraginfo(entry->heap, &info);
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%4u.%u%%", info.index / 10,
+                                   info.index % 10);
+      for (i = 0; i < MM_FRAGINFO_NEXTENTS; i++)
+        {
+          if (info.extents[i] > 0)
+            {
+              linesize += procfs_snprintf(procfile->line + linesize,
+                                          MEMINFO_LINELEN - linesize,
+                                          " %d:%lu",
+                                          i + MM_FRAGINFO_MINSHIFT,
+                                          info.extents[i]);
+            }
+        }
+
+      linesize  += procfs_snprintf(procfile->line + linesize,
+                                   MEMINFO_LINELEN - linesize,
+                                   " %s\n", entry->name);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 buflen, &offset);
+      totalsize += copysize;
+    }
+#endif
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+  /* Followed by the internal fragmentation of each mempool class of each
+   * heap and the class table that would minimize it.
+   */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%11s%11s%11s%7s%s\n",
+                                   "bsize", "nreq", "nbytes", "waste",
+                                   " pool");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      FAR struct mempool_multiple_s *mpool = mm_mempool(entry->heap);
+      struct mempool_classinfo_s info;
+      FAR size_t *poolsize;
+      ssize_t npools;
+      size_t i;
+
+      if (mpool == NULL)
+        {
+          continue;
+        }
+
+      for (i = 0; buflen > 0 &&
+                  mempool_multiple_classinfo(mpool, i, &info) >= 0; i++)
+        {
+          unsigned long total = info.blocksize * info.nrequest;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%11lu%11lu%11lu%6lu%% %s\n",
+                                       info.blocksize, info.nrequest,
+                                       info.nbytes,
+                                       total > 0 ? (total - info.nbytes) *
+                                                   100 / total : 0,
+                                       entry->name);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      if (buflen == 0)
+        {
+          break;
+        }
+
+      /* The requests too large for the mempool and the suggested table,
+       * which can be used for CONFIG_MM_HEAP_MEMPOOL_POOLSIZES.
+       */
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%11s%11lu%18s %s\n", "overflow",
+                                   mempool_multiple_overflow(mpool), "",
+                                   entry->name);
+
+      poolsize = fs_heap_malloc(i * sizeof(size_t));
+      if (poolsize != NULL)
+        {
+          npools = mempool_multiple_tune(mpool, poolsize, i);
+          if (npools > 0)
+            {
+              linesize += procfs_snprintf(procfile->line + linesize,
+                                          MEMINFO_LINELEN - linesize,
+                                          "%11s %zu", "suggest",
+                                          poolsize[0]);
+              for (i = 1; i < npools; i++)
+                {
+                  linesize += procfs_snprintf(procfile->line + linesize,
+                                              MEMINFO_LINELEN - linesize,
+                                              ",%zu", poolsize[i]);
+                }
+
+              linesize += procfs_snprintf(procfile->line + linesize,
+                                          MEMINFO_LINELEN - linesize,
+                                          " %s\n", entry->name);
+            }
+
+          fs_heap_free(poolsize);
+        }
+
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
 #ifdef CONFIG_MM_PGALLOC
   if (buflen > 0)
     {
@@ -450,6 +645,9 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
                  "used: dump all allocated node\n"
                  "free: dump all free node\n"
                  "orphan: dump allocated free neighbored node\n"
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+                 "poolreset: clear the mempool request statistics\n"
+#endif
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
                  "mempool: dump all mempool alloc node\n"
 #endif
@@ -507,6 +705,18 @@ static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
   procfile = filep->f_priv;
   DEBUGASSERT(procfile);
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+  if (strncmp(buffer, "poolreset", 9) == 0)
+    {
+      for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+        {
+          mempool_multiple_resetstats(mm_mempool(entry->heap));
+        }
+
+      return buflen;
+    }
+#endif
+
 #if CONFIG_MM_BACKTRACE > 0
   if (strcmp(buffer, "on") == 0)
     {
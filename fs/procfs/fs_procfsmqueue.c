@@ -0,0 +1,306 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsmqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mqueue.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0 && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_MQUEUE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MQUEUE_LINELEN 32
+
+/* The number of message allocation counters */
+
+#define MQUEUE_NSTATS 4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct mqueue_file_s
+{
+  struct procfs_file_s  base;     /* Base open file structure */
+  char line[MQUEUE_LINELEN];      /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     mqueue_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     mqueue_close(FAR struct file *filep);
+static ssize_t mqueue_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     mqueue_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     mqueue_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_mqueue_operations =
+{
+  mqueue_open,  /* open */
+  mqueue_close, /* close */
+  mqueue_read,  /* read */
+  NULL,         /* write */
+  NULL,         /* poll */
+
+  mqueue_dup,   /* dup */
+
+  NULL,         /* opendir */
+  NULL,         /* closedir */
+  NULL,         /* readdir */
+  NULL,         /* rewinddir */
+
+  mqueue_stat   /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mqueue_open
+ ****************************************************************************/
+
+static int mqueue_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct mqueue_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct mqueue_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mqueue_close
+ ****************************************************************************/
+
+static int mqueue_close(FAR struct file *filep)
+{
+  FAR struct mqueue_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct mqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mqueue_read
+ *
+ * Description:
+ *   Generate one "<name>: <count>" line for each message allocation
+ *   counter:
+ *
+ *     pool     - Messages taken from the reserved pool of a queue
+ *     poolmiss - Sends that found the reserved pool of a queue empty
+ *     heap     - Messages allocated from the heap
+ *     fail     - Message allocations that failed
+ *
+ ****************************************************************************/
+
+static ssize_t mqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct mqueue_file_s *attr;
+  FAR const char *names[MQUEUE_NSTATS];
+  int values[MQUEUE_NSTATS];
+  size_t linesize;
+  size_t copysize;
+  off_t offset;
+  ssize_t ret;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct mqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  names[0]  = "pool";
+  values[0] = atomic_load(&g_mqstats.pool);
+  names[1]  = "poolmiss";
+  values[1] = atomic_load(&g_mqstats.poolmiss);
+  names[2]  = "heap";
+  values[2] = atomic_load(&g_mqstats.heap);
+  names[3]  = "fail";
+  values[3] = atomic_load(&g_mqstats.fail);
+
+  ret    = 0;
+  offset = filep->f_pos;
+
+  for (i = 0; i < MQUEUE_NSTATS && ret < buflen; i++)
+    {
+      linesize = procfs_snprintf(attr->line, MQUEUE_LINELEN, "%s: %u\n",
+                                 names[i], (unsigned int)values[i]);
+      copysize = procfs_memcpy(attr->line, linesize, buffer + ret,
+                               buflen - ret, &offset);
+      ret     += copysize;
+    }
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mqueue_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mqueue_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct mqueue_file_s *oldattr;
+  FAR struct mqueue_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct mqueue_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct mqueue_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct mqueue_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mqueue_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mqueue_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "mqueue" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_MQ_MAXMSGSIZE > 0 && !CONFIG_FS_PROCFS_EXCLUDE_MQUEUE
+        */
@@ -99,6 +99,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  PROC_LATENCY,                       /* Wakeup latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -163,7 +166,7 @@ struct proc_envinfo_s
 
 static FAR const char * const g_policy[4] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -190,6 +193,14 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+static ssize_t proc_latency(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+static ssize_t proc_latency_write(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR const char *buffer,
+                 size_t buflen, off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -302,6 +313,13 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+static const struct proc_node_s g_latency =
+{
+  "latency",       "latency", (uint8_t)PROC_LATENCY,     DTYPE_FILE        /* Wakeup latency histogram */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -356,6 +374,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  &g_latency,      /* Wakeup latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -385,6 +406,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  &g_latency,      /* Wakeup latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -470,6 +494,7 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *   Priority:   nnn                Decimal, 0-255
  *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC}
  *   Sigmask:    nnnnnnnn           Hexadecimal, 32-bit
+ *   CPUTime:    sss.nnnnnnnnn      Seconds (CONFIG_SCHED_CPUTIME only)
  *
  ****************************************************************************/
 
@@ -479,6 +504,9 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
 {
   FAR const char *policy;
   FAR const char *name;
+#ifdef CONFIG_SCHED_CPUTIME
+  struct timespec cputime;
+#endif
   char state[32];
   size_t remaining;
   size_t linesize;
@@ -648,6 +676,29 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
                            &offset);
 
   totalsize += copysize;
+
+#ifdef CONFIG_SCHED_CPUTIME
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the CPU time consumed by the thread */
+
+  perf_convert(nxsched_get_cputime(tcb), &cputime);
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "%-12s%lu.%09lu\n", "CPUTime:",
+                             (unsigned long)cputime.tv_sec,
+                             (unsigned long)cputime.tv_nsec);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+#endif
+
   return totalsize;
 }
 
@@ -858,7 +909,7 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
   /* Reset the maximum */
 
   tcb->run_max = 0;
-  perf_convert(tcb->run_time, &runtime);
+  perf_convert(nxsched_get_cputime(tcb), &runtime);
 
   /* Output the maximum time the thread has run and
    * the total time the thread has run
@@ -880,6 +931,56 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_latency
+ *
+ * Description:
+ *   Generate the line "Latency:" followed by the SCHED_LATENCY_NBUCKETS
+ *   wakeup latency counters of the thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+static ssize_t proc_latency(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  size_t linesize;
+  int i;
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN, "%-12s",
+                             "Latency:");
+  for (i = 0; i < SCHED_LATENCY_NBUCKETS; i++)
+    {
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  STATUS_LINELEN - linesize,
+                                  " %" PRIu32, tcb->latency[i]);
+    }
+
+  linesize += procfs_snprintf(procfile->line + linesize,
+                              STATUS_LINELEN - linesize, "\n");
+
+  return procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+}
+
+/****************************************************************************
+ * Name: proc_latency_write
+ *
+ * Description:
+ *   Any write clears the wakeup latency histogram of the thread.
+ *
+ ****************************************************************************/
+
+static ssize_t proc_latency_write(FAR struct proc_file_s *procfile,
+                                  FAR struct tcb_s *tcb,
+                                  FAR const char *buffer,
+                                  size_t buflen, off_t offset)
+{
+  nxsched_reset_latency(tcb);
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1626,6 +1727,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+    case PROC_LATENCY: /* Wakeup latency histogram */
+      ret = proc_latency(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -1700,6 +1806,13 @@ static ssize_t proc_write(FAR struct file *filep, FAR const char *buffer,
 
   switch (procfile->node->node)
     {
+#ifdef CONFIG_SCHED_LATENCY
+      case PROC_LATENCY:
+        ret = proc_latency_write(procfile, tcb, buffer, buflen,
+                                 filep->f_pos);
+        break;
+#endif
+
 #ifdef CONFIG_DEBUG_MM
       case PROC_HEAP_CHECK:
         ret = proc_heapcheck_write(procfile, tcb, buffer, buflen,
@@ -0,0 +1,413 @@
+/****************************************************************************
+ * fs/procfs/fs_procfstasksnap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <malloc.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_TASKSNAP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TASKSNAP_RECSIZE sizeof(struct procfs_tasksnap_s)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The PID hash slot of the next
+ * record is remembered so that sequential reads do not rescan the table;
+ * it is only trusted while the file position is the one it was saved for.
+ */
+
+struct tasksnap_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  off_t pos;                    /* File position matching slot */
+  int slot;                     /* PID hash slot of the next record */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     tasksnap_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     tasksnap_close(FAR struct file *filep);
+static ssize_t tasksnap_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     tasksnap_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     tasksnap_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_tasksnap_operations =
+{
+  tasksnap_open,      /* open */
+  tasksnap_close,     /* close */
+  tasksnap_read,      /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  tasksnap_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  tasksnap_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tasksnap_fill
+ *
+ * Description:
+ *   Fill one record for the thread in PID hash slot 'slot'.
+ *
+ * Returned Value:
+ *   true if the slot holds a thread and 'snap' was filled.
+ *
+ ****************************************************************************/
+
+static bool tasksnap_fill(int slot, FAR struct procfs_tasksnap_s *snap)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+#if CONFIG_MM_BACKTRACE >= 0
+  struct mallinfo_task info;
+  struct malltask task;
+  bool kernel;
+#endif
+
+  memset(snap, 0, sizeof(*snap));
+
+  /* Take the fields that may change under us in one critical section so
+   * that they are consistent with each other.
+   */
+
+  flags = enter_critical_section();
+
+  tcb = slot < g_npidhash ? g_pidhash[slot] : NULL;
+  if (tcb == NULL)
+    {
+      leave_critical_section(flags);
+      return false;
+    }
+
+  snap->pid       = tcb->pid;
+  snap->group     = tcb->group ? tcb->group->tg_pid : -1;
+  snap->state     = tcb->task_state;
+  snap->priority  = tcb->sched_priority;
+  snap->type      = (tcb->flags & TCB_FLAG_TTYPE_MASK) >>
+                    TCB_FLAG_TTYPE_SHIFT;
+#ifdef CONFIG_SMP
+  snap->cpu       = tcb->cpu;
+#endif
+  snap->stacksize = tcb->adj_stack_size;
+
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  snap->cputicks  = tcb->ticks;
+  snap->cputotal  = g_cpuload_total;
+  snap->valid    |= TASKSNAP_VALID_CPULOAD;
+#endif
+
+#if CONFIG_MM_BACKTRACE >= 0
+  kernel = (tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL;
+#endif
+
+  leave_critical_section(flags);
+
+  /* The remaining fields take locks or walk memory.  Look the thread up
+   * again the way the /proc/<pid> files do; if it exited meanwhile they
+   * are simply left out.
+   */
+
+  tcb = nxsched_get_tcb(snap->pid);
+  if (tcb == NULL)
+    {
+      return true;
+    }
+
+#ifdef CONFIG_STACK_COLORATION
+  snap->stackused = up_check_tcbstack(tcb);
+  snap->valid    |= TASKSNAP_VALID_STACKUSED;
+#endif
+
+  if (tcb->group != NULL)
+    {
+      snap->nfds = files_countlist(&tcb->group->tg_filelist);
+    }
+
+#if CONFIG_MM_BACKTRACE >= 0
+  task.pid    = snap->pid;
+  task.seqmin = 0;
+  task.seqmax = ULONG_MAX;
+#  ifdef CONFIG_MM_KERNEL_HEAP
+  if (kernel)
+    {
+      info = fs_heap_mallinfo_task(&task);
+    }
+  else
+#  endif
+    {
+      UNUSED(kernel);
+      info = mallinfo_task(&task);
+    }
+
+  snap->heapused   = info.uordblks;
+  snap->heapblocks = info.aordblks;
+  snap->valid     |= TASKSNAP_VALID_HEAP;
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: tasksnap_open
+ ****************************************************************************/
+
+static int tasksnap_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct tasksnap_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes.  This is the only
+   * allocation; reads fill the caller's buffer directly.
+   */
+
+  attr = fs_heap_zalloc(sizeof(struct tasksnap_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasksnap_close
+ ****************************************************************************/
+
+static int tasksnap_close(FAR struct file *filep)
+{
+  FAR struct tasksnap_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct tasksnap_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasksnap_read
+ *
+ * Description:
+ *   Copy as many whole struct procfs_tasksnap_s records as fit in 'buffer',
+ *   one per thread.  Zero is returned once every thread has been reported;
+ *   seek back to zero to take a new snapshot.
+ *
+ ****************************************************************************/
+
+static ssize_t tasksnap_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct tasksnap_file_s *attr;
+  struct procfs_tasksnap_s snap;
+  size_t nread = 0;
+  off_t skip;
+  int slot;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct tasksnap_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (buflen < TASKSNAP_RECSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* Resume from the saved slot, or count records from the start if the
+   * file was repositioned.
+   */
+
+  if (filep->f_pos == attr->pos)
+    {
+      slot = attr->slot;
+      skip = 0;
+    }
+  else
+    {
+      slot = 0;
+      skip = filep->f_pos / TASKSNAP_RECSIZE;
+    }
+
+  for (; slot < g_npidhash && buflen - nread >= TASKSNAP_RECSIZE; slot++)
+    {
+      if (!tasksnap_fill(slot, &snap))
+        {
+          continue;
+        }
+
+      if (skip > 0)
+        {
+          skip--;
+          continue;
+        }
+
+      memcpy(buffer + nread, &snap, TASKSNAP_RECSIZE);
+      nread += TASKSNAP_RECSIZE;
+    }
+
+  filep->f_pos += nread;
+  attr->pos     = filep->f_pos;
+  attr->slot    = slot;
+  return nread;
+}
+
+/****************************************************************************
+ * Name: tasksnap_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int tasksnap_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct tasksnap_file_s *oldattr;
+  FAR struct tasksnap_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct tasksnap_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct tasksnap_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct tasksnap_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasksnap_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int tasksnap_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "tasksnap" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_TASKSNAP */
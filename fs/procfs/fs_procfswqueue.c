@@ -0,0 +1,319 @@
+/****************************************************************************
+ * fs/procfs/fs_procfswqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/wqueue.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_WORKQUEUE_PERWORKER) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define WQUEUE_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct wqueue_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[WQUEUE_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     wqueue_close(FAR struct file *filep);
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     wqueue_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     wqueue_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_wqueue_operations =
+{
+  wqueue_open,       /* open */
+  wqueue_close,      /* close */
+  wqueue_read,       /* read */
+  NULL,              /* write */
+  NULL,              /* poll */
+
+  wqueue_dup,        /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  wqueue_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wqueue_open
+ ****************************************************************************/
+
+static int wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct wqueue_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct wqueue_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_close
+ ****************************************************************************/
+
+static int wqueue_close(FAR struct file *filep)
+{
+  FAR struct wqueue_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_read_queue
+ *
+ * Description:
+ *   Generate the line "<name>:" followed by the WORK_LATENCY_NBUCKETS
+ *   latency counters of one work queue.
+ *
+ ****************************************************************************/
+
+static size_t wqueue_read_queue(FAR struct wqueue_file_s *attr,
+                                FAR char *buffer, size_t buflen,
+                                FAR off_t *offset, FAR const char *name,
+                                int qid)
+{
+  uint32_t latency[WORK_LATENCY_NBUCKETS];
+  size_t linesize;
+  int i;
+
+  if (work_queue_latency(qid, latency) < 0)
+    {
+      return 0;
+    }
+
+  linesize = procfs_snprintf(attr->line, WQUEUE_LINELEN, "%s:", name);
+  for (i = 0; i < WORK_LATENCY_NBUCKETS; i++)
+    {
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  WQUEUE_LINELEN - linesize,
+                                  " %" PRIu32, latency[i]);
+    }
+
+  linesize += procfs_snprintf(attr->line + linesize,
+                              WQUEUE_LINELEN - linesize, "\n");
+
+  return procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+}
+
+/****************************************************************************
+ * Name: wqueue_read
+ ****************************************************************************/
+
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct wqueue_file_s *attr;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  ret    = 0;
+  offset = filep->f_pos;
+
+#ifdef CONFIG_SCHED_HPWORK
+  ret += wqueue_read_queue(attr, buffer + ret, buflen - ret, &offset,
+                           "hpwork", HPWORK);
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK
+  if (ret < buflen)
+    {
+      ret += wqueue_read_queue(attr, buffer + ret, buflen - ret, &offset,
+                               "lpwork", LPWORK);
+    }
+#endif
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: wqueue_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wqueue_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wqueue_file_s *oldattr;
+  FAR struct wqueue_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct wqueue_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct wqueue_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct wqueue_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wqueue_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wqueue" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_WORKQUEUE_PERWORKER && !CONFIG_FS_PROCFS_EXCLUDE_WQUEUE
+        */
@@ -169,7 +169,8 @@ struct romfs_nodeinfo_s
   FAR struct romfs_nodeinfo_s **rn_child;  /* The node array for link to lower level */
   uint16_t rn_count;                       /* The count of node in rn_child level */
   uint8_t  rn_namesize;                    /* The length of name of the entry */
-  char     rn_name[1];                     /* The name to the entry */
+  FAR const char *rn_name;                 /* The name to the entry, in RAM
+                                            * or in the XIP media */
 #endif
 };
 
@@ -37,6 +37,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/blockcache.h>
 #include <nuttx/fs/ioctl.h>
 
 #include "fs_romfs.h"
@@ -48,7 +49,7 @@
 
 #define LINK_NOT_FOLLOWED 0
 #define LINK_FOLLOWED     1
-#define NODEINFO_NINCR    4
+#define NODEINFO_NINIT    4
 
 /****************************************************************************
  * Private Types
@@ -87,76 +88,6 @@ static uint32_t romfs_devread32(FAR struct romfs_mountpt_s *rm, int ndx)
            ((uint32_t)rm->rm_buffer[ndx + 3] & 0xff));
 }
 
-/****************************************************************************
- * Name: romfs_checkentry
- *
- * Description:
- *   Check if the entry at offset is a directory or file path segment
- *
- ****************************************************************************/
-
-#ifndef CONFIG_FS_ROMFS_CACHE_NODE
-static inline int romfs_checkentry(FAR struct romfs_mountpt_s *rm,
-                                   uint32_t offset,
-                                   FAR const char *entryname, int entrylen,
-                                   FAR struct romfs_nodeinfo_s *nodeinfo)
-{
-  char name[NAME_MAX + 1];
-  uint32_t linkoffset;
-  uint32_t next;
-  uint32_t info;
-  uint32_t size;
-  int ret;
-
-  /* Parse the directory entry at this offset (which may be re-directed
-   * to some other entry if HARLINKED).
-   */
-
-  ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info, &size);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Get the name of the directory entry. */
-
-  ret = romfs_parsefilename(rm, offset, name);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Then check if this the name segment we are looking for.  The
-   * string comparison is awkward because there is no terminator
-   * on entryname (there is a terminator on name, however)
-   */
-
-  if (strlen(name) == entrylen &&
-      memcmp(entryname, name, entrylen) == 0)
-    {
-      /* Found it -- save the component info and return success */
-
-      if (IS_DIRECTORY(next))
-        {
-          nodeinfo->rn_offset = info;
-          nodeinfo->rn_size   = 0;
-        }
-      else
-        {
-          nodeinfo->rn_offset = linkoffset;
-          nodeinfo->rn_size   = size;
-        }
-
-      nodeinfo->rn_next       = next;
-      return 0;
-    }
-
-  /* The entry is not a directory or it does not have the matching name */
-
-  return -ENOENT;
-}
-#endif
-
 /****************************************************************************
  * Name: romfs_devcacheread
  *
@@ -211,6 +142,129 @@ static int16_t romfs_devcacheread(FAR struct romfs_mountpt_s *rm,
   return offset & SEC_NDXMASK(rm);
 }
 
+/****************************************************************************
+ * Name: romfs_comparefilename
+ *
+ * Description:
+ *   Compare the name of the directory entry at offset with entryname in
+ *   place, a 16-byte chunk at a time, without copying the name out of
+ *   the sector buffer (which is the media itself in XIP mode).
+ *
+ * Returned Value:
+ *   0 if the names match, 1 if they do not, or a negated errno value on a
+ *   failure to read the media.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_ROMFS_CACHE_NODE
+static int romfs_comparefilename(FAR struct romfs_mountpt_s *rm,
+                                 uint32_t offset,
+                                 FAR const char *entryname, int entrylen)
+{
+  FAR const char *chunk;
+  int16_t  ndx;
+  uint16_t namelen = 0;
+  uint16_t chunklen;
+  bool     done;
+
+  offset += ROMFS_FHDR_NAME;
+  do
+    {
+      /* Read the sector into memory */
+
+      ndx = romfs_devcacheread(rm, offset + namelen);
+      if (ndx < 0)
+        {
+          return ndx;
+        }
+
+      /* Is the name terminated in this 16-byte block */
+
+      chunk = (FAR const char *)&rm->rm_buffer[ndx];
+      done  = chunk[15] == '\0';
+      chunklen = done ? strlen(chunk) : 16;
+
+      /* Names are truncated to NAME_MAX as in romfs_parsefilename() */
+
+      if (namelen + chunklen > NAME_MAX)
+        {
+          chunklen = NAME_MAX - namelen;
+          done     = true;
+        }
+
+      if (namelen + chunklen > entrylen ||
+          memcmp(&entryname[namelen], chunk, chunklen) != 0)
+        {
+          return 1;
+        }
+
+      namelen += chunklen;
+    }
+  while (!done);
+
+  return namelen == entrylen ? 0 : 1;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_checkentry
+ *
+ * Description:
+ *   Check if the entry at offset is a directory or file path segment
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_ROMFS_CACHE_NODE
+static inline int romfs_checkentry(FAR struct romfs_mountpt_s *rm,
+                                   uint32_t offset,
+                                   FAR const char *entryname, int entrylen,
+                                   FAR struct romfs_nodeinfo_s *nodeinfo)
+{
+  uint32_t linkoffset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t size;
+  int ret;
+
+  /* Check if this the name segment we are looking for before anything
+   * else, so that the entries that do not match cost no more than the
+   * name comparison.
+   */
+
+  ret = romfs_comparefilename(rm, offset, entryname, entrylen);
+  if (ret != 0)
+    {
+      return ret < 0 ? ret : -ENOENT;
+    }
+
+  /* Parse the directory entry at this offset (which may be re-directed
+   * to some other entry if HARLINKED).
+   */
+
+  ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info, &size);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Found it -- save the component info and return success */
+
+  if (IS_DIRECTORY(next))
+    {
+      nodeinfo->rn_offset = info;
+      nodeinfo->rn_size   = 0;
+    }
+  else
+    {
+      nodeinfo->rn_offset = linkoffset;
+      nodeinfo->rn_size   = size;
+    }
+
+  nodeinfo->rn_next = next;
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_followhardlinks
  *
@@ -401,27 +455,32 @@ static inline int romfs_searchdir(FAR struct romfs_mountpt_s *rm,
  * Name: romfs_cachenode
  *
  * Description:
- *   Alloc all entry node at once when filesystem is mounted
+ *   Alloc all entry node at once when filesystem is mounted.  If 'copy' is
+ *   false, 'name' stays valid for the life of the mount (it is in the XIP
+ *   media) and the node refers to it instead of keeping a copy in RAM.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
 static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
                            uint32_t offset, uint32_t next,
-                           uint32_t size, FAR const char *name,
+                           uint32_t size, FAR const char *name, bool copy,
                            FAR struct romfs_nodeinfo_s **pnodeinfo)
 {
   FAR struct romfs_nodeinfo_s **child;
   FAR struct romfs_nodeinfo_s *nodeinfo;
-  char childname[NAME_MAX + 1];
+  FAR const char *childname;
+  char namebuf[NAME_MAX + 1];
+  uint32_t entryoffset;
   uint32_t linkoffset;
   uint32_t info;
-  uint8_t num = 0;
+  uint16_t num = 0;
   size_t nsize;
   int ret;
 
   nsize = strlen(name);
-  nodeinfo = fs_heap_zalloc(sizeof(struct romfs_nodeinfo_s) + nsize);
+  nodeinfo = fs_heap_zalloc(sizeof(struct romfs_nodeinfo_s) +
+                            (copy ? nsize + 1 : 0));
   if (nodeinfo == NULL)
     {
       return -ENOMEM;
@@ -431,21 +490,29 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
   nodeinfo->rn_offset     = offset;
   nodeinfo->rn_next       = next;
   nodeinfo->rn_namesize   = nsize;
-  memcpy(nodeinfo->rn_name, name, nsize + 1);
+  if (copy)
+    {
+      memcpy(nodeinfo + 1, name, nsize + 1);
+      nodeinfo->rn_name   = (FAR const char *)(nodeinfo + 1);
+    }
+  else
+    {
+      nodeinfo->rn_name   = name;
+    }
+
   if (!IS_DIRECTORY(next))
     {
       nodeinfo->rn_size = size;
       return 0;
     }
 
-  child = nodeinfo->rn_child;
-
   do
     {
       /* Parse the directory entry at this offset (which may be re-directed
        * to some other entry if HARLINKED).
        */
 
+      entryoffset = offset;
       ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info,
                                 &size);
       if (ret < 0)
@@ -453,29 +520,54 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
           return ret;
         }
 
-      ret = romfs_parsefilename(rm, offset, childname);
+      ret = romfs_parsefilename(rm, offset, namebuf);
       if (ret < 0)
         {
           return ret;
         }
 
+      /* In XIP mode, refer to the name where it is in the media unless it
+       * had to be truncated.
+       */
+
+      childname = namebuf;
+      copy      = true;
+      if (rm->rm_xipbase != NULL && strlen(namebuf) < NAME_MAX)
+        {
+          childname = (FAR const char *)rm->rm_xipbase + entryoffset +
+                      ROMFS_FHDR_NAME;
+          copy      = false;
+        }
+
       if (strcmp(childname, ".") != 0 && strcmp(childname, "..") != 0)
         {
-          if (child == NULL || nodeinfo->rn_count == num - 1)
+          if (nodeinfo->rn_count == num)
             {
               FAR void *tmp;
+              uint16_t newnum;
+
+              /* Grow the array geometrically so that large directories
+               * do not cost a reallocation per few entries.
+               */
+
+              newnum = num == 0 ? NODEINFO_NINIT :
+                       num < UINT16_MAX / 2 ? 2 * num : UINT16_MAX;
+              if (newnum == num)
+                {
+                  return -EFBIG;
+                }
 
               tmp = fs_heap_realloc(nodeinfo->rn_child,
-                    (num + NODEINFO_NINCR) * sizeof(*nodeinfo->rn_child));
+                                    newnum * sizeof(*nodeinfo->rn_child));
               if (tmp == NULL)
                 {
                   return -ENOMEM;
                 }
 
               nodeinfo->rn_child = tmp;
-              memset(nodeinfo->rn_child + num, 0, NODEINFO_NINCR *
+              memset(nodeinfo->rn_child + num, 0, (newnum - num) *
                      sizeof(*nodeinfo->rn_child));
-              num += NODEINFO_NINCR;
+              num = newnum;
             }
 
           child = &nodeinfo->rn_child[nodeinfo->rn_count++];
@@ -485,7 +577,7 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
             }
 
           ret = romfs_cachenode(rm, linkoffset, next, size,
-                                childname, child);
+                                childname, copy, child);
           if (ret < 0)
             {
               nodeinfo->rn_count--;
@@ -540,7 +632,8 @@ int romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
 
       FAR struct inode *inode = rm->rm_blkdriver;
       ssize_t nsectorsread =
-        inode->u.i_bops->read(inode, buffer, sector, nsectors);
+        blockcache_read(inode, buffer, sector, nsectors,
+                        rm->rm_hwsectorsize);
 
       if (nsectorsread < 0)
         {
@@ -731,7 +824,8 @@ int romfs_fsconfigure(FAR struct romfs_mountpt_s *rm)
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
   ndx               = romfs_cachenode(rm, ROMFS_ALIGNUP(ROMFS_VHDR_VOLNAME +
                                                         strlen(name) + 1),
-                                      RFNEXT_DIRECTORY, 0, "", &rm->rm_root);
+                                      RFNEXT_DIRECTORY, 0, "", true,
+                                      &rm->rm_root);
   if (ndx < 0)
     {
       romfs_freenode(rm->rm_root);
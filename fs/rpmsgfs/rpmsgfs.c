@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -73,6 +74,14 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  FAR char                   *buf;     /* Read ahead or write behind data */
+  size_t                     bufpos;   /* Next byte to return from buf */
+  size_t                     buflen;   /* Number of valid bytes in buf */
+  bool                       bufdirty; /* buf holds writes not yet sent */
+  bool                       bufcheck; /* Whether the file can be buffered
+                                        * is not known yet */
+#endif
 };
 
 /* This structure represents the overall mountpoint state.  An instance of
@@ -93,6 +102,15 @@ struct rpmsgfs_mountpt_s
  * Private Function Prototypes
  ****************************************************************************/
 
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+static bool    rpmsgfs_buffered(FAR struct rpmsgfs_mountpt_s *fs,
+                                FAR struct rpmsgfs_ofile_s *hf);
+static int     rpmsgfs_flush(FAR struct rpmsgfs_mountpt_s *fs,
+                             FAR struct rpmsgfs_ofile_s *hf);
+#else
+#  define rpmsgfs_flush(fs, hf) OK
+#endif
+
 static int     rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
                             int oflags, mode_t mode);
 static int     rpmsgfs_close(FAR struct file *filep);
@@ -272,6 +290,70 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: rpmsgfs_buffered
+ *
+ * Description:
+ *   Return true if the open file uses the read ahead / write behind
+ *   buffer.  Only regular files are buffered: reading ahead of a device or
+ *   a FIFO would block or consume data the application did not ask for.
+ *   The buffer is allocated when the file is first read or written.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+static bool rpmsgfs_buffered(FAR struct rpmsgfs_mountpt_s *fs,
+                             FAR struct rpmsgfs_ofile_s *hf)
+{
+  struct stat buf;
+
+  if (hf->bufcheck)
+    {
+      hf->bufcheck = false;
+      if (rpmsgfs_client_fstat(fs->handle, hf->fd, &buf) >= 0 &&
+          S_ISREG(buf.st_mode))
+        {
+          hf->buf = fs_heap_malloc(CONFIG_FS_RPMSGFS_BUFFER_SIZE);
+        }
+    }
+
+  return hf->buf != NULL;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_flush
+ *
+ * Description:
+ *   Empty the buffer of the open file: send the writes gathered in it, or
+ *   move the remote file position back over the data that was read ahead
+ *   but not consumed.  Afterwards the remote file matches what the
+ *   application has done through this open file.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_flush(FAR struct rpmsgfs_mountpt_s *fs,
+                         FAR struct rpmsgfs_ofile_s *hf)
+{
+  off_t ret = OK;
+
+  if (hf->bufdirty)
+    {
+      ret = rpmsgfs_client_write(fs->handle, hf->fd, hf->buf, hf->buflen);
+    }
+  else if (hf->bufpos < hf->buflen)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd,
+                                 -(off_t)(hf->buflen - hf->bufpos),
+                                 SEEK_CUR);
+    }
+
+  hf->bufdirty = false;
+  hf->bufpos   = 0;
+  hf->buflen   = 0;
+  return ret < 0 ? (int)ret : OK;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -367,6 +449,13 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
   hf->fnext = fs->fs_head;
   hf->crefs = 1;
   hf->oflags = oflags;
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  hf->buf      = NULL;
+  hf->bufpos   = 0;
+  hf->buflen   = 0;
+  hf->bufdirty = false;
+  hf->bufcheck = true;
+#endif
   fs->fs_head = hf;
 
   ret = OK;
@@ -461,18 +550,22 @@ static int rpmsgfs_close(FAR struct file *filep)
         }
     }
 
-  /* Close the host file */
+  /* Send any buffered writes, then close the host file */
 
+  ret = rpmsgfs_flush(fs, hf);
   rpmsgfs_client_close(fs->handle, hf->fd);
 
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  fs_heap_free(hf->buf);
+#endif
   fs_heap_free(hf);
 
 okout:
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -485,6 +578,9 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR struct rpmsgfs_mountpt_s *fs;
   FAR struct rpmsgfs_ofile_s *hf;
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  size_t nread;
+#endif
   ssize_t ret;
 
   /* Sanity checks */
@@ -507,6 +603,74 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  if (buflen > 0 && rpmsgfs_buffered(fs, hf))
+    {
+      /* Send the pending writes before reading anything back */
+
+      if (hf->bufdirty)
+        {
+          ret = rpmsgfs_flush(fs, hf);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+        }
+
+      /* Return the data read ahead, and refill the buffer with one
+       * request whenever what is left to read is smaller than it.  A
+       * short refill means the end of the file was reached.
+       */
+
+      for (nread = 0, ret = 0; nread < buflen; )
+        {
+          if (hf->bufpos < hf->buflen)
+            {
+              size_t n = MIN(buflen - nread, hf->buflen - hf->bufpos);
+
+              memcpy(buffer + nread, hf->buf + hf->bufpos, n);
+              hf->bufpos += n;
+              nread      += n;
+            }
+          else if (ret != 0 && ret < CONFIG_FS_RPMSGFS_BUFFER_SIZE)
+            {
+              break;
+            }
+          else if (buflen - nread >= CONFIG_FS_RPMSGFS_BUFFER_SIZE)
+            {
+              ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer + nread,
+                                        buflen - nread);
+              if (ret > 0)
+                {
+                  nread += ret;
+                }
+
+              break;
+            }
+          else
+            {
+              ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->buf,
+                                        CONFIG_FS_RPMSGFS_BUFFER_SIZE);
+              if (ret <= 0)
+                {
+                  break;
+                }
+
+              hf->bufpos = 0;
+              hf->buflen = ret;
+            }
+        }
+
+      if (nread > 0)
+        {
+          filep->f_pos += nread;
+          ret = nread;
+        }
+
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the read */
 
   ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
@@ -515,6 +679,9 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
       filep->f_pos += ret;
     }
 
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+errout_with_lock:
+#endif
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -559,6 +726,37 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_lock;
     }
 
+#if CONFIG_FS_RPMSGFS_BUFFER_SIZE > 0
+  if (buflen > 0 && rpmsgfs_buffered(fs, hf))
+    {
+      /* Drop the data read ahead, and send the pending writes if the new
+       * data does not fit behind them.
+       */
+
+      if (!hf->bufdirty ||
+          hf->buflen + buflen > CONFIG_FS_RPMSGFS_BUFFER_SIZE)
+        {
+          ret = rpmsgfs_flush(fs, hf);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+        }
+
+      /* Gather writes smaller than the buffer */
+
+      if (buflen < CONFIG_FS_RPMSGFS_BUFFER_SIZE)
+        {
+          memcpy(hf->buf + hf->buflen, buffer, buflen);
+          hf->buflen  += buflen;
+          hf->bufdirty = true;
+          filep->f_pos += buflen;
+          ret = buflen;
+          goto errout_with_lock;
+        }
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
@@ -605,7 +803,12 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
-  ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+    }
+
   if (ret >= 0)
     {
       filep->f_pos = ret;
@@ -648,7 +851,12 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
-  ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+    }
+
   if (ret == 0 && (cmd == FIONBIO || cmd == FIOCLEX || cmd == FIONCLEX))
     {
       ret = -ENOTTY;
@@ -693,10 +901,11 @@ static int rpmsgfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  ret = rpmsgfs_flush(fs, hf);
   rpmsgfs_client_sync(fs->handle, hf->fd);
 
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -769,7 +978,11 @@ static int rpmsgfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call the host to perform the read */
 
-  ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -815,7 +1028,11 @@ static int rpmsgfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
-  ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -856,7 +1073,11 @@ static int rpmsgfs_truncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
-  ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+  ret = rpmsgfs_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
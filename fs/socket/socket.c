@@ -34,6 +34,7 @@
 #include <sys/socket.h>
 #include <assert.h>
 #include <fcntl.h>
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -52,9 +53,13 @@ static ssize_t sock_file_write(FAR struct file *filep,
                                FAR const char *buffer, size_t buflen);
 static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int sock_file_poll(FAR struct file *filep, struct pollfd *fds,
                           bool setup);
 static int sock_file_truncate(FAR struct file *filep, off_t length);
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct uio *uio);
 
 /****************************************************************************
  * Private Data
@@ -68,9 +73,11 @@ static const struct file_operations g_sock_fileops =
   sock_file_write,    /* write */
   NULL,               /* seek */
   sock_file_ioctl,    /* ioctl */
-  NULL,               /* mmap */
+  sock_file_mmap,     /* mmap */
   sock_file_truncate, /* truncate */
-  sock_file_poll      /* poll */
+  sock_file_poll,     /* poll */
+  NULL,               /* readv */
+  sock_file_writev    /* writev */
 };
 
 static struct inode g_sock_inode =
@@ -138,6 +145,12 @@ static int sock_file_ioctl(FAR struct file *filep, int cmd,
   return psock_ioctl(filep->f_priv, cmd, arg);
 }
 
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map)
+{
+  return psock_mmap(filep->f_priv, map);
+}
+
 static int sock_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup)
 {
@@ -149,6 +162,28 @@ static int sock_file_truncate(FAR struct file *filep, off_t length)
   return -EINVAL;
 }
 
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct uio *uio)
+{
+  struct msghdr msg;
+
+  /* Hand the whole vector to the protocol in one sendmsg() so that it
+   * goes out as a single send (one datagram for datagram sockets).
+   */
+
+  if (uio->uio_iovcnt <= 0)
+    {
+      return 0;
+    }
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov    = (FAR struct iovec *)uio->uio_iov;
+  msg.msg_iovlen = uio->uio_iovcnt;
+  return psock_sendmsg(filep->f_priv, &msg,
+                       (uio->uio_flags & UIO_NONBLOCK) != 0 ?
+                       MSG_DONTWAIT : 0);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
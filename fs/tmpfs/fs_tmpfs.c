@@ -94,11 +94,29 @@ struct tmpfs_dir_s
 
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
+static size_t tmpfs_span(unsigned int level);
+static FAR uint8_t *tmpfs_get_page(FAR struct tmpfs_file_s *tfo,
+              size_t pageno, bool alloc);
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+              FAR void **slot, unsigned int level, size_t first);
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo);
+static FAR uint8_t *tmpfs_file_addr(FAR struct tmpfs_file_s *tfo,
+              size_t pos, FAR size_t *len, bool alloc);
+static int  tmpfs_linearize(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
+static uint32_t tmpfs_hash_name(FAR const char *name, size_t len);
+static void tmpfs_hash_insert(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo,
+              unsigned int nbuckets);
+static FAR uint16_t *tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_drop_dirent(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name, size_t len);
 static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -141,6 +159,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
               size_t buflen);
 static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
               size_t buflen);
+static ssize_t tmpfs_readv(FAR struct file *filep,
+              FAR const struct uio *uio);
+static ssize_t tmpfs_writev(FAR struct file *filep,
+              FAR const struct uio *uio);
 static off_t tmpfs_seek(FAR struct file *filep, off_t offset, int whence);
 static int  tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int  tmpfs_sync(FAR struct file *filep);
@@ -190,8 +212,8 @@ const struct mountpt_operations g_tmpfs_operations =
   tmpfs_mmap,       /* mmap */
   tmpfs_truncate,   /* truncate */
   NULL,             /* poll */
-  NULL,             /* readv */
-  NULL,             /* writev */
+  tmpfs_readv,      /* readv */
+  tmpfs_writev,     /* writev */
 
   tmpfs_sync,       /* sync */
   tmpfs_dup,        /* dup */
@@ -268,8 +290,263 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_span
+ *
+ * Description:
+ *   Return the number of data pages covered by a node of the page index at
+ *   'level'.  Level 1 is a data page itself.
+ *
+ ****************************************************************************/
+
+static size_t tmpfs_span(unsigned int level)
+{
+  size_t span = 1;
+
+  while (--level > 0)
+    {
+      span *= TMPFS_FANOUT;
+    }
+
+  return span;
+}
+
+/****************************************************************************
+ * Name: tmpfs_get_page
+ *
+ * Description:
+ *   Return the data page 'pageno' of the file.  If 'alloc' is true, the
+ *   page, and any index nodes leading to it, are allocated (zeroed) if they
+ *   do not exist yet.  NULL is returned for a page that was never written
+ *   (a hole, that reads as zeros) or, when allocating, if there is no
+ *   memory.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_get_page(FAR struct tmpfs_file_s *tfo,
+                                   size_t pageno, bool alloc)
+{
+  FAR void **slot;
+  FAR void **node;
+  unsigned int level;
+  size_t span;
+
+  /* Grow the index upwards until it covers the page */
+
+  if (tfo->tfo_root == NULL)
+    {
+      tfo->tfo_height = 0;
+    }
+
+  while (tfo->tfo_height == 0 || pageno >= tmpfs_span(tfo->tfo_height))
+    {
+      if (!alloc)
+        {
+          return NULL;
+        }
+      else if (tfo->tfo_root == NULL)
+        {
+          /* Empty index: just start it at the required height */
+
+          tfo->tfo_height++;
+          continue;
+        }
+
+      node = fs_heap_zalloc(TMPFS_PAGESIZE);
+      if (node == NULL)
+        {
+          return NULL;
+        }
+
+      node[0]         = tfo->tfo_root;
+      tfo->tfo_root   = node;
+      tfo->tfo_alloc += TMPFS_PAGESIZE;
+      tfo->tfo_height++;
+    }
+
+  /* Then walk down to the page */
+
+  slot = &tfo->tfo_root;
+  for (level = tfo->tfo_height; ; level--)
+    {
+      if (*slot == NULL)
+        {
+          if (!alloc)
+            {
+              return NULL;
+            }
+
+          *slot = fs_heap_zalloc(TMPFS_PAGESIZE);
+          if (*slot == NULL)
+            {
+              return NULL;
+            }
+
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
+        }
+
+      if (level == 1)
+        {
+          return *slot;
+        }
+
+      span    = tmpfs_span(level - 1);
+      node    = *slot;
+      slot    = &node[pageno / span];
+      pageno %= span;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Free the data pages with an index of 'first' or greater (relative to
+ *   the node) below the index node at 'slot' on 'level', together with the
+ *   index nodes that become unused.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+                             FAR void **slot, unsigned int level,
+                             size_t first)
+{
+  FAR void **node = *slot;
+  size_t span;
+  size_t i;
+
+  if (node == NULL)
+    {
+      return;
+    }
+
+  if (level > 1)
+    {
+      span = tmpfs_span(level - 1);
+      for (i = first / span; i < TMPFS_FANOUT; i++)
+        {
+          tmpfs_free_pages(tfo, &node[i], level - 1,
+                           i * span >= first ? 0 : first - i * span);
+        }
+    }
+
+  if (first == 0)
+    {
+      fs_heap_free(node);
+      tfo->tfo_alloc -= TMPFS_PAGESIZE;
+      *slot = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_data
+ *
+ * Description:
+ *   Free all of the data of a file before the file object itself is freed.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo)
+{
+  tmpfs_free_pages(tfo, &tfo->tfo_root, tfo->tfo_height, 0);
+  fs_heap_free(tfo->tfo_data);
+  tfo->tfo_data   = NULL;
+  tfo->tfo_height = 0;
+  tfo->tfo_alloc  = 0;
+}
+
+/****************************************************************************
+ * Name: tmpfs_file_addr
+ *
+ * Description:
+ *   Return the address of the file data at 'pos' and reduce '*len' to the
+ *   number of bytes that are contiguous in memory from there.  NULL is
+ *   returned for a hole or, if 'alloc' is true, when out of memory.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_file_addr(FAR struct tmpfs_file_s *tfo,
+                                    size_t pos, FAR size_t *len, bool alloc)
+{
+  FAR uint8_t *page;
+  size_t offset;
+
+  if (tfo->tfo_data != NULL)
+    {
+      return tfo->tfo_data + pos;
+    }
+
+  offset = pos % TMPFS_PAGESIZE;
+  if (*len > TMPFS_PAGESIZE - offset)
+    {
+      *len = TMPFS_PAGESIZE - offset;
+    }
+
+  page = tmpfs_get_page(tfo, pos / TMPFS_PAGESIZE, alloc);
+  return page != NULL ? page + offset : NULL;
+}
+
+/****************************************************************************
+ * Name: tmpfs_linearize
+ *
+ * Description:
+ *   Memory mapping and execute in place need the file data in one piece.
+ *   Move the pages of the file into one contiguous buffer, where the data
+ *   then stays for the life of the file (or until it is truncated to zero
+ *   while it is not mapped).
+ *
+ ****************************************************************************/
+
+static int tmpfs_linearize(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *data;
+  FAR uint8_t *page;
+  size_t allocsize;
+  size_t pos;
+  size_t len;
+
+  if (tfo->tfo_data != NULL || tfo->tfo_size == 0)
+    {
+      return OK;
+    }
+
+  allocsize = tfo->tfo_size + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  if (allocsize < tfo->tfo_size)
+    {
+      return -ENOMEM;
+    }
+
+  data = fs_heap_zalloc(allocsize);
+  if (data == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (pos = 0; pos < tfo->tfo_size; pos += len)
+    {
+      len  = tfo->tfo_size - pos;
+      page = tmpfs_file_addr(tfo, pos, &len, false);
+      if (page != NULL)
+        {
+          memcpy(data + pos, page, len);
+        }
+    }
+
+  tmpfs_free_pages(tfo, &tfo->tfo_root, tfo->tfo_height, 0);
+  tfo->tfo_height = 0;
+  tfo->tfo_alloc  = allocsize;
+  tfo->tfo_data   = data;
+  return OK;
+}
+
 /****************************************************************************
  * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the size of the file.  Data beyond the end of the file always
+ *   reads as zeros, so when the file grows the new range is zero, and
+ *   when it shrinks the data past the new end is released or cleared.
+ *
  ****************************************************************************/
 
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
@@ -279,15 +556,44 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   size_t allocsize;
   size_t delta;
 
-  /* Are we growing or shrinking the object? */
+  if (tfo->tfo_data == NULL)
+    {
+      /* Paged file: growing just moves the end of file over a hole.
+       * Shrinking frees the pages beyond the new end and clears the tail
+       * of the new last page.
+       */
+
+      if (newsize < tfo->tfo_size)
+        {
+          FAR uint8_t *page;
+          size_t offset = newsize % TMPFS_PAGESIZE;
+
+          tmpfs_free_pages(tfo, &tfo->tfo_root, tfo->tfo_height,
+                           (newsize + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE);
+          if (offset != 0)
+            {
+              page = tmpfs_get_page(tfo, newsize / TMPFS_PAGESIZE, false);
+              if (page != NULL)
+                {
+                  memset(page + offset, 0, TMPFS_PAGESIZE - offset);
+                }
+            }
+        }
+
+      tfo->tfo_size = newsize;
+      return OK;
+    }
+
+  /* Contiguous file.  Are we growing or shrinking the object? */
 
   if (newsize <= tfo->tfo_alloc)
     {
       /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
+       * zero, unless the data is mapped.  The file then goes back to
+       * paged storage.
        */
 
-      if (newsize == 0)
+      if (newsize == 0 && tfo->tfo_nmaps == 0)
         {
           /* Free the file object */
 
@@ -297,24 +603,24 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
           tfo->tfo_size = 0;
           return OK;
         }
-      else if (newsize > 0)
+      else if (newsize < tfo->tfo_size)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          /* We should make sure the shrunked memory be zero */
 
-          delta = tfo->tfo_alloc - newsize;
+          memset(tfo->tfo_data + newsize, 0, tfo->tfo_size - newsize);
+        }
 
-          /* We should make sure the shrunked memory be zero */
+      /* Otherwise, don't realloc unless the object has shrunk by a lot
+       * (nor at all while it is mapped).
+       */
 
-          memset(tfo->tfo_data + newsize, 0, delta);
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+      delta = tfo->tfo_alloc - newsize;
+      if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD || tfo->tfo_nmaps > 0)
+        {
+          /* Hasn't shrunk enough.. Return doing nothing for now */
 
-              tfo->tfo_size = newsize;
-              return OK;
-            }
+          tfo->tfo_size = newsize;
+          return OK;
         }
     }
 
@@ -338,6 +644,13 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
       return -ENOMEM;
     }
 
+  /* Zero the memory beyond the old allocation */
+
+  if (allocsize > tfo->tfo_alloc)
+    {
+      memset(newdata + tfo->tfo_alloc, 0, allocsize - tfo->tfo_alloc);
+    }
+
   /* Return the new address of the reallocated file object */
 
   tfo->tfo_alloc = allocsize;
@@ -383,7 +696,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -418,6 +731,135 @@ static int tmpfs_release_file(FAR struct tmpfs_file_s *tfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_hash_name
+ *
+ * Description:
+ *   Return the FNV-1a hash of the first 'len' characters of 'name'.
+ *
+ ****************************************************************************/
+
+static uint32_t tmpfs_hash_name(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_insert
+ *
+ * Description:
+ *   Link directory entry 'index' into the head of its hash chain.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_insert(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *head;
+
+  head = &tdo->tdo_hash[tde->tde_hash & (tdo->tdo_nbuckets - 1)];
+  tde->tde_next = *head;
+  *head         = index + 1;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_rebuild
+ *
+ * Description:
+ *   Replace the hash index of the directory with one of 'nbuckets' buckets
+ *   (a power of two).  If the memory is not available, the directory falls
+ *   back to the linear search.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo,
+                               unsigned int nbuckets)
+{
+  unsigned int i;
+
+  fs_heap_free(tdo->tdo_hash);
+  tdo->tdo_nbuckets = 0;
+  tdo->tdo_hash     = fs_heap_zalloc(nbuckets * sizeof(uint16_t));
+  if (tdo->tdo_hash == NULL)
+    {
+      return;
+    }
+
+  tdo->tdo_nbuckets = nbuckets;
+  for (i = 0; i < tdo->tdo_nentries; i++)
+    {
+      tmpfs_hash_insert(tdo, i);
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_link
+ *
+ * Description:
+ *   Return the location in the hash index that refers to directory entry
+ *   'index': either a bucket head or the tde_next of the previous entry.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+                                     unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *link;
+
+  link = &tdo->tdo_hash[tde->tde_hash & (tdo->tdo_nbuckets - 1)];
+  while (*link != index + 1)
+    {
+      DEBUGASSERT(*link != 0);
+      link = &tdo->tdo_entry[*link - 1].tde_next;
+    }
+
+  return link;
+}
+
+/****************************************************************************
+ * Name: tmpfs_drop_dirent
+ *
+ * Description:
+ *   Remove directory entry 'index' by replacing it with the final directory
+ *   entry, keeping the hash index consistent.  The caller has already
+ *   released the entry name.
+ *
+ ****************************************************************************/
+
+static void tmpfs_drop_dirent(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  unsigned int last = tdo->tdo_nentries - 1;
+
+  if (tdo->tdo_hash != NULL)
+    {
+      *tmpfs_hash_link(tdo, index) = tdo->tdo_entry[index].tde_next;
+      if (index != last)
+        {
+          *tmpfs_hash_link(tdo, last) = index + 1;
+        }
+    }
+
+  if (index != last)
+    {
+      tdo->tdo_entry[index] = tdo->tdo_entry[last];
+    }
+
+  /* And decrement the count of directory entries */
+
+  tdo->tdo_nentries = last;
+}
+
 /****************************************************************************
  * Name: tmpfs_find_dirent
  ****************************************************************************/
@@ -425,6 +867,8 @@ static int tmpfs_release_file(FAR struct tmpfs_file_s *tfo)
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
                              FAR const char *name, size_t len)
 {
+  FAR struct tmpfs_dirent_s *tde;
+  uint32_t hash;
   int i;
 
   if (len == 0)
@@ -441,17 +885,41 @@ static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
-  /* Search the list of directory entries for a match */
+  hash = tmpfs_hash_name(name, len);
+
+  /* Walk the hash chain of the name if the directory has a hash index */
+
+  if (tdo->tdo_hash != NULL)
+    {
+      for (i = tdo->tdo_hash[hash & (tdo->tdo_nbuckets - 1)]; i != 0;
+           i = tde->tde_next)
+        {
+          tde = &tdo->tdo_entry[i - 1];
+          if (tde->tde_hash == hash &&
+              strncmp(tde->tde_name, name, len) == 0 &&
+              tde->tde_name[len] == 0)
+            {
+              return i - 1;
+            }
+        }
+
+      return -ENOENT;
+    }
 
-  for (i = 0;
-       i < tdo->tdo_nentries &&
-       (strncmp(tdo->tdo_entry[i].tde_name, name, len) != 0 ||
-       tdo->tdo_entry[i].tde_name[len] != 0);
-       i++);
+  /* Search the list of directory entries for a match */
 
-  /* Return what we found, if anything */
+  for (i = 0; i < tdo->tdo_nentries; i++)
+    {
+      tde = &tdo->tdo_entry[i];
+      if (tde->tde_hash == hash &&
+          strncmp(tde->tde_name, name, len) == 0 &&
+          tde->tde_name[len] == 0)
+        {
+          return i;
+        }
+    }
 
-  return i < tdo->tdo_nentries ? i : -ENOENT;
+  return -ENOENT;
 }
 
 /****************************************************************************
@@ -462,7 +930,6 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
                                FAR const char *name)
 {
   int index;
-  int last;
 
   /* Search the list of directory entries for a match */
 
@@ -472,6 +939,11 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
       return index;
     }
 
+  /* Forget the cached lookups in the directory and of the object */
+
+  dcache_purge(tdo);
+  dcache_purge(tdo->tdo_entry[index].tde_object);
+
   /* Free the object name */
 
   if (tdo->tdo_entry[index].tde_name != NULL)
@@ -481,15 +953,7 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
 
   /* Remove by replacing this entry with the final directory entry */
 
-  last = tdo->tdo_nentries - 1;
-  if (index != last)
-    {
-      tdo->tdo_entry[index] = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  tmpfs_drop_dirent(tdo, index);
   return OK;
 }
 
@@ -504,6 +968,7 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
   FAR struct tmpfs_dirent_s *tde;
   FAR char *newname;
   unsigned int nentries;
+  unsigned int nbuckets;
   size_t namelen;
   int index;
 
@@ -547,10 +1012,31 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
 
   /* Save the new object info in the new directory entry */
 
+  dcache_purge(tdo);
+
   to->to_parent   = tdo;
   tde             = &tdo->tdo_entry[index];
   tde->tde_object = to;
   tde->tde_name   = newname;
+  tde->tde_hash   = tmpfs_hash_name(newname, namelen);
+  tde->tde_next   = 0;
+
+  /* Index the entry, growing the hash index when the chains get long */
+
+  nbuckets = tdo->tdo_nbuckets;
+  if (tdo->tdo_hash != NULL &&
+      (nentries <= 2 * nbuckets || nbuckets >= TMPFS_HASH_MAXBUCKETS))
+    {
+      tmpfs_hash_insert(tdo, index);
+    }
+  else if (nentries >= TMPFS_HASH_MINENTRIES)
+    {
+      for (nbuckets = TMPFS_HASH_MINENTRIES;
+           nbuckets < nentries && nbuckets < TMPFS_HASH_MAXBUCKETS;
+           nbuckets <<= 1);
+
+      tmpfs_hash_rebuild(tdo, nbuckets);
+    }
 
   return OK;
 }
@@ -582,6 +1068,9 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+  tfo->tfo_height = 0;
+  tfo->tfo_nmaps  = 0;
+  tfo->tfo_root   = NULL;
   tfo->tfo_data   = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
@@ -731,7 +1220,9 @@ tmpfs_alloc_directory(FAR struct tmpfs_directory_s *parent)
   tdo->tdo_refs     = 0;
   tdo->tdo_parent   = parent;
   tdo->tdo_nentries = 0;
+  tdo->tdo_nbuckets = 0;
   tdo->tdo_entry    = NULL;
+  tdo->tdo_hash     = NULL;
 
   nxrmutex_init(&tdo->tdo_lock);
 
@@ -905,18 +1396,28 @@ static int tmpfs_find_object(FAR struct tmpfs_s *fs,
       tdo = next_tdo;
 
       /* Find the TMPFS object with the next segment name in the current
-       * directory.
+       * directory, trying the path component cache first.
        */
 
-      index = tmpfs_find_dirent(tdo, segment, next_segment - segment);
-      if (index < 0)
+      if (!dcache_lookup(tdo, segment, next_segment - segment,
+                         (FAR void **)&to, NULL))
         {
-          /* No object with this name exists in the directory. */
+          index = tmpfs_find_dirent(tdo, segment, next_segment - segment);
+          if (index < 0 && index != -ENOENT)
+            {
+              return index;
+            }
 
-          return index;
+          to = index < 0 ? NULL : tdo->tdo_entry[index].tde_object;
+          dcache_insert(tdo, segment, next_segment - segment, to, NULL);
         }
 
-      to = tdo->tdo_entry[index].tde_object;
+      if (to == NULL)
+        {
+          /* No object with this name exists in the directory. */
+
+          return -ENOENT;
+        }
 
       /* Is this object another directory? */
 
@@ -1181,7 +1682,13 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          /* Sparse paged files may use less memory than their size */
+
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1197,7 +1704,8 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
       avail  = tmptdo->tdo_alloc -
                SIZEOF_TMPFS_DIRECTORY(tmptdo->tdo_nentries);
 
-      tmpbuf->tsf_alloc += sizeof(struct tmpfs_directory_s);
+      tmpbuf->tsf_alloc += sizeof(struct tmpfs_directory_s) +
+                           tmptdo->tdo_nbuckets * sizeof(uint16_t);
       tmpbuf->tsf_avail += avail;
       tmpbuf->tsf_ffree += avail / sizeof(struct tmpfs_dirent_s);
     }
@@ -1215,7 +1723,6 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   FAR struct tmpfs_dirent_s *tde;
   FAR struct tmpfs_object_s *to;
   FAR struct tmpfs_file_s *tfo;
-  unsigned int last;
 
   /* Free the object name */
 
@@ -1228,18 +1735,9 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   tde  = &tdo->tdo_entry[index];
   to   = tde->tde_object;
-  last = tdo->tdo_nentries - 1;
-
-  if (index != last)
-    {
-      /* Move the directory entry */
-
-      *tde = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  dcache_purge(tdo);
+  dcache_purge(to);
+  tmpfs_drop_dirent(tdo, index);
 
   /* Is this directory entry a file object? */
 
@@ -1257,13 +1755,14 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
       tdo = (FAR struct tmpfs_directory_s *)to;
 
       fs_heap_free(tdo->tdo_entry);
+      fs_heap_free(tdo->tdo_hash);
     }
 
   /* Free the object now */
@@ -1529,20 +2028,22 @@ static int tmpfs_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: tmpfs_read
+ * Name: tmpfs_readv
  ****************************************************************************/
 
-static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
-                          size_t buflen)
+static ssize_t tmpfs_readv(FAR struct file *filep, FAR const struct uio *uio)
 {
   FAR struct tmpfs_file_s *tfo;
-  ssize_t nread;
+  FAR uint8_t *buffer;
+  FAR uint8_t *src;
+  ssize_t nread = 0;
   off_t startpos;
-  off_t endpos;
+  size_t chunk;
+  size_t len;
   int ret;
+  int i;
 
-  finfo("filep: %p buffer: %p buflen: %lu\n",
-        filep, buffer, (unsigned long)buflen);
+  finfo("filep: %p iovcnt: %d\n", filep, uio->uio_iovcnt);
   DEBUGASSERT(filep->f_priv != NULL);
 
   /* Recover our private data from the struct file instance */
@@ -1564,30 +2065,42 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  /* Handle attempts to read beyond the end of the file. */
+  /* Copy data from the memory object to each user buffer in turn,
+   * stopping at the end of the file.
+   */
 
   startpos = filep->f_pos;
-  nread    = buflen;
-  endpos   = startpos + buflen;
-
-  if (endpos > tfo->tfo_size)
+  for (i = 0; i < uio->uio_iovcnt && startpos < tfo->tfo_size; i++)
     {
-      endpos = tfo->tfo_size;
-      nread  = endpos - startpos;
-    }
+      len = uio->uio_iov[i].iov_len;
+      if (len > tfo->tfo_size - startpos)
+        {
+          len = tfo->tfo_size - startpos;
+        }
 
-  /* Copy data from the memory object to the user buffer */
+      /* Copy one page at a time; holes read as zeros */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
+      for (buffer = uio->uio_iov[i].iov_base; len > 0; len -= chunk)
+        {
+          chunk = len;
+          src   = tmpfs_file_addr(tfo, startpos, &chunk, false);
+          if (src != NULL)
+            {
+              memcpy(buffer, src, chunk);
+            }
+          else
+            {
+              memset(buffer, 0, chunk);
+            }
+
+          buffer   += chunk;
+          startpos += chunk;
+          nread    += chunk;
+        }
     }
 
+  filep->f_pos = startpos;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1595,22 +2108,51 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 }
 
 /****************************************************************************
- * Name: tmpfs_write
+ * Name: tmpfs_read
  ****************************************************************************/
 
-static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
-                           size_t buflen)
+static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = buffer;
+  iov.iov_len = buflen;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return tmpfs_readv(filep, &uio);
+}
+
+/****************************************************************************
+ * Name: tmpfs_writev
+ ****************************************************************************/
+
+static ssize_t tmpfs_writev(FAR struct file *filep,
+                            FAR const struct uio *uio)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR const uint8_t *buffer;
+  FAR uint8_t *dest;
   ssize_t nwritten;
+  ssize_t total;
   off_t startpos;
   off_t endpos;
+  size_t chunk;
+  size_t len;
   int ret;
+  int i;
 
-  finfo("filep: %p buffer: %p buflen: %lu\n",
-        filep, buffer, (unsigned long)buflen);
+  finfo("filep: %p iovcnt: %d\n", filep, uio->uio_iovcnt);
   DEBUGASSERT(filep->f_priv != NULL);
 
+  nwritten = uio_total_len(uio);
+  if (nwritten <= 0)
+    {
+      return nwritten;
+    }
+
   /* Recover our private data from the struct file instance */
 
   tfo = filep->f_priv;
@@ -1634,12 +2176,11 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       startpos = filep->f_pos;
     }
 
-  nwritten = buflen;
-  endpos   = startpos + buflen;
+  endpos = startpos + nwritten;
 
-  if (endpos > tfo->tfo_size)
+  if (tfo->tfo_data != NULL && endpos > tfo->tfo_size)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Reallocate a contiguous file once for the whole vector. */
 
       ret = tmpfs_realloc_file(tfo, (size_t)endpos);
       if (ret < 0)
@@ -1648,29 +2189,72 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from each user buffer to the memory object, allocating the
+   * pages as they are reached.
+   */
+
+  total = nwritten;
+  nwritten = 0;
+  ret = OK;
 
-  if (tfo->tfo_data != NULL)
+  for (i = 0; i < uio->uio_iovcnt && ret == OK; i++)
     {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+      buffer = uio->uio_iov[i].iov_base;
+      for (len = uio->uio_iov[i].iov_len; len > 0; len -= chunk)
+        {
+          chunk = len;
+          dest  = tmpfs_file_addr(tfo, startpos, &chunk, true);
+          if (dest == NULL)
+            {
+              ret = -ENOMEM;
+              break;
+            }
+
+          memcpy(dest, buffer, chunk);
+          buffer   += chunk;
+          startpos += chunk;
+          nwritten += chunk;
+        }
     }
-  else
+
+  /* A paged file grows as far as the data could be written */
+
+  if (startpos > tfo->tfo_size)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      tfo->tfo_size = startpos;
     }
 
-  filep->f_pos = endpos;
+  DEBUGASSERT(nwritten == total || ret < 0);
+  filep->f_pos = startpos;
 
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
-  return nwritten;
+  return nwritten > 0 ? nwritten : ret;
 
 errout_with_lock:
   tmpfs_unlock_file(tfo);
   return (ssize_t)ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_write
+ ****************************************************************************/
+
+static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len = buflen;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return tmpfs_writev(filep, &uio);
+}
+
 /****************************************************************************
  * Name: tmpfs_seek
  ****************************************************************************/
@@ -1745,7 +2329,12 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
       ret = mm_map_remove(get_group_mm(group), entry);
       if (ret >= 0)
         {
-          ret = tmpfs_release_file(tfo);
+          ret = tmpfs_lock_file(tfo);
+          if (ret >= 0)
+            {
+              tfo->tfo_nmaps--;
+              tmpfs_release_lockedfile(tfo);
+            }
         }
     }
 
@@ -1767,7 +2356,7 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
-  int ret = -EINVAL;
+  int ret;
 
   DEBUGASSERT(filep->f_priv != NULL);
 
@@ -1777,22 +2366,40 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 
   DEBUGASSERT(tfo != NULL);
 
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
-      map->priv.p = tfo;
-      map->munmap = tmpfs_unmap;
-      ret = mm_map_add(get_current_mm(), map);
+      /* The mapping refers to the file data directly, which needs the
+       * data in one piece.
+       */
+
+      ret = tmpfs_linearize(tfo);
+      if (ret >= 0)
+        {
+          map->vaddr = tfo->tfo_data + map->offset;
+          map->priv.p = tfo;
+          map->munmap = tmpfs_unmap;
+          ret = mm_map_add(get_current_mm(), map);
+        }
 
       if (ret >= 0)
         {
-          tmpfs_lock_file(tfo);
           tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
+          tfo->tfo_nmaps++;
         }
     }
+  else
+    {
+      ret = -EINVAL;
+    }
 
+  tmpfs_unlock_file(tfo);
   return ret;
 }
 
@@ -1834,8 +2441,18 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
+      /* Execute in place needs the file data in one piece */
+
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = tmpfs_linearize(tfo);
       *ptr = (uintptr_t)tfo->tfo_data;
-      return OK;
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   return ret;
@@ -1968,15 +2585,10 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* If the size has increased, the newly added range already reads
+       * as zeros.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
       ret = OK;
     }
 
@@ -2250,8 +2862,10 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Now we can destroy the root file system and the file system itself. */
 
+  dcache_purge(tdo);
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+  fs_heap_free(tdo->tdo_hash);
   fs_heap_free(tdo);
 
   nxrmutex_destroy(&fs->tfs_lock);
@@ -2297,7 +2911,8 @@ static int tmpfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
 
   tmpbuf.tsf_alloc = sizeof(struct tmpfs_s) +
                      sizeof(struct tmpfs_directory_s) +
-                     tdo->tdo_alloc;
+                     tdo->tdo_alloc +
+                     tdo->tdo_nbuckets * sizeof(uint16_t);
   tmpbuf.tsf_avail = avail;
   tmpbuf.tsf_files = 0;
   tmpbuf.tsf_ffree = avail / sizeof(struct tmpfs_dirent_s);
@@ -2418,7 +3033,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -2561,6 +3176,7 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+  fs_heap_free(tdo->tdo_hash);
   fs_heap_free(tdo);
 
   /* Release the reference and lock on the parent directory */
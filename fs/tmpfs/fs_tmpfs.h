@@ -42,6 +42,20 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is stored in pages of TMPFS_PAGESIZE bytes.  The pages are
+ * found through a radix index whose interior nodes are pages too, each
+ * holding TMPFS_FANOUT pointers, so that no allocation is ever larger than
+ * one page and appending never copies the data already written.
+ */
+
+#define TMPFS_PAGESIZE    CONFIG_FS_TMPFS_PAGESIZE
+#define TMPFS_FANOUT      (TMPFS_PAGESIZE / sizeof(FAR void *))
+
+/* Directories with at least this many entries are given a hash index */
+
+#define TMPFS_HASH_MINENTRIES 8
+#define TMPFS_HASH_MAXBUCKETS 32768
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -70,6 +84,8 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+  uint32_t tde_hash;     /* Hash of tde_name */
+  uint16_t tde_next;     /* Next entry in the hash chain (index + 1) */
 };
 
 /* The generic form of a TMPFS memory object */
@@ -100,7 +116,9 @@ struct tmpfs_directory_s
   /* Remaining fields are unique to a directory object */
 
   uint16_t tdo_nentries; /* Number of directory entries */
+  uint16_t tdo_nbuckets; /* Number of hash buckets (0: no hash index) */
   FAR struct tmpfs_dirent_s *tdo_entry;
+  FAR uint16_t *tdo_hash; /* Hash buckets: first entry of each (index + 1) */
 };
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
@@ -126,9 +144,12 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;  /* See TFO_FLAG_* definitions */
+  uint8_t       tfo_height; /* Levels of the page index (0: no pages) */
+  uint16_t      tfo_nmaps;  /* Number of memory mappings of the file */
+  size_t        tfo_size;   /* Valid file size */
+  FAR void     *tfo_root;   /* Root of the page index */
+  FAR uint8_t  *tfo_data;   /* Contiguous file data, once mapped or NULL */
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -27,6 +27,7 @@
 #include <sys/param.h>
 #include <fcntl.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
@@ -537,6 +538,56 @@ static void v9fs_fid_destroy(FAR struct v9fs_client_s *client,
   fs_heap_free(fidp);
 }
 
+/****************************************************************************
+ * v9fs_client_rpc_start
+ *
+ * Description:
+ *   Send a request without waiting for the reply.  Several requests, each
+ *   with its own tag and payload, may be outstanding at the same time; the
+ *   transport completes each payload as its reply arrives.
+ *
+ ****************************************************************************/
+
+static int v9fs_client_rpc_start(FAR struct v9fs_transport_s *transport,
+                                 FAR struct v9fs_payload_s *payload,
+                                 FAR struct iovec *wiov, size_t wcount,
+                                 FAR struct iovec *riov, size_t rcount,
+                                 uint16_t tag)
+{
+  int ret;
+
+  nxsem_init(&payload->resp, 0, 0);
+  payload->wiov = wiov;
+  payload->riov = riov;
+  payload->wcount = wcount;
+  payload->rcount = rcount;
+  payload->tag = tag;
+  payload->ret = -EIO;
+
+  ret = v9fs_transport_request(transport, payload);
+  if (ret < 0)
+    {
+      nxsem_destroy(&payload->resp);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * v9fs_client_rpc_wait
+ *
+ * Description:
+ *   Wait for the reply to a request sent by v9fs_client_rpc_start().
+ *
+ ****************************************************************************/
+
+static int v9fs_client_rpc_wait(FAR struct v9fs_payload_s *payload)
+{
+  nxsem_wait_uninterruptible(&payload->resp);
+  nxsem_destroy(&payload->resp);
+  return payload->ret;
+}
+
 /****************************************************************************
  * v9fs_client_rpc
  ****************************************************************************/
@@ -549,26 +600,64 @@ static int v9fs_client_rpc(FAR struct v9fs_transport_s *transport,
   struct v9fs_payload_s payload;
   int ret;
 
-  nxsem_init(&payload.resp, 0, 0);
-  payload.wiov = wiov;
-  payload.riov = riov;
-  payload.wcount = wcount;
-  payload.rcount = rcount;
-  payload.tag = tag;
-  payload.ret = -EIO;
-
-  ret = v9fs_transport_request(transport, &payload);
+  ret = v9fs_client_rpc_start(transport, &payload, wiov, wcount,
+                              riov, rcount, tag);
   if (ret < 0)
     {
-      nxsem_destroy(&payload.resp);
       return ret;
     }
 
-  nxsem_wait(&payload.resp);
-  nxsem_destroy(&payload.resp);
+  return v9fs_client_rpc_wait(&payload);
+}
+
+/****************************************************************************
+ * v9fs_attrcache_flush
+ *
+ * Description:
+ *   Drop all of the cached attributes.  Called on every change made
+ *   through the client.
+ *
+ ****************************************************************************/
+
+#if CONFIG_V9FS_ATTRCACHE_TIMEOUT > 0
+static void v9fs_attrcache_flush(FAR struct v9fs_client_s *client)
+{
+  int i;
+
+  nxmutex_lock(&client->lock);
+  for (i = 0; i < CONFIG_V9FS_ATTRCACHE_ENTRIES; i++)
+    {
+      fs_heap_free(client->attrs[i].path);
+      client->attrs[i].path = NULL;
+    }
+
+  nxmutex_unlock(&client->lock);
+}
+
+/****************************************************************************
+ * v9fs_attrcache_entry
+ *
+ * Description:
+ *   Return the cache entry that a path maps to.
+ *
+ ****************************************************************************/
+
+static FAR struct v9fs_attrcache_s *
+v9fs_attrcache_entry(FAR struct v9fs_client_s *client,
+                     FAR const char *relpath)
+{
+  uint32_t hash = 0;
+
+  while (*relpath != '\0')
+    {
+      hash = hash * 31 + (uint8_t)*relpath++;
+    }
 
-  return payload.ret;
+  return &client->attrs[hash % CONFIG_V9FS_ATTRCACHE_ENTRIES];
 }
+#else
+#  define v9fs_attrcache_flush(client)
+#endif
 
 /****************************************************************************
  * v9fs_client_clunk
@@ -716,6 +805,13 @@ static int v9fs_client_version(FAR struct v9fs_client_s *client)
       return -EREMOTEIO;
     }
 
+  /* The server lowers the proposed msize to the largest it supports */
+
+  if (response.msize <= V9FS_IOHDRSZ)
+    {
+      return -EREMOTEIO;
+    }
+
   if (response.msize < client->msize)
     {
       client->msize = response.msize;
@@ -891,6 +987,7 @@ int v9fs_client_chstat(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
 
+  v9fs_attrcache_flush(client);
   return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                          request.header.tag);
 }
@@ -903,12 +1000,17 @@ ssize_t v9fs_client_read(FAR struct v9fs_client_s *client, uint32_t fid,
                          FAR void *buffer, off_t offset, size_t buflen)
 {
   FAR struct v9fs_fid_s *fidp;
-  struct v9fs_read_s request;
-  struct v9fs_rread_s response;
-  struct iovec wiov[1];
-  struct iovec riov[2];
+  struct v9fs_read_s request[CONFIG_V9FS_PIPELINE_DEPTH];
+  struct v9fs_rread_s response[CONFIG_V9FS_PIPELINE_DEPTH];
+  struct v9fs_payload_s payload[CONFIG_V9FS_PIPELINE_DEPTH];
+  struct iovec wiov[CONFIG_V9FS_PIPELINE_DEPTH][1];
+  struct iovec riov[CONFIG_V9FS_PIPELINE_DEPTH][2];
+  size_t queued;
   size_t nread = 0;
+  bool done = false;
+  int nreq;
   int ret = 0;
+  int i;
 
   /* size[4] Tread tag[2] fid[4] offset[8] count[4]
    * size[4] Rread tag[2] count[4] data[count]
@@ -920,40 +1022,70 @@ ssize_t v9fs_client_read(FAR struct v9fs_client_s *client, uint32_t fid,
       return -ENOENT;
     }
 
-  while (buflen > 0)
+  while (buflen > 0 && !done)
     {
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ;
-      request.header.type = V9FS_TREAD;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
+      /* Send the requests for the next consecutive chunks */
 
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-      riov[1].iov_base = (FAR void *)buffer;
-      riov[1].iov_len = request.count;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 2,
-                            request.header.tag);
-      if (ret < 0)
+      for (nreq = 0, queued = 0;
+           nreq < CONFIG_V9FS_PIPELINE_DEPTH && queued < buflen; nreq++)
         {
-          break;
+          request[nreq].header.size = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                      V9FS_BIT64SZ + V9FS_BIT32SZ;
+          request[nreq].header.type = V9FS_TREAD;
+          request[nreq].header.tag = v9fs_get_tagid(client);
+          request[nreq].fid = fid;
+          request[nreq].offset = offset + queued;
+          request[nreq].count = MIN(buflen - queued, fidp->iounit);
+
+          wiov[nreq][0].iov_base = &request[nreq];
+          wiov[nreq][0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                  V9FS_BIT64SZ + V9FS_BIT32SZ;
+          riov[nreq][0].iov_base = &response[nreq];
+          riov[nreq][0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
+          riov[nreq][1].iov_base = (FAR uint8_t *)buffer + queued;
+          riov[nreq][1].iov_len = request[nreq].count;
+
+          ret = v9fs_client_rpc_start(client->transport, &payload[nreq],
+                                      wiov[nreq], 1, riov[nreq], 2,
+                                      request[nreq].header.tag);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          queued += request[nreq].count;
         }
 
-      if (response.count == 0)
+      if (nreq == 0)
         {
           break;
         }
 
-      nread += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
+      /* Collect the replies in order.  Data after a short or failed
+       * reply is not returned.
+       */
+
+      for (queued = 0, i = 0; i < nreq; i++)
+        {
+          ret = v9fs_client_rpc_wait(&payload[i]);
+          if (done)
+            {
+              continue;
+            }
+          else if (ret < 0 || response[i].count == 0)
+            {
+              done = true;
+              continue;
+            }
+
+          queued += response[i].count;
+          done = response[i].count < request[i].count;
+        }
+
+      nread  += queued;
+      offset += queued;
+      buffer  = (FAR uint8_t *)buffer + queued;
+      buflen -= queued;
     }
 
   return nread ? nread : ret;
@@ -1079,12 +1211,17 @@ ssize_t v9fs_client_write(FAR struct v9fs_client_s *client, uint32_t fid,
                           size_t buflen)
 {
   FAR struct v9fs_fid_s *fidp;
-  struct v9fs_write_s request;
-  struct v9fs_rwrite_s response;
-  struct iovec wiov[2];
-  struct iovec riov[1];
+  struct v9fs_write_s request[CONFIG_V9FS_PIPELINE_DEPTH];
+  struct v9fs_rwrite_s response[CONFIG_V9FS_PIPELINE_DEPTH];
+  struct v9fs_payload_s payload[CONFIG_V9FS_PIPELINE_DEPTH];
+  struct iovec wiov[CONFIG_V9FS_PIPELINE_DEPTH][2];
+  struct iovec riov[CONFIG_V9FS_PIPELINE_DEPTH][1];
+  size_t queued;
   size_t nwrite = 0;
+  bool done = false;
+  int nreq;
   int ret = 0;
+  int i;
 
   /* size[4] Twrite tag[2] fid[4] offset[8] count[4] data[count]
    * size[4] Rwrite tag[2] count[4]
@@ -1096,35 +1233,72 @@ ssize_t v9fs_client_write(FAR struct v9fs_client_s *client, uint32_t fid,
       return -ENOENT;
     }
 
-  while (buflen > 0)
+  v9fs_attrcache_flush(client);
+  while (buflen > 0 && !done)
     {
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ + request.count;
-      request.header.type = V9FS_TWRITE;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
+      /* Send the requests for the next consecutive chunks */
 
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      wiov[1].iov_base = (FAR void *)buffer;
-      wiov[1].iov_len = request.count;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 2, riov, 1,
-                            request.header.tag);
-      if (ret < 0)
+      for (nreq = 0, queued = 0;
+           nreq < CONFIG_V9FS_PIPELINE_DEPTH && queued < buflen; nreq++)
+        {
+          request[nreq].count = MIN(buflen - queued, fidp->iounit);
+          request[nreq].header.size = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                      V9FS_BIT64SZ + V9FS_BIT32SZ +
+                                      request[nreq].count;
+          request[nreq].header.type = V9FS_TWRITE;
+          request[nreq].header.tag = v9fs_get_tagid(client);
+          request[nreq].fid = fid;
+          request[nreq].offset = offset + queued;
+
+          wiov[nreq][0].iov_base = &request[nreq];
+          wiov[nreq][0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                  V9FS_BIT64SZ + V9FS_BIT32SZ;
+          wiov[nreq][1].iov_base = (FAR uint8_t *)buffer + queued;
+          wiov[nreq][1].iov_len = request[nreq].count;
+          riov[nreq][0].iov_base = &response[nreq];
+          riov[nreq][0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
+
+          ret = v9fs_client_rpc_start(client->transport, &payload[nreq],
+                                      wiov[nreq], 2, riov[nreq], 1,
+                                      request[nreq].header.tag);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          queued += request[nreq].count;
+        }
+
+      if (nreq == 0)
         {
           break;
         }
 
-      nwrite += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
+      /* Collect the replies in order.  Only the data up to the first
+       * short or failed reply is reported as written.
+       */
+
+      for (queued = 0, i = 0; i < nreq; i++)
+        {
+          ret = v9fs_client_rpc_wait(&payload[i]);
+          if (done)
+            {
+              continue;
+            }
+          else if (ret < 0 || response[i].count == 0)
+            {
+              done = true;
+              continue;
+            }
+
+          queued += response[i].count;
+          done = response[i].count < request[i].count;
+        }
+
+      nwrite += queued;
+      offset += queued;
+      buffer  = (FAR const uint8_t *)buffer + queued;
+      buflen -= queued;
     }
 
   return nwrite ? nwrite : ret;
@@ -1193,6 +1367,7 @@ int v9fs_client_rename(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
 
+  v9fs_attrcache_flush(client);
   return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                          request.header.tag);
 }
@@ -1226,6 +1401,7 @@ int v9fs_client_remove(FAR struct v9fs_client_s *client, uint32_t fid)
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
 
+  v9fs_attrcache_flush(client);
   return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                          request.header.tag);
 }
@@ -1263,6 +1439,7 @@ int v9fs_client_unlink(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
 
+  v9fs_attrcache_flush(client);
   ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                         request.header.tag);
   if (ret < 0)
@@ -1309,6 +1486,7 @@ int v9fs_client_mkdir(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_QIDSZ;
 
+  v9fs_attrcache_flush(client);
   return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                          request.header.tag);
 }
@@ -1360,6 +1538,7 @@ int v9fs_client_create(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_QIDSZ + V9FS_BIT32SZ;
 
+  v9fs_attrcache_flush(client);
   ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                         request.header.tag);
   if (ret < 0)
@@ -1411,6 +1590,11 @@ int v9fs_client_open(FAR struct v9fs_client_s *client,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_QIDSZ + V9FS_BIT32SZ;
 
+  if ((oflags & O_TRUNC) != 0)
+    {
+      v9fs_attrcache_flush(client);
+    }
+
   ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                         request.header.tag);
   if (ret < 0)
@@ -1729,6 +1913,7 @@ int v9fs_client_uninit(FAR struct v9fs_client_s *client)
       return ret;
     }
 
+  v9fs_attrcache_flush(client);
   v9fs_transport_destroy(client->transport);
   nxmutex_destroy(&client->lock);
   idr_destroy(client->fids);
@@ -1811,3 +1996,67 @@ int v9fs_fid_get(FAR struct v9fs_client_s *client, uint32_t fid)
   nxmutex_unlock(&client->lock);
   return 0;
 }
+
+/****************************************************************************
+ * v9fs_attrcache_lookup
+ *
+ * Description:
+ *   Look up the attributes of a path in the cache.  Returns -ENOENT if the
+ *   path is not cached or its entry has expired.
+ *
+ ****************************************************************************/
+
+#if CONFIG_V9FS_ATTRCACHE_TIMEOUT > 0
+int v9fs_attrcache_lookup(FAR struct v9fs_client_s *client,
+                          FAR const char *relpath, FAR struct stat *buf)
+{
+  FAR struct v9fs_attrcache_s *entry;
+  int ret = -ENOENT;
+
+  entry = v9fs_attrcache_entry(client, relpath);
+  nxmutex_lock(&client->lock);
+  if (entry->path != NULL && strcmp(entry->path, relpath) == 0 &&
+      (sclock_t)(entry->expire - clock_systime_ticks()) > 0)
+    {
+      memcpy(buf, &entry->buf, sizeof(struct stat));
+      ret = 0;
+    }
+
+  nxmutex_unlock(&client->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * v9fs_attrcache_store
+ *
+ * Description:
+ *   Save the attributes of a path in the cache, replacing whichever path
+ *   occupied the entry before.
+ *
+ ****************************************************************************/
+
+void v9fs_attrcache_store(FAR struct v9fs_client_s *client,
+                          FAR const char *relpath,
+                          FAR const struct stat *buf)
+{
+  FAR struct v9fs_attrcache_s *entry;
+
+  entry = v9fs_attrcache_entry(client, relpath);
+  nxmutex_lock(&client->lock);
+  if (entry->path == NULL || strcmp(entry->path, relpath) != 0)
+    {
+      fs_heap_free(entry->path);
+      entry->path = fs_heap_strdup(relpath);
+      if (entry->path == NULL)
+        {
+          nxmutex_unlock(&client->lock);
+          return;
+        }
+    }
+
+  memcpy(&entry->buf, buf, sizeof(struct stat));
+  entry->expire = clock_systime_ticks() +
+                  MSEC2TICK(CONFIG_V9FS_ATTRCACHE_TIMEOUT);
+  nxmutex_unlock(&client->lock);
+}
+#endif
@@ -32,6 +32,7 @@
 #include <nuttx/mutex.h>
 
 #include <dirent.h>
+#include <time.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/uio.h>
@@ -70,6 +71,15 @@ struct v9fs_transport_ops_s
   CODE void (*destroy)(FAR struct v9fs_transport_s *transport);
 };
 
+#if CONFIG_V9FS_ATTRCACHE_TIMEOUT > 0
+struct v9fs_attrcache_s
+{
+  FAR char   *path;    /* Path of the cached attributes, NULL if free */
+  clock_t     expire;  /* Time (in ticks) when the entry goes stale */
+  struct stat buf;     /* The attributes */
+};
+#endif
+
 struct v9fs_client_s
 {
   FAR struct v9fs_transport_s *transport;
@@ -78,6 +88,9 @@ struct v9fs_client_s
   uint32_t                     root_fid;
   uint32_t                     tag_id;
   mutex_t                      lock;
+#if CONFIG_V9FS_ATTRCACHE_TIMEOUT > 0
+  struct v9fs_attrcache_s      attrs[CONFIG_V9FS_ATTRCACHE_ENTRIES];
+#endif
 };
 
 /****************************************************************************
@@ -127,5 +140,12 @@ void v9fs_transport_destroy(FAR struct v9fs_transport_s *transport);
 void v9fs_transport_done(FAR struct v9fs_payload_s *cookie, int ret);
 int v9fs_fid_put(FAR struct v9fs_client_s *client, uint32_t fid);
 int v9fs_fid_get(FAR struct v9fs_client_s *client, uint32_t fid);
+#if CONFIG_V9FS_ATTRCACHE_TIMEOUT > 0
+int v9fs_attrcache_lookup(FAR struct v9fs_client_s *client,
+                          FAR const char *relpath, FAR struct stat *buf);
+void v9fs_attrcache_store(FAR struct v9fs_client_s *client,
+                          FAR const char *relpath,
+                          FAR const struct stat *buf);
+#endif
 
 #endif /* __FS_V9FS_CLIENT_H */
@@ -894,6 +894,15 @@ static int v9fs_vfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   client = mountpt->i_private;
   memset(buf, 0, sizeof(struct stat));
 
+#if CONFIG_V9FS_ATTRCACHE_TIMEOUT > 0
+  /* A cached reply saves the walk, getattr and clunk round trips */
+
+  if (v9fs_attrcache_lookup(client, relpath, buf) == 0)
+    {
+      return 0;
+    }
+#endif
+
   ret = v9fs_client_walk(client, relpath, NULL);
   if (ret < 0)
     {
@@ -904,6 +913,13 @@ static int v9fs_vfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   fid = ret;
   ret = v9fs_client_stat(client, fid, buf);
   v9fs_fid_put(client, fid);
+#if CONFIG_V9FS_ATTRCACHE_TIMEOUT > 0
+  if (ret >= 0)
+    {
+      v9fs_attrcache_store(client, relpath, buf);
+    }
+#endif
+
   return ret;
 }
 
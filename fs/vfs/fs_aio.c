@@ -0,0 +1,103 @@
+/****************************************************************************
+ * fs/vfs/fs_aio.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_aio
+ *
+ * Description:
+ *   Start an asynchronous transfer on an open file if the driver or file
+ *   system behind it supports that.  The transfer takes place at
+ *   aio->offset and does not change the file position.
+ *
+ * Input Parameters:
+ *   filep - File structure instance
+ *   aio   - Transfer description.  It must stay valid until
+ *           aio->complete() has been called.
+ *
+ * Returned Value:
+ *   OK if the transfer was started; aio->complete() will be called when it
+ *   finishes.  -ENOSYS if the file does not support asynchronous
+ *   transfers, or another negated errno value if this transfer could not
+ *   be started.  aio->complete() is not called in either case.
+ *
+ ****************************************************************************/
+
+int file_aio(FAR struct file *filep, FAR struct fs_aio_s *aio)
+{
+  FAR struct inode *inode;
+
+  DEBUGASSERT(filep != NULL && aio != NULL && aio->complete != NULL);
+
+  if (aio->offset < 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((filep->f_oflags & (aio->write ? O_WROK : O_RDOK)) == 0)
+    {
+      return -EBADF;
+    }
+
+  inode = filep->f_inode;
+  if (inode == NULL)
+    {
+      return -ENOSYS;
+    }
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      if (inode->u.i_mops != NULL && inode->u.i_mops->aio != NULL)
+        {
+          return inode->u.i_mops->aio(filep, aio);
+        }
+
+      return -ENOSYS;
+    }
+#endif
+
+  if (INODE_IS_DRIVER(inode) && inode->u.i_ops != NULL &&
+      inode->u.i_ops->aio != NULL)
+    {
+      return inode->u.i_ops->aio(filep, aio);
+    }
+
+  return -ENOSYS;
+}
@@ -37,6 +37,7 @@
 #include "notify/notify.h"
 #include "inode/inode.h"
 #include "vfs/lock.h"
+#include "vfs/readahead.h"
 
 /****************************************************************************
  * Private Functions
@@ -110,6 +111,7 @@ int file_close_without_clear(FAR struct file *filep)
   if (inode)
     {
       file_closelk(filep);
+      file_readahead_release(filep);
 
       /* Close the file, driver, or mountpoint. */
 
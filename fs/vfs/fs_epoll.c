@@ -56,15 +56,30 @@
 #  define CONFIG_EPOLL_NPOLLWAITERS 2
 #endif
 
+/* Events that may be combined with EPOLLEXCLUSIVE */
+
+#define EPOLL_EXCLUSIVE_OK (EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | \
+                            EPOLLWAKEUP | EPOLLET | EPOLLEXCLUSIVE)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* A registration.  It stays on the setup list from EPOLL_CTL_ADD until
+ * EPOLL_CTL_DEL, except for a reported EPOLLONESHOT registration that
+ * waits on the oneshot list for EPOLL_CTL_MOD.  Its poll stays set up
+ * while it is on the setup list, except between reporting a level
+ * triggered event and the next epoll_wait() (rearm is true).
+ */
+
 struct epoll_node_s
 {
-  struct list_node         node;
+  struct list_node         node;    /* Setup, oneshot or free list */
+  struct list_node         rnode;   /* Ready list or rearm list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     ready;   /* On the ready list, under poll_lock */
+  bool                     rearm;   /* On the rearm list, poll torn down */
+  bool                     oneshot; /* On the oneshot list, poll torn down */
   struct pollfd            pfd;
   FAR struct epoll_head_s *eph;
 };
@@ -77,13 +92,18 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
-  struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+  struct list_node      setup;    /* The setup list, store all the
+                                   * registered epoll nodes.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      ready;    /* The ready list, filled by the poll
+                                   * callbacks and protected by poll_lock.
+                                   * epoll_wait() only visits these nodes.
+                                   */
+  struct list_node      rearm;    /* The rearm list, store the level
+                                   * triggered nodes reported by the last
+                                   * epoll_wait(), whose poll is set up
+                                   * again by the next one to check whether
+                                   * the event is still pending.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
@@ -112,9 +132,9 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents);
+static int epoll_rearm(FAR epoll_head_t *eph);
+static int epoll_collect(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents);
 
 /****************************************************************************
  * Private Data
@@ -210,7 +230,10 @@ static int epoll_do_close(FAR struct file *filep)
       nxmutex_destroy(&eph->lock);
       list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
         {
-          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          if (!epn->rearm)
+            {
+              poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+            }
         }
 
       list_for_every_entry_safe(&eph->extend, epn, tmp, epoll_node_t, node)
@@ -251,8 +274,7 @@ static int epoll_do_poll(FAR struct file *filep,
   flags = spin_lock_irqsave(&eph->poll_lock);
   if (setup)
     {
-      FAR epoll_node_t *epn;
-      pollevent_t eventset = 0;
+      pollevent_t eventset;
 
       for (i = 0; i < CONFIG_EPOLL_NPOLLWAITERS; i++)
         {
@@ -271,27 +293,9 @@ static int epoll_do_poll(FAR struct file *filep,
           goto errout;
         }
 
+      eventset = list_is_empty(&eph->ready) ? 0 : POLLIN;
       spin_unlock_irqrestore(&eph->poll_lock, flags);
 
-      nxmutex_lock(&eph->lock);
-
-      list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-        {
-          /* Only check the notifed fd */
-
-          if (!epn->notified)
-            {
-              continue;
-            }
-
-          if (epn->pfd.revents != 0)
-            {
-              eventset |= POLLIN;
-            }
-        }
-
-      nxmutex_unlock(&eph->lock);
-
       epoll_notify(eph, eventset);
     }
   else
@@ -347,7 +351,8 @@ static int epoll_do_create(int size, int flags)
   epn = (FAR epoll_node_t *)(eph + 1);
 
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
+  list_initialize(&eph->ready);
+  list_initialize(&eph->rearm);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -373,10 +378,115 @@ static int epoll_do_create(int size, int flags)
 }
 
 /****************************************************************************
- * Name: epoll_setup
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove a node from the ready list.  The poll of the node must have been
+ *   torn down.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->poll_lock);
+  if (epn->ready)
+    {
+      list_delete(&epn->rnode);
+      epn->ready = false;
+    }
+
+  spin_unlock_irqrestore(&eph->poll_lock, flags);
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Stop monitoring a registration: tear down its poll and forget any
+ *   event that was not yet reported.  Called with eph->lock held.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  if (epn->rearm)
+    {
+      list_delete(&epn->rnode);
+      epn->rearm = false;
+    }
+  else
+    {
+      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+    }
+
+  epoll_unready(eph, epn);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Start monitoring a registration.  If the fd is ready already, the poll
+ *   callback puts the node on the ready list before this returns.  Called
+ *   with eph->lock held.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  int ret;
+
+  epn->pfd.revents = 0;
+  ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+  if (ret < 0)
+    {
+      ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
+           epn->pfd.fd, epn->pfd.events, ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Find the registration of fd.  Called with eph->lock held.
+ *
+ ****************************************************************************/
+
+static FAR epoll_node_t *epoll_find(FAR epoll_head_t *eph, int fd)
+{
+  FAR epoll_node_t *epn;
+
+  list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
+    }
+
+  list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
  *
  * Description:
- *   Setup all the fd.
+ *   Setup again the poll of the level triggered nodes reported by the last
+ *   epoll_wait().  If their event is still pending the poll callback puts
+ *   them back on the ready list.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -386,7 +496,7 @@ static int epoll_do_create(int size, int flags)
  *
  ****************************************************************************/
 
-static int epoll_setup(FAR epoll_head_t *eph)
+static int epoll_rearm(FAR epoll_head_t *eph)
 {
   FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
@@ -398,24 +508,16 @@ static int epoll_setup(FAR epoll_head_t *eph)
       return ret;
     }
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+  list_for_every_entry_safe(&eph->rearm, epn, tepn, epoll_node_t, rnode)
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
-
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+      ret = epoll_arm(eph, epn);
       if (ret < 0)
         {
-          ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
-               epn->pfd.fd, epn->pfd.events, ret);
           break;
         }
 
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
+      list_delete(&epn->rnode);
+      epn->rearm = false;
     }
 
   nxmutex_unlock(&eph->lock);
@@ -423,11 +525,21 @@ static int epoll_setup(FAR epoll_head_t *eph)
 }
 
 /****************************************************************************
- * Name: epoll_teardown
+ * Name: epoll_collect
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Report the nodes on the ready list.  Only the ready nodes are visited,
+ *   so the cost does not depend on the number of registered fds.
+ *
+ *   Edge triggered nodes keep their poll set up and are queued again by the
+ *   next notification from the driver.  Level triggered nodes are torn
+ *   down and set up again by the next epoll_wait(), which will report them
+ *   again if the event is still pending.  EPOLLONESHOT nodes are torn down
+ *   until they are re-enabled with EPOLL_CTL_MOD.
+ *
+ *   A node is taken off the ready list by exactly one caller, so each
+ *   event wakes up only one of several threads waiting on the same epoll
+ *   descriptor.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -435,50 +547,78 @@ static int epoll_setup(FAR epoll_head_t *eph)
  *   maxevents - The epoll events array size
  *
  * Returned Value:
- *   Return the number of fd that notifed and the events is also user
- *   expected.
+ *   Return the number of events stored in evs.
  *
  ****************************************************************************/
 
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents)
+static int epoll_collect(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  bool pending;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Only check the notifed fd */
+      flags = spin_lock_irqsave(&eph->poll_lock);
+      if (list_is_empty(&eph->ready))
+        {
+          spin_unlock_irqrestore(&eph->poll_lock, flags);
+          break;
+        }
+
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         rnode);
+      epn->ready       = false;
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
+      spin_unlock_irqrestore(&eph->poll_lock, flags);
 
-      if (!epn->notified)
+      if (revents == 0)
         {
           continue;
         }
 
-      /* Teradown all the notified fd */
-
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
-            }
+          epoll_disarm(eph, epn);
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
+          epn->oneshot = true;
+        }
+      else if ((epn->pfd.events & EPOLLET) == 0)
+        {
+          /* This also drops a notification that raced with us, the
+           * rearm checks the state again anyway.
+           */
+
+          epoll_disarm(eph, epn);
+          list_add_tail(&eph->rearm, &epn->rnode);
+          epn->rearm = true;
         }
-      else
+    }
+
+  /* Let another waiter pick up what did not fit in evs */
+
+  flags   = spin_lock_irqsave(&eph->poll_lock);
+  pending = !list_is_empty(&eph->ready);
+  spin_unlock_irqrestore(&eph->poll_lock, flags);
+
+  if (pending)
+    {
+      int semcount = 0;
+
+      nxsem_get_value(&eph->sem, &semcount);
+      if (semcount < 1)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          nxsem_post(&eph->sem);
         }
     }
 
@@ -491,7 +631,8 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification: queue the node on the ready list and wake up a
+ *   waiter.  It may run in interrupt context.
  *
  * Input Parameters:
  *   fds - The fds
@@ -504,19 +645,114 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  if (fds->revents == 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
+      return;
+    }
+
+  flags = spin_lock_irqsave(&eph->poll_lock);
+  if (!epn->ready)
+    {
+      list_add_tail(&eph->ready, &epn->rnode);
+      epn->ready = true;
+    }
+
+  spin_unlock_irqrestore(&eph->poll_lock, flags);
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
+    }
+
+  epoll_notify(eph, POLLIN);
+}
+
+/****************************************************************************
+ * Name: epoll_do_wait
+ ****************************************************************************/
+
+static int epoll_do_wait(int epfd, FAR struct epoll_event *evs,
+                         int maxevents, int timeout,
+                         FAR const sigset_t *sigmask)
+{
+  FAR struct file *filep;
+  FAR epoll_head_t *eph;
+  sigset_t oldsigmask;
+  int ret;
+
+  if (evs == NULL || maxevents <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  eph = epoll_head_from_fd(epfd, &filep);
+  if (eph == NULL)
+    {
+      goto out;
+    }
+
+retry:
+  ret = epoll_rearm(eph);
+  if (ret < 0)
+    {
+      goto err;
+    }
+
+  /* Wait the poll ready */
+
+  if (sigmask != NULL)
+    {
+      nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
+    }
+
+  if (timeout == 0)
+    {
+      ret = -ETIMEDOUT;
+    }
+  else if (timeout > 0)
+    {
+      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
+    }
+  else
+    {
+      ret = nxsem_wait(&eph->sem);
+    }
+
+  if (sigmask != NULL)
+    {
+      nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
+    }
+
+  if (ret < 0 && ret != -ETIMEDOUT)
+    {
+      goto err;
+    }
+  else /* ret >= 0 or ret == -ETIMEDOUT */
+    {
+      int num = epoll_collect(eph, evs, maxevents);
+      if (num == 0 && ret >= 0)
         {
-          nxsem_post(&epn->eph->sem);
+          goto retry;
         }
 
-      epoll_notify(epn->eph, POLLIN);
+      ret = num;
     }
+
+  fs_putfilep(filep);
+  return ret;
+
+err:
+  fs_putfilep(filep);
+  set_errno(-ret);
+out:
+  ferr("epoll wait failed:%d, timeout:%d\n", errno, timeout);
+  return ERROR;
 }
 
 /****************************************************************************
@@ -603,6 +839,8 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
       goto err_without_lock;
     }
 
+  epn = epoll_find(eph, fd);
+
   switch (op)
     {
       case EPOLL_CTL_ADD:
@@ -610,29 +848,36 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
         /* Check repetition */
 
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
+            ret = -EEXIST;
+            goto err;
+          }
+
+        /* EPOLLEXCLUSIVE only goes with the input/output events, and never
+         * with another epoll descriptor.
+         */
+
+        if ((ev->events & EPOLLEXCLUSIVE) != 0)
+          {
+            FAR struct file *target;
+
+            if ((ev->events & ~EPOLL_EXCLUSIVE_OK) != 0)
               {
-                ret = -EEXIST;
+                ret = -EINVAL;
                 goto err;
               }
-          }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
+            ret = fs_getfilep(fd, &target);
+            if (ret < 0)
               {
-                ret = -EEXIST;
                 goto err;
               }
-          }
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
+            ret = target->f_inode->u.i_ops == &g_epoll_ops ? -EINVAL : OK;
+            fs_putfilep(target);
+            if (ret < 0)
               {
-                ret = -EEXIST;
                 goto err;
               }
           }
@@ -664,16 +909,18 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
         epn->eph         = eph;
         epn->data        = ev->data;
-        epn->notified    = false;
+        epn->ready       = false;
+        epn->rearm       = false;
+        epn->oneshot     = false;
         epn->pfd.events  = ev->events | POLLALWAYS;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
         epn->pfd.cb      = epoll_default_cb;
-        epn->pfd.revents = 0;
 
-        ret = poll_fdsetup(fd, &epn->pfd, true);
+        ret = epoll_arm(eph, epn);
         if (ret < 0)
           {
+            epoll_unready(eph, epn);
             list_add_tail(&eph->free, &epn->node);
             goto err;
           }
@@ -683,114 +930,60 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
       case EPOLL_CTL_DEL:
         finfo("%p CTL DEL: fd=%d\n", eph, fd);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                poll_fdsetup(fd, &epn->pfd, false);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            ret = -ENOENT;
+            goto err;
           }
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        if (!epn->oneshot)
           {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            epoll_disarm(eph, epn);
           }
 
+        list_delete(&epn->node);
+        list_add_tail(&eph->free, &epn->node);
         break;
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    poll_fdsetup(fd, &epn->pfd, false);
-
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
+            ret = -ENOENT;
+            goto err;
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        /* EPOLLEXCLUSIVE can only be set when the fd is added */
+
+        if ((ev->events & EPOLLEXCLUSIVE) != 0 ||
+            (epn->pfd.events & EPOLLEXCLUSIVE) != 0)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
-              }
+            ret = -EINVAL;
+            goto err;
           }
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        if (!epn->oneshot)
           {
-            if (epn->pfd.fd == fd)
-              {
-                epn->notified    = false;
-                epn->data        = ev->data;
-                epn->pfd.events  = ev->events | POLLALWAYS;
-                epn->pfd.fd      = fd;
-                epn->pfd.revents = 0;
-
-                ret = poll_fdsetup(fd, &epn->pfd, true);
-                if (ret < 0)
-                  {
-                    goto err;
-                  }
-
-                list_delete(&epn->node);
-                list_add_tail(&eph->setup, &epn->node);
-                break;
-              }
+            epoll_disarm(eph, epn);
+          }
+
+        epn->data       = ev->data;
+        epn->pfd.events = ev->events | POLLALWAYS;
+        epn->oneshot    = false;
+
+        list_delete(&epn->node);
+        ret = epoll_arm(eph, epn);
+        if (ret < 0)
+          {
+            /* The registration stays, waiting for another EPOLL_CTL_MOD */
+
+            epoll_unready(eph, epn);
+            list_add_tail(&eph->oneshot, &epn->node);
+            epn->oneshot = true;
+            goto err;
           }
 
+        list_add_tail(&eph->setup, &epn->node);
         break;
 
       default:
@@ -798,10 +991,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         goto err;
     }
 
-out:
   nxmutex_unlock(&eph->lock);
   fs_putfilep(filep);
   return OK;
+
 err:
   nxmutex_unlock(&eph->lock);
 err_without_lock:
@@ -817,66 +1010,7 @@ err_without_lock:
 int epoll_pwait(int epfd, FAR struct epoll_event *evs,
                 int maxevents, int timeout, FAR const sigset_t *sigmask)
 {
-  FAR struct file *filep;
-  FAR epoll_head_t *eph;
-  sigset_t oldsigmask;
-  int ret;
-
-  eph = epoll_head_from_fd(epfd, &filep);
-  if (eph == NULL)
-    {
-      goto out;
-    }
-
-retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
-  /* Wait the poll ready */
-
-  nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
-
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
-  nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
-  if (ret < 0 && ret != -ETIMEDOUT)
-    {
-      goto err;
-    }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
-    {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
-
-      ret = num;
-    }
-
-  fs_putfilep(filep);
-  return ret;
-
-err:
-  fs_putfilep(filep);
-  set_errno(-ret);
-out:
-  ferr("epoll wait failed:%d, timeout:%d\n", errno, timeout);
-  return ERROR;
+  return epoll_do_wait(epfd, evs, maxevents, timeout, sigmask);
 }
 
 /****************************************************************************
@@ -893,60 +1027,5 @@ out:
 int epoll_wait(int epfd, FAR struct epoll_event *evs,
                int maxevents, int timeout)
 {
-  FAR struct file *filep;
-  FAR epoll_head_t *eph;
-  int ret;
-
-  eph = epoll_head_from_fd(epfd, &filep);
-  if (eph == NULL)
-    {
-      goto out;
-    }
-
-retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
-  /* Wait the poll ready */
-
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
-  if (ret < 0 && ret != -ETIMEDOUT)
-    {
-      goto err;
-    }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
-    {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
-
-      ret = num;
-    }
-
-  fs_putfilep(filep);
-  return ret;
-
-err:
-  fs_putfilep(filep);
-  set_errno(-ret);
-out:
-  ferr("epoll wait failed:%d, timeout:%d\n", errno, timeout);
-  return ERROR;
+  return epoll_do_wait(epfd, evs, maxevents, timeout, NULL);
 }
@@ -248,11 +248,15 @@ static int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
         break;
       case F_SETPIPE_SZ:
         /* Modify the capacity of the pipe to arg bytes, but not larger than
-         * CONFIG_DEV_PIPE_MAXSIZE.
+         * CONFIG_DEV_PIPE_MAXSIZE.  Return the resulting capacity.
          */
 
         {
           ret = file_ioctl(filep, PIPEIOC_SETSIZE, va_arg(ap, int));
+          if (ret >= 0)
+            {
+              ret = file_ioctl(filep, PIPEIOC_GETSIZE);
+            }
         }
 
         break;
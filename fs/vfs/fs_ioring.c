@@ -0,0 +1,1127 @@
+/****************************************************************************
+ * fs/vfs/fs_ioring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioring.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Alignment of the SQE and CQE arrays inside the shared ring memory */
+
+#define IORING_ALIGN          8
+#define IORING_ALIGN_UP(n)    (((n) + IORING_ALIGN - 1) & ~(IORING_ALIGN - 1))
+
+/* Request states.  Transitions into and out of IORING_REQ_ARMED happen
+ * under the ring spinlock because the poll callback may run from interrupt
+ * level.
+ */
+
+#define IORING_REQ_QUEUED     0  /* On the ready list, not yet started */
+#define IORING_REQ_ARMED      1  /* Waiting for the file to become ready */
+#define IORING_REQ_READY      2  /* Poll fired, poll must be torn down */
+#define IORING_REQ_RUNNING    3  /* Owned by the worker */
+
+#define IORING_LOAD(p)        __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define IORING_STORE(p, v)    __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ioring_s;
+
+/* One submitted SQE.  The SQE is copied at submission so that the
+ * application may reuse its slot immediately.
+ */
+
+struct ioring_req_s
+{
+  sq_entry_t               node;   /* Ready list or free list link */
+  FAR struct ioring_s     *ring;   /* Owning ring */
+  FAR struct ioring_req_s *link;   /* Next request of an IOSQE_IO_LINK chain */
+  FAR struct file         *filep;  /* File reference taken at submission */
+  struct ioring_sqe        sqe;    /* Private copy of the SQE */
+  struct pollfd            pfd;    /* Readiness wait for pollable files */
+  uint8_t                  state;  /* See IORING_REQ_* */
+};
+
+/* This structure describes the internal state of one ring */
+
+struct ioring_s
+{
+  mutex_t                  lock;      /* Serializes submit/complete/register */
+  spinlock_t               splock;    /* Protects ready, scheduled, states */
+  sem_t                    cqwait;    /* Posted when CQEs are produced */
+  struct work_s            work;      /* Runs ready requests on LPWORK */
+  sq_queue_t               ready;     /* Requests ready to run */
+  sq_queue_t               freelist;  /* Unused requests */
+  FAR struct ioring_req_s *reqs;      /* Request pool, one per CQE slot */
+  FAR struct ioring_rings *rings;     /* Shared ring memory */
+  FAR struct ioring_sqe   *sqes;      /* SQE array in the ring memory */
+  FAR struct ioring_cqe   *cqes;      /* CQE array in the ring memory */
+  size_t                   ringsize;  /* Size of the ring memory */
+  FAR struct iovec        *bufs;      /* Registered fixed buffers */
+  unsigned int             nbufs;     /* Number of registered buffers */
+  unsigned int             inflight;  /* Submitted but not completed */
+  uint16_t                 nwaiters;  /* Threads waiting on cqwait */
+  uint8_t                  crefs;     /* Open references */
+  bool                     scheduled; /* work is queued or running */
+  bool                     closing;   /* Last reference is being closed */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ioring_open(FAR struct file *filep);
+static int ioring_close(FAR struct file *filep);
+static int ioring_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+static void ioring_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ioring_fops =
+{
+  ioring_open,      /* open */
+  ioring_close,     /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  NULL,             /* ioctl */
+  ioring_mmap,      /* mmap */
+};
+
+static struct inode g_ioring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_ioring_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_roundup
+ ****************************************************************************/
+
+static uint32_t ioring_roundup(uint32_t n)
+{
+  uint32_t r = 1;
+
+  while (r < n)
+    {
+      r <<= 1;
+    }
+
+  return r;
+}
+
+/****************************************************************************
+ * Name: ioring_wakeup
+ *
+ * Description:
+ *   Wake every thread waiting for completions.  Waiters re-check their
+ *   condition and wait again if needed.  Called with the ring lock held.
+ *
+ ****************************************************************************/
+
+static void ioring_wakeup(FAR struct ioring_s *ring)
+{
+  while (ring->nwaiters > 0)
+    {
+      ring->nwaiters--;
+      nxsem_post(&ring->cqwait);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_ready
+ *
+ * Description:
+ *   Put a request on the ready list and make sure that the worker runs.
+ *
+ ****************************************************************************/
+
+static void ioring_ready(FAR struct ioring_s *ring,
+                         FAR struct ioring_req_s *req, uint8_t state)
+{
+  irqstate_t flags;
+  bool kick;
+
+  flags = spin_lock_irqsave(&ring->splock);
+  req->state = state;
+  sq_addlast(&req->node, &ring->ready);
+  kick = !ring->scheduled;
+  ring->scheduled = true;
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  if (kick)
+    {
+      work_queue(LPWORK, &ring->work, ioring_worker, ring, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_complete
+ *
+ * Description:
+ *   Post the CQE of a request and recycle it.  The next request of a link
+ *   chain is started on success; on failure the rest of the chain is
+ *   completed with -ECANCELED.  Called with the ring lock held.
+ *
+ ****************************************************************************/
+
+static void ioring_complete(FAR struct ioring_s *ring,
+                            FAR struct ioring_req_s *req, int res)
+{
+  FAR struct ioring_rings *rings = ring->rings;
+  FAR struct ioring_req_s *next;
+  FAR struct ioring_cqe *cqe;
+  uint32_t tail;
+
+  while (req != NULL)
+    {
+      /* Space was reserved at submission, so the CQ cannot overflow */
+
+      tail = rings->cq_tail;
+      cqe  = &ring->cqes[tail & rings->cq_mask];
+      cqe->user_data = req->sqe.user_data;
+      cqe->res       = res;
+      cqe->flags     = 0;
+      IORING_STORE(&rings->cq_tail, tail + 1);
+
+      if (req->filep != NULL)
+        {
+          fs_putfilep(req->filep);
+          req->filep = NULL;
+        }
+
+      next      = req->link;
+      req->link = NULL;
+      sq_addlast(&req->node, &ring->freelist);
+      ring->inflight--;
+
+      if (next != NULL && res >= 0 && !ring->closing)
+        {
+          ioring_ready(ring, next, IORING_REQ_QUEUED);
+          break;
+        }
+
+      req = next;
+      res = -ECANCELED;
+    }
+
+  ioring_wakeup(ring);
+}
+
+/****************************************************************************
+ * Name: ioring_poll_cb
+ *
+ * Description:
+ *   Poll callback of a request waiting for its file to become ready.  May
+ *   run from interrupt level.
+ *
+ ****************************************************************************/
+
+static void ioring_poll_cb(FAR struct pollfd *fds)
+{
+  FAR struct ioring_req_s *req = fds->arg;
+  FAR struct ioring_s *ring = req->ring;
+  irqstate_t flags;
+  bool ready;
+
+  flags = spin_lock_irqsave(&ring->splock);
+  ready = req->state == IORING_REQ_ARMED;
+  if (ready)
+    {
+      req->state = IORING_REQ_READY;
+    }
+
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  if (ready)
+    {
+      ioring_ready(ring, req, IORING_REQ_READY);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_arm
+ *
+ * Description:
+ *   Requests on pollable files that are not file system files (pipes,
+ *   sockets, character drivers) only start once the file reports that it
+ *   is ready, so that the worker never blocks waiting for a peer.
+ *
+ * Returned Value:
+ *   true if the request is now waiting for readiness; false if it should
+ *   run immediately.
+ *
+ ****************************************************************************/
+
+static bool ioring_arm(FAR struct ioring_req_s *req)
+{
+  FAR struct inode *inode = req->filep->f_inode;
+  FAR struct ioring_s *ring = req->ring;
+  irqstate_t flags;
+  bool armed;
+
+  if (INODE_IS_MOUNTPT(inode) || inode->u.i_ops == NULL ||
+      inode->u.i_ops->poll == NULL)
+    {
+      return false;
+    }
+
+  switch (req->sqe.opcode)
+    {
+      case IORING_OP_READV:
+      case IORING_OP_READ:
+      case IORING_OP_READ_FIXED:
+      case IORING_OP_RECV:
+        req->pfd.events = POLLIN;
+        break;
+
+      case IORING_OP_WRITEV:
+      case IORING_OP_WRITE:
+      case IORING_OP_WRITE_FIXED:
+      case IORING_OP_SEND:
+        req->pfd.events = POLLOUT;
+        break;
+
+      default:
+        return false;
+    }
+
+  req->pfd.revents = 0;
+  req->pfd.arg     = req;
+  req->pfd.cb      = ioring_poll_cb;
+  req->state       = IORING_REQ_ARMED;
+
+  if (file_poll(req->filep, &req->pfd, true) < 0)
+    {
+      /* Not pollable after all, just run it */
+
+      req->state = IORING_REQ_RUNNING;
+      return false;
+    }
+
+  /* If the file was already ready, the callback has run and the request is
+   * back on the ready list; the worker will pick it up again.
+   */
+
+  flags = spin_lock_irqsave(&ring->splock);
+  armed = req->state == IORING_REQ_ARMED || req->state == IORING_REQ_READY;
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  return armed;
+}
+
+/****************************************************************************
+ * Name: ioring_execute
+ ****************************************************************************/
+
+static int ioring_execute(FAR struct ioring_req_s *req)
+{
+  FAR struct ioring_sqe *sqe = &req->sqe;
+  FAR struct file *filep = req->filep;
+  struct iovec iov;
+  struct uio uio;
+  ssize_t ret;
+  int err;
+
+  iov.iov_base   = sqe->addr;
+  iov.iov_len    = sqe->len;
+  uio.uio_iov    = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags  = 0;
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        return 0;
+
+      case IORING_OP_FSYNC:
+        return file_fsync(filep);
+
+#ifdef CONFIG_NET
+      case IORING_OP_SEND:
+        return psock_send(file_socket(filep), sqe->addr, sqe->len,
+                          sqe->rw_flags);
+
+      case IORING_OP_RECV:
+        return psock_recv(file_socket(filep), sqe->addr, sqe->len,
+                          sqe->rw_flags);
+#endif
+
+      case IORING_OP_READV:
+        uio.uio_iov    = sqe->addr;
+        uio.uio_iovcnt = sqe->len;
+
+        /* Fall through */
+
+      case IORING_OP_READ:
+      case IORING_OP_READ_FIXED:
+        if (sqe->off == IORING_OFF_CURRENT)
+          {
+            ret = file_readv(filep, &uio);
+          }
+        else
+          {
+            ret = file_preadv(filep, &uio, sqe->off);
+          }
+
+        return ret;
+
+      case IORING_OP_WRITEV:
+        uio.uio_iov    = sqe->addr;
+        uio.uio_iovcnt = sqe->len;
+
+        /* Fall through */
+
+      case IORING_OP_WRITE:
+      case IORING_OP_WRITE_FIXED:
+        if (sqe->off == IORING_OFF_CURRENT)
+          {
+            ret = file_writev(filep, &uio);
+          }
+        else
+          {
+            ret = file_pwritev(filep, &uio, sqe->off);
+          }
+
+        if (ret > 0 && (sqe->rw_flags & (RWF_DSYNC | RWF_SYNC)) != 0)
+          {
+            err = file_fsync(filep);
+            if (err < 0 && err != -EINVAL && err != -ENOTTY)
+              {
+                ret = err;
+              }
+          }
+
+        return ret;
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_worker
+ *
+ * Description:
+ *   Run ready requests in submission order on the low priority work queue.
+ *
+ ****************************************************************************/
+
+static void ioring_worker(FAR void *arg)
+{
+  FAR struct ioring_s *ring = arg;
+  FAR struct ioring_req_s *req;
+  irqstate_t flags;
+  uint8_t state;
+  int res;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&ring->splock);
+      req = (FAR struct ioring_req_s *)sq_remfirst(&ring->ready);
+      if (req == NULL)
+        {
+          ring->scheduled = false;
+          spin_unlock_irqrestore(&ring->splock, flags);
+          break;
+        }
+
+      state      = req->state;
+      req->state = IORING_REQ_RUNNING;
+      spin_unlock_irqrestore(&ring->splock, flags);
+
+      if (state == IORING_REQ_READY)
+        {
+          file_poll(req->filep, &req->pfd, false);
+        }
+      else if (!ring->closing && req->filep != NULL && ioring_arm(req))
+        {
+          continue;
+        }
+
+      res = ring->closing ? -ECANCELED : ioring_execute(req);
+
+      nxmutex_lock(&ring->lock);
+      ioring_complete(ring, req, res);
+      nxmutex_unlock(&ring->lock);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_prep
+ *
+ * Description:
+ *   Validate a copied SQE and take a reference to its file.  Runs in the
+ *   context of the submitting task with the ring lock held.
+ *
+ ****************************************************************************/
+
+static int ioring_prep(FAR struct ioring_s *ring,
+                       FAR struct ioring_req_s *req)
+{
+  FAR struct ioring_sqe *sqe = &req->sqe;
+  FAR struct iovec *buf;
+  uintptr_t addr;
+  int ret;
+
+  if ((sqe->flags & ~IOSQE_IO_LINK) != 0 || sqe->opcode > IORING_OP_RECV)
+    {
+      return -EINVAL;
+    }
+
+  if (sqe->opcode == IORING_OP_NOP)
+    {
+      return OK;
+    }
+
+  ret = fs_getfilep(sqe->fd, &req->filep);
+  if (ret < 0)
+    {
+      req->filep = NULL;
+      return ret;
+    }
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_READ_FIXED:
+      case IORING_OP_WRITE_FIXED:
+
+        /* The transfer must lie within the registered buffer */
+
+        if (sqe->buf_index >= ring->nbufs)
+          {
+            return -EFAULT;
+          }
+
+        buf  = &ring->bufs[sqe->buf_index];
+        addr = (uintptr_t)sqe->addr;
+        if (addr < (uintptr_t)buf->iov_base ||
+            addr - (uintptr_t)buf->iov_base > buf->iov_len ||
+            sqe->len > buf->iov_len - (addr - (uintptr_t)buf->iov_base))
+          {
+            return -EFAULT;
+          }
+
+        /* Fall through */
+
+      case IORING_OP_READV:
+      case IORING_OP_WRITEV:
+      case IORING_OP_READ:
+      case IORING_OP_WRITE:
+        if ((sqe->rw_flags & ~RWF_SUPPORTED) != 0)
+          {
+            return -EOPNOTSUPP;
+          }
+
+        break;
+
+      case IORING_OP_SEND:
+      case IORING_OP_RECV:
+#ifdef CONFIG_NET
+        if (file_socket(req->filep) == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        break;
+#else
+        return -EINVAL;
+#endif
+
+      default:
+        break;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_submit
+ *
+ * Description:
+ *   Consume up to 'to_submit' SQEs.  Called with the ring lock held.
+ *
+ ****************************************************************************/
+
+static int ioring_submit(FAR struct ioring_s *ring, unsigned int to_submit)
+{
+  FAR struct ioring_rings *rings = ring->rings;
+  FAR struct ioring_req_s *prev = NULL;
+  FAR struct ioring_req_s *req;
+  bool broken = false;
+  unsigned int n = 0;
+  uint32_t head;
+  int ret;
+
+  while (n < to_submit)
+    {
+      head = rings->sq_head;
+      if (head == IORING_LOAD(&rings->sq_tail))
+        {
+          break;
+        }
+
+      /* Every submitted request needs a CQE slot when it completes */
+
+      if (ring->inflight + (rings->cq_tail - IORING_LOAD(&rings->cq_head))
+          >= rings->cq_entries)
+        {
+          break;
+        }
+
+      req = (FAR struct ioring_req_s *)sq_remfirst(&ring->freelist);
+      DEBUGASSERT(req != NULL);
+
+      memcpy(&req->sqe, &ring->sqes[head & rings->sq_mask],
+             sizeof(struct ioring_sqe));
+      IORING_STORE(&rings->sq_head, head + 1);
+      ring->inflight++;
+      n++;
+
+      ret = broken ? -ECANCELED : ioring_prep(ring, req);
+      if (ret < 0)
+        {
+          /* A bad SQE in the middle of a chain cancels the remainder */
+
+          broken = (req->sqe.flags & IOSQE_IO_LINK) != 0;
+          ioring_complete(ring, req, ret);
+        }
+      else if (prev != NULL)
+        {
+          prev->link = req;
+        }
+      else
+        {
+          ioring_ready(ring, req, IORING_REQ_QUEUED);
+        }
+
+      if ((req->sqe.flags & IOSQE_IO_LINK) != 0)
+        {
+          prev = ret < 0 ? NULL : req;
+        }
+      else
+        {
+          prev   = NULL;
+          broken = false;
+        }
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: ioring_open
+ ****************************************************************************/
+
+static int ioring_open(FAR struct file *filep)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ring->crefs >= 255)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      ring->crefs++;
+    }
+
+  nxmutex_unlock(&ring->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_close
+ ****************************************************************************/
+
+static int ioring_close(FAR struct file *filep)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+  irqstate_t flags;
+  unsigned int i;
+
+  nxmutex_lock(&ring->lock);
+  if (ring->crefs > 1)
+    {
+      ring->crefs--;
+      nxmutex_unlock(&ring->lock);
+      return OK;
+    }
+
+  /* Last reference: cancel the requests still waiting for readiness.  The
+   * worker tears down their poll and completes them with -ECANCELED.
+   */
+
+  ring->closing = true;
+  for (i = 0; i < ring->rings->cq_entries; i++)
+    {
+      FAR struct ioring_req_s *req = &ring->reqs[i];
+      bool armed;
+
+      flags = spin_lock_irqsave(&ring->splock);
+      armed = req->state == IORING_REQ_ARMED;
+      if (armed)
+        {
+          req->state = IORING_REQ_READY;
+        }
+
+      spin_unlock_irqrestore(&ring->splock, flags);
+
+      if (armed)
+        {
+          ioring_ready(ring, req, IORING_REQ_READY);
+        }
+    }
+
+  /* Wait for everything in flight to complete */
+
+  while (ring->inflight > 0)
+    {
+      ring->nwaiters++;
+      nxmutex_unlock(&ring->lock);
+      nxsem_wait_uninterruptible(&ring->cqwait);
+      nxmutex_lock(&ring->lock);
+    }
+
+  nxmutex_unlock(&ring->lock);
+  work_cancel_sync(LPWORK, &ring->work);
+
+  if (ring->bufs != NULL)
+    {
+      fs_heap_free(ring->bufs);
+    }
+
+  kumm_free(ring->rings);
+  fs_heap_free(ring->reqs);
+  nxsem_destroy(&ring->cqwait);
+  nxmutex_destroy(&ring->lock);
+  fs_heap_free(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_mmap
+ ****************************************************************************/
+
+static int ioring_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+
+  if (map->offset != IORING_OFF_RINGS || map->length > ring->ringsize)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = ring->rings;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_getring
+ ****************************************************************************/
+
+static int ioring_getring(int fd, FAR struct file **filep,
+                          FAR struct ioring_s **ring)
+{
+  int ret;
+
+  ret = fs_getfilep(fd, filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((*filep)->f_inode != &g_ioring_inode)
+    {
+      fs_putfilep(*filep);
+      return -EBADF;
+    }
+
+  *ring = (*filep)->f_priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring.  See include/sys/ioring.h.
+ *
+ * Input Parameters:
+ *   entries - Minimum number of SQE slots
+ *   p       - Setup parameters, updated with the ring geometry
+ *
+ * Returned Value:
+ *   A new file descriptor on success; -1 with errno set on failure.
+ *
+ ****************************************************************************/
+
+int ioring_setup(unsigned int entries, FAR struct ioring_params *p)
+{
+  FAR struct ioring_s *ring;
+  FAR uint8_t *mem;
+  uint32_t sqentries;
+  uint32_t cqentries;
+  size_t sqesoff;
+  size_t cqesoff;
+  unsigned int i;
+  int ret;
+
+  if (p == NULL || p->flags != 0 || entries == 0 ||
+      entries > CONFIG_FS_IORING_MAXENTRIES)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  sqentries = ioring_roundup(entries);
+  cqentries = ioring_roundup(p->cq_entries != 0 ? p->cq_entries :
+                             2 * sqentries);
+  if (cqentries < sqentries || cqentries > 2 * CONFIG_FS_IORING_MAXENTRIES)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ring = fs_heap_zalloc(sizeof(struct ioring_s));
+  if (ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ring->reqs = fs_heap_zalloc(cqentries * sizeof(struct ioring_req_s));
+  if (ring->reqs == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_ring;
+    }
+
+  /* The ring memory comes from the user heap so that the application can
+   * access it directly once it has been mapped.
+   */
+
+  sqesoff        = IORING_ALIGN_UP(sizeof(struct ioring_rings));
+  cqesoff        = IORING_ALIGN_UP(sqesoff +
+                                   sqentries * sizeof(struct ioring_sqe));
+  ring->ringsize = cqesoff + cqentries * sizeof(struct ioring_cqe);
+
+  mem = kumm_zalloc(ring->ringsize);
+  if (mem == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_reqs;
+    }
+
+  ring->rings             = (FAR struct ioring_rings *)mem;
+  ring->sqes              = (FAR struct ioring_sqe *)(mem + sqesoff);
+  ring->cqes              = (FAR struct ioring_cqe *)(mem + cqesoff);
+  ring->rings->sq_entries = sqentries;
+  ring->rings->sq_mask    = sqentries - 1;
+  ring->rings->cq_entries = cqentries;
+  ring->rings->cq_mask    = cqentries - 1;
+  ring->crefs             = 1;
+
+  for (i = 0; i < cqentries; i++)
+    {
+      ring->reqs[i].ring  = ring;
+      ring->reqs[i].state = IORING_REQ_RUNNING;
+      sq_addlast(&ring->reqs[i].node, &ring->freelist);
+    }
+
+  nxmutex_init(&ring->lock);
+  nxsem_init(&ring->cqwait, 0, 0);
+  spin_lock_init(&ring->splock);
+
+  ret = file_allocate(&g_ioring_inode, O_RDWR | O_CLOEXEC, 0, ring, 0,
+                      true);
+  if (ret < 0)
+    {
+      goto errout_with_sync;
+    }
+
+  p->sq_entries = sqentries;
+  p->cq_entries = cqentries;
+  p->ring_size  = ring->ringsize;
+  p->sqes_off   = sqesoff;
+  p->cqes_off   = cqesoff;
+  return ret;
+
+errout_with_sync:
+  nxsem_destroy(&ring->cqwait);
+  nxmutex_destroy(&ring->lock);
+  kumm_free(mem);
+errout_with_reqs:
+  fs_heap_free(ring->reqs);
+errout_with_ring:
+  fs_heap_free(ring);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Submit queued SQEs in one batch and optionally wait for completions.
+ *
+ * Input Parameters:
+ *   fd           - The ring file descriptor
+ *   to_submit    - Maximum number of SQEs to consume
+ *   min_complete - With IORING_ENTER_GETEVENTS, the number of CQEs that
+ *                  must be available before returning
+ *   flags        - IORING_ENTER_* flags
+ *
+ * Returned Value:
+ *   The number of SQEs consumed on success; -1 with errno set on failure.
+ *   A wait interrupted by a signal after SQEs were consumed still returns
+ *   the count.
+ *
+ ****************************************************************************/
+
+int ioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                 unsigned int flags)
+{
+  FAR struct ioring_rings *rings;
+  FAR struct ioring_s *ring;
+  FAR struct file *filep;
+  int submitted;
+  int ret;
+
+  if ((flags & ~IORING_ENTER_GETEVENTS) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = ioring_getring(fd, &filep, &ring);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  rings = ring->rings;
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  submitted = ioring_submit(ring, to_submit);
+
+  if ((flags & IORING_ENTER_GETEVENTS) != 0)
+    {
+      if (min_complete > rings->cq_entries)
+        {
+          min_complete = rings->cq_entries;
+        }
+
+      while (rings->cq_tail - IORING_LOAD(&rings->cq_head) < min_complete)
+        {
+          ring->nwaiters++;
+          nxmutex_unlock(&ring->lock);
+          ret = nxsem_wait(&ring->cqwait);
+          if (ret < 0)
+            {
+              fs_putfilep(filep);
+              if (submitted > 0)
+                {
+                  return submitted;
+                }
+
+              goto errout;
+            }
+
+          nxmutex_lock(&ring->lock);
+        }
+    }
+
+  nxmutex_unlock(&ring->lock);
+  fs_putfilep(filep);
+  return submitted;
+
+errout_with_filep:
+  fs_putfilep(filep);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: ioring_register
+ *
+ * Description:
+ *   Register or unregister ring resources.
+ *
+ * Input Parameters:
+ *   fd      - The ring file descriptor
+ *   opcode  - IORING_REGISTER_BUFFERS or IORING_UNREGISTER_BUFFERS
+ *   arg     - Array of struct iovec for IORING_REGISTER_BUFFERS
+ *   nr_args - Number of elements in arg
+ *
+ * Returned Value:
+ *   Zero on success; -1 with errno set on failure.
+ *
+ ****************************************************************************/
+
+int ioring_register(int fd, unsigned int opcode, FAR void *arg,
+                    unsigned int nr_args)
+{
+  FAR struct ioring_s *ring;
+  FAR struct file *filep;
+  FAR struct iovec *bufs;
+  int ret;
+
+  ret = ioring_getring(fd, &filep, &ring);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  switch (opcode)
+    {
+      case IORING_REGISTER_BUFFERS:
+        if (ring->bufs != NULL)
+          {
+            ret = -EBUSY;
+          }
+        else if (arg == NULL || nr_args == 0 ||
+                 nr_args > CONFIG_FS_IORING_MAXBUFS)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            bufs = fs_heap_malloc(nr_args * sizeof(struct iovec));
+            if (bufs == NULL)
+              {
+                ret = -ENOMEM;
+                break;
+              }
+
+            memcpy(bufs, arg, nr_args * sizeof(struct iovec));
+            ring->bufs  = bufs;
+            ring->nbufs = nr_args;
+          }
+        break;
+
+      case IORING_UNREGISTER_BUFFERS:
+
+        /* Requests in flight may still be using the buffers */
+
+        if (ring->bufs == NULL)
+          {
+            ret = -ENXIO;
+          }
+        else if (ring->inflight > 0)
+          {
+            ret = -EBUSY;
+          }
+        else
+          {
+            fs_heap_free(ring->bufs);
+            ring->bufs  = NULL;
+            ring->nbufs = 0;
+          }
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  nxmutex_unlock(&ring->lock);
+
+errout_with_filep:
+  fs_putfilep(filep);
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -27,7 +27,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -39,17 +41,17 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: file_pread
+ * Name: file_preadv
  *
  * Description:
- *   Equivalent to the standard pread function except that is accepts a
- *   struct file instance instead of a file descriptor.  Currently used
- *   only by aio_read();
+ *   Equivalent to the standard preadv function except that is accepts a
+ *   struct file instance instead of a file descriptor.  The whole vector is
+ *   handed to the driver's readv method in one call.
  *
  ****************************************************************************/
 
-ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes,
-                   off_t offset)
+ssize_t file_preadv(FAR struct file *filep, FAR const struct uio *uio,
+                    off_t offset)
 {
   off_t savepos;
   off_t pos;
@@ -79,7 +81,7 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes,
 
   /* Then perform the read operation */
 
-  ret = file_read(filep, buf, nbytes);
+  ret = file_readv(filep, uio);
 
   /* Restore the file position */
 
@@ -94,6 +96,30 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes,
   return ret;
 }
 
+/****************************************************************************
+ * Name: file_pread
+ *
+ * Description:
+ *   Equivalent to the standard pread function except that is accepts a
+ *   struct file instance instead of a file descriptor.  Currently used
+ *   only by aio_read();
+ *
+ ****************************************************************************/
+
+ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes,
+                   off_t offset)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = buf;
+  iov.iov_len = nbytes;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return file_preadv(filep, &uio, offset);
+}
+
 /****************************************************************************
  * Name: pread
  *
@@ -157,3 +183,103 @@ errout:
   leave_cancellation_point();
   return (ssize_t)ERROR;
 }
+
+/****************************************************************************
+ * Name: preadv2
+ *
+ * Description:
+ *   The preadv2() function performs the same action as preadv() with an
+ *   additional 'flags' argument that modifies the behavior of this call
+ *   only.  An 'offset' of -1 reads from, and updates, the current file
+ *   position like readv().  Supported flags:
+ *
+ *     RWF_NOWAIT - Do not wait for data that is not immediately available,
+ *                  as if O_NONBLOCK were set for the duration of the call.
+ *     RWF_HIPRI, RWF_DSYNC, RWF_SYNC - Accepted and ignored on reads.
+ *
+ * Input Parameters:
+ *   fd       File descriptor to read from
+ *   iov      User-provided iovec to save the data
+ *   iovcnt   The number of iovec
+ *   offset   The file offset, or -1 to use the current file position
+ *   flags    A bitwise OR of RWF_* values
+ *
+ * Returned Value:
+ *   The positive non-zero number of bytes read on success, 0 on if an
+ *   end-of-file condition, or -1 on failure with errno set appropriately.
+ *   EOPNOTSUPP is reported for unknown flags, and for RWF_NOWAIT on a
+ *   driver without a readv method.
+ *
+ ****************************************************************************/
+
+ssize_t preadv2(int fd, FAR const struct iovec *iov, int iovcnt,
+                off_t offset, int flags)
+{
+  FAR struct file *filep;
+  struct uio uio;
+  ssize_t ret;
+
+  /* preadv2() is a cancellation point */
+
+  enter_cancellation_point();
+
+  if ((flags & ~RWF_SUPPORTED) != 0)
+    {
+      ret = -EOPNOTSUPP;
+      goto errout;
+    }
+
+  /* Get the file structure corresponding to the file descriptor. */
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  uio.uio_iov = iov;
+  uio.uio_iovcnt = iovcnt;
+  uio.uio_flags = 0;
+
+  /* RWF_NOWAIT is passed down with this request only, so that other users
+   * of the open file never see it.  File system files never wait.  A
+   * driver can only honor it through its own readv method, the emulation
+   * with read() has no way to carry it.
+   */
+
+  if ((flags & RWF_NOWAIT) != 0 && (filep->f_oflags & O_NONBLOCK) == 0)
+    {
+      if (!INODE_IS_MOUNTPT(filep->f_inode) &&
+          filep->f_inode->u.i_ops->readv == NULL)
+        {
+          fs_putfilep(filep);
+          ret = -EOPNOTSUPP;
+          goto errout;
+        }
+
+      uio.uio_flags = UIO_NONBLOCK;
+    }
+
+  if (offset == -1)
+    {
+      ret = file_readv(filep, &uio);
+    }
+  else
+    {
+      ret = file_preadv(filep, &uio, offset);
+    }
+
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  set_errno((int)-ret);
+  leave_cancellation_point();
+  return (ssize_t)ERROR;
+}
@@ -27,7 +27,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
@@ -38,17 +40,17 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: file_pwrite
+ * Name: file_pwritev
  *
  * Description:
- *   Equivalent to the standard pwrite function except that is accepts a
- *   struct file instance instead of a file descriptor.  Currently used
- *   only by aio_write();
+ *   Equivalent to the standard pwritev function except that is accepts a
+ *   struct file instance instead of a file descriptor.  The whole vector is
+ *   handed to the driver's writev method in one call.
  *
  ****************************************************************************/
 
-ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
-                    size_t nbytes, off_t offset)
+ssize_t file_pwritev(FAR struct file *filep, FAR const struct uio *uio,
+                     off_t offset)
 {
   off_t savepos;
   off_t pos;
@@ -78,7 +80,7 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 
   /* Then perform the write operation */
 
-  ret = file_write(filep, buf, nbytes);
+  ret = file_writev(filep, uio);
 
   /* Restore the file position */
 
@@ -93,6 +95,30 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
   return ret;
 }
 
+/****************************************************************************
+ * Name: file_pwrite
+ *
+ * Description:
+ *   Equivalent to the standard pwrite function except that is accepts a
+ *   struct file instance instead of a file descriptor.  Currently used
+ *   only by aio_write();
+ *
+ ****************************************************************************/
+
+ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
+                    size_t nbytes, off_t offset)
+{
+  struct iovec iov;
+  struct uio uio;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len = nbytes;
+  uio.uio_iov = &iov;
+  uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
+  return file_pwritev(filep, &uio, offset);
+}
+
 /****************************************************************************
  * Name: pwrite
  *
@@ -160,3 +186,118 @@ errout:
   leave_cancellation_point();
   return (ssize_t)ERROR;
 }
+
+/****************************************************************************
+ * Name: pwritev2
+ *
+ * Description:
+ *   The pwritev2() function performs the same action as pwritev() with an
+ *   additional 'flags' argument that modifies the behavior of this call
+ *   only.  An 'offset' of -1 writes at, and updates, the current file
+ *   position like writev().  Supported flags:
+ *
+ *     RWF_NOWAIT - Do not wait for buffer space, as if O_NONBLOCK were set
+ *                  for the duration of the call.
+ *     RWF_DSYNC, RWF_SYNC - Flush the written data to the media before
+ *                  returning, as if the data were followed by fsync().
+ *     RWF_HIPRI  - Accepted and ignored.
+ *
+ * Input Parameters:
+ *   fd       File descriptor (or socket descriptor) to write to
+ *   iov      Data to write
+ *   iovcnt   The number of iovec
+ *   offset   The file offset, or -1 to use the current file position
+ *   flags    A bitwise OR of RWF_* values
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or -1 on failure with errno
+ *   set appropriately.  EOPNOTSUPP is reported for unknown flags, and for
+ *   RWF_NOWAIT on a driver without a writev method.
+ *
+ ****************************************************************************/
+
+ssize_t pwritev2(int fd, FAR const struct iovec *iov, int iovcnt,
+                 off_t offset, int flags)
+{
+  FAR struct file *filep;
+  struct uio uio;
+  ssize_t ret;
+  int err;
+
+  /* pwritev2() is a cancellation point */
+
+  enter_cancellation_point();
+
+  if ((flags & ~RWF_SUPPORTED) != 0)
+    {
+      ret = -EOPNOTSUPP;
+      goto errout;
+    }
+
+  /* Get the file structure corresponding to the file descriptor. */
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  uio.uio_iov = iov;
+  uio.uio_iovcnt = iovcnt;
+  uio.uio_flags = 0;
+
+  /* RWF_NOWAIT is passed down with this request only, so that other users
+   * of the open file never see it.  File system files never wait.  A
+   * driver can only honor it through its own writev method, the emulation
+   * with write() has no way to carry it.
+   */
+
+  if ((flags & RWF_NOWAIT) != 0 && (filep->f_oflags & O_NONBLOCK) == 0)
+    {
+      if (!INODE_IS_MOUNTPT(filep->f_inode) &&
+          filep->f_inode->u.i_ops->writev == NULL)
+        {
+          fs_putfilep(filep);
+          ret = -EOPNOTSUPP;
+          goto errout;
+        }
+
+      uio.uio_flags = UIO_NONBLOCK;
+    }
+
+  if (offset == -1)
+    {
+      ret = file_writev(filep, &uio);
+    }
+  else
+    {
+      ret = file_pwritev(filep, &uio, offset);
+    }
+
+  /* Files that cannot be synced (pipes, sockets, ...) are written through
+   * already, so only report errors from media that support it.
+   */
+
+  if (ret > 0 && (flags & (RWF_DSYNC | RWF_SYNC)) != 0)
+    {
+      err = file_fsync(filep);
+      if (err < 0 && err != -EINVAL && err != -ENOTTY)
+        {
+          ret = err;
+        }
+    }
+
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  set_errno((int)-ret);
+  leave_cancellation_point();
+  return (ssize_t)ERROR;
+}
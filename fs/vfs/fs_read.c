@@ -37,6 +37,7 @@
 
 #include "notify/notify.h"
 #include "inode/inode.h"
+#include "vfs/readahead.h"
 
 /****************************************************************************
  * Private Functions
@@ -156,13 +157,22 @@ ssize_t file_readv(FAR struct file *filep, FAR const struct uio *uio)
 
   else if (inode != NULL && inode->u.i_ops)
     {
-      if (inode->u.i_ops->readv)
-        {
-          ret = inode->u.i_ops->readv(filep, uio);
-        }
-      else if (inode->u.i_ops->read)
+      /* Sequential reads of file system files may be served by the
+       * readahead.
+       */
+
+      ret = file_readahead(filep, uio);
+      if (ret == -ENOSYS)
         {
-          ret = file_readv_compat(filep, uio);
+          ret = -EBADF;
+          if (inode->u.i_ops->readv)
+            {
+              ret = inode->u.i_ops->readv(filep, uio);
+            }
+          else if (inode->u.i_ops->read)
+            {
+              ret = file_readv_compat(filep, uio);
+            }
         }
     }
 
@@ -209,6 +219,7 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes)
   iov.iov_len = nbytes;
   uio.uio_iov = &iov;
   uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
   return file_readv(filep, &uio);
 }
 
@@ -253,6 +264,7 @@ ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt)
 
   uio.uio_iov = iov;
   uio.uio_iovcnt = iovcnt;
+  uio.uio_flags = 0;
   ret = file_readv(filep, &uio);
   fs_putfilep(filep);
   return ret;
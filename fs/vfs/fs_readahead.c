@@ -0,0 +1,563 @@
+/****************************************************************************
+ * fs/vfs/fs_readahead.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "inode/inode.h"
+#include "vfs/readahead.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_READAHEAD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The readahead state of one open file.  Two buffers are used: the reader
+ * consumes one of them while the low priority worker fills the other with
+ * the data that follows.  The fills go through a private duplicate of the
+ * open file so that they never disturb the file position or the file
+ * system state of the caller's file structure.
+ */
+
+struct file_readahead_s
+{
+  struct work_s work;        /* Asynchronous fill of the next buffer */
+  struct file   file;        /* Private duplicate read by the fills */
+  mutex_t       lock;        /* Serializes the readers of the open file */
+  sem_t         wait;        /* Posted when an asynchronous fill ends */
+  FAR uint8_t  *buffer[2];   /* Buffer being consumed and the next one */
+  size_t        size[2];     /* Allocated size of each buffer */
+  off_t         start[2];    /* File offset of each buffer, -1 if empty */
+  ssize_t       nbytes[2];   /* Valid bytes or a negated errno value */
+  off_t         next;        /* File offset of the next sequential read */
+  size_t        window;      /* Readahead window, zero if not streaming */
+  uint8_t       cur;         /* Index of the buffer being consumed */
+  uint8_t       nwaiters;    /* Readers waiting for the fill to finish */
+  bool          busy;        /* An asynchronous fill is in progress */
+  bool          dup;         /* 'file' holds a valid duplicate */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: readahead_covers
+ *
+ * Description:
+ *   Return true if buffer 'idx' holds the byte at file offset 'pos'.
+ *
+ ****************************************************************************/
+
+static bool readahead_covers(FAR struct file_readahead_s *ra, int idx,
+                             off_t pos)
+{
+  return ra->start[idx] >= 0 && ra->nbytes[idx] > 0 &&
+         pos >= ra->start[idx] && pos < ra->start[idx] + ra->nbytes[idx];
+}
+
+/****************************************************************************
+ * Name: readahead_fill
+ *
+ * Description:
+ *   Read 'size' bytes at file offset 'pos' through the private duplicate
+ *   of the open file.  Only end-of-file stops the read short.
+ *
+ ****************************************************************************/
+
+static ssize_t readahead_fill(FAR struct file_readahead_s *ra,
+                              FAR uint8_t *buffer, off_t pos, size_t size)
+{
+  FAR struct file *filep = &ra->file;
+  FAR struct inode *inode = filep->f_inode;
+  ssize_t total = 0;
+  ssize_t nread;
+  off_t ret;
+
+  ret = file_seek(filep, pos, SEEK_SET);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (total < size)
+    {
+      nread = inode->u.i_ops->read(filep, (FAR char *)buffer + total,
+                                   size - total);
+      if (nread <= 0)
+        {
+          if (nread < 0 && total == 0)
+            {
+              return nread;
+            }
+
+          break;
+        }
+
+      total += nread;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: readahead_worker
+ *
+ * Description:
+ *   Fill the buffer that is not being consumed.  While 'busy' is set the
+ *   reader touches neither that buffer nor the private file.
+ *
+ ****************************************************************************/
+
+static void readahead_worker(FAR void *arg)
+{
+  FAR struct file_readahead_s *ra = arg;
+  int idx = ra->cur ^ 1;
+  ssize_t nread;
+
+  nread = readahead_fill(ra, ra->buffer[idx], ra->start[idx],
+                         ra->nbytes[idx]);
+
+  nxmutex_lock(&ra->lock);
+  ra->nbytes[idx] = nread;
+  ra->busy        = false;
+
+  while (ra->nwaiters > 0)
+    {
+      ra->nwaiters--;
+      nxsem_post(&ra->wait);
+    }
+
+  nxmutex_unlock(&ra->lock);
+}
+
+/****************************************************************************
+ * Name: readahead_wait
+ *
+ * Description:
+ *   Wait for the asynchronous fill in progress, if any.  Called and
+ *   returns with the readahead lock held.
+ *
+ ****************************************************************************/
+
+static void readahead_wait(FAR struct file_readahead_s *ra)
+{
+  while (ra->busy)
+    {
+      ra->nwaiters++;
+      nxmutex_unlock(&ra->lock);
+      nxsem_wait_uninterruptible(&ra->wait);
+      nxmutex_lock(&ra->lock);
+    }
+}
+
+/****************************************************************************
+ * Name: readahead_alloc
+ *
+ * Description:
+ *   Make buffer 'idx' large enough for the current window.
+ *
+ ****************************************************************************/
+
+static int readahead_alloc(FAR struct file_readahead_s *ra, int idx)
+{
+  FAR uint8_t *buffer;
+
+  if (ra->size[idx] >= ra->window)
+    {
+      return OK;
+    }
+
+  buffer = fs_heap_malloc(ra->window);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fs_heap_free(ra->buffer[idx]);
+  ra->buffer[idx] = buffer;
+  ra->size[idx]   = ra->window;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: readahead_start
+ *
+ * Description:
+ *   Start filling the buffer that is not being consumed with one window
+ *   of data at file offset 'pos'.  Readahead is best effort: if the buffer
+ *   or the work cannot be obtained, the next read is simply synchronous.
+ *
+ *   Kernel threads fill the buffer synchronously instead.  They include
+ *   the work queue threads, such as the aio worker, and a fill queued
+ *   behind the caller on its own queue would never run while it waits.
+ *
+ ****************************************************************************/
+
+static void readahead_start(FAR struct file_readahead_s *ra, off_t pos)
+{
+  int idx = ra->cur ^ 1;
+
+  DEBUGASSERT(!ra->busy);
+
+  if (readahead_alloc(ra, idx) < 0)
+    {
+      return;
+    }
+
+  ra->start[idx]  = pos;
+  ra->nbytes[idx] = ra->window;
+
+  if ((nxsched_self()->flags & TCB_FLAG_TTYPE_MASK) ==
+      TCB_FLAG_TTYPE_KERNEL)
+    {
+      ra->nbytes[idx] = readahead_fill(ra, ra->buffer[idx], pos,
+                                       ra->window);
+      return;
+    }
+
+  ra->busy        = true;
+
+  if (work_queue(LPWORK, &ra->work, readahead_worker, ra, 0) < 0)
+    {
+      ra->start[idx] = -1;
+      ra->busy       = false;
+    }
+}
+
+/****************************************************************************
+ * Name: readahead_read
+ *
+ * Description:
+ *   Read into one user buffer.  Called with the readahead lock held.
+ *
+ ****************************************************************************/
+
+static ssize_t readahead_read(FAR struct file *filep,
+                              FAR struct file_readahead_s *ra,
+                              FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  off_t pos = filep->f_pos;
+  ssize_t total = 0;
+  ssize_t nread;
+  size_t ncopy;
+  int idx;
+
+  /* A read that does not continue the previous one ends the stream.  The
+   * second read in a row that does starts one with the smallest window.
+   */
+
+  if (pos != ra->next)
+    {
+      ra->window = 0;
+    }
+  else if (ra->window == 0)
+    {
+      if (!ra->dup && file_dup2(filep, &ra->file) >= 0)
+        {
+          ra->dup = true;
+        }
+
+      if (ra->dup)
+        {
+          ra->window = CONFIG_FS_READAHEAD_MIN;
+        }
+    }
+
+  if (ra->window == 0)
+    {
+      nread = inode->u.i_ops->read(filep, (FAR char *)buffer, buflen);
+      ra->next = filep->f_pos;
+      return nread;
+    }
+
+  while (buflen > 0)
+    {
+      idx = ra->cur;
+      if (readahead_covers(ra, idx, pos))
+        {
+          ncopy = MIN(buflen, ra->start[idx] + ra->nbytes[idx] - pos);
+          memcpy(buffer, ra->buffer[idx] + (pos - ra->start[idx]), ncopy);
+
+          buffer += ncopy;
+          buflen -= ncopy;
+          pos    += ncopy;
+          total  += ncopy;
+          continue;
+        }
+
+      /* The current buffer is used up, so switch to the one that follows
+       * once it has been filled.
+       */
+
+      readahead_wait(ra);
+
+      idx ^= 1;
+      if (ra->start[idx] == pos && ra->nbytes[idx] <= 0)
+        {
+          /* The readahead ran into the end of the file or an error */
+
+          nread = ra->nbytes[idx];
+          ra->start[idx] = -1;
+          if (nread < 0 && total == 0)
+            {
+              total = nread;
+            }
+
+          break;
+        }
+
+      if (readahead_covers(ra, idx, pos))
+        {
+          /* A readahead hit confirms the stream: double the window and
+           * prefetch behind the new current buffer.
+           */
+
+          ra->cur    = idx;
+          ra->window = MIN(ra->window * 2, CONFIG_FS_READAHEAD_MAX);
+          readahead_start(ra, ra->start[idx] + ra->nbytes[idx]);
+          continue;
+        }
+
+      /* Nothing is buffered at this offset.  Requests of at least a window
+       * are read straight into the caller's buffer, smaller ones through
+       * the current buffer.
+       */
+
+      idx = ra->cur;
+      if (buflen >= ra->window || readahead_alloc(ra, idx) < 0)
+        {
+          nread = readahead_fill(ra, buffer, pos, buflen);
+          if (nread > 0)
+            {
+              pos   += nread;
+              total += nread;
+              if (nread == buflen)
+                {
+                  readahead_start(ra, pos);
+                }
+            }
+          else if (nread < 0 && total == 0)
+            {
+              total = nread;
+            }
+
+          break;
+        }
+
+      nread = readahead_fill(ra, ra->buffer[idx], pos, ra->window);
+      if (nread <= 0)
+        {
+          ra->start[idx] = -1;
+          if (nread < 0 && total == 0)
+            {
+              total = nread;
+            }
+
+          break;
+        }
+
+      ra->start[idx]  = pos;
+      ra->nbytes[idx] = nread;
+      if (nread == ra->window)
+        {
+          readahead_start(ra, pos + nread);
+        }
+    }
+
+  /* Move the caller's file to the new position through the file system so
+   * that its own state stays consistent with f_pos.
+   */
+
+  if (pos != filep->f_pos && file_seek(filep, pos, SEEK_SET) < 0)
+    {
+      filep->f_pos = pos;
+    }
+
+  ra->next = pos;
+  return total;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readahead
+ *
+ * Description:
+ *   Read from a file system file through the per-open-file readahead
+ *   state.  See fs/vfs/readahead.h.
+ *
+ ****************************************************************************/
+
+ssize_t file_readahead(FAR struct file *filep, FAR const struct uio *uio)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct file_readahead_s *ra = filep->f_ra;
+  irqstate_t flags;
+  ssize_t ntotal = 0;
+  ssize_t nread;
+  size_t len;
+  int ret;
+  int i;
+
+  if (ra == NULL)
+    {
+      /* Only files opened read-only on a mounted file system that can
+       * duplicate its open files are eligible.
+       */
+
+      if (!INODE_IS_MOUNTPT(inode) || inode->u.i_mops->dup == NULL ||
+          (filep->f_oflags & (O_WROK | O_DIRECT)) != 0)
+        {
+          return -ENOSYS;
+        }
+
+      ra = fs_heap_zalloc(sizeof(struct file_readahead_s));
+      if (ra == NULL)
+        {
+          return -ENOSYS;
+        }
+
+      nxmutex_init(&ra->lock);
+      nxsem_init(&ra->wait, 0, 0);
+      ra->start[0] = -1;
+      ra->start[1] = -1;
+      ra->next     = -1;
+
+      /* Another thread sharing the file may have won the race */
+
+      flags = spin_lock_irqsave(NULL);
+      if (filep->f_ra == NULL)
+        {
+          filep->f_ra = ra;
+          spin_unlock_irqrestore(NULL, flags);
+        }
+      else
+        {
+          spin_unlock_irqrestore(NULL, flags);
+          nxmutex_destroy(&ra->lock);
+          nxsem_destroy(&ra->wait);
+          fs_heap_free(ra);
+          ra = filep->f_ra;
+        }
+    }
+
+  ret = nxmutex_lock(&ra->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < uio->uio_iovcnt; i++)
+    {
+      len = uio->uio_iov[i].iov_len;
+      if (len == 0)
+        {
+          continue;
+        }
+
+      nread = readahead_read(filep, ra, uio->uio_iov[i].iov_base, len);
+      if (nread < 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = nread;
+            }
+
+          break;
+        }
+
+      ntotal += nread;
+      if (nread < len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&ra->lock);
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: file_readahead_release
+ *
+ * Description:
+ *   Cancel any readahead in progress and free the readahead state of an
+ *   open file.
+ *
+ ****************************************************************************/
+
+void file_readahead_release(FAR struct file *filep)
+{
+  FAR struct file_readahead_s *ra = filep->f_ra;
+
+  if (ra == NULL)
+    {
+      return;
+    }
+
+  filep->f_ra = NULL;
+
+  /* A fill that is already queued cannot be told apart from one that is
+   * running, so just let it complete.
+   */
+
+  nxmutex_lock(&ra->lock);
+  readahead_wait(ra);
+  nxmutex_unlock(&ra->lock);
+
+  if (ra->dup)
+    {
+      file_close(&ra->file);
+    }
+
+  fs_heap_free(ra->buffer[0]);
+  fs_heap_free(ra->buffer[1]);
+  nxmutex_destroy(&ra->lock);
+  nxsem_destroy(&ra->wait);
+  fs_heap_free(ra);
+}
+
+#endif /* CONFIG_FS_READAHEAD */
@@ -35,6 +35,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/mutex.h>
 
 #include <sys/ioctl.h>
@@ -48,10 +49,36 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* With CONFIG_HRTIMER the timer is kept in nanoseconds by a high
+ * resolution timer, otherwise in clock ticks by a watchdog.
+ */
+
+#ifdef CONFIG_HRTIMER
+#  define timerfd_time2delay(ts)      clock_time2nsec(ts)
+#  define timerfd_delay2time(ts, d)   clock_nsec2time(ts, d)
+#  define timerfd_remaining(dev)      hrtimer_gettime(&(dev)->hrtimer)
+#  define timerfd_cancel(dev)         hrtimer_cancel(&(dev)->hrtimer)
+#  define timerfd_start(dev, d) \
+     hrtimer_start(&(dev)->hrtimer, d, timerfd_timeout, dev)
+#else
+#  define timerfd_time2delay(ts)      clock_time2ticks(ts)
+#  define timerfd_delay2time(ts, d)   clock_ticks2time(ts, d)
+#  define timerfd_remaining(dev)      wd_gettime(&(dev)->wdog)
+#  define timerfd_cancel(dev)         wd_cancel(&(dev)->wdog)
+#  define timerfd_start(dev, d) \
+     wd_start(&(dev)->wdog, d, timerfd_timeout, (wdparm_t)(dev))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_HRTIMER
+typedef uint64_t timerfd_delay_t;
+#else
+typedef sclock_t timerfd_delay_t;
+#endif
+
 typedef struct timerfd_waiter_sem_s
 {
   sem_t sem;
@@ -65,9 +92,13 @@ struct timerfd_priv_s
   mutex_t                   lock;    /* Enforces device exclusive access */
   FAR timerfd_waiter_sem_t *rdsems;  /* List of blocking readers */
   int                       clock;   /* Clock to use as the timing base */
-  int                       delay;   /* If non-zero, used to reset repetitive
+  timerfd_delay_t           delay;   /* If non-zero, used to reset repetitive
                                       * timers */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s          hrtimer; /* The timer that provides the timing */
+#else
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+#endif
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
 
@@ -101,7 +132,11 @@ static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
 static FAR struct timerfd_priv_s *timerfd_allocdev(void);
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev);
 
+#ifdef CONFIG_HRTIMER
+static void timerfd_timeout(FAR void *arg);
+#else
 static void timerfd_timeout(wdparm_t arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -158,7 +193,7 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void)
 
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
 {
-  wd_cancel(&dev->wdog);
+  timerfd_cancel(dev);
   nxmutex_unlock(&dev->lock);
   nxmutex_destroy(&dev->lock);
   fs_heap_free(dev);
@@ -384,7 +419,11 @@ out:
 }
 #endif
 
+#ifdef CONFIG_HRTIMER
+static void timerfd_timeout(FAR void *arg)
+#else
 static void timerfd_timeout(wdparm_t arg)
+#endif
 {
   FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
   FAR timerfd_waiter_sem_t *cur_sem;
@@ -404,7 +443,15 @@ static void timerfd_timeout(wdparm_t arg)
 
   if (dev->delay > 0)
     {
+#ifdef CONFIG_HRTIMER
+      /* Restart relative to the previous expiration to avoid drift */
+
+      hrtimer_start_absolute(&dev->hrtimer,
+                             dev->hrtimer.expired + dev->delay,
+                             timerfd_timeout, dev);
+#else
       wd_start(&dev->wdog, dev->delay, timerfd_timeout, arg);
+#endif
     }
 
 #ifdef CONFIG_TIMER_FD_POLL
@@ -490,7 +537,7 @@ int timerfd_settime(int fd, int flags,
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
   irqstate_t intflags;
-  sclock_t delay;
+  timerfd_delay_t delay;
   int ret;
 
   /* Some sanity checks */
@@ -530,21 +577,21 @@ int timerfd_settime(int fd, int flags,
 
   if (old_value)
     {
-      /* Get the number of ticks before the underlying watchdog expires */
+      /* Get the time before the underlying timer expires */
 
-      delay = wd_gettime(&dev->wdog);
+      delay = timerfd_remaining(dev);
 
       /* Convert that to a struct timespec and return it */
 
-      clock_ticks2time(&old_value->it_value, delay);
-      clock_ticks2time(&old_value->it_interval, dev->delay);
+      timerfd_delay2time(&old_value->it_value, delay);
+      timerfd_delay2time(&old_value->it_interval, dev->delay);
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timerfd_settime() is called).
    */
 
-  wd_cancel(&dev->wdog);
+  timerfd_cancel(dev);
 
   /* Clear expiration counter */
 
@@ -563,7 +610,7 @@ int timerfd_settime(int fd, int flags,
 
   /* Setup up any repetitive timer */
 
-  delay = clock_time2ticks(&new_value->it_interval);
+  delay = timerfd_time2delay(&new_value->it_interval);
   dev->delay = delay;
 
   /* We need to disable timer interrupts through the following section so
@@ -576,7 +623,22 @@ int timerfd_settime(int fd, int flags,
     {
       /* Calculate a delay corresponding to the absolute time in 'value' */
 
+#ifdef CONFIG_HRTIMER
+      struct timespec now;
+
+      nxclock_gettime(dev->clock, &now);
+      if (clock_timespec_compare(&new_value->it_value, &now) > 0)
+        {
+          clock_timespec_subtract(&new_value->it_value, &now, &now);
+          delay = clock_time2nsec(&now);
+        }
+      else
+        {
+          delay = 0;
+        }
+#else
       clock_abstime2ticks(dev->clock, &new_value->it_value, &delay);
+#endif
     }
   else
     {
@@ -585,7 +647,7 @@ int timerfd_settime(int fd, int flags,
        * returns success.
        */
 
-      delay = clock_time2ticks(&new_value->it_value);
+      delay = timerfd_time2delay(&new_value->it_value);
     }
 
   /* If the time is in the past or now, then set up the next interval
@@ -597,9 +659,9 @@ int timerfd_settime(int fd, int flags,
       delay = dev->delay;
     }
 
-  /* Then start the watchdog */
+  /* Then start the timer */
 
-  ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+  ret = timerfd_start(dev, delay);
   if (ret < 0)
     {
       leave_critical_section(intflags);
@@ -621,7 +683,7 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 {
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
-  sclock_t ticks;
+  timerfd_delay_t delay;
   int ret;
 
   /* Some sanity checks */
@@ -648,14 +710,14 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   dev = (FAR struct timerfd_priv_s *)filep->f_priv;
 
-  /* Get the number of ticks before the underlying watchdog expires */
+  /* Get the time before the underlying timer expires */
 
-  ticks = wd_gettime(&dev->wdog);
+  delay = timerfd_remaining(dev);
 
   /* Convert that to a struct timespec and return it */
 
-  clock_ticks2time(&curr_value->it_value, ticks);
-  clock_ticks2time(&curr_value->it_interval, dev->delay);
+  timerfd_delay2time(&curr_value->it_value, delay);
+  timerfd_delay2time(&curr_value->it_interval, dev->delay);
   fs_putfilep(filep);
   return OK;
 
@@ -212,6 +212,7 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf,
   iov.iov_len = nbytes;
   uio.uio_iov = &iov;
   uio.uio_iovcnt = 1;
+  uio.uio_flags = 0;
   return file_writev(filep, &uio);
 }
 
@@ -259,6 +260,7 @@ ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt)
 
       uio.uio_iov = iov;
       uio.uio_iovcnt = iovcnt;
+      uio.uio_flags = 0;
       ret = file_writev(filep, &uio);
       fs_putfilep(filep);
     }
@@ -0,0 +1,87 @@
+/****************************************************************************
+ * fs/vfs/readahead.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_VFS_READAHEAD_H
+#define __FS_VFS_READAHEAD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/uio.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_READAHEAD
+#  define file_readahead(filep, uio) ((void)(uio), -ENOSYS)
+#  define file_readahead_release(filep)
+#else
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readahead
+ *
+ * Description:
+ *   Read from a file system file through the per-open-file readahead
+ *   state.  Sequential streams are detected and served from buffers that
+ *   are filled asynchronously on the low priority work queue; everything
+ *   else is passed straight through to the file system.
+ *
+ * Input Parameters:
+ *   filep - File structure instance
+ *   uio   - User buffer information
+ *
+ * Returned Value:
+ *   The number of bytes read, zero at end-of-file, or a negated errno
+ *   value on failure.  -ENOSYS means that readahead does not apply to this
+ *   file and the caller should perform the read itself.
+ *
+ ****************************************************************************/
+
+ssize_t file_readahead(FAR struct file *filep, FAR const struct uio *uio);
+
+/****************************************************************************
+ * Name: file_readahead_release
+ *
+ * Description:
+ *   Cancel any readahead in progress and free the readahead state of an
+ *   open file.  Called when the file is closed.
+ *
+ * Input Parameters:
+ *   filep - File structure instance
+ *
+ ****************************************************************************/
+
+void file_readahead_release(FAR struct file *filep);
+
+#endif /* CONFIG_FS_READAHEAD */
+#endif /* __FS_VFS_READAHEAD_H */
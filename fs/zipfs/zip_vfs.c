@@ -28,6 +28,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <nuttx/mutex.h>
@@ -39,10 +40,69 @@
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of the deflate history window */
+
+#define ZIPFS_WINSIZE 32768
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#if CONFIG_ZIPFS_INDEX_SPAN > 0
+
+/* A point from which inflation of a member can be restarted */
+
+struct zipfs_point_s
+{
+  off_t out;                  /* Uncompressed offset of the point */
+  off_t in;                   /* Compressed offset of the next full byte */
+  int bits;                   /* Unused bits of the byte before in */
+  FAR uint8_t *window;        /* The output preceding the point */
+};
+
+/* One cached block of decompressed data */
+
+#  if CONFIG_ZIPFS_CACHE_BLOCKS > 0
+struct zipfs_block_s
+{
+  off_t blkno;                /* Block number, -1 if unused */
+  size_t len;                 /* Valid bytes, short only at the end */
+  uint32_t stamp;             /* Last use, for LRU replacement */
+  FAR uint8_t *data;
+};
+#  endif
+
+/* The random access state of a stored or deflated member */
+
+struct zipfs_inflate_s
+{
+  struct file zfile;          /* The archive, read directly */
+  off_t base;                 /* Archive offset of the member data */
+  off_t csize;                /* Compressed size */
+  off_t size;                 /* Uncompressed size */
+  bool stored;                /* Stored without compression */
+  bool eof;                   /* End of the deflate stream reached */
+  z_stream strm;
+  off_t inread;               /* Compressed bytes read into strm */
+  off_t out;                  /* Uncompressed offset of strm */
+  size_t have;                /* Valid bytes in window[] */
+  size_t wpos;                /* Next byte of window[] to write */
+  int npoints;
+  int maxpoints;
+  FAR struct zipfs_point_s *points;
+#  if CONFIG_ZIPFS_CACHE_BLOCKS > 0
+  uint32_t stamp;
+  struct zipfs_block_s blocks[CONFIG_ZIPFS_CACHE_BLOCKS];
+#  endif
+  FAR uint8_t *window;        /* Circular buffer of the recent output */
+  uint8_t input[CONFIG_ZIPFS_SEEK_BUFSIZE];
+};
+#endif
+
 struct zipfs_dir_s
 {
   struct fs_dirent_s base;
@@ -61,6 +121,9 @@ struct zipfs_file_s
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+#if CONFIG_ZIPFS_INDEX_SPAN > 0
+  FAR struct zipfs_inflate_s *zi; /* NULL if minizip reads the member */
+#endif
   char relpath[1];
 };
 
@@ -243,6 +306,451 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#if CONFIG_ZIPFS_INDEX_SPAN > 0
+
+/* Record a restart point at the current deflate block boundary, with a
+ * copy of the output window that the next blocks may refer back to.
+ */
+
+static void zipfs_inflate_addpoint(FAR struct zipfs_inflate_s *zi)
+{
+  FAR struct zipfs_point_s *point;
+  size_t tail;
+
+  if (zi->npoints == zi->maxpoints)
+    {
+      int maxpoints = zi->maxpoints ? zi->maxpoints * 2 : 8;
+
+      point = fs_heap_realloc(zi->points, maxpoints * sizeof(*point));
+      if (point == NULL)
+        {
+          return;
+        }
+
+      zi->points = point;
+      zi->maxpoints = maxpoints;
+    }
+
+  point = &zi->points[zi->npoints];
+  point->window = fs_heap_malloc(zi->have);
+  if (point->window == NULL)
+    {
+      return;
+    }
+
+  /* Unroll the circular window, oldest byte first */
+
+  tail = zi->have - zi->wpos;
+  memcpy(point->window, zi->window + ZIPFS_WINSIZE - tail, tail);
+  memcpy(point->window + tail, zi->window, zi->wpos);
+
+  point->out = zi->out;
+  point->in = zi->inread - zi->strm.avail_in;
+  point->bits = zi->strm.data_type & 7;
+  zi->npoints++;
+}
+
+/* Restart inflation from a point, or from the start of the member if
+ * point is NULL.
+ */
+
+static int zipfs_inflate_reset(FAR struct zipfs_inflate_s *zi,
+                               FAR struct zipfs_point_s *point)
+{
+  size_t dictlen;
+  uint8_t byte;
+  ssize_t nread;
+
+  if (inflateReset(&zi->strm) != Z_OK)
+    {
+      return -EIO;
+    }
+
+  zi->strm.avail_in = 0;
+  zi->eof = false;
+  if (point == NULL)
+    {
+      zi->inread = 0;
+      zi->out = 0;
+      zi->have = 0;
+      zi->wpos = 0;
+      return OK;
+    }
+
+  /* The point may start in the middle of a byte */
+
+  zi->inread = point->in;
+  if (point->bits != 0)
+    {
+      nread = file_pread(&zi->zfile, &byte, 1, zi->base + point->in - 1);
+      if (nread != 1)
+        {
+          return nread < 0 ? nread : -EIO;
+        }
+
+      inflatePrime(&zi->strm, point->bits, byte >> (8 - point->bits));
+    }
+
+  dictlen = MIN(point->out, ZIPFS_WINSIZE);
+  if (inflateSetDictionary(&zi->strm, point->window, dictlen) != Z_OK)
+    {
+      return -EIO;
+    }
+
+  memcpy(zi->window, point->window, dictlen);
+  zi->out = point->out;
+  zi->have = dictlen;
+  zi->wpos = dictlen;
+  return OK;
+}
+
+/* Inflate up to len bytes at the current position into dest, or discard
+ * them if dest is NULL.  Returns the number of bytes produced.
+ */
+
+static ssize_t zipfs_inflate(FAR struct zipfs_inflate_s *zi,
+                             FAR uint8_t *dest, size_t len)
+{
+  size_t total = 0;
+  size_t chunk;
+  ssize_t nread;
+  int ret;
+
+  while (total < len && !zi->eof)
+    {
+      /* Once all input is read, inflate may still hold the last bits */
+
+      if (zi->strm.avail_in == 0 && zi->inread < zi->csize)
+        {
+          nread = MIN(zi->csize - zi->inread, CONFIG_ZIPFS_SEEK_BUFSIZE);
+          nread = file_pread(&zi->zfile, zi->input, nread,
+                             zi->base + zi->inread);
+          if (nread <= 0)
+            {
+              return total ? total : nread < 0 ? nread : -EIO;
+            }
+
+          zi->inread += nread;
+          zi->strm.next_in = zi->input;
+          zi->strm.avail_in = nread;
+        }
+
+      if (zi->wpos == ZIPFS_WINSIZE)
+        {
+          zi->wpos = 0;
+        }
+
+      chunk = MIN(len - total, ZIPFS_WINSIZE - zi->wpos);
+      zi->strm.next_out = zi->window + zi->wpos;
+      zi->strm.avail_out = chunk;
+
+      /* Stop at each deflate block boundary to find restart points */
+
+      ret = inflate(&zi->strm, Z_BLOCK);
+      if (ret != Z_OK && ret != Z_STREAM_END)
+        {
+          return total ? total : ret == Z_MEM_ERROR ? -ENOMEM : -EIO;
+        }
+
+      chunk -= zi->strm.avail_out;
+      if (dest != NULL)
+        {
+          memcpy(dest + total, zi->window + zi->wpos, chunk);
+        }
+
+      total    += chunk;
+      zi->out  += chunk;
+      zi->wpos += chunk;
+      zi->have  = MIN(zi->have + chunk, ZIPFS_WINSIZE);
+
+      if (ret == Z_STREAM_END)
+        {
+          zi->eof = true;
+        }
+      else if ((zi->strm.data_type & 128) != 0 &&
+               (zi->strm.data_type & 64) == 0 &&
+               zi->out - (zi->npoints ?
+                          zi->points[zi->npoints - 1].out : 0) >=
+               CONFIG_ZIPFS_INDEX_SPAN)
+        {
+          zipfs_inflate_addpoint(zi);
+        }
+    }
+
+  return total;
+}
+
+/* Return up to len bytes at pos.  Data still in the window is copied
+ * from there; otherwise inflation restarts from the closest point before
+ * pos when that is ahead of the current position or pos lies behind it.
+ */
+
+static ssize_t zipfs_inflate_at(FAR struct zipfs_inflate_s *zi, off_t pos,
+                                FAR uint8_t *dest, size_t len)
+{
+  FAR struct zipfs_point_s *point = NULL;
+  size_t start;
+  ssize_t ret;
+  int i;
+
+  if (pos >= zi->size)
+    {
+      return 0;
+    }
+
+  len = MIN(len, zi->size - pos);
+  if (zi->stored)
+    {
+      return file_pread(&zi->zfile, dest, len, zi->base + pos);
+    }
+
+  if (pos < zi->out && pos >= zi->out - (off_t)zi->have)
+    {
+      start = (zi->wpos + ZIPFS_WINSIZE - (zi->out - pos)) % ZIPFS_WINSIZE;
+      len = MIN(len, zi->out - pos);
+      len = MIN(len, ZIPFS_WINSIZE - start);
+      memcpy(dest, zi->window + start, len);
+      return len;
+    }
+
+  for (i = zi->npoints - 1; i >= 0; i--)
+    {
+      if (zi->points[i].out <= pos)
+        {
+          point = &zi->points[i];
+          break;
+        }
+    }
+
+  if (pos < zi->out || (point != NULL && point->out > zi->out))
+    {
+      ret = zipfs_inflate_reset(zi, point);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  while (zi->out < pos)
+    {
+      ret = zipfs_inflate(zi, NULL, pos - zi->out);
+      if (ret <= 0)
+        {
+          return ret;
+        }
+    }
+
+  return zipfs_inflate(zi, dest, len);
+}
+
+#  if CONFIG_ZIPFS_CACHE_BLOCKS > 0
+/* Return the cached block blkno, inflating it into the least recently
+ * used entry on a miss.
+ */
+
+static FAR struct zipfs_block_s *
+zipfs_cache_get(FAR struct zipfs_inflate_s *zi, off_t blkno,
+                FAR ssize_t *err)
+{
+  FAR struct zipfs_block_s *block = &zi->blocks[0];
+  ssize_t ret;
+  int i;
+
+  for (i = 0; i < CONFIG_ZIPFS_CACHE_BLOCKS; i++)
+    {
+      if (zi->blocks[i].blkno == blkno)
+        {
+          block = &zi->blocks[i];
+          block->stamp = ++zi->stamp;
+          return block;
+        }
+      else if (zi->blocks[i].stamp < block->stamp)
+        {
+          block = &zi->blocks[i];
+        }
+    }
+
+  if (block->data == NULL)
+    {
+      block->data = fs_heap_malloc(CONFIG_ZIPFS_CACHE_BLOCKSIZE);
+      if (block->data == NULL)
+        {
+          *err = -ENOMEM;
+          return NULL;
+        }
+    }
+
+  block->blkno = -1;
+  block->len = 0;
+  while (block->len < CONFIG_ZIPFS_CACHE_BLOCKSIZE)
+    {
+      ret = zipfs_inflate_at(zi,
+                             blkno * CONFIG_ZIPFS_CACHE_BLOCKSIZE +
+                             block->len, block->data + block->len,
+                             CONFIG_ZIPFS_CACHE_BLOCKSIZE - block->len);
+      if (ret < 0)
+        {
+          *err = ret;
+          return NULL;
+        }
+      else if (ret == 0)
+        {
+          break;
+        }
+
+      block->len += ret;
+    }
+
+  block->blkno = blkno;
+  block->stamp = ++zi->stamp;
+  return block;
+}
+#  endif
+
+static ssize_t zipfs_inflate_read(FAR struct zipfs_inflate_s *zi,
+                                  off_t pos, FAR char *buffer,
+                                  size_t buflen)
+{
+  size_t total = 0;
+  ssize_t ret = 0;
+
+  buflen = MIN(buflen, zi->size - MIN(pos, zi->size));
+  while (total < buflen)
+    {
+#  if CONFIG_ZIPFS_CACHE_BLOCKS > 0
+      FAR struct zipfs_block_s *block;
+      size_t offset;
+
+      block = zipfs_cache_get(zi, pos / CONFIG_ZIPFS_CACHE_BLOCKSIZE, &ret);
+      if (block == NULL)
+        {
+          break;
+        }
+
+      offset = pos % CONFIG_ZIPFS_CACHE_BLOCKSIZE;
+      if (offset >= block->len)
+        {
+          break;
+        }
+
+      ret = MIN(buflen - total, block->len - offset);
+      memcpy(buffer + total, block->data + offset, ret);
+#  else
+      ret = zipfs_inflate_at(zi, pos, (FAR uint8_t *)buffer + total,
+                             buflen - total);
+      if (ret <= 0)
+        {
+          break;
+        }
+#  endif
+
+      total += ret;
+      pos   += ret;
+    }
+
+  return total ? total : ret;
+}
+
+static void zipfs_inflate_free(FAR struct zipfs_inflate_s *zi)
+{
+  int i;
+
+  if (!zi->stored)
+    {
+      inflateEnd(&zi->strm);
+    }
+
+  for (i = 0; i < zi->npoints; i++)
+    {
+      fs_heap_free(zi->points[i].window);
+    }
+
+#  if CONFIG_ZIPFS_CACHE_BLOCKS > 0
+  for (i = 0; i < CONFIG_ZIPFS_CACHE_BLOCKS; i++)
+    {
+      fs_heap_free(zi->blocks[i].data);
+    }
+#  endif
+
+  file_close(&zi->zfile);
+  fs_heap_free(zi->points);
+  fs_heap_free(zi->window);
+  fs_heap_free(zi);
+}
+
+/* Take over the reads of the member opened in uf if it is stored, or
+ * deflated and large enough to benefit.  Returns NULL to leave the member
+ * to minizip.
+ */
+
+static FAR struct zipfs_inflate_s *
+zipfs_inflate_open(FAR struct zipfs_mountpt_s *fs, unzFile uf)
+{
+  FAR struct zipfs_inflate_s *zi;
+  unz_file_info64 file_info;
+  int ret;
+
+  ret = unzGetCurrentFileInfo64(uf, &file_info, NULL, 0, NULL, 0, NULL, 0);
+  if (ret != UNZ_OK || (file_info.flag & 1) != 0 ||
+      (file_info.compression_method != 0 &&
+       (file_info.compression_method != Z_DEFLATED ||
+        file_info.uncompressed_size <= ZIPFS_WINSIZE)))
+    {
+      return NULL;
+    }
+
+  zi = fs_heap_zalloc(sizeof(*zi));
+  if (zi == NULL)
+    {
+      return NULL;
+    }
+
+  if (file_open(&zi->zfile, fs->abspath, O_RDONLY) < 0)
+    {
+      fs_heap_free(zi);
+      return NULL;
+    }
+
+  zi->base   = unzGetCurrentFileZStreamPos64(uf);
+  zi->csize  = file_info.compressed_size;
+  zi->size   = file_info.uncompressed_size;
+  zi->stored = file_info.compression_method == 0;
+
+#  if CONFIG_ZIPFS_CACHE_BLOCKS > 0
+  for (ret = 0; ret < CONFIG_ZIPFS_CACHE_BLOCKS; ret++)
+    {
+      zi->blocks[ret].blkno = -1;
+    }
+#  endif
+
+  if (zi->stored)
+    {
+      return zi;
+    }
+
+  /* Raw deflate data: minizip has already parsed the local header */
+
+  zi->window = fs_heap_malloc(ZIPFS_WINSIZE);
+  if (zi->window == NULL)
+    {
+      goto err_with_file;
+    }
+
+  if (inflateInit2(&zi->strm, -MAX_WBITS) != Z_OK)
+    {
+      fs_heap_free(zi->window);
+      goto err_with_file;
+    }
+
+  return zi;
+
+err_with_file:
+  file_close(&zi->zfile);
+  fs_heap_free(zi);
+  return NULL;
+}
+#endif
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -286,6 +794,9 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
   if (ret == OK)
     {
       fp->seekbuf = NULL;
+#if CONFIG_ZIPFS_INDEX_SPAN > 0
+      fp->zi = zipfs_inflate_open(fs, fp->uf);
+#endif
       strcpy(fp->relpath, relpath);
       filep->f_priv = fp;
     }
@@ -307,6 +818,13 @@ static int zipfs_close(FAR struct file *filep)
   FAR struct zipfs_file_s *fp = filep->f_priv;
   int ret;
 
+#if CONFIG_ZIPFS_INDEX_SPAN > 0
+  if (fp->zi != NULL)
+    {
+      zipfs_inflate_free(fp->zi);
+    }
+#endif
+
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
@@ -321,7 +839,18 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+#if CONFIG_ZIPFS_INDEX_SPAN > 0
+  if (fp->zi != NULL)
+    {
+      ret = zipfs_inflate_read(fp->zi, filep->f_pos, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer,
+                                                    buflen));
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -402,7 +931,26 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
     {
       goto err_with_lock;
     }
-  else if (filep->f_pos > offset)
+
+#if CONFIG_ZIPFS_INDEX_SPAN > 0
+  /* The next read positions the member itself */
+
+  if (fp->zi != NULL)
+    {
+      if (offset < 0)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          filep->f_pos = MIN(offset, fp->zi->size);
+        }
+
+      goto err_with_lock;
+    }
+#endif
+
+  if (filep->f_pos > offset)
     {
       ret = zipfs_convert_result(unzClose(fp->uf));
       if (ret < 0)
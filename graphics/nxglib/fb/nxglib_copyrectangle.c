@@ -69,6 +69,16 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   int lnlen;
 #endif
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel != NULL && accel->copyrectangle != NULL &&
+      accel->copyrectangle(pinfo, dest, src, origin, srcstride) >= 0)
+    {
+      return;
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   deststride = pinfo->stride;
@@ -73,6 +73,16 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
   int lnlen;
 #endif
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel != NULL && accel->fillrectangle != NULL &&
+      accel->fillrectangle(pinfo, rect, color) >= 0)
+    {
+      return;
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   stride = pinfo->stride;
@@ -119,6 +119,16 @@ void NXGL_FUNCNAME(nxgl_moverectangle, NXGLIB_SUFFIX)
   uint8_t tailmask;
 #endif
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel != NULL && accel->moverectangle != NULL &&
+      accel->moverectangle(pinfo, rect, offset) >= 0)
+    {
+      return;
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   stride = pinfo->stride;
@@ -0,0 +1,53 @@
+/****************************************************************************
+ * graphics/nxglib/nxglib_accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/nx/nxglib.h>
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+FAR const struct nxgl_accel_s *g_nxgl_accel;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_accel_register
+ *
+ * Description:
+ *   Register (or, with NULL, remove) the 2D accelerator used by the
+ *   framebuffer rasterizers.
+ *
+ ****************************************************************************/
+
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel)
+{
+  g_nxgl_accel = accel;
+}
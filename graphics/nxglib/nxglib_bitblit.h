@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -173,27 +174,58 @@
 #endif /* CONFIG_NX_ANTIALIASING */
 #else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
 
+#if NXGLIB_BITSPERPIXEL == 16
+
+/* Fill 16-bit runs two pixels per word store once the pointer is word
+ * aligned; this halves the number of bus writes for the common RGB565
+ * case.
+ */
+
 #  define NXGL_MEMSET(dest,value,width) \
    { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
+     FAR uint16_t *_ptr  = (FAR uint16_t*)(dest); \
+     FAR uint32_t *_wptr; \
+     uint32_t      _wide = (uint32_t)(uint16_t)(value) * 0x00010001u; \
+     nxgl_coord_t  _npix = (width); \
+     if (((uintptr_t)_ptr & 2) != 0 && _npix > 0) \
        { \
          *_ptr++ = (value); \
+         _npix--; \
+       } \
+     _wptr = (FAR uint32_t*)_ptr; \
+     while (_npix >= 2) \
+       { \
+         *_wptr++ = _wide; \
+         _npix   -= 2; \
+       } \
+     if (_npix > 0) \
+       { \
+         *(FAR uint16_t*)_wptr = (value); \
        } \
    }
 
-#  define NXGL_MEMCPY(dest,src,width) \
+#else
+
+#  define NXGL_MEMSET(dest,value,width) \
    { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
+     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
+     nxgl_coord_t     _npix = (width); \
      while (_npix--) \
        { \
-         *_dptr++ = *_sptr++; \
+         *_ptr++ = (value); \
        } \
    }
 
+#endif
+
+/* Whole pixels can be copied with the C library, which is usually tuned
+ * for the target (word or vector moves).  memmove() also keeps in-row
+ * moves of overlapping areas correct.
+ */
+
+#  define NXGL_MEMCPY(dest,src,width) \
+   memmove((dest), (src), (size_t)(width) * sizeof(NXGL_PIXEL_T))
+
 #ifdef CONFIG_NX_ANTIALIASING
 
 #  define NXGL_BLEND(dest,color1,frac) \
@@ -57,6 +57,8 @@
 
 #include <sys/types.h>
 #include <sys/queue.h>
+#include <semaphore.h>
+#include <stdbool.h>
 
 /* Some initial values */
 
@@ -213,6 +215,7 @@ struct cryptop
 #define CRYPTO_F_DONE 0x0010    /* request completed */
 #define CRYPTO_F_CBIMM 0x0020   /* Do callback immediately */
 #define CRYPTO_F_CANCEL 0x0040  /* Cancel the current crypto operation */
+#define CRYPTO_F_ASYNC 0x0080   /* Queued by crypto_dispatch() */
 
   FAR void *crp_buf;               /* Data to be processed */
   FAR void *crp_opaque;            /* Opaque pointer, passed along */
@@ -224,6 +227,11 @@ struct cryptop
   caddr_t crp_dst;
   caddr_t crp_iv;
   caddr_t crp_aad;
+
+  TAILQ_ENTRY(cryptop) crp_next;   /* Link in the dispatch queues */
+  sem_t crp_sem;                   /* Completion of a synchronous request
+                                    * the driver finishes later
+                                    */
 };
 
 #define CRYPTO_BUF_IOV 0x1
@@ -387,6 +395,37 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCCRYPTM              107
+#define CIOCKEYM                108
+
+/* Several CIOCCRYPT or CIOCKEY requests in one call.  The CIOCCRYPTM
+ * requests are all handed to the drivers before the first one is waited
+ * for, so that a hardware engine with a queue processes them back to
+ * back.  'status' is optional and receives the result of each request.
+ */
+
+struct crypt_mop
+{
+  uint32_t count;
+  FAR struct crypt_op *reqs;
+  FAR int *status;
+};
+
+struct crypt_kmop
+{
+  uint32_t count;
+  FAR struct crypt_kop *reqs;
+};
+
+/* A cipher session for kernel users, see crypto_cipher_init() */
+
+struct crypto_cipher_s
+{
+  uint64_t sid;                    /* Session of the chosen driver */
+  uint32_t alg;                    /* CRYPTO_AES_CBC, ... */
+  int klen;                        /* Key length in bits */
+  FAR uint8_t *key;                /* Copy of the key */
+};
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
@@ -399,12 +438,26 @@ int crypto_kregister(uint32_t, FAR int *,
 int crypto_unregister(uint32_t, int);
 int crypto_get_driverid(uint8_t);
 int crypto_invoke(FAR struct cryptop *);
+void crypto_done(FAR struct cryptop *);
+#ifdef CONFIG_CRYPTO_ASYNC
+int crypto_dispatch(FAR struct cryptop *);
+#endif
 int crypto_kinvoke(FAR struct cryptkop *);
 int crypto_getfeat(FAR int *);
 
 FAR struct cryptop *crypto_getreq(int);
 void crypto_freereq(FAR struct cryptop *);
 
+/* In-kernel cipher interface, e.g. for TLS record or storage encryption.
+ * The session prefers a hardware driver and falls back to software.
+ */
+
+int crypto_cipher_init(FAR struct crypto_cipher_s *, uint32_t,
+                       FAR const void *, size_t);
+int crypto_cipher_run(FAR struct crypto_cipher_s *, FAR const void *,
+                      FAR void *, size_t, FAR void *, bool);
+void crypto_cipher_free(FAR struct crypto_cipher_s *);
+
 #ifdef CONFIG_CRYPTO_CRYPTODEV_HARDWARE
 void hwcr_init(void);
 #endif
@@ -513,6 +513,18 @@ void park_transform(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
 void inv_park_transform(FAR phase_angle_f32_t *angle, FAR dq_frame_f32_t *dq,
                         FAR ab_frame_f32_t *ab);
 
+/* Batched transformation functions, n independent frames per call */
+
+void clarke_transform_n(FAR abc_frame_f32_t *abc, FAR ab_frame_f32_t *ab,
+                        size_t n);
+void inv_clarke_transform_n(FAR ab_frame_f32_t *ab,
+                            FAR abc_frame_f32_t *abc, size_t n);
+void park_transform_n(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
+                      FAR dq_frame_f32_t *dq, size_t n);
+void inv_park_transform_n(FAR phase_angle_f32_t *angle,
+                          FAR dq_frame_f32_t *dq, FAR ab_frame_f32_t *ab,
+                          size_t n);
+
 /* Phase angle related functions */
 
 void angle_norm(FAR float *angle, float per, float bottom, float top);
@@ -495,6 +495,19 @@ void park_transform_b16(FAR phase_angle_b16_t *angle, FAR ab_frame_b16_t *ab,
 void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
                             FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
 
+/* Batched transformation functions, n independent frames per call */
+
+void clarke_transform_n_b16(FAR abc_frame_b16_t *abc,
+                            FAR ab_frame_b16_t *ab, size_t n);
+void inv_clarke_transform_n_b16(FAR ab_frame_b16_t *ab,
+                                FAR abc_frame_b16_t *abc, size_t n);
+void park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                          FAR ab_frame_b16_t *ab, FAR dq_frame_b16_t *dq,
+                          size_t n);
+void inv_park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                              FAR dq_frame_b16_t *dq,
+                              FAR ab_frame_b16_t *ab, size_t n);
+
 /* Phase angle related functions */
 
 void angle_norm_b16(FAR b16_t *angle, b16_t per, b16_t bottom, b16_t top);
@@ -154,6 +154,17 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* Flags for splice(), tee() and vmsplice() */
+
+#define SPLICE_F_MOVE       0x0001 /* Move rather than copy (a hint only) */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on the pipe */
+#define SPLICE_F_MORE       0x0004 /* More data follows (a hint only) */
+#define SPLICE_F_GIFT       0x0008 /* Pages are gifted (a hint only) */
+
+/* fallocate() mode flags */
+
+#define FALLOC_FL_KEEP_SIZE 0x0001 /* Do not change the file size */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -214,6 +225,17 @@ int openat(int dirfd, FAR const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
+int fallocate(int fd, int mode, off_t offset, off_t len);
+
+/* Linux-like data movement to and from pipes */
+
+struct iovec; /* Forward reference */
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags);
 
 #undef EXTERN
 #if defined(__cplusplus)
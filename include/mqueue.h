@@ -36,6 +36,13 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard mq_attr.mq_flags bit: when set in the attributes passed to
+ * mq_open() with O_CREAT, reserve mq_maxmsg messages for the exclusive use
+ * of the new queue (requires CONFIG_MQ_QUEUE_POOL, ignored otherwise).
+ */
+
+#define MQ_PREALLOC (1 << 30)
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -58,4 +59,118 @@
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 
+/* Congestion control algorithm.  Argument: name, up to TCP_CA_NAME_MAX
+ * bytes
+ */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 5)
+
+/* Accept TCP Fast Open data in the SYN on a listening socket.
+ * Argument: int, non-zero to enable
+ */
+
+#define TCP_FASTOPEN   (__SO_PROTOCOL + 6)
+
+/* Connection statistics.  Argument: struct tcp_info, truncated to the
+ * length given
+ */
+
+#define TCP_INFO       (__SO_PROTOCOL + 7)
+
+#define TCP_CA_NAME_MAX 16
+
+/* Values of tcpi_state, as numbered by Linux */
+
+#define TCPI_ESTABLISHED  1
+#define TCPI_SYN_SENT     2
+#define TCPI_SYN_RECV     3
+#define TCPI_FIN_WAIT1    4
+#define TCPI_FIN_WAIT2    5
+#define TCPI_TIME_WAIT    6
+#define TCPI_CLOSE        7
+#define TCPI_CLOSE_WAIT   8
+#define TCPI_LAST_ACK     9
+#define TCPI_LISTEN       10
+#define TCPI_CLOSING      11
+
+/* Bits of tcpi_options */
+
+#define TCPI_OPT_TIMESTAMPS 1
+#define TCPI_OPT_SACK       2
+#define TCPI_OPT_WSCALE     4
+#define TCPI_OPT_ECN        8
+#define TCPI_OPT_SYN_DATA   32
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Argument of the TCP_INFO socket option.  The layout is the leading part
+ * of the Linux structure so that tools like ss can decode it.  Times are
+ * in microseconds and rates in bytes per second.  Fields the stack does
+ * not track read as zero.
+ */
+
+struct tcp_info
+{
+  uint8_t  tcpi_state;
+  uint8_t  tcpi_ca_state;
+  uint8_t  tcpi_retransmits;
+  uint8_t  tcpi_probes;
+  uint8_t  tcpi_backoff;
+  uint8_t  tcpi_options;
+  uint8_t  tcpi_snd_wscale : 4;
+  uint8_t  tcpi_rcv_wscale : 4;
+  uint8_t  tcpi_delivery_rate_app_limited : 1;
+  uint8_t  tcpi_fastopen_client_fail : 2;
+
+  uint32_t tcpi_rto;
+  uint32_t tcpi_ato;
+  uint32_t tcpi_snd_mss;
+  uint32_t tcpi_rcv_mss;
+
+  uint32_t tcpi_unacked;
+  uint32_t tcpi_sacked;
+  uint32_t tcpi_lost;
+  uint32_t tcpi_retrans;
+  uint32_t tcpi_fackets;
+
+  /* Times */
+
+  uint32_t tcpi_last_data_sent;
+  uint32_t tcpi_last_ack_sent;
+  uint32_t tcpi_last_data_recv;
+  uint32_t tcpi_last_ack_recv;
+
+  /* Metrics */
+
+  uint32_t tcpi_pmtu;
+  uint32_t tcpi_rcv_ssthresh;
+  uint32_t tcpi_rtt;
+  uint32_t tcpi_rttvar;
+  uint32_t tcpi_snd_ssthresh;
+  uint32_t tcpi_snd_cwnd;
+  uint32_t tcpi_advmss;
+  uint32_t tcpi_reordering;
+
+  uint32_t tcpi_rcv_rtt;
+  uint32_t tcpi_rcv_space;
+
+  uint32_t tcpi_total_retrans;
+
+  uint64_t tcpi_pacing_rate;
+  uint64_t tcpi_max_pacing_rate;
+  uint64_t tcpi_bytes_acked;
+  uint64_t tcpi_bytes_received;
+  uint32_t tcpi_segs_out;
+  uint32_t tcpi_segs_in;
+
+  uint32_t tcpi_notsent_bytes;
+  uint32_t tcpi_min_rtt;
+  uint32_t tcpi_data_segs_in;
+  uint32_t tcpi_data_segs_out;
+
+  uint64_t tcpi_delivery_rate;
+};
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -307,6 +307,7 @@
 #define IFLA_TXQLEN                      15
 #define IFLA_MAP                         16
 #define IFLA_WEIGHT                      17
+#define IFLA_STATS64                     23
 
 /* Definitions for struct rtmsg *********************************************/
 
@@ -30,6 +30,54 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Socket options at level SOL_PACKET */
+
+#define PACKET_RX_RING         5   /* Map a receive ring, struct tpacket_req3 */
+#define PACKET_STATISTICS      6   /* Read and reset struct tpacket_stats_v3 */
+#define PACKET_VERSION         10  /* Frame layout of the rings */
+#define PACKET_TX_RING         13  /* Map a transmit ring, struct tpacket_req3 */
+
+/* Values of the PACKET_VERSION option.  Only TPACKET_V3 rings are
+ * supported.
+ */
+
+#define TPACKET_V1             0
+#define TPACKET_V2             1
+#define TPACKET_V3             2
+
+/* Receive status of a block (block_status) or a frame (tp_status) */
+
+#define TP_STATUS_KERNEL       0         /* Owned by the kernel */
+#define TP_STATUS_USER         (1 << 0)  /* Owned by the application */
+#define TP_STATUS_COPY         (1 << 1)  /* Frame was truncated */
+#define TP_STATUS_LOSING       (1 << 2)  /* Frames were dropped before it */
+#define TP_STATUS_BLK_TMO      (1 << 5)  /* Block retired by the timeout */
+#define TP_STATUS_TS_SOFTWARE  (1 << 29) /* Software time stamp */
+
+/* Transmit status of a frame (tp_status) */
+
+#define TP_STATUS_AVAILABLE    0         /* Free for the application */
+#define TP_STATUS_SEND_REQUEST (1 << 0)  /* Filled, to be sent */
+#define TP_STATUS_SENDING      (1 << 1)  /* Being sent */
+#define TP_STATUS_WRONG_FORMAT (1 << 2)  /* Rejected, not sent */
+
+/* Frame headers and frames are aligned to TPACKET_ALIGNMENT bytes.  A
+ * received frame holds a struct tpacket3_hdr, a struct sockaddr_ll and
+ * then the link layer frame at tp_mac.  A frame to send holds a
+ * struct tpacket3_hdr and then the link layer frame at
+ * TPACKET_ALIGN(sizeof(struct tpacket3_hdr)).
+ */
+
+#define TPACKET_ALIGNMENT      16
+#define TPACKET_ALIGN(x)       (((x) + TPACKET_ALIGNMENT - 1) & \
+                                ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET3_HDRLEN        (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + \
+                                sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -45,4 +93,85 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* PACKET_RX_RING and PACKET_TX_RING request.  The ring consists of
+ * tp_block_nr blocks of tp_block_size bytes; transmit blocks are divided
+ * in frames of tp_frame_size bytes.  The receive ring comes first in the
+ * memory mapped from the socket, then the transmit ring.
+ */
+
+struct tpacket_req3
+{
+  uint32_t tp_block_size;       /* Size of one block */
+  uint32_t tp_block_nr;         /* Number of blocks, 0 removes the ring */
+  uint32_t tp_frame_size;       /* Size of one frame */
+  uint32_t tp_frame_nr;         /* Total number of frames */
+  uint32_t tp_retire_blk_tov;   /* Receive block timeout in milliseconds */
+  uint32_t tp_sizeof_priv;      /* Private area of each receive block */
+  uint32_t tp_feature_req_word; /* Unused */
+};
+
+/* PACKET_STATISTICS value */
+
+struct tpacket_stats_v3
+{
+  uint32_t tp_packets;          /* Frames received */
+  uint32_t tp_drops;            /* Frames dropped, the ring was full */
+  uint32_t tp_freeze_q_cnt;     /* Unused */
+};
+
+/* Header of one frame in a ring */
+
+struct tpacket_hdr_variant1
+{
+  uint32_t tp_rxhash;
+  uint32_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint16_t tp_padding;
+};
+
+struct tpacket3_hdr
+{
+  uint32_t tp_next_offset;      /* Offset of the next frame in the block */
+  uint32_t tp_sec;              /* Time stamp */
+  uint32_t tp_nsec;
+  uint32_t tp_snaplen;          /* Bytes stored at tp_mac */
+  uint32_t tp_len;              /* Length of the frame on the wire */
+  uint32_t tp_status;           /* TP_STATUS_* */
+  uint16_t tp_mac;              /* Offset of the link layer frame */
+  uint16_t tp_net;              /* Offset of the network header */
+  struct tpacket_hdr_variant1 hv1;
+  uint8_t  tp_padding[8];
+};
+
+/* Header of one receive block */
+
+struct tpacket_bd_ts
+{
+  unsigned int ts_sec;
+  unsigned int ts_nsec;
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t block_status;        /* TP_STATUS_KERNEL or TP_STATUS_USER */
+  uint32_t num_pkts;            /* Number of frames in the block */
+  uint32_t offset_to_first_pkt; /* Offset of the first frame */
+  uint32_t blk_len;             /* Bytes used in the block */
+  uint64_t seq_num;             /* Sequence number of the block */
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t version;
+  uint32_t offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -265,6 +265,9 @@ struct addrenv_s
   struct arch_addrenv_s addrenv; /* The address environment page directory  */
   struct work_s         work;    /* Worker to free address environment      */
   int                   refs;    /* Users of address environment            */
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+  uint64_t              asid;    /* ASID generation | ASID                  */
+#endif
 };
 
 typedef struct addrenv_s addrenv_t;
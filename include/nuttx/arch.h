@@ -1243,6 +1243,46 @@ ssize_t up_addrenv_heapsize(FAR const arch_addrenv_t *addrenv);
 int up_addrenv_select(FAR const arch_addrenv_t *addrenv);
 #endif
 
+/****************************************************************************
+ * Name: up_addrenv_asid_select
+ *
+ * Description:
+ *   Like up_addrenv_select(), but the user mappings are tagged with 'asid'
+ *   so the TLB does not have to be flushed.  The caller guarantees that no
+ *   other address environment has used 'asid' since this CPU last flushed
+ *   its TLB, otherwise it sets 'flush' and the whole local TLB must be
+ *   invalidated.  ASID 0 is reserved for up_addrenv_select().
+ *
+ * Input Parameters:
+ *   addrenv - The representation of the task address environment previously
+ *     returned by up_addrenv_create.
+ *   asid    - The address space identifier, 1..(1 << up_addrenv_asid_bits())
+ *     - 1.
+ *   flush   - Invalidate the local TLB before using 'asid'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+int up_addrenv_asid_select(FAR const arch_addrenv_t *addrenv,
+                           uint16_t asid, bool flush);
+#endif
+
+/****************************************************************************
+ * Name: up_addrenv_asid_bits
+ *
+ * Description:
+ *   Return the number of ASID bits implemented by the hardware, zero if
+ *   ASIDs are not supported.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+int up_addrenv_asid_bits(void);
+#endif
+
 /****************************************************************************
  * Name: up_addrenv_coherent
  *
@@ -1641,6 +1681,59 @@ int up_addrenv_kmap_pages(FAR void **pages, unsigned int npages,
 int up_addrenv_kunmap_pages(uintptr_t vaddr, unsigned int npages);
 #endif
 
+/****************************************************************************
+ * Name: up_addrenv_map_pages
+ *
+ * Description:
+ *   Map physical pages into a continuous user virtual memory block of an
+ *   address environment, which need not be the current one.  The pages
+ *   are not owned by the address environment: they must be unmapped with
+ *   up_addrenv_unmap_pages() before up_addrenv_destroy() is called.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to map the pages into.
+ *   pages - A pointer to the first element in a array of physical address,
+ *     each corresponding to one page of memory.
+ *   npages - The number of pages in the list of physical pages to be mapped.
+ *   vaddr - The virtual address corresponding to the beginning of the
+ *     (continuous) virtual address region.
+ *   prot - Access right flags.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ARCH_ADDRENV) && defined(CONFIG_CLOCK_VDSO)
+int up_addrenv_map_pages(FAR arch_addrenv_t *addrenv, FAR uintptr_t *pages,
+                         unsigned int npages, uintptr_t vaddr, int prot);
+#endif
+
+/****************************************************************************
+ * Name: up_addrenv_unmap_pages
+ *
+ * Description:
+ *   Unmap a user virtual memory region previously mapped with
+ *   up_addrenv_map_pages().  The pages themselves are not released.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to unmap the pages from.
+ *   vaddr - The virtual address corresponding to the beginning of the
+ *     (continuous) virtual address region.
+ *   npages - The number of pages to be unmapped
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ARCH_ADDRENV) && defined(CONFIG_CLOCK_VDSO)
+int up_addrenv_unmap_pages(FAR arch_addrenv_t *addrenv, uintptr_t vaddr,
+                           unsigned int npages);
+#endif
+
 /****************************************************************************
  * Name: up_addrenv_pa_to_va
  *
@@ -117,6 +117,9 @@
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
 #define AUDIOIOC_GETPOSITION        _AUDIOIOC(21)
+#define AUDIOIOC_GETRING            _AUDIOIOC(22)
+#define AUDIOIOC_SYNCPOINTER        _AUDIOIOC(23)
+#define AUDIOIOC_SETPERIODWAKEUP    _AUDIOIOC(24)
 
 /* Audio Device Types *******************************************************/
 
@@ -362,6 +365,7 @@
 #define AUDIO_MSG_SLIENCE          11
 #define AUDIO_MSG_UNDERRUN         12
 #define AUDIO_MSG_IOERR            13
+#define AUDIO_MSG_PERIOD           14
 #define AUDIO_MSG_USER             64
 
 /* Audio Pipeline Buffer flags */
@@ -456,6 +460,32 @@ struct ap_buffer_info_s
   apb_samp_t  buffer_size;  /* Preferred size of the buffers */
 };
 
+/* Period ring shared with user space, see AUDIOIOC_GETRING.  The DMA runs
+ * cyclically over nperiods periods of period_bytes each.  mmap() on the
+ * audio device maps the same ring.
+ */
+
+struct audio_ring_s
+{
+  FAR void   *base;         /* User-accessible address of the ring */
+  apb_samp_t  period_bytes; /* Size of one period */
+  apb_samp_t  nperiods;     /* Number of periods in the ring */
+};
+
+/* Ring positions for AUDIOIOC_SYNCPOINTER.  Positions are running byte
+ * counts that wrap at 2^32; the ring offset is position % ring size.
+ * The caller passes in the bytes it has written (playback) or consumed
+ * (capture) and gets back the hardware position and the bytes available
+ * to it without overrunning the hardware.
+ */
+
+struct audio_pointer_s
+{
+  uint32_t    applptr;      /* In: application position */
+  uint32_t    hwptr;        /* Out: hardware position */
+  uint32_t    avail;        /* Out: bytes available to the application */
+};
+
 /* This structure describes an Audio Pipeline Buffer */
 
 struct ap_buffer_s
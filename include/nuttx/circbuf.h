@@ -24,7 +24,11 @@
 #define __INCLUDE_NUTTX_CIRCBUF_H
 
 /* Note about locking: There is no locking required while only one reader
- * and one writer is using the circular buffer.
+ * and one writer is using the circular buffer.  The writer publishes head
+ * with release semantics after copying the data and the reader publishes
+ * tail after consuming it, so an interrupt handler or another CPU may
+ * produce while a thread consumes (or vice versa) without a critical
+ * section.
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
  * only a need to lock the reader.
@@ -36,12 +40,19 @@
 
 #include <stdbool.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define CIRCBUF_INITIALIZER(base, size) { base, size, 0, 0, true }
+/* Index mask of a power-of-two sized buffer, zero for any other size */
+
+#define CIRCBUF_MASK(size) \
+  (((size) > 1 && ((size) & ((size) - 1)) == 0) ? (size) - 1 : 0)
+
+#define CIRCBUF_INITIALIZER(base, size) \
+  { base, size, 0, 0, true, CIRCBUF_MASK(size) }
 
 /****************************************************************************
  * Public Types
@@ -56,6 +67,7 @@ struct circbuf_s
   size_t    head;     /* The head of buffer space */
   size_t    tail;     /* The tail of buffer space */
   bool      external; /* The flag for external buffer */
+  size_t    mask;     /* size - 1 if size is a power of two, else 0 */
 };
 
 /****************************************************************************
@@ -411,6 +423,46 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize);
 
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize);
 
+/****************************************************************************
+ * Name: circbuf_write_prepare
+ *
+ * Description:
+ *   Get all free space of the circbuf as up to two spans, the second one
+ *   being the part wrapped to the start of the buffer.  Fill the spans in
+ *   place and publish the data with circbuf_writecommit().
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   iov   - Returns the free spans, iov[1].iov_len is zero if not wrapped.
+ *
+ * Returned Value:
+ *   The total number of bytes that can be written.
+ *
+ ****************************************************************************/
+
+size_t circbuf_write_prepare(FAR struct circbuf_s *circ,
+                             FAR struct iovec iov[2]);
+
+/****************************************************************************
+ * Name: circbuf_read_prepare
+ *
+ * Description:
+ *   Get all data of the circbuf as up to two spans, the second one being
+ *   the part wrapped to the start of the buffer.  Consume the spans in
+ *   place and release them with circbuf_readcommit().
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   iov   - Returns the data spans, iov[1].iov_len is zero if not wrapped.
+ *
+ * Returned Value:
+ *   The total number of bytes that can be read.
+ *
+ ****************************************************************************/
+
+size_t circbuf_read_prepare(FAR struct circbuf_s *circ,
+                            FAR struct iovec iov[2]);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
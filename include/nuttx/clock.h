@@ -826,6 +826,20 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp);
 
 void nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp);
 
+/****************************************************************************
+ * Name: nx_clock_gettime
+ *
+ * Description:
+ *   The system call behind the user space clock_gettime() when the clock
+ *   data page is enabled.  It serves the clocks that the page does not
+ *   provide and the calls made before the page becomes valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_VDSO
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
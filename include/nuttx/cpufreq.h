@@ -43,6 +43,11 @@
 #define CPUFREQ_ENTRY_INVALID ~0u
 #define CPUFREQ_TABLE_END     ~1u
 
+/* Flags of cpufreq_update_util() */
+
+#define CPUFREQ_UTIL_IDLE     (1 << 0)  /* The idle task was switched in */
+#define CPUFREQ_UTIL_RT       (1 << 1)  /* A realtime task was switched in */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -243,6 +248,19 @@ int cpufreq_qos_update_request(FAR struct cpufreq_qos *qos,
 
 int cpufreq_qos_remove_request(FAR struct cpufreq_qos *qos);
 
+/* cpufreq_update_util - Report a context switch to the schedutil governor
+ * cpu: the CPU that switched
+ * flags: CPUFREQ_UTIL_* describing the task switched in
+ *
+ * Called by the scheduler with interrupts disabled.  Updates the
+ * utilization of the CPU and requests a new frequency if needed, the
+ * change itself is performed later from the high priority work queue.
+ */
+
+#ifdef CONFIG_CPUFREQ_DEFAULT_GOV_SCHEDUTIL
+void cpufreq_update_util(int cpu, unsigned int flags);
+#endif
+
 /****************************************************************************
  * Name: cpufreq_table_count_valid_entries
  *
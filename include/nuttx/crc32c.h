@@ -0,0 +1,94 @@
+/****************************************************************************
+ * include/nuttx/crc32c.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CRC32C_H
+#define __INCLUDE_NUTTX_CRC32C_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CRC32C_CHECK is the CRC-32C of the string "123456789" without the null
+ * byte.
+ *
+ *   const uint8_t checkbuf[] =
+ *   {
+ *     '1', '2', '3', '4', '5', '6', '7', '8', '9'
+ *   };
+ *
+ *   assert(crc32c(checkbuf, sizeof(checkbuf)) == CRC32C_CHECK);
+ */
+
+/* CRC-32C (Castagnoli, iSCSI), reflected */
+
+#define CRC32C_POLY   ((uint32_t)0x82f63b78)
+#define CRC32C_INIT   ((uint32_t)0xffffffff)
+#define CRC32C_XOROUT ((uint32_t)0xffffffff)
+#define CRC32C_CHECK  ((uint32_t)0xe3069283)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: crc32cpart
+ *
+ * Description:
+ *   Continue CRC-32C calculation on a part of the buffer.  The value is
+ *   neither pre- nor post-inverted; start with CRC32C_INIT and xor the
+ *   final result with CRC32C_XOROUT.
+ *
+ ****************************************************************************/
+
+uint32_t crc32cpart(FAR const uint8_t *src, size_t len, uint32_t crc32val);
+
+/****************************************************************************
+ * Name: crc32c
+ *
+ * Description:
+ *   Return the CRC-32C of the contents of the 'src' buffer, length 'len'.
+ *
+ ****************************************************************************/
+
+uint32_t crc32c(FAR const uint8_t *src, size_t len);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_CRC32C_H */
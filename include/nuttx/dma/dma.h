@@ -31,6 +31,8 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <nuttx/queue.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -42,6 +44,13 @@
 #define DMA_DEV_TO_MEM          3
 #define DMA_DEV_TO_DEV          4
 
+/* Capabilities of a DMA controller registered with dma_register() */
+
+#define DMA_CAP_SLAVE           (1 << 0)  /* Memory <-> peripheral */
+#define DMA_CAP_MEMCPY          (1 << 1)  /* Memory -> memory */
+#define DMA_CAP_CYCLIC          (1 << 2)  /* Circular buffers */
+#define DMA_CAP_SG              (1 << 3)  /* Hardware scatter-gather */
+
 #ifdef CONFIG_DMA_LINK
 #  define DMA_BLOCK_MODE        0
 #  define DMA_SRC_LINK_MODE     1
@@ -194,6 +203,22 @@
 
 #define DMA_RESIDUAL(chan) (chan)->ops->residual(chan)
 
+/****************************************************************************
+ * Name: DMA_START_SG
+ *
+ * Description:
+ *   Start a scatter-gather transfer between the device register 'devaddr'
+ *   and a list of memory segments, in the direction selected by the last
+ *   DMA_CONFIG().  This method is optional; the DMA engine core falls back
+ *   to one DMA_START() per segment when it is NULL.
+ *
+ * Note: callback get called once, when the last segment is done.
+ *
+ ****************************************************************************/
+
+#define DMA_START_SG(chan, callback, arg, devaddr, sg, nsg) \
+    (chan)->ops->start_sg(chan, callback, arg, devaddr, sg, nsg)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -282,6 +307,14 @@ struct dma_link_config_s
 };
 #endif
 
+/* One memory segment of a scatter-gather transfer */
+
+struct dma_sg_s
+{
+  uintptr_t addr;
+  size_t len;
+};
+
 /* The DMA vtable */
 
 struct dma_ops_s
@@ -305,6 +338,10 @@ struct dma_ops_s
   CODE int (*pause)(FAR struct dma_chan_s *chan);
   CODE int (*resume)(FAR struct dma_chan_s *chan);
   CODE size_t (*residual)(FAR struct dma_chan_s *chan);
+  CODE int (*start_sg)(FAR struct dma_chan_s *chan,
+                       dma_callback_t callback, FAR void *arg,
+                       uintptr_t devaddr, FAR const struct dma_sg_s *sg,
+                       unsigned int nsg);
 };
 
 /* This structure only defines the initial fields of the structure
@@ -325,4 +362,165 @@ struct dma_dev_s
                         FAR struct dma_chan_s *chan);
 };
 
+#ifdef CONFIG_DMA_ENGINE
+
+/* A transfer prepared by dma_prep_*() and queued with dma_submit().  The
+ * storage belongs to the client and must stay valid until the callback
+ * has run.  Descriptors submitted to one channel are performed in order;
+ * the next one is started from the completion interrupt of the previous.
+ */
+
+struct dma_desc_s
+{
+  sq_entry_t node;                 /* Link in the channel queue */
+  uint8_t type;                    /* Kind of transfer, private */
+  uint8_t direction;               /* DMA_MEM_TO_DEV, ... */
+  uintptr_t devaddr;               /* Device register or memcpy dest */
+  struct dma_sg_s buf;             /* Memcpy source or cyclic buffer */
+  FAR const struct dma_sg_s *sg;   /* Scatter-gather list */
+  unsigned int nsg;                /* Number of entries in 'sg' */
+  unsigned int index;              /* Segment in flight */
+  size_t period;                   /* Cyclic period length */
+  ssize_t result;                  /* Bytes done or negated errno */
+  dma_callback_t callback;         /* Completion callback */
+  FAR void *arg;                   /* Argument of 'callback' */
+};
+
+/* A channel handed out by dma_request_chan() */
+
+struct dma_engine_s;
+
+#endif /* CONFIG_DMA_ENGINE */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA_ENGINE
+
+/****************************************************************************
+ * Name: dma_register
+ *
+ * Description:
+ *   Make a DMA controller available to dma_request_chan().  'memcpy_ident'
+ *   names the channel used by dma_memcpy() if 'caps' has DMA_CAP_MEMCPY.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSPC if the table is full.
+ *
+ ****************************************************************************/
+
+int dma_register(FAR struct dma_dev_s *dev, unsigned int caps,
+                 unsigned int memcpy_ident);
+
+/****************************************************************************
+ * Name: dma_request_chan
+ *
+ * Description:
+ *   Get channel 'ident' of the first registered controller that has all
+ *   of 'caps'.  Like DMA_GET_CHAN(), this waits while the channel is held
+ *   by someone else.
+ *
+ * Returned Value:
+ *   The channel, or NULL if no controller matches.
+ *
+ ****************************************************************************/
+
+FAR struct dma_engine_s *dma_request_chan(unsigned int caps,
+                                          unsigned int ident);
+
+/****************************************************************************
+ * Name: dma_release_chan
+ *
+ * Description:
+ *   Abort the queued descriptors and give the channel back.
+ *
+ ****************************************************************************/
+
+void dma_release_chan(FAR struct dma_engine_s *engine);
+
+/****************************************************************************
+ * Name: dma_engine_config
+ *
+ * Description:
+ *   Set the request lines, widths, etc. of a channel.  The direction is
+ *   taken from each descriptor.
+ *
+ ****************************************************************************/
+
+void dma_engine_config(FAR struct dma_engine_s *engine,
+                       FAR const struct dma_config_s *cfg);
+
+/****************************************************************************
+ * Name: dma_prep_slave_sg / dma_prep_memcpy / dma_prep_cyclic
+ *
+ * Description:
+ *   Fill in a descriptor.  For cyclic descriptors the callback runs after
+ *   every period until dma_terminate() is called; for the others it runs
+ *   once with the total length transferred or a negated errno.
+ *
+ ****************************************************************************/
+
+int dma_prep_slave_sg(FAR struct dma_desc_s *desc, unsigned int direction,
+                      uintptr_t devaddr, FAR const struct dma_sg_s *sg,
+                      unsigned int nsg, dma_callback_t callback,
+                      FAR void *arg);
+int dma_prep_memcpy(FAR struct dma_desc_s *desc, uintptr_t dst,
+                    uintptr_t src, size_t len, dma_callback_t callback,
+                    FAR void *arg);
+int dma_prep_cyclic(FAR struct dma_desc_s *desc, unsigned int direction,
+                    uintptr_t devaddr, uintptr_t buf, size_t len,
+                    size_t period, dma_callback_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: dma_submit
+ *
+ * Description:
+ *   Queue a prepared descriptor behind the ones already submitted to the
+ *   channel.  May be called from interrupt context, e.g. from the callback
+ *   of the previous descriptor.
+ *
+ ****************************************************************************/
+
+void dma_submit(FAR struct dma_engine_s *engine,
+                FAR struct dma_desc_s *desc);
+
+/****************************************************************************
+ * Name: dma_terminate
+ *
+ * Description:
+ *   Stop the channel.  The active and queued descriptors complete with
+ *   -ECANCELED.
+ *
+ ****************************************************************************/
+
+void dma_terminate(FAR struct dma_engine_s *engine);
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   memcpy() that hands large copies to the memcpy channel of a registered
+ *   controller and sleeps until it is done.  Falls back to the CPU for
+ *   small copies, in interrupt context, or when the DMA fails.
+ *
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len);
+
+#endif /* CONFIG_DMA_ENGINE */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_DMA_DMA_H */
@@ -40,6 +40,7 @@
 
 #define RDFLAG_WRENABLED       (1 << 0) /* Bit 0: 1=Can write to RAM disk */
 #define RDFLAG_FUNLINK         (1 << 1) /* Bit 1: 1=Free memory when unlinked */
+#define RDFLAG_SPARSE          (1 << 3) /* Bit 3: 1=Allocate memory on write */
 
 /* For internal use by the driver only */
 
@@ -49,6 +50,16 @@
  * Type Definitions
  ****************************************************************************/
 
+/* Returned by BIOC_SPARSEINFO */
+
+struct ramdisk_sparseinfo_s
+{
+  uint32_t pagesize;      /* Allocation unit of the backing memory */
+  uint32_t npages;        /* Pages covering the whole disk */
+  uint32_t nallocated;    /* Pages currently allocated */
+  uint32_t nzero;         /* Writes of zero pages not backed by memory */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -72,7 +83,9 @@ extern "C"
  *   nsectors:      Number of sectors on device
  *   sectize:       The size of one sector
  *   rdflags:       See RDFLAG_* definitions
- *   buffer:        RAM disk backup memory
+ *   buffer:        RAM disk backup memory.  NULL with RDFLAG_SPARSE, in
+ *                  which case memory is allocated in pages as the disk is
+ *                  written and freed again by BIOC_DISCARD.
  *
  * Returned Value:
  *   Zero on success; a negated errno value on failure.
@@ -0,0 +1,91 @@
+/****************************************************************************
+ * include/nuttx/drivers/zram.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_ZRAM_H
+#define __INCLUDE_NUTTX_DRIVERS_ZRAM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_ZRAM
+
+/****************************************************************************
+ * Type Definitions
+ ****************************************************************************/
+
+/* Returned by BIOC_ZRAMINFO */
+
+struct zram_info_s
+{
+  uint32_t pagesize;      /* Compression unit */
+  uint32_t npages;        /* Pages covering the whole disk */
+  uint32_t ncompressed;   /* Pages stored compressed */
+  uint32_t nraw;          /* Pages that did not compress, stored as is */
+  uint32_t nzero;         /* Writes of zero pages not backed by memory */
+  size_t   compbytes;     /* Bytes of compressed data stored */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: zram_register
+ *
+ * Description:
+ *   Register a compressed RAM disk as /dev/zramN.  The disk starts empty
+ *   and reads as zero.  Data is stored lzf-compressed in units of
+ *   CONFIG_ZRAM_PAGESIZE bytes; pages that only hold zeros are not backed
+ *   by memory and BIOC_DISCARD releases the memory of discarded pages.
+ *
+ * Input Parameters:
+ *   minor    - Selects suffix of device named /dev/zramN, N={0,1,2...}
+ *   nsectors - Number of sectors on device
+ *   sectsize - The size of one sector
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int zram_register(int minor, uint32_t nsectors, uint16_t sectsize);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_ZRAM */
+#endif /* __INCLUDE_NUTTX_DRIVERS_ZRAM_H */
@@ -0,0 +1,207 @@
+/****************************************************************************
+ * include/nuttx/fs/blkqueue.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BLKQUEUE_H
+#define __INCLUDE_NUTTX_FS_BLKQUEUE_H
+
+/* The block request queue sits in front of one block driver.  Requests
+ * are submitted asynchronously in the same form as the aio() method of
+ * the driver and kept in sector order and in arrival order.  A deadline
+ * scheduler picks the next request: reads are preferred over writes, the
+ * elevator sweeps upwards through the sectors and a request waiting for
+ * longer than its deadline is served first.  Adjacent requests in the
+ * same direction are merged into one driver transfer.
+ *
+ * Drivers with an aio() method get up to CONFIG_FS_BLKQUEUE_DEPTH
+ * transfers in flight.  The others are called synchronously, one transfer
+ * at a time, from the low priority work queue or from the thread that
+ * unplugs the queue.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/list.h>
+
+#ifdef CONFIG_FS_BLKQUEUE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct blkqueue_s;
+
+/* One request.  The submitter fills in aio exactly as for the aio() method
+ * of a block driver: buf, nbytes (the number of sectors), offset (the
+ * first sector), write, complete and priv.  complete() is called from a
+ * work queue, or from the thread running the queue, with the number of
+ * sectors transferred or a negated errno value.  The request must stay
+ * valid until then.
+ */
+
+struct blkqueue_req_s
+{
+  struct fs_aio_s  aio;      /* The transfer */
+
+  /* The following fields are private to the queue */
+
+  struct list_node node;     /* In sector order, or in a dispatched batch */
+  struct list_node fifo;     /* In arrival order */
+  clock_t          deadline; /* Time by which it should be dispatched */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blkqueue_open
+ *
+ * Description:
+ *   Return the request queue of a block driver, creating it on first use.
+ *   Every user of the same driver shares one queue, so that all of their
+ *   requests can be merged and scheduled together.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode
+ *   queue - The location to return the queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkqueue_open(FAR struct inode *inode, FAR struct blkqueue_s **queue);
+
+/****************************************************************************
+ * Name: blkqueue_close
+ *
+ * Description:
+ *   Release a reference to a queue.  The queue is freed with the last
+ *   reference.  All of the requests submitted by the caller must have
+ *   completed.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by blkqueue_open()
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void blkqueue_close(FAR struct blkqueue_s *queue);
+
+/****************************************************************************
+ * Name: blkqueue_submit
+ *
+ * Description:
+ *   Add a request to the queue.  Unless the queue is plugged the transfer
+ *   is started as soon as the driver has room for it.
+ *
+ * Input Parameters:
+ *   queue - The queue
+ *   req   - The request to add
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued, in which case complete() will be
+ *   called; a negated errno value otherwise.
+ *
+ ****************************************************************************/
+
+int blkqueue_submit(FAR struct blkqueue_s *queue,
+                    FAR struct blkqueue_req_s *req);
+
+/****************************************************************************
+ * Name: blkqueue_plug
+ *
+ * Description:
+ *   Hold back the dispatch of new requests, so that a burst of requests
+ *   can be merged and sorted before any of them is started.  Plugs nest.
+ *
+ * Input Parameters:
+ *   queue - The queue
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void blkqueue_plug(FAR struct blkqueue_s *queue);
+
+/****************************************************************************
+ * Name: blkqueue_unplug
+ *
+ * Description:
+ *   Remove a plug and start the held back requests.  For a driver without
+ *   an aio() method, the transfers then run synchronously in the calling
+ *   thread until the queue is empty.
+ *
+ * Input Parameters:
+ *   queue - The queue
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void blkqueue_unplug(FAR struct blkqueue_s *queue);
+
+/****************************************************************************
+ * Name: blkqueue_read and blkqueue_write
+ *
+ * Description:
+ *   Transfer sectors through the queue and wait for the result.  These
+ *   have the same semantics as the read() and write() methods of the block
+ *   driver.
+ *
+ ****************************************************************************/
+
+ssize_t blkqueue_read(FAR struct blkqueue_s *queue,
+                      FAR unsigned char *buffer, blkcnt_t start,
+                      unsigned int nsectors);
+ssize_t blkqueue_write(FAR struct blkqueue_s *queue,
+                       FAR const unsigned char *buffer, blkcnt_t start,
+                       unsigned int nsectors);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FS_BLKQUEUE */
+#endif /* __INCLUDE_NUTTX_FS_BLKQUEUE_H */
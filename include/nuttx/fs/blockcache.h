@@ -0,0 +1,216 @@
+/****************************************************************************
+ * include/nuttx/fs/blockcache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BLOCKCACHE_H
+#define __INCLUDE_NUTTX_FS_BLOCKCACHE_H
+
+/* The block cache is a pool of pages, each one holding a run of
+ * consecutive sectors of a block driver, shared by all of the file systems
+ * that opt in by calling blockcache_read() and blockcache_write() instead
+ * of the read() and write() methods of the block driver.  Pages are looked
+ * up by (block driver inode, page index) and evicted with a simple 2Q
+ * policy, so that a long sequential scan cannot push the frequently used
+ * metadata pages out of the cache.
+ *
+ * A miss reads the whole page, which doubles as read-ahead for sequential
+ * access.  Requests spanning several pages bypass the cache.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_BLOCKCACHE
+#  define blockcache_read(i, b, s, n, z)  ((i)->u.i_bops->read(i, b, s, n))
+#  define blockcache_write(i, b, s, n, z) ((i)->u.i_bops->write(i, b, s, n))
+#  define blockcache_flush(i)             (0)
+#  define blockcache_invalidate(i)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/* Cache statistics, as reported in /proc/fs/blockcache.  The ratio of
+ * drvsectors to reqsectors is the read amplification: values above one
+ * mean that whole-page fills fetch sectors that are never asked for.
+ */
+
+struct blockcache_stats_s
+{
+  size_t   npages;     /* Pages currently allocated */
+  uint32_t hits;       /* Page sized reads served from the cache */
+  uint32_t misses;     /* Page sized reads that went to the driver */
+  uint32_t bypasses;   /* Reads of more than a page, never cached */
+  uint32_t writebacks; /* Dirty pages written back to a driver */
+  uint64_t reqsectors; /* Sectors requested by the file systems */
+  uint64_t drvsectors; /* Sectors read from the block drivers */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blockcache_read
+ *
+ * Description:
+ *   Read sectors from a block driver through the block cache.
+ *
+ * Input Parameters:
+ *   inode      - The block driver inode
+ *   buffer     - The buffer that receives the data
+ *   start      - The first sector to read
+ *   nsectors   - The number of sectors to read
+ *   sectorsize - The sector size of the block driver in bytes
+ *
+ * Returned Value:
+ *   The number of sectors read on success; a negated errno value on
+ *   failure.  This is the same as the read() method of the block driver.
+ *
+ ****************************************************************************/
+
+ssize_t blockcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                        blkcnt_t start, unsigned int nsectors,
+                        size_t sectorsize);
+
+/****************************************************************************
+ * Name: blockcache_write
+ *
+ * Description:
+ *   Write sectors to a block driver through the block cache.  With
+ *   CONFIG_FS_BLOCKCACHE_WRITEBACK, writes to cached pages only update the
+ *   cache and are written to the driver later from the low priority work
+ *   queue, or by blockcache_flush().
+ *
+ * Input Parameters:
+ *   inode      - The block driver inode
+ *   buffer     - The data to write
+ *   start      - The first sector to write
+ *   nsectors   - The number of sectors to write
+ *   sectorsize - The sector size of the block driver in bytes
+ *
+ * Returned Value:
+ *   The number of sectors written on success; a negated errno value on
+ *   failure.  This is the same as the write() method of the block driver.
+ *
+ ****************************************************************************/
+
+ssize_t blockcache_write(FAR struct inode *inode,
+                         FAR const unsigned char *buffer, blkcnt_t start,
+                         unsigned int nsectors, size_t sectorsize);
+
+/****************************************************************************
+ * Name: blockcache_flush
+ *
+ * Description:
+ *   Write all of the dirty pages of a block driver back to it.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode, or NULL to flush every driver
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if any write failed.
+ *
+ ****************************************************************************/
+
+int blockcache_flush(FAR struct inode *inode);
+
+/****************************************************************************
+ * Name: blockcache_invalidate
+ *
+ * Description:
+ *   Drop all of the cached pages of a block driver, discarding any dirty
+ *   data.  This must be called when the file system is unbound from the
+ *   driver, after blockcache_flush(), or when the media has changed.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void blockcache_invalidate(FAR struct inode *inode);
+
+/****************************************************************************
+ * Name: blockcache_getstats
+ *
+ * Description:
+ *   Return a snapshot of the cache statistics.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void blockcache_getstats(FAR struct blockcache_stats_s *stats);
+
+/****************************************************************************
+ * Name: blockcache_resetstats
+ *
+ * Description:
+ *   Clear the cache statistics.  The number of allocated pages is not
+ *   affected.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void blockcache_resetstats(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FS_BLOCKCACHE */
+#endif /* __INCLUDE_NUTTX_FS_BLOCKCACHE_H */
@@ -103,10 +103,11 @@
 
 /* Stream flags for the fs_flags field of in struct file_struct */
 
-#define __FS_FLAG_EOF   (1 << 0) /* EOF detected by a read operation */
-#define __FS_FLAG_ERROR (1 << 1) /* Error detected by any operation */
-#define __FS_FLAG_LBF   (1 << 2) /* Line buffered */
-#define __FS_FLAG_UBF   (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_EOF      (1 << 0) /* EOF detected by a read operation */
+#define __FS_FLAG_ERROR    (1 << 1) /* Error detected by any operation */
+#define __FS_FLAG_LBF      (1 << 2) /* Line buffered */
+#define __FS_FLAG_UBF      (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_BYCALLER (1 << 4) /* __fsetlocking(FSETLOCKING_BYCALLER) */
 
 /* Inode i_flags values:
  *
@@ -211,6 +212,31 @@ struct fs_dirent_s
   FAR char *fd_path;
 };
 
+/* This structure describes one asynchronous transfer handed to the aio
+ * method of a driver, a file system or a block driver.  The method returns
+ * OK once the transfer has been started and 'complete' is then called
+ * exactly once, possibly from interrupt level, with the number of bytes
+ * transferred or a negated errno value.  For block drivers 'offset' and
+ * 'nbytes' are the start sector and the number of sectors, and the result
+ * is a sector count.  A method that cannot start a particular transfer
+ * returns a negated errno value without calling 'complete' and the caller
+ * falls back to a synchronous transfer.
+ */
+
+struct fs_aio_s;
+typedef CODE void (*fs_aio_complete_t)(FAR struct fs_aio_s *aio,
+                                       ssize_t result);
+
+struct fs_aio_s
+{
+  FAR void         *buf;      /* Transfer buffer */
+  size_t            nbytes;   /* Bytes (sectors) to transfer */
+  off_t             offset;   /* File offset (start sector) */
+  bool              write;    /* true: write; false: read */
+  fs_aio_complete_t complete; /* Called when the transfer finishes */
+  FAR void         *priv;     /* For use by the submitter */
+};
+
 /* This structure is provided by devices when they are registered with the
  * system.  It is used to call back to perform device specific operations.
  */
@@ -247,6 +273,7 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+  CODE int     (*aio)(FAR struct file *filep, FAR struct fs_aio_s *aio);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -274,6 +301,7 @@ struct block_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+  CODE int     (*aio)(FAR struct inode *inode, FAR struct fs_aio_s *aio);
 };
 
 /* This structure is provided by a filesystem to describe a mount point.
@@ -360,6 +388,10 @@ struct mountpt_operations
   CODE int     (*chstat)(FAR struct inode *mountpt, FAR const char *relpath,
                          FAR const struct stat *buf, int flags);
   CODE int     (*syncfs)(FAR struct inode *mountpt);
+
+  /* Asynchronous transfers */
+
+  CODE int     (*aio)(FAR struct file *filep, FAR struct fs_aio_s *aio);
 };
 #endif /* CONFIG_DISABLE_MOUNTPOINT */
 
@@ -460,11 +492,14 @@ struct file
 {
   int               f_oflags;   /* Open mode flags */
 #ifdef CONFIG_FS_REFCOUNT
-  int               f_refs;     /* Reference count */
+  atomic_int        f_refs;     /* Reference count */
 #endif
   off_t             f_pos;      /* File position */
   FAR struct inode *f_inode;    /* Driver or file system interface */
   FAR void         *f_priv;     /* Per file driver private data */
+#ifdef CONFIG_FS_READAHEAD
+  FAR struct file_readahead_s *f_ra; /* Sequential readahead state */
+#endif
 #ifdef CONFIG_FDSAN
   uint64_t          f_tag_fdsan; /* File owner fdsan tag, init to 0 */
 #endif
@@ -480,6 +515,11 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              locked; /* Filelock state: false - unlocked, true - locked */
 #endif
+
+#ifdef CONFIG_FS_NOTIFY
+  unsigned int      f_notify_gen; /* Watch generation known to have no
+                                   * watcher for this file, 0 if unknown */
+#endif
 };
 
 /* This defines a two layer array of files indexed by the file descriptor.
@@ -944,6 +984,23 @@ int files_duplist(FAR struct filelist *plist, FAR struct filelist *clist,
                   FAR const posix_spawn_file_actions_t *actions,
                   bool cloexec);
 
+/****************************************************************************
+ * Name: files_dupactions
+ *
+ * Description:
+ *   Duplicate only the parent's descriptors that are the source of a dup2
+ *   file action, for POSIX_SPAWN_CLOEXEC_DEFAULT.  The cost depends on the
+ *   number of actions, not on the size of the parent's table.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int files_dupactions(FAR struct filelist *plist, FAR struct filelist *clist,
+                     FAR const posix_spawn_file_actions_t *actions);
+
 /****************************************************************************
  * Name: files_fget
  *
@@ -1516,6 +1573,18 @@ ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt);
 ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes,
                    off_t offset);
 
+/****************************************************************************
+ * Name: file_preadv
+ *
+ * Description:
+ *   Equivalent to the standard preadv function except that is accepts a
+ *   struct file instance instead of a file descriptor.
+ *
+ ****************************************************************************/
+
+ssize_t file_preadv(FAR struct file *filep, FAR const struct uio *uio,
+                    off_t offset);
+
 /****************************************************************************
  * Name: file_pwrite
  *
@@ -1529,6 +1598,36 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes,
 ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
                     size_t nbytes, off_t offset);
 
+/****************************************************************************
+ * Name: file_pwritev
+ *
+ * Description:
+ *   Equivalent to the standard pwritev function except that is accepts a
+ *   struct file instance instead of a file descriptor.
+ *
+ ****************************************************************************/
+
+ssize_t file_pwritev(FAR struct file *filep, FAR const struct uio *uio,
+                     off_t offset);
+
+/****************************************************************************
+ * Name: file_aio
+ *
+ * Description:
+ *   Start an asynchronous transfer on an open file if the driver or file
+ *   system behind it supports that.  The transfer takes place at
+ *   aio->offset and does not change the file position.
+ *
+ * Returned Value:
+ *   OK if the transfer was started; aio->complete() will be called when it
+ *   finishes.  -ENOSYS if the file does not support asynchronous
+ *   transfers, or another negated errno value if this transfer could not
+ *   be started.  aio->complete() is not called in either case.
+ *
+ ****************************************************************************/
+
+int file_aio(FAR struct file *filep, FAR struct fs_aio_s *aio);
+
 /****************************************************************************
  * Name: file_sendfile
  *
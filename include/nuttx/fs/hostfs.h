@@ -212,6 +212,8 @@ int           host_fchstat(int fd, const struct nuttx_stat_s *buf,
 int           host_ftruncate(int fd, nuttx_off_t length);
 void         *host_opendir(const char *name);
 int           host_readdir(void *dirp, struct nuttx_dirent_s *entry);
+int           host_readdir_batch(void *dirp, struct nuttx_dirent_s *entries,
+                                 struct nuttx_stat_s *bufs, int count);
 void          host_rewinddir(void *dirp);
 int           host_closedir(void *dirp);
 int           host_statfs(const char *path, struct nuttx_statfs_s *buf);
@@ -236,6 +238,8 @@ int           host_fchstat(int fd, const struct stat *buf, int flags);
 int           host_ftruncate(int fd, off_t length);
 void         *host_opendir(const char *name);
 int           host_readdir(void *dirp, struct dirent *entry);
+int           host_readdir_batch(void *dirp, struct dirent *entries,
+                                 struct stat *bufs, int count);
 void          host_rewinddir(void *dirp);
 int           host_closedir(void *dirp);
 int           host_statfs(const char *path, struct statfs *buf);
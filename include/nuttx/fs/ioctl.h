@@ -110,6 +110,7 @@
 #define _PCIBASE        (0x4100) /* Pci ioctl commands */
 #define _I3CBASE        (0x4200) /* I3C driver ioctl commands */
 #define _MSIOCBASE      (0x4300) /* Mouse ioctl commands */
+#define _DMABUFBASE     (0x4400) /* DMA buffer sharing ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -235,6 +236,16 @@
 #define FIOC_XIPBASE        _FIOC(0x0015) /* IN:  uinptr_t *
                                            * OUT: Current file xip base address
                                            */
+#define FIOC_FALLOCATE      _FIOC(0x0016) /* IN:  Pointer to struct fallocate_s
+                                           *      describing the range to
+                                           *      allocate
+                                           * OUT: None
+                                           */
+#define FIOC_NOTIFYLIMIT    _FIOC(0x0017) /* IN:  Maximum number of events
+                                           *      queued on an inotify
+                                           *      instance (unsigned long)
+                                           * OUT: None
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -349,6 +360,25 @@
                                            *      to return sector numbers.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_DISCARD    _BIOC(0x0011)     /* Tell the block device that a range
+                                           * of sectors no longer holds data.
+                                           * IN:  Pointer to read-only struct
+                                           *      blk_discard_s
+                                           * OUT: None.  The contents of the
+                                           *      range are undefined until
+                                           *      written again. */
+#define BIOC_SPARSEINFO _BIOC(0x0012)     /* Get the backing memory usage of
+                                           * a sparse RAM disk.
+                                           * IN:  Pointer to writable struct
+                                           *      ramdisk_sparseinfo_s
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
+#define BIOC_ZRAMINFO   _BIOC(0x0013)     /* Get the compression statistics
+                                           * of a zram disk.
+                                           * IN:  Pointer to writable struct
+                                           *      zram_info_s
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -755,6 +785,13 @@
 #define _FFIOCVALID(c) (_IOC_TYPE(c)==_FFIOCBASE)
 #define _FFIOC(nr)     _IOC(_FFIOCBASE,nr)
 
+/* DMA buffer sharing command definitions ***********************************/
+
+/* see nuttx/include/video/dmabuf.h */
+
+#define _DMABUFIOCVALID(c) (_IOC_TYPE(c)==_DMABUFBASE)
+#define _DMABUFIOC(nr)     _IOC(_DMABUFBASE,nr)
+
 /* Pinctrl driver command definitions ***************************************/
 
 /* see nuttx/include/pinctrl/pinctrl.h */
@@ -793,6 +830,23 @@ struct partition_info_s
   char      parent[NAME_MAX + 1];
 };
 
+/* Argument of BIOC_DISCARD */
+
+struct blk_discard_s
+{
+  blkcnt_t  start;        /* First sector of the range */
+  blkcnt_t  nsectors;     /* Number of sectors in the range */
+};
+
+/* Argument of FIOC_FALLOCATE, see fallocate() */
+
+struct fallocate_s
+{
+  int       mode;         /* FALLOC_FL_* flags */
+  off_t     offset;       /* First byte of the range */
+  off_t     len;          /* Length of the range in bytes */
+};
+
 struct pipe_peek_s
 {
   FAR void *buf;
@@ -28,6 +28,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/fs.h>
 
 /****************************************************************************
@@ -146,6 +149,34 @@ struct procfs_meminfo_entry_s
 #endif
 };
 
+/* One record of /proc/tasksnap.  A read returns a whole number of these,
+ * one per thread, so that monitoring agents need not parse the text files
+ * of /proc/<pid>.  Fields that are not available in the configuration are
+ * zero and the corresponding TASKSNAP_VALID_* bit is clear.
+ */
+
+#define TASKSNAP_VALID_CPULOAD   (1 << 0)  /* cputicks and cputotal */
+#define TASKSNAP_VALID_STACKUSED (1 << 1)  /* stackused */
+#define TASKSNAP_VALID_HEAP      (1 << 2)  /* heapused and heapblocks */
+
+struct procfs_tasksnap_s
+{
+  int32_t  pid;             /* Thread ID */
+  int32_t  group;           /* Process ID of the task group, -1 if none */
+  uint8_t  state;           /* enum tstate_e */
+  uint8_t  priority;        /* Current scheduling priority */
+  uint8_t  type;            /* TCB_FLAG_TTYPE_* >> TCB_FLAG_TTYPE_SHIFT */
+  uint8_t  cpu;             /* CPU last assigned to the thread */
+  uint32_t valid;           /* Bit set of TASKSNAP_VALID_* */
+  uint32_t cputicks;        /* CPU load ticks of the thread */
+  uint32_t cputotal;        /* CPU load ticks of all threads */
+  uint32_t stacksize;       /* Stack size in bytes */
+  uint32_t stackused;       /* Stack high water mark in bytes */
+  uint32_t heapused;        /* Heap bytes allocated by the thread */
+  uint32_t heapblocks;      /* Heap chunks allocated by the thread */
+  uint32_t nfds;            /* Open file descriptors of the task group */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -26,6 +26,19 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/uio.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The preadv2()/pwritev2() flags understood by the VFS */
+
+#define RWF_SUPPORTED (RWF_HIPRI | RWF_DSYNC | RWF_SYNC | RWF_NOWAIT)
+
+/* Values of uio_flags, they apply to a single operation only */
+
+#define UIO_NONBLOCK  (1 << 0) /* Do not block, as if O_NONBLOCK were set */
 
 /****************************************************************************
  * Public Type Definitions
@@ -45,6 +58,7 @@ struct uio
 {
   FAR const struct iovec *uio_iov;
   int uio_iovcnt;
+  int uio_flags;
 };
 
 /****************************************************************************
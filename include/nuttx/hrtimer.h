@@ -0,0 +1,191 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/compiler.h>
+#include <sys/tree.h>
+#include <stdint.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HRTIMER_ISACTIVE(h)   ((h)->func != NULL)
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* This is the form of the function that is called when the high
+ * resolution timer expires.
+ */
+
+typedef CODE void (*hrtimer_entry_t)(FAR void *arg);
+
+/* This is the internal representation of a high resolution timer.  Like
+ * struct wdog_s it is allocated by the caller and must not be modified
+ * while it is active.
+ */
+
+struct hrtimer_s
+{
+  RB_ENTRY(hrtimer_s) node;     /* Supports a red-black tree */
+  hrtimer_entry_t     func;     /* Function to execute when time expires */
+  FAR void           *arg;      /* Callback argument */
+  uint64_t            expired;  /* Absolute expiration time in nanoseconds */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current value of the time base used by the high resolution
+ *   timers: the time since power-up in nanoseconds, i.e. CLOCK_MONOTONIC.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The current time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   This function adds the high resolution timer to the active timer queue.
+ *   The specified function at 'func' will be called from the interrupt
+ *   level after the specified number of nanoseconds has elapsed.  Unlike
+ *   wd_start() the expiration is not rounded to a system tick: the alarm
+ *   is programmed for the exact expiration time.
+ *
+ *   High resolution timers execute only once.  To restart a timer,
+ *   including from its own callback, call hrtimer_start() again.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to start
+ *   delay   - Delay in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ * Assumptions:
+ *   The callback runs in the context of the timer interrupt handler and is
+ *   subject to all ISR restrictions.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer, uint64_t delay,
+                  hrtimer_entry_t func, FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_start_absolute
+ *
+ * Description:
+ *   The same as hrtimer_start() except that the expiration time is an
+ *   absolute time in nanoseconds in the time base of hrtimer_now().
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to start
+ *   expired - Absolute expiration time in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start_absolute(FAR struct hrtimer_s *hrtimer, uint64_t expired,
+                           hrtimer_entry_t func, FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a currently running high resolution timer.  High resolution
+ *   timers may be cancelled from the interrupt level.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success;  A negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *hrtimer);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time remaining before the high resolution timer expires.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *
+ * Returned Value:
+ *   The time in nanoseconds remaining until the timer expires.  Zero means
+ *   either that the timer is not active or that it has already expired.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(FAR struct hrtimer_s *hrtimer);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
@@ -33,6 +33,7 @@
 #include <stdint.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -270,6 +271,26 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* One queued transfer as handled by i2c_transfer_async().  The request and
+ * the messages belong to the caller and must stay valid until 'complete'
+ * has been called or the request has been cancelled.
+ */
+
+struct i2c_request_s
+{
+  sq_entry_t node;            /* Used internally */
+  FAR struct i2c_msg_s *msgv; /* Array of I2C messages for the transfer */
+  int msgc;                   /* Number of messages in the array */
+  uint8_t priority;           /* Higher values are served first */
+
+  /* Called from the work queue with the result of I2C_TRANSFER() */
+
+  CODE void (*complete)(FAR struct i2c_request_s *req, int result);
+  FAR void *arg;              /* For use by the caller */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +404,47 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue a transfer and return immediately.  Requests for the same bus
+ *   are performed from the low priority work queue in priority order (FIFO
+ *   among equal priorities).  Everything queued by the time the bus goes
+ *   idle is performed back-to-back in one pass, so several sensors that
+ *   queue their sample reads together are read in a single bus session
+ *   without a thread blocking on each of them.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to queue
+ *
+ * Returned Value:
+ *   0: queued, <0: A negated errno ('complete' will not be called)
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_transfer_cancel
+ *
+ * Description:
+ *   Remove a request that has not been started yet.
+ *
+ * Returned Value:
+ *   0: removed, -ENOENT: not queued (already performed or running)
+ *
+ ****************************************************************************/
+
+int i2c_transfer_cancel(FAR struct i2c_master_s *dev,
+                        FAR struct i2c_request_s *req);
+
+#endif /* CONFIG_I2C_ASYNC */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
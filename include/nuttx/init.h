@@ -31,6 +31,7 @@
 #include <nuttx/compiler.h>
 
 #include <stdint.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -47,6 +48,14 @@
 #define OSINIT_IDLELOOP()        (g_nx_initstate >= OSINIT_IDLELOOP)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Record the end of a boot step, see nx_bootprof_mark() */
+
+#ifdef CONFIG_SCHED_BOOTPROF
+#  define BOOTPROF_MARK(name)    nx_bootprof_mark(name)
+#else
+#  define BOOTPROF_MARK(name)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -75,6 +84,22 @@ enum nx_initstate_e
   OSINIT_PANIC     = 7   /* Fatal error happened. */
 };
 
+#ifdef CONFIG_SCHED_BOOTPROF
+/* One boot step: the step ended at 'time' (perf_gettime() units) */
+
+struct nx_bootprof_s
+{
+  FAR const char *name;  /* Name of the step, must be a string literal */
+  clock_t time;          /* perf_gettime() when the step finished */
+};
+#endif
+
+#ifdef CONFIG_SCHED_INIT_ASYNC
+/* An initialization step that may run concurrently with others */
+
+typedef CODE void (*nx_initfunc_t)(void);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -104,6 +129,65 @@ EXTERN volatile uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+#ifdef CONFIG_SCHED_BOOTPROF
+/****************************************************************************
+ * Name: nx_bootprof_mark
+ *
+ * Description:
+ *   Record that the boot step 'name' has just finished.  The time spent in
+ *   a step is the distance to the previous mark.  The mark is also emitted
+ *   as a scheduler note so that it shows up in the trace.  Marks beyond
+ *   CONFIG_SCHED_BOOTPROF_NENTRIES are dropped.
+ *
+ ****************************************************************************/
+
+void nx_bootprof_mark(FAR const char *name);
+
+/****************************************************************************
+ * Name: nx_bootprof_get
+ *
+ * Description:
+ *   Return the recorded boot steps in the order they finished.
+ *
+ * Returned Value:
+ *   The number of entries in the array returned through 'steps'.
+ *
+ ****************************************************************************/
+
+size_t nx_bootprof_get(FAR const struct nx_bootprof_s **steps);
+#endif
+
+#ifdef CONFIG_SCHED_INIT_ASYNC
+/****************************************************************************
+ * Name: nx_init_async
+ *
+ * Description:
+ *   Run an initialization step on the low priority work queue instead of
+ *   inline, so that independent drivers (e.g. from board_late_initialize)
+ *   probe concurrently.  The init task is not started before every queued
+ *   step has completed.  Steps must not depend on each other; a step that
+ *   needs another one done first has to be called inline after it.  If
+ *   no memory is available the step is run synchronously.
+ *
+ * Input Parameters:
+ *   func - The initialization function
+ *   name - Name of the step for the boot profile, a string literal
+ *
+ ****************************************************************************/
+
+void nx_init_async(nx_initfunc_t func, FAR const char *name);
+
+/****************************************************************************
+ * Name: nx_init_async_wait
+ *
+ * Description:
+ *   Wait until every step queued by nx_init_async() has completed.
+ *
+ ****************************************************************************/
+
+void nx_init_async_wait(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
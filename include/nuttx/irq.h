@@ -293,6 +293,48 @@ void leave_critical_section(irqstate_t flags) noinstrument_function;
 #  define leave_critical_section(f) up_irq_restore(f)
 #endif
 
+/****************************************************************************
+ * Name: enter_critical_section_local
+ *
+ * Description:
+ *   Disable interrupts on the current CPU only.  Unlike
+ *   enter_critical_section() this never takes the global IRQ spinlock, so
+ *   it does not serialize against other CPUs.  It may only be used to
+ *   protect state that is accessed exclusively by the executing CPU and its
+ *   own interrupt handlers, for example fields of the running TCB.
+ *
+ *   In the non-SMP case this is the same as enter_critical_section()
+ *   except that any critical section monitoring is bypassed.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to enter_critical_section_local();
+ *
+ ****************************************************************************/
+
+#define enter_critical_section_local() up_irq_save()
+
+/****************************************************************************
+ * Name: leave_critical_section_local
+ *
+ * Description:
+ *   Restore the interrupt state saved by enter_critical_section_local().
+ *
+ * Input Parameters:
+ *   flags - The architecture-specific value that represents the state of
+ *           the interrupts prior to the call to
+ *           enter_critical_section_local();
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#define leave_critical_section_local(f) up_irq_restore(f)
+
 /****************************************************************************
  * Name: restore_critical_section
  *
@@ -0,0 +1,275 @@
+/****************************************************************************
+ * include/nuttx/mm/cma.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_CMA_H
+#define __INCLUDE_NUTTX_MM_CMA_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/mm/map.h>
+
+#ifdef CONFIG_MM_CMA
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Cache attributes of a contiguous memory region.  Buffers carved from a
+ * cached region need cache maintenance around every DMA transfer; buffers
+ * from an uncached region (for example, one placed in a non-cacheable MPU
+ * region by the board) do not.
+ */
+
+#define CMA_CACHED         0x00  /* Region is accessed through the D-cache */
+#define CMA_UNCACHED       0x01  /* Region is not cacheable */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An opaque reservation made for one consumer (a driver instance) */
+
+struct cma_consumer_s;
+
+/* This describes one buffer allocated from a consumer reservation */
+
+struct cma_buffer_s
+{
+  FAR struct cma_consumer_s *owner;  /* Reservation the buffer belongs to */
+  FAR void                  *addr;   /* Start address of the buffer */
+  size_t                     size;   /* Size rounded up to granule size */
+  uint8_t                    flags;  /* Cache attributes, see CMA_* */
+};
+
+/* Usage information of the region or of a reservation */
+
+struct cma_info_s
+{
+  size_t total;                      /* Total size in bytes */
+  size_t used;                       /* Bytes currently allocated */
+  size_t largest;                    /* Largest contiguous free block */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cma_initialize
+ *
+ * Description:
+ *   Set up the contiguous memory region.  This is normally called once by
+ *   board or architecture logic early in the boot sequence, before the
+ *   memory becomes fragmented.  If start is NULL, the region is carved
+ *   from the kernel heap.
+ *
+ * Input Parameters:
+ *   start - Start of the region or NULL to allocate it from the kernel heap
+ *   size  - Size of the region in bytes
+ *   flags - Cache attributes of the region, see CMA_*
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int cma_initialize(FAR void *start, size_t size, uint8_t flags);
+
+/****************************************************************************
+ * Name: cma_reserve
+ *
+ * Description:
+ *   Reserve a contiguous part of the region for one consumer.  Buffers of
+ *   the consumer are then allocated from the reservation only, so that a
+ *   consumer can neither starve nor fragment the others.
+ *
+ * Input Parameters:
+ *   name - Name of the consumer, used for diagnostics only
+ *   size - Size of the reservation in bytes
+ *
+ * Returned Value:
+ *   A reservation handle on success; NULL if the region is not initialized
+ *   or has no contiguous free block of the requested size.
+ *
+ ****************************************************************************/
+
+FAR struct cma_consumer_s *cma_reserve(FAR const char *name, size_t size);
+
+/****************************************************************************
+ * Name: cma_unreserve
+ *
+ * Description:
+ *   Return a reservation to the region.  All buffers of the consumer must
+ *   have been freed.
+ *
+ * Input Parameters:
+ *   consumer - The handle previously returned by cma_reserve
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_unreserve(FAR struct cma_consumer_s *consumer);
+
+/****************************************************************************
+ * Name: cma_alloc
+ *
+ * Description:
+ *   Allocate a physically contiguous buffer from a reservation.  The buffer
+ *   is aligned to the region granule, i.e. to 1 << CONFIG_MM_CMA_LOG2GRAN.
+ *
+ * Input Parameters:
+ *   consumer - The handle previously returned by cma_reserve
+ *   size     - Size of the buffer in bytes
+ *   buf      - Location to return the buffer description
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int cma_alloc(FAR struct cma_consumer_s *consumer, size_t size,
+              FAR struct cma_buffer_s *buf);
+
+/****************************************************************************
+ * Name: cma_free
+ *
+ * Description:
+ *   Return a buffer to its reservation.  The description is cleared.
+ *
+ * Input Parameters:
+ *   buf - The buffer previously set up by cma_alloc
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_free(FAR struct cma_buffer_s *buf);
+
+/****************************************************************************
+ * Name: cma_sync_for_device
+ *
+ * Description:
+ *   Write back the CPU's view of part of a buffer before a device reads it
+ *   by DMA.  Nothing is done for uncached buffers.
+ *
+ * Input Parameters:
+ *   buf    - The buffer previously set up by cma_alloc
+ *   offset - Offset of the range in the buffer
+ *   len    - Length of the range in bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_sync_for_device(FAR const struct cma_buffer_s *buf,
+                         size_t offset, size_t len);
+
+/****************************************************************************
+ * Name: cma_sync_for_cpu
+ *
+ * Description:
+ *   Discard stale cache lines of part of a buffer after a device has
+ *   written it by DMA, so that the CPU sees the new data.  Nothing is done
+ *   for uncached buffers.
+ *
+ * Input Parameters:
+ *   buf    - The buffer previously set up by cma_alloc
+ *   offset - Offset of the range in the buffer
+ *   len    - Length of the range in bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_sync_for_cpu(FAR const struct cma_buffer_s *buf,
+                      size_t offset, size_t len);
+
+/****************************************************************************
+ * Name: cma_mmap
+ *
+ * Description:
+ *   Export part of a buffer to user space.  This is intended to be called
+ *   from the mmap method of a character driver that owns the buffer.
+ *
+ * Input Parameters:
+ *   buf - The buffer previously set up by cma_alloc
+ *   map - The mapping requested by the user; map->offset and map->length
+ *         are relative to the start of the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success and map->vaddr is set; a negated
+ *   errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int cma_mmap(FAR const struct cma_buffer_s *buf,
+             FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: cma_info
+ *
+ * Description:
+ *   Return usage information of a reservation or, if consumer is NULL, of
+ *   the whole region.
+ *
+ * Input Parameters:
+ *   consumer - The handle previously returned by cma_reserve or NULL
+ *   info     - Location to return the usage information
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int cma_info(FAR struct cma_consumer_s *consumer,
+             FAR struct cma_info_s *info);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_CMA */
+#endif /* __INCLUDE_NUTTX_MM_CMA_H */
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * include/nuttx/mm/heapprof.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_HEAPPROF_H
+#define __INCLUDE_NUTTX_MM_HEAPPROF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MM_HEAPPROF
+#  define heapprof_alloc(mem, size)
+#  define heapprof_free(mem)
+#else
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: heapprof_alloc
+ *
+ * Description:
+ *   Account an allocation to the sampling heap profiler.  On average one
+ *   allocation every CONFIG_MM_HEAPPROF_PERIOD bytes is sampled:  the
+ *   backtrace of the caller is recorded and aggregated with the other
+ *   samples of the same backtrace.
+ *
+ * Input Parameters:
+ *   mem  - The allocated memory
+ *   size - The requested size of the allocation
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void heapprof_alloc(FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: heapprof_free
+ *
+ * Description:
+ *   Tell the sampling heap profiler that memory is about to be freed.  If
+ *   the allocation was sampled, it is no longer accounted as in use.
+ *
+ * Input Parameters:
+ *   mem  - The memory to be freed, may be NULL
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void heapprof_free(FAR void *mem);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_HEAPPROF */
+#endif /* __INCLUDE_NUTTX_MM_HEAPPROF_H */
@@ -36,6 +36,10 @@
 #  include <nuttx/wqueue.h>
 #endif
 
+#ifdef CONFIG_IOB_EXTBUF
+#  include <nuttx/atomic.h>
+#endif
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
@@ -81,7 +85,7 @@
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -96,12 +100,49 @@
 #  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
 #endif
 
+/* The payload of the largest pre-allocated I/O buffer class */
+
+#ifdef CONFIG_IOB_LARGE
+#  define IOB_MAXBUFSIZE CONFIG_IOB_LARGE_BUFSIZE
+#else
+#  define IOB_MAXBUFSIZE CONFIG_IOB_BUFSIZE
+#endif
+
+/* True if the payload of the IOB is a reference to an external buffer.
+ * Such payload is owned by somebody else and must be treated as read-only.
+ */
+
+#ifdef CONFIG_IOB_EXTBUF
+#  define IOB_ISEXTBUF(p) ((p)->io_extbuf != NULL)
+#else
+#  define IOB_ISEXTBUF(p) false
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 typedef CODE void (*iob_free_cb_t)(FAR void *data);
 
+#ifdef CONFIG_IOB_EXTBUF
+/* Describes one reference counted external buffer.  The structure is
+ * allocated and initialized by the owner of the memory (normally embedded
+ * in a larger owner specific structure) and may be referenced by any number
+ * of IOBs.  The release callback is called once the last reference is
+ * dropped;  after that the owner may reuse or free the memory.
+ */
+
+struct iob_extbuf_s;
+typedef CODE void (*iob_extbuf_release_t)(FAR struct iob_extbuf_s *ext);
+
+struct iob_extbuf_s
+{
+  atomic_int           refs;     /* Number of references to the buffer */
+  iob_extbuf_release_t release;  /* Called when the last reference drops */
+  FAR void            *priv;     /* Owner private data */
+};
+#endif
+
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
@@ -130,6 +171,9 @@ struct iob_s
 #ifdef CONFIG_IOB_ALLOC
   iob_free_cb_t io_free;  /* Custom free callback */
   FAR uint8_t  *io_data;
+#  ifdef CONFIG_IOB_EXTBUF
+  FAR struct iob_extbuf_s *io_extbuf; /* Referenced external buffer */
+#  endif
 #else
   uint8_t       io_data[CONFIG_IOB_BUFSIZE];
 #endif
@@ -168,6 +212,9 @@ struct iob_stats_s
   int nfree;
   int nwait;
   int nthrottle;
+  int nminfree;      /* Lowest number of free IOBs seen */
+  uint32_t nwaited;  /* Allocations that had to wait for a free IOB */
+  uint32_t nfailed;  /* Allocations that failed or timed out */
 };
 
 /****************************************************************************
@@ -221,6 +268,37 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate the smallest pre-allocated I/O buffer that can hold 'size'
+ *   bytes of payload.  The buffer is taken from the small, the default or
+ *   the large class (see CONFIG_IOB_SMALL and CONFIG_IOB_LARGE), whichever
+ *   is the smallest to fit and still has a free buffer.  If none does,
+ *   this waits for a default I/O buffer, which may then be smaller than
+ *   'size':  the caller extends the chain as usual, e.g. by iob_copyin().
+ *
+ * Input Parameters:
+ *   size      - The payload size that the caller is going to store
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled);
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   The same as iob_alloc_size() but without waiting for a buffer to become
+ *   free.  Check IOB_BUFSIZE() of the result if the payload must be
+ *   contiguous.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -268,6 +346,76 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
                                       iob_free_cb_t free_cb);
 #endif
 
+#ifdef CONFIG_IOB_EXTBUF
+/****************************************************************************
+ * Name: iob_extbuf_init
+ *
+ * Description:
+ *   Initialize an external buffer descriptor.  The descriptor starts with
+ *   one reference that belongs to the caller and which must eventually be
+ *   dropped with iob_extbuf_put().
+ *
+ * Input Parameters:
+ *   ext     - The external buffer descriptor to initialize
+ *   release - Called when the last reference is dropped
+ *   priv    - Owner private data, saved in ext->priv
+ *
+ ****************************************************************************/
+
+void iob_extbuf_init(FAR struct iob_extbuf_s *ext,
+                     iob_extbuf_release_t release, FAR void *priv);
+
+/****************************************************************************
+ * Name: iob_extbuf_get
+ *
+ * Description:
+ *   Take an additional reference to an external buffer.
+ *
+ ****************************************************************************/
+
+void iob_extbuf_get(FAR struct iob_extbuf_s *ext);
+
+/****************************************************************************
+ * Name: iob_extbuf_put
+ *
+ * Description:
+ *   Drop a reference to an external buffer.  The release callback is
+ *   called, in the context of the caller, when the last reference is
+ *   dropped.  This may happen from any context that frees an IOB.
+ *
+ ****************************************************************************/
+
+void iob_extbuf_put(FAR struct iob_extbuf_s *ext);
+
+/****************************************************************************
+ * Name: iob_alloc_extbuf
+ *
+ * Description:
+ *   Allocate an I/O buffer from heap that refers to 'size' bytes of the
+ *   external buffer 'ext' beginning at 'data'.  Unlike iob_alloc_with_data()
+ *   the IOB is returned already holding 'size' bytes of payload and it
+ *   holds a reference to 'ext' until it is freed.  The payload is never
+ *   copied nor written to by the IOB logic.
+ *
+ *             +---------+  +-->+--------+
+ *             |   IOB   |  |   |  data  | (owned by ext)
+ *             | io_data |--+   +--------+
+ *             +---------+
+ *
+ * Input Parameters:
+ *   ext  - The external buffer that owns the payload
+ *   data - The beginning of the payload
+ *   size - The size of the payload
+ *
+ * Returned Value:
+ *   The new IOB on success; NULL if no memory is available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_extbuf(FAR struct iob_extbuf_s *ext,
+                                   FAR const void *data, uint16_t size);
+#endif
+
 /****************************************************************************
  * Name: iob_navail
  *
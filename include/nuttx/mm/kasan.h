@@ -45,6 +45,8 @@
 #  define kasan_start()
 #  define kasan_stop()
 #  define kasan_debugpoint(t,a,s) 0
+#  define kasan_check_range(addr, size, is_write)
+#  define kasan_region_enable(addr, enable) 0
 #  define kasan_init_early()
 #else
 
@@ -179,6 +181,48 @@ void kasan_start(void);
 
 void kasan_stop(void);
 
+/****************************************************************************
+ * Name: kasan_check_range
+ *
+ * Description:
+ *   Check that a memory range is accessible and report an error if any
+ *   part of it is poisoned.  Bulk operations such as memcpy() and memset()
+ *   are built without instrumentation and validate their whole source and
+ *   destination with a single call instead, which walks the shadow a word
+ *   or a cache line at a time rather than once per byte.
+ *
+ * Input Parameters:
+ *   addr     - range start address
+ *   size     - range size
+ *   is_write - true if the range is about to be written
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void kasan_check_range(FAR const void *addr, size_t size, bool is_write);
+
+/****************************************************************************
+ * Name: kasan_region_enable
+ *
+ * Description:
+ *   Enable or disable checking of the registered region (heap) that
+ *   contains addr.  The shadow of a disabled region is still maintained,
+ *   so checking can be enabled again at any time.  The initial state of
+ *   each region is taken from CONFIG_MM_KASAN_REGION_MASK.
+ *
+ * Input Parameters:
+ *   addr   - any address inside the region, e.g. the heap start
+ *   enable - true to check accesses to the region
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if no registered region contains addr.
+ *
+ ****************************************************************************/
+
+int kasan_region_enable(FAR const void *addr, bool enable);
+
 /****************************************************************************
  * Name: kasan_debugpoint
  *
@@ -0,0 +1,167 @@
+/****************************************************************************
+ * include/nuttx/mm/kmem_cache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_KMEM_CACHE_H
+#define __INCLUDE_NUTTX_MM_KMEM_CACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/mm/mempool.h>
+
+#ifdef CONFIG_MM_KMEM_CACHE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The constructor is called on every object handed out by the cache and
+ * the destructor on every object given back to it.  The first word of a
+ * free object links it into the pool, so an object does not keep its
+ * constructed state while it is free.
+ */
+
+typedef CODE void (*kmem_cache_ctor_t)(FAR void *obj);
+typedef CODE void (*kmem_cache_dtor_t)(FAR void *obj);
+
+/* This structure describes a cache of objects of one size */
+
+struct kmem_cache_s
+{
+  struct mempool_s  pool;      /* The pool the objects are carved from */
+  kmem_cache_ctor_t ctor;      /* Called on every allocated object */
+  kmem_cache_dtor_t dtor;      /* Called on every released object */
+  size_t            align;     /* The alignment of the expansion memory */
+  size_t            colorstep; /* The distance between two colors */
+  size_t            colormax;  /* The offset of the last color */
+  size_t            color;     /* The offset of the next expansion */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of the given size.  The objects are taken
+ *   from the kernel heap CONFIG_MM_KMEM_CACHE_EXPAND_SIZE bytes at a time
+ *   and are never returned to the heap before kmem_cache_destroy().
+ *
+ * Input Parameters:
+ *   name  - The name of the cache, reported in /proc/mempool.  The string
+ *           must stay valid while the cache exists.
+ *   size  - The size of an object.
+ *   align - The alignment of an object, zero for the natural alignment of
+ *           the heap.  Must be a power of two.
+ *   ctor  - The constructor, or NULL.
+ *   dtor  - The destructor, or NULL.
+ *
+ * Returned Value:
+ *   The new cache on success; NULL if there is not enough memory.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size, size_t align,
+                                           kmem_cache_ctor_t ctor,
+                                           kmem_cache_dtor_t dtor);
+
+/****************************************************************************
+ * Name: kmem_cache_destroy
+ *
+ * Description:
+ *   Destroy a cache and return all of its memory to the kernel heap.
+ *
+ * Input Parameters:
+ *   cache - The cache to destroy.
+ *
+ * Returned Value:
+ *   Zero on success; -EBUSY if objects of the cache are still allocated.
+ *
+ ****************************************************************************/
+
+int kmem_cache_destroy(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_alloc
+ *
+ * Description:
+ *   Allocate an object from the cache and run the constructor on it.
+ *
+ * Input Parameters:
+ *   cache - The cache to allocate from.
+ *
+ * Returned Value:
+ *   The object on success; NULL if there is not enough memory.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_zalloc
+ *
+ * Description:
+ *   The same as kmem_cache_alloc() except that the object is zeroed
+ *   before the constructor runs.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache);
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Run the destructor on an object and give it back to its cache.
+ *
+ * Input Parameters:
+ *   cache - The cache the object was allocated from.
+ *   obj   - The object to release.
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_MM_KMEM_CACHE */
+#endif /* __INCLUDE_NUTTX_MM_KMEM_CACHE_H */
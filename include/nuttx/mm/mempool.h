@@ -93,6 +93,20 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+/* This structure describes the free blocks one CPU keeps for a memory
+ * pool.  Only the owner CPU adds and removes blocks, the spinlock only
+ * serializes it against mempool_info() and mempool_deinit().
+ */
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+struct mempool_percpu_s
+{
+  spinlock_t      lock;   /* The protect lock to the free list */
+  FAR sq_entry_t *head;   /* The free blocks cached by the CPU */
+  size_t          count;  /* The number of blocks in the free list */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -115,6 +129,9 @@ struct mempool_s
   sq_queue_t equeue;  /* The expand block queue for normal mempool */
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  struct mempool_percpu_s percpu[CONFIG_SMP_NCPUS]; /* Per-CPU free lists */
+#endif
   sem_t      waitsem; /* The semaphore of waiter get free block */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
@@ -145,6 +162,20 @@ struct mempoolinfo_s
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
 };
 
+/* This describes the requests served by one block size class of a
+ * multiple mempool, see mempool_multiple_classinfo().  The internal
+ * fragmentation of the class is blocksize * nrequest - nbytes.
+ */
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+struct mempool_classinfo_s
+{
+  unsigned long blocksize; /* This is the block size of the class */
+  unsigned long nrequest;  /* This is the number of requests served */
+  unsigned long nbytes;    /* This is the sum of the requested sizes */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -527,6 +558,77 @@ struct mallinfo_task
 mempool_multiple_info_task(FAR struct mempool_multiple_s *mpool,
                            FAR const struct malltask *task);
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+
+/****************************************************************************
+ * Name: mempool_multiple_classinfo
+ *
+ * Description:
+ *   Get the request statistics of one block size class.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *   index - The index of the class, starting from the smallest block size.
+ *   info  - The location to return the statistics.
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if index is not a valid class.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_classinfo(FAR struct mempool_multiple_s *mpool,
+                               size_t index,
+                               FAR struct mempool_classinfo_s *info);
+
+/****************************************************************************
+ * Name: mempool_multiple_overflow
+ *
+ * Description:
+ *   Return the number of requests larger than the largest block size,
+ *   these are served by the caller, e.g. the heap, instead.
+ *
+ ****************************************************************************/
+
+unsigned long
+mempool_multiple_overflow(FAR struct mempool_multiple_s *mpool);
+
+/****************************************************************************
+ * Name: mempool_multiple_tune
+ *
+ * Description:
+ *   Compute, from the histogram of the requested sizes, the table of block
+ *   sizes that minimizes the internal fragmentation of the recorded
+ *   requests.  The largest block size of the table is kept so that the new
+ *   table serves the same requests.  The sizes are multiples of the
+ *   largest power of two that divides all current block sizes, hence keep
+ *   their alignment.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   poolsize - The location to return the increasing block sizes.
+ *   npools   - The maximum number of block sizes to return.
+ *
+ * Returned Value:
+ *   The number of block sizes returned in poolsize; a negated errno value
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t mempool_multiple_tune(FAR struct mempool_multiple_s *mpool,
+                              FAR size_t *poolsize, size_t npools);
+
+/****************************************************************************
+ * Name: mempool_multiple_resetstats
+ *
+ * Description:
+ *   Clear the request statistics of the multiple memory pool.
+ *
+ ****************************************************************************/
+
+void mempool_multiple_resetstats(FAR struct mempool_multiple_s *mpool);
+
+#endif /* CONFIG_MM_HEAP_MEMPOOL_STATS */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -176,6 +176,52 @@ struct mempool_init_s
   size_t            dict_expendsize;
 };
 
+/* This describes the statistics of the cache of one CPU, see
+ * mm_cacheinfo().
+ */
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+struct mm_cacheinfo_s
+{
+  unsigned long hits;    /* Allocations served from the cache */
+  unsigned long misses;  /* Cacheable allocations that missed the cache */
+  unsigned long flushes; /* Batches of chunks returned to the heap */
+  size_t        cached;  /* Bytes currently held by the cache */
+};
+#endif
+
+/* This describes the fragmentation of the free memory of a heap, see
+ * mm_fraginfo().  extents[n] counts the free chunks of at least
+ * 1 << (n + MM_FRAGINFO_MINSHIFT) bytes and, except for the last entry,
+ * less than twice that.
+ */
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+#define MM_FRAGINFO_MINSHIFT   5
+#define MM_FRAGINFO_NEXTENTS   16
+
+struct mm_fraginfo_s
+{
+  size_t        total;   /* Free bytes in the heap */
+  size_t        largest; /* Size of the largest free chunk */
+  unsigned int  index;   /* Fragmentation index in per mille */
+  unsigned long extents[MM_FRAGINFO_NEXTENTS];
+};
+#endif
+
+/* A handle of a movable allocation, see mm_malloc_movable() */
+
+#ifdef CONFIG_MM_HEAP_MOVABLE
+struct mm_movable_s;
+#endif
+
+/* The callback of mm_foreach_free(), [start, start + size) holds no live
+ * data and no heap metadata.
+ */
+
+typedef CODE void (*mm_free_handler_t)(FAR void *start, size_t size,
+                                       FAR void *arg);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -405,6 +451,30 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+struct mempool_multiple_s;
+FAR struct mempool_multiple_s *mm_mempool(FAR struct mm_heap_s *heap);
+#endif
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info);
+#endif
+
+/* Functions contained in mm_movable.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_MOVABLE
+FAR struct mm_movable_s *mm_malloc_movable(FAR struct mm_heap_s *heap,
+                                           size_t size);
+void mm_free_movable(FAR struct mm_heap_s *heap,
+                     FAR struct mm_movable_s *handle);
+FAR void *mm_movable_lock(FAR struct mm_heap_s *heap,
+                          FAR struct mm_movable_s *handle);
+void mm_movable_unlock(FAR struct mm_heap_s *heap,
+                       FAR struct mm_movable_s *handle);
+size_t mm_compact(FAR struct mm_heap_s *heap);
+#endif
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -414,6 +484,18 @@ struct mallinfo_task kmm_mallinfo_task(FAR const struct malltask *task);
 #  endif
 #endif
 
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+void mm_cacheinfo(FAR struct mm_heap_s *heap, int cpu,
+                  FAR struct mm_cacheinfo_s *info);
+#endif
+
+/* Functions contained in mm_foreach.c **************************************/
+
+void mm_foreach_free(FAR struct mm_heap_s *heap, mm_free_handler_t handler,
+                     FAR void *arg);
+
 /* Functions contained in mm_memdump.c **************************************/
 
 void mm_memdump(FAR struct mm_heap_s *heap,
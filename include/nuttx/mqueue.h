@@ -32,6 +32,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/signal.h>
 #include <nuttx/list.h>
+#include <nuttx/atomic.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -128,6 +129,22 @@ struct mqueue_inode_s
   struct sigwork_s ntwork;    /* Notification work */
 #endif
   FAR struct pollfd *fds[CONFIG_FS_MQUEUE_NPOLLWAITERS];
+#ifdef CONFIG_MQ_QUEUE_POOL
+  struct list_node msgpool;   /* Free messages reserved for this queue */
+  int16_t npool;              /* Number of messages reserved */
+  int16_t npoolused;          /* Number of reserved messages in use */
+  bool poolorphan;            /* Queue freed while messages were in use */
+#endif
+};
+
+/* Message allocation statistics, reported by /proc/mqueue */
+
+struct mqueue_stats_s
+{
+  atomic_int pool;            /* Messages taken from a per-queue pool */
+  atomic_int poolmiss;        /* Per-queue pool was empty */
+  atomic_int heap;            /* Messages allocated from the heap */
+  atomic_int fail;            /* Message allocations that failed */
 };
 
 /****************************************************************************
@@ -146,6 +163,10 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/* Message allocation statistics of all POSIX and System V queues */
+
+EXTERN struct mqueue_stats_s g_mqstats;
+
 struct tcb_s;         /* Forward reference */
 struct mq_attr;       /* Forward reference */
 struct timespec;      /* Forward reference */
@@ -412,6 +433,8 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq);
  *   attr   - The mq_maxmsg attribute is used at the time that the message
  *            queue is created to determine the maximum number of
  *            messages that may be placed in the message queue.
+ *            If MQ_PREALLOC is set in mq_flags, that many messages are
+ *            reserved for the queue as well.
  *   pmsgq  - This parameter is a address of a pointer
  *
  * Returned Value:
@@ -793,6 +816,97 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_LOAN
+
+/****************************************************************************
+ * Name: mq_loan_alloc
+ *
+ * Description:
+ *   Take a message buffer from the pool of loaned buffers.  The caller
+ *   fills the buffer and either passes it to mq_send_loan() or returns it
+ *   with mq_loan_free().  The buffer is a byte array with no alignment
+ *   guarantee.
+ *
+ * Input Parameters:
+ *   msglen - The size of the buffer needed, at most CONFIG_MQ_LOAN_BUFSIZE
+ *
+ * Returned Value:
+ *   The address of the buffer on success.  NULL is returned on failure and
+ *   errno is set to indicate the error:
+ *
+ *   EMSGSIZE 'msglen' is greater than CONFIG_MQ_LOAN_BUFSIZE.
+ *   ENOMEM   No loaned buffer is available.
+ *
+ ****************************************************************************/
+
+FAR void *mq_loan_alloc(size_t msglen);
+
+/****************************************************************************
+ * Name: mq_loan_free
+ *
+ * Description:
+ *   Return a buffer obtained from mq_loan_alloc() or mq_receive_loan().
+ *
+ * Input Parameters:
+ *   msg - The buffer to release
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_loan_free(FAR void *msg);
+
+/****************************************************************************
+ * Name: mq_send_loan
+ *
+ * Description:
+ *   This function behaves like mq_send() except that the message is not
+ *   copied.  'msg' must have been returned by mq_loan_alloc() and on
+ *   success ownership of the buffer passes to the message queue, then to
+ *   the receiver.  On failure the caller still owns the buffer.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   msg    - Loaned buffer holding the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   On success, mq_send_loan() returns 0 (OK); on error, -1 (ERROR) is
+ *   returned, with errno set to indicate the error.  See mq_send().
+ *
+ ****************************************************************************/
+
+int mq_send_loan(mqd_t mqdes, FAR void *msg, size_t msglen,
+                 unsigned int prio);
+
+/****************************************************************************
+ * Name: mq_receive_loan
+ *
+ * Description:
+ *   This function behaves like mq_receive() except that the message is not
+ *   copied.  The address of the message data is returned in 'msg' and the
+ *   caller must release it with mq_loan_free().  Messages sent with
+ *   mq_send() are returned in place as well.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - Location to return the address of the message data
+ *   prio  - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   On success, the length of the message in bytes is returned.  On
+ *   failure, -1 (ERROR) is returned and errno is set to indicate the error.
+ *   See mq_receive().
+ *
+ ****************************************************************************/
+
+ssize_t mq_receive_loan(mqd_t mqdes, FAR void **msg,
+                        FAR unsigned int *prio);
+
+#endif /* CONFIG_MQ_LOAN */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
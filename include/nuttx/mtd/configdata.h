@@ -58,6 +58,20 @@
  *   ioctl argument:  Pointer to a config_data_s structure to receive the
  *                    config data.  All fields of the structure must be
  *                    specified (i.e. id, instance, pointer and len).
+ *
+ * CFGDIOC_GETCONFIGS - Get several Config Data items under one lock.
+ *
+ *   ioctl argument:  Pointer to a config_bulk_s structure.  Items that do
+ *                    not exist are returned with len set to zero.  Returns
+ *                    the number of items found.
+ *
+ * CFGDIOC_SETCONFIGS - Set several Config Data items under one lock.
+ *
+ *   ioctl argument:  Pointer to a config_bulk_s structure.  Items are
+ *                    written in order; the first failure is returned and
+ *                    the remaining items are not written.
+ *
+ * The bulk commands are implemented by the fail-safe (NVS) backend only.
  */
 
 #define CFGDIOC_GETCONFIG    _CFGDIOC(1)
@@ -66,6 +80,8 @@
 #define CFGDIOC_FINDCONFIG   _CFGDIOC(4)
 #define CFGDIOC_FIRSTCONFIG  _CFGDIOC(5)
 #define CFGDIOC_NEXTCONFIG   _CFGDIOC(6)
+#define CFGDIOC_GETCONFIGS   _CFGDIOC(7)
+#define CFGDIOC_SETCONFIGS   _CFGDIOC(8)
 
 /****************************************************************************
  * Public Types
@@ -85,6 +101,14 @@ struct config_data_s
   size_t      len;          /* Length of the config data buffer */
 };
 
+/* This structure is used to get and set several config data items */
+
+struct config_bulk_s
+{
+  FAR struct config_data_s *data;  /* Array of config data items */
+  size_t      count;               /* Number of items in the array */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
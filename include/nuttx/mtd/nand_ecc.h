@@ -121,6 +121,52 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
                       unsigned int page,  FAR const void *data,
                       FAR void *spare);
 
+/****************************************************************************
+ * Name: nandecc_verifypage
+ *
+ * Description:
+ *   Verify (and, if possible, correct) the data area of a page that has
+ *   already been transferred from the NAND FLASH using the ECC information
+ *   held in its spare area.
+ *
+ * Input Parameters:
+ *   nand  - Upper-half, NAND FLASH interface
+ *   block - Number of the block where the page resides.
+ *   page  - Number of the page inside the given block.
+ *   data  - Buffer holding the data area of the page.
+ *   spare - Buffer holding the spare area of the page.
+ *
+ * Returned Value:
+ *   OK if the data is valid, -EUCLEAN if a single bit error was corrected
+ *   and -EBADMSG if the data could not be recovered.
+ *
+ ****************************************************************************/
+
+int nandecc_verifypage(FAR struct nand_dev_s *nand, off_t block,
+                       unsigned int page, FAR void *data,
+                       FAR const void *spare);
+
+/****************************************************************************
+ * Name: nandecc_encodepage
+ *
+ * Description:
+ *   Calculate the ECC for the data area of a page and store it in the
+ *   provided spare buffer.
+ *
+ * Input Parameters:
+ *   nand  - Upper-half, NAND FLASH interface
+ *   data  - Buffer containing the data to be written or NULL to leave the
+ *           existing ECC bytes erased.
+ *   spare - Buffer receiving the ECC bytes.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nandecc_encodepage(FAR struct nand_dev_s *nand, FAR const void *data,
+                        FAR void *spare);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
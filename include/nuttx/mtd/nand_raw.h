@@ -71,6 +71,12 @@
 #define COMMAND_STATUS                  0x70
 #define COMMAND_RESET                   0xff
 
+/* Nand flash commands (ONFI cache operations) */
+
+#define COMMAND_READ_CACHE_SEQ          0x31
+#define COMMAND_READ_CACHE_END          0x3f
+#define COMMAND_WRITE_CACHE             0x15
+
 /* Nand flash commands (small blocks) */
 
 #define COMMAND_READ_A                  0x00
@@ -226,10 +232,85 @@
 #  define NAND_WRITEPAGE(r,b,p,d,s) ((r)->rawwrite(r,b,p,d,s))
 #endif
 
+/****************************************************************************
+ * Name: NAND_READCACHE
+ *
+ * Description:
+ *   Reads the data and spare areas of several consecutive pages of one
+ *   block using the ONFI read cache (00h-30h, 31h..., 3Fh) sequence.  The
+ *   data areas are stored back-to-back in the data buffer.  After each page
+ *   has been transferred out of the cache register, and while the device is
+ *   already fetching the next page from the array, the callback is invoked
+ *   with the page data and its spare area so that the upper half can
+ *   verify the ECC in parallel with the array access.
+ *
+ *   This is a raw access: only NANDECC_NONE and NANDECC_SWECC devices use
+ *   it.  The method is optional and is cleared by nand_initialize() if the
+ *   ONFI parameter page does not report the read cache commands.
+ *
+ * Input Parameters:
+ *   raw      - Lower-half, raw NAND FLASH interface
+ *   block    - Number of the block where the pages reside.
+ *   page     - Number of the first page to read inside the given block.
+ *   npages   - Number of pages to read.  All pages lie in the same block.
+ *   data     - Buffer where the data areas will be stored.
+ *   callback - Per-page callback, may be NULL.
+ *   arg      - Argument passed to the callback.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure
+ *   including any negative value returned by the callback.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+#  define NAND_READCACHE(r,b,p,n,d,c,a) ((r)->readcache(r,b,p,n,d,c,a))
+#endif
+
+/****************************************************************************
+ * Name: NAND_WRITECACHE
+ *
+ * Description:
+ *   Programs several consecutive pages of one block using the ONFI page
+ *   cache program (80h-15h ..., 80h-10h) sequence.  Before each page is
+ *   transferred, and while the device is still programming the previous
+ *   page, the callback is invoked with the page data and a spare buffer
+ *   which it fills in, typically with the ECC of the page.  If no callback
+ *   is provided only the data areas are written.
+ *
+ *   The method is optional and is cleared by nand_initialize() if the ONFI
+ *   parameter page does not report the page cache program command.
+ *
+ * Input Parameters:
+ *   raw      - Lower-half, raw NAND FLASH interface
+ *   block    - Number of the block where the pages reside.
+ *   page     - Number of the first page to write inside the given block.
+ *   npages   - Number of pages to write.  All pages lie in the same block.
+ *   data     - Buffer containing the data areas, back-to-back.
+ *   callback - Per-page callback, may be NULL.
+ *   arg      - Argument passed to the callback.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure
+ *   including any negative value returned by the callback.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+#  define NAND_WRITECACHE(r,b,p,n,d,c,a) ((r)->writecache(r,b,p,n,d,c,a))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+/* Per-page callback of the NAND_READCACHE and NAND_WRITECACHE methods */
+
+typedef CODE int (*nand_pagecb_t)(FAR void *arg, unsigned int page,
+                                  FAR void *data, FAR void *spare);
+#endif
+
 /* This type represents the visible portion of the lower-half, raw NAND MTD
  * device.  The lower-half driver may freely append additional information
  * after this required header information.
@@ -262,6 +343,19 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+#ifdef CONFIG_MTD_NAND_CACHEOPS
+  /* Optional multi-page operations, may be NULL */
+
+  CODE int (*readcache)(FAR struct nand_raw_s *raw, off_t block,
+                        unsigned int page, unsigned int npages,
+                        FAR void *data, nand_pagecb_t callback,
+                        FAR void *arg);
+  CODE int (*writecache)(FAR struct nand_raw_s *raw, off_t block,
+                         unsigned int page, unsigned int npages,
+                         FAR const void *data, nand_pagecb_t callback,
+                         FAR void *arg);
+#endif
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers */
 
@@ -49,6 +49,23 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Bits in the features supported field of the ONFI parameter page */
+
+#define ONFI_FEATURE_BUS16        (1 << 0) /* 16-bit data bus width */
+#define ONFI_FEATURE_MULTILUN     (1 << 1) /* Multiple LUN operations */
+#define ONFI_FEATURE_NONSEQPROG   (1 << 2) /* Non-sequential page program */
+#define ONFI_FEATURE_MPPROGRAM    (1 << 3) /* Multi-plane program and erase */
+#define ONFI_FEATURE_MPREAD       (1 << 6) /* Multi-plane read */
+
+/* Bits in the optional commands supported field of the ONFI parameter
+ * page.
+ */
+
+#define ONFI_OPTCMD_CACHEPROGRAM  (1 << 0) /* Page Cache Program */
+#define ONFI_OPTCMD_CACHEREAD     (1 << 1) /* Read Cache Random/Sequential */
+#define ONFI_OPTCMD_FEATURES      (1 << 2) /* Get/Set Features */
+#define ONFI_OPTCMD_COPYBACK      (1 << 4) /* Copyback */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -66,6 +83,9 @@ struct onfi_pgparam_s
   uint16_t pagesperblock; /* Number of pages per block */
   uint16_t blocksperlun;  /* Number of blocks per logical unit (LUN) */
   uint32_t pagesize;      /* Number of data bytes per page */
+  uint16_t features;      /* Features supported, see ONFI_FEATURE_* */
+  uint16_t optcmds;       /* Optional commands, see ONFI_OPTCMD_* */
+  uint8_t planebits;      /* Number of plane (interleaved) address bits */
 };
 
 /****************************************************************************
@@ -0,0 +1,204 @@
+/****************************************************************************
+ * include/nuttx/mtd/sfdp.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MTD_SFDP_H
+#define __INCLUDE_NUTTX_MTD_SFDP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_MTD_SFDP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Read SFDP command.  Sent with a 3 byte address and 8 dummy clocks on a
+ * single data line.
+ */
+
+#define SFDP_CMD_READ       0x5a
+#define SFDP_DUMMY_CLOCKS   8
+
+/* Read modes, named instruction-address-data bus widths */
+
+#define SFDP_READ_1_1_1     0  /* Fast read (0Bh) */
+#define SFDP_READ_1_1_2     1
+#define SFDP_READ_1_2_2     2
+#define SFDP_READ_2_2_2     3
+#define SFDP_READ_1_1_4     4
+#define SFDP_READ_1_4_4     5
+#define SFDP_READ_4_4_4     6
+#define SFDP_READ_1_1_8     7
+#define SFDP_READ_1_8_8     8
+#define SFDP_READ_NMODES    9
+
+#define SFDP_READ_MODE(m)   (1 << (m))
+
+/* Address modes supported by the device */
+
+#define SFDP_ADDR_3BYTE     0  /* 3 byte addresses only */
+#define SFDP_ADDR_3OR4BYTE  1  /* 3 byte by default, 4 byte on request */
+#define SFDP_ADDR_4BYTE     2  /* 4 byte addresses only */
+
+/* Number of erase types described by the BFPT */
+
+#define SFDP_NERASETYPES    4
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Read SFDP data at 'addr' of the SFDP space into 'buffer'.  Returns zero
+ * on success or a negated errno value.
+ */
+
+typedef CODE int (*sfdp_read_t)(FAR void *arg, uint32_t addr,
+                                FAR void *buffer, size_t nbytes);
+
+/* One fast read instruction */
+
+struct sfdp_readop_s
+{
+  uint8_t opcode;           /* Read instruction */
+  uint8_t modeclks;         /* Mode (continuous read) clocks */
+  uint8_t dummies;          /* Wait state clocks following the mode clocks */
+};
+
+/* One erase type */
+
+struct sfdp_erase_s
+{
+  uint32_t size;            /* Erase size in bytes, zero if unused */
+  uint8_t  opcode;          /* Erase instruction */
+};
+
+/* Parameters taken from the JESD216 Basic Flash Parameter Table */
+
+struct sfdp_info_s
+{
+  uint8_t  major;           /* BFPT major revision */
+  uint8_t  minor;           /* BFPT minor revision */
+  uint8_t  addrmode;        /* See SFDP_ADDR_* definitions */
+  uint8_t  erase4k;         /* 4KiB erase instruction, zero if none */
+  bool     dtr;             /* Double transfer rate clocking supported */
+  uint8_t  qer;             /* Quad enable requirements (BFPT DWORD 15) */
+  uint16_t readmodes;       /* Bit set of SFDP_READ_MODE(SFDP_READ_*) */
+  uint32_t pagesize;        /* Program page size in bytes */
+  uint64_t size;            /* Device size in bytes */
+  struct sfdp_erase_s erase[SFDP_NERASETYPES];
+  struct sfdp_readop_s read[SFDP_READ_NMODES];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sfdp_probe
+ *
+ * Description:
+ *   Read the SFDP header of a serial flash and decode its Basic Flash
+ *   Parameter Table.  The transport is left to the caller so that both SPI
+ *   and QSPI drivers can share the parser.
+ *
+ * Input Parameters:
+ *   read - Reads from the SFDP space of the device
+ *   arg  - Opaque argument passed to read
+ *   info - Receives the decoded parameters
+ *
+ * Returned Value:
+ *   Zero on success; -ENODEV if the device has no valid SFDP header, or
+ *   another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sfdp_probe(sfdp_read_t read, FAR void *arg,
+               FAR struct sfdp_info_s *info);
+
+/****************************************************************************
+ * Name: sfdp_select_read
+ *
+ * Description:
+ *   Pick the widest read mode that both the device and the controller
+ *   support.
+ *
+ * Input Parameters:
+ *   info  - Parameters returned by sfdp_probe()
+ *   modes - Bit set of SFDP_READ_MODE(SFDP_READ_*) the controller can issue
+ *   op    - Receives the read instruction of the selected mode
+ *
+ * Returned Value:
+ *   The SFDP_READ_* mode selected.  SFDP_READ_1_1_1 (0Bh with 8 dummy
+ *   clocks) is always available.
+ *
+ ****************************************************************************/
+
+int sfdp_select_read(FAR const struct sfdp_info_s *info, uint16_t modes,
+                     FAR struct sfdp_readop_s *op);
+
+/****************************************************************************
+ * Name: sfdp_spi_probe
+ *
+ * Description:
+ *   sfdp_probe() for flash attached to a single line SPI bus.  The caller
+ *   must hold the bus lock and have configured mode and frequency.
+ *
+ * Input Parameters:
+ *   spi   - SPI bus of the device
+ *   devid - SPIDEV_FLASH() index of the device
+ *   info  - Receives the decoded parameters
+ *
+ * Returned Value:
+ *   See sfdp_probe().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI
+struct spi_dev_s;
+int sfdp_spi_probe(FAR struct spi_dev_s *spi, uint32_t devid,
+                   FAR struct sfdp_info_s *info);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_MTD_SFDP */
+#endif /* __INCLUDE_NUTTX_MTD_SFDP_H */
@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <stdbool.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/semaphore.h>
 
 /****************************************************************************
@@ -65,7 +66,7 @@ struct rmutex_s
 typedef struct rmutex_s rmutex_t;
 
 /****************************************************************************
- * Public Function Prototypes
+ * Public Data
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
@@ -78,6 +79,21 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/* Adaptive spinning statistics:  The number of nxmutex_lock() calls that
+ * acquired the mutex while spinning and the number that blocked after
+ * spinning.
+ */
+
+#if defined(CONFIG_SMP) && CONFIG_LIBC_MUTEX_ADAPTIVE_SPIN > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+EXTERN atomic_int g_nxmutex_spin_hits;
+EXTERN atomic_int g_nxmutex_spin_blocks;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: nxmutex_init
  *
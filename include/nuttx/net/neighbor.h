@@ -47,6 +47,10 @@
 #  define CONFIG_NET_IPv6_NCONF_ENTRIES 8
 #endif
 
+#ifndef CONFIG_NET_IPv6_NCONF_HASHSIZE
+#  define CONFIG_NET_IPv6_NCONF_HASHSIZE 8
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -137,10 +137,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;            /* Forward reference */
+struct stat;            /* Forward reference */
+struct socket;          /* Forward reference */
+struct pollfd;          /* Forward reference */
+struct mm_map_entry_s;  /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +182,14 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -206,6 +215,12 @@ struct socket_conn_s
   FAR struct devif_callback_s *list;
   FAR struct devif_callback_s *list_tail;
 
+  /* Per-connection lock, see conn_lock().  Only initialized by the
+   * protocols that use it.
+   */
+
+  rmutex_t      s_lock;
+
   /* Socket options */
 
 #ifdef CONFIG_NET_SOCKOPTS
@@ -220,6 +235,14 @@ struct socket_conn_s
   uint8_t       s_boundto;   /* Index of the interface we are bound to.
                               * Unbound: 0, Bound: 1-MAX_IFINDEX */
 #  endif
+#  ifdef CONFIG_NET_ZEROCOPY
+  uint32_t      s_zckey;     /* Number of the next MSG_ZEROCOPY send */
+  sq_queue_t    s_zcpend;    /* MSG_ZEROCOPY sends still in flight */
+  sq_queue_t    s_errq;      /* Error queue: completed MSG_ZEROCOPY sends */
+#  endif
+#  ifdef CONFIG_NET_BUSY_POLL
+  uint32_t      s_busypoll;  /* SO_BUSY_POLL time (in microseconds) */
+#  endif
 #endif
 
   /* Definitions of 8-bit socket flags */
@@ -320,6 +343,9 @@ ssize_t net_ioctl_arglen(uint8_t domain, int cmd);
  *
  *   net_lock()        - Locks the network via a re-entrant mutex.
  *   net_unlock()      - Unlocks the network.
+ *   conn_lock()       - Locks the state of one connection that the data
+ *                       path shares with the socket interface.
+ *   conn_unlock()     - Unlocks the connection.
  *   net_sem_wait()    - Like pthread_cond_wait() except releases the
  *                       network momentarily to wait on another semaphore.
  *   net_ioballoc()    - Like iob_alloc() except releases the network
@@ -380,6 +406,42 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of one connection.  It protects the connection state that
+ *   socket calls may access without the network lock, such as the UDP
+ *   read-ahead queue.  The network lock, if needed as well, must be taken
+ *   first; nothing may wait for the network lock while holding a
+ *   connection lock.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_lock(FAR struct socket_conn_s *sconn);
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of one connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn);
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -537,6 +599,28 @@ int net_sem_wait_uninterruptible(FAR sem_t *sem);
 
 FAR struct iob_s *net_iobtimedalloc(bool throttled, unsigned int timeout);
 
+/****************************************************************************
+ * Name: net_iobtimedalloc_size
+ *
+ * Description:
+ *   The same as net_iobtimedalloc() but first try to take the smallest IOB
+ *   that holds 'size' bytes, see iob_tryalloc_size().  Only default IOBs
+ *   are waited for.
+ *
+ * Input Parameters:
+ *   size       - The number of bytes that the IOB is expected to hold
+ *   throttled  - An indication of the IOB allocation is "throttled"
+ *   timeout    - The relative time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   A pointer to the newly allocated IOB is returned on success.  NULL is
+ *   returned on any allocation failure.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *net_iobtimedalloc_size(unsigned int size, bool throttled,
+                                         unsigned int timeout);
+
 /****************************************************************************
  * Name: net_ioballoc
  *
@@ -928,6 +1012,56 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends up to 'vlen' messages with one call.  It is the
+ *   internal OS interface behind sendmmsg() and differs from it the same
+ *   way psock_sendmsg() differs from sendmsg().
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send; msg_len is set for each one sent
+ *   vlen      Number of entries in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  A negated errno value is returned only
+ *   if the first message could not be sent.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to 'vlen' messages with one call.  It is
+ *   the internal OS interface behind recvmmsg() and differs from it the
+ *   same way psock_recvmsg() differs from recvmsg().
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages; msg_len is set for each one
+ *             received
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags, MSG_WAITFORONE included
+ *   timeout   If not NULL, stop once this much time has passed.  As with
+ *             Linux it is only checked after a message has arrived.
+ *
+ * Returned Value:
+ *   The number of messages received.  A negated errno value is returned
+ *   only if no message was received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1362,6 +1496,26 @@ int psock_dup2(FAR struct socket *psock1, FAR struct socket *psock2);
 
 int psock_fstat(FAR struct socket *psock, FAR struct stat *buf);
 
+/****************************************************************************
+ * Name: psock_mmap
+ *
+ * Description:
+ *   The standard mmap() operation redirects operations on socket descriptors
+ *   to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   map   - The mapping requested, updated with the address on success.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.  -ENOTTY is returned if the address family does not
+ *   support mmap().
+ *
+ ****************************************************************************/
+
+int psock_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
 /****************************************************************************
  * Name: psock_sendfile
  *
@@ -641,6 +641,12 @@
 #  define CONFIG_NET_ARPTAB_SIZE 8
 #endif
 
+#ifndef CONFIG_NET_ARPTAB_HASHSIZE
+/* The number of hash buckets of the ARP table */
+
+#  define CONFIG_NET_ARPTAB_HASHSIZE 8
+#endif
+
 #ifndef CONFIG_NET_ARP_MAXAGE
 /* The maximum age of ARP table entries measured in 10ths of seconds.
  *
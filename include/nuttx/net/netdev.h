@@ -204,6 +204,24 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)IPBUF(0))
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)IPBUF(0))
 
+/* Checksum offload.  d_features tells what the device can do, the
+ * per-packet d_chksum_flags what was asked for (TX) or found (RX).
+ */
+
+#define NETDEV_FEATURE_TXCSUM   (1 << 0) /* Finishes TCP/UDP checksums */
+#define NETDEV_FEATURE_RXCSUM   (1 << 1) /* Verifies IPv4/TCP/UDP checksums */
+
+#define NETDEV_CHKSUM_PARTIAL   (1 << 0) /* TX: L4 checksum left to device */
+#define NETDEV_CHKSUM_VERIFIED  (1 << 1) /* RX: checksums checked by device */
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+#  define netdev_chksum_verified(dev) \
+     (((dev)->d_chksum_flags & NETDEV_CHKSUM_VERIFIED) != 0)
+#else
+#  define netdev_chksum_verified(dev) false
+#  define netdev_chksum_complete(dev)
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #  ifndef CONFIG_NETDEV_MAX_IPv6_ADDR
 #    define CONFIG_NETDEV_MAX_IPv6_ADDR 1
@@ -475,6 +493,33 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* TCP segmentation offload.  d_gso_max is the largest IP packet the
+   * device segments, zero if it does not.  When the outgoing TCP packet
+   * in d_iob is larger than the MTU, d_gso_size holds the segment size it
+   * is to be cut into.
+   */
+
+  uint16_t d_gso_max;
+  uint16_t d_gso_size;
+#endif
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Checksum offload.  d_features holds the NETDEV_FEATURE_* bits of the
+   * device.  For an outgoing packet with NETDEV_CHKSUM_PARTIAL set in
+   * d_chksum_flags, the checksum field d_chksum_offset bytes after
+   * d_chksum_start (both relative to the IP header) holds the
+   * pseudo-header sum and the device must fold in the data from
+   * d_chksum_start on.  A driver sets NETDEV_CHKSUM_VERIFIED for an
+   * incoming packet whose IPv4 header and TCP/UDP checksums it checked.
+   */
+
+  uint8_t  d_features;
+  uint8_t  d_chksum_flags;
+  uint16_t d_chksum_start;
+  uint16_t d_chksum_offset;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -542,6 +587,13 @@ struct net_driver_s
   CODE int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd,
                       unsigned long arg);
 #endif
+#ifdef CONFIG_NET_BUSY_POLL
+  /* Run one receive poll of the device in the caller's context, for
+   * SO_BUSY_POLL.  Called with the network locked.  May be NULL.
+   */
+
+  CODE int (*d_busypoll)(FAR struct net_driver_s *dev);
+#endif
 
   /* Drivers may attached device-specific, private information */
 
@@ -1191,6 +1243,24 @@ void netdev_iob_clear(FAR struct net_driver_s *dev);
 
 void netdev_iob_release(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_chksum_complete
+ *
+ * Description:
+ *   Finish in software the TCP/UDP checksum of the packet in d_iob that
+ *   was left to the device with NETDEV_CHKSUM_PARTIAL.  Used where the
+ *   packet does not reach the device as it is (fragmentation, NAT,
+ *   segmentation or a device without the feature).
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+void netdev_chksum_complete(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: netdev_iob_clone
  *
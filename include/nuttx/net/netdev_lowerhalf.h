@@ -91,6 +91,33 @@ enum netpkt_type_e
   NETPKT_TYPENUM
 };
 
+#ifdef CONFIG_NETDEV_WMM
+/* WMM access categories, in the order the upper half serves them */
+
+enum netdev_ac_e
+{
+  NETDEV_AC_VO,               /* Voice */
+  NETDEV_AC_VI,               /* Video */
+  NETDEV_AC_BE,               /* Best effort */
+  NETDEV_AC_BK,               /* Background */
+  NETDEV_AC_NUM
+};
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* One TX/RX queue pair of a device with several hardware queues.  The
+ * queue is serviced by its own work thread, the statistics are updated by
+ * the upper half with the network locked.
+ */
+
+struct netdev_queue_s
+{
+  atomic_int quota[NETPKT_TYPENUM];   /* Max # of buffer held by the queue */
+  uint32_t   packets[NETPKT_TYPENUM]; /* Packets sent / received */
+  uint32_t   errors[NETPKT_TYPENUM];  /* Send errors / RX packets dropped */
+};
+#endif
+
 /* This structure is the generic form of state structure used by lower half
  * netdev driver. This state structure is passed to the netdev driver when
  * the driver is initialized. Then, on subsequent callbacks into the lower
@@ -119,6 +146,39 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* TX/RX queue pairs.  A driver with several hardware queues sets nqueues
+   * and the quota of each queue (quota[] above is then unused) before
+   * registering, and provides the transmitq, receiveq and reclaimq
+   * operations.  Zero keeps the single queue of the plain operations.
+   */
+
+  uint8_t nqueues;
+  struct netdev_queue_s queues[CONFIG_NETDEV_MAX_QUEUES];
+#endif
+
+#ifdef CONFIG_NETDEV_GSO
+  /* TCP segmentation offload.  A driver whose hardware segments TCP
+   * packets sets tso_max to the largest packet (as netpkt_getdatalen()
+   * counts it) it accepts; the upper half segments everything else in
+   * software.  gso_size is the segment size of the packet passed to
+   * transmit(), zero if it does not need segmentation.
+   */
+
+  uint16_t tso_max;
+  uint16_t gso_size;
+#endif
+
+#ifdef CONFIG_NETDEV_WMM
+  /* The access category (enum netdev_ac_e) of the packets passed to
+   * transmit() or transmit_batch() of an IEEE 802.11 device.  The upper
+   * half keeps one TX queue per category and always sends the highest
+   * non-empty one first.
+   */
+
+  uint8_t tx_ac;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +232,47 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmitq/receiveq/reclaimq - The same as transmit, receive and
+   * reclaim, on the queue pair 'queue' of a device that sets nqueues.
+   */
+
+  CODE int (*transmitq)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                        FAR netpkt_t *pkt);
+  CODE FAR netpkt_t *(*receiveq)(FAR struct netdev_lowerhalf_s *dev,
+                                 int queue);
+  CODE void (*reclaimq)(FAR struct netdev_lowerhalf_s *dev, int queue);
+#endif
+
+#if CONFIG_NETDEV_TX_BATCH > 0
+  /* transmit_batch - Optional, send several packets with one call, e.g.
+   *                  to aggregate them into one bus transfer or A-MPDU.
+   *                  'queue' is 0 for a device without queue pairs.
+   *   Returned Value:
+   *     The number of packets taken, always the first ones of 'pkts'.
+   *     The driver owns them as with transmit().  The others, or all of
+   *     them on a negated errno value, are recycled by the upper half.
+   */
+
+  CODE int (*transmit_batch)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                             FAR netpkt_t **pkts, int npkts);
+#endif
+
+  /* rxfill - Optional, hand an empty RX packet to the driver ahead of
+   *          time.  The driver receives into it directly (e.g. by DMA)
+   *          and returns it later from receive().  The upper half keeps
+   *          the driver filled up to its RX quota after every poll; the
+   *          driver frees the packets it still holds with netpkt_free()
+   *          when it goes down.  'queue' is 0 for a device without queue
+   *          pairs.
+   *   Returned Value:
+   *     OK if the driver took the packet, a negated errno value if its
+   *     RX ring is full.
+   */
+
+  CODE int (*rxfill)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                     FAR netpkt_t *pkt);
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -308,6 +409,47 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue/txdone_queue
+ *
+ * Description:
+ *   The same as netdev_lower_rxready and netdev_lower_txdone, for the queue
+ *   pair 'queue' of a device with several queues.  The plain functions
+ *   notify queue 0.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue);
+
+/****************************************************************************
+ * Name: netdev_lower_set_xps
+ *
+ * Description:
+ *   Select the TX queue used for the packets the network stack sends from
+ *   'cpu'.  By default CPU n sends on queue n % nqueues.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure, already registered
+ *   cpu   - The CPU
+ *   queue - The TX queue
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+int netdev_lower_set_xps(FAR struct netdev_lowerhalf_s *dev, int cpu,
+                         int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -323,6 +465,23 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 int netdev_lower_quota_load(FAR struct netdev_lowerhalf_s *dev,
                             enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netdev_lower_quota_load_queue
+ *
+ * Description:
+ *   Fetch the quota of one queue pair.  netdev_lower_quota_load() returns
+ *   the sum over all queues of a device with several queues.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *   type  - Whether get quota for TX or RX
+ *
+ ****************************************************************************/
+
+int netdev_lower_quota_load_queue(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue, enum netpkt_type_e type);
+
 /****************************************************************************
  * Name: netpkt_alloc
  *
@@ -357,6 +516,26 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
 void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                  enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netpkt_qalloc/netpkt_qfree
+ *
+ * Description:
+ *   The same as netpkt_alloc and netpkt_free, charging the quota of the
+ *   queue pair 'queue'.  The plain functions charge queue 0.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue pair
+ *   pkt   - The packet to release
+ *   type  - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+FAR netpkt_t *netpkt_qalloc(FAR struct netdev_lowerhalf_s *dev, int queue,
+                            enum netpkt_type_e type);
+void netpkt_qfree(FAR struct netdev_lowerhalf_s *dev, int queue,
+                  FAR netpkt_t *pkt, enum netpkt_type_e type);
+
 /****************************************************************************
  * Name: netpkt_copyin
  *
@@ -77,6 +77,20 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* The structure holding the IP fragment reassembly statistics */
+
+#ifdef CONFIG_NET_IPFRAG
+struct ipfrag_stats_s
+{
+  net_stats_t reassembled;      /* Number of reassembled datagrams */
+  net_stats_t timedout;         /* Number of datagrams dropped on timeout */
+  net_stats_t evicted;          /* Number of datagrams evicted above the
+                                 * high watermark */
+  net_stats_t nomem;            /* Number of fragments dropped for lack of
+                                 * memory */
+};
+#endif
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -91,6 +105,10 @@ struct net_stats_s
   struct ipv6_stats_s ipv6;     /* IPv6 statistics */
 #endif
 
+#ifdef CONFIG_NET_IPFRAG
+  struct ipfrag_stats_s ipfrag; /* IP fragment reassembly statistics */
+#endif
+
 #ifdef CONFIG_NET_ICMP
   struct icmp_stats_s icmp;     /* ICMP statistics */
 #endif
@@ -53,6 +53,7 @@
 #include <stdbool.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/queue.h>
 #include <nuttx/net/netdev.h>
 
 #ifdef CONFIG_NET_6LOWPAN
@@ -119,6 +120,17 @@
 #define SIXLOWPAN_DISPATCH_MESH           0x80 /* 10xxxxxx Mesh routing header */
 #define SIXLOWPAN_DISPATCH_MESH_MASK      0xc0 /* 11000000 */
 
+/* Mesh addressing header (RFC4944, section 5.2):  10VFHHHH followed by the
+ * originator and the final addresses.  V and F select a 16-bit short
+ * address instead of a 64-bit extended address.  A Hops Left value of 0xf
+ * means that a Deep Hops Left byte follows the dispatch byte.
+ */
+
+#define SIXLOWPAN_MESH_V                  0x20 /* Originator address is short */
+#define SIXLOWPAN_MESH_F                  0x10 /* Final address is short */
+#define SIXLOWPAN_MESH_HOPSLEFT_MASK      0x0f /* Hops Left */
+#define SIXLOWPAN_MESH_HOPSLEFT_DEEP      0x0f /* Deep Hops Left byte follows */
+
 #define SIXLOWPAN_DISPATCH_FRAG1          0xc0 /* 11000xxx Fragmentation header (ﬁrst) */
 #define SIXLOWPAN_DISPATCH_FRAGN          0xe0 /* 11100xxx Fragmentation header (subsequent) */
 #define SIXLOWPAN_DISPATCH_FRAG_MASK      0xf8 /* 11111000 */
@@ -384,6 +396,15 @@ struct sixlowpan_reassbuf_s
 
   FAR struct sixlowpan_reassbuf_s *rb_flink;
 
+  /* While the reassembly is active, the buffer is held in a hashtable
+   * keyed by the reassembly tag and the fragment source (rb_hnode) and in
+   * a list ordered by the time at which the reassembly was started
+   * (rb_tnode).
+   */
+
+  dq_entry_t rb_hnode;
+  dq_entry_t rb_tnode;
+
   /* Fragmentation is handled frame by frame and requires that certain
    * state information be retained from frame to frame.  That additional
    * information follows the externally visible packet buffer.
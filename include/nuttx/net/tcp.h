@@ -72,11 +72,14 @@
 #define TCP_OPT_WS        3   /* Window size scaling factor */
 #define TCP_OPT_SACK_PERM 4   /* Selective-ACK Permitted option */
 #define TCP_OPT_SACK      5   /* Selective-ACK Block option */
+#define TCP_OPT_FASTOPEN  34  /* TCP Fast Open cookie option */
 
 #define TCP_OPT_NOOP_LEN       1   /* Length of TCP NOOP option. */
 #define TCP_OPT_MSS_LEN        4   /* Length of TCP MSS option. */
 #define TCP_OPT_WS_LEN         3   /* Length of TCP WS option. */
 #define TCP_OPT_SACK_PERM_LEN  2   /* Length of TCP SACK option. */
+#define TCP_OPT_FASTOPEN_LEN   2   /* Length of TCP Fast Open option without
+                                    * the cookie. */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
@@ -196,6 +199,11 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                            * available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+#ifdef CONFIG_NET_TCP_RACK
+  net_stats_t sackrexmit; /* Number of segments found lost by RACK */
+  net_stats_t recovery;   /* Number of RACK loss recovery episodes */
+  net_stats_t tlp;        /* Number of tail loss probes sent */
+#endif
 };
 #endif
 
@@ -65,6 +65,15 @@
  *              - Set IRQ filter setting
  *                Argument: A read-only pointer to struct
  *                          note_filter_irq_s
+ * NOTECTL_GETTRACEPOINT
+ *              - Get the registered tracepoint selected by 'index'
+ *                Argument: A writable pointer to struct
+ *                          note_filter_tracepoint_s
+ * NOTECTL_SETTRACEPOINT
+ *              - Enable or disable the tracepoints matching the module
+ *                and name patterns
+ *                Argument: A read-only pointer to struct
+ *                          note_filter_tracepoint_s
  */
 
 #ifdef CONFIG_DRIVERS_NOTECTL
@@ -79,6 +88,10 @@
 #define NOTECTL_GETIRQFILTER        _NOTECTLIOC(0x05)
 #define NOTECTL_SETIRQFILTER        _NOTECTLIOC(0x06)
 #endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT
+#define NOTECTL_GETTRACEPOINT       _NOTECTLIOC(0x07)
+#define NOTECTL_SETTRACEPOINT       _NOTECTLIOC(0x08)
+#endif
 
 #endif
 
@@ -26,20 +26,50 @@
  ****************************************************************************/
 
 #include <nuttx/note/note_driver.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/streams.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Size of the buffer one Perfetto packet is encoded into */
+
+#define NOTESTREAM_PERFETTO_BUFSIZE 384
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+/* Encoder state of a stream in the Perfetto trace format */
+
+struct notestream_perfetto_s
+{
+  spinlock_t lock;              /* Keeps the packets of the CPUs apart */
+  bool started;                 /* The CPU tracks were described */
+  bool cleared;                 /* The interned names were forgotten */
+  clock_t last;                 /* Time stamp of the previous note */
+  uint64_t time;                /* The same in nanoseconds */
+  uint32_t nextiid;             /* Next interning ID */
+  int nkeys;                    /* Number of interned names */
+
+  /* Open task slice per CPU, interned names with their IDs, output */
+
+  bool running[CONFIG_SMP_NCPUS];
+  uint32_t keys[CONFIG_DRIVERS_NOTESTREAM_PERFETTO_NINTERN];
+  uint32_t iids[CONFIG_DRIVERS_NOTESTREAM_PERFETTO_NINTERN];
+  uint8_t buffer[NOTESTREAM_PERFETTO_BUFSIZE];
+};
+#endif
+
 struct notestream_driver_s
 {
   struct note_driver_s driver;
   struct lib_outstream_s *stream;
+#ifdef CONFIG_DRIVERS_NOTESTREAM_PERFETTO
+  struct notestream_perfetto_s perfetto;
+#endif
 };
 
 #if defined(__cplusplus)
@@ -94,6 +94,32 @@
  * file that also require NXGLIB types.
  */
 
+#ifdef CONFIG_NX_ACCEL
+/* Hooks of a 2D graphics accelerator (DMA2D, PXP, G2D, ...).  A board
+ * registers them with nxgl_accel_register() and the framebuffer
+ * rasterizers of 8 bpp and wider try them first.  Any hook may be NULL,
+ * and a hook that returns a negated errno value (e.g. -ENOTSUP for a
+ * pixel format or an alignment the engine cannot handle) makes nxglib
+ * fall back to the CPU.  A hook must not return before the operation has
+ * completed, since the caller may touch the same memory right after.
+ */
+
+struct nxgl_accel_s
+{
+  CODE int (*fillrectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_rect_s *rect,
+                            nxgl_mxpixel_t color);
+  CODE int (*moverectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_rect_s *rect,
+                            FAR struct nxgl_point_s *offset);
+  CODE int (*copyrectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_rect_s *dest,
+                            FAR const void *src,
+                            FAR const struct nxgl_point_s *origin,
+                            unsigned int srcstride);
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -107,6 +133,12 @@ extern "C"
 #  define EXTERN extern
 #endif
 
+#ifdef CONFIG_NX_ACCEL
+/* The registered accelerator, NULL if none */
+
+EXTERN FAR const struct nxgl_accel_s *g_nxgl_accel;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -507,6 +539,20 @@ void nxgl_circletraps(FAR const struct nxgl_point_s *center,
 uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1);
 uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1);
 
+/****************************************************************************
+ * Name: nxgl_accel_register
+ *
+ * Description:
+ *   Register (or, with NULL, remove) the 2D accelerator used by the
+ *   framebuffer rasterizers.  This is normally called once by board
+ *   logic before NX is started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_ACCEL
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
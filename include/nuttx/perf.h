@@ -68,6 +68,18 @@
 #define PERF_IOC_FLAG_GROUP            1
 
 #define PERF_EVENT_FLAG_ARCH           0x000fffff
+
+/* Longest call chain recorded with PERF_SAMPLE_CALLCHAIN */
+
+#ifndef PERF_MAX_STACK_DEPTH
+#  define PERF_MAX_STACK_DEPTH         16
+#endif
+
+/* An event with a sample period records a PERF_RECORD_SAMPLE each time
+ * its counter overflows instead of only being counted.
+ */
+
+#define is_sampling_event(e)           ((e)->attr.sample_period != 0)
 #define PERF_EVENT_FLAG_USER_READ_CNT  0x80000000
 
 /****************************************************************************
@@ -704,6 +716,14 @@ enum perf_event_type_e
   PERF_RECORD_MAX,      /* non-ABI */
 };
 
+/* PERF_SAMPLE_CALLCHAIN payload, innermost frame first */
+
+struct perf_callchain_entry
+{
+  uint64_t nr;
+  uint64_t ip[PERF_MAX_STACK_DEPTH];
+};
+
 struct perf_sample_data_s
 {
 /* Fields set by perf_sample_data_init() unconditionally,
@@ -806,13 +826,16 @@ int perf_event_open(FAR struct perf_event_attr_s *attr, pid_t pid,
  * Name: perf_event_overflow
  *
  * Description:
- *   Perf event overflow handler
+ *   Called by a PMU driver from its overflow interrupt.  A sampling event
+ *   gets a PERF_RECORD_SAMPLE describing the interrupted code appended to
+ *   its ring buffer; the driver is expected to have re-armed the counter
+ *   with the next sample period already.
  *
  * Input Parameters:
  *   event - Perf event
  *
  * Returned Value:
- *   Result
+ *   Non-zero if the driver should stop the event, zero otherwise.
  *
  ****************************************************************************/
 
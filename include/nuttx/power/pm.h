@@ -463,6 +463,19 @@ FAR const struct pm_governor_s *pm_greedy_governor_initialize(void);
 
 FAR const struct pm_governor_s *pm_activity_governor_initialize(void);
 
+/****************************************************************************
+ * Name: pm_predict_governor_initialize
+ *
+ * Description:
+ *   Return the predictive governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_predict_governor_initialize(void);
+
 /****************************************************************************
  * Name: pm_set_governor
  *
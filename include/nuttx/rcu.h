@@ -0,0 +1,195 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Store barrier ordering the initialization of an object before the store
+ * that publishes it, and the matching load barrier for readers that must
+ * observe two published values in order.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define RCU_WMB() __atomic_thread_fence(__ATOMIC_RELEASE)
+#  define RCU_RMB() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#else
+#  define RCU_WMB() UP_DMB()
+#  define RCU_RMB() UP_DMB()
+#endif
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter a read-side critical section.  Read-side sections never block and
+ *   never touch shared memory: they only disable interrupts on the local
+ *   CPU, so the executing CPU cannot pass through a quiescent state until
+ *   rcu_read_unlock() is called.  The code in between must not sleep.
+ *
+ * Returned Value:
+ *   The interrupt state to pass to rcu_read_unlock().
+ *
+ ****************************************************************************/
+
+#define rcu_read_lock()        up_irq_save()
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave a read-side critical section.
+ *
+ ****************************************************************************/
+
+#define rcu_read_unlock(flags) up_irq_restore(flags)
+
+/****************************************************************************
+ * Name: rcu_dereference
+ *
+ * Description:
+ *   Load a pointer protected by RCU inside a read-side section.
+ *
+ ****************************************************************************/
+
+#define rcu_dereference(p)     (*(FAR volatile __typeof__(p) *)&(p))
+
+/****************************************************************************
+ * Name: rcu_assign_pointer
+ *
+ * Description:
+ *   Publish a pointer to an object read under RCU.  All of the
+ *   initialization of the object is visible to the readers before the
+ *   pointer is.
+ *
+ ****************************************************************************/
+
+#define rcu_assign_pointer(p, v) \
+  do \
+    { \
+      RCU_WMB(); \
+      *(FAR volatile __typeof__(p) *)&(p) = (v); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct rcu_head;
+
+/* The function called by call_rcu() after a grace period */
+
+typedef CODE void (*rcu_callback_t)(FAR struct rcu_head *head);
+
+/* Embedded in an object whose release is deferred by call_rcu() */
+
+struct rcu_head
+{
+  sq_entry_t     entry;  /* Link in the list of pending callbacks */
+  rcu_callback_t func;   /* Called after the grace period */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait for a grace period: return once every read-side section that was
+ *   in progress on any CPU at the time of the call has completed.  After an
+ *   object has been unlinked, synchronize_rcu() guarantees that no reader
+ *   still references it.
+ *
+ *   Readers cannot be preempted, so without SMP there is never a reader in
+ *   progress when a thread runs and this does nothing.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Must be called from a thread, outside any read-side section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void synchronize_rcu(void);
+#else
+#  define synchronize_rcu()
+#endif
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Call func(head) on the low priority work queue after a grace period.
+ *   This is the non-blocking form of synchronize_rcu() followed by the
+ *   release of the object containing head.
+ *
+ * Input Parameters:
+ *   head - The rcu_head embedded in the unlinked object
+ *   func - The function that releases the object
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RCU
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RCU_H */
@@ -65,6 +65,10 @@ struct rpmsg_s
  * wait: wait sem.
  * post: post sem.
  * get_cpuname: get cpu name.
+ * shm_alloc: allocate a carve-out of the memory shared with the remote and
+ *            return its offset, which the remote resolves with shm_get.
+ * shm_free: release a carve-out obtained from shm_alloc.
+ * shm_get: translate an offset received from the remote to a local address.
  */
 
 struct rpmsg_ops_s
@@ -76,6 +80,11 @@ struct rpmsg_ops_s
   CODE void (*dump)(FAR struct rpmsg_s *rpmsg);
   CODE FAR const char *(*get_local_cpuname)(FAR struct rpmsg_s *rpmsg);
   CODE FAR const char *(*get_cpuname)(FAR struct rpmsg_s *rpmsg);
+  CODE FAR void *(*shm_alloc)(FAR struct rpmsg_s *rpmsg, size_t size,
+                              FAR uint32_t *offset);
+  CODE void (*shm_free)(FAR struct rpmsg_s *rpmsg, FAR void *ptr);
+  CODE FAR void *(*shm_get)(FAR struct rpmsg_s *rpmsg, uint32_t offset,
+                            size_t size);
 };
 
 CODE typedef void (*rpmsg_dev_cb_t)(FAR struct rpmsg_device *rdev,
@@ -105,6 +114,14 @@ int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem);
 FAR const char *rpmsg_get_local_cpuname(FAR struct rpmsg_device *rdev);
 FAR const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev);
 
+FAR void *rpmsg_shm_alloc(FAR struct rpmsg_endpoint *ept, size_t size,
+                          FAR uint32_t *offset);
+void rpmsg_shm_free(FAR struct rpmsg_endpoint *ept, FAR void *ptr);
+FAR void *rpmsg_shm_get(FAR struct rpmsg_endpoint *ept, uint32_t offset,
+                        size_t size);
+void rpmsg_shm_flush(FAR void *ptr, size_t size);
+void rpmsg_shm_invalidate(FAR void *ptr, size_t size);
+
 int rpmsg_register_callback(FAR void *priv,
                             rpmsg_dev_cb_t device_created,
                             rpmsg_dev_cb_t device_destroy,
@@ -160,6 +160,25 @@
 #define RPMSG_VIRTIO_NOTIFY(d,v) \
   ((d)->ops->notify ? (d)->ops->notify(d,v) : -ENOSYS)
 
+/****************************************************************************
+ * Name: RPMSG_VIRTIO_GET_RESOURCE_SIZE
+ *
+ * Description:
+ *   Get the size of the shared memory that starts at the resource table.
+ *   Whatever is left after the vrings and the rpmsg buffers becomes the
+ *   shared pool handed out by rpmsg_shm_alloc().
+ *
+ * Input Parameters:
+ *   dev  - Device-specific state data
+ *
+ * Returned Value:
+ *   The size in bytes, 0 if unknown.
+ *
+ ****************************************************************************/
+
+#define RPMSG_VIRTIO_GET_RESOURCE_SIZE(d) \
+  ((d)->ops->get_resource_size ? (d)->ops->get_resource_size(d) : 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -190,6 +209,7 @@ struct rpmsg_virtio_ops_s
   CODE FAR const char *(*get_cpuname)(FAR struct rpmsg_virtio_s *dev);
   CODE FAR struct rpmsg_virtio_rsc_s *
   (*get_resource)(FAR struct rpmsg_virtio_s *dev);
+  CODE size_t (*get_resource_size)(FAR struct rpmsg_virtio_s *dev);
   CODE int (*is_master)(FAR struct rpmsg_virtio_s *dev);
   CODE int (*notify)(FAR struct rpmsg_virtio_s *dev, uint32_t vqid);
   CODE int (*register_callback)(FAR struct rpmsg_virtio_s *dev,
@@ -44,6 +44,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/map.h>
@@ -123,6 +124,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -134,6 +136,7 @@
 #define TCB_FLAG_FORCED_CANCEL     (1 << 13)                     /* Bit 13: Pthread cancel is forced */
 #define TCB_FLAG_JOIN_COMPLETED    (1 << 14)                     /* Bit 14: Pthread join completed */
 #define TCB_FLAG_FREE_TCB          (1 << 15)                     /* Bit 15: Free tcb after exit */
+#define TCB_FLAG_CLOEXEC_DEFAULT   (1 << 16)                     /* Bit 16: Inherit only the fds of file actions */
 
 /* Values for struct task_group tg_flags */
 
@@ -246,6 +249,21 @@
 
 #define running_regs()               ((void *)(g_running_tasks[this_cpu()]->xcp.regs))
 
+/* Number of buckets in the wakeup latency histograms.  Bucket 0 counts
+ * threads that were switched in less than 1 microsecond after they became
+ * ready to run, bucket n counts latencies of 2^(n-1) to 2^n - 1
+ * microseconds and the last bucket counts everything that waited longer.
+ * The global histograms are kept per band of CONFIG_SCHED_LATENCY_PRIOBAND
+ * priorities.
+ */
+
+#ifdef CONFIG_SCHED_LATENCY
+#  define SCHED_LATENCY_NBUCKETS     16
+#  define SCHED_LATENCY_NBANDS       ((SCHED_PRIORITY_MAX + \
+                                       CONFIG_SCHED_LATENCY_PRIOBAND) / \
+                                      CONFIG_SCHED_LATENCY_PRIOBAND)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -369,6 +387,29 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure, like
+ * struct sporadic_s.  It holds the parameters and the constant bandwidth
+ * server state of a thread with the deadline scheduling policy.
+ */
+
+struct deadline_s
+{
+  bool      throttled;              /* Budget exhausted, waiting for period */
+  uint32_t  bandwidth;              /* runtime/period in 2^-20 units        */
+  clock_t   runtime;                /* Execution budget per period          */
+  clock_t   deadline;               /* Relative deadline                    */
+  clock_t   period;                 /* Activation period                    */
+  clock_t   expire;                 /* Current absolute deadline            */
+  sclock_t  budget;                 /* Budget remaining in this period      */
+  struct wdog_s timer;              /* Replenishment timer                  */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -539,6 +580,10 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+  sigset_t tg_sigpendset;           /* Set of signals in tg_sigpendingq         */
+#ifdef CONFIG_SIG_ACTION_TABLE
+  FAR struct sigactq *tg_sigaction[NSIG]; /* Actions indexed by signo         */
+#endif
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -552,9 +597,11 @@ struct task_group_s
 #endif
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
-  /* Interval timer *********************************************************/
+  /* POSIX timers ***********************************************************/
 
-  timer_t itimer;
+  timer_t itimer;                   /* The setitimer() timer                */
+  FAR sq_queue_t *tg_timers;        /* Hash table of the group's timers     */
+  int tg_timerid;                   /* Last timer ID handed out             */
 #endif
 
   /* PIC data space and address environments ********************************/
@@ -649,8 +696,14 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s waithrtimer;          /* Sub-tick timed waits use this   */
+#endif
 
   /* Stack-Related Fields ***************************************************/
 
@@ -678,6 +731,7 @@ struct tcb_s
   sigset_t   sigprocmask;                /* Signals that are blocked        */
   sigset_t   sigwaitmask;                /* Waiting for pending signals     */
   sq_queue_t sigpendactionq;             /* List of pending signal actions  */
+  sigset_t   sigpendactionset;           /* Standard signals in that list   */
   sq_queue_t sigpostedq;                 /* List of posted signals          */
   siginfo_t  *sigunbinfo;                /* Signal info when task unblocked */
 
@@ -695,12 +749,15 @@ struct tcb_s
 
   /* Pre-emption monitor support ********************************************/
 
-#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+#ifdef CONFIG_SCHED_CPUTIME
   clock_t run_start;                     /* Time when thread begin run      */
-  clock_t run_max;                       /* Max time thread run             */
   clock_t run_time;                      /* Total time thread run           */
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  clock_t run_max;                       /* Max time thread run             */
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
   clock_t premp_start;                   /* Time when preemption disabled   */
   clock_t premp_max;                     /* Max time preemption disabled    */
@@ -715,6 +772,16 @@ struct tcb_s
   void   *crit_max_caller;               /* Caller of max critical section  */
 #endif
 
+  /* Wakeup latency monitor support *****************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+  clock_t ready_time;                    /* Time when thread became ready   */
+
+  /* Histogram of the time from being made ready to run until running */
+
+  uint32_t latency[SCHED_LATENCY_NBUCKETS];
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -740,6 +807,11 @@ struct tcb_s
   size_t level_deepest;
   size_t level;
 #endif
+
+#ifdef CONFIG_STACK_CHECK_INCREMENTAL
+  FAR void *stack_mark;                  /* Deepest stack word known used   */
+  FAR void *stack_scan;                  /* Resume point of the color scan  */
+#endif
 };
 
 /* struct task_tcb_s ********************************************************/
@@ -874,6 +946,28 @@ EXTERN clock_t g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/* Number of times each CPU had to spin for the critical section. */
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 && defined(CONFIG_SMP)
+EXTERN uint32_t g_crit_contention[CONFIG_SMP_NCPUS];
+#endif
+
+/* Wakeup latency histograms of all threads, per priority band. */
+
+#ifdef CONFIG_SCHED_LATENCY
+EXTERN uint32_t g_sched_latency[SCHED_LATENCY_NBANDS]
+                               [SCHED_LATENCY_NBUCKETS];
+#endif
+
+/* Number of tasks pulled by and pulled away from each CPU by the SMP load
+ * balancer.
+ */
+
+#ifdef CONFIG_SCHED_LOADBALANCE
+EXTERN uint32_t g_migrate_in[CONFIG_SMP_NCPUS];
+EXTERN uint32_t g_migrate_out[CONFIG_SMP_NCPUS];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -941,6 +1035,44 @@ void nxsched_foreach(nxsched_foreach_t handler, FAR void *arg);
 
 FAR struct tcb_s *nxsched_get_tcb(pid_t pid);
 
+/****************************************************************************
+ * Name: nxsched_get_cputime
+ *
+ * Description:
+ *   Return the CPU time consumed by a thread, including the part of the
+ *   current time slice that has elapsed if the thread is running.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   The CPU time in perf_gettime() units, see perf_convert().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+clock_t nxsched_get_cputime(FAR struct tcb_s *tcb);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_reset_latency
+ *
+ * Description:
+ *   Clear the wakeup latency histogram of a thread or, if tcb is NULL, the
+ *   global per priority band histograms.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread or NULL
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+void nxsched_reset_latency(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name:  nxsched_releasepid
  *
@@ -952,6 +1084,25 @@ FAR struct tcb_s *nxsched_get_tcb(pid_t pid);
 
 int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+/****************************************************************************
+ * Name: nxsched_alloc_tcb and nxsched_free_tcb
+ *
+ * Description:
+ *   Allocate the zeroed memory of a TCB of up to sizeof(struct
+ *   task_tcb_s) or sizeof(struct pthread_tcb_s) bytes, and release it.
+ *   With CONFIG_SCHED_TCB_CACHE the TCBs come from an object cache,
+ *   otherwise from the kernel heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TCB_CACHE
+FAR void *nxsched_alloc_tcb(size_t size);
+void nxsched_free_tcb(FAR void *tcb);
+#else
+#  define nxsched_alloc_tcb(size) kmm_zalloc(size)
+#  define nxsched_free_tcb(tcb)   kmm_free(tcb)
+#endif
+
 /* File system helpers ******************************************************/
 
 /* These functions all extract lists from the group structure associated with
@@ -1011,6 +1162,8 @@ FAR struct filelist *nxsched_get_files(void);
  *   nature of the created task.  For example:
  *
  *     - Task type may be set in the TCB flags to create kernel thread
+ *     - TCB_FLAG_CLOEXEC_DEFAULT may be set so that the new task inherits
+ *       only the descriptors that 'actions' dup2() from
  *
  * Input Parameters:
  *   tcb        - Address of the new task's TCB
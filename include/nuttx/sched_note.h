@@ -217,6 +217,46 @@
 #define sched_note_mark(tag, str) \
         sched_note_event(tag, NOTE_DUMP_MARK, str, strlen(str))
 
+/* Tracepoints cost a single load and a not-taken branch while they are
+ * disabled.  NOTE_TRACEPOINT_DEFINE() declares one at file scope, the
+ * begin/end macros bracket the code to measure and emit NOTE_DUMP_BEGIN /
+ * NOTE_DUMP_END with the tracepoint name.  Tracepoints are enabled per
+ * module or name at run time through NOTECTL_SETTRACEPOINT.
+ */
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT
+#  define NOTE_TRACEPOINT_DEFINE(module_, name_) \
+          static struct note_tracepoint_s g_note_tracepoint_##name_ = \
+          { \
+            NULL, module_, #name_, NOTE_TRACEPOINT_NEW \
+          }
+#  define sched_note_tracepoint(name_, event_) \
+          do \
+            { \
+              if (predict_false(g_note_tracepoint_##name_.state != \
+                                NOTE_TRACEPOINT_OFF)) \
+                { \
+                  sched_note_tracepoint_ip(&g_note_tracepoint_##name_, \
+                                           SCHED_NOTE_IP, event_); \
+                } \
+            } \
+          while (0)
+#else
+#  define NOTE_TRACEPOINT_DEFINE(module_, name_) struct note_tracepoint_s
+#  define sched_note_tracepoint(name_, event_)
+#endif
+
+#define sched_note_tracepoint_begin(name_) \
+        sched_note_tracepoint(name_, NOTE_DUMP_BEGIN)
+#define sched_note_tracepoint_end(name_) \
+        sched_note_tracepoint(name_, NOTE_DUMP_END)
+
+/* States of struct note_tracepoint_s */
+
+#define NOTE_TRACEPOINT_NEW        0  /* Not reached yet, not registered */
+#define NOTE_TRACEPOINT_OFF        1
+#define NOTE_TRACEPOINT_ON         2
+
 #define sched_note_counter(tag, name_, value_) \
         do \
           { \
@@ -566,6 +606,26 @@ struct note_filter_named_tag_s
   struct note_filter_tag_s tag_mask;
 };
 
+/* A tracepoint, see NOTE_TRACEPOINT_DEFINE() */
+
+struct note_tracepoint_s
+{
+  FAR struct note_tracepoint_s *next;  /* Registered tracepoints */
+  FAR const char *module;
+  FAR const char *name;
+  uint8_t state;                       /* NOTE_TRACEPOINT_* */
+};
+
+/* Argument of NOTECTL_GETTRACEPOINT / NOTECTL_SETTRACEPOINT */
+
+struct note_filter_tracepoint_s
+{
+  unsigned int index;    /* GET: index of the registered tracepoint */
+  char module[NAME_MAX]; /* Module name, a glob pattern for SET */
+  char name[NAME_MAX];   /* Tracepoint name, a glob pattern for SET */
+  bool enable;
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -689,6 +749,11 @@ void sched_note_printf_ip(uint32_t tag, uintptr_t ip, FAR const char *fmt,
 #  define sched_note_printf_ip(t,ip,f,p,...)
 #endif /* CONFIG_SCHED_INSTRUMENTATION_DUMP */
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT
+void sched_note_tracepoint_ip(FAR struct note_tracepoint_s *tp,
+                              uintptr_t ip, uint8_t event);
+#endif
+
 #if defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT)
 
 /****************************************************************************
@@ -774,6 +839,30 @@ void sched_note_filter_tag(FAR struct note_filter_named_tag_s *oldf,
                            FAR struct note_filter_named_tag_s *newf);
 #endif
 
+/****************************************************************************
+ * Name: sched_note_filter_tracepoint
+ *
+ * Description:
+ *   Get a registered tracepoint or add a tracepoint enable rule
+ *   (Same as NOTECTL_GETTRACEPOINT / NOTECTL_SETTRACEPOINT ioctls)
+ *
+ * Input Parameters:
+ *   oldf - oldf->index selects the registered tracepoint to return.
+ *          If 0, nothing is returned.
+ *   newf - A rule enabling or disabling the matching tracepoints.
+ *          If 0, the rules are not updated.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_TRACEPOINT
+int sched_note_filter_tracepoint(FAR struct note_filter_tracepoint_s *oldf,
+                                 FAR const struct note_filter_tracepoint_s
+                                 *newf);
+#endif
+
 #endif /* defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT) */
 
 #undef EXTERN
@@ -42,10 +42,10 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-/* semcount, flags, waitlist, hhead */
+/* semcount, flags, waitlist, hhead, holder */
 
 #    define NXSEM_INITIALIZER(c, f) \
-       {(c), (f), SEM_WAITLIST_INITIALIZER, NULL}
+       {(c), (f), SEM_WAITLIST_INITIALIZER, NULL, SEMHOLDER_INITIALIZER}
 #  else
 /* semcount, flags, waitlist, holder[2] */
 
@@ -95,6 +95,14 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/* The deepest priority inheritance chain that has been boosted.  One means
+ * that only direct holders have ever been boosted.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+EXTERN uint8_t g_sem_prioinherit_maxdepth;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -358,6 +366,30 @@ int nxsem_tickwait(FAR sem_t *sem, uint32_t delay);
 
 int nxsem_post(FAR sem_t *sem);
 
+/****************************************************************************
+ * Name: nxsem_post_many
+ *
+ * Description:
+ *   Post the semaphore 'count' times, unblocking up to 'count' waiters
+ *   with a single merge of the ready-to-run lists.  This is the batched
+ *   equivalent of calling nxsem_post() 'count' times.
+ *
+ * Input Parameters:
+ *   sem   - Semaphore descriptor
+ *   count - The number of times to post the semaphore
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int nxsem_post_many(FAR sem_t *sem, int count);
+
 /****************************************************************************
  * Name:  nxsem_get_value
  *
@@ -552,6 +552,12 @@ struct sensor_lowerhalf_s
        *   Lower half driver pushes a sensor event by calling this function.
        *   It is provided by upper half driver to lower half driver.
        *
+       *   Several events may be pushed at once: drivers draining a
+       *   hardware FIFO should push the whole batch in a single call,
+       *   which is stored with one buffer update and wakes each user at
+       *   most once.  Users whose batch latency exceeds the hardware one
+       *   are only woken when their latency worth of events is pending.
+       *
        * Input Parameters:
        *   priv   - Upper half driver handle.
        *   data   - The buffer of event, it can be all type of sensor events.
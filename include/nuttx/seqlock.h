@@ -0,0 +1,265 @@
+/****************************************************************************
+ * include/nuttx/seqlock.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SEQLOCK_H
+#define __INCLUDE_NUTTX_SEQLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Read and write memory barriers.  A sequence counter needs its loads and
+ * stores ordered with respect to the data that it protects: between CPUs
+ * in the SMP case and only against the compiler otherwise, where the
+ * writer excludes the readers by disabling interrupts.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#  ifdef CONFIG_SMP
+#    define SEQ_RMB() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#    define SEQ_WMB() __atomic_thread_fence(__ATOMIC_RELEASE)
+#  else
+#    define SEQ_RMB() __atomic_signal_fence(__ATOMIC_ACQUIRE)
+#    define SEQ_WMB() __atomic_signal_fence(__ATOMIC_RELEASE)
+#  endif
+#else
+#  define SEQ_RMB() UP_DSB()
+#  define SEQ_WMB() UP_DMB()
+#endif
+
+#define SEQCOUNT_INITIALIZER {0}
+#define SEQLOCK_INITIALIZER  {SEQCOUNT_INITIALIZER, SP_UNLOCKED}
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A sequence counter.  Readers never block writers: a reader samples the
+ * counter, reads the protected data and retries if the counter changed or
+ * was odd (a write was in progress).  The writers must be serialized by
+ * other means and must not be preempted by a reader on the same CPU, i.e.
+ * they run with interrupts disabled.
+ */
+
+typedef struct seqcount_s
+{
+  volatile uint32_t sequence;
+} seqcount_t;
+
+/* A sequence counter together with the spinlock serializing its writers */
+
+typedef struct seqlock_s
+{
+  seqcount_t seqcount;
+  spinlock_t lock;
+} seqlock_t;
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: seqcount_init
+ *
+ * Description:
+ *   Initialize a sequence counter.
+ *
+ ****************************************************************************/
+
+static inline_function void seqcount_init(FAR seqcount_t *s)
+{
+  s->sequence = 0;
+}
+
+/****************************************************************************
+ * Name: read_seqcount_begin
+ *
+ * Description:
+ *   Begin a read section.  Waits for any write in progress on another CPU
+ *   to complete.
+ *
+ * Input Parameters:
+ *   s - The sequence counter
+ *
+ * Returned Value:
+ *   The sequence value to pass to read_seqcount_retry().
+ *
+ ****************************************************************************/
+
+static inline_function uint32_t read_seqcount_begin(FAR const seqcount_t *s)
+{
+  uint32_t start;
+
+  while (((start = s->sequence) & 1) != 0)
+    {
+    }
+
+  SEQ_RMB();
+  return start;
+}
+
+/****************************************************************************
+ * Name: read_seqcount_retry
+ *
+ * Description:
+ *   End a read section.
+ *
+ * Input Parameters:
+ *   s     - The sequence counter
+ *   start - The value returned by read_seqcount_begin()
+ *
+ * Returned Value:
+ *   true if a write happened during the read section and the data read
+ *   must be discarded and read again.
+ *
+ ****************************************************************************/
+
+static inline_function bool read_seqcount_retry(FAR const seqcount_t *s,
+                                                uint32_t start)
+{
+  SEQ_RMB();
+  return s->sequence != start;
+}
+
+/****************************************************************************
+ * Name: write_seqcount_begin
+ *
+ * Description:
+ *   Begin a write section.  The caller provides the mutual exclusion
+ *   between writers.
+ *
+ ****************************************************************************/
+
+static inline_function void write_seqcount_begin(FAR seqcount_t *s)
+{
+  s->sequence++;
+  SEQ_WMB();
+}
+
+/****************************************************************************
+ * Name: write_seqcount_end
+ *
+ * Description:
+ *   End a write section.
+ *
+ ****************************************************************************/
+
+static inline_function void write_seqcount_end(FAR seqcount_t *s)
+{
+  SEQ_WMB();
+  s->sequence++;
+}
+
+/****************************************************************************
+ * Name: seqlock_init
+ *
+ * Description:
+ *   Initialize a sequence lock.
+ *
+ ****************************************************************************/
+
+static inline_function void seqlock_init(FAR seqlock_t *sl)
+{
+  seqcount_init(&sl->seqcount);
+  spin_lock_init(&sl->lock);
+}
+
+/****************************************************************************
+ * Name: read_seqbegin and read_seqretry
+ *
+ * Description:
+ *   Lockless read section of a sequence lock, see read_seqcount_begin() and
+ *   read_seqcount_retry().  Typical use:
+ *
+ *     do
+ *       {
+ *         seq = read_seqbegin(&lock);
+ *         ... copy the protected data ...
+ *       }
+ *     while (read_seqretry(&lock, seq));
+ *
+ ****************************************************************************/
+
+static inline_function uint32_t read_seqbegin(FAR const seqlock_t *sl)
+{
+  return read_seqcount_begin(&sl->seqcount);
+}
+
+static inline_function bool read_seqretry(FAR const seqlock_t *sl,
+                                          uint32_t start)
+{
+  return read_seqcount_retry(&sl->seqcount, start);
+}
+
+/****************************************************************************
+ * Name: write_seqlock_irqsave
+ *
+ * Description:
+ *   Disable interrupts, take the writer spinlock and begin a write section.
+ *   This may be used from interrupt handlers.
+ *
+ * Input Parameters:
+ *   sl - The sequence lock
+ *
+ * Returned Value:
+ *   The interrupt state to pass to write_sequnlock_irqrestore().
+ *
+ ****************************************************************************/
+
+static inline_function irqstate_t write_seqlock_irqsave(FAR seqlock_t *sl)
+{
+  irqstate_t flags = spin_lock_irqsave(&sl->lock);
+
+  write_seqcount_begin(&sl->seqcount);
+  return flags;
+}
+
+/****************************************************************************
+ * Name: write_sequnlock_irqrestore
+ *
+ * Description:
+ *   End a write section, release the writer spinlock and restore the
+ *   interrupt state.
+ *
+ ****************************************************************************/
+
+static inline_function void write_sequnlock_irqrestore(FAR seqlock_t *sl,
+                                                       irqstate_t flags)
+{
+  write_seqcount_end(&sl->seqcount);
+  spin_unlock_irqrestore(&sl->lock, flags);
+}
+
+#endif /* __INCLUDE_NUTTX_SEQLOCK_H */
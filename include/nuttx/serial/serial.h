@@ -518,6 +518,21 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *  Idle-line completion of an RX DMA transfer.  The lower half stops the
+ *  transfer, stores the received count in dmarx.nbytes and calls this
+ *  function to hand the partial data to readers without waiting for the
+ *  DMA transfer to fill up.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_idle(FAR uart_dev_t *dev);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
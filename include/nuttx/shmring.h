@@ -0,0 +1,201 @@
+/****************************************************************************
+ * include/nuttx/shmring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SHMRING_H
+#define __INCLUDE_NUTTX_SHMRING_H
+
+/* A shared memory ring is a queue of fixed size elements that lives in a
+ * shmfs object, so it can be used by several processes without copying
+ * the data through the kernel.  Each push and pop is a pair of atomic
+ * operations on the shared head and tail indexes.  The kernel is entered
+ * only to block a consumer that found the ring empty and to wake it up
+ * again, which happens once per empty-to-nonempty transition at most.
+ *
+ * A ring has exactly one consumer.  It has one producer, or any number of
+ * producers if it was created with SHM_RING_MPSC.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+#ifdef CONFIG_LIBC_SHM_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* shm_ring_create() flags */
+
+#define SHM_RING_MPSC   (1 << 0)  /* Allow multiple concurrent producers */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The process local handle of an open ring */
+
+struct shm_ring_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shm_ring_create
+ *
+ * Description:
+ *   Create a new named shared memory ring and open it.
+ *
+ * Input Parameters:
+ *   name     - The shared memory object name, as for shm_open()
+ *   elemsize - The size of one element in bytes
+ *   nelem    - The number of elements, must be a power of two
+ *   flags    - Zero or SHM_RING_MPSC
+ *
+ * Returned Value:
+ *   A handle of the ring on success; NULL on failure with errno set
+ *   appropriately.  EEXIST is reported if the name is already in use.
+ *
+ ****************************************************************************/
+
+FAR struct shm_ring_s *shm_ring_create(FAR const char *name,
+                                       size_t elemsize, size_t nelem,
+                                       int flags);
+
+/****************************************************************************
+ * Name: shm_ring_open
+ *
+ * Description:
+ *   Open an existing named shared memory ring.
+ *
+ * Input Parameters:
+ *   name - The name that was passed to shm_ring_create()
+ *
+ * Returned Value:
+ *   A handle of the ring on success; NULL on failure with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+FAR struct shm_ring_s *shm_ring_open(FAR const char *name);
+
+/****************************************************************************
+ * Name: shm_ring_close
+ *
+ * Description:
+ *   Close a ring handle.  The ring itself persists until it is unlinked
+ *   and closed by all of its users.
+ *
+ * Input Parameters:
+ *   ring - The ring handle
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void shm_ring_close(FAR struct shm_ring_s *ring);
+
+/****************************************************************************
+ * Name: shm_ring_unlink
+ *
+ * Description:
+ *   Remove the name of a shared memory ring.
+ *
+ * Input Parameters:
+ *   name - The name that was passed to shm_ring_create()
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int shm_ring_unlink(FAR const char *name);
+
+/****************************************************************************
+ * Name: shm_ring_push
+ *
+ * Description:
+ *   Copy one element into the ring.  This never blocks.
+ *
+ * Input Parameters:
+ *   ring - The ring handle
+ *   data - The element to add, of the size given at creation
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the ring is full.
+ *
+ ****************************************************************************/
+
+int shm_ring_push(FAR struct shm_ring_s *ring, FAR const void *data);
+
+/****************************************************************************
+ * Name: shm_ring_pop
+ *
+ * Description:
+ *   Remove the oldest element from the ring.  Only one thread may pop from
+ *   a ring at a time.
+ *
+ * Input Parameters:
+ *   ring  - The ring handle
+ *   data  - Receives the element, of the size given at creation
+ *   block - Wait for an element if the ring is empty
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the ring is empty and block is false,
+ *   or a negated errno value if the wait failed (e.g. -EINTR).
+ *
+ ****************************************************************************/
+
+int shm_ring_pop(FAR struct shm_ring_s *ring, FAR void *data, bool block);
+
+/****************************************************************************
+ * Name: shm_ring_count
+ *
+ * Description:
+ *   Return the number of elements currently in the ring.
+ *
+ ****************************************************************************/
+
+size_t shm_ring_count(FAR struct shm_ring_s *ring);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_LIBC_SHM_RING */
+#endif /* __INCLUDE_NUTTX_SHMRING_H */
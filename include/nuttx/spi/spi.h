@@ -436,6 +436,32 @@
 #  define SPI_TRIGGER(d) \
   (((d)->ops->trigger) ? ((d)->ops->trigger(d)) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_CHAIN
+ *
+ * Description:
+ *   Perform a whole sequence of transfers (see spi_transfer.h) in one go,
+ *   typically by linking the transfers into a chain of DMA descriptors.
+ *   The frequency, mode and number of bits have already been set and the
+ *   bus is locked.  The lower half handles chip select, including any
+ *   deselect requested between transfers.  Optional.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   seq - The sequence of transfers
+ *
+ * Returned Value:
+ *   OK       - The sequence has completed
+ *   -ENOSYS  - Not supported (for this sequence); the caller falls back to
+ *              one SPI_EXCHANGE() per transfer
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+#  define SPI_CHAIN(d,s) \
+  (((d)->ops->chain) ? ((d)->ops->chain(d,s)) : -ENOSYS)
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -543,6 +569,7 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+struct spi_sequence_s;
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -581,6 +608,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_ASYNC
+  CODE int      (*chain)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_sequence_s *seq);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
@@ -35,6 +35,7 @@
 
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
+#include <nuttx/queue.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
 
@@ -114,6 +115,26 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes one queued message as handled by spi_transfer_async().
+ * The message, the sequence and all buffers belong to the caller and must
+ * stay valid until 'complete' has been called.
+ */
+
+struct spi_message_s
+{
+  sq_entry_t node;                      /* Used internally */
+  FAR struct spi_sequence_s *seq;       /* The transfers to perform */
+
+  /* Called from the work queue when the sequence has finished, with the
+   * result of spi_transfer().
+   */
+
+  CODE void (*complete)(FAR struct spi_message_s *msg, int result);
+  FAR void *arg;                        /* For use by the caller */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -137,6 +158,31 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return immediately.  Messages
+ *   for the same bus are performed in order from the low priority work
+ *   queue; up to CONFIG_SPI_ASYNC_BATCH of them are handled under a single
+ *   bus lock, so that back-to-back messages from different devices on a
+ *   shared bus do not pay the lock/unlock round trip each.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   msg - The message to queue
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was queued; a negated errno value on
+ *   failure, in which case 'complete' will not be called.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_message_s *msg);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +59,23 @@ struct symtab_s
   FAR const void *sym_value; /* The value associated with the string */
 };
 
+/* struct symtab_hash_s is a hash index over a symbol table, built at run
+ * time by symtab_hashinit() in the manner of ELF's DT_GNU_HASH: the chain
+ * of every bucket is contiguous and holds the full hash of each symbol so
+ * that a lookup only compares the strings of a probable match.  The table
+ * itself is neither copied nor reordered.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int nsyms;                         /* Number of entries in symtab */
+  uint32_t nbuckets;                 /* Number of buckets, a power of two */
+  FAR uint32_t *buckets;             /* First slot of each bucket + 1 end */
+  FAR uint32_t *chain;               /* Hash of the symbol in each slot */
+  FAR uint32_t *index;               /* symtab index of each slot */
+};
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -121,6 +140,50 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_HASH
+
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index over a symbol table of any order.  The table must
+ *   stay unchanged and valid as long as the index is used.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the index could not be allocated.
+ *
+ ****************************************************************************/
+
+int symtab_hashinit(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hashfind
+ *
+ * Description:
+ *   Find the symbol with the matching name in constant expected time.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hashfind(FAR const struct symtab_hash_s *hash, FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_hashfree
+ *
+ * Description:
+ *   Release the memory of a hash index.
+ *
+ ****************************************************************************/
+
+void symtab_hashfree(FAR struct symtab_hash_s *hash);
+
+#endif /* CONFIG_SYMTAB_HASH */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
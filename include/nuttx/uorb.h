@@ -1120,6 +1120,23 @@ struct sensor_gnss_geofence_param
   int32_t            transition;
 };
 
+/* This structure is placed at the start of the memory returned by mmap()
+ * on a sensor device and is followed by the event circular buffer of
+ * nbuffer * esize bytes.  The newest event ends at byte offset
+ * (head % (nbuffer * esize)) of that buffer.  The writer makes 'sequence'
+ * odd while it updates the buffer: readers sample it before and after
+ * copying an event and retry if it was odd or changed.
+ */
+
+struct sensor_mmap_s
+{
+  volatile uint32_t sequence;  /* Write sequence counter */
+  uint32_t esize;              /* The element size of circular buffer */
+  uint32_t nbuffer;            /* The number of events that the buffer holds */
+  uint32_t reserved;
+  volatile uint64_t head;      /* Total bytes written to the buffer */
+};
+
 /* This structure describes the state for the sensor device */
 
 struct sensor_state_s
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * include/nuttx/vdso.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VDSO_H
+#define __INCLUDE_NUTTX_VDSO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/seqlock.h>
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The clock data page as seen from user space */
+
+#define VDSO_DATA ((FAR const struct vdso_data_s *)CONFIG_ARCH_VDSO_VBASE)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The clock data page.  The kernel writes it under the sequence counter,
+ * user space reads it with read_seqcount_begin()/read_seqcount_retry() and
+ * adds the time elapsed since cycle_last, measured with up_vdso_gettime().
+ * That function is provided by the architecture in <arch/arch.h> and reads
+ * the counter behind up_perf_gettime() in user mode.
+ */
+
+struct vdso_data_s
+{
+  seqcount_t      seq;         /* Odd while the kernel updates the page */
+  unsigned long   freq;        /* Counter frequency, zero until valid */
+  unsigned long   cycle_last;  /* Counter value at the last update */
+  struct timespec monotonic;   /* CLOCK_MONOTONIC at cycle_last */
+  struct timespec offset;      /* CLOCK_REALTIME minus CLOCK_MONOTONIC */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: clock_vdso_page
+ *
+ * Description:
+ *   Return the clock data page.  addrenv_attach() maps it read-only at
+ *   CONFIG_ARCH_VDSO_VBASE in every process and addrenv_destroy() unmaps
+ *   it again, so that up_addrenv_destroy() does not free the shared page.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The physical address of the page; zero if it could not be allocated.
+ *
+ ****************************************************************************/
+
+uintptr_t clock_vdso_page(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CLOCK_VDSO */
+#endif /* __INCLUDE_NUTTX_VDSO_H */
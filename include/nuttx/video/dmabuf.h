@@ -0,0 +1,174 @@
+/****************************************************************************
+ * include/nuttx/video/dmabuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_DMABUF_H
+#define __INCLUDE_NUTTX_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* DMABUF file descriptors are shared between a producer (e.g. a V4L2
+ * capture device) and any number of consumers (a codec, the framebuffer)
+ * without copying the payload.  Before the CPU touches the buffer contents
+ * through a mapping it has to bracket the access with DMABUFIOC_SYNC so
+ * that the data cache is kept coherent with the DMA engines.
+ *
+ * DMABUFIOC_SYNC
+ *   Description: Start or end a CPU access window on the buffer.
+ *   Argument:    A reference to struct dmabuf_sync_s.
+ *   Return:      Zero (OK) on success.  A negated errno value on failure.
+ */
+
+#define DMABUFIOC_SYNC          _DMABUFIOC(0x0001)
+
+/* Flags of struct dmabuf_sync_s */
+
+#define DMABUF_SYNC_READ        (1 << 0)  /* CPU will read the buffer */
+#define DMABUF_SYNC_WRITE       (1 << 1)  /* CPU will write the buffer */
+#define DMABUF_SYNC_RW          (DMABUF_SYNC_READ | DMABUF_SYNC_WRITE)
+#define DMABUF_SYNC_START       (0 << 2)  /* Begin the CPU access */
+#define DMABUF_SYNC_END         (1 << 2)  /* Finish the CPU access */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Argument of DMABUFIOC_SYNC */
+
+struct dmabuf_sync_s
+{
+  uint64_t flags;                  /* DMABUF_SYNC_* */
+};
+
+/* Called when the last reference to an exported buffer goes away */
+
+typedef CODE void (*dmabuf_release_t)(FAR void *arg, FAR void *addr);
+
+/* Opaque buffer object behind a DMABUF file descriptor */
+
+struct dmabuf_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Name: dmabuf_export
+ *
+ * Description:
+ *   Wrap an existing, physically contiguous buffer into a new DMABUF file
+ *   descriptor.  The memory stays owned by the exporter; 'release' (if not
+ *   NULL) is invoked once the descriptor and all imported references are
+ *   gone.
+ *
+ * Input Parameters:
+ *   addr    - Start address of the buffer
+ *   size    - Size of the buffer in bytes
+ *   release - Release callback, may be NULL
+ *   arg     - Opaque argument passed to 'release'
+ *   oflags  - O_CLOEXEC and/or O_NONBLOCK for the new descriptor
+ *
+ * Returned Value:
+ *   A new file descriptor on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dmabuf_export(FAR void *addr, size_t size, dmabuf_release_t release,
+                  FAR void *arg, int oflags);
+
+/****************************************************************************
+ * Name: dmabuf_alloc
+ *
+ * Description:
+ *   Allocate a cache line aligned buffer from the user heap and export it
+ *   as a DMABUF file descriptor.  The memory is freed together with the
+ *   last reference.
+ *
+ ****************************************************************************/
+
+int dmabuf_alloc(size_t size, int oflags);
+
+/****************************************************************************
+ * Name: dmabuf_get
+ *
+ * Description:
+ *   Import the DMABUF behind 'fd' and take a reference on it.  The
+ *   reference keeps the memory alive even if the descriptor is closed.
+ *
+ * Returned Value:
+ *   The buffer object on success; NULL if 'fd' is not a DMABUF.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_get(int fd);
+
+/****************************************************************************
+ * Name: dmabuf_put
+ *
+ * Description:
+ *   Drop a reference taken by dmabuf_get().
+ *
+ ****************************************************************************/
+
+void dmabuf_put(FAR struct dmabuf_s *buf);
+
+/****************************************************************************
+ * Name: dmabuf_vaddr / dmabuf_size
+ *
+ * Description:
+ *   Return the address and size of an imported buffer.
+ *
+ ****************************************************************************/
+
+FAR void *dmabuf_vaddr(FAR struct dmabuf_s *buf);
+size_t dmabuf_size(FAR struct dmabuf_s *buf);
+
+#endif /* CONFIG_VIDEO_DMABUF */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_VIDEO_DMABUF_H */
@@ -319,6 +319,12 @@
                                               /* Argument: writable struct
                                                *           fb_fix_screeninfo */
 
+#ifdef CONFIG_VIDEO_DMABUF
+#  define FBIOSET_DMABUF      _FBIOC(0x001d)  /* Scan out from a DMABUF
+                                               * Argument: int (descriptor,
+                                               *           -1 for fbmem) */
+#endif
+
 #define FB_TYPE_PACKED_PIXELS        0      /* Packed Pixels */
 #define FB_TYPE_PLANES               1      /* Non interleaved planes */
 #define FB_TYPE_INTERLEAVED_PLANES   2      /* Interleaved planes */
@@ -846,6 +852,15 @@ struct fb_vtable_s
 
   int (*setpower)(FAR struct fb_vtable_s *vtable, int power);
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Scan out from an imported buffer instead of the plane's own memory.
+   * A NULL address switches back to the plane's memory.
+   */
+
+  int (*setbuffer)(FAR struct fb_vtable_s *vtable, FAR void *addr,
+                   size_t len);
+#endif
+
   /* Passthrough the unknown ioctl commands. */
 
   int (*ioctl)(FAR struct fb_vtable_s *vtable, int cmd, unsigned long arg);
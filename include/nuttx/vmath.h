@@ -0,0 +1,80 @@
+/****************************************************************************
+ * include/nuttx/vmath.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VMATH_H
+#define __INCLUDE_NUTTX_VMATH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+
+#ifdef CONFIG_LIBM_VECTOR
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: vsinf, vexpf, vlogf, vtanhf
+ *
+ * Description:
+ *   Compute y[i] = f(x[i]) for 0 <= i < n.  The arrays need no particular
+ *   alignment and y may be the same array as x, but they must not
+ *   otherwise overlap.
+ *
+ *   The maximum error over the whole float range, measured against a
+ *   double precision reference, is:
+ *
+ *     vsinf   3 ULP  (arguments above 39000 in magnitude use sinf())
+ *     vexpf   1 ULP
+ *     vlogf   1 ULP
+ *     vtanhf  2 ULP
+ *
+ *   NaN and infinite arguments give the same results as the scalar
+ *   functions, but errno is never set.
+ *
+ ****************************************************************************/
+
+void vsinf(FAR float *y, FAR const float *x, size_t n);
+void vexpf(FAR float *y, FAR const float *x, size_t n);
+void vlogf(FAR float *y, FAR const float *x, size_t n);
+void vtanhf(FAR float *y, FAR const float *x, size_t n);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_LIBM_VECTOR */
+#endif /* __INCLUDE_NUTTX_VMATH_H */
@@ -34,6 +34,10 @@
 #include <nuttx/irq.h>
 #include <stdint.h>
 
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+#  include <sys/tree.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -81,13 +85,20 @@ struct wdlist_node
 
 struct wdog_s
 {
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+  RB_ENTRY(wdog_s)   node;       /* Supports a red-black tree */
+#else
   struct wdlist_node node;       /* Supports a doubly linked list */
+#endif
   wdparm_t           arg;        /* Callback argument */
   wdentry_t          func;       /* Function to execute when delay expires */
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
   clock_t            expired;    /* Timer associated with the absoulute time */
+#ifdef CONFIG_WDOG_PERCPU
+  uint8_t            cpu;        /* CPU whose queue holds the watchdog */
+#endif
 };
 
 /****************************************************************************
@@ -180,6 +191,34 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
                      wdentry_t wdentry, wdparm_t arg);
 
+/****************************************************************************
+ * Name: wd_start_cpu
+ *
+ * Description:
+ *   This function is the same as wd_start() except that the watchdog is
+ *   placed on the timer queue of the specified CPU, and the watchdog
+ *   function will be executed on that CPU.  wd_start() always uses the
+ *   queue of the calling CPU.
+ *
+ *   Without CONFIG_WDOG_PERCPU there is only one timer queue and the
+ *   'cpu' argument is ignored.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *   cpu      - The CPU that will expire the watchdog
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int wd_start_cpu(FAR struct wdog_s *wdog, sclock_t delay,
+                 wdentry_t wdentry, wdparm_t arg, int cpu);
+
 /****************************************************************************
  * Name: wd_start_abstime
  *
@@ -335,6 +374,26 @@ int wd_cancel_irq(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_getnext
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog of the current CPU expires.  The power management governors
+ *   use it as an upper bound of the coming idle period.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that a watchdog is already due, CLOCK_MAX that no watchdog
+ *   is active.
+ *
+ ****************************************************************************/
+
+clock_t wd_getnext(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
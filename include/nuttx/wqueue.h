@@ -228,6 +228,14 @@
 
 #endif /* CONFIG_LIBC_USRWORK && !__KERNEL__ */
 
+/* Number of buckets in the kernel work queue latency histograms.  Bucket 0
+ * counts work that started in the same tick as it was queued, bucket n
+ * counts work that waited 2^(n-1) to 2^n - 1 ticks and the last bucket
+ * counts everything that waited longer.
+ */
+
+#define WORK_LATENCY_NBUCKETS 8
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -261,6 +269,18 @@ struct work_s
   worker_t  worker;              /* Work callback */
   FAR void *arg;                 /* Callback argument */
   FAR struct kwork_wqueue_s *wq; /* Work queue */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+  int16_t   cpu;                 /* CPU the work is bound to, or -1 */
+#endif
+};
+
+/* Describes one entry of a batch passed to work_queue_batch() */
+
+struct work_batch_s
+{
+  FAR struct work_s *work;       /* The work structure to queue */
+  worker_t  worker;              /* Work callback */
+  FAR void *arg;                 /* Callback argument */
 };
 
 /* This is an enumeration of the various events that may be
@@ -417,6 +437,93 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_batch/work_queue_batch_wq
+ *
+ * Description:
+ *   Queue several work structures at once with the same delay.  This has
+ *   the same effect as calling work_queue() for each entry of the batch
+ *   but the work is queued in one critical section, delayed work expires
+ *   on the same tick and the worker threads are woken up only once the
+ *   whole batch is queued.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   batch  - The array of work to queue
+ *   nwork  - The number of entries in the batch
+ *   delay  - Delay (in clock ticks) from the time queue until the workers
+ *            are invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_batch(int qid, FAR const struct work_batch_s *batch,
+                     size_t nwork, clock_t delay);
+int work_queue_batch_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR const struct work_batch_s *batch,
+                        size_t nwork, clock_t delay);
+
+/****************************************************************************
+ * Name: work_queue_cpu/work_queue_cpu_wq
+ *
+ * Description:
+ *   The same as work_queue()/work_queue_wq() except that the work is
+ *   performed by a worker thread bound to the specified CPU and is never
+ *   taken over by the workers of other CPUs.  Worker threads are bound to
+ *   CPUs only if the thread pool has at least one thread per CPU.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   cpu    - The CPU that must perform the work
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  -EINVAL is returned if
+ *   no worker thread of the work queue is bound to the CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+int work_queue_cpu(int qid, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay, int cpu);
+int work_queue_cpu_wq(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work, worker_t worker,
+                      FAR void *arg, clock_t delay, int cpu);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_latency/work_queue_latency_wq
+ *
+ * Description:
+ *   Return the histogram of the time that work waited in the work queue
+ *   before a worker thread started to perform it.
+ *
+ * Input Parameters:
+ *   qid     - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue  - The work queue handle
+ *   latency - The location to return the WORK_LATENCY_NBUCKETS counters
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+int work_queue_latency(int qid, FAR uint32_t *latency);
+int work_queue_latency_wq(FAR struct kwork_wqueue_s *wqueue,
+                          FAR uint32_t *latency);
+#endif
+
 /****************************************************************************
  * Name: work_queue_pri
  *
@@ -48,13 +48,14 @@
  * posix_spawnattr_t object using the posix_spawnattr_setflags() function:"
  */
 
-#define POSIX_SPAWN_RESETIDS      (1 << 0)  /* 1: Reset effective user ID */
-#define POSIX_SPAWN_SETPGROUP     (1 << 1)  /* 1: Set process group */
-#define POSIX_SPAWN_SETSCHEDPARAM (1 << 2)  /* 1: Set task's priority */
-#define POSIX_SPAWN_SETSCHEDULER  (1 << 3)  /* 1: Set task's scheduler policy */
-#define POSIX_SPAWN_SETSIGDEF     (1 << 4)  /* 1: Set default signal actions */
-#define POSIX_SPAWN_SETSIGMASK    (1 << 5)  /* 1: Set sigmask */
-#define POSIX_SPAWN_SETSID        (1 << 7)  /* 1: Create the new session(glibc specific) */
+#define POSIX_SPAWN_RESETIDS        (1 << 0)  /* 1: Reset effective user ID */
+#define POSIX_SPAWN_SETPGROUP       (1 << 1)  /* 1: Set process group */
+#define POSIX_SPAWN_SETSCHEDPARAM   (1 << 2)  /* 1: Set task's priority */
+#define POSIX_SPAWN_SETSCHEDULER    (1 << 3)  /* 1: Set task's scheduler policy */
+#define POSIX_SPAWN_SETSIGDEF       (1 << 4)  /* 1: Set default signal actions */
+#define POSIX_SPAWN_SETSIGMASK      (1 << 5)  /* 1: Set sigmask */
+#define POSIX_SPAWN_CLOEXEC_DEFAULT (1 << 6)  /* 1: Inherit only dup2 sources */
+#define POSIX_SPAWN_SETSID          (1 << 7)  /* 1: Create the new session(glibc specific) */
 
 /* NOTE: NuttX provides only one implementation:  If
  * CONFIG_LIBC_ENVPATH is defined, then only posix_spawnp() behavior
@@ -0,0 +1,194 @@
+/****************************************************************************
+ * include/sys/ioring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IORING_H
+#define __INCLUDE_SYS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Submission queue entry operation codes (struct ioring_sqe::opcode) */
+
+#define IORING_OP_NOP           0  /* Complete immediately with res = 0 */
+#define IORING_OP_READV         1  /* preadv2(fd, addr, len, off, rw_flags) */
+#define IORING_OP_WRITEV        2  /* pwritev2(fd, addr, len, off, rw_flags) */
+#define IORING_OP_FSYNC         3  /* fsync(fd) */
+#define IORING_OP_READ          4  /* pread(fd, addr, len, off) */
+#define IORING_OP_WRITE         5  /* pwrite(fd, addr, len, off) */
+#define IORING_OP_READ_FIXED    6  /* IORING_OP_READ into buffer buf_index */
+#define IORING_OP_WRITE_FIXED   7  /* IORING_OP_WRITE from buffer buf_index */
+#define IORING_OP_SEND          8  /* send(fd, addr, len, rw_flags) */
+#define IORING_OP_RECV          9  /* recv(fd, addr, len, rw_flags) */
+
+/* Submission queue entry flags (struct ioring_sqe::flags) */
+
+#define IOSQE_IO_LINK           (1 << 0) /* Start the next SQE only after
+                                          * this one completes successfully,
+                                          * otherwise cancel it */
+
+/* An 'off' value selecting the current file position */
+
+#define IORING_OFF_CURRENT      ((off_t)-1)
+
+/* ioring_enter() flags */
+
+#define IORING_ENTER_GETEVENTS  (1 << 0) /* Wait for min_complete CQEs */
+
+/* ioring_register() opcodes */
+
+#define IORING_REGISTER_BUFFERS   0 /* arg: struct iovec[nr_args] */
+#define IORING_UNREGISTER_BUFFERS 1 /* arg: NULL, nr_args: 0 */
+
+/* mmap() offset of the ring memory returned by ioring_setup() */
+
+#define IORING_OFF_RINGS        0
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* Submission queue entry.  Filled in by the application at
+ * sqes[sq_tail & sq_mask] before sq_tail is advanced.
+ */
+
+struct ioring_sqe
+{
+  uint8_t    opcode;     /* IORING_OP_* */
+  uint8_t    flags;      /* IOSQE_* */
+  uint16_t   buf_index;  /* Registered buffer index for *_FIXED */
+  int        fd;         /* File or socket descriptor */
+  off_t      off;        /* File offset or IORING_OFF_CURRENT */
+  FAR void  *addr;       /* Buffer, or struct iovec array for *V ops */
+  uint32_t   len;        /* Buffer length, or iovec count for *V ops */
+  uint32_t   rw_flags;   /* RWF_* for read/write, MSG_* for send/recv */
+  uintptr_t  user_data;  /* Copied unchanged into the CQE */
+};
+
+/* Completion queue entry.  Produced by the kernel at
+ * cqes[cq_tail & cq_mask]; consumed by the application advancing cq_head.
+ */
+
+struct ioring_cqe
+{
+  uintptr_t  user_data;  /* From the SQE */
+  int32_t    res;        /* Result: byte count or negated errno */
+  uint32_t   flags;      /* Reserved, zero */
+};
+
+/* Shared ring header at the start of the mapped ring memory.  The head of
+ * each queue is written by its consumer and the tail by its producer: the
+ * application produces SQEs and consumes CQEs, the kernel does the
+ * opposite.  Updates must use release stores and the peer's index must be
+ * read with an acquire load.
+ */
+
+struct ioring_rings
+{
+  uint32_t   sq_head;    /* Next SQE the kernel will consume */
+  uint32_t   sq_tail;    /* Next free SQE slot */
+  uint32_t   sq_mask;    /* sq_entries - 1 */
+  uint32_t   sq_entries; /* Number of SQE slots, a power of two */
+  uint32_t   cq_head;    /* Next CQE the application will consume */
+  uint32_t   cq_tail;    /* Next free CQE slot */
+  uint32_t   cq_mask;    /* cq_entries - 1 */
+  uint32_t   cq_entries; /* Number of CQE slots, a power of two */
+};
+
+/* ioring_setup() parameters */
+
+struct ioring_params
+{
+  uint32_t   sq_entries; /* Out: number of SQE slots */
+  uint32_t   cq_entries; /* In: CQE slots (0: 2 * sq_entries); out: used */
+  uint32_t   flags;      /* In: reserved, must be zero */
+  uint32_t   ring_size;  /* Out: bytes to mmap() at IORING_OFF_RINGS */
+  uint32_t   sqes_off;   /* Out: offset of the SQE array in the mapping */
+  uint32_t   cqes_off;   /* Out: offset of the CQE array in the mapping */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ioring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring with at least 'entries' SQE slots
+ *   (rounded up to a power of two) and return a file descriptor for it.
+ *   The ring memory is then mapped with
+ *   mmap(NULL, p->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+ *   IORING_OFF_RINGS).
+ *
+ ****************************************************************************/
+
+int ioring_setup(unsigned int entries, FAR struct ioring_params *p);
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Submit up to 'to_submit' queued SQEs and, with IORING_ENTER_GETEVENTS,
+ *   wait until at least 'min_complete' CQEs are available.  Returns the
+ *   number of SQEs consumed.
+ *
+ ****************************************************************************/
+
+int ioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                 unsigned int flags);
+
+/****************************************************************************
+ * Name: ioring_register
+ *
+ * Description:
+ *   Register (or unregister) resources used by later SQEs, such as the
+ *   fixed buffers referenced by IORING_OP_READ_FIXED/WRITE_FIXED.
+ *
+ ****************************************************************************/
+
+int ioring_register(int fd, unsigned int opcode, FAR void *arg,
+                    unsigned int nr_args);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_IORING_H */
@@ -67,6 +67,7 @@
 #define MAP_NORESERVE   (1 << 9)        /* Bit 9:  Do not reserve swap space for this mapping */
 #define MAP_POPULATE    (1 << 10)       /* Bit 10: populate (prefault) page tables */
 #define MAP_NONBLOCK    (1 << 11)       /* Bit 11: Do not block on IO */
+#define MAP_HUGETLB     (1 << 12)       /* Bit 12: Allocate the mapping using large pages */
 
 #define MAP_UNINITIALIZED (1 << 26)     /* Bit 26: Do not clear the anonymous pages */
 
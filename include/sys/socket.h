@@ -136,9 +136,14 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* recvmmsg(): block for the first message
+                                   * only.
+                                   */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
+#define MSG_ZEROCOPY    0x4000000 /* Send without copying user data.  */
+#define MSG_FASTOPEN   0x20000000 /* Send data in TCP SYN.  */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -220,6 +225,29 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_ZEROCOPY     19 /* Enables MSG_ZEROCOPY transmission (get/set).
+                            * arg: integer value
+                            */
+#define SO_REUSEPORT    20 /* Allow several listening sockets on the same
+                            * local address and port (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_BUSY_POLL    21 /* Microseconds a blocking receive polls the
+                            * device before sleeping (get/set).
+                            * arg: integer value
+                            */
+
+/* Socket filters, see net/bpf.h */
+
+#define SO_ATTACH_FILTER 22    /* Attach a filter program to the socket
+                                * (set only).
+                                * arg: struct sock_fprog
+                                */
+#define SO_DETACH_FILTER 23    /* Remove the filter program of the socket
+                                * (set only).
+                                * arg: ignored
+                                */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -307,6 +335,18 @@
 #define SS_PAD2SIZE (SS_MAXSIZE - (sizeof(sa_family_t) + \
                      SS_PAD1SIZE + SS_ALIGNSIZE))
 
+/* Values of sock_extended_err::ee_origin */
+
+#define SO_EE_ORIGIN_NONE       0
+#define SO_EE_ORIGIN_LOCAL      1
+#define SO_EE_ORIGIN_ICMP       2
+#define SO_EE_ORIGIN_ICMP6      3
+#define SO_EE_ORIGIN_ZEROCOPY   5
+
+/* Values of sock_extended_err::ee_code for SO_EE_ORIGIN_ZEROCOPY */
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1 /* The data was copied after all */
+
 /* Network socket control */
 
 #define DENY_INET_SOCK_ENABLE  0x01   /* Deny to create INET socket */
@@ -353,6 +393,24 @@ struct sockaddr
   char        sa_data[14];     /* 14-bytes data (actually variable length) */
 };
 
+/* Error queue message, returned as IP_RECVERR/IPV6_RECVERR control message
+ * by recvmsg(MSG_ERRQUEUE).  For SO_EE_ORIGIN_ZEROCOPY notifications
+ * ee_info and ee_data hold the first and the last (inclusive) number of the
+ * completed MSG_ZEROCOPY send calls;  the send calls of a socket are
+ * numbered sequentially starting from zero.
+ */
+
+struct sock_extended_err
+{
+  uint32_t ee_errno;           /* Error number */
+  uint8_t  ee_origin;          /* Where the error originated */
+  uint8_t  ee_type;            /* Type */
+  uint8_t  ee_code;            /* Code */
+  uint8_t  ee_pad;             /* Padding */
+  uint32_t ee_info;            /* Additional information */
+  uint32_t ee_data;            /* Other data */
+};
+
 /* Used with the SO_LINGER socket option */
 
 struct linger
@@ -372,6 +430,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* One entry of the message vector of recvmmsg() and sendmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -459,6 +525,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
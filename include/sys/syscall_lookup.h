@@ -168,7 +168,11 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
  */
 
 SYSCALL_LOOKUP(clock,                      0)
-SYSCALL_LOOKUP(clock_gettime,              2)
+#ifdef CONFIG_CLOCK_VDSO
+  SYSCALL_LOOKUP(nx_clock_gettime,         2)
+#else
+  SYSCALL_LOOKUP(clock_gettime,            2)
+#endif
 SYSCALL_LOOKUP(clock_settime,              2)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2)
@@ -204,6 +208,8 @@ SYSCALL_LOOKUP(readv,                      3)
 SYSCALL_LOOKUP(writev,                     3)
 SYSCALL_LOOKUP(pread,                      4)
 SYSCALL_LOOKUP(pwrite,                     4)
+SYSCALL_LOOKUP(preadv2,                    5)
+SYSCALL_LOOKUP(pwritev2,                   5)
 #ifdef CONFIG_FS_AIO
   SYSCALL_LOOKUP(aio_read,                 1)
   SYSCALL_LOOKUP(aio_write,                1)
@@ -225,6 +231,11 @@ SYSCALL_LOOKUP(pwrite,                     4)
 #ifdef CONFIG_SIGNAL_FD
   SYSCALL_LOOKUP(signalfd,                 3)
 #endif
+#ifdef CONFIG_FS_IORING
+  SYSCALL_LOOKUP(ioring_setup,             2)
+  SYSCALL_LOOKUP(ioring_enter,             4)
+  SYSCALL_LOOKUP(ioring_register,          4)
+#endif
 
 /* Board support */
 
@@ -276,6 +287,12 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(nx_mkfifo,                3)
 #endif
 
+#ifdef CONFIG_PIPES
+  SYSCALL_LOOKUP(splice,                   6)
+  SYSCALL_LOOKUP(tee,                      4)
+  SYSCALL_LOOKUP(vmsplice,                 4)
+#endif
+
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   SYSCALL_LOOKUP(mount,                    5)
   SYSCALL_LOOKUP(mkdir,                    2)
@@ -377,9 +394,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
@@ -50,10 +50,19 @@
  ****************************************************************************/
 
 #if defined(CONFIG_FS_LARGEFILE)
-#  define preadv64  preadv
-#  define pwritev64 pwritev
+#  define preadv64    preadv
+#  define pwritev64   pwritev
+#  define preadv64v2  preadv2
+#  define pwritev64v2 pwritev2
 #endif
 
+/* Per-call flags for preadv2() and pwritev2() */
+
+#define RWF_HIPRI   0x00000001 /* High priority request (ignored) */
+#define RWF_DSYNC   0x00000002 /* Flush written data before returning */
+#define RWF_SYNC    0x00000004 /* Same as RWF_DSYNC */
+#define RWF_NOWAIT  0x00000008 /* Do not block, as with O_NONBLOCK */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -163,6 +172,23 @@ ssize_t preadv(int fildes, FAR const struct iovec *iov, int iovcnt,
 ssize_t pwritev(int fildes, FAR const struct iovec *iov, int iovcnt,
                 off_t offset);
 
+/****************************************************************************
+ * Name: preadv2() and pwritev2()
+ *
+ * Description:
+ *   preadv2() and pwritev2() are preadv() and pwritev() with an extra
+ *   'flags' argument holding RWF_* values that apply to this call only.
+ *   An 'offset' of -1 uses and updates the current file position.  The
+ *   whole vector is passed to the driver in a single operation.
+ *
+ ****************************************************************************/
+
+ssize_t preadv2(int fildes, FAR const struct iovec *iov, int iovcnt,
+                off_t offset, int flags);
+
+ssize_t pwritev2(int fildes, FAR const struct iovec *iov, int iovcnt,
+                 off_t offset, int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
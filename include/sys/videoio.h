@@ -800,6 +800,22 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).  The driver returns in fd a DMABUF
+ * file descriptor referring to the MMAP buffer selected by type and index,
+ * which can then be queued as V4L2_MEMORY_DMABUF on another device.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t type;         /* enum #v4l2_buf_type */
+  uint32_t index;        /* Buffer id */
+  uint32_t plane;        /* Plane index, must be 0 */
+  uint32_t flags;        /* O_CLOEXEC and/or O_NONBLOCK */
+  int32_t  fd;           /* Driver sets the DMABUF descriptor */
+  uint32_t reserved[11];
+};
+
 /* Image is a keyframe (I-frame) */
 
 #define V4L2_BUF_FLAG_KEYFRAME                  0x00000008
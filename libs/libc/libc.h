@@ -193,6 +193,13 @@ int lib_getfullpath(int dirfd, FAR const char *path,
 
 int lib_mode2oflags(FAR const char *mode);
 
+/* Defined in lib_libfilelock.c.  The internal lock of the stdio
+ * functions, skipped for streams the caller locks itself.
+ */
+
+void lib_flockfile(FAR FILE *stream);
+void lib_funlockfile(FAR FILE *stream);
+
 /* Defined in lib_libfwrite.c */
 
 ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream);
@@ -75,10 +75,26 @@
 #  define IDX(h)    ((h) & (HSIZE - 1))
 #endif
 
+/* The back reference offset field is 13 bits wide whatever HLOG is */
+
 #define MAX_LIT     (1 <<  5)
-#define MAX_OFF     (1 << HLOG)
+#define MAX_OFF     (1 << 13)
 #define MAX_REF     ((1 << 8) + (1 << 3))
 
+/* Without strict alignment a match is extended one machine word at a time
+ * and the first differing byte is found from the XOR of the two words.
+ */
+
+#if !defined(CONFIG_LIBC_LZF_ALIGN) && defined(__GNUC__)
+#  define LZF_WORD_MATCH 1
+#  ifdef CONFIG_ENDIAN_BIG
+#    define WORD_DIFF(d) ((__builtin_clzl(d) >> 3) - \
+                          (sizeof(long) - sizeof(uintptr_t)))
+#  else
+#    define WORD_DIFF(d) (__builtin_ctzl(d) >> 3)
+#  endif
+#endif
+
 #if __GNUC__ >= 3
 #  define expect(expr,value) __builtin_expect((expr),(value))
 #  define inline             inline
@@ -213,6 +229,27 @@ size_t lzf_compress(FAR const void *const in_data,
           op[(- lit) - 1] = lit - 1; /* Stop run */
           op -= !lit;                /* Undo run if length is zero */
 
+#ifdef LZF_WORD_MATCH
+          len++;
+          while (len + sizeof(uintptr_t) <= maxlen)
+            {
+              uintptr_t diff = *(FAR const uintptr_t *)&ref[len] ^
+                               *(FAR const uintptr_t *)&ip[len];
+
+              if (diff != 0)
+                {
+                  len += WORD_DIFF(diff);
+                  break;
+                }
+
+              len += sizeof(uintptr_t);
+            }
+
+          while (len < maxlen && ref[len] == ip[len])
+            {
+              len++;
+            }
+#else
           for (; ; )
             {
               if (expect_true(maxlen > 16))
@@ -322,6 +359,7 @@ size_t lzf_compress(FAR const void *const in_data,
 
               break;
             }
+#endif
 
           len -= 2; /* len is now #octets - 1 */
           ip++;
@@ -21,7 +21,11 @@
  ****************************************************************************/
 
 /* Note about locking: There is no locking required while only one reader
- * and one writer is using the circular buffer.
+ * and one writer is using the circular buffer.  The writer publishes head
+ * with release semantics after copying the data and the reader publishes
+ * tail after consuming it, so an interrupt handler or another CPU may
+ * produce while a thread consumes (or vice versa) without a critical
+ * section.
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
  * only a need to lock the reader.
@@ -34,14 +38,51 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <sys/param.h>
 
 #include <nuttx/circbuf.h>
 #include <nuttx/lib/lib.h>
 
 /****************************************************************************
- * Private Types
+ * Private Functions
  ****************************************************************************/
 
+/* head is only written by the writer and tail only by the reader.  Loading
+ * the other side's index with acquire semantics and storing our own with
+ * release semantics orders the data copies against the index updates.
+ * Without SMP the two sides run on the same CPU, so only the compiler must
+ * not reorder the accesses.
+ */
+
+static inline size_t circbuf_load(FAR const size_t *index)
+{
+#ifdef CONFIG_SMP
+  return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+#else
+  size_t val = __atomic_load_n(index, __ATOMIC_RELAXED);
+
+  __atomic_signal_fence(__ATOMIC_ACQUIRE);
+  return val;
+#endif
+}
+
+static inline void circbuf_store(FAR size_t *index, size_t val)
+{
+#ifdef CONFIG_SMP
+  __atomic_store_n(index, val, __ATOMIC_RELEASE);
+#else
+  __atomic_signal_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(index, val, __ATOMIC_RELAXED);
+#endif
+}
+
+/* Map a free running index to a buffer offset */
+
+static inline size_t circbuf_off(FAR struct circbuf_s *circ, size_t pos)
+{
+  return circ->mask ? pos & circ->mask : pos % circ->size;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -83,6 +124,7 @@ int circbuf_init(FAR struct circbuf_s *circ, FAR void *base, size_t bytes)
 
   circ->base = base;
   circ->size = bytes;
+  circ->mask = CIRCBUF_MASK(bytes);
   circ->head = 0;
   circ->tail = 0;
 
@@ -138,6 +180,7 @@ int circbuf_resize(FAR struct circbuf_s *circ, size_t bytes)
 
   circ->base = tmp;
   circ->size = bytes;
+  circ->mask = CIRCBUF_MASK(bytes);
   circ->head = len;
   circ->tail = 0;
 
@@ -211,7 +254,7 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+  return circbuf_load(&circ->head) - circbuf_load(&circ->tail);
 }
 
 /****************************************************************************
@@ -298,6 +341,8 @@ bool circbuf_is_full(FAR struct circbuf_s *circ)
 ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
                        FAR void *dst, size_t bytes)
 {
+  size_t head;
+  size_t tail;
   size_t len;
   size_t off;
 
@@ -308,13 +353,15 @@ ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
       return 0;
     }
 
-  if (circ->head - pos > circ->head - circ->tail)
+  head = circbuf_load(&circ->head);
+  tail = circbuf_load(&circ->tail);
+  if (head - pos > head - tail)
     {
-      pos = circ->tail;
+      pos = tail;
     }
 
-  len = circ->head - pos;
-  off = pos % circ->size;
+  len = head - pos;
+  off = circbuf_off(circ, pos);
 
   if (bytes > len)
     {
@@ -386,7 +433,7 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -423,7 +470,7 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -463,7 +510,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
     }
 
   space = circbuf_space(circ);
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head);
   if (bytes > space)
     {
       bytes = space;
@@ -477,7 +524,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  circbuf_store(&circ->head, circ->head + bytes);
 
   return bytes;
 }
@@ -534,7 +581,7 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
     }
 
   circ->head += skip;
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head);
   space = circ->size - off;
   if (bytes < space)
     {
@@ -571,7 +618,7 @@ FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_space(circ);
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head);
   if (off + *size > circ->size)
     {
       *size = circ->size - off;
@@ -602,7 +649,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_used(circ);
-  off = circ->tail % circ->size;
+  off = circbuf_off(circ, circ->tail);
   if (off + *size > circ->size)
     {
       *size = circ->size - off;
@@ -628,7 +675,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 {
   DEBUGASSERT(circ);
-  circ->head += writtensize;
+  circbuf_store(&circ->head, circ->head + writtensize);
 }
 
 /****************************************************************************
@@ -648,5 +695,87 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize)
 {
   DEBUGASSERT(circ);
-  circ->tail += readsize;
+  circbuf_store(&circ->tail, circ->tail + readsize);
+}
+
+/****************************************************************************
+ * Name: circbuf_write_prepare
+ *
+ * Description:
+ *   Get all free space of the circbuf as up to two spans, the second one
+ *   being the part wrapped to the start of the buffer.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   iov   - Returns the free spans, iov[1].iov_len is zero if not wrapped.
+ *
+ * Returned Value:
+ *   The total number of bytes that can be written.
+ *
+ ****************************************************************************/
+
+size_t circbuf_write_prepare(FAR struct circbuf_s *circ,
+                             FAR struct iovec iov[2])
+{
+  size_t space;
+  size_t off;
+
+  DEBUGASSERT(circ);
+
+  iov[0].iov_len = iov[1].iov_len = 0;
+  if (!circ->size)
+    {
+      return 0;
+    }
+
+  space = circbuf_space(circ);
+  off   = circbuf_off(circ, circ->head);
+
+  iov[0].iov_base = (FAR char *)circ->base + off;
+  iov[0].iov_len  = MIN(space, circ->size - off);
+  iov[1].iov_base = circ->base;
+  iov[1].iov_len  = space - iov[0].iov_len;
+
+  return space;
+}
+
+/****************************************************************************
+ * Name: circbuf_read_prepare
+ *
+ * Description:
+ *   Get all data of the circbuf as up to two spans, the second one being
+ *   the part wrapped to the start of the buffer.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   iov   - Returns the data spans, iov[1].iov_len is zero if not wrapped.
+ *
+ * Returned Value:
+ *   The total number of bytes that can be read.
+ *
+ ****************************************************************************/
+
+size_t circbuf_read_prepare(FAR struct circbuf_s *circ,
+                            FAR struct iovec iov[2])
+{
+  size_t used;
+  size_t off;
+
+  DEBUGASSERT(circ);
+
+  iov[0].iov_len = iov[1].iov_len = 0;
+  if (!circ->size)
+    {
+      return 0;
+    }
+
+  used = circbuf_used(circ);
+  off  = circbuf_off(circ, circ->tail);
+
+  iov[0].iov_base = (FAR char *)circ->base + off;
+  iov[0].iov_len  = MIN(used, circ->size - off);
+  iov[1].iov_base = circ->base;
+  iov[1].iov_len  = used - iov[0].iov_len;
+
+  return used;
 }
@@ -26,6 +26,8 @@
 
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/mutex.h>
@@ -37,6 +39,40 @@
 
 #define NXMUTEX_RESET          ((pid_t)-2)
 
+/* In user space of PROTECTED and KERNEL builds every nxsem_wait() and
+ * nxsem_post() is a system call.  Without priority inheritance or priority
+ * protection the kernel keeps no holder state for the semaphore, so the
+ * uncontended transitions of the count can be done here with the same
+ * atomic operations the kernel uses, trapping only on contention.
+ */
+
+#if !defined(CONFIG_PRIORITY_INHERITANCE) && \
+    !defined(CONFIG_PRIORITY_PROTECT) && \
+    !defined(CONFIG_BUILD_FLAT) && !defined(__KERNEL__)
+#  define NXMUTEX_FASTPATH 1
+#  define NXMUTEX_COUNT(m) ((FAR atomic_short *)&(m)->sem.semcount)
+#endif
+
+/* Adaptive spinning needs access to the TCB of the holder */
+
+#if defined(CONFIG_SMP) && CONFIG_LIBC_MUTEX_ADAPTIVE_SPIN > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define NXMUTEX_ADAPTIVE 1
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef NXMUTEX_ADAPTIVE
+/* Number of nxmutex_lock() calls that acquired the mutex by spinning and
+ * number that had to block after spinning.
+ */
+
+atomic_int g_nxmutex_spin_hits;
+atomic_int g_nxmutex_spin_blocks;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -88,6 +124,128 @@ static void nxmutex_add_backtrace(FAR mutex_t *mutex)
 #  define nxmutex_add_backtrace(mutex)
 #endif
 
+/****************************************************************************
+ * Name: nxmutex_fastlock
+ *
+ * Description:
+ *   Take an unlocked mutex without entering the kernel.
+ *
+ * Parameters:
+ *   mutex - mutex descriptor.
+ *
+ * Return Value:
+ *   true if the mutex was acquired; false if the kernel must be entered.
+ *
+ ****************************************************************************/
+
+#ifdef NXMUTEX_FASTPATH
+static inline_function bool nxmutex_fastlock(FAR mutex_t *mutex)
+{
+  short old = 1;
+
+  return atomic_compare_exchange_weak_explicit(NXMUTEX_COUNT(mutex), &old,
+                                               0, memory_order_acquire,
+                                               memory_order_relaxed);
+}
+
+/****************************************************************************
+ * Name: nxmutex_fastunlock
+ *
+ * Description:
+ *   Release a mutex that has no waiters without entering the kernel.
+ *
+ * Parameters:
+ *   mutex - mutex descriptor.
+ *
+ * Return Value:
+ *   true if the mutex was released; false if there may be waiters to wake
+ *   and the kernel must be entered.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxmutex_fastunlock(FAR mutex_t *mutex)
+{
+  short old = 0;
+
+  return atomic_compare_exchange_weak_explicit(NXMUTEX_COUNT(mutex), &old,
+                                               1, memory_order_release,
+                                               memory_order_relaxed);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxmutex_spin
+ *
+ * Description:
+ *   Spin on the mutex while its holder is running on another CPU, or while
+ *   the mutex is being handed over, bounded by
+ *   CONFIG_LIBC_MUTEX_ADAPTIVE_SPIN iterations of about a microsecond.
+ *
+ *   The TCB of the holder is looked up only when the mutex changes hands
+ *   and is then only compared with g_running_tasks[], never dereferenced,
+ *   so no lock is needed even if the holder exits while we spin.
+ *
+ * Parameters:
+ *   mutex - mutex descriptor.
+ *
+ * Return Value:
+ *   true if the mutex was acquired; false if the caller must block.
+ *
+ ****************************************************************************/
+
+#ifdef NXMUTEX_ADAPTIVE
+static bool nxmutex_spin(FAR mutex_t *mutex)
+{
+  FAR struct tcb_s *tcb = NULL;
+  pid_t cached = NXMUTEX_NO_HOLDER;
+  pid_t holder;
+  int count;
+  int cpu;
+
+  for (count = 0; count < CONFIG_LIBC_MUTEX_ADAPTIVE_SPIN; count++)
+    {
+      if (nxsem_trywait(&mutex->sem) >= 0)
+        {
+          atomic_fetch_add(&g_nxmutex_spin_hits, 1);
+          return true;
+        }
+
+      /* Without a holder the mutex is being released, keep trying */
+
+      holder = *(FAR volatile pid_t *)&mutex->holder;
+      if (holder >= 0)
+        {
+          if (holder != cached)
+            {
+              cached = holder;
+              tcb    = nxsched_get_tcb(holder);
+            }
+
+          /* Stop spinning as soon as the holder is not running.  It cannot
+           * be running on this CPU, as we are.
+           */
+
+          for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+            {
+              if (g_running_tasks[cpu] == tcb)
+                {
+                  break;
+                }
+            }
+
+          if (tcb == NULL || cpu >= CONFIG_SMP_NCPUS)
+            {
+              return false;
+            }
+        }
+
+      up_udelay(1);
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -246,6 +404,36 @@ int nxmutex_lock(FAR mutex_t *mutex)
   int ret;
 
   DEBUGASSERT(!nxmutex_is_hold(mutex));
+
+#ifdef NXMUTEX_FASTPATH
+  if (nxmutex_fastlock(mutex))
+    {
+      mutex->holder = _SCHED_GETTID();
+      nxmutex_add_backtrace(mutex);
+      return OK;
+    }
+#endif
+
+#ifdef NXMUTEX_ADAPTIVE
+  if (nxmutex_spin(mutex))
+    {
+      mutex->holder = _SCHED_GETTID();
+      nxmutex_add_backtrace(mutex);
+      return OK;
+    }
+
+  /* Count only the calls that really block */
+
+  if (nxsem_trywait(&mutex->sem) >= 0)
+    {
+      mutex->holder = _SCHED_GETTID();
+      nxmutex_add_backtrace(mutex);
+      return OK;
+    }
+
+  atomic_fetch_add(&g_nxmutex_spin_blocks, 1);
+#endif
+
   for (; ; )
     {
       /* Take the semaphore (perhaps waiting) */
@@ -291,6 +479,15 @@ int nxmutex_trylock(FAR mutex_t *mutex)
 {
   int ret;
 
+#ifdef NXMUTEX_FASTPATH
+  if (nxmutex_fastlock(mutex))
+    {
+      mutex->holder = _SCHED_GETTID();
+      nxmutex_add_backtrace(mutex);
+      return OK;
+    }
+#endif
+
   ret = nxsem_trywait(&mutex->sem);
   if (ret < 0)
     {
@@ -333,6 +530,15 @@ int nxmutex_clocklock(FAR mutex_t *mutex, clockid_t clockid,
 {
   int ret;
 
+#ifdef NXMUTEX_FASTPATH
+  if (nxmutex_fastlock(mutex))
+    {
+      mutex->holder = _SCHED_GETTID();
+      nxmutex_add_backtrace(mutex);
+      return OK;
+    }
+#endif
+
   /* Wait until we get the lock or until the timeout expires */
 
   do
@@ -429,6 +635,13 @@ int nxmutex_unlock(FAR mutex_t *mutex)
 
   mutex->holder = NXMUTEX_NO_HOLDER;
 
+#ifdef NXMUTEX_FASTPATH
+  if (nxmutex_fastunlock(mutex))
+    {
+      return OK;
+    }
+#endif
+
   ret = nxsem_post(&mutex->sem);
   if (ret < 0)
     {
@@ -0,0 +1,389 @@
+/****************************************************************************
+ * libs/libc/misc/lib_shmring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/compiler.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/shmring.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHM_RING_MAGIC    0x53524e47  /* "SRNG" */
+
+#define SHM_RING_ALIGN    CONFIG_LIBC_SHM_RING_ALIGN
+#define SHM_RING_HDRSIZE  sizeof(struct shm_ring_hdr_s)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The layout of the ring at the start of the shared memory object.  The
+ * indexes run freely and are reduced modulo nelem on access.  The fields
+ * written by the producers and by the consumer live in separate cache
+ * lines so that the two sides do not keep stealing each other's line.
+ */
+
+struct shm_ring_hdr_s
+{
+  /* Read-only after creation */
+
+  atomic_uint magic;
+  uint32_t    flags;
+  uint32_t    elemsize;
+  uint32_t    nelem;
+
+  /* Written by the producers */
+
+  aligned_data(SHM_RING_ALIGN)
+  atomic_uint head;         /* Next element to publish to the consumer */
+  atomic_uint reserve;      /* Next element to claim (MPSC only) */
+
+  /* Written by the consumer */
+
+  aligned_data(SHM_RING_ALIGN)
+  atomic_uint tail;         /* Next element to consume */
+  atomic_uint waiting;      /* The consumer is (about to be) blocked */
+  sem_t       notempty;     /* Posted when waiting is found set */
+};
+
+struct shm_ring_s
+{
+  FAR struct shm_ring_hdr_s *hdr;
+  FAR uint8_t               *data;
+  size_t                     mapsize;
+  int                        fd;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_ring_map
+ ****************************************************************************/
+
+static FAR struct shm_ring_s *shm_ring_map(int fd, size_t mapsize)
+{
+  FAR struct shm_ring_s *ring;
+  FAR void *addr;
+
+  ring = lib_malloc(sizeof(struct shm_ring_s));
+  if (ring == NULL)
+    {
+      set_errno(ENOMEM);
+      return NULL;
+    }
+
+  addr = mmap(NULL, mapsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED)
+    {
+      lib_free(ring);
+      return NULL;
+    }
+
+  ring->hdr     = addr;
+  ring->data    = (FAR uint8_t *)addr + SHM_RING_HDRSIZE;
+  ring->mapsize = mapsize;
+  ring->fd      = fd;
+  return ring;
+}
+
+/****************************************************************************
+ * Name: shm_ring_notify
+ *
+ * Description:
+ *   Wake the consumer if it went to sleep on an empty ring.  The consumer
+ *   sets waiting before it looks at head for the last time, and the
+ *   producer has just stored head, so one of them always sees the other.
+ *
+ ****************************************************************************/
+
+static void shm_ring_notify(FAR struct shm_ring_hdr_s *hdr)
+{
+  if (atomic_load(&hdr->waiting) != 0 &&
+      atomic_exchange(&hdr->waiting, 0) != 0)
+    {
+      sem_post(&hdr->notempty);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_ring_create
+ ****************************************************************************/
+
+FAR struct shm_ring_s *shm_ring_create(FAR const char *name,
+                                       size_t elemsize, size_t nelem,
+                                       int flags)
+{
+  FAR struct shm_ring_hdr_s *hdr;
+  FAR struct shm_ring_s *ring;
+  size_t mapsize;
+  int fd;
+
+  if (elemsize == 0 || elemsize > UINT32_MAX || nelem == 0 ||
+      nelem > UINT32_MAX / 2 || (nelem & (nelem - 1)) != 0 ||
+      (flags & ~SHM_RING_MPSC) != 0)
+    {
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  mapsize = SHM_RING_HDRSIZE + elemsize * nelem;
+
+  fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+
+  if (ftruncate(fd, mapsize) < 0)
+    {
+      goto errout_with_fd;
+    }
+
+  ring = shm_ring_map(fd, mapsize);
+  if (ring == NULL)
+    {
+      goto errout_with_fd;
+    }
+
+  hdr           = ring->hdr;
+  hdr->flags    = flags;
+  hdr->elemsize = elemsize;
+  hdr->nelem    = nelem;
+
+  atomic_store(&hdr->head, 0);
+  atomic_store(&hdr->reserve, 0);
+  atomic_store(&hdr->tail, 0);
+  atomic_store(&hdr->waiting, 0);
+  sem_init(&hdr->notempty, 1, 0);
+
+  /* Publish the ring to shm_ring_open() last */
+
+  atomic_store_explicit(&hdr->magic, SHM_RING_MAGIC, memory_order_release);
+  return ring;
+
+errout_with_fd:
+  close(fd);
+  shm_unlink(name);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: shm_ring_open
+ ****************************************************************************/
+
+FAR struct shm_ring_s *shm_ring_open(FAR const char *name)
+{
+  FAR struct shm_ring_s *ring;
+  struct stat buf;
+  int fd;
+
+  fd = shm_open(name, O_RDWR | O_CLOEXEC, 0666);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+
+  if (fstat(fd, &buf) < 0)
+    {
+      goto errout_with_fd;
+    }
+
+  if (buf.st_size < SHM_RING_HDRSIZE)
+    {
+      set_errno(EINVAL);
+      goto errout_with_fd;
+    }
+
+  ring = shm_ring_map(fd, buf.st_size);
+  if (ring == NULL)
+    {
+      goto errout_with_fd;
+    }
+
+  if (atomic_load_explicit(&ring->hdr->magic, memory_order_acquire) !=
+      SHM_RING_MAGIC ||
+      SHM_RING_HDRSIZE + (size_t)ring->hdr->elemsize * ring->hdr->nelem >
+      ring->mapsize)
+    {
+      shm_ring_close(ring);
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  return ring;
+
+errout_with_fd:
+  close(fd);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: shm_ring_close
+ ****************************************************************************/
+
+void shm_ring_close(FAR struct shm_ring_s *ring)
+{
+  munmap(ring->hdr, ring->mapsize);
+  close(ring->fd);
+  lib_free(ring);
+}
+
+/****************************************************************************
+ * Name: shm_ring_unlink
+ ****************************************************************************/
+
+int shm_ring_unlink(FAR const char *name)
+{
+  return shm_unlink(name) < 0 ? -get_errno() : OK;
+}
+
+/****************************************************************************
+ * Name: shm_ring_push
+ ****************************************************************************/
+
+int shm_ring_push(FAR struct shm_ring_s *ring, FAR const void *data)
+{
+  FAR struct shm_ring_hdr_s *hdr = ring->hdr;
+  unsigned int head;
+  unsigned int tail;
+
+  if ((hdr->flags & SHM_RING_MPSC) == 0)
+    {
+      head = atomic_load_explicit(&hdr->head, memory_order_relaxed);
+      tail = atomic_load_explicit(&hdr->tail, memory_order_acquire);
+      if (head - tail >= hdr->nelem)
+        {
+          return -EAGAIN;
+        }
+
+      memcpy(ring->data + (head & (hdr->nelem - 1)) * hdr->elemsize,
+             data, hdr->elemsize);
+    }
+  else
+    {
+      /* Claim a slot, fill it, and then publish it once all of the slots
+       * claimed before it have been published.
+       */
+
+      head = atomic_load_explicit(&hdr->reserve, memory_order_relaxed);
+      do
+        {
+          tail = atomic_load_explicit(&hdr->tail, memory_order_acquire);
+          if (head - tail >= hdr->nelem)
+            {
+              return -EAGAIN;
+            }
+        }
+      while (!atomic_compare_exchange_weak_explicit(&hdr->reserve, &head,
+                                                    head + 1,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed));
+
+      memcpy(ring->data + (head & (hdr->nelem - 1)) * hdr->elemsize,
+             data, hdr->elemsize);
+
+      while (atomic_load_explicit(&hdr->head, memory_order_relaxed) != head)
+        {
+          sched_yield();
+        }
+    }
+
+  atomic_store(&hdr->head, head + 1);
+  shm_ring_notify(hdr);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shm_ring_pop
+ ****************************************************************************/
+
+int shm_ring_pop(FAR struct shm_ring_s *ring, FAR void *data, bool block)
+{
+  FAR struct shm_ring_hdr_s *hdr = ring->hdr;
+  unsigned int tail;
+
+  tail = atomic_load_explicit(&hdr->tail, memory_order_relaxed);
+  while (atomic_load_explicit(&hdr->head, memory_order_acquire) == tail)
+    {
+      if (!block)
+        {
+          return -EAGAIN;
+        }
+
+      /* Announce the wait and look again: a producer that stored head
+       * before it could see waiting set is caught by the second look.
+       */
+
+      atomic_store(&hdr->waiting, 1);
+      if (atomic_load(&hdr->head) != tail)
+        {
+          break;
+        }
+
+      if (sem_wait(&hdr->notempty) < 0)
+        {
+          return -get_errno();
+        }
+    }
+
+  memcpy(data, ring->data + (tail & (hdr->nelem - 1)) * hdr->elemsize,
+         hdr->elemsize);
+
+  atomic_store_explicit(&hdr->tail, tail + 1, memory_order_release);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shm_ring_count
+ ****************************************************************************/
+
+size_t shm_ring_count(FAR struct shm_ring_s *ring)
+{
+  FAR struct shm_ring_hdr_s *hdr = ring->hdr;
+
+  return atomic_load_explicit(&hdr->head, memory_order_acquire) -
+         atomic_load_explicit(&hdr->tail, memory_order_acquire);
+}
@@ -115,6 +115,26 @@ int modlib_symvalue(FAR struct module_s *modp,
                     Elf_Off sh_offset,
                     FAR const struct symtab_s *exports, int nexports);
 
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol exported by a module.  With CONFIG_SYMTAB_HASH a hash
+ *   index of the exports is built on the first lookup.  The caller must
+ *   hold the registry lock.
+ *
+ * Input Parameters:
+ *   modp - Module state information
+ *   name - The symbol name
+ *
+ * Returned Value:
+ *   The symbol table entry, NULL if the module does not export it.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findexport(FAR struct module_s *modp,
+                                             FAR const char *name);
+
 /****************************************************************************
  * Name: modlib_insertsymtab
  *
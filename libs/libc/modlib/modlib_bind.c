@@ -66,11 +66,22 @@
 
 typedef struct
 {
-  dq_entry_t entry;
   Elf_Sym    sym;
-  int        idx;
+  int        idx;       /* Index of the cached symbol, -1 if free */
 } Elf_SymCache;
 
+/* Resolved symbols, shared by all relocation sections of one module.  It
+ * is direct mapped by symbol index, so when the symbol table is no larger
+ * than CONFIG_MODLIB_SYMBOL_CACHECOUNT each symbol is read and resolved
+ * exactly once per load.
+ */
+
+struct modlib_symcache_s
+{
+  FAR Elf_SymCache *slots;
+  int               nslots;
+};
+
 struct
 {
   int stroff;           /* offset to string table */
@@ -164,6 +175,83 @@ static inline int modlib_readrelas(FAR struct mod_loadinfo_s *loadinfo,
                      relsec->sh_offset + offset);
 }
 
+/****************************************************************************
+ * Name: modlib_cachesym
+ *
+ * Description:
+ *   Return the resolved symbol 'symidx', reading and resolving it on the
+ *   first use.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  On success *psym is NULL for an undefined symbol without a
+ *   name, which up_relocate() handles itself.
+ *
+ ****************************************************************************/
+
+static int modlib_cachesym(FAR struct module_s *modp,
+                           FAR struct mod_loadinfo_s *loadinfo,
+                           FAR struct modlib_symcache_s *symcache,
+                           int symidx, FAR const struct symtab_s *exports,
+                           int nexports, FAR Elf_Sym **psym)
+{
+  FAR Elf_SymCache *cache = &symcache->slots[symidx % symcache->nslots];
+  FAR Elf_Sym *sym = &cache->sym;
+  int ret;
+
+  if (cache->idx != symidx)
+    {
+      /* Read the symbol table entry into memory */
+
+      cache->idx = -1;
+      ret = modlib_readsym(loadinfo, symidx, sym,
+                           &loadinfo->shdr[loadinfo->symtabidx]);
+      if (ret < 0)
+        {
+          berr("ERROR: Failed to read symbol[%d]: %d\n", symidx, ret);
+          return ret;
+        }
+
+      /* Get the value of the symbol (in sym.st_value) */
+
+      ret = modlib_symvalue(modp, loadinfo, sym,
+                            loadinfo->shdr[loadinfo->strtabidx].sh_offset,
+                            exports, nexports);
+      if (ret < 0)
+        {
+          /* The special error -ESRCH is returned only in one condition:
+           * The symbol has no name.
+           *
+           * There are a few relocations for a few architectures that do
+           * no depend upon a named symbol.  We don't know if that is the
+           * case here, but we will use a NULL symbol pointer to indicate
+           * that case to up_relocate().  That function can then do what
+           * is best.
+           */
+
+          if (ret != -ESRCH)
+            {
+              berr("ERROR: Failed to get value of symbol[%d]: %d\n",
+                   symidx, ret);
+              return ret;
+            }
+
+          berr("ERROR: Undefined symbol[%d] has no name: %d\n",
+               symidx, ret);
+        }
+
+      cache->idx = symidx;
+    }
+
+  if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
+    {
+      sym = NULL;
+    }
+
+  *psym = sym;
+  return OK;
+}
+
 /****************************************************************************
  * Name: modlib_relocate and modlib_relocateadd
  *
@@ -178,21 +266,18 @@ static inline int modlib_readrelas(FAR struct mod_loadinfo_s *loadinfo,
 
 static int modlib_relocate(FAR struct module_s *modp,
                            FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR struct modlib_symcache_s *symcache,
                            FAR const struct symtab_s *exports, int nexports)
 {
   FAR Elf_Shdr     *relsec = &loadinfo->shdr[relidx];
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rel      *rels;
   FAR Elf_Rel      *rel;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -205,14 +290,12 @@ static int modlib_relocate(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -237,99 +320,14 @@ static int modlib_relocate(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rel->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
-        {
-          if (j < CONFIG_MODLIB_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = modlib_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = modlib_symvalue(modp, loadinfo, sym,
-                  loadinfo->shdr[loadinfo->strtabidx].sh_offset,
-                  exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
-        }
-
-      if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
+      ret = modlib_cachesym(modp, loadinfo, symcache, symidx, exports,
+                            nexports, &sym);
+      if (ret < 0)
         {
-          sym = NULL;
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to resolve symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       /* Calculate the relocation address. */
@@ -416,18 +414,13 @@ static int modlib_relocate(FAR struct module_s *modp,
     }
 
   lib_free(rels);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
-
   return ret;
 }
 
 static int modlib_relocateadd(FAR struct module_s *modp,
                               FAR struct mod_loadinfo_s *loadinfo,
                               int relidx,
+                              FAR struct modlib_symcache_s *symcache,
                               FAR const struct symtab_s *exports,
                               int nexports)
 {
@@ -435,15 +428,11 @@ static int modlib_relocateadd(FAR struct module_s *modp,
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rela     *relas;
   FAR Elf_Rela     *rela;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -457,14 +446,12 @@ static int modlib_relocateadd(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -489,99 +476,14 @@ static int modlib_relocateadd(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rela->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
-        {
-          if (j < CONFIG_MODLIB_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = modlib_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = modlib_symvalue(modp, loadinfo, sym,
-                           loadinfo->shdr[loadinfo->strtabidx].sh_offset,
-                           exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
-        }
-
-      if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
+      ret = modlib_cachesym(modp, loadinfo, symcache, symidx, exports,
+                            nexports, &sym);
+      if (ret < 0)
         {
-          sym = NULL;
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to resolve symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       /* Calculate the relocation address. */
@@ -612,12 +514,6 @@ static int modlib_relocateadd(FAR struct module_s *modp,
     }
 
   lib_free(relas);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
-
   return ret;
 }
 
@@ -913,6 +809,7 @@ int modlib_bind(FAR struct module_s *modp,
                 FAR struct mod_loadinfo_s *loadinfo,
                 FAR const struct symtab_s *exports, int nexports)
 {
+  struct modlib_symcache_s symcache;
   int ret;
   int i;
 
@@ -941,6 +838,28 @@ int modlib_bind(FAR struct module_s *modp,
       return ret;
     }
 
+  /* Size the symbol cache to the symbol table if that fits */
+
+  symcache.nslots = loadinfo->shdr[loadinfo->symtabidx].sh_size /
+                    sizeof(Elf_Sym);
+  if (symcache.nslots > CONFIG_MODLIB_SYMBOL_CACHECOUNT ||
+      symcache.nslots == 0)
+    {
+      symcache.nslots = CONFIG_MODLIB_SYMBOL_CACHECOUNT;
+    }
+
+  symcache.slots = lib_malloc(symcache.nslots * sizeof(Elf_SymCache));
+  if (symcache.slots == NULL)
+    {
+      berr("Failed to allocate memory for elf symbols\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < symcache.nslots; i++)
+    {
+      symcache.slots[i].idx = -1;
+    }
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -989,7 +908,7 @@ int modlib_bind(FAR struct module_s *modp,
 
           if (ret < 0)
             {
-              return ret;
+              break;
             }
         }
       else
@@ -1016,7 +935,8 @@ int modlib_bind(FAR struct module_s *modp,
                     continue;
                   }
 
-                ret = modlib_relocate(modp, loadinfo, i, exports, nexports);
+                ret = modlib_relocate(modp, loadinfo, i, &symcache,
+                                      exports, nexports);
                 break;
               case SHT_RELA:
                 if ((loadinfo->shdr[infosec].sh_flags & SHF_ALLOC) == 0)
@@ -1024,8 +944,8 @@ int modlib_bind(FAR struct module_s *modp,
                     continue;
                   }
 
-                ret = modlib_relocateadd(modp, loadinfo, i, exports,
-                                         nexports);
+                ret = modlib_relocateadd(modp, loadinfo, i, &symcache,
+                                         exports, nexports);
                 break;
               case SHT_INIT_ARRAY:
                 loadinfo->initarr = loadinfo->shdr[i].sh_addr;
@@ -1042,10 +962,16 @@ int modlib_bind(FAR struct module_s *modp,
 
       if (ret < 0)
         {
-          return ret;
+          break;
         }
     }
 
+  lib_free(symcache.slots);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   modp->xipbase = loadinfo->xipbase;
 
   /* Ensure that the I and D caches are coherent before starting the newly
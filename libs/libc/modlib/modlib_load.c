@@ -133,6 +133,66 @@ static int modlib_section_alloc(FAR struct mod_loadinfo_s *loadinfo,
 }
 #endif
 
+/****************************************************************************
+ * Name: modlib_xipbase
+ *
+ * Description:
+ *   Find out whether the read-only sections of a position independent
+ *   module can be executed in place from a memory mapped file system, so
+ *   that only the writable sections and the GOT are loaded into RAM.
+ *
+ ****************************************************************************/
+
+static void modlib_xipbase(FAR struct mod_loadinfo_s *loadinfo)
+{
+#ifdef CONFIG_MODLIB_XIP
+  uintptr_t xipbase;
+  int i;
+
+  if (ioctl(loadinfo->filfd, FIOC_XIPBASE, (unsigned long)&xipbase) < 0 ||
+      xipbase == 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *shdr = &loadinfo->shdr[i];
+      FAR Elf_Shdr *dstsec;
+
+      /* A section left in place keeps the alignment of its file offset,
+       * which the file system may not have preserved.
+       */
+
+      if ((shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) == SHF_ALLOC &&
+          shdr->sh_size > 0 && shdr->sh_addralign > 1 &&
+          ((xipbase + shdr->sh_offset) & (shdr->sh_addralign - 1)) != 0)
+        {
+          binfo("Section %d is misaligned in place, no XIP\n", i);
+          return;
+        }
+
+      /* Only REL relocations through the GOT skip the read-only sections,
+       * anything else would have to write to the flash.
+       */
+
+      if (shdr->sh_type == SHT_RELA &&
+          shdr->sh_info < loadinfo->ehdr.e_shnum)
+        {
+          dstsec = &loadinfo->shdr[shdr->sh_info];
+          if ((dstsec->sh_flags & (SHF_ALLOC | SHF_WRITE)) == SHF_ALLOC)
+            {
+              binfo("Section %d relocates read-only data, no XIP\n", i);
+              return;
+            }
+        }
+    }
+
+  loadinfo->xipbase = xipbase;
+  binfo("can use xipbase %zu\n", loadinfo->xipbase);
+#endif
+}
+
 /****************************************************************************
  * Name: modlib_elfsize
  *
@@ -188,6 +248,16 @@ static void modlib_elfsize(FAR struct mod_loadinfo_s *loadinfo, bool alloc)
 
           if ((shdr->sh_flags & SHF_ALLOC) != 0)
             {
+#ifndef CONFIG_ARCH_USE_SEPARATED_SECTION
+              /* Sections executed in place take no memory */
+
+              if ((shdr->sh_flags & SHF_WRITE) == 0 &&
+                  loadinfo->xipbase != 0)
+                {
+                  continue;
+                }
+#endif
+
               /* SHF_WRITE indicates that the section address space is write-
                * able
                */
@@ -325,6 +395,7 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
 {
   FAR uint8_t *text = (FAR uint8_t *)loadinfo->textalloc;
   FAR uint8_t *data = (FAR uint8_t *)loadinfo->datastart;
+  FAR uint8_t *xip;
   int ret;
   int i;
 
@@ -421,6 +492,13 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
 
           if ((shdr->sh_flags & SHF_WRITE) == 0 && loadinfo->xipbase != 0)
             {
+              /* Execute in place: the section stays where it lies in the
+               * file, whatever the sections before it were.
+               */
+
+              xip  = (FAR uint8_t *)(uintptr_t)(loadinfo->xipbase +
+                                                shdr->sh_offset);
+              pptr = &xip;
               goto skipload;
             }
 
@@ -554,11 +632,7 @@ int modlib_load(FAR struct mod_loadinfo_s *loadinfo)
   if (loadinfo->gotindex >= 0)
     {
       binfo("GOT section found! index %d\n", loadinfo->gotindex);
-      if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
-                (unsigned long)&loadinfo->xipbase) >= 0)
-        {
-          binfo("can use xipbase %zu\n", loadinfo->xipbase);
-        }
+      modlib_xipbase(loadinfo);
     }
 
   /* Determine total size to allocate */
@@ -710,11 +784,7 @@ int modlib_load_with_addrenv(FAR struct mod_loadinfo_s *loadinfo)
   if (loadinfo->gotindex >= 0)
     {
       binfo("GOT section found! index %d\n", loadinfo->gotindex);
-      if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
-                (unsigned long)&loadinfo->xipbase) >= 0)
-        {
-          binfo("can use xipbase %zu\n", loadinfo->xipbase);
-        }
+      modlib_xipbase(loadinfo);
     }
 
   /* Determine total size to allocate */
@@ -93,6 +93,12 @@ int modlib_uninit(FAR struct module_s *modp)
 #endif
     }
 
+#ifdef CONFIG_SYMTAB_HASH
+  /* Exports set by the initializer are static, but their index is not */
+
+  symtab_hashfree(&modp->exphash);
+#endif
+
   /* Release resources held by the module */
 
   if (modp->textalloc != NULL || modp->dataalloc != NULL)
@@ -33,6 +33,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/mutex.h>
 #include <nuttx/symtab.h>
 #include <nuttx/lib/modlib.h>
 
@@ -72,6 +73,19 @@ struct eptable_s
 extern struct eptable_s global_table[];
 extern int nglobals;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASH
+/* Hash index of the base code's exports, rebuilt if another table is
+ * passed in.
+ */
+
+static mutex_t g_exphash_lock = NXMUTEX_INITIALIZER;
+static struct symtab_hash_s g_exphash;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -203,9 +217,7 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
+  exportinfo->symbol = modlib_findexport(modp, exportinfo->name);
 
   if (exportinfo->symbol != NULL)
     {
@@ -228,10 +240,86 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
   return SYM_NOT_FOUND;
 }
 
+/****************************************************************************
+ * Name: modlib_findbase
+ *
+ * Description:
+ *   Find a symbol exported by the base code.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *
+modlib_findbase(FAR const struct symtab_s *exports, int nexports,
+                FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  FAR const struct symtab_s *symbol = NULL;
+  bool hashed = false;
+
+  if (nxmutex_lock(&g_exphash_lock) >= 0)
+    {
+      if (g_exphash.symtab != exports || g_exphash.nsyms != nexports)
+        {
+          symtab_hashfree(&g_exphash);
+          symtab_hashinit(&g_exphash, exports, nexports);
+        }
+
+      if (g_exphash.nbuckets > 0)
+        {
+          symbol = symtab_hashfind(&g_exphash, name);
+          hashed = true;
+        }
+
+      nxmutex_unlock(&g_exphash_lock);
+    }
+
+  if (hashed)
+    {
+      return symbol;
+    }
+#endif
+
+  return symtab_findbyname(exports, name, nexports);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol exported by a module.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findexport(FAR struct module_s *modp,
+                                             FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  /* The exports are fixed once set, by modlib_insertsymtab() or by the
+   * module initializer, so the index only has to follow a new table.
+   */
+
+  if (modp->exphash.symtab != modp->modinfo.exports ||
+      modp->exphash.nsyms != (int)modp->modinfo.nexports)
+    {
+      symtab_hashfree(&modp->exphash);
+      symtab_hashinit(&modp->exphash, modp->modinfo.exports,
+                      modp->modinfo.nexports);
+    }
+
+  if (modp->exphash.nbuckets > 0)
+    {
+      return symtab_hashfind(&modp->exphash, name);
+    }
+#endif
+
+  return symtab_findbyname(modp->modinfo.exports, name,
+                           modp->modinfo.nexports);
+}
+
 /****************************************************************************
  * Name: modlib_findsymtab
  *
@@ -408,8 +496,7 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
-                                       nexports);
+            symbol = modlib_findbase(exports, nexports, exportinfo.name);
           }
 
         /* Was the symbol found from any exporter? */
@@ -630,6 +717,10 @@ void modlib_freesymtab(FAR struct module_s *modp)
   FAR const struct symtab_s *symbol;
   int i;
 
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hashfree(&modp->exphash);
+#endif
+
   if ((symbol = modp->modinfo.exports) != NULL)
     {
       for (i = 0; i < modp->modinfo.nexports; i++)
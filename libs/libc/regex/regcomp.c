@@ -3923,6 +3923,14 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* Failing to set up the DFA is not an error, regexec() then only uses
+   * the TNFA matchers.
+   */
+
+  tnfa->dfa             = tre_dfa_new(tnfa);
+#endif
+
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
   xfree(counts);
@@ -4030,5 +4038,9 @@ void regfree(regex_t *preg)
       xfree(tnfa->minimal_tags);
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_free(tnfa->dfa);
+#endif
+
   xfree(tnfa);
 }
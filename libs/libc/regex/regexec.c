@@ -64,38 +64,6 @@ static void tre_fill_pmatch(size_t nmatch, regmatch_t pmatch[], int cflags,
       str_byte += pos_add_next;                                         \
   } while (0)
 
-#define IS_WORD_CHAR(c)     ((c) == L'_' || tre_isalnum(c))
-
-#define CHECK_ASSERTIONS(assertions)                         \
-  (((assertions & ASSERT_AT_BOL)                             \
-    && (pos > 0 || reg_notbol)                               \
-    && (prev_c != L'\n' || !reg_newline))                    \
-   || ((assertions & ASSERT_AT_EOL)                          \
-       && (next_c != L'\0' || reg_noteol)                    \
-       && (next_c != L'\n' || !reg_newline))                 \
-   || ((assertions & ASSERT_AT_BOW)                          \
-       && (IS_WORD_CHAR(prev_c) || !IS_WORD_CHAR(next_c)))   \
-   || ((assertions & ASSERT_AT_EOW)                          \
-       && (!IS_WORD_CHAR(prev_c) || IS_WORD_CHAR(next_c)))   \
-   || ((assertions & ASSERT_AT_WB)                           \
-       && (pos != 0 && next_c != L'\0'                       \
-           && IS_WORD_CHAR(prev_c) == IS_WORD_CHAR(next_c))) \
-   || ((assertions & ASSERT_AT_WB_NEG)                       \
-       && (pos == 0 || next_c == L'\0'                       \
-           || IS_WORD_CHAR(prev_c) != IS_WORD_CHAR(next_c))))
-
-#define CHECK_CHAR_CLASSES(trans_i, tnfa, eflags)                              \
-  (((trans_i->assertions & ASSERT_CHAR_CLASS)                                  \
-    && !(tnfa->cflags & REG_ICASE)                                             \
-    && !tre_isctype((tre_cint_t)prev_c, trans_i->u.class))                     \
-   || ((trans_i->assertions & ASSERT_CHAR_CLASS)                               \
-       && (tnfa->cflags & REG_ICASE)                                           \
-       && !tre_isctype(tre_tolower((tre_cint_t)prev_c), trans_i->u.class)      \
-       && !tre_isctype(tre_toupper((tre_cint_t)prev_c), trans_i->u.class))     \
-   || ((trans_i->assertions & ASSERT_CHAR_CLASS_NEG)                           \
-       && tre_neg_char_classes_match(trans_i->neg_classes, (tre_cint_t)prev_c, \
-                                     tnfa->cflags & REG_ICASE)))
-
 /* Returns 1 if `t1' wins `t2', 0 otherwise. */
 
 static int tre_tag_order(int num_tags, tre_tag_direction_t *tag_directions,
@@ -136,8 +104,8 @@ static int tre_tag_order(int num_tags, tre_tag_direction_t *tag_directions,
   return 0;
 }
 
-static int tre_neg_char_classes_match(tre_ctype_t *classes, tre_cint_t wc,
-                                      int icase)
+int tre_neg_char_classes_match(tre_ctype_t *classes, tre_cint_t wc,
+                               int icase)
 {
   while (*classes != (tre_ctype_t)0)
     {
@@ -1225,6 +1193,22 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       nmatch = 0;
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* The DFA answers whether there is a match at all.  That is the whole
+   * result if no submatches are wanted, and otherwise still spares the
+   * TNFA run on strings that do not match.
+   */
+
+  if (tnfa->dfa != NULL)
+    {
+      status = tre_dfa_match(tnfa->dfa, string, eflags);
+      if (status == REG_NOMATCH || (status == REG_OK && nmatch == 0))
+        {
+          return status;
+        }
+    }
+#endif
+
   if (tnfa->num_tags > 0 && nmatch > 0)
     {
       tags = xmalloc(sizeof(*tags) * tnfa->num_tags);
@@ -0,0 +1,561 @@
+/****************************************************************************
+ * libs/libc/regex/tre-dfa.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The parallel TNFA matcher recomputes the set of active TNFA states for
+ * every input character.  When the caller only needs to know whether the
+ * regexp matches, the same sets can be cached: every distinct set becomes
+ * a DFA state and the transition taken on each byte class is remembered,
+ * so that scanning a string costs one table lookup per character once the
+ * cache is warm.
+ *
+ * Assertions are evaluated at the position a transition leads to, which
+ * depends on the character after the one being consumed.  Regexps using
+ * $, \<, \> or \b therefore key their transitions on the class of that
+ * lookahead character as well.
+ *
+ * Only ASCII input is handled; any other byte, a full cache that keeps
+ * being flushed or a cache busy in another thread makes the caller fall
+ * back to the TNFA matchers.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/mutex.h>
+
+#include "tre.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Classes of the character following the one being consumed */
+
+#define TRE_DFA_NEXT_OTHER      0
+#define TRE_DFA_NEXT_WORD       1
+#define TRE_DFA_NEXT_NEWLINE    2
+#define TRE_DFA_NEXT_END        3  /* End of string */
+#define TRE_DFA_NEXT_NOTEOL     4  /* End of string with REG_NOTEOL */
+#define TRE_DFA_NNEXT           5
+
+/* Assertions that look at the character following the transition */
+
+#define TRE_DFA_LOOKAHEAD       (ASSERT_AT_EOL | ASSERT_AT_BOW | \
+                                 ASSERT_AT_EOW | ASSERT_AT_WB | \
+                                 ASSERT_AT_WB_NEG)
+
+#define TRE_DFA_NASCII          128
+#define TRE_DFA_UNKNOWN         UINT16_MAX  /* Transition not computed yet */
+
+/* DFA state flags */
+
+#define TRE_DFA_ACCEPT          (1 << 0)    /* Contains the final state */
+#define TRE_DFA_DEAD            (1 << 1)    /* Can never reach a match */
+
+/* Give up on a string after flushing the cache this many times */
+
+#define TRE_DFA_MAX_FLUSHES     8
+
+#define TRE_DFA_ISSET(set, id)  (((set)[(id) >> 5] >> ((id) & 31)) & 1)
+#define TRE_DFA_SET(set, id)    ((set)[(id) >> 5] |= 1u << ((id) & 31))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tre_dfa_s
+{
+  mutex_t lock;                             /* Protects the cache */
+  const tre_tnfa_t *tnfa;                   /* The TNFA being cached */
+  tre_tnfa_transition_t **states;           /* TNFA state id -> arcs */
+  int final;                                /* State id of tnfa->final */
+  int words;                                /* Words in a state set */
+  int nnext;                                /* 1 or TRE_DFA_NNEXT */
+  int stride;                               /* Transitions per state */
+  int nstates;                              /* Cached DFA states */
+  bool anchored;                            /* Can only match at offset 0 */
+  uint8_t bclass[TRE_DFA_NASCII];           /* Byte -> byte class */
+  uint8_t brep[TRE_DFA_NASCII];             /* Byte class -> a byte in it */
+  uint8_t lookahead[TRE_DFA_NASCII];        /* Byte -> TRE_DFA_NEXT_* */
+  uint16_t start[2][TRE_DFA_NNEXT];         /* Initial state per context */
+
+  /* The cache itself is allocated by the first match */
+
+  uint32_t *sets;                           /* TNFA state sets + scratch */
+  uint32_t *hash;                           /* Hash of each state set */
+  uint16_t *next;                           /* Transition table */
+  uint8_t *flags;                           /* TRE_DFA_ACCEPT/DEAD */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* A character of each TRE_DFA_NEXT_* class, as seen by CHECK_ASSERTIONS */
+
+static const tre_char_t g_tre_dfa_next_c[TRE_DFA_NNEXT] =
+{
+  L' ', L'a', L'\n', L'\0', L'\0'
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Returns 1 if the arc `trans_i' consumes `prev_c', ignoring the
+ *  assertions about the position the arc leads to.
+ */
+
+static int tre_dfa_consumes(const tre_tnfa_t *tnfa,
+                            const tre_tnfa_transition_t *trans_i,
+                            tre_char_t prev_c)
+{
+  if (trans_i->code_min > (tre_cint_t)prev_c ||
+      trans_i->code_max < (tre_cint_t)prev_c)
+    {
+      return 0;
+    }
+
+  return !(trans_i->assertions & (ASSERT_CHAR_CLASS |
+                                  ASSERT_CHAR_CLASS_NEG)) ||
+         !CHECK_CHAR_CLASSES(trans_i, tnfa, 0);
+}
+
+/* Group the ASCII bytes into classes that no arc of the TNFA and no
+ *  assertion can tell apart.  The transition table is indexed by class
+ *  instead of by byte, which keeps it small for typical patterns.
+ */
+
+static int tre_dfa_classify(struct tre_dfa_s *dfa)
+{
+  const tre_tnfa_t      *tnfa = dfa->tnfa;
+  tre_tnfa_transition_t *trans;
+  unsigned int          j;
+  int                   nclass = 0;
+  int                   rep;
+  int                   c;
+  int                   i;
+
+  for (c = 1; c < TRE_DFA_NASCII; c++)
+    {
+      for (i = 0; i < nclass; i++)
+        {
+          rep = dfa->brep[i];
+          if (IS_WORD_CHAR(rep) != IS_WORD_CHAR(c) ||
+              (rep == L'\n') != (c == L'\n'))
+            {
+              continue;
+            }
+
+          for (j = 0; j < tnfa->num_transitions; j++)
+            {
+              trans = &tnfa->transitions[j];
+              if (trans->state != NULL &&
+                  tre_dfa_consumes(tnfa, trans, rep) !=
+                  tre_dfa_consumes(tnfa, trans, c))
+                {
+                  break;
+                }
+            }
+
+          if (j == tnfa->num_transitions)
+            {
+              break;
+            }
+        }
+
+      if (i == nclass)
+        {
+          dfa->brep[nclass++] = c;
+        }
+
+      dfa->bclass[c] = i;
+      dfa->lookahead[c] = IS_WORD_CHAR(c) ? TRE_DFA_NEXT_WORD :
+                          c == L'\n' ? TRE_DFA_NEXT_NEWLINE :
+                          TRE_DFA_NEXT_OTHER;
+    }
+
+  return nclass;
+}
+
+/* Allocate the cache in a single block */
+
+static int tre_dfa_alloc(struct tre_dfa_s *dfa)
+{
+  size_t nsets  = (size_t)(CONFIG_LIBC_REGEX_DFA_STATES + 1) * dfa->words;
+  size_t nnext  = (size_t)CONFIG_LIBC_REGEX_DFA_STATES * dfa->stride;
+  char   *buf;
+
+  buf = xmalloc((nsets + CONFIG_LIBC_REGEX_DFA_STATES) * sizeof(uint32_t) +
+                nnext * sizeof(uint16_t) + CONFIG_LIBC_REGEX_DFA_STATES);
+  if (buf == NULL)
+    {
+      return REG_ESPACE;
+    }
+
+  dfa->sets  = (void *)buf;
+  dfa->hash  = dfa->sets + nsets;
+  dfa->next  = (void *)(dfa->hash + CONFIG_LIBC_REGEX_DFA_STATES);
+  dfa->flags = (void *)(dfa->next + nnext);
+  return REG_OK;
+}
+
+/* Compute in `to' the set of TNFA states active after consuming `prev_c'
+ *  from the states in `from' (NULL at the start of the string).  The arcs
+ *  of the initial state are followed as well, since no match has been
+ *  found yet and one may start at this position.
+ */
+
+static void tre_dfa_step(struct tre_dfa_s *dfa, const uint32_t *from,
+                         tre_char_t prev_c, int pos, int reg_notbol,
+                         int next, uint32_t *to)
+{
+  const tre_tnfa_t      *tnfa        = dfa->tnfa;
+  tre_tnfa_transition_t *trans_i;
+  tre_char_t            next_c       = g_tre_dfa_next_c[next];
+  int                   reg_noteol   = next == TRE_DFA_NEXT_NOTEOL;
+  int                   reg_newline  = tnfa->cflags & REG_NEWLINE;
+  int                   id;
+
+  memset(to, 0, dfa->words * sizeof(uint32_t));
+
+  if (from != NULL)
+    {
+      for (id = 0; id < tnfa->num_states; id++)
+        {
+          if (!TRE_DFA_ISSET(from, id))
+            {
+              continue;
+            }
+
+          for (trans_i = dfa->states[id]; trans_i->state; trans_i++)
+            {
+              if (trans_i->code_min <= (tre_cint_t)prev_c &&
+                  trans_i->code_max >= (tre_cint_t)prev_c &&
+                  !(trans_i->assertions &&
+                    (CHECK_ASSERTIONS(trans_i->assertions) ||
+                     CHECK_CHAR_CLASSES(trans_i, tnfa, 0))))
+                {
+                  TRE_DFA_SET(to, trans_i->state_id);
+                }
+            }
+        }
+    }
+
+  for (trans_i = tnfa->initial; trans_i->state; trans_i++)
+    {
+      if (!(trans_i->assertions && CHECK_ASSERTIONS(trans_i->assertions)))
+        {
+          TRE_DFA_SET(to, trans_i->state_id);
+        }
+    }
+}
+
+/* Return the DFA state for the set `set', adding it to the cache if it is
+ *  not there yet.  A full cache is flushed first, which invalidates every
+ *  state number handed out before; `flushes' counts these events.
+ */
+
+static int tre_dfa_state(struct tre_dfa_s *dfa, const uint32_t *set,
+                         int *flushes)
+{
+  size_t   bytes = dfa->words * sizeof(uint32_t);
+  uint32_t hash  = 2166136261u;
+  uint32_t any   = 0;
+  int      i;
+
+  for (i = 0; i < dfa->words; i++)
+    {
+      hash = (hash ^ set[i]) * 16777619u;
+      any |= set[i];
+    }
+
+  for (i = 0; i < dfa->nstates; i++)
+    {
+      if (dfa->hash[i] == hash &&
+          memcmp(dfa->sets + i * dfa->words, set, bytes) == 0)
+        {
+          return i;
+        }
+    }
+
+  if (dfa->nstates == CONFIG_LIBC_REGEX_DFA_STATES)
+    {
+      if (++*flushes > TRE_DFA_MAX_FLUSHES)
+        {
+          return -1;
+        }
+
+      memset(dfa->start, 0xff, sizeof(dfa->start));
+      dfa->nstates = 0;
+    }
+
+  i = dfa->nstates++;
+  memcpy(dfa->sets + i * dfa->words, set, bytes);
+  memset(dfa->next + i * dfa->stride, 0xff,
+         dfa->stride * sizeof(uint16_t));
+  dfa->hash[i]  = hash;
+  dfa->flags[i] = 0;
+
+  if (TRE_DFA_ISSET(set, dfa->final))
+    {
+      dfa->flags[i] |= TRE_DFA_ACCEPT;
+    }
+
+  if (any == 0 && dfa->anchored)
+    {
+      dfa->flags[i] |= TRE_DFA_DEAD;
+    }
+
+  return i;
+}
+
+/* Classify the character after the one being consumed */
+
+static int tre_dfa_next(const struct tre_dfa_s *dfa, unsigned char c,
+                        int eflags)
+{
+  if (c >= TRE_DFA_NASCII)
+    {
+      return -1;
+    }
+  else if (dfa->nnext == 1)
+    {
+      return TRE_DFA_NEXT_OTHER;
+    }
+  else if (c == '\0')
+    {
+      return eflags & REG_NOTEOL ? TRE_DFA_NEXT_NOTEOL : TRE_DFA_NEXT_END;
+    }
+
+  return dfa->lookahead[c];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Prepare a DFA cache for `tnfa'.  Returns NULL if the TNFA is not suitable
+ *  or out of memory, regexec() then always uses the TNFA matchers.
+ */
+
+struct tre_dfa_s *tre_dfa_new(const tre_tnfa_t *tnfa)
+{
+  struct tre_dfa_s      *dfa;
+  tre_tnfa_transition_t *trans;
+  unsigned int          i;
+  int                   id;
+
+  if (tnfa->have_backrefs || tnfa->num_states <= 0)
+    {
+      return NULL;
+    }
+
+  dfa = xcalloc(1, sizeof(*dfa));
+  if (dfa == NULL)
+    {
+      return NULL;
+    }
+
+  dfa->states = xcalloc(tnfa->num_states, sizeof(*dfa->states));
+  if (dfa->states == NULL)
+    {
+      xfree(dfa);
+      return NULL;
+    }
+
+  dfa->tnfa     = tnfa;
+  dfa->final    = -1;
+  dfa->words    = (tnfa->num_states + 31) / 32;
+  dfa->nnext    = 1;
+  dfa->anchored = !(tnfa->cflags & REG_NEWLINE);
+
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state != NULL)
+        {
+          dfa->states[trans->state_id] = trans->state;
+          if (trans->assertions & TRE_DFA_LOOKAHEAD)
+            {
+              dfa->nnext = TRE_DFA_NNEXT;
+            }
+        }
+    }
+
+  for (trans = tnfa->initial; trans->state; trans++)
+    {
+      dfa->states[trans->state_id] = trans->state;
+      if (trans->assertions & TRE_DFA_LOOKAHEAD)
+        {
+          dfa->nnext = TRE_DFA_NNEXT;
+        }
+
+      if (!(trans->assertions & ASSERT_AT_BOL))
+        {
+          dfa->anchored = false;
+        }
+    }
+
+  for (id = 0; id < tnfa->num_states; id++)
+    {
+      if (dfa->states[id] == tnfa->final)
+        {
+          dfa->final = id;
+        }
+    }
+
+  if (dfa->final < 0)
+    {
+      xfree(dfa->states);
+      xfree(dfa);
+      return NULL;
+    }
+
+  dfa->stride = tre_dfa_classify(dfa) * dfa->nnext;
+  memset(dfa->start, 0xff, sizeof(dfa->start));
+  nxmutex_init(&dfa->lock);
+  return dfa;
+}
+
+void tre_dfa_free(struct tre_dfa_s *dfa)
+{
+  if (dfa == NULL)
+    {
+      return;
+    }
+
+  nxmutex_destroy(&dfa->lock);
+  if (dfa->sets != NULL)
+    {
+      xfree(dfa->sets);
+    }
+
+  xfree(dfa->states);
+  xfree(dfa);
+}
+
+/* Returns REG_OK if `string' contains a match, REG_NOMATCH if it does not
+ *  and TRE_DFA_FALLBACK if the caller has to run the TNFA instead.
+ */
+
+int tre_dfa_match(struct tre_dfa_s *dfa, const char *string, int eflags)
+{
+  const unsigned char *str       = (const unsigned char *)string;
+  int                 reg_notbol = !!(eflags & REG_NOTBOL);
+  int                 flushes    = 0;
+  int                 ret        = TRE_DFA_FALLBACK;
+  uint32_t            *scratch;
+  uint16_t            *edge;
+  int                 state;
+  int                 next;
+  int                 last;
+  int                 c;
+
+  if (nxmutex_trylock(&dfa->lock) < 0)
+    {
+      return TRE_DFA_FALLBACK;
+    }
+
+  if (dfa->sets == NULL && tre_dfa_alloc(dfa) != REG_OK)
+    {
+      goto out;
+    }
+
+  scratch = dfa->sets + CONFIG_LIBC_REGEX_DFA_STATES * dfa->words;
+
+  next = tre_dfa_next(dfa, str[0], eflags);
+  if (next < 0)
+    {
+      goto out;
+    }
+
+  state = dfa->start[reg_notbol][next];
+  if (state == TRE_DFA_UNKNOWN)
+    {
+      tre_dfa_step(dfa, NULL, L'\0', 0, reg_notbol, next, scratch);
+      state = tre_dfa_state(dfa, scratch, &flushes);
+      if (state < 0)
+        {
+          goto out;
+        }
+
+      dfa->start[reg_notbol][next] = state;
+    }
+
+  for (; ; )
+    {
+      if (dfa->flags[state] & TRE_DFA_ACCEPT)
+        {
+          ret = REG_OK;
+          break;
+        }
+
+      if (*str == '\0' || (dfa->flags[state] & TRE_DFA_DEAD))
+        {
+          ret = REG_NOMATCH;
+          break;
+        }
+
+      c    = *str++;
+      next = tre_dfa_next(dfa, *str, eflags);
+      if (next < 0)
+        {
+          break;
+        }
+
+      edge = &dfa->next[state * dfa->stride +
+                        dfa->bclass[c] * dfa->nnext + next];
+      if (*edge != TRE_DFA_UNKNOWN)
+        {
+          state = *edge;
+          continue;
+        }
+
+      tre_dfa_step(dfa, dfa->sets + state * dfa->words,
+                   dfa->brep[dfa->bclass[c]], 1, reg_notbol, next, scratch);
+
+      last  = flushes;
+      state = tre_dfa_state(dfa, scratch, &flushes);
+      if (state < 0)
+        {
+          break;
+        }
+
+      if (last == flushes)
+        {
+          *edge = state;
+        }
+    }
+
+out:
+  nxmutex_unlock(&dfa->lock);
+  return ret;
+}
@@ -159,6 +159,42 @@ struct tnfa_transition
 #define ASSERT_BACKREF          256 /* A back reference in `backref' */
 #define ASSERT_LAST             256
 
+/* Assertion checks shared by the matchers.  They expect `pos', `prev_c',
+ *  `next_c', `reg_notbol', `reg_noteol' and `reg_newline' in scope.
+ */
+
+#define IS_WORD_CHAR(c)     ((c) == L'_' || tre_isalnum(c))
+
+#define CHECK_ASSERTIONS(assertions)                         \
+  (((assertions & ASSERT_AT_BOL)                             \
+    && (pos > 0 || reg_notbol)                               \
+    && (prev_c != L'\n' || !reg_newline))                    \
+   || ((assertions & ASSERT_AT_EOL)                          \
+       && (next_c != L'\0' || reg_noteol)                    \
+       && (next_c != L'\n' || !reg_newline))                 \
+   || ((assertions & ASSERT_AT_BOW)                          \
+       && (IS_WORD_CHAR(prev_c) || !IS_WORD_CHAR(next_c)))   \
+   || ((assertions & ASSERT_AT_EOW)                          \
+       && (!IS_WORD_CHAR(prev_c) || IS_WORD_CHAR(next_c)))   \
+   || ((assertions & ASSERT_AT_WB)                           \
+       && (pos != 0 && next_c != L'\0'                       \
+           && IS_WORD_CHAR(prev_c) == IS_WORD_CHAR(next_c))) \
+   || ((assertions & ASSERT_AT_WB_NEG)                       \
+       && (pos == 0 || next_c == L'\0'                       \
+           || IS_WORD_CHAR(prev_c) != IS_WORD_CHAR(next_c))))
+
+#define CHECK_CHAR_CLASSES(trans_i, tnfa, eflags)                              \
+  (((trans_i->assertions & ASSERT_CHAR_CLASS)                                  \
+    && !(tnfa->cflags & REG_ICASE)                                             \
+    && !tre_isctype((tre_cint_t)prev_c, trans_i->u.class))                     \
+   || ((trans_i->assertions & ASSERT_CHAR_CLASS)                               \
+       && (tnfa->cflags & REG_ICASE)                                           \
+       && !tre_isctype(tre_tolower((tre_cint_t)prev_c), trans_i->u.class)      \
+       && !tre_isctype(tre_toupper((tre_cint_t)prev_c), trans_i->u.class))     \
+   || ((trans_i->assertions & ASSERT_CHAR_CLASS_NEG)                           \
+       && tre_neg_char_classes_match(trans_i->neg_classes, (tre_cint_t)prev_c, \
+                                     tnfa->cflags & REG_ICASE)))
+
 /* Tag directions. */
 
 typedef enum
@@ -211,6 +247,9 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+#ifdef CONFIG_LIBC_REGEX_DFA
+  struct tre_dfa_s *dfa;
+#endif
 };
 
 /* from tre-mem.h: */
@@ -278,6 +317,31 @@ void *tre_mem_alloc_impl(tre_mem_t mem, int provided, void *provided_block,
 
 void tre_mem_destroy(tre_mem_t mem);
 
+/* from regexec.c */
+
+#define tre_neg_char_classes_match  __tre_neg_char_classes_match
+
+int tre_neg_char_classes_match(tre_ctype_t *classes, tre_cint_t wc,
+                               int icase);
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+
+/* from tre-dfa.c: lazily built DFA used by regexec() to decide whether a
+ * regexp without back references matches at all.
+ */
+
+#define TRE_DFA_FALLBACK    (-2)  /* The DFA cannot answer, run the TNFA */
+
+#define tre_dfa_new         __tre_dfa_new
+#define tre_dfa_free        __tre_dfa_free
+#define tre_dfa_match       __tre_dfa_match
+
+struct tre_dfa_s *tre_dfa_new(const tre_tnfa_t *tnfa);
+void tre_dfa_free(struct tre_dfa_s *dfa);
+int tre_dfa_match(struct tre_dfa_s *dfa, const char *string, int eflags);
+
+#endif /* CONFIG_LIBC_REGEX_DFA */
+
 #define xmalloc     malloc
 #define xcalloc     calloc
 #define xfree       free
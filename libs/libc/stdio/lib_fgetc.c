@@ -55,9 +55,9 @@ int fgetc(FAR FILE *stream)
 {
   int ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fgetc_unlocked(stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
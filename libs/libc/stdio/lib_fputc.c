@@ -66,9 +66,9 @@ int fputc(int c, FAR FILE *stream)
 {
   int ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fputc_unlocked(c, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
@@ -102,9 +102,9 @@ wint_t fputwc_unlocked(wchar_t c, FAR FILE *f)
 
 wint_t fputwc(wchar_t c, FAR FILE *f)
 {
-  flockfile(f);
+  lib_flockfile(f);
   wint_t wc = fputwc_unlocked(c, f);
-  funlockfile(f);
+  lib_funlockfile(f);
   return wc;
 }
 
@@ -105,7 +105,7 @@ FAR FILE *freopen(FAR const char *path, FAR const char *mode,
 
       /* Make sure that we have exclusive access to the stream */
 
-      flockfile(stream);
+      lib_flockfile(stream);
 
       /* Flush the stream and invalidate the read buffer. */
 
@@ -115,7 +115,7 @@ FAR FILE *freopen(FAR const char *path, FAR const char *mode,
       lib_rdflush_unlocked(stream);
 #endif
 
-      funlockfile(stream);
+      lib_funlockfile(stream);
 
       /* Duplicate the new fd to the stream. */
 
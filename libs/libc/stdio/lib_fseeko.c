@@ -71,14 +71,14 @@ int fseeko(FAR FILE *stream, off_t offset, int whence)
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
   /* Flush any valid read/write data in the buffer (also verifies stream) */
 
-  flockfile(stream);
+  lib_flockfile(stream);
   if (lib_rdflush_unlocked(stream) < 0 || lib_wrflush_unlocked(stream) < 0)
     {
-      funlockfile(stream);
+      lib_funlockfile(stream);
       return ERROR;
     }
 
-  funlockfile(stream);
+  lib_funlockfile(stream);
 #endif
 
   /* On success or failure, discard any characters saved by ungetc() */
@@ -55,7 +55,7 @@
 static off_t lib_getoffset(FAR FILE *stream)
 {
   off_t offset = 0;
-  flockfile(stream);
+  lib_flockfile(stream);
 
   if (stream->fs_bufstart !=
       NULL && stream->fs_bufread !=
@@ -73,7 +73,7 @@ static off_t lib_getoffset(FAR FILE *stream)
       offset = -(stream->fs_bufpos - stream->fs_bufstart);
     }
 
-  funlockfile(stream);
+  lib_funlockfile(stream);
   return offset;
 }
 #else
@@ -64,9 +64,9 @@ size_t fwrite(FAR const void *ptr, size_t size, size_t n_items,
 {
   size_t ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = fwrite_unlocked(ptr, size, n_items, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
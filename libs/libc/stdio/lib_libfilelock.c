@@ -31,10 +31,13 @@
 #include <unistd.h>
 #include <errno.h>
 #include <assert.h>
+#include <stdio_ext.h>
 
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,3 +68,51 @@ void funlockfile(FAR struct file_struct *stream)
 {
   nxrmutex_unlock(&stream->fs_lock);
 }
+
+/****************************************************************************
+ * __fsetlocking
+ *
+ * Description:
+ *   With FSETLOCKING_BYCALLER the stdio functions stop locking the stream
+ *   on every call; the caller promises to use the stream from one thread
+ *   or to bracket the accesses with flockfile()/funlockfile() itself.
+ *   Returns the previous mode.
+ *
+ ****************************************************************************/
+
+int __fsetlocking(FAR struct file_struct *stream, int type)
+{
+  int prev = (stream->fs_flags & __FS_FLAG_BYCALLER) != 0 ?
+             FSETLOCKING_BYCALLER : FSETLOCKING_INTERNAL;
+
+  if (type == FSETLOCKING_BYCALLER)
+    {
+      stream->fs_flags |= __FS_FLAG_BYCALLER;
+    }
+  else if (type == FSETLOCKING_INTERNAL)
+    {
+      stream->fs_flags &= ~__FS_FLAG_BYCALLER;
+    }
+
+  return prev;
+}
+
+/****************************************************************************
+ * lib_flockfile / lib_funlockfile
+ ****************************************************************************/
+
+void lib_flockfile(FAR struct file_struct *stream)
+{
+  if ((stream->fs_flags & __FS_FLAG_BYCALLER) == 0)
+    {
+      nxrmutex_lock(&stream->fs_lock);
+    }
+}
+
+void lib_funlockfile(FAR struct file_struct *stream)
+{
+  if ((stream->fs_flags & __FS_FLAG_BYCALLER) == 0)
+    {
+      nxrmutex_unlock(&stream->fs_lock);
+    }
+}
@@ -53,6 +53,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
   FAR const char *src   = ptr;
   ssize_t ret = ERROR;
   size_t gulp_size;
+  size_t bufsize;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -102,11 +103,25 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
       goto errout;
     }
 
-  /* Determine the number of bytes left in the buffer */
+  /* A block at least the size of the buffer gains nothing from being
+   * copied: push out what is pending and hand the block to the file in
+   * one write.
+   */
 
-  gulp_size = stream->fs_bufend - stream->fs_bufpos;
-  if (gulp_size != CONFIG_STDIO_BUFFER_SIZE || count < gulp_size)
+  bufsize = stream->fs_bufend - stream->fs_bufstart;
+  if (count >= bufsize)
+    {
+      if (stream->fs_bufpos != stream->fs_bufstart &&
+          lib_fflush_unlocked(stream) < 0)
+        {
+          goto errout;
+        }
+    }
+  else
     {
+      /* Determine the number of bytes left in the buffer */
+
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
       if (gulp_size > count)
         {
           /* Yes, clip the gulp to the size of the user data */
@@ -140,7 +155,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
         }
     }
 
-  if (count >= CONFIG_STDIO_BUFFER_SIZE)
+  if (count >= bufsize)
     {
       if (stream->fs_iofunc.write != NULL)
         {
@@ -205,9 +220,9 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 {
   ssize_t ret;
 
-  flockfile(stream);
+  lib_flockfile(stream);
   ret = lib_fwrite_unlocked(ptr, count, stream);
-  funlockfile(stream);
+  lib_funlockfile(stream);
 
   return ret;
 }
@@ -194,6 +194,30 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifndef CONFIG_ARCH_ROMGETC
+          /* Hand a run of literal text to the stream in one call instead
+           * of one putc per character.
+           */
+
+          pnt = fmt;
+          while (*fmt != '\0' && *fmt != '%')
+            {
+              fmt++;
+            }
+
+          if (fmt != pnt)
+            {
+#ifdef CONFIG_LIBC_NUMBERED_ARGS
+              if (stream != NULL)
+                {
+                  stream_puts(pnt, fmt - pnt, stream);
+                }
+#else
+              stream_puts(pnt, fmt - pnt, stream);
+#endif
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -1313,9 +1337,25 @@ str_lpad:
           prec--;
         }
 
-      while (c)
+      if (c > 1)
+        {
+          /* The digits are in reverse order, turn them around and write
+           * them with one puts.
+           */
+
+          for (len = 0; len < c / 2; len++)
+            {
+              char t = buf[len];
+
+              buf[len] = buf[c - 1 - len];
+              buf[c - 1 - len] = t;
+            }
+
+          stream_puts(buf, c, stream);
+        }
+      else if (c)
         {
-          stream_putc(buf[--c], stream);
+          stream_putc(buf[0], stream);
         }
 
 tail:
@@ -52,7 +52,7 @@ int puts(FAR const IPTR char *s)
 
   /* Write the string (the next two steps must be atomic) */
 
-  flockfile(stream);
+  lib_flockfile(stream);
 
   /* Write the string without its trailing '\0' */
 
@@ -82,7 +82,7 @@ int puts(FAR const IPTR char *s)
         }
     }
 
-  funlockfile(stdout);
+  lib_funlockfile(stdout);
   return nput;
 #else
   size_t len = strlen(s);
@@ -33,6 +33,8 @@
 #include <stdio.h>
 #include <wchar.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -75,11 +77,11 @@ wint_t putwchar(wchar_t c)
   wint_t w;
 
 #ifdef CONFIG_FILE_STREAM
-  flockfile(stdout);
+  lib_flockfile(stdout);
 #endif
   w = putwchar_unlocked(c);
 #ifdef CONFIG_FILE_STREAM
-  funlockfile(stdout);
+  lib_funlockfile(stdout);
 #endif
 
   return w;
@@ -39,6 +39,26 @@
 
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Two decimal digits per entry, so that a decimal conversion needs one
+ * division per pair of digits instead of one per digit.
+ */
+
+static const char g_digit_pairs[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -50,6 +70,7 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 #endif
 {
   int upper = 0;
+  int shift;
 
   if (base & XTOA_UPPER)
     {
@@ -57,6 +78,48 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
       base &= ~XTOA_UPPER;
     }
 
+  if (base == 10)
+    {
+      while (val >= 100)
+        {
+          unsigned int v = val % 100;
+
+          val   /= 100;
+          *str++ = g_digit_pairs[2 * v + 1];
+          *str++ = g_digit_pairs[2 * v];
+        }
+
+      if (val >= 10)
+        {
+          *str++ = g_digit_pairs[2 * val + 1];
+          *str++ = g_digit_pairs[2 * val];
+        }
+      else
+        {
+          *str++ = '0' + val;
+        }
+
+      return str;
+    }
+
+  /* Octal and hex don't need a division at all */
+
+  shift = base == 16 ? 4 : base == 8 ? 3 : base == 2 ? 1 : 0;
+  if (shift != 0)
+    {
+      FAR const char *digits = upper ? "0123456789ABCDEF" :
+                                       "0123456789abcdef";
+
+      do
+        {
+          *str++ = digits[val & (base - 1)];
+          val  >>= shift;
+        }
+      while (val);
+
+      return str;
+    }
+
   do
     {
       int v;
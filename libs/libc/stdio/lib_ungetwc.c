@@ -35,6 +35,8 @@
 #include <fcntl.h>
 #include <string.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_FILE_STREAM
 
 /****************************************************************************
@@ -117,9 +119,9 @@ wint_t ungetwc(wint_t wc, FAR FILE *f)
       return WEOF;
     }
 
-  flockfile(f);
+  lib_flockfile(f);
   ret = ungetwc_unlocked(wc, f);
-  funlockfile(f);
+  lib_funlockfile(f);
   return ret;
 }
 
@@ -48,12 +48,21 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Swap strategies, chosen once per call from the width and alignment */
+
+#define SWAP_LONG       0  /* One long */
+#define SWAP_LONGS      1  /* A multiple of long */
+#define SWAP_INTS       2  /* A multiple of uint32_t, e.g. 4 bytes on LP64 */
+#define SWAP_BYTES      3  /* Anything else */
+
 #define swapcode(TYPE, parmi, parmj, n) \
   { \
     long i = (n) / sizeof(TYPE); \
@@ -67,11 +76,13 @@
   }
 
 #define SWAPINIT(a, width) \
-  swaptype = (uintptr_t)a % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long) ? 0 : 1;
+  swaptype = ((uintptr_t)(a) | (width)) % sizeof(long) == 0 ? \
+             ((width) == sizeof(long) ? SWAP_LONG : SWAP_LONGS) : \
+             ((uintptr_t)(a) | (width)) % sizeof(uint32_t) == 0 ? \
+             SWAP_INTS : SWAP_BYTES;
 
 #define swap(a, b) \
-  if (swaptype == 0) \
+  if (swaptype == SWAP_LONG) \
     { \
       long t = *(FAR long *)(a); \
       *(FAR long *)(a) = *(FAR long *)(b); \
@@ -84,25 +95,40 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+/* Below this many elements insertion sort beats partitioning */
+
+#define QSORT_SMALL     7
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*compar_t)(FAR const void *, FAR const void *);
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
+static inline void swapfunc(FAR char *a, FAR char *b, size_t n,
+                            int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+                             compar_t compar);
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+static inline void swapfunc(FAR char *a, FAR char *b, size_t n,
+                            int swaptype)
 {
-  if (swaptype <= 1)
+  if (swaptype <= SWAP_LONGS)
     {
       swapcode(long, a, b, n)
     }
+  else if (swaptype == SWAP_INTS)
+    {
+      swapcode(uint32_t, a, b, n)
+    }
   else
     {
       swapcode(char, a, b, n)
@@ -110,8 +136,7 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             compar_t compar)
 {
   return compar(a, b) < 0 ?
          (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
@@ -119,50 +144,94 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
- ****************************************************************************/
-
-/****************************************************************************
- * Name: qsort
+ * Name: insertion_sort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
+ *   Insertion sort that gives up after 'limit' element moves, so that a
+ *   range that only looked sorted can't turn it quadratic.
  *
  * Returned Value:
- *   The qsort() function will not return a value.
+ *   true if the range is sorted, false if the limit was hit.
+ *
+ ****************************************************************************/
+
+static bool insertion_sort(FAR char *base, size_t nel, size_t width,
+                           compar_t compar, int swaptype, size_t limit)
+{
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          if (limit-- == 0)
+            {
+              return false;
+            }
+
+          swap(pl, pl - width);
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: heap_sort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   The fallback once the partitioning has gone too deep.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void sift_down(FAR char *base, size_t root, size_t nel, size_t width,
+                      compar_t compar, int swaptype)
+{
+  size_t child;
+
+  while ((child = 2 * root + 1) < nel)
+    {
+      if (child + 1 < nel &&
+          compar(base + child * width, base + (child + 1) * width) < 0)
+        {
+          child++;
+        }
+
+      if (compar(base + root * width, base + child * width) >= 0)
+        {
+          break;
+        }
+
+      swap(base + root * width, base + child * width);
+      root = child;
+    }
+}
+
+static void heap_sort(FAR char *base, size_t nel, size_t width,
+                      compar_t compar, int swaptype)
+{
+  size_t i;
+
+  for (i = nel / 2; i-- > 0; )
+    {
+      sift_down(base, i, nel, width, compar, swaptype);
+    }
+
+  for (i = nel - 1; i > 0; i--)
+    {
+      swap(base, base + i * width);
+      sift_down(base, 0, i, width, compar, swaptype);
+    }
+}
+
+/****************************************************************************
+ * Name: intro_sort
+ ****************************************************************************/
+
+static void intro_sort(FAR char *base, size_t nel, size_t width,
+                       compar_t compar, int swaptype, int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -171,37 +240,31 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
+  size_t lsize;
+  size_t rsize;
+  size_t d;
   int swap_cnt;
-  int d;
   int r;
 
 loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
-
-  if (nel < 7)
+  if (nel < QSORT_SMALL)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
+      insertion_sort(base, nel, width, compar, swaptype, SIZE_MAX);
+      return;
+    }
 
+  if (depth-- == 0)
+    {
+      heap_sort(base, nel, width, compar, swaptype);
       return;
     }
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
+  swap_cnt = 0;
+  pm = base + (nel / 2) * width;
+  if (nel > QSORT_SMALL)
     {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
+      pn = base + (nel - 1) * width;
       if (nel > 40)
         {
           d  = (nel / 8) * width;
@@ -214,9 +277,9 @@ loop:
     }
 
   swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  pa = pb = base + width;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
+  pc = pd = base + (nel - 1) * width;
   for (; ; )
     {
       while (pb <= pc && (r = compar(pb, base)) <= 0)
@@ -256,41 +319,127 @@ loop:
 
   if (swap_cnt == 0)
     {
-      /* Switch to insertion sort */
+      /* Nothing moved, the range is likely presorted.  Try insertion sort
+       * but with a linear budget; an adversarial input that merely looks
+       * sorted to the partition gets partitioned again instead.
+       */
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (insertion_sort(base, nel, width, compar, swaptype, nel))
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          return;
         }
 
-      return;
+      goto loop;
     }
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+  pn = base + nel * width;
+  lsize = MIN(pa - base, pb - pa);
+  vecswap(base, pb - lsize, lsize);
+
+  rsize = MIN(pd - pc, pn - pd - width);
+  vecswap(pb, pn - rsize, rsize);
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+  /* Recurse into the smaller side and iterate on the larger one, which
+   * bounds the stack to O(log n).
+   */
 
-  if ((r = pb - pa) > width)
+  lsize = pb - pa;
+  rsize = pd - pc;
+  if (lsize < rsize)
     {
-      qsort(base, r / width, width, compar);
+      if (lsize > width)
+        {
+          intro_sort(base, lsize / width, width, compar, swaptype, depth);
+        }
+
+      if (rsize > width)
+        {
+          base = pn - rsize;
+          nel  = rsize / width;
+          goto loop;
+        }
     }
+  else
+    {
+      if (rsize > width)
+        {
+          intro_sort(pn - rsize, rsize / width, width, compar, swaptype,
+                     depth);
+        }
+
+      if (lsize > width)
+        {
+          nel = lsize / width;
+          goto loop;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes:
+ *   The partitioning is Bentley & McIlroy's from "Engineering a Sort
+ *   Function" (the original BSD version).  It is bounded by a depth limit
+ *   of 2 * log2(nel) partitioning rounds after which the remainder is
+ *   heap sorted, so the worst case is O(n log n) and the stack depth is
+ *   O(log n).
+ *
+ ****************************************************************************/
 
-  if ((r = pd - pc) > width)
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int swaptype;
+  int depth = 0;
+
+  if (nel < 2 || width == 0)
     {
-      /* Iterate rather than recurse to save stack space */
+      return;
+    }
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  SWAPINIT(base, width);
+
+  for (n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  intro_sort(base, nel, width, compar, swaptype, depth);
 }
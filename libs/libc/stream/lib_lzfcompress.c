@@ -43,18 +43,22 @@ static int lzfoutstream_flush(FAR struct lib_outstream_s *self)
                                  (FAR struct lib_lzfoutstream_s *)self;
   FAR struct lzf_header_s *header;
   size_t outlen;
+  ssize_t ret;
 
   if (stream->offset > 0)
     {
       outlen = lzf_compress(stream->in, stream->offset,
                             &stream->out[LZF_MAX_HDR_SIZE],
                             stream->offset, stream->state, &header);
+      stream->offset = 0;
       if (outlen > 0)
         {
-          lib_stream_puts(stream->backend, header, outlen);
+          ret = lib_stream_puts(stream->backend, header, outlen);
+          if (ret < 0)
+            {
+              return ret;
+            }
         }
-
-      stream->offset = 0;
     }
 
   return lib_stream_flush(stream->backend);
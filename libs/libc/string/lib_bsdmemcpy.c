@@ -24,6 +24,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include <nuttx/mm/kasan.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -58,6 +60,7 @@
 #if !defined(CONFIG_LIBC_ARCH_MEMCPY) && defined(LIBC_BUILD_MEMCPY)
 #undef memcpy /* See mm/README.txt */
 no_builtin("memcpy")
+nosanitize_address
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR char *pout = dest;
@@ -65,6 +68,9 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
   FAR long *paligned_out;
   FAR const long *paligned_in;
 
+  kasan_check_range(src, n, false);
+  kasan_check_range(dest, n, true);
+
   /* If the size is small, or either pin or pout is unaligned,
    * then punt into the byte copy loop.  This should be rare.
    */
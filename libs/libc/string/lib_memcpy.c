@@ -28,6 +28,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include <nuttx/mm/kasan.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -41,10 +43,15 @@
 #if !defined(CONFIG_LIBC_ARCH_MEMCPY) && defined(LIBC_BUILD_MEMCPY)
 #undef memcpy /* See mm/README.txt */
 no_builtin("memcpy")
+nosanitize_address
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+  kasan_check_range(src, n, false);
+  kasan_check_range(dest, n, true);
+
   while (n-- > 0)
     {
       *pout++ = *pin++;
@@ -28,6 +28,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include <nuttx/mm/kasan.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -37,6 +39,7 @@
 #if !defined(CONFIG_LIBC_ARCH_MEMMOVE) && defined(LIBC_BUILD_MEMMOVE)
 #undef memmove /* See mm/README.txt */
 no_builtin("memmove")
+nosanitize_address
 FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
 {
   FAR char *tmp;
@@ -48,6 +51,9 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
     }
   else
     {
+      kasan_check_range(src, count, false);
+      kasan_check_range(dest, count, true);
+
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
@@ -37,6 +37,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <nuttx/mm/kasan.h>
+
 #include "libc.h"
 
 #if !defined(CONFIG_LIBC_ARCH_MEMCPY) && defined(LIBC_BUILD_MEMCPY)
@@ -285,11 +287,15 @@ typedef uint32_t            uintn;
  ****************************************************************************/
 
 no_builtin("memcpy")
+nosanitize_address
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t count)
 {
   FAR uint8_t *dst8 = (FAR uint8_t *)dest;
   FAR uint8_t *src8 = (FAR uint8_t *)src;
 
+  kasan_check_range(src, count, false);
+  kasan_check_range(dest, count, true);
+
   if (count < 8)
     {
       COPY_REMAINING(count);
@@ -24,7 +24,12 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
 #include <nuttx/allsyms.h>
+#include <nuttx/mutex.h>
 #include <nuttx/symtab.h>
 
 /****************************************************************************
@@ -34,6 +39,60 @@
 extern const struct symtab_s g_allsyms[];
 extern const int             g_nallsyms;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASH
+/* g_allsyms[] is ordered by value, so name lookups go through a hash index
+ * built on the first one.
+ */
+
+static mutex_t g_allsyms_lock = NXMUTEX_INITIALIZER;
+static struct symtab_hash_s g_allsyms_hash;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: allsyms_findhashed
+ *
+ * Description:
+ *   Look a name up through the hash index.
+ *
+ * Returned Value:
+ *   false if the index is not available and a search is needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASH
+static bool allsyms_findhashed(FAR const char *name,
+                               FAR const struct symtab_s **symbol)
+{
+  bool hashed = false;
+
+  if (nxmutex_lock(&g_allsyms_lock) >= 0)
+    {
+      if (g_allsyms_hash.nbuckets == 0)
+        {
+          symtab_hashinit(&g_allsyms_hash, g_allsyms, g_nallsyms);
+        }
+
+      if (g_allsyms_hash.nbuckets > 0)
+        {
+          *symbol = symtab_hashfind(&g_allsyms_hash, name);
+          hashed  = true;
+        }
+
+      nxmutex_unlock(&g_allsyms_lock);
+    }
+
+  return hashed;
+}
+#endif
+
 /****************************************************************************
  * Name: allsyms_lookup
  *
@@ -54,7 +113,12 @@ allsyms_lookup(FAR const char *name, FAR void *value,
 
   if (name)
     {
-      symbol = symtab_findbyname(g_allsyms, name, g_nallsyms);
+#ifdef CONFIG_SYMTAB_HASH
+      if (!allsyms_findhashed(name, &symbol))
+#endif
+        {
+          symbol = symtab_findbyname(g_allsyms, name, g_nallsyms);
+        }
     }
   else if (value)
     {
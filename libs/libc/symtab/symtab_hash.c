@@ -0,0 +1,212 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   The hash function of DT_GNU_HASH (Bernstein's h * 33 + c).
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hash(FAR const char *name)
+{
+  uint32_t h = 5381;
+
+  while (*name != '\0')
+    {
+      h = (h << 5) + h + (uint8_t)*name++;
+    }
+
+  return h;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index over an existing symbol table.
+ *
+ ****************************************************************************/
+
+int symtab_hashinit(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR uint32_t *hashes;
+  uint32_t nbuckets;
+  uint32_t b;
+  int i;
+
+  DEBUGASSERT(hash != NULL && (symtab != NULL || nsyms == 0));
+
+  memset(hash, 0, sizeof(*hash));
+  if (nsyms <= 0)
+    {
+      return OK;
+    }
+
+  /* Around two symbols per bucket, a power of two to mask instead of
+   * divide.
+   */
+
+  nbuckets = 1;
+  while (nbuckets < (uint32_t)nsyms / 2)
+    {
+      nbuckets <<= 1;
+    }
+
+  /* One allocation: the bucket offsets, the slot hashes and indices, and
+   * the hash of every symbol as scratch while building.
+   */
+
+  hash->buckets = lib_malloc(sizeof(uint32_t) * (nbuckets + 1 + 3 * nsyms));
+  if (hash->buckets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hash->chain  = hash->buckets + nbuckets + 1;
+  hash->index  = hash->chain + nsyms;
+  hashes       = hash->index + nsyms;
+
+  memset(hash->buckets, 0, sizeof(uint32_t) * (nbuckets + 1));
+
+  /* Count the symbols of each bucket, turn the counts into the offset of
+   * each chain, then drop every symbol into its chain so that the chain
+   * of bucket b is the slots buckets[b] .. buckets[b + 1] - 1.
+   */
+
+  for (i = 0; i < nsyms; i++)
+    {
+      hashes[i] = symtab_hash(symtab[i].sym_name);
+      hash->buckets[(hashes[i] & (nbuckets - 1)) + 1]++;
+    }
+
+  for (b = 0; b < nbuckets; b++)
+    {
+      hash->buckets[b + 1] += hash->buckets[b];
+    }
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      b = --hash->buckets[(hashes[i] & (nbuckets - 1)) + 1];
+      hash->chain[b] = hashes[i];
+      hash->index[b] = i;
+    }
+
+  /* The decrements left buckets[b + 1] at the start of chain b */
+
+  memmove(hash->buckets, hash->buckets + 1, sizeof(uint32_t) * nbuckets);
+  hash->buckets[nbuckets] = nsyms;
+
+  hash->symtab   = symtab;
+  hash->nsyms    = nsyms;
+  hash->nbuckets = nbuckets;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hashfind
+ *
+ * Description:
+ *   Find a symbol through a hash index built by symtab_hashinit().
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hashfind(FAR const struct symtab_hash_s *hash, FAR const char *name)
+{
+  FAR const struct symtab_s *symbol;
+  uint32_t h;
+  uint32_t i;
+  uint32_t end;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+  if (hash->nbuckets == 0)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  h   = symtab_hash(name);
+  i   = hash->buckets[h & (hash->nbuckets - 1)];
+  end = hash->buckets[(h & (hash->nbuckets - 1)) + 1];
+
+  /* Only a full hash match is worth a string compare */
+
+  for (; i < end; i++)
+    {
+      if (hash->chain[i] == h)
+        {
+          symbol = &hash->symtab[hash->index[i]];
+          if (strcmp(name, symbol->sym_name) == 0)
+            {
+              return symbol;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: symtab_hashfree
+ *
+ * Description:
+ *   Release a hash index.  The symbol table itself is not touched.
+ *
+ ****************************************************************************/
+
+void symtab_hashfree(FAR struct symtab_hash_s *hash)
+{
+  lib_free(hash->buckets);
+  memset(hash, 0, sizeof(*hash));
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <arch/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/vdso.h>
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Read CLOCK_MONOTONIC, CLOCK_BOOTTIME and CLOCK_REALTIME from the clock
+ *   data page mapped by the kernel, without a system call.  The other
+ *   clocks, and all of them until the kernel has validated the page, are
+ *   read with the nx_clock_gettime() system call.
+ *
+ * Input Parameters:
+ *   clock_id - The clock to read
+ *   tp       - The location to return the time
+ *
+ * Returned Value:
+ *   Zero (OK) on success; ERROR with errno set on failure.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const struct vdso_data_s *vdso = VDSO_DATA;
+  struct timespec base;
+  unsigned long elapsed;
+  unsigned long freq;
+  uint32_t seq;
+
+  if (tp == NULL || (clock_id != CLOCK_MONOTONIC &&
+                     clock_id != CLOCK_BOOTTIME &&
+                     clock_id != CLOCK_REALTIME))
+    {
+      return nx_clock_gettime(clock_id, tp);
+    }
+
+  do
+    {
+      seq  = read_seqcount_begin(&vdso->seq);
+      freq = vdso->freq;
+      base = vdso->monotonic;
+      if (clock_id == CLOCK_REALTIME)
+        {
+          clock_timespec_add(&base, &vdso->offset, &base);
+        }
+
+      elapsed = up_vdso_gettime() - vdso->cycle_last;
+    }
+  while (read_seqcount_retry(&vdso->seq, seq));
+
+  if (freq == 0)
+    {
+      return nx_clock_gettime(clock_id, tp);
+    }
+
+  tp->tv_sec  = elapsed / freq;
+  tp->tv_nsec = (uint64_t)(elapsed % freq) * NSEC_PER_SEC / freq;
+  clock_timespec_add(&base, tp, tp);
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
+#include <errno.h>
 
 /****************************************************************************
  * Public Functions
@@ -37,63 +38,21 @@
  *
  * Description:
  *   The preadv() function is equivalent to pread(), except it takes
- *   an iov array.
+ *   an iov array.  The whole array is passed to the kernel in a single
+ *   preadv2() call.
  *
  ****************************************************************************/
 
 ssize_t preadv(int fildes, FAR const struct iovec *iov, int iovcnt,
                off_t offset)
 {
-  ssize_t ntotal;
-  ssize_t nread;
-  size_t remaining;
-  FAR uint8_t *buffer;
-  int i;
+  /* An offset of -1 has a special meaning to preadv2() */
 
-  /* Process each entry in the struct iovec array */
-
-  for (i = 0, ntotal = 0; i < iovcnt; i++)
+  if (offset < 0)
     {
-      /* Ignore zero-length reads */
-
-      if (iov[i].iov_len > 0)
-        {
-          buffer    = iov[i].iov_base;
-          remaining = iov[i].iov_len;
-
-          /* Read repeatedly as necessary to fill buffer */
-
-          do
-            {
-              /* NOTE: pread() is a cancellation point */
-
-              nread = pread(fildes, buffer, remaining, offset + ntotal);
-
-              /* Check for a read error */
-
-              if (nread < 0)
-                {
-                  return nread;
-                }
-
-              /* Check for an end-of-file condition */
-
-              else if (nread == 0)
-                {
-                  return ntotal;
-                }
-
-              /* Update pointers and counts in order to handle partial
-               * buffer reads.
-               */
-
-              buffer    += nread;
-              remaining -= nread;
-              ntotal    += nread;
-            }
-          while (remaining > 0);
-        }
+      set_errno(EINVAL);
+      return ERROR;
     }
 
-  return ntotal;
+  return preadv2(fildes, iov, iovcnt, offset, 0);
 }
@@ -38,56 +38,21 @@
  *
  * Description:
  *   The pwritev() function is equivalent to write(), except it takes
- *   an iov array.
+ *   an iov array.  The whole array is passed to the kernel in a single
+ *   pwritev2() call.
  *
  ****************************************************************************/
 
 ssize_t pwritev(int fildes, FAR const struct iovec *iov, int iovcnt,
                 off_t offset)
 {
-  ssize_t ntotal;
-  ssize_t nwritten;
-  size_t remaining;
-  FAR uint8_t *buffer;
-  int i;
+  /* An offset of -1 has a special meaning to pwritev2() */
 
-  /* Process each entry in the struct iovec array */
-
-  for (i = 0, ntotal = 0; i < iovcnt; i++)
+  if (offset < 0)
     {
-      /* Ignore zero-length writes */
-
-      if (iov[i].iov_len > 0)
-        {
-          buffer    = iov[i].iov_base;
-          remaining = iov[i].iov_len;
-
-          /* Write repeatedly as necessary to write the entire buffer */
-
-          do
-            {
-              /* NOTE: pwrite() is a cancellation point */
-
-              nwritten = pwrite(fildes, buffer, remaining, offset + ntotal);
-
-              /* Check for a write error */
-
-              if (nwritten < 0)
-                {
-                  return ntotal ? ntotal : ERROR;
-                }
-
-              /* Update pointers and counts in order to handle partial
-               * buffer writes.
-               */
-
-              buffer    += nwritten;
-              remaining -= nwritten;
-              ntotal    += nwritten;
-            }
-          while (remaining > 0);
-        }
+      set_errno(EINVAL);
+      return ERROR;
     }
 
-  return ntotal;
+  return pwritev2(fildes, iov, iovcnt, offset, 0);
 }
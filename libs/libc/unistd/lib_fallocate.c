@@ -0,0 +1,118 @@
+/****************************************************************************
+ * libs/libc/unistd/lib_fallocate.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fallocate
+ *
+ * Description:
+ *   Allocate storage on the file system media for the byte range
+ *   [offset, offset + len) of the file referred to by fd, so that later
+ *   writes to that range cannot fail for lack of space.  File systems that
+ *   can do so (FAT) allocate the range as contiguously as possible, which
+ *   makes fallocate() useful to reserve space ahead of a stream such as a
+ *   video recording.
+ *
+ *   If mode is zero and offset + len is beyond the end of the file, the
+ *   file size is extended and the new range reads back as zeros.  If mode
+ *   is FALLOC_FL_KEEP_SIZE the file size is not changed; the storage that
+ *   lies beyond the end of the file is then released when the file is
+ *   closed.
+ *
+ *   When the file system has no native support, a mode of zero falls back
+ *   to extending the file with ftruncate().
+ *
+ * Returned Value:
+ *   Zero on success; -1 on failure with errno set appropriately:
+ *
+ *   EINVAL     - offset is negative or len is not positive
+ *   EFBIG      - offset + len exceeds the maximum file size
+ *   EOPNOTSUPP - mode is not supported by the file system
+ *   ENOSPC     - There is not enough free space on the media
+ *
+ ****************************************************************************/
+
+int fallocate(int fd, int mode, off_t offset, off_t len)
+{
+  struct fallocate_s req;
+  struct stat st;
+  int ret;
+
+  if (offset < 0 || len <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  if (offset + len < 0)
+    {
+      set_errno(EFBIG);
+      return ERROR;
+    }
+
+  req.mode   = mode;
+  req.offset = offset;
+  req.len    = len;
+
+  ret = ioctl(fd, FIOC_FALLOCATE, (unsigned long)((uintptr_t)&req));
+  if (ret >= 0 || get_errno() != ENOTTY)
+    {
+      return ret;
+    }
+
+  /* No native support: only the plain mode can be emulated */
+
+  if (mode != 0)
+    {
+      set_errno(EOPNOTSUPP);
+      return ERROR;
+    }
+
+  ret = fstat(fd, &st);
+  if (ret < 0 || st.st_size >= offset + len)
+    {
+      return ret;
+    }
+
+  return ftruncate(fd, offset + len);
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT */
@@ -28,6 +28,7 @@
 
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 #include <sys/resource.h>
 
@@ -50,21 +51,35 @@
  *   information for the child process is discarded and not included in the
  *   resource information provided by getrusage().
  *
- *   Note: This is currently a dummy implementation and as such does not
- *   honor the 'who' parameter.
+ *   Note: Only the CPU time of the current process is provided, and only
+ *   with CONFIG_SCHED_CPUTIME.  NuttX does not tell user time from system
+ *   time, so all of it is reported in ru_utime.  Everything else, and all
+ *   of the RUSAGE_CHILDREN information, reads as zero.
  *
  ****************************************************************************/
 
 int getrusage(int who, FAR struct rusage *r_usage)
 {
-  UNUSED(who);
+#ifdef CONFIG_SCHED_CPUTIME
+  struct timespec ts;
+#endif
 
-  if (r_usage == NULL)
+  if (r_usage == NULL || (who != RUSAGE_SELF && who != RUSAGE_CHILDREN))
     {
       set_errno(EINVAL);
       return ERROR;
     }
 
   memset(r_usage, 0, sizeof(*r_usage));
+
+#ifdef CONFIG_SCHED_CPUTIME
+  if (who == RUSAGE_SELF &&
+      clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == OK)
+    {
+      r_usage->ru_utime.tv_sec  = ts.tv_sec;
+      r_usage->ru_utime.tv_usec = ts.tv_nsec / 1000;
+    }
+#endif
+
   return OK;
 }
@@ -28,8 +28,6 @@
 #include <errno.h>
 #include <unistd.h>
 
-#include <sys/stat.h>
-
 #ifndef CONFIG_DISABLE_MOUNTPOINT
 
 /****************************************************************************
@@ -51,7 +49,9 @@
  *  not be changed.
  *
  *  It is implementation-defined whether a previous posix_fadvise() call
- *  influences allocation strategy.
+ *  influences allocation strategy.  This implementation is built on
+ *  fallocate(), so file systems with native support reserve the range
+ *  contiguously.
  *
  *  Space allocated via posix_fallocate() shall be freed by a successful call
  *  to creat() or open() that truncates the size of the file. Space allocated
@@ -66,30 +66,24 @@
 
 int posix_fallocate(int fd, off_t offset, off_t len)
 {
-  struct stat st;
-
   if (offset < 0 || len < 0)
     {
       return EINVAL;
     }
 
-  len += offset;
-  if (len < 0)
+  if (offset + len < 0)
     {
       return EFBIG;
     }
 
-  if (fstat(fd, &st) != 0)
+  if (len == 0)
     {
-      return get_errno();
+      return 0;
     }
 
-  if (st.st_size < len)
+  if (fallocate(fd, 0, offset, len) < 0)
     {
-      if (ftruncate(fd, len) != 0)
-        {
-          return get_errno();
-        }
+      return get_errno();
     }
 
   return 0;
@@ -149,3 +149,154 @@ void inv_park_transform(FAR phase_angle_f32_t *angle,
   ab->a = angle->cos * dq->d - angle->sin * dq->q;
   ab->b = angle->cos * dq->q + angle->sin * dq->d;
 }
+
+/****************************************************************************
+ * Name: clarke_transform_n
+ *
+ * Description:
+ *   Clarke transform of n independent abc frames, e.g. one per motor or per
+ *   channel.  The loop body has no calls or branches so the compiler can
+ *   vectorize it for the target SIMD unit.
+ *
+ * Input Parameters:
+ *   abc - (in) array of n abc frames
+ *   ab  - (out) array of n alpha-beta frames
+ *   n   - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_n(FAR abc_frame_f32_t *abc,
+                        FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = abc[i].a;
+      float b = abc[i].b;
+
+      ab[i].a = a;
+      ab[i].b = ONE_BY_SQRT3_F*a + TWO_BY_SQRT3_F*b;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_n
+ *
+ * Description:
+ *   Inverse Clarke transform of n independent alpha-beta frames.
+ *
+ * Input Parameters:
+ *   ab  - (in) array of n alpha-beta frames
+ *   abc - (out) array of n abc frames
+ *   n   - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_n(FAR ab_frame_f32_t *ab,
+                            FAR abc_frame_f32_t *abc, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = ab[i].a;
+      float b = -0.5f*ab[i].a + SQRT3_BY_TWO_F*ab[i].b;
+
+      abc[i].a = a;
+      abc[i].b = b;
+      abc[i].c = -a - b;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_n
+ *
+ * Description:
+ *   Park transform of n independent alpha-beta frames, each with its own
+ *   phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   ab    - (in) array of n alpha-beta frames
+ *   dq    - (out) array of n direct-quadrature frames
+ *   n     - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_n(FAR phase_angle_f32_t *angle,
+                      FAR ab_frame_f32_t *ab,
+                      FAR dq_frame_f32_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float c = angle[i].cos;
+      float s = angle[i].sin;
+      float a = ab[i].a;
+      float b = ab[i].b;
+
+      dq[i].d = c * a + s * b;
+      dq[i].q = c * b - s * a;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_n
+ *
+ * Description:
+ *   Inverse Park transform of n independent direct-quadrature frames, each
+ *   with its own phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   dq    - (in) array of n direct-quadrature frames
+ *   ab    - (out) array of n alpha-beta frames
+ *   n     - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_n(FAR phase_angle_f32_t *angle,
+                          FAR dq_frame_f32_t *dq,
+                          FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      float c = angle[i].cos;
+      float s = angle[i].sin;
+      float d = dq[i].d;
+      float q = dq[i].q;
+
+      ab[i].a = c * d - s * q;
+      ab[i].b = c * q + s * d;
+    }
+}
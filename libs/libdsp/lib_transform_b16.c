@@ -151,3 +151,142 @@ void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
   ab->a = b16mulb16(angle->cos, dq->d) - b16mulb16(angle->sin, dq->q);
   ab->b = b16mulb16(angle->cos, dq->q) + b16mulb16(angle->sin, dq->d);
 }
+
+/****************************************************************************
+ * Name: clarke_transform_n_b16
+ *
+ * Description:
+ *   Clarke transform of n independent abc frames.
+ *
+ * Input Parameters:
+ *   abc - (in) array of n abc frames
+ *   ab  - (out) array of n alpha-beta frames
+ *   n   - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_n_b16(FAR abc_frame_b16_t *abc,
+                            FAR ab_frame_b16_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = abc[i].a;
+      ab[i].b = (b16mulb16(ONE_BY_SQRT3_B16, abc[i].a) +
+                 b16mulb16(TWO_BY_SQRT3_B16, abc[i].b));
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_n_b16
+ *
+ * Description:
+ *   Inverse Clarke transform of n independent alpha-beta frames.
+ *
+ * Input Parameters:
+ *   ab  - (in) array of n alpha-beta frames
+ *   abc - (out) array of n abc frames
+ *   n   - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_n_b16(FAR ab_frame_b16_t *ab,
+                                FAR abc_frame_b16_t *abc, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      abc[i].a = ab[i].a;
+      abc[i].b = (b16mulb16(-b16HALF, ab[i].a) +
+                  b16mulb16(SQRT3_BY_TWO_B16, ab[i].b));
+      abc[i].c = (-abc[i].a - abc[i].b);
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_n_b16
+ *
+ * Description:
+ *   Park transform of n independent alpha-beta frames, each with its own
+ *   phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   ab    - (in) array of n alpha-beta frames
+ *   dq    - (out) array of n direct-quadrature frames
+ *   n     - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                          FAR ab_frame_b16_t *ab,
+                          FAR dq_frame_b16_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      dq[i].d = (b16mulb16(angle[i].cos, ab[i].a) +
+                 b16mulb16(angle[i].sin, ab[i].b));
+      dq[i].q = (b16mulb16(angle[i].cos, ab[i].b) -
+                 b16mulb16(angle[i].sin, ab[i].a));
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_n_b16
+ *
+ * Description:
+ *   Inverse Park transform of n independent direct-quadrature frames, each
+ *   with its own phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   dq    - (in) array of n direct-quadrature frames
+ *   ab    - (out) array of n alpha-beta frames
+ *   n     - (in) number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                              FAR dq_frame_b16_t *dq,
+                              FAR ab_frame_b16_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = (b16mulb16(angle[i].cos, dq[i].d) -
+                 b16mulb16(angle[i].sin, dq[i].q));
+      ab[i].b = (b16mulb16(angle[i].cos, dq[i].q) +
+                 b16mulb16(angle[i].sin, dq[i].d));
+    }
+}
@@ -0,0 +1,249 @@
+/****************************************************************************
+ * libs/libm/vmath/vmath_kernel.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBM_VMATH_VMATH_KERNEL_H
+#define __LIBS_LIBM_VMATH_VMATH_KERNEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The kernels are written once against vf_t/vi_t.  With GCC and clang
+ * these are generic vector types of VM_VBYTES bytes, which the compiler
+ * lowers to NEON, Helium (MVE), RVV or SSE registers as available, and to
+ * scalar code otherwise.  Other compilers get a plain float version of
+ * the same code.
+ */
+
+#if defined(__GNUC__) && !defined(CONFIG_LIBM_VECTOR_SCALAR)
+#  define VM_VBYTES             CONFIG_LIBM_VECTOR_BYTES
+#  define VM_VLEN               (VM_VBYTES / 4)
+#  define VM_MASK(c)            (c)
+#  define VM_CVT_I(v)           __builtin_convertvector(v, vi_t)
+#  define VM_CVT_F(v)           __builtin_convertvector(v, vf_t)
+#else
+#  define VM_VLEN               1
+#  define VM_MASK(c)            (-(vi_t)(c))
+#  define VM_CVT_I(v)           ((vi_t)(v))
+#  define VM_CVT_F(v)           ((vf_t)(v))
+#endif
+
+/* Adding and subtracting 1.5 * 2^23 rounds to the nearest integer for
+ * magnitudes below 2^22.
+ */
+
+#define VM_RINT_MAGIC           12582912.0f
+
+/* Broadcast a constant */
+
+#define VM_SPLAT(c)             ((vf_t){ 0 } + (c))
+
+/* Define a function applying 'kernel' to whole arrays */
+
+#define VM_DEFINE(name, kernel) \
+  void name(FAR float *y, FAR const float *x, size_t n) \
+  { \
+    vf_t v; \
+    while (n >= VM_VLEN) \
+      { \
+        memcpy(&v, x, sizeof(v)); \
+        v = kernel(v); \
+        memcpy(y, &v, sizeof(v)); \
+        x += VM_VLEN; \
+        y += VM_VLEN; \
+        n -= VM_VLEN; \
+      } \
+    if (n > 0) \
+      { \
+        memset(&v, 0, sizeof(v)); \
+        memcpy(&v, x, n * sizeof(float)); \
+        v = kernel(v); \
+        memcpy(y, &v, n * sizeof(float)); \
+      } \
+  }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if VM_VLEN > 1
+typedef float   vf_t __attribute__((vector_size(VM_VBYTES)));
+typedef int32_t vi_t __attribute__((vector_size(VM_VBYTES)));
+#else
+typedef float   vf_t;
+typedef int32_t vi_t;
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+static inline vi_t vm_asint(vf_t v)
+{
+  vi_t i;
+
+  memcpy(&i, &v, sizeof(i));
+  return i;
+}
+
+static inline vf_t vm_asfloat(vi_t i)
+{
+  vf_t v;
+
+  memcpy(&v, &i, sizeof(v));
+  return v;
+}
+
+static inline vf_t vm_fabsf(vf_t v)
+{
+  return vm_asfloat(vm_asint(v) & INT32_MAX);
+}
+
+/* Pick a where mask is set, b elsewhere */
+
+static inline vf_t vm_select(vi_t mask, vf_t a, vf_t b)
+{
+  return vm_asfloat((vm_asint(a) & mask) | (vm_asint(b) & ~mask));
+}
+
+/****************************************************************************
+ * Name: vm_expf
+ *
+ * Description:
+ *   e^x = 2^n * e^r with n = rint(x / ln2) and |r| <= ln2 / 2.  ln2 is
+ *   split in two parts so that n * ln2 is subtracted exactly, and e^r is a
+ *   degree 7 polynomial (Cephes coefficients).  2^n is applied in two
+ *   steps so that both results near FLT_MAX and subnormal results are
+ *   reached.
+ *
+ ****************************************************************************/
+
+static inline vf_t vm_expf(vf_t x)
+{
+  vi_t n1;
+  vi_t n2;
+  vf_t r;
+  vf_t p;
+  vf_t n;
+  vf_t y;
+
+  x = vm_select(VM_MASK(x > 89.0f), VM_SPLAT(89.0f), x);
+  x = vm_select(VM_MASK(x < -104.0f), VM_SPLAT(-104.0f), x);
+
+  n = (x * 1.44269504088896341f + VM_RINT_MAGIC) - VM_RINT_MAGIC;
+  r = x - n * 0.693359375f;
+  r = r + n * 2.12194440e-4f;
+
+  p = VM_SPLAT(1.9875691500e-4f);
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * r * r + r + 1.0f;
+
+  /* |n| <= 151, so both halves have a valid biased exponent */
+
+  n1 = VM_CVT_I(n) >> 1;
+  n2 = VM_CVT_I(n) - n1;
+  y  = p * vm_asfloat((n1 + 127) << 23);
+  y  = y * vm_asfloat((n2 + 127) << 23);
+
+  /* x was clamped above, so overflow and underflow come out as inf and
+   * zero.  NaN has passed through the arithmetic.
+   */
+
+  return y;
+}
+
+/****************************************************************************
+ * Name: vm_logf
+ *
+ * Description:
+ *   log(x) = e * ln2 + log(m) with x = m * 2^e and sqrt(1/2) <= m <
+ *   sqrt(2).  log(1 + z) is z - z^2 / 2 + z^3 * P(z) with a degree 8
+ *   polynomial P (Cephes coefficients).
+ *
+ ****************************************************************************/
+
+static inline vf_t vm_logf(vf_t x)
+{
+  vi_t subnormal;
+  vi_t bits;
+  vf_t e;
+  vf_t m;
+  vf_t z;
+  vf_t zz;
+  vf_t p;
+  vf_t y;
+
+  /* Bring subnormals into the normal range first */
+
+  subnormal = VM_MASK(x < 1.17549435e-38f);
+  m = vm_select(subnormal, x * 8388608.0f, x);
+  bits = vm_asint(m);
+
+  /* Split off the exponent, leaving m in [sqrt(1/2), sqrt(2)) */
+
+  bits = bits - 0x3f3504f3;
+  e = VM_CVT_F(bits >> 23);
+  e = vm_select(subnormal, e - 23.0f, e);
+  m = vm_asfloat((bits & 0x007fffff) + 0x3f3504f3);
+
+  z = m - 1.0f;
+  zz = z * z;
+
+  p = VM_SPLAT(7.0376836292e-2f);
+  p = p * z - 1.1514610310e-1f;
+  p = p * z + 1.1676998740e-1f;
+  p = p * z - 1.2420140846e-1f;
+  p = p * z + 1.4249322787e-1f;
+  p = p * z - 1.6668057665e-1f;
+  p = p * z + 2.0000714765e-1f;
+  p = p * z - 2.4999993993e-1f;
+  p = p * z + 3.3333331174e-1f;
+
+  y = p * z * zz;
+  y = y - e * 2.12194440e-4f;
+  y = y - zz * 0.5f;
+  y = z + y;
+  y = y + e * 0.693359375f;
+
+  /* log(0) = -inf, log(<0) = NaN, log(inf) = inf, log(NaN) = NaN */
+
+  y = vm_select(VM_MASK(x == (float)INFINITY), x, y);
+  y = vm_select(VM_MASK(x < 0.0f), VM_SPLAT((float)NAN), y);
+  y = vm_select(VM_MASK(x == 0.0f), VM_SPLAT(-(float)INFINITY), y);
+  return vm_select(VM_MASK(x != x), x, y);
+}
+
+#endif /* __LIBS_LIBM_VMATH_VMATH_KERNEL_H */
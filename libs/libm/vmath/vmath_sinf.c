@@ -0,0 +1,127 @@
+/****************************************************************************
+ * libs/libm/vmath/vmath_sinf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/vmath.h>
+
+#include "vmath_kernel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Beyond this the four part reduction below loses accuracy */
+
+#define VM_SINF_MAX   39000.0f
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vm_sinf
+ *
+ * Description:
+ *   sin(x) = (-1)^q * sin(r) with q = rint(x / pi) and |r| <= pi / 2.  pi
+ *   is split in four parts (Cody-Waite) and sin(r) is an odd polynomial
+ *   of degree 9.
+ *
+ ****************************************************************************/
+
+static inline vf_t vm_sinf(vf_t x)
+{
+  vf_t q;
+  vf_t r;
+  vf_t s;
+  vf_t u;
+
+  q = (x * 0.318309886183790671f + VM_RINT_MAGIC) - VM_RINT_MAGIC;
+  r = x - q * 3.140625f;
+  r = r - q * 0.0009670257568359375f;
+  r = r - q * 6.2771141529083251953e-7f;
+  r = r - q * 1.2154201256553420762e-10f;
+
+  s = r * r;
+  u = VM_SPLAT(2.6083159809786593541503e-6f);
+  u = u * s - 1.981069071916863322258e-4f;
+  u = u * s + 8.33307858556509017944336e-3f;
+  u = u * s - 1.66666597127914428710938e-1f;
+  u = s * (u * r) + r;
+
+  /* Odd q flips the sign */
+
+  return vm_asfloat(vm_asint(u) ^
+                    (VM_MASK((VM_CVT_I(q) & 1) != 0) & INT32_MIN));
+}
+
+/****************************************************************************
+ * Name: vm_sinf_huge
+ *
+ * Description:
+ *   Redo the rare lanes too large for vm_sinf() with the scalar sinf().
+ *
+ ****************************************************************************/
+
+static inline vf_t vm_sinf_huge(vf_t x)
+{
+  vi_t huge = VM_MASK(vm_fabsf(x) > VM_SINF_MAX) &
+              VM_MASK(vm_fabsf(x) != (float)INFINITY);
+  int32_t lane[VM_VLEN];
+  float xs[VM_VLEN];
+  float ys[VM_VLEN];
+  int32_t any = 0;
+  vf_t y = vm_sinf(x);
+  int i;
+
+  memcpy(lane, &huge, sizeof(lane));
+  for (i = 0; i < VM_VLEN; i++)
+    {
+      any |= lane[i];
+    }
+
+  if (any != 0)
+    {
+      memcpy(xs, &x, sizeof(xs));
+      memcpy(ys, &y, sizeof(ys));
+      for (i = 0; i < VM_VLEN; i++)
+        {
+          if (lane[i] != 0)
+            {
+              ys[i] = sinf(xs[i]);
+            }
+        }
+
+      memcpy(&y, ys, sizeof(y));
+    }
+
+  return y;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+VM_DEFINE(vsinf, vm_sinf_huge)
@@ -0,0 +1,69 @@
+/****************************************************************************
+ * libs/libm/vmath/vmath_tanhf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/vmath.h>
+
+#include "vmath_kernel.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vm_tanhf
+ *
+ * Description:
+ *   Below 0.625 an odd polynomial (Cephes coefficients), above that
+ *   1 - 2 / (e^2|x| + 1) with the sign of x.
+ *
+ ****************************************************************************/
+
+static inline vf_t vm_tanhf(vf_t x)
+{
+  vf_t a = vm_fabsf(x);
+  vf_t z = x * x;
+  vf_t p;
+  vf_t y;
+
+  p = VM_SPLAT(-5.70498872745e-3f);
+  p = p * z + 2.06390887954e-2f;
+  p = p * z - 5.37397155531e-2f;
+  p = p * z + 1.33314422036e-1f;
+  p = p * z - 3.33332819422e-1f;
+  p = p * z * x + x;
+
+  y = 1.0f - 2.0f / (vm_expf(a + a) + 1.0f);
+  y = vm_asfloat(vm_asint(y) | (vm_asint(x) & INT32_MIN));
+
+  return vm_select(VM_MASK(a < 0.625f), p, y);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+VM_DEFINE(vtanhf, vm_tanhf)
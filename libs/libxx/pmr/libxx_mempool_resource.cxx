@@ -0,0 +1,163 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_mempool_resource.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <new>
+
+#include <nuttx/lib/lib.h>
+
+#include "memory_resource.hxx"
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// Block size step of the default resource
+
+#define MEMPOOL_STEP       16
+
+// Backing memory is taken from the heap this many bytes at a time
+
+#define MEMPOOL_EXPANDSIZE 4096
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static FAR void *mempool_resource_alloc(FAR void *arg, std::size_t align,
+                                        std::size_t size)
+{
+  return lib_memalign(align, size);
+}
+
+static std::size_t mempool_resource_size(FAR void *arg, FAR void *ptr)
+{
+  return lib_malloc_size(ptr);
+}
+
+static void mempool_resource_free(FAR void *arg, FAR void *ptr)
+{
+  lib_free(ptr);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+
+mempool_resource::mempool_resource(FAR const std::size_t *poolsize,
+                                   std::size_t npools,
+                                   std::size_t expandsize)
+{
+  m_mpool = mempool_multiple_init("pmr", poolsize, npools,
+                                  mempool_resource_alloc,
+                                  mempool_resource_size,
+                                  mempool_resource_free, nullptr, 0,
+                                  expandsize, expandsize);
+}
+
+mempool_resource::~mempool_resource()
+{
+  if (m_mpool != nullptr)
+    {
+      mempool_multiple_deinit(m_mpool);
+    }
+}
+
+FAR void *mempool_resource::do_allocate(std::size_t bytes,
+                                        std::size_t align)
+{
+  FAR void *ptr = nullptr;
+
+  if (m_mpool != nullptr)
+    {
+      ptr = align <= alignof(std::max_align_t) ?
+            mempool_multiple_alloc(m_mpool, bytes) :
+            mempool_multiple_memalign(m_mpool, align, bytes);
+    }
+
+  // Too large for the pools: fall back to the heap, never to operator new
+  // which may be served by this very resource
+
+  if (ptr == nullptr)
+    {
+      ptr = lib_memalign(align, bytes);
+    }
+
+#ifdef CONFIG_CXX_EXCEPTION
+  if (ptr == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+#endif
+
+  return ptr;
+}
+
+void mempool_resource::do_deallocate(FAR void *ptr, std::size_t bytes,
+                                     std::size_t align)
+{
+  if (m_mpool == nullptr || mempool_multiple_free(m_mpool, ptr) < 0)
+    {
+      lib_free(ptr);
+    }
+}
+
+bool mempool_resource::do_is_equal(const std::pmr::memory_resource &other)
+  const noexcept
+{
+  return this == &other;
+}
+
+FAR mempool_resource *default_mempool_resource() noexcept
+{
+  // Constructed in static storage and never destroyed: operator new and
+  // delete may still run after static destructors
+
+  alignas(mempool_resource) static unsigned char
+    storage[sizeof(mempool_resource)];
+  static FAR mempool_resource *resource = []() -> FAR mempool_resource *
+    {
+      std::size_t poolsize[CONFIG_LIBCXX_PMR_NPOOLS];
+
+      for (int i = 0; i < CONFIG_LIBCXX_PMR_NPOOLS; i++)
+        {
+          poolsize[i] = (i + 1) * MEMPOOL_STEP;
+        }
+
+      return new (storage) mempool_resource(poolsize,
+                                            CONFIG_LIBCXX_PMR_NPOOLS,
+                                            MEMPOOL_EXPANDSIZE);
+    }();
+
+  return resource;
+}
+
+} // namespace nuttx
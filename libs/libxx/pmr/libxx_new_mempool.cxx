@@ -0,0 +1,113 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_new_mempool.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <nuttx/lib/lib.h>
+
+#include "memory_resource.hxx"
+
+//***************************************************************************
+// Operators
+//***************************************************************************
+
+// These replace the weak definitions of libc++.  Only the plain forms are
+// needed: the array, nothrow and sized forms of libc++ all end up here.
+// Over-aligned new and delete keep using the heap directly.
+
+//***************************************************************************
+// Name: new
+//***************************************************************************
+
+FAR void *operator new(std::size_t nbytes)
+{
+  FAR struct mempool_multiple_s *mpool =
+    nuttx::default_mempool_resource()->pool();
+  FAR void *ptr;
+
+  if (nbytes == 0)
+    {
+      nbytes = 1;
+    }
+
+  for (; ; )
+    {
+      ptr = mpool != nullptr ? mempool_multiple_alloc(mpool, nbytes) :
+                               nullptr;
+      if (ptr == nullptr)
+        {
+          ptr = lib_malloc(nbytes);
+        }
+
+      if (ptr != nullptr)
+        {
+          return ptr;
+        }
+
+      std::new_handler handler = std::get_new_handler();
+      if (handler == nullptr)
+        {
+          break;
+        }
+
+      handler();
+    }
+
+#ifdef CONFIG_CXX_EXCEPTION
+  throw std::bad_alloc();
+#else
+  std::abort();
+#endif
+}
+
+//***************************************************************************
+// Name: delete
+//***************************************************************************
+
+void operator delete(FAR void *ptr) noexcept
+{
+  FAR struct mempool_multiple_s *mpool;
+
+  if (ptr == nullptr)
+    {
+      return;
+    }
+
+  mpool = nuttx::default_mempool_resource()->pool();
+  if (mpool == nullptr || mempool_multiple_free(mpool, ptr) < 0)
+    {
+      lib_free(ptr);
+    }
+}
+
+void operator delete(FAR void *ptr, std::size_t size) noexcept
+{
+  ::operator delete(ptr);
+}
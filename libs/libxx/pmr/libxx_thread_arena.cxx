@@ -0,0 +1,117 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_thread_arena.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <new>
+#include <pthread.h>
+
+#include <nuttx/lib/lib.h>
+
+#include "memory_resource.hxx"
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static pthread_once_t g_arena_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_arena_key;
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static void thread_arena_destroy(FAR void *arg)
+{
+  FAR std::pmr::monotonic_buffer_resource *arena =
+    static_cast<FAR std::pmr::monotonic_buffer_resource *>(arg);
+
+  arena->~monotonic_buffer_resource();
+  lib_free(arena);
+}
+
+static void thread_arena_key()
+{
+  pthread_key_create(&g_arena_key, thread_arena_destroy);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+
+FAR std::pmr::monotonic_buffer_resource *thread_arena() noexcept
+{
+  FAR std::pmr::monotonic_buffer_resource *arena;
+  FAR void *mem;
+
+  pthread_once(&g_arena_once, thread_arena_key);
+
+  arena = static_cast<FAR std::pmr::monotonic_buffer_resource *>
+          (pthread_getspecific(g_arena_key));
+  if (arena != nullptr)
+    {
+      return arena;
+    }
+
+  // The arena object itself comes from the heap so that creating it does
+  // not depend on operator new
+
+  mem = lib_malloc(sizeof(std::pmr::monotonic_buffer_resource));
+  if (mem == nullptr)
+    {
+      return nullptr;
+    }
+
+  arena = new (mem)
+    std::pmr::monotonic_buffer_resource(CONFIG_LIBCXX_PMR_ARENA_SIZE,
+                                        default_mempool_resource());
+  if (pthread_setspecific(g_arena_key, arena) != 0)
+    {
+      thread_arena_destroy(arena);
+      return nullptr;
+    }
+
+  return arena;
+}
+
+void thread_arena_release() noexcept
+{
+  FAR std::pmr::monotonic_buffer_resource *arena;
+
+  pthread_once(&g_arena_once, thread_arena_key);
+
+  arena = static_cast<FAR std::pmr::monotonic_buffer_resource *>
+          (pthread_getspecific(g_arena_key));
+  if (arena != nullptr)
+    {
+      arena->release();
+    }
+}
+
+} // namespace nuttx
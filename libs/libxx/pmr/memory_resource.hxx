@@ -0,0 +1,100 @@
+//***************************************************************************
+// libs/libxx/pmr/memory_resource.hxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __LIBS_LIBXX_PMR_MEMORY_RESOURCE_HXX
+#define __LIBS_LIBXX_PMR_MEMORY_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <nuttx/mm/mempool.h>
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+namespace nuttx
+{
+
+// A std::pmr::memory_resource serving small blocks from a multiple
+// mempool.  Each block size class has its own lock, so allocations do not
+// contend on the heap lock.  Requests larger than the biggest pool, or
+// with an alignment above alignof(std::max_align_t), go to the heap.
+// The resource itself is thread safe.
+
+class mempool_resource : public std::pmr::memory_resource
+{
+public:
+  mempool_resource(FAR const std::size_t *poolsize, std::size_t npools,
+                   std::size_t expandsize);
+  ~mempool_resource();
+
+  mempool_resource(const mempool_resource &) = delete;
+  mempool_resource &operator=(const mempool_resource &) = delete;
+
+  FAR struct mempool_multiple_s *pool() const noexcept
+  {
+    return m_mpool;
+  }
+
+protected:
+  FAR void *do_allocate(std::size_t bytes, std::size_t align) override;
+  void do_deallocate(FAR void *ptr, std::size_t bytes,
+                     std::size_t align) override;
+  bool do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept override;
+
+private:
+  FAR struct mempool_multiple_s *m_mpool;
+};
+
+//***************************************************************************
+// Public Function Prototypes
+//***************************************************************************
+
+// Return the process wide mempool resource, with CONFIG_LIBCXX_PMR_NPOOLS
+// pools in steps of 16 bytes.  It is created on first use and never
+// destroyed, so it may serve operator new.
+
+FAR mempool_resource *default_mempool_resource() noexcept;
+
+// Return the calling thread's monotonic arena, NULL if it could not be
+// created.  Allocations are carved out of CONFIG_LIBCXX_PMR_ARENA_SIZE byte
+// chunks taken from the default mempool resource and are only given back
+// by thread_arena_release() or when the thread exits.  No lock is taken,
+// so the arena must not be shared with other threads.
+
+FAR std::pmr::monotonic_buffer_resource *thread_arena() noexcept;
+
+// Free everything allocated from the calling thread's arena
+
+void thread_arena_release() noexcept;
+
+} // namespace nuttx
+
+#endif // __LIBS_LIBXX_PMR_MEMORY_RESOURCE_HXX
@@ -0,0 +1,460 @@
+/****************************************************************************
+ * mm/heapprof/heapprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/heapprof.h>
+
+#include "heapprof/heapprof.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HEAPPROF_NSTACKS    CONFIG_MM_HEAPPROF_NSTACKS
+#define HEAPPROF_NLIVE      CONFIG_MM_HEAPPROF_NLIVE
+
+/* The last entry of the backtrace table collects the samples that do not
+ * fit into the table anymore.
+ */
+
+#define HEAPPROF_OVERFLOW   HEAPPROF_NSTACKS
+
+/* FNV-1a hash parameters */
+
+#define HEAPPROF_FNV_BASIS  2166136261u
+#define HEAPPROF_FNV_PRIME  16777619u
+
+/* ln(2) and the correction of the linear log2() approximation in Q16 */
+
+#define HEAPPROF_LN2_Q16    45426
+#define HEAPPROF_LOG2_Q16   22713
+
+/* Number of random bits used to draw the sampling intervals */
+
+#define HEAPPROF_RANDBITS   26
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A sampled allocation that has not been freed yet */
+
+struct heapprof_live_s
+{
+  FAR void *mem;                 /* The allocated memory, NULL if unused */
+  size_t    size;                /* The requested size */
+  uint16_t  stack;               /* Index of the backtrace of the sample */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct heapprof_stack_s g_heapprof_stacks[HEAPPROF_NSTACKS + 1];
+static struct heapprof_live_s  g_heapprof_live[HEAPPROF_NLIVE];
+static volatile int            g_heapprof_nlive;
+static uint32_t                g_heapprof_ndropped;
+static spinlock_t              g_heapprof_lock = SP_UNLOCKED;
+
+/* Bytes to allocate on each CPU before the next sample is taken, and the
+ * state of the random number generator that draws that distance.
+ */
+
+static size_t   g_heapprof_remaining[CONFIG_SMP_NCPUS];
+static uint32_t g_heapprof_seed[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_interval
+ *
+ * Description:
+ *   Draw the number of bytes until the next sample from an exponential
+ *   distribution with a mean of CONFIG_MM_HEAPPROF_PERIOD, like tcmalloc
+ *   does:  the sampling then is a Poisson process over the allocated
+ *   bytes, so that each byte has the same chance to be sampled regardless
+ *   of the allocation pattern.  The interval is -ln(u) * period for a
+ *   uniform u in (0, 1], computed in fixed point.
+ *
+ ****************************************************************************/
+
+static size_t heapprof_interval(int cpu)
+{
+  uint32_t x = g_heapprof_seed[cpu];
+  uint32_t frac;
+  uint32_t neglog2;
+  int exp;
+
+  /* Advance the xorshift32 generator of this CPU */
+
+  if (x == 0)
+    {
+      x = HEAPPROF_FNV_BASIS + cpu;
+    }
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  g_heapprof_seed[cpu] = x;
+
+  /* u = x / 2^RANDBITS with x in [1, 2^RANDBITS] */
+
+  x = (x >> (32 - HEAPPROF_RANDBITS)) + 1;
+
+  /* log2(x) = exp + log2(1 + frac) ~ exp + frac + c * frac * (1 - frac) */
+
+  exp  = 31 - __builtin_clz(x);
+  frac = (uint32_t)(((uint64_t)x << 16 >> exp) & 0xffff);
+  frac += (((frac * (65536 - frac)) >> 16) * HEAPPROF_LOG2_Q16) >> 16;
+
+  neglog2 = (HEAPPROF_RANDBITS << 16) - ((exp << 16) + frac);
+
+  return (size_t)(((uint64_t)CONFIG_MM_HEAPPROF_PERIOD * neglog2 *
+                   HEAPPROF_LN2_Q16) >> 32) + 1;
+}
+
+/****************************************************************************
+ * Name: heapprof_hash
+ ****************************************************************************/
+
+static uint32_t heapprof_hash(FAR void **frames, int depth)
+{
+  uint32_t hash = HEAPPROF_FNV_BASIS;
+  int i;
+
+  for (i = 0; i < depth; i++)
+    {
+      uint64_t frame = (uintptr_t)frames[i];
+
+      hash = (hash ^ (uint32_t)frame) * HEAPPROF_FNV_PRIME;
+      hash = (hash ^ (uint32_t)(frame >> 32)) * HEAPPROF_FNV_PRIME;
+    }
+
+  /* Zero marks an unused entry */
+
+  return hash != 0 ? hash : 1;
+}
+
+/****************************************************************************
+ * Name: heapprof_findstack
+ *
+ * Description:
+ *   Find the entry of a backtrace in the table, creating it if necessary.
+ *   The caller must hold g_heapprof_lock.
+ *
+ ****************************************************************************/
+
+static int heapprof_findstack(FAR void **frames, int depth)
+{
+  FAR struct heapprof_stack_s *stack;
+  uint32_t hash = heapprof_hash(frames, depth);
+  int index = hash % HEAPPROF_NSTACKS;
+  int i;
+
+  for (i = 0; i < HEAPPROF_NSTACKS; i++)
+    {
+      stack = &g_heapprof_stacks[index];
+      if (stack->hash == 0)
+        {
+          stack->hash  = hash;
+          stack->depth = depth;
+          memcpy(stack->frames, frames, depth * sizeof(FAR void *));
+          return index;
+        }
+
+      if (stack->hash == hash && stack->depth == depth &&
+          memcmp(stack->frames, frames, depth * sizeof(FAR void *)) == 0)
+        {
+          return index;
+        }
+
+      if (++index >= HEAPPROF_NSTACKS)
+        {
+          index = 0;
+        }
+    }
+
+  /* The table is full */
+
+  g_heapprof_stacks[HEAPPROF_OVERFLOW].hash = 1;
+  return HEAPPROF_OVERFLOW;
+}
+
+/****************************************************************************
+ * Name: heapprof_livehome
+ ****************************************************************************/
+
+static int heapprof_livehome(FAR void *mem)
+{
+  return (uint32_t)(((uintptr_t)mem >> 3) * 2654435761u) % HEAPPROF_NLIVE;
+}
+
+/****************************************************************************
+ * Name: heapprof_sample
+ *
+ * Description:
+ *   Record one sampled allocation.
+ *
+ ****************************************************************************/
+
+static void heapprof_sample(FAR void *mem, size_t size)
+{
+  FAR struct heapprof_stack_s *stack;
+  FAR void *frames[CONFIG_MM_HEAPPROF_DEPTH];
+  irqstate_t flags;
+  int depth = 0;
+  int index;
+  int i;
+
+  /* Take the backtrace outside of the lock, it is the expensive part */
+
+  if (OSINIT_OS_READY() && !up_interrupt_context())
+    {
+      depth = sched_backtrace(_SCHED_GETTID(), frames,
+                              CONFIG_MM_HEAPPROF_DEPTH,
+                              CONFIG_MM_HEAPPROF_SKIP);
+      if (depth < 0)
+        {
+          depth = 0;
+        }
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  index = heapprof_findstack(frames, depth);
+  stack = &g_heapprof_stacks[index];
+  stack->nalloc++;
+  stack->allocbytes += size;
+
+  /* Remember the allocation until it is freed.  One entry is always left
+   * empty so that the lookups in heapprof_free() terminate.
+   */
+
+  if (g_heapprof_nlive < HEAPPROF_NLIVE - 1)
+    {
+      i = heapprof_livehome(mem);
+      while (g_heapprof_live[i].mem != NULL)
+        {
+          if (++i >= HEAPPROF_NLIVE)
+            {
+              i = 0;
+            }
+        }
+
+      g_heapprof_live[i].mem   = mem;
+      g_heapprof_live[i].size  = size;
+      g_heapprof_live[i].stack = index;
+      g_heapprof_nlive++;
+
+      stack->ninuse++;
+      stack->inusebytes += size;
+    }
+  else if (g_heapprof_ndropped++ == 0)
+    {
+      mwarn("WARNING: Too many sampled allocations in use, "
+            "increase CONFIG_MM_HEAPPROF_NLIVE\n");
+    }
+
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_alloc
+ *
+ * Description:
+ *   Account an allocation to the sampling heap profiler.
+ *
+ ****************************************************************************/
+
+void heapprof_alloc(FAR void *mem, size_t size)
+{
+  irqstate_t flags;
+  int cpu;
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  /* Most allocations only count down the distance to the next sample */
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  if (size < g_heapprof_remaining[cpu])
+    {
+      g_heapprof_remaining[cpu] -= size;
+      up_irq_restore(flags);
+      return;
+    }
+
+  g_heapprof_remaining[cpu] = heapprof_interval(cpu);
+  up_irq_restore(flags);
+
+  heapprof_sample(mem, size);
+}
+
+/****************************************************************************
+ * Name: heapprof_free
+ *
+ * Description:
+ *   Stop accounting a sampled allocation as in use when it is freed.
+ *
+ ****************************************************************************/
+
+void heapprof_free(FAR void *mem)
+{
+  FAR struct heapprof_stack_s *stack;
+  irqstate_t flags;
+  int home;
+  int i;
+  int j;
+
+  /* Nothing to do unless some sampled allocation is alive.  A sample that
+   * is being added concurrently cannot be this memory.
+   */
+
+  if (mem == NULL || g_heapprof_nlive == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  for (i = heapprof_livehome(mem); g_heapprof_live[i].mem != mem;
+       i = (i + 1) % HEAPPROF_NLIVE)
+    {
+      if (g_heapprof_live[i].mem == NULL)
+        {
+          /* Not a sampled allocation */
+
+          spin_unlock_irqrestore(&g_heapprof_lock, flags);
+          return;
+        }
+    }
+
+  stack = &g_heapprof_stacks[g_heapprof_live[i].stack];
+  stack->ninuse--;
+  stack->inusebytes -= g_heapprof_live[i].size;
+  g_heapprof_nlive--;
+
+  /* Remove the entry by moving the following entries of the same probe
+   * sequence back, so that no tombstones are needed.
+   */
+
+  for (j = (i + 1) % HEAPPROF_NLIVE; g_heapprof_live[j].mem != NULL;
+       j = (j + 1) % HEAPPROF_NLIVE)
+    {
+      home = heapprof_livehome(g_heapprof_live[j].mem);
+      if ((j > i && (home <= i || home > j)) ||
+          (j < i && home <= i && home > j))
+        {
+          g_heapprof_live[i] = g_heapprof_live[j];
+          i = j;
+        }
+    }
+
+  g_heapprof_live[i].mem = NULL;
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
+
+/****************************************************************************
+ * Name: heapprof_getstack
+ *
+ * Description:
+ *   Return a snapshot of the first backtrace at or after *index.
+ *
+ ****************************************************************************/
+
+int heapprof_getstack(FAR int *index, FAR struct heapprof_stack_s *stack)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  for (; *index <= HEAPPROF_OVERFLOW; (*index)++)
+    {
+      if (g_heapprof_stacks[*index].hash != 0)
+        {
+          *stack = g_heapprof_stacks[(*index)++];
+          ret = OK;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: heapprof_gettotal
+ *
+ * Description:
+ *   Return the sum of all backtraces.
+ *
+ ****************************************************************************/
+
+void heapprof_gettotal(FAR struct heapprof_stack_s *total)
+{
+  FAR struct heapprof_stack_s *stack;
+  irqstate_t flags;
+  int i;
+
+  memset(total, 0, sizeof(*total));
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  for (i = 0; i <= HEAPPROF_OVERFLOW; i++)
+    {
+      stack              = &g_heapprof_stacks[i];
+      total->nalloc     += stack->nalloc;
+      total->allocbytes += stack->allocbytes;
+      total->ninuse     += stack->ninuse;
+      total->inusebytes += stack->inusebytes;
+    }
+
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+ * mm/heapprof/heapprof.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_HEAPPROF_HEAPPROF_H
+#define __MM_HEAPPROF_HEAPPROF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_MM_HEAPPROF
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The samples aggregated for one backtrace.  The sizes are those of the
+ * sampled allocations only;  the consumer of the profile scales them by
+ * the sampling period.
+ */
+
+struct heapprof_stack_s
+{
+  uint32_t  hash;                /* Hash of the backtrace, zero if unused */
+  uint32_t  nalloc;              /* Number of sampled allocations */
+  uint64_t  allocbytes;          /* Bytes of the sampled allocations */
+  uint32_t  ninuse;              /* Sampled allocations not yet freed */
+  size_t    inusebytes;          /* Bytes of the sampled allocations in use */
+  uint8_t   depth;               /* Number of valid frames */
+  FAR void *frames[CONFIG_MM_HEAPPROF_DEPTH];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_getstack
+ *
+ * Description:
+ *   Return a snapshot of the first backtrace at or after *index in the
+ *   table of the profiler and advance *index past it.
+ *
+ * Returned Value:
+ *   Zero (OK) on success;  -ENOENT if there are no more backtraces.
+ *
+ ****************************************************************************/
+
+int heapprof_getstack(FAR int *index, FAR struct heapprof_stack_s *stack);
+
+/****************************************************************************
+ * Name: heapprof_gettotal
+ *
+ * Description:
+ *   Return the sum of all backtraces.  The frames of the result are unused.
+ *
+ ****************************************************************************/
+
+void heapprof_gettotal(FAR struct heapprof_stack_s *total);
+
+#endif /* CONFIG_MM_HEAPPROF */
+#endif /* __MM_HEAPPROF_HEAPPROF_H */
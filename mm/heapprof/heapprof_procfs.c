@@ -0,0 +1,302 @@
+/****************************************************************************
+ * mm/heapprof/heapprof_procfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/procfs.h>
+
+#include "heapprof/heapprof.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAPPROF_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct heapprof_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[HEAPPROF_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/* The state of one read() */
+
+struct heapprof_output_s
+{
+  FAR struct heapprof_file_s *procfile;
+  FAR char *buffer;               /* Remaining user buffer */
+  size_t    buflen;               /* Size of the remaining user buffer */
+  size_t    totalsize;            /* Bytes copied so far */
+  off_t     offset;               /* Bytes still to be skipped */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     heapprof_close(FAR struct file *filep);
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static int     heapprof_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     heapprof_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_heapprof_operations =
+{
+  heapprof_open,   /* open */
+  heapprof_close,  /* close */
+  heapprof_read,   /* read */
+  NULL,            /* write */
+  NULL,            /* poll */
+  heapprof_dup,    /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  heapprof_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_emit
+ *
+ * Description:
+ *   Copy the formatted line to the user buffer, skipping what has been read
+ *   before.
+ *
+ ****************************************************************************/
+
+static void heapprof_emit(FAR struct heapprof_output_s *out,
+                          size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(out->procfile->line, linesize, out->buffer,
+                           out->buflen, &out->offset);
+
+  out->buffer    += copysize;
+  out->buflen    -= copysize;
+  out->totalsize += copysize;
+}
+
+/****************************************************************************
+ * Name: heapprof_emitcounts
+ *
+ * Description:
+ *   Emit the "<inuse objs>: <inuse bytes> [<alloc objs>: <alloc bytes>]"
+ *   part of a line of the profile.
+ *
+ ****************************************************************************/
+
+static void heapprof_emitcounts(FAR struct heapprof_output_s *out,
+                                FAR const struct heapprof_stack_s *stack)
+{
+  size_t linesize;
+
+  linesize = procfs_snprintf(out->procfile->line, HEAPPROF_LINELEN,
+                             "%" PRIu32 ": %zu [%" PRIu32 ": %" PRIu64 "]",
+                             stack->ninuse, stack->inusebytes,
+                             stack->nalloc, stack->allocbytes);
+  heapprof_emit(out, linesize);
+}
+
+/****************************************************************************
+ * Name: heapprof_open
+ ****************************************************************************/
+
+static int heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct heapprof_file_s *procfile;
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  procfile = kmm_zalloc(sizeof(struct heapprof_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_close
+ ****************************************************************************/
+
+static int heapprof_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_read
+ *
+ * Description:
+ *   Generate the profile in the legacy text format of the gperftools heap
+ *   profiler, which pprof reads together with the ELF of the image:
+ *
+ *     heap profile: <in use totals> @ heap_v2/<sampling period>
+ *     <in use objs>: <in use bytes> [<alloc objs>: <alloc bytes>] @ <pcs>
+ *     ...
+ *
+ *   The counts are those of the samples;  pprof scales them back using the
+ *   sampling period.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct heapprof_output_s out;
+  struct heapprof_stack_s stack;
+  size_t linesize;
+  int index = 0;
+  int i;
+
+  out.procfile  = filep->f_priv;
+  out.buffer    = buffer;
+  out.buflen    = buflen;
+  out.totalsize = 0;
+  out.offset    = filep->f_pos;
+
+  /* The header line with the totals */
+
+  heapprof_gettotal(&stack);
+
+  linesize = procfs_snprintf(out.procfile->line, HEAPPROF_LINELEN,
+                             "heap profile: ");
+  heapprof_emit(&out, linesize);
+  heapprof_emitcounts(&out, &stack);
+  linesize = procfs_snprintf(out.procfile->line, HEAPPROF_LINELEN,
+                             " @ heap_v2/%lu\n",
+                             (unsigned long)CONFIG_MM_HEAPPROF_PERIOD);
+  heapprof_emit(&out, linesize);
+
+  /* Then one line per backtrace */
+
+  while (out.buflen > 0 && heapprof_getstack(&index, &stack) >= 0)
+    {
+      heapprof_emitcounts(&out, &stack);
+      linesize = procfs_snprintf(out.procfile->line, HEAPPROF_LINELEN,
+                                 " @");
+      heapprof_emit(&out, linesize);
+
+      for (i = 0; i < stack.depth; i++)
+        {
+          linesize = procfs_snprintf(out.procfile->line, HEAPPROF_LINELEN,
+                                     " 0x%" PRIxPTR,
+                                     (uintptr_t)stack.frames[i]);
+          heapprof_emit(&out, linesize);
+        }
+
+      linesize = procfs_snprintf(out.procfile->line, HEAPPROF_LINELEN,
+                                 "\n");
+      heapprof_emit(&out, linesize);
+    }
+
+  filep->f_pos += out.totalsize;
+  return out.totalsize;
+}
+
+/****************************************************************************
+ * Name: heapprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heapprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapprof_file_s *oldattr;
+  FAR struct heapprof_file_s *newattr;
+
+  oldattr = oldp->f_priv;
+  newattr = kmm_malloc(sizeof(struct heapprof_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct heapprof_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heapprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
@@ -43,6 +43,10 @@
 
 #define ROUNDUP(x, y)            (((x) + (y) - 1) / (y) * (y))
 
+#if defined(CONFIG_IOB_SMALL) || defined(CONFIG_IOB_LARGE)
+#  define IOB_HAVE_CLASSES       1
+#endif
+
 #if defined(CONFIG_DEBUG_FEATURES) && defined(CONFIG_IOB_DEBUG)
 #  define ioberr                 _err
 #  define iobwarn                _warn
@@ -83,6 +87,14 @@ extern sem_t g_iob_sem;
 
 extern volatile int16_t g_iob_count;
 
+/* Exhaustion statistics: the lowest number of free I/O buffers seen, the
+ * number of allocations that had to wait and the number that failed.
+ */
+
+extern volatile int16_t g_iob_minfree;
+extern volatile uint32_t g_iob_nwaited;
+extern volatile uint32_t g_iob_nfailed;
+
 #if CONFIG_IOB_THROTTLE > 0
 extern sem_t g_throttle_sem;
 
@@ -163,5 +175,109 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 void iob_notifier_signal(void);
 #endif
 
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Take the I/O buffer at the head of the free list, honoring the throttle
+ *   if 'throttled' is true.  The caller must hold g_iob_lock.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_internal(bool throttled);
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of pre-allocated I/O buffers, linked through io_flink, to
+ *   the free or the committed list taking g_iob_lock only once.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *iob);
+
+#ifdef IOB_HAVE_CLASSES
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the pools of the small and the large I/O buffer classes.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void);
+
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   Return an I/O buffer to the free list of its class.
+ *
+ * Returned Value:
+ *   True if the buffer belongs to the small or the large class;  false if
+ *   it is a buffer of the default pool.
+ *
+ ****************************************************************************/
+
+bool iob_class_free(FAR struct iob_s *iob);
+#endif
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+/****************************************************************************
+ * Name: iob_percpu_alloc
+ *
+ * Description:
+ *   Take a non-throttled I/O buffer from the cache of this CPU, refilling
+ *   the cache from the global free list in a batch if it is empty.
+ *
+ * Returned Value:
+ *   The I/O buffer in a known state;  NULL if neither the cache nor the
+ *   global free list has any.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_percpu_alloc(void);
+
+/****************************************************************************
+ * Name: iob_percpu_free
+ *
+ * Description:
+ *   Put a free I/O buffer into the cache of this CPU, spilling a batch to
+ *   the global free list if the cache is full.
+ *
+ * Returned Value:
+ *   True if the buffer was taken;  false if somebody waits for an I/O buffer
+ *   and the caller must free it to the global list.
+ *
+ ****************************************************************************/
+
+bool iob_percpu_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_percpu_drain
+ *
+ * Description:
+ *   Return the contents of all CPU caches to the global free list.
+ *
+ * Returned Value:
+ *   The number of I/O buffers returned.
+ *
+ ****************************************************************************/
+
+int iob_percpu_drain(void);
+
+/****************************************************************************
+ * Name: iob_percpu_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held in the CPU caches.  The value is
+ *   sampled without locking.
+ *
+ ****************************************************************************/
+
+int iob_percpu_navail(void);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
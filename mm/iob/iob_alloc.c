@@ -101,78 +101,6 @@ static FAR struct iob_s *iob_alloc_committed(void)
   return iob;
 }
 
-static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
-{
-  FAR struct iob_s *iob;
-#if CONFIG_IOB_THROTTLE > 0
-  int16_t count;
-#endif
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the count to check. */
-
-  count = (throttled ? g_throttle_count : g_iob_count);
-#endif
-
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
-   */
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
-
-  if (count > 0)
-#endif
-    {
-      /* Take the I/O buffer from the head of the free list */
-
-      iob = g_iob_freelist;
-      if (iob != NULL)
-        {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
-
-          g_iob_freelist = iob->io_flink;
-
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
-
-          g_iob_count--;
-          DEBUGASSERT(g_iob_count >= 0);
-
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is used to throttle the number of
-           * free buffers that are available.  It is used to prevent
-           * the overrunning of the free buffer list. Please note that
-           * it can only be decremented to zero, which indicates no
-           * throttled buffers are available.
-           */
-
-          if (g_throttle_count > 0)
-            {
-              g_throttle_count--;
-            }
-#endif
-
-          /* Put the I/O buffer in a known state */
-
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
-        }
-    }
-
-  return NULL;
-}
-
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -201,6 +129,19 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   sem = &g_iob_sem;
 #endif
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Non-throttled allocations are served by the cache of this CPU */
+
+  if (!throttled)
+    {
+      iob = iob_percpu_alloc();
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer allocations.  This is
    * not as bad as it sounds because interrupts will be re-enabled while
@@ -223,9 +164,18 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
        */
 
       (*count)--;
+      g_iob_nwaited++;
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+      /* Now that we are registered as a waiter, nothing new will be cached.
+       * Return whatever the CPU caches hold, the first buffers go to us.
+       */
+
+      iob_percpu_drain();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -246,6 +196,10 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
           iob = iob_alloc_committed();
           DEBUGASSERT(iob != NULL);
         }
+      else
+        {
+          g_iob_nfailed++;
+        }
 
       return iob;
     }
@@ -275,6 +229,92 @@ static void iob_free_dynamic(FAR void *data)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Take the I/O buffer at the head of the free list, honoring the throttle
+ *   if 'throttled' is true.  The caller must hold g_iob_lock.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_internal(bool throttled)
+{
+  FAR struct iob_s *iob;
+#if CONFIG_IOB_THROTTLE > 0
+  int16_t count;
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the count to check. */
+
+  count = (throttled ? g_throttle_count : g_iob_count);
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (count > 0)
+#endif
+    {
+      /* Take the I/O buffer from the head of the free list */
+
+      iob = g_iob_freelist;
+      if (iob != NULL)
+        {
+          /* Remove the I/O buffer from the free list and decrement the
+           * counting semaphore(s) that tracks the number of available
+           * IOBs.
+           */
+
+          g_iob_freelist = iob->io_flink;
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          g_iob_count--;
+          DEBUGASSERT(g_iob_count >= 0);
+
+          if (g_iob_count < g_iob_minfree)
+            {
+              g_iob_minfree = g_iob_count;
+            }
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is used to throttle the number of
+           * free buffers that are available.  It is used to prevent
+           * the overrunning of the free buffer list. Please note that
+           * it can only be decremented to zero, which indicates no
+           * throttled buffers are available.
+           */
+
+          if (g_throttle_count > 0)
+            {
+              g_throttle_count--;
+            }
+#endif
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          return iob;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: iob_timedalloc
  *
@@ -337,9 +377,39 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
    * to protect the free list:  We disable interrupts very briefly.
    */
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Non-throttled allocations are served by the cache of this CPU */
+
+  if (!throttled)
+    {
+      iob = iob_percpu_alloc();
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_iob_lock);
   iob = iob_tryalloc_internal(throttled);
   spin_unlock_irqrestore(&g_iob_lock, flags);
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Do not fail while other CPUs still cache free buffers */
+
+  if (iob == NULL && iob_percpu_drain() > 0)
+    {
+      flags = spin_lock_irqsave(&g_iob_lock);
+      iob = iob_tryalloc_internal(throttled);
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+    }
+#endif
+
+  if (iob == NULL)
+    {
+      g_iob_nfailed++;
+    }
+
   return iob;
 }
 
@@ -380,6 +450,9 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ROUNDUP((uintptr_t)(iob + 1),
                                                CONFIG_IOB_ALIGNMENT);
+#ifdef CONFIG_IOB_EXTBUF
+      iob->io_extbuf  = NULL;             /* No external buffer */
+#endif
     }
 
   return iob;
@@ -425,6 +498,9 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_pktlen  = 0;       /* Total length of the packet */
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
+#ifdef CONFIG_IOB_EXTBUF
+      iob->io_extbuf  = NULL;    /* No external buffer */
+#endif
     }
 
   return iob;
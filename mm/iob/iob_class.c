@@ -0,0 +1,342 @@
+/****************************************************************************
+ * mm/iob/iob_class.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_IOB_SMALL) && \
+    CONFIG_IOB_SMALL_BUFSIZE >= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_SMALL_BUFSIZE must be less than CONFIG_IOB_BUFSIZE
+#endif
+
+#if defined(CONFIG_IOB_LARGE) && \
+    CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_LARGE_BUFSIZE must be greater than CONFIG_IOB_BUFSIZE
+#endif
+
+/* Size of one I/O buffer of a class and of the raw memory of its pool */
+
+#define IOB_CLASS_ALIGN_SIZE(s) \
+  ROUNDUP(sizeof(struct iob_s) + (s), CONFIG_IOB_ALIGNMENT)
+
+#define IOB_CLASS_POOL_SIZE(s, n) \
+  (IOB_CLASS_ALIGN_SIZE(s) * (n) + CONFIG_IOB_ALIGNMENT - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef IOB_HAVE_CLASSES
+/* One pool of pre-allocated I/O buffers with a fixed payload size other
+ * than CONFIG_IOB_BUFSIZE.
+ */
+
+struct iob_class_s
+{
+  FAR struct iob_s *freelist;  /* Free I/O buffers of this class */
+  uintptr_t         start;     /* First I/O buffer of the pool */
+  uintptr_t         end;       /* End of the last I/O buffer of the pool */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SMALL
+#  ifdef IOB_SECTION
+static uint8_t g_iob_small_buffer[IOB_CLASS_POOL_SIZE(
+  CONFIG_IOB_SMALL_BUFSIZE, CONFIG_IOB_SMALL_NBUFFERS)]
+  locate_data(IOB_SECTION);
+#  else
+static uint8_t g_iob_small_buffer[IOB_CLASS_POOL_SIZE(
+  CONFIG_IOB_SMALL_BUFSIZE, CONFIG_IOB_SMALL_NBUFFERS)];
+#  endif
+
+static struct iob_class_s g_iob_small;
+#endif
+
+#ifdef CONFIG_IOB_LARGE
+#  ifdef IOB_SECTION
+static uint8_t g_iob_large_buffer[IOB_CLASS_POOL_SIZE(
+  CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_LARGE_NBUFFERS)]
+  locate_data(IOB_SECTION);
+#  else
+static uint8_t g_iob_large_buffer[IOB_CLASS_POOL_SIZE(
+  CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_LARGE_NBUFFERS)];
+#  endif
+
+static struct iob_class_s g_iob_large;
+#endif
+
+#ifdef IOB_HAVE_CLASSES
+static spinlock_t g_iob_class_lock = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef IOB_HAVE_CLASSES
+/****************************************************************************
+ * Name: iob_class_setup
+ *
+ * Description:
+ *   Divide the raw memory of a class pool into I/O buffers and put them on
+ *   the free list of the class.
+ *
+ ****************************************************************************/
+
+static void iob_class_setup(FAR struct iob_class_s *cls,
+                            FAR uint8_t *pool, uint16_t bufsize,
+                            int nbuffers)
+{
+  uintptr_t buf;
+  int i;
+
+  /* Align io_data of the first I/O buffer, the same as iob_initialize() */
+
+  buf = ROUNDUP((uintptr_t)pool + offsetof(struct iob_s, io_data),
+                CONFIG_IOB_ALIGNMENT) - offsetof(struct iob_s, io_data);
+
+  cls->start = buf;
+  cls->end   = buf + nbuffers * IOB_CLASS_ALIGN_SIZE(bufsize);
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob = (FAR struct iob_s *)
+                              (buf + i * IOB_CLASS_ALIGN_SIZE(bufsize));
+
+      iob->io_bufsize = bufsize;
+      iob->io_data    = (FAR uint8_t *)(iob + 1);
+      iob->io_flink   = cls->freelist;
+      cls->freelist   = iob;
+    }
+}
+
+/****************************************************************************
+ * Name: iob_class_tryalloc
+ *
+ * Description:
+ *   Take an I/O buffer from the free list of a class.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_class_tryalloc(FAR struct iob_class_s *cls)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_class_lock);
+
+  iob = cls->freelist;
+  if (iob != NULL)
+    {
+      cls->freelist = iob->io_flink;
+    }
+
+  spin_unlock_irqrestore(&g_iob_class_lock, flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_class_put
+ *
+ * Description:
+ *   Return an I/O buffer to its class if it belongs to the pool of 'cls'.
+ *
+ ****************************************************************************/
+
+static bool iob_class_put(FAR struct iob_class_s *cls,
+                          FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
+  if ((uintptr_t)iob < cls->start || (uintptr_t)iob >= cls->end)
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave(&g_iob_class_lock);
+  iob->io_flink = cls->freelist;
+  cls->freelist = iob;
+  spin_unlock_irqrestore(&g_iob_class_lock, flags);
+  return true;
+}
+#endif /* IOB_HAVE_CLASSES */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef IOB_HAVE_CLASSES
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the pools of the small and the large I/O buffer classes.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void)
+{
+#ifdef CONFIG_IOB_SMALL
+  iob_class_setup(&g_iob_small, g_iob_small_buffer,
+                  CONFIG_IOB_SMALL_BUFSIZE, CONFIG_IOB_SMALL_NBUFFERS);
+#endif
+
+#ifdef CONFIG_IOB_LARGE
+  iob_class_setup(&g_iob_large, g_iob_large_buffer,
+                  CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_LARGE_NBUFFERS);
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   Return an I/O buffer to the free list of the class it was allocated
+ *   from.
+ *
+ * Returned Value:
+ *   True if the buffer belongs to the small or the large class;  false if
+ *   it is a buffer of the default pool.
+ *
+ ****************************************************************************/
+
+bool iob_class_free(FAR struct iob_s *iob)
+{
+#ifdef CONFIG_IOB_SMALL
+  if (iob_class_put(&g_iob_small, iob))
+    {
+      return true;
+    }
+#endif
+
+#ifdef CONFIG_IOB_LARGE
+  if (iob_class_put(&g_iob_large, iob))
+    {
+      return true;
+    }
+#endif
+
+  return false;
+}
+#endif /* IOB_HAVE_CLASSES */
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate the smallest I/O buffer that can hold 'size' bytes,
+ *   falling back to a default I/O buffer, without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob = NULL;
+
+#ifdef CONFIG_IOB_SMALL
+  if (size <= CONFIG_IOB_SMALL_BUFSIZE)
+    {
+      iob = iob_class_tryalloc(&g_iob_small);
+    }
+#endif
+
+  if (iob == NULL && size <= CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc(throttled);
+    }
+
+#ifdef CONFIG_IOB_LARGE
+  /* When the default pool is exhausted a large buffer also serves smaller,
+   * non-throttled requests.  Throttled requests only take one that they
+   * really need so that the read-ahead cannot drain the large class.
+   */
+
+  if (iob == NULL && (size > CONFIG_IOB_BUFSIZE || !throttled))
+    {
+      iob = iob_class_tryalloc(&g_iob_large);
+    }
+#endif
+
+  /* Start a chain of default I/O buffers if nothing large enough is free */
+
+  if (iob == NULL && size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc(throttled);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate the smallest I/O buffer that can hold 'size' bytes, waiting
+ *   for a default I/O buffer if no buffer of a fitting class is free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_tryalloc_size(size, throttled);
+  if (iob == NULL)
+    {
+      iob = iob_alloc(throttled);
+    }
+
+  return iob;
+}
@@ -178,18 +178,19 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       if (len > 0 && !next)
         {
-          /* Yes.. allocate a new buffer.
+          /* Yes.. allocate a new buffer, the smallest one that holds the
+           * rest of the data if there is such.
            *
            * Copy as many bytes as possible. Block if we're allowed.
            */
 
           if (can_block)
             {
-              next = iob_alloc(throttled);
+              next = iob_alloc_size(len, throttled);
             }
           else
             {
-              next = iob_tryalloc(throttled);
+              next = iob_tryalloc_size(len, throttled);
             }
 
           if (next == NULL)
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * mm/iob/iob_extbuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_EXTBUF
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free_extbuf
+ *
+ * Description:
+ *   Free callback of an IOB referring to an external buffer.  Nothing to
+ *   do here:  iob_free() drops the reference to the external buffer.
+ *
+ ****************************************************************************/
+
+static void iob_free_extbuf(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_extbuf_init
+ *
+ * Description:
+ *   Initialize an external buffer descriptor.  The descriptor starts with
+ *   one reference that belongs to the caller and which must eventually be
+ *   dropped with iob_extbuf_put().
+ *
+ ****************************************************************************/
+
+void iob_extbuf_init(FAR struct iob_extbuf_s *ext,
+                     iob_extbuf_release_t release, FAR void *priv)
+{
+  DEBUGASSERT(ext != NULL && release != NULL);
+
+  atomic_init(&ext->refs, 1);
+  ext->release = release;
+  ext->priv    = priv;
+}
+
+/****************************************************************************
+ * Name: iob_extbuf_get
+ *
+ * Description:
+ *   Take an additional reference to an external buffer.
+ *
+ ****************************************************************************/
+
+void iob_extbuf_get(FAR struct iob_extbuf_s *ext)
+{
+  DEBUGASSERT(atomic_load(&ext->refs) > 0);
+  atomic_fetch_add(&ext->refs, 1);
+}
+
+/****************************************************************************
+ * Name: iob_extbuf_put
+ *
+ * Description:
+ *   Drop a reference to an external buffer, calling the release callback
+ *   when the last reference is dropped.
+ *
+ ****************************************************************************/
+
+void iob_extbuf_put(FAR struct iob_extbuf_s *ext)
+{
+  DEBUGASSERT(atomic_load(&ext->refs) > 0);
+
+  if (atomic_fetch_sub(&ext->refs, 1) == 1)
+    {
+      ext->release(ext);
+    }
+}
+
+/****************************************************************************
+ * Name: iob_alloc_extbuf
+ *
+ * Description:
+ *   Allocate an I/O buffer from heap that refers to 'size' bytes of the
+ *   external buffer 'ext' beginning at 'data'.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_extbuf(FAR struct iob_extbuf_s *ext,
+                                   FAR const void *data, uint16_t size)
+{
+  FAR struct iob_s *iob;
+
+  DEBUGASSERT(ext != NULL && data != NULL);
+
+  iob = kmm_malloc(sizeof(struct iob_s));
+  if (iob)
+    {
+      iob->io_flink   = NULL;            /* Not in a chain */
+      iob->io_len     = size;            /* The whole buffer is payload */
+      iob->io_offset  = 0;               /* Offset to the beginning of data */
+      iob->io_bufsize = size;            /* Total length of the iob buffer */
+      iob->io_pktlen  = size;            /* Total length of the packet */
+      iob->io_free    = iob_free_extbuf; /* Customer free callback */
+      iob->io_data    = (FAR uint8_t *)data;
+      iob->io_extbuf  = ext;             /* Hold a reference to ext */
+
+      iob_extbuf_get(ext);
+    }
+
+  return iob;
+}
+
+#endif /* CONFIG_IOB_EXTBUF */
@@ -67,6 +67,110 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of I/O buffers, linked through io_flink, to the free or to
+ *   the committed list, taking the lock only once.  Unlike iob_free() this
+ *   does not deal with I/O buffer chains:  io_pktlen is ignored and the
+ *   buffers must belong to the pre-allocated pool.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int nposts = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int nthrottle = 0;
+#endif
+
+  /* We don't know what context we are called from so we use extreme
+   * measures to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+
+      /* Which list?  If there is a task waiting for an IOB, then put
+       * the IOB on either the free list or on the committed list where
+       * it is reserved for that allocation (and not available to
+       * iob_tryalloc()). This is true for both throttled and non-throttled
+       * cases.
+       */
+
+#if CONFIG_IOB_THROTTLE > 0
+      if ((g_iob_count < 0) ||
+          ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
+           (g_throttle_count < 0)))
+#else
+      if (g_iob_count < 0)
+#endif
+        {
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+
+#if CONFIG_IOB_THROTTLE > 0
+          if (g_iob_count < 0)
+            {
+              g_iob_count++;
+              nposts++;
+            }
+          else
+            {
+              g_throttle_count++;
+              nthrottle++;
+            }
+#else
+          g_iob_count++;
+          nposts++;
+#endif
+        }
+      else
+        {
+          g_iob_count++;
+#if CONFIG_IOB_THROTTLE > 0
+          if (g_iob_count > CONFIG_IOB_THROTTLE)
+            {
+              g_throttle_count++;
+            }
+#endif
+
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  /* Wake up the waiters that the committed I/O buffers are reserved for */
+
+  while (nposts-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (nthrottle-- > 0)
+    {
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+  DEBUGASSERT(g_throttle_count <=
+              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -79,7 +183,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
   int16_t navail;
 #endif
@@ -121,78 +224,38 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
   if (iob->io_free != NULL)
     {
       iob->io_free(iob->io_data);
+#ifdef CONFIG_IOB_EXTBUF
+      if (iob->io_extbuf != NULL)
+        {
+          iob_extbuf_put(iob->io_extbuf);
+        }
+#endif
+
       kmm_free(iob);
       return next;
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
+#ifdef IOB_HAVE_CLASSES
+  /* Buffers of the small and the large class go back to their own pool */
 
-#if CONFIG_IOB_THROTTLE > 0
-  if ((g_iob_count < 0) ||
-      ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
-       (g_throttle_count < 0)))
-#else
-  if (g_iob_count < 0)
-#endif
+  if (iob_class_free(iob))
     {
-      FAR sem_t *sem;
-
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-
-#if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count < 0)
-        {
-          g_iob_count++;
-          sem = &g_iob_sem;
-        }
-      else
-        {
-          g_throttle_count++;
-          sem = &g_throttle_sem;
-        }
-#else
-      g_iob_count++;
-      sem = &g_iob_sem;
-#endif
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(sem);
+      return next;
     }
-  else
-    {
-      g_iob_count++;
-#if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count > CONFIG_IOB_THROTTLE)
-        {
-          g_throttle_count++;
-        }
 #endif
 
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-    }
-
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+  /* Keep the I/O buffer in the cache of this CPU if possible.  Otherwise
+   * free it by adding it to the head of the free or the committed list.
+   */
 
-#if CONFIG_IOB_THROTTLE > 0
-  DEBUGASSERT(g_throttle_count <=
-              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  if (!iob_percpu_free(iob))
 #endif
+    {
+      iob->io_flink = NULL;
+      iob_free_list(iob);
+    }
 
 #ifdef CONFIG_IOB_NOTIFIER
   /* Check if the IOB was claimed by a thread that is blocked waiting
@@ -97,6 +97,12 @@ sem_t g_iob_sem = SEM_INITIALIZER(0);
 
 volatile int16_t g_iob_count = CONFIG_IOB_NBUFFERS;
 
+/* Exhaustion statistics */
+
+volatile int16_t g_iob_minfree = CONFIG_IOB_NBUFFERS;
+volatile uint32_t g_iob_nwaited;
+volatile uint32_t g_iob_nfailed;
+
 #if CONFIG_IOB_THROTTLE > 0
 
 sem_t g_throttle_sem = SEM_INITIALIZER(0);
@@ -174,4 +180,10 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#ifdef IOB_HAVE_CLASSES
+  /* Set up the pools of the other I/O buffer size classes */
+
+  iob_class_initialize();
+#endif
 }
@@ -51,6 +51,15 @@ int iob_navail(bool throttled)
 #if CONFIG_IOB_NBUFFERS > 0
   ret = g_iob_count;
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Buffers held in the CPU caches are free, too */
+
+  if (ret >= 0)
+    {
+      ret += iob_percpu_navail();
+    }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* Subtract the throttle value is so requested */
 
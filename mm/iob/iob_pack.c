@@ -70,6 +70,16 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
     {
       next = iob->io_flink;
 
+      /* The payload of an external buffer is read-only:  it can neither
+       * be moved nor can anything be appended to it.
+       */
+
+      if (IOB_ISEXTBUF(iob))
+        {
+          iob = next;
+          continue;
+        }
+
       /* Eliminate the data offset in this entry */
 
       if (iob->io_offset > 0)
@@ -0,0 +1,307 @@
+/****************************************************************************
+ * mm/iob/iob_percpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of I/O buffers moved between a CPU cache and the global free list
+ * at a time.
+ */
+
+#define IOB_PERCPU_BATCH (CONFIG_IOB_PERCPU_CACHE_SIZE / 2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cache of free I/O buffers of one CPU.  The I/O buffers in a cache are
+ * accounted as allocated in g_iob_count and g_throttle_count.  The lock is
+ * only contended when another CPU drains the cache.
+ */
+
+struct iob_percpu_s
+{
+  spinlock_t        lock;   /* Protects the cache */
+  FAR struct iob_s *head;   /* List of cached I/O buffers */
+  int16_t           count;  /* Number of cached I/O buffers */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_percpu_s g_iob_percpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_percpu_waiting
+ *
+ * Description:
+ *   Return true if a thread is waiting for an I/O buffer.  No buffer may be
+ *   cached then:  it has to go to the committed list.
+ *
+ ****************************************************************************/
+
+static inline bool iob_percpu_waiting(void)
+{
+#if CONFIG_IOB_THROTTLE > 0
+  return g_iob_count < 0 || g_throttle_count < 0;
+#else
+  return g_iob_count < 0;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_percpu_alloc
+ *
+ * Description:
+ *   Take a non-throttled I/O buffer from the cache of this CPU, refilling
+ *   the cache from the global free list in a batch if it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_percpu_alloc(void)
+{
+  FAR struct iob_percpu_s *cache;
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int count = 0;
+
+  flags = up_irq_save();
+  cache = &g_iob_percpu[this_cpu()];
+
+  spin_lock(&cache->lock);
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+    }
+
+  spin_unlock(&cache->lock);
+
+  if (iob == NULL)
+    {
+      /* The cache is empty.  Take the buffer we need from the global free
+       * list, then up to a batch more for the cache.  These are taken as
+       * throttled allocations so that refilling never eats into the
+       * throttle reserve.
+       */
+
+      spin_lock(&g_iob_lock);
+
+      iob = iob_tryalloc_internal(false);
+      while (iob != NULL && count < IOB_PERCPU_BATCH)
+        {
+          next = iob_tryalloc_internal(true);
+          if (next == NULL)
+            {
+              break;
+            }
+
+          if (tail == NULL)
+            {
+              tail = next;
+            }
+
+          next->io_flink = head;
+          head = next;
+          count++;
+        }
+
+      spin_unlock(&g_iob_lock);
+
+      if (head != NULL)
+        {
+          spin_lock(&cache->lock);
+          tail->io_flink = cache->head;
+          cache->head    = head;
+          cache->count  += count;
+          spin_unlock(&cache->lock);
+        }
+    }
+
+  up_irq_restore(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_free
+ *
+ * Description:
+ *   Put a free I/O buffer into the cache of this CPU, spilling a batch to
+ *   the global free list if the cache is full.
+ *
+ ****************************************************************************/
+
+bool iob_percpu_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_percpu_s *cache;
+  FAR struct iob_s *spill = NULL;
+  FAR struct iob_s *tail;
+  irqstate_t flags;
+  int i;
+
+  flags = up_irq_save();
+  cache = &g_iob_percpu[this_cpu()];
+
+  spin_lock(&cache->lock);
+
+  /* The waiter registers itself before it drains the caches, so under the
+   * cache lock we either see the waiter or the waiter sees our buffer.
+   */
+
+  if (iob_percpu_waiting())
+    {
+      spin_unlock(&cache->lock);
+      up_irq_restore(flags);
+      return false;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  cache->count++;
+
+  if (cache->count > CONFIG_IOB_PERCPU_CACHE_SIZE)
+    {
+      /* The cache is full, spill a batch */
+
+      spill = cache->head;
+      for (tail = spill, i = 1; i < IOB_PERCPU_BATCH; i++)
+        {
+          tail = tail->io_flink;
+        }
+
+      cache->head    = tail->io_flink;
+      cache->count  -= IOB_PERCPU_BATCH;
+      tail->io_flink = NULL;
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+
+  if (spill != NULL)
+    {
+      iob_free_list(spill);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_drain
+ *
+ * Description:
+ *   Return the contents of all CPU caches to the global free list.
+ *
+ ****************************************************************************/
+
+int iob_percpu_drain(void)
+{
+  FAR struct iob_percpu_s *cache;
+  FAR struct iob_s *head;
+  irqstate_t flags;
+  int total = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_percpu[cpu];
+
+      flags = spin_lock_irqsave(&cache->lock);
+      head  = cache->head;
+      total += cache->count;
+      cache->head  = NULL;
+      cache->count = 0;
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (head != NULL)
+        {
+          iob_free_list(head);
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held in the CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_percpu_navail(void)
+{
+  int total = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      total += g_iob_percpu[cpu].count;
+    }
+
+  return total;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE */
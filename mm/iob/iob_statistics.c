@@ -65,6 +65,9 @@ void iob_getstats(FAR struct iob_stats_s *stats)
   else
     {
       stats->nwait = 0;
+#ifdef CONFIG_IOB_PERCPU_CACHE
+      stats->nfree += iob_percpu_navail();
+#endif
     }
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -78,6 +81,10 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
+
+  stats->nminfree = g_iob_minfree;
+  stats->nwaited  = g_iob_nwaited;
+  stats->nfailed  = g_iob_nfailed;
 }
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
@@ -27,9 +27,11 @@
 #include <nuttx/nuttx.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/compiler.h>
+#include <nuttx/seqlock.h>
 #include <nuttx/spinlock.h>
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -46,11 +48,23 @@
 
 #define KASAN_SHADOW_SCALE (sizeof(uintptr_t))
 
+/* The shadow words in the middle of a large range are scanned a group at
+ * a time: the words of a group are or'ed together and tested with a single
+ * branch.  Four words span 32 bytes of shadow, i.e. one cache line on most
+ * targets.
+ */
+
+#define KASAN_WORDS_PER_LINE 4
+
 #define KASAN_SHADOW_SIZE(size) \
   (KASAN_BYTES_PER_WORD * ((size) / KASAN_SHADOW_SCALE / KASAN_BITS_PER_WORD))
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
+/* Regions beyond the width of CONFIG_MM_KASAN_REGION_MASK are enabled */
+
+#define KASAN_REGION_MASK_BITS 32
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -59,91 +73,177 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;
   uintptr_t shadow[1];
 };
 
+/* The lookup table keeps its own copy of the bounds of each region, so
+ * that scanning it never reads the memory of a region that is being
+ * unregistered.
+ */
+
+struct kasan_entry_s
+{
+  uintptr_t                  begin;
+  uintptr_t                  end;
+  FAR struct kasan_region_s *region;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
+static struct kasan_entry_s g_region[CONFIG_MM_KASAN_REGIONS];
+static size_t g_region_last;
 static size_t g_region_count;
+static size_t g_region_seq;
+static seqcount_t g_region_sync;
 static spinlock_t g_lock;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+static inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr, size_t size)
+{
+  FAR struct kasan_region_s *region;
+  FAR struct kasan_entry_s *entry;
+  uint32_t seq;
+  size_t last;
+  size_t i;
+
+  /* The table is read without a lock and the lookup is retried if it was
+   * changed meanwhile.  Most accesses hit the same heap as the previous
+   * one, so the last matched entry is tried before scanning the table.
+   *
+   * The region itself is only used for an address inside it.  Its memory
+   * goes away with the heap it describes, and accessing a heap while it
+   * is being unregistered is already a bug of the caller.
+   */
+
+  do
+    {
+      seq    = read_seqcount_begin(&g_region_sync);
+      region = NULL;
+
+      last = g_region_last;
+      if (last < g_region_count && addr >= g_region[last].begin &&
+          addr < g_region[last].end)
+        {
+          region = g_region[last].region;
+        }
+      else
+        {
+          for (i = 0; i < g_region_count; i++)
+            {
+              entry = &g_region[i];
+              if (addr >= entry->begin && addr < entry->end)
+                {
+                  region        = entry->region;
+                  g_region_last = i;
+                  break;
+                }
+            }
+        }
+    }
+  while (read_seqcount_retry(&g_region_sync, seq));
+
+  DEBUGASSERT(region == NULL || addr + size <= region->end);
+  return region;
+}
+
 static inline_function FAR uintptr_t *
 kasan_mem_to_shadow(FAR const void *ptr, size_t size,
                     FAR unsigned int *bit)
 {
+  FAR struct kasan_region_s *region;
   uintptr_t addr = (uintptr_t)ptr;
-  size_t i;
 
-  for (i = 0; i < g_region_count; i++)
+  region = kasan_find_region(addr, size);
+  if (region == NULL)
     {
-      if (addr >= g_region[i]->begin && addr < g_region[i]->end)
-        {
-          DEBUGASSERT(addr + size <= g_region[i]->end);
-          addr -= g_region[i]->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &g_region[i]->shadow[addr / KASAN_BITS_PER_WORD];
-        }
+      return NULL;
     }
 
-  return NULL;
+  addr -= region->begin;
+  addr /= KASAN_SHADOW_SCALE;
+  *bit  = addr % KASAN_BITS_PER_WORD;
+  return &region->shadow[addr / KASAN_BITS_PER_WORD];
 }
 
 static inline_function bool
 kasan_is_poisoned(FAR const void *addr, size_t size)
 {
-  FAR uintptr_t *p;
-  unsigned int bit;
-  unsigned int nbit;
-  uintptr_t mask;
+  FAR struct kasan_region_s *region;
+  FAR const uintptr_t *p;
+  FAR const uintptr_t *end;
+  uintptr_t first;
+  uintptr_t last;
+  uintptr_t acc;
+  size_t i;
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
-  if (p == NULL)
+  region = kasan_find_region((uintptr_t)addr, size);
+  if (region == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
     }
 
-  if (size <= KASAN_SHADOW_SCALE)
+  if (!region->enabled)
     {
-      return ((*p >> bit) & 1);
+      return false;
     }
 
-  nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
-  mask = KASAN_FIRST_WORD_MASK(bit);
-  size = ALIGN_UP(size, KASAN_SHADOW_SCALE);
-  size /= KASAN_SHADOW_SCALE;
+  /* Index of the first and of the last shadow bit covered by the access.
+   * An unaligned access may straddle two granules even when it is no
+   * larger than one.
+   */
 
-  while (size >= nbit)
+  first = ((uintptr_t)addr - region->begin) / KASAN_SHADOW_SCALE;
+  last  = ((uintptr_t)addr + size - 1 - region->begin) /
+          KASAN_SHADOW_SCALE;
+
+  p   = &region->shadow[first / KASAN_BITS_PER_WORD];
+  end = &region->shadow[last / KASAN_BITS_PER_WORD];
+
+  if (p == end)
+    {
+      return (*p & KASAN_FIRST_WORD_MASK(first) &
+              KASAN_LAST_WORD_MASK(last + 1)) != 0;
+    }
+
+  if ((*p++ & KASAN_FIRST_WORD_MASK(first)) != 0)
+    {
+      return true;
+    }
+
+  /* Whole shadow words in between, a cache line at a time */
+
+  while (end - p >= KASAN_WORDS_PER_LINE)
     {
-      if ((*p++ & mask) != 0)
+      acc = 0;
+      for (i = 0; i < KASAN_WORDS_PER_LINE; i++)
         {
-          return true;
+          acc |= p[i];
         }
 
-      bit  += nbit;
-      size -= nbit;
+      if (acc != 0)
+        {
+          return true;
+        }
 
-      nbit = KASAN_BITS_PER_WORD;
-      mask = UINTPTR_MAX;
+      p += KASAN_WORDS_PER_LINE;
     }
 
-  if (size)
+  while (p < end)
     {
-      mask &= KASAN_LAST_WORD_MASK(bit + size);
-      if ((*p & mask) != 0)
+      if (*p++ != 0)
         {
           return true;
         }
     }
 
-  return false;
+  return (*end & KASAN_LAST_WORD_MASK(last + 1)) != 0;
 }
 
 static void kasan_set_poison(FAR const void *addr, size_t size,
@@ -233,8 +333,19 @@ void kasan_register(FAR void *addr, FAR size_t *size)
 
   flags = spin_lock_irqsave(&g_lock);
 
-  DEBUGASSERT(g_region_count <= CONFIG_MM_KASAN_REGIONS);
-  g_region[g_region_count++] = region;
+  region->enabled = g_region_seq >= KASAN_REGION_MASK_BITS ||
+                    (((uint32_t)CONFIG_MM_KASAN_REGION_MASK >>
+                      g_region_seq) & 1) != 0;
+  g_region_seq++;
+
+  DEBUGASSERT(g_region_count < CONFIG_MM_KASAN_REGIONS);
+
+  write_seqcount_begin(&g_region_sync);
+  g_region[g_region_count].begin  = region->begin;
+  g_region[g_region_count].end    = region->end;
+  g_region[g_region_count].region = region;
+  g_region_count++;
+  write_seqcount_end(&g_region_sync);
 
   spin_unlock_irqrestore(&g_lock, flags);
 
@@ -251,14 +362,39 @@ void kasan_unregister(FAR void *addr)
   flags = spin_lock_irqsave(&g_lock);
   for (i = 0; i < g_region_count; i++)
     {
-      if (g_region[i]->begin == (uintptr_t)addr)
+      if (g_region[i].begin == (uintptr_t)addr)
         {
+          write_seqcount_begin(&g_region_sync);
           g_region_count--;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
+          write_seqcount_end(&g_region_sync);
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+}
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+  irqstate_t flags;
+  int ret = -ENOENT;
+  size_t i;
+
+  flags = spin_lock_irqsave(&g_lock);
+  for (i = 0; i < g_region_count; i++)
+    {
+      region = g_region[i].region;
+      if ((uintptr_t)addr >= region->begin && (uintptr_t)addr < region->end)
+        {
+          region->enabled = enable;
+          ret = OK;
           break;
         }
     }
 
   spin_unlock_irqrestore(&g_lock, flags);
+  return ret;
 }
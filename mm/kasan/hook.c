@@ -269,6 +269,35 @@ void kasan_stop(void)
 }
 #endif
 
+/****************************************************************************
+ * Name: kasan_check_range
+ *
+ * Description:
+ *   Validate a whole memory range against the shadow with one call.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KASAN
+void kasan_check_range(FAR const void *addr, size_t size, bool is_write)
+{
+#  ifdef CONFIG_MM_KASAN_DISABLE_READS_CHECK
+  if (!is_write)
+    {
+      return;
+    }
+#  endif
+
+#  ifdef CONFIG_MM_KASAN_DISABLE_WRITES_CHECK
+  if (is_write)
+    {
+      return;
+    }
+#  endif
+
+  kasan_check_report(addr, size, is_write, return_address(0));
+}
+#endif
+
 /****************************************************************************
  * Name: kasan_debugpoint
  *
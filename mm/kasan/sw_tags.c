@@ -27,6 +27,7 @@
 #include <nuttx/spinlock.h>
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -52,6 +53,10 @@
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
+/* Regions beyond the width of CONFIG_MM_KASAN_REGION_MASK are enabled */
+
+#define KASAN_REGION_MASK_BITS 32
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -60,6 +65,7 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;
   uint8_t   shadow[1];
 };
 
@@ -69,6 +75,7 @@ struct kasan_region_s
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
 static int g_region_count;
+static size_t g_region_seq;
 static spinlock_t g_lock;
 
 /****************************************************************************
@@ -76,7 +83,8 @@ static spinlock_t g_lock;
  ****************************************************************************/
 
 static inline_function FAR uint8_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size)
+kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+                    FAR bool *enabled)
 {
   uintptr_t addr;
   int i;
@@ -88,6 +96,7 @@ kasan_mem_to_shadow(FAR const void *ptr, size_t size)
       if (addr >= g_region[i]->begin && addr < g_region[i]->end)
         {
           DEBUGASSERT(addr + size <= g_region[i]->end);
+          *enabled = g_region[i]->enabled;
           addr -= g_region[i]->begin;
           return &g_region[i]->shadow[addr / KASAN_SHADOW_SCALE];
         }
@@ -100,6 +109,7 @@ static inline_function bool
 kasan_is_poisoned(FAR const void *addr, size_t size)
 {
   FAR uint8_t *p;
+  bool enabled;
   uint8_t tag;
 
   tag = kasan_get_tag(addr);
@@ -111,12 +121,17 @@ kasan_is_poisoned(FAR const void *addr, size_t size)
     }
 #endif
 
-  p = kasan_mem_to_shadow(addr, size);
+  p = kasan_mem_to_shadow(addr, size, &enabled);
   if (p == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
     }
 
+  if (!enabled)
+    {
+      return false;
+    }
+
   size = KASAN_SHADOW_SIZE(size);
   while (size--)
     {
@@ -134,8 +149,9 @@ static void kasan_set_poison(FAR const void *addr,
 {
   irqstate_t flags;
   FAR uint8_t *p;
+  bool enabled;
 
-  p = kasan_mem_to_shadow(addr, size);
+  p = kasan_mem_to_shadow(addr, size, &enabled);
   if (p == NULL)
     {
       return;
@@ -188,6 +204,11 @@ void kasan_register(FAR void *addr, FAR size_t *size)
 
   flags = spin_lock_irqsave(&g_lock);
 
+  region->enabled = g_region_seq >= KASAN_REGION_MASK_BITS ||
+                    (((uint32_t)CONFIG_MM_KASAN_REGION_MASK >>
+                      g_region_seq) & 1) != 0;
+  g_region_seq++;
+
   DEBUGASSERT(g_region_count <= CONFIG_MM_KASAN_REGIONS);
   g_region[g_region_count++] = region;
 
@@ -217,3 +238,29 @@ void kasan_unregister(FAR void *addr)
 
   spin_unlock_irqrestore(&g_lock, flags);
 }
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+  irqstate_t flags;
+  uintptr_t ptr;
+  int ret = -ENOENT;
+  int i;
+
+  ptr   = (uintptr_t)kasan_reset_tag(addr);
+  flags = spin_lock_irqsave(&g_lock);
+
+  for (i = 0; i < g_region_count; i++)
+    {
+      region = g_region[i];
+      if (ptr >= region->begin && ptr < region->end)
+        {
+          region->enabled = enable;
+          ret = OK;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+  return ret;
+}
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -44,7 +45,11 @@
 
 FAR void *kmm_calloc(size_t n, size_t elem_size)
 {
-  return mm_calloc(g_kmmheap, n, elem_size);
+  FAR void *mem;
+
+  mem = mm_calloc(g_kmmheap, n, elem_size);
+  heapprof_alloc(mem, n * elem_size);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -29,6 +29,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -55,6 +56,7 @@
 void kmm_free(FAR void *mem)
 {
   DEBUGASSERT((mem == NULL) || kmm_heapmember(mem));
+  heapprof_free(mem);
   mm_free(g_kmmheap, mem);
 }
 
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -50,7 +51,11 @@
 
 FAR void *kmm_malloc(size_t size)
 {
-  return mm_malloc(g_kmmheap, size);
+  FAR void *mem;
+
+  mem = mm_malloc(g_kmmheap, size);
+  heapprof_alloc(mem, size);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
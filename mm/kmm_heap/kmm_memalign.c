@@ -28,6 +28,7 @@
 
 #include <stdlib.h>
 
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -53,7 +54,11 @@
 
 FAR void *kmm_memalign(size_t alignment, size_t size)
 {
-  return mm_memalign(g_kmmheap, alignment, size);
+  FAR void *mem;
+
+  mem = mm_memalign(g_kmmheap, alignment, size);
+  heapprof_alloc(mem, size);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
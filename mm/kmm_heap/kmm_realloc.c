@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -51,7 +52,15 @@
 
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 {
-  return mm_realloc(g_kmmheap, oldmem, newsize);
+  FAR void *mem;
+
+  /* The old memory may be reused by others once it is reallocated */
+
+  heapprof_free(oldmem);
+
+  mem = mm_realloc(g_kmmheap, oldmem, newsize);
+  heapprof_alloc(mem, newsize);
+  return mem;
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
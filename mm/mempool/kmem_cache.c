@@ -0,0 +1,279 @@
+/****************************************************************************
+ * mm/mempool/kmem_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/kmem_cache.h>
+#include <nuttx/nuttx.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_pool_alloc
+ *
+ * Description:
+ *   Get the memory for an expansion of the pool of a cache.  Successive
+ *   expansions start at successive colors, the memory is aligned so that
+ *   kmem_cache_pool_free() can find its start again.  Concurrent expansions
+ *   may pick the same color, which is harmless.
+ *
+ ****************************************************************************/
+
+static FAR void *kmem_cache_pool_alloc(FAR struct mempool_s *pool,
+                                       size_t size)
+{
+  FAR struct kmem_cache_s *cache = (FAR struct kmem_cache_s *)pool;
+  size_t color = cache->color;
+  FAR char *base;
+
+  base = kmm_memalign(cache->align, size + cache->colormax);
+  if (base == NULL)
+    {
+      return NULL;
+    }
+
+  cache->color = color < cache->colormax ? color + cache->colorstep : 0;
+  return base + color;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_pool_free
+ ****************************************************************************/
+
+static void kmem_cache_pool_free(FAR struct mempool_s *pool,
+                                 FAR void *addr)
+{
+  FAR struct kmem_cache_s *cache = (FAR struct kmem_cache_s *)pool;
+
+  kmm_free((FAR void *)ALIGN_DOWN((uintptr_t)addr, cache->align));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmem_cache_create
+ *
+ * Description:
+ *   Create a cache of objects of the given size.  The objects are taken
+ *   from the kernel heap CONFIG_MM_KMEM_CACHE_EXPAND_SIZE bytes at a time
+ *   and are never returned to the heap before kmem_cache_destroy().
+ *
+ * Input Parameters:
+ *   name  - The name of the cache, reported in /proc/mempool.  The string
+ *           must stay valid while the cache exists.
+ *   size  - The size of an object.
+ *   align - The alignment of an object, zero for the natural alignment of
+ *           the heap.  Must be a power of two.
+ *   ctor  - The constructor, or NULL.
+ *   dtor  - The destructor, or NULL.
+ *
+ * Returned Value:
+ *   The new cache on success; NULL if there is not enough memory.
+ *
+ ****************************************************************************/
+
+FAR struct kmem_cache_s *kmem_cache_create(FAR const char *name,
+                                           size_t size, size_t align,
+                                           kmem_cache_ctor_t ctor,
+                                           kmem_cache_dtor_t dtor)
+{
+  FAR struct kmem_cache_s *cache;
+  size_t expandsize;
+  size_t blocksize;
+  size_t linesize;
+  size_t slack;
+
+  DEBUGASSERT(size > 0 && (align & (align - 1)) == 0);
+
+  /* The objects of an expansion follow each other, with a backtrace the
+   * distance between them is only aligned to MEMPOOL_ALIGN.
+   */
+
+  align = MAX(align, MEMPOOL_ALIGN);
+  DEBUGASSERT(CONFIG_MM_BACKTRACE < 0 || align == MEMPOOL_ALIGN);
+
+  cache = kmm_zalloc(sizeof(struct kmem_cache_s));
+  if (cache == NULL)
+    {
+      return NULL;
+    }
+
+  cache->pool.blocksize = ALIGN_UP(size, align);
+  cache->pool.alloc     = kmem_cache_pool_alloc;
+  cache->pool.free      = kmem_cache_pool_free;
+  cache->ctor           = ctor;
+  cache->dtor           = dtor;
+
+  /* Request only the memory the pool really uses from each expansion, the
+   * slack after the last object is used for coloring instead.
+   */
+
+  blocksize  = MEMPOOL_REALBLOCKSIZE(&cache->pool);
+  expandsize = MAX(CONFIG_MM_KMEM_CACHE_EXPAND_SIZE,
+                   blocksize + sizeof(sq_entry_t));
+  slack      = (expandsize - sizeof(sq_entry_t)) % blocksize;
+
+  cache->pool.expandsize = expandsize - slack;
+
+  linesize = up_get_dcache_linesize();
+  if (linesize > 0)
+    {
+      cache->colorstep = MAX(linesize, align);
+      cache->colormax  = ALIGN_DOWN(slack, cache->colorstep);
+    }
+
+  /* The expansion memory is aligned beyond the largest color so that the
+   * color can be stripped again when it is freed.
+   */
+
+  cache->align = align;
+  while (cache->align <= cache->colormax)
+    {
+      cache->align <<= 1;
+    }
+
+  if (mempool_init(&cache->pool, name) < 0)
+    {
+      kmm_free(cache);
+      return NULL;
+    }
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_destroy
+ *
+ * Description:
+ *   Destroy a cache and return all of its memory to the kernel heap.
+ *
+ * Input Parameters:
+ *   cache - The cache to destroy.
+ *
+ * Returned Value:
+ *   Zero on success; -EBUSY if objects of the cache are still allocated.
+ *
+ ****************************************************************************/
+
+int kmem_cache_destroy(FAR struct kmem_cache_s *cache)
+{
+  int ret;
+
+  ret = mempool_deinit(&cache->pool);
+  if (ret >= 0)
+    {
+      kmm_free(cache);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_alloc
+ *
+ * Description:
+ *   Allocate an object from the cache and run the constructor on it.
+ *
+ * Input Parameters:
+ *   cache - The cache to allocate from.
+ *
+ * Returned Value:
+ *   The object on success; NULL if there is not enough memory.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_alloc(FAR struct kmem_cache_s *cache)
+{
+  FAR void *obj = mempool_allocate(&cache->pool);
+
+  if (obj != NULL && cache->ctor != NULL)
+    {
+      cache->ctor(obj);
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_zalloc
+ *
+ * Description:
+ *   The same as kmem_cache_alloc() except that the object is zeroed
+ *   before the constructor runs.
+ *
+ ****************************************************************************/
+
+FAR void *kmem_cache_zalloc(FAR struct kmem_cache_s *cache)
+{
+  FAR void *obj = mempool_allocate(&cache->pool);
+
+  if (obj != NULL)
+    {
+      memset(obj, 0, cache->pool.blocksize);
+      if (cache->ctor != NULL)
+        {
+          cache->ctor(obj);
+        }
+    }
+
+  return obj;
+}
+
+/****************************************************************************
+ * Name: kmem_cache_free
+ *
+ * Description:
+ *   Run the destructor on an object and give it back to its cache.
+ *
+ * Input Parameters:
+ *   cache - The cache the object was allocated from.
+ *   obj   - The object to release.
+ *
+ ****************************************************************************/
+
+void kmem_cache_free(FAR struct kmem_cache_s *cache, FAR void *obj)
+{
+  if (obj != NULL)
+    {
+      if (cache->dtor != NULL)
+        {
+          cache->dtor(obj);
+        }
+
+      mempool_release(&cache->pool, obj);
+    }
+}
@@ -98,6 +98,231 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+/* The per-CPU free lists are not used by pools that wait for free blocks,
+ * so that a waiter never starves while other CPUs cache free blocks, and
+ * not for the blocks of the interrupt reserve.
+ */
+
+static inline bool mempool_percpu_usable(FAR struct mempool_s *pool)
+{
+  return !pool->wait;
+}
+
+static FAR struct mempool_percpu_s *
+mempool_percpu_lock(FAR struct mempool_s *pool, FAR irqstate_t *flags)
+{
+  FAR struct mempool_percpu_s *percpu;
+
+  *flags = up_irq_save();
+  percpu = &pool->percpu[this_cpu()];
+  spin_lock_wo_note(&percpu->lock);
+
+  return percpu;
+}
+
+static inline void mempool_percpu_unlock(FAR struct mempool_percpu_s *percpu,
+                                         irqstate_t flags)
+{
+  spin_unlock_wo_note(&percpu->lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_remove
+ *
+ * Description:
+ *   Take a block from the free list of the current CPU.  When the list is
+ *   empty, refill it with a batch of blocks from the shared free queue
+ *   while holding the pool lock only once.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_percpu_remove(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_percpu_s *percpu;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  if (!mempool_percpu_usable(pool))
+    {
+      return NULL;
+    }
+
+  percpu = mempool_percpu_lock(pool, &flags);
+  if (percpu->head == NULL)
+    {
+      spin_lock_wo_note(&pool->lock);
+      while (percpu->count < CONFIG_MM_MEMPOOL_PERCPU_BATCH &&
+             (blk = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          blk->flink   = percpu->head;
+          percpu->head = blk;
+          percpu->count++;
+        }
+
+      /* Blocks held by the CPU count as allocated for the shared queue */
+
+      pool->nalloc += percpu->count;
+      spin_unlock_wo_note(&pool->lock);
+    }
+
+  blk = percpu->head;
+  if (blk != NULL)
+    {
+      percpu->head = blk->flink;
+      percpu->count--;
+      blk->flink   = NULL;
+    }
+
+  mempool_percpu_unlock(percpu, flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_add
+ *
+ * Description:
+ *   Put a released block on the free list of the current CPU.  When the
+ *   list has grown to two batches, one batch is returned to the shared free
+ *   queue while holding the pool lock only once.
+ *
+ * Returned Value:
+ *   true if the block was taken by the free list of the CPU.
+ *
+ ****************************************************************************/
+
+static bool mempool_percpu_add(FAR struct mempool_s *pool, FAR void *blk)
+{
+  FAR struct mempool_percpu_s *percpu;
+  FAR sq_entry_t *entry = blk;
+  irqstate_t flags;
+  size_t n;
+
+  if (!mempool_percpu_usable(pool) ||
+      (pool->ibase != NULL && (FAR char *)blk >= pool->ibase &&
+       (FAR char *)blk < pool->ibase + pool->interruptsize))
+    {
+      return false;
+    }
+
+  percpu = mempool_percpu_lock(pool, &flags);
+
+  entry->flink = percpu->head;
+  percpu->head = entry;
+  percpu->count++;
+  kasan_poison(blk, pool->blocksize);
+
+  if (percpu->count >= 2 * CONFIG_MM_MEMPOOL_PERCPU_BATCH)
+    {
+      spin_lock_wo_note(&pool->lock);
+      for (n = 0; n < CONFIG_MM_MEMPOOL_PERCPU_BATCH; n++)
+        {
+          entry        = percpu->head;
+          percpu->head = entry->flink;
+          sq_addlast(entry, &pool->queue);
+        }
+
+      percpu->count -= CONFIG_MM_MEMPOOL_PERCPU_BATCH;
+      pool->nalloc  -= CONFIG_MM_MEMPOOL_PERCPU_BATCH;
+      spin_unlock_wo_note(&pool->lock);
+    }
+
+  mempool_percpu_unlock(percpu, flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_count
+ *
+ * Description:
+ *   Return the number of free blocks held by all CPUs.
+ *
+ ****************************************************************************/
+
+static size_t mempool_percpu_count(FAR struct mempool_s *pool)
+{
+  irqstate_t flags;
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      flags  = spin_lock_irqsave_wo_note(&pool->percpu[cpu].lock);
+      count += pool->percpu[cpu].count;
+      spin_unlock_irqrestore_wo_note(&pool->percpu[cpu].lock, flags);
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_drain
+ *
+ * Description:
+ *   Return the free blocks held by all CPUs to the shared free queue.
+ *
+ * Returned Value:
+ *   The number of blocks returned.
+ *
+ ****************************************************************************/
+
+static size_t mempool_percpu_drain(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_percpu_s *percpu;
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      percpu = &pool->percpu[cpu];
+      flags  = spin_lock_irqsave_wo_note(&percpu->lock);
+      spin_lock_wo_note(&pool->lock);
+
+      while ((entry = percpu->head) != NULL)
+        {
+          percpu->head = entry->flink;
+          sq_addlast(entry, &pool->queue);
+        }
+
+      pool->nalloc -= percpu->count;
+      count        += percpu->count;
+      percpu->count = 0;
+
+      spin_unlock_wo_note(&pool->lock);
+      spin_unlock_irqrestore_wo_note(&percpu->lock, flags);
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: mempool_percpu_reclaim
+ *
+ * Description:
+ *   Called when the shared free queue is empty.  Take back the free blocks
+ *   cached by the CPUs, so that an allocation does not fail, or expand the
+ *   pool, while the pool still has free blocks.
+ *
+ * Returned Value:
+ *   true if any block was returned to the shared free queue.
+ *
+ ****************************************************************************/
+
+static bool mempool_percpu_reclaim(FAR struct mempool_s *pool)
+{
+  return mempool_percpu_usable(pool) && mempool_percpu_drain(pool) > 0;
+}
+#else
+#  define mempool_percpu_remove(pool)    NULL
+#  define mempool_percpu_add(pool, blk)  false
+#  define mempool_percpu_count(pool)     0
+#  define mempool_percpu_drain(pool)
+#  define mempool_percpu_reclaim(pool)   false
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -253,6 +478,9 @@ mempool_memdump_free_callback(FAR struct mempool_s *pool,
 int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  int i;
+#endif
 
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
@@ -303,6 +531,15 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
     }
 
   spin_initialize(&pool->lock, SP_UNLOCKED);
+#ifdef CONFIG_MM_MEMPOOL_PERCPU
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      spin_initialize(&pool->percpu[i].lock, SP_UNLOCKED);
+      pool->percpu[i].head  = NULL;
+      pool->percpu[i].count = 0;
+    }
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_init(&pool->waitsem, 0, 0);
@@ -341,10 +578,37 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
 {
   FAR sq_entry_t *blk;
   irqstate_t flags;
+  bool reclaimed = false;
+
+  blk = mempool_percpu_remove(pool);
+  if (blk != NULL)
+    {
+      goto out;
+    }
 
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
+  if (blk == NULL)
+    {
+      /* The CPU lists are locked before the pool, so release the pool
+       * lock while they are drained.
+       */
+
+      if (!reclaimed)
+        {
+          spin_unlock_irqrestore(&pool->lock, flags);
+          reclaimed = true;
+          if (mempool_percpu_reclaim(pool))
+            {
+              goto retry;
+            }
+
+          flags = spin_lock_irqsave(&pool->lock);
+          blk = mempool_remove_queue(pool, &pool->queue);
+        }
+    }
+
   if (blk == NULL)
     {
       if (up_interrupt_context())
@@ -395,6 +659,8 @@ retry:
 
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
+
+out:
   blk = kasan_unpoison(blk, pool->blocksize);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_ALLOC_MAGIC, pool->blocksize);
@@ -421,8 +687,8 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -434,12 +700,18 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
 #endif
 
-  pool->nalloc--;
-
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_FREE_MAGIC, pool->blocksize);
 #endif
 
+  if (mempool_percpu_add(pool, blk))
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&pool->lock);
+  pool->nalloc--;
+
   if (pool->interruptsize > blocksize)
     {
       if ((FAR char *)blk >= pool->ibase &&
@@ -489,13 +761,15 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   irqstate_t flags;
+  size_t cached;
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
+  cached = mempool_percpu_count(pool);
   flags = spin_lock_irqsave(&pool->lock);
-  info->ordblks = sq_count(&pool->queue);
+  info->ordblks = sq_count(&pool->queue) + cached;
   info->iordblks = sq_count(&pool->iqueue);
-  info->aordblks = pool->nalloc;
+  info->aordblks = pool->nalloc - cached;
   info->arena = sq_count(&pool->equeue) * sizeof(sq_entry_t) +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
@@ -524,6 +798,7 @@ mempool_info_task(FAR struct mempool_s *pool,
                   FAR const struct malltask *task)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  size_t cached = mempool_percpu_count(pool);
   struct mallinfo_task info =
     {
       0, 0
@@ -533,7 +808,7 @@ mempool_info_task(FAR struct mempool_s *pool,
     {
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
-                     sq_count(&pool->iqueue);
+                     sq_count(&pool->iqueue) + cached;
 
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
@@ -541,8 +816,8 @@ mempool_info_task(FAR struct mempool_s *pool,
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      info.aordblks += pool->nalloc - cached;
+      info.uordblks += (pool->nalloc - cached) * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -611,6 +886,7 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+  mempool_percpu_drain(pool);
   if (pool->nalloc != 0)
     {
       return -EBUSY;
@@ -25,10 +25,12 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <limits.h>
 #include <strings.h>
 #include <syslog.h>
 #include <sys/param.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/mutex.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
@@ -46,6 +48,14 @@ struct mpool_dict_s
   size_t                size; /* Record expand memary size */
 };
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+struct mpool_stats_s
+{
+  atomic_ulong nrequest;  /* Number of requests served by the pool */
+  atomic_ulong nbytes;    /* Sum of the sizes requested from the pool */
+};
+#endif
+
 struct mpool_chunk_s
 {
   sq_entry_t entry;
@@ -93,12 +103,48 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+  /* The request statistics: a histogram of the requested sizes in steps
+   * of granule bytes, the requests served by each pool and the requests
+   * too large for any pool.
+   */
+
+  FAR struct mpool_stats_s     *stats;
+  FAR atomic_ulong             *histogram;
+  size_t                        nhistogram;
+  size_t                        granule;
+  atomic_ulong                  overflow;
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+static void mempool_multiple_record(FAR struct mempool_multiple_s *mpool,
+                                    FAR struct mempool_s *pool, size_t size)
+{
+  if (pool == NULL)
+    {
+      if (mpool != NULL)
+        {
+          atomic_fetch_add(&mpool->overflow, 1);
+        }
+
+      return;
+    }
+
+  atomic_fetch_add(&mpool->histogram[size > 0 ?
+                                     (size - 1) / mpool->granule : 0], 1);
+  atomic_fetch_add(&mpool->stats[pool - mpool->pools].nrequest, 1);
+  atomic_fetch_add(&mpool->stats[pool - mpool->pools].nbytes, size);
+}
+#else
+#  define mempool_multiple_record(mpool, pool, size)
+#endif
+
 static inline FAR struct mempool_s *
 mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
 {
@@ -405,6 +451,10 @@ mempool_multiple_init(FAR const char *name,
   FAR struct mempool_s *pools;
   size_t maxpoolszie;
   size_t minpoolsize;
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+  size_t nhistogram;
+  size_t granule;
+#endif
   int ret;
   int i;
 
@@ -428,9 +478,28 @@ mempool_multiple_init(FAR const char *name,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+  /* The histogram steps by the largest power of two dividing all block
+   * sizes, so that every block size ends a step.
+   */
+
+  for (granule = 0, i = 0; i < npools; i++)
+    {
+      granule |= poolsize[i];
+    }
+
+  granule &= -granule;
+  nhistogram = (maxpoolszie + granule - 1) / granule;
+#endif
+
   mpool = alloc(arg, sizeof(uintptr_t),
                 sizeof(struct mempool_multiple_s) +
-                npools * sizeof(struct mempool_s));
+                npools * sizeof(struct mempool_s)
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+                + npools * sizeof(struct mpool_stats_s) +
+                nhistogram * sizeof(atomic_ulong)
+#endif
+                );
 
   if (mpool == NULL)
     {
@@ -453,6 +522,14 @@ mempool_multiple_init(FAR const char *name,
   mpool->minpoolsize = minpoolsize;
   mpool->delta = 0;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+  mpool->stats = (FAR struct mpool_stats_s *)(pools + npools);
+  mpool->histogram = (FAR atomic_ulong *)(mpool->stats + npools);
+  mpool->nhistogram = nhistogram;
+  mpool->granule = granule;
+  mempool_multiple_resetstats(mpool);
+#endif
+
   for (i = 0; i < npools; i++)
     {
       pools[i].blocksize = poolsize[i];
@@ -541,6 +618,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
     {
+      mempool_multiple_record(mpool, NULL, size);
       return NULL;
     }
 
@@ -551,6 +629,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
 
       if (blk)
         {
+          mempool_multiple_record(mpool, pool, size);
           return blk;
         }
     }
@@ -707,6 +786,7 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
   pool = mempool_multiple_find(mpool, size + alignment);
   if (pool == NULL)
     {
+      mempool_multiple_record(mpool, NULL, size + alignment);
       return NULL;
     }
 
@@ -716,6 +796,7 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
       FAR char *blk = mempool_allocate(pool);
       if (blk != NULL)
         {
+          mempool_multiple_record(mpool, pool, size + alignment);
           return (FAR void *)ALIGN_UP((uintptr_t)blk, alignment);
         }
     }
@@ -850,6 +931,222 @@ void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
     }
 }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+
+/****************************************************************************
+ * Name: mempool_multiple_classinfo
+ *
+ * Description:
+ *   Get the request statistics of one block size class.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *   index - The index of the class, starting from the smallest block size.
+ *   info  - The location to return the statistics.
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if index is not a valid class.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_classinfo(FAR struct mempool_multiple_s *mpool,
+                               size_t index,
+                               FAR struct mempool_classinfo_s *info)
+{
+  if (mpool == NULL || index >= mpool->npools)
+    {
+      return -EINVAL;
+    }
+
+  info->blocksize = mpool->pools[index].blocksize;
+  info->nrequest  = atomic_load(&mpool->stats[index].nrequest);
+  info->nbytes    = atomic_load(&mpool->stats[index].nbytes);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_overflow
+ *
+ * Description:
+ *   Return the number of requests larger than the largest block size,
+ *   these are served by the caller, e.g. the heap, instead.
+ *
+ ****************************************************************************/
+
+unsigned long
+mempool_multiple_overflow(FAR struct mempool_multiple_s *mpool)
+{
+  return mpool != NULL ? atomic_load(&mpool->overflow) : 0;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_tune
+ *
+ * Description:
+ *   Compute, from the histogram of the requested sizes, the table of block
+ *   sizes that minimizes the internal fragmentation of the recorded
+ *   requests.  The largest block size of the table is kept so that the new
+ *   table serves the same requests.  The sizes are multiples of the
+ *   largest power of two that divides all current block sizes, hence keep
+ *   their alignment.
+ *
+ *   With n histogram steps and k block sizes this is the usual dynamic
+ *   programming over the end of the last class, O(k * n^2) time and
+ *   O(k * n) space.  It is meant to be called rarely, e.g. when the
+ *   statistics are read through procfs.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   poolsize - The location to return the increasing block sizes.
+ *   npools   - The maximum number of block sizes to return.
+ *
+ * Returned Value:
+ *   The number of block sizes returned in poolsize; a negated errno value
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t mempool_multiple_tune(FAR struct mempool_multiple_s *mpool,
+                              FAR size_t *poolsize, size_t npools)
+{
+  FAR unsigned long long *count;
+  FAR unsigned long long *moment;
+  FAR unsigned long long *cost;
+  FAR size_t *split;
+  size_t start;
+  size_t n;
+  size_t k;
+  size_t c;
+  size_t i;
+  size_t j;
+
+  if (mpool == NULL || poolsize == NULL || npools == 0)
+    {
+      return -EINVAL;
+    }
+
+  n = mpool->nhistogram;
+  k = MIN(npools, n);
+
+  /* count[i] and moment[i] are the prefix sums of h[j] and of j * h[j]
+   * over the steps j < i, so that the waste of serving the steps a..b
+   * with a block of (b + 1) * granule bytes is, in units of granule:
+   *
+   *   b * (count[b + 1] - count[a]) - (moment[b + 1] - moment[a])
+   *
+   * cost[c * n + i] is the least waste of serving the steps 0..i with
+   * c + 1 classes the largest of which ends at step i, split[] records
+   * the end of the previous class.
+   */
+
+  count = mpool->alloc(mpool->arg, sizeof(uintptr_t),
+                       (2 * (n + 1) + k * n) * sizeof(unsigned long long) +
+                       k * n * sizeof(size_t));
+  if (count == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  moment = count + n + 1;
+  cost   = moment + n + 1;
+  split  = (FAR size_t *)(cost + k * n);
+
+  count[0]  = 0;
+  moment[0] = 0;
+  for (i = 0; i < n; i++)
+    {
+      unsigned long long h = atomic_load(&mpool->histogram[i]);
+
+      count[i + 1]  = count[i] + h;
+      moment[i + 1] = moment[i] + h * i;
+    }
+
+#define MPOOL_WASTE(a, b) ((b) * (count[(b) + 1] - count[a]) - \
+                           (moment[(b) + 1] - moment[a]))
+
+  for (i = 0; i < n; i++)
+    {
+      cost[i]  = MPOOL_WASTE(0, i);
+      split[i] = 0;
+    }
+
+  for (c = 1; c < k; c++)
+    {
+      for (i = 0; i < n; i++)
+        {
+          FAR unsigned long long *best = &cost[c * n + i];
+
+          /* At least c + 1 steps are needed for c + 1 classes */
+
+          *best = ULLONG_MAX;
+          split[c * n + i] = 0;
+          for (j = c - 1; j < i; j++)
+            {
+              unsigned long long waste = cost[(c - 1) * n + j] +
+                                         MPOOL_WASTE(j + 1, i);
+
+              if (waste < *best)
+                {
+                  *best = waste;
+                  split[c * n + i] = j;
+                }
+            }
+        }
+    }
+
+#undef MPOOL_WASTE
+
+  /* Walk back from the largest class, which always ends at the last step.
+   * Classes that would serve no request at all are dropped.
+   */
+
+  for (c = k, i = n - 1, j = k; c-- > 0; i = start - 1)
+    {
+      start = c > 0 ? split[c * n + i] + 1 : 0;
+      if (c == k - 1 || count[i + 1] != count[start])
+        {
+          poolsize[--j] = (i + 1) * mpool->granule;
+        }
+    }
+
+  memmove(poolsize, poolsize + j, (k - j) * sizeof(size_t));
+  mpool->free(mpool->arg, count);
+  return k - j;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_resetstats
+ *
+ * Description:
+ *   Clear the request statistics of the multiple memory pool.
+ *
+ ****************************************************************************/
+
+void mempool_multiple_resetstats(FAR struct mempool_multiple_s *mpool)
+{
+  size_t i;
+
+  if (mpool == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      atomic_store(&mpool->stats[i].nrequest, 0);
+      atomic_store(&mpool->stats[i].nbytes, 0);
+    }
+
+  for (i = 0; i < mpool->nhistogram; i++)
+    {
+      atomic_store(&mpool->histogram[i], 0);
+    }
+
+  atomic_store(&mpool->overflow, 0);
+}
+
+#endif /* CONFIG_MM_HEAP_MEMPOOL_STATS */
+
 /****************************************************************************
  * Name: mempool_multiple_deinit
  *
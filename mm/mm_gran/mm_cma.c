@@ -0,0 +1,488 @@
+/****************************************************************************
+ * mm/mm_gran/mm_cma.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/mm/cma.h>
+#include <nuttx/mm/gran.h>
+
+#ifdef CONFIG_MM_CMA
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CMA_GRANSIZE       (1 << CONFIG_MM_CMA_LOG2GRAN)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The contiguous memory region.  Reservations are carved from it with a
+ * granule allocator and each reservation again manages its buffers with a
+ * granule allocator of its own.
+ */
+
+struct cma_region_s
+{
+  GRAN_HANDLE gran;                  /* Allocator of the reservations */
+  FAR void   *base;                  /* Start of the region */
+  size_t      size;                  /* Size of the region */
+  uint8_t     flags;                 /* Cache attributes, see CMA_* */
+};
+
+struct cma_consumer_s
+{
+  GRAN_HANDLE     gran;              /* Allocator of the buffers */
+  FAR void       *base;              /* Start of the reservation */
+  size_t          size;              /* Size of the reservation */
+  char            name[16];          /* Name of the consumer */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct cma_region_s g_cma;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cma_range
+ *
+ * Description:
+ *   Clip a range to the buffer and return its start and end addresses.
+ *
+ ****************************************************************************/
+
+static bool cma_range(FAR const struct cma_buffer_s *buf, size_t offset,
+                      size_t len, FAR uintptr_t *start, FAR uintptr_t *end)
+{
+  DEBUGASSERT(buf != NULL && buf->addr != NULL);
+
+  if ((buf->flags & CMA_UNCACHED) != 0 || offset >= buf->size)
+    {
+      return false;
+    }
+
+  if (len > buf->size - offset)
+    {
+      len = buf->size - offset;
+    }
+
+  *start = (uintptr_t)buf->addr + offset;
+  *end   = *start + len;
+  return len > 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cma_initialize
+ *
+ * Description:
+ *   Set up the contiguous memory region.  This is normally called once by
+ *   board or architecture logic early in the boot sequence, before the
+ *   memory becomes fragmented.  If start is NULL, the region is carved
+ *   from the kernel heap.
+ *
+ * Input Parameters:
+ *   start - Start of the region or NULL to allocate it from the kernel heap
+ *   size  - Size of the region in bytes
+ *   flags - Cache attributes of the region, see CMA_*
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int cma_initialize(FAR void *start, size_t size, uint8_t flags)
+{
+  FAR void *base = start;
+
+  /* The granule must cover whole cache lines, otherwise maintenance of one
+   * buffer would corrupt the neighbouring one.
+   */
+
+  DEBUGASSERT(CMA_GRANSIZE >= up_get_dcache_linesize());
+
+  if (g_cma.gran != NULL)
+    {
+      return -EBUSY;
+    }
+
+  if (size < CMA_GRANSIZE)
+    {
+      return -EINVAL;
+    }
+
+  if (base == NULL)
+    {
+      base = kmm_memalign(CMA_GRANSIZE, size);
+      if (base == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  g_cma.gran = gran_initialize(base, size, CONFIG_MM_CMA_LOG2GRAN,
+                               CONFIG_MM_CMA_LOG2GRAN);
+  if (g_cma.gran == NULL)
+    {
+      if (start == NULL)
+        {
+          kmm_free(base);
+        }
+
+      return -ENOMEM;
+    }
+
+  g_cma.base  = base;
+  g_cma.size  = size;
+  g_cma.flags = flags;
+
+  minfo("CMA region %p size %zu flags %02x\n", base, size, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cma_reserve
+ *
+ * Description:
+ *   Reserve a contiguous part of the region for one consumer.  Buffers of
+ *   the consumer are then allocated from the reservation only, so that a
+ *   consumer can neither starve nor fragment the others.
+ *
+ * Input Parameters:
+ *   name - Name of the consumer, used for diagnostics only
+ *   size - Size of the reservation in bytes
+ *
+ * Returned Value:
+ *   A reservation handle on success; NULL if the region is not initialized
+ *   or has no contiguous free block of the requested size.
+ *
+ ****************************************************************************/
+
+FAR struct cma_consumer_s *cma_reserve(FAR const char *name, size_t size)
+{
+  FAR struct cma_consumer_s *consumer;
+
+  if (g_cma.gran == NULL || size == 0)
+    {
+      return NULL;
+    }
+
+  consumer = kmm_zalloc(sizeof(struct cma_consumer_s));
+  if (consumer == NULL)
+    {
+      return NULL;
+    }
+
+  size = ALIGN_UP(size, CMA_GRANSIZE);
+  consumer->base = gran_alloc(g_cma.gran, size);
+  if (consumer->base == NULL)
+    {
+      mwarn("WARNING: %s: no contiguous %zu bytes\n", name, size);
+      goto errout_with_consumer;
+    }
+
+  consumer->gran = gran_initialize(consumer->base, size,
+                                   CONFIG_MM_CMA_LOG2GRAN,
+                                   CONFIG_MM_CMA_LOG2GRAN);
+  if (consumer->gran == NULL)
+    {
+      goto errout_with_base;
+    }
+
+  consumer->size = size;
+  strlcpy(consumer->name, name, sizeof(consumer->name));
+
+  minfo("%s: reserved %p size %zu\n", name, consumer->base, size);
+  return consumer;
+
+errout_with_base:
+  gran_free(g_cma.gran, consumer->base, size);
+errout_with_consumer:
+  kmm_free(consumer);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cma_unreserve
+ *
+ * Description:
+ *   Return a reservation to the region.  All buffers of the consumer must
+ *   have been freed.
+ *
+ * Input Parameters:
+ *   consumer - The handle previously returned by cma_reserve
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_unreserve(FAR struct cma_consumer_s *consumer)
+{
+#ifdef CONFIG_DEBUG_ASSERTIONS
+  struct graninfo_s info;
+#endif
+
+  if (consumer == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_DEBUG_ASSERTIONS
+  gran_info(consumer->gran, &info);
+  DEBUGASSERT(info.nfree == info.ngranules);
+#endif
+
+  gran_release(consumer->gran);
+  gran_free(g_cma.gran, consumer->base, consumer->size);
+  kmm_free(consumer);
+}
+
+/****************************************************************************
+ * Name: cma_alloc
+ *
+ * Description:
+ *   Allocate a physically contiguous buffer from a reservation.  The buffer
+ *   is aligned to the region granule, i.e. to 1 << CONFIG_MM_CMA_LOG2GRAN.
+ *
+ * Input Parameters:
+ *   consumer - The handle previously returned by cma_reserve
+ *   size     - Size of the buffer in bytes
+ *   buf      - Location to return the buffer description
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int cma_alloc(FAR struct cma_consumer_s *consumer, size_t size,
+              FAR struct cma_buffer_s *buf)
+{
+  FAR void *addr;
+
+  DEBUGASSERT(buf != NULL);
+
+  if (consumer == NULL || size == 0)
+    {
+      return -EINVAL;
+    }
+
+  size = ALIGN_UP(size, CMA_GRANSIZE);
+  addr = gran_alloc(consumer->gran, size);
+  if (addr == NULL)
+    {
+      mwarn("WARNING: %s: no contiguous %zu bytes\n", consumer->name, size);
+      return -ENOMEM;
+    }
+
+  buf->owner = consumer;
+  buf->addr  = addr;
+  buf->size  = size;
+  buf->flags = g_cma.flags;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cma_free
+ *
+ * Description:
+ *   Return a buffer to its reservation.  The description is cleared.
+ *
+ * Input Parameters:
+ *   buf - The buffer previously set up by cma_alloc
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_free(FAR struct cma_buffer_s *buf)
+{
+  DEBUGASSERT(buf != NULL);
+
+  if (buf->addr != NULL)
+    {
+      gran_free(buf->owner->gran, buf->addr, buf->size);
+      memset(buf, 0, sizeof(struct cma_buffer_s));
+    }
+}
+
+/****************************************************************************
+ * Name: cma_sync_for_device
+ *
+ * Description:
+ *   Write back the CPU's view of part of a buffer before a device reads it
+ *   by DMA.  Nothing is done for uncached buffers.
+ *
+ * Input Parameters:
+ *   buf    - The buffer previously set up by cma_alloc
+ *   offset - Offset of the range in the buffer
+ *   len    - Length of the range in bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_sync_for_device(FAR const struct cma_buffer_s *buf,
+                         size_t offset, size_t len)
+{
+  uintptr_t start;
+  uintptr_t end;
+
+  if (cma_range(buf, offset, len, &start, &end))
+    {
+      up_clean_dcache(start, end);
+    }
+}
+
+/****************************************************************************
+ * Name: cma_sync_for_cpu
+ *
+ * Description:
+ *   Discard stale cache lines of part of a buffer after a device has
+ *   written it by DMA, so that the CPU sees the new data.  Nothing is done
+ *   for uncached buffers.
+ *
+ * Input Parameters:
+ *   buf    - The buffer previously set up by cma_alloc
+ *   offset - Offset of the range in the buffer
+ *   len    - Length of the range in bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void cma_sync_for_cpu(FAR const struct cma_buffer_s *buf,
+                      size_t offset, size_t len)
+{
+  uintptr_t start;
+  uintptr_t end;
+
+  if (cma_range(buf, offset, len, &start, &end))
+    {
+      up_invalidate_dcache(start, end);
+    }
+}
+
+/****************************************************************************
+ * Name: cma_mmap
+ *
+ * Description:
+ *   Export part of a buffer to user space.  This is intended to be called
+ *   from the mmap method of a character driver that owns the buffer.
+ *
+ * Input Parameters:
+ *   buf - The buffer previously set up by cma_alloc
+ *   map - The mapping requested by the user; map->offset and map->length
+ *         are relative to the start of the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success and map->vaddr is set; a negated
+ *   errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int cma_mmap(FAR const struct cma_buffer_s *buf,
+             FAR struct mm_map_entry_s *map)
+{
+  DEBUGASSERT(buf != NULL && map != NULL);
+
+  if (buf->addr == NULL || map->offset < 0 || map->length == 0 ||
+      (size_t)map->offset >= buf->size ||
+      map->length > buf->size - map->offset)
+    {
+      return -EINVAL;
+    }
+
+  /* The region is identity mapped, so the buffer is directly accessible
+   * to user space as it is for the other drivers offering mmap.
+   */
+
+  map->vaddr = (FAR uint8_t *)buf->addr + map->offset;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cma_info
+ *
+ * Description:
+ *   Return usage information of a reservation or, if consumer is NULL, of
+ *   the whole region.
+ *
+ * Input Parameters:
+ *   consumer - The handle previously returned by cma_reserve or NULL
+ *   info     - Location to return the usage information
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int cma_info(FAR struct cma_consumer_s *consumer,
+             FAR struct cma_info_s *info)
+{
+  struct graninfo_s ginfo;
+  GRAN_HANDLE gran;
+
+  DEBUGASSERT(info != NULL);
+
+  gran = consumer != NULL ? consumer->gran : g_cma.gran;
+  if (gran == NULL)
+    {
+      return -ENODEV;
+    }
+
+  gran_info(gran, &ginfo);
+
+  info->total   = (size_t)ginfo.ngranules << ginfo.log2gran;
+  info->used    = (size_t)(ginfo.ngranules - ginfo.nfree) << ginfo.log2gran;
+  info->largest = (size_t)ginfo.mxfree << ginfo.log2gran;
+  return OK;
+}
+
+#endif /* CONFIG_MM_CMA */
@@ -29,8 +29,11 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -39,6 +42,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 
 /****************************************************************************
@@ -62,6 +66,8 @@
  *   allocated.  It can range from 16-bytes to 4Gb.  Larger values of
  *   MM_MAX_SHIFT can cause larger data structure sizes and, perhaps,
  *   minor performance losses.
+ * MM_SLI_SHIFT is log2 of the number of linear sub-lists that each power of
+ *   two size range of the free lists is divided into.
  */
 
 #define MM_MIN_SHIFT      LOG2_CEIL(sizeof(struct mm_freenode_s))
@@ -71,6 +77,21 @@
 #  define MM_MAX_SHIFT    (22)  /*  4 Mb */
 #endif
 
+/* Movable allocations are compacted in the background only in the kernel,
+ * where the work queues live.
+ */
+
+#if defined(CONFIG_MM_HEAP_MOVABLE) && CONFIG_MM_HEAP_COMPACT_INTERVAL > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_COMPACT_WORK
+#endif
+
+#ifdef CONFIG_MM_HEAP_BITMAP
+#  define MM_SLI_SHIFT    CONFIG_MM_HEAP_BITMAP_SLI_SHIFT
+#else
+#  define MM_SLI_SHIFT    (0)
+#endif
+
 #if CONFIG_MM_BACKTRACE == 0
 #  define MM_ADD_BACKTRACE(heap, ptr) \
      do \
@@ -112,7 +133,13 @@
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
-#define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#define MM_NSLI          (1 << MM_SLI_SHIFT)
+#define MM_NNODES        (((MM_MAX_SHIFT - MM_MIN_SHIFT) << MM_SLI_SHIFT) + 1)
+
+#ifdef CONFIG_MM_HEAP_BITMAP
+#  define MM_BITMAP_BITS   (8 * sizeof(unsigned long))
+#  define MM_BITMAP_NWORDS ((MM_NNODES + MM_BITMAP_BITS - 1) / MM_BITMAP_BITS)
+#endif
 
 #if CONFIG_MM_DEFAULT_ALIGNMENT == 0
 #  define MM_ALIGN       (2 * sizeof(uintptr_t))
@@ -217,6 +244,36 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+/* This describes the cache of small chunks of one CPU.  A cache class
+ * holds chunks of exactly MM_MIN_CHUNK + class * MM_ALIGN bytes that are
+ * still marked as allocated in the heap, linked through their payload.
+ */
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+struct mm_cache_s
+{
+  spinlock_t lock;
+  FAR struct mm_delaynode_s *head[CONFIG_MM_HEAP_PERCPU_CACHE_NCLASSES];
+  uint16_t count[CONFIG_MM_HEAP_PERCPU_CACHE_NCLASSES];
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long flushes;
+};
+#endif
+
+/* This describes one movable allocation.  The handle itself is an ordinary
+ * allocation from the same heap.
+ */
+
+#ifdef CONFIG_MM_HEAP_MOVABLE
+struct mm_movable_s
+{
+  struct list_node node;   /* Entry in mm_movable of the heap */
+  FAR void        *mem;    /* Current address of the allocation */
+  unsigned int     pins;   /* Nesting count of mm_movable_lock() */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -253,6 +310,12 @@ struct mm_heap_s
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
 
+  /* One bit per mm_nodelist[] entry that holds at least one free node */
+
+#ifdef CONFIG_MM_HEAP_BITMAP
+  unsigned long mm_bitmap[MM_BITMAP_NWORDS];
+#endif
+
   /* Free delay list, as sometimes we can't do free immdiately. */
 
   FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
@@ -261,6 +324,22 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* Per-CPU caches of small chunks in front of mm_lock */
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+  struct mm_cache_s mm_cache[CONFIG_SMP_NCPUS];
+#endif
+
+  /* The movable allocations and their background compaction */
+
+#ifdef CONFIG_MM_HEAP_MOVABLE
+  struct list_node mm_movable;
+#endif
+
+#ifdef MM_HEAP_COMPACT_WORK
+  struct work_s mm_compactwork;
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
@@ -300,22 +379,80 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem);
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+#endif
 
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
 
+/* Map a chunk size to its mm_nodelist[] index: the power of two range of
+ * the size selects a group of MM_NSLI lists and the next MM_SLI_SHIFT bits
+ * of the size select the list in the group.
+ */
+
 static inline_function int mm_size2ndx(size_t size)
 {
+  int fl;
+
   DEBUGASSERT(size >= MM_MIN_CHUNK);
   if (size >= MM_MAX_CHUNK)
     {
       return MM_NNODES - 1;
     }
 
-  size >>= MM_MIN_SHIFT;
-  return flsl(size) - 1;
+  fl = flsl(size) - 1;
+  return ((fl - MM_MIN_SHIFT) << MM_SLI_SHIFT) +
+         ((size >> (fl - MM_SLI_SHIFT)) & (MM_NSLI - 1));
+}
+
+#ifdef CONFIG_MM_HEAP_BITMAP
+static inline_function void mm_bitmap_set(FAR struct mm_heap_s *heap,
+                                          int ndx)
+{
+  heap->mm_bitmap[ndx / MM_BITMAP_BITS] |= 1ul << (ndx % MM_BITMAP_BITS);
+}
+
+static inline_function void mm_bitmap_clear(FAR struct mm_heap_s *heap,
+                                            int ndx)
+{
+  heap->mm_bitmap[ndx / MM_BITMAP_BITS] &= ~(1ul << (ndx % MM_BITMAP_BITS));
+}
+
+/* Return the first non-empty mm_nodelist[] index not below ndx, or -1 */
+
+static inline_function int mm_bitmap_find(FAR struct mm_heap_s *heap,
+                                          int ndx)
+{
+  unsigned long bits;
+  int word;
+
+  if (ndx >= MM_NNODES)
+    {
+      return -1;
+    }
+
+  word = ndx / MM_BITMAP_BITS;
+  bits = heap->mm_bitmap[word] & (~0ul << (ndx % MM_BITMAP_BITS));
+  while (bits == 0)
+    {
+      if (++word >= MM_BITMAP_NWORDS)
+        {
+          return -1;
+        }
+
+      bits = heap->mm_bitmap[word];
+    }
+
+  return word * MM_BITMAP_BITS + ffsl((long)bits) - 1;
 }
+#endif
 
 static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
                                             FAR struct mm_freenode_s *node)
@@ -351,6 +488,35 @@ static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
       next->blink = node;
     }
+
+#ifdef CONFIG_MM_HEAP_BITMAP
+  mm_bitmap_set(heap, ndx);
+#endif
+}
+
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  /* Remove the node.  There must be a predecessor, but there may not be a
+   * successor node.
+   */
+
+  DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+#ifdef CONFIG_MM_HEAP_BITMAP
+  /* The list is empty now if the node sat between two list heads */
+
+  if (MM_SIZEOF_NODE(node->blink) == 0 &&
+      (node->flink == NULL || MM_SIZEOF_NODE(node->flink) == 0))
+    {
+      mm_bitmap_clear(heap, mm_size2ndx(MM_SIZEOF_NODE(node)));
+    }
+#endif
 }
 
 #endif /* __MM_MM_HEAP_MM_H */
@@ -0,0 +1,339 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/kasan.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of chunks returned to the heap at once when a class is full */
+
+#define MM_CACHE_BATCH   (CONFIG_MM_HEAP_PERCPU_CACHE_DEPTH / 2)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The caches are only used where interrupts can be disabled, like the
+ * delay lists.
+ */
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Name: mm_cache_class
+ *
+ * Description:
+ *   Map a chunk size (payload and header) to its cache class, or return a
+ *   negative value if chunks of that size are not cached.
+ *
+ ****************************************************************************/
+
+static inline_function int mm_cache_class(size_t size)
+{
+  size_t ndx = (size - MM_MIN_CHUNK) / MM_ALIGN;
+
+  return ndx < CONFIG_MM_HEAP_PERCPU_CACHE_NCLASSES ? (int)ndx : -1;
+}
+
+/****************************************************************************
+ * Name: mm_cache_lock
+ *
+ * Description:
+ *   Disable local interrupts and lock the cache of the current CPU.  The
+ *   spinlock only serializes against mm_cacheinfo() on another CPU.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_cache_s *mm_cache_lock(FAR struct mm_heap_s *heap,
+                                            FAR irqstate_t *flags)
+{
+  FAR struct mm_cache_s *cache;
+
+  *flags = up_irq_save();
+  cache  = &heap->mm_cache[this_cpu()];
+#ifdef CONFIG_SPINLOCK
+  spin_lock_wo_note(&cache->lock);
+#endif
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: mm_cache_unlock
+ ****************************************************************************/
+
+static void mm_cache_unlock(FAR struct mm_cache_s *cache, irqstate_t flags)
+{
+#ifdef CONFIG_SPINLOCK
+  spin_unlock_wo_note(&cache->lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return a list of chunks taken from a cache to the heap, taking the MM
+ *   mutex only once for the whole batch.
+ *
+ ****************************************************************************/
+
+static void mm_cache_flush(FAR struct mm_heap_s *heap,
+                           FAR struct mm_delaynode_s *list)
+{
+  FAR struct mm_delaynode_s *next;
+
+  if (mm_lock(heap) < 0)
+    {
+      /* The heap can't be locked here, let mm_delayfree() defer them */
+
+      for (; list != NULL; list = next)
+        {
+          next = list->flink;
+          mm_delayfree(heap, list, false);
+        }
+
+      return;
+    }
+
+  for (; list != NULL; list = next)
+    {
+      next = list->flink;
+      mm_freechunk(heap, list);
+    }
+
+  mm_unlock(heap);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Try to take a chunk of exactly 'size' bytes (payload and header) from
+ *   the cache of the current CPU without taking the MM mutex.
+ *
+ * Returned Value:
+ *   The address of the allocated memory or NULL on a cache miss.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_delaynode_s *mem;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  int ndx;
+
+  ndx = mm_cache_class(size);
+  if (ndx < 0)
+    {
+      return NULL;
+    }
+
+  cache = mm_cache_lock(heap, &flags);
+
+  mem = cache->head[ndx];
+  if (mem != NULL)
+    {
+      cache->head[ndx] = mem->flink;
+      cache->count[ndx]--;
+      cache->hits++;
+    }
+  else
+    {
+      cache->misses++;
+    }
+
+  mm_cache_unlock(cache, flags);
+
+  if (mem == NULL)
+    {
+      return NULL;
+    }
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)mem - MM_SIZEOF_ALLOCNODE);
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node) && MM_SIZEOF_NODE(node) == size);
+
+  MM_ADD_BACKTRACE(heap, node);
+  mem = kasan_unpoison(mem, size - MM_ALLOCNODE_OVERHEAD);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_ALLOC_MAGIC, size - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  return mem;
+#else
+  return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Try to keep a freed chunk in the cache of the current CPU.  When its
+ *   class is full, half of the class is returned to the heap first.
+ *
+ * Returned Value:
+ *   true if the chunk was taken by the cache, false if it must be freed to
+ *   the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *flush = NULL;
+  FAR struct mm_delaynode_s *tmp;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  size_t size;
+  int ndx;
+  int i;
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)kasan_reset_tag(mem) - MM_SIZEOF_ALLOCNODE);
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+  ndx = mm_cache_class(MM_SIZEOF_NODE(node));
+  if (ndx < 0)
+    {
+      return false;
+    }
+
+  size = mm_malloc_size(heap, mem);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_FREE_MAGIC, size);
+#endif
+  kasan_poison(mem, size);
+  UNUSED(size);
+
+#if CONFIG_MM_BACKTRACE >= 0
+  /* Cached chunks are owned by the heap, not by a leaking thread */
+
+  node->pid = PID_MM_MEMPOOL;
+#endif
+
+  tmp   = (FAR struct mm_delaynode_s *)kasan_reset_tag(mem);
+
+  cache = mm_cache_lock(heap, &flags);
+
+  if (cache->count[ndx] >= CONFIG_MM_HEAP_PERCPU_CACHE_DEPTH)
+    {
+      /* Detach the oldest batch, which is at the tail of the list */
+
+      FAR struct mm_delaynode_s *last = cache->head[ndx];
+
+      for (i = 1; i < CONFIG_MM_HEAP_PERCPU_CACHE_DEPTH - MM_CACHE_BATCH;
+           i++)
+        {
+          last = last->flink;
+        }
+
+      flush              = last->flink;
+      last->flink        = NULL;
+      cache->count[ndx] -= MM_CACHE_BATCH;
+      cache->flushes++;
+    }
+
+  tmp->flink       = cache->head[ndx];
+  cache->head[ndx] = tmp;
+  cache->count[ndx]++;
+
+  mm_cache_unlock(cache, flags);
+
+  if (flush != NULL)
+    {
+      mm_cache_flush(heap, flush);
+    }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cacheinfo
+ *
+ * Description:
+ *   Return the statistics of the cache of one CPU.
+ *
+ * Input Parameters:
+ *   heap - The heap
+ *   cpu  - The CPU index
+ *   info - The location to return the statistics
+ *
+ ****************************************************************************/
+
+void mm_cacheinfo(FAR struct mm_heap_s *heap, int cpu,
+                  FAR struct mm_cacheinfo_s *info)
+{
+  FAR struct mm_cache_s *cache = &heap->mm_cache[cpu];
+  irqstate_t flags;
+  int ndx;
+
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS);
+
+  flags = spin_lock_irqsave_wo_note(&cache->lock);
+
+  info->hits    = cache->hits;
+  info->misses  = cache->misses;
+  info->flushes = cache->flushes;
+  info->cached  = 0;
+
+  for (ndx = 0; ndx < CONFIG_MM_HEAP_PERCPU_CACHE_NCLASSES; ndx++)
+    {
+      info->cached += (size_t)cache->count[ndx] *
+                      (MM_MIN_CHUNK + ndx * MM_ALIGN);
+    }
+
+  spin_unlock_irqrestore_wo_note(&cache->lock, flags);
+}
+
+#endif /* CONFIG_MM_HEAP_PERCPU_CACHE */
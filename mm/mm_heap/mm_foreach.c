@@ -33,6 +33,37 @@
 
 #include "mm_heap/mm.h"
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mm_foreach_free_s
+{
+  mm_free_handler_t handler;
+  FAR void *arg;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void foreach_free_handler(FAR struct mm_allocnode_s *node,
+                                 FAR void *arg)
+{
+  FAR struct mm_foreach_free_s *priv = arg;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+
+  /* Skip the free node header, the payload ends where the next node
+   * begins.
+   */
+
+  if (MM_NODE_IS_FREE(node) && nodesize > sizeof(struct mm_freenode_s))
+    {
+      priv->handler((FAR char *)node + sizeof(struct mm_freenode_s),
+                    nodesize - sizeof(struct mm_freenode_s), priv->arg);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -102,3 +133,25 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
     }
 #undef region
 }
+
+/****************************************************************************
+ * Name: mm_foreach_free
+ *
+ * Description:
+ *   Report the unused part of each free chunk in address order.  Nothing is
+ *   reported if the heap can't be locked (e.g. it is held by the interrupted
+ *   task), so the caller must treat the walk as a hint only.
+ *
+ ****************************************************************************/
+
+void mm_foreach_free(FAR struct mm_heap_s *heap, mm_free_handler_t handler,
+                     FAR void *arg)
+{
+  struct mm_foreach_free_s priv;
+
+  DEBUGASSERT(handler);
+
+  priv.handler = handler;
+  priv.arg     = arg;
+  mm_foreach(heap, foreach_free_handler, &priv);
+}
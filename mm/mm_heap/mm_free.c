@@ -74,14 +74,16 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_delayfree
+ * Name: mm_freechunk
  *
  * Description:
- *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *   Return an allocated chunk to the list of free nodes, merging it with
+ *   the adjacent free chunks if possible.  The caller must hold the MM
+ *   mutex.
  *
  ****************************************************************************/
 
-void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   FAR struct mm_freenode_s *node;
   FAR struct mm_freenode_s *prev;
@@ -89,42 +91,6 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   size_t nodesize;
   size_t prevsize;
 
-  if (mm_lock(heap) < 0)
-    {
-      /* Meet -ESRCH return, which means we are in situations
-       * during context switching(See mm_lock() & gettid()).
-       * Then add to the delay list.
-       */
-
-      add_delaylist(heap, mem);
-      return;
-    }
-
-  nodesize = mm_malloc_size(heap, mem);
-#ifdef CONFIG_MM_FILL_ALLOCATIONS
-#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
-  /* If delay free is enabled, a memory node will be freed twice.
-   * The first time is to add the node to the delay list, and the second
-   * time is to actually free the node. Therefore, we only colorize the
-   * memory node the first time, when `delay` is set to true.
-   */
-
-  if (delay)
-#endif
-    {
-      memset(mem, MM_FREE_MAGIC, nodesize);
-    }
-#endif
-
-  kasan_poison(mem, nodesize);
-
-  if (delay)
-    {
-      mm_unlock(heap);
-      add_delaylist(heap, mem);
-      return;
-    }
-
   /* Map the memory chunk into a free node */
 
   node = (FAR struct mm_freenode_s *)
@@ -164,12 +130,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
        * but there may not be a successor node.
        */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -199,12 +160,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
        * not be a successor node.
        */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -217,6 +173,58 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   /* Add the merged node to the nodelist */
 
   mm_addfreechunk(heap, node);
+}
+
+/****************************************************************************
+ * Name: mm_delayfree
+ *
+ * Description:
+ *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *
+ ****************************************************************************/
+
+void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+{
+  size_t nodesize;
+
+  if (mm_lock(heap) < 0)
+    {
+      /* Meet -ESRCH return, which means we are in situations
+       * during context switching(See mm_lock() & gettid()).
+       * Then add to the delay list.
+       */
+
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  nodesize = mm_malloc_size(heap, mem);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+#if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
+  /* If delay free is enabled, a memory node will be freed twice.
+   * The first time is to add the node to the delay list, and the second
+   * time is to actually free the node. Therefore, we only colorize the
+   * memory node the first time, when `delay` is set to true.
+   */
+
+  if (delay)
+#endif
+    {
+      memset(mem, MM_FREE_MAGIC, nodesize);
+    }
+#endif
+
+  kasan_poison(mem, nodesize);
+  UNUSED(nodesize);
+
+  if (delay)
+    {
+      mm_unlock(heap);
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  mm_freechunk(heap, mem);
   mm_unlock(heap);
 }
 
@@ -252,5 +260,12 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+  if (mm_cache_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
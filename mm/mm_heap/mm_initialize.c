@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -265,6 +266,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
       heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
     }
 
+#ifdef CONFIG_MM_HEAP_MOVABLE
+  list_initialize(&heap->mm_movable);
+#endif
+
   /* Initialize the malloc mutex to one (to support one-at-
    * a-time access to private data sets).
    */
@@ -311,19 +316,52 @@ mm_initialize_pool(FAR const char *name,
     {
       /* Initialize the multiple mempool default parameter */
 
+#  ifdef CONFIG_MM_HEAP_MEMPOOL_POOLSIZES
+      FAR const char *sizes = CONFIG_MM_HEAP_MEMPOOL_POOLSIZES;
+#  endif
+      int npools = 0;
       int i;
 
-      for (i = 0; i < MEMPOOL_NPOOLS; i++)
+#  ifdef CONFIG_MM_HEAP_MEMPOOL_POOLSIZES
+      /* Take the block sizes from the configuration if there are any, they
+       * may e.g. come from the table suggested by /proc/meminfo.
+       */
+
+      while (npools < MEMPOOL_NPOOLS && *sizes != '\0')
+        {
+          FAR char *end;
+
+          poolsize[npools] = strtoul(sizes, &end, 0);
+          if (end == sizes)
+            {
+              break;
+            }
+
+          DEBUGASSERT(poolsize[npools] % MM_ALIGN == 0 &&
+                      (npools == 0 ||
+                       poolsize[npools] > poolsize[npools - 1]));
+
+          sizes = *end == ',' ? end + 1 : end;
+          npools++;
+        }
+#  endif
+
+      if (npools == 0)
         {
+          for (i = 0; i < MEMPOOL_NPOOLS; i++)
+            {
 #  if CONFIG_MM_MIN_BLKSIZE != 0
-          poolsize[i] = (i + 1) * CONFIG_MM_MIN_BLKSIZE;
+              poolsize[i] = (i + 1) * CONFIG_MM_MIN_BLKSIZE;
 #  else
-          poolsize[i] = (i + 1) * MM_MIN_CHUNK;
+              poolsize[i] = (i + 1) * MM_MIN_CHUNK;
 #  endif
+            }
+
+          npools = MEMPOOL_NPOOLS;
         }
 
       def.poolsize        = poolsize;
-      def.npools          = MEMPOOL_NPOOLS;
+      def.npools          = npools;
       def.threshold       = CONFIG_MM_HEAP_MEMPOOL_THRESHOLD;
       def.chunksize       = CONFIG_MM_HEAP_MEMPOOL_CHUNK_SIZE;
       def.expandsize      = CONFIG_MM_HEAP_MEMPOOL_EXPAND_SIZE;
@@ -371,6 +409,10 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
 {
   int i;
 
+#ifdef MM_HEAP_COMPACT_WORK
+  work_cancel_sync(LPWORK, &heap->mm_compactwork);
+#endif
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
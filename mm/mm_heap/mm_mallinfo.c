@@ -216,3 +216,76 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 
   return 0;
 }
+
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Return the fragmentation index of the heap and the histogram of the
+ *   sizes of its free chunks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_FRAGINFO
+void mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info)
+{
+  FAR struct mm_freenode_s *node;
+
+  memset(info, 0, sizeof(struct mm_fraginfo_s));
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  /* The free lists chain all free chunks in size order, separated by the
+   * zero sized list heads.
+   */
+
+  for (node = heap->mm_nodelist[0].flink; node; node = node->flink)
+    {
+      size_t nodesize = MM_SIZEOF_NODE(node);
+      int ndx;
+
+      if (nodesize == 0)
+        {
+          continue;
+        }
+
+      ndx = flsl(nodesize >> MM_FRAGINFO_MINSHIFT) - 1;
+      if (ndx >= MM_FRAGINFO_NEXTENTS)
+        {
+          ndx = MM_FRAGINFO_NEXTENTS - 1;
+        }
+      else if (ndx < 0)
+        {
+          ndx = 0;
+        }
+
+      info->extents[ndx]++;
+      info->total += nodesize;
+      info->largest = nodesize;
+    }
+
+  mm_unlock(heap);
+
+  if (info->total > 0)
+    {
+      info->index = (uint64_t)(info->total - info->largest) * 1000 /
+                    info->total;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_mempool
+ *
+ * Description:
+ *   Return the multiple mempool serving the small requests of the heap, or
+ *   NULL if the heap has none, e.g. to read its request statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_STATS
+FAR struct mempool_multiple_s *mm_mempool(FAR struct mm_heap_s *heap)
+{
+  return heap->mm_mpool;
+}
+#endif
@@ -210,6 +210,16 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGASSERT(alignsize >= MM_ALIGN);
 
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+  /* Small chunks may be available from this CPU without the MM mutex */
+
+  ret = mm_cache_alloc(heap, alignsize);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+#endif
+
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
@@ -218,6 +228,29 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   ndx = mm_size2ndx(alignsize);
 
+#ifdef CONFIG_MM_HEAP_BITMAP
+  /* The first node of a list is the smallest one.  If it is too small,
+   * every node of the next non-empty list is large enough.  Only the last
+   * list is not bounded above and has to be searched.
+   */
+
+  node = heap->mm_nodelist[ndx].flink;
+  if (ndx < MM_NNODES - 1 && MM_SIZEOF_NODE(node) < alignsize)
+    {
+      ndx  = mm_bitmap_find(heap, ndx + 1);
+      node = ndx < 0 ? NULL : heap->mm_nodelist[ndx].flink;
+    }
+
+  while (node && MM_SIZEOF_NODE(node) < alignsize)
+    {
+      node = node->flink;
+    }
+
+  if (node)
+    {
+      nodesize = MM_SIZEOF_NODE(node);
+    }
+#else
   /* Search for a large enough chunk in the list of nodes. This list is
    * ordered by size, but will have occasional zero sized nodes as we visit
    * other mm_nodelist[] entries.
@@ -232,6 +265,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
           break;
         }
     }
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that it must be the best fitting chunk
@@ -248,12 +282,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
        * a successor node.
        */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
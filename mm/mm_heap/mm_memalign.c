@@ -213,12 +213,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
            * not be a successor node.
            */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           precedingsize += MM_SIZEOF_NODE(prev);
           node = (FAR struct mm_allocnode_s *)prev;
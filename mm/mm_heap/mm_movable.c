@@ -0,0 +1,380 @@
+/****************************************************************************
+ * mm/mm_heap/mm_movable.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/kasan.h>
+#include <nuttx/sched_note.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_movable_slide
+ *
+ * Description:
+ *   Move an allocated chunk to the start of the free chunk that precedes
+ *   it physically.  The free space then follows the chunk and is merged
+ *   with the next chunk if that is free too.
+ *
+ * Input Parameters:
+ *   heap - The heap of the chunk
+ *   node - The allocated chunk; its preceding chunk must be free
+ *
+ * Returned Value:
+ *   The new location of the chunk.
+ *
+ * Assumptions:
+ *   The caller holds the heap mutex.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_allocnode_s *
+mm_movable_slide(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_freenode_s *prev;
+  FAR struct mm_freenode_s *remainder;
+  FAR struct mm_allocnode_s *newnode;
+  FAR struct mm_freenode_s *next;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+  size_t prevsize;
+  size_t remsize;
+
+  prev     = (FAR struct mm_freenode_s *)
+             ((FAR char *)node - node->preceding);
+  prevsize = MM_SIZEOF_NODE(prev);
+  next     = (FAR struct mm_freenode_s *)((FAR char *)node + nodesize);
+
+  DEBUGASSERT(MM_NODE_IS_FREE(prev) && node->preceding == prevsize);
+  DEBUGASSERT(!MM_PREVNODE_IS_FREE(prev));
+
+  mm_delfreechunk(heap, prev);
+
+  /* Copy the header and the payload.  The 'preceding' field is skipped
+   * because it holds the tail of the allocation before prev, while the
+   * tail of this allocation overlaps the 'preceding' field of next.
+   */
+
+  newnode = (FAR struct mm_allocnode_s *)prev;
+  memmove((FAR char *)newnode + sizeof(mmsize_t),
+          (FAR char *)node + sizeof(mmsize_t), nodesize);
+  newnode->size = nodesize | MM_ALLOC_BIT;
+
+  /* The space left behind becomes a free chunk, merged with the next one
+   * if that is free as well.
+   */
+
+  remainder = (FAR struct mm_freenode_s *)((FAR char *)newnode + nodesize);
+  remsize   = prevsize;
+
+  if (MM_NODE_IS_FREE(next))
+    {
+      FAR struct mm_allocnode_s *andbeyond;
+
+      andbeyond = (FAR struct mm_allocnode_s *)
+                  ((FAR char *)next + MM_SIZEOF_NODE(next));
+      mm_delfreechunk(heap, next);
+      remsize += MM_SIZEOF_NODE(next);
+      andbeyond->preceding = remsize;
+    }
+  else
+    {
+      next->size     |= MM_PREVFREE_BIT;
+      next->preceding = remsize;
+    }
+
+  remainder->size = remsize;
+  mm_addfreechunk(heap, remainder);
+
+  kasan_poison((FAR char *)remainder + MM_SIZEOF_ALLOCNODE,
+               prevsize - MM_SIZEOF_ALLOCNODE);
+  return newnode;
+}
+
+/****************************************************************************
+ * Name: mm_compact_worker
+ ****************************************************************************/
+
+#ifdef MM_HEAP_COMPACT_WORK
+static void mm_compact_worker(FAR void *arg)
+{
+  FAR struct mm_heap_s *heap = arg;
+
+  mm_compact(heap);
+
+  DEBUGVERIFY(mm_lock(heap));
+  if (!list_is_empty(&heap->mm_movable))
+    {
+      work_queue(LPWORK, &heap->mm_compactwork, mm_compact_worker, heap,
+                 MSEC2TICK(CONFIG_MM_HEAP_COMPACT_INTERVAL));
+    }
+
+  mm_unlock(heap);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_malloc_movable
+ *
+ * Description:
+ *   Allocate memory that mm_compact() may move.  The memory is only
+ *   accessible through mm_movable_lock(), which also prevents it from
+ *   moving until mm_movable_unlock() is called.
+ *
+ * Input Parameters:
+ *   heap - The heap to allocate from
+ *   size - Size of the allocation in bytes
+ *
+ * Returned Value:
+ *   A handle of the allocation, or NULL if the heap is out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct mm_movable_s *mm_malloc_movable(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_movable_s *handle;
+  size_t allocsize = size;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  /* Mempool blocks live inside larger chunks and cannot be moved */
+
+  if (heap->mm_mpool != NULL && allocsize <= heap->mm_threshold)
+    {
+      allocsize = heap->mm_threshold + 1;
+    }
+#endif
+
+  handle = mm_malloc(heap, sizeof(struct mm_movable_s));
+  if (handle == NULL)
+    {
+      return NULL;
+    }
+
+  handle->mem = mm_malloc(heap, allocsize);
+  if (handle->mem == NULL)
+    {
+      mm_free(heap, handle);
+      return NULL;
+    }
+
+  handle->pins = 0;
+
+  DEBUGVERIFY(mm_lock(heap));
+  list_add_tail(&heap->mm_movable, &handle->node);
+
+#ifdef MM_HEAP_COMPACT_WORK
+  if (work_available(&heap->mm_compactwork))
+    {
+      work_queue(LPWORK, &heap->mm_compactwork, mm_compact_worker, heap,
+                 MSEC2TICK(CONFIG_MM_HEAP_COMPACT_INTERVAL));
+    }
+#endif
+
+  mm_unlock(heap);
+  return handle;
+}
+
+/****************************************************************************
+ * Name: mm_free_movable
+ *
+ * Description:
+ *   Free a movable allocation and its handle.  The allocation must not be
+ *   locked.
+ *
+ * Input Parameters:
+ *   heap   - The heap of the allocation
+ *   handle - The handle returned by mm_malloc_movable()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_free_movable(FAR struct mm_heap_s *heap,
+                     FAR struct mm_movable_s *handle)
+{
+  FAR void *mem;
+
+  if (handle == NULL)
+    {
+      return;
+    }
+
+  DEBUGVERIFY(mm_lock(heap));
+  DEBUGASSERT(handle->pins == 0);
+  list_delete(&handle->node);
+  mem = handle->mem;
+  mm_unlock(heap);
+
+  mm_free(heap, mem);
+  mm_free(heap, handle);
+}
+
+/****************************************************************************
+ * Name: mm_movable_lock
+ *
+ * Description:
+ *   Pin a movable allocation and return its current address.  Calls may
+ *   be nested; the address stays valid until the matching number of
+ *   mm_movable_unlock() calls.
+ *
+ * Input Parameters:
+ *   heap   - The heap of the allocation
+ *   handle - The handle returned by mm_malloc_movable()
+ *
+ * Returned Value:
+ *   The current address of the allocation.
+ *
+ ****************************************************************************/
+
+FAR void *mm_movable_lock(FAR struct mm_heap_s *heap,
+                          FAR struct mm_movable_s *handle)
+{
+  FAR void *mem;
+
+  DEBUGVERIFY(mm_lock(heap));
+  handle->pins++;
+  mem = handle->mem;
+  mm_unlock(heap);
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_movable_unlock
+ *
+ * Description:
+ *   Undo one mm_movable_lock().  The address returned by it must not be
+ *   used afterwards.
+ *
+ * Input Parameters:
+ *   heap   - The heap of the allocation
+ *   handle - The handle returned by mm_malloc_movable()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_movable_unlock(FAR struct mm_heap_s *heap,
+                       FAR struct mm_movable_s *handle)
+{
+  DEBUGVERIFY(mm_lock(heap));
+  DEBUGASSERT(handle->pins > 0);
+  handle->pins--;
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_compact
+ *
+ * Description:
+ *   Move unlocked movable allocations towards lower addresses so that the
+ *   free chunks between them merge.  Each allocation that follows a free
+ *   chunk is moved to the start of it; this is repeated while it makes
+ *   progress, which is guaranteed to end since every move lowers an
+ *   address.
+ *
+ * Input Parameters:
+ *   heap - The heap to compact
+ *
+ * Returned Value:
+ *   The number of bytes moved.
+ *
+ ****************************************************************************/
+
+size_t mm_compact(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_movable_s *handle;
+  size_t moved = 0;
+  bool progress;
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  do
+    {
+      progress = false;
+
+      list_for_every_entry(&heap->mm_movable, handle, struct mm_movable_s,
+                           node)
+        {
+          FAR struct mm_allocnode_s *node;
+          size_t nodesize;
+
+          if (handle->pins > 0)
+            {
+              continue;
+            }
+
+          node = (FAR struct mm_allocnode_s *)
+                 ((FAR char *)kasan_reset_tag(handle->mem) -
+                  MM_SIZEOF_ALLOCNODE);
+          if (!MM_PREVNODE_IS_FREE(node))
+            {
+              continue;
+            }
+
+          nodesize = MM_SIZEOF_NODE(node);
+          sched_note_heap(NOTE_HEAP_FREE, heap, handle->mem, nodesize,
+                          heap->mm_curused);
+
+          node        = mm_movable_slide(heap, node);
+          handle->mem = kasan_unpoison((FAR char *)node +
+                                       MM_SIZEOF_ALLOCNODE,
+                                       nodesize - MM_ALLOCNODE_OVERHEAD);
+
+          sched_note_heap(NOTE_HEAP_ALLOC, heap, handle->mem, nodesize,
+                          heap->mm_curused);
+
+          moved   += nodesize;
+          progress = true;
+        }
+    }
+  while (progress);
+
+  mm_unlock(heap);
+
+  if (moved > 0)
+    {
+      minfo("Compacted %zu bytes\n", moved);
+    }
+
+  return moved;
+}
@@ -256,12 +256,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            * there may not be a successor node.
            */
 
-          DEBUGASSERT(prev && prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Make sure the new previous node has enough space */
 
@@ -330,12 +325,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            * may not be a successor node.
            */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Make sure the new next node has enough space */
 
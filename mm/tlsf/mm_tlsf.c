@@ -125,6 +125,12 @@ struct memdump_backtrace_s
 };
 #endif
 
+struct mm_foreach_free_s
+{
+  mm_free_handler_t handler;
+  FAR void *arg;
+};
+
 struct mm_mallinfo_handler_s
 {
   FAR const struct malltask *task;
@@ -400,6 +406,26 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
 #  define mempool_memalign mm_memalign
 #endif
 
+/****************************************************************************
+ * Name: foreach_free_handler
+ ****************************************************************************/
+
+static void foreach_free_handler(FAR void *ptr, size_t size, int used,
+                                 FAR void *user)
+{
+  FAR struct mm_foreach_free_s *priv = user;
+
+  /* A free block starts with its free list links and ends with the
+   * prev_phys_block field of the next block.
+   */
+
+  if (!used && size > 3 * sizeof(FAR void *))
+    {
+      priv->handler((FAR char *)ptr + 2 * sizeof(FAR void *),
+                    size - 3 * sizeof(FAR void *), priv->arg);
+    }
+}
+
 /****************************************************************************
  * Name: mallinfo_handler
  ****************************************************************************/
@@ -889,6 +915,46 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
 
+/****************************************************************************
+ * Name: mm_foreach_free
+ *
+ * Description:
+ *   Report the unused part of each free block in address order.  Nothing is
+ *   reported if the heap can't be locked.
+ *
+ ****************************************************************************/
+
+void mm_foreach_free(FAR struct mm_heap_s *heap, mm_free_handler_t handler,
+                     FAR void *arg)
+{
+  struct mm_foreach_free_s priv;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  DEBUGASSERT(handler);
+
+  priv.handler = handler;
+  priv.arg     = arg;
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      if (mm_lock(heap) < 0)
+        {
+          return;
+        }
+
+      tlsf_walk_pool(heap->mm_heapstart[region],
+                     foreach_free_handler, &priv);
+      mm_unlock(heap);
+    }
+#undef region
+}
+
 /****************************************************************************
  * Name: mm_heapmember
  *
@@ -29,6 +29,7 @@
 #include <errno.h>
 #include <stdlib.h>
 
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -81,6 +82,7 @@ FAR void *calloc(size_t n, size_t elem_size)
     }
   else
     {
+      heapprof_alloc(mem, n * elem_size);
       mm_notify_pressure(mm_heapfree(USR_HEAP),
                          mm_heapfree_largest(USR_HEAP));
     }
@@ -28,6 +28,7 @@
 
 #include <stdlib.h>
 
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -48,5 +49,6 @@
 #undef free /* See mm/README.txt */
 void free(FAR void *mem)
 {
+  heapprof_free(mem);
   mm_free(USR_HEAP, mem);
 }
@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -70,6 +71,7 @@ FAR void *malloc(size_t size)
     }
   else
     {
+      heapprof_alloc(ret, size);
       mm_notify_pressure(mm_heapfree(USR_HEAP),
                          mm_heapfree_largest(USR_HEAP));
     }
@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -92,6 +93,10 @@ FAR void *realloc(FAR void *oldmem, size_t size)
 #else
   FAR void *ret;
 
+  /* The old memory may be reused by others once it is reallocated */
+
+  heapprof_free(oldmem);
+
   ret = mm_realloc(USR_HEAP, oldmem, size);
   if (ret == NULL)
     {
@@ -99,6 +104,7 @@ FAR void *realloc(FAR void *oldmem, size_t size)
     }
   else
     {
+      heapprof_alloc(ret, size);
       mm_notify_pressure(mm_heapfree(USR_HEAP),
                          mm_heapfree_largest(USR_HEAP));
     }
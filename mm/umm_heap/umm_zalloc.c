@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <nuttx/mm/heapprof.h>
 #include <nuttx/mm/mm.h>
 
 #include "umm_heap/umm_heap.h"
@@ -76,6 +77,7 @@ FAR void *zalloc(size_t size)
     }
   else
     {
+      heapprof_alloc(ret, size);
       mm_notify_pressure(mm_heapfree(USR_HEAP),
                          mm_heapfree_largest(USR_HEAP));
     }
@@ -45,6 +45,7 @@
 #include <netinet/arp.h>
 #include <netinet/in.h>
 
+#include <nuttx/list.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/semaphore.h>
 
@@ -165,6 +166,8 @@ struct arp_entry_s
   struct ether_addr        at_ethaddr;  /* Hardware address */
   clock_t                  at_time;     /* Time of last usage */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
+  FAR struct arp_entry_s  *at_hnext;    /* Next entry in the hash bucket */
+  struct list_node         at_lru;      /* Most recently updated first */
 };
 
 /****************************************************************************
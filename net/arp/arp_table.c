@@ -73,6 +73,14 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+/* Fold the four address bytes so that hosts of one subnet, which differ
+ * in the last byte, spread over the buckets.
+ */
+
+#define ARP_HASH(ipaddr) \
+  (((ipaddr) ^ ((ipaddr) >> 8) ^ ((ipaddr) >> 16) ^ ((ipaddr) >> 24)) % \
+   CONFIG_NET_ARPTAB_HASHSIZE)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,6 +99,22 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The entries holding an address, chained by at_hnext in the bucket of
+ * their IP address.
+ */
+
+static FAR struct arp_entry_s *g_arphash[CONFIG_NET_ARPTAB_HASHSIZE];
+
+/* Entries that were ever used, most recently updated first.  Deleted
+ * entries are moved to the tail so that they are reused first.
+ */
+
+static struct list_node g_arplru = LIST_INITIAL_VALUE(g_arplru);
+
+/* The number of entries of g_arptable that were never used */
+
+static unsigned int g_arpfree = CONFIG_NET_ARPTAB_SIZE;
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -149,32 +173,74 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_unhash
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Remove an entry from the chain of its hash bucket.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static void arp_unhash(FAR struct arp_entry_s *tabptr)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
-    {
-      return e2;
-    }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+  FAR struct arp_entry_s **prev = &g_arphash[ARP_HASH(tabptr->at_ipaddr)];
+
+  while (*prev != NULL)
     {
-      return e1;
+      if (*prev == tabptr)
+        {
+          *prev = tabptr->at_hnext;
+          break;
+        }
+
+      prev = &(*prev)->at_hnext;
     }
-  else
+
+  tabptr->at_hnext = NULL;
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Forget the address held by an entry and make it the first one to be
+ *   reused.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry_s *tabptr)
+{
+  arp_unhash(tabptr);
+  tabptr->at_ipaddr = 0;
+
+  list_delete(&tabptr->at_lru);
+  list_add_tail(&g_arplru, &tabptr->at_lru);
+}
+
+/****************************************************************************
+ * Name: arp_search
+ *
+ * Description:
+ *   Find the ARP entry of this IP address and device regardless of its
+ *   age.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_search(in_addr_t ipaddr,
+                                          FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  for (tabptr = g_arphash[ARP_HASH(ipaddr)]; tabptr != NULL;
+       tabptr = tabptr->at_hnext)
     {
-      return e2;
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
     }
+
+  return NULL;
 }
 
 /****************************************************************************
@@ -197,19 +263,14 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check if the IPv4 address is in the ARP table and not expired */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr != NULL &&
+      clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return tabptr;
     }
 
   /* Not found */
@@ -276,42 +337,33 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
+  bool found;
   bool new_entry;
 #endif
-  int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in a never used entry or else in the
+   * least recently updated one.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-    {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
+  tabptr = arp_search(ipaddr, dev);
 #ifdef CONFIG_NETLINK_ROUTE
-          found = true;
+  found  = tabptr != NULL;
 #endif
-          break;
+
+  if (tabptr == NULL)
+    {
+      if (g_arpfree > 0)
+        {
+          tabptr = &g_arptable[--g_arpfree];
+          list_add_tail(&g_arplru, &tabptr->at_lru);
         }
       else
         {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+          tabptr = list_last_entry(&g_arplru, struct arp_entry_s, at_lru);
         }
     }
 
@@ -336,14 +388,32 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
 #endif
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
-   * information.
+   * information.  Rehash it if it held another address.
    */
 
+  if (!net_ipv4addr_cmp(tabptr->at_ipaddr, ipaddr) || tabptr->at_dev != dev)
+    {
+      FAR struct arp_entry_s **head = &g_arphash[ARP_HASH(ipaddr)];
+
+      if (tabptr->at_ipaddr != 0)
+        {
+          arp_unhash(tabptr);
+        }
+
+      tabptr->at_hnext = *head;
+      *head = tabptr;
+    }
+
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
 
+  /* It is now the most recently updated entry */
+
+  list_delete(&tabptr->at_lru);
+  list_add_head(&g_arplru, &tabptr->at_lru);
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -498,7 +568,7 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
       /* Yes.. Set the IP address to zero to "delete" it */
 
-      tabptr->at_ipaddr = 0;
+      arp_release(tabptr);
       return OK;
     }
 
@@ -527,7 +597,14 @@ void arp_cleanup(FAR struct net_driver_s *dev)
     {
       if (dev == g_arptable[i].at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          if (g_arptable[i].at_ipaddr != 0)
+            {
+              arp_release(&g_arptable[i]);
+            }
+
+          g_arptable[i].at_dev  = NULL;
+          g_arptable[i].at_time = 0;
+          memset(&g_arptable[i].at_ethaddr, 0, sizeof(struct ether_addr));
         }
     }
 }
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <stdint.h>
@@ -163,9 +164,11 @@ static ssize_t
       container->bn_iob = NULL;
       DEBUGASSERT(iob != NULL);
 
-      /* Copy the new packet data into the user buffer */
+      /* Copy the new packet data into the user buffer, a frame larger
+       * than the buffer is truncated as for any datagram socket.
+       */
 
-      copylen = iob->io_len - iob->io_offset;
+      copylen = MIN(iob->io_len - iob->io_offset, pstate->ir_buflen);
       memcpy(pstate->ir_buffer, &iob->io_data[iob->io_offset], copylen);
 
       ninfo("Received %d bytes\n", (int)copylen);
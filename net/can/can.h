@@ -57,6 +57,15 @@
 #define can_callback_free(dev,conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->sconn.list, &conn->sconn.list_tail)
 
+/* The CAN_RAW filters of a socket are summarized in a bitmap of the low ID
+ * bits that they can match, so that most frames a socket does not want are
+ * rejected with a single bit test.
+ */
+
+#define CAN_FILTER_HASHBITS 6
+#define CAN_FILTER_HASHSIZE (1 << CAN_FILTER_HASHBITS)
+#define CAN_FILTER_HASHMASK (CAN_FILTER_HASHSIZE - 1)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -106,6 +115,7 @@ struct can_conn_s
 #ifdef CONFIG_NET_CANPROTO_OPTIONS
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+  uint32_t filter_hash[CAN_FILTER_HASHSIZE / 32];
 #  ifdef CONFIG_NET_CAN_ERRORS
   can_err_mask_t err_mask;
 #  endif
@@ -197,6 +207,44 @@ FAR struct can_conn_s *can_nextconn(FAR struct can_conn_s *conn);
 FAR struct can_conn_s *can_active(FAR struct net_driver_s *dev,
                                   FAR struct can_conn_s *conn);
 
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Rebuild the ID bitmap of the CAN_RAW filters of a connection.  Must be
+ *   called each time conn->filters or conn->filter_count change.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_update(FAR struct can_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Check a received CAN ID against the CAN_RAW filters and the error
+ *   filter of a connection.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection
+ *   id   - The CAN ID of the frame, including the EFF/RTR/ERR flags
+ *
+ * Returned Value:
+ *   True if the connection wants the frame.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+bool can_filter_match(FAR struct can_conn_s *conn, canid_t id);
+#else
+#  define can_filter_match(conn, id) true
+#endif
+
 /****************************************************************************
  * Name: can_callback
  *
@@ -263,6 +311,28 @@ uint16_t can_datahandler(FAR struct net_driver_s *dev,
 ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Copy the frames already queued on a CAN socket into the entries of
+ *   'msgvec' with a single network lock.  This never waits; the first
+ *   message of a batch is received with can_recvmsg().
+ *
+ * Input Parameters:
+ *   psock   A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  The messages to fill, already validated by the caller
+ *   vlen    Number of entries in msgvec
+ *   flags   Receive flags
+ *
+ * Returned Value:
+ *   The number of frames received, possibly zero.
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: can_poll
  *
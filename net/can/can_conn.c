@@ -121,6 +121,7 @@ FAR struct can_conn_s *can_alloc(void)
        */
 
       conn->filter_count = 1;
+      can_filter_update(conn);
 #endif
 
       /* Enqueue the connection into the active list */
@@ -213,4 +214,110 @@ FAR struct can_conn_s *can_active(FAR struct net_driver_s *dev,
   return conn;
 }
 
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Rebuild the ID bitmap of the CAN_RAW filters of a connection.  Must be
+ *   called each time conn->filters or conn->filter_count change.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_update(FAR struct can_conn_s *conn)
+{
+  uint32_t hash[CAN_FILTER_HASHSIZE / 32];
+  int32_t i;
+
+  memset(hash, 0, sizeof(hash));
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      FAR struct can_filter *filter = &conn->filters[i];
+      uint32_t bucket;
+
+      /* An inverted filter or a mask that leaves some of the hashed ID bits
+       * open can match frames of any bucket.
+       */
+
+      if ((filter->can_id & CAN_INV_FILTER) != 0 ||
+          (filter->can_mask & CAN_FILTER_HASHMASK) != CAN_FILTER_HASHMASK)
+        {
+          memset(hash, 0xff, sizeof(hash));
+          break;
+        }
+
+      bucket = filter->can_id & CAN_FILTER_HASHMASK;
+      hash[bucket / 32] |= (uint32_t)1 << (bucket % 32);
+    }
+
+  memcpy(conn->filter_hash, hash, sizeof(hash));
+}
+
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Check a received CAN ID against the CAN_RAW filters and the error
+ *   filter of a connection.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection
+ *   id   - The CAN ID of the frame, including the EFF/RTR/ERR flags
+ *
+ * Returned Value:
+ *   True if the connection wants the frame.
+ *
+ ****************************************************************************/
+
+bool can_filter_match(FAR struct can_conn_s *conn, canid_t id)
+{
+  uint32_t bucket;
+  int32_t i;
+
+#ifdef CONFIG_NET_CAN_ERRORS
+  /* error message frame */
+
+  if ((id & CAN_ERR_FLAG) != 0)
+    {
+      return (id & conn->err_mask) != 0;
+    }
+#endif
+
+  /* Reject the frame at once if no filter can match its bucket */
+
+  bucket = id & CAN_FILTER_HASHMASK;
+  if ((conn->filter_hash[bucket / 32] & ((uint32_t)1 << (bucket % 32))) == 0)
+    {
+      return false;
+    }
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (conn->filters[i].can_id & CAN_INV_FILTER)
+        {
+          if ((id & conn->filters[i].can_mask) !=
+                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
+                 conn->filters[i].can_mask))
+            {
+              return true;
+            }
+        }
+      else
+        {
+          if ((id & conn->filters[i].can_mask) ==
+                (conn->filters[i].can_id & conn->filters[i].can_mask))
+            {
+              return true;
+            }
+        }
+    }
+
+  return false;
+}
+#endif /* CONFIG_NET_CANPROTO_OPTIONS */
+
 #endif /* CONFIG_NET_CAN */
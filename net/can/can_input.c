@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_CAN)
 
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -189,6 +190,34 @@ static int can_input_conn(FAR struct net_driver_s *dev,
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_input_next
+ *
+ * Description:
+ *   Find the next connection on the device that accepts a CAN ID.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received packet
+ *   conn   - The current connection; the search starts after it
+ *   can_id - The CAN ID of the received frame
+ *
+ * Returned Value:
+ *   The next connection or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct can_conn_s *can_input_next(FAR struct net_driver_s *dev,
+                                             FAR struct can_conn_s *conn,
+                                             canid_t can_id)
+{
+  while ((conn = can_active(dev, conn)) != NULL &&
+         !can_filter_match(conn, can_id))
+    {
+    }
+
+  return conn;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -217,10 +246,30 @@ static int can_in(FAR struct net_driver_s *dev)
 {
   FAR struct can_conn_s *conn = can_active(dev, NULL);
   FAR struct can_conn_s *nextconn;
+  canid_t can_id;
+
+  /* Only the connections whose filters accept the frame get a copy of it,
+   * so a frame is neither cloned nor queued for the sockets that do not
+   * want it.
+   */
+
+  memcpy(&can_id, dev->d_buf, sizeof(canid_t));
+
+  if (conn != NULL && !can_filter_match(conn, can_id))
+    {
+      conn = can_input_next(dev, conn, can_id);
+      if (conn == NULL)
+        {
+          /* No socket wants this frame, just drop it */
+
+          dev->d_len = 0;
+          return OK;
+        }
+    }
 
   /* Do we have second connection that can hold this packet? */
 
-  while ((nextconn = can_active(dev, conn)) != NULL)
+  while ((nextconn = can_input_next(dev, conn, can_id)) != NULL)
     {
       /* Yes... There are multiple listeners on the same dev.
        * We need to clone the packet and deliver it to each listener.
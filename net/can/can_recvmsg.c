@@ -74,10 +74,6 @@ struct can_recvfrom_s
  * Private Functions
  ****************************************************************************/
 
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
-static int can_recv_filter(FAR struct can_conn_s *conn, canid_t id);
-#endif
-
 /****************************************************************************
  * Name: can_add_recvlen
  *
@@ -241,30 +237,9 @@ static inline int can_readahead(struct can_recvfrom_s *pstate)
     {
       DEBUGASSERT(iob->io_pktlen > 0);
 
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
-      /* Check receive filters */
-
-      canid_t can_id;
-      iob_copyout((uint8_t *)&can_id, iob, sizeof(canid_t), 0);
-
-      if (can_recv_filter(conn, can_id) == 0)
-        {
-          FAR struct iob_s *tmp;
-
-          /* Remove the I/O buffer chain from the head of the read-ahead
-           * buffer queue.
-           */
-
-          tmp = iob_remove_queue(&conn->readahead);
-          DEBUGASSERT(tmp == iob);
-          UNUSED(tmp);
-
-          /* And free the I/O buffer chain */
-
-          iob_free_chain(iob);
-          return 0;
-        }
-#endif
+      /* The receive filters were checked by can_input() before the frame
+       * was queued.
+       */
 
 #ifdef CONFIG_NET_TIMESTAMP
       if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP) &&
@@ -330,45 +305,6 @@ static inline int can_readahead(struct can_recvfrom_s *pstate)
   return 0;
 }
 
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
-static int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
-{
-  uint32_t i;
-
-#ifdef CONFIG_NET_CAN_ERRORS
-  /* error message frame */
-
-  if ((id & CAN_ERR_FLAG) != 0)
-    {
-      return id & conn->err_mask ? 1 : 0;
-    }
-#endif
-
-  for (i = 0; i < conn->filter_count; i++)
-    {
-      if (conn->filters[i].can_id & CAN_INV_FILTER)
-        {
-          if ((id & conn->filters[i].can_mask) !=
-                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
-                 conn->filters[i].can_mask))
-            {
-              return 1;
-            }
-        }
-      else
-        {
-          if ((id & conn->filters[i].can_mask) ==
-                (conn->filters[i].can_id & conn->filters[i].can_mask))
-            {
-              return 1;
-            }
-        }
-    }
-
-  return 0;
-}
-#endif
-
 static uint16_t can_recvfrom_eventhandler(FAR struct net_driver_s *dev,
                                           FAR void *pvpriv, uint16_t flags)
 {
@@ -384,19 +320,9 @@ static uint16_t can_recvfrom_eventhandler(FAR struct net_driver_s *dev,
 
       if ((flags & CAN_NEWDATA) != 0)
         {
-          /* If a new packet is available, check receive filters
-           * when is valid then complete the read action.
+          /* If a new packet is available, complete the read action.  The
+           * receive filters were checked by can_input().
            */
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
-          canid_t can_id;
-          memcpy(&can_id, dev->d_appdata, sizeof(canid_t));
-
-          if (can_recv_filter(conn, can_id) == 0)
-            {
-              flags &= ~CAN_NEWDATA;
-              return flags;
-            }
-#endif
 
           /* do not pass frames with DLC > 8 to a legacy socket */
 #if defined(CONFIG_NET_CANPROTO_OPTIONS) && defined(CONFIG_NET_CAN_CANFD)
@@ -622,4 +548,88 @@ errout_with_state:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Copy the frames already queued on a CAN socket into the entries of
+ *   'msgvec' with a single network lock.  This never waits; the first
+ *   message of a batch is received with can_recvmsg().
+ *
+ * Input Parameters:
+ *   psock   A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  The messages to fill, already validated by the caller
+ *   vlen    Number of entries in msgvec
+ *   flags   Receive flags
+ *
+ * Returned Value:
+ *   The number of frames received, possibly zero.
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags)
+{
+  FAR struct can_conn_s *conn = psock->s_conn;
+  struct can_recvfrom_s state;
+  unsigned int count = 0;
+  int ret;
+
+  if (psock->s_type != SOCK_RAW)
+    {
+      return 0;
+    }
+
+  net_lock();
+
+  while (count < vlen && iob_peek_queue(&conn->readahead) != NULL)
+    {
+      FAR struct msghdr *msg = &msgvec[count].msg_hdr;
+      unsigned long msg_controllen = msg->msg_controllen;
+      FAR void *msg_control = msg->msg_control;
+
+      memset(&state, 0, sizeof(struct can_recvfrom_s));
+      state.pr_buflen = msg->msg_iov->iov_len;
+      state.pr_buffer = msg->msg_iov->iov_base;
+      state.pr_conn   = conn;
+
+#ifdef CONFIG_NET_TIMESTAMP
+      if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP))
+        {
+          state.pr_msgbuf = cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMP,
+                                        NULL, sizeof(struct timeval));
+          if (state.pr_msgbuf != NULL)
+            {
+              state.pr_msglen = sizeof(struct timeval);
+            }
+        }
+#endif
+
+      ret = can_readahead(&state);
+
+      /* Recover the cmsg pointer as psock_recvmsg() does */
+
+      msg->msg_control    = msg_control;
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+
+      if (ret > 0)
+        {
+          msgvec[count++].msg_len = ret;
+        }
+      else if (state.pr_buflen == 0)
+        {
+          /* Nothing can be received into this entry */
+
+          break;
+        }
+
+      /* Otherwise a CAN FD frame was dropped for a legacy socket, try the
+       * next one.
+       */
+    }
+
+  net_unlock();
+  return count;
+}
+
 #endif /* CONFIG_NET_CAN */
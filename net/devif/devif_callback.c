@@ -202,35 +202,26 @@ static void devif_callback_free(FAR struct net_driver_s *dev,
  *   occur.
  *
  * Input Parameters:
- *   events   - The set of events that has occurred.
+ *   evbits   - The individual event bits of the set of events that has
+ *              occurred, i.e. the set without the DEVPOLL_MASK field.
+ *   devpoll  - The encoded poll event of the set of events that has
+ *              occurred, or zero if none.
  *   triggers - The set of events that will trigger a callback.
  *
  ****************************************************************************/
 
-static bool devif_event_trigger(uint16_t events, uint16_t triggers)
+static inline_function bool devif_event_trigger(uint16_t evbits,
+                                                uint16_t devpoll,
+                                                uint16_t triggers)
 {
   /* The events are divided into a set of individual bits that may be ORed
-   * together PLUS a field that encodes a single poll event.
-   *
-   * First check if any of the individual event bits will trigger the
-   * callback.
+   * together PLUS a field that encodes a single poll event.  The caller
+   * splits the event set once for the whole list so that each callback is
+   * rejected with two compares.
    */
 
-  if ((events & triggers & ~DEVPOLL_MASK) != 0)
-    {
-      return true;
-    }
-
-  /* No... check the encoded device event. */
-
-  if ((events & DEVPOLL_MASK) == (triggers & DEVPOLL_MASK))
-    {
-      return (triggers & DEVPOLL_MASK) != 0;
-    }
-
-  /* No.. this event set will not generate the callback */
-
-  return false;
+  return (evbits & triggers) != 0 ||
+         (devpoll != 0 && devpoll == (triggers & DEVPOLL_MASK));
 }
 
 /****************************************************************************
@@ -450,6 +441,8 @@ uint16_t devif_conn_event(FAR struct net_driver_s *dev, uint16_t flags,
                           FAR struct devif_callback_s *list)
 {
   FAR struct devif_callback_s *next;
+  uint16_t evbits = flags & ~DEVPOLL_MASK;
+  uint16_t devpoll = flags & DEVPOLL_MASK;
 
   /* Loop for each callback in the list and while there are still events
    * set in the flags set.
@@ -467,14 +460,17 @@ uint16_t devif_conn_event(FAR struct net_driver_s *dev, uint16_t flags,
 
       /* Check if this callback handles any of the events in the flag set */
 
-      if (list->event != NULL && devif_event_trigger(flags, list->flags))
+      if (list->event != NULL &&
+          devif_event_trigger(evbits, devpoll, list->flags))
         {
           /* Yes.. perform the callback.  Actions perform by the callback
            * may delete the current list entry or add a new list entry to
            * beginning of the list (which will be ignored on this pass)
            */
 
-          flags = list->event(dev, list->priv, flags);
+          flags   = list->event(dev, list->priv, flags);
+          evbits  = flags & ~DEVPOLL_MASK;
+          devpoll = flags & DEVPOLL_MASK;
         }
 
       /* Set up for the next time through the loop */
@@ -509,6 +505,8 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, uint16_t flags)
 {
   FAR struct devif_callback_s *cb;
   FAR struct devif_callback_s *next;
+  uint16_t evbits = flags & ~DEVPOLL_MASK;
+  uint16_t devpoll = flags & DEVPOLL_MASK;
 
   /* Loop for each callback in the list and while there are still events
    * set in the flags set.
@@ -526,7 +524,8 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, uint16_t flags)
 
       /* Check if this callback handles any of the events in the flag set */
 
-      if (cb->event != NULL && devif_event_trigger(flags, cb->flags))
+      if (cb->event != NULL &&
+          devif_event_trigger(evbits, devpoll, cb->flags))
         {
           cb->free_flags |= DEVIF_CB_DONT_FREE;
 
@@ -535,7 +534,9 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, uint16_t flags)
            * beginning of the list (which will be ignored on this pass)
            */
 
-          flags = cb->event(dev, cb->priv, flags);
+          flags   = cb->event(dev, cb->priv, flags);
+          evbits  = flags & ~DEVPOLL_MASK;
+          devpoll = flags & DEVPOLL_MASK;
           cb->free_flags &= ~DEVIF_CB_DONT_FREE;
 
           /* update the next callback to prevent previously recorded the
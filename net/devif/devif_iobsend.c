@@ -74,7 +74,13 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  /* Devices doing segmentation offload take TCP packets up to d_gso_max */
+
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset
+#  ifdef CONFIG_NETDEV_GSO
+      && len + target_offset > dev->d_gso_max
+#  endif
+     )
     {
       ret = -EMSGSIZE;
       goto errout;
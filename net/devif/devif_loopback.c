@@ -105,6 +105,16 @@ int devif_loopback(FAR struct net_driver_s *dev)
        NETDEV_TXPACKETS(dev);
        NETDEV_RXPACKETS(dev);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+      /* A checksum left to the device is never filled in on the way back
+       * to ourself, so take the packet as checked.
+       */
+
+      dev->d_chksum_flags =
+        (dev->d_chksum_flags & NETDEV_CHKSUM_PARTIAL) != 0 ?
+        NETDEV_CHKSUM_VERIFIED : 0;
+#endif
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
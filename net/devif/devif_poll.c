@@ -614,6 +614,15 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
         }
     }
 
+  /* If the driver stopped the poll after the output of this connection,
+   * the next poll starts with the connection that follows it.
+   */
+
+  if (bstop)
+    {
+      udp_conn_rotate(conn);
+    }
+
   return bstop;
 }
 #endif /* NET_UDP_HAVE_STACK */
@@ -659,6 +668,17 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
         }
     }
 
+  /* If the driver stopped the poll after the output of this connection,
+   * the next poll starts with the connection that follows it.  Otherwise
+   * the first connections of the list would be served on every poll and
+   * could starve the others.
+   */
+
+  if (bstop)
+    {
+      tcp_conn_rotate(conn);
+    }
+
   return bstop;
 }
 #else
@@ -61,6 +61,7 @@
 #include <nuttx/net/ip.h>
 
 #include "devif/devif.h"
+#include "socket/socket.h"
 #include "icmp/icmp.h"
 #include "utils/utils.h"
 
@@ -126,7 +127,8 @@ static uint16_t icmp_datahandler(FAR struct net_driver_s *dev,
   uint16_t buflen;
   int ret;
 
-  iob = iob_tryalloc(false);
+  iob = iob_tryalloc_size(sizeof(struct sockaddr_in) +
+                          dev->d_iob->io_pktlen, false);
   if (iob == NULL)
     {
       return -ENOMEM;
@@ -208,6 +210,16 @@ static int icmp_delivery_callback(FAR struct icmp_conn_s *conn,
       return 0;
     }
 
+#ifdef CONFIG_NET_BPF
+  /* The socket filter sees the packet from the IP header on */
+
+  if (conn->bpf != NULL &&
+      sock_bpf_run(conn->bpf, dev->d_iob, 0, dev->d_iob->io_pktlen) == 0)
+    {
+      return 0;
+    }
+#endif
+
   info->delivered = true;
   if (devif_conn_event(dev, ICMP_NEWDATA, conn->sconn.list) == ICMP_NEWDATA)
     {
@@ -271,6 +271,12 @@ static int icmp_close(FAR struct socket *psock)
 
       iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_BPF
+      /* And the socket filter */
+
+      sock_bpf_free(&conn->bpf);
+#endif
+
       /* Then free the connection structure */
 
       conn->crefs = 0;           /* No more references on the connection */
@@ -489,7 +495,16 @@ static int icmp_setsockopt(FAR struct socket *psock, int level, int option,
     case IPPROTO_IP:
       return ipv4_setsockopt(psock, option, value, value_len);
 
-    case IPPROTO_ICMP:
+    case IPPROTO_ICMP: /* Same value as SOL_SOCKET */
+#ifdef CONFIG_NET_BPF
+      if (option == SO_ATTACH_FILTER || option == SO_DETACH_FILTER)
+        {
+          FAR struct icmp_conn_s *conn = psock->s_conn;
+
+          return sock_bpf_setsockopt(&conn->bpf, option, value, value_len);
+        }
+#endif
+
       return icmp_setsockopt_internal(psock, option, value, value_len);
 
     default:
@@ -68,6 +68,7 @@ struct pollfd;       /* Forward reference */
 /* Representation of a IPPROTO_ICMP socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct bpf_prog_s;       /* Forward reference */
 
 /* This is a container that holds the poll-related information */
 
@@ -100,6 +101,9 @@ struct icmpv6_conn_s
 
   struct iob_queue_s readahead;  /* Read-ahead buffering */
   struct icmp6_filter filter;    /* ICMP6 type filter */
+#ifdef CONFIG_NET_BPF
+  FAR struct bpf_prog_s *bpf;    /* SO_ATTACH_FILTER program */
+#endif
 
   /* The following is a list of poll structures of threads waiting for
    * socket events.
@@ -39,6 +39,7 @@
 #include "devif/devif.h"
 #include "netlink/netlink.h"
 #include "neighbor/neighbor.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 #include "icmpv6/icmpv6.h"
 #include "mld/mld.h"
@@ -117,7 +118,8 @@ static uint16_t icmpv6_datahandler(FAR struct net_driver_s *dev,
   uint16_t buflen;
   int ret;
 
-  iob = iob_tryalloc(false);
+  iob = iob_tryalloc_size(sizeof(struct sockaddr_in6) + 1 +
+                          dev->d_iob->io_pktlen - iplen, false);
   if (iob == NULL)
     {
       return -ENOMEM;
@@ -199,6 +201,16 @@ static int icmpv6_delivery_callback(FAR struct icmpv6_conn_s *conn,
       return 0;
     }
 
+#ifdef CONFIG_NET_BPF
+  /* The socket filter sees the packet from the IPv6 header on */
+
+  if (conn->bpf != NULL &&
+      sock_bpf_run(conn->bpf, dev->d_iob, 0, dev->d_iob->io_pktlen) == 0)
+    {
+      return 0;
+    }
+#endif
+
   info->delivered = true;
   if (devif_conn_event(dev, ICMPv6_NEWDATA, conn->sconn.list) !=
       ICMPv6_NEWDATA)
@@ -269,6 +269,12 @@ static int icmpv6_close(FAR struct socket *psock)
 
       iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_BPF
+      /* And the socket filter */
+
+      sock_bpf_free(&conn->bpf);
+#endif
+
       /* Then free the connection structure */
 
       conn->crefs = 0;             /* No more references on the connection */
@@ -484,6 +490,15 @@ static int icmpv6_setsockopt(FAR struct socket *psock, int level, int option,
 {
   switch (level)
     {
+#ifdef CONFIG_NET_BPF
+      case SOL_SOCKET:
+        {
+          FAR struct icmpv6_conn_s *conn = psock->s_conn;
+
+          return sock_bpf_setsockopt(&conn->bpf, option, value, value_len);
+        }
+#endif
+
       case IPPROTO_IPV6:
         return ipv6_setsockopt(psock, option, value, value_len);
 
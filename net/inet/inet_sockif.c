@@ -97,6 +97,12 @@ static ssize_t    inet_sendmsg(FAR struct socket *psock,
                                FAR struct msghdr *msg, int flags);
 static ssize_t    inet_recvmsg(FAR struct socket *psock,
                                FAR struct msghdr *msg, int flags);
+static int        inet_sendmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
 static int        inet_ioctl(FAR struct socket *psock,
                              int cmd, unsigned long arg);
 static int        inet_socketpair(FAR struct socket *psocks[2]);
@@ -144,6 +150,8 @@ static const struct sock_intf_s g_inet_sockif =
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
 #endif
+  , inet_sendmmsg   /* si_sendmmsg */
+  , inet_recvmmsg   /* si_recvmmsg */
 };
 
 /****************************************************************************
@@ -975,6 +983,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the receive buffer size */
 
               tcp->rcv_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+              tcp->flags   |= TCP_RCVBUF_LOCK;
+#endif
             }
           else
 #endif
@@ -1884,6 +1895,15 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EBADF;
     }
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+  /* sendto(MSG_FASTOPEN) connects a TCP socket with data in the SYN */
+
+  if (psock->s_type == SOCK_STREAM && (flags & MSG_FASTOPEN) != 0)
+    {
+      return tcp_fastopen_sendto(psock, buf, len, flags, to, tolen);
+    }
+#endif
+
 #ifdef CONFIG_NET_UDP
   if (psock->s_type != SOCK_DGRAM)
     {
@@ -2362,6 +2382,94 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Send a vector of messages.  For UDP the network stays locked for the
+ *   whole batch: the lock is taken once, and since the driver can not
+ *   drain the write queue meanwhile only the first datagram finds it empty
+ *   and notifies the device.  The lock is still released wherever a single
+ *   send would wait for buffers.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The messages to send
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, or a negated errno value if the first one
+ *   failed.
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags)
+{
+  unsigned int count;
+  ssize_t ret = OK;
+  bool locked = false;
+
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      net_lock();
+      locked = true;
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = ret;
+    }
+
+  if (locked)
+    {
+      net_unlock();
+    }
+
+  return count > 0 ? count : ret;
+}
+
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Receive the messages already queued on the socket into 'msgvec'
+ *   without waiting.  Only UDP queues whole datagrams; for other socket
+ *   types nothing is taken and the caller receives one message at a time.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The messages to fill
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of messages received, possibly zero.
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags)
+{
+#if defined(CONFIG_NET_UDP) && defined(NET_UDP_HAVE_STACK)
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      return psock_udp_recvmmsg(psock, msgvec, vlen, flags);
+    }
+#endif
+
+  return 0;
+}
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
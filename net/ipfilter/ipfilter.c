@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
@@ -65,6 +66,53 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+#  define IPFILTER_HASHSIZE CONFIG_NET_IPFILTER_INDEX_HASHSIZE
+#  define IPFILTER_NKEYS    (IPFILTER_KEY_MAX + 1)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+/* The exact match an entry is indexed by, in order of preference.  Entries
+ * without any of them are only on the 'any' list of the index.
+ */
+
+enum ipfilter_key_e
+{
+  IPFILTER_KEY_DPORT = 0,     /* A single TCP/UDP destination port */
+  IPFILTER_KEY_DSTIP,         /* A single destination address */
+  IPFILTER_KEY_SRCIP,         /* A single source address */
+  IPFILTER_KEY_MAX
+};
+
+/* The index of one chain.  Every entry is on exactly one list, either the
+ * 'any' list or the hash bucket of its key, and every list is in chain
+ * order.  A packet can only match the entries on the 'any' list and on the
+ * buckets of its own keys, so merging those few lists by position gives
+ * the same first match as walking the whole chain.  References are the
+ * chain position + 1, zero meaning none.
+ */
+
+struct ipfilter_index_s
+{
+  FAR const struct ipfilter_entry_s **entries; /* Entries in chain order */
+  FAR uint16_t *next;                          /* Next entry on same list */
+  uint16_t any;                                /* Entries with no key */
+  uint16_t head[IPFILTER_KEY_MAX][IPFILTER_HASHSIZE];
+  bool valid;                                  /* Matches the chain */
+};
+
+/* Classify an entry: return its key and the hash of the key value, or a
+ * negative value if the entry can not be indexed.
+ */
+
+typedef int (*ipfilter_classify_t)(FAR const struct ipfilter_entry_s *entry,
+                                   FAR unsigned int *hash);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -76,6 +124,15 @@ static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+#  ifdef CONFIG_NET_IPv4
+static struct ipfilter_index_s g_ipv4_index[IPFILTER_CHAIN_MAX];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static struct ipfilter_index_s g_ipv6_index[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -188,6 +245,352 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipv4_filter_entry_match / ipv6_filter_entry_match
+ *
+ * Description:
+ *   Match the packet with one filter entry.
+ *
+ * Input Parameters:
+ *   filter    - The filter entry to match
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   l4hdr     - The L4 header
+ *   proto     - The L4 protocol (IPv6 only)
+ *
+ * Returned Value:
+ *   true  - The input packet is matched
+ *   false - The input packet is not matched
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static bool
+ipv4_filter_entry_match(FAR const struct ipv4_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv4_hdr_s *ipv4,
+                        FAR const void *l4hdr)
+{
+  in_addr_t ipaddr;
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static bool
+ipv6_filter_entry_match(FAR const struct ipv6_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv6_hdr_s *ipv6,
+                        FAR const void *l4hdr, uint8_t proto)
+{
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+
+/****************************************************************************
+ * Name: ipfilter_hash_ipv4 / ipfilter_hash_ipv6
+ *
+ * Description:
+ *   Hash an address into an index bucket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static unsigned int ipfilter_hash_ipv4(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  return (hash ^ (hash >> 16)) % IPFILTER_HASHSIZE;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static unsigned int ipfilter_hash_ipv6(FAR const uint16_t *ipaddr)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = (hash << 3) ^ (hash >> 29) ^ ipaddr[i];
+    }
+
+  return hash % IPFILTER_HASHSIZE;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_dport_key
+ *
+ * Description:
+ *   Return true if the entry only matches TCP or UDP packets to a single
+ *   destination port.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_dport_key(FAR const struct ipfilter_entry_s *entry)
+{
+  return (entry->proto == IP_PROTO_TCP || entry->proto == IP_PROTO_UDP) &&
+         !entry->inv_proto && entry->match_tcpudp && !entry->inv_dport &&
+         entry->match.tcpudp.dports[0] == entry->match.tcpudp.dports[1];
+}
+
+/****************************************************************************
+ * Name: ipv4_filter_classify / ipv6_filter_classify
+ *
+ * Description:
+ *   Return the key entry is indexed by, see ipfilter_classify_t.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int ipv4_filter_classify(FAR const struct ipfilter_entry_s *entry,
+                                FAR unsigned int *hash)
+{
+  FAR const struct ipv4_filter_entry_s *filter =
+    (FAR const struct ipv4_filter_entry_s *)entry;
+
+  if (ipfilter_dport_key(entry))
+    {
+      *hash = entry->match.tcpudp.dports[0] % IPFILTER_HASHSIZE;
+      return IPFILTER_KEY_DPORT;
+    }
+
+  if (!entry->inv_dstip && net_ipv4addr_cmp(filter->dmsk, UINT32_MAX))
+    {
+      *hash = ipfilter_hash_ipv4(filter->dip);
+      return IPFILTER_KEY_DSTIP;
+    }
+
+  if (!entry->inv_srcip && net_ipv4addr_cmp(filter->smsk, UINT32_MAX))
+    {
+      *hash = ipfilter_hash_ipv4(filter->sip);
+      return IPFILTER_KEY_SRCIP;
+    }
+
+  return -ENOENT;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int ipv6_filter_classify(FAR const struct ipfilter_entry_s *entry,
+                                FAR unsigned int *hash)
+{
+  FAR const struct ipv6_filter_entry_s *filter =
+    (FAR const struct ipv6_filter_entry_s *)entry;
+
+  if (ipfilter_dport_key(entry))
+    {
+      *hash = entry->match.tcpudp.dports[0] % IPFILTER_HASHSIZE;
+      return IPFILTER_KEY_DPORT;
+    }
+
+  if (!entry->inv_dstip && net_ipv6_mask2pref(filter->dmsk) == 128)
+    {
+      *hash = ipfilter_hash_ipv6(filter->dip);
+      return IPFILTER_KEY_DSTIP;
+    }
+
+  if (!entry->inv_srcip && net_ipv6_mask2pref(filter->smsk) == 128)
+    {
+      *hash = ipfilter_hash_ipv6(filter->sip);
+      return IPFILTER_KEY_SRCIP;
+    }
+
+  return -ENOENT;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_index_build
+ *
+ * Description:
+ *   Build the index of a chain.  If there is no memory for it the index is
+ *   left empty, and the chain is then walked in full.
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_build(FAR struct ipfilter_index_s *index,
+                                 FAR const sq_queue_t *queue,
+                                 ipfilter_classify_t classify)
+{
+  FAR const sq_entry_t *entry;
+  unsigned int hash;
+  size_t count = 0;
+  size_t i;
+  int key;
+
+  kmm_free(index->entries);
+  memset(index, 0, sizeof(*index));
+  index->valid = true;
+
+  sq_for_every(queue, entry)
+    {
+      count++;
+    }
+
+  if (count == 0 || count >= UINT16_MAX)
+    {
+      return;
+    }
+
+  index->entries = kmm_malloc(count * (sizeof(*index->entries) +
+                                       sizeof(*index->next)));
+  if (index->entries == NULL)
+    {
+      nwarn("WARNING: No memory to index %zu filters\n", count);
+      return;
+    }
+
+  index->next = (FAR uint16_t *)&index->entries[count];
+
+  i = 0;
+  sq_for_every(queue, entry)
+    {
+      index->entries[i++] = (FAR const struct ipfilter_entry_s *)entry;
+    }
+
+  /* Push the entries from the last one so that every list ends up in
+   * chain order.
+   */
+
+  while (i-- > 0)
+    {
+      FAR uint16_t *head;
+
+      key  = classify(index->entries[i], &hash);
+      head = key < 0 ? &index->any : &index->head[key][hash];
+
+      index->next[i] = *head;
+      *head = i + 1;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_next
+ *
+ * Description:
+ *   Take the earliest entry from the lists in 'lists', which are the
+ *   candidates for one packet.
+ *
+ * Returned Value:
+ *   The entry, or NULL once all lists are exhausted.
+ *
+ ****************************************************************************/
+
+static FAR const struct ipfilter_entry_s *
+ipfilter_index_next(FAR const struct ipfilter_index_s *index,
+                    FAR uint16_t *lists)
+{
+  FAR uint16_t *first = NULL;
+  uint16_t ref;
+  int i;
+
+  for (i = 0; i < IPFILTER_NKEYS; i++)
+    {
+      if (lists[i] != 0 && (first == NULL || lists[i] < *first))
+        {
+          first = &lists[i];
+        }
+    }
+
+  if (first == NULL)
+    {
+      return NULL;
+    }
+
+  ref    = *first;
+  *first = index->next[ref - 1];
+  return index->entries[ref - 1];
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_lists
+ *
+ * Description:
+ *   Set up the candidate lists for a packet.  'hash' holds the bucket of
+ *   each key of the packet, or a negative value if it has none.
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_lists(FAR const struct ipfilter_index_s *index,
+                                 FAR const int *hash, FAR uint16_t *lists)
+{
+  int key;
+
+  for (key = 0; key < IPFILTER_KEY_MAX; key++)
+    {
+      lists[key] = hash[key] < 0 ? 0 : index->head[key][hash[key]];
+    }
+
+  lists[IPFILTER_KEY_MAX] = index->any;
+}
+
+#endif /* CONFIG_NET_IPFILTER_INDEX */
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -217,8 +620,11 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
   FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
   FAR const sq_entry_t *entry;
   FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR struct ipfilter_index_s *index = &g_ipv4_index[chain];
+  uint16_t lists[IPFILTER_NKEYS];
+  int hash[IPFILTER_KEY_MAX];
+#endif
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -229,45 +635,55 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv4_L4HDR(ipv4);
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  if (!index->valid)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
-
-      /* Match device */
+      ipfilter_index_build(index, queue, ipv4_filter_classify);
+    }
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+  if (index->entries != NULL)
+    {
+      if (ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP)
         {
-          continue;
+          FAR const struct udp_hdr_s *udp = l4hdr;
+          hash[IPFILTER_KEY_DPORT] = NTOHS(udp->destport) %
+                                     IPFILTER_HASHSIZE;
         }
-
-      /* Match addresses */
-
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
+      else
         {
-          continue;
+          hash[IPFILTER_KEY_DPORT] = -1;
         }
 
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+      hash[IPFILTER_KEY_DSTIP] =
+        ipfilter_hash_ipv4(net_ip4addr_conv32(ipv4->destipaddr));
+      hash[IPFILTER_KEY_SRCIP] =
+        ipfilter_hash_ipv4(net_ip4addr_conv32(ipv4->srcipaddr));
+
+      ipfilter_index_lists(index, hash, lists);
+      while ((filter = (FAR const struct ipv4_filter_entry_s *)
+                       ipfilter_index_next(index, lists)) != NULL)
         {
-          continue;
+          if (ipv4_filter_entry_match(filter, indev, outdev, ipv4, l4hdr))
+            {
+              return filter->common.target;
+            }
         }
 
-      /* Match protocol */
+      ninfo("No filter matched, maybe uninitialized.\n");
+      return IPFILTER_TARGET_ACCEPT;
+    }
+#endif
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
-        {
-          continue;
-        }
+  sq_for_every(queue, entry)
+    {
+      filter = (FAR struct ipv4_filter_entry_s *)entry;
 
       /* Return the target action if matched. */
 
-      return filter->common.target;
+      if (ipv4_filter_entry_match(filter, indev, outdev, ipv4, l4hdr))
+        {
+          return filter->common.target;
+        }
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -288,7 +704,11 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
   FAR const sq_entry_t *entry;
   FAR const void *l4hdr;
   uint8_t proto;
-  bool matched;
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  FAR struct ipfilter_index_s *index = &g_ipv6_index[chain];
+  uint16_t lists[IPFILTER_NKEYS];
+  int hash[IPFILTER_KEY_MAX];
+#endif
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -299,45 +719,55 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  if (!index->valid)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
-
-      /* Match device */
+      ipfilter_index_build(index, queue, ipv6_filter_classify);
+    }
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+  if (index->entries != NULL)
+    {
+      if (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP)
         {
-          continue;
+          FAR const struct udp_hdr_s *udp = l4hdr;
+          hash[IPFILTER_KEY_DPORT] = NTOHS(udp->destport) %
+                                     IPFILTER_HASHSIZE;
         }
-
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
+      else
         {
-          continue;
+          hash[IPFILTER_KEY_DPORT] = -1;
         }
 
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+      hash[IPFILTER_KEY_DSTIP] = ipfilter_hash_ipv6(ipv6->destipaddr);
+      hash[IPFILTER_KEY_SRCIP] = ipfilter_hash_ipv6(ipv6->srcipaddr);
+
+      ipfilter_index_lists(index, hash, lists);
+      while ((filter = (FAR const struct ipv6_filter_entry_s *)
+                       ipfilter_index_next(index, lists)) != NULL)
         {
-          continue;
+          if (ipv6_filter_entry_match(filter, indev, outdev, ipv6, l4hdr,
+                                      proto))
+            {
+              return filter->common.target;
+            }
         }
 
-      /* Match protocol */
+      ninfo("No filter matched, maybe uninitialized.\n");
+      return IPFILTER_TARGET_ACCEPT;
+    }
+#endif
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
-        {
-          continue;
-        }
+  sq_for_every(queue, entry)
+    {
+      filter = (FAR struct ipv6_filter_entry_s *)entry;
 
       /* Return the target action if matched. */
 
-      return filter->common.target;
+      if (ipv6_filter_entry_match(filter, indev, outdev, ipv6, l4hdr,
+                                  proto))
+        {
+          return filter->common.target;
+        }
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -411,6 +841,9 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      g_ipv4_index[chain].valid = false;
+#endif
     }
 #endif
 
@@ -418,6 +851,9 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET6)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      g_ipv6_index[chain].valid = false;
+#endif
     }
 #endif
 }
@@ -448,6 +884,10 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
         {
           kmm_free(sq_remfirst(queue));
         }
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      g_ipv4_index[chain].valid = false;
+#endif
     }
 #endif
 
@@ -459,6 +899,10 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
         {
           kmm_free(sq_remfirst(queue));
         }
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+      g_ipv6_index[chain].valid = false;
+#endif
     }
 #endif
 }
@@ -32,6 +32,8 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <netinet/in.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -368,5 +370,54 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flowcache_finddev
+ *
+ * Description:
+ *   Return the device a packet from 'srcipaddr' to 'destipaddr' must be
+ *   forwarded on.  A cached decision is used if there is one, otherwise
+ *   the device is looked up with netdev_findby_ripv4addr() and the
+ *   decision is cached.
+ *
+ * Input Parameters:
+ *   srcipaddr  - The source address of the packet
+ *   destipaddr - The destination address of the packet
+ *
+ * Returned Value:
+ *   The output device, or NULL if the destination is not routable.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && defined(CONFIG_NET_IPv4)
+FAR struct net_driver_s *ipv4_flowcache_finddev(in_addr_t srcipaddr,
+                                                in_addr_t destipaddr);
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Invalidate every cached forwarding decision.  This must be called
+ *   whenever a route, a device address or the set of devices that are up
+ *   changes.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flowcache_flush(void);
+#else
+#  define ipfwd_flowcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLOWCACHE_HASH(s, d) \
+  (((uint32_t)(s) ^ (uint32_t)(d) ^ ((uint32_t)(d) >> 16)) % \
+   CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached forwarding decision.  The output device only depends on the
+ * source and destination addresses, so that is all the key holds.
+ */
+
+#ifdef CONFIG_NET_IPv4
+struct ipv4_flowcache_s
+{
+  FAR struct net_driver_s *dev;  /* Output device */
+  in_addr_t srcipaddr;           /* Source address of the flow */
+  in_addr_t destipaddr;          /* Destination address of the flow */
+  uint32_t gen;                  /* Generation the entry was made in */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The generation starts at one so that zeroed entries never match */
+
+static uint32_t g_flowcache_gen = 1;
+
+#ifdef CONFIG_NET_IPv4
+static struct ipv4_flowcache_s
+  g_ipv4_flowcache[CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Invalidate every cached forwarding decision.  Called whenever a route,
+ *   a device address or the set of devices that are up changes.
+ *
+ ****************************************************************************/
+
+void ipfwd_flowcache_flush(void)
+{
+  net_lock();
+  g_flowcache_gen++;
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: ipv4_flowcache_finddev
+ *
+ * Description:
+ *   Return the device a packet from 'srcipaddr' to 'destipaddr' must be
+ *   forwarded on.  A cached decision is used if there is one, otherwise
+ *   the device is looked up with netdev_findby_ripv4addr() and the
+ *   decision is cached.
+ *
+ * Returned Value:
+ *   The output device, or NULL if the destination is not routable.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+FAR struct net_driver_s *ipv4_flowcache_finddev(in_addr_t srcipaddr,
+                                                in_addr_t destipaddr)
+{
+  FAR struct ipv4_flowcache_s *entry;
+  FAR struct net_driver_s *dev;
+
+  entry = &g_ipv4_flowcache[FLOWCACHE_HASH(srcipaddr, destipaddr)];
+  if (entry->gen == g_flowcache_gen &&
+      net_ipv4addr_cmp(entry->destipaddr, destipaddr) &&
+      net_ipv4addr_cmp(entry->srcipaddr, srcipaddr) &&
+      IFF_IS_UP(entry->dev->d_flags))
+    {
+      return entry->dev;
+    }
+
+  dev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+  if (dev != NULL)
+    {
+      entry->dev        = dev;
+      entry->srcipaddr  = srcipaddr;
+      entry->destipaddr = destipaddr;
+      entry->gen        = g_flowcache_gen;
+    }
+
+  return dev;
+}
+#endif
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
@@ -92,9 +92,19 @@ do  \
 #define IOBUF_CNT(ptr)    (((ptr)->io_pktlen + CONFIG_IOB_BUFSIZE - 1)/ \
                           CONFIG_IOB_BUFSIZE)
 
-/* The maximum I/O buffer occupied by fragment reassembly cache */
+/* When the fragment reassembly cache holds more I/O buffers than the high
+ * watermark, the oldest datagrams are evicted until it holds no more than
+ * the low watermark.
+ */
+
+#define REASSEMBLY_HIGHWATER \
+  (CONFIG_IOB_NBUFFERS * CONFIG_NET_IPFRAG_REASS_HIGHWATER / 100)
+#define REASSEMBLY_LOWWATER \
+  (CONFIG_IOB_NBUFFERS * CONFIG_NET_IPFRAG_REASS_LOWWATER / 100)
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_REASS_LOWWATER > CONFIG_NET_IPFRAG_REASS_HIGHWATER
+#  error CONFIG_NET_IPFRAG_REASS_LOWWATER exceeds the high watermark
+#endif
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -115,15 +125,18 @@ static struct wdog_s g_wdfragtimeout;
 
 static struct work_s g_wkfragtimeout;
 
-/* Remember the number of I/O buffers currently in reassembly cache */
+/* Remember the number of I/O buffers and of datagrams currently in
+ * reassembly cache
+ */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
+static uint32_t      g_nodeoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Hashtable of the datagrams of all NICs, keyed by the hash of the
+ * datagram identification.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static DECLARE_HASHTABLE(g_assemblyhash, CONFIG_NET_IPFRAG_HASH_BITS);
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -135,8 +148,8 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
+/* Only one thread can access g_assemblyhash and g_assemblyhead_time at a
+ * time.
  */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
@@ -151,6 +164,9 @@ static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
 static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
+static void ip_fragin_getkey(FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key);
+static uint32_t ip_fragin_hashkey(FAR const struct ip_fragkey_s *key);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
 
@@ -227,6 +243,9 @@ static void ip_fragin_timerwork(FAR void *arg)
            */
 
           ninfo("Reassembly timeout occurs!");
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipfrag.timedout++;
+#endif
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
           if ((node->verifyflag & IP_FRAGVERIFY_RECVDZEROFRAG) != 0)
             {
@@ -411,8 +430,9 @@ static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
  * Name: ip_fragin_cachemonitor
  *
  * Description:
- *   Check the reassembly cache buffer size, if it exceeds the configured
- *   threshold, some I/O buffers need to be freed
+ *   Check the reassembly cache buffer size.  If it exceeds the high
+ *   watermark, evict the oldest datagrams until it is back under the low
+ *   watermark.
  *
  * Input Parameters:
  *   curnode - node of the upper-level linked list, it maintains information
@@ -425,20 +445,17 @@ static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
 
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 {
-  uint32_t        cleancnt = 0;
-  uint32_t        bufcnt;
   FAR sq_entry_t *entry;
   FAR sq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
-  /* Start cache cleaning if g_bufoccupy exceeds the cache threshold */
+  /* Start cache cleaning if g_bufoccupy exceeds the high watermark */
 
-  if (g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB)
+  if (g_bufoccupy > REASSEMBLY_HIGHWATER)
     {
-      cleancnt = g_bufoccupy - REASSEMBLY_MAXOCCUPYIOB;
       entry = sq_peek(&g_assemblyhead_time);
 
-      while (entry != NULL && cleancnt > 0)
+      while (entry != NULL && g_bufoccupy > REASSEMBLY_LOWWATER)
         {
           entrynext = sq_next(entry);
 
@@ -461,12 +478,14 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
                     }
                 }
 
-              /* Remove node from single-list and free node memory */
+              /* Remove node from the lists and free node memory */
 
-              bufcnt = ip_frag_remnode(node);
+              ip_frag_remnode(node);
               kmm_free(node);
 
-              cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
+#ifdef CONFIG_NET_STATISTICS
+              g_netstats.ipfrag.evicted++;
+#endif
             }
 
           entry = entrynext;
@@ -474,6 +493,79 @@ static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
     }
 }
 
+/****************************************************************************
+ * Name: ip_fragin_getkey
+ *
+ * Description:
+ *   Get the identification of the datagram of a fragment from its IP
+ *   header.
+ *
+ * Input Parameters:
+ *   fraglink - node of the lower-level linked list, it maintains information
+ *              of one fragment
+ *   key      - The location to return the identification
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void ip_fragin_getkey(FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key)
+{
+  FAR struct iob_s *iob = fraglink->frag;
+
+  memset(key, 0, sizeof(*key));
+  key->ipid   = fraglink->ipid;
+  key->isipv4 = fraglink->isipv4;
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      memcpy(key->srcipaddr, ipv4->srcipaddr, sizeof(ipv4->srcipaddr));
+      memcpy(key->destipaddr, ipv4->destipaddr, sizeof(ipv4->destipaddr));
+      key->proto = ipv4->proto;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      memcpy(key->srcipaddr, ipv6->srcipaddr, sizeof(ipv6->srcipaddr));
+      memcpy(key->destipaddr, ipv6->destipaddr, sizeof(ipv6->destipaddr));
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_hashkey
+ *
+ * Description:
+ *   Fold the identification of a datagram into the reassembly hashtable
+ *   key.
+ *
+ ****************************************************************************/
+
+static uint32_t ip_fragin_hashkey(FAR const struct ip_fragkey_s *key)
+{
+  uint32_t hash = key->ipid ^ ((uint32_t)key->proto << 24);
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = hash * 31 + key->srcipaddr[i];
+      hash = hash * 31 + key->destipaddr[i];
+    }
+
+  return hash;
+}
+
 /****************************************************************************
  * Name: ip_fragout_allocfragbuf
  *
@@ -529,9 +621,10 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
 {
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
+  g_nodeoccupy--;
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-  sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+  hashtable_delete(g_assemblyhash, &node->hnode, node->hash);
+  sq_rem(&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
 }
@@ -542,8 +635,9 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are
+ *   found through a hashtable keyed by the source and destination
+ *   addresses, the IP ID and the protocol of the datagram.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -551,42 +645,43 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   Whether queue is empty before enqueue the new node.  If no node could
+ *   be allocated for the fragment, curfraglink->fragsnode is NULL and the
+ *   fragment is left to the caller.
  *
  ****************************************************************************/
 
 bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
                        FAR struct ip_fraglink_s *curfraglink)
 {
-  FAR struct ip_fragsnode_s *node;
-  FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  FAR struct ip_fragsnode_s *node = NULL;
+  FAR hash_node_t           *entry;
+  struct ip_fragkey_s        key;
+  uint32_t                   hash;
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  /* Look up the node of the datagram in the hashtable, otherwise need to
+   * create a new node and add it to the hashtable.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  empty = sq_peek(&g_assemblyhead_time) == NULL;
 
-  while (entry != NULL)
+  ip_fragin_getkey(curfraglink, &key);
+  hash = ip_fragin_hashkey(&key);
+
+  hashtable_for_every_possible(g_assemblyhash, entry, hash)
     {
-      node = (struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *curr =
+        container_of(entry, struct ip_fragsnode_s, hnode);
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (curr->dev == dev && memcmp(&curr->key, &key, sizeof(key)) == 0)
         {
+          node = curr;
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
       FAR struct ip_fraglink_s *fraglink;
       FAR struct ip_fraglink_s *lastlink = NULL;
@@ -682,39 +777,27 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       if (node == NULL)
         {
           nerr("ERROR: Failed to allocate buffer.\n");
-          return -ENOMEM;
+          curfraglink->fragsnode = NULL;
+          return empty;
         }
 
-      node->flink      = NULL;
-      node->flinkat    = NULL;
       node->dev        = dev;
-      node->ipid       = curfraglink->ipid;
+      node->key        = key;
+      node->hash       = hash;
       node->frags      = curfraglink;
       node->tick       = clock_systime_ticks();
       node->bufcnt     = IOBUF_CNT(curfraglink->frag);
       g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
       node->verifyflag = 0;
       node->outgoframe = NULL;
+      g_nodeoccupy++;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
-
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
-
-      /* Add this new node to the tail of linked list identified by
-       * g_assemblyhead_time
+      /* Add this new node to the hashtable and to the tail of linked list
+       * identified by g_assemblyhead_time
        */
 
-      sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+      hashtable_add(g_assemblyhash, &node->hnode, hash);
+      sq_addlast(&node->flinkat, &g_assemblyhead_time);
     }
 
   if (curfraglink->fragoff == 0)
@@ -1117,13 +1200,14 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
@@ -1139,7 +1223,7 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
             }
 
           ip_frag_remnode(node);
-          kmm_free(entry);
+          kmm_free(node);
         }
 
       entry = entrynext;
@@ -1172,13 +1256,14 @@ void ip_frag_remallfrags(void)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (node->frags != NULL)
@@ -1191,19 +1276,19 @@ void ip_frag_remallfrags(void)
             }
         }
 
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
+      /* The hashtable and g_assemblyhead_time are reset after this loop
+       * ends, so the node need not be removed from them one by one.
        */
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      kmm_free(node);
 
       entry = entrynext;
     }
 
+  hashtable_init(g_assemblyhash);
   sq_init(&g_assemblyhead_time);
-  g_bufoccupy = 0;
+  g_bufoccupy  = 0;
+  g_nodeoccupy = 0;
 
   nxmutex_unlock(&g_ipfrag_lock);
 
@@ -1223,6 +1308,30 @@ void ip_frag_remallfrags(void)
   net_unlock();
 }
 
+/****************************************************************************
+ * Name: ip_frag_getusage
+ *
+ * Description:
+ *   Get the number of datagrams and of I/O buffers currently held by the
+ *   fragment reassembly cache.
+ *
+ * Input Parameters:
+ *   nodes - The location to return the number of datagrams
+ *   iobs  - The location to return the number of I/O buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ip_frag_getusage(FAR uint32_t *nodes, FAR uint32_t *iobs)
+{
+  nxmutex_lock(&g_ipfrag_lock);
+  *nodes = g_nodeoccupy;
+  *iobs  = g_bufoccupy;
+  nxmutex_unlock(&g_ipfrag_lock);
+}
+
 /****************************************************************************
  * Name: ip_fragout
  *
@@ -1264,6 +1373,21 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return OK;
     }
 
+#ifdef CONFIG_NETDEV_GSO
+  /* The device cuts TCP offload packets into segments itself */
+
+  if (dev->d_gso_size > 0)
+    {
+      return OK;
+    }
+#endif
+
+  /* Only the first fragment holds the checksum field the device would
+   * patch, so finish the checksum over the whole packet first.
+   */
+
+  netdev_chksum_complete(dev);
+
   ninfo("pkt size: %d, MTU: %d\n", dev->d_iob->io_pktlen, mtu);
 
 #ifdef CONFIG_NET_IPv4
@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <assert.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/mutex.h>
 #include <nuttx/queue.h>
 #include <nuttx/mm/iob.h>
@@ -92,29 +93,41 @@ struct ip_fraglink_s
   uint32_t                   ipid;
 };
 
+/* The fragments of one IP datagram are identified by the source and the
+ * destination addresses, the IP ID and, for IPv4, the protocol (RFC 791,
+ * RFC 8200).  The IPv4 addresses use the first words of the address
+ * fields.  Unused fields are zero so that keys compare with memcmp().
+ */
+
+struct ip_fragkey_s
+{
+  uint32_t                   ipid;           /* IP Identification */
+  uint16_t                   srcipaddr[8];   /* Source address */
+  uint16_t                   destipaddr[8];  /* Destination address */
+  uint8_t                    proto;          /* IPv4 protocol, 0 for IPv6 */
+  uint8_t                    isipv4;         /* IPv4 or IPv6 */
+};
+
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
-   */
+  /* This link is used to find the node in the reassembly hashtable */
 
-  FAR struct ip_fragsnode_s *flink;
+  hash_node_t                hnode;
 
   /* Another link which connects all ip_fragsnode_s in order of addition
    * time
    */
 
-  FAR sq_entry_t            *flinkat;
+  sq_entry_t                 flinkat;
 
   /* Interface understood by the network */
 
   FAR struct net_driver_s   *dev;
 
-  /* IP Identification (IP ID) field defined in ipv4 header or in ipv6
-   * fragment header.
-   */
+  /* The identification of the datagram and its hash value */
 
-  uint32_t                   ipid;
+  struct ip_fragkey_s        key;
+  uint32_t                   hash;
 
   /* Count ticks, used by ressembly timer */
 
@@ -149,8 +162,8 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time
+/* Only one thread can access the reassembly hashtable and
+ * g_assemblyhead_time at a time
  */
 
 extern mutex_t g_ipfrag_lock;
@@ -182,8 +195,9 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are
+ *   found through a hashtable keyed by the source and destination
+ *   addresses, the IP ID and the protocol of the datagram.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -191,7 +205,9 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   Whether queue is empty before enqueue the new node.  If no node could
+ *   be allocated for the fragment, curfraglink->fragsnode is NULL and the
+ *   fragment is left to the caller.
  *
  ****************************************************************************/
 
@@ -366,6 +382,24 @@ void ip_frag_stop(FAR struct net_driver_s *dev);
 
 void ip_frag_remallfrags(void);
 
+/****************************************************************************
+ * Name: ip_frag_getusage
+ *
+ * Description:
+ *   Get the number of datagrams and of I/O buffers currently held by the
+ *   fragment reassembly cache.
+ *
+ * Input Parameters:
+ *   nodes - The location to return the number of datagrams
+ *   iobs  - The location to return the number of I/O buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ip_frag_getusage(FAR uint32_t *nodes, FAR uint32_t *iobs);
+
 /****************************************************************************
  * Name: ip_fragout
  *
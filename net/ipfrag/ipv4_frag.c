@@ -287,6 +287,15 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
   restartwdog = ip_fragin_enqueue(dev, fraginfo);
 
   node = fraginfo->fragsnode;
+  if (node == NULL)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.nomem++;
+#endif
+      return -ENOMEM;
+    }
 
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
     {
@@ -315,6 +324,10 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
       kmm_free(node);
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.reassembled++;
+#endif
+
       return ipv4_input(dev);
     }
 
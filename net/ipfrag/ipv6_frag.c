@@ -494,6 +494,16 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
   restartwdog = ip_fragin_enqueue(dev, fraginfo);
 
   node = fraginfo->fragsnode;
+  if (node == NULL)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.nomem++;
+#endif
+      return -ENOMEM;
+    }
+
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
     {
       /* Well, all fragments of an IP frame have been received, remove
@@ -521,6 +531,10 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
       kmm_free(node);
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.reassembled++;
+#endif
+
       return ipv6_input(dev);
     }
 
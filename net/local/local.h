@@ -37,6 +37,7 @@
 #include <poll.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/queue.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mutex.h>
@@ -49,7 +50,9 @@
  ****************************************************************************/
 
 #define LOCAL_NPOLLWAITERS 2
-#define LOCAL_NCONTROLFDS  4
+#ifdef CONFIG_NET_LOCAL_SCM
+#  define LOCAL_NCONTROLFDS CONFIG_NET_LOCAL_SCM_MAXFDS
+#endif
 
 #if CONFIG_DEV_PIPE_MAXSIZE > 65535
 typedef uint32_t lc_size_t;  /* 32-bit index */
@@ -156,6 +159,14 @@ struct local_conn_s
   FAR struct pollfd *lc_event_fds[LOCAL_NPOLLWAITERS];
   struct pollfd lc_inout_fds[2*LOCAL_NPOLLWAITERS];
 
+#ifdef CONFIG_NET_LOCAL_IOB
+  /* Data sent by the peer, waiting to be received */
+
+  FAR struct iob_s *lc_rxq;    /* Received data, NULL if none */
+  sem_t lc_rxsem;              /* Wait for data in lc_rxq */
+  sem_t lc_txsem;              /* Wait for room in the peer's lc_rxq */
+#endif
+
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
    */
@@ -679,6 +690,73 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
 void local_event_pollnotify(FAR struct local_conn_s *conn,
                             pollevent_t eventset);
 
+/****************************************************************************
+ * Name: local_iob_send
+ *
+ * Description:
+ *   Queue stream data on the receive queue of the peer connection.
+ *
+ * Input Parameters:
+ *   conn     - A connected SOCK_STREAM connection
+ *   buf      - Data to send
+ *   len      - Number of entries in buf
+ *   nonblock - Return -EAGAIN rather than wait for room at the peer
+ *
+ * Returned Value:
+ *   The number of bytes queued; a negated errno value if nothing could be
+ *   queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_IOB
+ssize_t local_iob_send(FAR struct local_conn_s *conn,
+                       FAR const struct iovec *buf, size_t len,
+                       bool nonblock);
+
+/****************************************************************************
+ * Name: local_iob_recv
+ *
+ * Description:
+ *   Take stream data queued by the peer connection.
+ *
+ * Input Parameters:
+ *   conn  - A connected SOCK_STREAM connection
+ *   buf   - Buffer to receive data
+ *   len   - Length of buffer
+ *   flags - MSG_PEEK and MSG_DONTWAIT are honoured
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at end of file, or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t local_iob_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                       size_t len, int flags);
+
+/****************************************************************************
+ * Name: local_iob_pollstate
+ *
+ * Description:
+ *   Return the poll events currently true for a connected stream.
+ *
+ ****************************************************************************/
+
+pollevent_t local_iob_pollstate(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_iob_notify
+ *
+ * Description:
+ *   Wake up senders, receivers and pollers of the connection after its
+ *   receive queue, the peer's receive queue or the connection state
+ *   changed.
+ *
+ ****************************************************************************/
+
+void local_iob_notify(FAR struct local_conn_s *conn);
+#endif /* CONFIG_NET_LOCAL_IOB */
+
 /****************************************************************************
  * Name: local_pollsetup
  *
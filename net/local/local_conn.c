@@ -161,6 +161,10 @@ FAR struct local_conn_s *local_alloc(void)
 #ifdef CONFIG_NET_LOCAL_STREAM
       nxsem_init(&conn->lc_waitsem, 0, 0);
 #endif
+#ifdef CONFIG_NET_LOCAL_IOB
+      nxsem_init(&conn->lc_rxsem, 0, 0);
+      nxsem_init(&conn->lc_txsem, 0, 0);
+#endif
 
       /* This semaphore is used for sending safely in multithread.
        * Make sure data will not be garbled when multi-thread sends.
@@ -302,10 +306,31 @@ void local_free(FAR struct local_conn_s *conn)
 
   if (conn->lc_peer)
     {
+#ifdef CONFIG_NET_LOCAL_IOB
+      FAR struct local_conn_s *peer = conn->lc_peer;
+
+      peer->lc_peer = NULL;
+      conn->lc_peer = NULL;
+
+      /* Wake up the peer, it now sees end of file or EPIPE */
+
+      local_iob_notify(peer);
+#else
       conn->lc_peer->lc_peer = NULL;
       conn->lc_peer = NULL;
+#endif
     }
 
+#ifdef CONFIG_NET_LOCAL_IOB
+  /* Drop the data that was never received */
+
+  if (conn->lc_rxq != NULL)
+    {
+      iob_free_chain(conn->lc_rxq);
+      conn->lc_rxq = NULL;
+    }
+#endif
+
   /* Make sure that the read-only FIFO is closed */
 
   if (conn->lc_infile.f_inode != NULL)
@@ -342,6 +367,10 @@ void local_free(FAR struct local_conn_s *conn)
 #ifdef CONFIG_NET_LOCAL_STREAM
   nxsem_destroy(&conn->lc_waitsem);
 #endif
+#ifdef CONFIG_NET_LOCAL_IOB
+  nxsem_destroy(&conn->lc_rxsem);
+  nxsem_destroy(&conn->lc_txsem);
+#endif
 
   /* Destory sem associated with the connection */
 
@@ -0,0 +1,382 @@
+/****************************************************************************
+ * net/local/local_iob.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+#include <poll.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/semaphore.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_IOB
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_iob_queued
+ *
+ * Description:
+ *   Return the number of bytes waiting in the receive queue of 'conn'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static inline size_t local_iob_queued(FAR struct local_conn_s *conn)
+{
+  return conn->lc_rxq != NULL ? conn->lc_rxq->io_pktlen : 0;
+}
+
+/****************************************************************************
+ * Name: local_iob_post
+ *
+ * Description:
+ *   Wake up the waiter of 'sem', if any.  Waiters re-check their condition
+ *   so the count is never raised above one.
+ *
+ ****************************************************************************/
+
+static void local_iob_post(FAR sem_t *sem)
+{
+  int sval;
+
+  if (nxsem_get_value(sem, &sval) >= 0 && sval < 1)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_iob_sendchunk
+ *
+ * Description:
+ *   Queue at most 'len' bytes of 'src' on the peer, waiting for room in
+ *   its receive queue first unless 'nonblock'.
+ *
+ * Returned Value:
+ *   The number of bytes queued or a negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t local_iob_sendchunk(FAR struct local_conn_s *conn,
+                                   FAR const uint8_t *src, size_t len,
+                                   bool nonblock)
+{
+  FAR struct local_conn_s *peer;
+  FAR struct iob_s *iob;
+  size_t queued;
+  int ret;
+
+  net_lock();
+
+  for (; ; )
+    {
+      /* The FIFO would report EPIPE once the reader is gone */
+
+      peer = conn->lc_peer;
+      if (peer == NULL || peer->lc_infile.f_inode == NULL)
+        {
+          ret = -EPIPE;
+          goto errout_with_lock;
+        }
+
+      queued = local_iob_queued(peer);
+      if (queued < peer->lc_rcvsize)
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout_with_lock;
+        }
+
+      ret = net_sem_wait(&conn->lc_txsem);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  len = MIN(len, peer->lc_rcvsize - queued);
+  net_unlock();
+
+  /* Build the chain without holding the network lock, the allocation may
+   * have to wait for free IOBs.
+   */
+
+  iob = nonblock ? iob_tryalloc(true) : iob_alloc(true);
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  ret = nonblock ? iob_trycopyin(iob, src, len, 0, true) :
+                   iob_copyin(iob, src, len, 0, true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return nonblock ? -EAGAIN : ret;
+    }
+
+  net_lock();
+
+  /* The peer may have been closed while the lock was released */
+
+  peer = conn->lc_peer;
+  if (peer == NULL || peer->lc_infile.f_inode == NULL)
+    {
+      net_unlock();
+      iob_free_chain(iob);
+      return -EPIPE;
+    }
+
+  if (peer->lc_rxq == NULL)
+    {
+      peer->lc_rxq = iob;
+    }
+  else
+    {
+      iob_concat(peer->lc_rxq, iob);
+    }
+
+  local_iob_notify(peer);
+  net_unlock();
+  return len;
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_iob_send
+ *
+ * Description:
+ *   Queue stream data on the receive queue of the peer connection.
+ *
+ * Input Parameters:
+ *   conn     - A connected SOCK_STREAM connection
+ *   buf      - Data to send
+ *   len      - Number of entries in buf
+ *   nonblock - Return -EAGAIN rather than wait for room at the peer
+ *
+ * Returned Value:
+ *   The number of bytes queued; a negated errno value if nothing could be
+ *   queued.
+ *
+ * Assumptions:
+ *   The caller holds lc_sendlock.
+ *
+ ****************************************************************************/
+
+ssize_t local_iob_send(FAR struct local_conn_s *conn,
+                       FAR const struct iovec *buf, size_t len,
+                       bool nonblock)
+{
+  FAR const struct iovec *end = buf + len;
+  FAR const struct iovec *iov;
+  ssize_t sent = 0;
+  ssize_t ret = 0;
+
+  nonblock |= (conn->lc_outfile.f_oflags & O_NONBLOCK) != 0;
+
+  for (iov = buf; iov != end; iov++)
+    {
+      FAR const uint8_t *src = iov->iov_base;
+      size_t remaining = iov->iov_len;
+
+      while (remaining > 0)
+        {
+          ret = local_iob_sendchunk(conn, src, remaining, nonblock);
+          if (ret < 0)
+            {
+              return sent > 0 ? sent : ret;
+            }
+
+          src       += ret;
+          remaining -= ret;
+          sent      += ret;
+        }
+    }
+
+  return sent;
+}
+
+/****************************************************************************
+ * Name: local_iob_recv
+ *
+ * Description:
+ *   Take stream data queued by the peer connection.
+ *
+ * Input Parameters:
+ *   conn  - A connected SOCK_STREAM connection
+ *   buf   - Buffer to receive data
+ *   len   - Length of buffer
+ *   flags - MSG_PEEK and MSG_DONTWAIT are honoured
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at end of file, or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t local_iob_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                       size_t len, int flags)
+{
+  FAR struct local_conn_s *peer;
+  bool nonblock;
+  int ret;
+
+  nonblock = _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+             (flags & MSG_DONTWAIT) != 0 ||
+             (conn->lc_infile.f_oflags & O_NONBLOCK) != 0;
+
+  net_lock();
+
+  while (conn->lc_rxq == NULL)
+    {
+      /* End of file once the peer is closed or has shut down writing */
+
+      peer = conn->lc_peer;
+      if (peer == NULL || peer->lc_outfile.f_inode == NULL ||
+          conn->lc_infile.f_inode == NULL)
+        {
+          ret = 0;
+          goto out;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      ret = net_sem_wait(&conn->lc_rxsem);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  ret = iob_copyout(buf, conn->lc_rxq, len, 0);
+  if (ret > 0 && (flags & MSG_PEEK) == 0)
+    {
+      conn->lc_rxq = iob_trimhead(conn->lc_rxq, ret);
+      if (conn->lc_rxq->io_pktlen == 0)
+        {
+          iob_free_chain(conn->lc_rxq);
+          conn->lc_rxq = NULL;
+        }
+
+      /* There is room again, tell the sending side */
+
+      if (conn->lc_peer != NULL)
+        {
+          local_iob_notify(conn->lc_peer);
+        }
+    }
+
+out:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_iob_pollstate
+ *
+ * Description:
+ *   Return the poll events currently true for a connected stream.
+ *
+ ****************************************************************************/
+
+pollevent_t local_iob_pollstate(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer;
+  pollevent_t eventset = 0;
+
+  net_lock();
+
+  peer = conn->lc_peer;
+  if (conn->lc_rxq != NULL)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (peer == NULL || peer->lc_outfile.f_inode == NULL)
+    {
+      eventset |= POLLIN | POLLHUP;
+    }
+
+  if (peer != NULL &&
+      (peer->lc_infile.f_inode == NULL ||
+       local_iob_queued(peer) < peer->lc_rcvsize))
+    {
+      eventset |= POLLOUT;
+    }
+
+  net_unlock();
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: local_iob_notify
+ *
+ * Description:
+ *   Wake up senders, receivers and pollers of the connection after its
+ *   receive queue, the peer's receive queue or the connection state
+ *   changed.
+ *
+ ****************************************************************************/
+
+void local_iob_notify(FAR struct local_conn_s *conn)
+{
+  local_iob_post(&conn->lc_rxsem);
+  local_iob_post(&conn->lc_txsem);
+  local_event_pollnotify(conn, local_iob_pollstate(conn));
+}
+
+#endif /* CONFIG_NET_LOCAL_IOB */
@@ -170,6 +170,23 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_event_pollsetup(conn, fds, true);
     }
 
+#ifdef CONFIG_NET_LOCAL_IOB
+  /* The data does not pass through the FIFOs, report the state of the
+   * receive queues instead.
+   */
+
+  if (conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      ret = local_event_pollsetup(conn, fds, true);
+      if (ret >= 0)
+        {
+          poll_notify(&fds, 1, local_iob_pollstate(conn));
+        }
+
+      return ret;
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       fds->priv = NULL;
@@ -319,6 +336,13 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_event_pollsetup(conn, fds, false);
     }
 
+#ifdef CONFIG_NET_LOCAL_IOB
+  if (conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_event_pollsetup(conn, fds, false);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       return OK;
@@ -57,6 +57,7 @@
  *
  ****************************************************************************/
 
+#if !defined(CONFIG_NET_LOCAL_IOB) || defined(CONFIG_NET_LOCAL_DGRAM)
 static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
                            size_t offset, FAR size_t *readlen,
                            int flags, bool once)
@@ -123,6 +124,7 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
 
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: local_recvctl
@@ -192,7 +194,7 @@ static void local_recvctl(FAR struct local_conn_s *conn,
     {
       if (peer->lc_cfpcount)
         {
-          memmove(peer->lc_cfps[0], peer->lc_cfps[i],
+          memmove(&peer->lc_cfps[0], &peer->lc_cfps[i],
                   sizeof(FAR void *) * peer->lc_cfpcount);
         }
     }
@@ -249,6 +251,17 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return 0;
     }
 
+#ifdef CONFIG_NET_LOCAL_IOB
+  /* The peer queues the data on the connection itself */
+
+  ret = local_iob_recv(conn, buf, len, flags);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  readlen = ret;
+#else
   /* If it is non-blocking mode, the data in fifo is 0 and
    * returns directly
    */
@@ -275,6 +288,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     {
       return ret;
     }
+#endif
 
   /* Return the address family */
 
@@ -44,24 +44,31 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: local_sendctl
+ * Name: local_ctlpeer
  *
  * Description:
- *   Handle the socket message conntrol field
+ *   Return the connection whose lc_cfps receive the descriptors sent on
+ *   'conn': the peer of a connected socket, the socket itself otherwise.
  *
- * Input Parameters:
- *   conn     Local connection instance
- *   msg      Message to send
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+static FAR struct local_conn_s *local_ctlpeer(FAR struct local_conn_s *conn)
+{
+  return conn->lc_peer != NULL ? conn->lc_peer : conn;
+}
+
+/****************************************************************************
+ * Name: local_freectl
  *
- * Returned Value:
- *  On any failure, a negated errno value is returned
+ * Description:
+ *   Undo the last 'count' descriptors queued by local_sendctl().
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_SCM
 static void local_freectl(FAR struct local_conn_s *conn, int count)
 {
-  FAR struct local_conn_s *peer = conn->lc_peer;
+  FAR struct local_conn_s *peer = local_ctlpeer(conn);
 
   while (count-- > 0)
     {
@@ -71,6 +78,24 @@ static void local_freectl(FAR struct local_conn_s *conn, int count)
     }
 }
 
+/****************************************************************************
+ * Name: local_sendctl
+ *
+ * Description:
+ *   Handle the socket message conntrol field.  The descriptors of all
+ *   SCM_RIGHTS messages are queued as one batch: either all of them are
+ *   passed or none is.
+ *
+ * Input Parameters:
+ *   conn     Local connection instance
+ *   msg      Message to send
+ *
+ * Returned Value:
+ *  The number of descriptors queued.  On any failure, a negated errno
+ *  value is returned
+ *
+ ****************************************************************************/
+
 static int local_sendctl(FAR struct local_conn_s *conn,
                          FAR struct msghdr *msg)
 {
@@ -78,17 +103,16 @@ static int local_sendctl(FAR struct local_conn_s *conn,
   FAR struct file *filep2;
   FAR struct file *filep;
   FAR struct cmsghdr *cmsg;
-  int count = 0;
+  int total = 0;
+  int count;
   FAR int *fds;
   int ret;
-  int i = 0;
+  int i;
 
   net_lock();
-  peer = conn->lc_peer;
-  if (peer == NULL)
-    {
-      peer = conn;
-    }
+  peer = local_ctlpeer(conn);
+
+  /* Validate the whole batch before taking any reference */
 
   for_each_cmsghdr(cmsg, msg)
     {
@@ -96,19 +120,25 @@ static int local_sendctl(FAR struct local_conn_s *conn,
           cmsg->cmsg_level != SOL_SOCKET ||
           cmsg->cmsg_type != SCM_RIGHTS)
         {
-          ret = -EOPNOTSUPP;
-          goto fail;
+          net_unlock();
+          return -EOPNOTSUPP;
         }
 
+      total += (cmsg->cmsg_len - sizeof(struct cmsghdr)) / sizeof(int);
+    }
+
+  if (total + peer->lc_cfpcount > LOCAL_NCONTROLFDS)
+    {
+      net_unlock();
+      return -EMFILE;
+    }
+
+  total = 0;
+  for_each_cmsghdr(cmsg, msg)
+    {
       fds = (FAR int *)CMSG_DATA(cmsg);
       count = (cmsg->cmsg_len - sizeof(struct cmsghdr)) / sizeof(int);
 
-      if (count + peer->lc_cfpcount >= LOCAL_NCONTROLFDS)
-        {
-          ret = -EMFILE;
-          goto fail;
-        }
-
       for (i = 0; i < count; i++)
         {
           ret = fs_getfilep(fds[i], &filep);
@@ -134,14 +164,15 @@ static int local_sendctl(FAR struct local_conn_s *conn,
             }
 
           peer->lc_cfps[peer->lc_cfpcount++] = filep2;
+          total++;
         }
     }
 
   net_unlock();
-  return count;
+  return total;
 
 fail:
-  local_freectl(conn, i);
+  local_freectl(conn, total);
   net_unlock();
   return ret;
 }
@@ -214,7 +245,19 @@ static ssize_t local_send(FAR struct socket *psock,
               return ret;
             }
 
-          ret = local_send_packet(&conn->lc_outfile, buf, len);
+#ifdef CONFIG_NET_LOCAL_IOB
+          if (psock->s_type == SOCK_STREAM)
+            {
+              ret = local_iob_send(conn, buf, len,
+                                   _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                                   (flags & MSG_DONTWAIT) != 0);
+            }
+          else
+#endif
+            {
+              ret = local_send_packet(&conn->lc_outfile, buf, len);
+            }
+
           nxmutex_unlock(&conn->lc_sendlock);
         }
         break;
@@ -436,6 +479,7 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   FAR const struct iovec *buf = msg->msg_iov;
   socklen_t tolen = msg->msg_namelen;
   size_t len = msg->msg_iovlen;
+  ssize_t ret;
 
   /* Check shutdown state */
 
@@ -457,19 +501,23 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
         }
     }
 
-  len = to ? local_sendto(psock, buf, len, flags, to, tolen) :
+  ret = to ? local_sendto(psock, buf, len, flags, to, tolen) :
              local_send(psock, buf, len, flags);
 
-  if (len < 0 && count > 0)
+  /* The descriptors travel with the data, take them back if it was not
+   * sent.
+   */
+
+  if (ret < 0 && count > 0)
     {
       net_lock();
       local_freectl(conn, count);
       net_unlock();
     }
 #else
-  len = to ? local_sendto(psock, buf, len, flags, to, tolen) :
+  ret = to ? local_sendto(psock, buf, len, flags, to, tolen) :
              local_send(psock, buf, len, flags);
 #endif
 
-  return len;
+  return ret;
 }
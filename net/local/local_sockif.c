@@ -962,6 +962,17 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
           }
         break;
       case FIONREAD:
+#ifdef CONFIG_NET_LOCAL_IOB
+        if (conn->lc_proto == SOCK_STREAM &&
+            conn->lc_state == LOCAL_STATE_CONNECTED)
+          {
+            net_lock();
+            *(FAR int *)((uintptr_t)arg) =
+              conn->lc_rxq != NULL ? conn->lc_rxq->io_pktlen : 0;
+            net_unlock();
+          }
+        else
+#endif
         if (conn->lc_infile.f_inode != NULL)
           {
             ret = file_ioctl(&conn->lc_infile, cmd, arg);
@@ -1099,6 +1110,16 @@ static int local_socketpair(FAR struct socket *psocks[2])
   conns[0]->lc_state = conns[1]->lc_state
                      = LOCAL_STATE_CONNECTED;
 
+#ifdef CONFIG_NET_LOCAL_IOB
+  /* Stream data is queued directly on the other end of the pair */
+
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      conns[0]->lc_peer = conns[1];
+      conns[1]->lc_peer = conns[0];
+    }
+#endif
+
 #ifdef CONFIG_NET_LOCAL_DGRAM
   if (psocks[0]->s_type == SOCK_DGRAM)
     {
@@ -1168,6 +1189,19 @@ static int local_shutdown(FAR struct socket *psock, int how)
                   conn->lc_outfile.f_inode = NULL;
                 }
             }
+
+#ifdef CONFIG_NET_LOCAL_IOB
+          /* Let both sides re-evaluate end of file and EPIPE */
+
+          net_lock();
+          local_iob_notify(conn);
+          if (conn->lc_peer != NULL)
+            {
+              local_iob_notify(conn->lc_peer);
+            }
+
+          net_unlock();
+#endif
         }
 
         return OK;
@@ -31,6 +31,7 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/list.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -38,6 +39,38 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Hash on the interface identifier, the part that differs between the
+ * neighbors of one link.
+ */
+
+#define NEIGHBOR_HASH(ipaddr) \
+  (((ipaddr)[4] ^ (ipaddr)[5] ^ (ipaddr)[6] ^ (ipaddr)[7]) % \
+   CONFIG_NET_IPv6_NCONF_HASHSIZE)
+
+/* Convert between a Neighbor Table entry and its bookkeeping node */
+
+#define NEIGHBOR_ENTRY(node)     (&g_neighbors[(node) - g_neighbor_nodes])
+#define NEIGHBOR_NODE(neighbor)  (&g_neighbor_nodes[(neighbor) - g_neighbors])
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The lookup structures of one Neighbor Table entry.  They are kept apart
+ * from struct neighbor_entry_s since the entries are copied as is to
+ * netlink.
+ */
+
+struct neighbor_node_s
+{
+  FAR struct neighbor_node_s *nn_hnext; /* Next entry in the hash bucket */
+  struct list_node            nn_lru;   /* Most recently used first */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -48,6 +81,18 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The lookup structures of the table entries: the hash buckets of the
+ * entries in use, the entries in least recently used order and the number
+ * of entries that were never used.
+ */
+
+extern struct neighbor_node_s
+  g_neighbor_nodes[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern FAR struct neighbor_node_s *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+extern struct list_node g_neighbor_lru;
+extern unsigned int g_neighbor_free;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
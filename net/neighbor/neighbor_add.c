@@ -41,6 +41,38 @@
 #include "netlink/netlink.h"
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_unhash
+ *
+ * Description:
+ *   Remove an entry from the chain of its hash bucket.
+ *
+ ****************************************************************************/
+
+static void neighbor_unhash(FAR struct neighbor_node_s *node)
+{
+  FAR struct neighbor_entry_s *neighbor = NEIGHBOR_ENTRY(node);
+  FAR struct neighbor_node_s **prev;
+
+  prev = &g_neighbor_hash[NEIGHBOR_HASH(neighbor->ne_ipaddr)];
+  while (*prev != NULL)
+    {
+      if (*prev == node)
+        {
+          *prev = node->nn_hnext;
+          break;
+        }
+
+      prev = &(*prev)->nn_hnext;
+    }
+
+  node->nn_hnext = NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,78 +97,89 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor = NULL;
+  FAR struct neighbor_node_s *node;
+  FAR struct neighbor_node_s **head;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
   bool    found = false;
   bool    new_entry;
-  int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+  /* Find the matching entry, else a never used entry, else the least
+   * recently used one.
    */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
+  head   = &g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (node = *head; node != NULL; node = node->nn_hnext)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      neighbor = NEIGHBOR_ENTRY(node);
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           found = true;
           break;
         }
+    }
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+  if (!found)
+    {
+      if (g_neighbor_free > 0)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          node = &g_neighbor_nodes[--g_neighbor_free];
+          list_add_tail(&g_neighbor_lru, &node->nn_lru);
+        }
+      else
+        {
+          node = list_last_entry(&g_neighbor_lru, struct neighbor_node_s,
+                                 nn_lru);
         }
-    }
 
-  /* When overwite old entry, need to notify RTM_DELNEIGH */
+      neighbor = NEIGHBOR_ENTRY(node);
 
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
-    {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
-                           AF_INET6);
+      /* When overwite old entry, need to notify RTM_DELNEIGH */
+
+      if (neighbor->ne_time != 0)
+        {
+          netlink_neigh_notify(neighbor, RTM_DELNEIGH, AF_INET6);
+          neighbor_unhash(node);
+        }
+
+      node->nn_hnext = *head;
+      *head = node;
     }
 
   /* Need to notify when entry is not found or changes in table */
 
-  new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-                             g_neighbors[oldest_ndx].ne_addr.na_llsize) != 0;
+  new_entry = !found || memcmp(&neighbor->ne_addr.u, addr,
+                               neighbor->ne_addr.na_llsize) != 0;
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  /* Fill in the matching entry or the one that was taken over */
+
+  neighbor->ne_dev  = dev;
+  neighbor->ne_time = clock_systime_ticks();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  g_neighbors[oldest_ndx].ne_dev  = dev;
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  /* It is now the most recently used entry */
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  list_delete(&node->nn_lru);
+  list_add_head(&g_neighbor_lru, &node->nn_lru);
 
   /* Notify the new entry */
 
   if (new_entry)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_NEWNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_NEWNEIGH, AF_INET6);
     }
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -53,11 +53,12 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_node_s *node;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (node = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)]; node != NULL;
+       node = node->nn_hnext)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = NEIGHBOR_ENTRY(node);
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
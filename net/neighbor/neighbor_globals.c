@@ -38,6 +38,13 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The lookup structures of the Neighbor table */
+
+struct neighbor_node_s g_neighbor_nodes[CONFIG_NET_IPv6_NCONF_ENTRIES];
+FAR struct neighbor_node_s *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+struct list_node g_neighbor_lru = LIST_INITIAL_VALUE(g_neighbor_lru);
+unsigned int g_neighbor_free = CONFIG_NET_IPv6_NCONF_ENTRIES;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -55,6 +55,11 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+      FAR struct neighbor_node_s *node = NEIGHBOR_NODE(neighbor);
+
       neighbor->ne_time = clock_systime_ticks();
+
+      list_delete(&node->nn_lru);
+      list_add_head(&g_neighbor_lru, &node->nn_lru);
     }
 }
@@ -533,6 +533,60 @@ void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
                            FAR const void *dst_addr, uint16_t dst_port);
 #endif
 
+/****************************************************************************
+ * Name: netdev_chksum_offload
+ *
+ * Description:
+ *   Leave the TCP/UDP checksum of the outgoing packet in d_iob to the
+ *   device if it supports that: the pseudo-header sum is stored in the
+ *   checksum field and the packet is marked NETDEV_CHKSUM_PARTIAL.
+ *
+ * Input Parameters:
+ *   dev    - The device the packet is sent on
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *   chksum - The checksum field in the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the device will finish the checksum; false if the caller must
+ *   compute it.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+bool netdev_chksum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                           FAR uint16_t *chksum);
+#else
+#  define netdev_chksum_offload(dev,proto,chksum) false
+#endif
+
+/****************************************************************************
+ * Name: netdev_busypoll
+ *
+ * Description:
+ *   Implement SO_BUSY_POLL for a receive that is about to block on 'sem':
+ *   poll the device for new packets, in the caller's context, until 'sem'
+ *   is posted or the socket's busy-poll time has passed.
+ *
+ * Input Parameters:
+ *   dev   - The device to poll, or NULL to poll every device
+ *   sconn - The socket connection, giving the busy-poll time
+ *   sem   - The semaphore the receive is about to wait on
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+void netdev_busypoll(FAR struct net_driver_s *dev,
+                     FAR struct socket_conn_s *sconn, FAR sem_t *sem);
+#else
+#  define netdev_busypoll(dev,sconn,sem)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * net/netdev/netdev_busypoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NET_BUSY_POLL
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_busypoll_callback
+ *
+ * Description:
+ *   Run one receive poll of 'dev'.  'arg' counts the devices polled.
+ *
+ ****************************************************************************/
+
+static int netdev_busypoll_callback(FAR struct net_driver_s *dev,
+                                    FAR void *arg)
+{
+  FAR unsigned int *npolled = arg;
+
+  if (dev->d_busypoll != NULL && IFF_IS_UP(dev->d_flags))
+    {
+      dev->d_busypoll(dev);
+      (*npolled)++;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_busypoll
+ *
+ * Description:
+ *   Implement SO_BUSY_POLL for a receive that is about to block on 'sem':
+ *   poll the device for new packets, in the caller's context, until 'sem'
+ *   is posted or the socket's busy-poll time has passed.
+ *
+ *   The packets go through the same input path as from the network work
+ *   thread, so the receive callback posts 'sem' as usual and the wait that
+ *   follows returns at once.  The performance counter is used for the time
+ *   limit since busy-poll times are much shorter than a system tick.
+ *
+ * Input Parameters:
+ *   dev   - The device to poll, or NULL to poll every device
+ *   sconn - The socket connection, giving the busy-poll time
+ *   sem   - The semaphore the receive is about to wait on
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_busypoll(FAR struct net_driver_s *dev,
+                     FAR struct socket_conn_s *sconn, FAR sem_t *sem)
+{
+  unsigned int npolled;
+  clock_t start;
+  clock_t limit;
+  int semcount;
+
+  if (sconn->s_busypoll == 0)
+    {
+      return;
+    }
+
+  limit = (clock_t)((uint64_t)sconn->s_busypoll * perf_getfreq() /
+                    USEC_PER_SEC);
+  start = perf_gettime();
+
+  do
+    {
+      npolled = 0;
+      if (dev != NULL)
+        {
+          netdev_busypoll_callback(dev, &npolled);
+        }
+      else
+        {
+          netdev_foreach(netdev_busypoll_callback, &npolled);
+        }
+
+      /* Nothing can be polled, so just wait */
+
+      if (npolled == 0)
+        {
+          break;
+        }
+
+      if (nxsem_get_value(sem, &semcount) == OK && semcount > 0)
+        {
+          break;
+        }
+    }
+  while (perf_gettime() - start < limit);
+}
+
+#endif /* CONFIG_NET_BUSY_POLL */
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * net/netdev/netdev_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_chksum_offload
+ *
+ * Description:
+ *   Leave the TCP/UDP checksum of the outgoing packet in d_iob to the
+ *   device if it supports that: the pseudo-header sum is stored in the
+ *   checksum field and the packet is marked NETDEV_CHKSUM_PARTIAL.
+ *
+ * Input Parameters:
+ *   dev    - The device the packet is sent on
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *   chksum - The checksum field in the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the device will finish the checksum; false if the caller must
+ *   compute it.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+bool netdev_chksum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                           FAR uint16_t *chksum)
+{
+  uint16_t iplen;
+  uint16_t sum;
+
+  if ((dev->d_features & NETDEV_FEATURE_TXCSUM) == 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      iplen = (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+      sum   = ipv4_upperlayer_header_chksum(dev, proto);
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      iplen = IPv6_HDRLEN;
+      sum   = ipv6_upperlayer_header_chksum(dev, proto, IPv6_HDRLEN);
+#else
+      return false;
+#endif
+    }
+
+  /* The device adds the header and the data to the pseudo-header sum and
+   * stores the complement in place.
+   */
+
+  *chksum = HTONS(sum);
+
+  dev->d_chksum_flags  |= NETDEV_CHKSUM_PARTIAL;
+  dev->d_chksum_start   = iplen;
+  dev->d_chksum_offset  = (FAR uint8_t *)chksum -
+                          (FAR uint8_t *)IPBUF(iplen);
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_chksum_complete
+ *
+ * Description:
+ *   Finish in software the TCP/UDP checksum of the packet in d_iob that
+ *   was left to the device with NETDEV_CHKSUM_PARTIAL.  Used where the
+ *   packet does not reach the device as it is (fragmentation, NAT,
+ *   segmentation or a device without the feature).
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_chksum_complete(FAR struct net_driver_s *dev)
+{
+  FAR uint16_t *chksum;
+  uint16_t sum;
+
+  if ((dev->d_chksum_flags & NETDEV_CHKSUM_PARTIAL) == 0)
+    {
+      return;
+    }
+
+  DEBUGASSERT(dev->d_iob != NULL);
+
+  chksum = IPBUF(dev->d_chksum_start + dev->d_chksum_offset);
+  sum    = chksum_iob(0, dev->d_iob, dev->d_chksum_start);
+  sum    = ~((sum == 0) ? 0xffff : HTONS(sum));
+
+  /* A zero UDP checksum means "none"; send it as 0xffff, which is the
+   * same value in one's complement and equally valid for TCP.
+   */
+
+  *chksum = (sum == 0) ? 0xffff : sum;
+  dev->d_chksum_flags &= ~NETDEV_CHKSUM_PARTIAL;
+}
+
+#endif /* CONFIG_NETDEV_CHKSUM_OFFLOAD */
@@ -31,6 +31,7 @@
 #include <errno.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
@@ -58,6 +59,7 @@
 FAR struct net_driver_s *netdev_findbyindex(int ifindex)
 {
   FAR struct net_driver_s *dev;
+  irqstate_t flags;
 #ifdef CONFIG_NETDEV_IFINDEX
   /* The bit index is the interface index minus one.  Zero is reserved in
    * POSIX to mean no interface index.
@@ -72,7 +74,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
 
 #endif
 
-  net_lock();
+  flags = rcu_read_lock();
 
 #ifdef CONFIG_NETDEV_IFINDEX
   /* Check if this index has been assigned */
@@ -81,12 +83,13 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     {
       /* This index has not been assigned */
 
-      net_unlock();
+      rcu_read_unlock(flags);
       return NULL;
     }
 #endif
 
-  for (dev = g_netdevices; dev; dev = dev->flink)
+  for (dev = rcu_dereference(g_netdevices); dev;
+       dev = rcu_dereference(dev->flink))
     {
 #ifdef CONFIG_NETDEV_IFINDEX
       /* Check if the index matches the index assigned when the device was
@@ -104,12 +107,12 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
       if (++i == ifindex)
 #endif
         {
-          net_unlock();
+          rcu_read_unlock(flags);
           return dev;
         }
     }
 
-  net_unlock();
+  rcu_read_unlock(flags);
   return NULL;
 }
 
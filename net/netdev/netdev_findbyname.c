@@ -30,6 +30,7 @@
 #include <errno.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
@@ -56,20 +57,27 @@
 FAR struct net_driver_s *netdev_findbyname(FAR const char *ifname)
 {
   FAR struct net_driver_s *dev;
+  irqstate_t flags;
 
   if (ifname)
     {
-      net_lock();
-      for (dev = g_netdevices; dev; dev = dev->flink)
+      /* The list is only walked here, so an RCU read-side section is
+       * enough to keep it consistent against netdev_register() and
+       * netdev_unregister().
+       */
+
+      flags = rcu_read_lock();
+      for (dev = rcu_dereference(g_netdevices); dev;
+           dev = rcu_dereference(dev->flink))
         {
           if (strcmp(ifname, dev->d_ifname) == 0)
             {
-              net_unlock();
+              rcu_read_unlock(flags);
               return dev;
             }
         }
 
-      net_unlock();
+      rcu_read_unlock(flags);
     }
 
   return NULL;
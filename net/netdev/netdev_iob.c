@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -58,14 +59,28 @@
 int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
                        unsigned int timeout)
 {
+  unsigned int size = CONFIG_NET_LL_GUARDSIZE + dev->d_pktsize;
+
+#ifdef CONFIG_IOB_SMALL
+  /* The buffer may be a small one handed over by the stack to send a short
+   * packet.  The driver may receive a full frame into it, so replace it.
+   */
+
+  if (dev->d_iob != NULL &&
+      IOB_BUFSIZE(dev->d_iob) < MIN(size, CONFIG_IOB_BUFSIZE))
+    {
+      netdev_iob_release(dev);
+    }
+#endif
+
   /* Prepare iob buffer */
 
   if (dev->d_iob == NULL)
     {
-      dev->d_iob = net_iobtimedalloc(false, timeout);
+      dev->d_iob = net_iobtimedalloc_size(size, false, timeout);
       if (dev->d_iob == NULL && throttled)
         {
-          dev->d_iob = net_iobtimedalloc(true, timeout);
+          dev->d_iob = net_iobtimedalloc_size(size, true, timeout);
         }
     }
 
@@ -83,6 +98,12 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
 
   dev->d_buf = NETLLBUF;
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* A new packet, nothing is known about its checksums yet */
+
+  dev->d_chksum_flags = 0;
+#endif
+
   return OK;
 }
 
@@ -108,9 +129,26 @@ void netdev_iob_prepare_dynamic(FAR struct net_driver_s *dev, uint16_t size)
       return;
     }
 
-  /* alloc new iob for jumbo frame */
+  /* Prefer a pre-allocated I/O buffer of the smallest class that holds the
+   * whole frame.  Otherwise alloc new iob for jumbo frame.
+   */
+
+  iob = NULL;
+  if (size <= IOB_MAXBUFSIZE)
+    {
+      iob = iob_tryalloc_size(size, false);
+      if (iob != NULL && IOB_BUFSIZE(iob) < size)
+        {
+          iob_free(iob);
+          iob = NULL;
+        }
+    }
+
+  if (iob == NULL)
+    {
+      iob = iob_alloc_dynamic(size);
+    }
 
-  iob = iob_alloc_dynamic(size);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to allocate an I/O buffer.");
@@ -194,6 +232,10 @@ void netdev_iob_clear(FAR struct net_driver_s *dev)
   dev->d_iob = NULL;
   dev->d_buf = NULL;
   dev->d_len = 0;
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  dev->d_chksum_flags = 0;
+#endif
 }
 
 /****************************************************************************
@@ -218,6 +260,10 @@ void netdev_iob_release(FAR struct net_driver_s *dev)
     }
 
   dev->d_buf = NULL;
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  dev->d_chksum_flags = 0;
+#endif
 }
 
 /****************************************************************************
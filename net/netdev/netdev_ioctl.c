@@ -83,6 +83,7 @@
 #include "devif/devif.h"
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
+#include "ipforward/ipforward.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
@@ -719,6 +720,7 @@ static ssize_t net_ioctl_ifreq_arglen(uint8_t domain, int cmd)
       case SIOCGMIIPHY:
       case SIOCGMIIREG:
       case SIOCSMIIREG:
+      case SIOCETHTOOL:
       case SIOCGCANBITRATE:
       case SIOCSCANBITRATE:
       case SIOCACANEXTFILTER:
@@ -1175,6 +1177,24 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#if defined(CONFIG_NETDEV_IOCTL) && defined(CONFIG_NETDEV_ETHTOOL_IOCTL)
+      case SIOCETHTOOL:  /* Ethtool command, ifr_data points to it */
+        if (req->ifr_data == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else if (dev->d_ioctl)
+          {
+            ret = dev->d_ioctl(dev, cmd,
+                               (unsigned long)(uintptr_t)req->ifr_data);
+          }
+        else
+          {
+            ret = -ENOSYS;
+          }
+        break;
+#endif
+
 #if defined(CONFIG_NETDEV_IOCTL) && defined(CONFIG_NETDEV_CAN_BITRATE_IOCTL)
       case SIOCGCANBITRATE:  /* Get bitrate from a CAN controller */
       case SIOCSCANBITRATE:  /* Set bitrate of a CAN controller */
@@ -1240,6 +1260,15 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
     }
 
+  /* The device address or state may have changed, which cached forwarding
+   * decisions depend on.
+   */
+
+  if (ret >= 0)
+    {
+      ipfwd_flowcache_flush();
+    }
+
   net_unlock();
   return ret;
 }
@@ -1962,6 +1991,8 @@ int netdev_ifup(FAR struct net_driver_s *dev)
 
               dev->d_flags |= IFF_UP;
 
+              ipfwd_flowcache_flush();
+
               /* Update the driver status */
 
               netlink_device_notify(dev);
@@ -1996,6 +2027,8 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
 
+              ipfwd_flowcache_flush();
+
               /* Update the driver status */
 
               netlink_device_notify(dev);
@@ -40,10 +40,12 @@
 #include <nuttx/net/ethernet.h>
 #include <nuttx/net/bluetooth.h>
 #include <nuttx/net/can.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "icmpv6/icmpv6.h"
 #include "igmp/igmp.h"
+#include "ipforward/ipforward.h"
 #include "mld/mld.h"
 #include "netdev/netdev.h"
 
@@ -454,7 +456,9 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       snprintf(dev->d_ifname, IFNAMSIZ, devfmt, devnum);
 
-      /* Add the device to the list of known network devices */
+      /* Add the device to the list of known network devices.  The entry
+       * must be complete before it is published to lockless readers.
+       */
 
       last = &g_netdevices;
       while (*last)
@@ -462,9 +466,9 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
           last = &((*last)->flink);
         }
 
-      *last = dev;
-
       dev->flink = NULL;
+      rcu_assign_pointer(*last, dev);
+      ipfwd_flowcache_flush();
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
@@ -36,8 +36,10 @@
 #include <net/if.h>
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
+#include "ipforward/ipforward.h"
 #include "netdev/netdev.h"
 
 /****************************************************************************
@@ -135,16 +137,18 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             {
               /* The entry was in the middle or at the end of the list */
 
-              prev->flink = curr->flink;
+              rcu_assign_pointer(prev->flink, curr->flink);
             }
           else
             {
               /* The entry was at the beginning of the list */
 
-              g_netdevices = curr->flink;
+              rcu_assign_pointer(g_netdevices, curr->flink);
             }
 
-          curr->flink = NULL;
+          /* Forget the forwarding decisions that may refer to it */
+
+          ipfwd_flowcache_flush();
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
@@ -152,6 +156,16 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 #endif
       net_unlock();
 
+      /* Lockless readers may still be walking through the entry, wait for
+       * them before breaking its link.
+       */
+
+      if (curr)
+        {
+          synchronize_rcu();
+          curr->flink = NULL;
+        }
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
       work_cancel_sync(NETDEV_STATISTICS_WORK, &dev->d_statistics.logwork);
 #endif
@@ -48,6 +48,7 @@
 #include "net/if_arp.h"
 #include "neighbor/neighbor.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
 
@@ -82,6 +83,10 @@ struct getlink_recvfrom_response_s
   struct ifinfomsg iface;
   struct rtattr    attrmtu;
   uint32_t         mtu;                         /* IFLA_MTU attribute */
+#ifdef CONFIG_NETDEV_STATISTICS
+  struct rtattr    attrstats;                   /* IFLA_STATS64 attribute */
+  uint8_t          stats[sizeof(struct rtnl_link_stats64)];
+#endif
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_TUN)
   struct rtattr    attraddr;
   uint8_t          mac[NLMSG_ALIGN(ETH_ALEN)];  /* IFLA_ADDRESS attribute */
@@ -321,6 +326,38 @@ static uint16_t netlink_convert_device_type(uint8_t lltype)
     }
 }
 
+#ifdef CONFIG_NETDEV_STATISTICS
+/****************************************************************************
+ * Name: netlink_get_stats64
+ *
+ * Description:
+ *   Convert the device statistics to the IFLA_STATS64 layout used by
+ *   "ip -s link".
+ *
+ ****************************************************************************/
+
+static void netlink_get_stats64(FAR struct net_driver_s *dev,
+                                FAR uint8_t *buf)
+{
+  FAR struct netdev_statistics_s *devstats = &dev->d_statistics;
+  struct rtnl_link_stats64 stats;
+
+  memset(&stats, 0, sizeof(stats));
+
+  stats.rx_packets        = devstats->rx_packets;
+  stats.tx_packets        = devstats->tx_packets;
+  stats.rx_bytes          = devstats->rx_bytes;
+  stats.tx_bytes          = devstats->tx_bytes;
+  stats.rx_errors         = devstats->rx_errors;
+  stats.tx_errors         = devstats->tx_errors;
+  stats.rx_dropped        = devstats->rx_dropped;
+  stats.rx_nohandler      = devstats->rx_dropped;
+  stats.tx_aborted_errors = devstats->tx_timeouts;
+
+  memcpy(buf, &stats, sizeof(stats));
+}
+#endif
+
 static FAR struct netlink_response_s *
 netlink_get_device(FAR struct net_driver_s *dev,
                    FAR const struct nlroute_sendto_request_s *req)
@@ -361,6 +398,16 @@ netlink_get_device(FAR struct net_driver_s *dev,
   resp->attrmtu.rta_type = IFLA_MTU;
   resp->mtu              = NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev);
 
+#ifdef CONFIG_NETDEV_STATISTICS
+  /* The payload of the attribute is only 4 byte aligned, so the 64-bit
+   * counters are built on the stack and copied in.
+   */
+
+  resp->attrstats.rta_len  = RTA_LENGTH(sizeof(struct rtnl_link_stats64));
+  resp->attrstats.rta_type = IFLA_STATS64;
+  netlink_get_stats64(dev, resp->stats);
+#endif
+
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_TUN)
   resp->attraddr.rta_len  = RTA_LENGTH(ETH_ALEN);
   resp->attraddr.rta_type = IFLA_ADDRESS;
@@ -1027,6 +1074,7 @@ static int netlink_new_ipv4addr(NETLINK_HANDLE handle,
 
   dev->d_ipaddr  = nla_get_in_addr(tb[IFA_LOCAL]);
   dev->d_netmask = make_mask(ifm->ifa_prefixlen);
+  ipfwd_flowcache_flush();
 
   netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET, &dev->d_ipaddr,
                                ifm->ifa_prefixlen);
@@ -1131,6 +1179,7 @@ static int netlink_del_ipv4addr(NETLINK_HANDLE handle,
   netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET, &dev->d_ipaddr,
                                net_ipv4_mask2pref(dev->d_netmask));
   dev->d_ipaddr  = 0;
+  ipfwd_flowcache_flush();
 
   net_unlock();
 
@@ -30,8 +30,14 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <poll.h>
 
 #include <nuttx/net/net.h>
+#ifdef CONFIG_NET_PKT_MMAP
+#  include <nuttx/wqueue.h>
+#endif
 
 #ifdef CONFIG_NET_PKT
 
@@ -50,9 +56,40 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* The memory shared by the rings of a packet socket and the application.
+ * It stays allocated until the socket is closed and the last mapping is
+ * removed.
+ */
+
+struct pkt_region_s
+{
+  FAR uint8_t *data;            /* Memory of the rings */
+  size_t       size;            /* Size of the memory in bytes */
+  int          crefs;           /* The connection plus each mapping */
+};
+
+/* One PACKET_RX_RING or PACKET_TX_RING ring in the shared memory */
+
+struct pkt_ring_s
+{
+  size_t   offset;              /* Offset of the ring in the region */
+  uint32_t blocksize;           /* Size of one block */
+  uint32_t blocknr;             /* Number of blocks, 0 if no ring */
+  uint32_t framesize;           /* Size of one frame */
+  uint32_t framenr;             /* Number of frames */
+  uint32_t privsize;            /* RX: private area of each block */
+  uint32_t head;                /* RX: open block, TX: next frame */
+  uint32_t last;                /* RX: offset of the last frame */
+  uint64_t seq;                 /* RX: sequence number of the open block */
+  clock_t  tov;                 /* RX: block retire timeout in ticks */
+};
+#endif
+
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct bpf_prog_s;       /* Forward reference */
 
 struct pkt_conn_s
 {
@@ -70,11 +107,32 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+  /* The threads waiting in poll() */
+
+  FAR struct pollfd *fds[CONFIG_NET_PKT_NPOLLWAITERS];
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Memory mapped rings.  With a receive ring the frames are stored there
+   * instead of the read-ahead queue.
+   */
+
+  uint8_t    version;             /* PACKET_VERSION */
+  bool       losing;              /* Frames dropped since the last block */
+  FAR struct pkt_region_s *region;
+  struct pkt_ring_s rxring;
+  struct pkt_ring_s txring;
+  struct work_s work;             /* Retires a partly filled RX block */
+  uint32_t   packets;             /* PACKET_STATISTICS */
+  uint32_t   drops;
+#endif
+
+#ifdef CONFIG_NET_BPF
+  FAR struct bpf_prog_s *bpf;     /* SO_ATTACH_FILTER program */
+#endif
 };
 
 /****************************************************************************
@@ -97,8 +155,11 @@ EXTERN const struct sock_intf_s g_pkt_sockif;
  * Public Function Prototypes
  ****************************************************************************/
 
-struct net_driver_s; /* Forward reference */
-struct socket;       /* Forward reference */
+struct net_driver_s;   /* Forward reference */
+struct socket;         /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
+struct tpacket3_hdr;   /* Forward reference */
+struct tpacket_req3;   /* Forward reference */
 
 /****************************************************************************
  * Name: pkt_initialize()
@@ -293,6 +354,174 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on packet socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Tear down the poll
+ *
+ * Returned Value:
+ *   0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                bool setup);
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Notify the threads polling the packet socket of new events.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset);
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Get the SOL_PACKET options of a packet socket: PACKET_VERSION and
+ *   PACKET_STATISTICS.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOPROTOOPT
+ *   is returned for the options of other levels.
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
+#if defined(CONFIG_NET_PKT_MMAP) || defined(CONFIG_NET_BPF)
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set the options of a packet socket: the socket filter options and the
+ *   SOL_PACKET options PACKET_VERSION, PACKET_RX_RING and PACKET_TX_RING.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOPROTOOPT
+ *   is returned for the options that are not handled here.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Configure or remove the receive or transmit ring of a packet socket.
+ *   The memory of both rings is allocated again, so both restart empty.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool rx,
+                   FAR const struct tpacket_req3 *req);
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket, the receive ring first and then the
+ *   transmit ring.
+ *
+ ****************************************************************************/
+
+int pkt_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the first 'caplen' bytes of the frame in dev->d_iob into the
+ *   receive ring of 'conn'.  The frame is dropped if the application still
+ *   owns the block.
+ *
+ * Assumptions:
+ *   The network is locked and 'conn' has a receive ring.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, uint32_t caplen);
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if the receive ring holds a block for the application.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_txframe
+ *
+ * Description:
+ *   Return the next frame of the transmit ring that the application has
+ *   queued and the location of its link layer data, or NULL if there is
+ *   none.  Frames that do not fit in their slot are skipped.
+ *
+ * Assumptions:
+ *   The network is locked and 'conn' has a transmit ring.
+ *
+ ****************************************************************************/
+
+FAR struct tpacket3_hdr *pkt_ring_txframe(FAR struct pkt_conn_s *conn,
+                                          FAR const uint8_t **data);
+
+/****************************************************************************
+ * Name: pkt_ring_txdone
+ *
+ * Description:
+ *   Give a frame returned by pkt_ring_txframe() back to the application
+ *   and move to the next one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_txdone(FAR struct pkt_conn_s *conn,
+                     FAR struct tpacket3_hdr *hdr);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings when the socket is closed.  The memory remains
+ *   valid until the last mapping is removed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
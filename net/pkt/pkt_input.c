@@ -35,6 +35,7 @@
 #include <nuttx/net/pkt.h>
 
 #include "devif/devif.h"
+#include "socket/socket.h"
 #include "pkt/pkt.h"
 
 /****************************************************************************
@@ -93,6 +94,7 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
   else
     {
       ninfo("Buffered %d bytes\n", dev->d_len);
+      pkt_pollnotify(conn, POLLIN);
       return dev->d_len;
     }
 
@@ -132,13 +134,50 @@ errout:
 static int pkt_in(FAR struct net_driver_s *dev)
 {
   FAR struct pkt_conn_s *conn;
+  uint32_t caplen = dev->d_len;
   int ret = OK;
 
   conn = pkt_active(dev);
+#ifdef CONFIG_NET_BPF
+  if (conn && conn->bpf)
+    {
+      /* Run the socket filter on the frame in place, before anything is
+       * copied.  It returns how much of the frame to keep.
+       */
+
+      caplen = sock_bpf_run(conn->bpf, dev->d_iob, -NET_LL_HDRLEN(dev),
+                            dev->d_len);
+      if (caplen == 0)
+        {
+          ninfo("Rejected by the socket filter\n");
+          return OK;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  if (conn && conn->rxring.blocknr > 0)
+    {
+      /* Frames go to the receive ring instead of the read-ahead queue.
+       * A frame that finds the ring full is dropped, not retried.
+       */
+
+      pkt_ring_input(dev, conn, caplen);
+    }
+  else
+#endif
   if (conn)
     {
+      uint16_t len = dev->d_len;
       uint16_t flags;
 
+      /* Deliver only what the socket filter kept */
+
+      if (caplen < len)
+        {
+          dev->d_len = caplen;
+        }
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -166,6 +205,8 @@ static int pkt_in(FAR struct net_driver_s *dev)
               ret = -EAGAIN;
             }
         }
+
+      dev->d_len = len;
     }
   else
     {
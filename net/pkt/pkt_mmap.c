@@ -0,0 +1,622 @@
+/****************************************************************************
+ * net/pkt/pkt_mmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A receive block starts with its descriptor and the private area, both
+ * rounded up to 8 bytes, followed by the frames.
+ */
+
+#define PKT_ALIGN8(x)         (((x) + 7) & ~7)
+#define PKT_BLK_HDRLEN        PKT_ALIGN8(sizeof(struct tpacket_block_desc))
+#define PKT_BLK_FIRST(priv)   (PKT_BLK_HDRLEN + PKT_ALIGN8(priv))
+
+/* The link layer data of a frame to send follows its header */
+
+#define PKT_TX_DATAOFF        TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+
+/* Receive block retire timeout used if the request gives none (ms) */
+
+#define PKT_RING_DEFTOV       8
+
+#define PKT_RXBLOCK(conn, n) \
+  ((FAR struct tpacket_block_desc *) \
+   ((conn)->region->data + (conn)->rxring.offset + \
+    (size_t)(n) * (conn)->rxring.blocksize))
+
+#define PKT_TXFRAME(conn, n) \
+  ((FAR struct tpacket3_hdr *) \
+   ((conn)->region->data + (conn)->txring.offset + \
+    (size_t)((n) / ((conn)->txring.blocksize / (conn)->txring.framesize)) * \
+    (conn)->txring.blocksize + \
+    (size_t)((n) % ((conn)->txring.blocksize / (conn)->txring.framesize)) * \
+    (conn)->txring.framesize))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_region_release
+ *
+ * Description:
+ *   Drop one reference to the shared memory of the rings.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_region_release(FAR struct pkt_region_s *region)
+{
+  DEBUGASSERT(region->crefs > 0);
+
+  if (--region->crefs == 0)
+    {
+      kumm_free(region->data);
+      kmm_free(region);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_size
+ ****************************************************************************/
+
+static size_t pkt_ring_size(FAR const struct pkt_ring_s *ring)
+{
+  return (size_t)ring->blocksize * ring->blocknr;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Hand the open receive block over to the application and move to the
+ *   next block.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_conn_s *conn, uint32_t status)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *blk = PKT_RXBLOCK(conn, ring->head);
+
+  status |= TP_STATUS_USER;
+  if (conn->losing)
+    {
+      status |= TP_STATUS_LOSING;
+      conn->losing = false;
+    }
+
+  /* The frames must be visible before the block changes hands */
+
+  UP_DMB();
+  blk->hdr.bh1.block_status = status;
+
+  ring->head = (ring->head + 1) % ring->blocknr;
+  ring->last = 0;
+
+  pkt_pollnotify(conn, POLLIN);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire the open receive block if no more frames filled it in time, so
+ *   that a slow trickle of frames is delivered without waiting for the
+ *   block to fill up.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_conn_s *conn = arg;
+
+  net_lock();
+
+  if (conn->region != NULL && conn->rxring.blocknr > 0 &&
+      conn->rxring.last != 0)
+    {
+      pkt_ring_retire(conn, TP_STATUS_BLK_TMO);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_munmap
+ ****************************************************************************/
+
+static int pkt_munmap(FAR struct task_group_s *group,
+                      FAR struct mm_map_entry_s *map,
+                      FAR void *start, size_t length)
+{
+  net_lock();
+  pkt_region_release(map->priv.p);
+  net_unlock();
+
+  return mm_map_remove(get_group_mm(group), map);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Configure or remove one ring.  The memory of both rings is allocated
+ *   again, so both restart empty.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool rx,
+                   FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_region_s *region = NULL;
+  FAR struct pkt_ring_s *other;
+  struct pkt_ring_s ring;
+  size_t rxsize;
+  size_t txsize;
+
+  if (conn->version != TPACKET_V3)
+    {
+      return -EINVAL;
+    }
+
+  /* The memory can not move while the application has it mapped */
+
+  if (conn->region != NULL && conn->region->crefs > 1)
+    {
+      return -EBUSY;
+    }
+
+  memset(&ring, 0, sizeof(ring));
+
+  if (req->tp_block_nr > 0)
+    {
+      if (req->tp_block_size == 0 ||
+          req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+          req->tp_block_nr > SIZE_MAX / 2 / req->tp_block_size ||
+          req->tp_frame_size < TPACKET3_HDRLEN ||
+          req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+          req->tp_frame_size > req->tp_block_size ||
+          req->tp_frame_nr != req->tp_block_size / req->tp_frame_size *
+                              req->tp_block_nr)
+        {
+          return -EINVAL;
+        }
+
+      if (rx && (req->tp_sizeof_priv >= req->tp_block_size ||
+                 PKT_BLK_FIRST(req->tp_sizeof_priv) + TPACKET3_HDRLEN >
+                 req->tp_block_size))
+        {
+          return -EINVAL;
+        }
+
+      ring.blocksize = req->tp_block_size;
+      ring.blocknr   = req->tp_block_nr;
+      ring.framesize = req->tp_frame_size;
+      ring.framenr   = req->tp_frame_nr;
+
+      if (rx)
+        {
+          ring.privsize = req->tp_sizeof_priv;
+          ring.tov      = MSEC2TICK(req->tp_retire_blk_tov > 0 ?
+                                    req->tp_retire_blk_tov :
+                                    PKT_RING_DEFTOV);
+          ring.tov      = MAX(ring.tov, 1);
+        }
+    }
+
+  other  = rx ? &conn->txring : &conn->rxring;
+  rxsize = pkt_ring_size(rx ? &ring : other);
+  txsize = pkt_ring_size(rx ? other : &ring);
+
+  if (rxsize + txsize > 0)
+    {
+      region = kmm_zalloc(sizeof(struct pkt_region_s));
+      if (region == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      region->data = kumm_zalloc(rxsize + txsize);
+      if (region->data == NULL)
+        {
+          kmm_free(region);
+          return -ENOMEM;
+        }
+
+      region->size  = rxsize + txsize;
+      region->crefs = 1;
+    }
+
+  /* Replace the old memory.  A pending retire timeout finds no open block
+   * and does nothing.
+   */
+
+  work_cancel(LPWORK, &conn->work);
+
+  if (conn->region != NULL)
+    {
+      pkt_region_release(conn->region);
+    }
+
+  conn->region = region;
+  conn->losing = false;
+
+  if (rx)
+    {
+      conn->rxring = ring;
+    }
+  else
+    {
+      conn->txring = ring;
+    }
+
+  other->head         = 0;
+  other->last         = 0;
+  conn->rxring.offset = 0;
+  conn->txring.offset = rxsize;
+
+  ninfo("RX ring %zu bytes, TX ring %zu bytes\n", rxsize, txsize);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket, the receive ring first and then the
+ *   transmit ring.  The mapping keeps the memory alive after close().
+ *
+ ****************************************************************************/
+
+int pkt_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_region_s *region;
+  int ret = -EINVAL;
+
+  net_lock();
+
+  region = conn->region;
+  if (region != NULL && map->offset == 0 && map->length <= region->size)
+    {
+      map->vaddr  = region->data;
+      map->munmap = pkt_munmap;
+      map->priv.p = region;
+
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret >= 0)
+        {
+          region->crefs++;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the frame in dev->d_iob into the receive ring of 'conn'.  The
+ *   frame is dropped if the application still owns the block.
+ *
+ * Assumptions:
+ *   The network is locked and 'conn' has a receive ring.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, uint32_t caplen)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *blk;
+  FAR struct tpacket3_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  uint32_t first = PKT_BLK_FIRST(ring->privsize);
+  uint32_t maclen = NET_LL_HDRLEN(dev);
+  uint32_t status = TP_STATUS_USER | TP_STATUS_TS_SOFTWARE;
+  uint32_t netoff;
+  uint32_t macoff;
+  uint32_t snaplen;
+  uint32_t size;
+  uint32_t off;
+
+  DEBUGASSERT(conn->region != NULL && ring->blocknr > 0);
+
+  conn->packets++;
+
+  /* Align the network header, as Linux does */
+
+  netoff = TPACKET_ALIGN(TPACKET3_HDRLEN + MAX(maclen, 16));
+  macoff = netoff - maclen;
+  if (macoff >= ring->blocksize - first)
+    {
+      conn->drops++;
+      return;
+    }
+
+  /* Truncate a frame that would not fit in an empty block */
+
+  snaplen = MIN(caplen, dev->d_len);
+  if (snaplen > ring->blocksize - first - macoff)
+    {
+      snaplen = ring->blocksize - first - macoff;
+      status |= TP_STATUS_COPY;
+    }
+
+  size = TPACKET_ALIGN(macoff + snaplen);
+  blk  = PKT_RXBLOCK(conn, ring->head);
+
+  if (ring->last != 0 && blk->hdr.bh1.blk_len + size > ring->blocksize)
+    {
+      pkt_ring_retire(conn, 0);
+      blk = PKT_RXBLOCK(conn, ring->head);
+    }
+
+  if (ring->last == 0)
+    {
+      /* Open the next block, unless the application still owns it */
+
+      if (blk->hdr.bh1.block_status != TP_STATUS_KERNEL)
+        {
+          conn->drops++;
+          conn->losing = true;
+          return;
+        }
+
+      blk->version                     = TPACKET_V3;
+      blk->offset_to_priv              = PKT_BLK_HDRLEN;
+      blk->hdr.bh1.num_pkts            = 0;
+      blk->hdr.bh1.offset_to_first_pkt = first;
+      blk->hdr.bh1.blk_len             = first;
+      blk->hdr.bh1.seq_num             = ++ring->seq;
+
+      work_queue(LPWORK, &conn->work, pkt_ring_timeout, conn, ring->tov);
+    }
+
+  /* Copy the frame straight from the driver's I/O buffer chain */
+
+  off = blk->hdr.bh1.blk_len;
+  hdr = (FAR struct tpacket3_hdr *)((FAR uint8_t *)blk + off);
+
+  memset(hdr, 0, macoff);
+  iob_copyout((FAR uint8_t *)hdr + macoff, dev->d_iob, snaplen,
+              -NET_LL_HDRLEN(dev));
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_status  = status;
+  hdr->tp_mac     = macoff;
+  hdr->tp_net     = netoff;
+
+  sll = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr +
+                                   TPACKET_ALIGN(sizeof(*hdr)));
+  sll->sll_family  = AF_PACKET;
+  sll->sll_ifindex = dev->d_ifindex;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET ||
+      dev->d_lltype == NET_LL_IEEE80211)
+    {
+      FAR struct eth_hdr_s *ethhdr = NETLLBUF;
+
+      sll->sll_protocol = ethhdr->type;
+      sll->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(sll->sll_addr, ethhdr->src, ETHER_ADDR_LEN);
+    }
+#endif
+
+  /* Link the frame after the previous one of the block */
+
+  if (blk->hdr.bh1.num_pkts > 0)
+    {
+      ((FAR struct tpacket3_hdr *)((FAR uint8_t *)blk + ring->last))->
+        tp_next_offset = off - ring->last;
+    }
+  else
+    {
+      blk->hdr.bh1.ts_first_pkt.ts_sec  = ts.tv_sec;
+      blk->hdr.bh1.ts_first_pkt.ts_nsec = ts.tv_nsec;
+    }
+
+  blk->hdr.bh1.ts_last_pkt.ts_sec  = ts.tv_sec;
+  blk->hdr.bh1.ts_last_pkt.ts_nsec = ts.tv_nsec;
+  blk->hdr.bh1.blk_len             = off + size;
+  blk->hdr.bh1.num_pkts++;
+  ring->last                       = off;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if the receive ring holds a block for the application.
+ *   Blocks are retired in order, so it is enough to look at the one
+ *   before the open block.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  uint32_t prev = (ring->head + ring->blocknr - 1) % ring->blocknr;
+
+  return PKT_RXBLOCK(conn, prev)->hdr.bh1.block_status != TP_STATUS_KERNEL;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_txframe
+ *
+ * Description:
+ *   Return the next frame of the transmit ring that the application has
+ *   queued and the location of its link layer data, or NULL if there is
+ *   none.  Frames that do not fit in their slot are skipped.
+ *
+ * Assumptions:
+ *   The network is locked and 'conn' has a transmit ring.
+ *
+ ****************************************************************************/
+
+FAR struct tpacket3_hdr *pkt_ring_txframe(FAR struct pkt_conn_s *conn,
+                                          FAR const uint8_t **data)
+{
+  FAR struct pkt_ring_s *ring = &conn->txring;
+  FAR struct tpacket3_hdr *hdr;
+  uint32_t n;
+
+  for (n = 0; n < ring->framenr; n++)
+    {
+      hdr = PKT_TXFRAME(conn, ring->head);
+      if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+        {
+          break;
+        }
+
+      /* Read the frame only after its status */
+
+      UP_DMB();
+
+      if (hdr->tp_len > 0 && hdr->tp_len <= ring->framesize - PKT_TX_DATAOFF)
+        {
+          hdr->tp_status = TP_STATUS_SENDING;
+          *data = (FAR const uint8_t *)hdr + PKT_TX_DATAOFF;
+          return hdr;
+        }
+
+      nwarn("WARNING: Bad frame length %" PRIu32 "\n", hdr->tp_len);
+
+      hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+      ring->head = (ring->head + 1) % ring->framenr;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_txdone
+ *
+ * Description:
+ *   Give a frame returned by pkt_ring_txframe() back to the application
+ *   and move to the next one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_txdone(FAR struct pkt_conn_s *conn,
+                     FAR struct tpacket3_hdr *hdr)
+{
+  FAR struct pkt_ring_s *ring = &conn->txring;
+
+  UP_DMB();
+  hdr->tp_status = TP_STATUS_AVAILABLE;
+  ring->head = (ring->head + 1) % ring->framenr;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings when the socket is closed.  The memory remains
+ *   valid until the last mapping is removed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  /* Detach the rings first so that no new retire timeout is started */
+
+  net_lock();
+
+  if (conn->region != NULL)
+    {
+      pkt_region_release(conn->region);
+      conn->region = NULL;
+    }
+
+  memset(&conn->rxring, 0, sizeof(conn->rxring));
+  memset(&conn->txring, 0, sizeof(conn->txring));
+
+  net_unlock();
+
+  work_cancel_sync(LPWORK, &conn->work);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_MMAP */
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * net/pkt/pkt_netpoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
+
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on packet socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Tear down the poll
+ *
+ * Returned Value:
+ *   0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                bool setup)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pollfd **slot;
+  pollevent_t eventset;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(conn != NULL);
+
+  net_lock();
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+        {
+          if (conn->fds[i] == NULL)
+            {
+              conn->fds[i] = fds;
+              fds->priv    = &conn->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_NET_PKT_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          /* Frames are sent synchronously, so the socket is always
+           * writable.
+           */
+
+          eventset = POLLOUT;
+
+          if (!IOB_QEMPTY(&conn->readahead))
+            {
+              eventset |= POLLIN;
+            }
+#ifdef CONFIG_NET_PKT_MMAP
+          else if (conn->rxring.blocknr > 0 && pkt_ring_readable(conn))
+            {
+              eventset |= POLLIN;
+            }
+#endif
+
+          poll_notify(&fds, 1, eventset);
+        }
+    }
+  else
+    {
+      /* Release the slot of the poll structure reference */
+
+      slot = (FAR struct pollfd **)fds->priv;
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Notify the threads polling the packet socket of new events.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset)
+{
+  poll_notify(conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, eventset);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT */
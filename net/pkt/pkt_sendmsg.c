@@ -43,6 +43,10 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
+#ifdef CONFIG_NET_PKT_MMAP
+#  include <netpacket/packet.h>
+#endif
+
 #include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "socket/socket.h"
@@ -141,6 +145,80 @@ end_wait:
   return flags;
 }
 
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: psock_ring_eventhandler
+ *
+ * Description:
+ *   Send the frames queued in the transmit ring, one each time the device
+ *   is polled, until the ring has no more.
+ *
+ ****************************************************************************/
+
+static uint16_t psock_ring_eventhandler(FAR struct net_driver_s *dev,
+                                        FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct send_s *pstate = pvpriv;
+  FAR struct pkt_conn_s *conn;
+  FAR struct tpacket3_hdr *hdr;
+  FAR const uint8_t *data;
+  int ret;
+
+  ninfo("flags: %04x sent: %zd\n", flags, pstate->snd_sent);
+
+  if (pstate)
+    {
+      /* Wait for the next polling cycle if the buffer is busy */
+
+      if (dev->d_sndlen > 0 || (flags & PKT_NEWDATA) != 0)
+        {
+          return flags;
+        }
+
+      conn = pstate->snd_sock->s_conn;
+      hdr  = conn->txring.blocknr > 0 ? pkt_ring_txframe(conn, &data) :
+                                        NULL;
+      if (hdr != NULL)
+        {
+          ret = devif_send(dev, data, hdr->tp_len, -NET_LL_HDRLEN(dev));
+          if (ret > 0)
+            {
+              dev->d_len        = dev->d_sndlen;
+              pstate->snd_sent += hdr->tp_len;
+              pkt_ring_txdone(conn, hdr);
+
+              /* Make sure no ARP request overwrites this frame */
+
+              IFF_SET_NOARP(dev->d_flags);
+              return flags;
+            }
+
+          /* Leave the frame queued and report the error, unless some
+           * frames were sent already.
+           */
+
+          hdr->tp_status = TP_STATUS_SEND_REQUEST;
+          if (pstate->snd_sent == 0)
+            {
+              pstate->snd_sent = ret < 0 ? ret : -ENOMEM;
+            }
+        }
+
+      /* Don't allow any further call backs. */
+
+      pstate->snd_cb->flags    = 0;
+      pstate->snd_cb->priv     = NULL;
+      pstate->snd_cb->event    = NULL;
+
+      /* Wake up the waiting thread */
+
+      nxsem_post(&pstate->snd_sem);
+    }
+
+  return flags;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -169,6 +247,8 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 {
   FAR const void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
+  devif_callback_event_t handler = psock_send_eventhandler;
+  FAR struct pkt_conn_s *conn;
   FAR struct net_driver_s *dev;
   struct send_s state;
   int ret = OK;
@@ -208,7 +288,8 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Get the device driver that will service this transfer */
 
-  dev = pkt_find_device(psock->s_conn);
+  conn = psock->s_conn;
+  dev  = pkt_find_device(conn);
   if (dev == NULL)
     {
       return -ENODEV;
@@ -228,10 +309,20 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   state.snd_buflen    = len;            /* Number of bytes to send */
   state.snd_buffer    = buf;            /* Buffer to send from */
 
-  if (len > 0)
+#ifdef CONFIG_NET_PKT_MMAP
+  /* With a transmit ring the frames queued there are sent instead of the
+   * buffer, and the number of bytes sent from the ring is returned.
+   */
+
+  if (conn->txring.blocknr > 0)
     {
-      FAR struct pkt_conn_s *conn = psock->s_conn;
+      handler = psock_ring_eventhandler;
+      len     = 1;
+    }
+#endif
 
+  if (len > 0)
+    {
       /* Allocate resource to receive a callback */
 
       state.snd_cb = pkt_callback_alloc(dev, conn);
@@ -241,7 +332,7 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
           state.snd_cb->flags = PKT_POLL;
           state.snd_cb->priv  = (FAR void *)&state;
-          state.snd_cb->event = psock_send_eventhandler;
+          state.snd_cb->event = handler;
 
           /* Notify the device driver that new TX data is available. */
 
@@ -71,10 +71,33 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_listen */
   NULL,            /* si_connect */
   NULL,            /* si_accept */
-  NULL,            /* si_poll */
+  pkt_netpoll,     /* si_poll */
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
-  pkt_close        /* si_close */
+  pkt_close,       /* si_close */
+  NULL,            /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL             /* si_shutdown */
+#ifdef CONFIG_NET_SOCKOPTS
+#  ifdef CONFIG_NET_PKT_MMAP
+  , pkt_getsockopt /* si_getsockopt */
+#  else
+  , NULL           /* si_getsockopt */
+#  endif
+#  if defined(CONFIG_NET_PKT_MMAP) || defined(CONFIG_NET_BPF)
+  , pkt_setsockopt /* si_setsockopt */
+#  else
+  , NULL           /* si_setsockopt */
+#  endif
+#endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#endif
+  , NULL           /* si_sendmmsg */
+  , NULL           /* si_recvmmsg */
+#ifdef CONFIG_NET_PKT_MMAP
+  , pkt_mmap       /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -308,6 +331,18 @@ static int pkt_close(FAR struct socket *psock)
 
               iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_PKT_MMAP
+              /* And the rings, mappings keep their memory */
+
+              pkt_ring_free(conn);
+#endif
+
+#ifdef CONFIG_NET_BPF
+              /* And the socket filter */
+
+              sock_bpf_free(&conn->bpf);
+#endif
+
               /* Then free the connection structure */
 
               conn->crefs = 0;          /* No more references on the connection */
@@ -0,0 +1,191 @@
+/****************************************************************************
+ * net/pkt/pkt_sockopt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+#if defined(CONFIG_NET_PKT_MMAP) || defined(CONFIG_NET_BPF)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Get the SOL_PACKET options of a packet socket: PACKET_VERSION and
+ *   PACKET_STATISTICS.  Reading the statistics resets them.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOPROTOOPT
+ *   is returned for the options of other levels.
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  struct tpacket_stats_v3 stats;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (*value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR int *)value = conn->version;
+        *value_len        = sizeof(int);
+        return OK;
+
+      case PACKET_STATISTICS:
+        memset(&stats, 0, sizeof(stats));
+
+        net_lock();
+        stats.tp_packets = conn->packets;
+        stats.tp_drops   = conn->drops;
+        conn->packets    = 0;
+        conn->drops      = 0;
+        net_unlock();
+
+        *value_len = MIN(*value_len, sizeof(stats));
+        memcpy(value, &stats, *value_len);
+        return OK;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set the options of a packet socket:  the SOL_SOCKET socket filter
+ *   options SO_ATTACH_FILTER and SO_DETACH_FILTER, and the SOL_PACKET
+ *   options PACKET_VERSION, PACKET_RX_RING and PACKET_TX_RING.  Only
+ *   TPACKET_V3 rings are supported and the version must be selected before
+ *   the rings.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOPROTOOPT
+ *   is returned for the options that are not handled here.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+#ifdef CONFIG_NET_PKT_MMAP
+  int ret;
+#endif
+
+#ifdef CONFIG_NET_BPF
+  if (level == SOL_SOCKET)
+    {
+      return sock_bpf_setsockopt(&conn->bpf, option, value, value_len);
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        if (*(FAR const int *)value != TPACKET_V3)
+          {
+            return -EINVAL;
+          }
+
+        net_lock();
+        if (conn->region != NULL)
+          {
+            ret = -EBUSY;
+          }
+        else
+          {
+            conn->version = TPACKET_V3;
+            ret = OK;
+          }
+
+        net_unlock();
+        return ret;
+
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value_len < sizeof(struct tpacket_req3))
+          {
+            return -EINVAL;
+          }
+
+        net_lock();
+        ret = pkt_ring_setup(conn, option == PACKET_RX_RING, value);
+        net_unlock();
+        return ret;
+
+      default:
+        break;
+    }
+#else
+  UNUSED(conn);
+#endif
+
+  return -ENOPROTOOPT;
+}
+
+#endif /* CONFIG_NET_PKT_MMAP || CONFIG_NET_BPF */
@@ -0,0 +1,175 @@
+/****************************************************************************
+ * net/procfs/net_ipfrag.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Output format:
+ *
+ *   Held:   Datagrams: xxxx IOBs: xxxx
+ *   Limits: High: xxxx Low: xxxx
+ *   Reassembled: xxxx
+ *   Dropped:
+ *     Timeout: xxxx
+ *     Evicted: xxxx
+ *     NoMem:   xxxx
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netstats.h>
+
+#include "procfs/procfs.h"
+#include "ipfrag/ipfrag.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_NET_STATISTICS)
+
+#ifdef CONFIG_NET_IPFRAG
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static int netprocfs_ipfrag_held(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_ipfrag_limits(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_ipfrag_reassembled(
+                  FAR struct netprocfs_file_s *netfile);
+static int netprocfs_ipfrag_dropped(FAR struct netprocfs_file_s *netfile);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static const linegen_t g_ipfrag_linegen[] =
+{
+  netprocfs_ipfrag_held,
+  netprocfs_ipfrag_limits,
+  netprocfs_ipfrag_reassembled,
+  netprocfs_ipfrag_dropped
+};
+
+#define NSTAT_LINES (sizeof(g_ipfrag_linegen) / sizeof(linegen_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_ipfrag_held
+ ****************************************************************************/
+
+static int netprocfs_ipfrag_held(FAR struct netprocfs_file_s *netfile)
+{
+  uint32_t nodes;
+  uint32_t iobs;
+
+  ip_frag_getusage(&nodes, &iobs);
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Held:   Datagrams: %04" PRIx32 " IOBs: %04" PRIx32 "\n",
+                  nodes, iobs);
+}
+
+/****************************************************************************
+ * Name: netprocfs_ipfrag_limits
+ ****************************************************************************/
+
+static int netprocfs_ipfrag_limits(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Limits: High: %04x Low: %04x\n",
+                  CONFIG_IOB_NBUFFERS * CONFIG_NET_IPFRAG_REASS_HIGHWATER /
+                  100,
+                  CONFIG_IOB_NBUFFERS * CONFIG_NET_IPFRAG_REASS_LOWWATER /
+                  100);
+}
+
+/****************************************************************************
+ * Name: netprocfs_ipfrag_reassembled
+ ****************************************************************************/
+
+static int netprocfs_ipfrag_reassembled(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN, "Reassembled: %04x\n",
+                  g_netstats.ipfrag.reassembled);
+}
+
+/****************************************************************************
+ * Name: netprocfs_ipfrag_dropped
+ ****************************************************************************/
+
+static int netprocfs_ipfrag_dropped(FAR struct netprocfs_file_s *netfile)
+{
+  int len;
+
+  len  = snprintf(netfile->line, NET_LINELEN, "Dropped:\n");
+  len += snprintf(&netfile->line[len], NET_LINELEN - len,
+                  "  Timeout: %04x\n", g_netstats.ipfrag.timedout);
+  len += snprintf(&netfile->line[len], NET_LINELEN - len,
+                  "  Evicted: %04x\n", g_netstats.ipfrag.evicted);
+  len += snprintf(&netfile->line[len], NET_LINELEN - len,
+                  "  NoMem:   %04x\n", g_netstats.ipfrag.nomem);
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_ipfragstats
+ *
+ * Description:
+ *   Read and format IP fragment reassembly statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_ipfragstats(FAR struct netprocfs_file_s *priv,
+                                   FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen,
+                                g_ipfrag_linegen, NSTAT_LINES);
+}
+
+#endif /* CONFIG_NET_IPFRAG */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_STATISTICS */
@@ -122,6 +122,14 @@ static const struct netprocfs_entry_s g_net_entries[] =
     }
   },
 #  endif
+#  ifdef CONFIG_NET_IPFRAG
+  {
+    DTYPE_FILE, "ipfrag",
+    {
+      netprocfs_read_ipfragstats
+    }
+  },
+#  endif
 #  ifdef NET_TCP_HAVE_STACK
   {
     DTYPE_FILE, "tcp",
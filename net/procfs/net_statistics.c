@@ -67,6 +67,9 @@ static int netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_TCP_RACK
+static int netprocfs_tcp_recovery(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_TCP_RACK */
 
 /****************************************************************************
  * Private Data
@@ -101,6 +104,10 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_TCP_RACK
+  , netprocfs_tcp_recovery
+#endif /* CONFIG_NET_TCP_RACK */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -423,6 +430,20 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_tcp_recovery
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP_RACK)
+static int netprocfs_tcp_recovery(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  Recovery   Lost: %04x  Rec: %04x  TLP: %04x\n",
+                  g_netstats.tcp.sackrexmit, g_netstats.tcp.recovery,
+                  g_netstats.tcp.tlp);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP_RACK */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
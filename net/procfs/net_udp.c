@@ -67,6 +67,7 @@ static ssize_t netprocfs_udpstats(FAR struct netprocfs_file_s *priv,
   int len = 0;
   FAR void *laddr;
   FAR void *raddr;
+  unsigned int rxq;
 
   net_lock();
 
@@ -92,6 +93,10 @@ static ssize_t netprocfs_udpstats(FAR struct netprocfs_file_s *priv,
       laddr = net_ip_binding_laddr(&conn->u, domain);
       raddr = net_ip_binding_raddr(&conn->u, domain);
 
+      conn_lock(&conn->sconn);
+      rxq = conn->readahead ? conn->readahead->io_pktlen : 0;
+      conn_unlock(&conn->sconn);
+
       len += snprintf(buffer + len, buflen - len,
                       "    %2" PRIu8
                       ": %3" PRIx8
@@ -104,7 +109,7 @@ static ssize_t netprocfs_udpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                       udp_wrbuffer_inqueue_size(conn),
 #endif
-                      (conn->readahead) ? conn->readahead->io_pktlen : 0);
+                      rxq);
 
       len += snprintf(buffer + len, buflen - len,
                       " %*s:%-6" PRIu16 " %*s:%-6" PRIu16 "\n",
@@ -167,6 +167,29 @@ ssize_t netprocfs_read_mldstats(FAR struct netprocfs_file_s *priv,
                                 FAR char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: netprocfs_read_ipfragstats
+ *
+ * Description:
+ *   Read and format IP fragment reassembly statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPFRAG)
+ssize_t netprocfs_read_ipfragstats(FAR struct netprocfs_file_s *priv,
+                                   FAR char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: netprocfs_read_tcpstats
  *
@@ -35,9 +35,11 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -87,6 +89,8 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   nwritten = net_writeroute_ipv4(&fshandle, &route);
 
   net_closeroute_ipv4(&fshandle);
+  net_trieroute_changed_ipv4();
+  ipfwd_flowcache_flush();
 
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
@@ -123,6 +127,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   nwritten = net_writeroute_ipv6(&fshandle, &route);
 
   net_closeroute_ipv6(&fshandle);
+  net_trieroute_changed_ipv6();
 
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET6);
   return nwritten >= 0 ? 0 : (int)nwritten;
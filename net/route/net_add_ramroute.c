@@ -36,9 +36,11 @@
 
 #include <arch/irq.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -88,6 +90,8 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+  net_trieroute_changed_ipv4();
+  ipfwd_flowcache_flush();
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
@@ -125,6 +129,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+  net_trieroute_changed_ipv6();
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET6);
@@ -38,10 +38,12 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -256,6 +258,9 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   net_flushcache_ipv4();
 #endif
 
+  net_trieroute_changed_ipv4();
+  ipfwd_flowcache_flush();
+
   /* Loop, copying each entry, to the previous entry thus removing the entry
    * to be deleted.
    */
@@ -409,6 +414,8 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   net_flushcache_ipv6();
 #endif
 
+  net_trieroute_changed_ipv6();
+
   /* Loop, copying each entry, to the previous entry thus removing the entry
    * to be deleted.
    */
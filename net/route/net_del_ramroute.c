@@ -34,9 +34,11 @@
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -118,6 +120,8 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
+      net_trieroute_changed_ipv4();
+      ipfwd_flowcache_flush();
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -176,6 +180,7 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
+      net_trieroute_changed_ipv6();
 
       /* Return a non-zero value to terminate the traversal */
 
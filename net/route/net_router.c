@@ -37,6 +37,7 @@
 #include "devif/devif.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 #include "utils/utils.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -283,7 +284,11 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_TRIE
+      ret = net_trieroute_ipv4(target, net_ipv4_match, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -377,7 +382,11 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_TRIE
+      ret = net_trieroute_ipv6(target, net_ipv6_match, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -0,0 +1,583 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/trieroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bit 'n' of an address, counted from the most significant bit of the
+ * first byte in network order.
+ */
+
+#define TRIE_BIT(a, n)   (((a)[(n) >> 3] >> (7 - ((n) & 7))) & 1)
+
+/* Node and route references are stored as index + 1, zero meaning none */
+
+#define TRIE_NODE(t, r)  (&(t)->nodes[(r) - 1])
+#define TRIE_ROUTE(t, r) ((t)->routes + ((r) - 1) * (t)->stride)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of the path-compressed prefix trie.  A node stands for the
+ * first 'len' bits of the target of route 'key'.  It carries the routes
+ * of exactly that prefix, if any, and up to two subtrees of longer
+ * prefixes, selected by bit 'len'.
+ */
+
+struct route_trie_node_s
+{
+  uint16_t child[2];           /* Subtrees, bit 'len' clear and set */
+  uint16_t route;              /* First route of this prefix */
+  uint16_t key;                /* Index of a route holding the prefix */
+  uint8_t  len;                /* Prefix length in bits */
+};
+
+/* The trie of one address family.  Route copies are kept in the trie so
+ * that a lookup neither walks nor reads the routing table itself, which
+ * may live in a file.  The target address is at the start of both route
+ * structures, followed by the netmask.
+ */
+
+struct route_trie_s
+{
+  FAR uint8_t *routes;         /* Route copies, 'stride' bytes each */
+  FAR struct route_trie_node_s *nodes;
+  FAR uint16_t *next;          /* Next route of the same prefix */
+  uint32_t gen;                /* Generation of the routing table */
+  uint32_t built;              /* Generation the trie was built for */
+  uint16_t nroutes;            /* Number of routes in the trie */
+  uint16_t nalloc;             /* Number of routes allocated for */
+  uint16_t nnodes;             /* Number of nodes in use */
+  uint16_t root;               /* Root node */
+  uint16_t stride;             /* Size of one route copy */
+  uint8_t  maxlen;             /* Address length in bits */
+  bool     linear;             /* The table must be traversed instead */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The generation starts at one so that the tries are built by the first
+ * lookup.
+ */
+
+#ifdef CONFIG_NET_IPv4
+static struct route_trie_s g_ipv4_trie =
+{
+  .gen    = 1,
+  .stride = sizeof(struct net_route_ipv4_s),
+  .maxlen = 32,
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct route_trie_s g_ipv6_trie =
+{
+  .gen    = 1,
+  .stride = sizeof(struct net_route_ipv6_s),
+  .maxlen = 128,
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_trieroute_common
+ *
+ * Description:
+ *   Return the number of leading bits, at most 'limit', that the
+ *   addresses 'a' and 'b' have in common.
+ *
+ ****************************************************************************/
+
+static unsigned int net_trieroute_common(FAR const uint8_t *a,
+                                         FAR const uint8_t *b,
+                                         unsigned int limit)
+{
+  unsigned int bits = 0;
+  uint8_t diff;
+
+  while (bits + 8 <= limit && a[bits >> 3] == b[bits >> 3])
+    {
+      bits += 8;
+    }
+
+  if (bits < limit)
+    {
+      diff = a[bits >> 3] ^ b[bits >> 3];
+      while (bits < limit && (diff & (0x80 >> (bits & 7))) == 0)
+        {
+          bits++;
+        }
+    }
+
+  return bits;
+}
+
+/****************************************************************************
+ * Name: net_trieroute_newnode
+ ****************************************************************************/
+
+static uint16_t net_trieroute_newnode(FAR struct route_trie_s *trie,
+                                      uint16_t key, uint8_t len,
+                                      uint16_t route)
+{
+  FAR struct route_trie_node_s *node = &trie->nodes[trie->nnodes++];
+
+  node->child[0] = 0;
+  node->child[1] = 0;
+  node->route    = route;
+  node->key      = key;
+  node->len      = len;
+  return trie->nnodes;
+}
+
+/****************************************************************************
+ * Name: net_trieroute_insert
+ *
+ * Description:
+ *   Insert the route copy 'index' with a prefix of 'len' bits.  Each
+ *   insertion adds at most two nodes, so twice as many nodes as routes
+ *   are always enough.
+ *
+ ****************************************************************************/
+
+static void net_trieroute_insert(FAR struct route_trie_s *trie,
+                                 uint16_t index, uint8_t len)
+{
+  FAR const uint8_t *key = TRIE_ROUTE(trie, index + 1);
+  FAR struct route_trie_node_s *node;
+  FAR const uint8_t *nkey;
+  FAR uint16_t *link = &trie->root;
+  FAR uint16_t *tail;
+  unsigned int common;
+  uint16_t split;
+
+  while (*link != 0)
+    {
+      node   = TRIE_NODE(trie, *link);
+      nkey   = TRIE_ROUTE(trie, node->key + 1);
+      common = net_trieroute_common(nkey, key, MIN(node->len, len));
+
+      if (common == node->len)
+        {
+          if (node->len == len)
+            {
+              /* Same prefix, append to the routes of this node */
+
+              tail = &node->route;
+              while (*tail != 0)
+                {
+                  tail = &trie->next[*tail - 1];
+                }
+
+              *tail = index + 1;
+              return;
+            }
+
+          /* The node prefix covers ours, descend */
+
+          link = &node->child[TRIE_BIT(key, node->len)];
+          continue;
+        }
+
+      /* The prefixes diverge inside the node.  If ours ends there it
+       * becomes the parent of the node, otherwise both hang off a new
+       * node for the common part.
+       */
+
+      if (common == len)
+        {
+          split = net_trieroute_newnode(trie, index, len, index + 1);
+        }
+      else
+        {
+          split = net_trieroute_newnode(trie, index, common, 0);
+          TRIE_NODE(trie, split)->child[TRIE_BIT(key, common)] =
+            net_trieroute_newnode(trie, index, len, index + 1);
+        }
+
+      TRIE_NODE(trie, split)->child[TRIE_BIT(nkey, common)] = *link;
+      *link = split;
+      return;
+    }
+
+  *link = net_trieroute_newnode(trie, index, len, index + 1);
+}
+
+/****************************************************************************
+ * Name: net_trieroute_add
+ *
+ * Description:
+ *   Copy one route into the trie being built.  The first pass, with no
+ *   storage allocated yet, only counts the routes.
+ *
+ ****************************************************************************/
+
+static void net_trieroute_add(FAR struct route_trie_s *trie,
+                              FAR const void *route, uint8_t len)
+{
+  if (trie->routes == NULL)
+    {
+      if (trie->nalloc < UINT16_MAX / 2)
+        {
+          trie->nalloc++;
+        }
+      else
+        {
+          trie->linear = true;
+        }
+    }
+  else if (trie->nroutes < trie->nalloc)
+    {
+      memcpy(TRIE_ROUTE(trie, trie->nroutes + 1), route, trie->stride);
+      trie->next[trie->nroutes] = 0;
+      net_trieroute_insert(trie, trie->nroutes, len);
+      trie->nroutes++;
+    }
+}
+
+/****************************************************************************
+ * Name: net_trieroute_reset
+ *
+ * Description:
+ *   Discard the current trie, ready for the counting pass.
+ *
+ ****************************************************************************/
+
+static void net_trieroute_reset(FAR struct route_trie_s *trie)
+{
+  kmm_free(trie->routes);
+
+  trie->routes  = NULL;
+  trie->nodes   = NULL;
+  trie->next    = NULL;
+  trie->nroutes = 0;
+  trie->nalloc  = 0;
+  trie->nnodes  = 0;
+  trie->root    = 0;
+  trie->linear  = false;
+  trie->built   = trie->gen;
+}
+
+/****************************************************************************
+ * Name: net_trieroute_alloc
+ *
+ * Description:
+ *   Allocate storage for the routes counted.  One block holds the route
+ *   copies, then the nodes and then the prefix chains, so that each part
+ *   stays suitably aligned.
+ *
+ * Returned Value:
+ *   true if the second, copying, pass should be run.
+ *
+ ****************************************************************************/
+
+static bool net_trieroute_alloc(FAR struct route_trie_s *trie)
+{
+  size_t nodeoff;
+  size_t nextoff;
+
+  if (trie->linear || trie->nalloc == 0)
+    {
+      return false;
+    }
+
+  nodeoff = ALIGN_UP(trie->nalloc * trie->stride, sizeof(uint32_t));
+  nextoff = nodeoff + 2 * trie->nalloc * sizeof(struct route_trie_node_s);
+
+  trie->routes = kmm_malloc(nextoff + trie->nalloc * sizeof(uint16_t));
+  if (trie->routes == NULL)
+    {
+      nerr("ERROR: No memory for %u routes, using the table\n",
+           trie->nalloc);
+      trie->linear = true;
+      return false;
+    }
+
+  trie->nodes = (FAR struct route_trie_node_s *)(trie->routes + nodeoff);
+  trie->next  = (FAR uint16_t *)(trie->routes + nextoff);
+  return true;
+}
+
+/****************************************************************************
+ * Name: net_trieroute_path
+ *
+ * Description:
+ *   Walk the trie towards 'target' and record the nodes that carry routes
+ *   covering it, shortest prefix first.
+ *
+ * Returned Value:
+ *   The number of nodes recorded in 'path', at most maxlen + 1.
+ *
+ ****************************************************************************/
+
+static unsigned int net_trieroute_path(FAR struct route_trie_s *trie,
+                                       FAR const uint8_t *target,
+                                       FAR uint16_t *path)
+{
+  FAR struct route_trie_node_s *node;
+  unsigned int depth = 0;
+  uint16_t ref = trie->root;
+
+  while (ref != 0)
+    {
+      node = TRIE_NODE(trie, ref);
+      if (net_trieroute_common(TRIE_ROUTE(trie, node->key + 1), target,
+                               node->len) < node->len)
+        {
+          break;
+        }
+
+      if (node->route != 0)
+        {
+          path[depth++] = ref;
+        }
+
+      if (node->len >= trie->maxlen)
+        {
+          break;
+        }
+
+      ref = node->child[TRIE_BIT(target, node->len)];
+    }
+
+  return depth;
+}
+
+/****************************************************************************
+ * Name: net_trieroute_addipv4 and net_trieroute_addipv6
+ *
+ * Description:
+ *   net_foreachroute_ipv4/6() callbacks used to build the trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int net_trieroute_addipv4(FAR struct net_route_ipv4_s *route,
+                                 FAR void *arg)
+{
+  FAR struct route_trie_s *trie = arg;
+  uint8_t len = net_ipv4_mask2pref(route->netmask);
+
+  if (route->netmask != (len == 0 ? 0 : HTONL(UINT32_MAX << (32 - len))))
+    {
+      trie->linear = true;
+      return 1;
+    }
+
+  net_trieroute_add(trie, route, len);
+  return 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int net_trieroute_addipv6(FAR struct net_route_ipv6_s *route,
+                                 FAR void *arg)
+{
+  FAR struct route_trie_s *trie = arg;
+  uint8_t len = net_ipv6_mask2pref(route->netmask);
+  net_ipv6addr_t mask;
+
+  net_ipv6_pref2mask(mask, len);
+  if (!net_ipv6addr_cmp(route->netmask, mask))
+    {
+      trie->linear = true;
+      return 1;
+    }
+
+  net_trieroute_add(trie, route, len);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_trieroute_changed_ipv4 and net_trieroute_changed_ipv6
+ *
+ * Description:
+ *   Note that the routing table was modified.  The prefix trie is rebuilt
+ *   from the table by the next lookup.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_trieroute_changed_ipv4(void)
+{
+  net_lock();
+  g_ipv4_trie.gen++;
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_trieroute_changed_ipv6(void)
+{
+  net_lock();
+  g_ipv6_trie.gen++;
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_ipv4 and net_trieroute_ipv6
+ *
+ * Description:
+ *   Visit the routes whose prefix covers 'target', longest prefix first,
+ *   until the handler returns a non-zero value.
+ *
+ * Input Parameters:
+ *   target  - The destination address, in network order
+ *   handler - Function to call for each matching route
+ *   arg     - Argument passed to the handler
+ *
+ * Returned Value:
+ *   The last non-zero value returned by the handler, or zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_trieroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                       FAR void *arg)
+{
+  FAR struct route_trie_s *trie = &g_ipv4_trie;
+  uint16_t path[32 + 1];
+  unsigned int depth;
+  uint16_t ref;
+  int ret = 0;
+
+  net_lock();
+
+  if (trie->built != trie->gen)
+    {
+      net_trieroute_reset(trie);
+      net_foreachroute_ipv4(net_trieroute_addipv4, trie);
+      if (net_trieroute_alloc(trie))
+        {
+          net_foreachroute_ipv4(net_trieroute_addipv4, trie);
+        }
+    }
+
+  if (trie->linear)
+    {
+      ret = net_foreachroute_ipv4(handler, arg);
+      net_unlock();
+      return ret;
+    }
+
+  depth = net_trieroute_path(trie, (FAR const uint8_t *)&target, path);
+  while (ret == 0 && depth-- > 0)
+    {
+      for (ref = TRIE_NODE(trie, path[depth])->route;
+           ref != 0 && ret == 0; ref = trie->next[ref - 1])
+        {
+          ret = handler((FAR struct net_route_ipv4_s *)
+                        TRIE_ROUTE(trie, ref), arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_trieroute_ipv6(const net_ipv6addr_t target,
+                       route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct route_trie_s *trie = &g_ipv6_trie;
+  uint16_t path[128 + 1];
+  unsigned int depth;
+  uint16_t ref;
+  int ret = 0;
+
+  net_lock();
+
+  if (trie->built != trie->gen)
+    {
+      net_trieroute_reset(trie);
+      net_foreachroute_ipv6(net_trieroute_addipv6, trie);
+      if (net_trieroute_alloc(trie))
+        {
+          net_foreachroute_ipv6(net_trieroute_addipv6, trie);
+        }
+    }
+
+  if (trie->linear)
+    {
+      ret = net_foreachroute_ipv6(handler, arg);
+      net_unlock();
+      return ret;
+    }
+
+  depth = net_trieroute_path(trie, (FAR const uint8_t *)target, path);
+  while (ret == 0 && depth-- > 0)
+    {
+      for (ref = TRIE_NODE(trie, path[depth])->route;
+           ref != 0 && ret == 0; ref = trie->next[ref - 1])
+        {
+          ret = handler((FAR struct net_route_ipv6_s *)
+                        TRIE_ROUTE(trie, ref), arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
@@ -36,6 +36,7 @@
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 #include "utils/utils.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -284,7 +285,11 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_TRIE
+      ret = net_trieroute_ipv4(target, net_ipv4_devmatch, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -371,7 +376,11 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_TRIE
+      ret = net_trieroute_ipv6(target, net_ipv6_devmatch, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
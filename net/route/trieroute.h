@@ -0,0 +1,106 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_ROUTE_TRIE
+#  define net_trieroute_changed_ipv4()
+#  define net_trieroute_changed_ipv6()
+#endif
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_trieroute_changed_ipv4 and net_trieroute_changed_ipv6
+ *
+ * Description:
+ *   Note that the routing table was modified.  The prefix trie is rebuilt
+ *   from the table by the next lookup.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_trieroute_changed_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_trieroute_changed_ipv6(void);
+#endif
+
+/****************************************************************************
+ * Name: net_trieroute_ipv4 and net_trieroute_ipv6
+ *
+ * Description:
+ *   Visit the routes whose prefix covers 'target', longest prefix first,
+ *   until the handler returns a non-zero value.  Routes of equal prefix
+ *   are visited in table order.  This replaces net_foreachroute_ipv4/6()
+ *   for lookups: routes that can not match 'target' are never visited.
+ *
+ *   If the table holds a non-contiguous netmask, or the trie could not be
+ *   allocated, the whole table is traversed with net_foreachroute_ipv4/6()
+ *   instead.
+ *
+ * Input Parameters:
+ *   target  - The destination address, in network order
+ *   handler - Function to call for each matching route
+ *   arg     - Argument passed to the handler
+ *
+ * Returned Value:
+ *   The last non-zero value returned by the handler, or zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_trieroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                       FAR void *arg);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_trieroute_ipv6(const net_ipv6addr_t target,
+                       route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
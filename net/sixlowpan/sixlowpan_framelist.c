@@ -765,4 +765,123 @@ int sixlowpan_queue_frames(FAR struct radio_driver_s *radio,
   return OK;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_mesh_forward
+ *
+ * Description:
+ *   Forward a received frame with a mesh header for another node towards
+ *   its final address.  The Hops Left field of the mesh header is
+ *   decremented and the frame is sent again as is, without decompressing
+ *   or reassembling it.
+ *
+ * Input Parameters:
+ *   radio   - The radio network driver instance
+ *   iob     - The received frame.  io_offset is the offset of the mesh
+ *             header.
+ *   nexthop - The MAC address of the next hop
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the frame was submitted to the MAC, which
+ *   then owns the IOB.  -ETIMEDOUT is returned if the hop limit of the
+ *   frame is exhausted.  Otherwise a negated errno value is returned.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_6LOWPAN_MESH
+int sixlowpan_mesh_forward(FAR struct radio_driver_s *radio,
+                           FAR struct iob_s *iob,
+                           FAR const struct netdev_varaddr_s *nexthop)
+{
+  union sixlowpan_metadata_u meta;
+  FAR uint8_t *mesh = iob->io_data + iob->io_offset;
+  uint16_t framelen = iob->io_len - iob->io_offset;
+  int hdrlen;
+  int ret = -ENOSYS;
+
+  /* Decrement the hop limit.  The frame is not forwarded any further once
+   * it is exhausted.
+   */
+
+  if ((mesh[0] & SIXLOWPAN_MESH_HOPSLEFT_MASK) ==
+      SIXLOWPAN_MESH_HOPSLEFT_DEEP)
+    {
+      if (mesh[1] <= 1)
+        {
+          return -ETIMEDOUT;
+        }
+
+      mesh[1]--;
+    }
+  else
+    {
+      if ((mesh[0] & SIXLOWPAN_MESH_HOPSLEFT_MASK) <= 1)
+        {
+          return -ETIMEDOUT;
+        }
+
+      mesh[0]--;
+    }
+
+  /* Get the metadata that describes the MAC header to the next hop */
+
+#ifdef CONFIG_WIRELESS_IEEE802154
+#ifdef CONFIG_WIRELESS_PKTRADIO
+  if (radio->r_dev.d_lltype == NET_LL_IEEE802154)
+#endif
+    {
+      ret = sixlowpan_ieee802154_metadata(radio, nexthop, &meta);
+    }
+#endif
+#ifdef CONFIG_WIRELESS_PKTRADIO
+#ifdef CONFIG_WIRELESS_IEEE802154
+  else
+#endif
+    {
+      ret = sixlowpan_pktradio_metadata(radio, nexthop, &meta);
+    }
+#endif
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hdrlen = sixlowpan_frame_hdrlen(radio, &meta);
+  if (hdrlen < 0)
+    {
+      nerr("ERROR: sixlowpan_frame_hdrlen() failed: %d\n", hdrlen);
+      return hdrlen;
+    }
+
+  if (hdrlen + framelen > CONFIG_IOB_BUFSIZE)
+    {
+      return -E2BIG;
+    }
+
+  /* Move the mesh header and everything that follows it behind the new MAC
+   * header and send the frame again.
+   */
+
+  memmove(iob->io_data + hdrlen, mesh, framelen);
+
+  iob->io_flink  = NULL;
+  iob->io_offset = hdrlen;
+  iob->io_len    = hdrlen + framelen;
+  iob->io_pktlen = iob->io_len;
+
+  ninfo("Forwarding mesh frame length=%u\n", iob->io_len);
+
+  ret = sixlowpan_frame_submit(radio, &meta, iob);
+  if (ret < 0)
+    {
+      nerr("ERROR: sixlowpan_frame_submit() failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif /* CONFIG_NET_6LOWPAN_MESH */
+
 #endif /* CONFIG_NET_6LOWPAN */
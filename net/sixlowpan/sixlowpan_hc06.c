@@ -101,6 +101,24 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+/* The compressed source and destination address fields of a flow.  These
+ * depend only on the IPv6 addresses, the MAC addresses and the address
+ * contexts, so they can be reused by all packets of the flow.
+ */
+
+struct sixlowpan_hc06flow_s
+{
+  net_ipv6addr_t fl_srcipaddr;        /* Source IPv6 address */
+  net_ipv6addr_t fl_destipaddr;       /* Destination IPv6 address */
+  struct netdev_varaddr_s fl_srcmac;  /* Local MAC address */
+  struct netdev_varaddr_s fl_destmac; /* Destination MAC address */
+  bool    fl_valid;                   /* The cache entry is in use */
+  uint8_t fl_iphc1;                   /* CID, SAC, SAM, M, DAC and DAM bits */
+  uint8_t fl_ctx;                     /* [ SCI | DCI ] if CID is set */
+  uint8_t fl_addrlen;                 /* Number of inline address bytes */
+  uint8_t fl_addr[32];                /* Inline address bytes */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -124,6 +142,13 @@ static struct sixlowpan_addrcontext_s
 
 static FAR uint8_t *g_hc06ptr;
 
+#if CONFIG_NET_6LOWPAN_HC06_FLOWCACHE > 0
+/* Cache of the compressed address fields of the most recent flows */
+
+static struct sixlowpan_hc06flow_s
+  g_hc06_flows[CONFIG_NET_6LOWPAN_HC06_FLOWCACHE];
+#endif
+
 /* Constant Data ************************************************************/
 
 /* Uncompression of linklocal
@@ -416,6 +441,264 @@ static uint8_t compress_laddr(FAR const net_ipv6addr_t srcipaddr,
   return tag;
 }
 
+/****************************************************************************
+ * Name: hc06_compress_addrs
+ *
+ * Description:
+ *   Compress the source and destination addresses of a packet into the
+ *   address fields of a flow.
+ *
+ * Input Parameters:
+ *   radio   - A reference to a radio network device instance
+ *   ipv6    - The IPv6 header to be compressed
+ *   destmac - L2 destination address, needed to compress the IP
+ *             destination field
+ *   flow    - The flow to hold the compressed address fields
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void hc06_compress_addrs(FAR struct radio_driver_s *radio,
+                                FAR const struct ipv6_hdr_s *ipv6,
+                                FAR const struct netdev_varaddr_s *destmac,
+                                FAR struct sixlowpan_hc06flow_s *flow)
+{
+  FAR struct sixlowpan_addrcontext_s *saddrcontext;
+  FAR struct sixlowpan_addrcontext_s *daddrcontext;
+  FAR uint8_t *hc06ptr = g_hc06ptr;
+  uint8_t iphc1 = 0;
+  uint8_t ctx = 0;
+
+  /* The inline address fields are written to the flow */
+
+  g_hc06ptr = flow->fl_addr;
+
+  /* Check if dest address context exists (for allocating third byte) */
+
+  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+  saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
+
+  if (daddrcontext != NULL || saddrcontext != NULL)
+    {
+      iphc1 |= SIXLOWPAN_IPHC_CID;
+    }
+
+  /* Source address - cannot be multicast */
+
+  if (net_is_addr_unspecified(ipv6->srcipaddr))
+    {
+      ninfo("Compressing unspecified srcipaddr.  Setting SAC\n");
+
+      iphc1 |= SIXLOWPAN_IPHC_SAC;
+      iphc1 |= SIXLOWPAN_IPHC_SAM_128;
+    }
+  else if (saddrcontext != NULL)
+    {
+      /* Elide the prefix - indicate by CID and set address context + SAC */
+
+      ninfo("Compressing src with address context."
+            " Setting SAC. Context: %d\n",
+            saddrcontext->number);
+
+      iphc1 |= SIXLOWPAN_IPHC_SAC;
+      ctx   |= saddrcontext->number << 4;
+
+      /* Compression compare with this nodes address (source) */
+
+      iphc1 |= compress_laddr(ipv6->srcipaddr,
+                              &radio->r_dev.d_mac.radio,
+                              SIXLOWPAN_IPHC_SAM_BIT);
+    }
+
+  /* No address context found for the source address */
+
+  else if (net_is_addr_linklocal(ipv6->srcipaddr) &&
+           ipv6->srcipaddr[1] == 0 &&  ipv6->srcipaddr[2] == 0 &&
+           ipv6->srcipaddr[3] == 0)
+    {
+      iphc1 |= compress_laddr(ipv6->srcipaddr,
+                              &radio->r_dev.d_mac.radio,
+                              SIXLOWPAN_IPHC_SAM_BIT);
+    }
+  else
+    {
+      /* Send the full source address ipaddr:  SAC = 0, SAM = 00 */
+
+      ninfo("Uncompressable "
+            "srcipaddr=%04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
+            NTOHS(ipv6->srcipaddr[0]), NTOHS(ipv6->srcipaddr[1]),
+            NTOHS(ipv6->srcipaddr[2]), NTOHS(ipv6->srcipaddr[3]),
+            NTOHS(ipv6->srcipaddr[4]), NTOHS(ipv6->srcipaddr[5]),
+            NTOHS(ipv6->srcipaddr[6]), NTOHS(ipv6->srcipaddr[7]));
+
+      iphc1 |= SIXLOWPAN_IPHC_SAM_128;   /* 128-bits */
+      memcpy(g_hc06ptr, ipv6->srcipaddr, 16);
+      g_hc06ptr += 16;
+    }
+
+  /* Destination address */
+
+  if (net_is_addr_mcast(ipv6->destipaddr))
+    {
+      /* Address is multicast, try to compress */
+
+      iphc1 |= SIXLOWPAN_IPHC_M;
+      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
+        {
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
+
+          /* Use "last" byte ("last" meaning the LS byte in host order.
+           * destipaddr is in big-endian network order).
+           */
+
+#ifdef CONFIG_ENDIAN_BIG
+          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
+#else
+          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
+#endif
+          g_hc06ptr += 1;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
+
+          /* Second byte + the last three */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[13], 3);
+          g_hc06ptr += 4;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
+
+          /* Second byte + the last five */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[11], 5);
+          g_hc06ptr += 6;
+        }
+      else
+        {
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
+
+          /* Full address */
+
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+  else
+    {
+      /* Address is unicast, try to compress */
+
+      if (daddrcontext != NULL)
+        {
+          /* Elide the prefix */
+
+          ninfo("Compressing dest with address context. "
+                "Setting DAC. Context: %d\n",
+                daddrcontext->number);
+
+          iphc1 |= SIXLOWPAN_IPHC_DAC;
+          ctx   |= daddrcontext->number;
+
+          /* Compession compare with link address (destination) */
+
+          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                    SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* No address context found for this address */
+
+      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
+               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
+               ipv6->destipaddr[3] == 0)
+        {
+          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                    SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* Send the full address */
+
+      else
+        {
+          iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+
+  net_ipv6addr_copy(flow->fl_srcipaddr, ipv6->srcipaddr);
+  net_ipv6addr_copy(flow->fl_destipaddr, ipv6->destipaddr);
+  memcpy(&flow->fl_srcmac, &radio->r_dev.d_mac.radio,
+         sizeof(struct netdev_varaddr_s));
+  memcpy(&flow->fl_destmac, destmac, sizeof(struct netdev_varaddr_s));
+
+  flow->fl_iphc1   = iphc1;
+  flow->fl_ctx     = ctx;
+  flow->fl_addrlen = g_hc06ptr - flow->fl_addr;
+  flow->fl_valid   = true;
+
+  g_hc06ptr = hc06ptr;
+}
+
+/****************************************************************************
+ * Name: hc06_lookup_flow
+ *
+ * Description:
+ *   Find the compressed address fields of the flow of a packet in the flow
+ *   cache.  On a miss, the addresses are compressed into the cache entry
+ *   of the flow, replacing the flow that was cached there.
+ *
+ * Input Parameters:
+ *   radio   - A reference to a radio network device instance
+ *   ipv6    - The IPv6 header to be compressed
+ *   destmac - L2 destination address
+ *
+ * Returned Value:
+ *   The flow holding the compressed address fields.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_6LOWPAN_HC06_FLOWCACHE > 0
+static FAR struct sixlowpan_hc06flow_s *
+  hc06_lookup_flow(FAR struct radio_driver_s *radio,
+                   FAR const struct ipv6_hdr_s *ipv6,
+                   FAR const struct netdev_varaddr_s *destmac)
+{
+  FAR const struct netdev_varaddr_s *srcmac = &radio->r_dev.d_mac.radio;
+  FAR struct sixlowpan_hc06flow_s *flow;
+  uint32_t key;
+
+  key  = ((uint32_t)ipv6->srcipaddr[6] << 16 | ipv6->srcipaddr[7]) ^
+         ((uint32_t)ipv6->destipaddr[6] << 16 | ipv6->destipaddr[7]);
+  flow = &g_hc06_flows[key % CONFIG_NET_6LOWPAN_HC06_FLOWCACHE];
+
+  if (flow->fl_valid &&
+      net_ipv6addr_cmp(flow->fl_destipaddr, ipv6->destipaddr) &&
+      net_ipv6addr_cmp(flow->fl_srcipaddr, ipv6->srcipaddr) &&
+      flow->fl_destmac.nv_addrlen == destmac->nv_addrlen &&
+      memcmp(flow->fl_destmac.nv_addr, destmac->nv_addr,
+             destmac->nv_addrlen) == 0 &&
+      flow->fl_srcmac.nv_addrlen == srcmac->nv_addrlen &&
+      memcmp(flow->fl_srcmac.nv_addr, srcmac->nv_addr,
+             srcmac->nv_addrlen) == 0)
+    {
+      return flow;
+    }
+
+  hc06_compress_addrs(radio, ipv6, destmac, flow);
+  return flow;
+}
+#endif
+
 /****************************************************************************
  * Name: uncompress_addr
  *
@@ -744,8 +1027,10 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
                                FAR uint8_t *fptr)
 {
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
-  FAR struct sixlowpan_addrcontext_s *saddrcontext;
-  FAR struct sixlowpan_addrcontext_s *daddrcontext;
+  FAR struct sixlowpan_hc06flow_s *flow;
+#if CONFIG_NET_6LOWPAN_HC06_FLOWCACHE == 0
+  struct sixlowpan_hc06flow_s flowbuf;
+#endif
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -771,17 +1056,24 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
    * byte with [ SCI | DCI ]
    */
 
-  /* Check if dest address context exists (for allocating third byte) */
+  /* Get the compressed addresses of the flow (for allocating third
+   * byte)
+   */
 
-  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
-  saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
+#if CONFIG_NET_6LOWPAN_HC06_FLOWCACHE > 0
+  flow = hc06_lookup_flow(radio, ipv6, destmac);
+#else
+  flow = &flowbuf;
+  hc06_compress_addrs(radio, ipv6, destmac, flow);
+#endif
 
-  if (daddrcontext != NULL || saddrcontext != NULL)
+  if ((flow->fl_iphc1 & SIXLOWPAN_IPHC_CID) != 0)
     {
       /* set address context flag and increase g_hc06ptr */
 
       ninfo("Compressing dest or src ipaddr. Setting CID\n");
-      iphc1 |= SIXLOWPAN_IPHC_CID;
+      iphc1  |= SIXLOWPAN_IPHC_CID;
+      iphc[2] = flow->fl_ctx;
       g_hc06ptr++;
     }
 
@@ -888,155 +1180,11 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
       break;
     }
 
-  /* Source address - cannot be multicast */
-
-  if (net_is_addr_unspecified(ipv6->srcipaddr))
-    {
-      ninfo("Compressing unspecified srcipaddr.  Setting SAC\n");
-
-      iphc1 |= SIXLOWPAN_IPHC_SAC;
-      iphc1 |= SIXLOWPAN_IPHC_SAM_128;
-    }
-  else if (saddrcontext != NULL)
-    {
-      /* Elide the prefix - indicate by CID and set address context + SAC */
-
-      ninfo("Compressing src with address context."
-            " Setting SAC. Context: %d\n",
-            saddrcontext->number);
-
-      iphc1   |= SIXLOWPAN_IPHC_SAC;
-      iphc[2] |= saddrcontext->number << 4;
-
-      /* Compression compare with this nodes address (source) */
-
-      iphc1   |= compress_laddr(ipv6->srcipaddr,
-                                &radio->r_dev.d_mac.radio,
-                                SIXLOWPAN_IPHC_SAM_BIT);
-    }
-
-  /* No address context found for the source address */
-
-  else if (net_is_addr_linklocal(ipv6->srcipaddr) &&
-           ipv6->srcipaddr[1] == 0 &&  ipv6->srcipaddr[2] == 0 &&
-           ipv6->srcipaddr[3] == 0)
-    {
-      iphc1   |= compress_laddr(ipv6->srcipaddr,
-                                &radio->r_dev.d_mac.radio,
-                                SIXLOWPAN_IPHC_SAM_BIT);
-    }
-  else
-    {
-      /* Send the full source address ipaddr:  SAC = 0, SAM = 00 */
-
-      ninfo("Uncompressable "
-            "srcipaddr=%04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
-            NTOHS(ipv6->srcipaddr[0]), NTOHS(ipv6->srcipaddr[1]),
-            NTOHS(ipv6->srcipaddr[2]), NTOHS(ipv6->srcipaddr[3]),
-            NTOHS(ipv6->srcipaddr[4]), NTOHS(ipv6->srcipaddr[5]),
-            NTOHS(ipv6->srcipaddr[6]), NTOHS(ipv6->srcipaddr[7]));
-
-      iphc1 |= SIXLOWPAN_IPHC_SAM_128;   /* 128-bits */
-      memcpy(g_hc06ptr, ipv6->srcipaddr, 16);
-      g_hc06ptr += 16;
-    }
-
-  /* Destination address */
+  /* Addresses were compressed at the beginning */
 
-  if (net_is_addr_mcast(ipv6->destipaddr))
-    {
-      /* Address is multicast, try to compress */
-
-      iphc1 |= SIXLOWPAN_IPHC_M;
-      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
-
-          /* Use "last" byte ("last" meaning the LS byte in host order.
-           * destipaddr is in big-endian network order).
-           */
-
-#ifdef CONFIG_ENDIAN_BIG
-          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
-#else
-          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
-#endif
-          g_hc06ptr += 1;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
-
-          /* Second byte + the last three */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[13], 3);
-          g_hc06ptr += 4;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
-
-          /* Second byte + the last five */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[11], 5);
-          g_hc06ptr += 6;
-        }
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
-
-          /* Full address */
-
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
-    }
-  else
-    {
-      /* Address is unicast, try to compress */
-
-      if (daddrcontext != NULL)
-        {
-          /* Elide the prefix */
-
-          ninfo("Compressing dest with address context. "
-                "Setting DAC. Context: %d\n",
-                daddrcontext->number);
-
-          iphc1   |= SIXLOWPAN_IPHC_DAC;
-          iphc[2] |= daddrcontext->number;
-
-          /* Compession compare with link address (destination) */
-
-          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                      SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* No address context found for this address */
-
-      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
-               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
-               ipv6->destipaddr[3] == 0)
-        {
-          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                    SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* Send the full address */
-
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
-    }
+  memcpy(g_hc06ptr, flow->fl_addr, flow->fl_addrlen);
+  g_hc06ptr += flow->fl_addrlen;
+  iphc1     |= flow->fl_iphc1;
 
   g_uncomp_hdrlen = IPv6_HDRLEN;
 
@@ -78,8 +78,9 @@
 
 /* Success return values from sixlowpan_frame_process */
 
-#define INPUT_PARTIAL  0 /* Frame processed successful, packet incomplete */
-#define INPUT_COMPLETE 1 /* Frame processed successful, packet complete */
+#define INPUT_PARTIAL   0 /* Frame processed successful, packet incomplete */
+#define INPUT_COMPLETE  1 /* Frame processed successful, packet complete */
+#define INPUT_FORWARDED 2 /* Frame forwarded to another node, IOB consumed */
 
 /* This is the size of a buffer large enough to hold the largest uncompressed
  * HC06 or HC1 headers.
@@ -240,6 +241,61 @@ static uint16_t sixlowpan_uncompress_ipv6proto(FAR uint8_t *fptr,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_mesh_header
+ *
+ * Description:
+ *   Parse the mesh addressing header (RFC 4944, section 5.2) at the
+ *   beginning of the 6LoWPAN payload of a frame.
+ *
+ * Input Parameters:
+ *   mesh    - The beginning of the mesh header
+ *   len     - The number of bytes that remain in the frame
+ *   origin  - Location to return the originator address
+ *   final   - Location to return the final destination address
+ *
+ * Returned Value:
+ *   The length of the mesh header on success; a negated errno value if the
+ *   header is truncated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_6LOWPAN_MESH
+static int sixlowpan_mesh_header(FAR const uint8_t *mesh, uint16_t len,
+                                 FAR struct netdev_varaddr_s *origin,
+                                 FAR struct netdev_varaddr_s *final)
+{
+  int meshlen = 1;
+
+  memset(origin, 0, sizeof(struct netdev_varaddr_s));
+  memset(final, 0, sizeof(struct netdev_varaddr_s));
+
+  if ((mesh[0] & SIXLOWPAN_MESH_HOPSLEFT_MASK) ==
+      SIXLOWPAN_MESH_HOPSLEFT_DEEP)
+    {
+      meshlen++;
+    }
+
+  origin->nv_addrlen = (mesh[0] & SIXLOWPAN_MESH_V) != 0 ?
+                       NET_6LOWPAN_SADDRSIZE : NET_6LOWPAN_EADDRSIZE;
+  final->nv_addrlen  = (mesh[0] & SIXLOWPAN_MESH_F) != 0 ?
+                       NET_6LOWPAN_SADDRSIZE : NET_6LOWPAN_EADDRSIZE;
+
+  if (meshlen + origin->nv_addrlen + final->nv_addrlen > len)
+    {
+      nwarn("WARNING: Truncated mesh header\n");
+      return -EINVAL;
+    }
+
+  memcpy(origin->nv_addr, &mesh[meshlen], origin->nv_addrlen);
+  meshlen += origin->nv_addrlen;
+  memcpy(final->nv_addr, &mesh[meshlen], final->nv_addrlen);
+  meshlen += final->nv_addrlen;
+
+  return meshlen;
+}
+#endif
+
 /****************************************************************************
  * Name: sixlowpan_frame_process
  *
@@ -280,6 +336,10 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   struct netdev_varaddr_s fragsrc;
+#ifdef CONFIG_NET_6LOWPAN_MESH
+  struct netdev_varaddr_s meshsrc;
+  bool ismesh        = false; /* true: Frame has a mesh header for us */
+#endif
   FAR uint8_t *fptr;          /* Convenience pointer to beginning of the frame */
   FAR uint8_t *bptr;          /* Used to redirect uncompressed header to the bitbucket */
   FAR uint8_t *hc1;           /* Convenience pointer to HC1 data */
@@ -311,12 +371,52 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
   g_uncomp_hdrlen = 0;
   g_frame_hdrlen  = hdrsize;
 
-  /* Since we don't support the mesh and broadcast header, the first header
-   * we look for is the fragmentation header.  NOTE that g_frame_hdrlen
-   * already includes the fragmentation header, if presetn.
+  fragptr = fptr + hdrsize;
+
+#ifdef CONFIG_NET_6LOWPAN_MESH
+  /* A mesh header comes first.  A frame for another node is forwarded as
+   * is, without decompressing or reassembling it.  For a frame that
+   * reached its final destination the originator, not the last hop, is
+   * the source of the fragments.
+   */
+
+  if ((fragptr[0] & SIXLOWPAN_DISPATCH_MESH_MASK) == SIXLOWPAN_DISPATCH_MESH)
+    {
+      struct netdev_varaddr_s final;
+      int meshlen;
+
+      meshlen = sixlowpan_mesh_header(fragptr, iob->io_len - hdrsize,
+                                      &meshsrc, &final);
+      if (meshlen < 0)
+        {
+          return meshlen;
+        }
+
+      if (final.nv_addrlen != radio->r_dev.d_mac.radio.nv_addrlen ||
+          memcmp(final.nv_addr, radio->r_dev.d_mac.radio.nv_addr,
+                 final.nv_addrlen) != 0)
+        {
+          ret = sixlowpan_mesh_forward(radio, iob, &final);
+          if (ret == -ETIMEDOUT)
+            {
+              nwarn("WARNING: Dropping mesh frame, hop limit exhausted\n");
+              return INPUT_PARTIAL;
+            }
+
+          return ret < 0 ? ret : INPUT_FORWARDED;
+        }
+
+      g_frame_hdrlen += meshlen;
+      fragptr        += meshlen;
+      ismesh          = true;
+    }
+#endif
+
+  /* Since we don't support the broadcast header, the next header we look
+   * for is the fragmentation header.  NOTE that g_frame_hdrlen already
+   * includes the fragmentation header, if presetn.
    */
 
-  fragptr = fptr + hdrsize;
   switch ((GETUINT16(fragptr, SIXLOWPAN_FRAG_DISPATCH_SIZE) & 0xf800) >> 8)
     {
     /* First fragment of new reassembly */
@@ -358,6 +458,13 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
             return ret;
           }
 
+#ifdef CONFIG_NET_6LOWPAN_MESH
+        if (ismesh)
+          {
+            fragsrc = meshsrc;
+          }
+#endif
+
         /* Allocate a new reassembly buffer */
 
         reass = sixlowpan_reass_allocate(fragtag, &fragsrc);
@@ -397,6 +504,13 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
             return ret;
           }
 
+#ifdef CONFIG_NET_6LOWPAN_MESH
+        if (ismesh)
+          {
+            fragsrc = meshsrc;
+          }
+#endif
+
         /* Find the existing reassembly buffer
          * with the same tag and source address
          */
@@ -766,7 +880,7 @@ int sixlowpan_input(FAR struct radio_driver_s *radio,
        * receiver wants it.
        */
 
-      if (ret >= 0)
+      if (ret >= 0 && ret != INPUT_FORWARDED)
         {
           iob_free(iob);
         }
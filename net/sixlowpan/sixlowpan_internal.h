@@ -399,6 +399,37 @@ int sixlowpan_queue_frames(FAR struct radio_driver_s *radio,
                            FAR const void *buf,  size_t buflen,
                            FAR const struct netdev_varaddr_s *destmac);
 
+/****************************************************************************
+ * Name: sixlowpan_mesh_forward
+ *
+ * Description:
+ *   Forward a received frame with a mesh header for another node towards
+ *   its final address.  The Hops Left field of the mesh header is
+ *   decremented and the frame is sent again as is, without decompressing
+ *   or reassembling it.
+ *
+ * Input Parameters:
+ *   radio   - The radio network driver instance
+ *   iob     - The received frame.  io_offset is the offset of the mesh
+ *             header.
+ *   nexthop - The MAC address of the next hop
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the frame was submitted to the MAC, which
+ *   then owns the IOB.  -ETIMEDOUT is returned if the hop limit of the
+ *   frame is exhausted.  Otherwise a negated errno value is returned.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_6LOWPAN_MESH
+int sixlowpan_mesh_forward(FAR struct radio_driver_s *radio,
+                           FAR struct iob_s *iob,
+                           FAR const struct netdev_varaddr_s *nexthop);
+#endif
+
 /****************************************************************************
  * Name: sixlowpan_hc06_initialize
  *
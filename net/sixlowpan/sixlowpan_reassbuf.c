@@ -33,6 +33,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
 
@@ -57,9 +58,14 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* The active, allocated reassembly buffers.  They are found by the
+ * reassembly tag and the fragment source in g_reass_hash.  g_active_reass
+ * holds them in the order in which the reassemblies were started so that
+ * only the expired buffers need to be visited.
+ */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static DECLARE_HASHTABLE(g_reass_hash, CONFIG_NET_6LOWPAN_REASS_HASH_BITS);
+static dq_queue_t g_active_reass;
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -67,9 +73,39 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sixlowpan_reass_key
+ *
+ * Description:
+ *   Get the hash key of a reassembly from its tag and fragment source.
+ *
+ * Input Parameters:
+ *   reasstag - The reassembly tag.
+ *   fragsrc  - The source address of the fragment.
+ *
+ * Returned Value:
+ *   The hash key.
+ *
  ****************************************************************************/
 
+static uint32_t
+sixlowpan_reass_key(uint16_t reasstag,
+                    FAR const struct netdev_varaddr_s *fragsrc)
+{
+  uint32_t key = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      key = (key << 5) + key + fragsrc->nv_addr[i];
+    }
+
+  return key;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -122,16 +158,20 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
 static void sixlowpan_reass_expire(void)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
-  FAR struct sixlowpan_reassbuf_s *next;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
   clock_t elapsed;
 
-  /* If reassembly timed out, cancel it */
+  /* The buffers are in the order in which the reassemblies were started,
+   * so stop at the first one that is still active and has not timed out.
+   */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (entry = dq_peek(&g_active_reass); entry != NULL; entry = next)
     {
       /* Needed if 'reass' is freed */
 
-      next = reass->rb_flink;
+      next  = dq_next(entry);
+      reass = container_of(entry, struct sixlowpan_reassbuf_s, rb_tnode);
 
       /* Free any inactive reassembly buffers.  This is done because the life
        * the reassembly buffer is not cerain.
@@ -140,21 +180,22 @@ static void sixlowpan_reass_expire(void)
       if (!reass->rb_active)
         {
           sixlowpan_reass_free(reass);
+          continue;
         }
-      else
-        {
-          /* Get the elpased time of the reassembly */
 
-          elapsed = clock_systime_ticks() - reass->rb_time;
+      /* Get the elpased time of the reassembly */
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+      elapsed = clock_systime_ticks() - reass->rb_time;
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
-            {
-              nwarn("WARNING: Reassembly timed out\n");
-              sixlowpan_reass_free(reass);
-            }
+      /* If the reassembly has expired, then free the reassembly buffer */
+
+      if (elapsed < NET_6LOWPAN_TIMEOUT)
+        {
+          break;
         }
+
+      nwarn("WARNING: Reassembly timed out\n");
+      sixlowpan_reass_free(reass);
     }
 }
 
@@ -177,31 +218,16 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
-  FAR struct sixlowpan_reassbuf_s *curr;
-  FAR struct sixlowpan_reassbuf_s *prev;
-
-  /* Find the reassembly buffer in the list of active reassembly buffers */
-
-  for (prev = NULL, curr = g_active_reass;
-       curr != NULL && curr != reass;
-       prev = curr, curr = curr->rb_flink)
-    {
-    }
-
-  /* Did we find it? */
+  /* Only the pre-allocated and the dynamically allocated buffers are ever
+   * added to the active reassembly buffers.
+   */
 
-  if (curr != NULL)
+  if (reass->rb_pool != REASS_POOL_RADIO)
     {
-      /* Yes.. remove it from the active reassembly buffer list */
-
-      if (prev == NULL)
-        {
-          g_active_reass = reass->rb_flink;
-        }
-      else
-        {
-          prev->rb_flink = reass->rb_flink;
-        }
+      hashtable_delete(g_reass_hash, &reass->rb_hnode,
+                       sixlowpan_reass_key(reass->rb_reasstag,
+                                           &reass->rb_fragsrc));
+      dq_rem(&reass->rb_tnode, &g_active_reass);
     }
 
   reass->rb_flink = NULL;
@@ -234,6 +260,9 @@ void sixlowpan_reass_initialize(void)
   FAR struct sixlowpan_reassbuf_s *reass;
   int i;
 
+  hashtable_init(g_reass_hash);
+  dq_init(&g_active_reass);
+
   /* Initialize g_free_reass, the list of reassembly buffer structures that
    * are available for allocation.
    */
@@ -326,10 +355,13 @@ FAR struct sixlowpan_reassbuf_s *
       reass->rb_reasstag = reasstag;
       reass->rb_time     = clock_systime_ticks();
 
-      /* Add the reassembly buffer to the list of active reassembly buffers */
+      /* Add the reassembly buffer to the active reassembly buffers.  The
+       * newest reassembly goes to the tail of the time ordered list.
+       */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      hashtable_add(g_reass_hash, &reass->rb_hnode,
+                    sixlowpan_reass_key(reasstag, fragsrc));
+      dq_addlast(&reass->rb_tnode, &g_active_reass);
     }
 
   return reass;
@@ -359,6 +391,7 @@ FAR struct sixlowpan_reassbuf_s *
                        FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  FAR dq_entry_t *entry;
 
   /* First, removed any expired or inactive reassembly buffers (we don't want
    * to return old reassembly buffer with the same tag)
@@ -367,11 +400,14 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_expire();
 
   /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+   * reassembly buffers that hash to the same bucket.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  hashtable_for_every_possible(g_reass_hash, entry,
+                               sixlowpan_reass_key(reasstag, fragsrc))
     {
+      reass = container_of(entry, struct sixlowpan_reassbuf_s, rb_hnode);
+
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
        * reassembly tag).
@@ -142,6 +142,20 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_BUSY_POLL
+      case SO_BUSY_POLL:  /* Busy-poll time of a blocking receive */
+        {
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = conn->s_busypoll;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       /* The following options take a point to an integer boolean value.
        * We will blindly report the bit here although the implementation
        * is outside of the scope of getsockopt.
@@ -154,8 +168,12 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                            * periodic transmission of probes */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Allow several listeners on one port */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:  /* Generates a timestamp for each incoming packet */
+#endif
+#ifdef CONFIG_NET_ZEROCOPY
+      case SO_ZEROCOPY:   /* Enables MSG_ZEROCOPY transmission */
 #endif
         {
           sockopt_t optionset;
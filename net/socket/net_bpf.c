@@ -0,0 +1,585 @@
+/****************************************************************************
+ * net/socket/net_bpf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <net/bpf.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET_BPF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SIZEOF_BPF_PROG(n) \
+  (offsetof(struct bpf_prog_s, insns) + (n) * sizeof(struct sock_filter))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sock_bpf_check
+ *
+ * Description:
+ *   Verify that a program can be run safely:  every opcode is known, every
+ *   jump goes forward and lands inside the program, scratch memory indices
+ *   are in range and the program ends with a return.  Since there are no
+ *   backward jumps, a verified program always terminates.
+ *
+ ****************************************************************************/
+
+static int sock_bpf_check(FAR const struct sock_filter *insns, int len)
+{
+  int pc;
+
+  if (len <= 0 || len > BPF_MAXINSNS)
+    {
+      return -EINVAL;
+    }
+
+  for (pc = 0; pc < len; pc++)
+    {
+      FAR const struct sock_filter *insn = &insns[pc];
+      int remain = len - pc - 1;
+
+      switch (insn->code)
+        {
+          case BPF_LD | BPF_W | BPF_ABS:
+          case BPF_LD | BPF_H | BPF_ABS:
+          case BPF_LD | BPF_B | BPF_ABS:
+          case BPF_LD | BPF_W | BPF_IND:
+          case BPF_LD | BPF_H | BPF_IND:
+          case BPF_LD | BPF_B | BPF_IND:
+          case BPF_LD | BPF_W | BPF_LEN:
+          case BPF_LD | BPF_IMM:
+          case BPF_LDX | BPF_W | BPF_IMM:
+          case BPF_LDX | BPF_W | BPF_LEN:
+          case BPF_LDX | BPF_B | BPF_MSH:
+          case BPF_ALU | BPF_ADD | BPF_K:
+          case BPF_ALU | BPF_ADD | BPF_X:
+          case BPF_ALU | BPF_SUB | BPF_K:
+          case BPF_ALU | BPF_SUB | BPF_X:
+          case BPF_ALU | BPF_MUL | BPF_K:
+          case BPF_ALU | BPF_MUL | BPF_X:
+          case BPF_ALU | BPF_DIV | BPF_X:
+          case BPF_ALU | BPF_MOD | BPF_X:
+          case BPF_ALU | BPF_OR | BPF_K:
+          case BPF_ALU | BPF_OR | BPF_X:
+          case BPF_ALU | BPF_AND | BPF_K:
+          case BPF_ALU | BPF_AND | BPF_X:
+          case BPF_ALU | BPF_XOR | BPF_K:
+          case BPF_ALU | BPF_XOR | BPF_X:
+          case BPF_ALU | BPF_LSH | BPF_X:
+          case BPF_ALU | BPF_RSH | BPF_X:
+          case BPF_ALU | BPF_NEG:
+          case BPF_RET | BPF_K:
+          case BPF_RET | BPF_A:
+          case BPF_MISC | BPF_TAX:
+          case BPF_MISC | BPF_TXA:
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_K:
+          case BPF_ALU | BPF_MOD | BPF_K:
+            if (insn->k == 0)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_K:
+          case BPF_ALU | BPF_RSH | BPF_K:
+            if (insn->k >= 32)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_LD | BPF_MEM:
+          case BPF_LDX | BPF_W | BPF_MEM:
+          case BPF_ST:
+          case BPF_STX:
+            if (insn->k >= BPF_MEMWORDS)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_JMP | BPF_JA:
+            if (insn->k >= (uint32_t)remain)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_K:
+          case BPF_JMP | BPF_JEQ | BPF_X:
+          case BPF_JMP | BPF_JGT | BPF_K:
+          case BPF_JMP | BPF_JGT | BPF_X:
+          case BPF_JMP | BPF_JGE | BPF_K:
+          case BPF_JMP | BPF_JGE | BPF_X:
+          case BPF_JMP | BPF_JSET | BPF_K:
+          case BPF_JMP | BPF_JSET | BPF_X:
+            if (insn->jt >= remain || insn->jf >= remain)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          default:
+            return -EINVAL;
+        }
+    }
+
+  /* Falling off the end is not possible if the last one returns */
+
+  if (BPF_CLASS(insns[len - 1].code) != BPF_RET)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sock_bpf_load
+ *
+ * Description:
+ *   Load 'size' bytes of packet data at offset 'k' in network byte order.
+ *
+ * Returned Value:
+ *   true on success; false if the data is beyond the end of the packet.
+ *
+ ****************************************************************************/
+
+static bool sock_bpf_load(FAR const struct iob_s *iob, int offset,
+                          uint32_t len, uint32_t k, unsigned int size,
+                          FAR uint32_t *value)
+{
+  FAR const uint8_t *ptr;
+  uint8_t buf[4];
+  uint32_t val;
+  unsigned int i;
+
+  if (k >= len || size > len - k)
+    {
+      return false;
+    }
+
+  /* Most loads are from the headers in the first IOB */
+
+  offset += k;
+  if (offset + (int)size <= (int)iob->io_len)
+    {
+      ptr = &iob->io_data[iob->io_offset + offset];
+    }
+  else if (iob_copyout(buf, iob, size, offset) == size)
+    {
+      ptr = buf;
+    }
+  else
+    {
+      return false;
+    }
+
+  for (val = 0, i = 0; i < size; i++)
+    {
+      val = (val << 8) | ptr[i];
+    }
+
+  *value = val;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sock_bpf_setsockopt
+ *
+ * Description:
+ *   Handle the SO_ATTACH_FILTER and SO_DETACH_FILTER socket options.
+ *
+ ****************************************************************************/
+
+int sock_bpf_setsockopt(FAR struct bpf_prog_s **prog, int option,
+                        FAR const void *value, socklen_t value_len)
+{
+  FAR const struct sock_fprog *fprog;
+  FAR struct bpf_prog_s *newprog;
+  FAR struct bpf_prog_s *oldprog;
+  int ret;
+
+  switch (option)
+    {
+      case SO_ATTACH_FILTER:
+        fprog = value;
+        if (value_len < sizeof(struct sock_fprog) ||
+            fprog->filter == NULL)
+          {
+            return -EINVAL;
+          }
+
+        ret = sock_bpf_check(fprog->filter, fprog->len);
+        if (ret < 0)
+          {
+            nerr("ERROR: Invalid filter program\n");
+            return ret;
+          }
+
+        newprog = kmm_malloc(SIZEOF_BPF_PROG(fprog->len));
+        if (newprog == NULL)
+          {
+            return -ENOMEM;
+          }
+
+        newprog->len = fprog->len;
+        memcpy(newprog->insns, fprog->filter,
+               fprog->len * sizeof(struct sock_filter));
+        break;
+
+      case SO_DETACH_FILTER:
+        if (*prog == NULL)
+          {
+            return -ENOENT;
+          }
+
+        newprog = NULL;
+        break;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+
+  /* The filter is only run with the network locked */
+
+  net_lock();
+  oldprog = *prog;
+  *prog   = newprog;
+  net_unlock();
+
+  if (oldprog != NULL)
+    {
+      kmm_free(oldprog);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sock_bpf_free
+ *
+ * Description:
+ *   Release the filter program of a connection that is being freed.
+ *
+ ****************************************************************************/
+
+void sock_bpf_free(FAR struct bpf_prog_s **prog)
+{
+  if (*prog != NULL)
+    {
+      kmm_free(*prog);
+      *prog = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: sock_bpf_run
+ *
+ * Description:
+ *   Run a filter program over the 'len' bytes of packet data that start at
+ *   'offset' in the IOB chain 'iob'.
+ *
+ ****************************************************************************/
+
+uint32_t sock_bpf_run(FAR const struct bpf_prog_s *prog,
+                      FAR const struct iob_s *iob, int offset, uint32_t len)
+{
+  FAR const struct sock_filter *insn;
+  uint32_t mem[BPF_MEMWORDS];
+  uint32_t a = 0;
+  uint32_t x = 0;
+  uint32_t v;
+
+  memset(mem, 0, sizeof(mem));
+
+  for (insn = prog->insns; ; insn++)
+    {
+      switch (insn->code)
+        {
+          case BPF_LD | BPF_W | BPF_ABS:
+            if (!sock_bpf_load(iob, offset, len, insn->k, 4, &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_H | BPF_ABS:
+            if (!sock_bpf_load(iob, offset, len, insn->k, 2, &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_B | BPF_ABS:
+            if (!sock_bpf_load(iob, offset, len, insn->k, 1, &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_W | BPF_IND:
+            if (!sock_bpf_load(iob, offset, len, x + insn->k, 4, &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_H | BPF_IND:
+            if (!sock_bpf_load(iob, offset, len, x + insn->k, 2, &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_B | BPF_IND:
+            if (!sock_bpf_load(iob, offset, len, x + insn->k, 1, &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_W | BPF_LEN:
+            a = len;
+            break;
+
+          case BPF_LD | BPF_IMM:
+            a = insn->k;
+            break;
+
+          case BPF_LD | BPF_MEM:
+            a = mem[insn->k];
+            break;
+
+          case BPF_LDX | BPF_W | BPF_IMM:
+            x = insn->k;
+            break;
+
+          case BPF_LDX | BPF_W | BPF_LEN:
+            x = len;
+            break;
+
+          case BPF_LDX | BPF_W | BPF_MEM:
+            x = mem[insn->k];
+            break;
+
+          case BPF_LDX | BPF_B | BPF_MSH:
+            if (!sock_bpf_load(iob, offset, len, insn->k, 1, &v))
+              {
+                return 0;
+              }
+
+            x = (v & 0x0f) << 2;
+            break;
+
+          case BPF_ST:
+            mem[insn->k] = a;
+            break;
+
+          case BPF_STX:
+            mem[insn->k] = x;
+            break;
+
+          case BPF_ALU | BPF_ADD | BPF_K:
+            a += insn->k;
+            break;
+
+          case BPF_ALU | BPF_ADD | BPF_X:
+            a += x;
+            break;
+
+          case BPF_ALU | BPF_SUB | BPF_K:
+            a -= insn->k;
+            break;
+
+          case BPF_ALU | BPF_SUB | BPF_X:
+            a -= x;
+            break;
+
+          case BPF_ALU | BPF_MUL | BPF_K:
+            a *= insn->k;
+            break;
+
+          case BPF_ALU | BPF_MUL | BPF_X:
+            a *= x;
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_K:
+            a /= insn->k;
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_X:
+            if (x == 0)
+              {
+                return 0;
+              }
+
+            a /= x;
+            break;
+
+          case BPF_ALU | BPF_MOD | BPF_K:
+            a %= insn->k;
+            break;
+
+          case BPF_ALU | BPF_MOD | BPF_X:
+            if (x == 0)
+              {
+                return 0;
+              }
+
+            a %= x;
+            break;
+
+          case BPF_ALU | BPF_OR | BPF_K:
+            a |= insn->k;
+            break;
+
+          case BPF_ALU | BPF_OR | BPF_X:
+            a |= x;
+            break;
+
+          case BPF_ALU | BPF_AND | BPF_K:
+            a &= insn->k;
+            break;
+
+          case BPF_ALU | BPF_AND | BPF_X:
+            a &= x;
+            break;
+
+          case BPF_ALU | BPF_XOR | BPF_K:
+            a ^= insn->k;
+            break;
+
+          case BPF_ALU | BPF_XOR | BPF_X:
+            a ^= x;
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_K:
+            a <<= insn->k;
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_X:
+            a = x < 32 ? a << x : 0;
+            break;
+
+          case BPF_ALU | BPF_RSH | BPF_K:
+            a >>= insn->k;
+            break;
+
+          case BPF_ALU | BPF_RSH | BPF_X:
+            a = x < 32 ? a >> x : 0;
+            break;
+
+          case BPF_ALU | BPF_NEG:
+            a = -a;
+            break;
+
+          case BPF_JMP | BPF_JA:
+            insn += insn->k;
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_K:
+            insn += a == insn->k ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_X:
+            insn += a == x ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGT | BPF_K:
+            insn += a > insn->k ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGT | BPF_X:
+            insn += a > x ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGE | BPF_K:
+            insn += a >= insn->k ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGE | BPF_X:
+            insn += a >= x ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JSET | BPF_K:
+            insn += (a & insn->k) != 0 ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JSET | BPF_X:
+            insn += (a & x) != 0 ? insn->jt : insn->jf;
+            break;
+
+          case BPF_RET | BPF_K:
+            return insn->k;
+
+          case BPF_RET | BPF_A:
+            return a;
+
+          case BPF_MISC | BPF_TAX:
+            x = a;
+            break;
+
+          case BPF_MISC | BPF_TXA:
+            a = x;
+            break;
+
+          default:
+
+            /* Not possible, sock_bpf_check() accepted the program */
+
+            DEBUGPANIC();
+            return 0;
+        }
+    }
+}
+
+#endif /* CONFIG_NET_BPF */
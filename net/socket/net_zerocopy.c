@@ -0,0 +1,354 @@
+/****************************************************************************
+ * net/socket/net_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "socket/socket.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest payload that one IOB can refer to */
+
+#define ZEROCOPY_MAXIOB   UINT16_MAX
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Completions are reported from whatever context frees the last IOB, so
+ * the pending list and the error queue of all sockets are protected by a
+ * spinlock rather than by the network lock.
+ */
+
+static spinlock_t g_zerocopy_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sock_zerocopy_release
+ *
+ * Description:
+ *   Release callback of the external buffer:  the network stack no longer
+ *   references any data of the send call.  Move the send call to the error
+ *   queue, merging it into the last entry when the numbers are contiguous.
+ *
+ ****************************************************************************/
+
+static void sock_zerocopy_release(FAR struct iob_extbuf_s *ext)
+{
+  FAR struct sock_zerocopy_s *zc = ext->priv;
+  FAR struct sock_zerocopy_s *tail;
+  FAR struct socket_conn_s *conn;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+
+  conn = zc->conn;
+  if (conn == NULL)
+    {
+      /* The socket has gone away, nobody is interested any more */
+
+      spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+      kmm_free(zc);
+      return;
+    }
+
+  sq_rem(&zc->node, &conn->s_zcpend);
+
+  tail = (FAR struct sock_zerocopy_s *)sq_tail(&conn->s_errq);
+  if (tail != NULL && tail->hi + 1 == zc->lo && tail->copied == zc->copied)
+    {
+      tail->hi = zc->hi;
+      spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+      kmm_free(zc);
+      return;
+    }
+
+  sq_addlast(&zc->node, &conn->s_errq);
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sock_zerocopy_alloc
+ *
+ * Description:
+ *   Allocate the tracking structure of one MSG_ZEROCOPY send() call and
+ *   assign it the next completion number of the socket.
+ *
+ ****************************************************************************/
+
+FAR struct sock_zerocopy_s *
+sock_zerocopy_alloc(FAR struct socket_conn_s *conn)
+{
+  FAR struct sock_zerocopy_s *zc;
+  irqstate_t flags;
+
+  zc = kmm_malloc(sizeof(struct sock_zerocopy_s));
+  if (zc == NULL)
+    {
+      return NULL;
+    }
+
+  iob_extbuf_init(&zc->ext, sock_zerocopy_release, zc);
+  zc->conn   = conn;
+  zc->copied = false;
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+  zc->lo = zc->hi = conn->s_zckey++;
+  sq_addlast(&zc->node, &conn->s_zcpend);
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  return zc;
+}
+
+/****************************************************************************
+ * Name: sock_zerocopy_wrap
+ *
+ * Description:
+ *   Wrap 'len' bytes of user data at 'buf' into a chain of IOBs that refer
+ *   to the data instead of copying it.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *sock_zerocopy_wrap(FAR struct sock_zerocopy_s *zc,
+                                     FAR const void *buf, size_t len)
+{
+  FAR const uint8_t *src = buf;
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  size_t ncopy;
+
+  while (len > 0)
+    {
+      ncopy = len > ZEROCOPY_MAXIOB ? ZEROCOPY_MAXIOB : len;
+
+      iob = iob_alloc_extbuf(&zc->ext, src, ncopy);
+      if (iob == NULL)
+        {
+          if (head != NULL)
+            {
+              iob_free_chain(head);
+            }
+
+          return NULL;
+        }
+
+      if (head == NULL)
+        {
+          head = iob;
+        }
+      else
+        {
+          iob->io_pktlen  = 0;
+          tail->io_flink  = iob;
+          head->io_pktlen += ncopy;
+        }
+
+      tail = iob;
+      src += ncopy;
+      len -= ncopy;
+    }
+
+  return head;
+}
+
+/****************************************************************************
+ * Name: sock_zerocopy_done
+ *
+ * Description:
+ *   Drop the reference of the send() caller so that the completion is
+ *   reported as soon as the network stack releases the data.
+ *
+ ****************************************************************************/
+
+void sock_zerocopy_done(FAR struct sock_zerocopy_s *zc, bool copied)
+{
+  if (copied)
+    {
+      zc->copied = true;
+    }
+
+  iob_extbuf_put(&zc->ext);
+}
+
+/****************************************************************************
+ * Name: sock_zerocopy_cancel
+ *
+ * Description:
+ *   The send() call failed without queuing any data.  Give the completion
+ *   number back if no other send call has taken one in the meantime;
+ *   otherwise report the call as copied so that the sequence stays
+ *   contiguous.
+ *
+ ****************************************************************************/
+
+void sock_zerocopy_cancel(FAR struct sock_zerocopy_s *zc)
+{
+  FAR struct socket_conn_s *conn;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+
+  conn = zc->conn;
+  if (conn != NULL && atomic_load(&zc->ext.refs) == 1 &&
+      conn->s_zckey == zc->lo + 1)
+    {
+      sq_rem(&zc->node, &conn->s_zcpend);
+      conn->s_zckey = zc->lo;
+      spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+      kmm_free(zc);
+      return;
+    }
+
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+  sock_zerocopy_done(zc, true);
+}
+
+/****************************************************************************
+ * Name: sock_zerocopy_recverr
+ *
+ * Description:
+ *   Dequeue the oldest completion range from the socket's error queue and
+ *   return it as a sock_extended_err control message.
+ *
+ ****************************************************************************/
+
+ssize_t sock_zerocopy_recverr(FAR struct socket *psock,
+                              FAR struct msghdr *msg)
+{
+  FAR struct socket_conn_s *conn = psock->s_conn;
+  FAR struct sock_zerocopy_s *zc;
+  struct sock_extended_err serr;
+  unsigned long msg_controllen;
+  FAR void *msg_control;
+  irqstate_t flags;
+  int level;
+  int type;
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+  zc = (FAR struct sock_zerocopy_s *)sq_remfirst(&conn->s_errq);
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  if (zc == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  memset(&serr, 0, sizeof(serr));
+  serr.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  serr.ee_code   = zc->copied ? SO_EE_CODE_ZEROCOPY_COPIED : 0;
+  serr.ee_info   = zc->lo;
+  serr.ee_data   = zc->hi;
+  kmm_free(zc);
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      level = SOL_IPV6;
+      type  = IPV6_RECVERR;
+    }
+  else
+#endif
+    {
+      level = SOL_IP;
+      type  = IP_RECVERR;
+    }
+
+  /* Report the true length of the control data, as psock_recvmsg() does */
+
+  msg_control    = msg->msg_control;
+  msg_controllen = msg->msg_controllen;
+  msg->msg_flags = MSG_ERRQUEUE;
+
+  if (cmsg_append(msg, level, type, &serr, sizeof(serr)) == NULL)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+    }
+
+  msg->msg_control    = msg_control;
+  msg->msg_controllen = msg_controllen - msg->msg_controllen;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: sock_zerocopy_purge
+ *
+ * Description:
+ *   Discard the error queue of the connection and detach it from any send
+ *   calls that are still referenced.
+ *
+ ****************************************************************************/
+
+void sock_zerocopy_purge(FAR struct socket_conn_s *conn)
+{
+  FAR struct sock_zerocopy_s *zc;
+  FAR sq_entry_t *entry;
+  sq_queue_t errq;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+
+  for (entry = sq_peek(&conn->s_zcpend); entry != NULL;
+       entry = sq_next(entry))
+    {
+      ((FAR struct sock_zerocopy_s *)entry)->conn = NULL;
+    }
+
+  sq_init(&conn->s_zcpend);
+  sq_move(&conn->s_errq, &errq);
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  while ((zc = (FAR struct sock_zerocopy_s *)sq_remfirst(&errq)) != NULL)
+    {
+      kmm_free(zc);
+    }
+}
+
+#endif /* CONFIG_NET_ZEROCOPY */
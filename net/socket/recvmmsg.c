@@ -0,0 +1,250 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmmsg_check
+ *
+ * Description:
+ *   Apply the checks of psock_recvmsg() to one entry of the vector, so that
+ *   the protocol may fill it directly.
+ *
+ ****************************************************************************/
+
+static int recvmmsg_check(FAR struct msghdr *msg)
+{
+  if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_name != NULL && msg->msg_namelen <= 0)
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_iovlen != 1)
+    {
+      return -ENOTSUP;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to 'vlen' messages with one call.  It is
+ *   the internal OS interface behind recvmmsg() and differs from it the
+ *   same way psock_recvmsg() differs from recvmsg().
+ *
+ *   Each round receives one message with psock_recvmsg(), blocking if the
+ *   socket does, and then lets the protocol's si_recvmmsg() method, if
+ *   any, copy out whatever else is already queued in one pass.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages; msg_len is set for each one
+ *             received
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags, MSG_WAITFORONE included
+ *   timeout   If not NULL, stop once this much time has passed.  As with
+ *             Linux it is only checked after a message has arrived.
+ *
+ * Returned Value:
+ *   The number of messages received.  A negated errno value is returned
+ *   only if no message was received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  unsigned int count = 0;
+  clock_t deadline = 0;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  /* Check the whole vector first so that an error is never reported after
+   * messages were already consumed.
+   */
+
+  for (count = 0; (flags & MSG_ERRQUEUE) == 0 && count < vlen; count++)
+    {
+      ret = recvmmsg_check(&msgvec[count].msg_hdr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  for (count = 0; count < vlen; )
+    {
+      ret = psock_recvmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count++].msg_len = ret;
+
+      /* A peek must not move on to the next datagram and the error queue
+       * is not a datagram queue at all.
+       */
+
+      if ((flags & (MSG_PEEK | MSG_ERRQUEUE)) != 0)
+        {
+          break;
+        }
+
+      if (psock->s_sockif->si_recvmmsg != NULL && count < vlen)
+        {
+          ret = psock->s_sockif->si_recvmmsg(psock, &msgvec[count],
+                                             vlen - count, flags);
+          if (ret > 0)
+            {
+              count += ret;
+            }
+        }
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL &&
+          (sclock_t)(clock_systime_ticks() - deadline) >= 0)
+        {
+          break;
+        }
+    }
+
+  return count > 0 ? count : ret;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives several messages from a socket with one call.  It
+ *   behaves like calling recvmsg() once per entry of 'msgvec', except that
+ *   the protocol may hand over all queued datagrams in one pass.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Buffers to receive the messages
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags; MSG_WAITFORONE makes every receive after the
+ *            first non-blocking
+ *   timeout  Optional timeout, checked after each received message
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received and sets msg_len
+ *   of each.  On error, -1 is returned, and errno is set as for recvmsg().
+ *   An error after the first message is not reported; the messages
+ *   received so far are returned instead.
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
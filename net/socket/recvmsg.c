@@ -76,6 +76,20 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   FAR void *msg_control;
   int ret;
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* Reading the error queue needs no data buffer */
+
+  if (msg != NULL && (flags & MSG_ERRQUEUE) != 0)
+    {
+      if (psock == NULL || psock->s_conn == NULL)
+        {
+          return -EBADF;
+        }
+
+      return sock_zerocopy_recverr(psock, msg);
+    }
+#endif
+
   /* Verify that non-NULL pointers were passed */
 
   if (msg == NULL || msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
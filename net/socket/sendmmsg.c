@@ -0,0 +1,160 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends up to 'vlen' messages with one call.  It is the
+ *   internal OS interface behind sendmmsg() and differs from it the same
+ *   way psock_sendmsg() differs from sendmsg().
+ *
+ *   Protocols that provide si_sendmmsg() get the whole vector; the others
+ *   are fed one message at a time through psock_sendmsg().
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send; msg_len is set for each one sent
+ *   vlen      Number of entries in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  A negated errno value is returned only
+ *   if the first message could not be sent.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  unsigned int count;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  if (psock->s_sockif->si_sendmmsg != NULL)
+    {
+      return psock->s_sockif->si_sendmmsg(psock, msgvec, vlen, flags);
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = ret;
+    }
+
+  return count > 0 ? count : ret;
+}
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *   sendmmsg() sends several messages on a socket with one call.  It
+ *   behaves like calling sendmsg() once per entry of 'msgvec'.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The messages to send
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent and sets msg_len of
+ *   each.  On error, -1 is returned, and errno is set as for sendmsg().
+ *   An error after the first message is not reported; the number of
+ *   messages sent so far is returned instead.
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_sendmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_sendmmsg(psock, msgvec, vlen, flags);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
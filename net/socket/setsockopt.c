@@ -137,8 +137,12 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                            * periodic transmission of probes */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Allow several listeners on one port */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:  /* Generates a timestamp for each incoming packet */
+#endif
+#ifdef CONFIG_NET_ZEROCOPY
+      case SO_ZEROCOPY:   /* Enables MSG_ZEROCOPY transmission */
 #endif
         {
           int setting;
@@ -177,6 +181,27 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_BUSY_POLL
+      case SO_BUSY_POLL:  /* Busy-poll time of a blocking receive */
+        {
+          int usec;
+
+          if (value == NULL || value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          usec = *(FAR int *)value;
+          if (usec < 0)
+            {
+              return -EINVAL;
+            }
+
+          conn->s_busypoll = usec;
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_BINDTODEVICE
       /* Handle the SO_BINDTODEVICE socket-level option.
        *
@@ -38,6 +38,14 @@
 #include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 
+#if defined(CONFIG_NET_ZEROCOPY) || defined(CONFIG_NET_BPF)
+#  include <nuttx/mm/iob.h>
+#endif
+
+#ifdef CONFIG_NET_BPF
+#  include <net/bpf.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -66,10 +74,12 @@
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
 #define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
 #define _SO_BINDTODEVICE _SO_BIT(SO_BINDTODEVICE)
+#define _SO_ZEROCOPY     _SO_BIT(SO_ZEROCOPY)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (18)
+#define _SO_MAXOPT       (20)
 
 /* Macros to set, test, clear options */
 
@@ -123,6 +133,39 @@
 #  define _SO_SETERRNO(s,e)
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ZEROCOPY
+/* Tracks one MSG_ZEROCOPY send() call.  While the call is in flight the
+ * structure is in the socket's s_zcpend list and the IOBs wrapping the
+ * user data hold references to 'ext'.  When the last reference is dropped
+ * it moves to the socket's error queue s_errq, where successive completions
+ * are merged into one [lo, hi] range.
+ */
+
+struct sock_zerocopy_s
+{
+  sq_entry_t                node;   /* Link in s_zcpend or s_errq */
+  struct iob_extbuf_s       ext;    /* External buffer shared by the IOBs */
+  FAR struct socket_conn_s *conn;   /* Owning socket, NULL once it is gone */
+  uint32_t                  lo;     /* First send call covered */
+  uint32_t                  hi;     /* Last send call covered */
+  bool                      copied; /* Some of the data was copied */
+};
+#endif
+
+#ifdef CONFIG_NET_BPF
+/* A verified filter program attached with SO_ATTACH_FILTER */
+
+struct bpf_prog_s
+{
+  uint16_t           len;      /* Number of instructions */
+  struct sock_filter insns[1]; /* The program */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -182,6 +225,166 @@ net_sockif(sa_family_t family, int type, int protocol);
 int net_timeo(clock_t start_time, socktimeo_t timeo);
 #endif
 
+#ifdef CONFIG_NET_ZEROCOPY
+/****************************************************************************
+ * Name: sock_zerocopy_alloc
+ *
+ * Description:
+ *   Allocate the tracking structure of one MSG_ZEROCOPY send() call and
+ *   assign it the next completion number of the socket.
+ *
+ * Input Parameters:
+ *   conn - The socket connection the data is sent on
+ *
+ * Returned Value:
+ *   The new structure on success; NULL if no memory is available.
+ *
+ ****************************************************************************/
+
+FAR struct sock_zerocopy_s *
+sock_zerocopy_alloc(FAR struct socket_conn_s *conn);
+
+/****************************************************************************
+ * Name: sock_zerocopy_wrap
+ *
+ * Description:
+ *   Wrap 'len' bytes of user data at 'buf' into a chain of IOBs that refer
+ *   to the data instead of copying it.  Each IOB holds a reference to the
+ *   send call 'zc' until it is freed.
+ *
+ * Returned Value:
+ *   The head of the IOB chain with io_pktlen set to 'len';  NULL if no
+ *   memory is available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *sock_zerocopy_wrap(FAR struct sock_zerocopy_s *zc,
+                                     FAR const void *buf, size_t len);
+
+/****************************************************************************
+ * Name: sock_zerocopy_done
+ *
+ * Description:
+ *   Called at the end of a MSG_ZEROCOPY send() call that queued some data.
+ *   Drops the reference held by the caller so that the completion is
+ *   reported as soon as the network stack releases the data.
+ *
+ * Input Parameters:
+ *   zc     - The send call
+ *   copied - True if any of the data was copied rather than referenced
+ *
+ ****************************************************************************/
+
+void sock_zerocopy_done(FAR struct sock_zerocopy_s *zc, bool copied);
+
+/****************************************************************************
+ * Name: sock_zerocopy_cancel
+ *
+ * Description:
+ *   Called instead of sock_zerocopy_done() if the send() call failed
+ *   without queuing any data.  No completion is reported for the call.
+ *
+ ****************************************************************************/
+
+void sock_zerocopy_cancel(FAR struct sock_zerocopy_s *zc);
+
+/****************************************************************************
+ * Name: sock_zerocopy_recverr
+ *
+ * Description:
+ *   Implements recvmsg(MSG_ERRQUEUE):  dequeue the oldest completion range
+ *   from the socket's error queue and return it as a sock_extended_err
+ *   control message.
+ *
+ * Input Parameters:
+ *   psock - The socket
+ *   msg   - Receives the control message
+ *
+ * Returned Value:
+ *   Zero on success; -EAGAIN if the error queue is empty.
+ *
+ ****************************************************************************/
+
+ssize_t sock_zerocopy_recverr(FAR struct socket *psock,
+                              FAR struct msghdr *msg);
+
+/****************************************************************************
+ * Name: sock_zerocopy_purge
+ *
+ * Description:
+ *   Called when a connection is freed:  discard its error queue and detach
+ *   it from any send calls that are still referenced.
+ *
+ ****************************************************************************/
+
+void sock_zerocopy_purge(FAR struct socket_conn_s *conn);
+
+/****************************************************************************
+ * Name: sock_zerocopy_errpending
+ *
+ * Description:
+ *   Return true if the error queue of the connection is not empty.
+ *
+ ****************************************************************************/
+
+#  define sock_zerocopy_errpending(c) (!sq_empty(&(c)->s_errq))
+#endif
+
+#ifdef CONFIG_NET_BPF
+/****************************************************************************
+ * Name: sock_bpf_setsockopt
+ *
+ * Description:
+ *   Handle the SO_ATTACH_FILTER and SO_DETACH_FILTER socket options for a
+ *   protocol that supports socket filters.  The program passed with
+ *   SO_ATTACH_FILTER is verified and copied; it then replaces the one in
+ *   'prog' under the network lock.
+ *
+ * Input Parameters:
+ *   prog      - The filter program field of the connection
+ *   option    - The socket option
+ *   value     - The struct sock_fprog of SO_ATTACH_FILTER
+ *   value_len - The size of 'value'
+ *
+ * Returned Value:
+ *   Zero on success; -ENOPROTOOPT if 'option' is not a filter option;
+ *   another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sock_bpf_setsockopt(FAR struct bpf_prog_s **prog, int option,
+                        FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: sock_bpf_free
+ *
+ * Description:
+ *   Release the filter program of a connection that is being closed.
+ *
+ ****************************************************************************/
+
+void sock_bpf_free(FAR struct bpf_prog_s **prog);
+
+/****************************************************************************
+ * Name: sock_bpf_run
+ *
+ * Description:
+ *   Run a filter program over the 'len' bytes of packet data that start at
+ *   'offset' in the IOB chain 'iob'.  The offset may be negative to include
+ *   the link layer header in front of the IOB data.
+ *
+ *   Must be called with the network locked.
+ *
+ * Returned Value:
+ *   The number of bytes of the packet to keep, zero to drop it.  The value
+ *   may be larger than 'len'.
+ *
+ ****************************************************************************/
+
+uint32_t sock_bpf_run(FAR const struct bpf_prog_s *prog,
+                      FAR const struct iob_s *iob, int offset, uint32_t len);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
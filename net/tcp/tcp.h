@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -73,6 +74,10 @@
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
+#ifdef CONFIG_NET_TCP_RACK
+#  define TCP_WBXMIT(wrb)            ((wrb)->wb_xmit)
+#  define TCP_WBFLAGS(wrb)           ((wrb)->wb_flags)
+#endif
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
      (iob_copyin((wrb)->wb_iob,src,(n),(off),true))
@@ -114,6 +119,43 @@
 
 #endif
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+/* The TCP flags for Fast Open */
+
+#define TCP_TFO_LISTEN        0x20U  /* Listener accepts data in the SYN */
+#define TCP_TFO_CONNECT       0x40U  /* Active open sends the TFO option */
+#define TCP_TFO_COOKIE        0x80U  /* SYN-ACK hands out a new cookie */
+#define TCP_TFO_EARLY         0x100U /* Established by the SYN data */
+
+/* Fast Open cookie sizes (RFC 7413, section 4.1.1) */
+
+#define TCP_FASTOPEN_COOKIE_MIN  4
+#define TCP_FASTOPEN_COOKIE_MAX  16
+#define TCP_FASTOPEN_COOKIE_LEN  8   /* Size of the cookies we generate */
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+/* The RACK-TLP state flags */
+
+#define TCP_RACK_SAMPLE       0x01U /* rtt, min_rtt and srtt are valid */
+#define TCP_RACK_RECOVERY     0x02U /* Repairing the losses found by RACK */
+#define TCP_RACK_TLP          0x04U /* A tail loss probe is outstanding */
+#define TCP_RACK_REO          0x08U /* The reordering timer is armed */
+#define TCP_RACK_PTO          0x10U /* The probe timer is armed */
+#define TCP_RACK_FIRED        0x20U /* The timer expired, act on next poll */
+
+/* The write buffer flags */
+
+#define TCP_WB_SACKED         0x01U /* Covered by a SACK block */
+#define TCP_WB_PROBED         0x02U /* The tail was sent again as a probe */
+#endif
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+/* The receive buffer size was set with SO_RCVBUF, do not autotune it */
+
+#define TCP_RCVBUF_LOCK       0x200U
+#endif
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
@@ -124,6 +166,26 @@
 
 #define TCP_FAST_RETRANSMISSION_THRESH 3
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* Increments a size inc and holds at max value rather than rollover. */
+
+#define TCP_CC_CWND_INC(wnd, inc) \
+ do { \
+  if ((uint32_t)((wnd) + (inc)) >= (wnd)) \
+    { \
+      (wnd) = (uint32_t)((wnd) + (inc)); \
+    } \
+  else \
+    { \
+      (wnd) = (uint32_t)-1; \
+    } \
+ } while(0)
+
+/* Number of rounds over which BBR keeps its maximum bandwidth filter */
+
+#define TCP_BBR_BW_ROUNDS 10
+#endif
+
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
@@ -176,6 +238,99 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  Duplicate ACK counting, fast
+ * retransmit and fast recovery (RFC 6582) are common to all algorithms and
+ * live in tcp_cc.c; an algorithm only decides how the window grows and how
+ * far it backs off.
+ *
+ *   name       - Name used with the TCP_CONGESTION socket option
+ *   init       - Reset the private state, called when the algorithm is
+ *                selected and when the connection starts.  Optional.
+ *   ssthresh   - Return the slow start threshold after a loss detected
+ *                by duplicate ACKs.
+ *   acked      - Called for every ACK of new data, also during fast
+ *                recovery, e.g. to sample the delivery rate.  Optional.
+ *   cong_avoid - Grow cwnd for 'acked' newly acknowledged bytes.  Not
+ *                called during fast recovery.
+ *   loss       - Retransmission timeout: set cwnd and ssthresh.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void      (*init)(FAR struct tcp_conn_s *conn);
+  CODE uint32_t  (*ssthresh)(FAR struct tcp_conn_s *conn);
+  CODE void      (*acked)(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                          uint32_t acked);
+  CODE void      (*cong_avoid)(FAR struct tcp_conn_s *conn,
+                               uint32_t acked);
+  CODE void      (*loss)(FAR struct tcp_conn_s *conn);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* CUBIC (RFC 9438) per-connection state */
+
+struct tcp_cubic_s
+{
+  clock_t  epoch;         /* Start of the current congestion avoidance
+                           * epoch */
+  uint32_t w_max;         /* cwnd just before the last reduction */
+  uint32_t origin;        /* Plateau of the cubic function */
+  uint32_t k;             /* Time to reach the plateau (units: ms) */
+  uint32_t w_est;         /* Reno-friendly window estimate */
+  bool     inepoch;       /* 'epoch' is valid */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+/* BBR (version 1) per-connection state.  A round starts at an ACK and
+ * ends when the first byte sent after it is acknowledged, which gives one
+ * RTT and one delivery rate sample per round.
+ */
+
+struct tcp_bbr_s
+{
+  /* Delivery rate of the last rounds (units: bytes/s) */
+
+  uint32_t bw[TCP_BBR_BW_ROUNDS];
+  uint32_t min_rtt;       /* Minimum RTT seen (units: us) */
+  clock_t  min_rtt_stamp; /* When min_rtt was taken */
+  clock_t  round_stamp;   /* When the current round started */
+  clock_t  probe_rtt_end; /* End of the PROBE_RTT dwell time */
+  uint32_t round_seq;     /* The round ends when this is ACKed */
+  uint32_t delivered;     /* Bytes ACKed in the current round */
+  uint32_t full_bw;       /* Bandwidth at the last STARTUP growth check */
+  uint32_t prior_cwnd;    /* cwnd to restore after PROBE_RTT */
+  uint8_t  round;         /* Round counter, indexes bw[] */
+  uint8_t  full_cnt;      /* Rounds without 25% bandwidth growth */
+  uint8_t  mode;          /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  cycle;         /* Index in the PROBE_BW gain cycle */
+  bool     filled;        /* The bottleneck bandwidth was reached */
+  bool     inround;       /* A round is being measured */
+};
+#endif
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
+#ifdef CONFIG_NET_TCP_RACK
+/* RACK-TLP (RFC 8985) per-connection state.  The scoreboard has write
+ * buffer granularity and all times are in system ticks.
+ */
+
+struct tcp_rack_s
+{
+  struct work_s work;     /* Reordering and probe timeout */
+  clock_t  xmit;          /* Send time of the last delivered write buffer */
+  clock_t  rtt;           /* RTT of the last delivered write buffer */
+  clock_t  min_rtt;       /* Minimum RTT seen */
+  clock_t  srtt;          /* Smoothed RTT */
+  uint32_t end_seq;       /* End of the last delivered write buffer */
+  uint32_t recover;       /* Recovery ends when this is ACKed */
+  uint32_t tlp_end;       /* The probe is over when this is ACKed */
+  uint8_t  flags;         /* See TCP_RACK_* */
+};
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -209,6 +364,10 @@ struct tcp_conn_s
   /* TCP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hash_node_t hnode;      /* Link in the connection hashtable */
+  hash_node_t lnode;      /* Link in the listener hashtable */
+#endif
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
   uint8_t  sndseq[4];     /* The sequence number that was last sent by us */
@@ -252,6 +411,26 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+  uint32_t pacing_rate;   /* Pacing rate chosen by the congestion control
+                           * (units: bytes/s, 0: not paced) */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* Congestion control algorithm */
+#if defined(CONFIG_NET_TCP_CC_CUBIC) || defined(CONFIG_NET_TCP_CC_BBR)
+  union
+  {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+    struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+    struct tcp_bbr_s   bbr;
+#endif
+  } cc;                   /* Private state of the algorithm */
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  clock_t  pace_stamp;    /* Last time pacing credit was added */
+  uint32_t pace_credit;   /* Bytes that may be sent without waiting */
+  struct work_s pacework; /* Resumes sending when credit is available */
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -267,6 +446,27 @@ struct tcp_conn_s
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcv_bufs;      /* Maximum amount of bytes queued in recv */
 #endif
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+  /* Receive buffer autotuning
+   *
+   *   drs_copied   - Bytes read by the application so far.
+   *   drs_start    - drs_copied at the start of the current measurement.
+   *   drs_space    - Bytes read during the last measurement.
+   *   drs_time     - Start of the current measurement.
+   *   drs_rtt_seq  - The RTT sample ends when this has been received.
+   *   drs_rtt_time - Start of the RTT sample.
+   *   drs_rtt      - Receiver side RTT estimate (0: none yet).
+   */
+
+  uint32_t drs_copied;
+  uint32_t drs_start;
+  uint32_t drs_space;
+  clock_t  drs_time;
+  uint32_t drs_rtt_seq;
+  clock_t  drs_rtt_time;
+  clock_t  drs_rtt;
+  bool     drs_inrtt;     /* An RTT sample is being taken */
+#endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
   int32_t  snd_bufs;      /* Maximum amount of bytes queued in send */
   sem_t    snd_sem;       /* Semaphore signals send completion */
@@ -278,6 +478,7 @@ struct tcp_conn_s
   uint16_t tx_unacked;    /* Number bytes sent but not yet ACKed */
 #endif
   uint16_t flags;         /* Flags of TCP-specific options */
+  uint32_t total_retrans; /* Segments retransmitted, reported by TCP_INFO */
 #ifdef CONFIG_NET_SOLINGER
   sclock_t ltimeout;      /* Linger timeout expiration */
 #endif
@@ -326,6 +527,21 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_TCP_RACK
+  struct tcp_rack_s rack; /* Loss detection */
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+  /* TCP Fast Open, active open only
+   *
+   *   tfo_iob - The data to be sent in the SYN.
+   *   tfo_len - The length of the data sent in the SYN, then how much of
+   *             it the SYN-ACK acknowledged.
+   */
+
+  FAR struct iob_s *tfo_iob;
+  uint16_t   tfo_len;
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -413,6 +629,10 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  uint8_t    wb_flags;     /* See TCP_WB_* */
+  clock_t    wb_xmit;      /* Time the last byte was (re)sent */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -532,6 +752,20 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
 
 FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_conn_rotate
+ *
+ * Description:
+ *   Rotate the list of active TCP connections so that the connection
+ *   following conn is polled first by the next devif_poll().
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_conn_rotate(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_local_ipv4_device
  *
@@ -1050,7 +1284,12 @@ void tcp_stop_timer(FAR struct tcp_conn_s *conn);
  * Name: tcp_findlistener
  *
  * Description:
- *   Return the connection listener for connections on this port (if any)
+ *   Return the connection listener for connections on this port (if any).
+ *   If several sockets listen on the port with SO_REUSEPORT, one of them
+ *   is chosen from the remote address in 'uaddr' and the remote port
+ *   'rport', so that all segments of one connection find the same one.
+ *   With CONFIG_NETDEV_RSS the members that last accepted on this CPU are
+ *   preferred.
  *
  * Assumptions:
  *   The network is locked
@@ -1059,11 +1298,11 @@ void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
+                                        uint16_t portno, uint16_t rport,
                                         uint8_t domain);
 #else
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno);
+                                        uint16_t portno, uint16_t rport);
 #endif
 
 /****************************************************************************
@@ -1742,6 +1981,76 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 
 bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_rcvbuf_measure
+ *
+ * Description:
+ *   Take the receiver side RTT sample used by receive buffer autotuning.
+ *   Called each time a window is advertised.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+void tcp_rcvbuf_measure(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_adjust
+ *
+ * Description:
+ *   Account data read by the application and, once per RTT, grow the
+ *   receive buffer to twice what was read during the last RTT.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure holding connection information.
+ *   copied - The number of bytes just read by the application.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+void tcp_rcvbuf_adjust(FAR struct tcp_conn_s *conn, size_t copied);
+#endif
+
+/****************************************************************************
+ * Name: tcp_iob_quota_check
+ *
+ * Description:
+ *   Check if an I/O buffer chain may be added to the read-ahead buffer of
+ *   the connection under CONFIG_NET_TCP_IOB_QUOTA.  A chain is always
+ *   accepted into an empty read-ahead buffer.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *   iob  - The I/O buffer chain to be queued.
+ *
+ * Returned Value:
+ *   true if the chain fits in the quota.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+bool tcp_iob_quota_check(FAR struct tcp_conn_s *conn,
+                         FAR struct iob_s *iob);
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -1783,6 +2092,8 @@ struct tcp_wrbuffer_s;
  *   this wait will be terminated when the specified timeout expires.
  *
  * Input Parameters:
+ *   size      - The amount of data about to be queued, used to choose the
+ *               size class of the first I/O buffer.
  *   timeout   - The relative time to wait until a timeout is declared.
  *
  * Assumptions:
@@ -1790,7 +2101,8 @@ struct tcp_wrbuffer_s;
  *
  ****************************************************************************/
 
-FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int timeout);
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int size,
+                                                   unsigned int timeout);
 
 /****************************************************************************
  * Name: tcp_wrbuffer_alloc
@@ -1820,14 +2132,15 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void);
  *   immediately if allocation fails.
  *
  * Input parameters:
- *   None
+ *   size      - The amount of data about to be queued, used to choose the
+ *               size class of the first I/O buffer.
  *
  * Assumptions:
  *   Called from user logic with the network locked.
  *
  ****************************************************************************/
 
-FAR struct tcp_wrbuffer_s *tcp_wrbuffer_tryalloc(void);
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_tryalloc(unsigned int size);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
 /****************************************************************************
@@ -2308,7 +2621,193 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_loss
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_loss(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_setalgo
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, as
+ *   done by the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - Name of the algorithm, not necessarily NUL terminated
+ *   len    - Maximum length of 'name'
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if no such algorithm is configured.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_setalgo(FAR struct tcp_conn_s *conn, FAR const char *name,
+                   size_t len);
+
+/****************************************************************************
+ * Name: tcp_cc_getalgo
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_getalgo(FAR struct tcp_conn_s *conn);
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
 #endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+
+/****************************************************************************
+ * Name: tcp_fastopen_synopt
+ *
+ * Description:
+ *   Build the Fast Open option of an outgoing SYN or SYN-ACK: a cookie
+ *   request or the cached cookie in the SYN of an active open, a new
+ *   cookie in the SYN-ACK of a server that was asked for one.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   flags  - The TCP flags of the segment, TCP_SYN or TCP_SYN | TCP_ACK
+ *   opt    - Where to put the option, room for 20 bytes
+ *
+ * Returned Value:
+ *   The length of the option, a multiple of four, or zero.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_fastopen_synopt(FAR struct tcp_conn_s *conn, uint8_t flags,
+                        FAR uint8_t *opt);
+
+/****************************************************************************
+ * Name: tcp_fastopen_syndata
+ *
+ * Description:
+ *   Append the data queued by tcp_fastopen_sendto() to the SYN that
+ *   tcp_synack() is building.  This is only done once, a retransmitted
+ *   SYN goes without data.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_fastopen_syndata(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_fastopen_checkcookie
+ *
+ * Description:
+ *   Check the Fast Open option of a SYN received by a listener.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN
+ *   conn   - The new connection created for the SYN
+ *   iplen  - The size of the IP header
+ *
+ * Returned Value:
+ *   OK if the SYN carries a valid cookie, -EINVAL if it asks for a cookie
+ *   or carries a stale one, -ENOENT if it has no Fast Open option.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_fastopen_checkcookie(FAR struct net_driver_s *dev,
+                             FAR struct tcp_conn_s *conn,
+                             unsigned int iplen);
+
+/****************************************************************************
+ * Name: tcp_fastopen_synack
+ *
+ * Description:
+ *   Process the SYN-ACK of an active Fast Open: remember the cookie of the
+ *   server and find out how much of the SYN data it accepted.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN-ACK
+ *   conn   - The TCP connection of interest
+ *   iplen  - The size of the IP header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_fastopen_synack(FAR struct net_driver_s *dev,
+                         FAR struct tcp_conn_s *conn,
+                         unsigned int iplen);
+
+/****************************************************************************
+ * Name: tcp_fastopen_sendto
+ *
+ * Description:
+ *   Implement sendto(MSG_FASTOPEN) on an unconnected TCP socket: connect
+ *   to 'to' with the start of 'buf' in the SYN if a cookie is cached for
+ *   the server, then send whatever the SYN-ACK did not acknowledge.
+ *
+ * Input Parameters:
+ *   psock  - An instance of the internal socket structure.
+ *   buf    - Data to send
+ *   len    - Length of data to send
+ *   flags  - Send flags
+ *   to     - Address of the server
+ *   tolen  - The length of the address structure
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value on failure.  A
+ *   non-blocking socket only requests a cookie and returns -EINPROGRESS
+ *   like connect().
+ *
+ ****************************************************************************/
+
+ssize_t tcp_fastopen_sendto(FAR struct socket *psock, FAR const void *buf,
+                            size_t len, int flags,
+                            FAR const struct sockaddr *to, socklen_t tolen);
+
+#endif /* CONFIG_NET_TCP_FASTOPEN */
 
 #ifdef __cplusplus
 }
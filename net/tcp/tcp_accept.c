@@ -35,6 +35,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 
@@ -225,6 +226,14 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
   conn = psock->s_conn;
 
+#ifdef CONFIG_NETDEV_RSS
+  /* Remember where the listener is served, so that tcp_findlistener() can
+   * hand each SO_REUSEPORT member the connections arriving on its CPU.
+   */
+
+  conn->rcvcpu = this_cpu();
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   state.acpt_newconn = tcp_backlogremove(conn);
   if (state.acpt_newconn)
@@ -386,6 +386,18 @@ uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
   FAR struct iob_s *iob = dev->d_iob;
   uint16_t buflen;
 
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+  /* Leave the packet unacknowledged if the connection holds its share of
+   * the IOBs already.
+   */
+
+  if (!tcp_iob_quota_check(conn, iob))
+    {
+      nwarn("WARNING: IOB quota exceeded, dropping %u bytes\n", dev->d_len);
+      return 0;
+    }
+#endif
+
   if (offset > 0)
     {
       /* Remove 'bufoff' bytes from the beginning of the input I/O chain */
@@ -24,6 +24,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+#include <string.h>
+#include <errno.h>
 #include <debug.h>
 
 #include "tcp/tcp.h"
@@ -60,24 +63,126 @@
     } \
  } while(0)
 
-/* Increments a size inc and holds at max value rather than rollover. */
+/* The algorithm used unless TCP_CONGESTION selects another one */
 
-#define CC_CWND_INC(wnd, inc) \
- do { \
-  if ((uint32_t)((wnd) + (inc)) >= (wnd)) \
-    { \
-      (wnd) = (uint32_t)((wnd) + (inc)); \
-    } \
-  else \
-    { \
-      (wnd) = (uint32_t)-1; \
-    } \
- } while(0)
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_cubic)
+#elif defined(CONFIG_NET_TCP_CC_DEFAULT_BBR)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_bbr)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_cc_newreno)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void newreno_loss(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "reno",               /* name */
+  NULL,                 /* init */
+  newreno_ssthresh,     /* ssthresh */
+  NULL,                 /* acked */
+  newreno_cong_avoid,   /* cong_avoid */
+  newreno_loss          /* loss */
+};
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algos[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Slow start and congestion avoidance of RFC 5681.
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* slow start (RFC 5681):
+       * Grow cwnd exponentially by maxseg(smss) per ACK.
+       */
+
+      increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+
+      TCP_CC_CWND_INC(conn->cwnd, increase);
+      ninfo("update slow start cwnd to %u\n", conn->cwnd);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      TCP_CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: newreno_loss
+ *
+ * Description:
+ *   Restart from one segment in slow start after a retransmission timeout.
+ *
+ ****************************************************************************/
+
+static void newreno_loss(FAR struct tcp_conn_s *conn)
+{
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = newreno_ssthresh(conn);
+  conn->cwnd = conn->mss;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +222,21 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+  conn->pacing_rate = 0;
+
+  /* Keep an algorithm selected with TCP_CONGESTION before connect() or
+   * inherited from the listener.
+   */
+
+  if (conn->cc_ops == NULL)
+    {
+      conn->cc_ops = TCP_CC_DEFAULT;
+    }
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
 }
 
 /****************************************************************************
@@ -140,15 +260,14 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, let the algorithm choose ssthresh and enter
+   * to Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -217,7 +336,7 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             {
               /* Inflate the congestion window */
 
-              CC_CWND_INC(conn->cwnd, conn->mss);
+              TCP_CC_CWND_INC(conn->cwnd, conn->mss);
             }
 
           if (conn->dupacks >= TCP_FAST_RETRANSMISSION_THRESH)
@@ -243,6 +362,11 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       conn->dupacks = 0;
       conn->last_ackno = ackno;
 
+      if (conn->cc_ops->acked != NULL)
+        {
+          conn->cc_ops->acked(conn, ackno, acked);
+        }
+
       /* When the ackno covers more than the fr_recover, exit the
        * fast recovery. Then, reset the "IN Fast Recovery" flags.
        * Also reset the congestion window to the slow start threshold.
@@ -260,7 +384,7 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              CC_CWND_INC(conn->cwnd, conn->mss);
+              TCP_CC_CWND_INC(conn->cwnd, conn->mss);
               return;
             }
         }
@@ -269,34 +393,105 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc_ops->cong_avoid(conn, acked);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_loss
+ *
+ * Description:
+ *   Update the congestion control variables after a retransmission
+ *   timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_loss(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+  conn->flags &= ~(TCP_INFR | TCP_INFT);
+  conn->cc_ops->loss(conn);
+}
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+/****************************************************************************
+ * Name: tcp_cc_setalgo
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, as
+ *   done by the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - Name of the algorithm, not necessarily NUL terminated
+ *   len    - Maximum length of 'name'
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if no such algorithm is configured.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
-            }
+int tcp_cc_setalgo(FAR struct tcp_conn_s *conn, FAR const char *name,
+                   size_t len)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+  unsigned int i;
+
+  len = strnlen(name, len);
+
+  for (i = 0; i < nitems(g_tcp_cc_algos); i++)
+    {
+      ops = g_tcp_cc_algos[i];
+      if (strlen(ops->name) == len && strncmp(ops->name, name, len) == 0)
+        {
+          break;
         }
     }
+
+  if (i >= nitems(g_tcp_cc_algos))
+    {
+      return -ENOENT;
+    }
+
+  if (ops != conn->cc_ops)
+    {
+      /* The window is kept, only the private state starts over.  The new
+       * algorithm may not pace.
+       */
+
+      conn->cc_ops = ops;
+      conn->pacing_rate = 0;
+      if (ops->init != NULL)
+        {
+          ops->init(conn);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_getalgo
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_getalgo(FAR struct tcp_conn_s *conn)
+{
+  return conn->cc_ops != NULL ? conn->cc_ops->name : TCP_CC_DEFAULT->name;
 }
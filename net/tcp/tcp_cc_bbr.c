@@ -0,0 +1,408 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Gains are in units of 1/256 */
+
+#define BBR_UNIT              256
+#define BBR_HIGH_GAIN         739   /* 2/ln(2), STARTUP */
+#define BBR_DRAIN_GAIN        89    /* 1/BBR_HIGH_GAIN, DRAIN */
+#define BBR_CWND_GAIN         512   /* cwnd gain in PROBE_BW */
+#define BBR_FULL_BW_GAIN      320   /* 25% growth expected in STARTUP */
+#define BBR_FULL_BW_CNT       3     /* Rounds without growth to leave it */
+#define BBR_CYCLE_LEN         8
+
+#define BBR_MIN_RTT_WINDOW    SEC2TICK(10)
+#define BBR_PROBE_RTT_TIME    MSEC2TICK(200)
+
+#define BBR_MIN_CWND(conn)    (4 * (uint32_t)(conn)->mss)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum bbr_mode_e
+{
+  BBR_STARTUP = 0,      /* Ramp up quickly to find the bottleneck rate */
+  BBR_DRAIN,            /* Empty the queue created in STARTUP */
+  BBR_PROBE_BW,         /* Cruise at the bottleneck rate, probing gently */
+  BBR_PROBE_RTT         /* Shrink the window to refresh min_rtt */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn);
+static void bbr_acked(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                      uint32_t acked);
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void bbr_loss(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Pacing gain cycle of PROBE_BW: probe for more, drain the excess, cruise */
+
+static const uint16_t g_bbr_cycle[BBR_CYCLE_LEN] =
+{
+  320, 192, 256, 256, 256, 256, 256, 256
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                /* name */
+  bbr_init,             /* init */
+  bbr_ssthresh,         /* ssthresh */
+  bbr_acked,            /* acked */
+  bbr_cong_avoid,       /* cong_avoid */
+  bbr_loss              /* loss */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_sndnxt
+ *
+ * Description:
+ *   Return the sequence number of the next new byte to be sent.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_sndnxt(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  return conn->isn + conn->sent;
+#else
+  return tcp_getsequence(conn->sndseq) + conn->tx_unacked;
+#endif
+}
+
+/****************************************************************************
+ * Name: bbr_max_bw
+ *
+ * Description:
+ *   Return the bottleneck bandwidth estimate, the maximum delivery rate of
+ *   the last TCP_BBR_BW_ROUNDS rounds.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_max_bw(FAR struct tcp_bbr_s *bbr)
+{
+  uint32_t bw = 0;
+  int i;
+
+  for (i = 0; i < TCP_BBR_BW_ROUNDS; i++)
+    {
+      bw = MAX(bw, bbr->bw[i]);
+    }
+
+  return bw;
+}
+
+/****************************************************************************
+ * Name: bbr_bdp
+ *
+ * Description:
+ *   Return the estimated bandwidth-delay product scaled by 'gain', or zero
+ *   while there is no estimate yet.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_bdp(FAR struct tcp_bbr_s *bbr, uint32_t gain)
+{
+  uint64_t bdp;
+
+  bdp = (uint64_t)bbr_max_bw(bbr) * bbr->min_rtt / USEC_PER_SEC;
+  bdp = bdp * gain / BBR_UNIT;
+
+  return (uint32_t)MIN(bdp, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: bbr_start_round
+ ****************************************************************************/
+
+static void bbr_start_round(FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_bbr_s *bbr, clock_t now)
+{
+  bbr->round_seq   = bbr_sndnxt(conn);
+  bbr->round_stamp = now;
+  bbr->delivered   = 0;
+  bbr->inround     = true;
+}
+
+/****************************************************************************
+ * Name: bbr_update_model
+ *
+ * Description:
+ *   Take the samples of a finished round and move through the states.
+ *
+ ****************************************************************************/
+
+static void bbr_update_model(FAR struct tcp_conn_s *conn,
+                             FAR struct tcp_bbr_s *bbr, clock_t now)
+{
+  clock_t interval = MAX(now - bbr->round_stamp, 1);
+  uint32_t rtt = TICK2USEC(interval);
+  uint64_t bw;
+  bool expired;
+
+  /* One delivery rate and one RTT sample per round.  Both are at the
+   * resolution of the system tick.
+   */
+
+  bw = (uint64_t)bbr->delivered * USEC_PER_SEC / rtt;
+  bbr->round = (bbr->round + 1) % TCP_BBR_BW_ROUNDS;
+  bbr->bw[bbr->round] = (uint32_t)MIN(bw, UINT32_MAX);
+
+  expired = now - bbr->min_rtt_stamp > BBR_MIN_RTT_WINDOW;
+  if (bbr->min_rtt == 0 || rtt <= bbr->min_rtt || expired)
+    {
+      bbr->min_rtt       = rtt;
+      bbr->min_rtt_stamp = now;
+    }
+
+  /* Leave STARTUP once the bandwidth stops growing */
+
+  if (!bbr->filled)
+    {
+      uint32_t maxbw = bbr_max_bw(bbr);
+
+      if ((uint64_t)maxbw * BBR_UNIT >=
+          (uint64_t)bbr->full_bw * BBR_FULL_BW_GAIN)
+        {
+          bbr->full_bw  = maxbw;
+          bbr->full_cnt = 0;
+        }
+      else if (++bbr->full_cnt >= BBR_FULL_BW_CNT)
+        {
+          bbr->filled = true;
+        }
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        if (bbr->filled)
+          {
+            bbr->mode = BBR_DRAIN;
+          }
+        break;
+
+      case BBR_DRAIN:
+        if (conn->tx_unacked <= bbr_bdp(bbr, BBR_UNIT))
+          {
+            bbr->mode  = BBR_PROBE_BW;
+            bbr->cycle = 0;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        bbr->cycle = (bbr->cycle + 1) % BBR_CYCLE_LEN;
+        break;
+
+      case BBR_PROBE_RTT:
+        if ((sclock_t)(now - bbr->probe_rtt_end) >= 0)
+          {
+            bbr->mode          = bbr->filled ? BBR_PROBE_BW : BBR_STARTUP;
+            bbr->min_rtt_stamp = now;
+            conn->cwnd         = MAX(conn->cwnd, bbr->prior_cwnd);
+          }
+        break;
+    }
+
+  /* min_rtt was not refreshed for a while: drain the queue for a moment
+   * to measure it again.
+   */
+
+  if (expired && bbr->mode != BBR_PROBE_RTT)
+    {
+      bbr->prior_cwnd     = conn->cwnd;
+      bbr->probe_rtt_end  = now + BBR_PROBE_RTT_TIME;
+      bbr->mode           = BBR_PROBE_RTT;
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+
+  memset(bbr, 0, sizeof(*bbr));
+  bbr->mode          = BBR_STARTUP;
+  bbr->min_rtt_stamp = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: bbr_ssthresh
+ *
+ * Description:
+ *   BBR does not treat loss as a congestion signal; keep the window.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->cwnd, BBR_MIN_CWND(conn));
+}
+
+/****************************************************************************
+ * Name: bbr_acked
+ *
+ * Description:
+ *   Account newly ACKed data and update the model and the pacing rate at
+ *   the end of each round.
+ *
+ ****************************************************************************/
+
+static void bbr_acked(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                      uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  clock_t now = clock_systime_ticks();
+  uint32_t gain;
+
+  if (!bbr->inround)
+    {
+      bbr_start_round(conn, bbr, now);
+      return;
+    }
+
+  bbr->delivered += acked;
+  if (!TCP_SEQ_GT(ackno, bbr->round_seq))
+    {
+      return;
+    }
+
+  bbr_update_model(conn, bbr, now);
+  bbr_start_round(conn, bbr, now);
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        gain = BBR_HIGH_GAIN;
+        break;
+
+      case BBR_DRAIN:
+        gain = BBR_DRAIN_GAIN;
+        break;
+
+      case BBR_PROBE_BW:
+        gain = g_bbr_cycle[bbr->cycle];
+        break;
+
+      default:
+        gain = BBR_UNIT;
+        break;
+    }
+
+  conn->pacing_rate = (uint32_t)MIN((uint64_t)bbr_max_bw(bbr) * gain /
+                                    BBR_UNIT, UINT32_MAX);
+  ninfo("bbr mode %u bw %" PRIu32 " min_rtt %" PRIu32 " pacing %" PRIu32
+        "\n", bbr->mode, bbr_max_bw(bbr), bbr->min_rtt, conn->pacing_rate);
+}
+
+/****************************************************************************
+ * Name: bbr_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd towards the estimated bandwidth-delay product times the cwnd
+ *   gain.  Until the bottleneck bandwidth is known it grows like slow
+ *   start.
+ *
+ ****************************************************************************/
+
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint32_t target;
+
+  if (bbr->mode == BBR_PROBE_RTT)
+    {
+      conn->cwnd = BBR_MIN_CWND(conn);
+      return;
+    }
+
+  target = bbr_bdp(bbr, bbr->mode == BBR_PROBE_BW ?
+                        BBR_CWND_GAIN : BBR_HIGH_GAIN);
+
+  TCP_CC_CWND_INC(conn->cwnd, acked);
+  if (bbr->filled && target > 0)
+    {
+      conn->cwnd = MIN(conn->cwnd, target);
+    }
+
+  conn->cwnd = MAX(conn->cwnd, BBR_MIN_CWND(conn));
+}
+
+/****************************************************************************
+ * Name: bbr_loss
+ *
+ * Description:
+ *   Retransmission timeout: restart from one segment.  The model is kept,
+ *   so cwnd climbs straight back to the bandwidth-delay product.
+ *
+ ****************************************************************************/
+
+static void bbr_loss(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+
+  bbr->prior_cwnd = conn->cwnd;
+  bbr->inround    = false;
+  conn->cwnd      = conn->mss;
+}
+
+#endif /* CONFIG_NET_TCP_CC_BBR */
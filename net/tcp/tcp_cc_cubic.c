@@ -0,0 +1,249 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Multiplicative decrease factor, 0.7 in units of 1/1024 */
+
+#define CUBIC_BETA          717
+
+/* The Reno-friendly additive increase 3 * (1 - beta) / (1 + beta), 0.529
+ * in units of 1/1024
+ */
+
+#define CUBIC_ALPHA         542
+
+/* The cubic function is W(t) = C * (t - K)^3 + W_max with C = 0.4 segments
+ * per second^3.  With t in milliseconds and W in bytes this is
+ * mss * (t - K)^3 * 2 / 5e9.
+ */
+
+#define CUBIC_C_NUM         2
+#define CUBIC_C_DEN         5000000000ull
+
+/* Clamp |t - K| so that its cube stays within 64 bits */
+
+#define CUBIC_MAX_DELTA_MS  100000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void cubic_loss(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",              /* name */
+  cubic_init,           /* init */
+  cubic_ssthresh,       /* ssthresh */
+  NULL,                 /* acked */
+  cubic_cong_avoid,     /* cong_avoid */
+  cubic_loss            /* loss */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cc.cubic, 0, sizeof(conn->cc.cubic));
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at which the loss happened, reduced further if it
+ *   is below the previous one (fast convergence), and back off by beta.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+
+  cubic->inepoch = false;
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint64_t)conn->cwnd * (1024 + CUBIC_BETA) / 2048;
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  return MAX((uint64_t)conn->cwnd * CUBIC_BETA / 1024, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Slow start below ssthresh, otherwise grow towards the cubic function of
+ *   the time since the last reduction, but never slower than Reno would.
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+  uint64_t target;
+  uint64_t delta;
+  int64_t offs;
+  clock_t now;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      TCP_CC_CWND_INC(conn->cwnd, MIN(acked, conn->mss));
+      ninfo("update slow start cwnd to %u\n", conn->cwnd);
+      return;
+    }
+
+  now = clock_systime_ticks();
+
+  if (!cubic->inepoch)
+    {
+      /* Start a new epoch: K = cbrt((W_max - cwnd) / C), in ms */
+
+      cubic->inepoch = true;
+      cubic->epoch   = now;
+      cubic->w_est   = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          cubic->k      = cubic_root((uint64_t)(cubic->w_max - conn->cwnd) *
+                                     (CUBIC_C_DEN / CUBIC_C_NUM) /
+                                     conn->mss);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  offs = (int64_t)TICK2MSEC(now - cubic->epoch) - cubic->k;
+  offs = MIN(MAX(offs, -CUBIC_MAX_DELTA_MS), CUBIC_MAX_DELTA_MS);
+
+  delta  = (uint64_t)(offs < 0 ? -offs : offs);
+  delta  = delta * delta * delta / 1000;
+  delta  = delta * conn->mss * CUBIC_C_NUM / (CUBIC_C_DEN / 1000);
+
+  if (offs >= 0)
+    {
+      target = cubic->origin + delta;
+    }
+  else
+    {
+      target = delta < cubic->origin ? cubic->origin - delta : 0;
+    }
+
+  /* Reno-friendly region */
+
+  cubic->w_est += (uint64_t)acked * conn->mss * CUBIC_ALPHA / 1024 /
+                  conn->cwnd;
+  target = MAX(target, cubic->w_est);
+
+  if (target > conn->cwnd)
+    {
+      uint64_t increase;
+
+      target   = MIN(target, (uint64_t)conn->cwnd * 3 / 2);
+      increase = (target - conn->cwnd) * acked / conn->cwnd;
+
+      TCP_CC_CWND_INC(conn->cwnd, (uint32_t)MAX(increase, 1));
+      ninfo("update cubic cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_loss
+ ****************************************************************************/
+
+static void cubic_loss(FAR struct tcp_conn_s *conn)
+{
+  conn->ssthresh = cubic_ssthresh(conn);
+  conn->cwnd     = conn->mss;
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -71,6 +72,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -95,10 +97,139 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The same connections hashed on their ports and remote address */
+
+static DECLARE_HASHTABLE(g_tcp_connhash, CONFIG_NET_TCP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_ipv4_hashkey and tcp_ipv6_hashkey
+ *
+ * Description:
+ *   Create the connection hash key from the local and remote ports and the
+ *   remote address, all in network order.  The local address is left out
+ *   so that connections bound to INADDR_ANY hash the same.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hashkey(in_addr_t raddr, uint16_t lport,
+                                        uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hashkey(FAR const uint16_t *raddr,
+                                        uint16_t lport, uint16_t rport)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return key;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_nexthash
+ *
+ * Description:
+ *   Traverse the active connections that may match the hash 'key'; all of
+ *   them without CONFIG_NET_TCP_CONN_HASH.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *
+  tcp_nexthash(FAR struct tcp_conn_s *conn, uint32_t key)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+
+  if (conn == NULL)
+    {
+      node = dq_peek(&g_tcp_connhash[HASH(key,
+                                     CONFIG_NET_TCP_CONN_HASH_BITS)]);
+    }
+  else
+    {
+      node = dq_next(&conn->hnode);
+    }
+
+  return node != NULL ? container_of(node, struct tcp_conn_s, hnode) : NULL;
+#else
+  UNUSED(key);
+  return tcp_nextconn(conn);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_conn_hashkey
+ *
+ * Description:
+ *   Create the connection hash key of an active connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static uint32_t tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_ipv6_hashkey(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_ipv4_hashkey(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_addactive and tcp_remactive
+ *
+ * Description:
+ *   Add a connection to or remove it from the list of active connections
+ *   (and the connection hashtable).  The ports and the remote address of
+ *   the connection must not change while it is active.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_add(g_tcp_connhash, &conn->hnode, tcp_conn_hashkey(conn));
+#endif
+}
+
+static void tcp_remactive(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_delete(g_tcp_connhash, &conn->hnode, tcp_conn_hashkey(conn));
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -194,10 +325,12 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
+  uint32_t key;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+  key        = tcp_ipv4_hashkey(srcipaddr, tcp->destport, tcp->srcport);
+  conn       = tcp_nexthash(NULL, key);
 
   while (conn)
     {
@@ -234,7 +367,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_nexthash(conn, key);
     }
 
   return conn;
@@ -261,10 +394,12 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+  uint32_t key;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+  key        = tcp_ipv6_hashkey(ip->srcipaddr, tcp->destport, tcp->srcport);
+  conn       = tcp_nexthash(NULL, key);
 
   while (conn)
     {
@@ -301,7 +436,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_nexthash(conn, key);
     }
 
   return conn;
@@ -608,6 +743,12 @@ int tcp_selectport(uint8_t domain,
 
 void tcp_initialize(void)
 {
+#ifdef CONFIG_NET_TCP_CONN_CACHE
+  if (NET_BUFPOOL_CACHE(g_tcp_connections, "tcp_conn") < 0)
+    {
+      nerr("ERROR: Failed to create the TCP connection cache\n");
+    }
+#endif
 }
 
 /****************************************************************************
@@ -837,6 +978,14 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
   tcp_stop_timer(conn);
 
+#ifdef CONFIG_NET_TCP_PACING
+  work_cancel(LPWORK, &conn->pacework);
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+  work_cancel(LPWORK, &conn->rack.work);
+#endif
+
   /* Make sure monitor is stopped. */
 
   tcp_stop_monitor(conn, TCP_CLOSE);
@@ -859,7 +1008,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_remactive(conn);
     }
 
   tcp_free_rx_buffers(conn);
@@ -887,6 +1036,19 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
 #endif
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+  /* Release SYN data that never made it out */
+
+  iob_free_chain(conn->tfo_iob);
+  conn->tfo_iob = NULL;
+#endif
+
+#ifdef CONFIG_NET_ZEROCOPY
+  /* Drop the MSG_ZEROCOPY completions nobody will read any more */
+
+  sock_zerocopy_purge(&conn->sconn);
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Remove any backlog attached to this connection */
 
@@ -973,6 +1135,42 @@ FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_conn_rotate
+ *
+ * Description:
+ *   Rotate the list of active TCP connections so that the connection
+ *   following conn becomes the first one.  devif_poll() calls this when the
+ *   driver stops the poll after the output of conn, so that the next poll
+ *   starts with the connections that were not served and conn is served
+ *   last.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_conn_rotate(FAR struct tcp_conn_s *conn)
+{
+  FAR dq_queue_t *list = &g_active_tcp_connections;
+  FAR dq_entry_t *node = &conn->sconn.node;
+  FAR dq_entry_t *next = node->flink;
+
+  if (next != NULL)
+    {
+      /* Move the entries from the head up to and including conn behind the
+       * tail.
+       */
+
+      list->tail->flink = list->head;
+      list->head->blink = list->tail;
+      next->blink       = NULL;
+      node->flink       = NULL;
+      list->head        = next;
+      list->tail        = node;
+    }
+}
+
 /****************************************************************************
  * Name: tcp_alloc_accept
  *
@@ -1102,10 +1300,16 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs         = listener->rcv_bufs;
 #endif
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+      conn->flags           |= listener->flags & TCP_RCVBUF_LOCK;
+#endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_FASTOPEN
+      conn->flags           |= listener->flags & TCP_TFO_LISTEN;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1131,8 +1335,11 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-      /* Initialize the variables of congestion control */
+      /* Initialize the variables of congestion control, using the
+       * algorithm selected on the listening socket.
+       */
 
+      conn->cc_ops           = listener->cc_ops;
       tcp_cc_init(conn);
 #endif
 
@@ -1156,7 +1363,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addactive(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1467,7 +1674,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
@@ -88,6 +88,17 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
   DEBUGASSERT(dev != NULL && conn != NULL && dev == conn->dev);
 
+  /* Nothing is sent for a connection that is not established unless its
+   * timer expired.  Skip it before an IOB is prepared for it.
+   */
+
+  if (!conn->timeout &&
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_ESTABLISHED)
+    {
+      dev->d_len = 0;
+      return;
+    }
+
   /* Prepare device buffer */
 
   if (netdev_iob_prepare(dev, false, 0) != OK)
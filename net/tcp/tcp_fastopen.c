@@ -0,0 +1,537 @@
+/****************************************************************************
+ * net/tcp/tcp_fastopen.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <crypto/siphash.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the remote address a cookie belongs to */
+
+#define TCP_FASTOPEN_ADDRLEN(conn) \
+  net_ip_domain_select((conn)->domain, sizeof(in_addr_t), \
+                       sizeof(net_ipv6addr_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One server cookie known to the client.  IPv4 and IPv6 addresses can not
+ * collide since their lengths differ.
+ */
+
+struct tcp_fastopen_entry_s
+{
+  uint8_t addrlen;                          /* Zero if the entry is free */
+  uint8_t cookielen;                        /* Length of the cookie */
+  uint8_t addr[16];                         /* Server address */
+  uint8_t cookie[TCP_FASTOPEN_COOKIE_MAX];  /* Server cookie */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The server side secret, generated on first use */
+
+static SIPHASH_KEY g_tcp_fastopen_key;
+
+/* The client cookie cache, entries are replaced round-robin */
+
+static struct tcp_fastopen_entry_s
+  g_tcp_fastopen_cache[CONFIG_NET_TCP_FASTOPEN_CACHE];
+static uint8_t g_tcp_fastopen_next;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_fastopen_gencookie
+ *
+ * Description:
+ *   Generate the cookie of the remote host of a connection, the first
+ *   TCP_FASTOPEN_COOKIE_LEN bytes of a SipHash-2-4 MAC of its address.
+ *
+ ****************************************************************************/
+
+static void tcp_fastopen_gencookie(FAR struct tcp_conn_s *conn,
+                                   FAR uint8_t *cookie)
+{
+  uint64_t mac;
+
+  /* Make sure we have a secret key */
+
+  if (g_tcp_fastopen_key.k0 == 0 && g_tcp_fastopen_key.k1 == 0)
+    {
+      arc4random_buf(&g_tcp_fastopen_key, sizeof(g_tcp_fastopen_key));
+    }
+
+  mac = siphash(&g_tcp_fastopen_key, 2, 4,
+                net_ip_binding_raddr(&conn->u, conn->domain),
+                TCP_FASTOPEN_ADDRLEN(conn));
+  memcpy(cookie, &mac, TCP_FASTOPEN_COOKIE_LEN);
+}
+
+/****************************************************************************
+ * Name: tcp_fastopen_lookup
+ *
+ * Description:
+ *   Find the cached cookie of the remote host of a connection.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_fastopen_entry_s *
+tcp_fastopen_lookup(FAR struct tcp_conn_s *conn)
+{
+  FAR const void *addr = net_ip_binding_raddr(&conn->u, conn->domain);
+  size_t addrlen = TCP_FASTOPEN_ADDRLEN(conn);
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TCP_FASTOPEN_CACHE; i++)
+    {
+      FAR struct tcp_fastopen_entry_s *entry = &g_tcp_fastopen_cache[i];
+
+      if (entry->addrlen == addrlen &&
+          memcmp(entry->addr, addr, addrlen) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_fastopen_findopt
+ *
+ * Description:
+ *   Find the Fast Open option in the TCP header of the packet in 'dev'.
+ *
+ * Returned Value:
+ *   The start of the option, its length byte checked against the header,
+ *   or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tcp_fastopen_findopt(FAR struct net_driver_s *dev,
+                                         unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  FAR uint8_t *opt = tcp->optdata;
+  int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  int i = 0;
+
+  while (i < optlen)
+    {
+      if (opt[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      /* All other options have a length field */
+
+      if (i + 1 >= optlen || opt[i + 1] < 2 || i + opt[i + 1] > optlen)
+        {
+          break;
+        }
+
+      if (opt[i] == TCP_OPT_FASTOPEN)
+        {
+          return &opt[i];
+        }
+
+      i += opt[i + 1];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_fastopen_synopt
+ *
+ * Description:
+ *   Build the Fast Open option of an outgoing SYN or SYN-ACK: a cookie
+ *   request or the cached cookie in the SYN of an active open, a new
+ *   cookie in the SYN-ACK of a server that was asked for one.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   flags  - The TCP flags of the segment, TCP_SYN or TCP_SYN | TCP_ACK
+ *   opt    - Where to put the option, room for 20 bytes
+ *
+ * Returned Value:
+ *   The length of the option, a multiple of four, or zero.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_fastopen_synopt(FAR struct tcp_conn_s *conn, uint8_t flags,
+                        FAR uint8_t *opt)
+{
+  uint8_t cookie[TCP_FASTOPEN_COOKIE_MAX];
+  int cookielen;
+  int pad;
+
+  if (flags == TCP_SYN && (conn->flags & TCP_TFO_CONNECT) != 0)
+    {
+      FAR struct tcp_fastopen_entry_s *entry = tcp_fastopen_lookup(conn);
+
+      if (entry != NULL)
+        {
+          cookielen = entry->cookielen;
+          memcpy(cookie, entry->cookie, cookielen);
+        }
+      else
+        {
+          /* No cookie yet, ask for one.  The data has to wait for the
+           * handshake this time.
+           */
+
+          iob_free_chain(conn->tfo_iob);
+          conn->tfo_iob = NULL;
+          cookielen     = 0;
+        }
+    }
+  else if (flags == (TCP_SYN | TCP_ACK) &&
+           (conn->flags & TCP_TFO_COOKIE) != 0)
+    {
+      tcp_fastopen_gencookie(conn, cookie);
+      cookielen = TCP_FASTOPEN_COOKIE_LEN;
+    }
+  else
+    {
+      return 0;
+    }
+
+  /* Pad in front so that the option ends on a word boundary */
+
+  pad = (4 - ((TCP_OPT_FASTOPEN_LEN + cookielen) & 3)) & 3;
+  memset(opt, TCP_OPT_NOOP, pad);
+
+  opt[pad]     = TCP_OPT_FASTOPEN;
+  opt[pad + 1] = TCP_OPT_FASTOPEN_LEN + cookielen;
+  memcpy(&opt[pad + 2], cookie, cookielen);
+
+  return pad + TCP_OPT_FASTOPEN_LEN + cookielen;
+}
+
+/****************************************************************************
+ * Name: tcp_fastopen_syndata
+ *
+ * Description:
+ *   Append the data queued by tcp_fastopen_sendto() to the SYN that
+ *   tcp_synack() is building.  This is only done once, a retransmitted
+ *   SYN goes without data.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_fastopen_syndata(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *conn)
+{
+  FAR struct iob_s *iob = conn->tfo_iob;
+
+  conn->tfo_iob = NULL;
+
+  /* The data follows the options, whose length is already in d_len.  It
+   * is no larger than the initial MSS, so it always fits the packet.
+   */
+
+  if (iob_clone_partial(iob, iob->io_pktlen, 0, dev->d_iob, dev->d_len,
+                        false, false) == OK)
+    {
+      /* Remember where the data starts to see how much gets ACKed */
+
+      conn->isn     = TCP_SEQ_ADD(tcp_getsequence(conn->sndseq), 1);
+      conn->tfo_len = iob->io_pktlen;
+      dev->d_len   += iob->io_pktlen;
+    }
+
+  iob_free_chain(iob);
+}
+
+/****************************************************************************
+ * Name: tcp_fastopen_checkcookie
+ *
+ * Description:
+ *   Check the Fast Open option of a SYN received by a listener.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN
+ *   conn   - The new connection created for the SYN
+ *   iplen  - The size of the IP header
+ *
+ * Returned Value:
+ *   OK if the SYN carries a valid cookie, -EINVAL if it asks for a cookie
+ *   or carries a stale one, -ENOENT if it has no Fast Open option.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_fastopen_checkcookie(FAR struct net_driver_s *dev,
+                             FAR struct tcp_conn_s *conn,
+                             unsigned int iplen)
+{
+  uint8_t cookie[TCP_FASTOPEN_COOKIE_LEN];
+  FAR uint8_t *opt;
+
+  opt = tcp_fastopen_findopt(dev, iplen);
+  if (opt == NULL)
+    {
+      return -ENOENT;
+    }
+
+  if (opt[1] != TCP_OPT_FASTOPEN_LEN + TCP_FASTOPEN_COOKIE_LEN)
+    {
+      return -EINVAL;
+    }
+
+  tcp_fastopen_gencookie(conn, cookie);
+  if (timingsafe_bcmp(&opt[2], cookie, TCP_FASTOPEN_COOKIE_LEN) != 0)
+    {
+      ninfo("Stale Fast Open cookie\n");
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_fastopen_synack
+ *
+ * Description:
+ *   Process the SYN-ACK of an active Fast Open: remember the cookie of the
+ *   server and find out how much of the SYN data it accepted.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN-ACK
+ *   conn   - The TCP connection of interest
+ *   iplen  - The size of the IP header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_fastopen_synack(FAR struct net_driver_s *dev,
+                         FAR struct tcp_conn_s *conn,
+                         unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  FAR struct tcp_fastopen_entry_s *entry;
+  FAR uint8_t *opt;
+  uint32_t acked = 0;
+  int cookielen;
+
+  entry = tcp_fastopen_lookup(conn);
+  opt   = tcp_fastopen_findopt(dev, iplen);
+
+  if (opt == NULL)
+    {
+      /* The server does not do Fast Open (any more) */
+
+      if (entry != NULL)
+        {
+          entry->addrlen = 0;
+        }
+    }
+  else
+    {
+      cookielen = opt[1] - TCP_OPT_FASTOPEN_LEN;
+      if (cookielen >= TCP_FASTOPEN_COOKIE_MIN &&
+          cookielen <= TCP_FASTOPEN_COOKIE_MAX)
+        {
+          if (entry == NULL)
+            {
+              entry = &g_tcp_fastopen_cache[g_tcp_fastopen_next];
+              g_tcp_fastopen_next = (g_tcp_fastopen_next + 1) %
+                                    CONFIG_NET_TCP_FASTOPEN_CACHE;
+
+              entry->addrlen = TCP_FASTOPEN_ADDRLEN(conn);
+              memcpy(entry->addr,
+                     net_ip_binding_raddr(&conn->u, conn->domain),
+                     entry->addrlen);
+            }
+
+          entry->cookielen = cookielen;
+          memcpy(entry->cookie, &opt[2], cookielen);
+        }
+    }
+
+  /* The SYN-ACK acknowledges the SYN and the part of the data the server
+   * accepted, which may be nothing.
+   */
+
+  if (conn->tfo_len > 0)
+    {
+      acked = TCP_SEQ_SUB(tcp_getsequence(tcp->ackno), conn->isn);
+      if (acked > conn->tfo_len)
+        {
+          acked = 0;
+        }
+    }
+
+  conn->tfo_len = acked;
+}
+
+/****************************************************************************
+ * Name: tcp_fastopen_sendto
+ *
+ * Description:
+ *   Implement sendto(MSG_FASTOPEN) on an unconnected TCP socket: connect
+ *   to 'to' with the start of 'buf' in the SYN if a cookie is cached for
+ *   the server, then send whatever the SYN-ACK did not acknowledge.
+ *
+ * Input Parameters:
+ *   psock  - An instance of the internal socket structure.
+ *   buf    - Data to send
+ *   len    - Length of data to send
+ *   flags  - Send flags
+ *   to     - Address of the server
+ *   tolen  - The length of the address structure
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value on failure.  A
+ *   non-blocking socket only requests a cookie and returns -EINPROGRESS
+ *   like connect().
+ *
+ ****************************************************************************/
+
+ssize_t tcp_fastopen_sendto(FAR struct socket *psock, FAR const void *buf,
+                            size_t len, int flags,
+                            FAR const struct sockaddr *to, socklen_t tolen)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  ssize_t nsent;
+  ssize_t ret;
+
+  net_lock();
+
+  if (conn->tcpstateflags != TCP_ALLOCATED)
+    {
+      net_unlock();
+      return -EISCONN;
+    }
+
+  conn->flags  |= TCP_TFO_CONNECT;
+  conn->tfo_len = 0;
+
+  /* A non-blocking connect() returns before the SYN-ACK tells how much of
+   * the data went through, so such sockets only collect a cookie.
+   */
+
+  if (len > 0 && !_SS_ISNONBLOCK(conn->sconn.s_flags) &&
+      (flags & MSG_DONTWAIT) == 0)
+    {
+      conn->tfo_iob = iob_tryalloc(false);
+      if (conn->tfo_iob != NULL &&
+          iob_trycopyin(conn->tfo_iob, buf, MIN(len, conn->mss), 0,
+                        false) < 0)
+        {
+          iob_free_chain(conn->tfo_iob);
+          conn->tfo_iob = NULL;
+        }
+    }
+
+  net_unlock();
+
+  ret = psock_connect(psock, to, tolen);
+
+  net_lock();
+  iob_free_chain(conn->tfo_iob);
+  conn->tfo_iob = NULL;
+  nsent         = conn->tfo_len;
+  net_unlock();
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Send what did not fit in the SYN or was not accepted with it */
+
+  if (nsent < len)
+    {
+      ret = psock_tcp_send(psock, (FAR const uint8_t *)buf + nsent,
+                           len - nsent, flags & ~MSG_FASTOPEN);
+      if (ret < 0)
+        {
+          return nsent > 0 ? nsent : ret;
+        }
+
+      nsent += ret;
+    }
+
+  return nsent;
+}
+
+#endif /* CONFIG_NET_TCP_FASTOPEN */
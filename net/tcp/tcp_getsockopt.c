@@ -26,15 +26,19 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
 #include <netinet/tcp.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
 #include <nuttx/net/tcp.h>
 
 #include "socket/socket.h"
@@ -43,6 +47,142 @@
 
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The retransmission timer counts half-seconds */
+
+#define TCP_HSEC2USEC(h)  ((uint32_t)(h) * (USEC_PER_SEC / 2))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_getinfo
+ *
+ * Description:
+ *   Fill in the TCP_INFO statistics of a connection.
+ *
+ ****************************************************************************/
+
+static void tcp_getinfo(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_info *info)
+{
+  static const uint8_t states[] =
+  {
+    TCPI_CLOSE,       /* TCP_CLOSED */
+    TCPI_CLOSE,       /* TCP_ALLOCATED */
+    TCPI_SYN_RECV,    /* TCP_SYN_RCVD */
+    TCPI_SYN_SENT,    /* TCP_SYN_SENT */
+    TCPI_ESTABLISHED, /* TCP_ESTABLISHED */
+    TCPI_FIN_WAIT1,   /* TCP_FIN_WAIT_1 */
+    TCPI_FIN_WAIT2,   /* TCP_FIN_WAIT_2 */
+    TCPI_CLOSING,     /* TCP_CLOSING */
+    TCPI_TIME_WAIT,   /* TCP_TIME_WAIT */
+    TCPI_LAST_ACK     /* TCP_LAST_ACK */
+  };
+
+  uint8_t state = conn->tcpstateflags & TCP_STATE_MASK;
+
+  memset(info, 0, sizeof(*info));
+
+  if (_SS_ISLISTENING(conn->sconn.s_flags))
+    {
+      info->tcpi_state = TCPI_LISTEN;
+    }
+  else if (state < nitems(states))
+    {
+      info->tcpi_state = states[state];
+    }
+  else
+    {
+      info->tcpi_state = TCPI_CLOSE;
+    }
+
+  if (conn->flags & TCP_SACK)
+    {
+      info->tcpi_options |= TCPI_OPT_SACK;
+    }
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (conn->flags & TCP_WSCALE)
+    {
+      info->tcpi_options   |= TCPI_OPT_WSCALE;
+      info->tcpi_snd_wscale = conn->snd_scale;
+      info->tcpi_rcv_wscale = conn->rcv_scale;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+  if (conn->flags & TCP_TFO_EARLY)
+    {
+      info->tcpi_options |= TCPI_OPT_SYN_DATA;
+    }
+#endif
+
+  info->tcpi_retransmits   = conn->nrtx;
+  info->tcpi_backoff       = conn->nrtx;
+  info->tcpi_total_retrans = conn->total_retrans;
+  info->tcpi_rto           = TCP_HSEC2USEC(conn->rto);
+  info->tcpi_snd_mss       = conn->mss;
+  info->tcpi_rcv_mss       = conn->mss;
+  info->tcpi_advmss        = conn->mss;
+  info->tcpi_unacked       = conn->tx_unacked;
+  info->tcpi_reordering    = TCP_FAST_RETRANSMISSION_THRESH;
+  if (conn->dev != NULL)
+    {
+      info->tcpi_pmtu = NETDEV_PKTSIZE(conn->dev) -
+                        NET_LL_HDRLEN(conn->dev);
+    }
+
+  /* Smoothed RTT and its variance as kept by the retransmission timer.
+   * They have the resolution of the timer, RACK has a better estimate.
+   */
+
+  info->tcpi_rtt           = TCP_HSEC2USEC(conn->sa >> 3);
+  info->tcpi_rttvar        = TCP_HSEC2USEC(conn->sv >> 2);
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  info->tcpi_retrans       = conn->expired;
+  info->tcpi_bytes_acked   = conn->sent - conn->tx_unacked;
+#ifdef CONFIG_NET_TCP_RACK
+  if (conn->rack.flags & TCP_RACK_SAMPLE)
+    {
+      info->tcpi_rtt       = TICK2USEC(conn->rack.srtt);
+      info->tcpi_min_rtt   = TICK2USEC(conn->rack.min_rtt);
+    }
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+  info->tcpi_rcv_rtt        = TICK2USEC(conn->drs_rtt);
+  info->tcpi_rcv_space      = conn->drs_space;
+  info->tcpi_bytes_received = conn->drs_copied;
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  info->tcpi_ca_state      = (conn->flags & TCP_INFR) != 0 ? 3 : 0;
+  info->tcpi_snd_cwnd      = conn->cwnd / MAX(conn->mss, 1);
+  info->tcpi_snd_ssthresh  = conn->ssthresh / MAX(conn->mss, 1);
+  info->tcpi_pacing_rate   = conn->pacing_rate;
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+  /* BBR measures the delivery rate once per round */
+
+  if (conn->cc_ops == &g_tcp_cc_bbr)
+    {
+      info->tcpi_delivery_rate = conn->cc.bbr.bw[conn->cc.bbr.round];
+      if (info->tcpi_min_rtt == 0)
+        {
+          info->tcpi_min_rtt = conn->cc.bbr.min_rtt;
+        }
+    }
+#endif
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -239,6 +379,48 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        if (*value_len == 0)
+          {
+            ret          = -EINVAL;
+          }
+        else
+          {
+            *value_len   = MIN(*value_len, TCP_CA_NAME_MAX);
+            strlcpy(value, tcp_cc_getalgo(conn), *value_len);
+            ret          = OK;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+      case TCP_FASTOPEN: /* Data in the SYN accepted */
+        if (*value_len < sizeof(int))
+          {
+            ret          = -EINVAL;
+          }
+        else
+          {
+            FAR int *tfo = (FAR int *)value;
+            *tfo         = (conn->flags & TCP_TFO_LISTEN) != 0;
+            *value_len   = sizeof(int);
+            ret          = OK;
+          }
+        break;
+#endif
+
+      case TCP_INFO:     /* Connection statistics */
+        {
+          struct tcp_info info;
+
+          tcp_getinfo(conn, &info);
+          *value_len = MIN(*value_len, sizeof(info));
+          memcpy(value, &info, *value_len);
+          ret        = OK;
+        }
+        break;
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
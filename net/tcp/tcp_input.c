@@ -53,6 +53,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -670,6 +671,156 @@ static void tcp_clear_zero_probe(FAR struct tcp_conn_s *conn,
     }
 }
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+/****************************************************************************
+ * Name: tcp_fastopen_accept
+ *
+ * Description:
+ *   Handle the Fast Open option of a SYN received by a listener.  With a
+ *   valid cookie the data in the SYN is queued for the application and
+ *   the new connection is established right away (RFC 7413, section 4.2).
+ *   Otherwise a cookie is handed out in the SYN-ACK if one was asked for,
+ *   and the usual three-way handshake follows.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN
+ *   conn   - The new connection created for the SYN
+ *   iplen  - The size of the IP header
+ *
+ * Returned Value:
+ *   true if the SYN was consumed and the SYN-ACK built, false if the
+ *   caller should answer with a normal SYN-ACK.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool tcp_fastopen_accept(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn,
+                                unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  unsigned int hdrlen = (tcp->tcpoffset >> 4) << 2;
+  uint16_t datalen;
+  int ret;
+
+  if ((conn->flags & TCP_TFO_LISTEN) == 0)
+    {
+      return false;
+    }
+
+  ret = tcp_fastopen_checkcookie(dev, conn, iplen);
+  if (ret == -EINVAL)
+    {
+      /* Hand out a new cookie, the peer sends the data again after the
+       * handshake.
+       */
+
+      conn->flags |= TCP_TFO_COOKIE;
+    }
+
+  datalen = dev->d_len - iplen - hdrlen;
+  if (ret < 0 || datalen == 0)
+    {
+      return false;
+    }
+
+  /* Establish the connection now and wake up accept() */
+
+  conn->tcpstateflags = TCP_ESTABLISHED;
+  if (tcp_accept_connection(dev, conn, tcp->destport) != OK)
+    {
+      conn->tcpstateflags = TCP_SYN_RCVD;
+      return false;
+    }
+
+  ninfo("TCP state: TCP_ESTABLISHED by Fast Open\n");
+
+  /* Our ISN goes out in the SYN-ACK below and our data starts right after
+   * it.  The SYN-ACK is not retransmitted from this state, a lost one is
+   * answered again when the peer retransmits its SYN.
+   */
+
+  conn->isn        = TCP_SEQ_ADD(tcp_getsequence(conn->sndseq), 1);
+  conn->sent       = 0;
+  conn->sndseq_max = 0;
+  conn->tx_unacked = 0;
+  conn->flags     |= TCP_TFO_EARLY;
+
+  /* The window in a SYN is never scaled */
+
+  conn->snd_wnd    = ((uint16_t)tcp->wnd[0] << 8) + tcp->wnd[1];
+  conn->snd_wl1    = tcp_getsequence(tcp->seqno);
+  conn->snd_wl2    = conn->isn;
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  /* A SYN acknowledges nothing, so pass on the acknowledgment the
+   * handshake would have brought.  The header is rebuilt for the SYN-ACK
+   * anyway.
+   */
+
+  tcp_setsequence(tcp->ackno, conn->isn);
+  tcp_cc_update(conn, tcp);
+#endif
+
+  /* Queue the data in the read-ahead buffer, this consumes the packet */
+
+  dev->d_len = datalen;
+  net_incr32(conn->rcvseq, tcp_datahandler(dev, conn, iplen + hdrlen));
+  dev->d_len = 0;
+
+  if (netdev_iob_prepare(dev, false, 0) == OK)
+    {
+      tcp_synack(dev, conn, TCP_ACK | TCP_SYN);
+    }
+
+  tcp_setsequence(conn->sndseq, conn->isn);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_fastopen_dupsyn
+ *
+ * Description:
+ *   Answer a retransmitted SYN on a connection established by
+ *   tcp_fastopen_accept(): the SYN-ACK was lost, send it again.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure holding the SYN
+ *   conn   - The TCP connection of interest
+ *   tcp    - Header of the SYN
+ *
+ * Returned Value:
+ *   true if the SYN-ACK was built, false if the SYN is not a
+ *   retransmission.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool tcp_fastopen_dupsyn(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn,
+                                FAR struct tcp_hdr_s *tcp)
+{
+  uint8_t sndseq[4];
+
+  if ((conn->flags & TCP_TFO_EARLY) == 0 ||
+      !TCP_SEQ_LT(tcp_getsequence(tcp->seqno),
+                  tcp_getsequence(conn->rcvseq)))
+    {
+      return false;
+    }
+
+  memcpy(sndseq, conn->sndseq, 4);
+  tcp_setsequence(conn->sndseq, TCP_SEQ_SUB(conn->isn, 1));
+  tcp_synack(dev, conn, TCP_ACK | TCP_SYN);
+  memcpy(conn->sndseq, sndseq, 4);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -726,7 +877,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #ifdef CONFIG_NET_TCP_CHECKSUMS
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!netdev_chksum_verified(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -753,6 +904,13 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
       if ((conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_RCVD &&
           (tcp->flags & TCP_CTL) == TCP_SYN)
         {
+#ifdef CONFIG_NET_TCP_FASTOPEN
+          if (tcp_fastopen_dupsyn(dev, conn, tcp))
+            {
+              return;
+            }
+#endif
+
           nwarn("WARNING: SYN in TCP_SYN_RCVD\n");
           goto reset;
         }
@@ -781,6 +939,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #  endif
         {
           net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+          net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
         }
 #endif
 
@@ -791,14 +950,17 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         {
           net_ipv4addr_copy(uaddr.ipv4.laddr,
                             net_ip4addr_conv32(IPv4BUF->destipaddr));
+          net_ipv4addr_copy(uaddr.ipv4.raddr,
+                            net_ip4addr_conv32(IPv4BUF->srcipaddr));
         }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if ((conn = tcp_findlistener(&uaddr, tmp16, domain)) != NULL)
+      conn = tcp_findlistener(&uaddr, tmp16, tcp->srcport, domain);
 #else
-      if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
+      conn = tcp_findlistener(&uaddr, tmp16, tcp->srcport);
 #endif
+      if (conn != NULL)
         {
           if (!tcp_backlogavailable(conn))
             {
@@ -862,6 +1024,13 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           tcp_parse_option(dev, conn, iplen);
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+          if (tcp_fastopen_accept(dev, conn, iplen))
+            {
+              return;
+            }
+#endif
+
           /* Our response will be a SYNACK. */
 
           tcp_synack(dev, conn, TCP_ACK | TCP_SYN);
@@ -920,6 +1089,7 @@ found:
 #  endif
             {
               net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+              net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
             }
 #endif
 
@@ -930,13 +1100,16 @@ found:
             {
               net_ipv4addr_copy(uaddr.ipv4.laddr,
                                 net_ip4addr_conv32(IPv4BUF->destipaddr));
+              net_ipv4addr_copy(uaddr.ipv4.raddr,
+                                net_ip4addr_conv32(IPv4BUF->srcipaddr));
             }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-          listener = tcp_findlistener(&uaddr, conn->lport, domain);
+          listener = tcp_findlistener(&uaddr, conn->lport, conn->rport,
+                                      domain);
 #else
-          listener = tcp_findlistener(&uaddr, conn->lport);
+          listener = tcp_findlistener(&uaddr, conn->lport, conn->rport);
 #endif
 
           /* We must free this TCP connection structure; this connection
@@ -1182,6 +1355,18 @@ found:
       if (((conn->tcpstateflags & TCP_STATE_MASK) == TCP_SYN_SENT) &&
           ((tcp->flags & TCP_SYN) == 0 && (tcp->flags & TCP_ACK) != 0))
         {
+#ifdef CONFIG_NET_TCP_FASTOPEN
+          /* A Fast Open server sends data right behind its SYN-ACK.  If
+           * the SYN-ACK was lost, wait for it to be sent again instead of
+           * resetting the connection the server already accepted.
+           */
+
+          if ((conn->flags & TCP_TFO_CONNECT) != 0)
+            {
+              goto drop;
+            }
+#endif
+
           /* Send the RST to close the half-open connection. */
 
           tcp_reset(dev, conn);
@@ -1354,6 +1539,13 @@ found:
 
             tcp_parse_option(dev, conn, iplen);
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+            if ((conn->flags & TCP_TFO_CONNECT) != 0)
+              {
+                tcp_fastopen_synack(dev, conn, iplen);
+              }
+#endif
+
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
             conn->rcv_adv = tcp_getsequence(conn->rcvseq);
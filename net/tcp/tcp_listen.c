@@ -50,25 +50,215 @@
 #include <stdbool.h>
 #include <debug.h>
 
+#include <nuttx/hashtable.h>
+#include <nuttx/sched.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+#  define tcp_reuseport(conn) _SO_GETOPT((conn)->sconn.s_options, SO_REUSEPORT)
+#else
+#  define tcp_reuseport(conn) false
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* All currently listening connections, hashed on the local port */
+
+static DECLARE_HASHTABLE(g_tcp_listeners, CONFIG_NET_TCP_CONN_HASH_BITS);
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_nextlistener
+ *
+ * Description:
+ *   Traverse the listening connections that may use the local port
+ *   'portno'.  'ndx' is the traversal state, -1 on the first call with
+ *   'conn' NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *tcp_nextlistener(FAR struct tcp_conn_s *conn,
+                                               uint16_t portno,
+                                               FAR int *ndx)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+
+  UNUSED(ndx);
+
+  if (conn == NULL)
+    {
+      node = dq_peek(&g_tcp_listeners[HASH(NTOHS(portno),
+                                    CONFIG_NET_TCP_CONN_HASH_BITS)]);
+    }
+  else
+    {
+      node = dq_next(&conn->lnode);
+    }
+
+  return node != NULL ? container_of(node, struct tcp_conn_s, lnode) : NULL;
+#else
+  UNUSED(conn);
+  UNUSED(portno);
+
+  while (++(*ndx) < CONFIG_NET_MAX_LISTENPORTS)
+    {
+      if (tcp_listenports[*ndx] != NULL)
+        {
+          return tcp_listenports[*ndx];
+        }
+    }
+
+  return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_listenmatch
+ *
+ * Description:
+ *   Return true if the listening connection 'conn' accepts connections to
+ *   the local address in 'uaddr' and the local port 'portno'.
+ *
+ ****************************************************************************/
+
+static bool tcp_listenmatch(FAR struct tcp_conn_s *conn,
+                            FAR union ip_binding_u *uaddr,
+                            uint16_t portno, uint8_t domain)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (conn->lport != portno || conn->domain != domain)
+#else
+  if (conn->lport != portno)
+#endif
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
+             net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
+             net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_listengroup
+ *
+ * Description:
+ *   Return true if the listening connections 'conn' and 'other' both have
+ *   SO_REUSEPORT set and are bound to the same local address, i.e. share
+ *   the incoming connections of their port.
+ *
+ ****************************************************************************/
+
+static bool tcp_listengroup(FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_conn_s *other, uint8_t domain)
+{
+  if (!tcp_reuseport(conn) || !tcp_reuseport(other))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, other->u.ipv6.laddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, other->u.ipv4.laddr);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_listenkey
+ *
+ * Description:
+ *   Hash the remote address in 'uaddr' and the remote port 'rport' to
+ *   choose a member of a SO_REUSEPORT group.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_listenkey(FAR union ip_binding_u *uaddr, uint16_t rport,
+                              uint8_t domain)
+{
+  uint32_t key = rport;
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      int i;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          key ^= ((uint32_t)uaddr->ipv6.raddr[i] << 16) |
+                 uaddr->ipv6.raddr[i + 1];
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      key ^= NTOHL(uaddr->ipv4.raddr);
+    }
+#endif
+
+  return HASH(key, 16);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -82,70 +272,106 @@ static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
+                                        uint16_t portno, uint16_t rport,
                                         uint8_t domain)
 #else
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno)
+                                        uint16_t portno, uint16_t rport)
 #endif
 {
-  int ndx;
+  FAR struct tcp_conn_s *first = NULL;
+  FAR struct tcp_conn_s *conn = NULL;
+  uint32_t nmembers = 0;
+  uint32_t member;
+  int ndx = -1;
+#ifdef CONFIG_NETDEV_RSS
+  uint32_t nlocal = 0;
+  int cpu = this_cpu();
+#endif
+#if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NET_IPv6)
+  uint8_t domain = PF_INET;
+#elif !defined(CONFIG_NET_IPv4)
+  uint8_t domain = PF_INET6;
+#endif
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine each listening connection that may use this port */
 
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  while ((conn = tcp_nextlistener(conn, portno, &ndx)) != NULL)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
+      if (!tcp_listenmatch(conn, uaddr, portno, domain))
+        {
+          continue;
+        }
+
+      /* The first listener found takes the connection unless it is part
+       * of a SO_REUSEPORT group.  Then count the members of the group.
        */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
-#else
-      if (conn && conn->lport == portno)
-#endif
+      if (first == NULL)
         {
-#ifdef CONFIG_NET_IPv6
-#  ifdef CONFIG_NET_IPv4
-          if (domain == PF_INET6)
-#  endif
+          if (!tcp_reuseport(conn))
             {
-              if (net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
-                  net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr))
-                {
-                  /* Yes.. we found a listener on this port */
-
-                  return conn;
-                }
+              return conn;
             }
-#endif
 
-#ifdef CONFIG_NET_IPv4
-#  ifdef CONFIG_NET_IPv6
-          if (domain == PF_INET)
-#  endif
-            {
-              if (net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
-                  net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
-                {
-                  /* Yes.. we found a listener on this port */
+          first = conn;
+        }
 
-                  return conn;
-                }
+      if (conn == first || tcp_listengroup(first, conn, domain))
+        {
+          nmembers++;
+#ifdef CONFIG_NETDEV_RSS
+          if (conn->rcvcpu == cpu)
+            {
+              nlocal++;
             }
 #endif
         }
     }
 
-  /* No listener for this port */
+  if (nmembers <= 1)
+    {
+      return first;
+    }
 
-  return NULL;
-}
+#ifdef CONFIG_NETDEV_RSS
+  /* RSS delivers a flow to one CPU.  Keep its connections there if some
+   * member last accepted on that CPU.
+   */
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+  if (nlocal > 0)
+    {
+      nmembers = nlocal;
+    }
+  else
+    {
+      cpu = -1;
+    }
+#endif
+
+  /* Spread the connections over the group by the remote address and port
+   * so that every segment of one connection selects the same member.
+   */
+
+  member = tcp_listenkey(uaddr, rport, domain) % nmembers;
+  conn   = NULL;
+  ndx    = -1;
+
+  while ((conn = tcp_nextlistener(conn, portno, &ndx)) != NULL)
+    {
+      if (tcp_listenmatch(conn, uaddr, portno, domain) &&
+          (conn == first || tcp_listengroup(first, conn, domain)) &&
+#ifdef CONFIG_NETDEV_RSS
+          (cpu < 0 || conn->rcvcpu == cpu) &&
+#endif
+          member-- == 0)
+        {
+          break;
+        }
+    }
+
+  return conn;
+}
 
 /****************************************************************************
  * Name: tcp_unlisten
@@ -160,15 +386,21 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR struct tcp_conn_s *listener = NULL;
+  int ndx = -1;
   int ret = -EINVAL;
 
   net_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  while ((listener = tcp_nextlistener(listener, conn->lport, &ndx)) != NULL)
     {
-      if (tcp_listenports[ndx] == conn)
+      if (listener == conn)
         {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+          hashtable_delete(g_tcp_listeners, &conn->lnode,
+                           NTOHS(conn->lport));
+#else
           tcp_listenports[ndx] = NULL;
+#endif
           ret = OK;
           break;
         }
@@ -191,8 +423,16 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
-  int ret;
+  FAR struct tcp_conn_s *listener = NULL;
+  int ndx = -1;
+  int ret = OK;
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t domain = conn->domain;
+#elif defined(CONFIG_NET_IPv4)
+  uint8_t domain = PF_INET;
+#else
+  uint8_t domain = PF_INET6;
+#endif
 
   /* This must be done with network locked because the listener table
    * is accessed from event processing logic as well.
@@ -200,24 +440,30 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   net_lock();
 
-  /* First, check if there is already a socket listening on this port */
+  /* First, check if there is already a socket listening on this port.  We
+   * must refuse this request unless both sockets have SO_REUSEPORT set
+   * and are bound to the same address.
+   */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
-#else
-  if (tcp_islistener(&conn->u, conn->lport))
-#endif
+  while ((listener = tcp_nextlistener(listener, conn->lport, &ndx)) != NULL)
     {
-      /* Yes, then we must refuse this request */
-
-      ret = -EADDRINUSE;
+      if (tcp_listenmatch(listener, &conn->u, conn->lport, domain) &&
+          !tcp_listengroup(listener, conn, domain))
+        {
+          ret = -EADDRINUSE;
+          break;
+        }
     }
-  else
+
+  if (ret == OK)
     {
       /* Otherwise, save a reference to the connection structure in the
        * "listener" list.
        */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      hashtable_add(g_tcp_listeners, &conn->lnode, NTOHS(conn->lport));
+#else
       ret = -ENOBUFS; /* Assume failure */
 
       /* Search all slots until an available slot is found */
@@ -235,6 +481,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
@@ -256,12 +503,12 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno,
                     uint8_t domain)
 {
-  return tcp_findlistener(uaddr, portno, domain) != NULL;
+  return tcp_findlistener(uaddr, portno, 0, domain) != NULL;
 }
 #else
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 {
-  return tcp_findlistener(uaddr, portno) != NULL;
+  return tcp_findlistener(uaddr, portno, 0) != NULL;
 }
 #endif
 
@@ -288,9 +535,9 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
    */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  listener = tcp_findlistener(&conn->u, portno, conn->domain);
+  listener = tcp_findlistener(&conn->u, portno, conn->rport, conn->domain);
 #else
-  listener = tcp_findlistener(&conn->u, portno);
+  listener = tcp_findlistener(&conn->u, portno, conn->rport);
 #endif
   if (listener != NULL)
     {
@@ -159,6 +159,20 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
           eventset |= POLLOUT;
         }
 
+#ifdef CONFIG_NET_ZEROCOPY
+      /* MSG_ZEROCOPY completions are queued when acknowledged data is
+       * released.  Like POLLOUT above this is speculative:  the write
+       * buffers are freed by psock_send_eventhandler after us.
+       */
+
+      if (sock_zerocopy_errpending(&info->conn->sconn) ||
+          ((flags & TCP_ACKDATA) != 0 &&
+           !sq_empty(&info->conn->sconn.s_zcpend)))
+        {
+          eventset |= POLLERR;
+        }
+#endif
+
       /* Awaken the caller of poll() if requested event occurred. */
 
       poll_notify(&info->fds, 1, eventset);
@@ -290,6 +304,17 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       cb->flags |= TCP_NEWDATA | TCP_BACKLOG;
     }
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* POLLERR is always polled:  watch for the acknowledgements that complete
+   * MSG_ZEROCOPY sends.
+   */
+
+  if (_SO_GETOPT(conn->sconn.s_options, SO_ZEROCOPY))
+    {
+      cb->flags |= TCP_ACKDATA;
+    }
+#endif
+
   /* Save the reference in the poll info structure as fds private as well
    * for use during poll teardown as well.
    */
@@ -305,6 +330,13 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLRDNORM;
     }
 
+#ifdef CONFIG_NET_ZEROCOPY
+  if (sock_zerocopy_errpending(&conn->sconn))
+    {
+      eventset |= POLLERR;
+    }
+#endif
+
   /* Check for a loss of connection events.  We need to be careful here.
    * There are four possibilities:
    *
@@ -780,6 +780,10 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
           info.tc_sem  = &state.ir_sem;
           tls_cleanup_push(tls_get_info(), tcp_callback_cleanup, &info);
 
+          /* With SO_BUSY_POLL, poll the device before going to sleep */
+
+          netdev_busypoll(conn->dev, &conn->sconn, &state.ir_sem);
+
           /* Wait for either the receive to complete or for an error/timeout
            * to occur.  net_sem_timedwait will also terminate if a signal is
            * received.
@@ -811,6 +815,13 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    * not only this particular connection.
    */
 
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+  if (ret > 0 && (flags & MSG_PEEK) == 0)
+    {
+      tcp_rcvbuf_adjust(conn, ret);
+    }
+#endif
+
   if (tcp_should_send_recvwindow(conn))
     {
       netdev_txnotify_dev(conn->dev);
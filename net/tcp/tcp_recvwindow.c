@@ -30,6 +30,8 @@
 #include <stdbool.h>
 #include <debug.h>
 
+#include <sys/param.h>
+
 #include <net/if.h>
 
 #include <nuttx/mm/iob.h>
@@ -43,6 +45,57 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_iob_quota_avail
+ *
+ * Description:
+ *   Return how many more IOBs the read-ahead buffer of the connection may
+ *   hold.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+static unsigned int tcp_iob_quota_avail(FAR struct tcp_conn_s *conn)
+{
+  FAR struct iob_s *iob;
+  unsigned int nused = 0;
+
+  for (iob = conn->readahead; iob != NULL; iob = iob->io_flink)
+    {
+      if (++nused >= CONFIG_NET_TCP_IOB_QUOTA)
+        {
+          return 0;
+        }
+    }
+
+  return CONFIG_NET_TCP_IOB_QUOTA - nused;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_limit
+ *
+ * Description:
+ *   The largest receive buffer autotuning may choose.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+static uint32_t tcp_rcvbuf_limit(void)
+{
+  uint32_t limit = CONFIG_NET_TCP_RCVBUF_MAX;
+
+#if CONFIG_NET_MAX_RECV_BUFSIZE > 0
+  limit = MIN(limit, CONFIG_NET_MAX_RECV_BUFSIZE);
+#endif
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+  limit = MIN(limit, CONFIG_NET_TCP_IOB_QUOTA * CONFIG_IOB_BUFSIZE);
+#endif
+
+  return limit;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_calc_rcvsize
  *
@@ -107,6 +160,9 @@ static uint32_t tcp_maxrcvwin(FAR struct tcp_conn_s *conn)
   recvwndo = tcp_calc_rcvsize(conn, (CONFIG_IOB_NBUFFERS -
                                      CONFIG_IOB_THROTTLE) *
                                      CONFIG_IOB_BUFSIZE);
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+  recvwndo = MIN(recvwndo, CONFIG_NET_TCP_IOB_QUOTA * CONFIG_IOB_BUFSIZE);
+#endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   recvwndo >>= conn->rcv_scale;
 #endif
@@ -221,6 +277,13 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 
   recvwndo = tcp_calc_rcvsize(conn, recvwndo);
 
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+  /* Do not invite more than the quota of the connection holds */
+
+  recvwndo = MIN(recvwndo, tailroom + tcp_iob_quota_avail(conn) *
+                           CONFIG_IOB_BUFSIZE);
+#endif
+
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
   /* Calculate the minimum desired size */
 
@@ -344,3 +407,142 @@ bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn)
         adv, mss, maxwin);
   return false;
 }
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_measure
+ *
+ * Description:
+ *   Take the receiver side RTT sample used by receive buffer autotuning.
+ *   A sample starts when a window is advertised and ends when data up to
+ *   its right edge has arrived, which takes one RTT when the sender is
+ *   limited by the window.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+void tcp_rcvbuf_measure(FAR struct tcp_conn_s *conn)
+{
+  uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
+  clock_t sample;
+  clock_t now;
+
+  if ((conn->flags & TCP_RCVBUF_LOCK) != 0 ||
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_ESTABLISHED)
+    {
+      return;
+    }
+
+  now = clock_systime_ticks();
+
+  if (conn->drs_inrtt)
+    {
+      if (TCP_SEQ_LT(rcvseq, conn->drs_rtt_seq))
+        {
+          return;
+        }
+
+      sample = MAX(now - conn->drs_rtt_time, 1);
+      if (conn->drs_rtt == 0)
+        {
+          conn->drs_rtt = sample;
+        }
+      else
+        {
+          conn->drs_rtt = (7 * conn->drs_rtt + sample) / 8;
+        }
+
+      conn->drs_inrtt = false;
+    }
+
+  if (TCP_SEQ_GT(conn->rcv_adv, rcvseq))
+    {
+      conn->drs_rtt_seq  = conn->rcv_adv;
+      conn->drs_rtt_time = now;
+      conn->drs_inrtt    = true;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rcvbuf_adjust
+ *
+ * Description:
+ *   Account data read by the application and, once per RTT, grow the
+ *   receive buffer to twice what was read during the last RTT.
+ *
+ ****************************************************************************/
+
+void tcp_rcvbuf_adjust(FAR struct tcp_conn_s *conn, size_t copied)
+{
+  uint32_t rcvbuf;
+  uint32_t space;
+  clock_t now;
+
+  conn->drs_copied += copied;
+
+  if ((conn->flags & TCP_RCVBUF_LOCK) != 0 || conn->drs_rtt == 0)
+    {
+      return;
+    }
+
+  now = clock_systime_ticks();
+  if (now - conn->drs_time < conn->drs_rtt)
+    {
+      return;
+    }
+
+  space = conn->drs_copied - conn->drs_start;
+
+  /* Grow only while the IOB pool is not under pressure; the memory is
+   * not given back but the window follows the free IOBs anyway.
+   */
+
+  if (space > conn->drs_space &&
+      iob_navail(true) >= (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE) / 4)
+    {
+      rcvbuf = MIN(2 * space, tcp_rcvbuf_limit());
+      if (rcvbuf > (uint32_t)conn->rcv_bufs)
+        {
+          ninfo("rcv_bufs %" PRId32 " -> %" PRIu32 " rtt=%lu\n",
+                conn->rcv_bufs, rcvbuf, (unsigned long)conn->drs_rtt);
+          conn->rcv_bufs = rcvbuf;
+        }
+    }
+
+  conn->drs_space = space;
+  conn->drs_start = conn->drs_copied;
+  conn->drs_time  = now;
+}
+#endif /* CONFIG_NET_TCP_RCVBUF_AUTOTUNE */
+
+/****************************************************************************
+ * Name: tcp_iob_quota_check
+ *
+ * Description:
+ *   Check if an I/O buffer chain may be added to the read-ahead buffer of
+ *   the connection.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_IOB_QUOTA > 0
+bool tcp_iob_quota_check(FAR struct tcp_conn_s *conn,
+                         FAR struct iob_s *iob)
+{
+  unsigned int avail;
+
+  if (conn->readahead == NULL)
+    {
+      return true;
+    }
+
+  avail = tcp_iob_quota_avail(conn);
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      if (avail-- == 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
@@ -163,6 +163,9 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Update the Receiver Window */
 
       conn->rcv_adv = rcvseq + recvwndo;
+#ifdef CONFIG_NET_TCP_RCVBUF_AUTOTUNE
+      tcp_rcvbuf_measure(conn);
+#endif
 
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
       recvwndo >>= conn->rcv_scale;
@@ -200,7 +203,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -224,7 +230,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -503,7 +512,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -523,7 +535,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
@@ -662,9 +677,22 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+  optlen += tcp_fastopen_synopt(conn, tcp->flags, &tcp->optdata[optlen]);
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
+#ifdef CONFIG_NET_TCP_FASTOPEN
+  /* The first SYN of a Fast Open carries data */
+
+  if (tcp->flags == TCP_SYN && conn->tfo_iob != NULL)
+    {
+      tcp_fastopen_syndata(dev, conn);
+    }
+#endif
+
   /* Complete the common portions of the TCP message */
 
   tcp_sendcommon(dev, conn, tcp);
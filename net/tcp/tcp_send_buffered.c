@@ -53,6 +53,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/tcp.h>
 #include <nuttx/net/net.h>
 
@@ -176,6 +177,8 @@ static void psock_writebuffer_notify(FAR struct tcp_conn_s *conn)
 static void retransmit_segment(FAR struct tcp_conn_s *conn,
                                FAR struct tcp_wrbuffer_s *wrb)
 {
+  conn->total_retrans++;
+
   /* Free any write buffers that have exceed the retry count */
 
   if (++TCP_WBNRTX(wrb) >= TCP_MAXRTX)
@@ -412,6 +415,580 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+#ifdef CONFIG_NET_TCP_PACING
+/****************************************************************************
+ * Name: tcp_pacing_work
+ *
+ * Description:
+ *   Poll the device again once the connection has gathered enough pacing
+ *   credit.
+ *
+ ****************************************************************************/
+
+static void tcp_pacing_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  net_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          netdev_txnotify_dev(conn->dev);
+          break;
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_allow
+ *
+ * Description:
+ *   Token bucket filled at the pacing rate of the connection.  The bucket
+ *   holds at least two segments or one tick worth of data, so that the
+ *   tick resolution of the wake-up does not cap the rate.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   sndlen - The size of the segment about to be sent
+ *
+ * Returned Value:
+ *   true if the segment may be sent now.  Otherwise a wake-up is scheduled
+ *   for when it may.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static bool tcp_pacing_allow(FAR struct tcp_conn_s *conn, size_t sndlen)
+{
+  uint32_t rate = conn->pacing_rate;
+  uint64_t credit;
+  uint32_t burst;
+  clock_t elapsed;
+  clock_t delay;
+  clock_t now;
+
+  if (rate == 0)
+    {
+      return true;
+    }
+
+  now              = clock_systime_ticks();
+  elapsed          = now - conn->pace_stamp;
+  conn->pace_stamp = now;
+
+  burst = MAX(rate / TICK_PER_SEC, 2 * (uint32_t)conn->mss);
+  burst = MAX(burst, sndlen);
+  if (elapsed >= TICK_PER_SEC)
+    {
+      credit = burst;
+    }
+  else
+    {
+      credit = conn->pace_credit + (uint64_t)rate * elapsed / TICK_PER_SEC;
+    }
+
+  conn->pace_credit = (uint32_t)MIN(credit, burst);
+  if (conn->pace_credit >= sndlen)
+    {
+      conn->pace_credit -= sndlen;
+      return true;
+    }
+
+  if (work_available(&conn->pacework))
+    {
+      delay = ((uint64_t)(sndlen - conn->pace_credit) * TICK_PER_SEC +
+               rate - 1) / rate;
+      work_queue(LPWORK, &conn->pacework, tcp_pacing_work, conn,
+                 MAX(delay, 1));
+    }
+
+  return false;
+}
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+/****************************************************************************
+ * Name: tcp_rack_work
+ *
+ * Description:
+ *   The reordering or probe timer expired.  Poll the device so that the
+ *   send event handler can act on it.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  net_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          conn->rack.flags |= TCP_RACK_FIRED;
+          netdev_txnotify_dev(conn->dev);
+          break;
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_rack_arm
+ *
+ * Description:
+ *   Arm the RACK timer as the reordering (TCP_RACK_REO) or the probe
+ *   (TCP_RACK_PTO) timer; only one of them runs at a time.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_arm(FAR struct tcp_conn_s *conn, uint8_t timer,
+                         clock_t delay)
+{
+  conn->rack.flags &= ~(TCP_RACK_REO | TCP_RACK_PTO | TCP_RACK_FIRED);
+  conn->rack.flags |= timer;
+  work_queue(LPWORK, &conn->rack.work, tcp_rack_work, conn, MAX(delay, 1));
+}
+
+/****************************************************************************
+ * Name: tcp_rack_update
+ *
+ * Description:
+ *   Take the RTT sample of a write buffer that has just been delivered,
+ *   either cumulatively or selectively acknowledged (RFC 8985, 6.2 step 2).
+ *
+ ****************************************************************************/
+
+static void tcp_rack_update(FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_wrbuffer_s *wrb, clock_t now)
+{
+  FAR struct tcp_rack_s *rack = &conn->rack;
+  uint32_t end = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+  clock_t rtt = now - TCP_WBXMIT(wrb);
+
+  /* The ACK of a buffer sent more than once may be for an earlier copy.
+   * Ignore a sample shorter than the path allows.
+   */
+
+  if ((TCP_WBNRTX(wrb) > 0 || (TCP_WBFLAGS(wrb) & TCP_WB_PROBED) != 0) &&
+      (rack->flags & TCP_RACK_SAMPLE) != 0 && rtt < rack->min_rtt)
+    {
+      return;
+    }
+
+  if ((rack->flags & TCP_RACK_SAMPLE) == 0)
+    {
+      rack->min_rtt = rtt;
+      rack->srtt    = rtt;
+      rack->flags  |= TCP_RACK_SAMPLE;
+    }
+  else
+    {
+      rack->min_rtt = MIN(rack->min_rtt, rtt);
+      rack->srtt    = (7 * rack->srtt + rtt) / 8;
+    }
+
+  rack->rtt = rtt;
+
+  /* Remember the most recently sent of the delivered buffers */
+
+  if ((sclock_t)(TCP_WBXMIT(wrb) - rack->xmit) > 0 ||
+      (TCP_WBXMIT(wrb) == rack->xmit && TCP_SEQ_GT(end, rack->end_seq)))
+    {
+      rack->xmit    = TCP_WBXMIT(wrb);
+      rack->end_seq = end;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rack_sack
+ *
+ * Description:
+ *   Update the scoreboard from the SACK blocks of an incoming ACK.  A write
+ *   buffer is marked once a single block covers all of it.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_sack(FAR struct tcp_conn_s *conn,
+                          FAR struct tcp_hdr_s *tcp, clock_t now)
+{
+  struct tcp_ofoseg_s segs[TCP_SACK_RANGES_MAX];
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t end;
+  int nsacks;
+  int i;
+
+  if ((tcp->tcpoffset & 0xf0) <= 0x50)
+    {
+      return;
+    }
+
+  nsacks = parse_sack(conn, tcp, segs);
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if ((TCP_WBFLAGS(wrb) & TCP_WB_SACKED) != 0)
+        {
+          continue;
+        }
+
+      end = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(end, segs[i].right))
+            {
+              TCP_WBFLAGS(wrb) |= TCP_WB_SACKED;
+              tcp_rack_update(conn, wrb, now);
+              break;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rack_detect
+ *
+ * Description:
+ *   Retransmit the write buffers that RACK deems lost (RFC 8985, 6.2 step
+ *   5) and arm the reordering timer for those that may still be.
+ *
+ * Returned Value:
+ *   The number of write buffers found lost.
+ *
+ ****************************************************************************/
+
+static int tcp_rack_detect(FAR struct tcp_conn_s *conn, clock_t now)
+{
+  FAR struct tcp_rack_s *rack = &conn->rack;
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  sclock_t remaining;
+  sclock_t timeout = 0;
+  clock_t reo_wnd;
+  int nlost = 0;
+
+  if ((rack->flags & TCP_RACK_SAMPLE) == 0)
+    {
+      return 0;
+    }
+
+  reo_wnd = rack->min_rtt / 4;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+    {
+      wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+      next = sq_next(entry);
+
+      /* Only a buffer sent before the last delivered one can be lost */
+
+      if ((TCP_WBFLAGS(wrb) & TCP_WB_SACKED) != 0 ||
+          (sclock_t)(TCP_WBXMIT(wrb) - rack->xmit) > 0 ||
+          (TCP_WBXMIT(wrb) == rack->xmit &&
+           TCP_SEQ_GTE(TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb),
+                       rack->end_seq)))
+        {
+          continue;
+        }
+
+      remaining = (sclock_t)(TCP_WBXMIT(wrb) + rack->rtt + reo_wnd - now);
+      if (remaining > 0)
+        {
+          timeout = MAX(timeout, remaining);
+          continue;
+        }
+
+      ninfo("RACK: lost wrb=%p seqno=%" PRIu32 " pktlen=%u\n",
+            wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb));
+
+      sq_rem(entry, &conn->unacked_q);
+      retransmit_segment(conn, wrb);
+      nlost++;
+    }
+
+  if (timeout > 0)
+    {
+      tcp_rack_arm(conn, TCP_RACK_REO, timeout);
+    }
+  else
+    {
+      rack->flags &= ~TCP_RACK_REO;
+    }
+
+  if (nlost > 0)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.sackrexmit += nlost;
+#endif
+
+      /* Start a recovery episode, the congestion window is reduced once
+       * for all the losses it repairs.
+       */
+
+      if ((rack->flags & TCP_RACK_RECOVERY) == 0)
+        {
+          rack->flags  |= TCP_RACK_RECOVERY;
+          rack->recover = conn->sndseq_max;
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.recovery++;
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+          if ((conn->flags & TCP_INFR) == 0)
+            {
+              conn->flags     |= TCP_INFT;
+              conn->fr_recover = conn->sndseq_max;
+              tcp_cc_update(conn, NULL);
+            }
+#endif
+        }
+    }
+
+  return nlost;
+}
+
+/****************************************************************************
+ * Name: tcp_rack_schedule
+ *
+ * Description:
+ *   Arm the probe timeout (RFC 8985, 7.2) if a tail loss probe could be
+ *   needed: data is in flight, no recovery or probe is in progress and the
+ *   reordering timer is not armed.  The probe is not armed if the
+ *   retransmission timer expires first.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_schedule(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_rack_s *rack = &conn->rack;
+  clock_t pto;
+
+  if ((rack->flags & (TCP_RACK_RECOVERY | TCP_RACK_TLP | TCP_RACK_REO)) != 0
+      || conn->tx_unacked == 0)
+    {
+      return;
+    }
+
+  if ((rack->flags & TCP_RACK_SAMPLE) != 0)
+    {
+      pto = 2 * rack->srtt;
+
+      /* Leave room for a delayed ACK if only one segment is in flight */
+
+      if (conn->tx_unacked <= conn->mss)
+        {
+          pto += MSEC2TICK(200);
+        }
+    }
+  else
+    {
+      pto = TICK_PER_SEC;
+    }
+
+  if (!work_available(&conn->work) &&
+      (sclock_t)pto >= work_timeleft(&conn->work))
+    {
+      rack->flags &= ~TCP_RACK_PTO;
+      return;
+    }
+
+  tcp_rack_arm(conn, TCP_RACK_PTO, pto);
+}
+
+/****************************************************************************
+ * Name: tcp_rack_ack
+ *
+ * Description:
+ *   RACK processing of an incoming ACK, after the cumulatively ACKed write
+ *   buffers have been released.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_ack(FAR struct tcp_conn_s *conn,
+                         FAR struct tcp_hdr_s *tcp, uint32_t ackno,
+                         clock_t now)
+{
+  FAR struct tcp_rack_s *rack = &conn->rack;
+
+  tcp_rack_sack(conn, tcp, now);
+
+  if ((rack->flags & TCP_RACK_RECOVERY) != 0 &&
+      TCP_SEQ_GTE(ackno, rack->recover))
+    {
+      rack->flags &= ~TCP_RACK_RECOVERY;
+    }
+
+  if ((rack->flags & TCP_RACK_TLP) != 0 &&
+      TCP_SEQ_GTE(ackno, rack->tlp_end))
+    {
+      rack->flags &= ~TCP_RACK_TLP;
+    }
+
+  tcp_rack_detect(conn, now);
+  tcp_rack_schedule(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_rack_probe
+ *
+ * Description:
+ *   Send a tail loss probe (RFC 8985, 7.3).  New data is preferred and is
+ *   left to the normal send path; otherwise the last MSS of the last write
+ *   buffer in flight is sent again.
+ *
+ * Returned Value:
+ *   true if the probe has been put in the device buffer.
+ *
+ ****************************************************************************/
+
+static bool tcp_rack_probe(FAR struct net_driver_s *dev,
+                           FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_rack_s *rack = &conn->rack;
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t offset;
+  size_t sndlen;
+  int ret;
+
+  rack->flags &= ~(TCP_RACK_PTO | TCP_RACK_FIRED);
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb != NULL && conn->snd_wnd > 0)
+    {
+      ninfo("RACK: probe with new data\n");
+
+      rack->flags  |= TCP_RACK_TLP;
+      rack->tlp_end = conn->sndseq_max + 1;
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.tlp++;
+#endif
+      return false;
+    }
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->unacked_q);
+  if (wrb == NULL)
+    {
+      return false;
+    }
+
+  sndlen = TCP_WBPKTLEN(wrb);
+  if (sndlen > conn->mss)
+    {
+      sndlen = conn->mss;
+    }
+
+  offset = TCP_WBPKTLEN(wrb) - sndlen;
+
+  ninfo("RACK: probe wrb=%p seqno=%" PRIu32 " sndlen=%zu\n",
+        wrb, TCP_WBSEQNO(wrb) + offset, sndlen);
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  tcp_ip_select(conn);
+#endif
+
+  tcp_setsequence(conn->sndseq, TCP_WBSEQNO(wrb) + offset);
+
+#ifdef CONFIG_NET_JUMBO_FRAME
+  netdev_iob_prepare_dynamic(dev, sndlen + tcpip_hdrsize(conn));
+#endif
+
+  ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, offset,
+                       tcpip_hdrsize(conn));
+  if (ret <= 0)
+    {
+      return false;
+    }
+
+  TCP_WBFLAGS(wrb) |= TCP_WB_PROBED;
+  TCP_WBXMIT(wrb)   = clock_systime_ticks();
+
+  rack->flags  |= TCP_RACK_TLP;
+  rack->tlp_end = conn->sndseq_max;
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.tlp++;
+#endif
+
+  tcp_update_retrantimer(conn, conn->rto);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_rack_rto
+ *
+ * Description:
+ *   The retransmission timer expired.  Queue every write buffer in flight
+ *   that the peer has not selectively acknowledged for retransmission.
+ *   The SACKed ones are marked again by the next ACKs, or retransmitted on
+ *   the next timeout if the peer discarded them.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_rto(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+    {
+      wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+      next = sq_next(entry);
+
+      if ((TCP_WBFLAGS(wrb) & TCP_WB_SACKED) != 0)
+        {
+          TCP_WBFLAGS(wrb) &= ~TCP_WB_SACKED;
+          continue;
+        }
+
+      sq_rem(entry, &conn->unacked_q);
+      retransmit_segment(conn, wrb);
+    }
+
+  conn->rack.flags &= ~(TCP_RACK_TLP | TCP_RACK_REO | TCP_RACK_PTO |
+                        TCP_RACK_FIRED);
+  conn->rack.flags |= TCP_RACK_RECOVERY;
+  conn->rack.recover = conn->sndseq_max;
+  work_cancel(LPWORK, &conn->rack.work);
+}
+#endif /* CONFIG_NET_TCP_RACK */
+
+/****************************************************************************
+ * Name: tcp_send_maxlen
+ *
+ * Description:
+ *   Return the largest amount of new data to put in one packet.  This is
+ *   one MSS, or a whole number of them if the device does segmentation
+ *   offload.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_send_maxlen(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NETDEV_GSO
+  uint32_t maxlen;
+
+  if (dev->d_gso_max > tcpip_hdrsize(conn) + 2 * conn->mss)
+    {
+      maxlen = dev->d_gso_max - tcpip_hdrsize(conn);
+      return maxlen - maxlen % conn->mss;
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -443,6 +1020,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
   uint32_t rexmitno = 0;
 #endif
+#ifdef CONFIG_NET_TCP_RACK
+  clock_t now = clock_systime_ticks();
+#endif
 
   /* Get the TCP connection pointer reliably from
    * the corresponding TCP socket.
@@ -547,6 +1127,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                   sq_rem(entry, &conn->unacked_q);
 
+#ifdef CONFIG_NET_TCP_RACK
+                  if ((TCP_WBFLAGS(wrb) & TCP_WB_SACKED) == 0)
+                    {
+                      tcp_rack_update(conn, wrb, now);
+                    }
+#endif
+
                   /* And return the write buffer to the pool of free
                    * buffers
                    */
@@ -591,6 +1178,20 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
           else if (ackno == TCP_WBSEQNO(wrb))
             {
+#ifdef CONFIG_NET_TCP_RACK
+              if ((conn->flags & TCP_SACK) != 0)
+                {
+                  /* RACK finds the losses from the SACK scoreboard, see
+                   * tcp_rack_ack().
+                   */
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+                  conn->flags &= ~TCP_INFT;
+#endif
+                  continue;
+                }
+#endif
+
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
               if (conn->dupacks >= TCP_FAST_RETRANSMISSION_THRESH)
 #else
@@ -608,7 +1209,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                        * driver to send the message and marked as rexmit
                        */
 
+#ifndef CONFIG_NET_TCP_CC_NEWRENO
                       TCP_WBNACK(wrb) = 0;
+#endif
                       conn->timeout = true;
                       netdev_txnotify_dev(conn->dev);
                       return flags;
@@ -681,6 +1284,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%" PRIu32 " pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_RACK
+      if ((conn->flags & TCP_SACK) != 0)
+        {
+          tcp_rack_ack(conn, tcp, ackno, now);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -707,6 +1317,32 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       return flags;
     }
 
+#ifdef CONFIG_NET_TCP_RACK
+  /* Act on an expired reordering or probe timer */
+
+  if ((flags & TCP_POLL) != 0 && dev->d_sndlen == 0 &&
+      (conn->rack.flags & TCP_RACK_FIRED) != 0)
+    {
+      if ((conn->rack.flags & TCP_RACK_PTO) != 0)
+        {
+          if (tcp_rack_probe(dev, conn))
+            {
+              flags &= ~TCP_POLL;
+              return flags;
+            }
+        }
+      else
+        {
+          conn->rack.flags &= ~TCP_RACK_FIRED;
+          if ((conn->rack.flags & TCP_RACK_REO) != 0)
+            {
+              tcp_rack_detect(conn, now);
+              tcp_rack_schedule(conn);
+            }
+        }
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
   if (rexmitno != 0)
     {
@@ -871,7 +1507,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
   if ((flags & TCP_REXMIT) != 0)
     {
       FAR struct tcp_wrbuffer_s *wrb;
+#ifndef CONFIG_NET_TCP_RACK
       FAR sq_entry_t *entry;
+#endif
 
       ninfo("REXMIT: %04x\n", flags);
 
@@ -888,6 +1526,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
           /* Increment the retransmit count on this write buffer. */
 
+          conn->total_retrans++;
           if (++TCP_WBNRTX(wrb) >= TCP_MAXRTX)
             {
               nwarn("WARNING: Expiring wrb=%p nrtx=%u\n",
@@ -961,10 +1600,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
        * write_q so they can be resent as soon as possible.
        */
 
+#ifdef CONFIG_NET_TCP_RACK
+      tcp_rack_rto(conn);
+#else
       while ((entry = sq_remlast(&conn->unacked_q)) != NULL)
         {
           retransmit_segment(conn, (FAR void *)entry);
         }
+#endif
     }
 
 #if CONFIG_NET_SEND_BUFSIZE > 0
@@ -1041,9 +1684,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_send_maxlen(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_send_maxlen(dev, conn);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1068,6 +1711,15 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = CONFIG_IOB_BUFSIZE;
             }
 
+#ifdef CONFIG_NET_TCP_PACING
+          /* Hold the segment back until the pacing rate allows it */
+
+          if (!tcp_pacing_allow(conn, sndlen))
+            {
+              return flags;
+            }
+#endif
+
           ninfo("SEND: wrb=%p seq=%" PRIu32 " pktlen=%u sent=%u sndlen=%zu "
                 "mss=%u snd_wnd=%" PRIu32 " seq=%" PRIu32
                 " remaining_snd_wnd=%" PRIu32 "\n",
@@ -1114,6 +1766,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NETDEV_GSO
+          /* Tell the device how to segment a packet larger than the MSS */
+
+          dev->d_gso_size = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
            * the amount of data sent. This will be needed in sequence
@@ -1141,6 +1799,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           /* Increment the count of bytes sent from this write buffer */
 
           TCP_WBSENT(wrb) += sndlen;
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb)  = now;
+#endif
 
           ninfo("SEND: wrb=%p sent=%u pktlen=%u\n",
                 wrb, TCP_WBSENT(wrb), TCP_WBPKTLEN(wrb));
@@ -1167,6 +1828,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               psock_insert_segment(wrb, &conn->unacked_q);
             }
 
+#ifdef CONFIG_NET_TCP_RACK
+          if ((conn->flags & TCP_SACK) != 0)
+            {
+              tcp_rack_schedule(conn);
+            }
+#endif
+
           /* Only one data can be sent by low level driver at once,
            * tell the caller stop polling the other connection.
            */
@@ -1202,6 +1870,12 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* or one segmentation offload packet */
+
+  size = MAX(size, CONFIG_NETDEV_GSO_MAXSIZE);
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -1316,6 +1990,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
   FAR const uint8_t *cp;
+#ifdef CONFIG_NET_ZEROCOPY
+  FAR struct sock_zerocopy_s *zc = NULL;
+  bool       copied = false;
+#endif
   unsigned int timeout;
   ssize_t    result = 0;
   bool       nonblock;
@@ -1375,6 +2053,27 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* MSG_ZEROCOPY is only honored if SO_ZEROCOPY was set on the socket,
+   * otherwise the flag is silently ignored.
+   */
+
+  if ((flags & MSG_ZEROCOPY) != 0 && len > 0 &&
+      _SO_GETOPT(conn->sconn.s_options, SO_ZEROCOPY))
+    {
+      zc = sock_zerocopy_alloc(&conn->sconn);
+      if (zc == NULL)
+        {
+          ret = -ENOBUFS;
+          goto errout;
+        }
+
+      /* Small sends are cheaper to copy */
+
+      copied = len < CONFIG_NET_ZEROCOPY_MINSIZE;
+    }
+#endif
+
   /* Dump the incoming buffer */
 
   BUF_DUMP("psock_tcp_send", buf, len);
@@ -1496,12 +2195,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             }
           else if (nonblock)
             {
-              wrb = tcp_wrbuffer_tryalloc();
+              wrb = tcp_wrbuffer_tryalloc(chunk_len);
               ninfo("new wrb %p (non blocking)\n", wrb);
             }
           else
             {
-              wrb = tcp_wrbuffer_timedalloc(tcp_send_gettimeout(start,
+              wrb = tcp_wrbuffer_timedalloc(chunk_len,
+                                            tcp_send_gettimeout(start,
                                                                 timeout));
               ninfo("new wrb %p\n", wrb);
             }
@@ -1528,6 +2228,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
           TCP_WBSEQNO(wrb) = (unsigned)-1;
           TCP_WBNRTX(wrb)  = 0;
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBFLAGS(wrb) = 0;
+#endif
 
           off = TCP_WBPKTLEN(wrb);
           if (off + chunk_len > max_wrb_size)
@@ -1547,7 +2250,32 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_ZEROCOPY
+          /* With MSG_ZEROCOPY append IOBs referring to the user data
+           * instead.  If they cannot be allocated fall back to copying.
+           */
+
+          chunk_result = -ENOMEM;
+          if (zc != NULL && !copied)
+            {
+              iob = sock_zerocopy_wrap(zc, cp, chunk_len);
+              if (iob != NULL)
+                {
+                  iob_concat(TCP_WBIOB(wrb), iob);
+                  chunk_result = chunk_len;
+                }
+              else
+                {
+                  copied = true;
+                }
+            }
+
+          if (chunk_result < 0)
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1672,6 +2400,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       goto errout;
     }
 
+#ifdef CONFIG_NET_ZEROCOPY
+  if (zc != NULL)
+    {
+      sock_zerocopy_done(zc, copied);
+    }
+#endif
+
   /* Return the number of bytes actually sent */
 
   return result;
@@ -1680,6 +2415,20 @@ errout_with_lock:
   net_unlock();
 
 errout:
+#ifdef CONFIG_NET_ZEROCOPY
+  if (zc != NULL)
+    {
+      if (result > 0)
+        {
+          sock_zerocopy_done(zc, copied);
+        }
+      else
+        {
+          sock_zerocopy_cancel(zc);
+        }
+    }
+#endif
+
   if (result > 0)
     {
       return result;
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/time.h>
 #include <stdint.h>
 #include <errno.h>
@@ -260,6 +261,46 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        if (value == NULL || value_len == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            net_lock();
+            ret = tcp_cc_setalgo(conn, value,
+                                 MIN(value_len, TCP_CA_NAME_MAX));
+            net_unlock();
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_FASTOPEN
+      case TCP_FASTOPEN: /* Accept data in the SYN, the queue length is
+                          * not limited beyond the listen backlog */
+        if (value_len != sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            net_lock();
+            if (*(FAR int *)value > 0)
+              {
+                conn->flags |= TCP_TFO_LISTEN;
+              }
+            else
+              {
+                conn->flags &= ~TCP_TFO_LISTEN;
+              }
+
+            net_unlock();
+          }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
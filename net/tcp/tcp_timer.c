@@ -536,9 +536,10 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
                   listener = tcp_findlistener(&conn->u, conn->lport,
-                                              conn->domain);
+                                              conn->rport, conn->domain);
 #else
-                  listener = tcp_findlistener(&conn->u, conn->lport);
+                  listener = tcp_findlistener(&conn->u, conn->lport,
+                                              conn->rport);
 #endif
                   if (listener != NULL)
                     {
@@ -601,6 +602,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
               conn->timer = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
               conn->nrtx++;
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
+              conn->total_retrans++;
+#endif
 
               /* Ok, so we need to retransmit. We do this differently
                * depending on which state we are in. In ESTABLISHED, we
@@ -652,22 +656,11 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
+                    /* Leave fast recovery and let the congestion control
+                     * algorithm reset cwnd and ssthresh.
+                     */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_loss(conn);
 #endif
                     goto done;
 
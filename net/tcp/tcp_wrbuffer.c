@@ -73,6 +73,8 @@ NET_BUFPOOL_DECLARE(g_wrbuffer, sizeof(struct tcp_wrbuffer_s),
  *   this wait will be terminated when the specified timeout expires.
  *
  * Input Parameters:
+ *   size      - The amount of data about to be queued, used to choose the
+ *               size class of the first I/O buffer.
  *   timeout   - The relative time to wait until a timeout is declared.
  *
  * Assumptions:
@@ -80,7 +82,8 @@ NET_BUFPOOL_DECLARE(g_wrbuffer, sizeof(struct tcp_wrbuffer_s),
  *
  ****************************************************************************/
 
-FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int timeout)
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int size,
+                                                   unsigned int timeout)
 {
   FAR struct tcp_wrbuffer_s *wrb;
 
@@ -100,7 +103,7 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int timeout)
 
   /* Now get the first I/O buffer for the write buffer structure */
 
-  wrb->wb_iob = net_iobtimedalloc(true, timeout);
+  wrb->wb_iob = net_iobtimedalloc_size(size, true, timeout);
 
   /* Did we get an IOB?  We should always get one except under some really
    * weird error conditions.
@@ -134,7 +137,7 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int timeout)
 
 FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
 {
-  return tcp_wrbuffer_timedalloc(UINT_MAX);
+  return tcp_wrbuffer_timedalloc(CONFIG_IOB_BUFSIZE, UINT_MAX);
 }
 
 /****************************************************************************
@@ -147,7 +150,8 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
  *   immediately if the allocation failed.
  *
  * Input parameters:
- *   None
+ *   size      - The amount of data about to be queued, used to choose the
+ *               size class of the first I/O buffer.
  *
  * Assumptions:
  *   Called from user logic with the network locked. Will return if no buffer
@@ -155,9 +159,9 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
  *
  ****************************************************************************/
 
-FAR struct tcp_wrbuffer_s *tcp_wrbuffer_tryalloc(void)
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_tryalloc(unsigned int size)
 {
-  return tcp_wrbuffer_timedalloc(0);
+  return tcp_wrbuffer_timedalloc(size, 0);
 }
 
 /****************************************************************************
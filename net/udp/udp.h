@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -111,6 +112,9 @@ struct udp_conn_s
   /* UDP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  hash_node_t hnode;      /* Link in the port hashtable while lport != 0 */
+#endif
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  flags;         /* See _UDP_FLAG_* definitions */
@@ -250,6 +254,30 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_reuseport
+ *
+ * Description:
+ *   Given the connection 'conn' that udp_active() found first for a
+ *   unicast datagram, return the member of its SO_REUSEPORT group that
+ *   receives the datagram.  Members whose last recvfrom() ran on this CPU
+ *   are preferred with CONFIG_NETDEV_RSS; among the candidates, the member
+ *   is chosen from the source address and port, so that one flow always
+ *   reaches the same socket.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport(FAR struct net_driver_s *dev,
+                                     FAR struct udp_conn_s *conn,
+                                     FAR struct udp_hdr_s *udp);
+#else
+#  define udp_reuseport(dev, conn, udp) (conn)
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -263,6 +291,20 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_conn_rotate
+ *
+ * Description:
+ *   Rotate the list of allocated UDP connections so that the connection
+ *   following conn is polled first by the next devif_poll().
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void udp_conn_rotate(FAR struct udp_conn_s *conn);
+
 /****************************************************************************
  * Name: udp_select_port
  *
@@ -282,6 +324,21 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of a connection, keeping the port hashtable up to
+ *   date.  All changes of conn->lport must go through this function.
+ *
+ * Input Parameters:
+ *   conn   - The UDP connection
+ *   portno - The new local port in network byte order, zero to unbind
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -512,6 +569,8 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void);
  *   this wait will be terminated when the specified timeout expires.
  *
  * Input Parameters:
+ *   len       - Size of the whole frame about to be queued, including the
+ *               link layer guard and the IP/UDP headers.
  *   timeout   - The relative time to wait until a timeout is declared.
  *
  * Assumptions:
@@ -520,7 +579,8 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void);
  ****************************************************************************/
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
-FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int timeout);
+FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int len,
+                                                   unsigned int timeout);
 #endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
 
 /****************************************************************************
@@ -533,7 +593,8 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int timeout);
  *   immediately if allocation fails.
  *
  * Input parameters:
- *   None
+ *   len       - Size of the whole frame about to be queued, including the
+ *               link layer guard and the IP/UDP headers.
  *
  * Assumptions:
  *   Called from user logic with the network locked.
@@ -541,11 +602,7 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int timeout);
  ****************************************************************************/
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
-#ifdef CONFIG_NET_JUMBO_FRAME
-FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(int len);
-#else
-FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(void);
-#endif
+FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(unsigned int len);
 #endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
 
 /****************************************************************************
@@ -753,6 +810,27 @@ void udp_callback_cleanup(FAR void *arg);
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Copy the datagrams already queued on a UDP SOCK_DGRAM socket into the
+ *   entries of 'msgvec' under one connection lock, without waiting.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   The messages to fill, already validated by the caller
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of datagrams received, possibly zero.
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
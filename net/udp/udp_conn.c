@@ -57,8 +57,10 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/sched.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -97,10 +99,51 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/* The connections with a local port, hashed on that port */
+
+static DECLARE_HASHTABLE(g_udp_porthash, CONFIG_NET_UDP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_nextport
+ *
+ * Description:
+ *   Traverse the connections that may be bound to the local port 'portno'
+ *   (network byte order); all of them without CONFIG_NET_UDP_CONN_HASH.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_nextport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  FAR hash_node_t *node;
+
+  if (conn == NULL)
+    {
+      node = dq_peek(&g_udp_porthash[HASH(NTOHS(portno),
+                                    CONFIG_NET_UDP_CONN_HASH_BITS)]);
+    }
+  else
+    {
+      node = dq_next(&conn->hnode);
+    }
+
+  return node != NULL ? container_of(node, struct udp_conn_s, hnode) : NULL;
+#else
+  UNUSED(portno);
+  return udp_nextconn(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -113,6 +156,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ *              SO_REUSEPORT: Likewise, the sockets then share the port.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -126,11 +170,12 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   FAR struct udp_conn_s *conn = NULL;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_shared = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure that may use this port. */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  while ((conn = udp_nextport(conn, portno)) != NULL)
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -141,6 +186,11 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         {
           continue;
         }
+
+      if (skip_shared && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
 #endif
 
       /* If the port local port number assigned to the connections matches
@@ -203,7 +253,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn)
     {
@@ -317,7 +367,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -343,7 +393,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -457,13 +507,95 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: udp_reusegroup
+ *
+ * Description:
+ *   Return true if the unconnected connection 'conn' shares the port and
+ *   local address of 'first' through SO_REUSEPORT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool udp_reusegroup(FAR struct udp_conn_s *first,
+                           FAR struct udp_conn_s *conn)
+{
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) ||
+      _UDP_ISCONNECTMODE(conn->flags) || conn->domain != first->domain ||
+      conn->lport != first->lport)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, first->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, first->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: udp_flowkey
+ *
+ * Description:
+ *   Hash the source address and port of the received datagram.
+ *
+ ****************************************************************************/
+
+static uint32_t udp_flowkey(FAR struct net_driver_s *dev,
+                            FAR struct udp_hdr_s *udp)
+{
+  uint32_t key = udp->srcport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+      int i;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          key ^= ((uint32_t)ip->srcipaddr[i] << 16) | ip->srcipaddr[i + 1];
+        }
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      key ^= NTOHL(net_ip4addr_conv32(ip->srcipaddr));
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return HASH(key, 16);
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -538,6 +670,48 @@ errout:
   return portno;
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of a connection, keeping the port hashtable up to
+ *   date.  All changes of conn->lport must go through this function.
+ *
+ * Input Parameters:
+ *   conn   - The UDP connection
+ *   portno - The new local port in network byte order, zero to unbind
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  net_lock();
+
+  if (conn->lport != 0)
+    {
+      hashtable_delete(g_udp_porthash, &conn->hnode, NTOHS(conn->lport));
+    }
+
+  conn->lport = portno;
+
+  /* Append, so that the connections of one port keep their bind order
+   * when udp_active() picks the first match.
+   */
+
+  if (portno != 0)
+    {
+      dq_addlast(&conn->hnode,
+                 &g_udp_porthash[HASH(NTOHS(portno),
+                                      CONFIG_NET_UDP_CONN_HASH_BITS)]);
+    }
+
+  net_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
 /****************************************************************************
  * Name: udp_initialize
  *
@@ -574,6 +748,7 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
     {
       /* Make sure that the connection is marked as uninitialized */
 
+      nxrmutex_init(&conn->sconn.s_lock);
       conn->sconn.s_ttl = IP_TTL_DEFAULT;
       conn->flags       = 0;
 #if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
@@ -622,8 +797,8 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+  udp_setport(conn, 0);
   nxmutex_lock(&g_free_lock);
-  conn->lport = 0;
 
   /* Remove the connection from the active list */
 
@@ -632,6 +807,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
   iob_free_chain(conn->readahead);
+  nxrmutex_destroy(&conn->sconn.s_lock);
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -692,6 +868,89 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_reuseport
+ *
+ * Description:
+ *   Given the connection 'conn' that udp_active() found first for a
+ *   unicast datagram, return the member of its SO_REUSEPORT group that
+ *   receives the datagram.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport(FAR struct net_driver_s *dev,
+                                     FAR struct udp_conn_s *conn,
+                                     FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *first = conn;
+  uint32_t nmembers = 0;
+  uint32_t member;
+#ifdef CONFIG_NETDEV_RSS
+  uint32_t nlocal = 0;
+  int cpu = this_cpu();
+#endif
+
+  /* A connected socket matched first keeps the datagram */
+
+  if (!udp_reusegroup(first, first))
+    {
+      return first;
+    }
+
+  for (; conn != NULL; conn = udp_active(dev, conn, udp))
+    {
+      if (udp_reusegroup(first, conn))
+        {
+          nmembers++;
+#ifdef CONFIG_NETDEV_RSS
+          if (conn->rcvcpu == cpu)
+            {
+              nlocal++;
+            }
+#endif
+        }
+    }
+
+  if (nmembers <= 1)
+    {
+      return first;
+    }
+
+#ifdef CONFIG_NETDEV_RSS
+  /* Keep the datagram on this CPU if a member is read from here */
+
+  if (nlocal > 0)
+    {
+      nmembers = nlocal;
+    }
+  else
+    {
+      cpu = -1;
+    }
+#endif
+
+  member = udp_flowkey(dev, udp) % nmembers;
+
+  for (conn = first; conn != NULL; conn = udp_active(dev, conn, udp))
+    {
+      if (udp_reusegroup(first, conn) &&
+#ifdef CONFIG_NETDEV_RSS
+          (cpu < 0 || conn->rcvcpu == cpu) &&
+#endif
+          member-- == 0)
+        {
+          break;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -715,6 +974,42 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_conn_rotate
+ *
+ * Description:
+ *   Rotate the list of allocated UDP connections so that the connection
+ *   following conn becomes the first one.  devif_poll() calls this when the
+ *   driver stops the poll after the output of conn, so that the next poll
+ *   starts with the connections that were not served and conn is served
+ *   last.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void udp_conn_rotate(FAR struct udp_conn_s *conn)
+{
+  FAR dq_queue_t *list = &g_active_udp_connections;
+  FAR dq_entry_t *node = &conn->sconn.node;
+  FAR dq_entry_t *next = node->flink;
+
+  if (next != NULL)
+    {
+      /* Move the entries from the head up to and including conn behind the
+       * tail.
+       */
+
+      list->tail->flink = list->head;
+      list->head->blink = list->tail;
+      next->blink       = NULL;
+      node->flink       = NULL;
+      list->head        = next;
+      list->tail        = node;
+    }
+}
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -852,7 +1147,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -877,7 +1172,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -929,7 +1224,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -246,7 +246,11 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (chksum != 0 && netdev_chksum_verified(dev))
+    {
+      chksum = 0;
+    }
+  else if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -326,6 +330,19 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
             }
 #endif
 
+#ifdef CONFIG_NET_SOCKOPTS
+          /* A unicast datagram goes to one member of a SO_REUSEPORT
+           * group.
+           */
+
+#  ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#  endif
+            {
+              conn = udp_reuseport(dev, conn, udp);
+            }
+#endif
+
           /* We can deliver the packet directly to the last listener. */
 
           ret = udp_input_conn(dev, conn, udpiplen);
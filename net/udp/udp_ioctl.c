@@ -114,6 +114,7 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
   int ret = OK;
 
   net_lock();
+  conn_lock(&conn->sconn);
 
   switch (cmd)
     {
@@ -151,6 +152,7 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
         break;
     }
 
+  conn_unlock(&conn->sconn);
   net_unlock();
 
   return ret;
@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -170,6 +171,18 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead
+ *
+ * Description:
+ *   Copy the first datagram of the read-ahead queue to the user buffer.
+ *   pstate->ir_recvlen is set to -1 if the queue is empty.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
@@ -687,16 +700,42 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Perform the UDP recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
-
-  net_lock();
   udp_recvfrom_initialize(conn, msg, &state, flags);
 
-  /* Copy the read-ahead data from the packet */
+  /* Datagrams that are already queued only need the connection lock.  This
+   * keeps the common case of a busy socket off the network lock.
+   */
 
+  conn_lock(&conn->sconn);
   udp_readahead(&state);
+  conn_unlock(&conn->sconn);
+
+  if (state.ir_recvlen > 0)
+    {
+#ifdef CONFIG_NETDEV_RSS
+      if (conn->rcvcpu != this_cpu())
+        {
+          net_lock();
+          udp_notify_recvcpu(conn);
+          net_unlock();
+        }
+#endif
+
+      udp_recvfrom_uninitialize(&state);
+      return state.ir_recvlen;
+    }
+
+  /* Otherwise look again with the network locked, since nothing must
+   * happen until we are ready to wait.
+   */
+
+  net_lock();
+  if (state.ir_recvlen < 0)
+    {
+      conn_lock(&conn->sconn);
+      udp_readahead(&state);
+      conn_unlock(&conn->sconn);
+    }
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -760,6 +799,10 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
           info.sem = &state.ir_sem;
           tls_cleanup_push(tls_get_info(), udp_callback_cleanup, &info);
 
+          /* With SO_BUSY_POLL, poll the device before going to sleep */
+
+          netdev_busypoll(dev, &conn->sconn, &state.ir_sem);
+
           /* Wait for either the receive to complete or for an error/timeout
            * to occur.  net_sem_timedwait will also terminate if a signal is
            * received.
@@ -791,4 +834,61 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Copy the datagrams already queued on a UDP SOCK_DGRAM socket into the
+ *   entries of 'msgvec', taking the connection lock once for all of them.
+ *   This never waits; the caller receives the first message of a batch
+ *   with psock_udp_recvfrom() so that blocking, timeouts and wakeups are
+ *   handled there only once.
+ *
+ * Input Parameters:
+ *   psock   Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec  The messages to fill, already validated by the caller
+ *   vlen    Number of entries in msgvec
+ *   flags   Receive flags
+ *
+ * Returned Value:
+ *   The number of datagrams received, possibly zero.
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  struct udp_recvfrom_s state;
+  unsigned int count;
+
+  conn_lock(&conn->sconn);
+
+  for (count = 0; count < vlen && conn->readahead != NULL; count++)
+    {
+      FAR struct msghdr *msg = &msgvec[count].msg_hdr;
+      unsigned long msg_controllen = msg->msg_controllen;
+      FAR void *msg_control = msg->msg_control;
+
+      udp_recvfrom_initialize(conn, msg, &state, flags);
+      udp_readahead(&state);
+      udp_recvfrom_uninitialize(&state);
+
+      /* Recover the cmsg pointer as psock_recvmsg() does */
+
+      msg->msg_control    = msg_control;
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+
+      if (state.ir_recvlen < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = state.ir_recvlen;
+    }
+
+  conn_unlock(&conn->sconn);
+  return count;
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
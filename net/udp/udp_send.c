@@ -60,6 +60,7 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "netdev/netdev.h"
 #include "socket/socket.h"
 #include "utils/utils.h"
 #include "udp/udp.h"
@@ -87,12 +88,25 @@
 static void udp_send_loopback(FAR struct net_driver_s *dev)
 {
   FAR struct iob_s *iob = netdev_iob_clone(dev, true);
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  uint8_t chksum_flags = dev->d_chksum_flags;
+#endif
+
   if (iob == NULL)
     {
       nerr("ERROR: IOB clone failed when looping UDP.\n");
       return;
     }
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* A checksum left to the device is not filled in for our own copy */
+
+  if ((chksum_flags & NETDEV_CHKSUM_PARTIAL) != 0)
+    {
+      dev->d_chksum_flags = NETDEV_CHKSUM_VERIFIED;
+    }
+#endif
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   if (IFF_IS_IPv4(dev->d_flags))
@@ -118,6 +132,10 @@ static void udp_send_loopback(FAR struct net_driver_s *dev)
   /* Restore device IOB with backup IOB */
 
   netdev_iob_replace(dev, iob);
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  dev->d_chksum_flags = chksum_flags;
+#endif
 }
 #endif
 
@@ -248,29 +266,32 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       iob_update_pktlen(dev->d_iob, dev->d_len, false);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum, unless the device does it. */
 
+      if (!netdev_chksum_offload(dev, IP_PROTO_UDP, &udp->udpchksum))
+        {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
-      if (IFF_IS_IPv4(dev->d_flags))
+          if (IFF_IS_IPv4(dev->d_flags))
 #endif
-        {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
-      else
+          else
 #endif
-        {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
-        {
-          udp->udpchksum = 0xffff;
+          if (udp->udpchksum == 0)
+            {
+              udp->udpchksum = 0xffff;
+            }
         }
 #endif /* CONFIG_NET_UDP_CHECKSUMS */
 
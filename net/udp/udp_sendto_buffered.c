@@ -258,7 +258,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -549,6 +549,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   FAR struct udp_wrbuffer_s *wrb;
   FAR struct udp_conn_s *conn;
   unsigned int timeout;
+  unsigned int wrblen;
   uint16_t udpiplen;
   bool nonblock;
   bool empty;
@@ -722,20 +723,22 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * unlocked here.
        */
 
+      wrblen = len + udpip_hdrsize(conn) + CONFIG_NET_LL_GUARDSIZE;
+
 #ifdef CONFIG_NET_JUMBO_FRAME
 
       /* alloc iob of gso pkt for udp data */
 
-      wrb = udp_wrbuffer_tryalloc(len + udpip_hdrsize(conn) +
-                                  CONFIG_NET_LL_GUARDSIZE);
+      wrb = udp_wrbuffer_tryalloc(wrblen);
 #else
       if (nonblock)
         {
-          wrb = udp_wrbuffer_tryalloc();
+          wrb = udp_wrbuffer_tryalloc(wrblen);
         }
       else
         {
-          wrb = udp_wrbuffer_timedalloc(udp_send_gettimeout(start,
+          wrb = udp_wrbuffer_timedalloc(wrblen,
+                                        udp_send_gettimeout(start,
                                                             timeout));
         }
 #endif
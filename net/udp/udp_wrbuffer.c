@@ -116,6 +116,8 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void)
  *   this wait will be terminated when the specified timeout expires.
  *
  * Input Parameters:
+ *   len       - Size of the whole frame about to be queued, including the
+ *               link layer guard and the IP/UDP headers.
  *   timeout   - The relative time to wait until a timeout is declared.
  *
  * Assumptions:
@@ -123,7 +125,8 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void)
  *
  ****************************************************************************/
 
-FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int timeout)
+FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int len,
+                                                   unsigned int timeout)
 {
   FAR struct udp_wrbuffer_s *wrb;
 
@@ -141,9 +144,12 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int timeout)
       return NULL;
     }
 
-  /* Now get the first I/O buffer for the write buffer structure */
+  /* Now get the first I/O buffer for the write buffer structure.  The
+   * buffer is handed to the device as is, so a buffer of a smaller class
+   * is only taken if the whole frame fits into it.
+   */
 
-  wrb->wb_iob = net_iobtimedalloc(true, timeout);
+  wrb->wb_iob = net_iobtimedalloc_size(len, true, timeout);
 
   /* Did we get an IOB?  We should always get one except under some really
    * weird error conditions.
@@ -169,7 +175,8 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int timeout)
  *   immediately if the allocation failed.
  *
  * Input parameters:
- *   None
+ *   len       - Size of the whole frame about to be queued, including the
+ *               link layer guard and the IP/UDP headers.
  *
  * Assumptions:
  *   Called from user logic with the network locked. Will return if no buffer
@@ -177,11 +184,7 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_timedalloc(unsigned int timeout)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_JUMBO_FRAME
-FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(int len)
-#else
-FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(void)
-#endif
+FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(unsigned int len)
 {
   FAR struct udp_wrbuffer_s *wrb;
 
@@ -205,7 +208,7 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(void)
 #ifdef CONFIG_NET_JUMBO_FRAME
     iob_alloc_dynamic(len);
 #else
-    iob_tryalloc(false);
+    iob_tryalloc_size(len, false);
 #endif
   if (!wrb->wb_iob)
     {
@@ -52,7 +52,9 @@
 struct usrsock_req_s
 {
   mutex_t  lock;              /* Request mutex (only one outstanding
-                               * request) */
+                               * request, or one request being handed to
+                               * the transport with
+                               * CONFIG_NET_USRSOCK_PIPELINE) */
   sem_t    acksem;            /* Request acknowledgment notification */
   uint32_t newxid;            /* New transcation Id */
   uint32_t ackxid;            /* Exchange id for which waiting ack */
@@ -663,6 +665,19 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
+#ifdef CONFIG_NET_USRSOCK_PIPELINE
+  /* The transport has copied the request out when usrsock_request()
+   * returns, so the request line is free for the requests of the other
+   * sockets while this one is in flight.  The caller waits for the
+   * response with USRSOCK_EVENT_REQ_COMPLETE.
+   */
+
+  ret = usrsock_request(iov, iovcnt);
+  if (ret < 0)
+    {
+      nerr("error: usrsock request failed with %d\n", ret);
+    }
+#else
   req->ackxid = req_head->xid;
 
   ret = usrsock_request(iov, iovcnt);
@@ -678,6 +693,7 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
     {
       nerr("error: usrsock request failed with %d\n", ret);
     }
+#endif
 
   /* Free request line for next command. */
 
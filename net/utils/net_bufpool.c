@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/kmem_cache.h>
 #include <nuttx/net/net.h>
 #include <nuttx/semaphore.h>
 
@@ -115,6 +116,19 @@ FAR void *net_bufpool_timedalloc(FAR struct net_bufpool_s *pool,
 
   /* If we get here, then we didn't exceed maxalloc. */
 
+#ifdef CONFIG_MM_KMEM_CACHE
+  if (pool->cache != NULL && sq_peek(&pool->freebuffers) == NULL)
+    {
+      node = kmem_cache_zalloc(pool->cache);
+      if (node == NULL)
+        {
+          nxsem_post(&pool->sem);
+        }
+
+      return node;
+    }
+#endif
+
   if (pool->dynalloc > 0 && sq_peek(&pool->freebuffers) == NULL)
     {
       node = kmm_zalloc(pool->nodesize * pool->dynalloc);
@@ -156,7 +170,16 @@ void net_bufpool_free(FAR struct net_bufpool_s *pool, FAR void *node)
       ((FAR char *)node < pool->pool ||
        (FAR char *)node >= pool->pool + pool->prealloc * pool->nodesize))
     {
-      kmm_free(node);
+#ifdef CONFIG_MM_KMEM_CACHE
+      if (pool->cache != NULL)
+        {
+          kmem_cache_free(pool->cache, node);
+        }
+      else
+#endif
+        {
+          kmm_free(node);
+        }
     }
   else
     {
@@ -197,3 +220,34 @@ int net_bufpool_test(FAR struct net_bufpool_s *pool)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: net_bufpool_cache
+ *
+ * Description:
+ *   Take the buffers of a pool that allocates every buffer dynamically
+ *   (dynalloc == 1) from a kmem_cache instead of the kernel heap.  Must be
+ *   called before the first buffer is allocated.
+ *
+ * Input Parameters:
+ *   pool - The pool whose dynamic buffers are cached
+ *   name - The name of the cache reported in /proc/mempool
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the cache cannot be created.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KMEM_CACHE
+int net_bufpool_cache(FAR struct net_bufpool_s *pool, FAR const char *name)
+{
+  DEBUGASSERT(pool->dynalloc == 1 && pool->cache == NULL);
+
+  /* The node size is still negated until the first allocation */
+
+  pool->cache = kmem_cache_create(name, pool->nodesize < 0 ?
+                                  -pool->nodesize : pool->nodesize,
+                                  0, NULL, NULL);
+  return pool->cache != NULL ? OK : -ENOMEM;
+}
+#endif
@@ -61,6 +61,11 @@ uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
   FAR const uint8_t *last_byte;
   uint16_t t;
 
+  if (len == 0)
+    {
+      return sum;
+    }
+
   dataptr = data;
   last_byte = data + len - 1;
 
@@ -76,6 +81,63 @@ uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
       dataptr += 1;
     }
 
+  /* Two bytes at a time up to a 32-bit boundary.  If the data is at an odd
+   * address, this goes on to the end.
+   */
+
+  while (dataptr < last_byte && ((uintptr_t)dataptr & 3) != 0)
+    {
+      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
+      sum += t;
+      if (sum < t)
+        {
+          sum++; /* carry */
+        }
+
+      dataptr += 2;
+    }
+
+  /* Then 16 bytes per step with aligned native loads.  The one's
+   * complement sum does not depend on byte order (RFC1071), so the native
+   * 16-bit halves are summed and the folded result swapped to network
+   * order at the end.  A 64-bit accumulator can not overflow for any
+   * uint16_t length.
+   */
+
+  if (((uintptr_t)dataptr & 3) == 0 && last_byte - dataptr >= 15)
+    {
+      FAR const uint32_t *wordptr = (FAR const uint32_t *)dataptr;
+      unsigned int nblocks = (last_byte - dataptr + 1) >> 4;
+      uint64_t acc = 0;
+
+      do
+        {
+          acc += wordptr[0];
+          acc += wordptr[1];
+          acc += wordptr[2];
+          acc += wordptr[3];
+          wordptr += 4;
+        }
+      while (--nblocks > 0);
+
+      dataptr = (FAR const uint8_t *)wordptr;
+
+      acc = (acc >> 32) + (acc & 0xffffffff);
+      acc = (acc >> 16) + (acc & 0xffff);
+      acc = (acc >> 16) + (acc & 0xffff);
+      acc = (acc >> 16) + (acc & 0xffff);
+
+      t = (uint16_t)acc;
+#ifndef CONFIG_ENDIAN_BIG
+      t = (uint16_t)((t << 8) | (t >> 8));
+#endif
+      sum += t;
+      if (sum < t)
+        {
+          sum++; /* carry */
+        }
+    }
+
   while (dataptr < last_byte)
     {
       /* At least two more bytes */
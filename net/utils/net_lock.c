@@ -114,6 +114,36 @@ _net_timedwait(FAR sem_t *sem, bool interruptible, unsigned int timeout)
   return ret;
 }
 
+/****************************************************************************
+ * Name: net_iobwait
+ *
+ * Description:
+ *   Wait for a default IOB with the network lock released.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+static FAR struct iob_s *net_iobwait(bool throttled, unsigned int timeout)
+{
+  FAR struct iob_s *iob;
+  unsigned int count;
+  int blresult;
+
+  /* There are no buffers available now.  We will have to wait for one to
+   * become available. But let's not do that with the network locked.
+   */
+
+  blresult = net_breaklock(&count);
+  iob      = iob_timedalloc(throttled, timeout);
+  if (blresult >= 0)
+    {
+      net_restorelock(count);
+    }
+
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -179,6 +209,32 @@ void net_unlock(void)
   nxrmutex_unlock(&g_netlock);
 }
 
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of one connection
+ *
+ ****************************************************************************/
+
+void conn_lock(FAR struct socket_conn_s *sconn)
+{
+  nxrmutex_lock(&sconn->s_lock);
+}
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of one connection
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn)
+{
+  nxrmutex_unlock(&sconn->s_lock);
+}
+
 /****************************************************************************
  * Name: net_breaklock
  *
@@ -421,19 +477,40 @@ FAR struct iob_s *net_iobtimedalloc(bool throttled, unsigned int timeout)
   iob = iob_tryalloc(throttled);
   if (iob == NULL && timeout != 0)
     {
-      unsigned int count;
-      int blresult;
+      iob = net_iobwait(throttled, timeout);
+    }
 
-      /* There are no buffers available now.  We will have to wait for one to
-       * become available. But let's not do that with the network locked.
-       */
+  return iob;
+}
 
-      blresult = net_breaklock(&count);
-      iob      = iob_timedalloc(throttled, timeout);
-      if (blresult >= 0)
-        {
-          net_restorelock(count);
-        }
+/****************************************************************************
+ * Name: net_iobtimedalloc_size
+ *
+ * Description:
+ *   The same as net_iobtimedalloc() but first try to take the smallest IOB
+ *   that holds 'size' bytes, see iob_tryalloc_size().  Only default IOBs
+ *   are waited for.
+ *
+ * Input Parameters:
+ *   size       - The number of bytes that the IOB is expected to hold
+ *   throttled  - An indication of the IOB allocation is "throttled"
+ *   timeout    - The relative time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   A pointer to the newly allocated IOB is returned on success.  NULL is
+ *   returned on any allocation failure.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *net_iobtimedalloc_size(unsigned int size, bool throttled,
+                                         unsigned int timeout)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_tryalloc_size(size, throttled);
+  if (iob == NULL && timeout != 0)
+    {
+      iob = net_iobwait(throttled, timeout);
     }
 
   return iob;
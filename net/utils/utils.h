@@ -104,6 +104,7 @@
 #define NET_BUFPOOL_ALLOC(p)        net_bufpool_timedalloc(&p, UINT_MAX)
 #define NET_BUFPOOL_FREE(p,n)       net_bufpool_free(&p, n)
 #define NET_BUFPOOL_TEST(p)         net_bufpool_test(&p)
+#define NET_BUFPOOL_CACHE(p,n)      net_bufpool_cache(&p, n)
 
 /****************************************************************************
  * Public Types
@@ -132,6 +133,10 @@ struct net_bufpool_s
   sem_t      sem;      /* The semaphore for waiting for free buffers */
 
   sq_queue_t freebuffers;
+
+#ifdef CONFIG_MM_KMEM_CACHE
+  FAR struct kmem_cache_s *cache; /* The object cache of dynamic buffers */
+#endif
 };
 
 /****************************************************************************
@@ -414,6 +419,27 @@ void net_bufpool_free(FAR struct net_bufpool_s *pool, FAR void *node);
 
 int net_bufpool_test(FAR struct net_bufpool_s *pool);
 
+/****************************************************************************
+ * Name: net_bufpool_cache
+ *
+ * Description:
+ *   Take the buffers of a pool that allocates every buffer dynamically
+ *   (dynalloc == 1) from a kmem_cache instead of the kernel heap.  Must be
+ *   called before the first buffer is allocated.
+ *
+ * Input Parameters:
+ *   pool - The pool whose dynamic buffers are cached
+ *   name - The name of the cache reported in /proc/mempool
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the cache cannot be created.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KMEM_CACHE
+int net_bufpool_cache(FAR struct net_bufpool_s *pool, FAR const char *name);
+#endif
+
 /****************************************************************************
  * Name: net_chksum_adjust
  *
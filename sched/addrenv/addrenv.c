@@ -28,12 +28,16 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 
 #include <nuttx/addrenv.h>
 #include <nuttx/irq.h>
 #include <nuttx/sched.h>
+#include <nuttx/vdso.h>
 #include <nuttx/wqueue.h>
 
+#include <sys/mman.h>
+
 #include "sched/sched.h"
 
 /****************************************************************************
@@ -55,6 +59,24 @@
 
 static FAR struct addrenv_s *g_addrenv[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+/* ASIDs are handed out in generations.  An address environment keeps its
+ * ASID for as long as the generation it was allocated in is the current
+ * one; when the ASIDs run out a new generation is started and each CPU
+ * invalidates its TLB once before it switches to an address environment
+ * again, so no stale entry can be hit through a recycled ASID.
+ *
+ * ASID 0 is never handed out, it remains for up_addrenv_select().
+ *
+ * These must only be accessed inside a critical section.
+ */
+
+static uint64_t g_asid_gen;                  /* Current generation */
+static uint32_t g_asid_next;                 /* Next unused ASID */
+static uint32_t g_asid_count;                /* Number of ASIDs, 0: unknown */
+static bool     g_asid_flush[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -79,6 +101,15 @@ static void addrenv_destroy(FAR void *arg)
 {
   FAR struct addrenv_s *addrenv = (FAR struct addrenv_s *)arg;
 
+#ifdef CONFIG_CLOCK_VDSO
+  /* The clock data page is shared, take it out before the address
+   * environment releases its pages.  It is not mapped if the process
+   * never got as far as addrenv_attach().
+   */
+
+  up_addrenv_unmap_pages(&addrenv->addrenv, CONFIG_ARCH_VDSO_VBASE, 1);
+#endif
+
   /* Destroy the address environment */
 
   up_addrenv_destroy(&addrenv->addrenv);
@@ -88,6 +119,76 @@ static void addrenv_destroy(FAR void *arg)
   kmm_free(addrenv);
 }
 
+/****************************************************************************
+ * Name: addrenv_asid_select
+ *
+ * Description:
+ *   Instantiate an address environment with its ASID, allocating a new ASID
+ *   first if the one it holds is from an older generation.  Must be called
+ *   inside a critical section.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to instantiate.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+static int addrenv_asid_select(FAR struct addrenv_s *addrenv)
+{
+  int cpu = this_cpu();
+  bool flush;
+  int bits;
+  int i;
+
+  if (g_asid_count == 0)
+    {
+      bits = up_addrenv_asid_bits();
+      if (bits > CONFIG_ARCH_ADDRENV_ASID_BITS)
+        {
+          bits = CONFIG_ARCH_ADDRENV_ASID_BITS;
+        }
+
+      /* With less than two ASIDs there is nothing to tag with */
+
+      g_asid_count = bits > 0 ? 1 << bits : 1;
+      g_asid_gen   = g_asid_count;
+      g_asid_next  = 1;
+    }
+
+  if (g_asid_count < 2)
+    {
+      return up_addrenv_select(&addrenv->addrenv);
+    }
+
+  if ((addrenv->asid & ~(uint64_t)(g_asid_count - 1)) != g_asid_gen)
+    {
+      if (g_asid_next == g_asid_count)
+        {
+          /* Out of ASIDs, start over with a new generation */
+
+          g_asid_gen  += g_asid_count;
+          g_asid_next  = 1;
+
+          for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+            {
+              g_asid_flush[i] = true;
+            }
+        }
+
+      addrenv->asid = g_asid_gen | g_asid_next++;
+    }
+
+  flush = g_asid_flush[cpu];
+  g_asid_flush[cpu] = false;
+
+  return up_addrenv_asid_select(&addrenv->addrenv,
+                                addrenv->asid & (g_asid_count - 1), flush);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -181,7 +282,11 @@ int addrenv_switch(FAR struct tcb_s *tcb)
        * instantiated.
        */
 
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+      ret = addrenv_asid_select(next);
+#else
       ret = up_addrenv_select(&next->addrenv);
+#endif
       if (ret < 0)
         {
           berr("ERROR: up_addrenv_select failed: %d\n", ret);
@@ -237,7 +342,8 @@ FAR struct addrenv_s *addrenv_allocate(void)
  *
  * Description:
  *   Attach address environment to a newly created group. Called by exec()
- *   right before injecting the new process into the system.
+ *   right before injecting the new process into the system.  With
+ *   CONFIG_CLOCK_VDSO the clock data page is mapped into it here.
  *
  * Input Parameters:
  *   tcb     - The tcb of the newly loaded task.
@@ -252,6 +358,25 @@ FAR struct addrenv_s *addrenv_allocate(void)
 
 int addrenv_attach(FAR struct tcb_s *tcb, FAR struct addrenv_s *addrenv)
 {
+#ifdef CONFIG_CLOCK_VDSO
+  uintptr_t page = clock_vdso_page();
+  int ret;
+
+  /* Map the clock data page, read-only, for clock_gettime() in libc */
+
+  if (page == 0)
+    {
+      return -ENOMEM;
+    }
+
+  ret = up_addrenv_map_pages(&addrenv->addrenv, &page, 1,
+                             CONFIG_ARCH_VDSO_VBASE, PROT_READ);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Attach the address environment */
 
   tcb->addrenv_own = addrenv;
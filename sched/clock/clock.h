@@ -33,6 +33,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/compiler.h>
+#include <nuttx/seqlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -66,6 +67,12 @@ extern volatile clock_t g_system_ticks;
 
 #ifndef CONFIG_CLOCK_TIMEKEEPING
 extern struct timespec  g_basetime;
+
+/* Serializes the updates of g_basetime.  Readers use read_seqbegin() and
+ * read_seqretry() and never block.
+ */
+
+extern seqlock_t        g_basetime_lock;
 #endif
 
 /****************************************************************************
@@ -81,6 +88,14 @@ void clock_timer(void);
 #  define clock_timer()
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_initialize(void);
+void clock_vdso_update(void);
+#else
+#  define clock_vdso_initialize()
+#  define clock_vdso_update()
+#endif
+
 /****************************************************************************
  * perf_init
  ****************************************************************************/
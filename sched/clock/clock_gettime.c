@@ -47,7 +47,7 @@
  * Private Functions
  ****************************************************************************/
 
-#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+#ifdef CONFIG_SCHED_CPUTIME
 static clock_t clock_process_runtime(FAR struct tcb_s *tcb)
 {
 # ifdef HAVE_GROUP_MEMBERS
@@ -63,13 +63,13 @@ static clock_t clock_process_runtime(FAR struct tcb_s *tcb)
     {
       tcb = container_of(curr, struct tcb_s, member);
 
-      runtime += tcb->run_time;
+      runtime += nxsched_get_cputime(tcb);
     }
 
   spin_unlock_irqrestore(NULL, flags);
   return runtime;
 # else  /* HAVE_GROUP_MEMBERS */
-  return tcb->run_time;
+  return nxsched_get_cputime(tcb);
 # endif /* HAVE_GROUP_MEMBERS */
 }
 #endif
@@ -99,8 +99,9 @@ void nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp)
   else if (clock_id == CLOCK_REALTIME)
     {
 #ifndef CONFIG_CLOCK_TIMEKEEPING
+      struct timespec base;
       struct timespec ts;
-      irqstate_t flags;
+      uint32_t seq;
 
       clock_systime_timespec(&ts);
 
@@ -109,16 +110,21 @@ void nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp)
        * was last set, this gives us the current time.
        */
 
-      flags = spin_lock_irqsave(NULL);
-      clock_timespec_add(&g_basetime, &ts, tp);
-      spin_unlock_irqrestore(NULL, flags);
+      do
+        {
+          seq  = read_seqbegin(&g_basetime_lock);
+          base = g_basetime;
+        }
+      while (read_seqretry(&g_basetime_lock, seq));
+
+      clock_timespec_add(&base, &ts, tp);
 #else
       clock_timekeeping_get_wall_time(tp);
 #endif
     }
   else
     {
-#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+#ifdef CONFIG_SCHED_CPUTIME
       clockid_t clock_type = clock_id & CLOCK_MASK;
       pid_t pid = clock_id >> CLOCK_SHIFT;
       FAR struct tcb_s *tcb;
@@ -136,11 +142,11 @@ void nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp)
         {
           if (clock_type == CLOCK_PROCESS_CPUTIME_ID)
             {
-              up_perf_convert(clock_process_runtime(tcb), tp);
+              perf_convert(clock_process_runtime(tcb), tp);
             }
           else if (clock_type == CLOCK_THREAD_CPUTIME_ID)
             {
-              up_perf_convert(tcb->run_time, tp);
+              perf_convert(nxsched_get_cputime(tcb), tp);
             }
         }
 #endif
@@ -182,3 +188,19 @@ int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
   nxclock_gettime(clock_id, tp);
   return OK;
 }
+
+/****************************************************************************
+ * Name: nx_clock_gettime
+ *
+ * Description:
+ *   System call entry of the user space clock_gettime(), see
+ *   libs/libc/time/lib_clock_gettime.c.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_VDSO
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  return clock_gettime(clock_id, tp);
+}
+#endif
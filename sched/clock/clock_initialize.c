@@ -59,6 +59,7 @@ volatile uint32_t g_system_ticks = INITIAL_SYSTEM_TIMER_TICKS;
 
 #ifndef CONFIG_CLOCK_TIMEKEEPING
 struct timespec   g_basetime;
+seqlock_t         g_basetime_lock = SEQLOCK_INITIALIZER;
 #endif
 
 /****************************************************************************
@@ -162,28 +163,42 @@ static void clock_inittime(FAR const struct timespec *tp)
   /* (Re-)initialize the time value to match the RTC */
 
 #ifndef CONFIG_CLOCK_TIMEKEEPING
+  struct timespec base;
   struct timespec ts;
+  irqstate_t flags;
 
   if (tp)
     {
-      memcpy(&g_basetime, tp, sizeof(struct timespec));
+      memcpy(&base, tp, sizeof(struct timespec));
     }
   else
     {
-      clock_basetime(&g_basetime);
+      clock_basetime(&base);
     }
 
+  /* With CONFIG_RTC_HIRES the system time is derived from g_basetime, so
+   * publish the new base before reading it.
+   */
+
+  flags = write_seqlock_irqsave(&g_basetime_lock);
+  g_basetime = base;
+  write_sequnlock_irqrestore(&g_basetime_lock, flags);
+
   clock_systime_timespec(&ts);
 
   /* Adjust base time to hide initial timer ticks. */
 
-  g_basetime.tv_sec  -= ts.tv_sec;
-  g_basetime.tv_nsec -= ts.tv_nsec;
-  while (g_basetime.tv_nsec < 0)
+  base.tv_sec  -= ts.tv_sec;
+  base.tv_nsec -= ts.tv_nsec;
+  while (base.tv_nsec < 0)
     {
-      g_basetime.tv_nsec += NSEC_PER_SEC;
-      g_basetime.tv_sec--;
+      base.tv_nsec += NSEC_PER_SEC;
+      base.tv_sec--;
     }
+
+  flags = write_seqlock_irqsave(&g_basetime_lock);
+  g_basetime = base;
+  write_sequnlock_irqrestore(&g_basetime_lock, flags);
 #else
   clock_inittimekeeping(tp);
 #endif
@@ -231,6 +246,10 @@ void clock_initialize(void)
 
   perf_init();
 
+  /* Allocate the clock data page mapped into the address environments */
+
+  clock_vdso_initialize();
+
 #ifdef CONFIG_SCHED_CPULOAD_SYSCLK
   cpuload_init();
 #endif
@@ -58,9 +58,18 @@ int clock_realtime2absticks(FAR const struct timespec *reltime,
                             FAR clock_t *absticks)
 {
 #ifndef CONFIG_CLOCK_TIMEKEEPING
+  struct timespec base;
   struct timespec mono;
+  uint32_t seq;
 
-  clock_timespec_subtract(reltime, &g_basetime, &mono);
+  do
+    {
+      seq  = read_seqbegin(&g_basetime_lock);
+      base = g_basetime;
+    }
+  while (read_seqretry(&g_basetime_lock, seq));
+
+  clock_timespec_subtract(reltime, &base, &mono);
 
   *absticks = clock_time2ticks(&mono);
 
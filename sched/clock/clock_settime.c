@@ -58,7 +58,9 @@
 void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 {
 #ifndef CONFIG_CLOCK_TIMEKEEPING
+  struct timespec base;
   struct timespec bias;
+  irqstate_t lockflags;
   irqstate_t flags;
 #  ifdef CONFIG_CLOCK_ADJTIME
   const struct timeval zerodelta = {
@@ -78,7 +80,11 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp)
    */
 
   clock_systime_timespec(&bias);
-  clock_timespec_subtract(tp, &bias, &g_basetime);
+  clock_timespec_subtract(tp, &bias, &base);
+
+  lockflags  = write_seqlock_irqsave(&g_basetime_lock);
+  g_basetime = base;
+  write_sequnlock_irqrestore(&g_basetime_lock, lockflags);
 
   leave_critical_section(flags);
 
@@ -99,6 +105,10 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 #else
   clock_timekeeping_set_wall_time(tp);
 #endif
+
+  /* Publish the new wall clock to user space without waiting for a tick */
+
+  clock_vdso_update();
 }
 
 /****************************************************************************
@@ -64,13 +64,19 @@ int clock_systime_timespec(FAR struct timespec *ts)
 #ifdef CONFIG_RTC_HIRES
   if (g_rtc_enabled)
     {
-      irqstate_t flags;
+      struct timespec base;
+      uint32_t seq;
 
       up_rtc_gettime(ts);
 
-      flags = spin_lock_irqsave(NULL);
-      clock_timespec_subtract(ts, &g_basetime, ts);
-      spin_unlock_irqrestore(NULL, flags);
+      do
+        {
+          seq  = read_seqbegin(&g_basetime_lock);
+          base = g_basetime;
+        }
+      while (read_seqretry(&g_basetime_lock, seq));
+
+      clock_timespec_subtract(ts, &base, ts);
     }
   else
     {
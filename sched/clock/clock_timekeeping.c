@@ -36,6 +36,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/seqlock.h>
 
 #include "clock/clock.h"
 
@@ -54,6 +55,12 @@ static uint64_t        g_clock_last_counter;
 static uint64_t        g_clock_mask;
 static long            g_clock_adjust;
 
+/* Serializes the updates of the wall time; clock_get_current_time() reads
+ * it without locking.
+ */
+
+static seqlock_t       g_clock_lock = SEQLOCK_INITIALIZER;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -65,27 +72,39 @@ static long            g_clock_adjust;
 static int clock_get_current_time(FAR struct timespec *ts,
                                   FAR struct timespec *base)
 {
-  irqstate_t flags;
+  struct timespec now;
   uint64_t counter;
+  uint64_t last;
   uint64_t offset;
   uint64_t nsec;
   time_t sec;
+  uint32_t seq;
   int ret;
 
-  flags = enter_critical_section();
+  /* Take a consistent snapshot of the counter and the time base, retrying
+   * if clock_update_wall_time() or a setter ran concurrently.
+   */
+
+  do
+    {
+      seq  = read_seqbegin(&g_clock_lock);
+      ret  = up_timer_gettick(&counter);
+      last = g_clock_last_counter;
+      now  = *base;
+    }
+  while (read_seqretry(&g_clock_lock, seq));
 
-  ret = up_timer_gettick(&counter);
   if (ret < 0)
     {
-      goto errout_in_critical_section;
+      return ret;
     }
 
-  offset = (counter - g_clock_last_counter) & g_clock_mask;
+  offset = (counter - last) & g_clock_mask;
   nsec   = offset * NSEC_PER_TICK;
   sec    = nsec   / NSEC_PER_SEC;
   nsec  -= sec    * NSEC_PER_SEC;
 
-  nsec  += base->tv_nsec;
+  nsec  += now.tv_nsec;
   if (nsec >= NSEC_PER_SEC)
     {
       nsec -= NSEC_PER_SEC;
@@ -93,10 +112,7 @@ static int clock_get_current_time(FAR struct timespec *ts,
     }
 
   ts->tv_nsec = nsec;
-  ts->tv_sec = base->tv_sec + sec;
-
-errout_in_critical_section:
-  leave_critical_section(flags);
+  ts->tv_sec = now.tv_sec + sec;
   return ret;
 }
 
@@ -123,12 +139,12 @@ int clock_timekeeping_set_wall_time(FAR const struct timespec *ts)
   uint64_t counter;
   int ret;
 
-  flags = enter_critical_section();
+  flags = write_seqlock_irqsave(&g_clock_lock);
 
   ret = up_timer_gettick(&counter);
   if (ret < 0)
     {
-      goto errout_in_critical_section;
+      goto errout_with_lock;
     }
 
   memcpy(&g_clock_wall_time, ts, sizeof(struct timespec));
@@ -136,8 +152,8 @@ int clock_timekeeping_set_wall_time(FAR const struct timespec *ts)
   g_clock_adjust       = 0;
   g_clock_last_counter = counter;
 
-errout_in_critical_section:
-  leave_critical_section(flags);
+errout_with_lock:
+  write_sequnlock_irqrestore(&g_clock_lock, flags);
   return ret;
 }
 
@@ -188,7 +204,7 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
       return -1;
     }
 
-  flags = enter_critical_section();
+  flags = write_seqlock_irqsave(&g_clock_lock);
 
   adjust_usec = delta->tv_sec * USEC_PER_SEC + delta->tv_usec;
 
@@ -199,7 +215,7 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
 
   g_clock_adjust = adjust_usec;
 
-  leave_critical_section(flags);
+  write_sequnlock_irqrestore(&g_clock_lock, flags);
 
   return OK;
 }
@@ -217,18 +233,18 @@ void clock_update_wall_time(void)
   time_t sec;
   int ret;
 
-  flags = enter_critical_section();
+  flags = write_seqlock_irqsave(&g_clock_lock);
 
   ret = up_timer_gettick(&counter);
   if (ret < 0)
     {
-      goto errout_in_critical_section;
+      goto errout_with_lock;
     }
 
   offset = (counter - g_clock_last_counter) & g_clock_mask;
   if (offset == 0)
     {
-      goto errout_in_critical_section;
+      goto errout_with_lock;
     }
 
   nsec  = offset * NSEC_PER_TICK;
@@ -270,8 +286,8 @@ void clock_update_wall_time(void)
 
   g_clock_last_counter = counter;
 
-errout_in_critical_section:
-  leave_critical_section(flags);
+errout_with_lock:
+  write_sequnlock_irqrestore(&g_clock_lock, flags);
 }
 
 /****************************************************************************
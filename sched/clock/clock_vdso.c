@@ -0,0 +1,156 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <limits.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/vdso.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uintptr_t g_vdso_page;
+static FAR struct vdso_data_s *g_vdso;
+static spinlock_t g_vdso_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_initialize
+ *
+ * Description:
+ *   Allocate the clock data page.  It stays invalid, and user space keeps
+ *   using the system call, until the performance counter is running.
+ *
+ ****************************************************************************/
+
+void clock_vdso_initialize(void)
+{
+  g_vdso_page = mm_pgalloc(1);
+  if (g_vdso_page == 0)
+    {
+      serr("ERROR: Failed to allocate the clock data page\n");
+      return;
+    }
+
+  g_vdso = (FAR struct vdso_data_s *)up_addrenv_page_vaddr(g_vdso_page);
+  memset(g_vdso, 0, CONFIG_MM_PGSIZE);
+  seqcount_init(&g_vdso->seq);
+
+  clock_vdso_update();
+}
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Refresh the clock data page.  Called on every timer interrupt, so that
+ *   the counter cannot wrap between two updates, and whenever the wall
+ *   clock is set.
+ *
+ *   CLOCK_MONOTONIC is advanced with the counter rather than copied from
+ *   the system timer, so that the values extrapolated by user space never
+ *   go backwards across an update.
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(void)
+{
+  FAR struct vdso_data_s *vdso = g_vdso;
+  struct timespec realtime;
+  struct timespec monotonic;
+  struct timespec elapsed;
+  unsigned long freq;
+  unsigned long now;
+  irqstate_t flags;
+
+  if (vdso == NULL)
+    {
+      return;
+    }
+
+  /* up_perf_init() may not have been called yet */
+
+  freq = up_perf_getfreq();
+  if (freq == 0 || freq == ULONG_MAX)
+    {
+      return;
+    }
+
+  nxclock_gettime(CLOCK_REALTIME, &realtime);
+  clock_systime_timespec(&monotonic);
+
+  flags = spin_lock_irqsave(&g_vdso_lock);
+  write_seqcount_begin(&vdso->seq);
+
+  now = up_perf_gettime();
+  if (vdso->freq == 0)
+    {
+      vdso->monotonic = monotonic;
+    }
+  else
+    {
+      up_perf_convert(now - vdso->cycle_last, &elapsed);
+      clock_timespec_add(&vdso->monotonic, &elapsed, &vdso->monotonic);
+    }
+
+  clock_timespec_subtract(&realtime, &monotonic, &vdso->offset);
+  vdso->cycle_last = now;
+  vdso->freq       = freq;
+
+  write_seqcount_end(&vdso->seq);
+  spin_unlock_irqrestore(&g_vdso_lock, flags);
+}
+
+/****************************************************************************
+ * Name: clock_vdso_page
+ *
+ * Description:
+ *   Return the physical address of the clock data page.  See
+ *   include/nuttx/vdso.h.
+ *
+ ****************************************************************************/
+
+uintptr_t clock_vdso_page(void)
+{
+  return g_vdso_page;
+}
+
+#endif /* CONFIG_CLOCK_VDSO */
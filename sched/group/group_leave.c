@@ -47,6 +47,7 @@
 #include "pthread/pthread.h"
 #include "mqueue/mqueue.h"
 #include "group/group.h"
+#include "timer/timer.h"
 #include "tls/tls.h"
 
 /****************************************************************************
@@ -82,6 +83,12 @@ group_release(FAR struct task_group_s *group, uint8_t ttype)
   group_remove_children(group);
 #endif
 
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+  /* Release the timer table */
+
+  timer_freeall(group);
+#endif
+
   /* Release pending signals */
 
   nxsig_release(group);
@@ -176,6 +183,15 @@ void group_leave(FAR struct tcb_s *tcb)
   group = tcb->group;
   if (group)
     {
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+      /* Release any timers that the thread holds.  We do this before the
+       * PID is released because they may still be trying to deliver
+       * signals to it.
+       */
+
+      timer_deleteall(group, tcb->pid);
+#endif
+
       /* In any event, we can detach the group from the TCB so that we won't
        * do this again.
        */
@@ -250,7 +266,7 @@ void group_drop(FAR struct task_group_s *group)
 
       if (tcb->cmn.flags & TCB_FLAG_FREE_TCB)
         {
-          kmm_free(tcb);
+          nxsched_free_tcb(tcb);
         }
     }
 }
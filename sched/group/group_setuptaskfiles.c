@@ -83,8 +83,20 @@ int group_setuptaskfiles(FAR struct task_tcb_s *tcb,
 
   if (group != rtcb->group)
     {
-      files_duplist(&rtcb->group->tg_filelist,
-                    &group->tg_filelist, actions, cloexec);
+      /* Visit only the descriptors named by the file actions instead of
+       * the parent's whole table if everything else would be closed.
+       */
+
+      if ((tcb->cmn.flags & TCB_FLAG_CLOEXEC_DEFAULT) != 0)
+        {
+          files_dupactions(&rtcb->group->tg_filelist,
+                           &group->tg_filelist, actions);
+        }
+      else
+        {
+          files_duplist(&rtcb->group->tg_filelist,
+                        &group->tg_filelist, actions, cloexec);
+        }
     }
 
   if (ret >= 0 && actions != NULL)
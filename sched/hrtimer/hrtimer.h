@@ -0,0 +1,183 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_HRTIMER_HRTIMER_H
+#define __SCHED_HRTIMER_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/tree.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+RB_HEAD(hrtimer_tree_s, hrtimer_s);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* g_hrtimertree holds the active high resolution timers ordered by
+ * expiration time.  g_hrtimerhead caches the leftmost node of the tree, or
+ * NULL if no timer is active.
+ */
+
+extern struct hrtimer_tree_s g_hrtimertree;
+extern FAR struct hrtimer_s *g_hrtimerhead;
+
+/* Non-zero while hrtimer_process() runs the timer callbacks.  The alarm
+ * is reprogrammed once all callbacks have been run.
+ */
+
+extern unsigned int g_hrtimernested;
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_compare
+ *
+ * Description:
+ *   Order two high resolution timers by expiration time.  Timers with the
+ *   same expiration time are never reported as equal so that they expire
+ *   in the order in which they were started.
+ *
+ ****************************************************************************/
+
+static inline_function int hrtimer_compare(FAR struct hrtimer_s *hrtimer1,
+                                           FAR struct hrtimer_s *hrtimer2)
+{
+  return hrtimer1->expired < hrtimer2->expired ? -1 : 1;
+}
+
+RB_PROTOTYPE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
+
+/****************************************************************************
+ * Name: hrtimer_dequeue
+ *
+ * Description:
+ *   Remove an active high resolution timer from the timer queue.
+ *
+ * Returned Value:
+ *   True if the timer was the head of the queue.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static inline_function bool hrtimer_dequeue(FAR struct hrtimer_s *hrtimer)
+{
+  bool head = (g_hrtimerhead == hrtimer);
+
+  if (head)
+    {
+      g_hrtimerhead = RB_NEXT(hrtimer_tree_s, &g_hrtimertree, hrtimer);
+    }
+
+  RB_REMOVE(hrtimer_tree_s, &g_hrtimertree, hrtimer);
+  hrtimer->func = NULL;
+  return head;
+}
+
+/****************************************************************************
+ * Name: hrtimer_next_expired
+ *
+ * Description:
+ *   Return the expiration time of the earliest active high resolution
+ *   timer.
+ *
+ * Input Parameters:
+ *   expired - Location to return the absolute expiration time
+ *
+ * Returned Value:
+ *   True if a timer is active and 'expired' has been set.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static inline_function bool hrtimer_next_expired(FAR uint64_t *expired)
+{
+  if (g_hrtimerhead == NULL)
+    {
+      return false;
+    }
+
+  *expired = g_hrtimerhead->expired;
+  return true;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Run all high resolution timers that expired at or before 'now'.  Called
+ *   from the tickless alarm expiration logic.
+ *
+ * Input Parameters:
+ *   now - The current time in nanoseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from interrupt handling logic.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(uint64_t now);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __SCHED_HRTIMER_HRTIMER_H */
@@ -0,0 +1,85 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_cancel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+
+#include "sched/sched.h"
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a currently running high resolution timer.  High resolution
+ *   timers may be cancelled from the interrupt level.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success;  A negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *hrtimer)
+{
+  irqstate_t flags;
+
+  if (hrtimer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (!HRTIMER_ISACTIVE(hrtimer))
+    {
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  /* If the timer was at the head of the queue, then the alarm must be
+   * re-adjusted for the next expiration.
+   */
+
+  if (hrtimer_dequeue(hrtimer) && g_hrtimernested == 0)
+    {
+      nxsched_reassess_timer();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current value of the time base used by the high resolution
+ *   timers: the time since power-up in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void)
+{
+  struct timespec ts;
+
+  up_timer_gettime(&ts);
+  return clock_time2nsec(&ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time remaining before the high resolution timer expires.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer
+ *
+ * Returned Value:
+ *   The time in nanoseconds remaining until the timer expires.  Zero means
+ *   either that the timer is not active or that it has already expired.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(FAR struct hrtimer_s *hrtimer)
+{
+  irqstate_t flags;
+  uint64_t expired;
+  uint64_t now;
+
+  if (hrtimer == NULL)
+    {
+      return 0;
+    }
+
+  flags = enter_critical_section();
+
+  if (!HRTIMER_ISACTIVE(hrtimer))
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  expired = hrtimer->expired;
+  leave_critical_section(flags);
+
+  now = hrtimer_now();
+  return expired > now ? expired - now : 0;
+}
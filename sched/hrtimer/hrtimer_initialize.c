@@ -0,0 +1,51 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_initialize.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* g_hrtimertree holds the active high resolution timers ordered by
+ * expiration time.  g_hrtimerhead always points to the leftmost node so
+ * that the next expiration can be found without a tree walk.
+ */
+
+struct hrtimer_tree_s g_hrtimertree = RB_INITIALIZER(&g_hrtimertree);
+FAR struct hrtimer_s *g_hrtimerhead;
+
+/* Non-zero while the timer callbacks are running */
+
+unsigned int g_hrtimernested;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+RB_GENERATE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
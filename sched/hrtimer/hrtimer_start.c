@@ -0,0 +1,173 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_start.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+
+#include "sched/sched.h"
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_start_absolute
+ *
+ * Description:
+ *   The same as hrtimer_start() except that the expiration time is an
+ *   absolute time in nanoseconds in the time base of hrtimer_now().
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to start
+ *   expired - Absolute expiration time in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start_absolute(FAR struct hrtimer_s *hrtimer, uint64_t expired,
+                           hrtimer_entry_t func, FAR void *arg)
+{
+  irqstate_t flags;
+  bool reassess = false;
+
+  if (hrtimer == NULL || func == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  /* Restarting an active timer simply moves it in the queue */
+
+  if (HRTIMER_ISACTIVE(hrtimer))
+    {
+      reassess = hrtimer_dequeue(hrtimer);
+    }
+
+  hrtimer->expired = expired;
+  hrtimer->func    = func;
+  hrtimer->arg     = arg;
+
+  RB_INSERT(hrtimer_tree_s, &g_hrtimertree, hrtimer);
+
+  if (g_hrtimerhead == NULL || hrtimer_compare(hrtimer, g_hrtimerhead) < 0)
+    {
+      g_hrtimerhead = hrtimer;
+      reassess = true;
+    }
+
+  /* If the earliest expiration changed, then the alarm must be
+   * reprogrammed.  That is deferred while the callbacks are running.
+   */
+
+  if (reassess && g_hrtimernested == 0)
+    {
+      nxsched_reassess_timer();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   This function adds the high resolution timer to the active timer queue.
+ *   The specified function at 'func' will be called from the interrupt
+ *   level after the specified number of nanoseconds has elapsed.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to start
+ *   delay   - Delay in nanoseconds
+ *   func    - Function to call on timeout
+ *   arg     - Parameter to pass to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer, uint64_t delay,
+                  hrtimer_entry_t func, FAR void *arg)
+{
+  return hrtimer_start_absolute(hrtimer, hrtimer_now() + delay, func, arg);
+}
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Run all high resolution timers that expired at or before 'now'.  Called
+ *   from the tickless alarm expiration logic.
+ *
+ * Input Parameters:
+ *   now - The current time in nanoseconds
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from interrupt handling logic.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(uint64_t now)
+{
+  FAR struct hrtimer_s *hrtimer;
+  hrtimer_entry_t func;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  g_hrtimernested++;
+
+  while ((hrtimer = g_hrtimerhead) != NULL && hrtimer->expired <= now)
+    {
+      /* Remove the timer from the queue before calling it so that the
+       * callback may restart it.
+       */
+
+      func = hrtimer->func;
+      hrtimer_dequeue(hrtimer);
+
+      func(hrtimer->arg);
+    }
+
+  g_hrtimernested--;
+  leave_critical_section(flags);
+}
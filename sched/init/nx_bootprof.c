@@ -0,0 +1,179 @@
+/****************************************************************************
+ * sched/init/nx_bootprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INIT_ASYNC
+/* One step queued by nx_init_async() */
+
+struct nx_initjob_s
+{
+  struct work_s work;    /* Work queue entry, must be first */
+  nx_initfunc_t func;    /* The initialization function */
+  FAR const char *name;  /* Name of the step */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BOOTPROF
+static struct nx_bootprof_s g_bootprof[CONFIG_SCHED_BOOTPROF_NENTRIES];
+static size_t g_bootprof_count;
+static spinlock_t g_bootprof_lock = SP_UNLOCKED;
+#endif
+
+#ifdef CONFIG_SCHED_INIT_ASYNC
+static sem_t g_initasync_done = SEM_INITIALIZER(0);
+static int g_initasync_pending;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INIT_ASYNC
+/****************************************************************************
+ * Name: nx_init_worker
+ *
+ * Description:
+ *   Run one queued step on the low priority work queue.
+ *
+ ****************************************************************************/
+
+static void nx_init_worker(FAR void *arg)
+{
+  FAR struct nx_initjob_s *job = arg;
+
+  job->func();
+  BOOTPROF_MARK(job->name);
+
+  kmm_free(job);
+  nxsem_post(&g_initasync_done);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BOOTPROF
+/****************************************************************************
+ * Name: nx_bootprof_mark
+ ****************************************************************************/
+
+void nx_bootprof_mark(FAR const char *name)
+{
+  irqstate_t flags;
+  clock_t now;
+
+  now   = perf_gettime();
+  flags = spin_lock_irqsave(&g_bootprof_lock);
+
+  if (g_bootprof_count < CONFIG_SCHED_BOOTPROF_NENTRIES)
+    {
+      g_bootprof[g_bootprof_count].name = name;
+      g_bootprof[g_bootprof_count].time = now;
+      g_bootprof_count++;
+    }
+
+  spin_unlock_irqrestore(&g_bootprof_lock, flags);
+
+  /* The note drivers are not usable before the hardware is up */
+
+  if (OSINIT_HW_READY())
+    {
+      sched_note_mark(NOTE_TAG_SCHED, name);
+    }
+}
+
+/****************************************************************************
+ * Name: nx_bootprof_get
+ ****************************************************************************/
+
+size_t nx_bootprof_get(FAR const struct nx_bootprof_s **steps)
+{
+  *steps = g_bootprof;
+  return g_bootprof_count;
+}
+#endif
+
+#ifdef CONFIG_SCHED_INIT_ASYNC
+/****************************************************************************
+ * Name: nx_init_async
+ ****************************************************************************/
+
+void nx_init_async(nx_initfunc_t func, FAR const char *name)
+{
+  FAR struct nx_initjob_s *job;
+
+  DEBUGASSERT(func != NULL);
+
+  job = kmm_zalloc(sizeof(struct nx_initjob_s));
+  if (job == NULL)
+    {
+      swarn("WARNING: Running %s synchronously\n", name);
+      func();
+      BOOTPROF_MARK(name);
+      return;
+    }
+
+  job->func = func;
+  job->name = name;
+
+  g_initasync_pending++;
+  work_queue(LPWORK, &job->work, nx_init_worker, job, 0);
+}
+
+/****************************************************************************
+ * Name: nx_init_async_wait
+ ****************************************************************************/
+
+void nx_init_async_wait(void)
+{
+  while (g_initasync_pending > 0)
+    {
+      nxsem_wait_uninterruptible(&g_initasync_done);
+      g_initasync_pending--;
+    }
+}
+#endif
@@ -320,6 +320,16 @@ static inline void nx_start_application(void)
    */
 
   board_late_initialize();
+  BOOTPROF_MARK("board_late_initialize");
+#endif
+
+#ifdef CONFIG_SCHED_INIT_ASYNC
+  /* Drivers probed in the background must be ready before the first
+   * application runs.
+   */
+
+  nx_init_async_wait();
+  BOOTPROF_MARK("init_async");
 #endif
 
 #ifndef CONFIG_BOARD_CRASHDUMP_NONE
@@ -520,6 +530,7 @@ int nx_bringup(void)
    */
 
   nx_workqueues();
+  BOOTPROF_MARK("workqueues");
 
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
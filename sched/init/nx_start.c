@@ -37,6 +37,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#include <nuttx/mm/cma.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/mm/kmap.h>
 #include <nuttx/mm/mm.h>
@@ -62,6 +63,7 @@
 #include "init/init.h"
 #include "instrument/instrument.h"
 #include "tls/tls.h"
+#include "wdog/wdog.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -94,6 +96,15 @@
 
 dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+/* The index over g_readytorun:  A bitmap of the priorities present in the
+ * list and the last TCB of each priority level in the list.
+ */
+
+uint32_t g_readytorun_map[SCHED_PRIORITY_WORDS];
+FAR struct tcb_s *g_readytorun_tail[SCHED_PRIORITY_MAX + 1];
+#endif
+
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
  *
@@ -425,6 +436,9 @@ static void idle_task_initialize(void)
       tasklist = TLIST_HEAD(tcb);
 #endif
       dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+      nxsched_prioritymap_add(tcb);
+#endif
 
       /* Mark the idle task as the running task */
 
@@ -538,9 +552,16 @@ void nx_start(void)
   /* Task lists are initialized */
 
   g_nx_initstate = OSINIT_TASKLISTS;
+  BOOTPROF_MARK("tasklists");
 
   /* Initialize RTOS Data ***************************************************/
 
+#ifdef CONFIG_WDOG_PERCPU
+  /* Initialize the per-CPU watchdog timer queues */
+
+  wd_initialize();
+#endif
+
   drivers_early_initialize();
 
   sched_trace_begin();
@@ -609,6 +630,12 @@ void nx_start(void)
   iob_initialize();
 #endif
 
+#if defined(CONFIG_MM_CMA) && CONFIG_MM_CMA_HEAPSIZE > 0
+  /* Set aside the contiguous memory region before the heap fragments */
+
+  cma_initialize(NULL, CONFIG_MM_CMA_HEAPSIZE, CMA_CACHED);
+#endif
+
   /* Initialize the logic that determine unique process IDs. */
 
   i = 1 << LOG2_CEIL(CONFIG_PID_INITIAL_COUNT);
@@ -631,11 +658,18 @@ void nx_start(void)
   /* The memory manager is available */
 
   g_nx_initstate = OSINIT_MEMORY;
+  BOOTPROF_MARK("memory");
 
   /* Initialize tasking data structures */
 
   task_initialize();
 
+#ifdef CONFIG_SCHED_TCB_CACHE
+  /* Create the object cache the TCBs are allocated from */
+
+  nxsched_tcbcache_initialize();
+#endif
+
   /* Initialize the instrument function */
 
   instrument_initialize();
@@ -678,6 +712,8 @@ void nx_start(void)
   binfmt_initialize();
 #endif
 
+  BOOTPROF_MARK("os");
+
   /* Initialize Hardware Facilities *****************************************/
 
   /* The processor specific details of running the operating system
@@ -687,10 +723,12 @@ void nx_start(void)
    */
 
   up_initialize();
+  BOOTPROF_MARK("up_initialize");
 
   /* Initialize common drivers */
 
   drivers_initialize();
+  BOOTPROF_MARK("drivers_initialize");
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -699,6 +737,7 @@ void nx_start(void)
    */
 
   board_early_initialize();
+  BOOTPROF_MARK("board_early_initialize");
 #endif
 
   /* Hardware resources are now available */
@@ -743,7 +782,13 @@ void nx_start(void)
   /* Then start the other CPUs */
 
   DEBUGVERIFY(nx_smp_start());
+  BOOTPROF_MARK("smp_start");
 
+#ifdef CONFIG_SCHED_LOADBALANCE
+  /* Start the periodic load balancer */
+
+  nxsched_loadbalance_initialize();
+#endif
 #endif /* CONFIG_SMP */
 
   /* Bring Up the System ****************************************************/
@@ -49,6 +49,25 @@
       g_cpu_irqset |= (1 << cpu); \
     } \
   while (0)
+
+/* Take the IRQ spinlock, counting the attempts that found it already held
+ * by another CPU.
+ */
+
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+#    define cpu_irqlock_take(cpu) \
+  do \
+    { \
+      if (!spin_trylock(&g_cpu_irqlock)) \
+        { \
+          g_crit_contention[cpu]++; \
+          spin_lock(&g_cpu_irqlock); \
+        } \
+    } \
+  while (0)
+#  else
+#    define cpu_irqlock_take(cpu) spin_lock(&g_cpu_irqlock)
+#  endif
 #endif
 
 /****************************************************************************
@@ -181,7 +200,7 @@ irqstate_t enter_critical_section(void)
                * no longer blocked by the critical section).
                */
 
-              spin_lock(&g_cpu_irqlock);
+              cpu_irqlock_take(cpu);
               cpu_irqlock_set(cpu);
             }
 
@@ -232,7 +251,7 @@ irqstate_t enter_critical_section(void)
 
           DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
-          spin_lock(&g_cpu_irqlock);
+          cpu_irqlock_take(cpu);
 
           /* Then set the lock count to 1.
            *
@@ -32,6 +32,7 @@
 
 #include <nuttx/coredump.h>
 #include <nuttx/elf.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/sched.h>
 
 #include "sched/sched.h"
@@ -72,6 +73,17 @@ struct elf_dumpinfo_s
   pid_t                       pid;
 };
 
+#ifdef CONFIG_BOARD_COREDUMP_SKIP_FREE
+/* The part of a memory segment that is still to be emitted */
+
+struct elf_freeinfo_s
+{
+  FAR struct elf_dumpinfo_s  *cinfo;
+  uintptr_t                   pos;
+  uintptr_t                   end;
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -157,19 +169,17 @@ static int elf_emit(FAR struct elf_dumpinfo_s *cinfo,
 }
 
 /****************************************************************************
- * Name: elf_emit_align
+ * Name: elf_emit_zero
  *
  * Description:
- *   Align the filled data according to the current offset
+ *   Send len bytes of zero to the out stream
  *
  ****************************************************************************/
 
-static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+static int elf_emit_zero(FAR struct elf_dumpinfo_s *cinfo, off_t len)
 {
-  off_t align = ROUNDUP(cinfo->stream->nput,
-                        ELF_PAGESIZE) - cinfo->stream->nput;
   unsigned char null[256];
-  off_t total = align;
+  off_t total = len;
   off_t ret = 0;
 
   memset(null, 0, sizeof(null));
@@ -186,7 +196,21 @@ static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
       total -= ret;
     }
 
-  return ret < 0 ? ret : align;
+  return ret < 0 ? ret : len;
+}
+
+/****************************************************************************
+ * Name: elf_emit_align
+ *
+ * Description:
+ *   Align the filled data according to the current offset
+ *
+ ****************************************************************************/
+
+static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+{
+  return elf_emit_zero(cinfo, ROUNDUP(cinfo->stream->nput, ELF_PAGESIZE) -
+                              cinfo->stream->nput);
 }
 
 /****************************************************************************
@@ -453,6 +477,77 @@ static void elf_emit_stack(FAR struct elf_dumpinfo_s *cinfo)
     }
 }
 
+#ifdef CONFIG_BOARD_COREDUMP_SKIP_FREE
+
+/****************************************************************************
+ * Name: elf_emit_free_handler
+ *
+ * Description:
+ *   Emit the segment up to a free heap chunk, then zeros in place of the
+ *   chunk.  The zeros keep every offset unchanged and compress to almost
+ *   nothing.
+ *
+ ****************************************************************************/
+
+static void elf_emit_free_handler(FAR void *start, size_t size,
+                                  FAR void *arg)
+{
+  FAR struct elf_freeinfo_s *info = arg;
+  uintptr_t begin = MAX((uintptr_t)start, info->pos);
+  uintptr_t end = MIN((uintptr_t)start + size, info->end);
+
+  /* Chunks outside the segment, or behind what was already emitted (the
+   * heaps are walked one after the other), are dumped as they are.
+   */
+
+  if (begin >= end)
+    {
+      return;
+    }
+
+  elf_emit(info->cinfo, (FAR const void *)info->pos, begin - info->pos);
+  elf_emit_zero(info->cinfo, end - begin);
+  info->pos = end;
+}
+
+/****************************************************************************
+ * Name: elf_emit_segment
+ *
+ * Description:
+ *   Emit a memory segment with the free heap chunks replaced by zeros
+ *
+ ****************************************************************************/
+
+static void elf_emit_segment(FAR struct elf_dumpinfo_s *cinfo,
+                             uintptr_t start, uintptr_t end)
+{
+  struct elf_freeinfo_s info;
+
+  info.cinfo = cinfo;
+  info.pos   = start;
+  info.end   = end;
+
+  /* The heap is walked only from the crash path: a task context would
+   * hold the heap lock while the out stream may need to allocate.  The
+   * walk is also skipped if a heap is locked by the crashed context, the
+   * chunks are then dumped as they are.
+   */
+
+  if (up_interrupt_context())
+    {
+#ifdef CONFIG_MM_KERNEL_HEAP
+      mm_foreach_free(g_kmmheap, elf_emit_free_handler, &info);
+#endif
+#ifndef CONFIG_BUILD_KERNEL
+      mm_foreach_free(USR_HEAP, elf_emit_free_handler, &info);
+#endif
+    }
+
+  elf_emit(cinfo, (FAR const void *)info.pos, info.end - info.pos);
+}
+
+#endif
+
 /****************************************************************************
  * Name: elf_emit_memory
  *
@@ -492,8 +587,13 @@ static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
         }
       else
         {
+#ifdef CONFIG_BOARD_COREDUMP_SKIP_FREE
+          elf_emit_segment(cinfo, cinfo->regions[i].start,
+                           cinfo->regions[i].end);
+#else
           elf_emit(cinfo, (FAR void *)cinfo->regions[i].start,
                    cinfo->regions[i].end - cinfo->regions[i].start);
+#endif
         }
 
       /* Align to page */
@@ -80,6 +80,10 @@ struct list_node g_msgfreeirq;
 
 #endif
 
+/* Message allocation statistics */
+
+struct mqueue_stats_s g_mqstats;
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -185,6 +189,12 @@ void nxmq_initialize(void)
 
   msg = mq_msgblockinit(&g_msgfreeirq, msg, CONFIG_PREALLOC_MQ_IRQ_MSGS,
                          MQ_ALLOC_IRQ);
+
+#  ifdef CONFIG_MQ_LOAN
+  /* Initialize the pool of loaned message buffers */
+
+  nxmq_loan_initialize();
+#  endif
 #endif
 
 #ifndef CONFIG_DISABLE_MQUEUE_SYSV
@@ -0,0 +1,390 @@
+/****************************************************************************
+ * sched/mqueue/mq_loan.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <debug.h>
+#include <fcntl.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/nuttx.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_LOAN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MQ_LOAN_BLOCKSIZE ALIGN_UP(MQ_LOAN_SIZE, sizeof(uintptr_t))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pool of loaned message buffers */
+
+static struct mempool_s g_mqloanpool;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_loan_pool_alloc and nxmq_loan_pool_free
+ *
+ * Description:
+ *   Back end allocators of the loan pool.
+ *
+ ****************************************************************************/
+
+static FAR void *nxmq_loan_pool_alloc(FAR struct mempool_s *pool,
+                                      size_t size)
+{
+  return kmm_memalign(pool->blocksize > MEMPOOL_ALIGN ?
+                      MEMPOOL_ALIGN : sizeof(uintptr_t), size);
+}
+
+static void nxmq_loan_pool_free(FAR struct mempool_s *pool, FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+/****************************************************************************
+ * Name: nxmq_loan_msg
+ *
+ * Description:
+ *   Recover the message header from the address of the message data.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct mqueue_msg_s *nxmq_loan_msg(FAR void *msg)
+{
+  return container_of((FAR char *)msg, struct mqueue_msg_s, mail[0]);
+}
+
+/****************************************************************************
+ * Name: file_mq_send_loan
+ *
+ * Description:
+ *   Add a loaned buffer to the message queue without copying it.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int file_mq_send_loan(FAR struct file *mq, FAR void *msg,
+                             size_t msglen, unsigned int prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mq == NULL || mq->f_inode == NULL || mq->f_inode->i_private == NULL ||
+      msg == NULL || prio >= MQ_PRIO_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if ((mq->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (msglen > CONFIG_MQ_LOAN_BUFSIZE)
+    {
+      return -EMSGSIZE;
+    }
+
+  mqmsg = nxmq_loan_msg(msg);
+  DEBUGASSERT(mqmsg->type == MQ_ALLOC_LOAN);
+
+  MQ_MSG_LOAN(mqmsg)->len = msglen;
+  return nxmq_send_msg(mq, mqmsg, prio, NULL, -1);
+}
+
+/****************************************************************************
+ * Name: file_mq_receive_loan
+ *
+ * Description:
+ *   Remove the highest priority message from the message queue and return
+ *   its data in place.
+ *
+ * Returned Value:
+ *   The length of the message on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static ssize_t file_mq_receive_loan(FAR struct file *mq, FAR void **msg,
+                                    FAR unsigned int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (mq == NULL || mq->f_inode == NULL || mq->f_inode->i_private == NULL ||
+      msg == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mq->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = nxmq_receive_msg(mq, &mqmsg, NULL, -1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (prio != NULL)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  *msg = mqmsg->mail;
+  return MQ_MSG_LEN(mqmsg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_loan_initialize
+ *
+ * Description:
+ *   Create the pool of loaned message buffers.  Called from
+ *   nxmq_initialize().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_loan_initialize(void)
+{
+  g_mqloanpool.blocksize   = MQ_LOAN_BLOCKSIZE;
+  g_mqloanpool.initialsize = CONFIG_MQ_LOAN_NBUFFERS * MQ_LOAN_BLOCKSIZE +
+                             sizeof(sq_entry_t);
+#if CONFIG_MQ_LOAN_EXPAND > 0
+  g_mqloanpool.expandsize  = CONFIG_MQ_LOAN_EXPAND * MQ_LOAN_BLOCKSIZE +
+                             sizeof(sq_entry_t);
+#endif
+  g_mqloanpool.alloc       = nxmq_loan_pool_alloc;
+  g_mqloanpool.free        = nxmq_loan_pool_free;
+
+  if (mempool_init(&g_mqloanpool, "mqueue-loan") < 0)
+    {
+      serr("ERROR: Failed to create the mqueue loan pool\n");
+    }
+}
+
+/****************************************************************************
+ * Name: nxmq_loan_release
+ *
+ * Description:
+ *   Return a loaned message to the loan pool.  Called from
+ *   nxmq_free_msg().
+ *
+ * Input Parameters:
+ *   mqmsg - The message header embedded in the loaned buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_loan_release(FAR struct mqueue_msg_s *mqmsg)
+{
+  mempool_release(&g_mqloanpool, MQ_MSG_LOAN(mqmsg));
+}
+
+/****************************************************************************
+ * Name: mq_loan_alloc
+ *
+ * Description:
+ *   Take a message buffer from the pool of loaned buffers.
+ *
+ * Input Parameters:
+ *   msglen - The size of the buffer needed, at most CONFIG_MQ_LOAN_BUFSIZE
+ *
+ * Returned Value:
+ *   The address of the buffer on success.  NULL is returned on failure and
+ *   errno is set to indicate the error.
+ *
+ ****************************************************************************/
+
+FAR void *mq_loan_alloc(size_t msglen)
+{
+  FAR struct mqueue_loan_s *loan;
+
+  if (msglen > CONFIG_MQ_LOAN_BUFSIZE)
+    {
+      set_errno(EMSGSIZE);
+      return NULL;
+    }
+
+  loan = mempool_allocate(&g_mqloanpool);
+  if (loan == NULL)
+    {
+      set_errno(ENOMEM);
+      return NULL;
+    }
+
+  loan->len      = 0;
+  loan->msg.type = MQ_ALLOC_LOAN;
+  return loan->msg.mail;
+}
+
+/****************************************************************************
+ * Name: mq_loan_free
+ *
+ * Description:
+ *   Return a buffer obtained from mq_loan_alloc() or mq_receive_loan().
+ *
+ * Input Parameters:
+ *   msg - The buffer to release
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_loan_free(FAR void *msg)
+{
+  if (msg != NULL)
+    {
+      nxmq_free_msg(nxmq_loan_msg(msg));
+    }
+}
+
+/****************************************************************************
+ * Name: mq_send_loan
+ *
+ * Description:
+ *   Send a loaned buffer without copying it.  See include/nuttx/mqueue.h.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   msg    - Loaned buffer holding the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   On success, mq_send_loan() returns 0 (OK); on error, -1 (ERROR) is
+ *   returned, with errno set to indicate the error.
+ *
+ ****************************************************************************/
+
+int mq_send_loan(mqd_t mqdes, FAR void *msg, size_t msglen,
+                 unsigned int prio)
+{
+  FAR struct file *filep;
+  int ret;
+
+  /* mq_send_loan() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret >= 0)
+    {
+      ret = file_mq_send_loan(filep, msg, msglen, prio);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receive_loan
+ *
+ * Description:
+ *   Receive a message in place without copying it.  See
+ *   include/nuttx/mqueue.h.
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor
+ *   msg   - Location to return the address of the message data
+ *   prio  - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   On success, the length of the message in bytes is returned.  On
+ *   failure, -1 (ERROR) is returned and errno is set to indicate the error.
+ *
+ ****************************************************************************/
+
+ssize_t mq_receive_loan(mqd_t mqdes, FAR void **msg,
+                        FAR unsigned int *prio)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  /* mq_receive_loan() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret >= 0)
+    {
+      ret = file_mq_receive_loan(filep, msg, prio);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_MQ_LOAN */
@@ -98,6 +98,38 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
     {
       kmm_free(mqmsg);
     }
+#ifdef CONFIG_MQ_QUEUE_POOL
+
+  /* Reserved messages go back to the pool of their queue.  If the queue was
+   * freed while this message was outside of it, the last message returned
+   * frees the queue.
+   */
+
+  else if (mqmsg->type == MQ_ALLOC_POOL)
+    {
+      FAR struct mqueue_inode_s *msgq = MQ_MSG_POOL(mqmsg)->msgq;
+      bool release;
+
+      flags = spin_lock_irqsave(NULL);
+      list_add_tail(&msgq->msgpool, &mqmsg->node);
+      release = --msgq->npoolused == 0 && msgq->poolorphan;
+      spin_unlock_irqrestore(NULL, flags);
+
+      if (release)
+        {
+          kmm_free(msgq);
+        }
+    }
+#endif
+#ifdef CONFIG_MQ_LOAN
+
+  /* Loaned buffers go back to the loan pool */
+
+  else if (mqmsg->type == MQ_ALLOC_LOAN)
+    {
+      nxmq_loan_release(mqmsg);
+    }
+#endif
   else
     {
       DEBUGPANIC();
@@ -30,6 +30,7 @@
 #include <assert.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/sched.h>
 #include <nuttx/mqueue.h>
 
@@ -50,7 +51,9 @@
  * Input Parameters:
  *   attr   - The mq_maxmsg attribute is used at the time that the message
  *            queue is created to determine the maximum number of
- *            messages that may be placed in the message queue.
+ *            messages that may be placed in the message queue.  If
+ *            MQ_PREALLOC is set in mq_flags, that many messages are
+ *            reserved for the queue as well.
  *   pmsgq  - This parameter is a address of a pointer
  *
  * Returned Value:
@@ -68,6 +71,13 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
                     FAR struct mqueue_inode_s **pmsgq)
 {
   FAR struct mqueue_inode_s *msgq;
+  size_t size = sizeof(struct mqueue_inode_s);
+#ifdef CONFIG_MQ_QUEUE_POOL
+  FAR uint8_t *block;
+  size_t slot = 0;
+  int npool = 0;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -79,10 +89,23 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       return -EINVAL;
     }
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* The reserved messages are allocated in the same block as the queue so
+   * that they are released together.
+   */
+
+  if (attr && (attr->mq_flags & MQ_PREALLOC) != 0)
+    {
+      size  = ALIGN_UP(size, sizeof(FAR void *));
+      slot  = MQ_POOL_SIZE(attr->mq_msgsize);
+      npool = attr->mq_maxmsg;
+      size += slot * npool;
+    }
+#endif
+
   /* Allocate memory for the new message queue. */
 
-  msgq = (FAR struct mqueue_inode_s *)
-    kmm_zalloc(sizeof(struct mqueue_inode_s));
+  msgq = (FAR struct mqueue_inode_s *)kmm_zalloc(size);
 
   if (msgq)
     {
@@ -106,6 +129,26 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
 
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
+
+#ifdef CONFIG_MQ_QUEUE_POOL
+      /* Put the reserved messages on the free list of the queue */
+
+      list_initialize(&msgq->msgpool);
+      msgq->npool = npool;
+
+      block = (FAR uint8_t *)msgq +
+              ALIGN_UP(sizeof(struct mqueue_inode_s), sizeof(FAR void *));
+      for (i = 0; i < npool; i++)
+        {
+          FAR struct mqueue_poolmsg_s *poolmsg =
+            (FAR struct mqueue_poolmsg_s *)block;
+
+          poolmsg->msgq     = msgq;
+          poolmsg->msg.type = MQ_ALLOC_POOL;
+          list_add_tail(&msgq->msgpool, &poolmsg->msg.node);
+          block += slot;
+        }
+#endif
     }
   else
     {
@@ -28,6 +28,7 @@
 
 #include <debug.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 #include "mqueue/mqueue.h"
 
 /****************************************************************************
@@ -56,6 +57,9 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct mqueue_msg_s *entry;
   FAR struct mqueue_msg_s *tmp;
+#ifdef CONFIG_MQ_QUEUE_POOL
+  irqstate_t flags;
+#endif
 
   /* Deallocate any stranded messages in the message queue. */
 
@@ -68,6 +72,22 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       nxmq_free_msg(entry);
     }
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* Reserved messages that were received but not yet released still point
+   * to the queue.  In that case, the last of them frees the queue.
+   */
+
+  flags = spin_lock_irqsave(NULL);
+  if (msgq->npoolused > 0)
+    {
+      msgq->poolorphan = true;
+      spin_unlock_irqrestore(NULL, flags);
+      return;
+    }
+
+  spin_unlock_irqrestore(NULL, flags);
+#endif
+
   /* Then deallocate the message queue itself */
 
   kmm_free(msgq);
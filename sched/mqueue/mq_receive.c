@@ -140,9 +140,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
                                       FAR const struct timespec *abstime,
                                       sclock_t ticks)
 {
-  FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   ssize_t ret = 0;
 
   DEBUGASSERT(up_interrupt_context() == false);
@@ -171,10 +169,75 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
     }
 #endif
 
-  msgq = mq->f_inode->i_private;
+  ret = nxmq_receive_msg(mq, &mqmsg, abstime, ticks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Return the message to the caller */
 
-  /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
-   * because messages can be sent from interrupt level.
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  ret = MQ_MSG_LEN(mqmsg);
+  if ((size_t)ret > msglen)
+    {
+      /* Only a loaned message may be larger than the maximum message size
+       * of the queue.
+       */
+
+      ret = -EMSGSIZE;
+    }
+  else
+    {
+      memcpy(msg, mqmsg->mail, ret);
+    }
+
+  /* Free the message structure */
+
+  nxmq_free_msg(mqmsg);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_receive_msg
+ *
+ * Description:
+ *   Remove the highest priority message from the message queue, waiting
+ *   for one if the queue is empty, and pass ownership to the caller.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   rcvmsg  - The location to return the message
+ *   abstime - the absolute time to wait until a timeout is declared
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success and the caller must release the
+ *   message with nxmq_free_msg().  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxmq_receive_msg(FAR struct file *mq, FAR struct mqueue_msg_s **rcvmsg,
+                     FAR const struct timespec *abstime, sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  /* nxmq_wait_receive() expects to have interrupts disabled because
+   * messages can be sent from interrupt level.
    */
 
   flags = enter_critical_section();
@@ -215,27 +278,10 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   leave_critical_section(flags);
 
-  /* Return the message to the caller */
-
-  if (prio)
-    {
-      *prio = mqmsg->priority;
-    }
-
-  memcpy(msg, mqmsg->mail, mqmsg->msglen);
-  ret = mqmsg->msglen;
-
-  /* Free the message structure */
-
-  nxmq_free_msg(mqmsg);
-
-  return ret;
+  *rcvmsg = mqmsg;
+  return OK;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: file_mq_timedreceive
  *
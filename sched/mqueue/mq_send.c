@@ -110,8 +110,10 @@ static int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  If the queue reserved messages at creation time
+ *   (MQ_PREALLOC), the message is taken from the queue's own pool.
+ *   Otherwise, or if that pool is empty, the message will be allocated
+ *   from the g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -124,19 +126,51 @@ static int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *   handler will be notified.
  *
  * Input Parameters:
- *   None
+ *   msgq    - The message queue the message will be sent to
+ *   msgsize - The size of the message data
  *
  * Returned Value:
- *   A reference to the allocated msg structure.  On a failure to allocate,
- *   this function PANICs.
+ *   A reference to the allocated msg structure.  NULL is returned on a
+ *   failure to allocate.
  *
  ****************************************************************************/
 
-static FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
+static FAR struct mqueue_msg_s *
+nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq, uint16_t msgsize)
 {
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* Try the messages reserved for this queue first */
+
+  if (msgq->npool > 0)
+    {
+      mqmsg = NULL;
+
+      flags = spin_lock_irqsave(NULL);
+      if (msgsize <= msgq->maxmsgsize)
+        {
+          mqmsg = (FAR struct mqueue_msg_s *)
+            list_remove_head(&msgq->msgpool);
+          if (mqmsg != NULL)
+            {
+              msgq->npoolused++;
+            }
+        }
+
+      spin_unlock_irqrestore(NULL, flags);
+
+      if (mqmsg != NULL)
+        {
+          atomic_fetch_add(&g_mqstats.pool, 1);
+          return mqmsg;
+        }
+
+      atomic_fetch_add(&g_mqstats.poolmiss, 1);
+    }
+#endif
+
   /* Try to get the message from the generally available free list. */
 
   flags = spin_lock_irqsave(NULL);
@@ -177,8 +211,14 @@ static FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
                */
 
               mqmsg->type = MQ_ALLOC_DYN;
+              atomic_fetch_add(&g_mqstats.heap, 1);
             }
         }
+
+      if (mqmsg == NULL)
+        {
+          atomic_fetch_add(&g_mqstats.fail, 1);
+        }
     }
 
   return mqmsg;
@@ -277,9 +317,7 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
                                FAR const struct timespec *abstime,
                                sclock_t ticks)
 {
-  FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   int ret = 0;
 
   /* Verify the input parameters */
@@ -304,19 +342,61 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
     }
 #endif
 
-  msgq = mq->f_inode->i_private;
-
   /* Pre-allocate a message structure */
 
-  mqmsg = nxmq_alloc_msg(msglen);
+  mqmsg = nxmq_alloc_msg(mq->f_inode->i_private, msglen);
   if (!mqmsg)
     {
       return -ENOMEM;
     }
 
   memcpy(mqmsg->mail, msg, msglen);
+  mqmsg->msglen = msglen;
+
+  ret = nxmq_send_msg(mq, mqmsg, prio, abstime, ticks);
+  if (ret < 0)
+    {
+      nxmq_free_msg(mqmsg);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_send_msg
+ *
+ * Description:
+ *   Add a message that has already been filled in to the message queue,
+ *   waiting for space if the queue is full.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   mqmsg   - The message to add to the queue
+ *   prio    - The priority of the message
+ *   abstime - the absolute time to wait until a timeout is decleared
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success and the queue owns the message.  A
+ *   negated errno value is returned on failure and the caller still owns
+ *   the message.
+ *
+ ****************************************************************************/
+
+int nxmq_send_msg(FAR struct file *mq, FAR struct mqueue_msg_s *mqmsg,
+                  unsigned int prio, FAR const struct timespec *abstime,
+                  sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  irqstate_t flags;
+  int ret = 0;
+
   mqmsg->priority = prio;
-  mqmsg->msglen   = msglen;
 
   /* Disable interruption */
 
@@ -360,19 +440,9 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
 out:
   leave_critical_section(flags);
-
-  if (ret < 0)
-    {
-      nxmq_free_msg(mqmsg);
-    }
-
   return ret;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: file_mq_timedsend
  *
@@ -38,6 +38,7 @@
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/nuttx.h>
 
 #if defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -51,6 +52,33 @@
 
 #define MQ_MSG_SIZE(n) (sizeof(struct mqueue_msg_s) + (n) - 1)
 
+#ifdef CONFIG_MQ_LOAN
+/* Size of one loaned buffer and conversions between a loaned message and
+ * the message header embedded in it.
+ */
+
+#  define MQ_LOAN_SIZE \
+     (sizeof(struct mqueue_loan_s) + CONFIG_MQ_LOAN_BUFSIZE - 1)
+#  define MQ_MSG_LOAN(m) container_of(m, struct mqueue_loan_s, msg)
+
+/* The length of the data of any message */
+
+#  define MQ_MSG_LEN(m) \
+     ((m)->type == MQ_ALLOC_LOAN ? MQ_MSG_LOAN(m)->len : (m)->msglen)
+#else
+#  define MQ_MSG_LEN(m) ((m)->msglen)
+#endif
+
+#ifdef CONFIG_MQ_QUEUE_POOL
+/* Size of one message of a per-queue pool with a payload of n bytes and
+ * conversion from the message to its pool header.
+ */
+
+#  define MQ_POOL_SIZE(n) \
+     ALIGN_UP(sizeof(struct mqueue_poolmsg_s) + (n) - 1, sizeof(FAR void *))
+#  define MQ_MSG_POOL(m) container_of(m, struct mqueue_poolmsg_s, msg)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -59,7 +87,9 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_LOAN,       /* Loaned buffer from the loan pool */
+  MQ_ALLOC_POOL        /* Reserved for one queue, see MQ_PREALLOC */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -77,6 +107,28 @@ struct mqueue_msg_s
   char mail[1];            /* Message data */
 };
 
+#ifdef CONFIG_MQ_LOAN
+/* This structure describes one loaned message buffer.  The message data
+ * starts at msg.mail and may be up to CONFIG_MQ_LOAN_BUFSIZE bytes long.
+ */
+
+struct mqueue_loan_s
+{
+  size_t len;                /* Message data length */
+  struct mqueue_msg_s msg;   /* Message header, must be last */
+};
+#endif
+
+#ifdef CONFIG_MQ_QUEUE_POOL
+/* This structure describes one message of a per-queue pool */
+
+struct mqueue_poolmsg_s
+{
+  FAR struct mqueue_inode_s *msgq; /* The queue owning the message */
+  struct mqueue_msg_s msg;         /* Message header, must be last */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -128,6 +180,11 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
                       sclock_t ticks);
 void nxmq_notify_receive(FAR struct mqueue_inode_s *msgq);
 
+/* mq_receive.c *************************************************************/
+
+int nxmq_receive_msg(FAR struct file *mq, FAR struct mqueue_msg_s **rcvmsg,
+                     FAR const struct timespec *abstime, sclock_t ticks);
+
 /* mq_sndinternal.c *********************************************************/
 
 int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
@@ -135,6 +192,19 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
                    sclock_t ticks);
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
 
+/* mq_send.c ****************************************************************/
+
+int nxmq_send_msg(FAR struct file *mq, FAR struct mqueue_msg_s *mqmsg,
+                  unsigned int prio, FAR const struct timespec *abstime,
+                  sclock_t ticks);
+
+/* mq_loan.c ****************************************************************/
+
+#ifdef CONFIG_MQ_LOAN
+void nxmq_loan_initialize(void);
+void nxmq_loan_release(FAR struct mqueue_msg_s *mqmsg);
+#endif
+
 /* mq_recover.c *************************************************************/
 
 void nxmq_recover(FAR struct tcb_s *tcb);
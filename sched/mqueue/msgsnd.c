@@ -212,6 +212,7 @@ int msgsnd(int msqid, FAR const void *msgp, size_t msgsz, int msgflg)
       msg = (FAR struct msgbuf_s *)list_remove_head(&g_msgfreelist);
       if (msg == NULL)
         {
+          atomic_fetch_add(&g_mqstats.fail, 1);
           ret = -ENOMEM;
           goto errout_with_critical;
         }
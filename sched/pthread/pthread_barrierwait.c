@@ -95,11 +95,8 @@ int pthread_barrier_wait(FAR pthread_barrier_t *barrier)
     {
       /* Free all of the waiting threads */
 
-      while (barrier->wait_count > 0)
-        {
-          barrier->wait_count--;
-          nxsem_post(&barrier->sem);
-        }
+      nxsem_post_many(&barrier->sem, barrier->wait_count);
+      barrier->wait_count = 0;
 
       /* Then return PTHREAD_BARRIER_SERIAL_THREAD to the final thread */
 
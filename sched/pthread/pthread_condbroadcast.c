@@ -69,28 +69,20 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
   else
     {
       /* Disable pre-emption until all of the waiting threads have been
-       * restarted. This is necessary to assure that the sval behaves as
-       * expected in the following while loop
+       * restarted. This is necessary to assure that the wait_count
+       * behaves as expected.
        */
 
       sched_lock();
 
-      /* Loop until all of the waiting threads have been restarted. */
+      /* Post the condition semaphore once for each waiting thread.  All of
+       * them are made ready-to-run in one pass.
+       */
 
-      while (cond->wait_count > 0)
+      if (cond->wait_count > 0)
         {
-          /* If the value is less than zero (meaning that one or more
-           * thread is waiting), then post the condition semaphore.
-           * Only the highest priority waiting thread will get to execute
-           */
-
-          ret = -nxsem_post(&cond->sem);
-
-          /* Increment the semaphore count (as was done by the
-           * above post).
-           */
-
-          cond->wait_count--;
+          ret = -nxsem_post_many(&cond->sem, cond->wait_count);
+          cond->wait_count = 0;
         }
 
       /* Now we can let the restarted threads run */
@@ -0,0 +1,203 @@
+/****************************************************************************
+ * sched/rcu/rcu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <sched.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/rcu.h>
+#include <nuttx/sched.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "rcu/rcu.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_RCU
+/* Callbacks waiting for the next grace period */
+
+static spinlock_t g_rcu_lock = SP_UNLOCKED;
+static sq_queue_t g_rcu_pending;
+static struct work_s g_rcu_work;
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if defined(CONFIG_RCU) && defined(CONFIG_SMP)
+volatile uint32_t g_rcu_qscount[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_sync_handler
+ *
+ * Description:
+ *   Runs with interrupts enabled on the target CPU, which proves that no
+ *   read-side section started before the call is still in progress there.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static int rcu_sync_handler(FAR void *arg)
+{
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: rcu_worker
+ *
+ * Description:
+ *   Invoke the callbacks queued by call_rcu() after a grace period.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RCU
+static void rcu_worker(FAR void *arg)
+{
+  FAR struct rcu_head *head;
+  FAR sq_entry_t *curr;
+  sq_queue_t list;
+  irqstate_t flags;
+
+  /* Callbacks queued after this point wait for the next run */
+
+  flags = spin_lock_irqsave(&g_rcu_lock);
+  list = g_rcu_pending;
+  sq_init(&g_rcu_pending);
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+
+  synchronize_rcu();
+
+  while ((curr = sq_remfirst(&list)) != NULL)
+    {
+      head = container_of(curr, struct rcu_head, entry);
+      head->func(head);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until every read-side section in progress at the time of the call
+ *   has completed.  See include/nuttx/rcu.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void synchronize_rcu(void)
+{
+#ifdef CONFIG_RCU
+  uint32_t snapshot[CONFIG_SMP_NCPUS];
+#endif
+  cpu_set_t cpuset;
+  int cpu;
+
+  DEBUGASSERT(!up_interrupt_context());
+
+#ifdef CONFIG_RCU
+  /* Give the CPUs one tick to pass through a context switch on their own;
+   * those which did are quiescent.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      snapshot[cpu] = g_rcu_qscount[cpu];
+    }
+
+  nxsig_usleep(USEC_PER_TICK);
+#endif
+
+  CPU_ZERO(&cpuset);
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+#ifdef CONFIG_RCU
+      if (g_rcu_qscount[cpu] != snapshot[cpu])
+        {
+          continue;
+        }
+#endif
+
+      CPU_SET(cpu, &cpuset);
+    }
+
+  /* Force the remaining CPUs through a quiescent state */
+
+  if (CPU_COUNT(&cpuset) > 0)
+    {
+      nxsched_smp_call(cpuset, rcu_sync_handler, NULL);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Call func(head) on the low priority work queue after a grace period.
+ *   See include/nuttx/rcu.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RCU
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func)
+{
+  irqstate_t flags;
+  bool queue;
+
+  DEBUGASSERT(head != NULL && func != NULL);
+
+  head->func = func;
+
+  flags = spin_lock_irqsave(&g_rcu_lock);
+  sq_addlast(&head->entry, &g_rcu_pending);
+  queue = work_available(&g_rcu_work);
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+
+  if (queue)
+    {
+      work_queue(LPWORK, &g_rcu_work, rcu_worker, NULL, 0);
+    }
+}
+#endif
@@ -73,6 +73,10 @@
 
 #define is_idle_task(t)          ((t)->pid < CONFIG_SMP_NCPUS)
 
+/* Number of 32-bit words in the ready-to-run priority bitmap */
+
+#define SCHED_PRIORITY_WORDS     ((SCHED_PRIORITY_MAX + 32) / 32)
+
 /* This macro returns the running task which may different from this_task()
  * during interrupt level context switches.
  */
@@ -155,6 +159,15 @@ struct tasklist_s
 
 extern dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+/* The index over g_readytorun:  A bitmap of the priorities present in the
+ * list and the last TCB of each priority level in the list.
+ */
+
+extern uint32_t g_readytorun_map[SCHED_PRIORITY_WORDS];
+extern FAR struct tcb_s *g_readytorun_tail[SCHED_PRIORITY_MAX + 1];
+#endif
+
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
@@ -318,6 +331,23 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+/* Ready-to-run list index */
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+FAR struct tcb_s *nxsched_prioritymap_position(FAR struct tcb_s *tcb);
+void nxsched_prioritymap_add(FAR struct tcb_s *tcb);
+void nxsched_prioritymap_remove(FAR struct tcb_s *tcb);
+void nxsched_prioritymap_setpriority(FAR struct tcb_s *tcb, int priority);
+
+/* Change the priority of the running task without moving it */
+
+#  define nxsched_running_priority(tcb, priority) \
+     nxsched_prioritymap_setpriority(tcb, priority)
+#else
+#  define nxsched_running_priority(tcb, priority) \
+     ((tcb)->sched_priority = (uint8_t)(priority))
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -354,6 +384,15 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_set_deadline(FAR struct tcb_s *tcb,
+                          FAR const struct sched_param *param);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -389,6 +428,10 @@ static inline_function FAR struct tcb_s *this_task(void)
 
 #ifdef CONFIG_SMP
 void nxsched_process_delivered(int cpu);
+#  ifdef CONFIG_SCHED_LOADBALANCE
+void nxsched_loadbalance_kick(void);
+void nxsched_loadbalance_initialize(void);
+#  endif
 #else
 #  define nxsched_select_cpu(a)     (0)
 #endif
@@ -404,6 +447,26 @@ void nxsched_process_cpuload_ticks(clock_t ticks);
 #define nxsched_process_cpuload() nxsched_process_cpuload_ticks(1)
 #endif
 
+/* Per-thread CPU time accounting */
+
+#ifdef CONFIG_SCHED_CPUTIME
+void nxsched_resume_cputime(FAR struct tcb_s *tcb);
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb);
+#endif
+
+/* Wakeup latency monitor */
+
+#ifdef CONFIG_SCHED_LATENCY
+void nxsched_ready_latency(FAR struct tcb_s *tcb);
+void nxsched_resume_latency(FAR struct tcb_s *tcb);
+#endif
+
+/* TCB object cache */
+
+#ifdef CONFIG_SCHED_TCB_CACHE
+void nxsched_tcbcache_initialize(void);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -436,25 +499,65 @@ FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
  * Inline functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_before
+ *
+ * Description:
+ *   Return true if 'tcb' must be placed ahead of 'next' in a prioritized
+ *   task list: it has a higher priority or, with SCHED_DEADLINE, both are
+ *   deadline threads of the same priority and 'tcb' has the earlier
+ *   absolute deadline.  Threads of equal rank keep FIFO order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define nxsched_is_deadline(tcb) \
+     (((tcb)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+
+static inline_function bool nxsched_before(FAR struct tcb_s *tcb,
+                                           FAR struct tcb_s *next)
+{
+  if (tcb->sched_priority != next->sched_priority)
+    {
+      return tcb->sched_priority > next->sched_priority;
+    }
+
+  return nxsched_is_deadline(tcb) && nxsched_is_deadline(next) &&
+         (sclock_t)(tcb->deadline->expire - next->deadline->expire) < 0;
+}
+#else
+#  define nxsched_before(tcb, next) \
+     ((tcb)->sched_priority > (next)->sched_priority)
+#endif
+
 static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
                                                     DSEG dq_queue_t *list)
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
-  uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
   /* Lets do a sanity check before we get started. */
 
-  DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
+  DEBUGASSERT(tcb->sched_priority >= SCHED_PRIORITY_MIN);
 
   /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+   * Each is list is maintained in descending sched_priority order (and
+   * ascending deadline order among deadline threads of equal priority).
    */
 
-  for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
-       next = next->flink);
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+  if (list == list_readytorun())
+    {
+      next = nxsched_prioritymap_position(tcb);
+    }
+  else
+#endif
+    {
+      for (next = (FAR struct tcb_s *)list->head;
+           (next && !nxsched_before(tcb, next));
+           next = next->flink);
+    }
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -512,6 +615,13 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
         }
     }
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+  if (list == list_readytorun())
+    {
+      nxsched_prioritymap_add(tcb);
+    }
+#endif
+
   return ret;
 }
 
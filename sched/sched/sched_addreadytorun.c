@@ -71,13 +71,19 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_LATENCY
+  /* Start measuring the wakeup latency */
+
+  nxsched_ready_latency(btcb);
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 && nxsched_before(btcb, rtcb))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -161,6 +167,12 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int cpu;
   int me;
 
+#ifdef CONFIG_SCHED_LATENCY
+  /* Start measuring the wakeup latency */
+
+  nxsched_ready_latency(btcb);
+#endif
+
   cpu = nxsched_select_cpu(btcb->affinity);
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -173,7 +185,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    * required.
    */
 
-  if (rtcb->sched_priority < btcb->sched_priority)
+  if (nxsched_before(btcb, rtcb))
     {
       task_state = TSTATE_TASK_RUNNING;
     }
@@ -239,7 +251,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
           else
             {
               rtcb = g_delivertasks[cpu];
-              if (rtcb->sched_priority < btcb->sched_priority)
+              if (nxsched_before(btcb, rtcb))
                 {
                   g_delivertasks[cpu] = btcb;
                   btcb->cpu = cpu;
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * sched/sched/sched_cputime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUTIME
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_resume_cputime
+ *
+ * Description:
+ *   Called when a thread resumes execution to start its time slice.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_resume_cputime(FAR struct tcb_s *tcb)
+{
+  tcb->run_start = perf_gettime();
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_cputime
+ *
+ * Description:
+ *   Called when a thread suspends execution to charge it the time slice
+ *   that just ended.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb)
+{
+  tcb->run_time += perf_gettime() - tcb->run_start;
+}
+
+/****************************************************************************
+ * Name: nxsched_get_cputime
+ *
+ * Description:
+ *   Return the CPU time consumed by a thread.  See include/nuttx/sched.h.
+ *
+ ****************************************************************************/
+
+clock_t nxsched_get_cputime(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+  clock_t runtime;
+
+  /* The time slice of a running thread is not charged until it is
+   * suspended, add the part that has elapsed so far.  Only a context
+   * switch on this CPU is excluded: a thread running on another CPU may
+   * be switched out meanwhile, which is not worth a global lock here.
+   */
+
+  flags   = enter_critical_section_local();
+  runtime = tcb->run_time;
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      runtime += perf_gettime() - tcb->run_start;
+    }
+
+  leave_critical_section_local(flags);
+  return runtime;
+}
+
+#endif /* CONFIG_SCHED_CPUTIME */
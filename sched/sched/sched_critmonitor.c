@@ -100,6 +100,12 @@ clock_t g_premp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif
 
+/* Number of times each CPU found the critical section held by another CPU */
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 && defined(CONFIG_SMP)
+uint32_t g_crit_contention[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -147,6 +153,7 @@ static void nxsched_critmon_cpuload(FAR struct tcb_s *tcb, clock_t current,
 
       /* Update start time, avoid repeated statistics when the next call */
 
+      rtcb->run_time += current - rtcb->run_start;
       rtcb->run_start = current;
     }
 #  endif
@@ -280,10 +287,6 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb)
 
   UNUSED(current);
 
-#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
-  tcb->run_start = current;
-#endif
-
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
   /* Did this task disable pre-emption? */
 
@@ -333,8 +336,9 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
 
   UNUSED(cpu);
 
+  /* The time slice itself is charged by nxsched_suspend_cputime() */
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
-  tcb->run_time += elapsed;
   if (elapsed > tcb->run_max)
     {
       tcb->run_max = elapsed;
@@ -410,9 +414,12 @@ void nxsched_update_critmon(FAR struct tcb_s *tcb)
 
   tcb->run_start = current;
   tcb->run_time += elapsed;
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
   if (elapsed > tcb->run_max)
     {
       tcb->run_max = elapsed;
       CHECK_THREAD(tcb->pid, elapsed);
     }
+#endif
 }
@@ -0,0 +1,425 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths (runtime / period) are kept as fixed point fractions */
+
+#define DEADLINE_BW_SHIFT  20
+#define DEADLINE_BW_ONE    (UINT32_C(1) << DEADLINE_BW_SHIFT)
+
+/* The admission limit for the sum of all deadline bandwidths */
+
+#define DEADLINE_BW_LIMIT \
+  (DEADLINE_BW_ONE / 100 * CONFIG_SCHED_DEADLINE_UTILIZATION * \
+   CONFIG_SMP_NCPUS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The total bandwidth reserved by all deadline threads */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Change the priority of a deadline thread, respecting any priority
+ *   boost from priority inheritance.
+ *
+ * Input Parameters:
+ *   tcb      - TCB of the thread whose priority will be modified
+ *   priority - The new base priority
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* If the thread is boosted to at least the new priority, just reset the
+   * base priority and continue to run at the boosted priority.
+   */
+
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority >= priority)
+    {
+      tcb->base_priority = priority;
+      return OK;
+    }
+#endif
+
+  return nxsched_reprioritize(tcb, priority);
+}
+
+/****************************************************************************
+ * Name: deadline_replenish_expire
+ *
+ * Description:
+ *   The next period of a throttled thread has started: replenish its
+ *   budget, set the new absolute deadline and restore its priority.
+ *
+ * Input Parameters:
+ *   arg - The TCB of the throttled thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_replenish_expire(wdparm_t arg)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg;
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  dl = tcb->deadline;
+
+  /* Any overrun (made while the thread held the scheduler lock) is
+   * charged against the new budget.
+   */
+
+  dl->budget    = dl->runtime + (dl->budget < 0 ? dl->budget : 0);
+  if (dl->budget < 1)
+    {
+      dl->budget = 1;
+    }
+
+  dl->expire    = clock_systime_ticks() + dl->deadline;
+  dl->throttled = false;
+
+  DEBUGVERIFY(deadline_set_priority(tcb, CONFIG_SCHED_DEADLINE_PRIORITY));
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: deadline_throttle
+ *
+ * Description:
+ *   The thread has exhausted its budget: drop it to the minimum priority
+ *   until its next period starts.
+ *
+ * Input Parameters:
+ *   tcb - TCB of the thread that is throttled
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+static void deadline_throttle(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  sclock_t delay;
+
+  /* The next period starts one period after the start of the current one */
+
+  delay = (sclock_t)(dl->expire - dl->deadline + dl->period -
+                     clock_systime_ticks());
+  if (delay < 1)
+    {
+      delay = 1;
+    }
+
+  dl->throttled = true;
+  wd_start(&dl->timer, delay, deadline_replenish_expire, (wdparm_t)tcb);
+
+  DEBUGVERIFY(deadline_set_priority(tcb, SCHED_PRIORITY_MIN));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_set_deadline
+ *
+ * Description:
+ *   Establish (or change) the deadline scheduling parameters of a thread
+ *   and start its first period.  Called from sched_setscheduler() and
+ *   sched_setparam().
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - Holds the runtime, deadline and period of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL The parameters are not 0 < runtime <= deadline <= period.
+ *   EBUSY  Admitting the thread would exceed the bandwidth limit.
+ *   ENOMEM The deadline state could not be allocated.
+ *
+ *   On failure the thread keeps its previous deadline parameters, if any.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int nxsched_set_deadline(FAR struct tcb_s *tcb,
+                         FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl;
+  uint32_t bandwidth;
+  uint32_t oldbw;
+  clock_t runtime;
+  clock_t deadline;
+  clock_t period;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+
+  /* Convert timespec values to system clock ticks */
+
+  runtime  = clock_time2ticks(&param->sched_dl_runtime);
+  deadline = clock_time2ticks(&param->sched_dl_deadline);
+  period   = clock_time2ticks(&param->sched_dl_period);
+
+  if (deadline == 0)
+    {
+      deadline = period;
+    }
+
+  if (runtime < 1 || runtime > deadline || deadline > period)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control */
+
+  bandwidth = (uint32_t)(((uint64_t)runtime << DEADLINE_BW_SHIFT) / period);
+  oldbw     = tcb->deadline != NULL ? tcb->deadline->bandwidth : 0;
+
+  if (g_deadline_bw - oldbw + bandwidth > DEADLINE_BW_LIMIT)
+    {
+      serr("ERROR: Bandwidth exceeded: %" PRIu32 " + %" PRIu32 "\n",
+           g_deadline_bw - oldbw, bandwidth);
+      return -EBUSY;
+    }
+
+  /* Allocate the deadline add-on data structure on first use */
+
+  dl = tcb->deadline;
+  if (dl == NULL)
+    {
+      dl = kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      tcb->deadline = dl;
+    }
+  else
+    {
+      wd_cancel(&dl->timer);
+    }
+
+  g_deadline_bw  = g_deadline_bw - oldbw + bandwidth;
+
+  /* Save the parameters and start the first period now */
+
+  dl->bandwidth  = bandwidth;
+  dl->runtime    = runtime;
+  dl->deadline   = deadline;
+  dl->period     = period;
+  dl->budget     = runtime;
+  dl->expire     = clock_systime_ticks() + deadline;
+  dl->throttled  = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Called to terminate deadline scheduling on a given thread, to release
+ *   its bandwidth and to free all resources associated with the policy.
+ *   This happens when the thread exits or when another scheduling policy
+ *   is selected via sched_setscheduler().
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is ending deadline scheduling.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  dl = tcb->deadline;
+
+  wd_cancel(&dl->timer);
+  g_deadline_bw -= dl->bandwidth;
+
+  kmm_free(dl);
+  tcb->deadline = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Apply the constant bandwidth server wakeup rule when a deadline thread
+ *   leaves the blocked state: the current deadline and budget are kept only
+ *   if the remaining budget can be consumed before that deadline without
+ *   exceeding the reserved bandwidth.  Otherwise a new period starts now.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is becoming ready-to-run.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  clock_t now;
+  sclock_t left;
+
+  if (dl == NULL || dl->throttled)
+    {
+      return;
+    }
+
+  now  = clock_systime_ticks();
+  left = (sclock_t)(dl->expire - now);
+
+  if (left <= 0 || dl->budget <= 0 ||
+      (uint64_t)dl->budget * dl->period > (uint64_t)left * dl->runtime)
+    {
+      dl->expire = now + dl->deadline;
+      dl->budget = dl->runtime;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_process_deadline
+ *
+ * Description:
+ *   Charge the elapsed time to the running deadline thread and throttle it
+ *   when its budget is exhausted.  Called from the timer interrupt handler.
+ *
+ * Input Parameters:
+ *   tcb        - The TCB of the running deadline thread.
+ *   ticks      - The number of elapsed ticks since the last time this
+ *                function was called.
+ *   noswitches - We are running in a context where context switching is
+ *                not permitted.
+ *
+ * Returned Value:
+ *   The number if ticks remaining until the budget is exhausted.  Zero is
+ *   returned if the thread is throttled.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches)
+{
+  FAR struct deadline_s *dl;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  dl = tcb->deadline;
+
+  if (dl->throttled)
+    {
+      return 0;
+    }
+
+  dl->budget -= ticks;
+  if (dl->budget > 0)
+    {
+      return dl->budget;
+    }
+
+  /* The budget is exhausted.  If the thread has the scheduler locked or
+   * we cannot switch now, let it overrun and try again on the next tick.
+   * The overrun is charged against the next period.
+   */
+
+  if (nxsched_islocked_tcb(tcb) || noswitches)
+    {
+      return 1;
+    }
+
+  deadline_throttle(tcb);
+  return 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -91,8 +91,16 @@ int nxsched_get_scheduler(pid_t pid)
 
   /* Return the scheduling policy from the TCB.  NOTE that the user-
    * interpretable values are 1 based; the TCB values are zero-based.
+   * SCHED_DEADLINE does not follow that rule.
    */
 
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      return SCHED_DEADLINE;
+    }
+#endif
+
   policy = (tcb->flags & TCB_FLAG_POLICY_MASK) >> TCB_FLAG_POLICY_SHIFT;
   return policy + 1;
 }
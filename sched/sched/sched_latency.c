@@ -0,0 +1,141 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Wakeup latency histograms of all threads, per priority band */
+
+uint32_t g_sched_latency[SCHED_LATENCY_NBANDS][SCHED_LATENCY_NBUCKETS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_ready_latency
+ *
+ * Description:
+ *   Called when a thread is made ready to run to record the time the
+ *   wakeup latency is measured from.  A thread that is already stamped,
+ *   e.g. one moved from the pending list by nxsched_merge_pending() or
+ *   re-added by nxsched_reprioritize_rtr(), keeps its original time.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_ready_latency(FAR struct tcb_s *tcb)
+{
+  if (tcb->ready_time == 0)
+    {
+      tcb->ready_time = perf_gettime();
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_latency
+ *
+ * Description:
+ *   Called when a thread resumes execution.  If the thread was made ready
+ *   to run since it last ran, the time it waited is added to its own
+ *   histogram and to the histogram of its priority band.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_resume_latency(FAR struct tcb_s *tcb)
+{
+  uint64_t usec;
+  int bucket;
+
+  /* Threads that were pre-empted, rather than woken up, are not stamped */
+
+  if (tcb->ready_time == 0)
+    {
+      return;
+    }
+
+  usec = (uint64_t)(perf_gettime() - tcb->ready_time) * USEC_PER_SEC /
+         perf_getfreq();
+  tcb->ready_time = 0;
+
+  bucket = flsll(usec);
+  if (bucket >= SCHED_LATENCY_NBUCKETS)
+    {
+      bucket = SCHED_LATENCY_NBUCKETS - 1;
+    }
+
+  tcb->latency[bucket]++;
+  g_sched_latency[tcb->sched_priority / CONFIG_SCHED_LATENCY_PRIOBAND]
+                 [bucket]++;
+}
+
+/****************************************************************************
+ * Name: nxsched_reset_latency
+ *
+ * Description:
+ *   Clear a wakeup latency histogram.  See include/nuttx/sched.h.
+ *
+ ****************************************************************************/
+
+void nxsched_reset_latency(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (tcb != NULL)
+    {
+      memset(tcb->latency, 0, sizeof(tcb->latency));
+    }
+  else
+    {
+      memset(g_sched_latency, 0, sizeof(g_sched_latency));
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_LATENCY */
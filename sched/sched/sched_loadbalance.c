@@ -0,0 +1,374 @@
+/****************************************************************************
+ * sched/sched/sched_loadbalance.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "sched/queue.h"
+
+#ifdef CONFIG_SCHED_LOADBALANCE
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int nxsched_loadbalance_handler(FAR void *arg);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The number of tasks that each CPU pulled from other CPUs (or from the
+ * unassigned g_readytorun list) and the number of tasks that were pulled
+ * away from each CPU.
+ */
+
+uint32_t g_migrate_in[CONFIG_SMP_NCPUS];
+uint32_t g_migrate_out[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The call data used to run the balance handler on the idle CPUs */
+
+static struct smp_call_data_s g_balance_data =
+{
+  nxsched_loadbalance_handler
+};
+
+/* The set of CPUs on which the balance handler is already queued.  The same
+ * call data must not be queued twice on one CPU.
+ */
+
+static cpu_set_t g_balance_pending;
+
+/* Periodic balance timer */
+
+static struct wdog_s g_balance_wdog;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_loadbalance_waiting
+ *
+ * Description:
+ *   Return true if the task is waiting in an assigned task list: it is
+ *   neither the running task at the head of the list nor the IDLE task at
+ *   the tail of the list.
+ *
+ ****************************************************************************/
+
+static inline bool nxsched_loadbalance_waiting(FAR struct tcb_s *tcb)
+{
+  return tcb != NULL && tcb->task_state == TSTATE_TASK_ASSIGNED &&
+         !is_idle_task(tcb);
+}
+
+/****************************************************************************
+ * Name: nxsched_loadbalance_cpuset
+ *
+ * Description:
+ *   Return the set of CPUs that are executing their IDLE task while there
+ *   is a waiting task that is permitted to run on them.  CPUs on which the
+ *   balance handler is already pending are excluded.
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+static cpu_set_t nxsched_loadbalance_cpuset(void)
+{
+  FAR struct tcb_s *tcb;
+  cpu_set_t idleset = 0;
+  cpu_set_t cpuset = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      tcb = current_task(cpu);
+      if (is_idle_task(tcb) && !nxsched_islocked_tcb(tcb) &&
+          g_delivertasks[cpu] == NULL)
+        {
+          CPU_SET(cpu, &idleset);
+        }
+    }
+
+  idleset &= ~g_balance_pending;
+  if (idleset == 0)
+    {
+      return 0;
+    }
+
+  for (tcb = (FAR struct tcb_s *)list_readytorun()->head; tcb != NULL;
+       tcb = tcb->flink)
+    {
+      cpuset |= tcb->affinity & idleset;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && cpuset != idleset; cpu++)
+    {
+      tcb = (FAR struct tcb_s *)g_assignedtasks[cpu].head;
+      for (tcb = tcb->flink; nxsched_loadbalance_waiting(tcb);
+           tcb = tcb->flink)
+        {
+          cpuset |= tcb->affinity & idleset;
+        }
+    }
+
+  return cpuset;
+}
+
+/****************************************************************************
+ * Name: nxsched_loadbalance_steal
+ *
+ * Description:
+ *   Select and remove a task that may run on this CPU.  Unassigned tasks in
+ *   g_readytorun are taken first.  Otherwise the highest priority task is
+ *   taken from the CPU with the most waiting tasks that this CPU is
+ *   permitted to run.
+ *
+ * Input Parameters:
+ *   me - The index of this CPU
+ *
+ * Returned Value:
+ *   The removed TCB in the TSTATE_TASK_INVALID state or NULL if there is
+ *   nothing to balance.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *nxsched_loadbalance_steal(int me)
+{
+  FAR struct tcb_s *btcb = NULL;
+  FAR struct tcb_s *tcb;
+  int maxload = 0;
+  int busiest = -1;
+  int load;
+  int cpu;
+
+  for (tcb = (FAR struct tcb_s *)list_readytorun()->head; tcb != NULL;
+       tcb = tcb->flink)
+    {
+      if (CPU_ISSET(me, &tcb->affinity))
+        {
+          dq_rem((FAR dq_entry_t *)tcb, list_readytorun());
+          tcb->task_state = TSTATE_TASK_INVALID;
+          return tcb;
+        }
+    }
+
+  /* Find the busiest CPU.  The assigned task lists are kept in priority
+   * order, so the first eligible task is the one with the highest priority.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct tcb_s *first = NULL;
+
+      if (cpu == me)
+        {
+          continue;
+        }
+
+      load = 0;
+      tcb  = (FAR struct tcb_s *)g_assignedtasks[cpu].head;
+      for (tcb = tcb->flink; nxsched_loadbalance_waiting(tcb);
+           tcb = tcb->flink)
+        {
+          if (CPU_ISSET(me, &tcb->affinity))
+            {
+              if (first == NULL)
+                {
+                  first = tcb;
+                }
+
+              load++;
+            }
+        }
+
+      if (load > maxload)
+        {
+          maxload = load;
+          busiest = cpu;
+          btcb    = first;
+        }
+    }
+
+  if (btcb != NULL)
+    {
+      /* The task is neither the head nor the tail of the list */
+
+      dq_rem_mid(btcb);
+      btcb->task_state = TSTATE_TASK_INVALID;
+      g_migrate_out[busiest]++;
+    }
+
+  return btcb;
+}
+
+/****************************************************************************
+ * Name: nxsched_loadbalance_handler
+ *
+ * Description:
+ *   Runs on an idle CPU, either directly or from the SMP call interrupt,
+ *   and makes a stolen task the running task of that CPU.
+ *
+ ****************************************************************************/
+
+static int nxsched_loadbalance_handler(FAR void *arg)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
+  int me;
+
+  flags = enter_critical_section();
+
+  me = this_cpu();
+  CPU_CLR(me, &g_balance_pending);
+
+  /* Things may have changed since the request was sent */
+
+  rtcb = current_task(me);
+  if (is_idle_task(rtcb) && !nxsched_islocked_tcb(rtcb) &&
+      g_delivertasks[me] == NULL)
+    {
+      btcb = nxsched_loadbalance_steal(me);
+      if (btcb != NULL)
+        {
+          /* Change the IDLE task from TSTATE_TASK_RUNNING to
+           * TSTATE_TASK_ASSIGNED and make btcb the running task.
+           */
+
+          rtcb->task_state = TSTATE_TASK_ASSIGNED;
+          dq_addfirst_nonempty((FAR dq_entry_t *)btcb,
+                               &g_assignedtasks[me]);
+
+          btcb->cpu        = me;
+          btcb->task_state = TSTATE_TASK_RUNNING;
+          g_migrate_in[me]++;
+
+          up_update_task(btcb);
+          up_switch_context(btcb, rtcb);
+        }
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_loadbalance_timeout
+ *
+ * Description:
+ *   The periodic balance timer handler.
+ *
+ ****************************************************************************/
+
+static void nxsched_loadbalance_timeout(wdparm_t arg)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  nxsched_loadbalance_kick();
+  leave_critical_section(flags);
+
+  wd_start(&g_balance_wdog, CONFIG_SCHED_LOADBALANCE_INTERVAL,
+           nxsched_loadbalance_timeout, arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_loadbalance_kick
+ *
+ * Description:
+ *   Ask every idle CPU that could run one of the waiting tasks to pull that
+ *   task.  The request is sent with nxsched_smp_call_async() and the tasks
+ *   are moved by the idle CPUs themselves.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the critical section and is running in interrupt
+ *   context.
+ *
+ ****************************************************************************/
+
+void nxsched_loadbalance_kick(void)
+{
+  cpu_set_t cpuset;
+
+  DEBUGASSERT(up_interrupt_context());
+
+  cpuset = nxsched_loadbalance_cpuset();
+  if (cpuset != 0)
+    {
+      g_balance_pending |= cpuset;
+      nxsched_smp_call_async(cpuset, &g_balance_data);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_loadbalance_initialize
+ *
+ * Description:
+ *   Start the periodic load balance timer.  Called once from nx_start()
+ *   after the other CPUs have been started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_loadbalance_initialize(void)
+{
+  wd_start(&g_balance_wdog, CONFIG_SCHED_LOADBALANCE_INTERVAL,
+           nxsched_loadbalance_timeout, 0);
+}
+
+#endif /* CONFIG_SCHED_LOADBALANCE */
@@ -92,6 +92,19 @@ int sched_lock(void)
 
       DEBUGASSERT(rtcb->lockcount < MAX_LOCK_COUNT);
 
+      /* If pre-emption is already disabled, this is a nested lock:  The
+       * task cannot migrate and only the lockcount of this TCB changes, so
+       * there is no need to contend for the global critical section.
+       */
+
+      if (rtcb->lockcount > 0)
+        {
+          flags = enter_critical_section_local();
+          rtcb->lockcount++;
+          leave_critical_section_local(flags);
+          return OK;
+        }
+
       flags = enter_critical_section();
 
       /* A counter is used to support locking.  This allows nested lock
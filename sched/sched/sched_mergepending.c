@@ -106,11 +106,15 @@ bool nxsched_merge_pending(void)
            * order.
            */
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+          rtcb = nxsched_prioritymap_position(ptcb);
+#else
           for (;
                (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
                rtcb = rtcb->flink)
             {
             }
+#endif
 
           /* Add the ptcb to the spot found in the list.  Check if the
            * ptcb goes at the ends of the ready-to-run list. This would be
@@ -148,6 +152,10 @@ bool nxsched_merge_pending(void)
               ptcb->task_state  = TSTATE_TASK_READYTORUN;
             }
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+          nxsched_prioritymap_add(ptcb);
+#endif
+
           /* Set up for the next time through */
 
           rtcb = ptcb;
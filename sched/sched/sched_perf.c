@@ -29,8 +29,11 @@
 #include <fcntl.h>
 #include <stdbool.h>
 #include <poll.h>
+#include <sys/param.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/atomic.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/perf.h>
@@ -167,8 +170,54 @@ static struct pmu_s g_perf_swevent =
 static void perf_sample_data_init(FAR struct perf_sample_data_s *data,
                                   uint64_t period)
 {
-  data->sample_flags = PERF_SAMPLE_PERIOD;
+  data->sample_flags = 0;
   data->period = period;
+  data->callchain = NULL;
+}
+
+/****************************************************************************
+ * Name: perf_callchain
+ *
+ * Description:
+ *   Record the call chain of the code that was interrupted at 'ip'.  From
+ *   interrupt context the unwinder walks the interrupt stack first and
+ *   then continues on the interrupted stack starting at 'ip', so the
+ *   frames in front of 'ip' belong to the sampling path itself and are
+ *   dropped.  If 'ip' is not found only the sampled address is recorded.
+ *
+ ****************************************************************************/
+
+static void perf_callchain(FAR struct perf_callchain_entry *entry,
+                           uintptr_t ip)
+{
+#ifdef CONFIG_ARCH_HAVE_BACKTRACE
+  FAR void *frames[2 * PERF_MAX_STACK_DEPTH];
+  int start;
+  int n;
+
+  n = up_backtrace(NULL, frames, nitems(frames), 0);
+  for (start = 0; start < n; start++)
+    {
+      if ((uintptr_t)frames[start] == ip)
+        {
+          break;
+        }
+    }
+
+  entry->nr = 0;
+  while (start < n && entry->nr < PERF_MAX_STACK_DEPTH)
+    {
+      entry->ip[entry->nr++] = (uintptr_t)frames[start++];
+    }
+
+  if (entry->nr > 0)
+    {
+      return;
+    }
+#endif
+
+  entry->ip[0] = ip;
+  entry->nr = 1;
 }
 
 static uint16_t perf_prepare_sample(FAR struct perf_sample_data_s *data,
@@ -220,6 +269,37 @@ static uint16_t perf_prepare_sample(FAR struct perf_sample_data_s *data,
       size += sizeof(data->tid_entry);
     }
 
+  if (sample_type & PERF_SAMPLE_TIME)
+    {
+      struct timespec ts;
+
+      clock_systime_timespec(&ts);
+      data->time = clock_time2nsec(&ts);
+      data->sample_flags |= PERF_SAMPLE_TIME;
+      size += sizeof(data->time);
+    }
+
+  if (sample_type & PERF_SAMPLE_CPU)
+    {
+      data->cpu_entry.cpu = this_cpu();
+      data->cpu_entry.reserved = 0;
+      data->sample_flags |= PERF_SAMPLE_CPU;
+      size += sizeof(data->cpu_entry);
+    }
+
+  if (sample_type & PERF_SAMPLE_PERIOD)
+    {
+      data->sample_flags |= PERF_SAMPLE_PERIOD;
+      size += sizeof(data->period);
+    }
+
+  if ((sample_type & PERF_SAMPLE_CALLCHAIN) && data->callchain)
+    {
+      data->sample_flags |= PERF_SAMPLE_CALLCHAIN;
+      size += sizeof(data->callchain->nr) +
+              data->callchain->nr * sizeof(data->callchain->ip[0]);
+    }
+
   return size;
 }
 
@@ -243,16 +323,52 @@ static void perf_output_sample(FAR struct perf_event_header_s *header,
                         sizeof(data->tid_entry));
     }
 
+  if (sample_type & PERF_SAMPLE_TIME)
+    {
+      circbuf_overwrite(&(event->buf->rb), &data->time, sizeof(data->time));
+    }
+
   if (sample_type & PERF_SAMPLE_ID)
     {
       circbuf_overwrite(&(event->buf->rb), &data->id, sizeof(data->id));
     }
+
+  if (sample_type & PERF_SAMPLE_CPU)
+    {
+      circbuf_overwrite(&(event->buf->rb), &data->cpu_entry,
+                        sizeof(data->cpu_entry));
+    }
+
+  if (sample_type & PERF_SAMPLE_PERIOD)
+    {
+      circbuf_overwrite(&(event->buf->rb), &data->period,
+                        sizeof(data->period));
+    }
+
+  if (sample_type & PERF_SAMPLE_CALLCHAIN)
+    {
+      circbuf_overwrite(&(event->buf->rb), data->callchain,
+                        sizeof(data->callchain->nr) + data->callchain->nr *
+                        sizeof(data->callchain->ip[0]));
+    }
 }
 
-static int perf_event_data_overflow(FAR struct perf_event_s *event,
-                                    FAR struct perf_sample_data_s *data,
-                                    uintptr_t ip)
+/****************************************************************************
+ * Name: perf_event_output
+ *
+ * Description:
+ *   Append a PERF_RECORD_SAMPLE to the event's ring buffer, laid out as
+ *   in the Linux perf_event ABI so that the records can be written into a
+ *   perf.data file unchanged.  The oldest records are dropped when the
+ *   buffer is full.  Must be called with the buffer lock held.
+ *
+ ****************************************************************************/
+
+static int perf_event_output(FAR struct perf_event_s *event,
+                             FAR struct perf_sample_data_s *data,
+                             uintptr_t ip)
 {
+  struct perf_callchain_entry callchain;
   struct perf_event_header_s header;
   size_t space;
 
@@ -261,10 +377,16 @@ static int perf_event_data_overflow(FAR struct perf_event_s *event,
       return -ENOMEM;
     }
 
+  if (event->attr.sample_type & PERF_SAMPLE_CALLCHAIN)
+    {
+      perf_callchain(&callchain, ip);
+      data->callchain = &callchain;
+    }
+
   space = circbuf_space(&(event->buf->rb));
-  event->count++;
   header.size = perf_prepare_sample(data, event, ip);
   header.type = PERF_RECORD_SAMPLE;
+  header.misc = 0;
 
   if (space < circbuf_size(&(event->buf->rb)) / 5 && event->pfd)
     {
@@ -286,6 +408,19 @@ static int perf_event_data_overflow(FAR struct perf_event_s *event,
   return 0;
 }
 
+static int perf_event_data_overflow(FAR struct perf_event_s *event,
+                                    FAR struct perf_sample_data_s *data,
+                                    uintptr_t ip)
+{
+  if (!event->buf)
+    {
+      return -ENOMEM;
+    }
+
+  event->count++;
+  return perf_event_output(event, data, ip);
+}
+
 static int perf_buffer_set_output(FAR struct perf_event_s *event,
                                   FAR struct perf_event_s *output)
 {
@@ -2473,6 +2608,20 @@ static int perf_swevent_match(FAR struct perf_event_s *event)
 
 int perf_event_overflow(FAR struct perf_event_s *event)
 {
+  struct perf_sample_data_s data;
+  irqstate_t flags;
+
+  if (!is_sampling_event(event) || !event->buf)
+    {
+      return 0;
+    }
+
+  perf_sample_data_init(&data, event->attr.sample_period);
+
+  flags = spin_lock_irqsave(&event->buf->lock);
+  perf_event_output(event, &data, up_getusrpc(NULL));
+  spin_unlock_irqrestore(&event->buf->lock, flags);
+
   return 0;
 }
 
@@ -0,0 +1,245 @@
+/****************************************************************************
+ * sched/sched/sched_prioritymap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: prioritymap_above
+ *
+ * Description:
+ *   Return the lowest priority above 'priority' that is present in the
+ *   ready-to-run list.
+ *
+ * Input Parameters:
+ *   priority - The priority to start the search from
+ *
+ * Returned Value:
+ *   The priority found or -1 if there is no higher priority task.
+ *
+ ****************************************************************************/
+
+static int prioritymap_above(int priority)
+{
+  uint32_t bits;
+  int word;
+
+  priority++;
+  if (priority > SCHED_PRIORITY_MAX)
+    {
+      return -1;
+    }
+
+  word = priority >> 5;
+  bits = g_readytorun_map[word] & (UINT32_MAX << (priority & 31));
+
+  while (bits == 0)
+    {
+      if (++word >= SCHED_PRIORITY_WORDS)
+        {
+          return -1;
+        }
+
+      bits = g_readytorun_map[word];
+    }
+
+  return (word << 5) + ffs((int)bits) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_prioritymap_position
+ *
+ * Description:
+ *   Find the position of a TCB that is about to be added to the
+ *   ready-to-run list:  After all tasks of higher or equal priority (or,
+ *   for deadline threads, after those with an earlier deadline).
+ *
+ * Input Parameters:
+ *   tcb - The TCB to be added
+ *
+ * Returned Value:
+ *   The TCB that 'tcb' must be inserted before or NULL if 'tcb' goes at the
+ *   end of the list.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_prioritymap_position(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *next;
+  int priority = tcb->sched_priority;
+  int above;
+
+  /* The level of 'priority' starts just after the last TCB of the nearest
+   * higher priority level.
+   */
+
+  above = prioritymap_above(priority);
+  if (above < 0)
+    {
+      next = (FAR struct tcb_s *)list_readytorun()->head;
+    }
+  else
+    {
+      next = g_readytorun_tail[above]->flink;
+    }
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Deadline threads are ordered within their level */
+
+  if (nxsched_is_deadline(tcb))
+    {
+      while (next != NULL && !nxsched_before(tcb, next))
+        {
+          next = next->flink;
+        }
+
+      return next;
+    }
+#endif
+
+  /* Otherwise the TCB goes after all TCBs of the same priority */
+
+  if (g_readytorun_tail[priority] != NULL)
+    {
+      next = g_readytorun_tail[priority]->flink;
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: nxsched_prioritymap_add
+ *
+ * Description:
+ *   Update the index after 'tcb' was inserted into the ready-to-run list.
+ *
+ * Input Parameters:
+ *   tcb - The TCB that was added
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_prioritymap_add(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *next = tcb->flink;
+  int priority = tcb->sched_priority;
+
+  /* 'tcb' is the new last TCB of its level unless it was inserted in the
+   * middle of the level.
+   */
+
+  if (next == NULL || next->sched_priority != priority)
+    {
+      g_readytorun_tail[priority] = tcb;
+      g_readytorun_map[priority >> 5] |= UINT32_C(1) << (priority & 31);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_prioritymap_remove
+ *
+ * Description:
+ *   Update the index before 'tcb' is removed from the ready-to-run list.
+ *
+ * Input Parameters:
+ *   tcb - The TCB that is about to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_prioritymap_remove(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev;
+  int priority = tcb->sched_priority;
+
+  if (g_readytorun_tail[priority] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          g_readytorun_tail[priority] = prev;
+        }
+      else
+        {
+          /* That was the only TCB of this priority */
+
+          g_readytorun_tail[priority] = NULL;
+          g_readytorun_map[priority >> 5] &=
+            ~(UINT32_C(1) << (priority & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_prioritymap_setpriority
+ *
+ * Description:
+ *   Change the priority of the running task (the head of the ready-to-run
+ *   list) in place, when the list order is not affected by the change.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB of the running task
+ *   priority - The new priority
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_prioritymap_setpriority(FAR struct tcb_s *tcb, int priority)
+{
+  DEBUGASSERT(tcb == this_task());
+
+  nxsched_prioritymap_remove(tcb);
+  tcb->sched_priority = (uint8_t)priority;
+  nxsched_prioritymap_add(tcb);
+}
+
+#endif /* CONFIG_SCHED_PRIORITY_BITMAP */
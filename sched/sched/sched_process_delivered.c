@@ -125,6 +125,17 @@ void nxsched_process_delivered(int cpu)
       DEBUGASSERT(btcb->flink != NULL);
       DEBUGASSERT(next == btcb->flink);
       next->task_state = TSTATE_TASK_ASSIGNED;
+
+#ifdef CONFIG_SCHED_LOADBALANCE
+      /* The preempted task now waits on this CPU, perhaps while another
+       * CPU is idle.
+       */
+
+      if (!is_idle_task(next))
+        {
+          nxsched_loadbalance_kick();
+        }
+#endif
     }
   else
     {
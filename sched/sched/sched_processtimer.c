@@ -64,7 +64,8 @@
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void nxsched_cpu_scheduler(int cpu)
 {
   FAR struct tcb_s *rtcb = current_task(cpu);
@@ -94,6 +95,17 @@ static inline void nxsched_cpu_scheduler(int cpu)
       nxsched_process_sporadic(rtcb, 1, false);
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge it and check if it has exhausted its budget. */
+
+      nxsched_process_deadline(rtcb, 1, false);
+    }
+#endif
 }
 #endif
 
@@ -112,7 +124,8 @@ static inline void nxsched_cpu_scheduler(int cpu)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void nxsched_process_scheduler(void)
 {
   irqstate_t flags;
@@ -186,6 +199,10 @@ void nxsched_process_timer(void)
 
   clock_timer();
 
+  /* Refresh the clock data page read by user space */
+
+  clock_vdso_update();
+
   /* Check if the currently executing task has exceeded its
    * timeslice.
    */
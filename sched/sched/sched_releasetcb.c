@@ -36,7 +36,6 @@
 #include "task/task.h"
 #include "sched/sched.h"
 #include "group/group.h"
-#include "timer/timer.h"
 
 /****************************************************************************
  * Private Functions
@@ -111,16 +110,6 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       DEBUGASSERT(tcb->flink == NULL && tcb->blink == NULL);
 
-#ifndef CONFIG_DISABLE_POSIX_TIMERS
-      /* Release any timers that the task might hold.  We do this
-       * before release the PID because it may still be trying to
-       * deliver signals (although interrupts are should be
-       * disabled here).
-       */
-
-      timer_deleteall(tcb->pid);
-#endif
-
       /* Release the task's process ID if one was assigned.  PID
        * zero is reserved for the IDLE task.  The TCB of the IDLE
        * task is never release so a value of zero simply means that
@@ -200,7 +189,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->flags & TCB_FLAG_FREE_TCB)
         {
-          kmm_free(tcb);
+          nxsched_free_tcb(tcb);
         }
     }
 
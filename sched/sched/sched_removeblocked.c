@@ -74,6 +74,15 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb)
 
   btcb->waitobj = NULL;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread that wakes up may need a new deadline and budget */
+
+  if (nxsched_is_deadline(btcb))
+    {
+      nxsched_wakeup_deadline(btcb);
+    }
+#endif
+
   /* Make sure the TCB's state corresponds to not being in
    * any list
    */
@@ -93,6 +93,13 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+  if (tasklist == list_readytorun())
+    {
+      nxsched_prioritymap_remove(rtcb);
+    }
+#endif
+
   dq_rem((FAR dq_entry_t *)rtcb, tasklist);
 
   /* Since the TCB is not in any list, it is now invalid */
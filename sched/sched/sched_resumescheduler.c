@@ -27,7 +27,10 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <debug.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
@@ -36,11 +39,89 @@
 #  include <nuttx/perf.h>
 #endif
 
+#ifdef CONFIG_CPUFREQ_DEFAULT_GOV_SCHEDUTIL
+#  include <nuttx/cpufreq.h>
+#endif
+
 #include "irq/irq.h"
+#include "rcu/rcu.h"
 #include "sched/sched.h"
 
 #if defined(CONFIG_SCHED_RESUMESCHEDULER)
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_GUARD_WATCH
+/* The guard area currently watched on each CPU */
+
+static FAR void *g_stack_guard[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_GUARD_WATCH
+
+/****************************************************************************
+ * Name: nxsched_stack_overflow
+ *
+ * Description:
+ *   Watchpoint callback, the running thread wrote into its stack guard.
+ *
+ ****************************************************************************/
+
+static void nxsched_stack_overflow(int type, FAR void *addr, size_t size,
+                                   FAR void *arg)
+{
+  FAR struct tcb_s *tcb = arg;
+
+  _alert("Stack overflow: pid %d wrote %p, stack %p size %zu\n",
+         tcb->pid, addr, tcb->stack_base_ptr, tcb->adj_stack_size);
+  PANIC();
+}
+
+/****************************************************************************
+ * Name: nxsched_watch_stack
+ *
+ * Description:
+ *   Move this CPU's write watchpoint to the guard area at the lowest end of
+ *   the stack of the thread being resumed.  The area is aligned to its
+ *   size as required by the debug hardware.
+ *
+ ****************************************************************************/
+
+static void nxsched_watch_stack(FAR struct tcb_s *tcb)
+{
+  int cpu = this_cpu();
+  uintptr_t guard;
+
+  if (g_stack_guard[cpu] != NULL)
+    {
+      up_debugpoint_remove(DEBUGPOINT_WATCHPOINT_WO, g_stack_guard[cpu],
+                           CONFIG_STACK_GUARD_WATCH_SIZE);
+      g_stack_guard[cpu] = NULL;
+    }
+
+  if (tcb->stack_base_ptr == NULL ||
+      tcb->adj_stack_size < 4 * CONFIG_STACK_GUARD_WATCH_SIZE)
+    {
+      return;
+    }
+
+  guard = ALIGN_UP((uintptr_t)tcb->stack_base_ptr,
+                   CONFIG_STACK_GUARD_WATCH_SIZE);
+  if (up_debugpoint_add(DEBUGPOINT_WATCHPOINT_WO, (FAR void *)guard,
+                        CONFIG_STACK_GUARD_WATCH_SIZE,
+                        nxsched_stack_overflow, tcb) == 0)
+    {
+      g_stack_guard[cpu] = (FAR void *)guard;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -74,6 +155,12 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
 
   /* Indicate the task has been resumed */
 
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_resume_cputime(tcb);
+#endif
+#ifdef CONFIG_SCHED_LATENCY
+  nxsched_resume_latency(tcb);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
@@ -84,6 +171,32 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_PERF_EVENTS
   perf_event_task_sched_in(tcb);
 #endif
+
+#ifdef CONFIG_STACK_GUARD_WATCH
+  nxsched_watch_stack(tcb);
+#endif
+
+#ifdef CONFIG_CPUFREQ_DEFAULT_GOV_SCHEDUTIL
+  /* Feed the CPU utilization to the frequency governor */
+
+  if (is_idle_task(tcb))
+    {
+      cpufreq_update_util(this_cpu(), CPUFREQ_UTIL_IDLE);
+    }
+  else if ((tcb->flags & TCB_FLAG_TTYPE_MASK) != TCB_FLAG_TTYPE_KERNEL &&
+           tcb->sched_priority >= CONFIG_CPUFREQ_SCHEDUTIL_RT_PRIORITY)
+    {
+      cpufreq_update_util(this_cpu(), CPUFREQ_UTIL_RT);
+    }
+  else
+    {
+      cpufreq_update_util(this_cpu(), 0);
+    }
+#endif
+
+  /* A context switch is a quiescent state for RCU readers on this CPU */
+
+  rcu_note_context_switch(tcb->cpu);
 }
 
 #endif /* CONFIG_SCHED_RESUMESCHEDULER */
@@ -71,6 +71,7 @@
  *
  *   EINVAL The parameter 'param' is invalid or does not make sense for the
  *          current scheduling policy.
+ *   EBUSY  SCHED_DEADLINE admission control refused the new parameters.
  *   EPERM  The calling task does not have appropriate privileges.
  *   ESRCH  The task whose ID is pid could not be found.
  *
@@ -205,6 +206,28 @@ int nxsched_set_param(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  Deadline threads
+   * always run at the deadline priority.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      ret = nxsched_set_deadline(tcb, param);
+      leave_critical_section(flags);
+
+      if (ret >= 0)
+        {
+          ret = nxsched_reprioritize(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+        }
+
+      goto errout_with_lock;
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = nxsched_reprioritize(tcb, param->sched_priority);
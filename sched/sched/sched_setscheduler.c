@@ -74,6 +74,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control refused the thread.
  *
  ****************************************************************************/
 
@@ -82,6 +83,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+  int priority = param->sched_priority;
   int ret;
 
   /* Check for supported scheduling policy */
@@ -93,16 +95,29 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* All deadline threads run at the same priority; the priority in 'param'
+   * is ignored.
+   */
+
+  if (policy == SCHED_DEADLINE)
+    {
+      priority = CONFIG_SCHED_DEADLINE_PRIORITY;
+    }
+#endif
+
   /* Verify that the requested priority is in the valid range */
 
-  if (param->sched_priority < SCHED_PRIORITY_MIN ||
-      param->sched_priority > SCHED_PRIORITY_MAX)
+  if (priority < SCHED_PRIORITY_MIN || priority > SCHED_PRIORITY_MAX)
     {
       return -EINVAL;
     }
@@ -131,6 +146,26 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Admit the thread with its new deadline parameters or release the
+   * bandwidth of any on-going deadline scheduling.
+   */
+
+  if (policy == SCHED_DEADLINE)
+    {
+      ret = nxsched_set_deadline(tcb, param);
+      if (ret < 0)
+        {
+          goto errout_with_irq;
+        }
+    }
+  else if (tcb->deadline != NULL)
+    {
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -266,17 +301,39 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         }
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+#ifdef CONFIG_SCHED_SPORADIC
+          /* Cancel any on-going sporadic scheduling */
+
+          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+            {
+              DEBUGVERIFY(nxsched_stop_sporadic(tcb));
+            }
+#endif
+
+          /* The deadline parameters were saved above */
+
+          tcb->flags     |= TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+          tcb->timeslice  = 0;
+#endif
+        }
+        break;
+#endif
     }
 
   leave_critical_section(flags);
 
   /* Set the new priority */
 
-  ret = nxsched_reprioritize(tcb, param->sched_priority);
+  ret = nxsched_reprioritize(tcb, priority);
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
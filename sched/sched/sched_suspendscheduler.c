@@ -82,6 +82,9 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_suspend_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_suspend_cputime(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(tcb);
 #endif
@@ -0,0 +1,128 @@
+/****************************************************************************
+ * sched/sched/sched_tcbcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <sys/param.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/kmem_cache.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TCB_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Every kind of TCB must fit into an object of the cache */
+
+#define TCB_CACHE_SIZE MAX(sizeof(struct task_tcb_s), \
+                           sizeof(struct pthread_tcb_s))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct kmem_cache_s *g_tcb_cache;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_tcbcache_initialize
+ *
+ * Description:
+ *   Create the TCB object cache.  Called once from nx_start() before the
+ *   first task is created.  If the cache cannot be created the TCBs are
+ *   allocated from the kernel heap.
+ *
+ ****************************************************************************/
+
+void nxsched_tcbcache_initialize(void)
+{
+  g_tcb_cache = kmem_cache_create("tcb", TCB_CACHE_SIZE, 0, NULL, NULL);
+  if (g_tcb_cache == NULL)
+    {
+      serr("ERROR: Failed to create the TCB cache\n");
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate the zeroed memory of a TCB.
+ *
+ * Input Parameters:
+ *   size - The size of the TCB
+ *
+ * Returned Value:
+ *   The TCB on success; NULL if there is not enough memory.
+ *
+ ****************************************************************************/
+
+FAR void *nxsched_alloc_tcb(size_t size)
+{
+  DEBUGASSERT(size <= TCB_CACHE_SIZE);
+
+  if (g_tcb_cache == NULL)
+    {
+      return kmm_zalloc(size);
+    }
+
+  return kmem_cache_zalloc(g_tcb_cache);
+}
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Release the memory of a TCB allocated by nxsched_alloc_tcb().
+ *
+ * Input Parameters:
+ *   tcb - The TCB to release
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR void *tcb)
+{
+  if (g_tcb_cache == NULL)
+    {
+      kmm_free(tcb);
+    }
+  else
+    {
+      kmem_cache_free(g_tcb_cache, tcb);
+    }
+}
+
+#endif /* CONFIG_SCHED_TCB_CACHE */
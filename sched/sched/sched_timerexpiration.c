@@ -45,6 +45,10 @@
 #  include "clock/clock_timekeeping.h"
 #endif
 
+#ifdef CONFIG_HRTIMER
+#  include "hrtimer/hrtimer.h"
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
 
 /****************************************************************************
@@ -72,11 +76,13 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * Private Function Prototypes
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
                                      clock_t elapsed, bool noswitches);
 #endif
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static clock_t nxsched_process_scheduler(clock_t ticks, clock_t elapsed,
                                          bool noswitches);
 #endif
@@ -178,7 +184,8 @@ int up_timer_tick_cancel(FAR clock_t *ticks)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
                                      clock_t elapsed, bool noswitches)
 {
@@ -225,6 +232,17 @@ static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge it and check if it has exhausted its budget. */
+
+      ret = nxsched_process_deadline(rtcb, elapsed, noswitches);
+    }
+#endif
+
   /* If a context switch occurred, then need to return delay remaining for
    * the new task at the head of the ready to run list.
    */
@@ -271,7 +289,8 @@ static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static clock_t nxsched_process_scheduler(clock_t ticks, clock_t elapsed,
                                          bool noswitches)
 {
@@ -339,6 +358,10 @@ static clock_t nxsched_timer_process(clock_t ticks, clock_t elapsed,
   clock_update_wall_time();
 #endif
 
+  /* Refresh the clock data page read by user space */
+
+  clock_vdso_update();
+
   /* Check for operations specific to scheduling policy of the currently
    * active task.
    */
@@ -360,6 +383,55 @@ static clock_t nxsched_timer_process(clock_t ticks, clock_t elapsed,
   return rettime;
 }
 
+/****************************************************************************
+ * Name:  nxsched_alarm_start
+ *
+ * Description:
+ *   Program the alarm for the earlier of the next tick event and the
+ *   earliest high resolution timer.
+ *
+ * Input Parameters:
+ *   ticks - The current time in ticks.
+ *   interval - The number of ticks until the next tick event, zero if
+ *     there is none.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int nxsched_alarm_start(clock_t ticks, clock_t interval)
+{
+  struct timespec ts;
+  uint64_t expired;
+  uint64_t tickexp;
+  bool active;
+
+  active = hrtimer_next_expired(&expired);
+
+  if (interval > 0)
+    {
+      clock_ticks2time(&ts, ticks + interval);
+      tickexp = clock_time2nsec(&ts);
+
+      if (!active || tickexp < expired)
+        {
+          expired = tickexp;
+          active  = true;
+        }
+    }
+
+  if (!active)
+    {
+      return OK;
+    }
+
+  clock_nsec2time(&ts, expired);
+  return up_alarm_start(&ts);
+}
+#endif
+
 /****************************************************************************
  * Name:  nxsched_timer_start
  *
@@ -379,6 +451,25 @@ static clock_t nxsched_timer_start(clock_t ticks, clock_t interval)
 {
   int ret;
 
+#ifdef CONFIG_HRTIMER
+  /* The alarm is shared with the high resolution timers, so it may need
+   * to be started even if there is no tick event to wait for.
+   */
+
+#  ifdef CONFIG_SCHED_TICKLESS_LIMIT_MAX_SLEEP
+  if (interval > g_oneshot_maxticks)
+    {
+      interval = g_oneshot_maxticks;
+    }
+#  endif
+
+  ret = nxsched_alarm_start(ticks, interval);
+  if (ret < 0)
+    {
+      serr("ERROR: up_alarm_start failed: %d\n", ret);
+      UNUSED(ret);
+    }
+#else
   if (interval > 0)
     {
 #ifdef CONFIG_SCHED_TICKLESS_LIMIT_MAX_SLEEP
@@ -406,6 +497,7 @@ static clock_t nxsched_timer_start(clock_t ticks, clock_t interval)
           UNUSED(ret);
         }
     }
+#endif
 
   return interval;
 }
@@ -441,6 +533,14 @@ void nxsched_alarm_tick_expiration(clock_t ticks)
   clock_t nexttime;
   irqstate_t flags;
 
+#ifdef CONFIG_HRTIMER
+  /* The alarm may have been programmed for a high resolution timer that
+   * expires between two ticks.  Run those first.
+   */
+
+  hrtimer_process(hrtimer_now());
+#endif
+
   /* Save the time that the alarm occurred */
 
   flags = enter_critical_section();
@@ -72,13 +72,29 @@ int sched_unlock(void)
 
   if (rtcb != NULL && !up_interrupt_context())
     {
-      /* Prevent context switches throughout the following. */
-
-      irqstate_t flags = enter_critical_section();
-      int cpu = this_cpu();
+      irqstate_t flags;
+      int cpu;
 
       DEBUGASSERT(rtcb->lockcount > 0);
 
+      /* A nested unlock leaves pre-emption disabled and only changes the
+       * lockcount of this TCB, so the global critical section is not
+       * needed.
+       */
+
+      if (rtcb->lockcount > 1)
+        {
+          flags = enter_critical_section_local();
+          rtcb->lockcount--;
+          leave_critical_section_local(flags);
+          return OK;
+        }
+
+      /* Prevent context switches throughout the following. */
+
+      flags = enter_critical_section();
+      cpu = this_cpu();
+
       /* Decrement the preemption lock counter */
 
       rtcb->lockcount--;
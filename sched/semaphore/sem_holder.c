@@ -49,10 +49,22 @@
 typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
                                FAR sem_t *sem, FAR void *arg);
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Deepest priority inheritance chain that has been boosted */
+
+uint8_t g_sem_prioinherit_maxdepth;
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+/* Current depth of the priority inheritance chain being boosted */
+
+static uint8_t g_boostdepth;
+
 /* Preallocated holder structures */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
@@ -75,8 +87,15 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder != NULL)
+  if (sem->holder.htcb == NULL)
+    {
+      /* Use the slot embedded in the semaphore */
+
+      pholder        = &sem->holder;
+      pholder->flink = sem->hhead;
+      sem->hhead     = pholder;
+    }
+  else if ((pholder = g_freeholders) != NULL)
     {
       /* Remove the holder from the free list and
        * put it into the semaphore's holder list
@@ -105,6 +124,12 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
   /* Put it into the task's list */
 
   pholder->tlink  = htcb->holdsem;
+  pholder->tprev  = NULL;
+  if (pholder->tlink != NULL)
+    {
+      pholder->tlink->tprev = pholder;
+    }
+
   htcb->holdsem   = pholder;
 
   return pholder;
@@ -125,6 +150,15 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
   FAR struct semholder_s *pholder;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+  /* Check the embedded holder first.  This is the only holder of a
+   * mutex.
+   */
+
+  if (sem->holder.htcb == htcb)
+    {
+      return &sem->holder;
+    }
+
   /* Try to find the holder in the list of holders associated with this
    * semaphore
    */
@@ -179,24 +213,30 @@ nxsem_findorallocateholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 static inline void nxsem_freeholder(FAR sem_t *sem,
                                     FAR struct semholder_s *pholder)
 {
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s * FAR *curr;
+#endif
 
   /* Remove the holder from the task's list */
 
-  for (curr = &pholder->htcb->holdsem;
-       *curr != NULL;
-       curr = &(*curr)->tlink)
+  if (pholder->tprev != NULL)
     {
-      if (*curr == pholder)
-        {
-          *curr = pholder->tlink;
-          break;
-        }
+      pholder->tprev->tlink = pholder->tlink;
+    }
+  else
+    {
+      pholder->htcb->holdsem = pholder->tlink;
+    }
+
+  if (pholder->tlink != NULL)
+    {
+      pholder->tlink->tprev = pholder->tprev;
     }
 
   /* Release the holder and counts */
 
   pholder->tlink  = NULL;
+  pholder->tprev  = NULL;
   pholder->sem    = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
@@ -215,10 +255,17 @@ static inline void nxsem_freeholder(FAR sem_t *sem,
         }
     }
 
-  /* And put it in the free list */
+  /* And put it in the free list unless it is embedded in the semaphore */
 
-  pholder->flink = g_freeholders;
-  g_freeholders  = pholder;
+  if (pholder != &sem->holder)
+    {
+      pholder->flink = g_freeholders;
+      g_freeholders  = pholder;
+    }
+  else
+    {
+      pholder->flink = NULL;
+    }
 #endif
 }
 
@@ -322,6 +369,32 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
        */
 
       nxsched_set_priority(htcb, rtcb->sched_priority);
+
+      if (++g_boostdepth > g_sem_prioinherit_maxdepth)
+        {
+          g_sem_prioinherit_maxdepth = g_boostdepth;
+        }
+
+      /* If the holder is itself waiting for another semaphore with
+       * priority inheritance, propagate the boost along the ownership
+       * chain.  A cycle terminates because a holder that has already been
+       * boosted is not boosted again.  The transitive boost is undone when
+       * the holder releases the semaphore or the waiter gives up.
+       */
+
+      if (htcb->task_state == TSTATE_WAIT_SEM &&
+          g_boostdepth < CONFIG_SEM_PRIOINHERIT_DEPTH)
+        {
+          FAR sem_t *wsem = htcb->waitobj;
+
+          if (wsem != NULL &&
+              (wsem->flags & SEM_PRIO_MASK) == SEM_PRIO_INHERIT)
+            {
+              nxsem_foreachholder(wsem, nxsem_boostholderprio, rtcb);
+            }
+        }
+
+      g_boostdepth--;
     }
 
   return 0;
@@ -737,19 +810,16 @@ void nxsem_release_holder(FAR sem_t *sem)
       /* Find the container for this holder */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-      for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+      pholder = nxsem_findholder(sem, rtcb);
+      if (pholder != NULL)
         {
           DEBUGASSERT(pholder->counts > 0);
 
-          if (pholder->htcb == rtcb)
-            {
-              /* Decrement the counts on this holder -- the holder will be
-               * freed later in nxsem_restore_baseprio.
-               */
+          /* Decrement the counts on this holder -- the holder will be
+           * freed later in nxsem_restore_baseprio.
+           */
 
-              pholder->counts--;
-              return;
-            }
+          pholder->counts--;
         }
 #else
       pholder = &sem->holder;
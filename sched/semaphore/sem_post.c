@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+
 #include <limits.h>
 #include <errno.h>
 #include <sched.h>
@@ -271,3 +273,122 @@ int nxsem_post(FAR sem_t *sem)
 
   return nxsem_post_slow(sem);
 }
+
+/****************************************************************************
+ * Name: nxsem_post_many
+ *
+ * Description:
+ *   Perform the semaphore unlock operation 'count' times.  This is
+ *   equivalent to calling nxsem_post() 'count' times but all of the
+ *   unblocked tasks are taken from the wait list in one critical section
+ *   with pre-emption disabled.  They collect in the pending task list and
+ *   are merged into the ready-to-run lists in a single pass when the
+ *   scheduler is unlocked, so each CPU is switched (and, in SMP, each
+ *   other CPU is interrupted) at most once.
+ *
+ *   Semaphores with priority inheritance or priority protection fall back
+ *   to nxsem_post(), since each post may change the priority of the
+ *   holders.
+ *
+ * Input Parameters:
+ *   sem   - Semaphore descriptor
+ *   count - The number of times to post the semaphore
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int nxsem_post_many(FAR sem_t *sem, int count)
+{
+  FAR struct tcb_s *stcb;
+  irqstate_t flags;
+  int16_t sem_count;
+  int nwake;
+  int ret = OK;
+
+  DEBUGASSERT(sem != NULL && count >= 0);
+
+  if (count <= 1)
+    {
+      return count > 0 ? nxsem_post(sem) : OK;
+    }
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_PRIORITY_PROTECT)
+  if ((sem->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
+    {
+      while (count-- > 0 && ret >= 0)
+        {
+          ret = nxsem_post(sem);
+        }
+
+      return ret;
+    }
+#endif
+
+  flags = enter_critical_section();
+
+  /* Check the maximum allowable value once for the whole batch */
+
+  sem_count = atomic_load(NXSEM_COUNT(sem));
+  if (sem_count > SEM_VALUE_MAX - count)
+    {
+      leave_critical_section(flags);
+      return -EOVERFLOW;
+    }
+
+  atomic_fetch_add(NXSEM_COUNT(sem), count);
+
+  /* Only the tasks accounted for by a negative count are waiting */
+
+  nwake = sem_count < 0 ? MIN(-sem_count, count) : 0;
+  if (nwake > 0)
+    {
+      /* With the scheduler locked the unblocked tasks only go to the
+       * pending task list.
+       */
+
+      sched_lock();
+
+      while (nwake-- > 0)
+        {
+          FAR struct tcb_s *rtcb = this_task();
+
+          stcb = (FAR struct tcb_s *)dq_remfirst(SEM_WAITLIST(sem));
+          if (stcb == NULL)
+            {
+              break;
+            }
+
+          nxsem_add_holder_tcb(stcb, sem);
+
+          if (WDOG_ISACTIVE(&stcb->waitdog))
+            {
+              wd_cancel(&stcb->waitdog);
+            }
+
+          stcb->waitobj = NULL;
+
+          /* No context switch can be needed here except when called from
+           * an interrupt handler, where sched_lock() has no effect.
+           */
+
+          if (nxsched_add_readytorun(stcb))
+            {
+              up_switch_context(stcb, rtcb);
+            }
+        }
+
+      /* Now release all of the unblocked tasks at once */
+
+      sched_unlock();
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
@@ -378,6 +378,9 @@ int nxsig_action(int signo, FAR const struct sigaction *act,
           /* Yes.. Remove it from signal action queue */
 
           sq_rem((FAR sq_entry_t *)sigact, &group->tg_sigactionq);
+#ifdef CONFIG_SIG_ACTION_TABLE
+          group->tg_sigaction[signo] = NULL;
+#endif
 
           /* And deallocate it */
 
@@ -421,6 +424,14 @@ int nxsig_action(int signo, FAR const struct sigaction *act,
       sigact->act.sa_mask    = act->sa_mask;
       sigact->act.sa_flags   = act->sa_flags;
       sigact->act.sa_user    = act->sa_user;
+
+#ifdef CONFIG_SIG_ACTION_TABLE
+      /* Publish it only once it is complete, dispatch may run from an
+       * interrupt handler.
+       */
+
+      group->tg_sigaction[signo] = sigact;
+#endif
     }
 
   return OK;
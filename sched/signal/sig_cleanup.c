@@ -25,6 +25,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <string.h>
+
 #include <nuttx/arch.h>
 
 #include "signal/signal.h"
@@ -54,6 +57,8 @@ void nxsig_cleanup(FAR struct tcb_s *stcb)
       nxsig_release_pendingsigaction(sigq);
     }
 
+  sigemptyset(&stcb->sigpendactionset);
+
   /* Deallocate all entries in the list of posted signal actions */
 
   while ((sigq = (FAR sigq_t *)sq_remfirst(&stcb->sigpostedq)) != NULL)
@@ -91,6 +96,10 @@ void nxsig_release(FAR struct task_group_s *group)
       nxsig_release_action(sigact);
     }
 
+#ifdef CONFIG_SIG_ACTION_TABLE
+  memset(group->tg_sigaction, 0, sizeof(group->tg_sigaction));
+#endif
+
   /* Deallocate all entries in the list of pending signals */
 
   while ((sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendingq))
@@ -98,4 +107,6 @@ void nxsig_release(FAR struct task_group_s *group)
     {
       nxsig_release_pendingsignal(sigpend);
     }
+
+  sigemptyset(&group->tg_sigpendset);
 }
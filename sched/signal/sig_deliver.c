@@ -97,6 +97,10 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
           break;
         }
 
+      /* From now on a new instance of the signal needs its own action */
+
+      nxsig_delset(&stcb->sigpendactionset, sigq->info.si_signo);
+
       /* Indicate that a signal is being delivered */
 
       stcb->flags |= TCB_FLAG_SIGNAL_ACTION;
@@ -127,6 +127,23 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
+      /* Standard signals are not queued: if the action of this one is
+       * still waiting to be delivered, this instance merges into it and
+       * needs no new queue element.
+       */
+
+      if (info->si_signo < SIGRTMIN)
+        {
+          flags = enter_critical_section();
+          if (nxsig_ismember(&stcb->sigpendactionset, info->si_signo) == 1)
+            {
+              leave_critical_section(flags);
+              return OK;
+            }
+
+          leave_critical_section(flags);
+        }
+
       /* Allocate a new element for the signal queue. NOTE:
        * nxsig_alloc_pendingsigaction will force a system crash if it is
        * unable to allocate memory for the signal data.
@@ -155,6 +172,10 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
           flags = enter_critical_section();
           sq_addlast((FAR sq_entry_t *)sigq, &(stcb->sigpendactionq));
+          if (info->si_signo < SIGRTMIN)
+            {
+              nxsig_addset(&stcb->sigpendactionset, info->si_signo);
+            }
 
           /* Then schedule execution of the signal handling action on the
            * recipient's thread. SMP related handling will be done in
@@ -294,11 +315,16 @@ nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
 
   flags = enter_critical_section();
 
-  /* Search the list for a action pending on this signal */
+  /* Search the list for a action pending on this signal, unless the
+   * pending set already tells that there is none.
+   */
 
-  for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
-       (sigpend && sigpend->info.si_signo != signo);
-       sigpend = sigpend->flink);
+  if (nxsig_ismember(&group->tg_sigpendset, signo) == 1)
+    {
+      for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
+           (sigpend && sigpend->info.si_signo != signo);
+           sigpend = sigpend->flink);
+    }
 
   leave_critical_section(flags);
   return sigpend;
@@ -370,6 +396,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 
           flags = enter_critical_section();
           sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendingq);
+          nxsig_addset(&group->tg_sigpendset, info->si_signo);
           leave_critical_section(flags);
           nxsig_dispatch_kernel_action(stcb, &sigpend->info);
         }
@@ -46,12 +46,20 @@
 FAR sigactq_t *nxsig_find_action(FAR struct task_group_s *group, int signo)
 {
   FAR sigactq_t *sigact = NULL;
+#ifndef CONFIG_SIG_ACTION_TABLE
   irqstate_t flags;
+#endif
 
   /* Verify the caller's sanity */
 
   if (group)
     {
+#ifdef CONFIG_SIG_ACTION_TABLE
+      if (GOOD_SIGNO(signo))
+        {
+          sigact = group->tg_sigaction[signo];
+        }
+#else
       /* Sigactions can only be assigned to the currently executing
        * thread.  So, a simple lock ought to give us sufficient
        * protection.
@@ -66,6 +74,7 @@ FAR sigactq_t *nxsig_find_action(FAR struct task_group_s *group, int signo)
            sigact = sigact->flink);
 
       spin_unlock_irqrestore(NULL, flags);
+#endif
     }
 
   return sigact;
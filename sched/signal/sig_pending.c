@@ -73,7 +73,7 @@ int sigpending(FAR sigset_t *set)
  * Name: nxsig_pendingset
  *
  * Description:
- *   Convert the list of pending signals into a signal set
+ *   Return the set of signals pending for the group of a task
  *
  ****************************************************************************/
 
@@ -81,7 +81,6 @@ sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
 {
   FAR struct task_group_s *group;
   sigset_t sigpendset;
-  FAR sigpendq_t *sigpend;
   irqstate_t flags;
 
   if (stcb == NULL)
@@ -92,15 +91,8 @@ sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
   group = stcb->group;
   DEBUGASSERT(group);
 
-  sigemptyset(&sigpendset);
-
   flags = enter_critical_section();
-  for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
-       (sigpend); sigpend = sigpend->flink)
-    {
-      nxsig_addset(&sigpendset, sigpend->info.si_signo);
-    }
-
+  sigpendset = group->tg_sigpendset;
   leave_critical_section(flags);
 
   return sigpendset;
@@ -39,6 +39,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/queue.h>
@@ -132,6 +133,25 @@ static void nxsig_timeout(wdparm_t arg)
 #endif
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   A high resolution timeout elapsed while waiting for signals to be
+ *   queued.
+ *
+ * Assumptions:
+ *   This function executes in the context of the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void nxsig_hrtimeout(FAR void *arg)
+{
+  nxsig_timeout((wdparm_t)(uintptr_t)arg);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -256,6 +276,11 @@ int nxsig_clockwait(int clockid, int flags,
   irqstate_t iflags;
   clock_t expect = 0;
   clock_t stop;
+#ifdef CONFIG_HRTIMER
+  uint64_t hrexpect = 0;
+  uint64_t hrstop = 0;
+  bool hires = false;
+#endif
 
   if (rqtp && (rqtp->tv_nsec < 0 || rqtp->tv_nsec >= 1000000000))
     {
@@ -298,6 +323,28 @@ int nxsig_clockwait(int clockid, int flags,
 
   iflags = enter_critical_section();
 
+#ifdef CONFIG_HRTIMER
+  /* A watchdog would round the wait up to a whole tick.  Use a high
+   * resolution timer instead if the requested time is not tick aligned.
+   * Absolute CLOCK_REALTIME waits must follow changes to the realtime
+   * clock, so they always use the watchdog.
+   */
+
+  if (rqtp && rqtp->tv_nsec % NSEC_PER_TICK != 0 &&
+      ((flags & TIMER_ABSTIME) == 0 || clockid != CLOCK_REALTIME))
+    {
+      hires = true;
+      hrexpect = clock_time2nsec(rqtp);
+      if ((flags & TIMER_ABSTIME) == 0)
+        {
+          hrexpect += hrtimer_now();
+        }
+
+      hrtimer_start_absolute(&rtcb->waithrtimer, hrexpect,
+                             nxsig_hrtimeout, rtcb);
+    }
+  else
+#endif
   if (rqtp)
     {
       /* Start the watchdog timer */
@@ -335,6 +382,14 @@ int nxsig_clockwait(int clockid, int flags,
 
   /* We no longer need the watchdog */
 
+#ifdef CONFIG_HRTIMER
+  if (hires)
+    {
+      hrtimer_cancel(&rtcb->waithrtimer);
+      hrstop = hrtimer_now();
+    }
+  else
+#endif
   if (rqtp)
     {
       wd_cancel(&rtcb->waitdog);
@@ -343,6 +398,13 @@ int nxsig_clockwait(int clockid, int flags,
 
   leave_critical_section(iflags);
 
+#ifdef CONFIG_HRTIMER
+  if (hires && rmtp && (flags & TIMER_ABSTIME) == 0)
+    {
+      clock_nsec2time(rmtp, hrexpect > hrstop ? hrexpect - hrstop : 0);
+    }
+#endif
+
   if (rqtp && rmtp && expect)
     {
       clock_ticks2time(rmtp, expect > stop ? expect - stop : 0);
@@ -64,6 +64,8 @@
  *   nature of the created task.  For example:
  *
  *     - Task type may be set in the TCB flags to create kernel thread
+ *     - TCB_FLAG_CLOEXEC_DEFAULT may be set so that the new task inherits
+ *       only the descriptors that 'actions' dup2() from
  *
  * Input Parameters:
  *   tcb        - Address of the new task's TCB
@@ -74,6 +74,10 @@ void nxtask_recover(FAR struct tcb_s *tcb)
 
   wd_recover(tcb);
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&tcb->waithrtimer);
+#endif
+
   /* If the thread holds semaphore counts or is waiting for a semaphore
    *  count, then release the counts.
    */
@@ -94,4 +98,13 @@ void nxtask_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(nxsched_stop_sporadic(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Stop deadline scheduling and release the bandwidth */
+
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+    }
+#endif
 }
@@ -92,7 +92,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = nxsched_alloc_tcb(sizeof(struct task_tcb_s));
   if (tcb == NULL)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -102,6 +102,10 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
   /* Setup the task type */
 
   tcb->cmn.flags = TCB_FLAG_TTYPE_TASK | TCB_FLAG_FREE_TCB;
+  if (attr != NULL && (attr->flags & POSIX_SPAWN_CLOEXEC_DEFAULT) != 0)
+    {
+      tcb->cmn.flags |= TCB_FLAG_CLOEXEC_DEFAULT;
+    }
 
   /* Initialize the task */
 
@@ -109,7 +113,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
                     entry, argv, envp, actions);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb(tcb);
       return ret;
     }
 
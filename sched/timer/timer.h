@@ -33,6 +33,8 @@
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/wdog.h>
 
@@ -44,24 +46,73 @@
 
 #define PT_FLAGS_PREALLOCATED 0x01 /* Timer comes from a pool of preallocated timers */
 
+#if (CONFIG_TIMER_HASH_SIZE & (CONFIG_TIMER_HASH_SIZE - 1)) != 0
+#  error CONFIG_TIMER_HASH_SIZE must be a power of two
+#endif
+
+#define TIMER_HASH(id)        ((id) & (CONFIG_TIMER_HASH_SIZE - 1))
+
+/* Timer IDs are handed to the application as timer_t */
+
+#define TIMER_ID2T(id)        ((timer_t)(uintptr_t)(id))
+#define TIMER_T2ID(t)         ((int)(uintptr_t)(t))
+
+/* The time base of the timers: nanoseconds of the high resolution timers
+ * if available, system ticks of the watchdog timers otherwise.
+ */
+
+#ifdef CONFIG_HRTIMER
+#  define timer_now()                 hrtimer_now()
+#  define timer_time2delay(ts)        ((ptime_t)clock_time2nsec(ts))
+#  define timer_delay2time(ts, delay) clock_nsec2time(ts, delay)
+#  define timer_remaining(t)          ((ptime_t)hrtimer_gettime(&(t)->pt_hrtimer))
+#  define timer_cancel(t)             hrtimer_cancel(&(t)->pt_hrtimer)
+#else
+#  define timer_now()                 clock_systime_ticks()
+#  define timer_time2delay(ts)        ((ptime_t)clock_time2ticks(ts))
+#  define timer_delay2time(ts, delay) clock_ticks2time(ts, delay)
+#  define timer_remaining(t)          ((ptime_t)wd_gettime(&(t)->pt_wdog))
+#  define timer_cancel(t)             wd_cancel(&(t)->pt_wdog)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+struct task_group_s; /* Forward reference */
+
+/* Signed and unsigned time in the units of the timer time base */
+
+#ifdef CONFIG_HRTIMER
+typedef int64_t  ptime_t;
+typedef uint64_t ptabs_t;
+#else
+typedef sclock_t ptime_t;
+typedef clock_t  ptabs_t;
+#endif
+
 /* This structure represents one POSIX timer */
 
 struct posix_timer_s
 {
   FAR struct posix_timer_s *flink;
 
+  /* The owning task group, it finds the timer by pt_id */
+
+  FAR struct task_group_s *pt_group;
+  int              pt_id;          /* Timer ID within the group */
   clockid_t        pt_clock;       /* Specifies the clock to use as the timing base. */
   uint8_t          pt_flags;       /* See PT_FLAGS_* definitions */
   uint8_t          pt_crefs;       /* Reference count */
   pid_t            pt_owner;       /* Creator of timer */
   int              pt_overrun;     /* Overrun time */
-  sclock_t         pt_delay;       /* If non-zero, used to reset repetitive timers */
-  clock_t          pt_expected;    /* Expected absolute time */
+  ptime_t          pt_delay;       /* If non-zero, used to reset repetitive timers */
+  ptabs_t          pt_expected;    /* Expected absolute time */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s pt_hrtimer;     /* The timer that provides the timing */
+#else
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
+#endif
   struct sigevent  pt_event;       /* Notification information */
 #ifdef CONFIG_SIG_EVTHREAD
   struct sigwork_s pt_work;
@@ -78,19 +129,16 @@ struct posix_timer_s
 extern volatile sq_queue_t g_freetimers;
 #endif
 
-/* This is a list of instantiated timer structures -- active and inactive.
- * The timers are place on this list by timer_create() and removed from the
- * list by timer_delete() or when the owning thread exits.
- */
-
-extern volatile sq_queue_t g_alloctimers;
-
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
 void timer_initialize(void);
-void timer_deleteall(pid_t pid);
+int timer_addhandle(FAR struct task_group_s *group,
+                    FAR struct posix_timer_s *timer);
+void timer_remhandle(FAR struct posix_timer_s *timer);
+void timer_deleteall(FAR struct task_group_s *group, pid_t pid);
+void timer_freeall(FAR struct task_group_s *group);
 int timer_release(FAR struct posix_timer_s *timer);
 FAR struct posix_timer_s *timer_gethandle(timer_t timerid);
 
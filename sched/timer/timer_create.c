@@ -50,14 +50,16 @@
  * Name: timer_allocate
  *
  * Description:
- *   Allocate one POSIX timer and place it into the allocated timer list.
+ *   Allocate one POSIX timer.
  *
  ****************************************************************************/
 
 static FAR struct posix_timer_s *timer_allocate(void)
 {
   FAR struct posix_timer_s *ret;
+#if CONFIG_PREALLOC_TIMERS > 0
   irqstate_t flags;
+#endif
   uint8_t pt_flags;
 
   /* Try to get a preallocated timer from the free list */
@@ -84,20 +86,12 @@ static FAR struct posix_timer_s *timer_allocate(void)
       pt_flags = 0;
     }
 
-  /* If we have a timer, then put it into the allocated timer list */
+  /* If we have a timer, then initialize the timer structure */
 
   if (ret)
     {
-      /* Initialize the timer structure */
-
       memset(ret, 0, sizeof(struct posix_timer_s));
       ret->pt_flags = pt_flags;
-
-      /* And add it to the end of the list of allocated timers */
-
-      flags = spin_lock_irqsave(NULL);
-      sq_addlast((FAR sq_entry_t *)ret, (FAR sq_queue_t *)&g_alloctimers);
-      spin_unlock_irqrestore(NULL, flags);
     }
 
   return ret;
@@ -181,6 +175,15 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
       return ERROR;
     }
 
+  /* Give it an ID in the timer table of the calling process */
+
+  if (timer_addhandle(tcb->group, ret) < 0)
+    {
+      timer_release(ret);
+      set_errno(EAGAIN);
+      return ERROR;
+    }
+
   /* Initialize the timer instance */
 
   ret->pt_clock = clockid;
@@ -208,7 +211,7 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
 
       ret->pt_event.sigev_notify            = SIGEV_SIGNAL;
       ret->pt_event.sigev_signo             = SIGALRM;
-      ret->pt_event.sigev_value.sival_ptr   = ret;
+      ret->pt_event.sigev_value.sival_ptr   = TIMER_ID2T(ret->pt_id);
 
 #ifdef CONFIG_SIG_EVTHREAD
       ret->pt_event.sigev_notify_function   = NULL;
@@ -218,7 +221,7 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
 
   /* Return the timer */
 
-  *timerid = ret;
+  *timerid = TIMER_ID2T(ret->pt_id);
   return OK;
 }
 
@@ -73,7 +73,7 @@
 int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 {
   FAR struct posix_timer_s *timer = timer_gethandle(timerid);
-  sclock_t ticks;
+  ptime_t delay;
 
   if (!timer || !value)
     {
@@ -81,14 +81,14 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
       return ERROR;
     }
 
-  /* Get the number of ticks before the underlying watchdog expires */
+  /* Get the time before the underlying timer expires */
 
-  ticks = wd_gettime(&timer->pt_wdog);
+  delay = timer_remaining(timer);
 
   /* Convert that to a struct timespec and return it */
 
-  clock_ticks2time(&value->it_value, ticks);
-  clock_ticks2time(&value->it_interval, timer->pt_delay);
+  timer_delay2time(&value->it_value, delay);
+  timer_delay2time(&value->it_interval, timer->pt_delay);
   return OK;
 }
 
@@ -28,13 +28,18 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#include <limits.h>
 #include <time.h>
 #include <errno.h>
 
 #include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/trace.h>
 
+#include "sched/sched.h"
 #include "timer/timer.h"
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -59,12 +64,68 @@ static struct posix_timer_s g_prealloctimers[CONFIG_PREALLOC_TIMERS];
 volatile sq_queue_t g_freetimers;
 #endif
 
-/* This is a list of instantiated timer structures -- active and inactive.
- * The timers are place on this list by timer_create() and removed from the
- * list by timer_delete() or when the owning thread exits.
- */
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timer_find
+ *
+ * Description:
+ *   Look up a timer ID in the hash table of a group.  Must be called with
+ *   the table locked.
+ *
+ ****************************************************************************/
 
-volatile sq_queue_t g_alloctimers;
+static FAR struct posix_timer_s *timer_find(FAR struct task_group_s *group,
+                                            int id)
+{
+  FAR sq_entry_t *entry;
+
+  sq_for_every(&group->tg_timers[TIMER_HASH(id)], entry)
+    {
+      if (((FAR struct posix_timer_s *)entry)->pt_id == id)
+        {
+          return (FAR struct posix_timer_s *)entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: timer_release_owned
+ *
+ * Description:
+ *   Delete the timers of a group created by 'pid', or all of them if 'pid'
+ *   is INVALID_PROCESS_ID.
+ *
+ ****************************************************************************/
+
+static void timer_release_owned(FAR struct task_group_s *group, pid_t pid)
+{
+  FAR struct posix_timer_s *timer;
+  FAR struct posix_timer_s *next;
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_TIMER_HASH_SIZE; i++)
+    {
+      for (timer = (FAR struct posix_timer_s *)group->tg_timers[i].head;
+           timer != NULL;
+           timer = next)
+        {
+          next = timer->flink;
+          if (pid == INVALID_PROCESS_ID || timer->pt_owner == pid)
+            {
+              timer_release(timer);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
 
 /****************************************************************************
  * Public Functions
@@ -103,57 +164,153 @@ void timer_initialize(void)
     }
 #endif
 
-  /* Initialize the list of allocated timers */
-
-  sq_init((FAR sq_queue_t *)&g_alloctimers);
   sched_trace_end();
 }
 
 /****************************************************************************
- * Name: timer_deleteall
+ * Name: timer_addhandle
  *
  * Description:
- *   This function is called whenever a thread exits.  Any timers owned by
- *   that thread are deleted as though called by timer_delete().
- *
- *   It is provided in this file so that it can be weakly defined but also,
- *   like timer_intitialize(), be brought into the link whenever the timer
- *   resources are referenced.
+ *   Assign the next free timer ID of a group to a timer and enter it into
+ *   the group's hash table, allocating the table on first use.
  *
  * Input Parameters:
- *   pid - the task ID of the thread that exited
+ *   group - The task group that owns the timer
+ *   timer - The new timer
  *
  * Returned Value:
- *   None
+ *   Zero (OK) on success; -ENOMEM if the table could not be allocated.
  *
  ****************************************************************************/
 
-void timer_deleteall(pid_t pid)
+int timer_addhandle(FAR struct task_group_s *group,
+                    FAR struct posix_timer_s *timer)
 {
-  FAR struct posix_timer_s *timer;
-  FAR struct posix_timer_s *next;
+  FAR sq_queue_t *table = NULL;
   irqstate_t flags;
+  int id;
 
-  flags = enter_critical_section();
-  for (timer = (FAR struct posix_timer_s *)g_alloctimers.head;
-       timer != NULL;
-       timer = next)
+  if (group->tg_timers == NULL)
     {
-      next = timer->flink;
-      if (timer->pt_owner == pid)
+      table = kmm_zalloc(CONFIG_TIMER_HASH_SIZE * sizeof(sq_queue_t));
+      if (table == NULL)
         {
-          timer_delete((timer_t)timer);
+          return -ENOMEM;
         }
     }
 
-  leave_critical_section(flags);
+  flags = spin_lock_irqsave(NULL);
+
+  if (group->tg_timers == NULL)
+    {
+      group->tg_timers = table;
+      table = NULL;
+    }
+
+  /* IDs only wrap around after INT_MAX timers, skip the ones in use */
+
+  do
+    {
+      id = group->tg_timerid < INT_MAX ? group->tg_timerid + 1 : 1;
+      group->tg_timerid = id;
+    }
+  while (timer_find(group, id) != NULL);
+
+  timer->pt_group = group;
+  timer->pt_id    = id;
+  sq_addlast((FAR sq_entry_t *)timer, &group->tg_timers[TIMER_HASH(id)]);
+
+  spin_unlock_irqrestore(NULL, flags);
+
+  if (table != NULL)
+    {
+      kmm_free(table);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timer_remhandle
+ *
+ * Description:
+ *   Remove a timer from the hash table of its group.
+ *
+ ****************************************************************************/
+
+void timer_remhandle(FAR struct posix_timer_s *timer)
+{
+  FAR struct task_group_s *group = timer->pt_group;
+  irqstate_t flags;
+
+  if (group != NULL)
+    {
+      flags = spin_lock_irqsave(NULL);
+      sq_rem((FAR sq_entry_t *)timer,
+             &group->tg_timers[TIMER_HASH(timer->pt_id)]);
+      spin_unlock_irqrestore(NULL, flags);
+
+      timer->pt_group = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: timer_deleteall
+ *
+ * Description:
+ *   This function is called whenever a thread leaves its task group.  Any
+ *   timers owned by that thread are deleted as though called by
+ *   timer_delete().
+ *
+ * Input Parameters:
+ *   group - The task group of the thread
+ *   pid   - the task ID of the thread that exited
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void timer_deleteall(FAR struct task_group_s *group, pid_t pid)
+{
+  if (group->tg_timers != NULL)
+    {
+      timer_release_owned(group, pid);
+    }
+}
+
+/****************************************************************************
+ * Name: timer_freeall
+ *
+ * Description:
+ *   Delete whatever timers are left in a task group that is being released
+ *   and free its timer hash table.
+ *
+ * Input Parameters:
+ *   group - The task group being released
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void timer_freeall(FAR struct task_group_s *group)
+{
+  if (group->tg_timers != NULL)
+    {
+      timer_release_owned(group, INVALID_PROCESS_ID);
+
+      kmm_free(group->tg_timers);
+      group->tg_timers = NULL;
+    }
 }
 
 /****************************************************************************
  * Name: timer_gethandle
  *
  * Description:
- *   Returns the posix timer in the activity from the corresponding timerid
+ *   Returns the posix timer of the calling task group with the
+ *   corresponding timerid
  *
  * Input Parameters:
  *   timerid - The pre-thread timer, previously created by the call to
@@ -167,21 +324,18 @@ void timer_deleteall(pid_t pid)
 
 FAR struct posix_timer_s *timer_gethandle(timer_t timerid)
 {
+  FAR struct task_group_s *group = this_task()->group;
   FAR struct posix_timer_s *timer = NULL;
-  FAR sq_entry_t *entry;
   irqstate_t flags;
+  int id = TIMER_T2ID(timerid);
 
-  if (timerid != NULL)
+  if (group != NULL && id > 0)
     {
       flags = spin_lock_irqsave(NULL);
 
-      sq_for_every(&g_alloctimers, entry)
+      if (group->tg_timers != NULL)
         {
-          if (entry == timerid)
-            {
-              timer = (FAR struct posix_timer_s *)timerid;
-              break;
-            }
+          timer = timer_find(group, id);
         }
 
       spin_unlock_irqrestore(NULL, flags);
@@ -45,7 +45,7 @@
  * Name: timer_free
  *
  * Description:
- *   Remove the timer from the allocated timer list and free it or return it
+ *   Remove the timer from its group's timer table and free it or return it
  *   to the free list (depending on whether or not the timer is one of the
  *   preallocated timers)
  *
@@ -53,18 +53,20 @@
 
 static inline void timer_free(struct posix_timer_s *timer)
 {
+#if CONFIG_PREALLOC_TIMERS > 0
   irqstate_t flags;
+#endif
 
-  /* Remove the timer from the allocated list */
+  /* Remove the timer from the table of its group */
 
-  flags = spin_lock_irqsave(NULL);
-  sq_rem((FAR sq_entry_t *)timer, (FAR sq_queue_t *)&g_alloctimers);
+  timer_remhandle(timer);
 
   /* Return it to the free list if it is one of the preallocated timers */
 
 #if CONFIG_PREALLOC_TIMERS > 0
   if ((timer->pt_flags & PT_FLAGS_PREALLOCATED) != 0)
     {
+      flags = spin_lock_irqsave(NULL);
       sq_addlast((FAR sq_entry_t *)timer, (FAR sq_queue_t *)&g_freetimers);
       spin_unlock_irqrestore(NULL, flags);
     }
@@ -73,7 +75,6 @@ static inline void timer_free(struct posix_timer_s *timer)
     {
       /* Otherwise, return it to the heap */
 
-      spin_unlock_irqrestore(NULL, flags);
       kmm_free(timer);
     }
 }
@@ -122,9 +123,9 @@ int timer_release(FAR struct posix_timer_s *timer)
       return 1;
     }
 
-  /* Cancel the underlying watchdog instance */
+  /* Cancel the underlying timer instance */
 
-  wd_cancel(&timer->pt_wdog);
+  timer_cancel(timer);
 
   /* Cancel any pending notification */
 
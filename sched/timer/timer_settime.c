@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <limits.h>
 #include <time.h>
 #include <string.h>
 #include <assert.h>
@@ -44,9 +45,13 @@
  ****************************************************************************/
 
 static inline void timer_signotify(FAR struct posix_timer_s *timer);
-static inline void timer_restart(FAR struct posix_timer_s *timer,
-                                 wdparm_t itimer);
-static void timer_timeout(wdparm_t itimer);
+static int timer_start(FAR struct posix_timer_s *timer);
+static inline void timer_restart(FAR struct posix_timer_s *timer);
+#ifdef CONFIG_HRTIMER
+static void timer_timeout(FAR void *arg);
+#else
+static void timer_timeout(wdparm_t arg);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -81,6 +86,25 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer)
 #endif
 }
 
+/****************************************************************************
+ * Name: timer_start
+ *
+ * Description:
+ *   Arm the underlying timer for the absolute time in pt_expected.
+ *
+ ****************************************************************************/
+
+static int timer_start(FAR struct posix_timer_s *timer)
+{
+#ifdef CONFIG_HRTIMER
+  return hrtimer_start_absolute(&timer->pt_hrtimer, timer->pt_expected,
+                                timer_timeout, timer);
+#else
+  return wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
+                          timer_timeout, (wdparm_t)timer);
+#endif
+}
+
 /****************************************************************************
  * Name: timer_restart
  *
@@ -98,12 +122,10 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer)
  *
  ****************************************************************************/
 
-static inline void timer_restart(FAR struct posix_timer_s *timer,
-                                 wdparm_t itimer)
+static inline void timer_restart(FAR struct posix_timer_s *timer)
 {
-  clock_t ticks;
-  sclock_t delay;
-  sclock_t frame;
+  ptime_t delay;
+  ptime_t frame;
 
   /* If this is a repetitive timer, then restart the watchdog */
 
@@ -111,8 +133,7 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
     {
       /* Check whether next expected time is reached */
 
-      ticks = clock_systime_ticks();
-      delay = ticks - timer->pt_expected;
+      delay = timer_now() - timer->pt_expected;
 
       /* Calculate the number of timer overruns and the next expected tick.
        * The next expired tick frame can be computed as align up:
@@ -123,16 +144,18 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
        * In this case, frame equals 3.
        * Then, pt_overrun <- frame - 1 and
        * the next pt_expected <- pt_expected + frame * pt_delay.
+       * So however late the timer ran, it is re-armed exactly once and the
+       * missed periods are only counted.
        * Assumption of correctness:
        * (delay + timer->pt_delay) should not overflow.
        */
 
       frame = (delay + timer->pt_delay) / timer->pt_delay;
-      timer->pt_overrun = frame - 1;
+      timer->pt_overrun = frame - 1 > DELAYTIMER_MAX ?
+                          DELAYTIMER_MAX : (int)(frame - 1);
       timer->pt_expected += frame * timer->pt_delay;
 
-      wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
-                       timer_timeout, itimer);
+      timer_start(timer);
     }
 }
 
@@ -144,24 +167,24 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
  *   signaled.
  *
  * Input Parameters:
- *   itimer - A reference to the POSIX timer that just timed out
+ *   arg - A reference to the POSIX timer that just timed out
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
  *   This function executes in the context of the watchod timer interrupt.
+ *   A deleted timer has been cancelled, so 'arg' is always valid.
  *
  ****************************************************************************/
 
-static void timer_timeout(wdparm_t itimer)
+#ifdef CONFIG_HRTIMER
+static void timer_timeout(FAR void *arg)
+#else
+static void timer_timeout(wdparm_t arg)
+#endif
 {
-  FAR struct posix_timer_s *timer = timer_gethandle((timer_t)itimer);
-
-  if (timer == NULL)
-    {
-      return;
-    }
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)arg;
 
   /* Send the specified signal to the specified task.   Increment the
    * reference count on the timer first so that will not be deleted until
@@ -179,7 +202,7 @@ static void timer_timeout(wdparm_t itimer)
     {
       /* If this is a repetitive timer, the restart the watchdog */
 
-      timer_restart(timer, itimer);
+      timer_restart(timer);
     }
 }
 
@@ -256,7 +279,8 @@ int timer_settime(timer_t timerid, int flags,
                   FAR struct itimerspec *ovalue)
 {
   FAR struct posix_timer_s *timer = timer_gethandle(timerid);
-  sclock_t delay;
+  struct timespec reltime;
+  ptime_t delay;
   int ret = OK;
 
   /* Some sanity checks */
@@ -269,21 +293,21 @@ int timer_settime(timer_t timerid, int flags,
 
   if (ovalue)
     {
-      /* Get the number of ticks before the underlying watchdog expires */
+      /* Get the time before the underlying timer expires */
 
-      delay = wd_gettime(&timer->pt_wdog);
+      delay = timer_remaining(timer);
 
       /* Convert that to a struct timespec and return it */
 
-      clock_ticks2time(&ovalue->it_value, delay);
-      clock_ticks2time(&ovalue->it_interval, timer->pt_delay);
+      timer_delay2time(&ovalue->it_value, delay);
+      timer_delay2time(&ovalue->it_interval, timer->pt_delay);
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timer_settime() is called).
    */
 
-  wd_cancel(&timer->pt_wdog);
+  timer_cancel(timer);
 
   /* Cancel any pending notification */
 
@@ -302,8 +326,7 @@ int timer_settime(timer_t timerid, int flags,
 
   if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
     {
-      delay = clock_time2ticks(&value->it_interval);
-      timer->pt_delay = delay;
+      timer->pt_delay = timer_time2delay(&value->it_interval);
     }
   else
     {
@@ -314,11 +337,13 @@ int timer_settime(timer_t timerid, int flags,
 
   if ((flags & TIMER_ABSTIME) != 0)
     {
-      /* Calculate a delay corresponding to the absolute time in 'value' */
+      /* Calculate a delay corresponding to the absolute time in 'value',
+       * zero if that time has already passed.
+       */
 
-      clock_abstime2ticks(timer->pt_clock, &value->it_value,
-                          &timer->pt_expected);
-      timer->pt_expected += clock_systime_ticks();
+      nxclock_gettime(timer->pt_clock, &reltime);
+      clock_timespec_subtract(&value->it_value, &reltime, &reltime);
+      delay = timer_time2delay(&reltime);
     }
   else
     {
@@ -327,14 +352,14 @@ int timer_settime(timer_t timerid, int flags,
        * returns success.
        */
 
-      delay = clock_time2ticks(&value->it_value);
-      timer->pt_expected = clock_systime_ticks() + delay;
+      delay = timer_time2delay(&value->it_value);
     }
 
-  /* Then start the watchdog */
+  timer->pt_expected = timer_now() + delay;
+
+  /* Then start the underlying timer */
 
-  ret = wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
-                         timer_timeout, (wdparm_t)timer);
+  ret = timer_start(timer);
 
   if (ret < 0)
     {
@@ -107,11 +107,9 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
    * cancellation is complete
    */
 
-  head = list_is_head(&g_wdactivelist, &wdog->node);
-
   /* Now, remove the watchdog from the timer queue */
 
-  list_delete(&wdog->node);
+  head = wd_dequeue(wdog);
 
   /* Mark the watchdog inactive */
 
@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <limits.h>
+
 #include <nuttx/wdog.h>
 #include <nuttx/irq.h>
 
@@ -65,3 +67,40 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   return delay < 0 ? 0 : delay;
 }
+
+/****************************************************************************
+ * Name: wd_getnext
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog of the current CPU expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that a watchdog is already due, CLOCK_MAX that no watchdog
+ *   is active.
+ *
+ ****************************************************************************/
+
+clock_t wd_getnext(void)
+{
+  FAR struct wdog_s *wdog;
+  clock_t ret = CLOCK_MAX;
+  irqstate_t flags;
+  sclock_t delay;
+
+  flags = enter_critical_section();
+
+  wdog = wd_first(WDOG_THIS_QUEUE);
+  if (wdog != NULL)
+    {
+      delay = wdog->expired - clock_systime_ticks();
+      ret   = delay < 0 ? 0 : delay;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
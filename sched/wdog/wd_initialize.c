@@ -34,13 +34,63 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+/* The g_wdactivetree data structure is a red-black tree ordered by
+ * watchdog expiration time.  g_wdactivehead always points to the leftmost
+ * node so that the next expiration can be found without a tree walk.
+ */
+
+struct wdog_tree_s g_wdactivetree[WDOG_NQUEUES];
+FAR struct wdog_s *g_wdactivehead[WDOG_NQUEUES];
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
-struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#ifdef CONFIG_WDOG_PERCPU
+struct list_node g_wdactivelist[WDOG_NQUEUES];
+#else
+struct list_node g_wdactivelist[WDOG_NQUEUES] =
+{
+  LIST_INITIAL_VALUE(g_wdactivelist[0])
+};
+#endif
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+RB_GENERATE(wdog_tree_s, wdog_s, node, wd_compare);
+#endif
+
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU watchdog queues.  This must be called before
+ *   any watchdog is started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+void wd_initialize(void)
+{
+#ifndef CONFIG_WDOG_QUEUE_RBTREE
+  int i;
+
+  for (i = 0; i < WDOG_NQUEUES; i++)
+    {
+      list_initialize(&g_wdactivelist[i]);
+    }
+#endif
+}
+#endif
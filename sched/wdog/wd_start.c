@@ -90,6 +90,17 @@
 static unsigned int g_wdtimernested;
 #endif
 
+#ifdef CONFIG_WDOG_PERCPU
+static int wd_smp_expiration(FAR void *arg);
+
+/* Used to ask other CPUs to expire the watchdogs on their own queues */
+
+static struct smp_call_data_s g_wdsmpcall =
+{
+  .func = wd_smp_expiration,
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -102,6 +113,7 @@ static unsigned int g_wdtimernested;
  *   run. If so, remove the watchdog from the list and execute it.
  *
  * Input Parameters:
+ *   index - Index of the active queue to process
  *   ticks - current time in ticks
  *
  * Returned Value:
@@ -109,7 +121,7 @@ static unsigned int g_wdtimernested;
  *
  ****************************************************************************/
 
-static inline_function void wd_expiration(clock_t ticks)
+static inline_function void wd_expiration(int index, clock_t ticks)
 {
   FAR struct wdog_s *wdog;
   irqstate_t flags;
@@ -129,10 +141,8 @@ static inline_function void wd_expiration(clock_t ticks)
    * other watchdogs that became ready to run at this time
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  while ((wdog = wd_first(index)) != NULL)
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
       /* Check if expected time is expired */
 
       if (!clock_compare(wdog->expired, ticks))
@@ -142,7 +152,7 @@ static inline_function void wd_expiration(clock_t ticks)
 
       /* Remove the watchdog from the head of the list */
 
-      list_delete(&wdog->node);
+      wd_dequeue(wdog);
 
       /* Indicate that the watchdog is no longer active. */
 
@@ -164,6 +174,89 @@ static inline_function void wd_expiration(clock_t ticks)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: wd_smp_expiration
+ *
+ * Description:
+ *   Expire the watchdogs on the queue of the CPU that receives the SMP
+ *   call.  Run on behalf of wd_timer() which executes only on the CPU that
+ *   takes the timer interrupt.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ * Returned Value:
+ *   Always OK
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+static int wd_smp_expiration(FAR void *arg)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  wd_expiration(this_cpu(), clock_systime_ticks());
+
+  /* The watchdog functions may have started new watchdogs while the
+   * reassessment was suppressed, so pick up the new head now.
+   */
+
+  nxsched_reassess_timer();
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wd_smp_dispatch
+ *
+ * Description:
+ *   Ask every other CPU whose queue holds an expired watchdog to process
+ *   it.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline_function void wd_smp_dispatch(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  irqstate_t flags;
+  cpu_set_t cpuset;
+  int cpu;
+  int me;
+
+  CPU_ZERO(&cpuset);
+
+  flags = enter_critical_section();
+  me = this_cpu();
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      wdog = wd_first(cpu);
+      if (cpu != me && wdog != NULL && clock_compare(wdog->expired, ticks))
+        {
+          CPU_SET(cpu, &cpuset);
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (CPU_COUNT(&cpuset) > 0)
+    {
+      nxsched_smp_call_async(cpuset, &g_wdsmpcall);
+    }
+}
+#else
+#  define wd_smp_dispatch(ticks)
+#endif
+
 /****************************************************************************
  * Name: wd_insert
  *
@@ -181,85 +274,49 @@ static inline_function void wd_expiration(clock_t ticks)
  *   wdog and wdentry is not NULL.
  *
  * Returned Value:
- *   None.
+ *   True if the watchdog was inserted at the head of the queue.
  *
  ****************************************************************************/
 
 static inline_function
-void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
+bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
-  FAR struct wdog_s *curr;
-
-  /* Traverse the watchdog list */
+  bool head;
 
-  list_for_every_entry(&g_wdactivelist, curr, struct wdog_s, node)
-    {
-      /* Until curr->expired has not timed out relative to expired */
-
-      if (!clock_compare(curr->expired, expired))
-        {
-          break;
-        }
-    }
-
-  /* There are two cases:
-   * - Traverse to the end, where curr == &g_wdactivelist.
-   * - Find a curr such that curr->expected has not timed out
-   * relative to expired.
-   * In either case 1 or 2, we just insert the wdog before curr.
-   */
-
-  list_add_before(&curr->node, &wdog->node);
+  wdog->expired = expired;
+  head = wd_enqueue(wdog);
 
   wdog->func = wdentry;
   up_getpicbase(&wdog->picbase);
   wdog->arg = arg;
-  wdog->expired = expired;
-}
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+  return head;
+}
 
 /****************************************************************************
- * Name: wd_start_abstick
+ * Name: wd_start_internal
  *
  * Description:
- *   This function adds a watchdog timer to the active timer queue.  The
- *   specified watchdog function at 'wdentry' will be called from the
- *   interrupt level after the specified number of ticks has reached.
- *   Watchdog timers may be started from the interrupt level.
- *
- *   Watchdog timers execute in the address environment that was in effect
- *   when wd_start() is called.
- *
- *   Watchdog timers execute only once.
- *
- *   To replace either the timeout delay or the function to be executed,
- *   call wd_start again with the same wdog; only the most recent wdStart()
- *   on a given watchdog ID has any effect.
+ *   Add the watchdog to the timer queue of the given CPU to expire at the
+ *   absolute time 'ticks'.  This is the common implementation of
+ *   wd_start_abstick() and wd_start_cpu().
  *
  * Input Parameters:
  *   wdog     - Watchdog ID
  *   ticks    - Absoulute time in clock ticks
  *   wdentry  - Function to call on timeout
- *   arg      - Parameter to pass to wdentry.
- *
- *   NOTE:  The parameter must be of type wdparm_t.
+ *   arg      - Parameter to pass to wdentry
+ *   cpu      - The CPU whose queue will hold the watchdog
  *
  * Returned Value:
  *   Zero (OK) is returned on success; a negated errno value is return to
  *   indicate the nature of any failure.
  *
- * Assumptions:
- *   The watchdog routine runs in the context of the timer interrupt handler
- *   and is subject to all ISR restrictions.
- *
  ****************************************************************************/
 
-int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
-                     wdentry_t wdentry, wdparm_t arg)
+static int wd_start_internal(FAR struct wdog_s *wdog, clock_t ticks,
+                             wdentry_t wdentry, wdparm_t arg, int cpu)
 {
   irqstate_t flags;
   bool reassess = false;
@@ -299,15 +356,19 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
-      reassess |= list_is_head(&g_wdactivelist, &wdog->node);
-      list_delete(&wdog->node);
+      reassess |= wd_dequeue(wdog);
       wdog->func = NULL;
     }
 
-  wd_insert(wdog, ticks, wdentry, arg);
+#ifdef CONFIG_WDOG_PERCPU
+  wdog->cpu = cpu;
+#else
+  UNUSED(cpu);
+#endif
 
-  if (!g_wdtimernested &&
-      (reassess || list_is_head(&g_wdactivelist, &wdog->node)))
+  reassess |= wd_insert(wdog, ticks, wdentry, arg);
+
+  if (!g_wdtimernested && reassess)
     {
       /* Resume the interval timer that will generate the next
        * interval event. If the timer at the head of the list changed,
@@ -323,10 +384,16 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
-      list_delete(&wdog->node);
+      wd_dequeue(wdog);
       wdog->func = NULL;
     }
 
+#ifdef CONFIG_WDOG_PERCPU
+  wdog->cpu = cpu;
+#else
+  UNUSED(cpu);
+#endif
+
   wd_insert(wdog, ticks, wdentry, arg);
 #endif
   leave_critical_section(flags);
@@ -335,6 +402,56 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
   return OK;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_start_abstick
+ *
+ * Description:
+ *   This function adds a watchdog timer to the active timer queue.  The
+ *   specified watchdog function at 'wdentry' will be called from the
+ *   interrupt level after the specified number of ticks has reached.
+ *   Watchdog timers may be started from the interrupt level.
+ *
+ *   Watchdog timers execute in the address environment that was in effect
+ *   when wd_start() is called.
+ *
+ *   Watchdog timers execute only once.
+ *
+ *   To replace either the timeout delay or the function to be executed,
+ *   call wd_start again with the same wdog; only the most recent wdStart()
+ *   on a given watchdog ID has any effect.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   ticks    - Absoulute time in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry.
+ *
+ *   NOTE:  The parameter must be of type wdparm_t.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ * Assumptions:
+ *   The watchdog routine runs in the context of the timer interrupt handler
+ *   and is subject to all ISR restrictions.
+ *
+ ****************************************************************************/
+
+int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
+                     wdentry_t wdentry, wdparm_t arg)
+{
+#ifdef CONFIG_WDOG_PERCPU
+  return wd_start_internal(wdog, ticks, wdentry, arg, this_cpu());
+#else
+  return wd_start_internal(wdog, ticks, wdentry, arg, 0);
+#endif
+}
+
 /****************************************************************************
  * Name: wd_start
  *
@@ -385,6 +502,43 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
                           wdentry, arg);
 }
 
+/****************************************************************************
+ * Name: wd_start_cpu
+ *
+ * Description:
+ *   This function is the same as wd_start() except that the watchdog is
+ *   placed on the timer queue of the specified CPU, and the watchdog
+ *   function will be executed on that CPU.  wd_start() always uses the
+ *   queue of the calling CPU.
+ *
+ *   Without CONFIG_WDOG_PERCPU there is only one timer queue and the
+ *   'cpu' argument is ignored.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *   cpu      - The CPU that will expire the watchdog
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+int wd_start_cpu(FAR struct wdog_s *wdog, sclock_t delay,
+                 wdentry_t wdentry, wdparm_t arg, int cpu)
+{
+  if (delay < 0 || cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  return wd_start_internal(wdog, clock_systime_ticks() + delay,
+                           wdentry, arg, cpu);
+}
+
 /****************************************************************************
  * Name: wd_timer
  *
@@ -416,34 +570,48 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 {
   FAR struct wdog_s *wdog;
   irqstate_t flags;
-  sclock_t ret;
+  sclock_t delay;
+  sclock_t ret = 0;
+  bool found = false;
+  int i;
 
   /* Check if the watchdog at the head of the list is ready to run */
 
   if (!noswitches)
     {
-      wd_expiration(ticks);
+      wd_expiration(WDOG_THIS_QUEUE, ticks);
+      wd_smp_dispatch(ticks);
     }
 
   flags = enter_critical_section();
 
-  /* Return the delay for the next watchdog to expire */
-
-  if (list_is_empty(&g_wdactivelist))
-    {
-      leave_critical_section(flags);
-      return 0;
-    }
-
-  /* Notice that if noswitches, expired - g_wdtickbase
+  /* Return the delay for the next watchdog to expire.
+   *
+   * Notice that if noswitches, expired - g_wdtickbase
    * may get negative value.
    */
 
-  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-  ret = wdog->expired - ticks;
+  for (i = 0; i < WDOG_NQUEUES; i++)
+    {
+      wdog = wd_first(i);
+      if (wdog != NULL)
+        {
+          delay = wdog->expired - ticks;
+          if (!found || delay < ret)
+            {
+              ret = delay;
+              found = true;
+            }
+        }
+    }
 
   leave_critical_section(flags);
 
+  if (!found)
+    {
+      return 0;
+    }
+
   /* Return the delay for the next watchdog to expire */
 
   return MAX(ret, 1);
@@ -454,6 +622,7 @@ void wd_timer(clock_t ticks)
 {
   /* Check if there are any active watchdogs to process */
 
-  wd_expiration(ticks);
+  wd_expiration(WDOG_THIS_QUEUE, ticks);
+  wd_smp_dispatch(ticks);
 }
 #endif /* CONFIG_SCHED_TICKLESS */
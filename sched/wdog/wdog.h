@@ -38,6 +38,10 @@
 #include <nuttx/wdog.h>
 #include <nuttx/list.h>
 
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+#  include <sys/tree.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -46,6 +50,26 @@
 
 #define list_node wdlist_node
 
+/* Number of active watchdog queues and the queue that holds a watchdog */
+
+#ifdef CONFIG_WDOG_PERCPU
+#  define WDOG_NQUEUES          CONFIG_SMP_NCPUS
+#  define WDOG_THIS_QUEUE       this_cpu()
+#  define wd_queue_index(wdog)  ((wdog)->cpu)
+#else
+#  define WDOG_NQUEUES          1
+#  define WDOG_THIS_QUEUE       0
+#  define wd_queue_index(wdog)  0
+#endif
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+RB_HEAD(wdog_tree_s, wdog_s);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -58,17 +82,198 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/* There is one active watchdog queue per CPU if CONFIG_WDOG_PERCPU is
+ * selected, otherwise a single queue shared by all CPUs.
+ */
+
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+/* The g_wdactivetree data structure is a red-black tree ordered by
+ * watchdog expiration time.  g_wdactivehead caches the leftmost node of
+ * the tree, i.e. the watchdog that will expire next, or NULL if the tree
+ * is empty.
+ */
+
+extern struct wdog_tree_s g_wdactivetree[WDOG_NQUEUES];
+extern FAR struct wdog_s *g_wdactivehead[WDOG_NQUEUES];
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
-extern struct list_node g_wdactivelist;
+extern struct list_node g_wdactivelist[WDOG_NQUEUES];
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+/****************************************************************************
+ * Name: wd_compare
+ *
+ * Description:
+ *   Order two watchdogs by expiration time.  Watchdogs with the same
+ *   expiration time are never reported as equal so that a newly inserted
+ *   watchdog is placed after the ones already queued for that time.
+ *
+ ****************************************************************************/
+
+static inline_function int wd_compare(FAR struct wdog_s *wdog1,
+                                      FAR struct wdog_s *wdog2)
+{
+  return clock_compare(wdog2->expired, wdog1->expired) ? 1 : -1;
+}
+
+RB_PROTOTYPE(wdog_tree_s, wdog_s, node, wd_compare);
+#endif
+
+/****************************************************************************
+ * Name: wd_first
+ *
+ * Description:
+ *   Return the active watchdog with the earliest expiration time.
+ *
+ * Input Parameters:
+ *   index - Index of the active queue (always zero without
+ *           CONFIG_WDOG_PERCPU)
+ *
+ * Returned Value:
+ *   The watchdog at the head of the active queue, or NULL if no watchdog
+ *   is active.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct wdog_s *wd_first(int index)
+{
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+  return g_wdactivehead[index];
+#else
+  return list_peek_head_type(&g_wdactivelist[index], struct wdog_s, node);
+#endif
+}
+
+/****************************************************************************
+ * Name: wd_enqueue
+ *
+ * Description:
+ *   Insert the watchdog into its active queue according to its expiration
+ *   time.  wdog->expired (and wdog->cpu with CONFIG_WDOG_PERCPU) must
+ *   already be set.
+ *
+ * Returned Value:
+ *   True if the watchdog became the head of the active queue.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static inline_function bool wd_enqueue(FAR struct wdog_s *wdog)
+{
+  int index = wd_queue_index(wdog);
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+  FAR struct wdog_s **head = &g_wdactivehead[index];
+
+  RB_INSERT(wdog_tree_s, &g_wdactivetree[index], wdog);
+
+  if (*head == NULL || wd_compare(wdog, *head) < 0)
+    {
+      *head = wdog;
+      return true;
+    }
+
+  return false;
+#else
+  FAR struct list_node *list = &g_wdactivelist[index];
+  FAR struct wdog_s *curr;
+
+  /* Traverse the watchdog list */
+
+  list_for_every_entry(list, curr, struct wdog_s, node)
+    {
+      /* Until curr->expired has not timed out relative to expired */
+
+      if (!clock_compare(curr->expired, wdog->expired))
+        {
+          break;
+        }
+    }
+
+  /* There are two cases:
+   * - Traverse to the end, where curr == list.
+   * - Find a curr such that curr->expected has not timed out
+   * relative to expired.
+   * In either case 1 or 2, we just insert the wdog before curr.
+   */
+
+  list_add_before(&curr->node, &wdog->node);
+  return list_is_head(list, &wdog->node);
+#endif
+}
+
+/****************************************************************************
+ * Name: wd_dequeue
+ *
+ * Description:
+ *   Remove the watchdog from its active queue.
+ *
+ * Returned Value:
+ *   True if the watchdog was the head of the active queue.
+ *
+ * Assumptions:
+ *   Called in a critical section with an active watchdog.
+ *
+ ****************************************************************************/
+
+static inline_function bool wd_dequeue(FAR struct wdog_s *wdog)
+{
+  int index = wd_queue_index(wdog);
+  bool head;
+
+#ifdef CONFIG_WDOG_QUEUE_RBTREE
+  head = (g_wdactivehead[index] == wdog);
+  if (head)
+    {
+      g_wdactivehead[index] = RB_NEXT(wdog_tree_s,
+                                      &g_wdactivetree[index], wdog);
+    }
+
+  RB_REMOVE(wdog_tree_s, &g_wdactivetree[index], wdog);
+#else
+  head = list_is_head(&g_wdactivelist[index], &wdog->node);
+  list_delete(&wdog->node);
+#endif
+
+  return head;
+}
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU watchdog queues.  This must be called before
+ *   any watchdog is started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+void wd_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: wd_timer
  *
@@ -42,6 +42,51 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove queued work from the pending queue of the worker that holds it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+static void work_dequeue(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s *work)
+{
+  FAR dq_entry_t *head = (FAR dq_entry_t *)work;
+  int wndx;
+
+  /* Find the head of the queue that holds the work */
+
+  while (head->blink != NULL)
+    {
+      head = head->blink;
+    }
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      FAR struct kworker_s *kworker = &wqueue->worker[wndx];
+
+      if (kworker->q.head == head)
+        {
+          dq_rem((FAR dq_entry_t *)work, &kworker->q);
+          return;
+        }
+      else if (kworker->bq.head == head)
+        {
+          dq_rem((FAR dq_entry_t *)work, &kworker->bq);
+          return;
+        }
+    }
+
+  DEBUGPANIC();
+}
+#else
+#  define work_dequeue(wqueue, work) \
+     dq_rem((FAR dq_entry_t *)(work), &(wqueue)->q)
+#endif
+
 static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
                         FAR struct work_s *work)
 {
@@ -71,7 +116,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
         }
       else
         {
-          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+          work_dequeue(wqueue, work);
         }
 
       work->worker = NULL;
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <sched.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -44,6 +45,7 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERWORKER
 #define queue_work(wqueue, work) \
   do \
     { \
@@ -56,11 +58,90 @@
         } \
     } \
   while (0)
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: queue_work
+ *
+ * Description:
+ *   Add the work to the pending queue of one worker and wake that worker
+ *   up.  Bound work goes to a worker of its CPU.  Other work goes to an
+ *   idle worker if there is one or, otherwise, to the next worker in round
+ *   robin order.  Idle workers take work from the queues of busy workers,
+ *   so unbound work is not stuck behind a long running work.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+static void queue_work(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
+{
+  FAR struct kworker_s *kworker = NULL;
+  FAR struct kworker_s *first = NULL;
+  int semcount;
+  int wndx;
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      FAR struct kworker_s *curr = &wqueue->worker[wndx];
+
+      if (work->cpu >= 0 && curr->cpu != work->cpu)
+        {
+          continue;
+        }
+
+      if (first == NULL)
+        {
+          first = curr;
+        }
+
+      /* A negative count means that the worker is waiting for work */
+
+      nxsem_get_value(&curr->sem, &semcount);
+      if (semcount < 0)
+        {
+          kworker = curr;
+          break;
+        }
+    }
+
+  if (kworker == NULL)
+    {
+      if (work->cpu >= 0)
+        {
+          kworker = first;
+        }
+      else
+        {
+          kworker = &wqueue->worker[wqueue->next];
+          if (++wqueue->next >= wqueue->nthreads)
+            {
+              wqueue->next = 0;
+            }
+        }
+    }
+
+  DEBUGASSERT(kworker != NULL);
+
+  work->u.s.qtime = clock_systime_ticks();
+  dq_addlast((FAR dq_entry_t *)work,
+             work->cpu >= 0 ? &kworker->bq : &kworker->q);
+
+  nxsem_get_value(&kworker->sem, &semcount);
+  if (semcount < 0)
+    {
+      nxsem_post(&kworker->sem);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: work_timer_expiry
  ****************************************************************************/
@@ -74,6 +155,27 @@ static void work_timer_expiry(wdparm_t arg)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: work_expiry
+ *
+ * Description:
+ *   Return the absolute expiration tick of delayed work.  With a slack
+ *   window, the tick is rounded up to the end of the window so that all
+ *   delayed work expiring within the same window shares one timer expiry.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_WORKQUEUE_SLACK > 1
+static inline clock_t work_expiry(clock_t ticks)
+{
+  clock_t rem = ticks % CONFIG_SCHED_WORKQUEUE_SLACK;
+
+  return rem != 0 ? ticks + CONFIG_SCHED_WORKQUEUE_SLACK - rem : ticks;
+}
+#else
+#  define work_expiry(ticks) (ticks)
+#endif
+
 static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
                               FAR struct work_s *work)
 {
@@ -95,6 +197,71 @@ static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
   return false;
 }
 
+/****************************************************************************
+ * Name: work_qqueue
+ *
+ * Description:
+ *   Queue the work to be performed delay ticks after the tick base, bound
+ *   to a CPU if cpu is not negative.
+ *
+ ****************************************************************************/
+
+static int work_qqueue(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t base, clock_t delay, int cpu)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  if (wqueue == NULL || work == NULL || worker == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Interrupts are disabled so that this logic can be called from with
+   * task logic or from interrupt handling logic.
+   */
+
+  flags = enter_critical_section();
+
+  /* Remove the entry from the timer and work queue. */
+
+  if (work->worker != NULL)
+    {
+      work_cancel_wq(wqueue, work);
+    }
+
+  if (work_is_canceling(wqueue->worker, wqueue->nthreads, work))
+    {
+      goto out;
+    }
+
+  /* Initialize the work structure. */
+
+  work->worker = worker;           /* Work callback. non-NULL means queued */
+  work->arg    = arg;              /* Callback argument */
+  work->wq     = wqueue;           /* Work queue */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+  work->cpu    = cpu;              /* Bound CPU */
+#endif
+
+  /* Queue the new work */
+
+  if (!delay)
+    {
+      queue_work(wqueue, work);
+    }
+  else
+    {
+      wd_start_abstick(&work->u.timer, work_expiry(base + delay),
+                       work_timer_expiry, (wdparm_t)work);
+    }
+
+out:
+  leave_critical_section(flags);
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -133,58 +300,146 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay)
 {
-  irqstate_t flags;
-  int ret = OK;
+  return work_qqueue(wqueue, work, worker, arg, clock_systime_ticks(),
+                     delay, -1);
+}
 
-  if (wqueue == NULL || work == NULL || worker == NULL)
+int work_queue(int qid, FAR struct work_s *work, worker_t worker,
+               FAR void *arg, clock_t delay)
+{
+  return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
+}
+
+/****************************************************************************
+ * Name: work_queue_cpu/work_queue_cpu_wq
+ *
+ * Description:
+ *   Queue work to be performed at a later time by a worker thread bound to
+ *   the specified CPU.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   cpu    - The CPU that must perform the work
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+int work_queue_cpu_wq(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work, worker_t worker,
+                      FAR void *arg, clock_t delay, int cpu)
+{
+  int wndx;
+
+  if (wqueue == NULL || cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
     {
       return -EINVAL;
     }
 
-  /* Interrupts are disabled so that this logic can be called from with
-   * task logic or from interrupt handling logic.
-   */
+  /* The worker threads are bound to CPUs only if there are enough */
 
-  flags = enter_critical_section();
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      if (wqueue->worker[wndx].cpu == cpu)
+        {
+          return work_qqueue(wqueue, work, worker, arg,
+                             clock_systime_ticks(), delay, cpu);
+        }
+    }
 
-  /* Remove the entry from the timer and work queue. */
+  return -EINVAL;
+}
 
-  if (work->worker != NULL)
+int work_queue_cpu(int qid, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay, int cpu)
+{
+  return work_queue_cpu_wq(work_qid2wq(qid), work, worker, arg, delay,
+                           cpu);
+}
+#endif
+
+/****************************************************************************
+ * Name: work_queue_batch/work_queue_batch_wq
+ *
+ * Description:
+ *   Queue several work structures at once.  All of the work is queued in
+ *   one critical section against the same tick base, so delayed work in
+ *   the batch expires together, and the worker threads are not switched
+ *   in before the whole batch is queued.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   batch  - The array of work to queue
+ *   nwork  - The number of entries in the batch
+ *   delay  - Delay (in clock ticks) from the time queue until the workers
+ *            are invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  Nothing is queued if
+ *   any entry of the batch is invalid.
+ *
+ ****************************************************************************/
+
+int work_queue_batch_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR const struct work_batch_s *batch,
+                        size_t nwork, clock_t delay)
+{
+  irqstate_t flags;
+  clock_t base;
+  size_t i;
+
+  if (wqueue == NULL || batch == NULL)
     {
-      work_cancel_wq(wqueue, work);
+      return -EINVAL;
     }
 
-  if (work_is_canceling(wqueue->worker, wqueue->nthreads, work))
+  for (i = 0; i < nwork; i++)
     {
-      goto out;
+      if (batch[i].work == NULL || batch[i].worker == NULL)
+        {
+          return -EINVAL;
+        }
     }
 
-  /* Initialize the work structure. */
-
-  work->worker = worker;           /* Work callback. non-NULL means queued */
-  work->arg    = arg;              /* Callback argument */
-  work->wq     = wqueue;           /* Work queue */
+  if (!up_interrupt_context())
+    {
+      sched_lock();
+    }
 
-  /* Queue the new work */
+  flags = enter_critical_section();
+  base  = clock_systime_ticks();
 
-  if (!delay)
+  for (i = 0; i < nwork; i++)
     {
-      queue_work(wqueue, work);
+      work_qqueue(wqueue, batch[i].work, batch[i].worker, batch[i].arg,
+                  base, delay, -1);
     }
-  else
+
+  leave_critical_section(flags);
+
+  if (!up_interrupt_context())
     {
-      wd_start(&work->u.timer, delay, work_timer_expiry, (wdparm_t)work);
+      sched_unlock();
     }
 
-out:
-  leave_critical_section(flags);
-  return ret;
+  return OK;
 }
 
-int work_queue(int qid, FAR struct work_s *work, worker_t worker,
-               FAR void *arg, clock_t delay)
+int work_queue_batch(int qid, FAR const struct work_batch_s *batch,
+                     size_t nwork, clock_t delay)
 {
-  return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
+  return work_queue_batch_wq(work_qid2wq(qid), batch, nwork, delay);
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
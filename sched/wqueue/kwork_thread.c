@@ -108,6 +108,59 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove the next work for this worker: first work bound to its CPU,
+ *   then its own unbound work and finally unbound work stolen from the
+ *   other workers of the pool.  The time the work has waited is added to
+ *   the latency histogram of the work queue.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+static FAR struct work_s *work_dequeue(FAR struct kwork_wqueue_s *wqueue,
+                                       FAR struct kworker_s *kworker)
+{
+  FAR struct work_s *work;
+  clock_t elapsed;
+  int bucket;
+  int wndx;
+
+  work = (FAR struct work_s *)dq_remfirst(&kworker->bq);
+  if (work == NULL)
+    {
+      work = (FAR struct work_s *)dq_remfirst(&kworker->q);
+    }
+
+  for (wndx = 0; work == NULL && wndx < wqueue->nthreads; wndx++)
+    {
+      work = (FAR struct work_s *)dq_remfirst(&wqueue->worker[wndx].q);
+    }
+
+  if (work != NULL)
+    {
+      elapsed = clock_systime_ticks() - work->u.s.qtime;
+      for (bucket = 0; elapsed > 0 && bucket < WORK_LATENCY_NBUCKETS - 1;
+           bucket++)
+        {
+          elapsed >>= 1;
+        }
+
+      wqueue->latency[bucket]++;
+    }
+
+  return work;
+}
+#else
+#  define work_dequeue(wqueue, kworker) \
+     ((FAR struct work_s *)dq_remfirst(&(wqueue)->q))
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -160,7 +213,7 @@ static int work_thread(int argc, FAR char *argv[])
 
       /* Remove the ready-to-execute work from the list */
 
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      while ((work = work_dequeue(wqueue, kworker)) != NULL)
         {
           if (work->worker == NULL)
             {
@@ -211,7 +264,11 @@ static int work_thread(int argc, FAR char *argv[])
        * posted.
        */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+      nxsem_wait_uninterruptible(&kworker->sem);
+#else
       nxsem_wait_uninterruptible(&wqueue->sem);
+#endif
     }
 
   leave_critical_section(flags);
@@ -259,6 +316,18 @@ static int work_thread_create(FAR const char *name, int priority,
     {
       nxsem_init(&wqueue->worker[wndx].wait, 0, 0);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+      /* Bind the workers to CPUs round robin if there is at least one
+       * worker per CPU.
+       */
+
+      dq_init(&wqueue->worker[wndx].q);
+      dq_init(&wqueue->worker[wndx].bq);
+      nxsem_init(&wqueue->worker[wndx].sem, 0, 0);
+      wqueue->worker[wndx].cpu = wqueue->nthreads >= CONFIG_SMP_NCPUS ?
+                                 wndx % CONFIG_SMP_NCPUS : -1;
+#endif
+
       snprintf(arg0, sizeof(arg0), "%p", wqueue);
       snprintf(arg1, sizeof(arg1), "%p", &wqueue->worker[wndx]);
       argv[0] = arg0;
@@ -277,6 +346,17 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid = pid;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+      if (wqueue->worker[wndx].cpu >= 0)
+        {
+          cpu_set_t cpuset;
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(wqueue->worker[wndx].cpu, &cpuset);
+          nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+        }
+#endif
     }
 
   sched_unlock();
@@ -383,7 +463,11 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+      nxsem_post(&wqueue->worker[wndx].sem);
+#else
       nxsem_post(&wqueue->sem);
+#endif
     }
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
@@ -438,6 +522,46 @@ int work_queue_priority(int qid)
   return work_queue_priority_wq(work_qid2wq(qid));
 }
 
+/****************************************************************************
+ * Name: work_queue_latency_wq
+ *
+ * Description:
+ *   Return the histogram of the time that work waited in the work queue
+ *   before a worker thread started to perform it.
+ *
+ * Input Parameters:
+ *  wqueue  - The work queue handle
+ *  latency - The location to return the WORK_LATENCY_NBUCKETS counters
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+int work_queue_latency_wq(FAR struct kwork_wqueue_s *wqueue,
+                          FAR uint32_t *latency)
+{
+  irqstate_t flags;
+
+  if (wqueue == NULL || latency == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  memcpy(latency, wqueue->latency, sizeof(wqueue->latency));
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+int work_queue_latency(int qid, FAR uint32_t *latency)
+{
+  return work_queue_latency_wq(work_qid2wq(qid), latency);
+}
+#endif
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -58,6 +58,12 @@ struct kworker_s
   pid_t             pid;       /* The task ID of the worker thread */
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+  struct dq_queue_s q;         /* Pending work that any worker may take */
+  struct dq_queue_s bq;        /* Pending work bound to this worker's CPU */
+  sem_t             sem;       /* Wakes up this worker */
+  int               cpu;       /* The CPU of this worker, or -1 if unbound */
+#endif
 };
 
 /* This structure defines the state of one kernel-mode work queue */
@@ -69,6 +75,13 @@ struct kwork_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+  uint8_t           next;      /* Next worker for round robin queueing */
+
+  /* Histogram of the time that work waited before it was performed */
+
+  uint32_t          latency[WORK_LATENCY_NBUCKETS];
+#endif
   struct kworker_s  worker[0]; /* Describes a worker thread */
 };
 
@@ -84,6 +97,13 @@ struct hp_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+  uint8_t           next;      /* Next worker for round robin queueing */
+
+  /* Histogram of the time that work waited before it was performed */
+
+  uint32_t          latency[WORK_LATENCY_NBUCKETS];
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -103,6 +123,13 @@ struct lp_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERWORKER
+  uint8_t           next;      /* Next worker for round robin queueing */
+
+  /* Histogram of the time that work waited before it was performed */
+
+  uint32_t          latency[WORK_LATENCY_NBUCKETS];
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
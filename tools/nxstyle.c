@@ -617,6 +617,11 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzGetCurrentFileZStreamPos64",
+  "inflateInit2",
+  "inflateReset",
+  "inflatePrime",
+  "inflateSetDictionary",
   NULL
 };
 